@@ -388,10 +388,13 @@ namespace CodeGen
             output.WriteLine("namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects");
             output.WriteLine("{");
             output.Indent();
+
+            bool hasPropertyDefaults = WritePropertyDefaults(effect, output);
+
             output.WriteLine(effect.ClassName + "::" + effect.ClassName + "(ICanvasDevice* device, ID2D1Effect* effect)");
             output.WriteIndent();
             output.WriteLine(": CanvasEffect(EffectId(), "
-                             + (effect.Properties.Count(p => (!p.IsHandCoded && !p.IsHdrAlias)) - 4) + ", "
+                             + (hasPropertyDefaults ? effect.ClassName + "PropertyDefaults" : "0") + ", "
                              + inputsCount + ", "
                              + isInputSizeFixed.ToString().ToLower() + ", "
                              + "device, effect, static_cast<" + effect.InterfaceName + "*>(this))");
@@ -404,20 +407,8 @@ namespace CodeGen
                 output.Indent();
                 output.WriteLine("ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);");
                 output.Unindent();
-                output.WriteLine();
             }
-            
-            output.WriteLine("if (!effect)");
-            output.WriteLine("{");
-            output.Indent();
-            output.WriteLine("// Set default values");
 
-            foreach (var property in effect.Properties)
-            {
-                WritePropertyInitialization(output, property);
-            }
-            output.Unindent();
-            output.WriteLine("}");
             output.Unindent();
             output.WriteLine("}");
             output.WriteLine();
@@ -517,22 +508,67 @@ namespace CodeGen
                    !string.IsNullOrEmpty(effect.Overrides.IsSupportedCheck);
         }
 
-        private static void WritePropertyInitialization(Formatter output, Effects.Property property)
+        private static bool WritePropertyDefaults(Effects.Effect effect, Formatter output)
         {
             // Property with type string describes 
             // name/author/category/description of effect but not input type
-            if (property.Type == "string" || property.IsHandCoded || property.IsHdrAlias)
-                return;
+            var properties = effect.Properties.Where(p => p.Type != "string" && !p.IsHandCoded && !p.IsHdrAlias).ToList();
+
+            if (properties.Count == 0)
+                return false;
+
+            output.WriteLine("IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(" + effect.ClassName + ",");
+            output.Indent();
 
+            for (int i = 0; i < properties.Count; i++)
+            {
+                bool isLast = (i == properties.Count - 1);
+
+                output.WriteLine(FormatPropertyDefault(properties[i]) + (isLast ? ")" : ","));
+            }
+
+            output.Unindent();
+            output.WriteLine();
+
+            return true;
+        }
+
+        private static string FormatPropertyDefault(Effects.Property property)
+        {
             string defaultValue = property.Properties.Find(internalProperty => internalProperty.Name == "Default").Value;
 
-            string setFunction = property.IsArray ? "SetArrayProperty" : "SetBoxedProperty";
+            // Defaults are emitted in D2D format, so colors and rectangles are not converted to their WinRT types.
+            if (property.IsArray || property.Type.StartsWith("matrix") || property.Type.StartsWith("vector"))
+            {
+                var values = property.IsArray ? defaultValue.Split(',').Select(v => v.Trim()) : SplitVectorValue(defaultValue);
 
-            string customConversion = null;
-            if (property.ConvertColorHdrToVector3)
-                customConversion = "ConvertColorHdrToVector3";
+                return "EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(" + property.NativePropertyName + ", " + values.Count() + ", " + string.Join(", ", values) + ")";
+            }
+
+            if (property.TypeNameBoxed.EndsWith("*"))
+            {
+                if (defaultValue != "null")
+                    throw new NotSupportedException("Interface property " + property.Name + " must default to null.");
+
+                return "EFFECT_PROPERTY_DEFAULT_INTERFACE(" + property.NativePropertyName + ")";
+            }
+
+            string macro;
 
-            output.WriteLine(setFunction + "<" + (customConversion?? property.TypeNameBoxed) + ">(" + property.NativePropertyName + ", " + FormatPropertyValue(property, defaultValue) + ");");
+            switch (property.TypeNameBoxed)
+            {
+                case "float":       macro = "EFFECT_PROPERTY_DEFAULT_SINGLE";   break;
+                case "int32_t":     macro = "EFFECT_PROPERTY_DEFAULT_INT32";    break;
+                case "uint32_t":    macro = "EFFECT_PROPERTY_DEFAULT_UINT32";   break;
+                case "boolean":     macro = "EFFECT_PROPERTY_DEFAULT_BOOLEAN";  break;
+
+                default:
+                    throw new NotSupportedException("Unsupported type " + property.TypeNameBoxed + " for property " + property.Name + ".");
+            }
+
+            string value = (property.Type == "bool") ? defaultValue : FormatPropertyValue(property, defaultValue);
+
+            return macro + "(" + property.NativePropertyName + ", " + value + ")";
         }
 
         private static void WritePropertyImplementation(Effects.Effect effect, Formatter output, Effects.Property property)
@@ -564,9 +600,22 @@ namespace CodeGen
 
             bool isValidation = ((min != null) || (max != null) || isWithUnsupported) && (customConversion == null);
 
+            // Plain min/max checks are emitted as a constant range, which a single shared
+            // helper checks for every effect. Anything else gets a validation expression.
+            string minValue = null;
+            string maxValue = null;
+
+            bool isRange = isValidation && !isWithUnsupported && !property.IsArray &&
+                           TryFormatRangeLimit(property, min, false, out minValue) &&
+                           TryFormatRangeLimit(property, max, true, out maxValue);
+
             string implementMacro = property.IsArray ? "IMPLEMENT_EFFECT_ARRAY_PROPERTY" : "IMPLEMENT_EFFECT_PROPERTY";
 
-            if (isValidation)
+            if (isRange)
+            {
+                implementMacro += "_WITH_RANGE";
+            }
+            else if (isValidation)
             {
                 implementMacro += "_WITH_VALIDATION";
             }
@@ -581,7 +630,13 @@ namespace CodeGen
                 output.WriteLine(property.TypeNameCpp + ",");
             }
 
-            if (isValidation)
+            if (isRange)
+            {
+                output.WriteLine(property.NativePropertyName + ",");
+                output.WriteLine(minValue + ",");
+                output.WriteLine(maxValue + ")");
+            }
+            else if (isValidation)
             {
                 output.WriteLine(property.NativePropertyName + ",");
 
@@ -616,6 +671,48 @@ namespace CodeGen
             output.WriteLine();
         }
 
+        static bool TryFormatRangeLimit(Effects.Property property, Effects.Property minOrMax, bool isMax, out string value)
+        {
+            // Ranges are compared componentwise, which only makes sense for the Numerics vector types.
+            if (property.Type.StartsWith("vector") && !property.TypeNameCpp.StartsWith("Numerics::Vector"))
+            {
+                value = null;
+                return false;
+            }
+
+            if (minOrMax != null)
+            {
+                value = FormatPropertyValue(property, minOrMax.Value);
+                return true;
+            }
+
+            // A missing limit leaves that end of the range open.
+            if (property.Type.StartsWith("vector"))
+            {
+                int componentCount = int.Parse(property.Type.Substring("vector".Length));
+                var limits = Enumerable.Repeat(isMax ? "inf" : "-inf", componentCount);
+
+                value = FormatPropertyValue(property, "(" + string.Join(",", limits) + ")");
+                return true;
+            }
+
+            switch (property.TypeNameCpp)
+            {
+                case "float":
+                    value = (isMax ? "" : "-") + stdInfinity;
+                    return true;
+
+                case "int32_t":
+                case "uint32_t":
+                    value = "std::numeric_limits<" + property.TypeNameCpp + ">::" + (isMax ? "max()" : "lowest()");
+                    return true;
+
+                default:
+                    value = null;
+                    return false;
+            }
+        }
+
         static void AddValidationChecks(List<string> validationChecks, Effects.Property property, string minOrMax, string comparisonOperator)
         {
             if (property.Type.StartsWith("vector"))
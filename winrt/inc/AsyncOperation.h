@@ -10,6 +10,7 @@
 #include <functional>
 #include "ErrorHandling.h"
 #include "LifespanTracker.h"
+#include "AsyncScheduler.h"
 
 
 // Helper for marking our callback delegates as agile, by mixing in FtmBase.
@@ -39,6 +40,62 @@ struct AsyncCompletedHandlerType<ABI::Windows::Foundation::IAsyncAction>
 };
 
 
+// Lets a worker function find out whether the async operation it is running
+// for has been cancelled, so long running loads and saves can stop between
+// stages rather than finishing work nobody wants. Outside of a worker function
+// nothing is ever cancelled, so code shared with the synchronous APIs (and the
+// batch loaders' helper threads) can call this freely.
+class AsyncCancellation
+{
+    static ABI::Windows::Foundation::IAsyncInfo*& CurrentAsyncInfo()
+    {
+        static thread_local ABI::Windows::Foundation::IAsyncInfo* asyncInfo = nullptr;
+        return asyncInfo;
+    }
+
+public:
+    // Marks the current thread as running a worker function for asyncInfo.
+    class Scope
+    {
+        ABI::Windows::Foundation::IAsyncInfo* m_previous;
+
+    public:
+        Scope(ABI::Windows::Foundation::IAsyncInfo* asyncInfo)
+            : m_previous(CurrentAsyncInfo())
+        {
+            CurrentAsyncInfo() = asyncInfo;
+        }
+
+        ~Scope()
+        {
+            CurrentAsyncInfo() = m_previous;
+        }
+
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+    };
+
+    static bool IsCanceled()
+    {
+        auto asyncInfo = CurrentAsyncInfo();
+
+        if (!asyncInfo)
+            return false;
+
+        AsyncStatus status;
+        return SUCCEEDED(asyncInfo->get_Status(&status)) && status == AsyncStatus::Canceled;
+    }
+
+    // The error is never seen by the caller: once cancelled, the async
+    // operation reports that rather than whatever its worker failed with.
+    static void ThrowIfCanceled()
+    {
+        if (IsCanceled())
+            ThrowHR(E_ABORT);
+    }
+};
+
+
 // Common implementation code shared between AsyncOperation and AsyncAction.
 template<typename T>
 class AsyncCommon : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::AsyncBase<typename AsyncCompletedHandlerType<T>::Type>, T>
@@ -142,20 +199,26 @@ private:
         
         auto threadPoolDelegate = Callback<CallbackType>([=](IAsyncAction*)
         {
-            // Run the worker function.
-            HRESULT hr = ExceptionBoundary([&]
+            // Don't bother starting work that was cancelled while it waited its turn.
+            if (ContinueAsyncOperation())
             {
-                workerFunction();
-            });
+                AsyncCancellation::Scope cancellationScope(static_cast<IAsyncInfo*>(keepThisAliveUntilTaskCompletion.Get()));
 
-            // Capture the success or failure state.
-            if (SUCCEEDED(hr))
-            {
-                (void)TryTransitionToCompleted();
-            }
-            else
-            {
-                (void)TryTransitionToError(hr);
+                // Run the worker function.
+                HRESULT hr = ExceptionBoundary([&]
+                {
+                    workerFunction();
+                });
+
+                // Capture the success or failure state.
+                if (SUCCEEDED(hr))
+                {
+                    (void)TryTransitionToCompleted();
+                }
+                else
+                {
+                    (void)TryTransitionToError(hr);
+                }
             }
 
             // Notify listeners that the task is complete.
@@ -170,18 +233,10 @@ private:
     }
 
 
-    // Starts a task running on the system threadpool.
+    // Starts a task running on the system threadpool, subject to the AsyncScheduler's limits.
     void StartThreadPoolDelegate(Microsoft::WRL::ComPtr<ABI::Windows::System::Threading::IWorkItemHandler> const& threadPoolDelegate)
     {
-        using namespace ABI::Windows::Foundation;
-        using namespace ABI::Windows::System::Threading;
-        using namespace Microsoft::WRL;
-
-        ComPtr<IThreadPoolStatics> threadPool;
-        ThrowIfFailed(GetActivationFactory(Wrappers::HStringReference(RuntimeClass_Windows_System_Threading_ThreadPool).Get(), &threadPool));
-
-        ComPtr<IAsyncAction> threadPoolTask;
-        ThrowIfFailed(threadPool->RunAsync(threadPoolDelegate.Get(), &threadPoolTask));
+        AsyncScheduler::GetInstance().Run(threadPoolDelegate);
     }
 
 
@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include <wrl.h>
+#include <Windows.System.Threading.h>
+#include <algorithm>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "ErrorHandling.h"
+
+
+// All the background work Win2D starts (async operations, and the workers of
+// the batch APIs) goes through here rather than straight to the thread pool,
+// so apps can limit how many thread pool threads we occupy at once and at
+// what priority they run.
+//
+// Work items queued beyond the concurrency limit wait until an earlier one
+// finishes. Work started from inside an already running work item is not
+// held back: such items are helping to finish their parent, which could
+// otherwise deadlock waiting for a slot that only it can free. The batch APIs
+// instead cap their worker counts via LimitParallelism.
+class AsyncScheduler
+{
+    typedef ABI::Windows::System::Threading::IWorkItemHandler IWorkItemHandler;
+    typedef ABI::Windows::System::Threading::WorkItemPriority WorkItemPriority;
+
+    std::mutex m_mutex;
+    uint32_t m_maximumConcurrency;
+    WorkItemPriority m_priority;
+    uint32_t m_runningCount;
+    std::queue<Microsoft::WRL::ComPtr<IWorkItemHandler>> m_pendingWorkItems;
+
+    AsyncScheduler()
+        : m_maximumConcurrency(0)
+        , m_priority(ABI::Windows::System::Threading::WorkItemPriority_Normal)
+        , m_runningCount(0)
+    { }
+
+    static bool& IsRunningWorkItem()
+    {
+        static thread_local bool isRunningWorkItem = false;
+        return isRunningWorkItem;
+    }
+
+public:
+    static AsyncScheduler& GetInstance()
+    {
+        static AsyncScheduler instance;
+        return instance;
+    }
+
+    // Zero means no limit.
+    uint32_t GetMaximumConcurrency()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_maximumConcurrency;
+    }
+
+    void SetMaximumConcurrency(uint32_t value)
+    {
+        std::vector<Microsoft::WRL::ComPtr<IWorkItemHandler>> workItemsToStart;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maximumConcurrency = value;
+
+            // Raising the limit may let some pending work start.
+            while (!m_pendingWorkItems.empty() && HasFreeSlot())
+            {
+                workItemsToStart.push_back(m_pendingWorkItems.front());
+                m_pendingWorkItems.pop();
+                m_runningCount++;
+            }
+        }
+
+        for (auto& workItem : workItemsToStart)
+        {
+            StartOrRunInline(workItem, true);
+        }
+    }
+
+    WorkItemPriority GetPriority()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_priority;
+    }
+
+    void SetPriority(WorkItemPriority value)
+    {
+        using namespace ABI::Windows::System::Threading;
+
+        switch (value)
+        {
+        case WorkItemPriority_Low:
+        case WorkItemPriority_Normal:
+        case WorkItemPriority_High:
+            break;
+
+        default:
+            ThrowHR(E_INVALIDARG);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_priority = value;
+    }
+
+    // Returns how many workers a batch API should start, given how many it wanted.
+    uint32_t LimitParallelism(uint32_t parallelism)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_maximumConcurrency)
+            return std::max(std::min(parallelism, m_maximumConcurrency), 1U);
+        else
+            return parallelism;
+    }
+
+    // Runs a work item on the thread pool, or queues it if we are already at the concurrency limit.
+    void Run(Microsoft::WRL::ComPtr<IWorkItemHandler> const& workItem)
+    {
+        if (IsRunningWorkItem())
+        {
+            Start(workItem, false);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!HasFreeSlot())
+            {
+                m_pendingWorkItems.push(workItem);
+                return;
+            }
+
+            m_runningCount++;
+        }
+
+        try
+        {
+            Start(workItem, true);
+        }
+        catch (...)
+        {
+            OnWorkItemCompleted();
+            throw;
+        }
+    }
+
+private:
+    bool HasFreeSlot() const
+    {
+        return !m_maximumConcurrency || m_runningCount < m_maximumConcurrency;
+    }
+
+    void Start(Microsoft::WRL::ComPtr<IWorkItemHandler> const& workItem, bool isCounted)
+    {
+        using namespace ABI::Windows::Foundation;
+        using namespace ABI::Windows::System::Threading;
+        using namespace Microsoft::WRL;
+
+        ComPtr<IThreadPoolStatics> threadPool;
+        ThrowIfFailed(GetActivationFactory(Wrappers::HStringReference(RuntimeClass_Windows_System_Threading_ThreadPool).Get(), &threadPool));
+
+        typedef Implements<RuntimeClassFlags<ClassicCom>, IWorkItemHandler, FtmBase> CallbackType;
+
+        auto wrapper = Callback<CallbackType>([this, workItem, isCounted](IAsyncAction* action)
+        {
+            Invoke(workItem, action, isCounted);
+            return S_OK;
+        });
+
+        CheckMakeResult(wrapper);
+
+        ComPtr<IAsyncAction> threadPoolTask;
+        ThrowIfFailed(threadPool->RunWithPriorityAsync(wrapper.Get(), GetPriority(), &threadPoolTask));
+    }
+
+    // Used when a queued work item gets its turn. There is nobody to report a
+    // failure to start it to, so in that rare case it runs on this thread.
+    void StartOrRunInline(Microsoft::WRL::ComPtr<IWorkItemHandler> const& workItem, bool isCounted)
+    {
+        HRESULT hr = ExceptionBoundary([&] { Start(workItem, isCounted); });
+
+        if (FAILED(hr))
+        {
+            Invoke(workItem, nullptr, isCounted);
+        }
+    }
+
+    void Invoke(Microsoft::WRL::ComPtr<IWorkItemHandler> const& workItem, ABI::Windows::Foundation::IAsyncAction* action, bool isCounted)
+    {
+        bool wasRunningWorkItem = IsRunningWorkItem();
+        IsRunningWorkItem() = true;
+
+        (void)workItem->Invoke(action);
+
+        IsRunningWorkItem() = wasRunningWorkItem;
+
+        if (isCounted)
+        {
+            OnWorkItemCompleted();
+        }
+    }
+
+    void OnWorkItemCompleted()
+    {
+        Microsoft::WRL::ComPtr<IWorkItemHandler> next;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_runningCount--;
+
+            if (!m_pendingWorkItems.empty() && HasFreeSlot())
+            {
+                next = m_pendingWorkItems.front();
+                m_pendingWorkItems.pop();
+                m_runningCount++;
+            }
+        }
+
+        if (next)
+        {
+            StartOrRunInline(next, true);
+        }
+    }
+};
@@ -130,6 +130,7 @@ namespace collections
     template<typename TKey, typename TValue, template<typename TKey_abi, typename TValue_abi> class Traits = DefaultMapTraits>
     class Map : public Microsoft::WRL::RuntimeClass<ABI::Windows::Foundation::Collections::IMap<TKey, TValue>,
                                                     ABI::Windows::Foundation::Collections::IIterable<ABI::Windows::Foundation::Collections::IKeyValuePair<TKey, TValue>*>>,
+                public PooledAllocation<Map<TKey, TValue, Traits>>,
                 private LifespanTracker<Map<TKey, TValue, Traits>>
     {
         InspectableClass(IMap::z_get_rc_name_impl(), BaseTrust);
@@ -274,7 +275,7 @@ namespace collections
             {
                 CheckAndClearOutPointer(view);
 
-                auto mapView = Microsoft::WRL::Make<MapView<TKey, TValue, Map>>(this);
+                auto mapView = MakePooled<MapView<TKey, TValue, Map>>(this);
                 CheckMakeResult(mapView);
 
                 *view = mapView.Detach();
@@ -287,12 +288,12 @@ namespace collections
             return ExceptionBoundary([&]
             {
                 // Flatten our map into a Vector<KeyValuePair>.
-                auto vector = Microsoft::WRL::Make<Vector<ABI::Windows::Foundation::Collections::IKeyValuePair<TKey, TValue>*>>();
+                auto vector = MakePooled<Vector<ABI::Windows::Foundation::Collections::IKeyValuePair<TKey, TValue>*>>();
                 CheckMakeResult(vector);
 
                 for (auto& entry : Traits::GetKeyValuePairs(mMap))
                 {
-                    auto keyValuePair = Microsoft::WRL::Make<KeyValuePair<TKey, TValue, Traits>>(entry.first, entry.second);
+                    auto keyValuePair = MakePooled<KeyValuePair<TKey, TValue, Traits>>(entry.first, entry.second);
                     CheckMakeResult(keyValuePair);
 
                     ThrowIfFailed(vector->Append(keyValuePair.Get()));
@@ -309,6 +310,7 @@ namespace collections
     template<typename TKey, typename TValue, typename TMap>
     class MapView : public Microsoft::WRL::RuntimeClass<ABI::Windows::Foundation::Collections::IMapView<TKey, TValue>,
                                                         ABI::Windows::Foundation::Collections::IIterable<ABI::Windows::Foundation::Collections::IKeyValuePair<TKey, TValue>*>>,
+                    public PooledAllocation<MapView<TKey, TValue, TMap>>,
                     private LifespanTracker<MapView<TKey, TValue, TMap>>
     {
         InspectableClass(IMapView::z_get_rc_name_impl(), BaseTrust);
@@ -362,6 +364,7 @@ namespace collections
     // Implements the WinRT KeyValuePair interface.
     template<typename TKey, typename TValue, typename Traits>
     class KeyValuePair : public Microsoft::WRL::RuntimeClass<ABI::Windows::Foundation::Collections::IKeyValuePair<TKey, TValue>>,
+                         public PooledAllocation<KeyValuePair<TKey, TValue, Traits>>,
                          private LifespanTracker<KeyValuePair<TKey, TValue, Traits>>
     {
         InspectableClass(KeyValuePair::z_get_rc_name_impl(), BaseTrust);
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include <wrl.h>
+#include <assert.h>
+#include <new>
+
+
+// Derive from this to give a type its own free list of memory blocks. Short
+// lived objects that are created over and over (such as the collections and
+// iterators our APIs hand out) then mostly reuse recently freed memory rather
+// than going back to the heap each time.
+//
+// Every block in the free list came from the global operator new, and is
+// exactly sizeof(T), so pooled and non-pooled allocations can be freely mixed.
+// This matters because WRL's Make always uses the global operator new: objects
+// it creates are returned to the pool when they are destroyed, but only
+// objects created through MakePooled take blocks back out again.
+template<typename T>
+class PooledAllocation
+{
+    // Enough to cover a burst of creating and releasing, without holding on
+    // to too much memory once it is over.
+    static const USHORT MaxPooledBlocks = 64;
+
+    struct FreeList
+    {
+        SLIST_HEADER Head;
+
+        FreeList()
+        {
+            InitializeSListHead(&Head);
+        }
+
+        ~FreeList()
+        {
+            while (auto block = InterlockedPopEntrySList(&Head))
+            {
+                ::operator delete(block);
+            }
+        }
+    };
+
+    static PSLIST_HEADER GetFreeList()
+    {
+        static FreeList freeList;
+        return &freeList.Head;
+    }
+
+    static void* TryPop(size_t size)
+    {
+        static_assert(sizeof(T) >= sizeof(SLIST_ENTRY), "T must be big enough to hold a free list entry");
+
+        // Types derived from T don't fit in T's blocks.
+        if (size != sizeof(T))
+            return nullptr;
+
+        return InterlockedPopEntrySList(GetFreeList());
+    }
+
+public:
+    static void* operator new(size_t size)
+    {
+        if (auto block = TryPop(size))
+            return block;
+
+        return ::operator new(size);
+    }
+
+    static void* operator new(size_t size, std::nothrow_t const&) noexcept
+    {
+        if (auto block = TryPop(size))
+            return block;
+
+        return ::operator new(size, std::nothrow);
+    }
+
+    static void operator delete(void* block, size_t size) noexcept
+    {
+        if (!block)
+            return;
+
+        if (size == sizeof(T) && QueryDepthSList(GetFreeList()) < MaxPooledBlocks)
+        {
+            // SList entries need this alignment, which the global operator new provides.
+            assert(reinterpret_cast<uintptr_t>(block) % MEMORY_ALLOCATION_ALIGNMENT == 0);
+
+            InterlockedPushEntrySList(GetFreeList(), static_cast<PSLIST_ENTRY>(block));
+            return;
+        }
+
+        ::operator delete(block);
+    }
+
+    // Only called if a constructor throws during new (std::nothrow).
+    static void operator delete(void* block, std::nothrow_t const&) noexcept
+    {
+        ::operator delete(block);
+    }
+
+    // Declaring the above hides the global placement forms, which Make needs.
+    static void* operator new(size_t, void* place) noexcept
+    {
+        return place;
+    }
+
+    static void operator delete(void*, void*) noexcept
+    {
+    }
+};
+
+
+// Equivalent of WRL's Make, for types that derive from PooledAllocation.
+// Returns null if out of memory, so callers use CheckMakeResult the same as
+// they would with Make.
+template<typename T, typename... Args>
+Microsoft::WRL::ComPtr<T> MakePooled(Args&&... args)
+{
+    static_assert(std::is_base_of<PooledAllocation<T>, T>::value, "T must derive from PooledAllocation<T>");
+
+    Microsoft::WRL::ComPtr<T> object;
+
+    // RuntimeClass objects start out with a reference count of one.
+    object.Attach(new (std::nothrow) T(std::forward<Args>(args)...));
+
+    return object;
+}
@@ -8,6 +8,7 @@
 #include <vector>
 #include "ErrorHandling.h"
 #include "LifespanTracker.h"
+#include "PooledAllocation.h"
 
 namespace collections
 {
@@ -151,6 +152,7 @@ namespace collections
     template<typename T, template<typename T_abi> class Traits = DefaultVectorTraits>
     class Vector : public Microsoft::WRL::RuntimeClass<ABI::Windows::Foundation::Collections::IVector<T>,
                                                        ABI::Windows::Foundation::Collections::IIterable<T>>,
+                   public PooledAllocation<Vector<T, Traits>>,
                    private LifespanTracker<Vector<T, Traits>>
     {
         InspectableClass(IVector<T>::z_get_rc_name_impl(), BaseTrust);
@@ -376,7 +378,7 @@ namespace collections
             {
                 CheckAndClearOutPointer(view);
 
-                auto vectorView = Microsoft::WRL::Make<VectorView<T, Vector>>(this);
+                auto vectorView = MakePooled<VectorView<T, Vector>>(this);
                 CheckMakeResult(vectorView);
 
                 *view = vectorView.Detach();
@@ -390,7 +392,7 @@ namespace collections
             {
                 CheckAndClearOutPointer(first);
 
-                auto iterator = Microsoft::WRL::Make<VectorIterator<T, Vector>>(this);
+                auto iterator = MakePooled<VectorIterator<T, Vector>>(this);
                 CheckMakeResult(iterator);
 
                 *first = iterator.Detach();
@@ -403,6 +405,7 @@ namespace collections
     template<typename T, typename TVector>
     class VectorView : public Microsoft::WRL::RuntimeClass<ABI::Windows::Foundation::Collections::IVectorView<T>,
                                                            ABI::Windows::Foundation::Collections::IIterable<T>>,
+                       public PooledAllocation<VectorView<T, TVector>>,
                        private LifespanTracker<VectorView<T, TVector>>
     {
         InspectableClass(IVectorView<T>::z_get_rc_name_impl(), BaseTrust);
@@ -446,6 +449,7 @@ namespace collections
     // Implements the WinRT IIterator interface.
     template<typename T, typename TVector>
     class VectorIterator : public Microsoft::WRL::RuntimeClass<ABI::Windows::Foundation::Collections::IIterator<T>>,
+                           public PooledAllocation<VectorIterator<T, TVector>>,
                            private LifespanTracker<VectorIterator<T, TVector>>
     {
         InspectableClass(IIterator<T>::z_get_rc_name_impl(), BaseTrust);
@@ -52,7 +52,11 @@ CanvasImageBrush::CanvasImageBrush(
     : CanvasBrush(device)
     , ResourceWrapper(bitmapBrush)
     , m_d2dBitmapBrush(bitmapBrush)
+    , m_useBitmapBrush(true)
     , m_isSourceRectSet(false)
+    , m_realizedGeneration(0)
+    , m_realizedFlags(GetImageFlags::None)
+    , m_realizedDpi(0)
 {
 }
 
@@ -62,7 +66,11 @@ CanvasImageBrush::CanvasImageBrush(
     : CanvasBrush(device)
     , ResourceWrapper(imageBrush)
     , m_d2dImageBrush(imageBrush)
+    , m_useBitmapBrush(false)
     , m_isSourceRectSet(true)
+    , m_realizedGeneration(0)
+    , m_realizedFlags(GetImageFlags::None)
+    , m_realizedDpi(0)
 {
 }
 
@@ -71,7 +79,11 @@ CanvasImageBrush::CanvasImageBrush(
     ICanvasImage* image)
     : CanvasBrush(device)
     , ResourceWrapper(nullptr)
+    , m_useBitmapBrush(false)
     , m_isSourceRectSet(false)
+    , m_realizedGeneration(0)
+    , m_realizedFlags(GetImageFlags::None)
+    , m_realizedDpi(0)
 {
     if (image)
     {
@@ -85,9 +97,11 @@ CanvasImageBrush::CanvasImageBrush(
 
 void CanvasImageBrush::SetImage(ICanvasImage* image)
 {
+    m_realizedGeneration = 0;
+
     if (image == nullptr)
     {
-        if (m_d2dBitmapBrush)
+        if (m_useBitmapBrush)
             m_d2dBitmapBrush->SetBitmap(nullptr);
         else
             m_d2dImageBrush->SetImage(nullptr);
@@ -104,7 +118,7 @@ void CanvasImageBrush::SetImage(ICanvasImage* image)
         // Use a bitmap brush.
         auto& d2dBitmap = As<ICanvasBitmapInternal>(bitmap)->GetD2DBitmap();
 
-        if (m_d2dBitmapBrush)
+        if (m_useBitmapBrush)
         {
             m_d2dBitmapBrush->SetBitmap(d2dBitmap.Get());
         }
@@ -120,7 +134,7 @@ void CanvasImageBrush::SetImage(ICanvasImage* image)
         // Use an image brush.
         auto d2dImage = As<ICanvasImageInternal>(image)->GetD2DImage(m_device.EnsureNotClosed().Get(), nullptr, GetImageFlags::MinimalRealization);
 
-        if (m_d2dImageBrush)
+        if (!m_useBitmapBrush && m_d2dImageBrush)
         {
             m_d2dImageBrush->SetImage(d2dImage.Get());
         }
@@ -145,7 +159,7 @@ IFACEMETHODIMP CanvasImageBrush::get_Image(ICanvasImage** value)
 
             ComPtr<ID2D1Image> d2dImage;
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
             {
                 ComPtr<ID2D1Bitmap> bitmap;
                 m_d2dBitmapBrush->GetBitmap(&bitmap);
@@ -186,7 +200,7 @@ IFACEMETHODIMP CanvasImageBrush::get_ExtendX(CanvasEdgeBehavior* value)
             ThrowIfClosed();
             D2D1_EXTEND_MODE extendMode;
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
                 extendMode = m_d2dBitmapBrush->GetExtendModeX();
             else 
                 extendMode = m_d2dImageBrush->GetExtendModeX();
@@ -204,7 +218,7 @@ IFACEMETHODIMP CanvasImageBrush::put_ExtendX(CanvasEdgeBehavior value)
 
             ThrowIfClosed();
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
                 m_d2dBitmapBrush->SetExtendModeX(static_cast<D2D1_EXTEND_MODE>(value));
             else 
                 m_d2dImageBrush->SetExtendModeX(static_cast<D2D1_EXTEND_MODE>(value));
@@ -222,7 +236,7 @@ IFACEMETHODIMP CanvasImageBrush::get_ExtendY(CanvasEdgeBehavior* value)
             ThrowIfClosed();
             D2D1_EXTEND_MODE extendMode;
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
                 extendMode = m_d2dBitmapBrush->GetExtendModeY();
             else 
                 extendMode = m_d2dImageBrush->GetExtendModeY();
@@ -240,7 +254,7 @@ IFACEMETHODIMP CanvasImageBrush::put_ExtendY(CanvasEdgeBehavior value)
 
             ThrowIfClosed();
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
                 m_d2dBitmapBrush->SetExtendModeY(static_cast<D2D1_EXTEND_MODE>(value));
             else 
                 m_d2dImageBrush->SetExtendModeY(static_cast<D2D1_EXTEND_MODE>(value));
@@ -288,7 +302,7 @@ IFACEMETHODIMP CanvasImageBrush::put_SourceRectangle(ABI::Windows::Foundation::I
 
             ThrowIfClosed();
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
             {
                 assert(!m_isSourceRectSet);
                 if (value)
@@ -339,7 +353,7 @@ IFACEMETHODIMP CanvasImageBrush::get_Interpolation(CanvasImageInterpolation* val
             ThrowIfClosed();
             D2D1_INTERPOLATION_MODE interpolationMode;
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
                 interpolationMode = m_d2dBitmapBrush->GetInterpolationMode1();
             else 
                 interpolationMode = m_d2dImageBrush->GetInterpolationMode();
@@ -357,7 +371,7 @@ IFACEMETHODIMP CanvasImageBrush::put_Interpolation(CanvasImageInterpolation valu
 
             ThrowIfClosed();
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
                 m_d2dBitmapBrush->SetInterpolationMode1(static_cast<D2D1_INTERPOLATION_MODE>(value));
             else 
                 m_d2dImageBrush->SetInterpolationMode(static_cast<D2D1_INTERPOLATION_MODE>(value));
@@ -370,6 +384,7 @@ IFACEMETHODIMP CanvasImageBrush::Close()
     m_d2dBitmapBrush.Reset();
     m_d2dImageBrush.Reset();
     m_currentImageCache.Reset();
+    m_realizedGeneration = 0;
     return ResourceWrapper::Close();
 }
 
@@ -379,7 +394,7 @@ ComPtr<ID2D1Brush> CanvasImageBrush::GetD2DBrush(ID2D1DeviceContext* deviceConte
 
     ThrowIfClosed();
 
-    if (m_d2dBitmapBrush)
+    if (m_useBitmapBrush)
     {
         return m_d2dBitmapBrush;
     }
@@ -422,7 +437,7 @@ IFACEMETHODIMP CanvasImageBrush::GetNativeResource(ICanvasDevice* device, float
 
             ResourceManager::ValidateDevice(static_cast<ICanvasResourceWrapperWithDevice*>(this), device);
 
-            if (m_d2dBitmapBrush)
+            if (m_useBitmapBrush)
             {
                 ThrowIfFailed(m_d2dBitmapBrush.CopyTo(iid, resource));
             }
@@ -443,6 +458,17 @@ IFACEMETHODIMP CanvasImageBrush::GetNativeResource(ICanvasDevice* device, float
 
 void CanvasImageBrush::RealizeSourceEffect(ID2D1DeviceContext* deviceContext, GetImageFlags flags, float dpi)
 {
+    // Read the generation before realizing, so changes made while we do that aren't missed.
+    auto generation = Effects::CanvasEffect::GetRealizedGraphGeneration();
+
+    float targetDpi = dpi;
+
+    if ((flags & GetImageFlags::ReadDpiFromDeviceContext) != GetImageFlags::None)
+    {
+        // Command lists are DPI independent, so they get a DPI that no device context has.
+        targetDpi = TargetIsCommandList(deviceContext) ? 0 : GetDpi(deviceContext);
+    }
+
     // Do we have a source image?
     ComPtr<ID2D1Image> d2dImage;
     m_d2dImageBrush->GetImage(&d2dImage);
@@ -450,8 +476,26 @@ void CanvasImageBrush::RealizeSourceEffect(ID2D1DeviceContext* deviceContext, Ge
     if (!d2dImage)
         return;
 
-    // Is it an effect?
-    if (!MaybeAs<ID2D1Effect>(d2dImage))
+    // Fast path: if nothing about the graph or the target has changed since we last
+    // realized the effect, it is still set up correctly. The image is compared too,
+    // in case the D2D brush has been changed through interop. Source images that
+    // change their D2D image move the generation on (see InvalidateRealizedImageGraphs),
+    // so this also catches those.
+    if (m_realizedGeneration != 0 &&
+        m_realizedGeneration == generation &&
+        m_realizedFlags == flags &&
+        m_realizedDpi == targetDpi &&
+        IsSameInstance(d2dImage.Get(), m_currentImageCache.GetResource()))
+    {
+        return;
+    }
+
+    m_realizedGeneration = 0;
+
+    // Effects need realizing. Other images are asked again too, as some (such as
+    // CanvasDynamicBitmap) move on to a new D2D image, but only when we already
+    // know their wrapper. An image set through interop might not have one.
+    if (!MaybeAs<ID2D1Effect>(d2dImage) && !IsSameInstance(d2dImage.Get(), m_currentImageCache.GetResource()))
         return;
 
     // Look up the corresponding Win2D wrapper instance.
@@ -465,6 +509,20 @@ void CanvasImageBrush::RealizeSourceEffect(ID2D1DeviceContext* deviceContext, Ge
     {
         m_d2dImageBrush->SetImage(realizedEffect.Get());
     }
+
+    // Effects that cache their output have to go through GetD2DImage every time they
+    // are drawn, so the effect cache budget knows they are still in use.
+    boolean cacheOutput = false;
+
+    if (auto effect = MaybeAs<Effects::ICanvasEffect>(sourceEffect))
+        ThrowIfFailed(effect->get_CacheOutput(&cacheOutput));
+
+    if (realizedEffect && !cacheOutput)
+    {
+        m_realizedGeneration = generation;
+        m_realizedFlags = flags;
+        m_realizedDpi = targetDpi;
+    }
 }
 
 void CanvasImageBrush::ThrowIfClosed()
@@ -474,11 +532,18 @@ void CanvasImageBrush::ThrowIfClosed()
 
 void CanvasImageBrush::SwitchToImageBrush(ID2D1Image* image)
 {
-    assert(!m_d2dImageBrush);
-
-    m_d2dImageBrush = As<ICanvasDeviceInternal>(m_device.EnsureNotClosed())->CreateImageBrush(image);
+    assert(!m_d2dImageBrush || m_useBitmapBrush);
 
+    // The bitmap brush is kept for later, but mustn't hold on to its bitmap meanwhile.
     if (m_d2dBitmapBrush)
+        m_d2dBitmapBrush->SetBitmap(nullptr);
+
+    if (m_d2dImageBrush)
+        m_d2dImageBrush->SetImage(image);
+    else
+        m_d2dImageBrush = As<ICanvasDeviceInternal>(m_device.EnsureNotClosed())->CreateImageBrush(image);
+
+    if (m_useBitmapBrush)
     {
         m_d2dImageBrush->SetExtendModeX(m_d2dBitmapBrush->GetExtendModeX());
         m_d2dImageBrush->SetExtendModeY(m_d2dBitmapBrush->GetExtendModeY());
@@ -487,19 +552,27 @@ void CanvasImageBrush::SwitchToImageBrush(ID2D1Image* image)
         D2D1_MATRIX_3X2_F transform;
         m_d2dBitmapBrush->GetTransform(&transform);
         m_d2dImageBrush->SetTransform(transform);
-
-        m_d2dBitmapBrush.Reset();
     }
 
+    m_useBitmapBrush = false;
+    m_realizedGeneration = 0;
+
     SetResource(m_d2dImageBrush.Get());
 }
 
 void CanvasImageBrush::SwitchToBitmapBrush(ID2D1Bitmap1* bitmap)
 {
-    assert(!m_d2dBitmapBrush);
+    assert(!m_useBitmapBrush);
     assert(!m_isSourceRectSet);
 
-    m_d2dBitmapBrush = As<ICanvasDeviceInternal>(m_device.EnsureNotClosed())->CreateBitmapBrush(bitmap);
+    // The image brush is kept for later, but mustn't hold on to its image meanwhile.
+    if (m_d2dImageBrush)
+        m_d2dImageBrush->SetImage(nullptr);
+
+    if (m_d2dBitmapBrush)
+        m_d2dBitmapBrush->SetBitmap(bitmap);
+    else
+        m_d2dBitmapBrush = As<ICanvasDeviceInternal>(m_device.EnsureNotClosed())->CreateBitmapBrush(bitmap);
 
     if (m_d2dImageBrush)
     {
@@ -510,16 +583,17 @@ void CanvasImageBrush::SwitchToBitmapBrush(ID2D1Bitmap1* bitmap)
         D2D1_MATRIX_3X2_F transform;
         m_d2dImageBrush->GetTransform(&transform);
         m_d2dBitmapBrush->SetTransform(transform);
-
-        m_d2dImageBrush.Reset();
     }
 
+    m_useBitmapBrush = true;
+    m_realizedGeneration = 0;
+
     SetResource(m_d2dBitmapBrush.Get());
 }
 
 void CanvasImageBrush::TrySwitchFromImageBrushToBitmapBrush()
 {
-    assert(m_d2dImageBrush);
+    assert(!m_useBitmapBrush && m_d2dImageBrush);
     assert(!m_isSourceRectSet);
 
     ComPtr<ID2D1Image> targetImage;
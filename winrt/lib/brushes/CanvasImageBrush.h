@@ -39,6 +39,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // Otherwise, it uses the image brush.
         // Bitmap brush is eligible when the source image is a bitmap and the source rect
         // is NULL.
+        //
+        // Once created, both D2D brushes are kept for the lifetime of this object, so
+        // alternating between bitmaps and other images just retargets them in place. The
+        // one not in use has its image cleared, so it doesn't keep anything alive.
 
         mutable std::mutex m_mutex;
 
@@ -46,10 +50,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ComPtr<ID2D1ImageBrush> m_d2dImageBrush;
 
+        bool m_useBitmapBrush;
+
         CachedResourceReference<ID2D1Image, ICanvasImage> m_currentImageCache;
 
         bool m_isSourceRectSet;
 
+        // When the image brush is drawing an effect, RealizeSourceEffect records the
+        // effect graph generation (see CanvasEffect::GetRealizedGraphGeneration),
+        // flags and target DPI it realized the effect with. Until one of those
+        // changes, or the image does, drawing the brush again can skip the effect
+        // entirely. Zero means nothing is recorded.
+        uint64_t m_realizedGeneration;
+        GetImageFlags m_realizedFlags;
+        float m_realizedDpi;
+
     public:
         CanvasImageBrush(
             ICanvasDevice* device,
@@ -175,6 +175,37 @@ public:
 };
 
 
+ComPtr<ICanvasDrawingSession> ABI::Microsoft::Graphics::Canvas::UI::Composition::CreateCompositionDrawingSession(
+    ICompositionDrawingSurface* drawingSurface,
+    RECT const* updateRect,
+    float dpi)
+{
+    auto drawingSurfaceInterop = As<ICompositionDrawingSurfaceInterop>(drawingSurface);
+
+    ComPtr<ID2D1DeviceContext> deviceContext;
+    POINT offset;            
+    ThrowIfFailed(drawingSurfaceInterop->BeginDraw(updateRect, IID_PPV_ARGS(&deviceContext), &offset));
+
+    float offsetX = PixelsToDips(offset.x, dpi);
+    float offsetY = PixelsToDips(offset.y, dpi);
+
+    deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(offsetX, offsetY));
+    deviceContext->SetDpi(dpi, dpi);
+
+    // Although we could look up the owner using interop, via the
+    // deviceContext, drawing session will do this lazily for us if
+    // anyone actually requests it.
+    ICanvasDevice* owner = nullptr;
+
+    return CanvasDrawingSession::CreateNew(
+        As<ID2D1DeviceContext1>(deviceContext).Get(),
+        std::make_shared<CompositionDrawingSurfaceDrawingSessionAdapter>(std::move(drawingSurfaceInterop)),
+        owner,
+        nullptr,
+        D2D1_POINT_2F{ offsetX, offsetY });
+}
+
+
 HRESULT CanvasCompositionStatics::CreateDrawingSessionImpl(ICompositionDrawingSurface* drawingSurface, RECT const* updateRect, float dpi, ICanvasDrawingSession** drawingSession)
 {
     return ExceptionBoundary(
@@ -182,30 +213,8 @@ HRESULT CanvasCompositionStatics::CreateDrawingSessionImpl(ICompositionDrawingSu
         {
             CheckInPointer(drawingSurface);
             CheckAndClearOutPointer(drawingSession);
-            
-            auto drawingSurfaceInterop = As<ICompositionDrawingSurfaceInterop>(drawingSurface);
-
-            ComPtr<ID2D1DeviceContext> deviceContext;
-            POINT offset;            
-            ThrowIfFailed(drawingSurfaceInterop->BeginDraw(updateRect, IID_PPV_ARGS(&deviceContext), &offset));
-
-            float offsetX = PixelsToDips(offset.x, dpi);
-            float offsetY = PixelsToDips(offset.y, dpi);
 
-            deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(offsetX, offsetY));
-            deviceContext->SetDpi(dpi, dpi);
-
-            // Although we could look up the owner using interop, via the
-            // deviceContext, drawing session will do this lazily for us if
-            // anyone actually requests it.
-            ICanvasDevice* owner = nullptr;
-
-            auto newDs = CanvasDrawingSession::CreateNew(
-                As<ID2D1DeviceContext1>(deviceContext).Get(),
-                std::make_shared<CompositionDrawingSurfaceDrawingSessionAdapter>(std::move(drawingSurfaceInterop)),
-                owner,
-                nullptr,
-                D2D1_POINT_2F{ offsetX, offsetY });
+            auto newDs = CreateCompositionDrawingSession(drawingSurface, updateRect, dpi);
             ThrowIfFailed(newDs.CopyTo(drawingSession));
         });
 }
@@ -230,4 +239,51 @@ IFACEMETHODIMP CanvasCompositionStatics::Resize(
         });
 }
 
+
+IFACEMETHODIMP CanvasCompositionStatics::DrawSurfaces(
+    ICanvasDevice* canvasDevice,
+    uint32_t surfaceCount,
+    ICompositionDrawingSurface** surfaces,
+    ICanvasCompositionDrawSurfaceHandler* drawHandler)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(canvasDevice);
+            CheckInPointer(drawHandler);
+
+            if (surfaceCount == 0)
+                return;
+
+            CheckInPointer(surfaces);
+
+            for (uint32_t i = 0; i < surfaceCount; i++)
+            {
+                CheckInPointer(surfaces[i]);
+            }
+
+            // BeginDraw and EndDraw take the D2D lock themselves.  It is
+            // re-entrant, so holding it across the batch means they only
+            // ever re-enter it, and other threads can't get in between.
+            ComPtr<ICanvasLock> lock;
+            ThrowIfFailed(canvasDevice->Lock(&lock));
+
+            auto closableLock = As<IClosable>(lock);
+            auto unlock = MakeScopeWarden([&] { (void)closableLock->Close(); });
+
+            for (uint32_t i = 0; i < surfaceCount; i++)
+            {
+                auto drawingSession = CreateCompositionDrawingSession(surfaces[i], nullptr, DEFAULT_DPI);
+
+                auto closableSession = As<IClosable>(drawingSession);
+                auto closeOnFailure = MakeScopeWarden([&] { (void)closableSession->Close(); });
+
+                ThrowIfFailed(drawHandler->Invoke(static_cast<int32_t>(i), drawingSession.Get()));
+
+                closeOnFailure.Dismiss();
+                ThrowIfFailed(closableSession->Close());
+            }
+        });
+}
+
 #endif
@@ -54,10 +54,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ICompositionDrawingSurface* drawingSurface,
             Size size) override;
 
+        IFACEMETHODIMP DrawSurfaces(
+            ICanvasDevice* canvasDevice,
+            uint32_t surfaceCount,
+            ICompositionDrawingSurface** surfaces,
+            ICanvasCompositionDrawSurfaceHandler* drawHandler) override;
+
     private:
         HRESULT CreateDrawingSessionImpl(ICompositionDrawingSurface* drawingSurface, RECT const* rect, float dpi, ICanvasDrawingSession** drawingSession);
     };
 
+    //
+    // Begins drawing to a composition drawing surface.  When updateRect is
+    // specified the drawing session's origin is its top left corner.
+    //
+    ComPtr<ICanvasDrawingSession> CreateCompositionDrawingSession(
+        ICompositionDrawingSurface* drawingSurface,
+        RECT const* updateRectInPixels,
+        float dpi);
+
 } } } } } }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,463 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CanvasCompositionSurfaceAtlas.h"
+#include "CanvasComposition.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::UI::Composition;
+using namespace ABI::Windows::UI::Composition;
+
+
+SurfaceAtlasAllocator::SurfaceAtlasAllocator(D2D1_SIZE_U pageSize)
+    : m_pageSize(pageSize)
+{
+}
+
+
+AtlasAllocation SurfaceAtlasAllocator::Allocate(D2D1_SIZE_U size)
+{
+    if (size.width == 0 || size.height == 0 ||
+        size.width > m_pageSize.width || size.height > m_pageSize.height)
+    {
+        ThrowHR(E_INVALIDARG);
+    }
+
+    auto paddedSize = GetPaddedSize(size);
+
+    D2D1_POINT_2U position;
+
+    for (uint32_t i = 0; i < m_pages.size(); i++)
+    {
+        if (TryAllocate(m_pages[i], paddedSize.width, paddedSize.height, &position))
+            return AtlasAllocation{ i, position, size };
+    }
+
+    m_pages.push_back(Page{ 0 });
+
+    if (!TryAllocate(m_pages.back(), paddedSize.width, paddedSize.height, &position))
+        ThrowHR(E_UNEXPECTED);
+
+    return AtlasAllocation{ static_cast<uint32_t>(m_pages.size() - 1), position, size };
+}
+
+
+bool SurfaceAtlasAllocator::TryAllocate(Page& page, uint32_t width, uint32_t height, D2D1_POINT_2U* position)
+{
+    Shelf* bestShelf = nullptr;
+    size_t bestSpan = 0;
+
+    for (auto& shelf : page.Shelves)
+    {
+        if (shelf.Height < height || (bestShelf && shelf.Height >= bestShelf->Height))
+            continue;
+
+        for (size_t i = 0; i < shelf.FreeSpans.size(); i++)
+        {
+            if (shelf.FreeSpans[i].Width >= width)
+            {
+                bestShelf = &shelf;
+                bestSpan = i;
+                break;
+            }
+        }
+    }
+
+    uint32_t nextShelfY = page.Shelves.empty() ? 0 : page.Shelves.back().Y + page.Shelves.back().Height;
+    bool canAddShelf = nextShelfY + height <= m_pageSize.height;
+
+    // Rather than waste more than half of a taller shelf, start a new one.
+    if (!bestShelf || (bestShelf->Height > height * 2 && canAddShelf))
+    {
+        if (!canAddShelf)
+            return false;
+
+        page.Shelves.push_back(Shelf{ nextShelfY, height, 0, { Span{ 0, m_pageSize.width } } });
+
+        bestShelf = &page.Shelves.back();
+        bestSpan = 0;
+    }
+
+    auto& span = bestShelf->FreeSpans[bestSpan];
+
+    *position = D2D1_POINT_2U{ span.X, bestShelf->Y };
+
+    span.X += width;
+    span.Width -= width;
+
+    if (span.Width == 0)
+        bestShelf->FreeSpans.erase(bestShelf->FreeSpans.begin() + bestSpan);
+
+    bestShelf->AllocationCount++;
+    page.AllocationCount++;
+
+    return true;
+}
+
+
+void SurfaceAtlasAllocator::Free(AtlasAllocation const& allocation)
+{
+    auto& page = m_pages[allocation.Page];
+
+    auto shelf = std::find_if(page.Shelves.begin(), page.Shelves.end(),
+        [&](Shelf const& s) { return s.Y == allocation.Position.y; });
+
+    if (shelf == page.Shelves.end())
+    {
+        assert(false);
+        ThrowHR(E_UNEXPECTED);
+    }
+
+    // Put the span back in order, merging it with its neighbors.
+    auto& spans = shelf->FreeSpans;
+
+    auto span = std::lower_bound(spans.begin(), spans.end(), allocation.Position.x,
+        [](Span const& s, uint32_t x) { return s.X < x; });
+
+    span = spans.insert(span, Span{ allocation.Position.x, GetPaddedSize(allocation.Size).width });
+
+    auto next = span + 1;
+
+    if (next != spans.end() && span->X + span->Width == next->X)
+    {
+        span->Width += next->Width;
+        spans.erase(next);
+    }
+
+    if (span != spans.begin())
+    {
+        auto previous = span - 1;
+
+        if (previous->X + previous->Width == span->X)
+        {
+            previous->Width += span->Width;
+            spans.erase(span);
+        }
+    }
+
+    shelf->AllocationCount--;
+    page.AllocationCount--;
+
+    if (page.AllocationCount == 0)
+    {
+        page.Shelves.clear();
+        return;
+    }
+
+    while (page.Shelves.back().AllocationCount == 0)
+    {
+        page.Shelves.pop_back();
+    }
+}
+
+
+D2D1_SIZE_U SurfaceAtlasAllocator::GetPaddedSize(D2D1_SIZE_U size) const
+{
+    // Allocations at the right or bottom edge of a page don't need padding.
+    return D2D1_SIZE_U
+    {
+        std::min(size.width + Padding, m_pageSize.width),
+        std::min(size.height + Padding, m_pageSize.height)
+    };
+}
+
+
+static D2D1_SIZE_U ToPixelSize(Size size)
+{
+    if (size.Width <= 0 || size.Height <= 0)
+        ThrowHR(E_INVALIDARG);
+
+    // Rounded, to match CanvasComposition.Resize.
+    return D2D1_SIZE_U
+    {
+        static_cast<uint32_t>(std::round(size.Width)),
+        static_cast<uint32_t>(std::round(size.Height))
+    };
+}
+
+
+ComPtr<CanvasCompositionSurfaceAtlas> CanvasCompositionSurfaceAtlas::CreateNew(
+    ICompositionGraphicsDevice* graphicsDevice,
+    Size pageSizeInPixels)
+{
+    CheckInPointer(graphicsDevice);
+
+    auto atlas = Make<CanvasCompositionSurfaceAtlas>(graphicsDevice, ToPixelSize(pageSizeInPixels));
+    CheckMakeResult(atlas);
+
+    return atlas;
+}
+
+
+CanvasCompositionSurfaceAtlas::CanvasCompositionSurfaceAtlas(
+    ICompositionGraphicsDevice* graphicsDevice,
+    D2D1_SIZE_U pageSize)
+    : m_graphicsDevice(graphicsDevice)
+    , m_allocator(pageSize)
+{
+}
+
+
+IFACEMETHODIMP CanvasCompositionSurfaceAtlas::Allocate(Size sizeInPixels, ICanvasCompositionAtlasSurface** surface)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(surface);
+
+            auto size = ToPixelSize(sizeInPixels);
+
+            Lock lock(m_mutex);
+
+            if (!m_graphicsDevice)
+                ThrowHR(RO_E_CLOSED);
+
+            auto allocation = m_allocator.Allocate(size);
+
+            auto freeOnFailure = MakeScopeWarden([&] { m_allocator.Free(allocation); });
+
+            if (allocation.Page >= m_pageSurfaces.size())
+                m_pageSurfaces.resize(allocation.Page + 1);
+
+            auto& pageSurface = m_pageSurfaces[allocation.Page];
+
+            if (!pageSurface)
+            {
+                auto pageSize = m_allocator.GetPageSize();
+
+                ThrowIfFailed(m_graphicsDevice->CreateDrawingSurface(
+                    Size{ static_cast<float>(pageSize.width), static_cast<float>(pageSize.height) },
+                    PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                    ABI::Windows::Graphics::DirectX::DirectXAlphaMode_Premultiplied,
+                    &pageSurface));
+            }
+
+            auto newSurface = Make<CanvasCompositionAtlasSurface>(this, pageSurface.Get(), allocation);
+            CheckMakeResult(newSurface);
+
+            freeOnFailure.Dismiss();
+
+            ThrowIfFailed(newSurface.CopyTo(surface));
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionSurfaceAtlas::get_PageSize(Size* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto pageSize = m_allocator.GetPageSize();
+
+            *value = Size{ static_cast<float>(pageSize.width), static_cast<float>(pageSize.height) };
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionSurfaceAtlas::get_PageCount(int32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            *value = static_cast<int32_t>(std::count_if(m_pageSurfaces.begin(), m_pageSurfaces.end(),
+                [](ComPtr<ICompositionDrawingSurface> const& surface) { return surface != nullptr; }));
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionSurfaceAtlas::Trim()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+
+            if (!m_graphicsDevice)
+                ThrowHR(RO_E_CLOSED);
+
+            for (uint32_t i = 0; i < m_pageSurfaces.size(); i++)
+            {
+                if (m_allocator.IsPageEmpty(i))
+                    m_pageSurfaces[i].Reset();
+            }
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionSurfaceAtlas::Close()
+{
+    Lock lock(m_mutex);
+
+    m_graphicsDevice.Reset();
+    m_pageSurfaces.clear();
+
+    return S_OK;
+}
+
+
+void CanvasCompositionSurfaceAtlas::Free(AtlasAllocation const& allocation)
+{
+    Lock lock(m_mutex);
+
+    // Once the atlas is closed there is nothing left to free.
+    if (m_graphicsDevice)
+        m_allocator.Free(allocation);
+}
+
+
+CanvasCompositionAtlasSurface::CanvasCompositionAtlasSurface(
+    CanvasCompositionSurfaceAtlas* atlas,
+    ICompositionDrawingSurface* drawingSurface,
+    AtlasAllocation const& allocation)
+    : m_atlas(atlas)
+    , m_drawingSurface(drawingSurface)
+    , m_allocation(allocation)
+{
+}
+
+
+CanvasCompositionAtlasSurface::~CanvasCompositionAtlasSurface()
+{
+    (void)Close();
+}
+
+
+IFACEMETHODIMP CanvasCompositionAtlasSurface::get_DrawingSurface(ICompositionDrawingSurface** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+            ThrowIfClosed();
+
+            ThrowIfFailed(m_drawingSurface.CopyTo(value));
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionAtlasSurface::get_Bounds(Rect* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            ThrowIfClosed();
+
+            *value = Rect
+            {
+                static_cast<float>(m_allocation.Position.x),
+                static_cast<float>(m_allocation.Position.y),
+                static_cast<float>(m_allocation.Size.width),
+                static_cast<float>(m_allocation.Size.height)
+            };
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionAtlasSurface::CreateDrawingSession(ICanvasDrawingSession** drawingSession)
+{
+    return CreateDrawingSessionWithDpi(DEFAULT_DPI, drawingSession);
+}
+
+
+IFACEMETHODIMP CanvasCompositionAtlasSurface::CreateDrawingSessionWithDpi(float dpi, ICanvasDrawingSession** drawingSession)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(drawingSession);
+            ThrowIfClosed();
+
+            RECT updateRect
+            {
+                static_cast<LONG>(m_allocation.Position.x),
+                static_cast<LONG>(m_allocation.Position.y),
+                static_cast<LONG>(m_allocation.Position.x + m_allocation.Size.width),
+                static_cast<LONG>(m_allocation.Position.y + m_allocation.Size.height)
+            };
+
+            auto newDs = CreateCompositionDrawingSession(m_drawingSurface.Get(), &updateRect, dpi);
+            ThrowIfFailed(newDs.CopyTo(drawingSession));
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionAtlasSurface::ConfigureSurfaceBrush(ICompositionSurfaceBrush* brush)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(brush);
+            ThrowIfClosed();
+
+            // The offset needs ICompositionSurfaceBrush2, so check for it
+            // before changing anything.
+            auto brush2 = MaybeAs<ICompositionSurfaceBrush2>(brush);
+
+            if (!brush2)
+                ThrowHR(E_NOTIMPL);
+
+            ThrowIfFailed(brush->put_Surface(As<ICompositionSurface>(m_drawingSurface).Get()));
+            ThrowIfFailed(brush->put_Stretch(CompositionStretch_None));
+            ThrowIfFailed(brush->put_HorizontalAlignmentRatio(0));
+            ThrowIfFailed(brush->put_VerticalAlignmentRatio(0));
+
+            ThrowIfFailed(brush2->put_Offset(Numerics::Vector2
+                {
+                    -static_cast<float>(m_allocation.Position.x),
+                    -static_cast<float>(m_allocation.Position.y)
+                }));
+        });
+}
+
+
+IFACEMETHODIMP CanvasCompositionAtlasSurface::Close()
+{
+    if (m_atlas)
+    {
+        m_atlas->Free(m_allocation);
+        m_atlas.Reset();
+        m_drawingSurface.Reset();
+    }
+
+    return S_OK;
+}
+
+
+void CanvasCompositionAtlasSurface::ThrowIfClosed()
+{
+    if (!m_atlas)
+        ThrowHR(RO_E_CLOSED);
+}
+
+
+IFACEMETHODIMP CanvasCompositionSurfaceAtlasFactory::Create(
+    ICompositionGraphicsDevice* graphicsDevice,
+    Size pageSizeInPixels,
+    ICanvasCompositionSurfaceAtlas** atlas)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(atlas);
+
+            auto newAtlas = CanvasCompositionSurfaceAtlas::CreateNew(graphicsDevice, pageSizeInPixels);
+
+            ThrowIfFailed(newAtlas.CopyTo(atlas));
+        });
+}
+
+
+ActivatableClassWithFactory(CanvasCompositionSurfaceAtlas, CanvasCompositionSurfaceAtlasFactory);
+
+#endif
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace UI { namespace Composition
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Windows::UI::Composition;
+
+    struct AtlasAllocation
+    {
+        uint32_t Page;
+        D2D1_POINT_2U Position;
+        D2D1_SIZE_U Size;
+    };
+
+    //
+    // Shelf packing of rectangles, in pixels, into fixed size pages, with
+    // support for freeing them again.  Each page is divided into horizontal
+    // shelves, and each shelf keeps a sorted list of its free spans.  A
+    // rectangle goes on the shortest shelf it fits, or on a new shelf if the
+    // best one would waste more than half its height.  Freed spans are merged
+    // with their neighbors, empty shelves at the bottom of a page are
+    // removed, and a page with nothing left on it starts again from scratch.
+    //
+    // Rectangles are separated by Padding pixels, so linear filtering at
+    // their edges doesn't pick up their neighbors.
+    //
+    class SurfaceAtlasAllocator
+    {
+        struct Span
+        {
+            uint32_t X;
+            uint32_t Width;
+        };
+
+        struct Shelf
+        {
+            uint32_t Y;
+            uint32_t Height;
+            uint32_t AllocationCount;
+            std::vector<Span> FreeSpans;
+        };
+
+        struct Page
+        {
+            uint32_t AllocationCount;
+            std::vector<Shelf> Shelves;     // Sorted by Y.
+        };
+
+        D2D1_SIZE_U m_pageSize;
+        std::vector<Page> m_pages;
+
+    public:
+        static const uint32_t Padding = 1;
+
+        SurfaceAtlasAllocator(D2D1_SIZE_U pageSize);
+
+        // Adds a page if none of the existing ones have room.  Throws if the
+        // size is larger than a page.
+        AtlasAllocation Allocate(D2D1_SIZE_U size);
+
+        void Free(AtlasAllocation const& allocation);
+
+        D2D1_SIZE_U GetPageSize() const { return m_pageSize; }
+
+        uint32_t GetPageCount() const { return static_cast<uint32_t>(m_pages.size()); }
+
+        bool IsPageEmpty(uint32_t page) const { return m_pages[page].AllocationCount == 0; }
+
+    private:
+        bool TryAllocate(Page& page, uint32_t width, uint32_t height, D2D1_POINT_2U* position);
+        D2D1_SIZE_U GetPaddedSize(D2D1_SIZE_U size) const;
+    };
+
+
+    class CanvasCompositionSurfaceAtlas : public RuntimeClass<ICanvasCompositionSurfaceAtlas, IClosable>,
+                                          private LifespanTracker<CanvasCompositionSurfaceAtlas>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_UI_Composition_CanvasCompositionSurfaceAtlas, BaseTrust);
+
+        std::mutex m_mutex;
+        ComPtr<ICompositionGraphicsDevice> m_graphicsDevice;     // Null once closed.
+        SurfaceAtlasAllocator m_allocator;
+        std::vector<ComPtr<ICompositionDrawingSurface>> m_pageSurfaces;    // Indexed by page; null if trimmed.
+
+    public:
+        static ComPtr<CanvasCompositionSurfaceAtlas> CreateNew(
+            ICompositionGraphicsDevice* graphicsDevice,
+            Size pageSizeInPixels);
+
+        CanvasCompositionSurfaceAtlas(
+            ICompositionGraphicsDevice* graphicsDevice,
+            D2D1_SIZE_U pageSize);
+
+        IFACEMETHOD(Allocate)(Size sizeInPixels, ICanvasCompositionAtlasSurface** surface) override;
+        IFACEMETHOD(get_PageSize)(Size* value) override;
+        IFACEMETHOD(get_PageCount)(int32_t* value) override;
+        IFACEMETHOD(Trim)() override;
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+        // Called by CanvasCompositionAtlasSurface::Close.
+        void Free(AtlasAllocation const& allocation);
+    };
+
+
+    class CanvasCompositionAtlasSurface : public RuntimeClass<ICanvasCompositionAtlasSurface, IClosable>,
+                                          private LifespanTracker<CanvasCompositionAtlasSurface>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_UI_Composition_CanvasCompositionAtlasSurface, BaseTrust);
+
+        // Keeps the atlas alive, so the allocation can be freed on close.
+        ComPtr<CanvasCompositionSurfaceAtlas> m_atlas;
+        ComPtr<ICompositionDrawingSurface> m_drawingSurface;
+        AtlasAllocation const m_allocation;
+
+    public:
+        CanvasCompositionAtlasSurface(
+            CanvasCompositionSurfaceAtlas* atlas,
+            ICompositionDrawingSurface* drawingSurface,
+            AtlasAllocation const& allocation);
+
+        virtual ~CanvasCompositionAtlasSurface();
+
+        IFACEMETHOD(get_DrawingSurface)(ICompositionDrawingSurface** value) override;
+        IFACEMETHOD(get_Bounds)(Rect* value) override;
+        IFACEMETHOD(CreateDrawingSession)(ICanvasDrawingSession** drawingSession) override;
+        IFACEMETHOD(CreateDrawingSessionWithDpi)(float dpi, ICanvasDrawingSession** drawingSession) override;
+        IFACEMETHOD(ConfigureSurfaceBrush)(ICompositionSurfaceBrush* brush) override;
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+    private:
+        void ThrowIfClosed();
+    };
+
+
+    class CanvasCompositionSurfaceAtlasFactory
+        : public AgileActivationFactory<ICanvasCompositionSurfaceAtlasFactory>
+        , private LifespanTracker<CanvasCompositionSurfaceAtlasFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_UI_Composition_CanvasCompositionSurfaceAtlas, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICompositionGraphicsDevice* graphicsDevice,
+            Size pageSizeInPixels,
+            ICanvasCompositionSurfaceAtlas** atlas) override;
+    };
+
+} } } } } }
+
+#endif
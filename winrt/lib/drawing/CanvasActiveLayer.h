@@ -6,7 +6,9 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
+    // Apps can push thousands of layers per frame, so these are pooled.
     class CanvasActiveLayer : public RuntimeClass<ICanvasActiveLayer, IClosable>,
+                              public PooledAllocation<CanvasActiveLayer>,
                               private LifespanTracker<CanvasActiveLayer>
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasActiveLayer, BaseTrust);
@@ -3,8 +3,11 @@
 // Licensed under the MIT License. See LICENSE.txt in the project root for license information.
 
 #include "pch.h"
-
-#include "CanvasLock.h"
+#include "CanvasGpuFence.h"
+#include "effects/DownsampledBlurEffectImpl.h"
+#include "effects/shader/ComputeShaderEffectImpl.h"
+#include "effects/shader/PixelShaderEffectImpl.h"
+#include "text/CustomFontManager.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -71,6 +74,113 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
     }
 
+    bool DefaultDeviceAdapter::TryCreateD3DDeviceOnAdapter(
+        IDXGIAdapter* dxgiAdapter,
+        bool useDebugD3DDevice,
+        ComPtr<ID3D11Device>* device)
+    {
+        UINT deviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+        if (useDebugD3DDevice)
+        {
+            deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+        }
+
+        // D3D11CreateDevice requires D3D_DRIVER_TYPE_UNKNOWN when it is given an adapter.
+        ComPtr<ID3D11Device> createdDevice;
+        if (FAILED(D3D11CreateDevice(
+            dxgiAdapter,
+            D3D_DRIVER_TYPE_UNKNOWN,
+            NULL, // software handle
+            deviceFlags,
+            NULL, // feature level array
+            0,  // feature level count
+            D3D11_SDK_VERSION,
+            &createdDevice,
+            NULL,
+            NULL)))
+        {
+            return false;
+        }
+
+        *device = createdDevice;
+        return true;
+    }
+
+    bool DefaultDeviceAdapter::TryCreateSoftwareD3DDevice(
+        CanvasSoftwareDeviceOptions options,
+        bool useDebugD3DDevice,
+        ComPtr<ID3D11Device>* device)
+    {
+        UINT deviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+        if (useDebugD3DDevice)
+        {
+            deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+        }
+
+        if ((options & CanvasSoftwareDeviceOptions::SingleThreaded) != CanvasSoftwareDeviceOptions::None)
+        {
+            deviceFlags |= D3D11_CREATE_DEVICE_SINGLETHREADED;
+        }
+
+        if ((options & CanvasSoftwareDeviceOptions::NoInternalThreading) != CanvasSoftwareDeviceOptions::None)
+        {
+            deviceFlags |= D3D11_CREATE_DEVICE_PREVENT_INTERNAL_THREADING_OPTIMIZATIONS;
+        }
+
+        ComPtr<ID3D11Device> createdDevice;
+        if (FAILED(D3D11CreateDevice(
+            NULL, // adapter
+            D3D_DRIVER_TYPE_WARP,
+            NULL, // software handle
+            deviceFlags,
+            NULL, // feature level array
+            0,  // feature level count
+            D3D11_SDK_VERSION,
+            &createdDevice,
+            NULL,
+            NULL)))
+        {
+            return false;
+        }
+
+        *device = createdDevice;
+        return true;
+    }
+
+    ComPtr<IDXGIAdapter> DefaultDeviceAdapter::EnumAdapterByGpuPreference(CanvasGpuPreference gpuPreference)
+    {
+        ComPtr<IDXGIFactory1> dxgiFactory;
+        ThrowIfFailed(CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory)));
+
+        ComPtr<IDXGIAdapter> dxgiAdapter;
+
+        // IDXGIFactory6 is only available from the Windows 10 April 2018
+        // Update.  Before that there is no way to ask, so the caller uses
+        // the default adapter.
+        auto dxgiFactory6 = MaybeAs<IDXGIFactory6>(dxgiFactory);
+
+        if (!dxgiFactory6 ||
+            FAILED(dxgiFactory6->EnumAdapterByGpuPreference(0, static_cast<DXGI_GPU_PREFERENCE>(gpuPreference), IID_PPV_ARGS(&dxgiAdapter))))
+        {
+            return nullptr;
+        }
+
+        return dxgiAdapter;
+    }
+
+    ComPtr<IDXGIAdapter> DefaultDeviceAdapter::EnumAdapterByLuid(LUID adapterLuid)
+    {
+        ComPtr<IDXGIFactory4> dxgiFactory;
+        ThrowIfFailed(CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory)));
+
+        ComPtr<IDXGIAdapter> dxgiAdapter;
+
+        if (FAILED(dxgiFactory->EnumAdapterByLuid(adapterLuid, IID_PPV_ARGS(&dxgiAdapter))))
+            return nullptr;
+
+        return dxgiAdapter;
+    }
+
     ComPtr<IDXGIDevice3> DefaultDeviceAdapter::GetDxgiDevice(ID2D1Device1* d2dDevice)
     {
         //
@@ -153,10 +263,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
     SharedDeviceState::SharedDeviceState()
         : m_adapter(CanvasDeviceAdapter::GetInstance())
+        , m_fastPathReaderCount(0)
+        , m_deviceContextPoolPrewarmCount(0)
         , m_isID2D1Factory5Supported(-1)
     {
         std::fill_n(m_sharedDeviceDebugLevels, _countof(m_sharedDeviceDebugLevels), CanvasDebugLevel::None);
 
+        for (auto& fastSharedDevice : m_fastSharedDevices)
+        {
+            fastSharedDevice.store(nullptr);
+        }
+
         m_currentDebugLevel = LoadDebugLevelProperty();
     }
 
@@ -169,18 +286,50 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    ComPtr<ICanvasDevice> SharedDeviceState::TryGetSharedDeviceWithoutLock(int cacheIndex)
+    {
+        // Counted before the load, so GetSharedDevice can't release the weak
+        // reference we load while we are still using it.  These and the
+        // matching operations in GetSharedDevice are sequentially consistent.
+        m_fastPathReaderCount.fetch_add(1);
+        auto readerWarden = MakeScopeWarden([&] { m_fastPathReaderCount.fetch_sub(1); });
+
+        auto weakRef = m_fastSharedDevices[cacheIndex].load();
+
+        if (!weakRef)
+            return nullptr;
+
+        ComPtr<ICanvasDevice> device;
+        if (FAILED(weakRef->Resolve(__uuidof(ICanvasDevice), reinterpret_cast<IInspectable**>(device.GetAddressOf()))) || !device)
+            return nullptr;
+
+        // Anything other than a healthy device is left to the locked path,
+        // which replaces it (and raises DeviceLost if need be).
+        auto canvasDevice = static_cast<CanvasDevice*>(device.Get());
+
+        if (!canvasDevice->HasResource() || FAILED(canvasDevice->GetDeviceRemovedErrorCode()))
+            return nullptr;
+
+        return device;
+    }
+
     ComPtr<ICanvasDevice> SharedDeviceState::GetSharedDevice(
         bool forceSoftwareRenderer)
     {
+        int cacheIndex = forceSoftwareRenderer ? 1 : 0;
+        assert(cacheIndex < _countof(m_sharedDevices));
+
+        // Most calls find the device already there, and needn't serialize
+        // with each other.
+        if (auto device = TryGetSharedDeviceWithoutLock(cacheIndex))
+            return device;
+
         //
         // This code, unlike other non-control APIs, cannot rely on the D2D
         // API lock. SharedDeviceState keeps its own lock for this purpose.
         //
         RecursiveLock lock(m_mutex);
 
-        int cacheIndex = forceSoftwareRenderer ? 1 : 0;
-        assert(cacheIndex < _countof(m_sharedDevices));
-
         ComPtr<ICanvasDevice> device = LockWeakRef<ICanvasDevice>(m_sharedDevices[cacheIndex]);
         ComPtr<ICanvasDevice> lostDevice;
 
@@ -215,10 +364,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             // level set at the time.
             //
             device = CanvasDevice::CreateNew(forceSoftwareRenderer);
+
+            if (m_sharedDevices[cacheIndex])
+                m_retiredSharedDevices.push_back(m_sharedDevices[cacheIndex]);
+
             m_sharedDevices[cacheIndex] = AsWeak(device.Get());
             m_sharedDeviceDebugLevels[cacheIndex] = m_currentDebugLevel;
         }
 
+        // Published here, rather than only when the device is created, so
+        // that setting the debug level back again re-enables the fast path.
+        m_fastSharedDevices[cacheIndex].store(m_sharedDevices[cacheIndex].Get());
+
+        // Readers that start from now on can only load the current weak
+        // references, so once none are left over from before, the retired
+        // ones can go.  Otherwise they are released by a later call.
+        if (!m_retiredSharedDevices.empty() && m_fastPathReaderCount.load() == 0)
+            m_retiredSharedDevices.clear();
+
         lock.unlock();
 
         // Now that the lock has been released we can safely raise DeviceLost
@@ -300,6 +463,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         RecursiveLock lock(m_mutex);
 
         m_currentDebugLevel = value;
+
+        // Make the next GetSharedDevice calls check the debug level of their device.
+        for (auto& fastSharedDevice : m_fastSharedDevices)
+        {
+            fastSharedDevice.store(nullptr, std::memory_order_release);
+        }
     }
 
     // Presence of the new ID2D1Factory5 interface is used to check if we are running on a version of Windows that
@@ -359,6 +528,80 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDeviceFactory::CreateWithGpuPreference(
+        CanvasGpuPreference gpuPreference,
+        ICanvasDevice** canvasDevice)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(canvasDevice);
+
+                auto adapter = SharedDeviceState::GetInstance()->GetAdapter();
+                auto dxgiAdapter = adapter->EnumAdapterByGpuPreference(gpuPreference);
+
+                ComPtr<CanvasDevice> newCanvasDevice;
+
+                if (dxgiAdapter)
+                {
+                    try
+                    {
+                        newCanvasDevice = CanvasDevice::CreateNewOnAdapter(dxgiAdapter.Get());
+                    }
+                    catch (HResultException const&)
+                    {
+                        // Fall back as below.
+                    }
+                }
+
+                if (!newCanvasDevice)
+                    newCanvasDevice = CanvasDevice::CreateNew(false);
+
+                ThrowIfFailed(newCanvasDevice.CopyTo(canvasDevice));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::CreateFromAdapterId(
+        ABI::Windows::Graphics::DisplayAdapterId adapterId,
+        ICanvasDevice** canvasDevice)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(canvasDevice);
+
+                LUID luid{ adapterId.LowPart, adapterId.HighPart };
+
+                auto dxgiAdapter = SharedDeviceState::GetInstance()->GetAdapter()->EnumAdapterByLuid(luid);
+
+                if (!dxgiAdapter)
+                    ThrowHR(E_INVALIDARG, Strings::AdapterNotFound);
+
+                auto newCanvasDevice = CanvasDevice::CreateNewOnAdapter(dxgiAdapter.Get());
+
+                ThrowIfFailed(newCanvasDevice.CopyTo(canvasDevice));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::CreateSoftwareDevice(
+        CanvasSoftwareDeviceOptions options,
+        ICanvasDevice** canvasDevice)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(canvasDevice);
+
+                auto const validOptions = CanvasSoftwareDeviceOptions::SingleThreaded | CanvasSoftwareDeviceOptions::NoInternalThreading;
+                if ((static_cast<uint32_t>(options) & ~static_cast<uint32_t>(validOptions)) != 0)
+                    ThrowHR(E_INVALIDARG);
+
+                auto newCanvasDevice = CanvasDevice::CreateNewSoftware(options);
+
+                ThrowIfFailed(newCanvasDevice.CopyTo(canvasDevice));
+            });
+    }
+
     _Use_decl_annotations_
         IFACEMETHODIMP CanvasDeviceFactory::ActivateInstance(IInspectable **object)
     {
@@ -395,6 +638,51 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDeviceFactory::PreinitializeAsync(
+        ABI::Windows::Foundation::IAsyncOperation<CanvasDevice*>** sharedDevice)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(sharedDevice);
+
+                auto fontManager = Text::CustomFontManager::GetInstance();
+
+                {
+                    Lock lock(m_mutex);
+                    m_preinitializedFontManager = fontManager;
+                }
+
+                auto asyncOperation = Make<AsyncOperation<CanvasDevice>>(
+                    [=]
+                    {
+                        auto device = SharedDeviceState::GetInstance()->GetSharedDevice(false);
+                        auto canvasDevice = static_cast<CanvasDevice*>(device.Get());
+
+                        canvasDevice->PrewarmDeviceContextPool(1);
+
+                        // Custom effects are registered with each D2D factory,
+                        // which the shared device doesn't share with anyone.
+                        ComPtr<ID2D1Factory> d2dFactory;
+                        canvasDevice->GetD2DDevice()->GetFactory(&d2dFactory);
+
+                        auto d2dFactory1 = As<ID2D1Factory1>(d2dFactory);
+
+                        Effects::PixelShaderEffectImpl::Register(d2dFactory1.Get());
+                        Effects::ComputeShaderEffectImpl::Register(d2dFactory1.Get());
+                        Effects::DownsampledBlurEffectImpl::Register(d2dFactory1.Get());
+
+                        // This creates the shared DirectWrite factory too.
+                        fontManager->GetSystemFontFallback();
+
+                        return ComPtr<CanvasDevice>(canvasDevice);
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(sharedDevice));
+            });
+    }
+
     IFACEMETHODIMP CanvasDeviceFactory::put_DebugLevel(CanvasDebugLevel debugLevel)
     {
         return ExceptionBoundary(
@@ -415,6 +703,93 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDeviceFactory::put_DeviceContextPoolPrewarmCount(int32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                SharedDeviceState::GetInstance()->SetDeviceContextPoolPrewarmCount(static_cast<uint32_t>(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::get_DeviceContextPoolPrewarmCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = static_cast<int32_t>(SharedDeviceState::GetInstance()->GetDeviceContextPoolPrewarmCount());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasDeviceFactory::GetPerformanceCounters(CanvasPerformanceCounters* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = PerformanceCounters::GetSnapshot();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::GetObjectCounts(CanvasObjectCounts* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = ObjectCounters::GetSnapshot();
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasDeviceFactory::put_MaximumAsyncConcurrency(uint32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                AsyncScheduler::GetInstance().SetMaximumConcurrency(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::get_MaximumAsyncConcurrency(uint32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = AsyncScheduler::GetInstance().GetMaximumConcurrency();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::put_AsyncWorkItemPriority(ABI::Windows::System::Threading::WorkItemPriority value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                AsyncScheduler::GetInstance().SetPriority(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDeviceFactory::get_AsyncWorkItemPriority(ABI::Windows::System::Threading::WorkItemPriority* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = AsyncScheduler::GetInstance().GetPriority();
+            });
+    }
+
 
     //
     // ICanvasFactoryNative.
@@ -451,6 +826,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         , m_dxgiDevice(dxgiDevice)
         , m_sharedState(SharedDeviceState::GetInstance())
         , m_deviceContextPool(d2dDevice)
+        , m_maximumEffectCacheSize(std::numeric_limits<uint64_t>::max())
+        , m_gradientStopCollectionCache(MaxCachedGradientStopCollections)
+        , m_strokeStyleCache(MaxCachedStrokeStyles)
+        , m_lockStatistics(std::make_shared<CanvasLockStatisticsTracker>())
 #if WINVER > _WIN32_WINNT_WINBLUE
         , m_spriteBatchQuirk(SpriteBatchQuirk::NeedsCheck)
 #endif
@@ -462,6 +841,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
 
         InitializePrimaryOutput(dxgiDevice);
+
+        // Every device comes through here, including the ones apps and
+        // controls create to replace a lost device, so they all get the
+        // prewarmed contexts.
+        PrewarmDeviceContextPool(m_sharedState->GetDeviceContextPoolPrewarmCount());
     }
 
     ComPtr<CanvasDevice> CanvasDevice::CreateNew(
@@ -506,130 +890,307 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return device;
     }
 
-    ComPtr<ID3D11Device> CanvasDevice::MakeD3D11Device(
-        CanvasDeviceAdapter* adapter,
-        bool forceSoftwareRenderer,
-        bool useDebugD3DDevice)
+    ComPtr<CanvasDevice> CanvasDevice::CreateNewOnAdapter(
+        IDXGIAdapter* dxgiAdapter)
+    {
+        auto sharedState = SharedDeviceState::GetInstance();
+
+        auto debugLevel = sharedState->GetDebugLevel();
+        bool useDebugD3DDevice = debugLevel != CanvasDebugLevel::None;
+
+        auto d2dFactory = sharedState->GetAdapter()->CreateD2DFactory(debugLevel);
+
+        ComPtr<ID3D11Device> d3dDevice;
+        if (!sharedState->GetAdapter()->TryCreateD3DDeviceOnAdapter(dxgiAdapter, useDebugD3DDevice, &d3dDevice))
+            ThrowHR(E_FAIL);
+
+        auto dxgiDevice = As<IDXGIDevice3>(d3dDevice);
+
+        ComPtr<ID2D1Device1> d2dDevice;
+        ThrowIfFailed(d2dFactory->CreateDevice(dxgiDevice.Get(), &d2dDevice));
+
+        auto device = Make<CanvasDevice>(d2dDevice.Get(), dxgiDevice.Get());
+        CheckMakeResult(device);
+
+        return device;
+    }
+
+    ComPtr<CanvasDevice> CanvasDevice::CreateNewSoftware(
+        CanvasSoftwareDeviceOptions options)
+    {
+        auto sharedState = SharedDeviceState::GetInstance();
+
+        auto debugLevel = sharedState->GetDebugLevel();
+        bool useDebugD3DDevice = debugLevel != CanvasDebugLevel::None;
+
+        auto d2dFactory = sharedState->GetAdapter()->CreateD2DFactory(debugLevel);
+
+        // There is nothing to fall back to if WARP can't be created.
+        ComPtr<ID3D11Device> d3dDevice;
+        if (!sharedState->GetAdapter()->TryCreateSoftwareD3DDevice(options, useDebugD3DDevice, &d3dDevice))
+            ThrowHR(E_FAIL);
+
+        auto dxgiDevice = As<IDXGIDevice3>(d3dDevice);
+
+        ComPtr<ID2D1Device1> d2dDevice;
+        ThrowIfFailed(d2dFactory->CreateDevice(dxgiDevice.Get(), &d2dDevice));
+
+        auto device = Make<CanvasDevice>(d2dDevice.Get(), dxgiDevice.Get(), true);
+        CheckMakeResult(device);
+
+        return device;
+    }
+
+    ComPtr<ID3D11Device> CanvasDevice::MakeD3D11Device(
+        CanvasDeviceAdapter* adapter,
+        bool forceSoftwareRenderer,
+        bool useDebugD3DDevice)
+    {
+        ComPtr<ID3D11Device> d3dDevice;
+
+        if (adapter->TryCreateD3DDevice(forceSoftwareRenderer, useDebugD3DDevice, &d3dDevice))
+        {
+            return d3dDevice;
+        }
+
+        if (!forceSoftwareRenderer)
+        {
+            // try again using the software renderer
+            if (adapter->TryCreateD3DDevice(true, useDebugD3DDevice, &d3dDevice))
+            {
+                return d3dDevice;
+            }
+        }
+
+        // If we end up here then we failed to create a d3d device
+        ThrowHR(E_FAIL);
+    }
+
+    ComPtr<ID2D1Factory2> CanvasDevice::GetD2DFactory()
+    {
+        ComPtr<ID2D1Device1> d2dDevice = GetD2DDevice();
+
+        ComPtr<ID2D1Factory> d2dBaseFactory;
+        d2dDevice->GetFactory(&d2dBaseFactory);
+
+        ComPtr<ID2D1Factory2> d2dDerivedFactory;
+        d2dBaseFactory.As(&d2dDerivedFactory);
+
+        return d2dDerivedFactory;
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_ForceSoftwareRenderer(boolean *value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+                *value = m_forceSoftwareRenderer;
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumBitmapSizeInPixels(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                
+                auto deviceContext = GetResourceCreationDeviceContext();
+                UINT32 maximumBitmapSize = deviceContext->GetMaximumBitmapSize();
+
+                assert(maximumBitmapSize <= INT_MAX);
+
+                *value = static_cast<int32_t>(maximumBitmapSize);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::IsPixelFormatSupported(DirectXPixelFormat pixelFormat, boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                
+                *value = !!GetResourceCreationDeviceContext()->IsDxgiFormatSupported(static_cast<DXGI_FORMAT>(pixelFormat));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::IsBufferPrecisionSupported(CanvasBufferPrecision bufferPrecision, boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                
+                *value = !!GetResourceCreationDeviceContext()->IsBufferPrecisionSupported(ToD2DBufferPrecision(bufferPrecision));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumCacheSize(UINT64* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = GetResource()->GetMaximumTextureMemory();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumCacheSize(UINT64 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource()->SetMaximumTextureMemory(value);
+
+                UpdateEffectCacheBudget(value);
+
+                // Idle staging bitmaps are texture memory too, so don't let them hog more than the cache is allowed in total.
+                m_stagingBitmapPool.SetMaximumIdleSize(std::min(value, static_cast<uint64_t>(StagingBitmapPool::DefaultMaximumIdleSize)));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_LowPriority(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+     
+                *value = (GetResource()->GetRenderingPriority() == D2D1_RENDERING_PRIORITY_LOW);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_LowPriority(boolean value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource()->SetRenderingPriority(value ? D2D1_RENDERING_PRIORITY_LOW : D2D1_RENDERING_PRIORITY_NORMAL);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumDeviceContextPoolSize(int32_t* value)
     {
-        ComPtr<ID3D11Device> d3dDevice;
-
-        if (adapter->TryCreateD3DDevice(forceSoftwareRenderer, useDebugD3DDevice, &d3dDevice))
-        {
-            return d3dDevice;
-        }
-
-        if (!forceSoftwareRenderer)
-        {
-            // try again using the software renderer
-            if (adapter->TryCreateD3DDevice(true, useDebugD3DDevice, &d3dDevice))
+        return ExceptionBoundary(
+            [&]
             {
-                return d3dDevice;
-            }
-        }
+                CheckInPointer(value);
 
-        // If we end up here then we failed to create a d3d device
-        ThrowHR(E_FAIL);
+                *value = static_cast<int32_t>(m_deviceContextPool.GetMaxPoolSize());
+            });
     }
 
-    ComPtr<ID2D1Factory2> CanvasDevice::GetD2DFactory()
+    IFACEMETHODIMP CanvasDevice::put_MaximumDeviceContextPoolSize(int32_t value)
     {
-        ComPtr<ID2D1Device1> d2dDevice = GetD2DDevice();
-
-        ComPtr<ID2D1Factory> d2dBaseFactory;
-        d2dDevice->GetFactory(&d2dBaseFactory);
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 0)
+                    ThrowHR(E_INVALIDARG);
 
-        ComPtr<ID2D1Factory2> d2dDerivedFactory;
-        d2dBaseFactory.As(&d2dDerivedFactory);
+                m_deviceContextPool.SetMaxPoolSize(static_cast<uint32_t>(value));
+            });
+    }
 
-        return d2dDerivedFactory;
+    void CanvasDevice::PrewarmDeviceContextPool(uint32_t count)
+    {
+        m_deviceContextPool.Prewarm(count);
     }
 
-    IFACEMETHODIMP CanvasDevice::get_ForceSoftwareRenderer(boolean *value)
+    IFACEMETHODIMP CanvasDevice::get_MaximumEffectCacheSize(UINT64* value)
     {
         return ExceptionBoundary(
             [&]
             {
                 CheckInPointer(value);
-                GetResource();  // this ensures that Close() hasn't been called
-                *value = m_forceSoftwareRenderer;
+
+                *value = m_effectCacheBudget.GetMaximumSize();
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::get_MaximumBitmapSizeInPixels(int32_t* value)
+    IFACEMETHODIMP CanvasDevice::put_MaximumEffectCacheSize(UINT64 value)
     {
         return ExceptionBoundary(
             [&]
             {
-                CheckInPointer(value);
-                
-                auto deviceContext = GetResourceCreationDeviceContext();
-                UINT32 maximumBitmapSize = deviceContext->GetMaximumBitmapSize();
+                m_maximumEffectCacheSize = value;
 
-                assert(maximumBitmapSize <= INT_MAX);
-
-                *value = static_cast<int32_t>(maximumBitmapSize);
+                UpdateEffectCacheBudget(GetResource()->GetMaximumTextureMemory());
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::IsPixelFormatSupported(DirectXPixelFormat pixelFormat, boolean* value)
+    IFACEMETHODIMP CanvasDevice::get_EffectCacheSize(UINT64* value)
     {
         return ExceptionBoundary(
             [&]
             {
                 CheckInPointer(value);
-                
-                *value = !!GetResourceCreationDeviceContext()->IsDxgiFormatSupported(static_cast<DXGI_FORMAT>(pixelFormat));
+
+                *value = m_effectCacheBudget.GetCurrentSize();
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::IsBufferPrecisionSupported(CanvasBufferPrecision bufferPrecision, boolean* value)
+    IFACEMETHODIMP CanvasDevice::get_MaximumTextLayoutCacheCount(UINT32* value)
     {
         return ExceptionBoundary(
             [&]
             {
                 CheckInPointer(value);
-                
-                *value = !!GetResourceCreationDeviceContext()->IsBufferPrecisionSupported(ToD2DBufferPrecision(bufferPrecision));
+
+                *value = m_textLayoutCache.GetMaximumCount();
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::get_MaximumCacheSize(UINT64* value)
+    IFACEMETHODIMP CanvasDevice::put_MaximumTextLayoutCacheCount(UINT32 value)
     {
         return ExceptionBoundary(
             [&]
             {
-                CheckInPointer(value);
+                GetResource();
 
-                *value = GetResource()->GetMaximumTextureMemory();
+                m_textLayoutCache.SetMaximumCount(value);
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::put_MaximumCacheSize(UINT64 value)
+    IFACEMETHODIMP CanvasDevice::get_MaximumSurfaceBitmapCacheCount(UINT32* value)
     {
         return ExceptionBoundary(
             [&]
             {
-                GetResource()->SetMaximumTextureMemory(value);
+                CheckInPointer(value);
+
+                *value = m_surfaceBitmapCache.GetMaximumCount();
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::get_LowPriority(boolean* value)
+    IFACEMETHODIMP CanvasDevice::put_MaximumSurfaceBitmapCacheCount(UINT32 value)
     {
         return ExceptionBoundary(
             [&]
             {
-                CheckInPointer(value);
-     
-                *value = (GetResource()->GetRenderingPriority() == D2D1_RENDERING_PRIORITY_LOW);
+                GetResource();
+
+                m_surfaceBitmapCache.SetMaximumCount(value);
             });
     }
 
-    IFACEMETHODIMP CanvasDevice::put_LowPriority(boolean value)
+    IFACEMETHODIMP CanvasDevice::get_TextLayoutCacheStatistics(CanvasTextLayoutCacheStatistics* value)
     {
         return ExceptionBoundary(
             [&]
             {
-                GetResource()->SetRenderingPriority(value ? D2D1_RENDERING_PRIORITY_LOW : D2D1_RENDERING_PRIORITY_NORMAL);
+                CheckInPointer(value);
+
+                auto statistics = m_textLayoutCache.GetStatistics();
+
+                value->Count = statistics.Count;
+                value->HitCount = statistics.HitCount;
+                value->MissCount = statistics.MissCount;
+                value->EvictionCount = statistics.EvictionCount;
             });
     }
 
@@ -705,26 +1266,162 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             {
                 auto factory = GetD2DFactory();
 
-                auto lock = Make<CanvasLock>(As<ID2D1Multithread>(factory).Get());
+                auto lock = Make<CanvasLock>(As<ID2D1Multithread>(factory).Get(), m_lockStatistics);
                 CheckMakeResult(lock);
                 
                 ThrowIfFailed(lock.CopyTo(value));
             });
     }
 
+    IFACEMETHODIMP CanvasDevice::get_LockStatistics(CanvasLockStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_lockStatistics->GetStatistics();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::ResetLockStatistics()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                m_lockStatistics->Reset();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_AdapterId(ABI::Windows::Graphics::DisplayAdapterId* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto& dxgiDevice = m_dxgiDevice.EnsureNotClosed();
+
+                ComPtr<IDXGIAdapter> dxgiAdapter;
+                ThrowIfFailed(dxgiDevice->GetAdapter(&dxgiAdapter));
+
+                DXGI_ADAPTER_DESC desc;
+                ThrowIfFailed(dxgiAdapter->GetDesc(&desc));
+
+                value->LowPart = desc.AdapterLuid.LowPart;
+                value->HighPart = desc.AdapterLuid.HighPart;
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MemoryUsage(CanvasMemoryUsage* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto dxgiAdapter = MaybeGetDxgiAdapter3();
+
+                if (!dxgiAdapter)
+                    ThrowHR(E_NOTIMPL);
+
+                DXGI_QUERY_VIDEO_MEMORY_INFO info;
+                ThrowIfFailed(dxgiAdapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info));
+
+                value->Budget = info.Budget;
+                value->CurrentUsage = info.CurrentUsage;
+                value->AvailableForReservation = info.AvailableForReservation;
+                value->CurrentReservation = info.CurrentReservation;
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::InsertFence(ICanvasGpuFence** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                auto& d2dDevice = GetResource();
+                auto& dxgiDevice = m_dxgiDevice.EnsureNotClosed();
+
+                auto fence = Make<CanvasGpuFence>(d2dDevice.Get(), As<ID3D11Device>(dxgiDevice).Get());
+                CheckMakeResult(fence);
+
+                ThrowIfFailed(fence.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::add_MemoryBudgetChanged(
+        DeviceLostHandlerType* value,
+        EventRegistrationToken* token)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+                CheckInPointer(value);
+                CheckInPointer(token);
+
+                ThrowIfFailed(m_memoryBudgetChangedEventList.Add(value, token));
+
+                // Budget notifications are only registered for once someone
+                // is listening, and stay registered until the device is
+                // closed.  Older versions of DXGI never raise the event.
+                if (m_memoryBudgetNotifier.IsStarted())
+                    return;
+
+                auto dxgiAdapter = MaybeGetDxgiAdapter3();
+
+                if (!dxgiAdapter)
+                    return;
+
+                auto weakSelf = AsWeak(static_cast<ICanvasDevice*>(this));
+
+                m_memoryBudgetNotifier.Start(dxgiAdapter.Get(),
+                    [weakSelf]() mutable
+                    {
+                        auto device = LockWeakRef<ICanvasDevice>(weakSelf);
+
+                        if (device)
+                            (void)static_cast<CanvasDevice*>(device.Get())->m_memoryBudgetChangedEventList.InvokeAll(device.Get(), nullptr);
+                    });
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::remove_MemoryBudgetChanged(
+        EventRegistrationToken token)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                // Like remove_DeviceLost, this is allowed after Close.
+                ThrowIfFailed(m_memoryBudgetChangedEventList.Remove(token));
+            });
+    }
+
     IFACEMETHODIMP CanvasDevice::Close()
     {
         return ExceptionBoundary(
             [&]
             {
+                m_memoryBudgetNotifier.Stop();
                 m_deviceContextPool.Close();
+                m_effectResourceCache.Clear();
+                m_stagingBitmapPool.Clear();
+                m_renderTargetPool.Clear();
+                m_gradientStopCollectionCache.Clear();
+                m_strokeStyleCache.Clear();
+                m_textLayoutCache.Clear();
+                m_surfaceBitmapCache.Clear();
                 ThrowIfFailed(this->ResourceWrapper::Close()); // 'this->' is workaround for VS2013 calling with bad 'this' pointer
 
                 m_dxgiDevice.Close();
                 m_primaryOutput.Reset();
                 m_sharedState.reset();
-                m_histogramEffect.Reset();
-                m_atlasEffect.Reset();
+
+                Lock lock(m_histogramEffectsMutex);
+                m_histogramEffects.clear();
         });
     }
 
@@ -890,6 +1587,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         ThrowIfCreateSurfaceFailed(hr, L"CanvasBitmap", widthInPixels, heightInPixels);
 
+        if (bytes)
+            PerformanceCounters::Increment(PerformanceCounter::BitmapBytesUploaded, static_cast<uint64_t>(pitch) * heightInPixels);
+
         return d2dBitmap;
     }
 
@@ -1016,6 +1716,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 auto& d2dDevice = GetResource();
                 auto& dxgiDevice = m_dxgiDevice.EnsureNotClosed();
 
+                m_deviceContextPool.Trim();
+                m_effectResourceCache.Clear();
+                m_stagingBitmapPool.Clear();
+                m_renderTargetPool.Clear();
+                m_gradientStopCollectionCache.Clear();
+                m_strokeStyleCache.Clear();
+                m_textLayoutCache.Clear();
+                m_surfaceBitmapCache.Clear();
+
+                {
+                    Lock lock(m_histogramEffectsMutex);
+                    m_histogramEffects.clear();
+                }
+
                 D2DResourceLock lock(d2dDevice.Get());
 
                 d2dDevice->ClearResources();
@@ -1043,20 +1757,74 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_EXTEND_MODE extendMode,
         D2D1_COLOR_INTERPOLATION_MODE interpolationMode)
     {
-        auto deviceContext = GetResourceCreationDeviceContext();
+        // Stop collections are immutable, so brushes built from the same
+        // stops and options can all share one.
+        auto key = EffectResourceCache::MakeKey(
+            __uuidof(ID2D1GradientStopCollection1),
+            reinterpret_cast<BYTE const*>(stops.data()),
+            stops.size() * sizeof(D2D1_GRADIENT_STOP),
+            {
+                static_cast<uint32_t>(stops.size()),
+                static_cast<uint32_t>(preInterpolationSpace),
+                static_cast<uint32_t>(postInterpolationSpace),
+                static_cast<uint32_t>(bufferPrecision),
+                static_cast<uint32_t>(extendMode),
+                static_cast<uint32_t>(interpolationMode)
+            });
+
+        return m_gradientStopCollectionCache.GetOrCreate<ID2D1GradientStopCollection1>(key, [&]
+        {
+            auto deviceContext = GetResourceCreationDeviceContext();
+
+            ComPtr<ID2D1GradientStopCollection1> gradientStopCollection;
+            ThrowIfFailed(deviceContext->CreateGradientStopCollection(
+                stops.data(),
+                static_cast<uint32_t>(stops.size()),
+                preInterpolationSpace,
+                postInterpolationSpace,
+                bufferPrecision,
+                extendMode,
+                interpolationMode,
+                &gradientStopCollection));
+
+            return gradientStopCollection;
+        });
+    }
+
+    ComPtr<ID2D1StrokeStyle1> CanvasDevice::CreateStrokeStyle(
+        D2D1_STROKE_STYLE_PROPERTIES1 const& properties,
+        std::vector<float> const& dashes)
+    {
+        auto key = EffectResourceCache::MakeKey(
+            __uuidof(ID2D1StrokeStyle1),
+            reinterpret_cast<BYTE const*>(dashes.data()),
+            dashes.size() * sizeof(float),
+            {
+                static_cast<uint32_t>(dashes.size()),
+                static_cast<uint32_t>(properties.startCap),
+                static_cast<uint32_t>(properties.endCap),
+                static_cast<uint32_t>(properties.dashCap),
+                static_cast<uint32_t>(properties.lineJoin),
+                reinterpret_cast<uint32_t const&>(properties.miterLimit),
+                static_cast<uint32_t>(properties.dashStyle),
+                reinterpret_cast<uint32_t const&>(properties.dashOffset),
+                static_cast<uint32_t>(properties.transformType)
+            });
+
+        return m_strokeStyleCache.GetOrCreate<ID2D1StrokeStyle1>(key, [&]
+        {
+            ComPtr<ID2D1Factory> d2dFactory;
+            GetD2DDevice()->GetFactory(&d2dFactory);
 
-        ComPtr<ID2D1GradientStopCollection1> gradientStopCollection;
-        ThrowIfFailed(deviceContext->CreateGradientStopCollection(
-            stops.data(),
-            static_cast<uint32_t>(stops.size()),
-            preInterpolationSpace,
-            postInterpolationSpace,
-            bufferPrecision,
-            extendMode,
-            interpolationMode,
-            &gradientStopCollection));
+            ComPtr<ID2D1StrokeStyle1> strokeStyle;
+            ThrowIfFailed(As<ID2D1Factory2>(d2dFactory)->CreateStrokeStyle(
+                properties,
+                dashes.empty() ? nullptr : dashes.data(),
+                static_cast<uint32_t>(dashes.size()),
+                &strokeStyle));
 
-        return gradientStopCollection;
+            return strokeStyle;
+        });
     }
 
     ComPtr<ID2D1LinearGradientBrush> CanvasDevice::CreateLinearGradientBrush(
@@ -1106,6 +1874,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         DirectXPixelFormat format,
         int32_t bufferCount,
         CanvasAlphaMode alphaMode,
+        UINT flags,
         FN&& createFn)
     {
         auto& d2dDevice = GetResource();
@@ -1134,6 +1903,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         swapChainDesc.Scaling = DXGI_SCALING_STRETCH;
         swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
         swapChainDesc.AlphaMode = ToDxgiAlphaMode(alphaMode);
+        swapChainDesc.Flags = flags;
 
         ComPtr<IDXGISwapChain1> swapChain;
         ThrowIfCreateSurfaceFailed(
@@ -1145,6 +1915,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    static HRESULT CreateSwapChainForCompositionFn(IDXGIFactory2* factory, IDXGIDevice3* device, DXGI_SWAP_CHAIN_DESC1* desc, IDXGISwapChain1** swapChain)
+    {
+        return factory->CreateSwapChainForComposition(
+            device, 
+            desc, 
+            nullptr,  // restrictToOutput
+            swapChain);
+    }
+
+
     ComPtr<IDXGISwapChain1> CanvasDevice::CreateSwapChainForComposition(
         int32_t widthInPixels,
         int32_t heightInPixels,
@@ -1152,15 +1932,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         int32_t bufferCount,
         CanvasAlphaMode alphaMode)
     {
-        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode,
-            [] (IDXGIFactory2* factory, IDXGIDevice3* device, DXGI_SWAP_CHAIN_DESC1* desc, IDXGISwapChain1** swapChain)
-            {
-                return factory->CreateSwapChainForComposition(
-                    device, 
-                    desc, 
-                    nullptr,  // restrictToOutput
-                    swapChain);
-            });
+        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode, 0, CreateSwapChainForCompositionFn);
+    }
+
+    ComPtr<IDXGISwapChain1> CanvasDevice::CreateSwapChainForCompositionWithFlags(
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        DirectXPixelFormat format,
+        int32_t bufferCount,
+        CanvasAlphaMode alphaMode,
+        UINT flags)
+    {
+        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode, flags, CreateSwapChainForCompositionFn);
     }
 
     ComPtr<IDXGISwapChain1> CanvasDevice::CreateSwapChainForCoreWindow(
@@ -1171,7 +1954,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         int32_t bufferCount,
         CanvasAlphaMode alphaMode)
     {
-        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode,
+        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode, 0,
             [coreWindow] (IDXGIFactory2* factory, IDXGIDevice3* device, DXGI_SWAP_CHAIN_DESC1* desc, IDXGISwapChain1** swapChain)
             {
                 return factory->CreateSwapChainForCoreWindow(
@@ -1299,6 +2082,85 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return m_primaryOutput;
     }
 
+    bool CanvasDevice::IsTearingSupported()
+    {
+#if WINVER > _WIN32_WINNT_WINBLUE
+        auto& dxgiDevice = m_dxgiDevice.EnsureNotClosed();
+
+        ComPtr<IDXGIAdapter> dxgiAdapter;
+        ThrowIfFailed(dxgiDevice->GetAdapter(&dxgiAdapter));
+
+        ComPtr<IDXGIFactory2> dxgiFactory;
+        ThrowIfFailed(dxgiAdapter->GetParent(IID_PPV_ARGS(&dxgiFactory)));
+
+        // Older versions of DXGI don't know about tearing at all.
+        auto dxgiFactory5 = MaybeAs<IDXGIFactory5>(dxgiFactory);
+
+        if (!dxgiFactory5)
+            return false;
+
+        BOOL allowTearing = FALSE;
+
+        if (FAILED(dxgiFactory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))))
+            return false;
+
+        return !!allowTearing;
+#else
+        return false;
+#endif
+    }
+
+    EffectCacheBudget* CanvasDevice::GetEffectCacheBudget()
+    {
+        return &m_effectCacheBudget;
+    }
+
+    EffectResourceCache* CanvasDevice::GetEffectResourceCache()
+    {
+        return &m_effectResourceCache;
+    }
+
+    StagingBitmapPool* CanvasDevice::GetStagingBitmapPool()
+    {
+        return &m_stagingBitmapPool;
+    }
+
+    RenderTargetPool* CanvasDevice::GetRenderTargetPool()
+    {
+        return &m_renderTargetPool;
+    }
+
+    SurfaceBitmapCache* CanvasDevice::GetSurfaceBitmapCache()
+    {
+        return &m_surfaceBitmapCache;
+    }
+
+    TextLayoutCache* CanvasDevice::GetTextLayoutCache()
+    {
+        return &m_textLayoutCache;
+    }
+
+    void CanvasDevice::UpdateEffectCacheBudget(uint64_t maximumCacheSize)
+    {
+        //
+        // Cached effect outputs live in the same texture memory that
+        // MaximumCacheSize limits, so the effect budget can never usefully be
+        // any larger than that.  Until either size is set, the budget is left
+        // unbounded, and D2D's own texture memory limit is all that applies.
+        //
+        m_effectCacheBudget.SetMaximumSize(std::min(m_maximumEffectCacheSize, maximumCacheSize));
+    }
+
+    ComPtr<IDXGIAdapter3> CanvasDevice::MaybeGetDxgiAdapter3()
+    {
+        auto& dxgiDevice = m_dxgiDevice.EnsureNotClosed();
+
+        ComPtr<IDXGIAdapter> dxgiAdapter;
+        ThrowIfFailed(dxgiDevice->GetAdapter(&dxgiAdapter));
+
+        return MaybeAs<IDXGIAdapter3>(dxgiAdapter);
+    }
+
     void CanvasDevice::ThrowIfCreateSurfaceFailed(HRESULT hr, wchar_t const* typeName, uint32_t width, uint32_t height)
     {
         if (hr == E_INVALIDARG)
@@ -1316,40 +2178,37 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ThrowIfFailed(hr);
     }
 
-    static ComPtr<ID2D1Effect> InterlockedExchangeComPtr(ComPtr<ID2D1Effect>& target, ComPtr<ID2D1Effect>&& value)
-    {
-        auto addressOfTarget = reinterpret_cast<void* volatile*>(target.GetAddressOf());
-
-        auto exchanged = InterlockedExchangePointer(addressOfTarget, value.Detach());
-
-        ComPtr<ID2D1Effect> result;
-        result.Attach(reinterpret_cast<ID2D1Effect*>(exchanged));
-        return result;
-    }
-
     CanvasDevice::HistogramAndAtlasEffects CanvasDevice::LeaseHistogramEffect(ID2D1DeviceContext* d2dContext)
     {
-        ComPtr<ID2D1Effect> histogram = InterlockedExchangeComPtr(m_histogramEffect, nullptr);
-
-        if (!histogram)
         {
-            ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Histogram, &histogram));
+            Lock lock(m_histogramEffectsMutex);
+
+            if (!m_histogramEffects.empty())
+            {
+                auto effects = std::move(m_histogramEffects.back());
+                m_histogramEffects.pop_back();
+                return effects;
+            }
         }
 
-        ComPtr<ID2D1Effect> atlas = InterlockedExchangeComPtr(m_atlasEffect, nullptr);
+        ComPtr<ID2D1Effect> histogram;
+        ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Histogram, &histogram));
 
-        if (!atlas)
-        {
-            ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Atlas, &atlas));
-        }
+        ComPtr<ID2D1Effect> atlas;
+        ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Atlas, &atlas));
 
         return HistogramAndAtlasEffects{ histogram, atlas };
     }
 
     void CanvasDevice::ReleaseHistogramEffect(HistogramAndAtlasEffects&& effects)
     {
-        InterlockedExchangeComPtr(m_histogramEffect, std::move(effects.HistogramEffect));
-        InterlockedExchangeComPtr(m_atlasEffect, std::move(effects.AtlasEffect));
+        // Take ownership even if the pool is full, so the caller is always left empty handed.
+        auto released = std::move(effects);
+
+        Lock lock(m_histogramEffectsMutex);
+
+        if (m_histogramEffects.size() < MaxPooledHistogramEffects)
+            m_histogramEffects.push_back(std::move(released));
     }
 
 #if WINVER > _WIN32_WINNT_WINBLUE
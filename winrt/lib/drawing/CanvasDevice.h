@@ -4,7 +4,15 @@
 
 #pragma once
 
+#include "CanvasLock.h"
 #include "DeviceContextPool.h"
+#include "EffectCacheBudget.h"
+#include "EffectResourceCache.h"
+#include "MemoryBudgetNotifier.h"
+#include "RenderTargetPool.h"
+#include "StagingBitmapPool.h"
+#include "SurfaceBitmapCache.h"
+#include "TextLayoutCache.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -17,6 +25,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     class SharedDeviceState;
     class DefaultDeviceAdapter;
 
+    namespace Text
+    {
+        class CustomFontManager;
+    }
+
 
     //
     // Abstracts away some lower-level resource access, allowing unit
@@ -32,6 +45,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         virtual bool TryCreateD3DDevice(bool forceSoftwareRenderer, bool useDebugD3DDevice, ComPtr<ID3D11Device>* device) = 0;
 
+        virtual bool TryCreateD3DDeviceOnAdapter(IDXGIAdapter* dxgiAdapter, bool useDebugD3DDevice, ComPtr<ID3D11Device>* device) = 0;
+
+        virtual bool TryCreateSoftwareD3DDevice(CanvasSoftwareDeviceOptions options, bool useDebugD3DDevice, ComPtr<ID3D11Device>* device) = 0;
+
+        // These return null if there is no matching adapter.
+        virtual ComPtr<IDXGIAdapter> EnumAdapterByGpuPreference(CanvasGpuPreference gpuPreference) = 0;
+        virtual ComPtr<IDXGIAdapter> EnumAdapterByLuid(LUID adapterLuid) = 0;
+
         virtual ComPtr<IDXGIDevice3> GetDxgiDevice(ID2D1Device1* d2dDevice) = 0;
 
         virtual ComPtr<ICoreApplication> GetCoreApplication() = 0;
@@ -54,6 +75,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         virtual bool TryCreateD3DDevice(bool forceSoftwareRenderer, bool useDebugD3DDevice, ComPtr<ID3D11Device>* device) override;
 
+        virtual bool TryCreateD3DDeviceOnAdapter(IDXGIAdapter* dxgiAdapter, bool useDebugD3DDevice, ComPtr<ID3D11Device>* device) override;
+
+        virtual bool TryCreateSoftwareD3DDevice(CanvasSoftwareDeviceOptions options, bool useDebugD3DDevice, ComPtr<ID3D11Device>* device) override;
+
+        virtual ComPtr<IDXGIAdapter> EnumAdapterByGpuPreference(CanvasGpuPreference gpuPreference) override;
+        virtual ComPtr<IDXGIAdapter> EnumAdapterByLuid(LUID adapterLuid) override;
+
         virtual ComPtr<IDXGIDevice3> GetDxgiDevice(ID2D1Device1* d2dDevice) override;
 
         virtual ComPtr<ICoreApplication> GetCoreApplication() override;
@@ -124,6 +152,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         virtual ComPtr<ID2D1RadialGradientBrush> CreateRadialGradientBrush(
             ID2D1GradientStopCollection1* stopCollection) = 0;
 
+        virtual ComPtr<ID2D1StrokeStyle1> CreateStrokeStyle(
+            D2D1_STROKE_STYLE_PROPERTIES1 const& properties,
+            std::vector<float> const& dashes) = 0;
+
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForComposition(
             int32_t widthInPixels,
             int32_t heightInPixels,
@@ -131,6 +163,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int32_t bufferCount,
             CanvasAlphaMode alphaMode) = 0;
 
+        // flags are DXGI_SWAP_CHAIN_FLAG values.
+        virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCompositionWithFlags(
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            int32_t bufferCount,
+            CanvasAlphaMode alphaMode,
+            UINT flags) = 0;
+
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCoreWindow(
             ICoreWindow* coreWindow,
             int32_t widthInPixels,
@@ -154,6 +195,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         virtual ComPtr<IDXGIOutput> GetPrimaryDisplayOutput() = 0;
 
+        // Whether swap chains can be created with DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING.
+        virtual bool IsTearingSupported() = 0;
+
+        virtual EffectCacheBudget* GetEffectCacheBudget() = 0;
+        virtual EffectResourceCache* GetEffectResourceCache() = 0;
+        virtual StagingBitmapPool* GetStagingBitmapPool() = 0;
+        virtual RenderTargetPool* GetRenderTargetPool() = 0;
+        virtual SurfaceBitmapCache* GetSurfaceBitmapCache() = 0;
+        virtual TextLayoutCache* GetTextLayoutCache() = 0;
+
         virtual void ThrowIfCreateSurfaceFailed(HRESULT hr, wchar_t const* typeName, uint32_t width, uint32_t height) = 0;
 
         struct HistogramAndAtlasEffects
@@ -203,13 +254,46 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         EventSource<DeviceLostHandlerType, InvokeModeOptions<StopOnFirstError>> m_deviceLostEventList;
 
+        // Declared after the event list, so it is stopped before the handlers are released.
+        EventSource<DeviceLostHandlerType, InvokeModeOptions<StopOnFirstError>> m_memoryBudgetChangedEventList;
+        MemoryBudgetNotifier m_memoryBudgetNotifier;
+
         // Backreference keeps the shared device state alive as long as any device exists.
         std::shared_ptr<SharedDeviceState> m_sharedState;
 
         DeviceContextPool m_deviceContextPool;
 
-        ComPtr<ID2D1Effect> m_histogramEffect;
-        ComPtr<ID2D1Effect> m_atlasEffect;
+        // The effect cache budget is the smaller of MaximumEffectCacheSize and MaximumCacheSize.
+        EffectCacheBudget m_effectCacheBudget;
+        uint64_t m_maximumEffectCacheSize;
+
+        EffectResourceCache m_effectResourceCache;
+        StagingBitmapPool m_stagingBitmapPool;
+        RenderTargetPool m_renderTargetPool;
+
+        // Gradient brushes with the same stops and interpolation options share one stop collection.
+        static const size_t MaxCachedGradientStopCollections = 64;
+
+        EffectResourceCache m_gradientStopCollectionCache;
+
+        // Frozen stroke styles with the same properties share one D2D stroke style.
+        static const size_t MaxCachedStrokeStyles = 64;
+
+        EffectResourceCache m_strokeStyleCache;
+
+        TextLayoutCache m_textLayoutCache;
+        SurfaceBitmapCache m_surfaceBitmapCache;
+
+        // Shared with the CanvasLocks returned by Lock, which may outlive the device.
+        std::shared_ptr<CanvasLockStatisticsTracker> m_lockStatistics;
+
+        // Idle histogram effects, so concurrent ComputeHistogram calls (and
+        // the several effects used by one ComputeHistograms call) can each
+        // lease their own without creating new ones every time.
+        static const size_t MaxPooledHistogramEffects = 8;
+
+        std::mutex m_histogramEffectsMutex;
+        std::vector<HistogramAndAtlasEffects> m_histogramEffects;
 
 #if WINVER > _WIN32_WINNT_WINBLUE
         std::mutex m_quirkMutex;
@@ -227,6 +311,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     public:
         static ComPtr<CanvasDevice> CreateNew(bool forceSoftwareRenderer);
         static ComPtr<CanvasDevice> CreateNew(IDirect3DDevice* direct3DDevice);
+        static ComPtr<CanvasDevice> CreateNewOnAdapter(IDXGIAdapter* dxgiAdapter);
+        static ComPtr<CanvasDevice> CreateNewSoftware(CanvasSoftwareDeviceOptions options);
 
         CanvasDevice(
             ID2D1Device1* d2dDevice,
@@ -251,6 +337,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(get_LowPriority)(boolean* value) override;
         IFACEMETHOD(put_LowPriority)(boolean value) override;
 
+        IFACEMETHOD(get_MaximumDeviceContextPoolSize)(int32_t* value) override;
+        IFACEMETHOD(put_MaximumDeviceContextPoolSize)(int32_t value) override;
+
+        IFACEMETHOD(get_MaximumEffectCacheSize)(UINT64* value) override;
+        IFACEMETHOD(put_MaximumEffectCacheSize)(UINT64 value) override;
+
+        IFACEMETHOD(get_EffectCacheSize)(UINT64* value) override;
+
+        IFACEMETHOD(get_MaximumTextLayoutCacheCount)(UINT32* value) override;
+        IFACEMETHOD(put_MaximumTextLayoutCacheCount)(UINT32 value) override;
+
+        IFACEMETHOD(get_TextLayoutCacheStatistics)(CanvasTextLayoutCacheStatistics* value) override;
+
+        IFACEMETHOD(get_MaximumSurfaceBitmapCacheCount)(UINT32* value) override;
+        IFACEMETHOD(put_MaximumSurfaceBitmapCacheCount)(UINT32 value) override;
+
         IFACEMETHOD(add_DeviceLost)(DeviceLostHandlerType* value, EventRegistrationToken* token) override;
 
         IFACEMETHOD(remove_DeviceLost)(EventRegistrationToken token) override;
@@ -260,6 +362,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(RaiseDeviceLost)() override;
 
         IFACEMETHOD(Lock)(ICanvasLock** value) override;
+        IFACEMETHOD(get_LockStatistics)(CanvasLockStatistics* value) override;
+        IFACEMETHOD(ResetLockStatistics)() override;
+
+        IFACEMETHOD(get_AdapterId)(ABI::Windows::Graphics::DisplayAdapterId* value) override;
+
+        IFACEMETHOD(get_MemoryUsage)(CanvasMemoryUsage* value) override;
+
+        IFACEMETHOD(InsertFence)(ICanvasGpuFence** value) override;
+
+        IFACEMETHOD(add_MemoryBudgetChanged)(DeviceLostHandlerType* value, EventRegistrationToken* token) override;
+
+        IFACEMETHOD(remove_MemoryBudgetChanged)(EventRegistrationToken token) override;
 
         //
         // ICanvasResourceCreator
@@ -327,6 +441,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             D2D1_EXTEND_MODE extendMode,
             D2D1_COLOR_INTERPOLATION_MODE interpolationMode) override;
 
+        virtual ComPtr<ID2D1StrokeStyle1> CreateStrokeStyle(
+            D2D1_STROKE_STYLE_PROPERTIES1 const& properties,
+            std::vector<float> const& dashes) override;
+
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForComposition(
             int32_t widthInPixels,
             int32_t heightInPixels,
@@ -334,6 +452,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int32_t bufferCount,
             CanvasAlphaMode alphaMode) override;
 
+        virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCompositionWithFlags(
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            int32_t bufferCount,
+            CanvasAlphaMode alphaMode,
+            UINT flags) override;
+
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCoreWindow(
             ICoreWindow* coreWindow,
             int32_t widthInPixels,
@@ -357,8 +483,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         virtual DeviceContextLease GetResourceCreationDeviceContext() override final;
 
+        // Creates up to count pooled device contexts ahead of time.
+        void PrewarmDeviceContextPool(uint32_t count);
+
         virtual ComPtr<IDXGIOutput> GetPrimaryDisplayOutput() override;
 
+        virtual bool IsTearingSupported() override;
+
+        virtual EffectCacheBudget* GetEffectCacheBudget() override;
+        virtual EffectResourceCache* GetEffectResourceCache() override;
+        virtual StagingBitmapPool* GetStagingBitmapPool() override;
+        virtual RenderTargetPool* GetRenderTargetPool() override;
+        virtual SurfaceBitmapCache* GetSurfaceBitmapCache() override;
+        virtual TextLayoutCache* GetTextLayoutCache() override;
+
         virtual void ThrowIfCreateSurfaceFailed(HRESULT hr, wchar_t const* typeName, uint32_t width, uint32_t height) override;
 
         virtual HistogramAndAtlasEffects LeaseHistogramEffect(ID2D1DeviceContext* d2dContext) override;
@@ -390,6 +528,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         HRESULT GetDeviceRemovedErrorCode();
 
     private:
+        void UpdateEffectCacheBudget(uint64_t maximumCacheSize);
+
+        // Null if DXGI is too old to report memory budgets.
+        ComPtr<IDXGIAdapter3> MaybeGetDxgiAdapter3();
+
         static ComPtr<ID3D11Device> MakeD3D11Device(CanvasDeviceAdapter* adapter, bool forceSoftwareRenderer, bool useDebugD3DDevice);
 
         template<typename FN>
@@ -399,6 +542,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             DirectXPixelFormat format,
             int32_t bufferCount,
             CanvasAlphaMode alphaMode,
+            UINT flags,
             FN&& createFn);
 
         ComPtr<ID2D1Factory2> GetD2DFactory();
@@ -422,9 +566,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         WeakRef m_sharedDevices[2];
 
+        // Copies of m_sharedDevices that GetSharedDevice reads before taking
+        // the lock.  Null until a device is created, and again whenever the
+        // debug level changes, so that those calls take the locked path.  A
+        // reader may still be resolving a weak reference after it has been
+        // replaced, so replaced ones are kept in m_retiredSharedDevices.
+        // m_fastPathReaderCount counts the readers between loading a weak
+        // reference and finishing with it; the retired list is cleared,
+        // under the lock, whenever the count is seen to be zero after a new
+        // weak reference has been published.
+        std::atomic<IWeakReference*> m_fastSharedDevices[2];
+        std::atomic<uint32_t> m_fastPathReaderCount;
+        std::vector<WeakRef> m_retiredSharedDevices;
+
         CanvasDebugLevel m_sharedDeviceDebugLevels[2];
         CanvasDebugLevel m_currentDebugLevel;
 
+        std::atomic<uint32_t> m_deviceContextPoolPrewarmCount;
+
         int m_isID2D1Factory5Supported; // negative = not yet checked.
 
         std::recursive_mutex m_mutex;
@@ -439,11 +598,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         CanvasDebugLevel GetDebugLevel();
         void SetDebugLevel(CanvasDebugLevel const& value);
 
+        uint32_t GetDeviceContextPoolPrewarmCount() const { return m_deviceContextPoolPrewarmCount.load(); }
+        void SetDeviceContextPoolPrewarmCount(uint32_t value) { m_deviceContextPoolPrewarmCount.store(value); }
+
         bool IsID2D1Factory5Supported();
 
         CanvasDeviceAdapter* GetAdapter() const { return m_adapter.get(); }
 
     private:
+        ComPtr<ICanvasDevice> TryGetSharedDeviceWithoutLock(int cacheIndex);
+
         CanvasDebugLevel LoadDebugLevelProperty();
         void SaveDebugLevelProperty(CanvasDebugLevel debugLevel);
 
@@ -469,6 +633,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasDevice, BaseTrust);
 
+        // Text state only lives as long as something refers to it, so
+        // PreinitializeAsync parks a reference here to keep its work from
+        // being thrown away before the app first uses text.
+        std::mutex m_mutex;
+        std::shared_ptr<Text::CustomFontManager> m_preinitializedFontManager;
+
     public:
         //
         // ActivationFactory
@@ -488,6 +658,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             IDirect3DDevice* direct3DDevice,
             ICanvasDevice** canvasDevice) override;
 
+        IFACEMETHOD(CreateWithGpuPreference)(
+            CanvasGpuPreference gpuPreference,
+            ICanvasDevice** canvasDevice) override;
+
+        IFACEMETHOD(CreateFromAdapterId)(
+            ABI::Windows::Graphics::DisplayAdapterId adapterId,
+            ICanvasDevice** canvasDevice) override;
+
+        IFACEMETHOD(CreateSoftwareDevice)(
+            CanvasSoftwareDeviceOptions options,
+            ICanvasDevice** canvasDevice) override;
+
         //
         // ICanvasDeviceStatics
         //
@@ -498,9 +680,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             boolean forceSoftwareRenderer,
             ICanvasDevice** device);
 
+        IFACEMETHOD(PreinitializeAsync)(
+            ABI::Windows::Foundation::IAsyncOperation<CanvasDevice*>** sharedDevice);
+
         IFACEMETHOD(put_DebugLevel)(CanvasDebugLevel debugLevel);
         IFACEMETHOD(get_DebugLevel)(CanvasDebugLevel* debugLevel);
 
+        IFACEMETHOD(put_DeviceContextPoolPrewarmCount)(int32_t value);
+        IFACEMETHOD(get_DeviceContextPoolPrewarmCount)(int32_t* value);
+
+        IFACEMETHOD(GetPerformanceCounters)(CanvasPerformanceCounters* value);
+        IFACEMETHOD(GetObjectCounts)(CanvasObjectCounts* value);
+
+        IFACEMETHOD(put_MaximumAsyncConcurrency)(uint32_t value);
+        IFACEMETHOD(get_MaximumAsyncConcurrency)(uint32_t* value);
+
+        IFACEMETHOD(put_AsyncWorkItemPriority)(ABI::Windows::System::Threading::WorkItemPriority value);
+        IFACEMETHOD(get_AsyncWorkItemPriority)(ABI::Windows::System::Threading::WorkItemPriority* value);
+
         //
         // ICanvasFactoryNative.
         //
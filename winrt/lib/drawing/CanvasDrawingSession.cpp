@@ -5,6 +5,12 @@
 #include "pch.h"
 
 #include "CanvasActiveLayer.h"
+#include "CanvasDrawingState.h"
+#include "CanvasDrawingTrace.h"
+#include "CanvasImageTileCache.h"
+#include "CanvasInkCache.h"
+#include "CanvasProfileScope.h"
+#include "CanvasRenderNode.h"
 #include "CanvasSpriteBatch.h"
 #include "text/CanvasTextFormat.h"
 #include "text/CanvasTextRenderingParameters.h"
@@ -13,7 +19,10 @@
 #include "text/TextUtilities.h"
 #include "text/InternalDWriteTextRenderer.h"
 #include "text/DrawGlyphRunHelper.h"
+#include "text/CanvasGlyphRun.h"
+#include "text/CanvasGlyphAtlas.h"
 #include "svg/CanvasSvgDocument.h"
+#include "images/CanvasCommandList.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -143,6 +152,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
         if (m_targetHasActiveDrawingSession)
             *m_targetHasActiveDrawingSession = true;
+
+        EventWrite_CanvasDrawingSession_Start();
     }
 
 
@@ -162,6 +173,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         
                 ReleaseResource();
 
+                // Only the first Close ends the session (the destructor closes again).
+                auto sessionEnd = MakeScopeWarden(
+                    [&]
+                    {
+                        if (deviceContext)
+                            EventWrite_CanvasDrawingSession_Stop();
+                    });
+
+                if (!m_pushedClipIsAxisAligned.empty())
+                    ThrowHR(E_FAIL, Strings::DidNotPopClip);
+
                 if (!m_activeLayerIds.empty())
                     ThrowHR(E_FAIL, Strings::DidNotPopLayer);
 
@@ -177,11 +199,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     auto adapter = m_adapter;
                     m_adapter.reset();
 
+                    EventWrite_CanvasDrawingSession_EndDraw_Start();
+                    auto endDrawEnd = MakeScopeWarden([] { EventWrite_CanvasDrawingSession_EndDraw_Stop(); });
+
                     adapter->EndDraw(deviceContext.Get());
                 }
 
-                m_solidColorBrush.Reset();
+                m_solidColorBrushes.Clear();
                 m_defaultTextFormat.Reset();
+                m_drawImageEffects = DrawImageEffectCache();
                 m_owner.Reset();
 #if WINVER > _WIN32_WINNT_WINBLUE
                 m_inkD2DRenderer.Reset();
@@ -197,7 +223,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return ExceptionBoundary(
             [&]
             {
-                GetResource()->Clear(ToD2DColor(color));
+                ClearImpl(ToD2DColor(color));
             });
     }
 
@@ -208,17 +234,34 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return ExceptionBoundary(
             [&]
             {
-                GetResource()->Clear(ToD2DColor(color));
+                ClearImpl(ToD2DColor(color));
             });
     }
 
 
+    void CanvasDrawingSession::ClearImpl(
+        D2D1_COLOR_F const& color)
+    {
+        auto& deviceContext = GetResource();
+
+        deviceContext->Clear(color);
+
+        if (auto trace = GetTrace())
+            trace->RecordClear(GetTraceState(deviceContext.Get()), color);
+    }
+
+
     IFACEMETHODIMP CanvasDrawingSession::Flush()
     {
         return ExceptionBoundary(
             [&]
             {
-                ThrowIfFailed(GetResource()->Flush(nullptr, nullptr));
+                auto& deviceContext = GetResource();
+
+                EventWrite_CanvasDrawingSession_Flush_Start();
+                auto flushEnd = MakeScopeWarden([] { EventWrite_CanvasDrawingSession_Flush_Stop(); });
+
+                ThrowIfFailed(deviceContext->Flush(nullptr, nullptr));
             });
     }
 
@@ -422,6 +465,95 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    // Works out which part of the drawing session coordinate space ends up
+    // inside the target bitmap.  Returns false if the target has no bounds,
+    // as is the case when drawing into a command list.
+    static bool TryGetVisibleRect(ID2D1DeviceContext* deviceContext, Rect* visibleRect)
+    {
+        ComPtr<ID2D1Image> target;
+        deviceContext->GetTarget(&target);
+
+        auto targetBitmap = MaybeAs<ID2D1Bitmap>(target);
+        if (!targetBitmap)
+            return false;
+
+        float dpiX, dpiY;
+        deviceContext->GetDpi(&dpiX, &dpiY);
+
+        auto pixelSize = targetBitmap->GetPixelSize();
+
+        auto right = PixelsToDips(pixelSize.width, dpiX);
+        auto bottom = PixelsToDips(pixelSize.height, dpiY);
+
+        D2D1::Matrix3x2F transform;
+        deviceContext->GetTransform(&transform);
+
+        if (!transform.Invert())
+        {
+            *visibleRect = Rect{};
+            return true;
+        }
+
+        D2D1_POINT_2F corners[] =
+        {
+            transform.TransformPoint(D2D1::Point2F(0, 0)),
+            transform.TransformPoint(D2D1::Point2F(right, 0)),
+            transform.TransformPoint(D2D1::Point2F(0, bottom)),
+            transform.TransformPoint(D2D1::Point2F(right, bottom)),
+        };
+
+        auto bounds = D2D1::RectF(corners[0].x, corners[0].y, corners[0].x, corners[0].y);
+
+        for (auto& corner : corners)
+        {
+            bounds.left = std::min(bounds.left, corner.x);
+            bounds.top = std::min(bounds.top, corner.y);
+            bounds.right = std::max(bounds.right, corner.x);
+            bounds.bottom = std::max(bounds.bottom, corner.y);
+        }
+
+        *visibleRect = FromD2DRect(bounds);
+        return true;
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawCachedImage(
+        ICanvasImage* image,
+        Vector2 offset,
+        ICanvasImageTileCache* tileCache)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                CheckInPointer(image);
+                CheckInPointer(tileCache);
+
+                Rect visibleRect;
+
+                if (!TryGetVisibleRect(deviceContext.Get(), &visibleRect))
+                {
+                    // Nothing can be scrolled out of view of a command list, so there are no tiles to reuse.
+                    ThrowIfFailed(DrawImageAtOffset(image, offset));
+                    return;
+                }
+
+                visibleRect.X -= offset.X;
+                visibleRect.Y -= offset.Y;
+
+                float dpiX, dpiY;
+                deviceContext->GetDpi(&dpiX, &dpiY);
+
+                auto cachedImage = static_cast<CanvasImageTileCache*>(tileCache)->Update(image, visibleRect, dpiX);
+
+                if (cachedImage)
+                {
+                    ThrowIfFailed(DrawImageAtOffset(cachedImage.Get(), offset));
+                }
+            });
+    }
+
+
     class DrawImageWorker
     {
         ICanvasDevice* m_canvasDevice;
@@ -436,8 +568,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ComPtr<ID2D1Image> m_opacityEffectOutput;
         ComPtr<ID2D1Image> m_borderEffectOutput;
 
+        DrawImageEffectCache* m_sessionEffects;
+        DrawImageEffectCache m_transientEffects;
+        DrawImageEffectCache* m_effectCache;
+
     public:
-        DrawImageWorker(ICanvasDevice* canvasDevice, ID2D1DeviceContext1* deviceContext, Vector2* offset, Rect* destinationRect, Rect* sourceRect, float opacity, CanvasImageInterpolation interpolation)
+        DrawImageWorker(ICanvasDevice* canvasDevice, ID2D1DeviceContext1* deviceContext, DrawImageEffectCache* effectCache, Vector2* offset, Rect* destinationRect, Rect* sourceRect, float opacity, CanvasImageInterpolation interpolation)
             : m_canvasDevice(canvasDevice)
             , m_deviceContext(deviceContext)
             , m_offset(offset)
@@ -445,13 +581,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             , m_sourceRect(sourceRect)
             , m_opacity(opacity)
             , m_interpolation(interpolation)
+            , m_sessionEffects(effectCache)
+            , m_effectCache(nullptr)
         {
             assert(m_offset || m_destinationRect);
+            assert(m_sessionEffects);
 
             if (m_sourceRect)
                 m_d2dSourceRect = ToD2DRect(*sourceRect);
         }
 
+        ~DrawImageWorker()
+        {
+            // Don't let the cached effects keep the images we just drew alive.
+            if (m_effectCache == m_sessionEffects)
+            {
+                ClearInput(m_effectCache->OpacityEffect.Get());
+                ClearInput(m_effectCache->OpacityDpiCompensationEffect.Get());
+                ClearInput(m_effectCache->BorderEffect.Get());
+                ClearInput(m_effectCache->BorderDpiCompensationEffect.Get());
+            }
+        }
+
         void DrawBitmap(ICanvasBitmap* bitmap, Numerics::Matrix4x4* perspective)
         {
             DrawBitmap(As<ICanvasBitmapInternal>(bitmap).Get(), perspective);
@@ -472,8 +623,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             {
                 // If DrawBitmap cannot handle this request, we must use the DrawImage slow path.
 
-                auto internalImage = As<ICanvasImageInternal>(image);
-                auto d2dImage = internalImage->GetD2DImage(m_canvasDevice, m_deviceContext);
+                auto d2dImage = MaybeGetCulledCommandList(image);
+
+                if (!d2dImage)
+                {
+                    auto internalImage = As<ICanvasImageInternal>(image);
+                    d2dImage = internalImage->GetD2DImage(m_canvasDevice, m_deviceContext);
+                }
 
                 auto d2dInterpolationMode = static_cast<D2D1_INTERPOLATION_MODE>(m_interpolation);
                 auto d2dCompositeMode = composite ? static_cast<D2D1_COMPOSITE_MODE>(*composite)
@@ -487,6 +643,30 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
 
     private:
+        // Command lists with a spatial index can leave out whatever is outside the source rectangle.
+        ComPtr<ID2D1Image> MaybeGetCulledCommandList(ICanvasImage* image)
+        {
+            if (!m_sourceRect)
+                return nullptr;
+
+            auto commandList = MaybeAs<ICanvasCommandListInternal>(image);
+            if (!commandList)
+                return nullptr;
+
+            // Leave a margin for the filtering of scaled draws, which can sample slightly outside the source rectangle.
+            const float margin = 2;
+
+            D2D1_RECT_F visibleRectangle
+            {
+                m_d2dSourceRect.left - margin,
+                m_d2dSourceRect.top - margin,
+                m_d2dSourceRect.right + margin,
+                m_d2dSourceRect.bottom + margin
+            };
+
+            return commandList->GetCulledD2DImage(m_canvasDevice, m_deviceContext, visibleRectangle);
+        }
+
         void DrawBitmap(ICanvasBitmapInternal* internalBitmap, Numerics::Matrix4x4* perspective)
         {
             auto& d2dBitmap = internalBitmap->GetD2DBitmap();
@@ -551,9 +731,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             if (m_opacity >= 1.0f)
                 return d2dImage;
 
-            ComPtr<ID2D1Effect> opacityEffect;
-
-            ThrowIfFailed(m_deviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &opacityEffect));
+            auto opacityEffect = GetCachedEffect(GetEffectCache()->OpacityEffect, CLSID_D2D1ColorMatrix);
 
             if (auto bitmap = MaybeAs<ID2D1Bitmap>(d2dImage))
             {
@@ -562,7 +740,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 // the bitmap's DPI before passing it to the color matrix effect
                 // (since effects by default ignore a bitmap's DPI).
                 //
-                ThrowIfFailed(D2D1::SetDpiCompensatedEffectInput(m_deviceContext, opacityEffect.Get(), 0, bitmap.Get()));
+                SetDpiCompensatedEffectInput(GetEffectCache()->OpacityDpiCompensationEffect, opacityEffect, bitmap.Get());
             }
             else
             {
@@ -704,14 +882,65 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             // image, but it is non trivial to detect that for different filter modes, and this
             // is a slow path in any case so we keep it simple and always add the border.
 
-            ComPtr<ID2D1Effect> borderEffect;
-            ThrowIfFailed(m_deviceContext->CreateEffect(CLSID_D2D1Border, &borderEffect));
-            ThrowIfFailed(D2D1::SetDpiCompensatedEffectInput(m_deviceContext, borderEffect.Get(), 0, d2dBitmap.Get()));
+            auto borderEffect = GetCachedEffect(GetEffectCache()->BorderEffect, CLSID_D2D1Border);
+            SetDpiCompensatedEffectInput(GetEffectCache()->BorderDpiCompensationEffect, borderEffect, d2dBitmap.Get());
 
             borderEffect->GetOutput(&m_borderEffectOutput);
             return m_borderEffectOutput.Get();
         }
 
+        ID2D1Effect* GetCachedEffect(ComPtr<ID2D1Effect>& cachedEffect, IID const& effectId)
+        {
+            if (!cachedEffect)
+                ThrowIfFailed(m_deviceContext->CreateEffect(effectId, &cachedEffect));
+
+            return cachedEffect.Get();
+        }
+
+        // A command list holds on to the effects drawn into it, and plays them
+        // back with whatever inputs and properties they have by then. So while
+        // recording one, each draw gets effects of its own instead of sharing
+        // the session's cached ones.
+        DrawImageEffectCache* GetEffectCache()
+        {
+            if (!m_effectCache)
+            {
+                ComPtr<ID2D1Image> target;
+                m_deviceContext->GetTarget(&target);
+
+                if (MaybeAs<ID2D1CommandList>(target))
+                    m_effectCache = &m_transientEffects;
+                else
+                    m_effectCache = m_sessionEffects;
+            }
+
+            return m_effectCache;
+        }
+
+        // Equivalent to D2D1::SetDpiCompensatedEffectInput, except that it
+        // reuses a cached DPI compensation effect instead of creating a new one.
+        void SetDpiCompensatedEffectInput(ComPtr<ID2D1Effect>& cachedDpiCompensationEffect, ID2D1Effect* effect, ID2D1Bitmap* bitmap)
+        {
+            auto dpiCompensationEffect = GetCachedEffect(cachedDpiCompensationEffect, CLSID_D2D1DpiCompensation);
+
+            dpiCompensationEffect->SetInput(0, bitmap);
+
+            D2D1_POINT_2F bitmapDpi;
+            bitmap->GetDpi(&bitmapDpi.x, &bitmapDpi.y);
+
+            ThrowIfFailed(dpiCompensationEffect->SetValue(D2D1_DPICOMPENSATION_PROP_INPUT_DPI, bitmapDpi));
+            ThrowIfFailed(dpiCompensationEffect->SetValue(D2D1_DPICOMPENSATION_PROP_INTERPOLATION_MODE, D2D1_DPICOMPENSATION_INTERPOLATION_MODE_LINEAR));
+            ThrowIfFailed(dpiCompensationEffect->SetValue(D2D1_DPICOMPENSATION_PROP_BORDER_MODE, D2D1_BORDER_MODE_HARD));
+
+            effect->SetInputEffect(0, dpiCompensationEffect);
+        }
+
+        static void ClearInput(ID2D1Effect* effect)
+        {
+            if (effect)
+                effect->SetInput(0, nullptr);
+        }
+
         D2D1_RECT_F* GetD2DSourceRect()
         {
             if (m_sourceRect)
@@ -735,7 +964,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             auto& deviceContext = GetResource();
             CheckInPointer(image);
 
-            DrawImageWorker(GetDevice().Get(), deviceContext.Get(), offset, destinationRect, sourceRect, opacity, interpolation).DrawImage(image, composite);
+            DrawImageWorker(GetDevice().Get(), deviceContext.Get(), &m_drawImageEffects, offset, destinationRect, sourceRect, opacity, interpolation).DrawImage(image, composite);
+
+            if (auto trace = GetTrace())
+                trace->RecordSkipped();
         });
 
     }
@@ -754,7 +986,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             auto& deviceContext = GetResource();
             CheckInPointer(bitmap);
 
-            DrawImageWorker(GetDevice().Get(), deviceContext.Get(), offset, destinationRect, sourceRect, opacity, interpolation).DrawBitmap(bitmap, perspective);
+            DrawImageWorker(GetDevice().Get(), deviceContext.Get(), &m_drawImageEffects, offset, destinationRect, sourceRect, opacity, interpolation).DrawBitmap(bitmap, perspective);
+
+            if (auto trace = GetTrace())
+                trace->RecordSkipped();
         });
     }
 
@@ -978,6 +1213,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        if (auto trace = GetTrace())
+            trace->RecordLine(GetTraceState(deviceContext.Get()), point0, point1, brush, strokeWidth, strokeStyle);
     }
 
 
@@ -1183,6 +1421,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        if (auto trace = GetTrace())
+            trace->RecordRectangle(GetTraceState(deviceContext.Get()), DrawingTraceOp::DrawRectangle, rect, brush, strokeWidth, strokeStyle);
     }
 
 
@@ -1256,6 +1497,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->FillRectangle(
             &d2dRect,
             brush);
+
+        if (auto trace = GetTrace())
+            trace->RecordRectangle(GetTraceState(deviceContext.Get()), DrawingTraceOp::FillRectangle, rect, brush);
     }
 
 
@@ -1644,6 +1888,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        if (auto trace = GetTrace())
+            trace->RecordRoundedRectangle(GetTraceState(deviceContext.Get()), DrawingTraceOp::DrawRoundedRectangle, rect, radiusX, radiusY, brush, strokeWidth, strokeStyle);
     }
 
 
@@ -1735,6 +1982,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->FillRoundedRectangle(
             &d2dRoundedRect,
             brush);
+
+        if (auto trace = GetTrace())
+            trace->RecordRoundedRectangle(GetTraceState(deviceContext.Get()), DrawingTraceOp::FillRoundedRectangle, rect, radiusX, radiusY, brush);
     }
 
 
@@ -1978,6 +2228,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        if (auto trace = GetTrace())
+            trace->RecordEllipse(GetTraceState(deviceContext.Get()), DrawingTraceOp::DrawEllipse, centerPoint, radiusX, radiusY, brush, strokeWidth, strokeStyle);
     }
 
 
@@ -2065,6 +2318,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->FillEllipse(
             &d2dEllipse,
             brush);
+
+        if (auto trace = GetTrace())
+            trace->RecordEllipse(GetTraceState(deviceContext.Get()), DrawingTraceOp::FillEllipse, centerPoint, radiusX, radiusY, brush);
     }
 
 
@@ -2368,10 +2624,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return ExceptionBoundary(
             [&]
             {
+                uint32_t textLength;
+                auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+
                 DrawTextAtPointImpl(
-                    text, 
-                    point, 
-                    ToD2DBrush(brush).Get(), 
+                    textBuffer,
+                    textLength,
+                    point,
+                    ToD2DBrush(brush).Get(),
                     format);
             });
     }
@@ -2386,8 +2646,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return ExceptionBoundary(
             [&]
             {
+                uint32_t textLength;
+                auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+
                 DrawTextAtRectImpl(
-                    text,
+                    textBuffer,
+                    textLength,
                     rectangle,
                     ToD2DBrush(brush).Get(),
                     format);
@@ -2436,10 +2700,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return ExceptionBoundary(
             [&]
             {
+                uint32_t textLength;
+                auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+
                 DrawTextAtPointImpl(
-                    text, 
-                    point, 
-                    GetColorBrush(color), 
+                    textBuffer,
+                    textLength,
+                    point,
+                    GetColorBrush(color),
                     format);
             });
     }
@@ -2454,10 +2722,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return ExceptionBoundary(
             [&]
             {
+                uint32_t textLength;
+                auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+
                 DrawTextAtRectImpl(
-                    text, 
-                    rectangle, 
-                    GetColorBrush(color), 
+                    textBuffer,
+                    textLength,
+                    rectangle,
+                    GetColorBrush(color),
                     format);
             });
     }
@@ -2495,8 +2767,62 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    //
+    // The text goes straight from the caller's buffer to D2D, so it needn't
+    // be copied into an HSTRING first.
+    //
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawTextFromBufferAtPoint(
+        wchar_t const* text,
+        UINT32 textLength,
+        float x,
+        float y,
+        IUnknown* brush,
+        IUnknown* format)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(brush);
+
+                DrawTextAtPointImpl(
+                    text,
+                    textLength,
+                    Vector2{ x, y },
+                    ToD2DBrush(As<ICanvasBrush>(brush).Get()).Get(),
+                    format ? As<ICanvasTextFormat>(format).Get() : nullptr);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawTextFromBufferAtRect(
+        wchar_t const* text,
+        UINT32 textLength,
+        float x,
+        float y,
+        float w,
+        float h,
+        IUnknown* brush,
+        IUnknown* format)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(brush);
+
+                DrawTextAtRectImpl(
+                    text,
+                    textLength,
+                    Rect{ x, y, w, h },
+                    ToD2DBrush(As<ICanvasBrush>(brush).Get()).Get(),
+                    format ? As<ICanvasTextFormat>(format).Get() : nullptr);
+            });
+    }
+
+
     void CanvasDrawingSession::DrawTextAtRectImpl(
-        HSTRING text,
+        wchar_t const* text,
+        uint32_t textLength,
         Rect const& rect,
         ID2D1Brush* brush,
         ICanvasTextFormat* format)
@@ -2505,15 +2831,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             format = GetDefaultTextFormat();
 
         auto formatInternal = As<ICanvasTextFormatInternal>(format);
+
+        // The version is read before the format it describes, so a layout
+        // cached under it can never predate a property change.
+        auto formatVersion = formatInternal->GetRealizedTextFormatVersion();
         auto realizedFormat = formatInternal->GetRealizedTextFormat();
         auto drawTextOptions = formatInternal->GetDrawTextOptions();
         
-        DrawTextImpl(text, rect, brush, realizedFormat.Get(), drawTextOptions);
+        DrawTextImpl(text, textLength, rect, brush, realizedFormat.Get(), formatVersion, drawTextOptions);
     }
 
 
     void CanvasDrawingSession::DrawTextAtPointImpl(
-        HSTRING text,
+        wchar_t const* text,
+        uint32_t textLength,
         Vector2 const& point,
         ID2D1Brush* brush,
         ICanvasTextFormat* format)
@@ -2528,10 +2859,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         Rect rect{ point.X, point.Y, 0, 0 };
 
         auto formatInternal = As<ICanvasTextFormatInternal>(format);
+        auto formatVersion = formatInternal->GetRealizedTextFormatVersion();
         auto drawTextOptions = formatInternal->GetDrawTextOptions();
+        auto realizedTextFormat = GetRealizedTextFormatForPoint(format);
+
+        DrawTextImpl(text, textLength, rect, brush, realizedTextFormat.Get(), formatVersion, drawTextOptions);
+    }
+
+
+    ComPtr<IDWriteTextFormat> CanvasDrawingSession::GetRealizedTextFormatForPoint(ICanvasTextFormat* format)
+    {
+        auto formatInternal = As<ICanvasTextFormatInternal>(format);
 
-        ComPtr<IDWriteTextFormat> realizedTextFormat;
-        
         //
         // Drawing at a point only works if word wrapping is turned off.  We
         // don't want to modify the original format passed in (since DrawText is
@@ -2545,37 +2884,74 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         if (wordWrapping == CanvasWordWrapping::NoWrap)
         {
-            realizedTextFormat = formatInternal->GetRealizedTextFormat();
+            return formatInternal->GetRealizedTextFormat();
         }
         else
         {
-            realizedTextFormat = formatInternal->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+            return formatInternal->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
         }
-
-        DrawTextImpl(text, rect, brush, realizedTextFormat.Get(), drawTextOptions);
     }
 
 
     void CanvasDrawingSession::DrawTextImpl(
-        HSTRING text,
+        wchar_t const* textBuffer,
+        uint32_t textLength,
         Rect const& rect,
         ID2D1Brush* brush,
         IDWriteTextFormat* realizedFormat,
+        uint64_t formatVersion,
         D2D1_DRAW_TEXT_OPTIONS drawTextOptions)
     {
         auto& deviceContext = GetResource();
         CheckInPointer(brush);
 
-        uint32_t textLength;
-        auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
         ThrowIfNullPointer(textBuffer, E_INVALIDARG);
 
+        if (auto trace = GetTrace())
+            trace->RecordSkipped();
+
+        // This is the same layout that ID2D1DeviceContext::DrawText would
+        // make internally, but kept for next time.
+        auto layout = TryGetCachedTextLayout(textBuffer, textLength, realizedFormat, formatVersion, rect);
+
+        if (layout)
+        {
+            deviceContext->DrawTextLayout(D2D1_POINT_2F{ rect.X, rect.Y }, layout.Get(), brush, drawTextOptions);
+            return;
+        }
+
         auto d2dRect = ToD2DRect(rect);
 
         deviceContext->DrawText(textBuffer, textLength, realizedFormat, &d2dRect, brush, drawTextOptions);
     }
 
 
+    ComPtr<IDWriteTextLayout> CanvasDrawingSession::TryGetCachedTextLayout(
+        wchar_t const* textBuffer,
+        uint32_t textLength,
+        IDWriteTextFormat* realizedFormat,
+        uint64_t formatVersion,
+        Rect const& rect)
+    {
+        if (formatVersion == 0)
+            return nullptr;
+
+        auto textLayoutCache = As<ICanvasDeviceInternal>(GetDevice())->GetTextLayoutCache();
+
+        if (!textLayoutCache->IsEnabled())
+            return nullptr;
+
+        return textLayoutCache->GetOrCreate(
+            CustomFontManager::GetInstance()->GetSharedFactory().Get(),
+            textBuffer,
+            textLength,
+            realizedFormat,
+            formatVersion,
+            std::max(0.0f, rect.Width),
+            std::max(0.0f, rect.Height));
+    }
+
+
     ICanvasTextFormat* CanvasDrawingSession::GetDefaultTextFormat()
     {
         if (!m_defaultTextFormat)
@@ -2971,6 +3347,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        if (auto trace = GetTrace())
+            trace->RecordGeometry(GetTraceState(deviceContext.Get()), DrawingTraceOp::DrawGeometry, geometry, brush, strokeWidth, strokeStyle);
     }
 
 
@@ -3165,6 +3544,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
             deviceContext->PopLayer();
         }
+
+        if (auto trace = GetTrace())
+        {
+            if (opacityBrush)
+                trace->RecordSkipped();
+            else
+                trace->RecordGeometry(GetTraceState(deviceContext.Get()), DrawingTraceOp::FillGeometry, geometry, brush);
+        }
     }
 
 
@@ -3274,6 +3661,68 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->DrawGeometryRealization(
             GetWrappedResource<ID2D1GeometryRealization>(cachedGeometry).Get(),
             brush);
+
+        if (auto trace = GetTrace())
+            trace->RecordSkipped();
+    }
+
+
+    IFACEMETHODIMP CanvasDrawingSession::FillMesh(
+        ICanvasMesh* mesh,
+        ICanvasBrush* brush)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                FillMeshImpl(
+                    mesh,
+                    ToD2DBrush(brush).Get());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasDrawingSession::FillMeshWithColor(
+        ICanvasMesh* mesh,
+        Color color)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                FillMeshImpl(
+                    mesh,
+                    GetColorBrush(color));
+            });
+    }
+
+
+    void CanvasDrawingSession::FillMeshImpl(
+        ICanvasMesh* mesh,
+        ID2D1Brush* brush)
+    {
+        auto& deviceContext = GetResource();
+        CheckInPointer(mesh);
+        CheckInPointer(brush);
+
+        auto d2dMesh = GetWrappedResource<ID2D1Mesh>(mesh);
+
+        if (auto trace = GetTrace())
+            trace->RecordSkipped();
+
+        // FillMesh requires that antialiasing be disabled, so we temporarily
+        // switch it off rather than making every caller remember to.
+        auto antialiasMode = deviceContext->GetAntialiasMode();
+
+        if (antialiasMode == D2D1_ANTIALIAS_MODE_ALIASED)
+        {
+            deviceContext->FillMesh(d2dMesh.Get(), brush);
+        }
+        else
+        {
+            deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+            auto restoreAntialiasMode = MakeScopeWarden([&] { deviceContext->SetAntialiasMode(antialiasMode); });
+
+            deviceContext->FillMesh(d2dMesh.Get(), brush);
+        }
     }
 
 #if WINVER > _WIN32_WINNT_WINBLUE
@@ -3297,6 +3746,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDrawingSession::DrawInkWithCache(
+        IIterable<InkStroke*>* inkStrokeCollection,
+        boolean highContrast,
+        ICanvasInkCache* inkCache)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+
+                CheckInPointer(inkStrokeCollection);
+                CheckInPointer(inkCache);
+
+                auto cachedInk = static_cast<CanvasInkCache*>(inkCache)->Update(inkStrokeCollection, !!highContrast);
+
+                if (cachedInk)
+                {
+                    ThrowIfFailed(DrawImageAtOrigin(cachedInk.Get()));
+                }
+            });
+    }
+
     void CanvasDrawingSession::DrawInkImpl(
         IIterable<InkStroke*>* inkStrokeCollection,
         bool highContrast)
@@ -3307,6 +3778,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         ComPtr<IUnknown> inkStrokeCollectionAsIUnknown = As<IUnknown>(inkStrokeCollection);
 
+        if (auto trace = GetTrace())
+            trace->RecordSkipped();
+
         if (!m_inkD2DRenderer)
         {
             m_inkD2DRenderer = InkAdapter::GetInstance()->CreateInkRenderer();
@@ -3383,34 +3857,89 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
     ID2D1SolidColorBrush* CanvasDrawingSession::GetColorBrush(Color const& color)
     {
-        if (m_solidColorBrush)
-        {
-            m_solidColorBrush->SetColor(ToD2DColor(color));
-        }
-        else
-        {
-            auto& deviceContext = GetResource();
-            ThrowIfFailed(deviceContext->CreateSolidColorBrush(ToD2DColor(color), &m_solidColorBrush));
-        }
+        auto& deviceContext = GetResource();
 
-        return m_solidColorBrush.Get();
+        return m_solidColorBrushes.GetBrush(deviceContext.Get(), color);
     }
 
 
-    ComPtr<ID2D1Brush> CanvasDrawingSession::ToD2DBrush(ICanvasBrush* brush)
+    static bool IsSameColor(Color const& a, Color const& b)
     {
-        if (!brush)
-            return nullptr;
+        return a.A == b.A &&
+               a.R == b.R &&
+               a.G == b.G &&
+               a.B == b.B;
+    }
 
-        auto& deviceContext = GetResource();
 
-        return As<ICanvasBrushInternal>(brush)->GetD2DBrush(deviceContext.Get(), GetBrushFlags::None);
+    SolidColorBrushCache::SolidColorBrushCache()
+        : m_count(0)
+    {
     }
 
 
-    IFACEMETHODIMP CanvasDrawingSession::get_Antialiasing(CanvasAntialiasing* value)
+    ID2D1SolidColorBrush* SolidColorBrushCache::GetBrush(ID2D1DeviceContext1* deviceContext, Color const& color)
     {
-        return ExceptionBoundary(
+        auto begin = m_entries;
+        auto end = begin + m_count;
+
+        // Look for an existing brush of this color.
+        auto it = std::find_if(begin, end,
+            [&](Entry const& entry)
+            {
+                return IsSameColor(entry.BrushColor, color);
+            });
+
+        if (it == end)
+        {
+            if (m_count < Capacity)
+            {
+                // There's a free slot, so create a new brush.
+                ThrowIfFailed(deviceContext->CreateSolidColorBrush(ToD2DColor(color), &it->Brush));
+                ++m_count;
+            }
+            else
+            {
+                // Recycle the least recently used brush.
+                it = end - 1;
+                it->Brush->SetColor(ToD2DColor(color));
+            }
+
+            it->BrushColor = color;
+        }
+
+        // Move this entry to the front, keeping the rest in MRU order.
+        std::rotate(begin, it, it + 1);
+
+        return begin->Brush.Get();
+    }
+
+
+    void SolidColorBrushCache::Clear()
+    {
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            m_entries[i].Brush.Reset();
+        }
+
+        m_count = 0;
+    }
+
+
+    ComPtr<ID2D1Brush> CanvasDrawingSession::ToD2DBrush(ICanvasBrush* brush)
+    {
+        if (!brush)
+            return nullptr;
+
+        auto& deviceContext = GetResource();
+
+        return As<ICanvasBrushInternal>(brush)->GetD2DBrush(deviceContext.Get(), GetBrushFlags::None);
+    }
+
+
+    IFACEMETHODIMP CanvasDrawingSession::get_Antialiasing(CanvasAntialiasing* value)
+    {
+        return ExceptionBoundary(
             [&]
             {
                 auto& deviceContext = GetResource();
@@ -3713,6 +4242,47 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDrawingSession::get_Trace(ICanvasDrawingTrace** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+                CheckAndClearOutPointer(value);
+
+                ThrowIfFailed(m_trace.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::put_Trace(ICanvasDrawingTrace* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+
+                m_trace = value;
+
+                if (auto trace = GetTrace())
+                    trace->RecordBeginSession();
+            });
+    }
+
+    CanvasDrawingTrace* CanvasDrawingSession::GetTrace()
+    {
+        return static_cast<CanvasDrawingTrace*>(m_trace.Get());
+    }
+
+    DrawingTraceState CanvasDrawingSession::GetTraceState(ID2D1DeviceContext1* deviceContext)
+    {
+        return DrawingTraceState
+        {
+            GetTransform(deviceContext, m_offset),
+            static_cast<CanvasAntialiasing>(deviceContext->GetAntialiasMode()),
+            static_cast<CanvasBlend>(deviceContext->GetPrimitiveBlend())
+        };
+    }
+
 
     IFACEMETHODIMP CanvasDrawingSession::get_Device(ICanvasDevice** value)
     {
@@ -3966,6 +4536,141 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDrawingSession::DrawGlyphRunObject(
+        Vector2 point,
+        ICanvasGlyphRun* glyphRun,
+        ICanvasBrush* brush)
+    {
+        return DrawGlyphRunObjectWithMeasuringMode(
+            point,
+            glyphRun,
+            brush,
+            CanvasTextMeasuringMode::Natural);
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawGlyphRunObjectWithMeasuringMode(
+        Vector2 point,
+        ICanvasGlyphRun* glyphRun,
+        ICanvasBrush* brush,
+        CanvasTextMeasuringMode measuringMode)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                CheckInPointer(glyphRun);
+                CheckInPointer(brush);
+
+                deviceContext->DrawGlyphRun(
+                    ToD2DPoint(point),
+                    &As<ICanvasGlyphRunInternal>(glyphRun)->GetDWriteGlyphRun(),
+                    nullptr,
+                    ToD2DBrush(brush).Get(),
+                    ToDWriteMeasuringMode(measuringMode));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawGlyphRuns(
+        uint32_t pointCount,
+        Vector2* points,
+        uint32_t glyphRunCount,
+        ICanvasGlyphRun** glyphRuns,
+        ICanvasBrush* brush)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+
+                CheckInPointer(brush);
+
+                DrawGlyphRunsImpl(pointCount, points, glyphRunCount, glyphRuns, 1, &brush);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawGlyphRunsWithBrushes(
+        uint32_t pointCount,
+        Vector2* points,
+        uint32_t glyphRunCount,
+        ICanvasGlyphRun** glyphRuns,
+        uint32_t brushCount,
+        ICanvasBrush** brushes)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+
+                if (brushCount != glyphRunCount)
+                    ThrowHR(E_INVALIDARG);
+
+                DrawGlyphRunsImpl(pointCount, points, glyphRunCount, glyphRuns, brushCount, brushes);
+            });
+    }
+
+    void CanvasDrawingSession::DrawGlyphRunsImpl(
+        uint32_t pointCount,
+        Vector2* points,
+        uint32_t glyphRunCount,
+        ICanvasGlyphRun** glyphRuns,
+        uint32_t brushCount,
+        ICanvasBrush** brushes)
+    {
+        auto& deviceContext = GetResource();
+
+        if (pointCount != glyphRunCount)
+            ThrowHR(E_INVALIDARG);
+
+        if (glyphRunCount == 0)
+            return;
+
+        CheckInPointer(points);
+        CheckInPointer(glyphRuns);
+        CheckInPointer(brushes);
+
+        // Validate everything up front, so a bad argument doesn't leave the
+        // batch half drawn.
+        std::vector<ComPtr<ICanvasGlyphRunInternal>> glyphRunsInternal(glyphRunCount);
+
+        for (uint32_t i = 0; i < glyphRunCount; ++i)
+        {
+            CheckInPointer(glyphRuns[i]);
+            glyphRunsInternal[i] = As<ICanvasGlyphRunInternal>(glyphRuns[i]);
+        }
+
+        std::vector<ComPtr<ID2D1Brush>> d2dBrushes(brushCount);
+
+        for (uint32_t i = 0; i < brushCount; ++i)
+        {
+            // Neighbouring runs often share a brush, which then only needs
+            // to be realized once.
+            if (i > 0 && brushes[i] == brushes[i - 1])
+            {
+                d2dBrushes[i] = d2dBrushes[i - 1];
+                continue;
+            }
+
+            CheckInPointer(brushes[i]);
+            d2dBrushes[i] = ToD2DBrush(brushes[i]);
+        }
+
+        if (auto trace = GetTrace())
+            trace->RecordSkipped();
+
+        for (uint32_t i = 0; i < glyphRunCount; ++i)
+        {
+            auto& d2dBrush = d2dBrushes[brushCount == 1 ? 0 : i];
+
+            deviceContext->DrawGlyphRun(
+                ToD2DPoint(points[i]),
+                &glyphRunsInternal[i]->GetDWriteGlyphRun(),
+                nullptr,
+                d2dBrush.Get(),
+                DWRITE_MEASURING_MODE_NATURAL);
+        }
+    }
+
     // Returns true if the current transform matrix contains only scaling and translation, but no rotation or skew.
     static bool TransformIsAxisPreserving(ID2D1DeviceContext* deviceContext)
     {
@@ -3977,6 +4682,40 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                transform._21 == 0.0f;
     }
 
+    // If a layer's clip geometry is a plain rectangle with no rotation or skew
+    // in its transform, the layer clips to an axis aligned rectangle in the
+    // same coordinate space as its content bounds. Intersects that rectangle
+    // into clipRect and returns true.
+    static bool TryIntersectRectangleGeometryClip(ComPtr<ID2D1Geometry> const& d2dGeometry, D2D1_MATRIX_3X2_F const& geometryTransform, D2D1_RECT_F* clipRect)
+    {
+        if (geometryTransform._12 != 0.0f || geometryTransform._21 != 0.0f)
+            return false;
+
+        auto rectangleGeometry = MaybeAs<ID2D1RectangleGeometry>(d2dGeometry);
+
+        if (!rectangleGeometry)
+            return false;
+
+        D2D1_RECT_F rect;
+        rectangleGeometry->GetRect(&rect);
+
+        float x1 = rect.left   * geometryTransform._11 + geometryTransform._31;
+        float x2 = rect.right  * geometryTransform._11 + geometryTransform._31;
+        float y1 = rect.top    * geometryTransform._22 + geometryTransform._32;
+        float y2 = rect.bottom * geometryTransform._22 + geometryTransform._32;
+
+        clipRect->left   = std::max(clipRect->left,   std::min(x1, x2));
+        clipRect->top    = std::max(clipRect->top,    std::min(y1, y2));
+        clipRect->right  = std::min(clipRect->right,  std::max(x1, x2));
+        clipRect->bottom = std::min(clipRect->bottom, std::max(y1, y2));
+
+        // Nothing at all gets through if the two don't overlap.
+        clipRect->right  = std::max(clipRect->right,  clipRect->left);
+        clipRect->bottom = std::max(clipRect->bottom, clipRect->top);
+
+        return true;
+    }
+
     HRESULT CanvasDrawingSession::CreateLayerImpl(
         float opacity,
         ICanvasBrush* opacityBrush,
@@ -4001,13 +4740,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 auto d2dAntialiasMode = deviceContext->GetAntialiasMode();
 
                 // Simple cases can be optimized to use PushAxisAlignedClip instead of PushLayer.
-                bool isAxisAlignedClip = clipRectangle &&
+                // That includes clipping to a rectangle geometry, as UI code often does.
+                bool isAxisAlignedClip = (clipRectangle || d2dGeometry) &&
                                          !d2dBrush &&
-                                         !d2dGeometry &&
                                          opacity == 1.0f &&
                                          options == CanvasLayerOptions::None &&
                                          TransformIsAxisPreserving(deviceContext.Get());
 
+                if (isAxisAlignedClip && d2dGeometry)
+                {
+                    isAxisAlignedClip = TryIntersectRectangleGeometryClip(d2dGeometry, d2dMatrix, &d2dRect);
+                }
+
                 // Store a unique ID, used for validation in PopLayer. This extra state 
                 // is needed because the D2D PopLayer method always just pops the topmost 
                 // layer, but we want to make sure our CanvasActiveLayer objects are 
@@ -4027,7 +4771,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 // Construct a scope object that will pop the layer when its Close method is called.
                 WeakRef weakSelf = AsWeak(this);
 
-                auto activeLayer = Make<CanvasActiveLayer>(
+                auto activeLayer = MakePooled<CanvasActiveLayer>(
                     [weakSelf, layerId, isAxisAlignedClip]() mutable
                     {
                         auto strongSelf = LockWeakRef<ICanvasDrawingSession>(weakSelf);
@@ -4065,6 +4809,211 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDrawingSession::BeginProfileScope(
+        HSTRING name,
+        ICanvasProfileScope** scope)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(scope);
+
+                auto& deviceContext = GetResource();
+
+                // Submit what was drawn before the scope, so it isn't counted.
+                ThrowIfFailed(deviceContext->Flush(nullptr, nullptr));
+
+                WeakRef weakSelf = AsWeak(this);
+
+                auto profileScope = CanvasProfileScope::CreateNew(
+                    name,
+                    GetDevice().Get(),
+                    deviceContext.Get(),
+                    [weakSelf]() mutable
+                    {
+                        auto strongSelf = LockWeakRef<ICanvasDrawingSession>(weakSelf);
+                        auto self = static_cast<CanvasDrawingSession*>(strongSelf.Get());
+
+                        if (self)
+                            self->FlushForProfileScope();
+                    });
+
+                ThrowIfFailed(profileScope.CopyTo(scope));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::SaveDrawingState(
+        ICanvasDrawingState** state)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(state);
+
+                auto& deviceContext = GetResource();
+
+                ComPtr<ID2D1Factory> d2dFactory;
+                deviceContext->GetFactory(&d2dFactory);
+
+                ComPtr<ID2D1DrawingStateBlock1> stateBlock;
+                ThrowIfFailed(As<ID2D1Factory1>(d2dFactory)->CreateDrawingStateBlock(nullptr, nullptr, &stateBlock));
+
+                deviceContext->SaveDrawingState(stateBlock.Get());
+
+                auto drawingState = Make<CanvasDrawingState>(
+                    d2dFactory.Get(),
+                    stateBlock.Get(),
+                    m_offset,
+                    GetTransform(deviceContext.Get(), m_offset));
+                CheckMakeResult(drawingState);
+
+                ThrowIfFailed(drawingState.CopyTo(state));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::RestoreDrawingState(
+        ICanvasDrawingState* state)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(state);
+
+                auto drawingState = static_cast<CanvasDrawingState*>(state);
+                auto& deviceContext = GetResource();
+
+                ComPtr<ID2D1Factory> d2dFactory;
+                deviceContext->GetFactory(&d2dFactory);
+
+                if (!IsSameInstance(d2dFactory.Get(), drawingState->GetD2DFactory()))
+                    ThrowHR(E_INVALIDARG, Strings::DrawingStateFromDifferentDevice);
+
+                deviceContext->RestoreDrawingState(drawingState->GetStateBlock());
+
+                // The saved D2D transform has the offset of the session it
+                // came from baked into it, so swap that for ours.
+                auto& savedOffset = drawingState->GetOffset();
+
+                if (savedOffset.x != m_offset.x || savedOffset.y != m_offset.y)
+                {
+                    Numerics::Matrix3x2 transform;
+                    ThrowIfFailed(state->get_Transform(&transform));
+                    SetTransform(deviceContext.Get(), m_offset, transform);
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::PushTransform(
+        Matrix3x2 transform)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                auto previousTransform = GetTransform(deviceContext.Get(), m_offset);
+
+                auto pushed = D2D1::Matrix3x2F::ReinterpretBaseType(ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform));
+                auto previous = D2D1::Matrix3x2F::ReinterpretBaseType(ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&previousTransform));
+
+                D2D1_MATRIX_3X2_F combinedTransform = *pushed * *previous;
+
+                m_transformStack.push_back(previousTransform);
+
+                SetTransform(deviceContext.Get(), m_offset, *ReinterpretAs<Matrix3x2 const*>(&combinedTransform));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::PopTransform()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                if (m_transformStack.empty())
+                    ThrowHR(E_FAIL, Strings::PopTransformWithoutPush);
+
+                // Going via the Transform property value rather than the raw
+                // D2D matrix keeps the offset right if Units changed meanwhile.
+                SetTransform(deviceContext.Get(), m_offset, m_transformStack.back());
+
+                m_transformStack.pop_back();
+            });
+    }
+
+    // The m_activeLayerIds entry for PushClip. CreateLayer IDs start from 1.
+    static const int PushedClipLayerId = 0;
+
+    IFACEMETHODIMP CanvasDrawingSession::PushClip(
+        Rect clipRectangle)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                auto d2dRect = ToD2DRect(clipRectangle);
+                auto d2dAntialiasMode = deviceContext->GetAntialiasMode();
+
+                bool isAxisAlignedClip = TransformIsAxisPreserving(deviceContext.Get());
+
+                m_activeLayerIds.push_back(PushedClipLayerId);
+                m_pushedClipIsAxisAligned.push_back(isAxisAlignedClip);
+
+                if (isAxisAlignedClip)
+                {
+                    deviceContext->PushAxisAlignedClip(&d2dRect, d2dAntialiasMode);
+                }
+                else
+                {
+                    // Rotated or skewed clips need a layer.
+                    auto parameters = D2D1::LayerParameters1(d2dRect, nullptr, d2dAntialiasMode);
+
+                    deviceContext->PushLayer(&parameters, nullptr);
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::PopClip()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+
+                if (m_activeLayerIds.empty() || m_activeLayerIds.back() != PushedClipLayerId)
+                    ThrowHR(E_FAIL, Strings::PoppedWrongClip);
+
+                bool isAxisAlignedClip = m_pushedClipIsAxisAligned.back();
+                m_pushedClipIsAxisAligned.pop_back();
+
+                PopLayer(PushedClipLayerId, isAxisAlignedClip);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawRenderNode(
+        ICanvasRenderNode* renderNode)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();
+                CheckInPointer(renderNode);
+
+                static_cast<CanvasRenderNode*>(renderNode)->Draw(this);
+            });
+    }
+
+    void CanvasDrawingSession::FlushForProfileScope()
+    {
+        // If the session has already been closed, EndDraw submitted everything.
+        auto& deviceContext = MaybeGetResource();
+
+        if (deviceContext)
+            ThrowIfFailed(deviceContext->Flush(nullptr, nullptr));
+    }
+
     void CanvasDrawingSession::PopLayer(int layerId, bool isAxisAlignedClip)
     {
         auto& deviceContext = GetResource();
@@ -4129,28 +5078,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
         return ExceptionBoundary([&]
         {
-            // Validate interpolation mode
-            switch (interpolation)
-            {
-            case CanvasImageInterpolation::NearestNeighbor:
-            case CanvasImageInterpolation::Linear:
-                break;
-
-            default:
-                // We have a special message for this case since there are
-                // various, valid looking, CanvasImageInterpolation modes that
-                // are not valid to use with this API.
-                ThrowHR(E_INVALIDARG, Strings::SpriteBatchInvalidInterpolation);
-            }
-
-            // Validate options
-            auto const validOptions = CanvasSpriteOptions::ClampToSourceRect;
-            if ((static_cast<uint32_t>(options) & ~static_cast<uint32_t>(validOptions)) != 0)
-            {
-                // no special message for this since this can't happen unless
-                // the app is doing casting.
-                ThrowHR(E_INVALIDARG);
-            }
+            ValidateSpriteBatchInterpolationAndOptions(interpolation, options);
 
             CheckAndClearOutPointer(spriteBatch);
             
@@ -4170,6 +5098,109 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         });
     }
 
+
+    //
+    // DrawCachedSpriteBatch
+    //
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawCachedSpriteBatch(
+        ICanvasCachedSpriteBatch* cachedSpriteBatch)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+                CheckInPointer(cachedSpriteBatch);
+
+                auto deviceContext3 = MaybeAs<ID2D1DeviceContext3>(deviceContext);
+
+                if (!deviceContext3)
+                    ThrowHR(E_NOTIMPL, Strings::SpriteBatchNotAvailable);
+
+                As<ICanvasCachedSpriteBatchInternal>(cachedSpriteBatch)->Draw(GetDevice().Get(), deviceContext3.Get());
+            });
+    }
+
+    //
+    // DrawTextWithGlyphAtlas
+    //
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawTextWithGlyphAtlas(
+        HSTRING text,
+        Vector2 point,
+        Color color,
+        ICanvasTextFormat* format,
+        ICanvasGlyphAtlas* glyphAtlas)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+                CheckInPointer(glyphAtlas);
+
+                uint32_t textLength;
+                auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+                ThrowIfNullPointer(textBuffer, E_INVALIDARG);
+
+                if (!format)
+                    format = GetDefaultTextFormat();
+
+                auto formatInternal = As<ICanvasTextFormatInternal>(format);
+                auto formatVersion = formatInternal->GetRealizedTextFormatVersion();
+                auto drawTextOptions = formatInternal->GetDrawTextOptions();
+                auto realizedTextFormat = GetRealizedTextFormatForPoint(format);
+
+                // The atlas draws the glyph runs of a layout, so unlike
+                // DrawText this always needs one.
+                auto layout = TryGetCachedTextLayout(textBuffer, textLength, realizedTextFormat.Get(), formatVersion, Rect{ point.X, point.Y, 0, 0 });
+
+                if (!layout)
+                {
+                    ThrowIfFailed(CustomFontManager::GetInstance()->GetSharedFactory()->CreateTextLayout(
+                        textBuffer,
+                        textLength,
+                        realizedTextFormat.Get(),
+                        0,
+                        0,
+                        &layout));
+                }
+
+                static_cast<CanvasGlyphAtlas*>(glyphAtlas)->DrawTextLayout(
+                    GetDevice().Get(),
+                    deviceContext.Get(),
+                    layout.Get(),
+                    point,
+                    GetColorBrush(color),
+                    drawTextOptions);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawTextLayoutWithGlyphAtlas(
+        ICanvasTextLayout* textLayout,
+        Vector2 point,
+        Color color,
+        ICanvasGlyphAtlas* glyphAtlas)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+                CheckInPointer(textLayout);
+                CheckInPointer(glyphAtlas);
+
+                CanvasDrawTextOptions drawTextOptions;
+                ThrowIfFailed(textLayout->get_Options(&drawTextOptions));
+
+                static_cast<CanvasGlyphAtlas*>(glyphAtlas)->DrawTextLayout(
+                    GetDevice().Get(),
+                    deviceContext.Get(),
+                    GetWrappedResource<IDWriteTextLayout>(textLayout).Get(),
+                    point,
+                    GetColorBrush(color),
+                    StaticCastAs<D2D1_DRAW_TEXT_OPTIONS>(drawTextOptions));
+            });
+    }
+
     IFACEMETHODIMP CanvasDrawingSession::DrawSvgAtOrigin(ICanvasSvgDocument *svgDocument, Size viewportSize)
     {
         return DrawSvgAtCoords(svgDocument, viewportSize, 0, 0);
@@ -4197,6 +5228,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
                 auto d2dSvgDocument = GetWrappedResource<ID2D1SvgDocument>(svgDocument);
 
+                auto svgDocumentInternal = MaybeAs<ICanvasSvgDocumentInternal>(svgDocument);
+
+                if (svgDocumentInternal && svgDocumentInternal->TryDrawRasterized(deviceContext5.Get(), viewportSize, x, y))
+                    return;
+
                 TemporaryTransform<ID2D1DeviceContext1> transform(GetResource().Get(), Vector2{ x, y });
                 TemporaryViewportSize viewportSizer(d2dSvgDocument.Get(), viewportSize);
 
@@ -4206,4 +5242,232 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     
 #endif
 
+    //
+    // Batched primitives
+    //
+    // Arguments are validated once up front, after which the loops talk
+    // directly to the D2D device context.
+    //
+
+    template<typename T>
+    static T const& GetBatchElement(T const* elements, uint32_t elementCount, uint32_t index)
+    {
+        return (elementCount == 1) ? elements[0] : elements[index];
+    }
+
+    template<typename T>
+    static void ValidateBatchArray(uint32_t primitiveCount, uint32_t elementCount, T const* elements)
+    {
+        if (primitiveCount == 0)
+            return;
+
+        CheckInPointer(elements);
+
+        if (elementCount != 1 && elementCount != primitiveCount)
+            ThrowHR(E_INVALIDARG, Strings::BatchedPrimitiveArraySizeMismatch);
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::FillRectangles(
+        uint32_t rectCount,
+        Rect* rects,
+        uint32_t colorCount,
+        Color* colors)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                if (rectCount == 0)
+                    return;
+
+                CheckInPointer(rects);
+                ValidateBatchArray(rectCount, colorCount, colors);
+
+                for (uint32_t i = 0; i < rectCount; ++i)
+                {
+                    auto d2dRect = ToD2DRect(rects[i]);
+
+                    deviceContext->FillRectangle(
+                        &d2dRect,
+                        GetColorBrush(GetBatchElement(colors, colorCount, i)));
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawRectangles(
+        uint32_t rectCount,
+        Rect* rects,
+        uint32_t colorCount,
+        Color* colors,
+        float strokeWidth)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                if (rectCount == 0)
+                    return;
+
+                CheckInPointer(rects);
+                ValidateBatchArray(rectCount, colorCount, colors);
+
+                for (uint32_t i = 0; i < rectCount; ++i)
+                {
+                    auto d2dRect = ToD2DRect(rects[i]);
+
+                    deviceContext->DrawRectangle(
+                        &d2dRect,
+                        GetColorBrush(GetBatchElement(colors, colorCount, i)),
+                        strokeWidth,
+                        nullptr);
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawLines(
+        uint32_t pointCount,
+        Vector2* points,
+        uint32_t colorCount,
+        Color* colors,
+        float strokeWidth)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                if (pointCount % 2 != 0)
+                    ThrowHR(E_INVALIDARG, Strings::DrawLinesRequiresPointPairs);
+
+                if (pointCount == 0)
+                    return;
+
+                uint32_t lineCount = pointCount / 2;
+
+                CheckInPointer(points);
+                ValidateBatchArray(lineCount, colorCount, colors);
+
+                for (uint32_t i = 0; i < lineCount; ++i)
+                {
+                    deviceContext->DrawLine(
+                        ToD2DPoint(points[i * 2]),
+                        ToD2DPoint(points[i * 2 + 1]),
+                        GetColorBrush(GetBatchElement(colors, colorCount, i)),
+                        strokeWidth,
+                        nullptr);
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::FillCircles(
+        uint32_t centerPointCount,
+        Vector2* centerPoints,
+        uint32_t radiusCount,
+        float* radii,
+        uint32_t colorCount,
+        Color* colors)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& deviceContext = GetResource();
+
+                if (centerPointCount == 0)
+                    return;
+
+                CheckInPointer(centerPoints);
+                ValidateBatchArray(centerPointCount, radiusCount, radii);
+                ValidateBatchArray(centerPointCount, colorCount, colors);
+
+                for (uint32_t i = 0; i < centerPointCount; ++i)
+                {
+                    auto radius = GetBatchElement(radii, radiusCount, i);
+                    auto d2dEllipse = ToD2DEllipse(centerPoints[i], radius, radius);
+
+                    deviceContext->FillEllipse(
+                        &d2dEllipse,
+                        GetColorBrush(GetBatchElement(colors, colorCount, i)));
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawCachedGeometryInstances(
+        ICanvasCachedGeometry* cachedGeometry,
+        uint32_t offsetCount,
+        Vector2* offsets,
+        uint32_t colorCount,
+        Color* colors)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (offsetCount > 0)
+                    CheckInPointer(offsets);
+
+                DrawCachedGeometryInstancesImpl(cachedGeometry, offsetCount, colorCount, colors,
+                    [&](uint32_t i)
+                    {
+                        return D2D1::Matrix3x2F::Translation(offsets[i].X, offsets[i].Y);
+                    });
+            });
+    }
+
+    IFACEMETHODIMP CanvasDrawingSession::DrawCachedGeometryInstancesWithTransforms(
+        ICanvasCachedGeometry* cachedGeometry,
+        uint32_t transformCount,
+        Matrix3x2* transforms,
+        uint32_t colorCount,
+        Color* colors)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (transformCount > 0)
+                    CheckInPointer(transforms);
+
+                DrawCachedGeometryInstancesImpl(cachedGeometry, transformCount, colorCount, colors,
+                    [&](uint32_t i)
+                    {
+                        return *D2D1::Matrix3x2F::ReinterpretBaseType(ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transforms[i]));
+                    });
+            });
+    }
+
+    template<typename TGetTransform>
+    void CanvasDrawingSession::DrawCachedGeometryInstancesImpl(
+        ICanvasCachedGeometry* cachedGeometry,
+        uint32_t instanceCount,
+        uint32_t colorCount,
+        Color const* colors,
+        TGetTransform&& getTransform)
+    {
+        auto& deviceContext = GetResource();
+        CheckInPointer(cachedGeometry);
+
+        if (instanceCount == 0)
+            return;
+
+        ValidateBatchArray(instanceCount, colorCount, colors);
+
+        auto d2dGeometryRealization = GetWrappedResource<ID2D1GeometryRealization>(cachedGeometry);
+
+        // Each instance is drawn with its own transform applied on top of
+        // the session's, which is put back once they have all been drawn.
+        D2D1::Matrix3x2F sessionTransform;
+        deviceContext->GetTransform(&sessionTransform);
+
+        auto restoreTransform = MakeScopeWarden([&] { deviceContext->SetTransform(&sessionTransform); });
+
+        for (uint32_t i = 0; i < instanceCount; ++i)
+        {
+            deviceContext->SetTransform(getTransform(i) * sessionTransform);
+
+            deviceContext->DrawGeometryRealization(
+                d2dGeometryRealization.Get(),
+                GetColorBrush(GetBatchElement(colors, colorCount, i)));
+        }
+    }
+
 }}}}
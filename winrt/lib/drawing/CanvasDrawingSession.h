@@ -18,6 +18,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
     using namespace ::Microsoft::WRL;
 
+    class CanvasDrawingTrace;
+    struct DrawingTraceState;
+
     class ICanvasDrawingSessionAdapter
     {
     public:
@@ -48,12 +51,59 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     };
 #endif
 
+    //
+    // Solid color brushes used by the color overloads.  Rather than changing
+    // the color of a single brush on every draw, a handful of brushes are kept
+    // in most-recently-used order, so draw sequences that alternate between a
+    // few colors don't keep changing brush state.  When all the slots are in
+    // use the least recently used brush has its color changed instead.
+    //
+    class SolidColorBrushCache
+    {
+    public:
+        static const size_t Capacity = 8;
+
+        SolidColorBrushCache();
+
+        ID2D1SolidColorBrush* GetBrush(ID2D1DeviceContext1* deviceContext, ABI::Windows::UI::Color const& color);
+
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            ABI::Windows::UI::Color BrushColor;
+            ComPtr<ID2D1SolidColorBrush> Brush;
+        };
+
+        Entry m_entries[Capacity];
+        size_t m_count;
+    };
+
+    //
+    // Intermediate effects used by the DrawImage slow path (opacity, border
+    // and the DPI compensation effects that feed them).  These are created the
+    // first time they are needed and then reused for the rest of the drawing
+    // session, rather than creating new D2D effects on every DrawImage call.
+    // The cache is bypassed while the target is a command list, since those
+    // keep referencing the effects after DrawImage returns.
+    //
+    struct DrawImageEffectCache
+    {
+        ComPtr<ID2D1Effect> OpacityEffect;
+        ComPtr<ID2D1Effect> OpacityDpiCompensationEffect;
+        ComPtr<ID2D1Effect> BorderEffect;
+        ComPtr<ID2D1Effect> BorderDpiCompensationEffect;
+    };
+
+
     class CanvasDrawingSession : RESOURCE_WRAPPER_RUNTIME_CLASS(
         ID2D1DeviceContext1,
         CanvasDrawingSession,
         ICanvasDrawingSession,
         ICanvasResourceCreatorWithDpi,
-        ICanvasResourceCreator)
+        ICanvasResourceCreator,
+        CloakedIid<ICanvasDrawingSessionNative>)
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasDrawingSession, BaseTrust);
 
@@ -61,12 +111,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<bool> m_targetHasActiveDrawingSession;
         D2D1_POINT_2F const m_offset;
         
-        ComPtr<ID2D1SolidColorBrush> m_solidColorBrush;
+        SolidColorBrushCache m_solidColorBrushes;
         ComPtr<ICanvasTextFormat> m_defaultTextFormat;
 
+        DrawImageEffectCache m_drawImageEffects;
+
         std::vector<int> m_activeLayerIds;
         int m_nextLayerId;
 
+        // PushClip shares m_activeLayerIds with CreateLayer, so the two nest
+        // correctly. This holds how each of the clips still pushed was done.
+        std::vector<bool> m_pushedClipIsAxisAligned;
+
+        // The values of the Transform property to go back to on PopTransform.
+        std::vector<Matrix3x2> m_transformStack;
+
+        ComPtr<ICanvasDrawingTrace> m_trace;
+
         //
         // Contract:
         //     Drawing sessions created conventionally initialize this member.
@@ -248,6 +309,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasImageInterpolation interpolation,
             Matrix4x4 perspective) override;
 
+        //
+        // DrawCachedImage
+        //
+
+        IFACEMETHOD(DrawCachedImage)(
+            ICanvasImage* image,
+            Vector2 offset,
+            ICanvasImageTileCache* tileCache) override;
+
         //
         // DrawLine
         //
@@ -934,6 +1004,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ABI::Windows::UI::Color color,
             ICanvasTextFormat* format) override;
 
+        //
+        // ICanvasDrawingSessionNative
+        //
+
+        IFACEMETHOD(DrawTextFromBufferAtPoint)(
+            wchar_t const* text,
+            UINT32 textLength,
+            float x,
+            float y,
+            IUnknown* brush,
+            IUnknown* format) override;
+
+        IFACEMETHOD(DrawTextFromBufferAtRect)(
+            wchar_t const* text,
+            UINT32 textLength,
+            float x,
+            float y,
+            float w,
+            float h,
+            IUnknown* brush,
+            IUnknown* format) override;
+
         //
         // DrawTextLayout
         //
@@ -1165,6 +1257,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ICanvasCachedGeometry* cachedGeometry,
             ABI::Windows::UI::Color color) override;
 
+        //
+        // FillMesh
+        //
+
+        IFACEMETHOD(FillMesh)(
+            ICanvasMesh* mesh,
+            ICanvasBrush* brush) override;
+
+        IFACEMETHOD(FillMeshWithColor)(
+            ICanvasMesh* mesh,
+            ABI::Windows::UI::Color color) override;
+
 #if WINVER > _WIN32_WINNT_WINBLUE
         //
         // DrawInk
@@ -1172,6 +1276,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(DrawInk)(IIterable<InkStroke*>* inkStrokes) override;
 
         IFACEMETHOD(DrawInkWithHighContrast)(IIterable<InkStroke*>* inkStrokes, boolean highContrast) override;
+
+        IFACEMETHOD(DrawInkWithCache)(IIterable<InkStroke*>* inkStrokes, boolean highContrast, ICanvasInkCache* inkCache) override;
         
         //
         // DrawGradientMesh
@@ -1190,6 +1296,52 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
 #endif
 
+        //
+        // Batched primitives
+        //
+
+        IFACEMETHOD(FillRectangles)(
+            uint32_t rectCount,
+            Rect* rects,
+            uint32_t colorCount,
+            Color* colors) override;
+
+        IFACEMETHOD(DrawRectangles)(
+            uint32_t rectCount,
+            Rect* rects,
+            uint32_t colorCount,
+            Color* colors,
+            float strokeWidth) override;
+
+        IFACEMETHOD(DrawLines)(
+            uint32_t pointCount,
+            Vector2* points,
+            uint32_t colorCount,
+            Color* colors,
+            float strokeWidth) override;
+
+        IFACEMETHOD(FillCircles)(
+            uint32_t centerPointCount,
+            Vector2* centerPoints,
+            uint32_t radiusCount,
+            float* radii,
+            uint32_t colorCount,
+            Color* colors) override;
+
+        IFACEMETHOD(DrawCachedGeometryInstances)(
+            ICanvasCachedGeometry* cachedGeometry,
+            uint32_t offsetCount,
+            Vector2* offsets,
+            uint32_t colorCount,
+            Color* colors) override;
+
+        IFACEMETHOD(DrawCachedGeometryInstancesWithTransforms)(
+            ICanvasCachedGeometry* cachedGeometry,
+            uint32_t transformCount,
+            Matrix3x2* transforms,
+            uint32_t colorCount,
+            Color* colors) override;
+
         //
         // State properties
         //
@@ -1218,6 +1370,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(get_EffectTileSize)(BitmapSize* value) override;
         IFACEMETHOD(put_EffectTileSize)(BitmapSize value) override;
 
+        IFACEMETHOD(get_Trace)(ICanvasDrawingTrace** value) override;
+        IFACEMETHOD(put_Trace)(ICanvasDrawingTrace* value) override;
+
         //
         // CreateLayer
         //
@@ -1271,6 +1426,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasLayerOptions options,
             ICanvasActiveLayer** layer) override;
 
+        IFACEMETHOD(BeginProfileScope)(
+            HSTRING name,
+            ICanvasProfileScope** scope) override;
+
+        IFACEMETHOD(SaveDrawingState)(
+            ICanvasDrawingState** state) override;
+
+        IFACEMETHOD(RestoreDrawingState)(
+            ICanvasDrawingState* state) override;
+
+        IFACEMETHOD(PushTransform)(
+            Matrix3x2 transform) override;
+
+        IFACEMETHOD(PopTransform)() override;
+
+        IFACEMETHOD(PushClip)(
+            Rect clipRectangle) override;
+
+        IFACEMETHOD(PopClip)() override;
+
+        IFACEMETHOD(DrawRenderNode)(
+            ICanvasRenderNode* renderNode) override;
+
         
         IFACEMETHOD(DrawGlyphRun)(
             Vector2 point,
@@ -1309,6 +1487,32 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int* clusterMapIndices,
             uint32_t textPosition) override;
 
+        IFACEMETHOD(DrawGlyphRunObject)(
+            Vector2 point,
+            ICanvasGlyphRun* glyphRun,
+            ICanvasBrush* brush) override;
+
+        IFACEMETHOD(DrawGlyphRunObjectWithMeasuringMode)(
+            Vector2 point,
+            ICanvasGlyphRun* glyphRun,
+            ICanvasBrush* brush,
+            CanvasTextMeasuringMode measuringMode) override;
+
+        IFACEMETHOD(DrawGlyphRuns)(
+            uint32_t pointCount,
+            Vector2* points,
+            uint32_t glyphRunCount,
+            ICanvasGlyphRun** glyphRuns,
+            ICanvasBrush* brush) override;
+
+        IFACEMETHOD(DrawGlyphRunsWithBrushes)(
+            uint32_t pointCount,
+            Vector2* points,
+            uint32_t glyphRunCount,
+            ICanvasGlyphRun** glyphRuns,
+            uint32_t brushCount,
+            ICanvasBrush** brushes) override;
+
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 
@@ -1334,6 +1538,30 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasSpriteOptions options,
             ICanvasSpriteBatch** spriteBatch) override;
 
+        //
+        // DrawCachedSpriteBatch
+        //
+
+        IFACEMETHOD(DrawCachedSpriteBatch)(
+            ICanvasCachedSpriteBatch* cachedSpriteBatch) override;
+
+        //
+        // DrawTextWithGlyphAtlas
+        //
+
+        IFACEMETHOD(DrawTextWithGlyphAtlas)(
+            HSTRING text,
+            Vector2 point,
+            ABI::Windows::UI::Color color,
+            ICanvasTextFormat* format,
+            ICanvasGlyphAtlas* glyphAtlas) override;
+
+        IFACEMETHOD(DrawTextLayoutWithGlyphAtlas)(
+            ICanvasTextLayout* textLayout,
+            Vector2 point,
+            ABI::Windows::UI::Color color,
+            ICanvasGlyphAtlas* glyphAtlas) override;
+
 #endif
 
         //
@@ -1352,6 +1580,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHODIMP ConvertDipsToPixels(float dips, CanvasDpiRounding dpiRounding, int* pixels) override;
 
     private:
+        void ClearImpl(
+            D2D1_COLOR_F const& color);
+
         void DrawLineImpl(
             Vector2 const& p0,
             Vector2 const& p1,
@@ -1398,24 +1629,40 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ID2D1Brush* brush);
 
         void DrawTextAtRectImpl(
-            HSTRING text,
+            wchar_t const* text,
+            uint32_t textLength,
             Rect const& rect,
             ID2D1Brush* brush,
             ICanvasTextFormat* format);
 
         void DrawTextAtPointImpl(
-            HSTRING text,
+            wchar_t const* text,
+            uint32_t textLength,
             Vector2 const& point,
             ID2D1Brush* brush,
             ICanvasTextFormat* format);
 
         void DrawTextImpl(
-            HSTRING text,
+            wchar_t const* text,
+            uint32_t textLength,
             Rect const& rect,
             ID2D1Brush* brush,
             IDWriteTextFormat* format,
+            uint64_t formatVersion,
             D2D1_DRAW_TEXT_OPTIONS options);
 
+        // Drawing at a point needs a format with word wrapping turned off.
+        ComPtr<IDWriteTextFormat> GetRealizedTextFormatForPoint(ICanvasTextFormat* format);
+
+        // Returns null if the device's text layout cache is turned off, or
+        // the format can't be versioned.
+        ComPtr<IDWriteTextLayout> TryGetCachedTextLayout(
+            wchar_t const* textBuffer,
+            uint32_t textLength,
+            IDWriteTextFormat* realizedFormat,
+            uint64_t formatVersion,
+            Rect const& rect);
+
         ICanvasTextFormat* GetDefaultTextFormat();
 
         void DrawGeometryImpl(
@@ -1433,9 +1680,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ICanvasCachedGeometry* cachedGeometry,
             ID2D1Brush* brush);
 
+        template<typename TGetTransform>
+        void DrawCachedGeometryInstancesImpl(
+            ICanvasCachedGeometry* cachedGeometry,
+            uint32_t instanceCount,
+            uint32_t colorCount,
+            Color const* colors,
+            TGetTransform&& getTransform);
+
+        void FillMeshImpl(
+            ICanvasMesh* mesh,
+            ID2D1Brush* brush);
+
         ID2D1SolidColorBrush* GetColorBrush(ABI::Windows::UI::Color const& color);
         ComPtr<ID2D1Brush> ToD2DBrush(ICanvasBrush* brush);
 
+        void DrawGlyphRunsImpl(
+            uint32_t pointCount,
+            Vector2* points,
+            uint32_t glyphRunCount,
+            ICanvasGlyphRun** glyphRuns,
+            uint32_t brushCount,
+            ICanvasBrush** brushes);
+
         HRESULT DrawImageImpl(
             ICanvasImage* image,
             Vector2* offset,
@@ -1465,6 +1732,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         void PopLayer(int layerId, bool isAxisAlignedClip);
 
+        void FlushForProfileScope();
+
+        // Returns null unless the Trace property is set.
+        CanvasDrawingTrace* GetTrace();
+        DrawingTraceState GetTraceState(ID2D1DeviceContext1* deviceContext);
+
 #if WINVER > _WIN32_WINNT_WINBLUE
         void DrawInkImpl(IIterable<InkStroke*>* inkStrokeCollection, bool highContrast);
 #endif
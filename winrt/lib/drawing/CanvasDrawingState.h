@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ABI::Microsoft::Graphics::Canvas::Text;
+
+    //
+    // A snapshot of a drawing session's transform, antialiasing, blend,
+    // text antialiasing, text rendering parameters and units, held in a D2D
+    // drawing state block so that it can be put back in a single call.
+    //
+    // The D2D transform includes the session's offset (see
+    // CanvasDrawingSession::m_offset), so we remember which offset it was
+    // saved with in order to restore it into a session with a different one.
+    //
+    class CanvasDrawingState : public RuntimeClass<ICanvasDrawingState>,
+                               private LifespanTracker<CanvasDrawingState>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasDrawingState, BaseTrust);
+
+        ComPtr<ID2D1Factory> m_d2dFactory;
+        ComPtr<ID2D1DrawingStateBlock1> m_stateBlock;
+        D2D1_POINT_2F m_offset;
+        Numerics::Matrix3x2 m_transform;
+
+    public:
+        CanvasDrawingState(
+            ID2D1Factory* d2dFactory,
+            ID2D1DrawingStateBlock1* stateBlock,
+            D2D1_POINT_2F const& offset,
+            Numerics::Matrix3x2 const& transform)
+            : m_d2dFactory(d2dFactory)
+            , m_stateBlock(stateBlock)
+            , m_offset(offset)
+            , m_transform(transform)
+        {
+        }
+
+        IFACEMETHODIMP get_Transform(Numerics::Matrix3x2* value) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    CheckInPointer(value);
+                    *value = m_transform;
+                });
+        }
+
+        IFACEMETHODIMP get_Antialiasing(CanvasAntialiasing* value) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    CheckInPointer(value);
+                    *value = static_cast<CanvasAntialiasing>(GetDescription().antialiasMode);
+                });
+        }
+
+        IFACEMETHODIMP get_Blend(CanvasBlend* value) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    CheckInPointer(value);
+                    *value = static_cast<CanvasBlend>(GetDescription().primitiveBlend);
+                });
+        }
+
+        IFACEMETHODIMP get_TextAntialiasing(CanvasTextAntialiasing* value) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    CheckInPointer(value);
+                    *value = static_cast<CanvasTextAntialiasing>(GetDescription().textAntialiasMode);
+                });
+        }
+
+        IFACEMETHODIMP get_Units(CanvasUnits* value) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    CheckInPointer(value);
+                    *value = static_cast<CanvasUnits>(GetDescription().unitMode);
+                });
+        }
+
+        ID2D1Factory* GetD2DFactory() const { return m_d2dFactory.Get(); }
+        ID2D1DrawingStateBlock1* GetStateBlock() const { return m_stateBlock.Get(); }
+        D2D1_POINT_2F const& GetOffset() const { return m_offset; }
+
+    private:
+        D2D1_DRAWING_STATE_DESCRIPTION1 GetDescription() const
+        {
+            D2D1_DRAWING_STATE_DESCRIPTION1 description;
+            m_stateBlock->GetDescription(&description);
+            return description;
+        }
+    };
+}}}}
@@ -0,0 +1,724 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasDrawingTrace.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+
+static void ThrowInvalidTrace()
+{
+    ThrowHR(E_INVALIDARG, Strings::InvalidDrawingTrace);
+}
+
+
+// Records can start at any byte offset, so they are copied out rather than cast in place.
+template<typename T>
+static T ReadPayload(uint8_t const* payload)
+{
+    T value;
+    memcpy(&value, payload, sizeof(T));
+    return value;
+}
+
+
+// Calls fn for each record, checking only that the record framing holds together.
+template<typename FN>
+static void ForEachRecord(uint8_t const* records, size_t size, FN&& fn)
+{
+    size_t offset = 0;
+
+    while (offset < size)
+    {
+        if (size - offset < sizeof(DrawingTraceRecordHeader))
+            ThrowInvalidTrace();
+
+        auto header = ReadPayload<DrawingTraceRecordHeader>(records + offset);
+        offset += sizeof(header);
+
+        if (size - offset < header.Size)
+            ThrowInvalidTrace();
+
+        fn(header.Op, records + offset, header.Size);
+        offset += header.Size;
+    }
+}
+
+
+// The payload size of each op, or zero for ops without a payload.  DefineGeometry is variable-sized.
+static uint32_t GetPayloadSize(DrawingTraceOp op)
+{
+    switch (op)
+    {
+    case DrawingTraceOp::SetState:              return sizeof(DrawingTraceState);
+    case DrawingTraceOp::Clear:                 return sizeof(D2D1_COLOR_F);
+    case DrawingTraceOp::DrawLine:              return sizeof(DrawingTraceLine);
+    case DrawingTraceOp::DrawRectangle:
+    case DrawingTraceOp::FillRectangle:         return sizeof(DrawingTraceRectangle);
+    case DrawingTraceOp::DrawRoundedRectangle:
+    case DrawingTraceOp::FillRoundedRectangle:  return sizeof(DrawingTraceRoundedRectangle);
+    case DrawingTraceOp::DrawEllipse:
+    case DrawingTraceOp::FillEllipse:           return sizeof(DrawingTraceEllipse);
+    case DrawingTraceOp::DrawGeometry:
+    case DrawingTraceOp::FillGeometry:          return sizeof(DrawingTraceGeometry);
+    default:                                    return 0;
+    }
+}
+
+
+// Ops that count towards CallCount.  The rest describe state or resources, or are skipped calls.
+static bool IsRecordedCall(DrawingTraceOp op)
+{
+    switch (op)
+    {
+    case DrawingTraceOp::BeginSession:
+    case DrawingTraceOp::SetState:
+    case DrawingTraceOp::DefineGeometry:
+    case DrawingTraceOp::Skipped:
+        return false;
+
+    default:
+        return true;
+    }
+}
+
+
+// How many segment data values each command takes, as described by CanvasGeometryPathCommand.
+static uint32_t GetSegmentDataCount(CanvasGeometryPathCommand command)
+{
+    switch (command)
+    {
+    case CanvasGeometryPathCommand::BeginFigure:                    return 3;
+    case CanvasGeometryPathCommand::AddLine:                        return 2;
+    case CanvasGeometryPathCommand::AddCubicBezier:                 return 6;
+    case CanvasGeometryPathCommand::AddQuadraticBezier:             return 4;
+    case CanvasGeometryPathCommand::AddArc:                         return 7;
+    case CanvasGeometryPathCommand::SetFilledRegionDetermination:   return 1;
+    case CanvasGeometryPathCommand::SetSegmentOptions:              return 1;
+    case CanvasGeometryPathCommand::EndFigure:                      return 1;
+    default:                                                        ThrowInvalidTrace(); return 0;
+    }
+}
+
+
+static void ValidateGeometryDefinition(uint8_t const* payload, uint32_t size, uint32_t expectedId)
+{
+    if (size < sizeof(DrawingTraceGeometryDefinition))
+        ThrowInvalidTrace();
+
+    auto definition = ReadPayload<DrawingTraceGeometryDefinition>(payload);
+
+    uint64_t expectedSize = sizeof(definition) +
+        static_cast<uint64_t>(definition.CommandCount) * sizeof(CanvasGeometryPathCommand) +
+        static_cast<uint64_t>(definition.SegmentDataCount) * sizeof(float);
+
+    if (definition.Id != expectedId || size != expectedSize)
+        ThrowInvalidTrace();
+
+    auto commands = payload + sizeof(definition);
+    uint64_t segmentDataCount = 0;
+
+    for (uint32_t i = 0; i < definition.CommandCount; i++)
+    {
+        auto command = ReadPayload<CanvasGeometryPathCommand>(commands + i * sizeof(CanvasGeometryPathCommand));
+
+        segmentDataCount += GetSegmentDataCount(command);
+    }
+
+    if (segmentDataCount != definition.SegmentDataCount)
+        ThrowInvalidTrace();
+}
+
+
+// Plays a DefineGeometry record's path into a new geometry, the inverse of PathDataSink.
+static ComPtr<ICanvasGeometry> CreateGeometry(ICanvasResourceCreator* resourceCreator, uint8_t const* payload)
+{
+    auto definition = ReadPayload<DrawingTraceGeometryDefinition>(payload);
+
+    std::vector<CanvasGeometryPathCommand> commands(definition.CommandCount);
+    std::vector<float> segmentData(definition.SegmentDataCount);
+
+    payload += sizeof(definition);
+    memcpy(commands.data(), payload, commands.size() * sizeof(CanvasGeometryPathCommand));
+
+    payload += commands.size() * sizeof(CanvasGeometryPathCommand);
+    memcpy(segmentData.data(), payload, segmentData.size() * sizeof(float));
+
+    GeometryDevicePtr device(resourceCreator);
+
+    auto pathGeometry = GeometryAdapter::GetInstance()->CreatePathGeometry(device);
+
+    ComPtr<ID2D1GeometrySink> sink;
+    ThrowIfFailed(pathGeometry->Open(&sink));
+
+    auto data = segmentData.data();
+
+    for (auto command : commands)
+    {
+        switch (command)
+        {
+        case CanvasGeometryPathCommand::BeginFigure:
+            sink->BeginFigure(D2D1::Point2F(data[0], data[1]), static_cast<D2D1_FIGURE_BEGIN>(static_cast<int>(data[2])));
+            break;
+
+        case CanvasGeometryPathCommand::AddLine:
+            sink->AddLine(D2D1::Point2F(data[0], data[1]));
+            break;
+
+        case CanvasGeometryPathCommand::AddCubicBezier:
+            sink->AddBezier(D2D1::BezierSegment(D2D1::Point2F(data[0], data[1]), D2D1::Point2F(data[2], data[3]), D2D1::Point2F(data[4], data[5])));
+            break;
+
+        case CanvasGeometryPathCommand::AddQuadraticBezier:
+            sink->AddQuadraticBezier(D2D1::QuadraticBezierSegment(D2D1::Point2F(data[0], data[1]), D2D1::Point2F(data[2], data[3])));
+            break;
+
+        case CanvasGeometryPathCommand::AddArc:
+            sink->AddArc(D2D1::ArcSegment(
+                D2D1::Point2F(data[0], data[1]),
+                D2D1::SizeF(data[2], data[3]),
+                ::DirectX::XMConvertToDegrees(data[4]),
+                static_cast<D2D1_SWEEP_DIRECTION>(static_cast<int>(data[5])),
+                static_cast<D2D1_ARC_SIZE>(static_cast<int>(data[6]))));
+            break;
+
+        case CanvasGeometryPathCommand::SetFilledRegionDetermination:
+            sink->SetFillMode(static_cast<D2D1_FILL_MODE>(static_cast<int>(data[0])));
+            break;
+
+        case CanvasGeometryPathCommand::SetSegmentOptions:
+            sink->SetSegmentFlags(static_cast<D2D1_PATH_SEGMENT>(static_cast<int>(data[0])));
+            break;
+
+        case CanvasGeometryPathCommand::EndFigure:
+            sink->EndFigure(static_cast<D2D1_FIGURE_END>(static_cast<int>(data[0])));
+            break;
+        }
+
+        data += GetSegmentDataCount(command);
+    }
+
+    ThrowIfFailed(sink->Close());
+
+    auto geometry = Make<CanvasGeometry>(device, pathGeometry.Get());
+    CheckMakeResult(geometry);
+
+    return geometry;
+}
+
+
+static int64_t GetTimestamp()
+{
+    static int64_t const frequency = []
+    {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value.QuadPart;
+    }();
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Split up the conversion so the multiply doesn't overflow.
+    auto seconds = counter.QuadPart / frequency;
+    auto remainder = counter.QuadPart % frequency;
+
+    return seconds * 10000000 + remainder * 10000000 / frequency;
+}
+
+
+CanvasDrawingTrace::CanvasDrawingTrace()
+    : m_callCount(0)
+    , m_skippedCallCount(0)
+    , m_geometryCount(0)
+    , m_hasState(false)
+    , m_state{}
+{
+}
+
+
+IFACEMETHODIMP CanvasDrawingTrace::get_CallCount(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+            *value = m_callCount;
+        });
+}
+
+
+IFACEMETHODIMP CanvasDrawingTrace::get_SkippedCallCount(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+            *value = m_skippedCallCount;
+        });
+}
+
+
+IFACEMETHODIMP CanvasDrawingTrace::GetBytes(
+    uint32_t* byteCount,
+    BYTE** bytes)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(byteCount);
+            CheckAndClearOutPointer(bytes);
+
+            Lock lock(m_mutex);
+
+            DrawingTraceHeader header{ DrawingTraceHeader::ExpectedMagic, DrawingTraceHeader::CurrentVersion };
+
+            ComArray<uint8_t> array(static_cast<uint32_t>(sizeof(header) + m_records.size()));
+
+            memcpy(array.GetData(), &header, sizeof(header));
+
+            if (!m_records.empty())
+                memcpy(array.GetData() + sizeof(header), m_records.data(), m_records.size());
+
+            array.Detach(byteCount, bytes);
+        });
+}
+
+
+IFACEMETHODIMP CanvasDrawingTrace::Load(
+    uint32_t byteCount,
+    BYTE* bytes)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(bytes);
+
+            if (byteCount < sizeof(DrawingTraceHeader))
+                ThrowInvalidTrace();
+
+            auto header = ReadPayload<DrawingTraceHeader>(bytes);
+
+            if (header.Magic != DrawingTraceHeader::ExpectedMagic ||
+                header.Version != DrawingTraceHeader::CurrentVersion)
+            {
+                ThrowInvalidTrace();
+            }
+
+            auto records = bytes + sizeof(header);
+            auto recordsSize = byteCount - sizeof(header);
+
+            uint32_t callCount = 0;
+            uint32_t skippedCallCount = 0;
+            uint32_t geometryCount = 0;
+
+            ForEachRecord(records, recordsSize,
+                [&](DrawingTraceOp op, uint8_t const* payload, uint32_t size)
+                {
+                    if (op >= DrawingTraceOp::Count)
+                        ThrowInvalidTrace();
+
+                    if (op == DrawingTraceOp::DefineGeometry)
+                    {
+                        ValidateGeometryDefinition(payload, size, geometryCount);
+                        geometryCount++;
+                        return;
+                    }
+
+                    if (size != GetPayloadSize(op))
+                        ThrowInvalidTrace();
+
+                    if (op == DrawingTraceOp::DrawGeometry || op == DrawingTraceOp::FillGeometry)
+                    {
+                        if (ReadPayload<DrawingTraceGeometry>(payload).Id >= geometryCount)
+                            ThrowInvalidTrace();
+                    }
+
+                    if (IsRecordedCall(op))
+                        callCount++;
+                    else if (op == DrawingTraceOp::Skipped)
+                        skippedCallCount++;
+                });
+
+            Lock lock(m_mutex);
+
+            m_records.assign(records, records + recordsSize);
+            m_callCount = callCount;
+            m_skippedCallCount = skippedCallCount;
+            m_geometryCount = geometryCount;
+            m_hasState = false;
+            m_geometryIds.clear();
+            m_geometries.clear();
+        });
+}
+
+
+IFACEMETHODIMP CanvasDrawingTrace::Clear()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+
+            m_records.clear();
+            m_callCount = 0;
+            m_skippedCallCount = 0;
+            m_geometryCount = 0;
+            m_hasState = false;
+            m_geometryIds.clear();
+            m_geometries.clear();
+        });
+}
+
+
+IFACEMETHODIMP CanvasDrawingTrace::Replay(
+    ICanvasDrawingSession* drawingSession,
+    ABI::Windows::Foundation::TimeSpan* elapsedTime)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(drawingSession);
+            CheckInPointer(elapsedTime);
+
+            // Work from a copy, so that replaying onto a session that is
+            // recording into this same trace doesn't deadlock.
+            std::vector<uint8_t> records;
+            {
+                Lock lock(m_mutex);
+                records = m_records;
+            }
+
+            std::vector<ComPtr<ICanvasGeometry>> geometries;
+
+            auto startTime = GetTimestamp();
+
+            // Colors go back through the Windows.UI.Color overloads, so high
+            // dynamic range values are clamped, except by Clear.
+            ForEachRecord(records.data(), records.size(),
+                [&](DrawingTraceOp op, uint8_t const* payload, uint32_t)
+                {
+                    switch (op)
+                    {
+                    case DrawingTraceOp::SetState:
+                        {
+                            auto state = ReadPayload<DrawingTraceState>(payload);
+                            ThrowIfFailed(drawingSession->put_Transform(state.Transform));
+                            ThrowIfFailed(drawingSession->put_Antialiasing(state.Antialiasing));
+                            ThrowIfFailed(drawingSession->put_Blend(state.Blend));
+                        }
+                        break;
+
+                    case DrawingTraceOp::Clear:
+                        {
+                            auto color = ReadPayload<D2D1_COLOR_F>(payload);
+                            ThrowIfFailed(drawingSession->ClearHdr(Vector4{ color.r, color.g, color.b, color.a }));
+                        }
+                        break;
+
+                    case DrawingTraceOp::DrawLine:
+                        {
+                            auto line = ReadPayload<DrawingTraceLine>(payload);
+                            ThrowIfFailed(drawingSession->DrawLineWithColorAndStrokeWidth(line.Point0, line.Point1, ToWindowsColor(line.Color), line.StrokeWidth));
+                        }
+                        break;
+
+                    case DrawingTraceOp::DrawRectangle:
+                        {
+                            auto rectangle = ReadPayload<DrawingTraceRectangle>(payload);
+                            ThrowIfFailed(drawingSession->DrawRectangleWithColorAndStrokeWidth(rectangle.Bounds, ToWindowsColor(rectangle.Color), rectangle.StrokeWidth));
+                        }
+                        break;
+
+                    case DrawingTraceOp::FillRectangle:
+                        {
+                            auto rectangle = ReadPayload<DrawingTraceRectangle>(payload);
+                            ThrowIfFailed(drawingSession->FillRectangleWithColor(rectangle.Bounds, ToWindowsColor(rectangle.Color)));
+                        }
+                        break;
+
+                    case DrawingTraceOp::DrawRoundedRectangle:
+                        {
+                            auto rectangle = ReadPayload<DrawingTraceRoundedRectangle>(payload);
+                            ThrowIfFailed(drawingSession->DrawRoundedRectangleWithColorAndStrokeWidth(rectangle.Bounds, rectangle.RadiusX, rectangle.RadiusY, ToWindowsColor(rectangle.Color), rectangle.StrokeWidth));
+                        }
+                        break;
+
+                    case DrawingTraceOp::FillRoundedRectangle:
+                        {
+                            auto rectangle = ReadPayload<DrawingTraceRoundedRectangle>(payload);
+                            ThrowIfFailed(drawingSession->FillRoundedRectangleWithColor(rectangle.Bounds, rectangle.RadiusX, rectangle.RadiusY, ToWindowsColor(rectangle.Color)));
+                        }
+                        break;
+
+                    case DrawingTraceOp::DrawEllipse:
+                        {
+                            auto ellipse = ReadPayload<DrawingTraceEllipse>(payload);
+                            ThrowIfFailed(drawingSession->DrawEllipseWithColorAndStrokeWidth(ellipse.CenterPoint, ellipse.RadiusX, ellipse.RadiusY, ToWindowsColor(ellipse.Color), ellipse.StrokeWidth));
+                        }
+                        break;
+
+                    case DrawingTraceOp::FillEllipse:
+                        {
+                            auto ellipse = ReadPayload<DrawingTraceEllipse>(payload);
+                            ThrowIfFailed(drawingSession->FillEllipseWithColor(ellipse.CenterPoint, ellipse.RadiusX, ellipse.RadiusY, ToWindowsColor(ellipse.Color)));
+                        }
+                        break;
+
+                    case DrawingTraceOp::DefineGeometry:
+                        geometries.push_back(CreateGeometry(As<ICanvasResourceCreator>(drawingSession).Get(), payload));
+                        break;
+
+                    case DrawingTraceOp::DrawGeometry:
+                        {
+                            auto geometry = ReadPayload<DrawingTraceGeometry>(payload);
+                            ThrowIfFailed(drawingSession->DrawGeometryAtOriginWithColorAndStrokeWidth(geometries[geometry.Id].Get(), ToWindowsColor(geometry.Color), geometry.StrokeWidth));
+                        }
+                        break;
+
+                    case DrawingTraceOp::FillGeometry:
+                        {
+                            auto geometry = ReadPayload<DrawingTraceGeometry>(payload);
+                            ThrowIfFailed(drawingSession->FillGeometryAtOriginWithColor(geometries[geometry.Id].Get(), ToWindowsColor(geometry.Color)));
+                        }
+                        break;
+
+                    default:
+                        // BeginSession and Skipped have nothing to replay.
+                        break;
+                    }
+                });
+
+            elapsedTime->Duration = GetTimestamp() - startTime;
+        });
+}
+
+
+void CanvasDrawingTrace::RecordBeginSession()
+{
+    Lock lock(m_mutex);
+
+    AppendRecord(DrawingTraceOp::BeginSession, nullptr, 0);
+
+    // A new session starts from default state, so the next call records whatever it uses.
+    m_hasState = false;
+}
+
+
+void CanvasDrawingTrace::RecordClear(DrawingTraceState const& state, D2D1_COLOR_F const& color)
+{
+    Lock lock(m_mutex);
+
+    UpdateState(state);
+    AppendRecord(DrawingTraceOp::Clear, color);
+}
+
+
+void CanvasDrawingTrace::RecordLine(
+    DrawingTraceState const& state,
+    Vector2 const& point0,
+    Vector2 const& point1,
+    ID2D1Brush* brush,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle)
+{
+    Lock lock(m_mutex);
+
+    DrawingTraceLine line{ point0, point1, {}, strokeWidth };
+
+    if (!TryGetColor(brush, strokeStyle, &line.Color))
+        return AppendRecord(DrawingTraceOp::Skipped, nullptr, 0);
+
+    UpdateState(state);
+    AppendRecord(DrawingTraceOp::DrawLine, line);
+}
+
+
+void CanvasDrawingTrace::RecordRectangle(
+    DrawingTraceState const& state,
+    DrawingTraceOp op,
+    Rect const& rect,
+    ID2D1Brush* brush,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle)
+{
+    Lock lock(m_mutex);
+
+    DrawingTraceRectangle rectangle{ rect, {}, strokeWidth };
+
+    if (!TryGetColor(brush, strokeStyle, &rectangle.Color))
+        return AppendRecord(DrawingTraceOp::Skipped, nullptr, 0);
+
+    UpdateState(state);
+    AppendRecord(op, rectangle);
+}
+
+
+void CanvasDrawingTrace::RecordRoundedRectangle(
+    DrawingTraceState const& state,
+    DrawingTraceOp op,
+    Rect const& rect,
+    float radiusX,
+    float radiusY,
+    ID2D1Brush* brush,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle)
+{
+    Lock lock(m_mutex);
+
+    DrawingTraceRoundedRectangle rectangle{ rect, radiusX, radiusY, {}, strokeWidth };
+
+    if (!TryGetColor(brush, strokeStyle, &rectangle.Color))
+        return AppendRecord(DrawingTraceOp::Skipped, nullptr, 0);
+
+    UpdateState(state);
+    AppendRecord(op, rectangle);
+}
+
+
+void CanvasDrawingTrace::RecordEllipse(
+    DrawingTraceState const& state,
+    DrawingTraceOp op,
+    Vector2 const& centerPoint,
+    float radiusX,
+    float radiusY,
+    ID2D1Brush* brush,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle)
+{
+    Lock lock(m_mutex);
+
+    DrawingTraceEllipse ellipse{ centerPoint, radiusX, radiusY, {}, strokeWidth };
+
+    if (!TryGetColor(brush, strokeStyle, &ellipse.Color))
+        return AppendRecord(DrawingTraceOp::Skipped, nullptr, 0);
+
+    UpdateState(state);
+    AppendRecord(op, ellipse);
+}
+
+
+void CanvasDrawingTrace::RecordGeometry(
+    DrawingTraceState const& state,
+    DrawingTraceOp op,
+    ICanvasGeometry* geometry,
+    ID2D1Brush* brush,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle)
+{
+    Lock lock(m_mutex);
+
+    DrawingTraceGeometry record{ 0, {}, strokeWidth };
+
+    if (!TryGetColor(brush, strokeStyle, &record.Color))
+        return AppendRecord(DrawingTraceOp::Skipped, nullptr, 0);
+
+    record.Id = GetGeometryId(geometry);
+
+    UpdateState(state);
+    AppendRecord(op, record);
+}
+
+
+void CanvasDrawingTrace::RecordSkipped()
+{
+    Lock lock(m_mutex);
+
+    AppendRecord(DrawingTraceOp::Skipped, nullptr, 0);
+}
+
+
+void CanvasDrawingTrace::AppendRecord(DrawingTraceOp op, void const* payload, uint32_t size)
+{
+    DrawingTraceRecordHeader header{ op, size };
+
+    auto headerBytes = reinterpret_cast<uint8_t const*>(&header);
+    auto payloadBytes = static_cast<uint8_t const*>(payload);
+
+    m_records.insert(m_records.end(), headerBytes, headerBytes + sizeof(header));
+
+    if (size)
+        m_records.insert(m_records.end(), payloadBytes, payloadBytes + size);
+
+    if (IsRecordedCall(op))
+        m_callCount++;
+    else if (op == DrawingTraceOp::Skipped)
+        m_skippedCallCount++;
+}
+
+
+void CanvasDrawingTrace::UpdateState(DrawingTraceState const& state)
+{
+    if (m_hasState && memcmp(&state, &m_state, sizeof(state)) == 0)
+        return;
+
+    AppendRecord(DrawingTraceOp::SetState, state);
+
+    m_state = state;
+    m_hasState = true;
+}
+
+
+uint32_t CanvasDrawingTrace::GetGeometryId(ICanvasGeometry* geometry)
+{
+    auto it = m_geometryIds.find(geometry);
+
+    if (it != m_geometryIds.end())
+        return it->second;
+
+    ComArray<CanvasGeometryPathCommand> commands;
+    ComArray<float> segmentData;
+
+    ThrowIfFailed(geometry->GetPathData(commands.GetAddressOfSize(), commands.GetAddressOfData(), segmentData.GetAddressOfSize(), segmentData.GetAddressOfData()));
+
+    auto id = m_geometryCount;
+
+    DrawingTraceGeometryDefinition definition{ id, commands.GetSize(), segmentData.GetSize() };
+
+    std::vector<uint8_t> payload(sizeof(definition) + commands.GetSize() * sizeof(CanvasGeometryPathCommand) + segmentData.GetSize() * sizeof(float));
+
+    auto out = payload.data();
+    memcpy(out, &definition, sizeof(definition));
+
+    out += sizeof(definition);
+    memcpy(out, commands.GetData(), commands.GetSize() * sizeof(CanvasGeometryPathCommand));
+
+    out += commands.GetSize() * sizeof(CanvasGeometryPathCommand);
+    memcpy(out, segmentData.GetData(), segmentData.GetSize() * sizeof(float));
+
+    AppendRecord(DrawingTraceOp::DefineGeometry, payload.data(), static_cast<uint32_t>(payload.size()));
+
+    m_geometries.push_back(geometry);
+    m_geometryIds[geometry] = id;
+    m_geometryCount++;
+
+    return id;
+}
+
+
+bool CanvasDrawingTrace::TryGetColor(ID2D1Brush* brush, ICanvasStrokeStyle* strokeStyle, D2D1_COLOR_F* color)
+{
+    if (strokeStyle)
+        return false;
+
+    auto solidColorBrush = MaybeAs<ID2D1SolidColorBrush>(brush);
+
+    if (!solidColorBrush)
+        return false;
+
+    *color = solidColorBrush->GetColor();
+    color->a *= solidColorBrush->GetOpacity();
+
+    return true;
+}
+
+
+ActivatableClassWithFactory(CanvasDrawingTrace, ::SimpleAgileActivationFactory<CanvasDrawingTrace>);
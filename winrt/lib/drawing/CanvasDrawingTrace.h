@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+    //
+    // The bytes returned by GetBytes are a DrawingTraceHeader followed by
+    // records, each a DrawingTraceRecordHeader and then Size bytes of
+    // payload.  The comments give the payload for each op.
+    //
+    enum class DrawingTraceOp : uint32_t
+    {
+        BeginSession,           // None
+        SetState,               // DrawingTraceState
+        Clear,                  // D2D1_COLOR_F
+        DrawLine,               // DrawingTraceLine
+        DrawRectangle,          // DrawingTraceRectangle
+        FillRectangle,          // DrawingTraceRectangle
+        DrawRoundedRectangle,   // DrawingTraceRoundedRectangle
+        FillRoundedRectangle,   // DrawingTraceRoundedRectangle
+        DrawEllipse,            // DrawingTraceEllipse
+        FillEllipse,            // DrawingTraceEllipse
+        DefineGeometry,         // DrawingTraceGeometryDefinition, then the path commands, then the segment data
+        DrawGeometry,           // DrawingTraceGeometry
+        FillGeometry,           // DrawingTraceGeometry
+        Skipped,                // None
+        Count
+    };
+
+    struct DrawingTraceHeader
+    {
+        static const uint32_t ExpectedMagic = 0x54443257;       // "W2DT" when written little-endian
+        static const uint32_t CurrentVersion = 1;
+
+        uint32_t Magic;
+        uint32_t Version;
+    };
+
+    struct DrawingTraceRecordHeader
+    {
+        DrawingTraceOp Op;
+        uint32_t Size;
+    };
+
+    struct DrawingTraceState
+    {
+        Matrix3x2 Transform;
+        CanvasAntialiasing Antialiasing;
+        CanvasBlend Blend;
+    };
+
+    // Fills record a StrokeWidth of zero.
+
+    struct DrawingTraceLine
+    {
+        Vector2 Point0;
+        Vector2 Point1;
+        D2D1_COLOR_F Color;
+        float StrokeWidth;
+    };
+
+    struct DrawingTraceRectangle
+    {
+        Rect Bounds;
+        D2D1_COLOR_F Color;
+        float StrokeWidth;
+    };
+
+    struct DrawingTraceRoundedRectangle
+    {
+        Rect Bounds;
+        float RadiusX;
+        float RadiusY;
+        D2D1_COLOR_F Color;
+        float StrokeWidth;
+    };
+
+    struct DrawingTraceEllipse
+    {
+        Vector2 CenterPoint;
+        float RadiusX;
+        float RadiusY;
+        D2D1_COLOR_F Color;
+        float StrokeWidth;
+    };
+
+    // Geometries are numbered from zero, in the order they are defined.
+    struct DrawingTraceGeometryDefinition
+    {
+        uint32_t Id;
+        uint32_t CommandCount;
+        uint32_t SegmentDataCount;
+    };
+
+    struct DrawingTraceGeometry
+    {
+        uint32_t Id;
+        D2D1_COLOR_F Color;
+        float StrokeWidth;
+    };
+
+
+    //
+    // Records are appended to m_records as CanvasDrawingSession reports each
+    // call.  The geometries that have been defined are kept alive, so that
+    // their addresses stay unique while they are used as keys.
+    //
+    class CanvasDrawingTrace : public RuntimeClass<ICanvasDrawingTrace>,
+                               private LifespanTracker<CanvasDrawingTrace>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasDrawingTrace, BaseTrust);
+
+        std::mutex m_mutex;
+        std::vector<uint8_t> m_records;
+        uint32_t m_callCount;
+        uint32_t m_skippedCallCount;
+        uint32_t m_geometryCount;
+
+        bool m_hasState;
+        DrawingTraceState m_state;
+
+        std::unordered_map<ICanvasGeometry*, uint32_t> m_geometryIds;
+        std::vector<ComPtr<ICanvasGeometry>> m_geometries;
+
+    public:
+        CanvasDrawingTrace();
+
+        IFACEMETHOD(get_CallCount)(uint32_t* value) override;
+
+        IFACEMETHOD(get_SkippedCallCount)(uint32_t* value) override;
+
+        IFACEMETHOD(GetBytes)(
+            uint32_t* byteCount,
+            BYTE** bytes) override;
+
+        IFACEMETHOD(Load)(
+            uint32_t byteCount,
+            BYTE* bytes) override;
+
+        IFACEMETHOD(Clear)() override;
+
+        IFACEMETHOD(Replay)(
+            ICanvasDrawingSession* drawingSession,
+            ABI::Windows::Foundation::TimeSpan* elapsedTime) override;
+
+        //
+        // Called by CanvasDrawingSession.  A call is only recorded if its
+        // brush is a solid color brush and it has no stroke style; otherwise
+        // it is counted as skipped.
+        //
+
+        void RecordBeginSession();
+
+        void RecordClear(DrawingTraceState const& state, D2D1_COLOR_F const& color);
+
+        void RecordLine(
+            DrawingTraceState const& state,
+            Vector2 const& point0,
+            Vector2 const& point1,
+            ID2D1Brush* brush,
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle);
+
+        void RecordRectangle(
+            DrawingTraceState const& state,
+            DrawingTraceOp op,
+            Rect const& rect,
+            ID2D1Brush* brush,
+            float strokeWidth = 0,
+            ICanvasStrokeStyle* strokeStyle = nullptr);
+
+        void RecordRoundedRectangle(
+            DrawingTraceState const& state,
+            DrawingTraceOp op,
+            Rect const& rect,
+            float radiusX,
+            float radiusY,
+            ID2D1Brush* brush,
+            float strokeWidth = 0,
+            ICanvasStrokeStyle* strokeStyle = nullptr);
+
+        void RecordEllipse(
+            DrawingTraceState const& state,
+            DrawingTraceOp op,
+            Vector2 const& centerPoint,
+            float radiusX,
+            float radiusY,
+            ID2D1Brush* brush,
+            float strokeWidth = 0,
+            ICanvasStrokeStyle* strokeStyle = nullptr);
+
+        void RecordGeometry(
+            DrawingTraceState const& state,
+            DrawingTraceOp op,
+            ICanvasGeometry* geometry,
+            ID2D1Brush* brush,
+            float strokeWidth = 0,
+            ICanvasStrokeStyle* strokeStyle = nullptr);
+
+        void RecordSkipped();
+
+    private:
+        // These expect m_mutex to already be held.
+
+        void AppendRecord(DrawingTraceOp op, void const* payload, uint32_t size);
+
+        template<typename T>
+        void AppendRecord(DrawingTraceOp op, T const& payload)
+        {
+            AppendRecord(op, &payload, sizeof(payload));
+        }
+
+        void UpdateState(DrawingTraceState const& state);
+
+        uint32_t GetGeometryId(ICanvasGeometry* geometry);
+
+        static bool TryGetColor(ID2D1Brush* brush, ICanvasStrokeStyle* strokeStyle, D2D1_COLOR_F* color);
+    };
+}}}}
@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasGpuFence.h"
+#include "utils/D2DResourceLock.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    CanvasGpuFence::CanvasGpuFence(
+        ID2D1Device* d2dDevice,
+        ID3D11Device* d3dDevice)
+        : m_d2dDevice(d2dDevice)
+    {
+        d3dDevice->GetImmediateContext(&m_immediateContext);
+
+        auto d3dDevice5 = MaybeAs<ID3D11Device5>(d3dDevice);
+        auto immediateContext4 = MaybeAs<ID3D11DeviceContext4>(m_immediateContext);
+
+        if (d3dDevice5 && immediateContext4)
+        {
+            ThrowIfFailed(d3dDevice5->CreateFence(0, D3D11_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+        }
+        else
+        {
+            D3D11_QUERY_DESC desc{ D3D11_QUERY_EVENT, 0 };
+            ThrowIfFailed(d3dDevice->CreateQuery(&desc, &m_query));
+        }
+
+        // The immediate context is shared with D2D, so is protected by its lock.
+        D2DResourceLock lock(m_d2dDevice.Get());
+
+        if (m_fence)
+            ThrowIfFailed(immediateContext4->Signal(m_fence.Get(), 1));
+        else
+            m_immediateContext->End(m_query.Get());
+
+        // Submit the query along with everything before it.  This doesn't
+        // wait for the GPU, but without it the fence might not complete
+        // until the app next flushes or presents.
+        m_immediateContext->Flush();
+    }
+
+
+    IFACEMETHODIMP CanvasGpuFence::get_IsCompleted(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                Lock lock(m_mutex);
+
+                *value = PollForCompletion();
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasGpuFence::WaitAsync(IAsyncAction** action)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(action);
+
+                ComPtr<CanvasGpuFence> self = this;
+
+                auto asyncAction = Make<AsyncAction>(
+                    [self]
+                    {
+                        self->WaitForCompletion();
+                    });
+
+                CheckMakeResult(asyncAction);
+                ThrowIfFailed(asyncAction.CopyTo(action));
+            });
+    }
+
+
+    void CanvasGpuFence::WaitForCompletion()
+    {
+        if (TryWaitForCompletion())
+            return;
+
+        // Event queries can't signal an event, so the only way to wait for
+        // one is to poll.  Each poll only takes the D2D lock briefly, so
+        // other threads can keep rendering in the meantime.
+        for (;;)
+        {
+            {
+                Lock lock(m_mutex);
+
+                if (PollForCompletion())
+                    return;
+            }
+
+            Sleep(1);
+        }
+    }
+
+
+    bool CanvasGpuFence::TryWaitForCompletion()
+    {
+        ComPtr<ID3D11Fence> fence;
+
+        {
+            Lock lock(m_mutex);
+
+            if (!m_query && !m_fence)
+                return true;
+
+            fence = m_fence;
+        }
+
+        if (!fence)
+            return false;
+
+        Wrappers::Event completedEvent(CreateEventEx(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+
+        if (!completedEvent.IsValid())
+            ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+
+        // If the device is lost, the fence jumps to UINT64_MAX, which also
+        // sets the event, so this never waits forever.
+        ThrowIfFailed(fence->SetEventOnCompletion(1, completedEvent.Get()));
+
+        if (WaitForSingleObjectEx(completedEvent.Get(), INFINITE, FALSE) == WAIT_FAILED)
+            ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+
+        Lock lock(m_mutex);
+
+        m_fence.Reset();
+        m_immediateContext.Reset();
+
+        return true;
+    }
+
+
+    bool CanvasGpuFence::PollForCompletion()
+    {
+        if (m_fence)
+        {
+            // Fences can be read from any thread, so this doesn't need the
+            // D2D lock.  A lost device reports UINT64_MAX.
+            if (m_fence->GetCompletedValue() < 1)
+                return false;
+
+            m_fence.Reset();
+            m_immediateContext.Reset();
+
+            return true;
+        }
+
+        if (!m_query)
+            return true;
+
+        D2DResourceLock lock(m_d2dDevice.Get());
+
+        // The query was flushed when the fence was inserted, so there is no
+        // need for polling to submit anything else.
+        HRESULT hr = m_immediateContext->GetData(m_query.Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH);
+
+        if (hr == S_FALSE)
+            return false;
+
+        // A failure here means the device was lost.  The GPU will never
+        // finish the work, but nor will it touch anything again, so it is
+        // just as safe to reuse resources as if it had.
+        m_query.Reset();
+        m_immediateContext.Reset();
+
+        return true;
+    }
+}}}}
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ABI::Windows::Foundation;
+
+    //
+    // Wraps a D3D fence, which the GPU signals once it has finished all the
+    // work submitted before it.  Where the device supports ID3D11Fence, that
+    // is used, so waiting can block on an event; otherwise this falls back
+    // to an event query, which can only be polled.  Checking IsCompleted
+    // never stalls the CPU.  The fence is released as soon as it is seen to
+    // complete.
+    //
+    class CanvasGpuFence : public RuntimeClass<ICanvasGpuFence>,
+                           private LifespanTracker<CanvasGpuFence>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasGpuFence, BaseTrust);
+
+        std::mutex m_mutex;
+
+        ComPtr<ID2D1Device> m_d2dDevice;
+        ComPtr<ID3D11DeviceContext> m_immediateContext;
+        ComPtr<ID3D11Query> m_query;
+        ComPtr<ID3D11Fence> m_fence;
+
+    public:
+        CanvasGpuFence(
+            ID2D1Device* d2dDevice,
+            ID3D11Device* d3dDevice);
+
+        IFACEMETHOD(get_IsCompleted)(boolean* value) override;
+        IFACEMETHOD(WaitAsync)(IAsyncAction** action) override;
+
+        // Blocks the calling thread until the GPU reaches the fence.  This
+        // waits on an event where the device supports ID3D11Fence, and
+        // otherwise polls the event query.
+        void WaitForCompletion();
+
+    private:
+        bool TryWaitForCompletion();
+        bool PollForCompletion();
+    };
+}}}}
@@ -230,6 +230,7 @@ CanvasGradientMesh::CanvasGradientMesh(
     ID2D1GradientMesh* d2dGradientMesh)
         : ResourceWrapper(d2dGradientMesh)
         , m_canvasDevice(canvasDevice)
+        , m_d2dPatchesMatchResource(false)
 {
 }
         
@@ -304,9 +305,90 @@ IFACEMETHODIMP CanvasGradientMesh::GetBoundsWithTransform(
 }
 
 
+IFACEMETHODIMP CanvasGradientMesh::SetPatches(
+    uint32_t patchCount,
+    CanvasGradientMeshPatch* patchElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            GetResource();
+
+            auto& device = m_canvasDevice.EnsureNotClosed();
+
+            if (!UpdateD2DPatches(patchCount, patchElements))
+                return;
+
+            // Like CreateNew, never pass D2D a null patch array.
+            D2D1_GRADIENT_MESH_PATCH emptyPatch{};
+
+            auto d2dGradientMesh = As<ICanvasDeviceInternal>(device)->CreateGradientMesh(
+                m_d2dPatches.empty() ? &emptyPatch : &m_d2dPatches[0],
+                patchCount);
+
+            SetResource(d2dGradientMesh.Get());
+            m_d2dPatchesMatchResource = true;
+        });
+}
+
+IFACEMETHODIMP CanvasGradientMesh::get_PatchCount(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = GetResource()->GetPatchCount();
+        });
+}
+
+IFACEMETHODIMP CanvasGradientMesh::get_SizeInBytes(uint64_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            // D2D doesn't report what it allocates for a mesh, but its size
+            // is proportional to the patch data that it holds.
+            *value = static_cast<uint64_t>(GetResource()->GetPatchCount()) * sizeof(D2D1_GRADIENT_MESH_PATCH);
+        });
+}
+
+bool CanvasGradientMesh::UpdateD2DPatches(
+    uint32_t patchCount,
+    CanvasGradientMeshPatch* patchElements)
+{
+    if (patchCount > 0)
+    {
+        CheckInPointer(patchElements);
+    }
+
+    bool changed = !m_d2dPatchesMatchResource || m_d2dPatches.size() != patchCount;
+
+    m_d2dPatches.resize(patchCount);
+
+    for (uint32_t i = 0; i < patchCount; ++i)
+    {
+        auto d2dPatch = CanvasGradientMeshFactory::PatchToD2DPatch(patchElements[i]);
+
+        if (!changed && memcmp(&d2dPatch, &m_d2dPatches[i], sizeof(d2dPatch)) == 0)
+            continue;
+
+        m_d2dPatches[i] = d2dPatch;
+        changed = true;
+    }
+
+    m_d2dPatchesMatchResource = !changed;
+
+    return changed;
+}
+
 IFACEMETHODIMP CanvasGradientMesh::Close()
 {
     m_canvasDevice.Close();
+    m_d2dPatches.clear();
+    m_d2dPatchesMatchResource = false;
     return ResourceWrapper::Close();
 }
 
@@ -352,6 +434,11 @@ ComPtr<CanvasGradientMesh> CanvasGradientMesh::CreateNew(
         d2dGradientMesh.Get());
     CheckMakeResult(canvasGradientMesh);
 
+    // Hang on to the converted patches, so SetPatches can reuse them.
+    d2dPatches.resize(patchCount);
+    canvasGradientMesh->m_d2dPatches = std::move(d2dPatches);
+    canvasGradientMesh->m_d2dPatchesMatchResource = true;
+
     return canvasGradientMesh;
 }
 
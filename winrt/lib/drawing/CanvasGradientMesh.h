@@ -20,6 +20,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ClosablePtr<ICanvasDevice> m_canvasDevice;
 
+        // The D2D patches the current resource was built from, kept so that
+        // SetPatches can reuse the allocation and skip redundant rebuilds.
+        // Empty for meshes created through interop.
+        std::vector<D2D1_GRADIENT_MESH_PATCH> m_d2dPatches;
+        bool m_d2dPatchesMatchResource;
+
     public:
         static ComPtr<CanvasGradientMesh> CreateNew(
             ICanvasResourceCreator* resourceCreator,
@@ -43,9 +49,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             Numerics::Matrix3x2 transform,
             Rect* bounds) override;
 
+        IFACEMETHOD(SetPatches)(
+            uint32_t patchCount,
+            CanvasGradientMeshPatch* patchElements) override;
+
+        IFACEMETHOD(get_PatchCount)(uint32_t* value) override;
+
+        IFACEMETHOD(get_SizeInBytes)(uint64_t* value) override;
+
         IFACEMETHOD(Close)() override;
 
         IFACEMETHOD(get_Device)(ICanvasDevice** device) override;
+
+    private:
+        // Converts the patches into m_d2dPatches, returning false if they are
+        // the same as the ones the current resource was built from.
+        bool UpdateD2DPatches(uint32_t patchCount, CanvasGradientMeshPatch* patchElements);
     };
 
     class CanvasGradientMeshFactory
@@ -0,0 +1,358 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasImageTileCache.h"
+#include "images/CanvasCommandList.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasImageTileCacheFactory
+    //
+
+    IFACEMETHODIMP CanvasImageTileCacheFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasImageTileCache** tileCache)
+    {
+        return CreateWithTileSize(resourceCreator, CanvasImageTileCache::DefaultTileSizeInPixels, tileCache);
+    }
+
+    IFACEMETHODIMP CanvasImageTileCacheFactory::CreateWithTileSize(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t tileSizeInPixels,
+        ICanvasImageTileCache** tileCache)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(tileCache);
+
+                if (tileSizeInPixels <= 0)
+                    ThrowHR(E_INVALIDARG);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newTileCache = Make<CanvasImageTileCache>(device.Get(), tileSizeInPixels);
+                CheckMakeResult(newTileCache);
+
+                ThrowIfFailed(newTileCache.CopyTo(tileCache));
+            });
+    }
+
+
+    //
+    // Tile math
+    //
+
+    static int ToTileIndex(double pixels, int tileSizeInPixels, bool roundUp)
+    {
+        auto tile = pixels / tileSizeInPixels;
+
+        tile = roundUp ? ceil(tile) : floor(tile);
+
+        // Keeps the index and the pixel position of the tile in range of an int.
+        auto limit = static_cast<double>(INT_MAX / tileSizeInPixels);
+
+        return static_cast<int>(std::max(-limit, std::min(limit, tile)));
+    }
+
+    TileRange GetTilesOverlappingRect(Rect const& rect, int tileSizeInPixels, float dpi)
+    {
+        if (!(rect.Width > 0) || !(rect.Height > 0))
+            return TileRange{ 0, 0, 0, 0 };
+
+        double scale = dpi / DEFAULT_DPI;
+
+        return TileRange
+        {
+            ToTileIndex(rect.X * scale, tileSizeInPixels, false),
+            ToTileIndex(rect.Y * scale, tileSizeInPixels, false),
+            ToTileIndex((rect.X + rect.Width) * scale, tileSizeInPixels, true),
+            ToTileIndex((rect.Y + rect.Height) * scale, tileSizeInPixels, true)
+        };
+    }
+
+    static bool IsSameRange(TileRange const& a, TileRange const& b)
+    {
+        return a.Left == b.Left &&
+               a.Top == b.Top &&
+               a.Right == b.Right &&
+               a.Bottom == b.Bottom;
+    }
+
+
+    //
+    // CanvasImageTileCache
+    //
+
+    CanvasImageTileCache::CanvasImageTileCache(ICanvasDevice* device, int tileSizeInPixels)
+        : m_device(device)
+        , m_tileSizeInPixels(tileSizeInPixels)
+        , m_maximumTileCount(DefaultMaximumTileCount)
+        , m_dpi(0)
+        , m_updateCount(0)
+        , m_cachedRange{}
+    {
+    }
+
+    IFACEMETHODIMP CanvasImageTileCache::get_TileSizeInPixels(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_tileSizeInPixels;
+            });
+    }
+
+    IFACEMETHODIMP CanvasImageTileCache::get_MaximumTileCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_maximumTileCount;
+            });
+    }
+
+    IFACEMETHODIMP CanvasImageTileCache::put_MaximumTileCount(int32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                m_maximumTileCount = value;
+                EvictTiles();
+            });
+    }
+
+    IFACEMETHODIMP CanvasImageTileCache::Invalidate()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                Clear();
+            });
+    }
+
+    IFACEMETHODIMP CanvasImageTileCache::InvalidateRegion(Rect region)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (m_tiles.empty())
+                    return;
+
+                auto range = GetTilesOverlappingRect(region, m_tileSizeInPixels, m_dpi);
+
+                if (range.IsEmpty())
+                    return;
+
+                for (auto it = m_tiles.begin(); it != m_tiles.end(); )
+                {
+                    auto& index = it->first;
+
+                    if (index.first >= range.Left && index.first < range.Right &&
+                        index.second >= range.Top && index.second < range.Bottom)
+                    {
+                        it = m_tiles.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+
+                m_cachedImage.Reset();
+            });
+    }
+
+    IFACEMETHODIMP CanvasImageTileCache::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    void CanvasImageTileCache::Clear()
+    {
+        m_tiles.clear();
+        m_cachedImage.Reset();
+        m_image.Reset();
+        m_dpi = 0;
+    }
+
+    ComPtr<ICanvasImage> CanvasImageTileCache::Update(ICanvasImage* image, Rect const& visibleRect, float dpi)
+    {
+        if (!IsSameInstance(image, m_image.Get()) || dpi != m_dpi)
+        {
+            Clear();
+            m_image = image;
+            m_dpi = dpi;
+        }
+
+        auto range = GetTilesOverlappingRect(visibleRect, m_tileSizeInPixels, dpi);
+
+        if (range.IsEmpty())
+            return nullptr;
+
+        m_updateCount++;
+
+        ComPtr<ID2D1DeviceContext1> deviceContext;
+        ComPtr<ID2D1Image> d2dImage;
+        bool isChanged = !m_cachedImage || !IsSameRange(range, m_cachedRange);
+
+        for (int y = range.Top; y < range.Bottom; y++)
+        {
+            for (int x = range.Left; x < range.Right; x++)
+            {
+                TileIndex index(x, y);
+
+                auto tile = m_tiles.find(index);
+
+                if (tile == m_tiles.end())
+                {
+                    if (!deviceContext)
+                    {
+                        deviceContext = As<ICanvasDeviceInternal>(m_device)->CreateDeviceContextForDrawingSession();
+                        deviceContext->SetDpi(dpi, dpi);
+
+                        d2dImage = As<ICanvasImageInternal>(image)->GetD2DImage(m_device.Get(), deviceContext.Get(), GetImageFlags::None, dpi);
+                    }
+
+                    auto bitmap = RenderTile(deviceContext.Get(), d2dImage.Get(), index);
+
+                    tile = m_tiles.emplace(index, CachedTile{ bitmap }).first;
+                    isChanged = true;
+                }
+
+                tile->second.LastUsed = m_updateCount;
+            }
+        }
+
+        if (isChanged)
+        {
+            // Reset first, so if recording fails we try again next time.
+            m_cachedImage.Reset();
+
+            if (!deviceContext)
+            {
+                deviceContext = As<ICanvasDeviceInternal>(m_device)->CreateDeviceContextForDrawingSession();
+                deviceContext->SetDpi(dpi, dpi);
+            }
+
+            RecordCachedImage(deviceContext.Get(), range);
+            m_cachedRange = range;
+        }
+
+        EvictTiles();
+
+        return m_cachedImage;
+    }
+
+    Vector2 CanvasImageTileCache::GetTileOrigin(TileIndex const& index) const
+    {
+        return Vector2
+        {
+            PixelsToDips(index.first * m_tileSizeInPixels, m_dpi),
+            PixelsToDips(index.second * m_tileSizeInPixels, m_dpi)
+        };
+    }
+
+    ComPtr<ID2D1Bitmap1> CanvasImageTileCache::RenderTile(ID2D1DeviceContext1* deviceContext, ID2D1Image* d2dImage, TileIndex const& index)
+    {
+        auto tileSizeInDips = PixelsToDips(m_tileSizeInPixels, m_dpi);
+
+        auto bitmap = As<ICanvasDeviceInternal>(m_device)->CreateRenderTargetBitmap(
+            tileSizeInDips,
+            tileSizeInDips,
+            m_dpi,
+            PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            CanvasAlphaMode::Premultiplied);
+
+        auto origin = GetTileOrigin(index);
+        auto offset = D2D1_POINT_2F{ -origin.X, -origin.Y };
+
+        deviceContext->SetTarget(bitmap.Get());
+        deviceContext->BeginDraw();
+        deviceContext->Clear(D2D1::ColorF(0, 0));
+        deviceContext->DrawImage(d2dImage, &offset);
+
+        HRESULT endDrawHr = deviceContext->EndDraw();
+        deviceContext->SetTarget(nullptr);
+
+        ThrowIfFailed(endDrawHr);
+
+        return bitmap;
+    }
+
+    void CanvasImageTileCache::RecordCachedImage(ID2D1DeviceContext1* deviceContext, TileRange const& range)
+    {
+        auto commandList = As<ICanvasDeviceInternal>(m_device)->CreateCommandList();
+
+        deviceContext->SetTarget(commandList.Get());
+        deviceContext->BeginDraw();
+
+        for (int y = range.Top; y < range.Bottom; y++)
+        {
+            for (int x = range.Left; x < range.Right; x++)
+            {
+                TileIndex index(x, y);
+
+                auto origin = GetTileOrigin(index);
+                auto offset = D2D1_POINT_2F{ origin.X, origin.Y };
+
+                // Tiles line up with the pixels of the image, so no filtering is needed.
+                deviceContext->DrawImage(m_tiles[index].Bitmap.Get(), &offset, nullptr, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+            }
+        }
+
+        HRESULT endDrawHr = deviceContext->EndDraw();
+        deviceContext->SetTarget(nullptr);
+
+        ThrowIfFailed(endDrawHr);
+
+        // Left open: CanvasCommandList closes it the first time it is drawn.
+        auto cachedImage = Make<CanvasCommandList>(m_device.Get(), commandList.Get(), false);
+        CheckMakeResult(cachedImage);
+
+        m_cachedImage = As<ICanvasImage>(cachedImage);
+    }
+
+    void CanvasImageTileCache::EvictTiles()
+    {
+        if (m_tiles.size() <= static_cast<size_t>(m_maximumTileCount))
+            return;
+
+        // Oldest first, leaving out the tiles drawn by the most recent Update.
+        std::vector<std::pair<uint64_t, TileIndex>> candidates;
+
+        for (auto& tile : m_tiles)
+        {
+            if (tile.second.LastUsed != m_updateCount)
+                candidates.emplace_back(tile.second.LastUsed, tile.first);
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+
+        for (auto& candidate : candidates)
+        {
+            if (m_tiles.size() <= static_cast<size_t>(m_maximumTileCount))
+                break;
+
+            m_tiles.erase(candidate.second);
+        }
+    }
+}}}}
+
+ActivatableClassWithFactory(CanvasImageTileCache, CanvasImageTileCacheFactory);
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    class CanvasImageTileCacheFactory
+        : public AgileActivationFactory<ICanvasImageTileCacheFactory>
+        , private LifespanTracker<CanvasImageTileCacheFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasImageTileCache, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasImageTileCache** tileCache) override;
+
+        IFACEMETHOD(CreateWithTileSize)(
+            ICanvasResourceCreator* resourceCreator,
+            int32_t tileSizeInPixels,
+            ICanvasImageTileCache** tileCache) override;
+    };
+
+
+    // The tiles from Left to Right and Top to Bottom, exclusive of Right and Bottom.
+    struct TileRange
+    {
+        int Left;
+        int Top;
+        int Right;
+        int Bottom;
+
+        bool IsEmpty() const { return Left >= Right || Top >= Bottom; }
+    };
+
+    // Works out which tiles overlap a rectangle given in DIPs.
+    TileRange GetTilesOverlappingRect(Rect const& rect, int tileSizeInPixels, float dpi);
+
+
+    //
+    // Scrolling a large effect graph makes D2D render all of it that is
+    // inside the clip every frame, even though most of it was already on
+    // screen last frame.  This keeps what was rendered in a grid of tile
+    // bitmaps, aligned to the pixel grid of the image rather than the
+    // target, so the same tiles stay valid however the image is panned.
+    //
+    // Each time the image is drawn, only the tiles that overlap the visible
+    // part of it and have not been rendered yet are rendered.  They are then
+    // drawn by a command list that is only recorded again if the set of
+    // visible tiles changed.
+    //
+    // Tiles that have not been visible for a while are thrown away once
+    // there are more than MaximumTileCount of them.  Tiles that are visible
+    // now are never thrown away, even if that means going over the limit.
+    //
+    // There is no way to tell when an effect property changes, so after
+    // changing the cached image the app must call Invalidate or
+    // InvalidateRegion.  Drawing a different image, or at a different DPI,
+    // discards every tile automatically.
+    //
+    class CanvasImageTileCache
+        : public RuntimeClass<
+            ICanvasImageTileCache,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasImageTileCache>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasImageTileCache, BaseTrust);
+
+        struct CachedTile
+        {
+            ComPtr<ID2D1Bitmap1> Bitmap;
+            uint64_t LastUsed;
+        };
+
+        typedef std::pair<int, int> TileIndex;
+
+        ComPtr<ICanvasDevice> m_device;
+        int m_tileSizeInPixels;
+        int m_maximumTileCount;
+
+        ComPtr<ICanvasImage> m_image;
+        float m_dpi;
+
+        std::map<TileIndex, CachedTile> m_tiles;
+        uint64_t m_updateCount;
+
+        TileRange m_cachedRange;
+        ComPtr<ICanvasImage> m_cachedImage;
+
+    public:
+        static const int DefaultTileSizeInPixels = 256;
+        static const int DefaultMaximumTileCount = 256;
+
+        CanvasImageTileCache(ICanvasDevice* device, int tileSizeInPixels);
+
+        IFACEMETHOD(get_TileSizeInPixels)(int32_t* value) override;
+
+        IFACEMETHOD(get_MaximumTileCount)(int32_t* value) override;
+        IFACEMETHOD(put_MaximumTileCount)(int32_t value) override;
+
+        IFACEMETHOD(Invalidate)() override;
+        IFACEMETHOD(InvalidateRegion)(Rect region) override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        // Renders whatever tiles of image overlapping visibleRect are
+        // missing, and returns an image that draws all of them, or null if
+        // visibleRect is empty.  visibleRect is in the DIPs of the image.
+        ComPtr<ICanvasImage> Update(ICanvasImage* image, Rect const& visibleRect, float dpi);
+
+        int GetTileCount() const { return static_cast<int>(m_tiles.size()); }
+
+    private:
+        void Clear();
+
+        ComPtr<ID2D1Bitmap1> RenderTile(ID2D1DeviceContext1* deviceContext, ID2D1Image* d2dImage, TileIndex const& index);
+        void RecordCachedImage(ID2D1DeviceContext1* deviceContext, TileRange const& range);
+        void EvictTiles();
+
+        Vector2 GetTileOrigin(TileIndex const& index) const;
+    };
+}}}}
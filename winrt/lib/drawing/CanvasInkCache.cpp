@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CanvasInkCache.h"
+#include "images/CanvasCommandList.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasInkCacheFactory
+    //
+
+    IFACEMETHODIMP CanvasInkCacheFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasInkCache** inkCache)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(inkCache);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newInkCache = Make<CanvasInkCache>(device.Get());
+                CheckMakeResult(newInkCache);
+
+                ThrowIfFailed(newInkCache.CopyTo(inkCache));
+            });
+    }
+
+
+    //
+    // CanvasInkCache
+    //
+
+    CanvasInkCache::CanvasInkCache(ICanvasDevice* device)
+        : m_device(device)
+        , m_singleStroke(MakePooled<Vector<InkStroke*>>())
+        , m_highContrast(false)
+    {
+        CheckMakeResult(m_singleStroke);
+    }
+
+    IFACEMETHODIMP CanvasInkCache::Invalidate()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                m_strokes.clear();
+                m_cachedInk.Reset();
+            });
+    }
+
+    IFACEMETHODIMP CanvasInkCache::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    static bool IsSameRect(Rect const& a, Rect const& b)
+    {
+        return a.X == b.X &&
+               a.Y == b.Y &&
+               a.Width == b.Width &&
+               a.Height == b.Height;
+    }
+
+    ComPtr<ICanvasImage> CanvasInkCache::Update(IIterable<InkStroke*>* inkStrokes, bool highContrast)
+    {
+        if (highContrast != m_highContrast)
+        {
+            m_strokes.clear();
+            m_cachedInk.Reset();
+            m_highContrast = highContrast;
+        }
+
+        // Strokes are matched up by identity, wherever they were in the
+        // collection last time.
+        std::unordered_map<IInkStroke*, size_t> previousIndices;
+
+        for (size_t i = 0; i < m_strokes.size(); i++)
+        {
+            previousIndices.emplace(m_strokes[i].Stroke.Get(), i);
+        }
+
+        std::vector<CachedStroke> strokes;
+        strokes.reserve(m_strokes.size());
+
+        ComPtr<ID2D1DeviceContext1> deviceContext;
+        bool isChanged = !m_cachedInk;
+
+        ComPtr<IIterator<InkStroke*>> iterator;
+        ThrowIfFailed(inkStrokes->First(&iterator));
+
+        boolean hasCurrent;
+        ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+        while (hasCurrent)
+        {
+            ComPtr<IInkStroke> stroke;
+            ThrowIfFailed(iterator->get_Current(&stroke));
+
+            CheckInPointer(stroke.Get());
+
+            CachedStroke cachedStroke{ stroke };
+
+            ThrowIfFailed(stroke->get_BoundingRect(&cachedStroke.BoundingRect));
+
+            boolean isSelected;
+            ThrowIfFailed(stroke->get_Selected(&isSelected));
+            cachedStroke.IsSelected = !!isSelected;
+
+            auto previous = previousIndices.find(stroke.Get());
+
+            if (previous != previousIndices.end())
+            {
+                auto& previousStroke = m_strokes[previous->second];
+
+                if (IsSameRect(previousStroke.BoundingRect, cachedStroke.BoundingRect) &&
+                    previousStroke.IsSelected == cachedStroke.IsSelected)
+                {
+                    cachedStroke.CommandList = previousStroke.CommandList;
+                }
+
+                if (previous->second != strokes.size())
+                    isChanged = true;
+            }
+
+            if (!cachedStroke.CommandList)
+            {
+                if (!deviceContext)
+                    deviceContext = As<ICanvasDeviceInternal>(m_device)->CreateDeviceContextForDrawingSession();
+
+                cachedStroke.CommandList = RenderStroke(deviceContext.Get(), stroke.Get(), highContrast);
+                isChanged = true;
+            }
+
+            strokes.push_back(std::move(cachedStroke));
+
+            ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+        }
+
+        if (strokes.size() != m_strokes.size())
+            isChanged = true;
+
+        m_strokes.swap(strokes);
+
+        if (isChanged)
+        {
+            // Reset first, so if recording fails we try again next time.
+            m_cachedInk.Reset();
+
+            if (!m_strokes.empty())
+            {
+                if (!deviceContext)
+                    deviceContext = As<ICanvasDeviceInternal>(m_device)->CreateDeviceContextForDrawingSession();
+
+                RecordCachedInk(deviceContext.Get());
+            }
+        }
+
+        return m_cachedInk;
+    }
+
+    ComPtr<ID2D1CommandList> CanvasInkCache::RenderStroke(ID2D1DeviceContext1* deviceContext, IInkStroke* stroke, bool highContrast)
+    {
+        if (!m_inkRenderer)
+        {
+            m_inkRenderer = InkAdapter::GetInstance()->CreateInkRenderer();
+        }
+
+        auto commandList = As<ICanvasDeviceInternal>(m_device)->CreateCommandList();
+
+        ThrowIfFailed(m_singleStroke->Append(stroke));
+        auto clearSingleStroke = MakeScopeWarden([&] { m_singleStroke->Clear(); });
+
+        deviceContext->SetTarget(commandList.Get());
+        deviceContext->BeginDraw();
+
+        HRESULT drawHr = m_inkRenderer->Draw(
+            deviceContext,
+            As<IUnknown>(m_singleStroke).Get(),
+            highContrast);
+
+        HRESULT endDrawHr = deviceContext->EndDraw();
+        deviceContext->SetTarget(nullptr);
+
+        ThrowIfFailed(drawHr);
+        ThrowIfFailed(endDrawHr);
+
+        ThrowIfFailed(commandList->Close());
+
+        return commandList;
+    }
+
+    void CanvasInkCache::RecordCachedInk(ID2D1DeviceContext1* deviceContext)
+    {
+        auto commandList = As<ICanvasDeviceInternal>(m_device)->CreateCommandList();
+
+        deviceContext->SetTarget(commandList.Get());
+        deviceContext->BeginDraw();
+
+        for (auto& stroke : m_strokes)
+        {
+            deviceContext->DrawImage(stroke.CommandList.Get());
+        }
+
+        HRESULT endDrawHr = deviceContext->EndDraw();
+        deviceContext->SetTarget(nullptr);
+
+        ThrowIfFailed(endDrawHr);
+
+        // Left open: CanvasCommandList closes it the first time it is drawn.
+        auto cachedInk = Make<CanvasCommandList>(m_device.Get(), commandList.Get(), false);
+        CheckMakeResult(cachedInk);
+
+        m_cachedInk = As<ICanvasImage>(cachedInk);
+    }
+}}}}
+
+ActivatableClassWithFactory(CanvasInkCache, CanvasInkCacheFactory);
+
+#endif
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::collections;
+    using namespace ABI::Windows::UI::Input::Inking;
+
+    class CanvasInkCacheFactory
+        : public AgileActivationFactory<ICanvasInkCacheFactory>
+        , private LifespanTracker<CanvasInkCacheFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasInkCache, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasInkCache** inkCache) override;
+    };
+
+
+    //
+    // Rendering ink is expensive, since the ink renderer works out the
+    // outline of every stroke from its points each time it is drawn.  This
+    // keeps each stroke rendered into a command list of its own, along with
+    // a command list that replays all of them, which is what actually gets
+    // drawn.
+    //
+    // Each time the strokes are drawn they are compared against what was
+    // cached last time.  A stroke that is new, or whose bounds or selection
+    // state have changed, is rendered again.  The combined command list is
+    // only recorded again if any stroke was rendered, removed or reordered,
+    // so redrawing an unchanged set of strokes costs a single DrawImage.
+    //
+    class CanvasInkCache
+        : public RuntimeClass<
+            ICanvasInkCache,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasInkCache>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasInkCache, BaseTrust);
+
+        struct CachedStroke
+        {
+            ComPtr<IInkStroke> Stroke;
+            Rect BoundingRect;
+            bool IsSelected;
+            ComPtr<ID2D1CommandList> CommandList;
+        };
+
+        ComPtr<ICanvasDevice> m_device;
+        ComPtr<IInkD2DRenderer> m_inkRenderer;
+
+        // Reused to pass the ink renderer one stroke at a time.
+        ComPtr<Vector<InkStroke*>> m_singleStroke;
+
+        // In the order they were last drawn.
+        std::vector<CachedStroke> m_strokes;
+        bool m_highContrast;
+
+        ComPtr<ICanvasImage> m_cachedInk;
+
+    public:
+        CanvasInkCache(ICanvasDevice* device);
+
+        IFACEMETHOD(Invalidate)() override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        // Brings the cache up to date with inkStrokes, and returns an image
+        // that draws all of them, or null if there are none.
+        ComPtr<ICanvasImage> Update(IIterable<InkStroke*>* inkStrokes, bool highContrast);
+
+    private:
+        ComPtr<ID2D1CommandList> RenderStroke(ID2D1DeviceContext1* deviceContext, IInkStroke* stroke, bool highContrast);
+        void RecordCachedInk(ID2D1DeviceContext1* deviceContext);
+    };
+}}}}
+
+#endif
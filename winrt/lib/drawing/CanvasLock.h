@@ -4,8 +4,75 @@
 
 #pragma once
 
+#include "utils/LockUtilities.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
+    //
+    // Counts how long CanvasLocks wait to enter the D2D lock and how long
+    // they then hold it, so apps can see which of their threads are
+    // contending.  Times are in TimeSpan units (100ns).
+    //
+    class CanvasLockStatisticsTracker
+    {
+        std::mutex m_mutex;
+        CanvasLockStatistics m_statistics;
+
+    public:
+        CanvasLockStatisticsTracker()
+            : m_statistics{}
+        {
+        }
+
+        static int64_t GetTimestamp()
+        {
+            static int64_t const frequency = []
+            {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return value.QuadPart;
+            }();
+
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+
+            // Split up the conversion so the multiply doesn't overflow.
+            auto seconds = counter.QuadPart / frequency;
+            auto remainder = counter.QuadPart % frequency;
+
+            return seconds * 10000000 + remainder * 10000000 / frequency;
+        }
+
+        void RecordWait(int64_t duration)
+        {
+            Lock lock(m_mutex);
+
+            m_statistics.LockCount++;
+            m_statistics.TotalWaitTime.Duration += duration;
+            m_statistics.MaximumWaitTime.Duration = std::max(m_statistics.MaximumWaitTime.Duration, duration);
+        }
+
+        void RecordHold(int64_t duration)
+        {
+            Lock lock(m_mutex);
+
+            m_statistics.TotalHoldTime.Duration += duration;
+            m_statistics.MaximumHoldTime.Duration = std::max(m_statistics.MaximumHoldTime.Duration, duration);
+        }
+
+        CanvasLockStatistics GetStatistics()
+        {
+            Lock lock(m_mutex);
+            return m_statistics;
+        }
+
+        void Reset()
+        {
+            Lock lock(m_mutex);
+            m_statistics = CanvasLockStatistics{};
+        }
+    };
+
 
     class CanvasLock : public RuntimeClass<ICanvasLock, IClosable>
                      , private LifespanTracker<CanvasLock>
@@ -13,12 +80,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasLock, BaseTrust);
 
         ComPtr<ID2D1Multithread> m_multithread;
+        std::shared_ptr<CanvasLockStatisticsTracker> m_statisticsTracker;
+        int64_t m_enterTime;
 
     public:
-        CanvasLock(ID2D1Multithread* multithread)
+        CanvasLock(
+            ID2D1Multithread* multithread,
+            std::shared_ptr<CanvasLockStatisticsTracker> statisticsTracker = nullptr)
             : m_multithread(multithread)
+            , m_statisticsTracker(std::move(statisticsTracker))
+            , m_enterTime(0)
         {
+            if (!m_statisticsTracker)
+            {
+                m_multithread->Enter();
+                return;
+            }
+
+            auto waitStart = CanvasLockStatisticsTracker::GetTimestamp();
             m_multithread->Enter();
+            m_enterTime = CanvasLockStatisticsTracker::GetTimestamp();
+
+            m_statisticsTracker->RecordWait(m_enterTime - waitStart);
         }
 
         virtual ~CanvasLock()
@@ -30,6 +113,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         {
             if (m_multithread)
             {
+                if (m_statisticsTracker)
+                {
+                    m_statisticsTracker->RecordHold(CanvasLockStatisticsTracker::GetTimestamp() - m_enterTime);
+                    m_statisticsTracker.reset();
+                }
+
                 m_multithread->Leave();
                 m_multithread.Reset();
             }
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasProfileScope.h"
+#include "utils/D2DResourceLock.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    static ComPtr<ID3D11Query> CreateQuery(ID3D11Device* d3dDevice, D3D11_QUERY queryType)
+    {
+        D3D11_QUERY_DESC desc{ queryType, 0 };
+
+        ComPtr<ID3D11Query> query;
+        ThrowIfFailed(d3dDevice->CreateQuery(&desc, &query));
+
+        return query;
+    }
+
+
+    ComPtr<CanvasProfileScope> CanvasProfileScope::CreateNew(
+        HSTRING name,
+        ICanvasDevice* device,
+        ID2D1DeviceContext1* deviceContext,
+        std::function<void()>&& flushAction)
+    {
+        ComPtr<ID2D1Device> d2dDevice;
+        deviceContext->GetDevice(&d2dDevice);
+
+        auto d3dDevice = GetDXGIInterface<ID3D11Device>(device);
+
+        auto scope = Make<CanvasProfileScope>(name, d2dDevice.Get(), d3dDevice.Get(), std::move(flushAction));
+        CheckMakeResult(scope);
+
+        return scope;
+    }
+
+
+    CanvasProfileScope::CanvasProfileScope(
+        HSTRING name,
+        ID2D1Device* d2dDevice,
+        ID3D11Device* d3dDevice,
+        std::function<void()>&& flushAction)
+        : m_name(name)
+        , m_flushAction(std::move(flushAction))
+        , m_d2dDevice(d2dDevice)
+        , m_disjointQuery(CreateQuery(d3dDevice, D3D11_QUERY_TIMESTAMP_DISJOINT))
+        , m_startQuery(CreateQuery(d3dDevice, D3D11_QUERY_TIMESTAMP))
+        , m_endQuery(CreateQuery(d3dDevice, D3D11_QUERY_TIMESTAMP))
+        , m_status(CanvasProfileScopeStatus::Running)
+        , m_gpuDuration{}
+    {
+        d3dDevice->GetImmediateContext(&m_immediateContext);
+
+        // The immediate context is shared with D2D, so is protected by its lock.
+        D2DResourceLock lock(m_d2dDevice.Get());
+
+        m_immediateContext->Begin(m_disjointQuery.Get());
+        m_immediateContext->End(m_startQuery.Get());
+    }
+
+
+    IFACEMETHODIMP CanvasProfileScope::get_Name(HSTRING* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                m_name.CopyTo(value);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasProfileScope::get_Status(CanvasProfileScopeStatus* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                Lock lock(m_mutex);
+
+                PollForResult();
+
+                *value = m_status;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasProfileScope::get_GpuDuration(TimeSpan* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                Lock lock(m_mutex);
+
+                PollForResult();
+
+                if (m_status != CanvasProfileScopeStatus::Complete)
+                    ThrowHR(E_ILLEGAL_METHOD_CALL, Strings::ProfileScopeResultNotAvailable);
+
+                *value = m_gpuDuration;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasProfileScope::Close()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                Lock lock(m_mutex);
+
+                if (m_status != CanvasProfileScopeStatus::Running)
+                    return;
+
+                // Submit everything drawn inside the scope before the end timestamp.
+                auto flushAction = std::move(m_flushAction);
+                m_flushAction = nullptr;
+
+                auto endScope = MakeScopeWarden(
+                    [&]
+                    {
+                        D2DResourceLock d2dLock(m_d2dDevice.Get());
+
+                        m_immediateContext->End(m_endQuery.Get());
+                        m_immediateContext->End(m_disjointQuery.Get());
+
+                        m_status = CanvasProfileScopeStatus::Pending;
+                    });
+
+                if (flushAction)
+                    flushAction();
+            });
+    }
+
+
+    void CanvasProfileScope::PollForResult()
+    {
+        if (m_status != CanvasProfileScopeStatus::Pending)
+            return;
+
+        D2DResourceLock lock(m_d2dDevice.Get());
+
+        // DONOTFLUSH, so polling never submits work on the app's behalf.
+        // The queries complete once the app next flushes or presents.
+        auto const flags = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        uint64_t start;
+        uint64_t end;
+
+        HRESULT hr = m_immediateContext->GetData(m_disjointQuery.Get(), &disjoint, sizeof(disjoint), flags);
+
+        if (hr == S_OK)
+            hr = m_immediateContext->GetData(m_startQuery.Get(), &start, sizeof(start), flags);
+
+        if (hr == S_OK)
+            hr = m_immediateContext->GetData(m_endQuery.Get(), &end, sizeof(end), flags);
+
+        if (hr == S_FALSE)
+            return;
+
+        // A failure here means the device was lost, so there will never be a result.
+        if (FAILED(hr) || disjoint.Disjoint || disjoint.Frequency == 0 || end < start)
+        {
+            m_status = CanvasProfileScopeStatus::Unavailable;
+        }
+        else
+        {
+            uint64_t const ticksPerSecond = 10000000;
+            auto delta = end - start;
+
+            m_gpuDuration.Duration = static_cast<INT64>(
+                (delta / disjoint.Frequency) * ticksPerSecond +
+                (delta % disjoint.Frequency) * ticksPerSecond / disjoint.Frequency);
+
+            m_status = CanvasProfileScopeStatus::Complete;
+        }
+
+        ReleaseQueries();
+    }
+
+
+    void CanvasProfileScope::ReleaseQueries()
+    {
+        m_disjointQuery.Reset();
+        m_startQuery.Reset();
+        m_endQuery.Reset();
+        m_immediateContext.Reset();
+    }
+}}}}
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ABI::Windows::Foundation;
+
+    //
+    // Times a section of a drawing session on the GPU, using a pair of D3D
+    // timestamp queries inside a disjoint query.  D2D batches up drawing
+    // commands, so the session is flushed at each end of the scope to make
+    // sure the timestamps bracket exactly the commands issued inside it.
+    //
+    // The queries are only ever polled (never waited on) so reading the
+    // result doesn't stall the CPU.
+    //
+    class CanvasProfileScope : public RuntimeClass<ICanvasProfileScope, IClosable>,
+                               private LifespanTracker<CanvasProfileScope>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasProfileScope, BaseTrust);
+
+        std::mutex m_mutex;
+
+        WinString m_name;
+        std::function<void()> m_flushAction;
+
+        ComPtr<ID2D1Device> m_d2dDevice;
+        ComPtr<ID3D11DeviceContext> m_immediateContext;
+        ComPtr<ID3D11Query> m_disjointQuery;
+        ComPtr<ID3D11Query> m_startQuery;
+        ComPtr<ID3D11Query> m_endQuery;
+
+        CanvasProfileScopeStatus m_status;
+        TimeSpan m_gpuDuration;
+
+    public:
+        static ComPtr<CanvasProfileScope> CreateNew(
+            HSTRING name,
+            ICanvasDevice* device,
+            ID2D1DeviceContext1* deviceContext,
+            std::function<void()>&& flushAction);
+
+        CanvasProfileScope(
+            HSTRING name,
+            ID2D1Device* d2dDevice,
+            ID3D11Device* d3dDevice,
+            std::function<void()>&& flushAction);
+
+        IFACEMETHOD(get_Name)(HSTRING* value) override;
+        IFACEMETHOD(get_Status)(CanvasProfileScopeStatus* value) override;
+        IFACEMETHOD(get_GpuDuration)(TimeSpan* value) override;
+
+        IFACEMETHOD(Close)() override;
+
+    private:
+        void PollForResult();
+        void ReleaseQueries();
+    };
+}}}}
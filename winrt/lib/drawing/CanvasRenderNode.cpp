@@ -0,0 +1,307 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasRenderNode.h"
+#include "images/CanvasCommandList.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasRenderNodeFactory
+    //
+
+    IFACEMETHODIMP CanvasRenderNodeFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasRenderNode** renderNode)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(renderNode);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newRenderNode = Make<CanvasRenderNode>(device.Get());
+                CheckMakeResult(newRenderNode);
+
+                ThrowIfFailed(newRenderNode.CopyTo(renderNode));
+            });
+    }
+
+
+    //
+    // CanvasRenderNode
+    //
+
+    CanvasRenderNode::CanvasRenderNode(ICanvasDevice* device)
+        : m_device(device)
+        , m_transform(Identity3x2())
+        , m_hasClipRectangle(false)
+        , m_clipRectangle{}
+        , m_opacity(1.0f)
+        , m_isVisible(true)
+        , m_children(MakePooled<ChildrenVector>())
+        , m_propertiesVersion(NextVersion())
+        , m_contentVersion(NextVersion())
+        , m_recordedVersion(0)
+        , m_isUpdating(false)
+    {
+        CheckMakeResult(m_children);
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_Transform(Numerics::Matrix3x2* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_transform;
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::put_Transform(Numerics::Matrix3x2 value)
+    {
+        m_transform = value;
+        m_propertiesVersion = NextVersion();
+        return S_OK;
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_ClipRectangle(IReference<Rect>** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                if (m_hasClipRectangle)
+                {
+                    auto clipRectangle = Make<Nullable<Rect>>(m_clipRectangle);
+                    CheckMakeResult(clipRectangle);
+
+                    ThrowIfFailed(clipRectangle.CopyTo(value));
+                }
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::put_ClipRectangle(IReference<Rect>* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value)
+                {
+                    ThrowIfFailed(value->get_Value(&m_clipRectangle));
+                    m_hasClipRectangle = true;
+                }
+                else
+                {
+                    m_hasClipRectangle = false;
+                }
+
+                m_propertiesVersion = NextVersion();
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_Opacity(float* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_opacity;
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::put_Opacity(float value)
+    {
+        m_opacity = value;
+        m_propertiesVersion = NextVersion();
+        return S_OK;
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_IsVisible(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_isVisible;
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::put_IsVisible(boolean value)
+    {
+        m_isVisible = !!value;
+        m_propertiesVersion = NextVersion();
+        return S_OK;
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_Content(ICanvasCommandList** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_content.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::put_Content(ICanvasCommandList* value)
+    {
+        m_content = value;
+        m_contentVersion = NextVersion();
+        return S_OK;
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_Children(IVector<CanvasRenderNode*>** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_children.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderNode::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    void CanvasRenderNode::Draw(ICanvasDrawingSession* drawingSession)
+    {
+        UpdateSubtree();
+        DrawRecordedSubtree(drawingSession);
+    }
+
+    uint64_t CanvasRenderNode::NextVersion()
+    {
+        static std::atomic<uint64_t> version(0);
+        return ++version;
+    }
+
+    // Records again anything below us that has changed, and returns the most
+    // recent change that affects how we look when drawn.
+    uint64_t CanvasRenderNode::UpdateSubtree()
+    {
+        if (m_isUpdating)
+            ThrowHR(E_INVALIDARG, Strings::RenderNodeCycle);
+
+        m_isUpdating = true;
+        auto updateEnd = MakeScopeWarden([&] { m_isUpdating = false; });
+
+        if (m_children->IsChanged())
+        {
+            m_contentVersion = NextVersion();
+            m_children->SetChanged(false);
+        }
+
+        auto subtreeVersion = m_contentVersion;
+
+        for (auto& child : m_children->InternalVector())
+        {
+            auto childNode = static_cast<CanvasRenderNode*>(child.Get());
+
+            // Changes to hidden children can wait until they are shown,
+            // which itself counts as a change.
+            if (childNode && childNode->m_isVisible)
+            {
+                subtreeVersion = std::max(subtreeVersion, childNode->UpdateSubtree());
+            }
+        }
+
+        if (subtreeVersion != m_recordedVersion)
+        {
+            RecordSubtree();
+            m_recordedVersion = subtreeVersion;
+        }
+
+        return std::max(subtreeVersion, m_propertiesVersion);
+    }
+
+    void CanvasRenderNode::RecordSubtree()
+    {
+        auto& children = m_children->InternalVector();
+
+        // Without children there is only the content to draw, which needn't
+        // be copied into a command list of our own.
+        if (children.empty())
+        {
+            m_recordedSubtree = m_content ? As<ICanvasImage>(m_content) : nullptr;
+            return;
+        }
+
+        auto commandList = CanvasCommandList::CreateNew(m_device.Get());
+
+        ComPtr<ICanvasDrawingSession> drawingSession;
+        ThrowIfFailed(commandList->CreateDrawingSession(&drawingSession));
+
+        if (m_content)
+        {
+            ThrowIfFailed(drawingSession->DrawImageAtOrigin(As<ICanvasImage>(m_content).Get()));
+        }
+
+        for (auto& child : children)
+        {
+            if (child)
+            {
+                static_cast<CanvasRenderNode*>(child.Get())->DrawRecordedSubtree(drawingSession.Get());
+            }
+        }
+
+        ThrowIfFailed(As<IClosable>(drawingSession)->Close());
+
+        m_recordedSubtree = As<ICanvasImage>(commandList);
+    }
+
+    static bool IsIdentity(Numerics::Matrix3x2 const& matrix)
+    {
+        return matrix.M11 == 1 && matrix.M12 == 0 &&
+               matrix.M21 == 0 && matrix.M22 == 1 &&
+               matrix.M31 == 0 && matrix.M32 == 0;
+    }
+
+    void CanvasRenderNode::DrawRecordedSubtree(ICanvasDrawingSession* drawingSession)
+    {
+        if (!m_isVisible || m_opacity <= 0 || !m_recordedSubtree)
+            return;
+
+        // Unwinding in reverse order pops everything even if drawing fails.
+        bool hasTransform = !IsIdentity(m_transform);
+
+        if (hasTransform)
+            ThrowIfFailed(drawingSession->PushTransform(m_transform));
+
+        auto popTransform = MakeScopeWarden([&] { if (hasTransform) drawingSession->PopTransform(); });
+
+        if (m_hasClipRectangle)
+            ThrowIfFailed(drawingSession->PushClip(m_clipRectangle));
+
+        auto popClip = MakeScopeWarden([&] { if (m_hasClipRectangle) drawingSession->PopClip(); });
+
+        ComPtr<IClosable> opacityLayer;
+
+        if (m_opacity < 1)
+        {
+            ComPtr<ICanvasActiveLayer> layer;
+            ThrowIfFailed(drawingSession->CreateLayerWithOpacity(m_opacity, &layer));
+            opacityLayer = As<IClosable>(layer);
+        }
+
+        auto closeLayer = MakeScopeWarden([&] { if (opacityLayer) opacityLayer->Close(); });
+
+        ThrowIfFailed(drawingSession->DrawImageAtOrigin(m_recordedSubtree.Get()));
+    }
+}}}}
+
+ActivatableClassWithFactory(CanvasRenderNode, CanvasRenderNodeFactory);
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::collections;
+
+    class CanvasRenderNodeFactory
+        : public AgileActivationFactory<ICanvasRenderNodeFactory>
+        , private LifespanTracker<CanvasRenderNodeFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasRenderNode, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasRenderNode** renderNode) override;
+    };
+
+
+    //
+    // Each node caches the drawing of its content and children (but not its
+    // own transform, clip and opacity, which are applied by whoever draws
+    // it) in a command list.
+    //
+    // Rather than nodes pointing back at their parents, every change is
+    // stamped with a number from a global counter.  Drawing walks the tree
+    // working out the most recent change in each subtree, and records again
+    // only those subtrees that changed since they were last recorded.  This
+    // means one node can be the child of several others.
+    //
+    // Like drawing sessions, nodes must not be changed while they are being
+    // drawn on another thread.
+    //
+    class CanvasRenderNode
+        : public RuntimeClass<
+            ICanvasRenderNode,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasRenderNode>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasRenderNode, BaseTrust);
+
+        typedef Vector<CanvasRenderNode*> ChildrenVector;
+
+        ComPtr<ICanvasDevice> m_device;
+
+        Numerics::Matrix3x2 m_transform;
+        bool m_hasClipRectangle;
+        Rect m_clipRectangle;
+        float m_opacity;
+        bool m_isVisible;
+
+        ComPtr<ICanvasCommandList> m_content;
+        ComPtr<ChildrenVector> m_children;
+
+        // When our own Transform, ClipRectangle, Opacity or IsVisible last changed.
+        // Our parents need to record again then, but we needn't.
+        uint64_t m_propertiesVersion;
+
+        // When our Content or the list of Children last changed.
+        uint64_t m_contentVersion;
+
+        // The most recent change within our subtree that m_recordedSubtree includes.
+        uint64_t m_recordedVersion;
+        ComPtr<ICanvasImage> m_recordedSubtree;
+
+        bool m_isUpdating;
+
+    public:
+        CanvasRenderNode(ICanvasDevice* device);
+
+        IFACEMETHOD(get_Transform)(Numerics::Matrix3x2* value) override;
+        IFACEMETHOD(put_Transform)(Numerics::Matrix3x2 value) override;
+
+        IFACEMETHOD(get_ClipRectangle)(IReference<Rect>** value) override;
+        IFACEMETHOD(put_ClipRectangle)(IReference<Rect>* value) override;
+
+        IFACEMETHOD(get_Opacity)(float* value) override;
+        IFACEMETHOD(put_Opacity)(float value) override;
+
+        IFACEMETHOD(get_IsVisible)(boolean* value) override;
+        IFACEMETHOD(put_IsVisible)(boolean value) override;
+
+        IFACEMETHOD(get_Content)(ICanvasCommandList** value) override;
+        IFACEMETHOD(put_Content)(ICanvasCommandList* value) override;
+
+        IFACEMETHOD(get_Children)(IVector<CanvasRenderNode*>** value) override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        // Draws this node and everything below it, recording again any
+        // subtrees that have changed.
+        void Draw(ICanvasDrawingSession* drawingSession);
+
+    private:
+        static uint64_t NextVersion();
+
+        uint64_t UpdateSubtree();
+        void RecordSubtree();
+        void DrawRecordedSubtree(ICanvasDrawingSession* drawingSession);
+    };
+}}}}
@@ -0,0 +1,468 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasResourceManifest.h"
+#include "geometry/CanvasCachedGeometry.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+
+static std::wstring GetKey(HSTRING key)
+{
+    if (WindowsIsStringEmpty(key))
+        ThrowHR(E_INVALIDARG);
+
+    return std::wstring(WindowsGetStringRawBuffer(key, nullptr));
+}
+
+
+// Copies a geometry's figures into a new path geometry, on whichever factory device refers to.
+static ComPtr<ID2D1PathGeometry1> CopyGeometry(GeometryDevicePtr const& device, ID2D1Geometry* d2dGeometry)
+{
+    auto d2dPathGeometry = GeometryAdapter::GetInstance()->CreatePathGeometry(device);
+
+    ComPtr<ID2D1GeometrySink> sink;
+    ThrowIfFailed(d2dPathGeometry->Open(&sink));
+
+    if (auto sourcePathGeometry = MaybeAs<ID2D1PathGeometry>(d2dGeometry))
+    {
+        ThrowIfFailed(sourcePathGeometry->Stream(sink.Get()));
+    }
+    else
+    {
+        // Other geometry types can't stream themselves, but simplifying to
+        // cubics and lines keeps their curves.
+        ThrowIfFailed(d2dGeometry->Simplify(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_CUBICS_AND_LINES, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE, sink.Get()));
+    }
+
+    ThrowIfFailed(sink->Close());
+
+    return d2dPathGeometry;
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::AddBitmapFromFile(
+    HSTRING key,
+    HSTRING fileName,
+    float dpi,
+    CanvasAlphaMode alpha)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(fileName);
+
+            auto entry = std::make_shared<ManifestEntry>();
+
+            entry->Type = ManifestEntryType::BitmapFromFile;
+            entry->FileName = fileName;
+            entry->Dpi = dpi;
+            entry->Alpha = alpha;
+
+            AddEntry(key, entry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::AddBitmapFromBytes(
+    HSTRING key,
+    uint32_t byteCount,
+    BYTE* bytes,
+    int32_t widthInPixels,
+    int32_t heightInPixels,
+    DirectXPixelFormat format,
+    float dpi,
+    CanvasAlphaMode alpha)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(bytes);
+
+            auto entry = std::make_shared<ManifestEntry>();
+
+            entry->Type = ManifestEntryType::BitmapFromBytes;
+            entry->Bytes.assign(bytes, bytes + byteCount);
+            entry->WidthInPixels = widthInPixels;
+            entry->HeightInPixels = heightInPixels;
+            entry->Format = format;
+            entry->Dpi = dpi;
+            entry->Alpha = alpha;
+
+            AddEntry(key, entry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::AddGeometry(
+    HSTRING key,
+    ICanvasGeometry* geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometry);
+
+            auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometry);
+
+            auto entry = std::make_shared<ManifestEntry>();
+
+            entry->Type = ManifestEntryType::Geometry;
+            entry->RecordedGeometry = CopyGeometry(GeometryDevicePtr(static_cast<ICanvasDevice*>(nullptr)), d2dGeometry.Get());
+
+            AddEntry(key, entry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::AddCachedFill(
+    HSTRING key,
+    HSTRING geometryKey,
+    float flatteningTolerance)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto entry = std::make_shared<ManifestEntry>();
+
+            entry->Type = ManifestEntryType::CachedFill;
+            entry->GeometryKey = GetKey(geometryKey);
+            entry->FlatteningTolerance = flatteningTolerance;
+
+            ValidateGeometryKey(entry->GeometryKey);
+
+            AddEntry(key, entry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::AddCachedStroke(
+    HSTRING key,
+    HSTRING geometryKey,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    float flatteningTolerance)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto entry = std::make_shared<ManifestEntry>();
+
+            entry->Type = ManifestEntryType::CachedStroke;
+            entry->GeometryKey = GetKey(geometryKey);
+            entry->StrokeWidth = strokeWidth;
+            entry->StrokeStyle = strokeStyle;
+            entry->FlatteningTolerance = flatteningTolerance;
+
+            ValidateGeometryKey(entry->GeometryKey);
+
+            AddEntry(key, entry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::Remove(
+    HSTRING key,
+    boolean* wasRemoved)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(wasRemoved);
+
+            auto name = GetKey(key);
+
+            Lock lock(m_mutex);
+
+            auto it = FindEntry(name);
+
+            if (it == m_entries.end())
+            {
+                *wasRemoved = false;
+                return;
+            }
+
+            m_entries.erase(it);
+
+            if (m_resources)
+                m_resources->erase(name);
+
+            *wasRemoved = true;
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::get_Count(int32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            *value = static_cast<int32_t>(m_entries.size());
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::LoadAsync(
+    ICanvasResourceCreator* resourceCreator,
+    IAsyncAction** action)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckAndClearOutPointer(action);
+
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(resourceCreator->get_Device(&device));
+
+            EntryList entries;
+
+            {
+                Lock lock(m_mutex);
+                entries = m_entries;
+            }
+
+            ComPtr<CanvasResourceManifest> self = this;
+
+            auto asyncAction = Make<AsyncAction>(
+                [=]
+                {
+                    auto resources = CreateResources(device.Get(), entries);
+
+                    Lock lock(self->m_mutex);
+                    self->m_resources = resources;
+                });
+
+            CheckMakeResult(asyncAction);
+            ThrowIfFailed(asyncAction.CopyTo(action));
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::GetBitmap(
+    HSTRING key,
+    ICanvasBitmap** bitmap)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(bitmap);
+
+            auto resource = GetResource(key, ManifestEntryType::BitmapFromFile, ManifestEntryType::BitmapFromBytes);
+
+            ThrowIfFailed(resource.CopyTo(bitmap));
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::GetGeometry(
+    HSTRING key,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(geometry);
+
+            auto resource = GetResource(key, ManifestEntryType::Geometry, ManifestEntryType::Geometry);
+
+            ThrowIfFailed(resource.CopyTo(geometry));
+        });
+}
+
+
+IFACEMETHODIMP CanvasResourceManifest::GetCachedGeometry(
+    HSTRING key,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(cachedGeometry);
+
+            auto resource = GetResource(key, ManifestEntryType::CachedFill, ManifestEntryType::CachedStroke);
+
+            ThrowIfFailed(resource.CopyTo(cachedGeometry));
+        });
+}
+
+
+void CanvasResourceManifest::AddEntry(HSTRING key, std::shared_ptr<ManifestEntry const> const& entry)
+{
+    auto name = GetKey(key);
+
+    Lock lock(m_mutex);
+
+    // Adding a key that is already in the manifest replaces its entry, but
+    // keeps its place in the load order.
+    auto it = FindEntry(name);
+
+    if (it != m_entries.end())
+        it->second = entry;
+    else
+        m_entries.emplace_back(std::move(name), entry);
+}
+
+
+void CanvasResourceManifest::ValidateGeometryKey(std::wstring const& geometryKey)
+{
+    Lock lock(m_mutex);
+
+    auto it = FindEntry(geometryKey);
+
+    if (it == m_entries.end() || it->second->Type != ManifestEntryType::Geometry)
+        ThrowHR(E_INVALIDARG, Strings::ResourceManifestUnknownGeometryKey);
+}
+
+
+CanvasResourceManifest::EntryList::iterator CanvasResourceManifest::FindEntry(std::wstring const& key)
+{
+    return std::find_if(m_entries.begin(), m_entries.end(),
+        [&](EntryList::value_type const& entry)
+        {
+            return entry.first == key;
+        });
+}
+
+
+ComPtr<IInspectable> CanvasResourceManifest::GetResource(HSTRING key, ManifestEntryType firstType, ManifestEntryType lastType)
+{
+    auto name = GetKey(key);
+
+    Lock lock(m_mutex);
+
+    auto it = FindEntry(name);
+
+    if (it == m_entries.end())
+        ThrowHR(E_INVALIDARG, Strings::ResourceManifestKeyNotFound);
+
+    auto type = it->second->Type;
+
+    if (type < firstType || type > lastType)
+        ThrowHR(E_INVALIDARG, Strings::ResourceManifestWrongType);
+
+    // Entries added since the last LoadAsync have nothing to return yet.
+    if (!m_resources)
+        ThrowHR(E_ILLEGAL_METHOD_CALL, Strings::ResourceManifestNotLoaded);
+
+    auto resource = m_resources->find(name);
+
+    if (resource == m_resources->end())
+        ThrowHR(E_ILLEGAL_METHOD_CALL, Strings::ResourceManifestNotLoaded);
+
+    return resource->second;
+}
+
+
+std::shared_ptr<CanvasResourceManifest::ResourceMap> CanvasResourceManifest::CreateResources(ICanvasDevice* device, EntryList const& entries)
+{
+    auto resources = std::make_shared<ResourceMap>();
+
+    // Bitmap files are the slow part, so they are decoded in parallel, in
+    // one batch for each combination of DPI and alpha mode.
+    std::map<std::pair<float, CanvasAlphaMode>, std::vector<EntryList::value_type const*>> fileBatches;
+
+    for (auto& entry : entries)
+    {
+        if (entry.second->Type == ManifestEntryType::BitmapFromFile)
+            fileBatches[std::make_pair(entry.second->Dpi, entry.second->Alpha)].push_back(&entry);
+    }
+
+    for (auto& batch : fileBatches)
+    {
+        std::vector<WinString> fileNames;
+
+        for (auto entry : batch.second)
+        {
+            fileNames.push_back(entry->second->FileName);
+        }
+
+        auto bitmaps = LoadBitmapFilesInParallel(device, std::move(fileNames), batch.first.first, batch.first.second);
+
+        for (uint32_t i = 0; i < batch.second.size(); i++)
+        {
+            ComPtr<ICanvasBitmap> bitmap;
+            ThrowIfFailed(bitmaps->GetAt(i, &bitmap));
+
+            (*resources)[batch.second[i]->first] = As<IInspectable>(bitmap);
+        }
+    }
+
+    // Everything else is quick to create, and is done in the order it was
+    // added, so cached geometries come after the geometries they refer to.
+    for (auto& entry : entries)
+    {
+        auto& name = entry.first;
+        auto& details = *entry.second;
+
+        switch (details.Type)
+        {
+        case ManifestEntryType::BitmapFromFile:
+            break;
+
+        case ManifestEntryType::BitmapFromBytes:
+            {
+                auto bitmap = CanvasBitmap::CreateNew(
+                    device,
+                    static_cast<uint32_t>(details.Bytes.size()),
+                    const_cast<BYTE*>(details.Bytes.data()),
+                    details.WidthInPixels,
+                    details.HeightInPixels,
+                    details.Dpi,
+                    details.Format,
+                    details.Alpha);
+
+                (*resources)[name] = As<IInspectable>(bitmap);
+            }
+            break;
+
+        case ManifestEntryType::Geometry:
+            {
+                GeometryDevicePtr geometryDevice(device);
+
+                auto d2dGeometry = CopyGeometry(geometryDevice, details.RecordedGeometry.Get());
+
+                auto geometry = Make<CanvasGeometry>(geometryDevice, d2dGeometry.Get());
+                CheckMakeResult(geometry);
+
+                (*resources)[name] = As<IInspectable>(geometry);
+            }
+            break;
+
+        case ManifestEntryType::CachedFill:
+        case ManifestEntryType::CachedStroke:
+            {
+                auto geometryEntry = resources->find(details.GeometryKey);
+
+                // The geometry may have been removed, or replaced by a different type of resource.
+                ComPtr<ICanvasGeometry> geometry;
+
+                if (geometryEntry == resources->end() || !(geometry = MaybeAs<ICanvasGeometry>(geometryEntry->second)))
+                    ThrowHR(E_INVALIDARG, Strings::ResourceManifestUnknownGeometryKey);
+
+                ComPtr<CanvasCachedGeometry> cachedGeometry;
+
+                if (details.Type == ManifestEntryType::CachedFill)
+                    cachedGeometry = CanvasCachedGeometry::CreateNew(device, geometry.Get(), details.FlatteningTolerance);
+                else
+                    cachedGeometry = CanvasCachedGeometry::CreateNew(device, geometry.Get(), details.StrokeWidth, details.StrokeStyle.Get(), details.FlatteningTolerance);
+
+                (*resources)[name] = As<IInspectable>(cachedGeometry);
+            }
+            break;
+        }
+    }
+
+    return resources;
+}
+
+
+ActivatableClassWithFactory(CanvasResourceManifest, ::SimpleAgileActivationFactory<CanvasResourceManifest>);
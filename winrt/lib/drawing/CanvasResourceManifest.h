@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+    enum class ManifestEntryType
+    {
+        BitmapFromFile,
+        BitmapFromBytes,
+        Geometry,
+        CachedFill,
+        CachedStroke
+    };
+
+    //
+    // Everything needed to create one resource again.  Only the fields that
+    // apply to the entry's Type are used.
+    //
+    struct ManifestEntry
+    {
+        ManifestEntryType Type;
+
+        // Bitmaps
+        WinString FileName;
+        std::vector<uint8_t> Bytes;
+        int32_t WidthInPixels;
+        int32_t HeightInPixels;
+        DirectXPixelFormat Format;
+        float Dpi;
+        CanvasAlphaMode Alpha;
+
+        // Geometries are recorded into a path geometry on the standalone
+        // geometry factory, which can't be lost along with a device.
+        ComPtr<ID2D1PathGeometry1> RecordedGeometry;
+
+        // Cached geometries
+        std::wstring GeometryKey;
+        float StrokeWidth;
+        ComPtr<ICanvasStrokeStyle> StrokeStyle;
+        float FlatteningTolerance;
+    };
+
+
+    //
+    // Entries are kept in the order they were added, so that LoadAsync
+    // creates geometries before the cached geometries that refer to them.
+    // LoadAsync works from a copy of the entries, and swaps in the whole set
+    // of new resources when it has finished, so the resources from the last
+    // load stay available while a new one is in progress.
+    //
+    class CanvasResourceManifest : public RuntimeClass<ICanvasResourceManifest>,
+                                   private LifespanTracker<CanvasResourceManifest>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasResourceManifest, BaseTrust);
+
+        typedef std::vector<std::pair<std::wstring, std::shared_ptr<ManifestEntry const>>> EntryList;
+        typedef std::map<std::wstring, ComPtr<IInspectable>> ResourceMap;
+
+        std::mutex m_mutex;
+        EntryList m_entries;
+        std::shared_ptr<ResourceMap> m_resources;
+
+    public:
+        IFACEMETHOD(AddBitmapFromFile)(
+            HSTRING key,
+            HSTRING fileName,
+            float dpi,
+            CanvasAlphaMode alpha) override;
+
+        IFACEMETHOD(AddBitmapFromBytes)(
+            HSTRING key,
+            uint32_t byteCount,
+            BYTE* bytes,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            float dpi,
+            CanvasAlphaMode alpha) override;
+
+        IFACEMETHOD(AddGeometry)(
+            HSTRING key,
+            ICanvasGeometry* geometry) override;
+
+        IFACEMETHOD(AddCachedFill)(
+            HSTRING key,
+            HSTRING geometryKey,
+            float flatteningTolerance) override;
+
+        IFACEMETHOD(AddCachedStroke)(
+            HSTRING key,
+            HSTRING geometryKey,
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            float flatteningTolerance) override;
+
+        IFACEMETHOD(Remove)(
+            HSTRING key,
+            boolean* wasRemoved) override;
+
+        IFACEMETHOD(get_Count)(int32_t* value) override;
+
+        IFACEMETHOD(LoadAsync)(
+            ICanvasResourceCreator* resourceCreator,
+            IAsyncAction** action) override;
+
+        IFACEMETHOD(GetBitmap)(
+            HSTRING key,
+            ICanvasBitmap** bitmap) override;
+
+        IFACEMETHOD(GetGeometry)(
+            HSTRING key,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(GetCachedGeometry)(
+            HSTRING key,
+            ICanvasCachedGeometry** cachedGeometry) override;
+
+    private:
+        void AddEntry(HSTRING key, std::shared_ptr<ManifestEntry const> const& entry);
+
+        void ValidateGeometryKey(std::wstring const& geometryKey);
+
+        EntryList::iterator FindEntry(std::wstring const& key);
+
+        ComPtr<IInspectable> GetResource(HSTRING key, ManifestEntryType firstType, ManifestEntryType lastType);
+
+        static std::shared_ptr<ResourceMap> CreateResources(ICanvasDevice* device, EntryList const& entries);
+    };
+}}}}
@@ -77,13 +77,19 @@ static D2D1_RECT_U MakeSourceRect(ComPtr<ID2D1Bitmap> const& d2dBitmap, CanvasSp
 }
 
 
-static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, D2D1_UNIT_MODE unitMode, ICanvasBitmap* bitmap, Rect sourceRect)
+static float GetSourceRectDpi(D2D1_UNIT_MODE unitMode, ICanvasBitmap* bitmap)
 {
     float dpi = 96.0f;
 
     if (unitMode == D2D1_UNIT_MODE_DIPS)
         ThrowIfFailed(As<ICanvasResourceCreatorWithDpi>(bitmap)->get_Dpi(&dpi));
-    
+
+    return dpi;
+}
+
+
+static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, float dpi, Rect sourceRect)
+{
     auto sourceLeft   = DipsToPixels(sourceRect.X,      dpi, CanvasDpiRounding::Round);
     auto sourceTop    = DipsToPixels(sourceRect.Y,      dpi, CanvasDpiRounding::Round);
     auto sourceWidth  = DipsToPixels(sourceRect.Width,  dpi, CanvasDpiRounding::Round);
@@ -101,6 +107,12 @@ static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, D2D1_UNIT_MODE unitMode
 }
 
 
+static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, D2D1_UNIT_MODE unitMode, ICanvasBitmap* bitmap, Rect sourceRect)
+{
+    return MakeSourceRect(flip, GetSourceRectDpi(unitMode, bitmap), sourceRect);
+}
+
+
 static float3x2 MakeTransform(Vector2 const& origin, float rotation, Vector2 const& scale, Vector2 const& offset)
 {
     return
@@ -139,6 +151,78 @@ CanvasSpriteBatch::~CanvasSpriteBatch()
 }
 
 
+uint32_t CanvasSpriteBatch::SpriteArrays::Size() const
+{
+    return static_cast<uint32_t>(BitmapIndices.size());
+}
+
+
+void CanvasSpriteBatch::SpriteArrays::Reserve(size_t count)
+{
+    // Keep the usual geometric growth, so that lots of small bulk additions
+    // don't end up reallocating every time.
+    if (count <= BitmapIndices.capacity())
+        return;
+
+    count = std::max(count, BitmapIndices.capacity() * 2);
+
+    BitmapIndices.reserve(count);
+    DestinationRects.reserve(count);
+    SourceRects.reserve(count);
+    Colors.reserve(count);
+    Transforms.reserve(count);
+}
+
+
+void CanvasSpriteBatch::SpriteArrays::Clear()
+{
+    *this = SpriteArrays();
+}
+
+
+uint32_t CanvasSpriteBatch::GetBitmapIndex(ComPtr<ID2D1Bitmap>&& d2dBitmap)
+{
+    // Consecutive sprites very often share a bitmap, so check that before
+    // going to the map.
+    if (!m_bitmaps.empty() && m_bitmaps.back() == d2dBitmap)
+        return static_cast<uint32_t>(m_bitmaps.size() - 1);
+
+    auto newIndex = static_cast<uint32_t>(m_bitmaps.size());
+    auto result = m_bitmapIndices.emplace(d2dBitmap.Get(), newIndex);
+
+    if (result.second)
+        m_bitmaps.emplace_back(std::move(d2dBitmap));
+
+    return result.first->second;
+}
+
+
+void CanvasSpriteBatch::AddSprite(
+    ComPtr<ID2D1Bitmap>&& d2dBitmap,
+    D2D1_RECT_F const& destinationRect,
+    D2D1_RECT_U const& sourceRect,
+    Vector4 const& tint,
+    Matrix3x2 const& transform)
+{
+    AddSprite(GetBitmapIndex(std::move(d2dBitmap)), destinationRect, sourceRect, tint, transform);
+}
+
+
+void CanvasSpriteBatch::AddSprite(
+    uint32_t bitmapIndex,
+    D2D1_RECT_F const& destinationRect,
+    D2D1_RECT_U const& sourceRect,
+    Vector4 const& tint,
+    Matrix3x2 const& transform)
+{
+    m_sprites.BitmapIndices.push_back(bitmapIndex);
+    m_sprites.DestinationRects.push_back(destinationRect);
+    m_sprites.SourceRects.push_back(sourceRect);
+    m_sprites.Colors.push_back(*ReinterpretAs<D2D1_COLOR_F const*>(&tint));
+    m_sprites.Transforms.push_back(*ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform));
+}
+
+
 IFACEMETHODIMP CanvasSpriteBatch::DrawToRect( 
     ICanvasBitmap* bitmap,
     Rect destRect)
@@ -186,7 +270,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawAtOffsetWithTint(
         auto d2dDestRect = MakeDestRect(d2dBitmap, offset);
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, CanvasSpriteFlip::None);
         
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             d2dDestRect,
             d2dSourceRect,
@@ -218,7 +302,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawToRectWithTintAndFlip(
         auto d2dBitmap = GetWrappedResource<ID2D1Bitmap>(bitmap);
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, flip);
         
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             ToD2DRect(destRect),
             d2dSourceRect,
@@ -242,7 +326,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawWithTransformAndTintAndFlip(
         auto d2dDestRect = MakeDestRect(d2dBitmap);
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, flip);
 
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             d2dDestRect,
             d2dSourceRect,
@@ -271,7 +355,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawAtOffsetWithTintAndTransform(
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, flip);
         auto transform = MakeTransform(origin, rotation, scale, offset);
 
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             d2dDestRect,
             d2dSourceRect,
@@ -333,7 +417,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetAtOffsetWithTint(
         auto d2dDestRect = MakeDestRect(sourceRect, offset);
         auto d2dSourceRect = MakeSourceRect(CanvasSpriteFlip::None, m_unitMode, bitmap, sourceRect);
         
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             d2dDestRect,
             d2dSourceRect,
@@ -367,7 +451,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetToRectWithTintAndFlip(
         auto d2dBitmap = GetWrappedResource<ID2D1Bitmap>(bitmap);
         auto d2dSourceRect = MakeSourceRect(flip, m_unitMode, bitmap, sourceRect);
         
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             ToD2DRect(destRect),
             d2dSourceRect,
@@ -392,7 +476,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetWithTransformAndTintAndFlip
         auto d2dDestRect = MakeDestRect(sourceRect);
         auto d2dSourceRect = MakeSourceRect(flip, m_unitMode, bitmap, sourceRect);
         
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             d2dDestRect,
             d2dSourceRect,
@@ -422,7 +506,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetAtOffsetWithTintAndTransfor
         auto d2dSourceRect = MakeSourceRect(flip, m_unitMode, bitmap, sourceRect);
         auto transform = MakeTransform(origin, rotation, scale, offset);
 
-        m_sprites.emplace_back(
+        AddSprite(
             std::move(d2dBitmap),
             d2dDestRect,
             d2dSourceRect,
@@ -433,22 +517,155 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetAtOffsetWithTintAndTransfor
 
 
 template<typename T>
+static void ValidateSpriteArray(uint32_t spriteCount, uint32_t elementCount, T const* elements)
+{
+    if (elementCount == 0)
+        return;
+
+    CheckInPointer(elements);
+
+    if (elementCount != 1 && elementCount != spriteCount)
+        ThrowHR(E_INVALIDARG, Strings::BatchedPrimitiveArraySizeMismatch);
+}
+
+
+template<typename T>
+static T const& GetSpriteElement(T const* elements, uint32_t elementCount, uint32_t index)
+{
+    return (elementCount == 1) ? elements[0] : elements[index];
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawSpritesToRects(
+    ICanvasBitmap* bitmap,
+    uint32_t destRectCount,
+    Rect* destRects,
+    uint32_t sourceRectCount,
+    Rect* sourceRects,
+    uint32_t tintCount,
+    Vector4* tints)
+{
+    return ExceptionBoundary([&]
+    {
+        if (destRectCount)
+            CheckInPointer(destRects);
+
+        AddSprites(bitmap, destRectCount, destRects, nullptr, sourceRectCount, sourceRects, tintCount, tints);
+    });
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawSpritesWithTransforms(
+    ICanvasBitmap* bitmap,
+    uint32_t transformCount,
+    Matrix3x2* transforms,
+    uint32_t sourceRectCount,
+    Rect* sourceRects,
+    uint32_t tintCount,
+    Vector4* tints)
+{
+    return ExceptionBoundary([&]
+    {
+        if (transformCount)
+            CheckInPointer(transforms);
+
+        AddSprites(bitmap, transformCount, nullptr, transforms, sourceRectCount, sourceRects, tintCount, tints);
+    });
+}
+
+
+//
+// Bulk version of the Draw / DrawFromSpriteSheet methods.  Each sprite is
+// positioned either by a destination rect or a transform (exactly one of
+// destRects and transforms is non-null).  The bitmap is unwrapped, and its
+// size and DPI looked up, once for the whole array rather than per sprite.
+//
+void CanvasSpriteBatch::AddSprites(
+    ICanvasBitmap* bitmap,
+    uint32_t spriteCount,
+    Rect const* destRects,
+    Matrix3x2 const* transforms,
+    uint32_t sourceRectCount,
+    Rect const* sourceRects,
+    uint32_t tintCount,
+    Vector4 const* tints)
+{
+    assert((destRects == nullptr) != (transforms == nullptr) || spriteCount == 0);
+
+    CheckInPointer(bitmap);
+    EnsureNotClosed();
+
+    ValidateSpriteArray(spriteCount, sourceRectCount, sourceRects);
+    ValidateSpriteArray(spriteCount, tintCount, tints);
+
+    if (spriteCount == 0)
+        return;
+
+    auto d2dBitmap = GetWrappedResource<ID2D1Bitmap>(bitmap);
+
+    auto wholeBitmapDestRect = MakeDestRect(d2dBitmap);
+    auto wholeBitmapSourceRect = MakeSourceRect(d2dBitmap, CanvasSpriteFlip::None);
+    auto sourceRectDpi = sourceRectCount ? GetSourceRectDpi(m_unitMode, bitmap) : 0.0f;
+
+    auto bitmapIndex = GetBitmapIndex(std::move(d2dBitmap));
+
+    m_sprites.Reserve(m_sprites.Size() + spriteCount);
+
+    for (uint32_t i = 0; i < spriteCount; ++i)
+    {
+        auto d2dSourceRect = wholeBitmapSourceRect;
+        auto d2dDestRect = wholeBitmapDestRect;
+
+        if (sourceRectCount)
+        {
+            auto& sourceRect = GetSpriteElement(sourceRects, sourceRectCount, i);
+
+            d2dSourceRect = MakeSourceRect(CanvasSpriteFlip::None, sourceRectDpi, sourceRect);
+            d2dDestRect = MakeDestRect(sourceRect);
+        }
+
+        auto& tint = tintCount ? GetSpriteElement(tints, tintCount, i) : DEFAULT_TINT;
+
+        if (destRects)
+        {
+            AddSprite(
+                bitmapIndex,
+                ToD2DRect(destRects[i]),
+                d2dSourceRect,
+                tint,
+                Identity3x2());
+        }
+        else
+        {
+            AddSprite(
+                bitmapIndex,
+                d2dDestRect,
+                d2dSourceRect,
+                tint,
+                transforms[i]);
+        }
+    }
+}
+
+
 class BatchFinder
 {
-    std::vector<T> const& m_sprites;
+    std::vector<uint32_t> const& m_bitmapIndices;
     uint32_t const m_maxSpritesPerBatch;
 
     uint32_t m_startIndex;
     uint32_t m_endIndex;
-    ID2D1Bitmap* m_bitmap;
+    uint32_t m_bitmapIndex;
+    bool m_done;
 
 public:
-    BatchFinder(std::vector<T> const& sprites, uint32_t maxSpritesPerBatch) noexcept
-        : m_sprites(sprites)
+    BatchFinder(std::vector<uint32_t> const& bitmapIndices, uint32_t maxSpritesPerBatch) noexcept
+        : m_bitmapIndices(bitmapIndices)
         , m_maxSpritesPerBatch(maxSpritesPerBatch)
         , m_startIndex(0)
         , m_endIndex(0)
-        , m_bitmap(nullptr)
+        , m_bitmapIndex(0)
+        , m_done(false)
     {
         FindNext();
     }
@@ -456,13 +673,13 @@ public:
     void FindNext() noexcept
     {
         m_startIndex = m_endIndex;
-        if (m_endIndex >= m_sprites.size())
+        if (m_endIndex >= m_bitmapIndices.size())
         {
-            m_bitmap = nullptr;
+            m_done = true;
             return;
         }
 
-        m_bitmap = m_sprites[m_endIndex].Bitmap.Get();
+        m_bitmapIndex = m_bitmapIndices[m_endIndex];
 
         for (; InCurrentBatch(); ++m_endIndex)
         {
@@ -472,7 +689,7 @@ public:
 
     bool Done() const noexcept
     {
-        return (m_bitmap == nullptr);
+        return m_done;
     }
 
     uint32_t CurrentStartIndex() const noexcept
@@ -485,9 +702,9 @@ public:
         return m_endIndex - m_startIndex;
     }
 
-    ID2D1Bitmap* CurrentBitmap() const noexcept
+    uint32_t CurrentBitmapIndex() const noexcept
     {
-        return m_bitmap;
+        return m_bitmapIndex;
     }
 
 
@@ -500,10 +717,98 @@ private:
         if (m_endIndex - m_startIndex >= m_maxSpritesPerBatch)
             return false;
         
-        return m_endIndex != m_sprites.size() && m_sprites[m_endIndex].Bitmap.Get() == m_bitmap;
+        return m_endIndex != m_bitmapIndices.size() && m_bitmapIndices[m_endIndex] == m_bitmapIndex;
     }
 };
 
+
+template<typename T>
+static void ApplyPermutation(std::vector<T>& values, std::vector<uint32_t> const& destinations)
+{
+    std::vector<T> permuted(values.size());
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        permuted[destinations[i]] = values[i];
+    }
+
+    values.swap(permuted);
+}
+
+
+//
+// Stable counting sort of the sprites by bitmap.  Bitmaps are ordered by
+// their D2D pointer value (as they always have been), but that only
+// involves sorting the distinct bitmaps; the sprites themselves are sorted
+// in linear time.
+//
+void CanvasSpriteBatch::SortSpritesByBitmap()
+{
+    auto bitmapCount = static_cast<uint32_t>(m_bitmaps.size());
+
+    if (bitmapCount < 2)
+        return;
+
+    // Work out where each bitmap appears in the sorted order.
+    std::vector<uint32_t> bitmapOrder(bitmapCount);
+    for (uint32_t i = 0; i < bitmapCount; ++i)
+        bitmapOrder[i] = i;
+
+    std::sort(bitmapOrder.begin(), bitmapOrder.end(),
+        [&] (uint32_t a, uint32_t b)
+        {
+            return m_bitmaps[a].Get() < m_bitmaps[b].Get();
+        });
+
+    std::vector<uint32_t> bitmapRanks(bitmapCount);
+    for (uint32_t i = 0; i < bitmapCount; ++i)
+        bitmapRanks[bitmapOrder[i]] = i;
+
+    // Count the sprites using each bitmap and turn that into the position of
+    // the first sprite for each bitmap.
+    std::vector<uint32_t> nextPosition(bitmapCount);
+
+    for (auto bitmapIndex : m_sprites.BitmapIndices)
+        ++nextPosition[bitmapRanks[bitmapIndex]];
+
+    uint32_t position = 0;
+    for (auto& count : nextPosition)
+    {
+        auto bucketSize = count;
+        count = position;
+        position += bucketSize;
+    }
+
+    // Find where every sprite needs to move to.
+    auto spriteCount = m_sprites.Size();
+    std::vector<uint32_t> destinations(spriteCount);
+
+    for (uint32_t i = 0; i < spriteCount; ++i)
+        destinations[i] = nextPosition[bitmapRanks[m_sprites.BitmapIndices[i]]]++;
+
+    ApplyPermutation(m_sprites.BitmapIndices, destinations);
+    ApplyPermutation(m_sprites.DestinationRects, destinations);
+    ApplyPermutation(m_sprites.SourceRects, destinations);
+    ApplyPermutation(m_sprites.Colors, destinations);
+    ApplyPermutation(m_sprites.Transforms, destinations);
+}
+
+
+//
+// Older Qualcomm drivers can't handle large sprite batches, so on those
+// devices we limit how many sprites go to each DrawSpriteBatch call.
+//
+static uint32_t const QuirkedMaxSpritesPerBatch = 256;
+
+static bool IsSpriteBatchQuirkRequired(ID2D1DeviceContext3* deviceContext)
+{
+    ComPtr<ID2D1Device> d2dDevice;
+    deviceContext->GetDevice(&d2dDevice);
+    auto device = ResourceManager::GetOrCreate<ICanvasDeviceInternal>(d2dDevice.Get());
+    return device->IsSpriteBatchQuirkRequired();
+}
+
+
 IFACEMETHODIMP CanvasSpriteBatch::Close()
 {
     return ExceptionBoundary([&]
@@ -512,7 +817,7 @@ IFACEMETHODIMP CanvasSpriteBatch::Close()
         if (!deviceContext)
             return;
 
-        if (m_sprites.empty()) // early out if there's nothing to draw
+        if (m_sprites.Size() == 0) // early out if there's nothing to draw
             return;
 
         //
@@ -521,11 +826,7 @@ IFACEMETHODIMP CanvasSpriteBatch::Close()
         
         if (m_sortMode == CanvasSpriteSortMode::Bitmap)
         {
-            std::stable_sort(m_sprites.begin(), m_sprites.end(),
-                [] (auto const& a, auto const& b)
-                {
-                    return a.Bitmap.Get() < b.Bitmap.Get();
-                });
+            SortSpritesByBitmap();
         }
 
         //
@@ -535,21 +836,20 @@ IFACEMETHODIMP CanvasSpriteBatch::Close()
         ComPtr<ID2D1SpriteBatch> spriteBatch;
         ThrowIfFailed(deviceContext->CreateSpriteBatch(&spriteBatch));
 
-        assert(m_sprites.size() < std::numeric_limits<uint32_t>::max());
-
-        auto firstSprite = &m_sprites.front();
-        auto stride = static_cast<uint32_t>(sizeof(Sprite));
+        assert(m_sprites.BitmapIndices.size() < std::numeric_limits<uint32_t>::max());
 
         ThrowIfFailed(spriteBatch->AddSprites(
-            static_cast<uint32_t>(m_sprites.size()),
-            &firstSprite->DestinationRect,
-            &firstSprite->SourceRect,
-            &firstSprite->Color,
-            &firstSprite->Transform,
-            stride,
-            stride,
-            stride,
-            stride));
+            m_sprites.Size(),
+            m_sprites.DestinationRects.data(),
+            m_sprites.SourceRects.data(),
+            m_sprites.Colors.data(),
+            m_sprites.Transforms.data(),
+            static_cast<uint32_t>(sizeof(D2D1_RECT_F)),
+            static_cast<uint32_t>(sizeof(D2D1_RECT_U)),
+            static_cast<uint32_t>(sizeof(D2D1_COLOR_F)),
+            static_cast<uint32_t>(sizeof(D2D1_MATRIX_3X2_F))));
+
+        PerformanceCounters::Increment(PerformanceCounter::SpritesDrawn, m_sprites.Size());
 
         //
         // Get the device context into the right state
@@ -570,19 +870,16 @@ IFACEMETHODIMP CanvasSpriteBatch::Close()
 
         // Figure out if we need to quirk the batch size to workaround an issue
         // with older Qualcomm drivers.
-        ComPtr<ID2D1Device> d2dDevice;
-        deviceContext->GetDevice(&d2dDevice);
-        auto device = ResourceManager::GetOrCreate<ICanvasDeviceInternal>(d2dDevice.Get());
-        bool quirked = device->IsSpriteBatchQuirkRequired();
-        uint32_t maxSpritesPerBatch = quirked ? 256 : std::numeric_limits<uint32_t>::max();
+        bool quirked = IsSpriteBatchQuirkRequired(deviceContext.Get());
+        uint32_t maxSpritesPerBatch = quirked ? QuirkedMaxSpritesPerBatch : std::numeric_limits<uint32_t>::max();
         
-        for (BatchFinder<Sprite> batchFinder(m_sprites, maxSpritesPerBatch); !batchFinder.Done(); batchFinder.FindNext())
+        for (BatchFinder batchFinder(m_sprites.BitmapIndices, maxSpritesPerBatch); !batchFinder.Done(); batchFinder.FindNext())
         {
             deviceContext->DrawSpriteBatch(
                 spriteBatch.Get(),
                 batchFinder.CurrentStartIndex(),
                 batchFinder.CurrentSpriteCount(),
-                batchFinder.CurrentBitmap(),
+                m_bitmaps[batchFinder.CurrentBitmapIndex()].Get(),
                 m_interpolationMode,
                 m_spriteOptions);
 
@@ -609,8 +906,10 @@ IFACEMETHODIMP CanvasSpriteBatch::Close()
         // Release our working memory
         //
 
-        m_sprites.clear();
-        m_sprites.shrink_to_fit();
+        m_sprites.Clear();
+        m_bitmaps.clear();
+        m_bitmaps.shrink_to_fit();
+        m_bitmapIndices.clear();
     });
 }
 
@@ -677,4 +976,417 @@ void CanvasSpriteBatch::EnsureNotClosed()
 }
 
 
+void ValidateSpriteBatchInterpolationAndOptions(
+    CanvasImageInterpolation interpolation,
+    CanvasSpriteOptions options)
+{
+    // Validate interpolation mode
+    switch (interpolation)
+    {
+    case CanvasImageInterpolation::NearestNeighbor:
+    case CanvasImageInterpolation::Linear:
+        break;
+
+    default:
+        // We have a special message for this case since there are
+        // various, valid looking, CanvasImageInterpolation modes that
+        // are not valid to use with this API.
+        ThrowHR(E_INVALIDARG, Strings::SpriteBatchInvalidInterpolation);
+    }
+
+    // Validate options
+    auto const validOptions = CanvasSpriteOptions::ClampToSourceRect;
+    if ((static_cast<uint32_t>(options) & ~static_cast<uint32_t>(validOptions)) != 0)
+    {
+        // no special message for this since this can't happen unless
+        // the app is doing casting.
+        ThrowHR(E_INVALIDARG);
+    }
+}
+
+
+//
+// CanvasCachedSpriteBatchFactory implementation
+//
+
+
+ActivatableStaticOnlyFactory(CanvasCachedSpriteBatchFactory);
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatchFactory::Create(
+    ICanvasResourceCreator* resourceCreator,
+    ICanvasBitmap* bitmap,
+    ICanvasCachedSpriteBatch** cachedSpriteBatch)
+{
+    return CreateWithInterpolationAndOptions(
+        resourceCreator,
+        bitmap,
+        CanvasImageInterpolation::Linear,
+        CanvasSpriteOptions::None,
+        cachedSpriteBatch);
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatchFactory::CreateWithInterpolationAndOptions(
+    ICanvasResourceCreator* resourceCreator,
+    ICanvasBitmap* bitmap,
+    CanvasImageInterpolation interpolation,
+    CanvasSpriteOptions options,
+    ICanvasCachedSpriteBatch** cachedSpriteBatch)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(resourceCreator);
+        CheckInPointer(bitmap);
+        CheckAndClearOutPointer(cachedSpriteBatch);
+
+        auto newCachedSpriteBatch = CanvasCachedSpriteBatch::CreateNew(
+            resourceCreator,
+            bitmap,
+            interpolation,
+            options);
+
+        ThrowIfFailed(newCachedSpriteBatch.CopyTo(cachedSpriteBatch));
+    });
+}
+
+
+//
+// CanvasCachedSpriteBatch implementation
+//
+
+
+ComPtr<CanvasCachedSpriteBatch> CanvasCachedSpriteBatch::CreateNew(
+    ICanvasResourceCreator* resourceCreator,
+    ICanvasBitmap* bitmap,
+    CanvasImageInterpolation interpolation,
+    CanvasSpriteOptions options)
+{
+    ValidateSpriteBatchInterpolationAndOptions(interpolation, options);
+
+    ComPtr<ICanvasDevice> device;
+    ThrowIfFailed(resourceCreator->get_Device(&device));
+
+    auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+    auto deviceContext3 = MaybeAs<ID2D1DeviceContext3>(lease.Get());
+
+    if (!deviceContext3)
+        ThrowHR(E_NOTIMPL, Strings::SpriteBatchNotAvailable);
+
+    ComPtr<ID2D1SpriteBatch> spriteBatch;
+    ThrowIfFailed(deviceContext3->CreateSpriteBatch(&spriteBatch));
+
+    auto cachedSpriteBatch = Make<CanvasCachedSpriteBatch>(
+        device.Get(),
+        spriteBatch.Get(),
+        bitmap,
+        static_cast<D2D1_BITMAP_INTERPOLATION_MODE>(interpolation),
+        static_cast<D2D1_SPRITE_OPTIONS>(options));
+    CheckMakeResult(cachedSpriteBatch);
+
+    return cachedSpriteBatch;
+}
+
+
+CanvasCachedSpriteBatch::CanvasCachedSpriteBatch(
+    ICanvasDevice* device,
+    ID2D1SpriteBatch* spriteBatch,
+    ICanvasBitmap* bitmap,
+    D2D1_BITMAP_INTERPOLATION_MODE interpolation,
+    D2D1_SPRITE_OPTIONS options)
+    : m_spriteBatch(spriteBatch)
+    , m_device(device)
+    , m_bitmap(bitmap)
+    , m_d2dBitmap(GetWrappedResource<ID2D1Bitmap>(bitmap))
+    , m_bitmapDpi(GetSourceRectDpi(D2D1_UNIT_MODE_DIPS, bitmap))
+    , m_interpolationMode(interpolation)
+    , m_spriteOptions(options)
+{
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::get_Bitmap(ICanvasBitmap** value)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckAndClearOutPointer(value);
+        m_spriteBatch.EnsureNotClosed();
+
+        ThrowIfFailed(m_bitmap.CopyTo(value));
+    });
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::get_SpriteCount(int32_t* value)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(value);
+
+        *value = static_cast<int32_t>(m_spriteBatch.EnsureNotClosed()->GetSpriteCount());
+    });
+}
+
+
+//
+// The sprite arrays are passed to ID2D1SpriteBatch with a stride of zero
+// when they hold a single element (so that element is used for every
+// sprite), or as null when they are empty.  For AddSprites null means the
+// D2D defaults; for SetSprites it means the existing values are kept, which
+// includes the destination rects.
+//
+// Vector4 and Matrix3x2 have the same layout as D2D1_COLOR_F and
+// D2D1_MATRIX_3X2_F, so tints and transforms are passed straight through.
+// Destination and source rects need converting.
+//
+class CachedSpriteArrays
+{
+    std::vector<D2D1_RECT_F> m_destRects;
+    std::vector<D2D1_RECT_U> m_sourceRects;
+
+    uint32_t m_spriteCount;
+    uint32_t m_tintCount;
+    Vector4 const* m_tints;
+    uint32_t m_transformCount;
+    Matrix3x2 const* m_transforms;
+
+public:
+    CachedSpriteArrays(
+        float bitmapDpi,
+        uint32_t spriteCount,
+        uint32_t destRectCount,
+        Rect const* destRects,
+        uint32_t sourceRectCount,
+        Rect const* sourceRects,
+        uint32_t tintCount,
+        Vector4 const* tints,
+        uint32_t transformCount,
+        Matrix3x2 const* transforms)
+        : m_spriteCount(spriteCount)
+        , m_tintCount(tintCount)
+        , m_tints(tints)
+        , m_transformCount(transformCount)
+        , m_transforms(transforms)
+    {
+        ValidateSpriteArray(spriteCount, destRectCount, destRects);
+        ValidateSpriteArray(spriteCount, sourceRectCount, sourceRects);
+        ValidateSpriteArray(spriteCount, tintCount, tints);
+        ValidateSpriteArray(spriteCount, transformCount, transforms);
+
+        m_destRects.reserve(destRectCount);
+        for (uint32_t i = 0; i < destRectCount; ++i)
+            m_destRects.push_back(ToD2DRect(destRects[i]));
+
+        m_sourceRects.reserve(sourceRectCount);
+        for (uint32_t i = 0; i < sourceRectCount; ++i)
+            m_sourceRects.push_back(MakeSourceRect(CanvasSpriteFlip::None, bitmapDpi, sourceRects[i]));
+    }
+
+    uint32_t SpriteCount() const
+    {
+        return m_spriteCount;
+    }
+
+    D2D1_RECT_F const* DestRects() const        { return m_destRects.empty() ? nullptr : m_destRects.data(); }
+    D2D1_RECT_U const* SourceRects() const      { return m_sourceRects.empty() ? nullptr : m_sourceRects.data(); }
+    D2D1_COLOR_F const* Colors() const          { return m_tintCount ? reinterpret_cast<D2D1_COLOR_F const*>(m_tints) : nullptr; }
+    D2D1_MATRIX_3X2_F const* Transforms() const { return m_transformCount ? reinterpret_cast<D2D1_MATRIX_3X2_F const*>(m_transforms) : nullptr; }
+
+    uint32_t DestRectsStride() const   { return GetStride<D2D1_RECT_F>(static_cast<uint32_t>(m_destRects.size())); }
+    uint32_t SourceRectsStride() const { return GetStride<D2D1_RECT_U>(static_cast<uint32_t>(m_sourceRects.size())); }
+    uint32_t ColorsStride() const      { return GetStride<D2D1_COLOR_F>(m_tintCount); }
+    uint32_t TransformsStride() const  { return GetStride<D2D1_MATRIX_3X2_F>(m_transformCount); }
+
+private:
+    template<typename T>
+    static uint32_t GetStride(uint32_t elementCount)
+    {
+        return elementCount == 1 ? 0 : static_cast<uint32_t>(sizeof(T));
+    }
+};
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::AddSprites(
+    uint32_t destRectCount,
+    Rect* destRects,
+    uint32_t sourceRectCount,
+    Rect* sourceRects,
+    uint32_t tintCount,
+    Vector4* tints,
+    uint32_t transformCount,
+    Matrix3x2* transforms)
+{
+    return ExceptionBoundary([&]
+    {
+        auto& spriteBatch = m_spriteBatch.EnsureNotClosed();
+
+        // Every new sprite needs a destination rect.
+        CachedSpriteArrays sprites(
+            m_bitmapDpi,
+            destRectCount,
+            destRectCount, destRects,
+            sourceRectCount, sourceRects,
+            tintCount, tints,
+            transformCount, transforms);
+
+        if (sprites.SpriteCount() == 0)
+            return;
+
+        ThrowIfFailed(spriteBatch->AddSprites(
+            sprites.SpriteCount(),
+            sprites.DestRects(),
+            sprites.SourceRects(),
+            sprites.Colors(),
+            sprites.Transforms(),
+            sprites.DestRectsStride(),
+            sprites.SourceRectsStride(),
+            sprites.ColorsStride(),
+            sprites.TransformsStride()));
+    });
+}
+
+
+// SetSprites updates one sprite per destination rect. When destRects is
+// empty, so only the other properties are being changed, the count comes
+// from whichever arrays hold one element per sprite instead. If they all
+// hold a single shared element, every sprite from startIndex on is updated.
+static uint32_t GetUpdatedSpriteCount(
+    uint32_t remainingCount,
+    uint32_t destRectCount,
+    uint32_t sourceRectCount,
+    uint32_t tintCount,
+    uint32_t transformCount)
+{
+    if (destRectCount)
+        return destRectCount;
+
+    auto count = std::max({ sourceRectCount, tintCount, transformCount });
+
+    return (count == 1) ? remainingCount : count;
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::SetSprites(
+    int32_t startIndex,
+    uint32_t destRectCount,
+    Rect* destRects,
+    uint32_t sourceRectCount,
+    Rect* sourceRects,
+    uint32_t tintCount,
+    Vector4* tints,
+    uint32_t transformCount,
+    Matrix3x2* transforms)
+{
+    return ExceptionBoundary([&]
+    {
+        auto& spriteBatch = m_spriteBatch.EnsureNotClosed();
+
+        auto spriteCount = spriteBatch->GetSpriteCount();
+
+        if (startIndex < 0 || static_cast<uint32_t>(startIndex) > spriteCount)
+            ThrowHR(E_BOUNDS);
+
+        auto remainingCount = spriteCount - static_cast<uint32_t>(startIndex);
+
+        CachedSpriteArrays sprites(
+            m_bitmapDpi,
+            GetUpdatedSpriteCount(remainingCount, destRectCount, sourceRectCount, tintCount, transformCount),
+            destRectCount, destRects,
+            sourceRectCount, sourceRects,
+            tintCount, tints,
+            transformCount, transforms);
+
+        if (sprites.SpriteCount() > remainingCount)
+            ThrowHR(E_BOUNDS);
+
+        if (sprites.SpriteCount() == 0)
+            return;
+
+        ThrowIfFailed(spriteBatch->SetSprites(
+            static_cast<uint32_t>(startIndex),
+            sprites.SpriteCount(),
+            sprites.DestRects(),
+            sprites.SourceRects(),
+            sprites.Colors(),
+            sprites.Transforms(),
+            sprites.DestRectsStride(),
+            sprites.SourceRectsStride(),
+            sprites.ColorsStride(),
+            sprites.TransformsStride()));
+    });
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::Clear()
+{
+    return ExceptionBoundary([&]
+    {
+        m_spriteBatch.EnsureNotClosed()->Clear();
+    });
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::Close()
+{
+    m_spriteBatch.Close();
+    m_device.Reset();
+    m_bitmap.Reset();
+    m_d2dBitmap.Reset();
+    return S_OK;
+}
+
+
+IFACEMETHODIMP CanvasCachedSpriteBatch::get_Device(ICanvasDevice** value)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckAndClearOutPointer(value);
+        m_spriteBatch.EnsureNotClosed();
+
+        ThrowIfFailed(m_device.CopyTo(value));
+    });
+}
+
+
+void CanvasCachedSpriteBatch::Draw(ICanvasDevice* device, ID2D1DeviceContext3* deviceContext)
+{
+    auto& spriteBatch = m_spriteBatch.EnsureNotClosed();
+
+    if (!IsSameInstance(device, m_device.Get()))
+        ThrowHR(E_INVALIDARG, Strings::CachedSpriteBatchWrongDevice);
+
+    auto spriteCount = spriteBatch->GetSpriteCount();
+    if (spriteCount == 0)
+        return;
+
+    auto originalAntialiasMode = deviceContext->GetAntialiasMode();
+
+    if (originalAntialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE)
+        deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+
+    bool quirked = IsSpriteBatchQuirkRequired(deviceContext);
+    uint32_t maxSpritesPerBatch = quirked ? QuirkedMaxSpritesPerBatch : spriteCount;
+
+    for (uint32_t startIndex = 0; startIndex < spriteCount; startIndex += maxSpritesPerBatch)
+    {
+        deviceContext->DrawSpriteBatch(
+            spriteBatch.Get(),
+            startIndex,
+            std::min(maxSpritesPerBatch, spriteCount - startIndex),
+            m_d2dBitmap.Get(),
+            m_interpolationMode,
+            m_spriteOptions);
+
+        if (quirked)
+        {
+            // See CanvasSpriteBatch::Close.
+            deviceContext->Flush();
+        }
+    }
+
+    if (originalAntialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE)
+        deviceContext->SetAntialiasMode(originalAntialiasMode);
+}
+
+
 #endif
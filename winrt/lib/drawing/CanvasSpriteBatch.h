@@ -30,39 +30,30 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_SPRITE_OPTIONS m_spriteOptions;
         D2D1_UNIT_MODE m_unitMode;
         
-        struct Sprite
+        //
+        // Sprites are stored as a structure of arrays, so the arrays can be
+        // handed straight to ID2D1SpriteBatch::AddSprites, and sorting only
+        // has to look at the (small) bitmap index of each sprite.
+        //
+        // Each distinct bitmap is referenced once from m_bitmaps; sprites
+        // refer to their bitmap by its index into that vector.
+        //
+        struct SpriteArrays
         {
-            ComPtr<ID2D1Bitmap> Bitmap;
-            D2D1_RECT_F DestinationRect;
-            D2D1_RECT_U SourceRect;
-            D2D1_COLOR_F Color;
-            D2D1_MATRIX_3X2_F Transform;
-
-            Sprite(
-                ComPtr<ID2D1Bitmap>&& bitmap,
-                D2D1_RECT_F const& destinationRect,
-                D2D1_RECT_U const& sourceRect,
-                Vector4 const& tint,
-                Matrix3x2 const& transform)
-                : Bitmap(std::move(bitmap))
-                , DestinationRect(destinationRect)
-                , SourceRect(sourceRect)
-                , Color(*ReinterpretAs<D2D1_COLOR_F const*>(&tint))
-                , Transform(*ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform))
-            {
-            }
-
-            Sprite(
-                ComPtr<ID2D1Bitmap>&& bitmap,
-                D2D1_RECT_F const& destinationRect,
-                D2D1_RECT_U const& sourceRect,
-                Vector4 const& tint)
-                : Sprite(std::move(bitmap), destinationRect, sourceRect, tint, Identity3x2())
-            {
-            }
+            std::vector<uint32_t> BitmapIndices;
+            std::vector<D2D1_RECT_F> DestinationRects;
+            std::vector<D2D1_RECT_U> SourceRects;
+            std::vector<D2D1_COLOR_F> Colors;
+            std::vector<D2D1_MATRIX_3X2_F> Transforms;
+
+            uint32_t Size() const;
+            void Reserve(size_t count);
+            void Clear();
         };
 
-        std::vector<Sprite> m_sprites;
+        std::vector<ComPtr<ID2D1Bitmap>> m_bitmaps;
+        std::unordered_map<ID2D1Bitmap*, uint32_t> m_bitmapIndices;
+        SpriteArrays m_sprites;
 
     public:
         static Vector4 const DEFAULT_TINT;
@@ -184,6 +175,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             Vector2 scale,
             CanvasSpriteFlip flip) override;
 
+        IFACEMETHODIMP DrawSpritesToRects(
+            ICanvasBitmap* bitmap,
+            uint32_t destRectCount,
+            Rect* destRects,
+            uint32_t sourceRectCount,
+            Rect* sourceRects,
+            uint32_t tintCount,
+            Vector4* tints) override;
+
+        IFACEMETHODIMP DrawSpritesWithTransforms(
+            ICanvasBitmap* bitmap,
+            uint32_t transformCount,
+            Matrix3x2* transforms,
+            uint32_t sourceRectCount,
+            Rect* sourceRects,
+            uint32_t tintCount,
+            Vector4* tints) override;
+
         //
         // IClosable
         //
@@ -214,8 +223,166 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasDpiRounding dpiRounding,
             int32_t* pixels) override;
 
+        //
+        // For internal callers, such as CanvasGlyphAtlas, that already have
+        // a D2D bitmap and a source rectangle in pixels.
+        //
+
+        void AddSprite(
+            ComPtr<ID2D1Bitmap>&& d2dBitmap,
+            D2D1_RECT_F const& destinationRect,
+            D2D1_RECT_U const& sourceRect,
+            Vector4 const& tint,
+            Matrix3x2 const& transform = Identity3x2());
+
     private:
         void EnsureNotClosed();
+
+        uint32_t GetBitmapIndex(ComPtr<ID2D1Bitmap>&& d2dBitmap);
+
+        void AddSprite(
+            uint32_t bitmapIndex,
+            D2D1_RECT_F const& destinationRect,
+            D2D1_RECT_U const& sourceRect,
+            Vector4 const& tint,
+            Matrix3x2 const& transform);
+
+        void AddSprites(
+            ICanvasBitmap* bitmap,
+            uint32_t spriteCount,
+            Rect const* destRects,
+            Matrix3x2 const* transforms,
+            uint32_t sourceRectCount,
+            Rect const* sourceRects,
+            uint32_t tintCount,
+            Vector4 const* tints);
+
+        void SortSpritesByBitmap();
+    };
+
+
+    // Validates the interpolation and options passed when creating either
+    // kind of sprite batch.
+    void ValidateSpriteBatchInterpolationAndOptions(
+        CanvasImageInterpolation interpolation,
+        CanvasSpriteOptions options);
+
+
+    class __declspec(uuid("3F6A2C8E-91D4-4B7A-8E15-C2D07A4B9F36"))
+    ICanvasCachedSpriteBatchInternal : public IUnknown
+    {
+    public:
+        virtual void Draw(ICanvasDevice* device, ID2D1DeviceContext3* deviceContext) = 0;
+    };
+
+
+    class CanvasCachedSpriteBatchFactory
+        : public AgileActivationFactory<ICanvasCachedSpriteBatchStatics>
+        , private LifespanTracker<CanvasCachedSpriteBatchFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasCachedSpriteBatch, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasBitmap* bitmap,
+            ICanvasCachedSpriteBatch** cachedSpriteBatch) override;
+
+        IFACEMETHOD(CreateWithInterpolationAndOptions)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasBitmap* bitmap,
+            CanvasImageInterpolation interpolation,
+            CanvasSpriteOptions options,
+            ICanvasCachedSpriteBatch** cachedSpriteBatch) override;
+    };
+
+
+    //
+    // Unlike CanvasSpriteBatch, which builds an ID2D1SpriteBatch when it is
+    // closed and then throws it away, this keeps its ID2D1SpriteBatch alive
+    // so the same sprites can be drawn frame after frame without being
+    // uploaded again.
+    //
+    class CanvasCachedSpriteBatch
+        : public RuntimeClass<
+            ICanvasCachedSpriteBatch,
+            IClosable,
+            ICanvasResourceCreator,
+            CloakedIid<ICanvasCachedSpriteBatchInternal>>
+        , private LifespanTracker<CanvasCachedSpriteBatch>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasCachedSpriteBatch, BaseTrust);
+
+        ClosablePtr<ID2D1SpriteBatch> m_spriteBatch;
+        ComPtr<ICanvasDevice> m_device;
+        ComPtr<ICanvasBitmap> m_bitmap;
+        ComPtr<ID2D1Bitmap> m_d2dBitmap;
+        float m_bitmapDpi;
+        D2D1_BITMAP_INTERPOLATION_MODE m_interpolationMode;
+        D2D1_SPRITE_OPTIONS m_spriteOptions;
+
+    public:
+        static ComPtr<CanvasCachedSpriteBatch> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasBitmap* bitmap,
+            CanvasImageInterpolation interpolation,
+            CanvasSpriteOptions options);
+
+        CanvasCachedSpriteBatch(
+            ICanvasDevice* device,
+            ID2D1SpriteBatch* spriteBatch,
+            ICanvasBitmap* bitmap,
+            D2D1_BITMAP_INTERPOLATION_MODE interpolation,
+            D2D1_SPRITE_OPTIONS options);
+
+        //
+        // ICanvasCachedSpriteBatch
+        //
+
+        IFACEMETHOD(get_Bitmap)(ICanvasBitmap** value) override;
+
+        IFACEMETHOD(get_SpriteCount)(int32_t* value) override;
+
+        IFACEMETHOD(AddSprites)(
+            uint32_t destRectCount,
+            Rect* destRects,
+            uint32_t sourceRectCount,
+            Rect* sourceRects,
+            uint32_t tintCount,
+            Vector4* tints,
+            uint32_t transformCount,
+            Matrix3x2* transforms) override;
+
+        IFACEMETHOD(SetSprites)(
+            int32_t startIndex,
+            uint32_t destRectCount,
+            Rect* destRects,
+            uint32_t sourceRectCount,
+            Rect* sourceRects,
+            uint32_t tintCount,
+            Vector4* tints,
+            uint32_t transformCount,
+            Matrix3x2* transforms) override;
+
+        IFACEMETHOD(Clear)() override;
+
+        //
+        // IClosable
+        //
+
+        IFACEMETHOD(Close)() override;
+
+        //
+        // ICanvasResourceCreator
+        //
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        //
+        // ICanvasCachedSpriteBatchInternal
+        //
+
+        virtual void Draw(ICanvasDevice* device, ID2D1DeviceContext3* deviceContext) override;
     };
 
 } } } }
@@ -17,6 +17,7 @@ CanvasStrokeStyle::CanvasStrokeStyle()
     , m_dashOffset(0)
     , m_transformBehavior(CanvasStrokeTransformBehavior::Normal)
     , m_closed(false)
+    , m_frozen(false)
 {
 }
 
@@ -24,6 +25,7 @@ CanvasStrokeStyle::CanvasStrokeStyle()
 CanvasStrokeStyle::CanvasStrokeStyle(ID2D1StrokeStyle1* d2dStrokeStyle)
     : ResourceWrapper(d2dStrokeStyle)
     , m_closed(false)
+    , m_frozen(false)
     , m_startCap(static_cast<CanvasCapStyle>(d2dStrokeStyle->GetStartCap()))
     , m_endCap(static_cast<CanvasCapStyle>(d2dStrokeStyle->GetEndCap()))
     , m_dashCap(static_cast<CanvasCapStyle>(d2dStrokeStyle->GetDashCap()))
@@ -76,6 +78,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_StartCap(_In_ CanvasCapStyle value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_startCap != value)
             {
                 ReleaseResource();
@@ -105,6 +108,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_EndCap(_In_ CanvasCapStyle value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_endCap != value)
             {
                 ReleaseResource();
@@ -134,6 +138,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_DashCap(_In_ CanvasCapStyle value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_dashCap != value)
             {
                 ReleaseResource();
@@ -163,6 +168,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_LineJoin(_In_ CanvasLineJoin value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_lineJoin != value)
             {
                 ReleaseResource();
@@ -192,6 +198,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_MiterLimit(_In_ float value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_miterLimit != value)
             {
                 ReleaseResource();
@@ -221,6 +228,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_DashStyle(_In_ CanvasDashStyle value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_dashStyle != value)
             {
                 ReleaseResource();
@@ -250,6 +258,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_DashOffset(float value)
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
             if (m_dashOffset != value)
             {
                 ReleaseResource();
@@ -288,6 +297,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_CustomDashStyle(
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
 
             if (valueCount)
                 CheckInPointer(valueElements);
@@ -324,6 +334,7 @@ IFACEMETHODIMP CanvasStrokeStyle::put_TransformBehavior(_In_ CanvasStrokeTransfo
             auto lock = GetLock();
             
             ThrowIfClosed();
+            ThrowIfFrozen();
 
             if (m_transformBehavior != value)
             {
@@ -357,11 +368,23 @@ ComPtr<ID2D1StrokeStyle1> CanvasStrokeStyle::GetRealizedD2DStrokeStyle(ID2D1Fact
 {
     auto lock = GetLock();
             
+    auto& resource = MaybeGetResource();
+
+    if (m_frozen)
+    {
+        if (resource && m_frozenFactory.Get() == d2dFactory)
+            return resource;
+
+        //
+        // Drawing with a device on a different factory (or after Close) gets a
+        // one-off realization, so the shared resource is left as it is.
+        //
+        return CreateD2DStrokeStyle(d2dFactory);
+    }
+
     //
     // If there is already a realization, ensure its factory matches the target factory.
     //
-    auto& resource = MaybeGetResource();
-
     if (resource)
     {
         ComPtr<ID2D1Factory> realizationFactory;
@@ -376,6 +399,16 @@ ComPtr<ID2D1StrokeStyle1> CanvasStrokeStyle::GetRealizedD2DStrokeStyle(ID2D1Fact
     //
     // We must re-realize the D2D resource.
     //
+    auto d2dStrokeStyle = CreateD2DStrokeStyle(d2dFactory);
+
+    SetResource(d2dStrokeStyle.Get());
+
+    return d2dStrokeStyle;
+}
+
+
+D2D1_STROKE_STYLE_PROPERTIES1 CanvasStrokeStyle::GetD2DStrokeStyleProperties()
+{
     D2D1_STROKE_STYLE_PROPERTIES1 strokeStyleProperties = D2D1::StrokeStyleProperties1(
         static_cast<D2D1_CAP_STYLE>(m_startCap),
         static_cast<D2D1_CAP_STYLE>(m_endCap),
@@ -386,11 +419,21 @@ ComPtr<ID2D1StrokeStyle1> CanvasStrokeStyle::GetRealizedD2DStrokeStyle(ID2D1Fact
         m_dashOffset,
         static_cast<D2D1_STROKE_TRANSFORM_TYPE>(m_transformBehavior));
 
+    if (m_customDashElements.size() > 0)
+    {
+        strokeStyleProperties.dashStyle = D2D1_DASH_STYLE_CUSTOM;
+    }
+
+    return strokeStyleProperties;
+}
+
+
+ComPtr<ID2D1StrokeStyle1> CanvasStrokeStyle::CreateD2DStrokeStyle(ID2D1Factory* d2dFactory)
+{
     float* dashArray = NULL;
     if (m_customDashElements.size() > 0)
     {
         dashArray = &(m_customDashElements[0]);
-        strokeStyleProperties.dashStyle = D2D1_DASH_STYLE_CUSTOM;
     }
 
     assert(m_customDashElements.size() <= UINT_MAX);
@@ -400,17 +443,47 @@ ComPtr<ID2D1StrokeStyle1> CanvasStrokeStyle::GetRealizedD2DStrokeStyle(ID2D1Fact
 
     ComPtr<ID2D1StrokeStyle1> d2dStrokeStyle;
     ThrowIfFailed(d2dFactory2->CreateStrokeStyle(
-        strokeStyleProperties,
+        GetD2DStrokeStyleProperties(),
         dashArray,
         static_cast<uint32_t>(m_customDashElements.size()),
         &d2dStrokeStyle));
 
-    SetResource(d2dStrokeStyle.Get());
-
     return d2dStrokeStyle;
 }
 
 
+ComPtr<CanvasStrokeStyle> CanvasStrokeStyle::CreateFrozen(
+    ICanvasDevice* device,
+    ICanvasStrokeStyle* strokeStyle)
+{
+    auto frozenStrokeStyle = Make<CanvasStrokeStyle>();
+    CheckMakeResult(frozenStrokeStyle);
+
+    ThrowIfFailed(strokeStyle->get_StartCap(&frozenStrokeStyle->m_startCap));
+    ThrowIfFailed(strokeStyle->get_EndCap(&frozenStrokeStyle->m_endCap));
+    ThrowIfFailed(strokeStyle->get_DashCap(&frozenStrokeStyle->m_dashCap));
+    ThrowIfFailed(strokeStyle->get_LineJoin(&frozenStrokeStyle->m_lineJoin));
+    ThrowIfFailed(strokeStyle->get_MiterLimit(&frozenStrokeStyle->m_miterLimit));
+    ThrowIfFailed(strokeStyle->get_DashStyle(&frozenStrokeStyle->m_dashStyle));
+    ThrowIfFailed(strokeStyle->get_DashOffset(&frozenStrokeStyle->m_dashOffset));
+    ThrowIfFailed(strokeStyle->get_TransformBehavior(&frozenStrokeStyle->m_transformBehavior));
+
+    ComArray<float> customDashElements;
+    ThrowIfFailed(strokeStyle->get_CustomDashStyle(customDashElements.GetAddressOfSize(), customDashElements.GetAddressOfData()));
+    frozenStrokeStyle->m_customDashElements.assign(customDashElements.GetData(), customDashElements.GetData() + customDashElements.GetSize());
+
+    auto d2dStrokeStyle = As<ICanvasDeviceInternal>(device)->CreateStrokeStyle(
+        frozenStrokeStyle->GetD2DStrokeStyleProperties(),
+        frozenStrokeStyle->m_customDashElements);
+
+    frozenStrokeStyle->SetSharedResource(d2dStrokeStyle.Get());
+    d2dStrokeStyle->GetFactory(&frozenStrokeStyle->m_frozenFactory);
+    frozenStrokeStyle->m_frozen = true;
+
+    return frozenStrokeStyle;
+}
+
+
 //
 // ICanvasResourceWrapperNative
 //
@@ -446,6 +519,14 @@ void CanvasStrokeStyle::ThrowIfClosed()
     }
 }
 
+void CanvasStrokeStyle::ThrowIfFrozen()
+{
+    if (m_frozen)
+    {
+        ThrowHR(E_ILLEGAL_METHOD_CALL, Strings::StrokeStyleIsFrozen);
+    }
+}
+
 //
 // CanvasStrokeStyleFactory
 //
@@ -464,4 +545,26 @@ IFACEMETHODIMP CanvasStrokeStyleFactory::ActivateInstance(IInspectable** object)
         });
 }
 
+_Use_decl_annotations_
+IFACEMETHODIMP CanvasStrokeStyleFactory::CreateFrozen(
+    ICanvasResourceCreator* resourceCreator,
+    ICanvasStrokeStyle* strokeStyle,
+    ICanvasStrokeStyle** frozenStrokeStyle)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(strokeStyle);
+            CheckAndClearOutPointer(frozenStrokeStyle);
+
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(resourceCreator->get_Device(&device));
+
+            auto newCanvasStrokeStyle = CanvasStrokeStyle::CreateFrozen(device.Get(), strokeStyle);
+
+            ThrowIfFailed(newCanvasStrokeStyle.CopyTo(frozenStrokeStyle));
+        });
+}
+
 ActivatableClassWithFactory(CanvasStrokeStyle, CanvasStrokeStyleFactory);
@@ -21,11 +21,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     };
 
     class CanvasStrokeStyleFactory
-        : public AgileActivationFactory<>
+        : public AgileActivationFactory<ICanvasStrokeStyleStatics>
         , private LifespanTracker<CanvasStrokeStyleFactory>
     {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasStrokeStyle, BaseTrust);
+
     public:
         IFACEMETHOD(ActivateInstance)(IInspectable** ppvObject) override;
+
+        //
+        // ICanvasStrokeStyleStatics
+        //
+
+        IFACEMETHOD(CreateFrozen)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasStrokeStyle* strokeStyle,
+            ICanvasStrokeStyle** frozenStrokeStyle) override;
     };
 
     class CanvasStrokeStyle : RESOURCE_WRAPPER_RUNTIME_CLASS(
@@ -55,7 +66,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         //
         bool m_closed;
 
+        //
+        // Frozen stroke styles can't be changed, and share their D2D resource
+        // with every other frozen style that has the same properties. The factory
+        // it was created on is kept so realization is just a pointer compare.
+        //
+        bool m_frozen;
+        ComPtr<ID2D1Factory> m_frozenFactory;
+
     public:
+        static ComPtr<CanvasStrokeStyle> CreateFrozen(
+            ICanvasDevice* device,
+            ICanvasStrokeStyle* strokeStyle);
+
         CanvasStrokeStyle();
 
         CanvasStrokeStyle(ID2D1StrokeStyle1* d2dStrokeStyle);
@@ -111,6 +134,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     private:
         void ThrowIfClosed();
+        void ThrowIfFrozen();
+
+        D2D1_STROKE_STYLE_PROPERTIES1 GetD2DStrokeStyleProperties();
+        ComPtr<ID2D1StrokeStyle1> CreateD2DStrokeStyle(ID2D1Factory* d2dFactory);
 
         Lock GetLock()
         {
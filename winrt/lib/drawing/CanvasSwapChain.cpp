@@ -6,6 +6,59 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
+#if WINVER > _WIN32_WINNT_WINBLUE
+    static UINT const AllowTearingSwapChainFlag = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    static UINT const AllowTearingPresentFlag = DXGI_PRESENT_ALLOW_TEARING;
+#else
+    // Tearing is never supported here, so these are never used.
+    static UINT const AllowTearingSwapChainFlag = 0;
+    static UINT const AllowTearingPresentFlag = 0;
+#endif
+
+    // Rounds out to whole pixels, so the rect covers every pixel it touches.
+    static RECT ToOutwardRECT(Rect const& rect, float dpi)
+    {
+        if (rect.Width < 0 || rect.Height < 0)
+            ThrowHR(E_INVALIDARG);
+
+        return RECT
+        {
+            DipsToPixels(rect.X, dpi, CanvasDpiRounding::Floor),
+            DipsToPixels(rect.Y, dpi, CanvasDpiRounding::Floor),
+            DipsToPixels(rect.X + rect.Width, dpi, CanvasDpiRounding::Ceiling),
+            DipsToPixels(rect.Y + rect.Height, dpi, CanvasDpiRounding::Ceiling)
+        };
+    }
+
+    static RECT ClipRECT(RECT const& rect, DXGI_SWAP_CHAIN_DESC1 const& desc)
+    {
+        return RECT
+        {
+            std::max(rect.left, 0L),
+            std::max(rect.top, 0L),
+            std::min(rect.right, static_cast<LONG>(desc.Width)),
+            std::min(rect.bottom, static_cast<LONG>(desc.Height))
+        };
+    }
+
+    static bool IsEmptyRECT(RECT const& rect)
+    {
+        return rect.right <= rect.left || rect.bottom <= rect.top;
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+    static DXGI_COLOR_SPACE_TYPE ToDxgiColorSpace(CanvasSwapChainColorSpace colorSpace)
+    {
+        switch (colorSpace)
+        {
+        case CanvasSwapChainColorSpace::Srgb:  return DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709;
+        case CanvasSwapChainColorSpace::ScRgb: return DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709;
+        case CanvasSwapChainColorSpace::Hdr10: return DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020;
+        default:                               ThrowHR(E_INVALIDARG);
+        }
+    }
+#endif
+
     //
     // CanvasSwapChainFactory
     //
@@ -162,6 +215,86 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 ThrowIfFailed(newCanvasSwapChain.CopyTo(swapChain));
             });
     }
+
+    IFACEMETHODIMP CanvasSwapChainFactory::IsTearingSupported(
+        ICanvasDevice* device,
+        boolean* isSupported)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(device);
+                CheckInPointer(isSupported);
+
+                *isSupported = As<ICanvasDeviceInternal>(device)->IsTearingSupported();
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChainFactory::CreateAllowingTearing(
+        ICanvasResourceCreator* resourceCreator,
+        float width,
+        float height,
+        float dpi,
+        DirectXPixelFormat format,
+        int32_t bufferCount,
+        CanvasAlphaMode alphaMode,
+        ICanvasSwapChain** swapChain)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(swapChain);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newCanvasSwapChain = CanvasSwapChain::CreateNew(
+                    device.Get(),
+                    width,
+                    height,
+                    dpi,
+                    format,
+                    bufferCount,
+                    alphaMode,
+                    0,
+                    true);
+
+                ThrowIfFailed(newCanvasSwapChain.CopyTo(swapChain));
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChainFactory::CreateWithColorSpace(
+        ICanvasResourceCreator* resourceCreator,
+        float width,
+        float height,
+        float dpi,
+        CanvasSwapChainColorSpace colorSpace,
+        ICanvasSwapChain** swapChain)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(swapChain);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newCanvasSwapChain = CanvasSwapChain::CreateNew(
+                    device.Get(),
+                    width,
+                    height,
+                    dpi,
+                    CanvasSwapChain::GetFormatForColorSpace(colorSpace),
+                    CanvasSwapChain::DefaultBufferCount,
+                    CanvasSwapChain::DefaultCompositionAlphaMode);
+
+                newCanvasSwapChain->SetColorSpace(colorSpace);
+
+                ThrowIfFailed(newCanvasSwapChain.CopyTo(swapChain));
+            });
+    }
     
     CanvasSwapChain::CanvasSwapChain(
         ICanvasDevice* device,
@@ -174,6 +307,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         , m_dpi(dpi)
         , m_adapter(CanvasSwapChainAdapter::GetInstance())
         , m_hasActiveDrawingSession(std::make_shared<bool>())
+        , m_maximumFrameLatency(0)
+        , m_isTearingAllowed(false)
+        , m_hasPresentedSinceResize(false)
+        , m_wasLastPresentOccluded(false)
+        , m_colorSpace(CanvasSwapChainColorSpace::Srgb)
     {
     }
 
@@ -447,10 +585,182 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {
                 auto lock = GetResourceLock();
-                auto& resource = GetResource();
+                PresentImpl(lock, syncInterval, 0, 0, nullptr, nullptr, nullptr);
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::PresentAllowingTearing()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto lock = GetResourceLock();
+                PresentImpl(lock, 0, m_isTearingAllowed ? AllowTearingPresentFlag : 0, 0, nullptr, nullptr, nullptr);
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::PresentWithDirtyRects(
+        uint32_t dirtyRectsCount,
+        Rect* dirtyRects)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (dirtyRectsCount)
+                    CheckInPointer(dirtyRects);
+
+                auto lock = GetResourceLock();
+                PresentImpl(lock, 1, 0, dirtyRectsCount, dirtyRects, nullptr, nullptr);
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::PresentWithDirtyRectsAndScroll(
+        uint32_t dirtyRectsCount,
+        Rect* dirtyRects,
+        Rect scrollRect,
+        Vector2 scrollOffset)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (dirtyRectsCount)
+                    CheckInPointer(dirtyRects);
+
+                auto lock = GetResourceLock();
+                PresentImpl(lock, 1, 0, dirtyRectsCount, dirtyRects, &scrollRect, &scrollOffset);
+            });
+    }
+
+    void CanvasSwapChain::PresentWithOptions(bool allowTearing, std::vector<Rect> const& dirtyRects)
+    {
+        auto lock = GetResourceLock();
+
+        int32_t syncInterval = allowTearing ? 0 : 1;
+        UINT presentFlags = (allowTearing && m_isTearingAllowed) ? AllowTearingPresentFlag : 0;
+
+        PresentImpl(
+            lock,
+            syncInterval,
+            presentFlags,
+            static_cast<uint32_t>(dirtyRects.size()),
+            dirtyRects.empty() ? nullptr : dirtyRects.data(),
+            nullptr,
+            nullptr);
+    }
+
+    bool CanvasSwapChain::TryGetFrameStatistics(DXGI_FRAME_STATISTICS* statistics)
+    {
+        auto lock = GetResourceLock();
+
+        return SUCCEEDED(GetResource()->GetFrameStatistics(statistics));
+    }
+
+    bool CanvasSwapChain::IsOccluded()
+    {
+        auto lock = GetResourceLock();
+
+        DXGI_PRESENT_PARAMETERS presentParameters = { 0 };
+
+        HRESULT hr = GetResource()->Present1(0, DXGI_PRESENT_TEST, &presentParameters);
+        ThrowIfFailed(hr);
+
+        m_wasLastPresentOccluded = (hr == DXGI_STATUS_OCCLUDED);
+
+        return m_wasLastPresentOccluded;
+    }
+
+    bool CanvasSwapChain::CanWaitForVerticalBlank()
+    {
+        auto& device = m_device.EnsureNotClosed();
+
+        return As<ICanvasDeviceInternal>(device)->GetPrimaryDisplayOutput() != nullptr;
+    }
+
+    void CanvasSwapChain::PresentImpl(
+        D2DResourceLock const& lock,
+        int32_t syncInterval,
+        UINT presentFlags,
+        uint32_t dirtyRectsCount,
+        Rect const* dirtyRects,
+        Rect const* scrollRect,
+        Vector2 const* scrollOffset)
+    {
+        auto& resource = GetResource();
 
-                DXGI_PRESENT_PARAMETERS presentParameters = { 0 };
-                ThrowIfFailed(resource->Present1(syncInterval, 0, &presentParameters));
+        DXGI_PRESENT_PARAMETERS presentParameters = { 0 };
+
+        std::vector<RECT> dxgiDirtyRects;
+        RECT dxgiScrollRect;
+        POINT dxgiScrollOffset;
+
+        bool hasDirtyRegions = dirtyRectsCount || scrollRect;
+
+        if (hasDirtyRegions && m_hasPresentedSinceResize)
+        {
+            auto desc = GetSwapChainDesc(lock);
+
+            dxgiDirtyRects.reserve(dirtyRectsCount);
+
+            for (uint32_t i = 0; i < dirtyRectsCount; i++)
+            {
+                auto rect = ClipRECT(ToOutwardRECT(dirtyRects[i], m_dpi), desc);
+
+                if (!IsEmptyRECT(rect))
+                    dxgiDirtyRects.push_back(rect);
+            }
+
+            presentParameters.DirtyRectsCount = static_cast<UINT>(dxgiDirtyRects.size());
+            presentParameters.pDirtyRects = dxgiDirtyRects.empty() ? nullptr : dxgiDirtyRects.data();
+
+            if (scrollRect)
+            {
+                dxgiScrollRect = ClipRECT(ToOutwardRECT(*scrollRect, m_dpi), desc);
+
+                dxgiScrollOffset = POINT
+                {
+                    DipsToPixels(scrollOffset->X, m_dpi, CanvasDpiRounding::Round),
+                    DipsToPixels(scrollOffset->Y, m_dpi, CanvasDpiRounding::Round)
+                };
+
+                if (!IsEmptyRECT(dxgiScrollRect))
+                {
+                    presentParameters.pScrollRect = &dxgiScrollRect;
+                    presentParameters.pScrollOffset = &dxgiScrollOffset;
+                }
+            }
+
+            // If everything was clipped away nothing has changed, but an empty
+            // DXGI_PRESENT_PARAMETERS would mean that everything had, so we
+            // mark a single pixel as dirty instead.
+            if (!presentParameters.DirtyRectsCount && !presentParameters.pScrollRect &&
+                desc.Width && desc.Height)
+            {
+                dxgiDirtyRects.push_back(RECT{ 0, 0, 1, 1 });
+                presentParameters.DirtyRectsCount = 1;
+                presentParameters.pDirtyRects = dxgiDirtyRects.data();
+            }
+        }
+
+        HRESULT hr = resource->Present1(syncInterval, presentFlags, &presentParameters);
+        ThrowIfFailed(hr);
+
+        // An occluded present is thrown away, so it doesn't count as having
+        // filled the buffers.
+        m_wasLastPresentOccluded = (hr == DXGI_STATUS_OCCLUDED);
+
+        if (!m_wasLastPresentOccluded)
+            m_hasPresentedSinceResize = true;
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::get_IsTearingAllowed(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // Fails if the swap chain has been closed.
+
+                *value = m_isTearingAllowed;
             });
     }
 
@@ -524,6 +834,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
     
+    UINT CanvasSwapChain::GetSwapChainFlags() const
+    {
+        // ResizeBuffers must be passed the flags the swap chain was created with.
+        UINT flags = 0;
+
+        if (IsFrameLatencyWaitable())
+            flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+        if (m_isTearingAllowed)
+            flags |= AllowTearingSwapChainFlag;
+
+        return flags;
+    }
+
     void CanvasSwapChain::ResizeBuffersImpl(
         D2DResourceLock const& lock,
         float newWidth,
@@ -532,11 +856,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         DirectXPixelFormat newFormat,
         int32_t bufferCount)
     {            
+        ResizeBuffersInPixelsImpl(
+            lock,
+            SizeDipsToPixels(newWidth, newDpi),
+            SizeDipsToPixels(newHeight, newDpi),
+            newDpi,
+            newFormat,
+            bufferCount);
+    }
+
+    void CanvasSwapChain::ResizeBuffersInPixelsImpl(
+        D2DResourceLock const& lock,
+        int widthInPixels,
+        int heightInPixels,
+        float newDpi,
+        DirectXPixelFormat newFormat,
+        int32_t bufferCount)
+    {
         auto swapChain = As<IDXGISwapChain2>(GetResource());
 
-        int widthInPixels = SizeDipsToPixels(newWidth, newDpi);
-        int heightInPixels = SizeDipsToPixels(newHeight, newDpi);
-        
         ThrowIfNegative(bufferCount);
         ThrowIfNegative(widthInPixels);
         ThrowIfNegative(heightInPixels);
@@ -546,7 +884,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             widthInPixels,
             heightInPixels,
             static_cast<DXGI_FORMAT>(newFormat), 
-            0));
+            GetSwapChainFlags()));
+
+        m_hasPresentedSinceResize = false;
 
         if (m_isCoreWindowSwapChain)
         {
@@ -562,6 +902,53 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
     }
 
+    static uint32_t GetOverallocatedLength(uint32_t length, uint32_t maximumLength)
+    {
+        return std::max(length, std::min(length + length / 4, maximumLength));
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::ResizeBuffersAllowingOverallocation(
+        float newWidth,
+        float newHeight,
+        float newDpi)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto lock = GetResourceLock();
+                auto desc = GetSwapChainDesc(lock);
+
+                int widthInPixels = SizeDipsToPixels(newWidth, newDpi);
+                int heightInPixels = SizeDipsToPixels(newHeight, newDpi);
+
+                // DXGI can't show an empty part of a swap chain.
+                if (widthInPixels <= 0 || heightInPixels <= 0)
+                    ThrowHR(E_INVALIDARG);
+
+                auto width = static_cast<uint32_t>(widthInPixels);
+                auto height = static_cast<uint32_t>(heightInPixels);
+
+                bool fits = (width <= desc.Width) && (height <= desc.Height);
+                bool isMostlyUnused = (width * 2 < desc.Width) && (height * 2 < desc.Height);
+
+                if (newDpi != m_dpi || !fits || isMostlyUnused)
+                {
+                    int32_t maximumSize;
+                    ThrowIfFailed(m_device.EnsureNotClosed()->get_MaximumBitmapSizeInPixels(&maximumSize));
+
+                    ResizeBuffersInPixelsImpl(
+                        lock,
+                        static_cast<int>(GetOverallocatedLength(width, static_cast<uint32_t>(maximumSize))),
+                        static_cast<int>(GetOverallocatedLength(height, static_cast<uint32_t>(maximumSize))),
+                        newDpi,
+                        static_cast<DirectXPixelFormat>(desc.Format),
+                        desc.BufferCount);
+                }
+
+                ThrowIfFailed(As<IDXGISwapChain2>(GetResource())->SetSourceSize(width, height));
+            });
+    }
+
     // IClosable
 
     IFACEMETHODIMP CanvasSwapChain::Close()
@@ -571,6 +958,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             return hr;
 
         m_device.Close();
+        m_frameLatencyWaitableObject.Close();
         return S_OK;
     }
 
@@ -674,29 +1062,35 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {            
                 CheckAndClearOutPointer(drawingSession);
-                auto& dxgiSwapChain = GetResource();
-                auto& device = m_device.EnsureNotClosed();
-
-                if (*m_hasActiveDrawingSession)
-                    ThrowHR(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
-
-                auto d2dDevice = As<ICanvasDeviceInternal>(device)->GetD2DDevice();
-                D2DResourceLock lock(d2dDevice.Get());
 
-                ComPtr<ID2D1DeviceContext1> deviceContext;
-                auto adapter = CanvasSwapChainDrawingSessionAdapter::Create(
-                    device.Get(),
-                    dxgiSwapChain.Get(),
-                    ToD2DColor(clearColor),
-                    m_dpi,
-                    &deviceContext);
-                
-                auto newDrawingSession = CanvasDrawingSession::CreateNew(deviceContext.Get(), adapter, device.Get(), m_hasActiveDrawingSession);
+                auto newDrawingSession = CreateDrawingSessionWithDpiScale(clearColor, 1.0f);
 
                 ThrowIfFailed(newDrawingSession.CopyTo(drawingSession));
             });
     }
 
+    ComPtr<ICanvasDrawingSession> CanvasSwapChain::CreateDrawingSessionWithDpiScale(Color clearColor, float dpiScale)
+    {
+        auto& dxgiSwapChain = GetResource();
+        auto& device = m_device.EnsureNotClosed();
+
+        if (*m_hasActiveDrawingSession)
+            ThrowHR(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
+
+        auto d2dDevice = As<ICanvasDeviceInternal>(device)->GetD2DDevice();
+        D2DResourceLock lock(d2dDevice.Get());
+
+        ComPtr<ID2D1DeviceContext1> deviceContext;
+        auto adapter = CanvasSwapChainDrawingSessionAdapter::Create(
+            device.Get(),
+            dxgiSwapChain.Get(),
+            ToD2DColor(clearColor),
+            m_dpi * dpiScale,
+            &deviceContext);
+        
+        return CanvasDrawingSession::CreateNew(deviceContext.Get(), adapter, device.Get(), m_hasActiveDrawingSession);
+    }
+
     IFACEMETHODIMP CanvasSwapChain::WaitForVerticalBlank()
     {
         return ExceptionBoundary(
@@ -725,6 +1119,197 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasSwapChain::GetFrameStatistics(CanvasSwapChainFrameStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto lock = GetResourceLock();
+
+                DXGI_FRAME_STATISTICS statistics;
+                ThrowIfFailed(GetResource()->GetFrameStatistics(&statistics));
+
+                value->PresentCount = statistics.PresentCount;
+                value->PresentRefreshCount = statistics.PresentRefreshCount;
+                value->SyncRefreshCount = statistics.SyncRefreshCount;
+                value->SyncQpcTime = statistics.SyncQPCTime.QuadPart;
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::get_ColorSpace(CanvasSwapChainColorSpace* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // Fails if the swap chain has been closed.
+
+                *value = m_colorSpace;
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::put_ColorSpace(CanvasSwapChainColorSpace value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                SetColorSpace(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::IsColorSpaceSupported(
+        CanvasSwapChainColorSpace colorSpace,
+        boolean* isSupported)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(isSupported);
+
+                auto lock = GetResourceLock();
+
+                *isSupported = IsColorSpaceSupported(lock, colorSpace);
+            });
+    }
+
+    bool CanvasSwapChain::IsColorSpaceSupported(D2DResourceLock const&, CanvasSwapChainColorSpace colorSpace)
+    {
+        switch (colorSpace)
+        {
+        case CanvasSwapChainColorSpace::Srgb:
+        case CanvasSwapChainColorSpace::ScRgb:
+        case CanvasSwapChainColorSpace::Hdr10:
+            break;
+
+        default:
+            ThrowHR(E_INVALIDARG);
+        }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+        if (auto swapChain3 = MaybeAs<IDXGISwapChain3>(GetResource()))
+        {
+            UINT support = 0;
+            ThrowIfFailed(swapChain3->CheckColorSpaceSupport(ToDxgiColorSpace(colorSpace), &support));
+
+            return (support & DXGI_SWAP_CHAIN_COLOR_SPACE_SUPPORT_FLAG_PRESENT) != 0;
+        }
+#endif
+
+        // Swap chains that predate DXGI 1.4 can only be presented as sRGB.
+        return colorSpace == CanvasSwapChainColorSpace::Srgb;
+    }
+
+    void CanvasSwapChain::SetColorSpace(CanvasSwapChainColorSpace colorSpace)
+    {
+        auto lock = GetResourceLock();
+
+        if (!IsColorSpaceSupported(lock, colorSpace))
+            ThrowHR(E_INVALIDARG, Strings::SwapChainColorSpaceNotSupported);
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+        if (auto swapChain3 = MaybeAs<IDXGISwapChain3>(GetResource()))
+        {
+            ThrowIfFailed(swapChain3->SetColorSpace1(ToDxgiColorSpace(colorSpace)));
+        }
+#endif
+
+        m_colorSpace = colorSpace;
+    }
+
+    DirectXPixelFormat CanvasSwapChain::GetFormatForColorSpace(CanvasSwapChainColorSpace colorSpace)
+    {
+        switch (colorSpace)
+        {
+        case CanvasSwapChainColorSpace::Srgb:  return PIXEL_FORMAT(B8G8R8A8UIntNormalized);
+        case CanvasSwapChainColorSpace::ScRgb: return PIXEL_FORMAT(R16G16B16A16Float);
+        case CanvasSwapChainColorSpace::Hdr10: return PIXEL_FORMAT(R10G10B10A2UIntNormalized);
+        default:                               ThrowHR(E_INVALIDARG);
+        }
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+    // HDR10 metadata stores chromaticities in units of 0.00002.
+    static UINT16 ToHdr10Chromaticity(float value)
+    {
+        return static_cast<UINT16>(value * 50000.0f + 0.5f);
+    }
+
+    static UINT16 ToHdr10LightLevel(float nits)
+    {
+        return static_cast<UINT16>(std::min(nits, 65535.0f) + 0.5f);
+    }
+#endif
+
+    IFACEMETHODIMP CanvasSwapChain::SetHdrMetadata(
+        float maximumMasteringLuminance,
+        float minimumMasteringLuminance,
+        float maximumContentLightLevel,
+        float maximumFrameAverageLightLevel)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (!(maximumMasteringLuminance >= 0) ||
+                    !(minimumMasteringLuminance >= 0) ||
+                    !(maximumContentLightLevel >= 0) ||
+                    !(maximumFrameAverageLightLevel >= 0) ||
+                    minimumMasteringLuminance > maximumMasteringLuminance)
+                {
+                    ThrowHR(E_INVALIDARG);
+                }
+
+                auto lock = GetResourceLock();
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+                auto swapChain4 = MaybeAs<IDXGISwapChain4>(GetResource());
+
+                if (!swapChain4)
+                    ThrowHR(E_NOTIMPL);
+
+                // BT.2020 primaries, D65 white point.
+                DXGI_HDR_METADATA_HDR10 metadata{};
+
+                metadata.RedPrimary[0]   = ToHdr10Chromaticity(0.708f);
+                metadata.RedPrimary[1]   = ToHdr10Chromaticity(0.292f);
+                metadata.GreenPrimary[0] = ToHdr10Chromaticity(0.170f);
+                metadata.GreenPrimary[1] = ToHdr10Chromaticity(0.797f);
+                metadata.BluePrimary[0]  = ToHdr10Chromaticity(0.131f);
+                metadata.BluePrimary[1]  = ToHdr10Chromaticity(0.046f);
+                metadata.WhitePoint[0]   = ToHdr10Chromaticity(0.3127f);
+                metadata.WhitePoint[1]   = ToHdr10Chromaticity(0.3290f);
+
+                // Max is in whole nits, min in units of 0.0001 nits.
+                metadata.MaxMasteringLuminance = static_cast<UINT>(std::min(maximumMasteringLuminance, 4294967295.0f) + 0.5f);
+                metadata.MinMasteringLuminance = static_cast<UINT>(std::min(minimumMasteringLuminance * 10000.0f, 4294967295.0f) + 0.5f);
+
+                metadata.MaxContentLightLevel = ToHdr10LightLevel(maximumContentLightLevel);
+                metadata.MaxFrameAverageLightLevel = ToHdr10LightLevel(maximumFrameAverageLightLevel);
+
+                ThrowIfFailed(swapChain4->SetHDRMetaData(DXGI_HDR_METADATA_TYPE_HDR10, sizeof(metadata), &metadata));
+#else
+                ThrowHR(E_NOTIMPL);
+#endif
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::ClearHdrMetadata()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto lock = GetResourceLock();
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+                if (auto swapChain4 = MaybeAs<IDXGISwapChain4>(GetResource()))
+                {
+                    ThrowIfFailed(swapChain4->SetHDRMetaData(DXGI_HDR_METADATA_TYPE_NONE, 0, nullptr));
+                }
+#endif
+            });
+    }
+
     ComPtr<CanvasSwapChain> CanvasSwapChain::CreateNew(
         ICanvasDevice* device,
         float width,
@@ -758,6 +1343,87 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return canvasSwapChain;
     }
 
+    ComPtr<CanvasSwapChain> CanvasSwapChain::CreateNew(
+        ICanvasDevice* device,
+        float width,
+        float height,
+        float dpi,
+        DirectXPixelFormat format,
+        int32_t bufferCount,
+        CanvasAlphaMode alphaMode,
+        uint32_t maximumFrameLatency,
+        bool allowTearing)
+    {
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+
+        // Creating a swap chain with a flag that DXGI doesn't support fails,
+        // so we quietly fall back to a swap chain that doesn't tear.
+        allowTearing = allowTearing && deviceInternal->IsTearingSupported();
+
+        UINT flags = 0;
+
+        if (maximumFrameLatency)
+            flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+        if (allowTearing)
+            flags |= AllowTearingSwapChainFlag;
+
+        ComPtr<IDXGISwapChain1> dxgiSwapChain = deviceInternal->CreateSwapChainForCompositionWithFlags(
+            SizeDipsToPixels(width, dpi),
+            SizeDipsToPixels(height, dpi),
+            format,
+            bufferCount,
+            alphaMode,
+            flags);
+
+        auto canvasSwapChain = Make<CanvasSwapChain>(
+            device,
+            dxgiSwapChain.Get(),
+            dpi,
+            false);
+        CheckMakeResult(canvasSwapChain);
+
+        ThrowIfFailed(canvasSwapChain->put_TransformMatrix(Matrix3x2{ 1, 0, 0, 1, 0, 0 }));
+
+        canvasSwapChain->m_isTearingAllowed = allowTearing;
+
+        if (maximumFrameLatency)
+        {
+            auto swapChain2 = As<IDXGISwapChain2>(dxgiSwapChain);
+
+            canvasSwapChain->m_frameLatencyWaitableObject.Attach(swapChain2->GetFrameLatencyWaitableObject());
+            canvasSwapChain->SetMaximumFrameLatency(maximumFrameLatency);
+        }
+
+        return canvasSwapChain;
+    }
+
+    void CanvasSwapChain::SetMaximumFrameLatency(uint32_t maximumFrameLatency)
+    {
+        assert(IsFrameLatencyWaitable());
+
+        auto swapChain = As<IDXGISwapChain2>(GetResource());
+        ThrowIfFailed(swapChain->SetMaximumFrameLatency(maximumFrameLatency));
+
+        m_maximumFrameLatency = maximumFrameLatency;
+    }
+
+    void CanvasSwapChain::WaitForFrameLatencyWaitableObject()
+    {
+        assert(IsFrameLatencyWaitable());
+
+        //
+        // The object is signaled once each presented frame has been
+        // consumed, so this normally returns within a frame.  The timeout
+        // stops us from hanging if the GPU stops presenting, eg. because the
+        // device has been lost; Present will report that.
+        //
+        auto result = WaitForSingleObjectEx(m_frameLatencyWaitableObject.Get(), 1000, TRUE);
+
+        if (result == WAIT_FAILED)
+            ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
     ComPtr<CanvasSwapChain> CanvasSwapChain::CreateNew(
         ICanvasDevice* device,
         ICoreWindow* coreWindow,
@@ -71,6 +71,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             DirectXPixelFormat format,
             int32_t bufferCount,
             ICanvasSwapChain** swapChain);
+
+        IFACEMETHOD(IsTearingSupported)(
+            ICanvasDevice* device,
+            boolean* isSupported);
+
+        IFACEMETHOD(CreateAllowingTearing)(
+            ICanvasResourceCreator* resourceCreator,
+            float width,
+            float height,
+            float dpi,
+            DirectXPixelFormat format,
+            int32_t bufferCount,
+            CanvasAlphaMode alphaMode,
+            ICanvasSwapChain** swapChain);
+
+        IFACEMETHOD(CreateWithColorSpace)(
+            ICanvasResourceCreator* resourceCreator,
+            float width,
+            float height,
+            float dpi,
+            CanvasSwapChainColorSpace colorSpace,
+            ICanvasSwapChain** swapChain);
     };
 
 
@@ -115,6 +137,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<CanvasSwapChainAdapter> m_adapter;
         std::shared_ptr<bool> m_hasActiveDrawingSession;
 
+        // Only set for swap chains created with a maximum frame latency.
+        Wrappers::Event m_frameLatencyWaitableObject;
+        uint32_t m_maximumFrameLatency;
+
+        // Only set for swap chains created with DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING.
+        bool m_isTearingAllowed;
+
+        // Dirty rects are only used once the buffers have been presented in full.
+        bool m_hasPresentedSinceResize;
+
+        // Set when DXGI discarded the last present because the swap chain
+        // can't currently be seen.
+        bool m_wasLastPresentOccluded;
+
+        // DXGI has no way to read the color space back, so we remember it.
+        CanvasSwapChainColorSpace m_colorSpace;
+
     public:
         static DirectXPixelFormat const DefaultPixelFormat = PIXEL_FORMAT(B8G8R8A8UIntNormalized);
         static int32_t const DefaultBufferCount = 2;
@@ -130,6 +169,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int32_t bufferCount,
             CanvasAlphaMode alphaMode);
 
+        //
+        // Creates a composition swap chain that, if maximumFrameLatency is
+        // non-zero, has a frame latency waitable object, so that callers can
+        // block until the swap chain is ready for the next frame rather than
+        // blocking in Present.  If allowTearing is set, and the device
+        // supports it, the swap chain allows tearing.
+        //
+        static ComPtr<CanvasSwapChain> CreateNew(
+            ICanvasDevice* device,
+            float width,
+            float height,
+            float dpi,
+            DirectXPixelFormat format,
+            int32_t bufferCount,
+            CanvasAlphaMode alphaMode,
+            uint32_t maximumFrameLatency,
+            bool allowTearing);
+
         static ComPtr<CanvasSwapChain> CreateNew(
             ICanvasDevice* device,
             ICoreWindow* coreWindow,
@@ -182,6 +239,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         IFACEMETHOD(Present)() override;
         IFACEMETHOD(PresentWithSyncInterval)(int32_t syncInterval) override;
+        IFACEMETHOD(PresentAllowingTearing)() override;
+
+        IFACEMETHOD(get_IsTearingAllowed)(boolean* value) override;
+
+        IFACEMETHOD(PresentWithDirtyRects)(
+            uint32_t dirtyRectsCount,
+            Rect* dirtyRects) override;
+
+        IFACEMETHOD(PresentWithDirtyRectsAndScroll)(
+            uint32_t dirtyRectsCount,
+            Rect* dirtyRects,
+            Rect scrollRect,
+            Vector2 scrollOffset) override;
 
         IFACEMETHOD(ResizeBuffersWithSize)(
             Size newSize) override;
@@ -204,9 +274,74 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         IFACEMETHOD(WaitForVerticalBlank)() override;
 
+        IFACEMETHOD(GetFrameStatistics)(CanvasSwapChainFrameStatistics* value) override;
+
+        IFACEMETHOD(get_ColorSpace)(CanvasSwapChainColorSpace* value) override;
+        IFACEMETHOD(put_ColorSpace)(CanvasSwapChainColorSpace value) override;
+
+        IFACEMETHOD(IsColorSpaceSupported)(
+            CanvasSwapChainColorSpace colorSpace,
+            boolean* isSupported) override;
+
+        IFACEMETHOD(SetHdrMetadata)(
+            float maximumMasteringLuminance,
+            float minimumMasteringLuminance,
+            float maximumContentLightLevel,
+            float maximumFrameAverageLightLevel) override;
+
+        IFACEMETHOD(ClearHdrMetadata)() override;
+
+        IFACEMETHOD(ResizeBuffersAllowingOverallocation)(
+            float newWidth,
+            float newHeight,
+            float newDpi) override;
+
         // IClosable
         IFACEMETHOD(Close)() override;
 
+        //
+        // These are only valid on swap chains that were created with a
+        // maximum frame latency, and are not exception boundaries.
+        //
+        bool IsFrameLatencyWaitable() const { return m_frameLatencyWaitableObject.IsValid(); }
+        uint32_t GetMaximumFrameLatency() const { return m_maximumFrameLatency; }
+        void SetMaximumFrameLatency(uint32_t maximumFrameLatency);
+
+        // Blocks until the swap chain is ready to accept another frame.
+        void WaitForFrameLatencyWaitableObject();
+
+        bool IsTearingAllowed() const { return m_isTearingAllowed; }
+
+        // Presents as Present or, if allowTearing is set, as
+        // PresentAllowingTearing does, with optional dirty rects in DIPs.
+        void PresentWithOptions(bool allowTearing, std::vector<Rect> const& dirtyRects);
+
+        // Returns false if DXGI has no statistics for this swap chain, eg.
+        // before its first present or after it moves between displays.
+        bool TryGetFrameStatistics(DXGI_FRAME_STATISTICS* statistics);
+
+        // Whether the last present returned DXGI_STATUS_OCCLUDED.
+        bool WasLastPresentOccluded() const { return m_wasLastPresentOccluded; }
+
+        // Asks DXGI, with a test present that doesn't show anything, whether
+        // the swap chain is still occluded.
+        bool IsOccluded();
+
+        // WaitForVerticalBlank only yields on devices that have no display
+        // output, such as explicitly requested software devices.
+        bool CanWaitForVerticalBlank();
+
+        // As CreateDrawingSession, with DIPs mapped to dpiScale times as many
+        // pixels, for drawing into a SourceSize that is that fraction of the
+        // swap chain's size.
+        ComPtr<ICanvasDrawingSession> CreateDrawingSessionWithDpiScale(Color clearColor, float dpiScale);
+
+        // The format that CreateWithColorSpace gives swap chains in this color space.
+        static DirectXPixelFormat GetFormatForColorSpace(CanvasSwapChainColorSpace colorSpace);
+
+        // Not an exception boundary.
+        void SetColorSpace(CanvasSwapChainColorSpace colorSpace);
+
     private:
         D2DResourceLock GetResourceLock();
 
@@ -221,6 +356,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ComPtr<IDXGISwapChain2> const& resource, 
             DXGI_MATRIX_3X2_F* transform);
 
+        UINT GetSwapChainFlags() const;
+
+        bool IsColorSpaceSupported(D2DResourceLock const& lock, CanvasSwapChainColorSpace colorSpace);
+
+        void PresentImpl(
+            D2DResourceLock const& lock,
+            int32_t syncInterval,
+            UINT presentFlags,
+            uint32_t dirtyRectsCount,
+            Rect const* dirtyRects,
+            Rect const* scrollRect,
+            Vector2 const* scrollOffset);
+
         void ResizeBuffersImpl(
             D2DResourceLock const& lock,
             float newWidth,
@@ -228,6 +376,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             float newDpi,
             DirectXPixelFormat newFormat,
             int32_t bufferCount);
+
+        void ResizeBuffersInPixelsImpl(
+            D2DResourceLock const& lock,
+            int widthInPixels,
+            int heightInPixels,
+            float newDpi,
+            DirectXPixelFormat newFormat,
+            int32_t bufferCount);
     };
 
 }}}}
@@ -10,23 +10,83 @@
 //
 // DeviceContextPool implementation
 //
+// Leases are handed out from three places, cheapest first:
+//
+//  1. The slot belonging to the calling thread (a single atomic exchange).
+//  2. The shared overflow list, protected by m_mutex.
+//  3. A newly created device context.
+//
+// m_pooledCount tracks how many contexts are held across the slots and the
+// overflow list, so the total size of the pool remains bounded by
+// m_maxPoolSize no matter how the contexts are distributed.
+//
+
+
+static uint32_t GetDefaultMaxPoolSize()
+{
+    //
+    // Max pool size is picked from number of CPUs - reasoning being that you
+    // should expect to be able to have that many threads running and reusing
+    // contexts without recreating them.
+    //
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
 
 
 DeviceContextPool::DeviceContextPool(ID2D1Device1* d2dDevice)
     : m_d2dDevice(d2dDevice)
+    , m_isClosed(false)
+    , m_maxPoolSize(GetDefaultMaxPoolSize())
+    , m_pooledCount(0)
+    , m_threadSlotCount(m_maxPoolSize)
+    , m_threadSlots(new ThreadSlot[m_threadSlotCount])
+    , m_threadSlotHits(0)
+    , m_overflowHits(0)
+    , m_creations(0)
+{
+}
+
+
+DeviceContextPool::~DeviceContextPool()
 {
+    DrainThreadSlots();
 }
 
 
 DeviceContextLease DeviceContextPool::TakeLease()
 {
+    if (m_isClosed)
+        ThrowHR(RO_E_CLOSED);
+
+    //
+    // Fast path: reuse the context parked in this thread's slot.
+    //
+    auto& slot = GetCurrentThreadSlot();
+
+    if (auto rawDeviceContext = slot.DeviceContext.exchange(nullptr))
+    {
+        --m_pooledCount;
+        ++m_threadSlotHits;
+        PerformanceCounters::Increment(PerformanceCounter::DeviceContextsReused);
+
+        ComPtr<ID2D1DeviceContext1> deviceContext;
+        deviceContext.Attach(rawDeviceContext);
+        return DeviceContextLease(this, std::move(deviceContext));
+    }
+
+    //
+    // Slow path: take one from the overflow list, or create a new one.
+    //
     Lock lock(m_mutex);
 
     if (!m_d2dDevice)
         ThrowHR(RO_E_CLOSED);
-    
+
     if (m_deviceContexts.empty())
     {
+        ++m_creations;
+        PerformanceCounters::Increment(PerformanceCounter::DeviceContextsCreated);
+
         ComPtr<ID2D1DeviceContext1> deviceContext;
         ThrowIfFailed(m_d2dDevice->CreateDeviceContext(
             D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
@@ -35,6 +95,10 @@ DeviceContextLease DeviceContextPool::TakeLease()
     }
     else
     {
+        --m_pooledCount;
+        ++m_overflowHits;
+        PerformanceCounters::Increment(PerformanceCounter::DeviceContextsReused);
+
         DeviceContextLease newLease(this, std::move(m_deviceContexts.back()));
         m_deviceContexts.pop_back();
         return newLease;
@@ -46,13 +110,11 @@ void DeviceContextPool::ReturnLease(ComPtr<ID2D1DeviceContext1>&& deviceContext)
 {
     if (!deviceContext)
         return;
-        
-    Lock lock(m_mutex);
 
     //
     // If the pool has been closed we just discard the context
     //
-    if (!m_d2dDevice)
+    if (m_isClosed)
         return;
 
     //
@@ -61,21 +123,176 @@ void DeviceContextPool::ReturnLease(ComPtr<ID2D1DeviceContext1>&& deviceContext)
     // destroyed.  This is to give the pool a chance to shrink back down to a
     // reasonable size if there is ever any large scale concurrency going on.
     //
-    // Max pool size is picked from number of CPUs - reasoning being that you
-    // should expect to be able to have that many threads running and reusing
-    // contexts without recreating them.
+    if (m_pooledCount.fetch_add(1) >= m_maxPoolSize)
+    {
+        --m_pooledCount;
+        return;
+    }
+
+    //
+    // Prefer parking the context in this thread's slot, so the next lease
+    // taken on this thread doesn't need the lock.
     //
-    static auto maxPoolSize = std::max(std::thread::hardware_concurrency(), 1U);
+    auto& slot = GetCurrentThreadSlot();
 
-    if (m_deviceContexts.size() < maxPoolSize)
-        m_deviceContexts.emplace_back(std::move(deviceContext));
+    ID2D1DeviceContext1* expected = nullptr;
+    if (slot.DeviceContext.compare_exchange_strong(expected, deviceContext.Get()))
+    {
+        deviceContext.Detach();
+
+        //
+        // Close() may have drained the slots between our check above and
+        // the exchange.  If so, take the context back out again; whichever
+        // of us wins the exchange is responsible for releasing it.
+        //
+        if (m_isClosed)
+        {
+            if (auto rawDeviceContext = slot.DeviceContext.exchange(nullptr))
+            {
+                --m_pooledCount;
+                rawDeviceContext->Release();
+            }
+        }
+
+        return;
+    }
+
+    Lock lock(m_mutex);
+
+    if (!m_d2dDevice)
+    {
+        --m_pooledCount;
+        return;
+    }
+
+    m_deviceContexts.emplace_back(std::move(deviceContext));
 }
 
 
 void DeviceContextPool::Close()
 {
+    m_isClosed = true;
+
+    DrainThreadSlots();
+
     Lock lock(m_mutex);
 
+    m_pooledCount -= static_cast<uint32_t>(m_deviceContexts.size());
     m_deviceContexts.clear();
     m_d2dDevice = nullptr;
 }
+
+
+void DeviceContextPool::Prewarm(uint32_t count)
+{
+    Lock lock(m_mutex);
+
+    if (!m_d2dDevice)
+        ThrowHR(RO_E_CLOSED);
+
+    count = std::min(count, m_maxPoolSize.load());
+
+    while (m_pooledCount < count)
+    {
+        ComPtr<ID2D1DeviceContext1> deviceContext;
+        ThrowIfFailed(m_d2dDevice->CreateDeviceContext(
+            D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
+            &deviceContext));
+
+        ++m_creations;
+        ++m_pooledCount;
+        PerformanceCounters::Increment(PerformanceCounter::DeviceContextsCreated);
+        m_deviceContexts.emplace_back(std::move(deviceContext));
+    }
+}
+
+
+void DeviceContextPool::Trim()
+{
+    if (m_isClosed)
+        ThrowHR(RO_E_CLOSED);
+
+    TrimTo(0);
+}
+
+
+uint32_t DeviceContextPool::GetMaxPoolSize() const
+{
+    if (m_isClosed)
+        ThrowHR(RO_E_CLOSED);
+
+    return m_maxPoolSize;
+}
+
+
+void DeviceContextPool::SetMaxPoolSize(uint32_t value)
+{
+    if (m_isClosed)
+        ThrowHR(RO_E_CLOSED);
+
+    m_maxPoolSize = value;
+
+    TrimTo(value);
+}
+
+
+void DeviceContextPool::TrimTo(uint32_t maxPooledCount)
+{
+    //
+    // Contexts in the overflow list are discarded first, since those are the
+    // ones least likely to be reused by the thread that returned them.
+    //
+    {
+        Lock lock(m_mutex);
+
+        while (!m_deviceContexts.empty() && m_pooledCount > maxPooledCount)
+        {
+            m_deviceContexts.pop_back();
+            --m_pooledCount;
+        }
+    }
+
+    for (size_t i = 0; i < m_threadSlotCount && m_pooledCount > maxPooledCount; ++i)
+    {
+        if (auto rawDeviceContext = m_threadSlots[i].DeviceContext.exchange(nullptr))
+        {
+            --m_pooledCount;
+            rawDeviceContext->Release();
+        }
+    }
+}
+
+
+DeviceContextPoolStatistics DeviceContextPool::GetStatistics() const
+{
+    DeviceContextPoolStatistics statistics;
+
+    statistics.ThreadSlotHits = m_threadSlotHits;
+    statistics.OverflowHits = m_overflowHits;
+    statistics.Creations = m_creations;
+
+    return statistics;
+}
+
+
+DeviceContextPool::ThreadSlot& DeviceContextPool::GetCurrentThreadSlot()
+{
+    //
+    // Threads that collide on the same slot still work correctly; they just
+    // end up falling back to the overflow list more often.
+    //
+    return m_threadSlots[GetCurrentThreadId() % m_threadSlotCount];
+}
+
+
+void DeviceContextPool::DrainThreadSlots()
+{
+    for (size_t i = 0; i < m_threadSlotCount; ++i)
+    {
+        if (auto rawDeviceContext = m_threadSlots[i].DeviceContext.exchange(nullptr))
+        {
+            --m_pooledCount;
+            rawDeviceContext->Release();
+        }
+    }
+}
@@ -11,16 +11,54 @@ using namespace ABI::Microsoft::Graphics::Canvas;
 
 class DeviceContextLease;
 
+struct DeviceContextPoolStatistics
+{
+    uint64_t ThreadSlotHits;    // leases satisfied lock-free from a per-thread slot
+    uint64_t OverflowHits;      // leases satisfied from the shared (locked) overflow list
+    uint64_t Creations;         // leases that required a new device context
+};
+
 class DeviceContextPool
 {
+    //
+    // Each thread hashes to one of these slots.  A lease taken and returned
+    // on the same thread is normally satisfied by a single atomic exchange,
+    // so concurrent threads sharing one device don't contend on m_mutex.
+    // Slots are padded out to a cache line to avoid false sharing.
+    //
+    struct ThreadSlot
+    {
+        std::atomic<ID2D1DeviceContext1*> DeviceContext;
+        char Padding[64 - sizeof(std::atomic<ID2D1DeviceContext1*>)];
+
+        ThreadSlot()
+            : DeviceContext(nullptr)
+        {
+        }
+    };
+
     ID2D1Device1* m_d2dDevice;
 
+    std::atomic<bool> m_isClosed;
+
+    std::atomic<uint32_t> m_maxPoolSize;
+    std::atomic<uint32_t> m_pooledCount;
+
+    size_t const m_threadSlotCount;
+    std::unique_ptr<ThreadSlot[]> m_threadSlots;
+
     std::mutex m_mutex;
     std::vector<ComPtr<ID2D1DeviceContext1>> m_deviceContexts;
+
+    std::atomic<uint64_t> m_threadSlotHits;
+    std::atomic<uint64_t> m_overflowHits;
+    std::atomic<uint64_t> m_creations;
     
 public:
     DeviceContextPool(ID2D1Device1* d2dDevice);
 
+    ~DeviceContextPool();
+
     DeviceContextPool(DeviceContextPool const&) = delete;
     DeviceContextPool& operator=(DeviceContextPool const&) = delete;
 
@@ -28,13 +66,37 @@ public:
 
     void Close();
 
+    // Creates device contexts up front, so the first leases don't pay the
+    // creation cost.  The pool is never filled beyond its maximum size.
+    void Prewarm(uint32_t count);
+
+    // Releases all idle device contexts.  Outstanding leases are unaffected.
+    void Trim();
+
+    uint32_t GetMaxPoolSize() const;
+    void SetMaxPoolSize(uint32_t value);
+
+    DeviceContextPoolStatistics GetStatistics() const;
+
 private:
     void ReturnLease(ComPtr<ID2D1DeviceContext1>&& deviceContext);
 
+    ThreadSlot& GetCurrentThreadSlot();
+    void DrainThreadSlots();
+    void TrimTo(uint32_t maxPooledCount);
+
     friend class DeviceContextLease;
 };
 
 
+//
+// A device context borrowed from a DeviceContextPool, and handed back to it
+// when the lease is destroyed.  The pool hands contexts out again as they
+// are, so anyone who sets a target, transform, DPI or other state on a
+// leased context must put it back the way it was found before the lease
+// goes.
+//
+
 class DeviceContextLease
 {
     DeviceContextPool* m_owner;
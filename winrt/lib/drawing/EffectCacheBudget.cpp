@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "EffectCacheBudget.h"
+
+
+EffectCacheBudget::EffectCacheBudget(uint64_t maximumSize)
+    : m_maximumSize(maximumSize)
+    , m_currentSize(0)
+    , m_clock(0)
+{
+}
+
+
+bool EffectCacheBudget::TryAdmit(std::shared_ptr<EffectCacheEntry> const& entry, uint64_t estimatedSize)
+{
+    Lock lock(m_mutex);
+
+    RemoveExpiredEntries();
+
+    entry->LastUsed = ++m_clock;
+
+    if (FindEntry(entry.get()) != m_cachedEntries.end())
+        return true;
+
+    //
+    // Only evict anything if doing so actually makes enough room; otherwise
+    // we would throw away other cached outputs and still not be able to
+    // cache this one.
+    //
+    bool fits = estimatedSize <= m_maximumSize &&
+                m_currentSize - GetEvictableSize(entry->Priority) <= m_maximumSize - estimatedSize;
+
+    if (fits)
+    {
+        EvictUntil(m_maximumSize - estimatedSize, entry->Priority);
+
+        m_cachedEntries.push_back(CachedEntry{ entry, estimatedSize });
+        m_currentSize += estimatedSize;
+    }
+
+    SetCached(entry.get(), fits);
+
+    return fits;
+}
+
+
+void EffectCacheBudget::Touch(EffectCacheEntry* entry)
+{
+    Lock lock(m_mutex);
+
+    entry->LastUsed = ++m_clock;
+}
+
+
+void EffectCacheBudget::Release(EffectCacheEntry* entry)
+{
+    Lock lock(m_mutex);
+
+    auto it = FindEntry(entry);
+
+    if (it != m_cachedEntries.end())
+    {
+        m_currentSize -= it->EstimatedSize;
+        m_cachedEntries.erase(it);
+    }
+
+    SetCached(entry, false);
+}
+
+
+void EffectCacheBudget::SetPriority(EffectCacheEntry* entry, EffectCachePriority priority)
+{
+    Lock lock(m_mutex);
+
+    entry->Priority = priority;
+}
+
+
+uint64_t EffectCacheBudget::GetMaximumSize()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumSize;
+}
+
+
+void EffectCacheBudget::SetMaximumSize(uint64_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumSize = value;
+
+    RemoveExpiredEntries();
+    EvictUntil(m_maximumSize, AnyPriority);
+}
+
+
+uint64_t EffectCacheBudget::GetCurrentSize()
+{
+    Lock lock(m_mutex);
+
+    RemoveExpiredEntries();
+
+    return m_currentSize;
+}
+
+
+void EffectCacheBudget::RemoveExpiredEntries()
+{
+    auto newEnd = std::remove_if(m_cachedEntries.begin(), m_cachedEntries.end(),
+        [&](CachedEntry const& cachedEntry)
+        {
+            if (!cachedEntry.Entry.expired())
+                return false;
+
+            m_currentSize -= cachedEntry.EstimatedSize;
+            return true;
+        });
+
+    m_cachedEntries.erase(newEnd, m_cachedEntries.end());
+}
+
+
+uint64_t EffectCacheBudget::GetEvictableSize(EffectCachePriority belowPriority)
+{
+    uint64_t size = 0;
+
+    for (auto& cachedEntry : m_cachedEntries)
+    {
+        auto entry = cachedEntry.Entry.lock();
+
+        if (entry && entry->Priority < belowPriority)
+            size += cachedEntry.EstimatedSize;
+    }
+
+    return size;
+}
+
+
+void EffectCacheBudget::EvictUntil(uint64_t targetSize, EffectCachePriority belowPriority)
+{
+    while (m_currentSize > targetSize)
+    {
+        //
+        // Pick the least recently used entry out of the lowest priority ones.
+        //
+        auto victim = m_cachedEntries.end();
+        std::shared_ptr<EffectCacheEntry> victimEntry;
+
+        for (auto it = m_cachedEntries.begin(); it != m_cachedEntries.end(); ++it)
+        {
+            auto entry = it->Entry.lock();
+
+            if (!entry || entry->Priority >= belowPriority)
+                continue;
+
+            if (!victimEntry ||
+                entry->Priority < victimEntry->Priority ||
+                (entry->Priority == victimEntry->Priority && entry->LastUsed < victimEntry->LastUsed))
+            {
+                victim = it;
+                victimEntry = std::move(entry);
+            }
+        }
+
+        if (!victimEntry)
+            return;
+
+        m_currentSize -= victim->EstimatedSize;
+        m_cachedEntries.erase(victim);
+
+        SetCached(victimEntry.get(), false);
+    }
+}
+
+
+std::vector<EffectCacheBudget::CachedEntry>::iterator EffectCacheBudget::FindEntry(EffectCacheEntry* entry)
+{
+    return std::find_if(m_cachedEntries.begin(), m_cachedEntries.end(),
+        [=](CachedEntry const& cachedEntry)
+        {
+            return cachedEntry.Entry.lock().get() == entry;
+        });
+}
+
+
+void EffectCacheBudget::SetCached(EffectCacheEntry* entry, bool value)
+{
+    entry->IsCached = value;
+
+    ThrowIfFailed(entry->Effect->SetValue(D2D1_PROPERTY_CACHED, static_cast<BOOL>(value)));
+}
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+using namespace ABI::Microsoft::Graphics::Canvas::Effects;
+
+//
+// Shared between a CanvasEffect whose CacheOutput is enabled and the
+// EffectCacheBudget of the device that it is realized on.  The effect owns
+// the entry, while the budget only holds a weak reference, so an entry that
+// is destroyed without being released simply drops out of the budget.
+//
+// Priority and LastUsed are protected by the budget's mutex.
+//
+struct EffectCacheEntry
+{
+    ComPtr<ID2D1Effect> Effect;
+    EffectCachePriority Priority;
+    uint64_t LastUsed;
+    std::atomic<bool> IsCached;     // Whether the budget is currently letting D2D cache this output.
+
+    EffectCacheEntry(ID2D1Effect* effect, EffectCachePriority priority)
+        : Effect(effect)
+        , Priority(priority)
+        , LastUsed(0)
+        , IsCached(false)
+    {
+    }
+};
+
+
+//
+// Bounds how much memory D2D may spend on cached effect outputs for a single
+// device.  D2D has no way to report how big a cached intermediate actually
+// is, so each entry is charged an estimate supplied when it is admitted.
+//
+// When there is not enough room for a new entry, cached entries of strictly
+// lower priority are evicted (least recently used first) to make space.
+// Entries of equal priority never displace each other, which stops two
+// equally important effects that don't both fit from thrashing every frame.
+// An entry that can't be admitted is drawn without caching, and tries again
+// the next time it is drawn.
+//
+// Evicting an entry turns off D2D1_PROPERTY_CACHED on its effect.  The
+// budget never calls back into CanvasEffect, so it is safe to use while
+// holding an effect's lock.
+//
+class EffectCacheBudget
+{
+    // Passed as belowPriority to make every cached entry a candidate for eviction.
+    static EffectCachePriority const AnyPriority = static_cast<EffectCachePriority>(EffectCachePriority_High + 1);
+
+    struct CachedEntry
+    {
+        std::weak_ptr<EffectCacheEntry> Entry;
+        uint64_t EstimatedSize;
+    };
+
+    std::mutex m_mutex;
+
+    uint64_t m_maximumSize;
+    uint64_t m_currentSize;
+    uint64_t m_clock;
+
+    std::vector<CachedEntry> m_cachedEntries;
+
+public:
+    EffectCacheBudget(uint64_t maximumSize = std::numeric_limits<uint64_t>::max());
+
+    EffectCacheBudget(EffectCacheBudget const&) = delete;
+    EffectCacheBudget& operator=(EffectCacheBudget const&) = delete;
+
+    // Tries to fit the entry into the budget, turning D2D caching on or off
+    // to match.  Returns whether the entry's output is now being cached.
+    bool TryAdmit(std::shared_ptr<EffectCacheEntry> const& entry, uint64_t estimatedSize);
+
+    // Marks an already cached entry as used, so it is not the next to go.
+    void Touch(EffectCacheEntry* entry);
+
+    // Stops caching the entry's output and gives back its share of the budget.
+    void Release(EffectCacheEntry* entry);
+
+    void SetPriority(EffectCacheEntry* entry, EffectCachePriority priority);
+
+    uint64_t GetMaximumSize();
+    void SetMaximumSize(uint64_t value);
+
+    uint64_t GetCurrentSize();
+
+private:
+    void RemoveExpiredEntries();
+    uint64_t GetEvictableSize(EffectCachePriority belowPriority);
+    void EvictUntil(uint64_t targetSize, EffectCachePriority belowPriority);
+    std::vector<CachedEntry>::iterator FindEntry(EffectCacheEntry* entry);
+
+    static void SetCached(EffectCacheEntry* entry, bool value);
+};
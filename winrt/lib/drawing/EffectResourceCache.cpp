@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "EffectResourceCache.h"
+
+
+EffectResourceCache::EffectResourceCache(size_t maxEntries)
+    : m_clock(0)
+    , m_maxEntries(maxEntries)
+{
+}
+
+
+IID EffectResourceCache::MakeKey(IID const& resourceType, BYTE const* data, size_t dataSize, std::initializer_list<uint32_t> parameters)
+{
+    //
+    // Hash the (potentially large) source data, then hash the other
+    // parameters using that as the namespace. The data can be many megabytes
+    // for a big lookup table, so we deliberately don't keep a copy of it to
+    // compare against, and rely on the 128 bit hash to tell different data
+    // apart. The parameters are hashed straight out of the initializer list,
+    // so there is no limit on how many a caller can pass.
+    //
+    auto dataHash = ABI::Microsoft::Graphics::Canvas::GetFastUuid(resourceType, data, dataSize);
+
+    return ABI::Microsoft::Graphics::Canvas::GetFastUuid(
+        dataHash,
+        reinterpret_cast<BYTE const*>(parameters.begin()),
+        parameters.size() * sizeof(uint32_t));
+}
+
+
+void EffectResourceCache::Clear()
+{
+    Lock lock(m_mutex);
+
+    m_resources.clear();
+}
+
+
+ComPtr<IUnknown> EffectResourceCache::TryLookup(IID const& key)
+{
+    Lock lock(m_mutex);
+
+    for (auto& cached : m_resources)
+    {
+        if (cached.Key == key)
+        {
+            cached.LastUsed = ++m_clock;
+            return cached.Resource;
+        }
+    }
+
+    return nullptr;
+}
+
+
+ComPtr<IUnknown> EffectResourceCache::Add(IID const& key, IUnknown* resource)
+{
+    Lock lock(m_mutex);
+
+    for (auto& cached : m_resources)
+    {
+        if (cached.Key == key)
+        {
+            cached.LastUsed = ++m_clock;
+            return cached.Resource;
+        }
+    }
+
+    if (m_resources.size() >= m_maxEntries)
+    {
+        auto leastRecentlyUsed = std::min_element(m_resources.begin(), m_resources.end(),
+            [](CachedResource const& a, CachedResource const& b)
+            {
+                return a.LastUsed < b.LastUsed;
+            });
+
+        m_resources.erase(leastRecentlyUsed);
+    }
+
+    m_resources.push_back(CachedResource{ key, resource, ++m_clock });
+
+    return resource;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+
+//
+// Per-device cache of the immutable D2D resources that effects are
+// configured with (ID2D1LookupTable3D and ID2D1ColorContext), so that
+// creating more than one EffectTransferTable3D or ColorManagementProfile
+// from the same data only builds the D2D resource once.
+//
+// Entries are keyed on a hash of everything the resource is created from,
+// see MakeKey.  The most recently used entries, up to the capacity passed
+// to the constructor, are kept alive; Trim releases all of them.
+//
+// The device also keeps a second, larger, instance for the gradient stop
+// collections that CanvasLinearGradientBrush and CanvasRadialGradientBrush
+// are built from, since apps tend to create many brushes from the same few
+// gradients.
+//
+// Several Win2D wrappers can end up sharing one cached resource, so they
+// must attach it with ResourceWrapper::SetSharedResource.
+//
+class EffectResourceCache
+{
+    struct CachedResource
+    {
+        IID Key;
+        ComPtr<IUnknown> Resource;
+        uint64_t LastUsed;
+    };
+
+    std::mutex m_mutex;
+    std::vector<CachedResource> m_resources;
+    uint64_t m_clock;
+    size_t m_maxEntries;
+
+public:
+    static const size_t DefaultMaxEntries = 16;
+
+    explicit EffectResourceCache(size_t maxEntries = DefaultMaxEntries);
+
+    EffectResourceCache(EffectResourceCache const&) = delete;
+    EffectResourceCache& operator=(EffectResourceCache const&) = delete;
+
+    // Builds a cache key from the resource type, the source data, and any other
+    // parameters that affect the resource.
+    static IID MakeKey(IID const& resourceType, BYTE const* data, size_t dataSize, std::initializer_list<uint32_t> parameters);
+
+    // Returns the cached resource for this key, or calls createFunction to make
+    // (and cache) a new one. Creation happens outside the cache lock.
+    template<typename T, typename FN>
+    ComPtr<T> GetOrCreate(IID const& key, FN&& createFunction)
+    {
+        auto cached = TryLookup(key);
+
+        if (cached)
+            return As<T>(cached);
+
+        ComPtr<T> resource = createFunction();
+
+        if (resource)
+        {
+            // If another thread got there first, use theirs so there is only ever one copy.
+            resource = As<T>(Add(key, resource.Get()));
+        }
+
+        return resource;
+    }
+
+    void Clear();
+
+private:
+    ComPtr<IUnknown> TryLookup(IID const& key);
+    ComPtr<IUnknown> Add(IID const& key, IUnknown* resource);
+};
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "MemoryBudgetNotifier.h"
+
+// The notifier whose callback is running on this thread, if any.
+static thread_local MemoryBudgetNotifier* t_notifierInCallback = nullptr;
+
+
+MemoryBudgetNotifier::MemoryBudgetNotifier()
+    : m_event(nullptr)
+    , m_wait(nullptr)
+    , m_cookie(0)
+{
+}
+
+
+MemoryBudgetNotifier::~MemoryBudgetNotifier()
+{
+    Stop();
+}
+
+
+void MemoryBudgetNotifier::Start(IDXGIAdapter3* adapter, std::function<void()>&& callback)
+{
+    Lock lock(m_mutex);
+
+    if (m_wait)
+        return;
+
+    auto event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+
+    if (!event)
+        ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+
+    auto eventWarden = MakeScopeWarden([&] { CloseHandle(event); });
+
+    auto wait = CreateThreadpoolWait(&MemoryBudgetNotifier::OnBudgetChanged, this, nullptr);
+
+    if (!wait)
+        ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+
+    auto waitWarden = MakeScopeWarden([&] { CloseThreadpoolWait(wait); });
+
+    DWORD cookie;
+    ThrowIfFailed(adapter->RegisterVideoMemoryBudgetChangeNotificationEvent(event, &cookie));
+
+    m_adapter = adapter;
+    m_event = event;
+    m_wait = wait;
+    m_cookie = cookie;
+    m_callback = std::move(callback);
+
+    SetThreadpoolWait(m_wait, m_event, nullptr);
+
+    eventWarden.Dismiss();
+    waitWarden.Dismiss();
+}
+
+
+void MemoryBudgetNotifier::Stop()
+{
+    ComPtr<IDXGIAdapter3> adapter;
+    HANDLE event;
+    PTP_WAIT wait;
+    DWORD cookie;
+
+    {
+        Lock lock(m_mutex);
+
+        if (!m_wait)
+            return;
+
+        // Callbacks that haven't got as far as checking m_wait will now do nothing.
+        adapter = std::move(m_adapter);
+        event = m_event;
+        wait = m_wait;
+        cookie = m_cookie;
+
+        m_event = nullptr;
+        m_wait = nullptr;
+        m_cookie = 0;
+        m_callback = nullptr;
+    }
+
+    adapter->UnregisterVideoMemoryBudgetChangeNotification(cookie);
+
+    SetThreadpoolWait(wait, nullptr, nullptr);
+
+    // A callback can't wait for itself to finish.  CloseThreadpoolWait
+    // frees the wait once any callback that is still running returns.
+    if (t_notifierInCallback != this)
+        WaitForThreadpoolWaitCallbacks(wait, TRUE);
+
+    CloseThreadpoolWait(wait);
+    CloseHandle(event);
+}
+
+
+bool MemoryBudgetNotifier::IsStarted()
+{
+    Lock lock(m_mutex);
+
+    return m_wait != nullptr;
+}
+
+
+void CALLBACK MemoryBudgetNotifier::OnBudgetChanged(PTP_CALLBACK_INSTANCE, void* context, PTP_WAIT wait, TP_WAIT_RESULT)
+{
+    auto notifier = static_cast<MemoryBudgetNotifier*>(context);
+
+    std::function<void()> callback;
+
+    {
+        Lock lock(notifier->m_mutex);
+
+        if (notifier->m_wait != wait)
+            return;
+
+        // Rearm before calling back, so changes made while the callback runs aren't missed.
+        SetThreadpoolWait(wait, notifier->m_event, nullptr);
+
+        callback = notifier->m_callback;
+    }
+
+    t_notifierInCallback = notifier;
+    auto inCallbackWarden = MakeScopeWarden([] { t_notifierInCallback = nullptr; });
+
+    callback();
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+
+//
+// Calls back on a thread pool thread whenever DXGI signals that the
+// process's video memory budget for an adapter has changed.  CanvasDevice
+// starts one when its MemoryBudgetChanged event is first subscribed to, and
+// stops it when the device is closed.
+//
+// The callback may release the last reference to the device that owns this
+// notifier, so Stop doesn't wait for callbacks when it is called from one,
+// and the callback never touches the notifier after it has been called.
+//
+class MemoryBudgetNotifier
+{
+    std::mutex m_mutex;
+    ComPtr<IDXGIAdapter3> m_adapter;
+    HANDLE m_event;
+    PTP_WAIT m_wait;
+    DWORD m_cookie;
+    std::function<void()> m_callback;
+
+public:
+    MemoryBudgetNotifier();
+    ~MemoryBudgetNotifier();
+
+    MemoryBudgetNotifier(MemoryBudgetNotifier const&) = delete;
+    MemoryBudgetNotifier& operator=(MemoryBudgetNotifier const&) = delete;
+
+    // Does nothing if the notifier is already started.
+    void Start(IDXGIAdapter3* adapter, std::function<void()>&& callback);
+
+    void Stop();
+
+    bool IsStarted();
+
+private:
+    static void CALLBACK OnBudgetChanged(PTP_CALLBACK_INSTANCE, void* context, PTP_WAIT wait, TP_WAIT_RESULT);
+};
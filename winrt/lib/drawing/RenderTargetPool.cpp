@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "RenderTargetPool.h"
+
+
+RenderTargetPool::RenderTargetPool()
+    : m_idleSize(0)
+    , m_maximumIdleCount(DefaultMaximumIdleCount)
+    , m_maximumIdleSize(DefaultMaximumIdleSize)
+    , m_rentCount(0)
+    , m_reuseCount(0)
+    , m_returnCount(0)
+{
+}
+
+
+static uint32_t RoundUpToBucket(uint32_t value, uint32_t maximumValue)
+{
+    uint32_t highestPowerOfTwo = 1;
+
+    while (highestPowerOfTwo <= value / 2)
+        highestPowerOfTwo *= 2;
+
+    auto granularity = std::max(RenderTargetPool::MinimumSizeGranularity, highestPowerOfTwo / 8);
+    auto roundedUp = (static_cast<uint64_t>(value) + granularity - 1) / granularity * granularity;
+
+    // Don't round up past a size that the device is able to create.
+    return static_cast<uint32_t>(std::max<uint64_t>(value, std::min<uint64_t>(roundedUp, maximumValue)));
+}
+
+
+D2D1_SIZE_U RenderTargetPool::GetBucketSize(D2D1_SIZE_U size, uint32_t maximumBitmapSize)
+{
+    return D2D1_SIZE_U
+    {
+        RoundUpToBucket(size.width, maximumBitmapSize),
+        RoundUpToBucket(size.height, maximumBitmapSize)
+    };
+}
+
+
+ComPtr<ID2D1Bitmap1> RenderTargetPool::Acquire(ID2D1DeviceContext* deviceContext, D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format, float dpi)
+{
+    auto bucketSize = GetBucketSize(size, deviceContext->GetMaximumBitmapSize());
+
+    if (auto bitmap = TryTakeIdleBitmap(bucketSize, format, dpi))
+        return bitmap;
+
+    auto bitmapProperties = D2D1::BitmapProperties1(
+        D2D1_BITMAP_OPTIONS_TARGET,
+        format,
+        dpi,
+        dpi);
+
+    ComPtr<ID2D1Bitmap1> bitmap;
+
+    auto hr = deviceContext->CreateBitmap(bucketSize, nullptr, 0, &bitmapProperties, &bitmap);
+
+    if (hr == E_OUTOFMEMORY)
+    {
+        // Give back whatever memory our idle bitmaps are holding on to, and try again.
+        Clear();
+
+        hr = deviceContext->CreateBitmap(bucketSize, nullptr, 0, &bitmapProperties, &bitmap);
+    }
+
+    ThrowIfFailed(hr);
+
+    return bitmap;
+}
+
+
+ComPtr<ID2D1Bitmap1> RenderTargetPool::TryTakeIdleBitmap(D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format, float dpi)
+{
+    Lock lock(m_mutex);
+
+    m_rentCount++;
+
+    // Search from the back, so the most recently used bitmaps are reused first.
+    for (auto it = m_idleBitmaps.rbegin(); it != m_idleBitmaps.rend(); ++it)
+    {
+        auto idleSize = it->Bitmap->GetPixelSize();
+        auto idleFormat = it->Bitmap->GetPixelFormat();
+
+        if (idleSize.width == size.width &&
+            idleSize.height == size.height &&
+            idleFormat.format == format.format &&
+            idleFormat.alphaMode == format.alphaMode &&
+            it->Dpi == dpi)
+        {
+            auto bitmap = std::move(it->Bitmap);
+            m_idleSize -= it->Size;
+            m_idleBitmaps.erase(std::next(it).base());
+            m_reuseCount++;
+            return bitmap;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void RenderTargetPool::Release(ID2D1Bitmap1* bitmap)
+{
+    auto size = GetBitmapSize(bitmap);
+
+    float dpiX, dpiY;
+    bitmap->GetDpi(&dpiX, &dpiY);
+
+    Lock lock(m_mutex);
+
+    m_returnCount++;
+
+    if (size > m_maximumIdleSize || m_maximumIdleCount == 0)
+        return;
+
+    EvictUntil(m_maximumIdleCount - 1, m_maximumIdleSize - size);
+
+    m_idleBitmaps.push_back(IdleBitmap{ bitmap, size, dpiX });
+    m_idleSize += size;
+}
+
+
+RenderTargetPool::Statistics RenderTargetPool::GetStatistics()
+{
+    Lock lock(m_mutex);
+
+    return Statistics
+    {
+        m_rentCount,
+        m_reuseCount,
+        m_returnCount,
+        static_cast<uint32_t>(m_idleBitmaps.size()),
+        m_idleSize
+    };
+}
+
+
+uint32_t RenderTargetPool::GetMaximumIdleCount()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumIdleCount;
+}
+
+
+void RenderTargetPool::SetMaximumIdleCount(uint32_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumIdleCount = value;
+
+    EvictUntil(m_maximumIdleCount, m_maximumIdleSize);
+}
+
+
+uint64_t RenderTargetPool::GetMaximumIdleSize()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumIdleSize;
+}
+
+
+void RenderTargetPool::SetMaximumIdleSize(uint64_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumIdleSize = value;
+
+    EvictUntil(m_maximumIdleCount, m_maximumIdleSize);
+}
+
+
+void RenderTargetPool::Clear()
+{
+    Lock lock(m_mutex);
+
+    m_idleBitmaps.clear();
+    m_idleSize = 0;
+}
+
+
+void RenderTargetPool::EvictUntil(size_t maxCount, uint64_t maxSize)
+{
+    while (!m_idleBitmaps.empty() && (m_idleBitmaps.size() > maxCount || m_idleSize > maxSize))
+    {
+        m_idleSize -= m_idleBitmaps.front().Size;
+        m_idleBitmaps.erase(m_idleBitmaps.begin());
+    }
+}
+
+
+uint64_t RenderTargetPool::GetBitmapSize(ID2D1Bitmap1* bitmap)
+{
+    using namespace ABI::Microsoft::Graphics::Canvas;
+
+    auto size = bitmap->GetPixelSize();
+    auto format = bitmap->GetPixelFormat().format;
+
+    auto blockSize = GetBlockSize(format);
+    auto blocksWide = (size.width + blockSize - 1) / blockSize;
+    auto blocksHigh = (size.height + blockSize - 1) / blockSize;
+
+    return static_cast<uint64_t>(blocksWide) * blocksHigh * GetBytesPerBlock(format);
+}
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+
+//
+// Per-device pool of render target bitmaps, used by CanvasRenderTargetPool.
+//
+// Effect pipelines often create and throw away many intermediate render
+// targets of the same size every frame.  Rather than allocating new GPU
+// memory each time, returned bitmaps are kept and handed out again to later
+// requests with the same format, alpha mode and DPI whose size falls into
+// the same bucket.
+//
+// Sizes are bucketed by rounding each dimension up to a multiple of an
+// eighth of its highest power of two (but at least MinimumSizeGranularity),
+// so no more than about an eighth of each dimension is wasted, while nearly
+// equal sizes still share bitmaps.  Sizes are never rounded up past what the
+// device is able to create.
+//
+// Idle bitmaps are limited in both number and total size, the least recently
+// returned being dropped first.  They are also dropped if creating a new one
+// runs out of memory, and by CanvasDevice.Trim.
+//
+class RenderTargetPool
+{
+    struct IdleBitmap
+    {
+        ComPtr<ID2D1Bitmap1> Bitmap;
+        uint64_t Size;
+        float Dpi;
+    };
+
+    std::mutex m_mutex;
+    std::vector<IdleBitmap> m_idleBitmaps;      // Most recently returned at the back.
+    uint64_t m_idleSize;
+    uint32_t m_maximumIdleCount;
+    uint64_t m_maximumIdleSize;
+
+    uint64_t m_rentCount;
+    uint64_t m_reuseCount;
+    uint64_t m_returnCount;
+
+public:
+    static const uint32_t MinimumSizeGranularity = 8;
+    static const uint32_t DefaultMaximumIdleCount = 16;
+    static const uint64_t DefaultMaximumIdleSize = 128 * 1024 * 1024;
+
+    struct Statistics
+    {
+        uint64_t RentCount;         // Calls to Acquire.
+        uint64_t ReuseCount;        // Calls to Acquire that were satisfied by an idle bitmap.
+        uint64_t ReturnCount;       // Calls to Release.
+        uint32_t IdleCount;
+        uint64_t IdleSize;
+    };
+
+    RenderTargetPool();
+
+    RenderTargetPool(RenderTargetPool const&) = delete;
+    RenderTargetPool& operator=(RenderTargetPool const&) = delete;
+
+    // Returns an idle render target bitmap of the bucket size for the requested
+    // size, format and DPI, or creates a new one on deviceContext if there are
+    // none.  The contents of a reused bitmap are whatever was last drawn to it.
+    ComPtr<ID2D1Bitmap1> Acquire(ID2D1DeviceContext* deviceContext, D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format, float dpi);
+
+    // Returns a bitmap to the pool, to be reused by a later Acquire.
+    void Release(ID2D1Bitmap1* bitmap);
+
+    Statistics GetStatistics();
+
+    uint32_t GetMaximumIdleCount();
+    void SetMaximumIdleCount(uint32_t value);
+
+    uint64_t GetMaximumIdleSize();
+    void SetMaximumIdleSize(uint64_t value);
+
+    void Clear();
+
+    static D2D1_SIZE_U GetBucketSize(D2D1_SIZE_U size, uint32_t maximumBitmapSize);
+
+private:
+    ComPtr<ID2D1Bitmap1> TryTakeIdleBitmap(D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format, float dpi);
+    void EvictUntil(size_t maxCount, uint64_t maxSize);
+
+    static uint64_t GetBitmapSize(ID2D1Bitmap1* bitmap);
+};
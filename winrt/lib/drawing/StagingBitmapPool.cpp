@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "StagingBitmapPool.h"
+
+
+StagingBitmapPool::StagingBitmapPool()
+    : m_idleSize(0)
+    , m_maximumIdleSize(DefaultMaximumIdleSize)
+{
+}
+
+
+static uint32_t RoundUpToGranularity(uint32_t value, uint32_t maximumValue)
+{
+    auto granularity = StagingBitmapPool::SizeGranularity;
+    auto roundedUp = (static_cast<uint64_t>(value) + granularity - 1) / granularity * granularity;
+
+    // Don't round up past a size that the device is able to create.
+    return static_cast<uint32_t>(std::max<uint64_t>(value, std::min<uint64_t>(roundedUp, maximumValue)));
+}
+
+
+ComPtr<ID2D1Bitmap1> StagingBitmapPool::Acquire(ID2D1DeviceContext* deviceContext, D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format)
+{
+    auto maximumBitmapSize = deviceContext->GetMaximumBitmapSize();
+
+    D2D1_SIZE_U bucketSize
+    {
+        RoundUpToGranularity(size.width, maximumBitmapSize),
+        RoundUpToGranularity(size.height, maximumBitmapSize)
+    };
+
+    if (auto bitmap = TryTakeIdleBitmap(bucketSize, format))
+        return bitmap;
+
+    auto bitmapProperties = D2D1::BitmapProperties1(
+        D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
+        format);
+
+    ComPtr<ID2D1Bitmap1> bitmap;
+
+    auto hr = deviceContext->CreateBitmap(bucketSize, nullptr, 0, &bitmapProperties, &bitmap);
+
+    if (hr == E_OUTOFMEMORY)
+    {
+        // Give back whatever memory our idle bitmaps are holding on to, and try again.
+        Clear();
+
+        hr = deviceContext->CreateBitmap(bucketSize, nullptr, 0, &bitmapProperties, &bitmap);
+    }
+
+    ThrowIfFailed(hr);
+
+    return bitmap;
+}
+
+
+ComPtr<ID2D1Bitmap1> StagingBitmapPool::TryTakeIdleBitmap(D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format)
+{
+    Lock lock(m_mutex);
+
+    // Search from the back, so the most recently used bitmaps are reused first.
+    for (auto it = m_idleBitmaps.rbegin(); it != m_idleBitmaps.rend(); ++it)
+    {
+        auto idleSize = it->Bitmap->GetPixelSize();
+        auto idleFormat = it->Bitmap->GetPixelFormat();
+
+        if (idleSize.width == size.width &&
+            idleSize.height == size.height &&
+            idleFormat.format == format.format &&
+            idleFormat.alphaMode == format.alphaMode)
+        {
+            auto bitmap = std::move(it->Bitmap);
+            m_idleSize -= it->Size;
+            m_idleBitmaps.erase(std::next(it).base());
+            return bitmap;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void StagingBitmapPool::Release(ID2D1Bitmap1* bitmap)
+{
+    auto size = GetBitmapSize(bitmap);
+
+    Lock lock(m_mutex);
+
+    if (size > m_maximumIdleSize)
+        return;
+
+    EvictUntil(MaxIdleBitmaps - 1, m_maximumIdleSize - size);
+
+    m_idleBitmaps.push_back(IdleBitmap{ bitmap, size });
+    m_idleSize += size;
+}
+
+
+uint64_t StagingBitmapPool::GetIdleSize()
+{
+    Lock lock(m_mutex);
+
+    return m_idleSize;
+}
+
+
+uint64_t StagingBitmapPool::GetMaximumIdleSize()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumIdleSize;
+}
+
+
+void StagingBitmapPool::SetMaximumIdleSize(uint64_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumIdleSize = value;
+
+    EvictUntil(MaxIdleBitmaps, m_maximumIdleSize);
+}
+
+
+void StagingBitmapPool::Clear()
+{
+    Lock lock(m_mutex);
+
+    m_idleBitmaps.clear();
+    m_idleSize = 0;
+}
+
+
+void StagingBitmapPool::EvictUntil(size_t maxCount, uint64_t maxSize)
+{
+    while (!m_idleBitmaps.empty() && (m_idleBitmaps.size() > maxCount || m_idleSize > maxSize))
+    {
+        m_idleSize -= m_idleBitmaps.front().Size;
+        m_idleBitmaps.erase(m_idleBitmaps.begin());
+    }
+}
+
+
+uint64_t StagingBitmapPool::GetBitmapSize(ID2D1Bitmap1* bitmap)
+{
+    using namespace ABI::Microsoft::Graphics::Canvas;
+
+    auto size = bitmap->GetPixelSize();
+    auto format = bitmap->GetPixelFormat().format;
+
+    auto blockSize = GetBlockSize(format);
+    auto blocksWide = (size.width + blockSize - 1) / blockSize;
+    auto blocksHigh = (size.height + blockSize - 1) / blockSize;
+
+    return static_cast<uint64_t>(blocksWide) * blocksHigh * GetBytesPerBlock(format);
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+
+//
+// Per-device pool of the CPU-readable staging bitmaps that pixels are copied
+// into before they are read back (see ScopedBitmapMappedPixelAccess).
+//
+// Reading back a bitmap every frame, eg. when exporting video, would
+// otherwise allocate a new staging texture for every read.  Staging bitmaps
+// are created with their size rounded up to a multiple of SizeGranularity,
+// and released bitmaps are kept and reused by later reads of the same
+// format that round up to the same size.  That way reading back thumbnails
+// of slightly different sizes can still share bitmaps.  Bitmaps that are
+// still in use (not yet released) are never shared, so several reads may be
+// in flight at once.
+//
+// At most MaxIdleBitmaps, adding up to no more than the maximum idle size,
+// are kept at once, the least recently released being dropped first.  The
+// idle bitmaps are also dropped if creating a new one runs out of memory,
+// and by CanvasDevice.Trim.
+//
+class StagingBitmapPool
+{
+    struct IdleBitmap
+    {
+        ComPtr<ID2D1Bitmap1> Bitmap;
+        uint64_t Size;
+    };
+
+    std::mutex m_mutex;
+    std::vector<IdleBitmap> m_idleBitmaps;      // Most recently released at the back.
+    uint64_t m_idleSize;
+    uint64_t m_maximumIdleSize;
+
+public:
+    static const size_t MaxIdleBitmaps = 4;
+    static const uint32_t SizeGranularity = 64;
+    static const uint64_t DefaultMaximumIdleSize = 64 * 1024 * 1024;
+
+    StagingBitmapPool();
+
+    StagingBitmapPool(StagingBitmapPool const&) = delete;
+    StagingBitmapPool& operator=(StagingBitmapPool const&) = delete;
+
+    // Returns an idle staging bitmap at least as big as requested, with the
+    // requested format, or creates a new one on deviceContext if there are
+    // none.  Only the top left corner of the bitmap may be used.
+    ComPtr<ID2D1Bitmap1> Acquire(ID2D1DeviceContext* deviceContext, D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format);
+
+    // Returns an unmapped bitmap to the pool, to be reused by a later Acquire.
+    void Release(ID2D1Bitmap1* bitmap);
+
+    uint64_t GetIdleSize();
+
+    uint64_t GetMaximumIdleSize();
+    void SetMaximumIdleSize(uint64_t value);
+
+    void Clear();
+
+private:
+    ComPtr<ID2D1Bitmap1> TryTakeIdleBitmap(D2D1_SIZE_U size, D2D1_PIXEL_FORMAT format);
+    void EvictUntil(size_t maxCount, uint64_t maxSize);
+
+    static uint64_t GetBitmapSize(ID2D1Bitmap1* bitmap);
+};
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "SurfaceBitmapCache.h"
+
+
+SurfaceBitmapCache::SurfaceBitmapCache()
+    : m_maximumCount(0)
+{
+}
+
+
+bool SurfaceBitmapCache::IsEnabled()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumCount > 0;
+}
+
+
+ComPtr<ID2D1Bitmap1> SurfaceBitmapCache::GetOrCreate(
+    IUnknown* surface,
+    float dpi,
+    D2D1_ALPHA_MODE alphaMode,
+    std::function<ComPtr<ID2D1Bitmap1>()> const& createBitmap)
+{
+    ComPtr<IUnknown> identity;
+    ThrowIfFailed(surface->QueryInterface(IID_PPV_ARGS(&identity)));
+
+    {
+        Lock lock(m_mutex);
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->Surface.Get() != identity.Get())
+                continue;
+
+            if (it->Dpi == dpi && it->AlphaMode == alphaMode)
+            {
+                // Move the entry to the back, as the most recently used.
+                auto bitmap = it->Bitmap;
+                std::rotate(it, std::next(it), m_entries.end());
+                return bitmap;
+            }
+
+            // The same surface with different properties replaces the old entry.
+            m_entries.erase(it);
+            break;
+        }
+    }
+
+    auto bitmap = createBitmap();
+
+    Lock lock(m_mutex);
+
+    if (m_maximumCount == 0)
+        return bitmap;
+
+    // Another thread may have cached this surface while we were creating it.
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->Surface.Get() == identity.Get())
+        {
+            m_entries.erase(it);
+            break;
+        }
+    }
+
+    EvictToCount(lock, m_maximumCount - 1);
+
+    m_entries.push_back(Entry{ identity, dpi, alphaMode, bitmap });
+
+    return bitmap;
+}
+
+
+uint32_t SurfaceBitmapCache::GetCount()
+{
+    Lock lock(m_mutex);
+
+    return static_cast<uint32_t>(m_entries.size());
+}
+
+
+uint32_t SurfaceBitmapCache::GetMaximumCount()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumCount;
+}
+
+
+void SurfaceBitmapCache::SetMaximumCount(uint32_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumCount = value;
+
+    EvictToCount(lock, value);
+}
+
+
+void SurfaceBitmapCache::Clear()
+{
+    Lock lock(m_mutex);
+
+    m_entries.clear();
+}
+
+
+void SurfaceBitmapCache::EvictToCount(Lock const& lock, uint32_t count)
+{
+    MustOwnLock(lock);
+
+    if (m_entries.size() > count)
+    {
+        m_entries.erase(m_entries.begin(), m_entries.end() - count);
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+
+//
+// Per-device cache of the bitmaps that CanvasBitmap.CreateFromDirect3D11Surface
+// makes for Direct3D surfaces.
+//
+// Video pipelines (MediaPlayer frame servers, MediaCapture frame readers)
+// hand the app the same small set of frame pool surfaces over and over.
+// Without this cache, every frame makes a new ID2D1Bitmap1 for its surface,
+// and so also a new CanvasBitmap to wrap it.  When the cache is enabled,
+// the D2D bitmap made for a surface is kept and handed out again the next
+// time the same surface is passed with the same dpi and alpha mode.  Because
+// CanvasBitmap wrappers are looked up by their D2D resource, this also
+// returns the same CanvasBitmap for as long as the app holds on to it.
+//
+// Surfaces are keyed on their IUnknown identity.  Each entry keeps its D2D
+// bitmap, and through it the surface, alive, so a surface address can't be
+// reused by a different surface while an entry exists.
+//
+// The cache is disabled until given a non-zero maximum count.  The least
+// recently used entries beyond that count are released, as is everything
+// by Clear.
+//
+class SurfaceBitmapCache
+{
+    struct Entry
+    {
+        ComPtr<IUnknown> Surface;
+        float Dpi;
+        D2D1_ALPHA_MODE AlphaMode;
+        ComPtr<ID2D1Bitmap1> Bitmap;
+    };
+
+    std::mutex m_mutex;
+    std::vector<Entry> m_entries;       // Most recently used at the back.
+    uint32_t m_maximumCount;
+
+public:
+    SurfaceBitmapCache();
+
+    SurfaceBitmapCache(SurfaceBitmapCache const&) = delete;
+    SurfaceBitmapCache& operator=(SurfaceBitmapCache const&) = delete;
+
+    bool IsEnabled();
+
+    // Returns the cached bitmap for this surface, dpi and alpha mode, or
+    // creates (and caches) a new one using createBitmap.  Creation happens
+    // outside the cache lock.
+    ComPtr<ID2D1Bitmap1> GetOrCreate(
+        IUnknown* surface,
+        float dpi,
+        D2D1_ALPHA_MODE alphaMode,
+        std::function<ComPtr<ID2D1Bitmap1>()> const& createBitmap);
+
+    uint32_t GetCount();
+
+    uint32_t GetMaximumCount();
+    void SetMaximumCount(uint32_t value);
+
+    void Clear();
+
+private:
+    void EvictToCount(Lock const& lock, uint32_t count);
+};
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "TextLayoutCache.h"
+
+
+size_t TextLayoutCache::CacheKeyHash::operator()(CacheKey const& key) const
+{
+    // FNV-1a, over the characters in place.
+#ifdef _WIN64
+    size_t const offsetBasis = 14695981039346656037ULL;
+    size_t const prime = 1099511628211ULL;
+#else
+    size_t const offsetBasis = 2166136261U;
+    size_t const prime = 16777619U;
+#endif
+
+    size_t hash = offsetBasis;
+
+    for (uint32_t i = 0; i < key.TextLength; i++)
+    {
+        hash ^= key.Text[i];
+        hash *= prime;
+    }
+
+    auto combine = [&](size_t value)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    combine(std::hash<void*>()(key.Format));
+    combine(std::hash<uint64_t>()(key.FormatVersion));
+    combine(std::hash<float>()(key.Width));
+    combine(std::hash<float>()(key.Height));
+
+    return hash;
+}
+
+
+TextLayoutCache::TextLayoutCache()
+    : m_maximumCount(0)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_evictionCount(0)
+{
+}
+
+
+bool TextLayoutCache::IsEnabled()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumCount > 0;
+}
+
+
+ComPtr<IDWriteTextLayout> TextLayoutCache::GetOrCreate(
+    IDWriteFactory* factory,
+    wchar_t const* text,
+    uint32_t textLength,
+    IDWriteTextFormat* format,
+    uint64_t formatVersion,
+    float width,
+    float height)
+{
+    CacheKey key{ text, textLength, format, formatVersion, width, height };
+
+    {
+        Lock lock(m_mutex);
+
+        auto it = m_entryMap.find(key);
+
+        if (it != m_entryMap.end())
+        {
+            m_hitCount++;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->Layout;
+        }
+
+        m_missCount++;
+    }
+
+    ComPtr<IDWriteTextLayout> layout;
+    ThrowIfFailed(factory->CreateTextLayout(text, textLength, format, width, height, &layout));
+
+    Lock lock(m_mutex);
+
+    // If another thread got there first, use theirs so there is only ever one copy.
+    auto it = m_entryMap.find(key);
+
+    if (it != m_entryMap.end())
+    {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->Layout;
+    }
+
+    if (m_maximumCount == 0)
+        return layout;
+
+    EvictToCount(lock, m_maximumCount - 1);
+
+    m_entries.push_front(Entry{ std::wstring(text, textLength), key, format, layout });
+
+    auto& entry = m_entries.front();
+    entry.Key.Text = entry.Text.c_str();
+
+    m_entryMap.emplace(entry.Key, m_entries.begin());
+
+    return layout;
+}
+
+
+TextLayoutCache::Statistics TextLayoutCache::GetStatistics()
+{
+    Lock lock(m_mutex);
+
+    return Statistics
+    {
+        static_cast<uint32_t>(m_entries.size()),
+        m_hitCount,
+        m_missCount,
+        m_evictionCount
+    };
+}
+
+
+uint32_t TextLayoutCache::GetMaximumCount()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumCount;
+}
+
+
+void TextLayoutCache::SetMaximumCount(uint32_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumCount = value;
+    EvictToCount(lock, value);
+}
+
+
+void TextLayoutCache::Clear()
+{
+    Lock lock(m_mutex);
+
+    EvictToCount(lock, 0);
+}
+
+
+void TextLayoutCache::EvictToCount(Lock const& lock, uint32_t count)
+{
+    MustOwnLock(lock);
+
+    while (m_entries.size() > count)
+    {
+        auto& entry = m_entries.back();
+
+        m_entryMap.erase(entry.Key);
+        m_entries.pop_back();
+
+        m_evictionCount++;
+    }
+}
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+
+//
+// Per-device cache of the text layouts used by CanvasDrawingSession.DrawText.
+//
+// ID2D1DeviceContext::DrawText shapes and lays out its string from scratch
+// on every call.  When this cache is enabled, DrawText instead asks it for an
+// IDWriteTextLayout of the same text, format and layout box, and draws that,
+// so text that is unchanged from one frame to the next is only laid out once.
+//
+// Entries are keyed on the text, the realized IDWriteTextFormat together with
+// a version number that CanvasTextFormat changes whenever any of its
+// properties does, and the layout box size.  The cache holds a reference to
+// each format, so a format pointer can't be reused by a different format
+// while an entry exists.  Draw text options are not part of the key, as they
+// are applied when drawing rather than when laying out.
+//
+// Lookups key on the caller's text buffer, so a hit doesn't copy the text.
+// Only a new entry copies it, into the entry itself, and the key stored in
+// the map points at that copy.
+//
+// The cache is disabled until given a non-zero maximum count.  The least
+// recently drawn entries beyond that count are released, as is everything
+// by Clear.
+//
+class TextLayoutCache
+{
+    struct CacheKey
+    {
+        wchar_t const* Text;
+        uint32_t TextLength;
+        IDWriteTextFormat* Format;
+        uint64_t FormatVersion;
+        float Width;
+        float Height;
+
+        bool operator==(CacheKey const& other) const
+        {
+            return Format == other.Format &&
+                   FormatVersion == other.FormatVersion &&
+                   Width == other.Width &&
+                   Height == other.Height &&
+                   TextLength == other.TextLength &&
+                   wmemcmp(Text, other.Text, TextLength) == 0;
+        }
+    };
+
+    struct CacheKeyHash
+    {
+        size_t operator()(CacheKey const& key) const;
+    };
+
+    struct Entry
+    {
+        std::wstring Text;
+        CacheKey Key;                                                   // Key.Text points into Text.
+        ComPtr<IDWriteTextFormat> Format;
+        ComPtr<IDWriteTextLayout> Layout;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    std::mutex m_mutex;
+    EntryList m_entries;                                                // Most recently used at the front.
+    std::unordered_map<CacheKey, EntryList::iterator, CacheKeyHash> m_entryMap;
+    uint32_t m_maximumCount;
+
+    uint64_t m_hitCount;
+    uint64_t m_missCount;
+    uint64_t m_evictionCount;
+
+public:
+    struct Statistics
+    {
+        uint32_t Count;
+        uint64_t HitCount;          // Calls to GetOrCreate that found a cached layout.
+        uint64_t MissCount;         // Calls to GetOrCreate that had to create one.
+        uint64_t EvictionCount;
+    };
+
+    TextLayoutCache();
+
+    TextLayoutCache(TextLayoutCache const&) = delete;
+    TextLayoutCache& operator=(TextLayoutCache const&) = delete;
+
+    bool IsEnabled();
+
+    // Returns the cached layout of this text, format and size, or creates
+    // (and caches) a new one using factory.  Creation happens outside the
+    // cache lock.
+    ComPtr<IDWriteTextLayout> GetOrCreate(
+        IDWriteFactory* factory,
+        wchar_t const* text,
+        uint32_t textLength,
+        IDWriteTextFormat* format,
+        uint64_t formatVersion,
+        float width,
+        float height);
+
+    Statistics GetStatistics();
+
+    uint32_t GetMaximumCount();
+    void SetMaximumCount(uint32_t value);
+
+    void Clear();
+
+private:
+    void EvictToCount(Lock const& lock, uint32_t count);
+};
@@ -3,20 +3,37 @@
 // Licensed under the MIT License. See LICENSE.txt in the project root for license information.
 
 #include "pch.h"
+#include "effects/DownsampledBlurEffectImpl.h"
+#include "effects/FastGaussianBlurEffect.h"
+#include "effects/FastShadowEffect.h"
+#include "effects/shader/ComputeShaderEffect.h"
+#include "effects/shader/ComputeShaderEffectImpl.h"
 #include "effects/shader/PixelShaderEffect.h"
 #include "effects/shader/PixelShaderEffectImpl.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
 {
-    CanvasEffect::CanvasEffect(IID const& effectId, unsigned int propertiesSize, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable)
+    // Starts at 1 so a zero m_validatedGeneration never matches.
+    std::atomic<uint64_t> CanvasEffect::s_graphGeneration(1);
+
+    std::atomic<uint32_t> CanvasEffect::s_externallyVisibleEffectCount(0);
+
+
+    CanvasEffect::CanvasEffect(IID const& effectId, EffectPropertyDefaultTable const& propertyDefaults, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable)
         : ResourceWrapper(effect, outerInspectable)
         , m_closed(false)
         , m_insideGetImage(false)
         , m_effectId(effectId)
-        , m_properties(propertiesSize)
+        , m_propertyVersion(0)
+        , m_propertyDefaults(propertyDefaults)
         , m_sources(sourcesSize)
         , m_cacheOutput(false)
         , m_bufferPrecision(D2D1_BUFFER_PRECISION_UNKNOWN)
+        , m_cachePriority(EffectCachePriority_Normal)
+        , m_validatedGeneration(0)
+        , m_validatedFlags(GetImageFlags::None)
+        , m_validatedTargetDpi(0)
+        , m_isExternallyVisible(false)
     {
         // If this effect has a variable number of inputs, expose them as an IVector<>.
         if (!isSourcesSizeFixed)
@@ -35,12 +52,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             auto d2dDevice = As<ICanvasDeviceInternal>(device)->GetD2DDevice();
 
             m_realizationDevice.Set(d2dDevice.Get(), device);
+
+            // The D2D effect came from interop, so others may be holding onto it.
+            MarkExternallyVisible();
         }
     }
 
 
+    CanvasEffect::CanvasEffect(IID const& effectId, unsigned int propertiesSize, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable)
+        : CanvasEffect(effectId, EffectPropertyDefaultTable{ nullptr, propertiesSize }, sourcesSize, isSourcesSizeFixed, device, effect, outerInspectable)
+    {
+    }
+
+
     CanvasEffect::~CanvasEffect()
     {
+        if (m_isExternallyVisible)
+            --s_externallyVisibleEffectCount;
+
+
         // The sources vector could outlive us if a customer is holding onto a separate reference
         // to it. But with us gone, its parent link would be a stale pointer, so we null that out.
         if (m_sourcesVector)
@@ -64,25 +94,42 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // Look up which strongly typed Win2D wrapper class matches the effect CLSID.
         IID effectId = d2dEffect->GetValue<IID>(D2D1_PROPERTY_CLSID);
 
-        for (auto effectMaker = m_effectMakers; effectMaker->second; effectMaker++)
+        auto& effectMakers = GetEffectMakerIndex();
+        auto it = effectMakers.find(effectId);
+
+        if (it == effectMakers.end())
         {
-            if (IsEqualGUID(effectMaker->first, effectId))
-            {
-                // Found it! Create the Win2D wrapper class.
-                effectMaker->second(device, d2dEffect.Get(), result);
-                return true;
-            }
+            // Unrecognized effect CLSID.
+            return false;
         }
 
-        // If this isn't one of the codegenned effect wrappers, could it be our custom pixel shader effect?
-        if (IsEqualGUID(effectId, CLSID_PixelShaderEffect))
+        // Found it! Create the Win2D wrapper class.
+        it->second(device, d2dEffect.Get(), result);
+        return true;
+    }
+
+
+    CanvasEffect::EffectMakerIndex const& CanvasEffect::GetEffectMakerIndex()
+    {
+        static EffectMakerIndex const index = []
         {
-            MakeEffect<PixelShaderEffect>(device, d2dEffect.Get(), result);
-            return true;
-        }
+            EffectMakerIndex index;
 
-        // Unrecognized effect CLSID.
-        return false;
+            for (auto effectMaker = m_effectMakers; effectMaker->second; effectMaker++)
+            {
+                index.insert(*effectMaker);
+            }
+
+            // Our custom effects aren't among the codegenned effect wrappers.
+            index.insert(std::make_pair(CLSID_PixelShaderEffect, &MakeEffect<PixelShaderEffect>));
+            index.insert(std::make_pair(CLSID_ComputeShaderEffect, &MakeEffect<ComputeShaderEffect>));
+            index.insert(std::make_pair(CLSID_FastGaussianBlurEffect, &MakeEffect<FastGaussianBlurEffect>));
+            index.insert(std::make_pair(CLSID_FastShadowEffect, &MakeEffect<FastShadowEffect>));
+
+            return index;
+        }();
+
+        return index;
     }
 
 
@@ -94,7 +141,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ICanvasResourceCreator* resourceCreator,
         Rect* bounds)
     {
-        return GetImageBoundsImpl(this, resourceCreator, nullptr, bounds);
+        return GetImageBoundsImpl(this, resourceCreator, nullptr, bounds, GetCachedBounds());
     }
 
 
@@ -103,7 +150,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Numerics::Matrix3x2 transform,
         Rect* bounds)
     {
-        return GetImageBoundsImpl(this, resourceCreator, &transform, bounds);
+        return GetImageBoundsImpl(this, resourceCreator, &transform, bounds, GetCachedBounds());
     }
 
 
@@ -155,9 +202,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         if (!IsSameInstance(d2dDevice.Get(), m_realizationDevice.GetResource()))
         {
-            Unrealize();
-
-            m_realizationDevice.Set(d2dDevice.Get(), device);
+            ChangeRealizationDevice(d2dDevice.Get(), device);
         }
 
         if (!HasResource())
@@ -168,10 +213,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 return nullptr;
             }
         }
-        else if ((flags & GetImageFlags::MinimalRealization) == GetImageFlags::None)
+        else if ((flags & GetImageFlags::MinimalRealization) == GetImageFlags::None &&
+                 !IsGraphValidated(flags, targetDpi))
         {
             // Recurse through the effect graph to make sure child nodes are properly realized.
+            // The generation is read first, so changes made while we refresh aren't missed.
+            auto generation = s_graphGeneration.load();
+
             RefreshInputs(flags, targetDpi, deviceContext);
+
+            m_validatedGeneration = generation;
+            m_validatedFlags = flags;
+            m_validatedTargetDpi = targetDpi;
+        }
+
+        if (m_cacheOutput)
+        {
+            UpdateCacheBudget(device, deviceContext);
         }
 
         if (realizedDpi)
@@ -208,25 +266,233 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 auto realizedEffect = GetD2DImage(device, nullptr, flags, dpi);
                 
                 ThrowIfFailed(realizedEffect.CopyTo(iid, resource));
+
+                MarkExternallyVisible();
             });
     }
 
 
+    //
+    // ICanvasEffectInternal
+    //
+
+    void CanvasEffect::GetTemplateState(CanvasEffectTemplateState* state, std::vector<ComPtr<IGraphicsEffectSource>>* sources)
+    {
+        ThrowIfClosed();
+
+        // Look up the strongly typed wrapper maker once, so instantiating copies doesn't need to.
+        // The custom shader effects can't be recreated without their shader, so are not supported.
+        auto& effectMakers = GetEffectMakerIndex();
+        auto it = effectMakers.find(m_effectId);
+
+        if (it == effectMakers.end() ||
+            IsEqualGUID(m_effectId, CLSID_PixelShaderEffect) ||
+            IsEqualGUID(m_effectId, CLSID_ComputeShaderEffect))
+            ThrowHR(E_INVALIDARG, Strings::EffectGraphTemplateUnsupportedEffect);
+
+        unsigned int sourceCount = GetSourceCount();
+
+        sources->clear();
+        sources->reserve(sourceCount);
+
+        for (unsigned int i = 0; i < sourceCount; ++i)
+        {
+            sources->push_back(GetSource(i));
+        }
+
+        auto lock = Lock(m_mutex);
+
+        state->EffectId = m_effectId;
+        state->MakeEffect = it->second;
+        state->PropertyDefaults = m_propertyDefaults;
+        state->Name = m_name;
+
+        if (auto& d2dEffect = MaybeGetResource())
+        {
+            // If we are realized, the D2D effect holds the latest values.
+            state->Properties.resize(m_propertyDefaults.Count);
+
+            for (unsigned int i = 0; i < m_propertyDefaults.Count; ++i)
+            {
+                GetD2DPropertyAsStored(d2dEffect.Get(), i, &state->Properties[i]);
+            }
+
+            state->CacheOutput = ReadCacheOutput(d2dEffect.Get());
+            state->BufferPrecision = d2dEffect->GetValue<D2D1_BUFFER_PRECISION>(D2D1_PROPERTY_PRECISION);
+        }
+        else
+        {
+            // Still empty if nothing has been changed, in which case the copies share our defaults.
+            state->Properties = m_properties;
+            state->CacheOutput = m_cacheOutput;
+            state->BufferPrecision = m_bufferPrecision;
+        }
+
+        state->CachePriority = m_cachePriority;
+    }
+
+
+    void CanvasEffect::SetTemplateState(CanvasEffectTemplateState const& state, std::vector<ComPtr<IGraphicsEffectSource>> const& sources)
+    {
+        {
+            auto lock = Lock(m_mutex);
+
+            assert(!HasResource());
+            assert(IsEqualGUID(m_effectId, state.EffectId));
+            assert(state.Properties.empty() || state.Properties.size() == m_propertyDefaults.Count);
+
+            m_properties = state.Properties;
+            m_cacheOutput = state.CacheOutput;
+            m_cachePriority = state.CachePriority;
+            m_bufferPrecision = state.BufferPrecision;
+            m_name = state.Name;
+        }
+
+        if (m_sourcesVector)
+        {
+            for (auto& source : sources)
+            {
+                AppendSource(source.Get());
+            }
+        }
+        else
+        {
+            assert(m_sources.size() == sources.size());
+
+            for (unsigned int i = 0; i < sources.size(); ++i)
+            {
+                SetSource(i, sources[i].Get());
+            }
+        }
+    }
+
+
+    void CanvasEffect::ApplyAnimations(int64_t time, std::set<ICanvasEffectInternal*>* visited)
+    {
+        if (m_closed || !visited->insert(this).second)
+            return;
+
+        // Values are worked out under the lock, but set without it as the
+        // property setters take the same (non recursive) lock.
+        std::vector<std::pair<EffectAnimationTarget, Numerics::Vector4>> values;
+
+        {
+            auto lock = Lock(m_mutex);
+
+            values.reserve(m_animations.size());
+
+            for (auto& animation : m_animations)
+            {
+                values.emplace_back(animation.Target, EvaluateKeyframes(animation.Keyframes, animation.Easing, time));
+            }
+        }
+
+        for (auto& value : values)
+        {
+            SetAnimatedProperty(value.first, value.second);
+        }
+
+        unsigned int sourceCount = GetSourceCount();
+
+        for (unsigned int i = 0; i < sourceCount; ++i)
+        {
+            auto source = MaybeAs<ICanvasEffectInternal>(GetSource(i));
+
+            if (source)
+                source->ApplyAnimations(time, visited);
+        }
+    }
+
+
+    bool CanvasEffectTemplateState::GetInlineProperty(unsigned int index, PropertyType type, void* data, uint32_t size) const
+    {
+        if (!Properties.empty())
+        {
+            auto& storedProperty = Properties[index];
+
+            if (storedProperty.InlineType != type || storedProperty.InlineSize != size)
+                return false;
+
+            memcpy(data, storedProperty.InlineData, size);
+            return true;
+        }
+
+        if (!PropertyDefaults.Defaults)
+            return false;
+
+        auto& propertyDefault = PropertyDefaults.Defaults[index];
+
+        if (propertyDefault.Type != type || propertyDefault.Size != size)
+            return false;
+
+        switch (type)
+        {
+        case PropertyType_Single:
+        case PropertyType_SingleArray:
+            memcpy(data, propertyDefault.FloatValues, size);
+            break;
+
+        default:
+            memcpy(data, &propertyDefault.IntegerValue, size);
+            break;
+        }
+
+        return true;
+    }
+
+
+    void CanvasEffectTemplateState::SetInlineProperty(unsigned int index, PropertyType type, void const* data, uint32_t size)
+    {
+        // Copy the defaults the first time anything is changed. Only effects whose properties
+        // are all stored inline are changed, so there are no boxed defaults to create.
+        if (Properties.empty())
+        {
+            assert(PropertyDefaults.Defaults);
+
+            Properties.resize(PropertyDefaults.Count);
+
+            for (unsigned int i = 0; i < PropertyDefaults.Count; ++i)
+            {
+                auto& propertyDefault = PropertyDefaults.Defaults[i];
+
+                assert(propertyDefault.Type != PropertyType_InspectableArray);
+
+                if (propertyDefault.Type == PropertyType_Single || propertyDefault.Type == PropertyType_SingleArray)
+                    Properties[i].SetInline(propertyDefault.Type, propertyDefault.FloatValues, propertyDefault.Size);
+                else
+                    Properties[i].SetInline(propertyDefault.Type, &propertyDefault.IntegerValue, propertyDefault.Size);
+            }
+        }
+
+        Properties[index].SetInline(type, data, size);
+    }
+
+
     //
     // IClosable
     //
 
     IFACEMETHODIMP CanvasEffect::Close()
     {
+        InvalidateRealizedGraphs();
+        InvalidateCachedImageBounds();
+
+        ReleaseCacheEntry();
         ReleaseResource();
 
         m_realizationDevice.Reset();
+        m_parkedRealizations.clear();
         m_workaround6146411.Reset();
         m_sources.assign(m_sources.size(), SourceReference());
 
         if (m_sourcesVector)
             m_sourcesVector->InternalVector() = nullptr;
 
+        {
+            auto lock = Lock(m_mutex);
+            m_animations.clear();
+        }
+
         m_closed = true;
 
         return S_OK;
@@ -301,7 +567,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             [&]
             {
                 CheckInPointer(count);
-                *count = static_cast<UINT>(m_properties.size());
+                *count = static_cast<UINT>(m_propertyDefaults.Count);
             });
     }
 
@@ -313,7 +579,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             {
                 CheckAndClearOutPointer(value);
         
-                if (index >= m_properties.size())
+                if (index >= m_propertyDefaults.Count)
                     ThrowHR(E_BOUNDS);
 
                 ThrowIfFailed(GetProperty(index).CopyTo(value));
@@ -380,7 +646,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 // If we are realized, read the latest value from the underlying D2D resource.
                 if (auto& d2dEffect = MaybeGetResource())
                 {
-                    m_cacheOutput = !!d2dEffect->GetValue<BOOL>(D2D1_PROPERTY_CACHED);
+                    m_cacheOutput = ReadCacheOutput(d2dEffect.Get());
                 }
         
                 *value = m_cacheOutput;
@@ -396,6 +662,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 auto lock = Lock(m_mutex);
 
                 m_cacheOutput = value;
+                ++m_propertyVersion;
+
+                // Turning caching off gives back our share of the cache budget. Turning it
+                // on takes effect the next time we are drawn, when the budget is consulted.
+                if (!m_cacheOutput)
+                {
+                    ReleaseCacheEntry();
+                }
+                else
+                {
+                    // Make sure anything skipping GetD2DImage (see GetRealizedGraphGeneration)
+                    // draws us through it again, so the budget sees us being used.
+                    InvalidateRealizedGraphs();
+                }
 
                 // If we are realized, set the new value through to the underlying D2D resource.
                 if (auto& d2dEffect = MaybeGetResource())
@@ -406,6 +686,48 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
+    IFACEMETHODIMP CanvasEffect::get_CachePriority(EffectCachePriority* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto lock = Lock(m_mutex);
+
+                *value = m_cachePriority;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffect::put_CachePriority(EffectCachePriority value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                switch (value)
+                {
+                case EffectCachePriority_Low:
+                case EffectCachePriority_Normal:
+                case EffectCachePriority_High:
+                    break;
+
+                default:
+                    ThrowHR(E_INVALIDARG);
+                }
+
+                auto lock = Lock(m_mutex);
+
+                m_cachePriority = value;
+
+                if (m_cacheEntry)
+                {
+                    As<ICanvasDeviceInternal>(m_realizationDevice.GetWrapper())->GetEffectCacheBudget()->SetPriority(m_cacheEntry.get(), value);
+                }
+            });
+    }
+
+
     IFACEMETHODIMP CanvasEffect::get_BufferPrecision(IReference<CanvasBufferPrecision>** value)
     {
         return ExceptionBoundary(
@@ -455,6 +777,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                     m_bufferPrecision = D2D1_BUFFER_PRECISION_UNKNOWN;
                 }
 
+                ++m_propertyVersion;
+
                 // If we are realized, set the new value through to the underlying D2D resource.
                 if (auto& d2dEffect = MaybeGetResource())
                 {
@@ -668,73 +992,355 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    unsigned int CanvasEffect::GetSourceCount()
+    // D2D compiles the shaders for an effect graph the first time it is drawn, so
+    // PrepareAsync draws the graph into a bitmap this many pixels square.
+    static const uint32_t PrepareTargetSize = 16;
+
+
+    static void PrepareEffect(ICanvasDevice* device, ICanvasImageInternal* effect, float dpi)
     {
-        auto lock = Lock(m_mutex);
+        auto deviceContext = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+
+        auto d2dImage = effect->GetD2DImage(device, deviceContext.Get(), GetImageFlags::None, dpi);
+
+        ComPtr<ID2D1Bitmap1> target;
+        ThrowIfFailed(deviceContext->CreateBitmap(
+            D2D1::SizeU(PrepareTargetSize, PrepareTargetSize),
+            nullptr,
+            0,
+            D2D1::BitmapProperties1(
+                D2D1_BITMAP_OPTIONS_TARGET,
+                D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+                dpi,
+                dpi),
+            &target));
+
+        auto restoreState = MakeScopeWarden(
+            [&]
+            {
+                deviceContext->SetTarget(nullptr);
+                deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+                deviceContext->SetDpi(DEFAULT_DPI, DEFAULT_DPI);
+            });
 
-        auto& d2dEffect = MaybeGetResource();
+        deviceContext->SetTarget(target.Get());
+        deviceContext->SetDpi(dpi, dpi);
 
-        if (d2dEffect)
-        {
-            // If we are realized, read the count from the underlying D2D resource.
-            auto sourceCount = d2dEffect->GetInputCount();
+        // Shrink the whole image down to fit the target, so every effect in the
+        // graph contributes to what is drawn. Images with infinite or empty bounds
+        // are drawn as they are.
+        D2D1_RECT_F bounds;
+        ThrowIfFailed(deviceContext->GetImageLocalBounds(d2dImage.Get(), &bounds));
 
-            return sourceCount;
-        }
-        else
+        auto width = bounds.right - bounds.left;
+        auto height = bounds.bottom - bounds.top;
+        auto targetSize = PrepareTargetSize * DEFAULT_DPI / dpi;
+
+        deviceContext->BeginDraw();
+
+        if (std::isfinite(width) && std::isfinite(height) && width > 0 && height > 0)
         {
-            // If not realized, use our local sources vector.
-            return (unsigned)m_sources.size();
+            auto scale = std::min(1.0f, targetSize / std::max(width, height));
+
+            deviceContext->SetTransform(
+                D2D1::Matrix3x2F::Translation(-bounds.left, -bounds.top) *
+                D2D1::Matrix3x2F::Scale(scale, scale));
         }
+
+        deviceContext->DrawImage(d2dImage.Get());
+        ThrowIfFailed(deviceContext->EndDraw());
     }
 
 
-    ComPtr<IGraphicsEffectSource> CanvasEffect::GetSource(unsigned int index)
+    IFACEMETHODIMP CanvasEffect::PrepareAsync(ICanvasResourceCreator* resourceCreator, float dpi, IAsyncAction** action)
     {
-        auto lock = Lock(m_mutex);
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(action);
 
-        auto& d2dEffect = MaybeGetResource();
+                if (dpi <= 0)
+                    ThrowHR(E_INVALIDARG);
 
-        if (d2dEffect)
-        {
-            // If we are realized, read the source image from the underlying D2D resource.
-            if (index >= d2dEffect->GetInputCount())
-                ThrowHR(E_BOUNDS);
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
 
-            return GetD2DInput(d2dEffect.Get(), index);
-        }
-        else
-        {
-            // If not realized, use our local sources vector.
-            if (index >= m_sources.size())
-                ThrowHR(E_BOUNDS);
+                ComPtr<ICanvasImageInternal> self = this;
 
-            return m_sources[index].GetWrapper();
-        }
+                auto asyncAction = Make<AsyncAction>(
+                    [=]
+                    {
+                        PrepareEffect(device.Get(), self.Get(), dpi);
+                    });
+
+                CheckMakeResult(asyncAction);
+                ThrowIfFailed(asyncAction.CopyTo(action));
+            });
     }
 
 
-    // SetD2DInput options used by SetSource, InsertSource, and AppendSource.
-    const GetImageFlags SetSourceFlags = GetImageFlags::MinimalRealization | 
-                                         GetImageFlags::AllowNullEffectInputs |
-                                         GetImageFlags::UnrealizeOnFailure;
+    // Effect property names are not case sensitive, so animations are matched up by where they send their values.
+    static bool IsSameAnimationTarget(EffectAnimationTarget const& a, EffectAnimationTarget const& b)
+    {
+        return a.PropertyIndex == b.PropertyIndex &&
+               a.Mapping == b.Mapping &&
+               a.IsShaderProperty == b.IsShaderProperty;
+    }
 
 
-    void CanvasEffect::SetSource(unsigned int index, IGraphicsEffectSource* source)
+    IFACEMETHODIMP CanvasEffect::Animate(HSTRING propertyName, uint32_t keyframeCount, EffectKeyframe* keyframes, EffectAnimationEasing easing)
     {
-        auto lock = Lock(m_mutex);
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(propertyName);
+                CheckInPointer(keyframes);
 
-        auto& d2dEffect = MaybeGetResource();
+                ThrowIfClosed();
 
-        if (d2dEffect)
-        {
-            // If we are realized, set the source image through to the underlying D2D resource.
-            if (index >= d2dEffect->GetInputCount())
-                ThrowHR(E_BOUNDS);
+                ValidateAnimation(keyframeCount, keyframes, easing);
 
-            SetD2DInput(d2dEffect.Get(), index, source, SetSourceFlags);
-        }
-        else
+                EffectAnimationTrack track;
+
+                track.Keyframes.assign(keyframes, keyframes + keyframeCount);
+                track.Easing = easing;
+                track.Target = ResolveAnimationTarget(propertyName);
+
+                auto lock = Lock(m_mutex);
+
+                auto it = std::find_if(m_animations.begin(), m_animations.end(),
+                    [&](EffectAnimationTrack const& animation)
+                    {
+                        return IsSameAnimationTarget(animation.Target, track.Target);
+                    });
+
+                if (it != m_animations.end())
+                    *it = std::move(track);
+                else
+                    m_animations.push_back(std::move(track));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffect::StopAnimation(HSTRING propertyName)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(propertyName);
+
+                ThrowIfClosed();
+
+                auto target = ResolveAnimationTarget(propertyName);
+
+                auto lock = Lock(m_mutex);
+
+                m_animations.erase(
+                    std::remove_if(m_animations.begin(), m_animations.end(),
+                        [&](EffectAnimationTrack const& animation)
+                        {
+                            return IsSameAnimationTarget(animation.Target, target);
+                        }),
+                    m_animations.end());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffect::SetAnimationTime(TimeSpan time)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                ThrowIfClosed();
+
+                std::set<ICanvasEffectInternal*> visited;
+
+                ApplyAnimations(time.Duration, &visited);
+            });
+    }
+
+
+    static void ThrowUnanimatableProperty(HSTRING propertyName, wchar_t const* message)
+    {
+        WinStringBuilder builder;
+        builder.Format(message, WindowsGetStringRawBuffer(propertyName, nullptr));
+        ThrowHR(E_INVALIDARG, builder.Get());
+    }
+
+
+    // How many floats the strongly typed property exposes, or zero if the mapping can't be animated.
+    static unsigned int GetAnimatedComponentCount(GRAPHICS_EFFECT_PROPERTY_MAPPING mapping, PropertyType type, unsigned int floatCount)
+    {
+        switch (mapping)
+        {
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT:
+            return (floatCount <= 4) ? floatCount : 0;
+
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_RADIANS_TO_DEGREES:
+            return (type == PropertyType_Single) ? 1 : 0;
+
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORX:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORY:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORZ:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORW:
+            return (type == PropertyType_SingleArray && floatCount <= 4 &&
+                    static_cast<unsigned int>(mapping - GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORX) < floatCount) ? 1 : 0;
+
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_RECT_TO_VECTOR4:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_COLOR_TO_VECTOR4:
+            return (floatCount == 4) ? 4 : 0;
+
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_COLOR_TO_VECTOR3:
+            return (floatCount == 3) ? 3 : 0;
+
+        default:
+            return 0;
+        }
+    }
+
+
+    EffectAnimationTarget CanvasEffect::ResolveAnimationTarget(HSTRING propertyName)
+    {
+        auto name = WindowsGetStringRawBuffer(propertyName, nullptr);
+
+        EffectAnimationTarget target{};
+
+        if (!FindNamedProperty(GetPropertyMapping(), name, &target.PropertyIndex, &target.Mapping) &&
+            !FindNamedProperty(GetPropertyMappingHandCoded(), name, &target.PropertyIndex, &target.Mapping))
+        {
+            ThrowUnanimatableProperty(propertyName, Strings::EffectAnimationUnknownProperty);
+        }
+
+        // Only float properties with known defaults can be animated, as these
+        // are the ones whose D2D type and size are known up front.
+        if (m_propertyDefaults.Defaults && target.PropertyIndex < m_propertyDefaults.Count)
+        {
+            auto& propertyDefault = m_propertyDefaults.Defaults[target.PropertyIndex];
+
+            if (propertyDefault.Type == PropertyType_Single || propertyDefault.Type == PropertyType_SingleArray)
+            {
+                target.Type = propertyDefault.Type;
+                target.ComponentCount = propertyDefault.Size / sizeof(float);
+            }
+        }
+
+        if (!GetAnimatedComponentCount(target.Mapping, target.Type, target.ComponentCount))
+            ThrowUnanimatableProperty(propertyName, Strings::EffectAnimationUnsupportedProperty);
+
+        return target;
+    }
+
+
+    void CanvasEffect::SetAnimatedProperty(EffectAnimationTarget const& target, Numerics::Vector4 const& value)
+    {
+        float values[4] = { value.X, value.Y, value.Z, value.W };
+
+        switch (target.Mapping)
+        {
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_RADIANS_TO_DEGREES:
+            values[0] = ::DirectX::XMConvertToDegrees(value.X);
+            break;
+
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORX:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORY:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORZ:
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORW:
+            // Only one component of the D2D vector is animated, so keep the others.
+            GetInlineProperty(target.PropertyIndex, target.Type, values, target.ComponentCount * sizeof(float));
+            values[target.Mapping - GRAPHICS_EFFECT_PROPERTY_MAPPING_VECTORX] = value.X;
+            break;
+
+        case GRAPHICS_EFFECT_PROPERTY_MAPPING_RECT_TO_VECTOR4:
+            values[2] = value.X + value.Z;
+            values[3] = value.Y + value.W;
+            break;
+        }
+
+        SetInlineProperty(target.PropertyIndex, target.Type, values, target.ComponentCount * sizeof(float));
+    }
+
+
+    unsigned int CanvasEffect::GetSourceCount()
+    {
+        auto lock = Lock(m_mutex);
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            // If we are realized, read the count from the underlying D2D resource.
+            auto sourceCount = d2dEffect->GetInputCount();
+
+            return sourceCount;
+        }
+        else
+        {
+            // If not realized, use our local sources vector.
+            return (unsigned)m_sources.size();
+        }
+    }
+
+
+    ComPtr<IGraphicsEffectSource> CanvasEffect::GetSource(unsigned int index)
+    {
+        auto lock = Lock(m_mutex);
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            // If we are realized, read the source image from the underlying D2D resource.
+            if (index >= d2dEffect->GetInputCount())
+                ThrowHR(E_BOUNDS);
+
+            return GetD2DInput(d2dEffect.Get(), index);
+        }
+        else
+        {
+            // If not realized, use our local sources vector.
+            if (index >= m_sources.size())
+                ThrowHR(E_BOUNDS);
+
+            return m_sources[index].GetWrapper();
+        }
+    }
+
+
+    HRESULT CanvasEffect::SetSourceNoThrow(unsigned int index, IGraphicsEffectSource* source)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                SetSource(index, source);
+            });
+    }
+
+
+    // SetD2DInput options used by SetSource, InsertSource, and AppendSource.
+    const GetImageFlags SetSourceFlags = GetImageFlags::MinimalRealization | 
+                                         GetImageFlags::AllowNullEffectInputs |
+                                         GetImageFlags::UnrealizeOnFailure;
+
+
+    void CanvasEffect::SetSource(unsigned int index, IGraphicsEffectSource* source)
+    {
+        auto lock = Lock(m_mutex);
+
+        InvalidateRealizedGraphs();
+        InvalidateCachedImageBounds();
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            // If we are realized, set the source image through to the underlying D2D resource.
+            if (index >= d2dEffect->GetInputCount())
+                ThrowHR(E_BOUNDS);
+
+            SetD2DInput(d2dEffect.Get(), index, source, SetSourceFlags);
+        }
+        else
         {
             // If not realized, use our local sources vector.
             if (index >= m_sources.size())
@@ -748,6 +1354,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::InsertSource(unsigned int index, IGraphicsEffectSource* source)
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateRealizedGraphs();
+        InvalidateCachedImageBounds();
         
         auto& d2dEffect = MaybeGetResource();
 
@@ -788,6 +1397,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::RemoveSource(unsigned int index)
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateRealizedGraphs();
+        InvalidateCachedImageBounds();
         
         auto& d2dEffect = MaybeGetResource();
 
@@ -835,6 +1447,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::AppendSource(IGraphicsEffectSource* source)
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateRealizedGraphs();
+        InvalidateCachedImageBounds();
         
         auto& d2dEffect = MaybeGetResource();
 
@@ -858,6 +1473,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::ClearSources()
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateRealizedGraphs();
+        InvalidateCachedImageBounds();
         
         // Effects with variable number of inputs don't allow zero of them,
         // so we must unrealize before we can clear the collection.
@@ -1005,6 +1623,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 if (resourceChanged || dpiChanged)
                 {
                     SetEffectInput(d2dEffect.Get(), i, realizedSource.Get());
+                    InvalidateRealizedGraphs();
                 }
             }
         }
@@ -1120,7 +1739,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         auto lock = Lock(m_mutex);
 
-        assert(index < m_properties.size());
+        assert(index < m_propertyDefaults.Count);
+
+        ++m_propertyVersion;
+        InvalidateCachedImageBounds();
 
         auto& d2dEffect = MaybeGetResource();
 
@@ -1132,7 +1754,215 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         else
         {
             // If we are not realized, directly store the property value.
-            m_properties[index] = propertyValue;
+            GetWritableStoredProperty(index).SetBoxed(propertyValue);
+        }
+    }
+
+
+    void CanvasEffect::SetInlineProperty(unsigned int index, PropertyType type, void const* data, uint32_t size)
+    {
+        auto lock = Lock(m_mutex);
+
+        assert(index < m_propertyDefaults.Count);
+
+        ++m_propertyVersion;
+        InvalidateCachedImageBounds();
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            // If we are realized, the value is already in the format D2D wants.
+            ThrowIfFailed(d2dEffect->SetValue(index, static_cast<BYTE const*>(data), size));
+        }
+        else
+        {
+            GetWritableStoredProperty(index).SetInline(type, data, size);
+        }
+    }
+
+
+    void CanvasEffect::GetInlineProperty(unsigned int index, PropertyType type, void* data, uint32_t size)
+    {
+        auto lock = Lock(m_mutex);
+
+        assert(index < m_propertyDefaults.Count);
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            ThrowIfFailed(d2dEffect->GetValue(index, static_cast<BYTE*>(data), size));
+            return;
+        }
+
+        StoredProperty defaultValue;
+        auto& storedProperty = GetStoredProperty(index, &defaultValue);
+
+        if (storedProperty.IsInline())
+        {
+            if (storedProperty.InlineSize != size)
+                ThrowHR(E_BOUNDS);
+
+            memcpy(data, storedProperty.InlineData, size);
+            return;
+        }
+
+        // Values that were not set through the strongly typed API (for instance read back
+        // from a D2D blob property) may still be boxed, so unbox them into D2D form.
+        auto propertyValue = storedProperty.BoxedValue.Get();
+
+        if (!propertyValue)
+            ThrowHR(E_UNEXPECTED);
+
+        switch (type)
+        {
+        case PropertyType_Boolean:
+            {
+                assert(size == sizeof(BOOL));
+                boolean value;
+                ThrowIfFailed(propertyValue->GetBoolean(&value));
+                *static_cast<BOOL*>(data) = value;
+            }
+            break;
+
+        case PropertyType_Int32:
+            assert(size == sizeof(INT32));
+            ThrowIfFailed(propertyValue->GetInt32(static_cast<INT32*>(data)));
+            break;
+
+        case PropertyType_UInt32:
+            assert(size == sizeof(UINT32));
+            ThrowIfFailed(propertyValue->GetUInt32(static_cast<UINT32*>(data)));
+            break;
+
+        case PropertyType_Single:
+            assert(size == sizeof(float));
+            ThrowIfFailed(propertyValue->GetSingle(static_cast<float*>(data)));
+            break;
+
+        case PropertyType_SingleArray:
+            {
+                ComArray<float> value;
+                ThrowIfFailed(propertyValue->GetSingleArray(value.GetAddressOfSize(), value.GetAddressOfData()));
+
+                if (value.GetSize() * sizeof(float) != size)
+                    ThrowHR(E_BOUNDS);
+
+                memcpy(data, value.GetData(), size);
+            }
+            break;
+
+        default:
+            ThrowHR(E_NOTIMPL);
+        }
+    }
+
+
+    void CanvasEffect::StoredProperty::SetInline(PropertyType type, void const* data, uint32_t size)
+    {
+        assert(type != PropertyType_Empty);
+        assert(size <= MaxInlineSize);
+
+        InlineType = type;
+        InlineSize = size;
+        memcpy(InlineData, data, size);
+
+        BoxedValue.Reset();
+    }
+
+
+    void CanvasEffect::StoredProperty::SetBoxed(IPropertyValue* propertyValue)
+    {
+        InlineType = PropertyType_Empty;
+        InlineSize = 0;
+
+        BoxedValue = propertyValue;
+    }
+
+
+    CanvasEffect::StoredProperty const& CanvasEffect::GetStoredProperty(unsigned int index, StoredProperty* defaultValue)
+    {
+        if (!m_properties.empty())
+            return m_properties[index];
+
+        GetDefaultProperty(index, defaultValue);
+
+        return *defaultValue;
+    }
+
+
+    CanvasEffect::StoredProperty& CanvasEffect::GetWritableStoredProperty(unsigned int index)
+    {
+        // Copy the defaults the first time anything is changed.
+        if (m_properties.empty())
+        {
+            m_properties.resize(m_propertyDefaults.Count);
+
+            for (unsigned int i = 0; i < m_propertyDefaults.Count; ++i)
+            {
+                GetDefaultProperty(i, &m_properties[i]);
+            }
+        }
+
+        return m_properties[index];
+    }
+
+
+    void CanvasEffect::GetDefaultProperty(unsigned int index, StoredProperty* storedProperty)
+    {
+        if (!m_propertyDefaults.Defaults)
+            return;
+
+        auto& propertyDefault = m_propertyDefaults.Defaults[index];
+
+        assert(propertyDefault.Index == index);
+
+        switch (propertyDefault.Type)
+        {
+        case PropertyType_Single:
+        case PropertyType_SingleArray:
+            storedProperty->SetInline(propertyDefault.Type, propertyDefault.FloatValues, propertyDefault.Size);
+            break;
+
+        case PropertyType_InspectableArray:
+            storedProperty->SetBoxed(CreateProperty(m_propertyValueFactory.Get(), static_cast<IInspectable*>(nullptr)).Get());
+            break;
+
+        default:
+            storedProperty->SetInline(propertyDefault.Type, &propertyDefault.IntegerValue, propertyDefault.Size);
+            break;
+        }
+    }
+
+
+    ComPtr<IPropertyValue> CanvasEffect::BoxStoredProperty(StoredProperty const& storedProperty)
+    {
+        auto factory = m_propertyValueFactory.Get();
+        auto data = storedProperty.InlineData;
+
+        switch (storedProperty.InlineType)
+        {
+        case PropertyType_Empty:
+            return storedProperty.BoxedValue;
+
+        case PropertyType_Boolean:
+            return CreateProperty(factory, static_cast<boolean>(!!*reinterpret_cast<BOOL const*>(data)));
+
+        case PropertyType_Int32:
+            return CreateProperty(factory, *reinterpret_cast<INT32 const*>(data));
+
+        case PropertyType_UInt32:
+            return CreateProperty(factory, *reinterpret_cast<UINT32 const*>(data));
+
+        case PropertyType_Single:
+            return CreateProperty(factory, *reinterpret_cast<float const*>(data));
+
+        case PropertyType_SingleArray:
+            return CreateProperty(factory, storedProperty.InlineSize / static_cast<uint32_t>(sizeof(float)), reinterpret_cast<float const*>(data));
+
+        default:
+            ThrowHR(E_NOTIMPL);
         }
     }
 
@@ -1212,7 +2042,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         auto lock = Lock(m_mutex);
 
-        assert(index < m_properties.size());
+        assert(index < m_propertyDefaults.Count);
 
         auto& d2dEffect = MaybeGetResource();
 
@@ -1223,8 +2053,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
         else
         {
-            // If we are not realized, directly return the property value.
-            return m_properties[index];
+            // If we are not realized, return the stored property value (boxing it if it is held inline).
+            StoredProperty defaultValue;
+            return BoxStoredProperty(GetStoredProperty(index, &defaultValue));
         }
     }
 
@@ -1309,6 +2140,38 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
+    void CanvasEffect::GetD2DPropertyAsStored(ID2D1Effect* d2dEffect, unsigned int index, StoredProperty* storedProperty)
+    {
+        PropertyType type;
+        uint32_t size;
+
+        switch (d2dEffect->GetType(index))
+        {
+        case D2D1_PROPERTY_TYPE_BOOL:       type = PropertyType_Boolean;     size = sizeof(BOOL);                 break;
+        case D2D1_PROPERTY_TYPE_INT32:      type = PropertyType_Int32;       size = sizeof(INT32);                break;
+        case D2D1_PROPERTY_TYPE_UINT32:     type = PropertyType_Int32;       size = sizeof(INT32);                break;  // Matches GetD2DProperty.
+        case D2D1_PROPERTY_TYPE_ENUM:       type = PropertyType_UInt32;      size = sizeof(UINT32);               break;
+        case D2D1_PROPERTY_TYPE_FLOAT:      type = PropertyType_Single;      size = sizeof(float);                break;
+        case D2D1_PROPERTY_TYPE_VECTOR2:    type = PropertyType_SingleArray; size = sizeof(D2D1_VECTOR_2F);       break;
+        case D2D1_PROPERTY_TYPE_VECTOR3:    type = PropertyType_SingleArray; size = sizeof(D2D1_VECTOR_3F);       break;
+        case D2D1_PROPERTY_TYPE_VECTOR4:    type = PropertyType_SingleArray; size = sizeof(D2D1_VECTOR_4F);       break;
+        case D2D1_PROPERTY_TYPE_MATRIX_3X2: type = PropertyType_SingleArray; size = sizeof(D2D1_MATRIX_3X2_F);    break;
+        case D2D1_PROPERTY_TYPE_MATRIX_4X4: type = PropertyType_SingleArray; size = sizeof(D2D1_MATRIX_4X4_F);    break;
+        case D2D1_PROPERTY_TYPE_MATRIX_5X4: type = PropertyType_SingleArray; size = sizeof(D2D1_MATRIX_5X4_F);    break;
+
+        default:
+            // Blobs, interfaces and color contexts stay boxed.
+            storedProperty->SetBoxed(GetD2DProperty(d2dEffect, index).Get());
+            return;
+        }
+
+        BYTE value[StoredProperty::MaxInlineSize];
+        ThrowIfFailed(d2dEffect->GetValue(index, value, size));
+
+        storedProperty->SetInline(type, value, size);
+    }
+
+
     bool CanvasEffect::Realize(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext)
     {
         assert(!HasResource());
@@ -1319,21 +2182,42 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ThrowHR(E_INVALIDARG, Strings::EffectNoSources);
         }
 
-        // Create a new D2D effect instance.
-        auto d2dEffect = CreateD2DEffect(deviceContext, m_effectId);
+        // Realizing the sources nests their events inside this one.
+        EventWrite_CanvasEffect_Realize_Start(&m_effectId, static_cast<uint32_t>(m_sources.size()));
+        auto realizeEnd = MakeScopeWarden([] { EventWrite_CanvasEffect_Realize_Stop(); });
 
-        // Transfer property values from our resource independent m_properties store to the D2D effect.
-        for (unsigned i = 0; i < m_properties.size(); ++i)
+        // Reuse the D2D effect we parked on this device earlier, or create a new one.
+        bool propertiesAreCurrent;
+        auto d2dEffect = TakeParkedRealization(&propertiesAreCurrent);
+        bool isNewEffect = !d2dEffect;
+
+        if (isNewEffect)
         {
-            SetD2DProperty(d2dEffect.Get(), i, m_properties[i].Get());
+            d2dEffect = CreateD2DEffect(deviceContext, m_effectId);
         }
 
-        // Also transfer the special properties that are common to all effects (CacheOutput and BufferPrecision).
-        if (m_cacheOutput)
-            ThrowIfFailed(d2dEffect->SetValue(D2D1_PROPERTY_CACHED, static_cast<BOOL>(true)));
+        if (!propertiesAreCurrent)
+        {
+            // Transfer property values from our resource independent m_properties store to the D2D effect.
+            for (unsigned i = 0; i < m_propertyDefaults.Count; ++i)
+            {
+                StoredProperty defaultValue;
+                auto& storedProperty = GetStoredProperty(i, &defaultValue);
+
+                if (storedProperty.IsInline())
+                    ThrowIfFailed(d2dEffect->SetValue(i, storedProperty.InlineData, storedProperty.InlineSize));
+                else
+                    SetD2DProperty(d2dEffect.Get(), i, storedProperty.BoxedValue.Get());
+            }
 
-        if (m_bufferPrecision != D2D1_BUFFER_PRECISION_UNKNOWN)
-            ThrowIfFailed(d2dEffect->SetValue(D2D1_PROPERTY_PRECISION, m_bufferPrecision));
+            // Also transfer the special properties that are common to all effects (CacheOutput and BufferPrecision).
+            // A new effect already has the default values, but a reused one may not.
+            if (m_cacheOutput || !isNewEffect)
+                ThrowIfFailed(d2dEffect->SetValue(D2D1_PROPERTY_CACHED, static_cast<BOOL>(m_cacheOutput)));
+
+            if (m_bufferPrecision != D2D1_BUFFER_PRECISION_UNKNOWN || !isNewEffect)
+                ThrowIfFailed(d2dEffect->SetValue(D2D1_PROPERTY_PRECISION, m_bufferPrecision));
+        }
 
         // Transfer input images across to the D2D effect.
         ThrowIfFailed(d2dEffect->SetInputCount((unsigned)m_sources.size()));
@@ -1345,11 +2229,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
 
         // Wipe m_properties, as the D2D effect is now the One True Source Of Authoritativeness.
-        m_properties.assign(m_properties.size(), nullptr);
+        m_properties.clear();
 
         // Store the new effect.
         SetResource(d2dEffect.Get());
 
+        InvalidateRealizedGraphs();
+
+        PerformanceCounters::Increment(PerformanceCounter::EffectRealizations);
+
         return true;
     }
 
@@ -1360,16 +2248,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         if (d2dEffect)
         {
+            PerformanceCounters::Increment(PerformanceCounter::EffectUnrealizations);
+
             // Transfer property values from the D2D effect to our resource independent m_properties store.
-            for (unsigned i = 0; i < m_properties.size(); ++i)
+            m_properties.resize(m_propertyDefaults.Count);
+
+            for (unsigned i = 0; i < m_propertyDefaults.Count; ++i)
             {
-                m_properties[i] = GetD2DProperty(d2dEffect.Get(), i);
+                GetD2DPropertyAsStored(d2dEffect.Get(), i, &m_properties[i]);
             }
 
             // Also transfer the special properties that are common to all effects (CacheOutput and BufferPrecision).
-            m_cacheOutput = !!d2dEffect->GetValue<BOOL>(D2D1_PROPERTY_CACHED);
+            m_cacheOutput = ReadCacheOutput(d2dEffect.Get());
             m_bufferPrecision = d2dEffect->GetValue<D2D1_BUFFER_PRECISION>(D2D1_PROPERTY_PRECISION);
 
+            // A D2D effect that is parked or thrown away must not hold on to cached output memory.
+            ReleaseCacheEntry();
+
             // Read back the list of source images from the D2D effect.
             if (!skipAllSources)
             {
@@ -1392,7 +2287,140 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ReleaseResource();
 
             m_workaround6146411.Reset();
+
+            InvalidateRealizedGraphs();
+        }
+    }
+
+
+    void CanvasEffect::ChangeRealizationDevice(ID2D1Device* d2dDevice, ICanvasDevice* device)
+    {
+        // Keep hold of the D2D effect while unrealizing, so it can be parked for reuse.
+        // Effects visible through interop may be changed behind our back, so are never parked.
+        ComPtr<ID2D1Effect> previousEffect = m_isExternallyVisible ? nullptr : MaybeGetResource();
+        ComPtr<IUnknown> previousDevice = m_realizationDevice.GetResource();
+
+        Unrealize();
+
+        if (previousEffect)
+        {
+            if (m_parkedRealizations.size() >= MaxParkedRealizations)
+            {
+                m_parkedRealizations.erase(m_parkedRealizations.begin());
+            }
+
+            m_parkedRealizations.push_back(ParkedRealization{ previousDevice, previousEffect, m_propertyVersion });
+        }
+
+        m_realizationDevice.Set(d2dDevice, device);
+    }
+
+
+    ComPtr<ID2D1Effect> CanvasEffect::TakeParkedRealization(bool* propertiesAreCurrent)
+    {
+        *propertiesAreCurrent = false;
+
+        auto device = m_realizationDevice.GetResource();
+
+        for (auto it = m_parkedRealizations.begin(); it != m_parkedRealizations.end(); ++it)
+        {
+            if (IsSameInstance(it->Device.Get(), device))
+            {
+                auto d2dEffect = it->Effect;
+
+                *propertiesAreCurrent = (it->PropertyVersion == m_propertyVersion);
+
+                m_parkedRealizations.erase(it);
+
+                return d2dEffect;
+            }
+        }
+
+        return nullptr;
+    }
+
+
+    void CanvasEffect::UpdateCacheBudget(ICanvasDevice* device, ID2D1DeviceContext* deviceContext)
+    {
+        auto budget = As<ICanvasDeviceInternal>(device)->GetEffectCacheBudget();
+
+        if (m_cacheEntry && m_cacheEntry->IsCached)
+        {
+            budget->Touch(m_cacheEntry.get());
+            return;
         }
+
+        // Either newly realized, or previously turned away or evicted, so (re)apply for space.
+        if (!m_cacheEntry)
+        {
+            m_cacheEntry = std::make_shared<EffectCacheEntry>(GetResource().Get(), m_cachePriority);
+        }
+
+        budget->TryAdmit(m_cacheEntry, EstimateCachedOutputSize(deviceContext));
+    }
+
+
+    void CanvasEffect::ReleaseCacheEntry()
+    {
+        if (!m_cacheEntry)
+            return;
+
+        if (auto device = m_realizationDevice.GetWrapper())
+        {
+            As<ICanvasDeviceInternal>(device)->GetEffectCacheBudget()->Release(m_cacheEntry.get());
+        }
+
+        m_cacheEntry.reset();
+    }
+
+
+    bool CanvasEffect::ReadCacheOutput(ID2D1Effect* d2dEffect)
+    {
+        // If the budget has switched caching off, CacheOutput keeps reporting what was asked for.
+        bool isEvicted = m_cacheEntry && !m_cacheEntry->IsCached;
+
+        return !!d2dEffect->GetValue<BOOL>(D2D1_PROPERTY_CACHED) || isEvicted;
+    }
+
+
+    static uint64_t GetBytesPerPixel(D2D1_BUFFER_PRECISION bufferPrecision)
+    {
+        switch (bufferPrecision)
+        {
+        case D2D1_BUFFER_PRECISION_16BPC_UNORM:
+        case D2D1_BUFFER_PRECISION_16BPC_FLOAT:
+            return 8;
+
+        case D2D1_BUFFER_PRECISION_32BPC_FLOAT:
+            return 16;
+
+        default:
+            return 4;
+        }
+    }
+
+
+    uint64_t CanvasEffect::EstimateCachedOutputSize(ID2D1DeviceContext* deviceContext)
+    {
+        // D2D doesn't report how large a cached output is, so charge for a bitmap the size of our output bounds.
+        ComPtr<ID2D1Image> output;
+        GetResource()->GetOutput(&output);
+
+        D2D1_RECT_F bounds;
+        ThrowIfFailed(deviceContext->GetImageLocalBounds(output.Get(), &bounds));
+
+        float dpiX, dpiY;
+        deviceContext->GetDpi(&dpiX, &dpiY);
+
+        // Unbounded outputs (eg. from a flood effect) are charged as the largest bitmap the device supports.
+        auto maximumBitmapSize = static_cast<float>(deviceContext->GetMaximumBitmapSize());
+
+        auto width = std::min(std::max(bounds.right - bounds.left, 0.0f) * dpiX / DEFAULT_DPI, maximumBitmapSize);
+        auto height = std::min(std::max(bounds.bottom - bounds.top, 0.0f) * dpiY / DEFAULT_DPI, maximumBitmapSize);
+
+        auto pixelCount = static_cast<uint64_t>(ceil(width)) * static_cast<uint64_t>(ceil(height));
+
+        return pixelCount * GetBytesPerPixel(m_bufferPrecision);
     }
 
 
@@ -1404,4 +2432,45 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
     }
 
+
+    uint64_t CanvasEffect::GetRealizedGraphGeneration()
+    {
+        if (s_externallyVisibleEffectCount != 0)
+            return 0;
+
+        return s_graphGeneration;
+    }
+
+
+    bool CanvasEffect::IsGraphValidated(GetImageFlags flags, float targetDpi)
+    {
+        return m_validatedGeneration == s_graphGeneration &&
+               m_validatedFlags == flags &&
+               m_validatedTargetDpi == targetDpi &&
+               s_externallyVisibleEffectCount == 0;
+    }
+
+
+    CachedImageBounds* CanvasEffect::GetCachedBounds()
+    {
+        // While any D2D effects are visible through interop, the graph may be changed behind our back.
+        if (s_externallyVisibleEffectCount != 0)
+            return nullptr;
+
+        return &m_cachedBounds;
+    }
+
+
+    void CanvasEffect::MarkExternallyVisible()
+    {
+        if (!m_isExternallyVisible)
+        {
+            m_isExternallyVisible = true;
+            ++s_externallyVisibleEffectCount;
+
+            // From now on this effect can be changed without us knowing, so bounds can't be cached.
+            InvalidateCachedImageBounds();
+        }
+    }
+
 }}}}}
@@ -29,6 +29,96 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     };
 
 
+    // Default property values created by codegen, stored in the same binary form that D2D
+    // uses. These are constant tables, so constructing an effect does not need to box or
+    // store anything until one of its properties is changed.
+    struct EffectPropertyDefault
+    {
+        static const uint32_t MaxFloatCount = 20;   // Large enough for Matrix5x4.
+
+        UINT Index;
+        PropertyType Type;                          // PropertyType_InspectableArray means a null interface pointer.
+        uint32_t Size;
+        uint32_t IntegerValue;
+        float FloatValues[MaxFloatCount];
+    };
+
+    struct EffectPropertyDefaultTable
+    {
+        EffectPropertyDefault const* Defaults;      // Null if the properties have no default values.
+        unsigned int Count;
+    };
+
+    template<size_t N>
+    constexpr EffectPropertyDefaultTable MakeEffectPropertyDefaultTable(EffectPropertyDefault const (&defaults)[N])
+    {
+        return EffectPropertyDefaultTable{ defaults, static_cast<unsigned int>(N) };
+    }
+
+    // Valid range of a property, created by codegen from the Min and Max values in the effect
+    // description. Bounds are inclusive, and vectors are checked one component at a time.
+    // These are constant data, so a validated put_ is a call into one shared range check
+    // per property type rather than a check compiled into each accessor.
+    template<typename T>
+    struct EffectPropertyRange
+    {
+        T Min;
+        T Max;
+    };
+
+    template<typename T>
+    inline bool IsInEffectPropertyRange(T const& value, EffectPropertyRange<T> const& range)
+    {
+        return (value >= range.Min) && (value <= range.Max);
+    }
+
+    inline bool IsInEffectPropertyRange(Numerics::Vector2 const& value, EffectPropertyRange<Numerics::Vector2> const& range)
+    {
+        return (value.X >= range.Min.X) && (value.Y >= range.Min.Y) &&
+               (value.X <= range.Max.X) && (value.Y <= range.Max.Y);
+    }
+
+    inline bool IsInEffectPropertyRange(Numerics::Vector3 const& value, EffectPropertyRange<Numerics::Vector3> const& range)
+    {
+        return (value.X >= range.Min.X) && (value.Y >= range.Min.Y) && (value.Z >= range.Min.Z) &&
+               (value.X <= range.Max.X) && (value.Y <= range.Max.Y) && (value.Z <= range.Max.Z);
+    }
+
+    inline bool IsInEffectPropertyRange(Numerics::Vector4 const& value, EffectPropertyRange<Numerics::Vector4> const& range)
+    {
+        return (value.X >= range.Min.X) && (value.Y >= range.Min.Y) && (value.Z >= range.Min.Z) && (value.W >= range.Min.W) &&
+               (value.X <= range.Max.X) && (value.Y <= range.Max.Y) && (value.Z <= range.Max.Z) && (value.W <= range.Max.W);
+    }
+
+
+    // Defaults are looked up by D2D property index, so the table must not have any gaps.
+    template<size_t N>
+    constexpr bool AreEffectPropertyDefaultsInIndexOrder(EffectPropertyDefault const (&defaults)[N], size_t i = 0)
+    {
+        return (i == N) || (defaults[i].Index == i && AreEffectPropertyDefaultsInIndexOrder(defaults, i + 1));
+    }
+
+
+    // Defined after CanvasEffect.
+    struct CanvasEffectTemplateState;
+
+
+    // Lets CanvasEffectGraphTemplate capture an effect, and then stamp out unrealized copies of it.
+    class __declspec(uuid("6C1F6E0A-3D2B-4C5E-9A7F-2E8B4D1C0F93"))
+    ICanvasEffectInternal : public IUnknown
+    {
+    public:
+        // Captures everything about the effect except for its sources, which are returned separately.
+        virtual void GetTemplateState(CanvasEffectTemplateState* state, std::vector<ComPtr<IGraphicsEffectSource>>* sources) = 0;
+
+        // Only valid on a newly created effect of the same type as the one the state was captured from.
+        virtual void SetTemplateState(CanvasEffectTemplateState const& state, std::vector<ComPtr<IGraphicsEffectSource>> const& sources) = 0;
+
+        // Applies this effect's animations, then those of its sources. Effects already in visited are skipped.
+        virtual void ApplyAnimations(int64_t time, std::set<ICanvasEffectInternal*>* visited) = 0;
+    };
+
+
     class CanvasEffect
         : public Implements<
             RuntimeClassFlags<WinRtClassicComMix>,
@@ -38,11 +128,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ICanvasEffect,
             ICanvasImage,
             CloakedIid<ICanvasImageInternal>,
+            CloakedIid<ICanvasEffectInternal>,
             ChainInterfaces<
                 MixIn<CanvasEffect, ResourceWrapper<ID2D1Effect, CanvasEffect, IGraphicsEffect>>,
                 IClosable,
                 CloakedIid<ICanvasResourceWrapperNative>>>
         , public ResourceWrapper<ID2D1Effect, CanvasEffect, IGraphicsEffect>
+        , private ObjectCounter<CountedObjectType::Effect>
     {
         // Unlike other objects, a null ID2D1Effect does not necessarily indicate the object was closed.
         bool m_closed; 
@@ -56,12 +148,92 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // What device are we currently realized on?
         CachedResourceReference<ID2D1Device, ICanvasDevice> m_realizationDevice;
 
-        // Effect property values (only used when the effect is not realized).
-        std::vector<ComPtr<IPropertyValue>> m_properties;
+        // When the effect is drawn on a different device, the D2D effect from the previous device
+        // is parked here rather than destroyed, so switching back can reuse it instead of creating
+        // a new one. This keeps alternating between a few devices (eg. one per monitor) cheap.
+        // Parked effects are used least recently first, and keep their inputs until reused.
+        struct ParkedRealization
+        {
+            ComPtr<IUnknown> Device;
+            ComPtr<ID2D1Effect> Effect;
+            uint64_t PropertyVersion;       // m_propertyVersion when the effect was parked.
+        };
+
+        static const size_t MaxParkedRealizations = 2;
+
+        std::vector<ParkedRealization> m_parkedRealizations;
+
+        // Incremented whenever a property, CacheOutput or BufferPrecision is changed. A parked
+        // effect whose PropertyVersion still matches does not need its properties set again.
+        uint64_t m_propertyVersion;
+
+        // Drawing a realized effect normally walks the whole effect graph (see RefreshInputs)
+        // to make sure it is still connected up correctly. To make that free when nothing has
+        // changed, anything that can alter how a realized graph is connected (changing sources,
+        // realizing, unrealizing or closing an effect, or adding/removing DPI compensation)
+        // bumps s_graphGeneration. Property changes don't, as they go straight through to D2D.
+        //
+        // After a successful RefreshInputs we record the generation, flags and target DPI it
+        // ran with. If none of those have changed by the next draw, the walk can be skipped.
+        static std::atomic<uint64_t> s_graphGeneration;
+
+        uint64_t m_validatedGeneration;
+        GetImageFlags m_validatedFlags;
+        float m_validatedTargetDpi;
+
+        // Once an ID2D1Effect has been exposed through interop, it can be modified without
+        // us knowing. While any such effects exist we always walk the whole graph.
+        static std::atomic<uint32_t> s_externallyVisibleEffectCount;
+        bool m_isExternallyVisible;
+
+        // Result of the last GetBounds call. Changing the sources or properties of any
+        // effect discards every cached result (see InvalidateCachedImageBounds).
+        CachedImageBounds m_cachedBounds;
+
+        // Effect property values (only used when the effect is not realized). Scalar, vector and
+        // matrix values are stored inline in the same binary form that D2D uses, so they can be
+        // set and read back without boxing. Anything else (interfaces and variable length
+        // arrays) is kept as an IPropertyValue.
+        struct StoredProperty
+        {
+            static const uint32_t MaxInlineSize = sizeof(float[20]);    // Large enough for Matrix5x4.
+
+            PropertyType InlineType;    // PropertyType_Empty if the value is not stored inline.
+            uint32_t InlineSize;
+            BYTE InlineData[MaxInlineSize];
+
+            ComPtr<IPropertyValue> BoxedValue;
+
+            StoredProperty()
+                : InlineType(PropertyType_Empty)
+                , InlineSize(0)
+            { }
+
+            bool IsInline() const { return InlineType != PropertyType_Empty; }
+
+            void SetInline(PropertyType type, void const* data, uint32_t size);
+            void SetBoxed(IPropertyValue* propertyValue);
+        };
+
+        // m_properties stays empty while every property still has its default value, in which
+        // case values are read straight from m_propertyDefaults. It is filled in the first time
+        // a property is changed.
+        EffectPropertyDefaultTable m_propertyDefaults;
+        std::vector<StoredProperty> m_properties;
 
         boolean m_cacheOutput;
         D2D1_BUFFER_PRECISION m_bufferPrecision;
 
+        // While CacheOutput is enabled and the effect is realized, whether D2D actually caches
+        // the output is decided by the realization device's EffectCacheBudget. m_cacheEntry is
+        // how the budget knows about us; if it has been evicted D2D1_PROPERTY_CACHED reads back
+        // as false, but m_cacheOutput stays true so caching can resume when there is room.
+        EffectCachePriority m_cachePriority;
+        std::shared_ptr<EffectCacheEntry> m_cacheEntry;
+
+        // Keyframe animations, applied by SetAnimationTime. At most one per property.
+        std::vector<EffectAnimationTrack> m_animations;
+
         // Workaround Windows bug 6146411 (crash when reading back DESTINATION_COLOR_CONTEXT from a CLSID_D2D1ColorManagement effect).
         ComPtr<IUnknown> m_workaround6146411;
 
@@ -124,9 +296,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         static std::pair<IID, MakeEffectFunction> m_effectMakers[];
 
+        // Hash index over m_effectMakers, so interop can find the right maker without a linear scan.
+        typedef std::unordered_map<IID, MakeEffectFunction, IIDHash> EffectMakerIndex;
+
+        static EffectMakerIndex const& GetEffectMakerIndex();
+
+        friend struct CanvasEffectTemplateState;
+
 
     protected:
-        // Constructor.
+        // Constructors. Effects that pass only a propertiesSize start out with empty property values.
+        CanvasEffect(IID const& m_effectId, EffectPropertyDefaultTable const& propertyDefaults, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable);
         CanvasEffect(IID const& m_effectId, unsigned int propertiesSize, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable);
 
         virtual ~CanvasEffect();
@@ -134,6 +314,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual EffectPropertyMappingTable GetPropertyMapping()          { return EffectPropertyMappingTable{ nullptr, 0 }; }
         virtual EffectPropertyMappingTable GetPropertyMappingHandCoded() { return EffectPropertyMappingTable{ nullptr, 0 }; }
 
+        // Works out where Animate should send values for the named property, throwing if it cannot be animated.
+        // Overridden by effects that have properties beyond the D2D ones, such as PixelShaderEffect.
+        virtual EffectAnimationTarget ResolveAnimationTarget(HSTRING propertyName);
+        virtual void SetAnimatedProperty(EffectAnimationTarget const& target, Numerics::Vector4 const& value);
+
         ComPtr<SourcesVector> const& Sources() { return m_sourcesVector; }
         
         ICanvasDevice* RealizationDevice() { return m_realizationDevice.GetWrapper(); }
@@ -143,6 +328,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     public:
         // Used by ResourceManager::GetOrCreate.
         static bool TryCreateEffect(ICanvasDevice* device, IUnknown* resource, float dpi, ComPtr<IInspectable>* result);
+
+        // Lets callers that hold on to a realized effect (such as CanvasImageBrush) tell
+        // whether any realized graph may have changed since they last looked. Returns
+        // zero, which never matches, while effects are visible through interop.
+        static uint64_t GetRealizedGraphGeneration();
+
+        // Bumps s_graphGeneration. Other kinds of image reach this through
+        // InvalidateRealizedImageGraphs (see ICanvasImageInternal).
+        static void InvalidateRealizedGraphs() { ++s_graphGeneration; }
             
         //
         // ICanvasImage
@@ -163,6 +357,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         IFACEMETHOD(GetNativeResource)(ICanvasDevice* device, float dpi, REFIID iid, void** resource) override;
 
+        //
+        // ICanvasEffectInternal
+        //
+
+        virtual void GetTemplateState(CanvasEffectTemplateState* state, std::vector<ComPtr<IGraphicsEffectSource>>* sources) override;
+        virtual void SetTemplateState(CanvasEffectTemplateState const& state, std::vector<ComPtr<IGraphicsEffectSource>> const& sources) override;
+        virtual void ApplyAnimations(int64_t time, std::set<ICanvasEffectInternal*>* visited) override;
+
         //
         // IClosable
         //
@@ -195,10 +397,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHOD(put_CacheOutput)(boolean value) override;
         IFACEMETHOD(get_BufferPrecision)(IReference<CanvasBufferPrecision>** value) override;
         IFACEMETHOD(put_BufferPrecision)(IReference<CanvasBufferPrecision>* value) override;
+
+        IFACEMETHOD(get_CachePriority)(EffectCachePriority* value) override;
+        IFACEMETHOD(put_CachePriority)(EffectCachePriority value) override;
         IFACEMETHOD(InvalidateSourceRectangle)(ICanvasResourceCreatorWithDpi* resourceCreator, uint32_t sourceIndex, Rect invalidRectangle) override;
         IFACEMETHOD(GetInvalidRectangles)(ICanvasResourceCreatorWithDpi* resourceCreator, uint32_t* valueCount, Rect** valueElements) override;
         IFACEMETHOD(GetRequiredSourceRectangle)(ICanvasResourceCreatorWithDpi* resourceCreator, Rect outputRectangle, ICanvasEffect* sourceEffect, uint32_t sourceIndex, Rect sourceBounds, Rect* value) override;
         IFACEMETHOD(GetRequiredSourceRectangles)(ICanvasResourceCreatorWithDpi* resourceCreator, Rect outputRectangle, uint32_t sourceEffectCount, ICanvasEffect** sourceEffects, uint32_t sourceIndexCount, uint32_t* sourceIndices, uint32_t sourceBoundsCount, Rect* sourceBounds, uint32_t* valueCount, Rect** valueElements) override;
+        IFACEMETHOD(PrepareAsync)(ICanvasResourceCreator* resourceCreator, float dpi, IAsyncAction** action) override;
+
+        IFACEMETHOD(Animate)(HSTRING propertyName, uint32_t keyframeCount, EffectKeyframe* keyframes, EffectAnimationEasing easing) override;
+        IFACEMETHOD(StopAnimation)(HSTRING propertyName) override;
+        IFACEMETHOD(SetAnimationTime)(TimeSpan time) override;
 
 
     protected:
@@ -208,13 +418,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // enums are stored as unsigned integers, vectors and matrices as float arrays, and
         // colors as float[3] or float[4] depending on whether they include alpha.
         //
+        // Types that have an InlinePropertyStorage are converted directly to their D2D form,
+        // bypassing IPropertyValue. Others (interface pointers) are boxed.
+        //
 
         template<typename TBoxed, typename TPublic>
         void SetBoxedProperty(unsigned int index, TPublic const& value)
         {
-            auto boxedValue = PropertyTypeConverter<TBoxed, TPublic>::Box(m_propertyValueFactory.Get(), value);
-
-            SetProperty(index, boxedValue.Get());
+            SetBoxedProperty<TBoxed, TPublic>(index, value, std::integral_constant<bool, InlinePropertyStorage<TBoxed>::IsInline>());
         }
 
         template<typename TBoxed, typename TPublic>
@@ -222,9 +433,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         {
             CheckInPointer(value);
 
-            auto boxedValue = GetProperty(index);
-
-            PropertyTypeConverter<TBoxed, TPublic>::Unbox(boxedValue.Get(), value);
+            GetBoxedProperty<TBoxed, TPublic>(index, value, std::integral_constant<bool, InlinePropertyStorage<TBoxed>::IsInline>());
         }
 
         template<typename T>
@@ -252,6 +461,48 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             GetValueOfProperty(boxedValue.Get(), valueCount, value);
         }
 
+        //
+        // What the IMPLEMENT_EFFECT_*PROPERTY macros call.  Keeping the
+        // exception boundary out of line leaves each generated accessor as a
+        // single call, and lets every effect with a property of the same
+        // types share one copy of the code and its unwind data.
+        //
+
+        template<typename TBoxed, typename TPublic>
+        __declspec(noinline) HRESULT SetBoxedPropertyNoThrow(unsigned int index, TPublic const& value)
+        {
+            return ExceptionBoundary([&] { SetBoxedProperty<TBoxed, TPublic>(index, value); });
+        }
+
+        template<typename TBoxed, typename TPublic>
+        __declspec(noinline) HRESULT SetBoxedPropertyNoThrow(unsigned int index, TPublic const& value, EffectPropertyRange<TPublic> const& range)
+        {
+            if (!IsInEffectPropertyRange(value, range))
+                return E_INVALIDARG;
+
+            return SetBoxedPropertyNoThrow<TBoxed, TPublic>(index, value);
+        }
+
+        template<typename TBoxed, typename TPublic>
+        __declspec(noinline) HRESULT GetBoxedPropertyNoThrow(unsigned int index, TPublic* value)
+        {
+            return ExceptionBoundary([&] { GetBoxedProperty<TBoxed, TPublic>(index, value); });
+        }
+
+        template<typename T>
+        __declspec(noinline) HRESULT SetArrayPropertyNoThrow(unsigned int index, uint32_t valueCount, T const* value)
+        {
+            return ExceptionBoundary([&] { SetArrayProperty<T>(index, valueCount, value); });
+        }
+
+        template<typename T>
+        __declspec(noinline) HRESULT GetArrayPropertyNoThrow(unsigned int index, uint32_t* valueCount, T** value)
+        {
+            return ExceptionBoundary([&] { GetArrayProperty<T>(index, valueCount, value); });
+        }
+
+        HRESULT SetSourceNoThrow(unsigned int index, IGraphicsEffectSource* source);
+
 
         // Marker types, used as TBoxed for values that need special conversion.
         struct ConvertRadiansToDegrees { };
@@ -259,6 +510,44 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         struct ConvertColorHdrToVector3 { };
 
 
+        //
+        // InlinePropertyStorage describes how each TBoxed type is represented by D2D.
+        //
+
+        template<typename TBoxed>
+        struct InlinePropertyStorage
+        {
+            static const bool IsInline = false;
+
+            struct Value { };
+        };
+
+        template<PropertyType TYPE, typename TValue>
+        struct InlinePropertyStorageOf
+        {
+            static const bool IsInline = true;
+            static const PropertyType Type = TYPE;
+
+            typedef TValue Value;
+        };
+
+        template<> struct InlinePropertyStorage<float>                    : InlinePropertyStorageOf<PropertyType_Single, float> { };
+        template<> struct InlinePropertyStorage<int32_t>                  : InlinePropertyStorageOf<PropertyType_Int32, INT32> { };
+        template<> struct InlinePropertyStorage<uint32_t>                 : InlinePropertyStorageOf<PropertyType_UInt32, UINT32> { };
+        template<> struct InlinePropertyStorage<boolean>                  : InlinePropertyStorageOf<PropertyType_Boolean, BOOL> { };
+        template<> struct InlinePropertyStorage<ConvertRadiansToDegrees>  : InlinePropertyStorage<float> { };
+        template<> struct InlinePropertyStorage<ConvertAlphaMode>         : InlinePropertyStorage<uint32_t> { };
+
+        template<int N>
+        struct FloatArray
+        {
+            float Values[N];
+        };
+
+        template<int N> struct InlinePropertyStorage<float[N]>            : InlinePropertyStorageOf<PropertyType_SingleArray, FloatArray<N>> { };
+        template<> struct InlinePropertyStorage<ConvertColorHdrToVector3> : InlinePropertyStorage<float[3]> { };
+
+
         // Methods for manipulating the collection of source images, used by SourcesVector::Traits.
         unsigned int GetSourceCount();
         ComPtr<IGraphicsEffectSource> GetSource(unsigned int index);
@@ -275,6 +564,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     private:
         ComPtr<ID2D1Effect> CreateD2DEffect(ID2D1DeviceContext* deviceContext, IID const& effectId);
+        void ChangeRealizationDevice(ID2D1Device* d2dDevice, ICanvasDevice* device);
+        ComPtr<ID2D1Effect> TakeParkedRealization(bool* propertiesAreCurrent);
+
+        void UpdateCacheBudget(ICanvasDevice* device, ID2D1DeviceContext* deviceContext);
+        void ReleaseCacheEntry();
+        bool ReadCacheOutput(ID2D1Effect* d2dEffect);
+        uint64_t EstimateCachedOutputSize(ID2D1DeviceContext* deviceContext);
         bool ApplyDpiCompensation(unsigned int index, ComPtr<ID2D1Image>& inputImage, float inputDpi, GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext);
         void RefreshInputs(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext);
         
@@ -287,8 +583,60 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<IPropertyValue> GetProperty(unsigned int index);
         ComPtr<IPropertyValue> GetD2DProperty(ID2D1Effect* d2dEffect, unsigned int index);
 
+        void SetInlineProperty(unsigned int index, PropertyType type, void const* data, uint32_t size);
+        void GetInlineProperty(unsigned int index, PropertyType type, void* data, uint32_t size);
+
+        StoredProperty const& GetStoredProperty(unsigned int index, StoredProperty* defaultValue);
+        StoredProperty& GetWritableStoredProperty(unsigned int index);
+        void GetDefaultProperty(unsigned int index, StoredProperty* storedProperty);
+
+        ComPtr<IPropertyValue> BoxStoredProperty(StoredProperty const& storedProperty);
+        void GetD2DPropertyAsStored(ID2D1Effect* d2dEffect, unsigned int index, StoredProperty* storedProperty);
+
+        template<typename TBoxed, typename TPublic>
+        void SetBoxedProperty(unsigned int index, TPublic const& value, std::true_type /* isInline */)
+        {
+            typedef InlinePropertyStorage<TBoxed> Storage;
+
+            auto d2dValue = PropertyTypeConverter<TBoxed, TPublic>::ToD2D(value);
+
+            SetInlineProperty(index, Storage::Type, &d2dValue, sizeof(d2dValue));
+        }
+
+        template<typename TBoxed, typename TPublic>
+        void SetBoxedProperty(unsigned int index, TPublic const& value, std::false_type /* isInline */)
+        {
+            auto boxedValue = PropertyTypeConverter<TBoxed, TPublic>::Box(m_propertyValueFactory.Get(), value);
+
+            SetProperty(index, boxedValue.Get());
+        }
+
+        template<typename TBoxed, typename TPublic>
+        void GetBoxedProperty(unsigned int index, TPublic* value, std::true_type /* isInline */)
+        {
+            typedef InlinePropertyStorage<TBoxed> Storage;
+
+            typename Storage::Value d2dValue;
+
+            GetInlineProperty(index, Storage::Type, &d2dValue, sizeof(d2dValue));
+
+            PropertyTypeConverter<TBoxed, TPublic>::FromD2D(d2dValue, value);
+        }
+
+        template<typename TBoxed, typename TPublic>
+        void GetBoxedProperty(unsigned int index, TPublic* value, std::false_type /* isInline */)
+        {
+            auto boxedValue = GetProperty(index);
+
+            PropertyTypeConverter<TBoxed, TPublic>::Unbox(boxedValue.Get(), value);
+        }
+
         void ThrowIfClosed();
 
+        bool IsGraphValidated(GetImageFlags flags, float targetDpi);
+        void MarkExternallyVisible();
+        CachedImageBounds* GetCachedBounds();
+
 
         // Used by EffectMakers.cpp to populate the m_effectMakers table.
         template<typename T>
@@ -319,6 +667,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             {
                 GetValueOfProperty(propertyValue, result);
             }
+
+            typedef typename InlinePropertyStorage<TBoxed>::Value D2DValue;
+
+            static D2DValue ToD2D(TPublic const& value)
+            {
+                return static_cast<D2DValue>(value);
+            }
+
+            static void FromD2D(D2DValue const& value, TPublic* result)
+            {
+                *result = static_cast<TPublic>(value);
+            }
         };
 
 
@@ -338,6 +698,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 GetValueOfProperty(propertyValue, &value);
                 *result = static_cast<TPublic>(value);
             }
+
+            static UINT32 ToD2D(TPublic value)
+            {
+                return static_cast<UINT32>(value);
+            }
+
+            static void FromD2D(UINT32 value, TPublic* result)
+            {
+                *result = static_cast<TPublic>(value);
+            }
         };
 
 
@@ -373,6 +743,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
                 *result = *reinterpret_cast<TPublic*>(value.GetData());
             }
+
+            typedef FloatArray<N> D2DValue;
+
+            static D2DValue ToD2D(TPublic const& value)
+            {
+                return *reinterpret_cast<D2DValue const*>(&value);
+            }
+
+            static void FromD2D(D2DValue const& value, TPublic* result)
+            {
+                *result = *reinterpret_cast<TPublic const*>(&value);
+            }
         };
 
 
@@ -393,6 +775,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 VectorConverter::Unbox(propertyValue, &value);
                 *result = ToWindowsColor(value);
             }
+
+            static VectorConverter::D2DValue ToD2D(Color const& value)
+            {
+                return VectorConverter::ToD2D(ToVector4(value));
+            }
+
+            static void FromD2D(VectorConverter::D2DValue const& d2dValue, Color* result)
+            {
+                Numerics::Vector4 value;
+                VectorConverter::FromD2D(d2dValue, &value);
+                *result = ToWindowsColor(value);
+            }
         };
 
 
@@ -413,6 +807,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 VectorConverter::Unbox(propertyValue, &value);
                 *result = ToWindowsColor(value);
             }
+
+            static VectorConverter::D2DValue ToD2D(Color const& value)
+            {
+                return VectorConverter::ToD2D(ToVector3(value));
+            }
+
+            static void FromD2D(VectorConverter::D2DValue const& d2dValue, Color* result)
+            {
+                Numerics::Vector3 value;
+                VectorConverter::FromD2D(d2dValue, &value);
+                *result = ToWindowsColor(value);
+            }
         };
 
 
@@ -433,6 +839,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 VectorConverter::Unbox(propertyValue, &value);
                 *result = Numerics::Vector4{ value.X, value.Y, value.Z, 1.0f };
             }
+
+            static VectorConverter::D2DValue ToD2D(Numerics::Vector4 const& value)
+            {
+                return VectorConverter::ToD2D(Numerics::Vector3{ value.X, value.Y, value.Z });
+            }
+
+            static void FromD2D(VectorConverter::D2DValue const& d2dValue, Numerics::Vector4* result)
+            {
+                Numerics::Vector3 value;
+                VectorConverter::FromD2D(d2dValue, &value);
+                *result = Numerics::Vector4{ value.X, value.Y, value.Z, 1.0f };
+            }
         };
 
 
@@ -454,6 +872,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 VectorConverter::Unbox(propertyValue, &value);
                 *result = FromD2DRect(*ReinterpretAs<D2D1_RECT_F*>(&value));
             }
+
+            static VectorConverter::D2DValue ToD2D(Rect const& value)
+            {
+                auto d2dRect = ToD2DRect(value);
+                return VectorConverter::ToD2D(*ReinterpretAs<Numerics::Vector4*>(&d2dRect));
+            }
+
+            static void FromD2D(VectorConverter::D2DValue const& d2dValue, Rect* result)
+            {
+                Numerics::Vector4 value;
+                VectorConverter::FromD2D(d2dValue, &value);
+                *result = FromD2DRect(*ReinterpretAs<D2D1_RECT_F*>(&value));
+            }
         };
 
 
@@ -472,6 +903,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 GetValueOfProperty(propertyValue, &degrees);
                 *result = ::DirectX::XMConvertToRadians(degrees);
             }
+
+            static float ToD2D(float value)
+            {
+                return ::DirectX::XMConvertToDegrees(value);
+            }
+
+            static void FromD2D(float degrees, float* result)
+            {
+                *result = ::DirectX::XMConvertToRadians(degrees);
+            }
         };
 
 
@@ -496,6 +937,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 GetValueOfProperty(propertyValue, &value);
                 *result = FromD2DAlphaMode(static_cast<D2D1_ALPHA_MODE>(value));
             }
+
+            static UINT32 ToD2D(CanvasAlphaMode value)
+            {
+                if (value == CanvasAlphaMode::Ignore)
+                    ThrowHR(E_INVALIDARG);
+
+                return static_cast<UINT32>(ToD2DAlphaMode(value));
+            }
+
+            static void FromD2D(UINT32 value, CanvasAlphaMode* result)
+            {
+                *result = FromD2DAlphaMode(static_cast<D2D1_ALPHA_MODE>(value));
+            }
         };
 
 
@@ -588,18 +1042,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                                                                                         \
         IFACEMETHODIMP CLASS::get_##PROPERTY(_Out_ PUBLIC_TYPE* value)                  \
         {                                                                               \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                GetBoxedProperty<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);                \
-            });                                                                         \
+            return GetBoxedPropertyNoThrow<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);      \
         }                                                                               \
                                                                                         \
         IFACEMETHODIMP CLASS::put_##PROPERTY(_In_ PUBLIC_TYPE value)                    \
         {                                                                               \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                SetBoxedProperty<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);                \
-            });                                                                         \
+            return SetBoxedPropertyNoThrow<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);      \
         }
 
 
@@ -608,10 +1056,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                                                                                         \
         IFACEMETHODIMP CLASS::get_##PROPERTY(_Out_ PUBLIC_TYPE* value)                  \
         {                                                                               \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                GetBoxedProperty<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);                \
-            });                                                                         \
+            return GetBoxedPropertyNoThrow<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);      \
         }                                                                               \
                                                                                         \
         IFACEMETHODIMP CLASS::put_##PROPERTY(_In_ PUBLIC_TYPE value)                    \
@@ -621,30 +1066,59 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 return E_INVALIDARG;                                                    \
             }                                                                           \
                                                                                         \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                SetBoxedProperty<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);                \
-            });                                                                         \
+            return SetBoxedPropertyNoThrow<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);      \
+        }
+
+
+        // The arguments after INDEX are the minimum and maximum. They are taken as __VA_ARGS__
+        // because vector bounds are braced initializers, whose commas would split macro arguments.
+#define IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(CLASS, PROPERTY, BOXED_TYPE,               \
+                                             PUBLIC_TYPE, INDEX, ...)                   \
+                                                                                        \
+        IFACEMETHODIMP CLASS::get_##PROPERTY(_Out_ PUBLIC_TYPE* value)                  \
+        {                                                                               \
+            return GetBoxedPropertyNoThrow<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value);      \
+        }                                                                               \
+                                                                                        \
+        IFACEMETHODIMP CLASS::put_##PROPERTY(_In_ PUBLIC_TYPE value)                    \
+        {                                                                               \
+            static constexpr EffectPropertyRange<PUBLIC_TYPE> range{ __VA_ARGS__ };     \
+                                                                                        \
+            return SetBoxedPropertyNoThrow<BOXED_TYPE, PUBLIC_TYPE>(INDEX, value, range); \
         }
     };
 
 
+    // Everything needed to recreate an unrealized effect, apart from its sources.
+    struct CanvasEffectTemplateState
+    {
+        IID EffectId;
+        CanvasEffect::MakeEffectFunction MakeEffect;
+        std::vector<CanvasEffect::StoredProperty> Properties;
+        EffectPropertyDefaultTable PropertyDefaults;    // What Properties holds while it is empty.
+        boolean CacheOutput;
+        EffectCachePriority CachePriority;
+        D2D1_BUFFER_PRECISION BufferPrecision;
+        WinString Name;
+
+        // Used by the graph template optimizer to read and change scalar, vector and matrix
+        // properties, whether or not they still have their default values. Get returns false
+        // if the property is not stored with the specified type and size.
+        bool GetInlineProperty(unsigned int index, PropertyType type, void* data, uint32_t size) const;
+        void SetInlineProperty(unsigned int index, PropertyType type, void const* data, uint32_t size);
+    };
+
+
 #define IMPLEMENT_EFFECT_ARRAY_PROPERTY(CLASS, PROPERTY, TYPE, INDEX)                   \
                                                                                         \
         IFACEMETHODIMP CLASS::get_##PROPERTY(UINT32 *valueCount, TYPE **valueElements)  \
         {                                                                               \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                GetArrayProperty<TYPE>(INDEX, valueCount, valueElements);               \
-            });                                                                         \
+            return GetArrayPropertyNoThrow<TYPE>(INDEX, valueCount, valueElements);     \
         }                                                                               \
                                                                                         \
         IFACEMETHODIMP CLASS::put_##PROPERTY(UINT32 valueCount, TYPE *valueElements)    \
         {                                                                               \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                SetArrayProperty<TYPE>(INDEX, valueCount, valueElements);               \
-            });                                                                         \
+            return SetArrayPropertyNoThrow<TYPE>(INDEX, valueCount, valueElements);     \
         }
 
 
@@ -657,10 +1131,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                                                                                         \
         IFACEMETHODIMP CLASS::put_##SOURCE_NAME(_In_ IGraphicsEffectSource* source)     \
         {                                                                               \
-            return ExceptionBoundary([&]                                                \
-            {                                                                           \
-                SetSource(SOURCE_INDEX, source);                                        \
-            });                                                                         \
+            return SetSourceNoThrow(SOURCE_INDEX, source);                              \
         }
 
 
@@ -676,6 +1147,38 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
 
 
+#define IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(CLASS, ...)                                  \
+    static constexpr EffectPropertyDefault CLASS##PropertyDefaultValues[] =             \
+    {                                                                                   \
+        __VA_ARGS__                                                                     \
+    };                                                                                  \
+                                                                                        \
+    static_assert(AreEffectPropertyDefaultsInIndexOrder(CLASS##PropertyDefaultValues),  \
+                  "Property defaults must be listed in D2D property index order");      \
+                                                                                        \
+    static constexpr EffectPropertyDefaultTable CLASS##PropertyDefaults =               \
+        MakeEffectPropertyDefaultTable(CLASS##PropertyDefaultValues);
+
+
+#define EFFECT_PROPERTY_DEFAULT_SINGLE(INDEX, VALUE)                                    \
+    { INDEX, PropertyType_Single, sizeof(float), 0, { VALUE } }
+
+#define EFFECT_PROPERTY_DEFAULT_INT32(INDEX, VALUE)                                     \
+    { INDEX, PropertyType_Int32, sizeof(INT32), static_cast<uint32_t>(VALUE) }
+
+#define EFFECT_PROPERTY_DEFAULT_UINT32(INDEX, VALUE)                                    \
+    { INDEX, PropertyType_UInt32, sizeof(UINT32), static_cast<uint32_t>(VALUE) }
+
+#define EFFECT_PROPERTY_DEFAULT_BOOLEAN(INDEX, VALUE)                                   \
+    { INDEX, PropertyType_Boolean, sizeof(BOOL), static_cast<uint32_t>(VALUE) }
+
+#define EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(INDEX, COUNT, ...)                         \
+    { INDEX, PropertyType_SingleArray, sizeof(float[COUNT]), 0, { __VA_ARGS__ } }
+
+#define EFFECT_PROPERTY_DEFAULT_INTERFACE(INDEX)                                        \
+    { INDEX, PropertyType_InspectableArray, 0 }
+
+
 #define EFFECT_PROPERTY_MAPPING()                                                       \
     EffectPropertyMappingTable GetPropertyMapping() override
 
@@ -0,0 +1,955 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasEffectGraphTemplate.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    class CanvasEffectGraphTemplate::Compiler
+    {
+        CanvasEffectGraphTemplate* m_graphTemplate;
+
+        std::unordered_map<IUnknown*, uint32_t> m_effectIndices;
+        std::unordered_map<IUnknown*, uint32_t> m_inputIndices;
+
+        // False while the sources of an effect are still being visited, which is how we detect cycles.
+        std::vector<bool> m_isEffectCompiled;
+
+        // Keeps everything we have visited alive, so the identity keys above remain unique.
+        std::vector<ComPtr<IUnknown>> m_visited;
+
+    public:
+        Compiler(CanvasEffectGraphTemplate* graphTemplate)
+            : m_graphTemplate(graphTemplate)
+        { }
+
+        SourceBinding AddSource(IGraphicsEffectSource* source)
+        {
+            if (!source)
+                return SourceBinding{ SourceBinding::SourceKind::Null, 0 };
+
+            auto identity = As<IUnknown>(source);
+            auto effect = MaybeAs<ICanvasEffectInternal>(source);
+
+            if (!effect)
+                return AddInput(identity.Get(), source);
+
+            auto it = m_effectIndices.find(identity.Get());
+
+            if (it != m_effectIndices.end())
+            {
+                if (!m_isEffectCompiled[it->second])
+                    ThrowHR(D2DERR_CYCLIC_GRAPH);
+
+                // Effects that are shared by more than one parent stay shared in each copy.
+                return SourceBinding{ SourceBinding::SourceKind::Effect, it->second };
+            }
+
+            auto& effects = m_graphTemplate->m_effects;
+            auto index = static_cast<uint32_t>(effects.size());
+
+            m_effectIndices.insert(std::make_pair(identity.Get(), index));
+            m_isEffectCompiled.push_back(false);
+            m_visited.push_back(identity);
+
+            CanvasEffectTemplateState state;
+            std::vector<ComPtr<IGraphicsEffectSource>> sources;
+
+            effect->GetTemplateState(&state, &sources);
+
+            effects.push_back(EffectNode{ std::move(state) });
+
+            // Compiling the sources can add more effects, so don't hold references into m_effects across this.
+            for (auto& childSource : sources)
+            {
+                auto binding = AddSource(childSource.Get());
+                effects[index].Sources.push_back(binding);
+            }
+
+            m_isEffectCompiled[index] = true;
+
+            return SourceBinding{ SourceBinding::SourceKind::Effect, index };
+        }
+
+    private:
+        SourceBinding AddInput(IUnknown* identity, IGraphicsEffectSource* source)
+        {
+            auto& inputs = m_graphTemplate->m_inputs;
+
+            auto it = m_inputIndices.find(identity);
+
+            if (it != m_inputIndices.end())
+                return SourceBinding{ SourceBinding::SourceKind::Input, it->second };
+
+            auto index = static_cast<uint32_t>(inputs.size());
+
+            m_inputIndices.insert(std::make_pair(identity, index));
+            inputs.push_back(source);
+
+            return SourceBinding{ SourceBinding::SourceKind::Input, index };
+        }
+    };
+
+
+    //
+    // Simplifies a compiled graph, so that realizing an instance of it needs fewer
+    // GPU passes and intermediate textures:
+    //
+    //  - Opacity, brightness, color matrix and 2D transform effects whose properties
+    //    leave the image unchanged are removed.
+    //  - A color matrix whose source is another color matrix is merged with it, as is
+    //    a 2D transform whose source is another 2D transform.
+    //
+    // An effect is only removed if nothing can tell it is gone: the root effect is
+    // always kept, as are effects that set CacheOutput or BufferPrecision, and effects
+    // used by more than one parent are not merged into any of them.
+    //
+    class CanvasEffectGraphTemplate::Optimizer
+    {
+        std::vector<EffectNode>& m_effects;
+
+        // How many sources refer to each effect. The root counts as used once more.
+        std::vector<uint32_t> m_useCounts;
+
+        // The 5x4 color matrix multiplies a row vector of (R, G, B, A, 1), so row and
+        // column 3 are alpha, and row 4 holds the offsets.
+        static const int Alpha = 3;
+        static const int OffsetRow = 4;
+
+    public:
+        Optimizer(CanvasEffectGraphTemplate* graphTemplate)
+            : m_effects(graphTemplate->m_effects)
+            , m_useCounts(graphTemplate->m_effects.size())
+        { }
+
+        void Run()
+        {
+            AddUse(0);
+
+            for (auto& effect : m_effects)
+            {
+                for (auto& binding : effect.Sources)
+                {
+                    if (binding.Kind == SourceBinding::SourceKind::Effect)
+                        m_useCounts[binding.Index]++;
+                }
+            }
+
+            // Removing one effect can put two mergeable ones next to each other, so
+            // keep going until nothing changes.
+            bool changed;
+
+            do
+            {
+                changed = false;
+
+                for (uint32_t i = 0; i < m_effects.size(); ++i)
+                {
+                    if (m_useCounts[i] == 0)
+                        continue;
+
+                    for (uint32_t j = 0; j < m_effects[i].Sources.size(); ++j)
+                    {
+                        changed |= SimplifySource(i, j);
+                    }
+                }
+            }
+            while (changed);
+
+            RemoveUnusedEffects();
+        }
+
+    private:
+        bool SimplifySource(uint32_t parentIndex, uint32_t sourceIndex)
+        {
+            auto binding = m_effects[parentIndex].Sources[sourceIndex];
+
+            if (binding.Kind != SourceBinding::SourceKind::Effect)
+                return false;
+
+            auto& child = m_effects[binding.Index];
+
+            if (!IsInvisible(child) || child.Sources.size() != 1)
+                return false;
+
+            if (IsIdentity(child) ||
+                (m_useCounts[binding.Index] == 1 && TryMerge(m_effects[parentIndex], child)))
+            {
+                // Skip past the child, straight to its own source.
+                auto newBinding = child.Sources[0];
+
+                m_effects[parentIndex].Sources[sourceIndex] = newBinding;
+
+                if (newBinding.Kind == SourceBinding::SourceKind::Effect)
+                    AddUse(newBinding.Index);
+
+                ReleaseUse(binding.Index);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void AddUse(uint32_t index)
+        {
+            m_useCounts[index]++;
+        }
+
+        void ReleaseUse(uint32_t index)
+        {
+            if (--m_useCounts[index] > 0)
+                return;
+
+            for (auto& binding : m_effects[index].Sources)
+            {
+                if (binding.Kind == SourceBinding::SourceKind::Effect)
+                    ReleaseUse(binding.Index);
+            }
+        }
+
+        // Whether anything other than the image an effect produces can be observed.
+        static bool IsInvisible(EffectNode const& effect)
+        {
+            return !effect.State.CacheOutput &&
+                   effect.State.BufferPrecision == D2D1_BUFFER_PRECISION_UNKNOWN;
+        }
+
+        template<typename T>
+        static bool GetProperty(EffectNode const& effect, unsigned int index, PropertyType type, T* value)
+        {
+            return effect.State.GetInlineProperty(index, type, value, sizeof(T));
+        }
+
+        template<typename T>
+        static void SetProperty(EffectNode& effect, unsigned int index, PropertyType type, T const& value)
+        {
+            effect.State.SetInlineProperty(index, type, &value, sizeof(T));
+        }
+
+        static bool IsIdentity(EffectNode const& effect)
+        {
+            auto& effectId = effect.State.EffectId;
+
+#if (defined _WIN32_WINNT_WIN10) && (WINVER >= _WIN32_WINNT_WIN10)
+            if (IsEqualGUID(effectId, CLSID_D2D1Opacity))
+            {
+                float opacity;
+
+                return GetProperty(effect, D2D1_OPACITY_PROP_OPACITY, PropertyType_Single, &opacity) &&
+                       opacity == 1.0f;
+            }
+#endif
+
+            if (IsEqualGUID(effectId, CLSID_D2D1Brightness))
+            {
+                D2D1_VECTOR_2F whitePoint, blackPoint;
+
+                return GetProperty(effect, D2D1_BRIGHTNESS_PROP_WHITE_POINT, PropertyType_SingleArray, &whitePoint) &&
+                       GetProperty(effect, D2D1_BRIGHTNESS_PROP_BLACK_POINT, PropertyType_SingleArray, &blackPoint) &&
+                       whitePoint.x == 1.0f && whitePoint.y == 1.0f &&
+                       blackPoint.x == 0.0f && blackPoint.y == 0.0f;
+            }
+
+            if (IsEqualGUID(effectId, CLSID_D2D12DAffineTransform))
+            {
+                D2D1_MATRIX_3X2_F matrix;
+
+                return GetProperty(effect, D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX, PropertyType_SingleArray, &matrix) &&
+                       D2D1::Matrix3x2F::ReinterpretBaseType(&matrix)->IsIdentity();
+            }
+
+            if (IsEqualGUID(effectId, CLSID_D2D1ColorMatrix))
+            {
+                D2D1_MATRIX_5X4_F matrix;
+                BOOL clampOutput;
+
+                // Clamping could change out of range input, so only an unclamped identity does nothing.
+                return GetProperty(effect, D2D1_COLORMATRIX_PROP_COLOR_MATRIX, PropertyType_SingleArray, &matrix) &&
+                       GetProperty(effect, D2D1_COLORMATRIX_PROP_CLAMP_OUTPUT, PropertyType_Boolean, &clampOutput) &&
+                       !clampOutput &&
+                       IsIdentity(matrix);
+            }
+
+            return false;
+        }
+
+        static bool IsIdentity(D2D1_MATRIX_5X4_F const& matrix)
+        {
+            for (int row = 0; row < 5; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    if (matrix.m[row][column] != (row == column ? 1.0f : 0.0f))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Folds what the child does into the parent, so the parent can take the child's source instead.
+        static bool TryMerge(EffectNode& parent, EffectNode const& child)
+        {
+            auto& effectId = parent.State.EffectId;
+
+            if (!IsEqualGUID(effectId, child.State.EffectId))
+                return false;
+
+            if (IsEqualGUID(effectId, CLSID_D2D1ColorMatrix))
+                return TryMergeColorMatrix(parent, child);
+
+            if (IsEqualGUID(effectId, CLSID_D2D12DAffineTransform))
+                return TryMergeTransform(parent, child);
+
+            return false;
+        }
+
+        static bool TryMergeColorMatrix(EffectNode& parent, EffectNode const& child)
+        {
+            D2D1_MATRIX_5X4_F parentMatrix, childMatrix;
+            uint32_t parentAlphaMode, childAlphaMode;
+            BOOL childClampOutput;
+
+            if (!GetProperty(parent, D2D1_COLORMATRIX_PROP_COLOR_MATRIX, PropertyType_SingleArray, &parentMatrix) ||
+                !GetProperty(child, D2D1_COLORMATRIX_PROP_COLOR_MATRIX, PropertyType_SingleArray, &childMatrix) ||
+                !GetProperty(parent, D2D1_COLORMATRIX_PROP_ALPHA_MODE, PropertyType_UInt32, &parentAlphaMode) ||
+                !GetProperty(child, D2D1_COLORMATRIX_PROP_ALPHA_MODE, PropertyType_UInt32, &childAlphaMode) ||
+                !GetProperty(child, D2D1_COLORMATRIX_PROP_CLAMP_OUTPUT, PropertyType_Boolean, &childClampOutput))
+            {
+                return false;
+            }
+
+            // Clamping in between the two matrices can't be expressed by a single one.
+            if (childClampOutput || parentAlphaMode != childAlphaMode)
+                return false;
+
+            // In premultiplied mode each effect divides color by alpha before applying its
+            // matrix. Where the child outputs zero alpha, that loses the color the parent
+            // would have seen. This only makes no difference if the parent's alpha comes
+            // from alpha alone, so it outputs zero too.
+            if (parentAlphaMode == D2D1_COLORMATRIX_ALPHA_MODE_PREMULTIPLIED)
+            {
+                for (int row = 0; row < 5; ++row)
+                {
+                    if (row != Alpha && parentMatrix.m[row][Alpha] != 0)
+                        return false;
+                }
+            }
+
+            // Applying the child then the parent multiplies by the child matrix then the
+            // parent one, with the child's offsets also going through the parent matrix.
+            D2D1_MATRIX_5X4_F merged;
+
+            for (int row = 0; row < 5; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    float value = (row == OffsetRow) ? parentMatrix.m[OffsetRow][column] : 0.0f;
+
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        value += childMatrix.m[row][i] * parentMatrix.m[i][column];
+                    }
+
+                    merged.m[row][column] = value;
+                }
+            }
+
+            SetProperty(parent, D2D1_COLORMATRIX_PROP_COLOR_MATRIX, PropertyType_SingleArray, merged);
+
+            return true;
+        }
+
+        static bool TryMergeTransform(EffectNode& parent, EffectNode const& child)
+        {
+            D2D1_MATRIX_3X2_F parentMatrix, childMatrix;
+            uint32_t parentInterpolation, childInterpolation;
+            uint32_t parentBorderMode, childBorderMode;
+            float parentSharpness, childSharpness;
+
+            if (!GetProperty(parent, D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX, PropertyType_SingleArray, &parentMatrix) ||
+                !GetProperty(child, D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX, PropertyType_SingleArray, &childMatrix) ||
+                !GetProperty(parent, D2D1_2DAFFINETRANSFORM_PROP_INTERPOLATION_MODE, PropertyType_UInt32, &parentInterpolation) ||
+                !GetProperty(child, D2D1_2DAFFINETRANSFORM_PROP_INTERPOLATION_MODE, PropertyType_UInt32, &childInterpolation) ||
+                !GetProperty(parent, D2D1_2DAFFINETRANSFORM_PROP_BORDER_MODE, PropertyType_UInt32, &parentBorderMode) ||
+                !GetProperty(child, D2D1_2DAFFINETRANSFORM_PROP_BORDER_MODE, PropertyType_UInt32, &childBorderMode) ||
+                !GetProperty(parent, D2D1_2DAFFINETRANSFORM_PROP_SHARPNESS, PropertyType_Single, &parentSharpness) ||
+                !GetProperty(child, D2D1_2DAFFINETRANSFORM_PROP_SHARPNESS, PropertyType_Single, &childSharpness))
+            {
+                return false;
+            }
+
+            if (parentInterpolation != childInterpolation ||
+                parentBorderMode != childBorderMode ||
+                parentSharpness != childSharpness)
+            {
+                return false;
+            }
+
+            // Points are row vectors, so the child's transform is applied first.
+            D2D1_MATRIX_3X2_F merged = *D2D1::Matrix3x2F::ReinterpretBaseType(&childMatrix) *
+                                       *D2D1::Matrix3x2F::ReinterpretBaseType(&parentMatrix);
+
+            SetProperty(parent, D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX, PropertyType_SingleArray, merged);
+
+            return true;
+        }
+
+        void RemoveUnusedEffects()
+        {
+            std::vector<uint32_t> newIndices(m_effects.size());
+            std::vector<EffectNode> usedEffects;
+
+            for (uint32_t i = 0; i < m_effects.size(); ++i)
+            {
+                if (m_useCounts[i] > 0)
+                {
+                    newIndices[i] = static_cast<uint32_t>(usedEffects.size());
+                    usedEffects.push_back(std::move(m_effects[i]));
+                }
+            }
+
+            for (auto& effect : usedEffects)
+            {
+                for (auto& binding : effect.Sources)
+                {
+                    if (binding.Kind == SourceBinding::SourceKind::Effect)
+                        binding.Index = newIndices[binding.Index];
+                }
+            }
+
+            m_effects = std::move(usedEffects);
+        }
+    };
+
+
+    //
+    // Chooses a BufferPrecision for each effect that doesn't have one, following the
+    // range and precision of the images that flow into it:
+    //
+    //  - Effects fed only by 8 bit images, that can't move values outside 0 to 1,
+    //    get 8 bit buffers.
+    //  - Effects that can move values outside that range, or that are fed by 16 bit
+    //    float images, get 16 bit float buffers so later effects can still see them.
+    //  - Anything fed by an input or effect whose output we can't reason about (command
+    //    lists, 32 bit float bitmaps, custom effects, etc.) is left for D2D to decide.
+    //
+    class CanvasEffectGraphTemplate::PrecisionChooser
+    {
+        enum class Precision { Unknown, Unorm8, Float16 };
+
+        // How an effect's output range relates to that of its sources.
+        enum class OutputRange { Unknown, SameAsSources, Extended };
+
+        std::vector<EffectNode> const& m_effects;
+        std::vector<ComPtr<IGraphicsEffectSource>> const& m_defaultInputs;
+        IGraphicsEffectSource** m_inputs;
+
+        std::vector<Precision> m_precisions;
+        std::vector<bool> m_isPrecisionKnown;
+
+    public:
+        PrecisionChooser(CanvasEffectGraphTemplate* graphTemplate, IGraphicsEffectSource** inputs)
+            : m_effects(graphTemplate->m_effects)
+            , m_defaultInputs(graphTemplate->m_inputs)
+            , m_inputs(inputs)
+            , m_precisions(graphTemplate->m_effects.size())
+            , m_isPrecisionKnown(graphTemplate->m_effects.size())
+        { }
+
+        std::vector<D2D1_BUFFER_PRECISION> Run()
+        {
+            std::vector<D2D1_BUFFER_PRECISION> bufferPrecisions;
+
+            for (uint32_t i = 0; i < m_effects.size(); ++i)
+            {
+                auto bufferPrecision = m_effects[i].State.BufferPrecision;
+
+                if (bufferPrecision == D2D1_BUFFER_PRECISION_UNKNOWN)
+                {
+                    switch (GetEffectPrecision(i))
+                    {
+                    case Precision::Unorm8:
+                        bufferPrecision = D2D1_BUFFER_PRECISION_8BPC_UNORM;
+                        break;
+
+                    case Precision::Float16:
+                        bufferPrecision = D2D1_BUFFER_PRECISION_16BPC_FLOAT;
+                        break;
+
+                    case Precision::Unknown:
+                        // Leave it for D2D to choose.
+                        break;
+                    }
+                }
+
+                bufferPrecisions.push_back(bufferPrecision);
+            }
+
+            return bufferPrecisions;
+        }
+
+    private:
+        // Graphs are acyclic, but effects can be shared, so remember what has already been worked out.
+        Precision GetEffectPrecision(uint32_t index)
+        {
+            if (!m_isPrecisionKnown[index])
+            {
+                m_precisions[index] = CalculateEffectPrecision(m_effects[index]);
+                m_isPrecisionKnown[index] = true;
+            }
+
+            return m_precisions[index];
+        }
+
+        Precision CalculateEffectPrecision(EffectNode const& effect)
+        {
+            switch (effect.State.BufferPrecision)
+            {
+            case D2D1_BUFFER_PRECISION_UNKNOWN:
+                break;
+
+            case D2D1_BUFFER_PRECISION_8BPC_UNORM:
+            case D2D1_BUFFER_PRECISION_8BPC_UNORM_SRGB:
+                return Precision::Unorm8;
+
+            case D2D1_BUFFER_PRECISION_16BPC_FLOAT:
+                return Precision::Float16;
+
+            default:
+                return Precision::Unknown;
+            }
+
+            auto outputRange = GetOutputRange(effect);
+
+            if (outputRange == OutputRange::Unknown)
+                return Precision::Unknown;
+
+            auto precision = (outputRange == OutputRange::Extended) ? Precision::Float16 : Precision::Unorm8;
+
+            for (auto& binding : effect.Sources)
+            {
+                auto sourcePrecision = GetSourcePrecision(binding);
+
+                if (sourcePrecision == Precision::Unknown)
+                    return Precision::Unknown;
+
+                precision = std::max(precision, sourcePrecision);
+            }
+
+            return precision;
+        }
+
+        Precision GetSourcePrecision(SourceBinding const& binding)
+        {
+            switch (binding.Kind)
+            {
+            case SourceBinding::SourceKind::Effect:
+                return GetEffectPrecision(binding.Index);
+
+            case SourceBinding::SourceKind::Input:
+                {
+                    auto input = m_inputs[binding.Index] ? m_inputs[binding.Index] : m_defaultInputs[binding.Index].Get();
+                    return GetInputPrecision(input);
+                }
+
+            default:
+                // Null sources are transparent black.
+                return Precision::Unorm8;
+            }
+        }
+
+        static Precision GetInputPrecision(IGraphicsEffectSource* input)
+        {
+            auto bitmap = MaybeAs<ICanvasBitmap>(input);
+
+            if (!bitmap)
+                return Precision::Unknown;
+
+            DirectXPixelFormat format;
+            ThrowIfFailed(bitmap->get_Format(&format));
+
+            switch (static_cast<DXGI_FORMAT>(format))
+            {
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            case DXGI_FORMAT_B8G8R8X8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            case DXGI_FORMAT_A8_UNORM:
+            case DXGI_FORMAT_BC1_UNORM:
+            case DXGI_FORMAT_BC2_UNORM:
+            case DXGI_FORMAT_BC3_UNORM:
+                return Precision::Unorm8;
+
+            case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            case DXGI_FORMAT_R10G10B10A2_UNORM:
+                return Precision::Float16;
+
+            default:
+                // Half float would lose precision from 16 bit integer or 32 bit float bitmaps.
+                return Precision::Unknown;
+            }
+        }
+
+        template<typename T>
+        static bool GetProperty(EffectNode const& effect, unsigned int index, PropertyType type, T* value)
+        {
+            return effect.State.GetInlineProperty(index, type, value, sizeof(T));
+        }
+
+        // Which effects can output values outside 0 to 1 when all their sources are
+        // inside it. Effects that aren't listed here leave the precision to D2D.
+        static OutputRange GetOutputRange(EffectNode const& effect)
+        {
+            auto& effectId = effect.State.EffectId;
+
+            static IID const* const sameRangeEffects[] =
+            {
+                &CLSID_D2D12DAffineTransform,
+                &CLSID_D2D13DTransform,
+                &CLSID_D2D1Atlas,
+                &CLSID_D2D1Blend,
+                &CLSID_D2D1Border,
+                &CLSID_D2D1Brightness,
+                &CLSID_D2D1Crop,
+                &CLSID_D2D1DirectionalBlur,
+                &CLSID_D2D1DisplacementMap,
+                &CLSID_D2D1GaussianBlur,
+                &CLSID_D2D1LuminanceToAlpha,
+                &CLSID_D2D1Morphology,
+                &CLSID_D2D1OpacityMetadata,
+                &CLSID_D2D1Premultiply,
+                &CLSID_D2D1Scale,
+                &CLSID_D2D1Shadow,
+                &CLSID_D2D1Tile,
+                &CLSID_D2D1Turbulence,
+                &CLSID_D2D1UnPremultiply,
+#if (defined _WIN32_WINNT_WIN10) && (WINVER >= _WIN32_WINNT_WIN10)
+                &CLSID_D2D1AlphaMask,
+                &CLSID_D2D1ChromaKey,
+                &CLSID_D2D1CrossFade,
+                &CLSID_D2D1Grayscale,
+                &CLSID_D2D1Invert,
+                &CLSID_D2D1Opacity,
+                &CLSID_D2D1Posterize,
+                &CLSID_D2D1Sepia,
+                &CLSID_D2D1Straighten,
+#endif
+            };
+
+            static IID const* const extendedRangeEffects[] =
+            {
+                &CLSID_D2D1HueRotation,
+                &CLSID_D2D1Saturation,
+#if (defined _WIN32_WINNT_WIN10) && (WINVER >= _WIN32_WINNT_WIN10)
+                &CLSID_D2D1Contrast,
+                &CLSID_D2D1Exposure,
+                &CLSID_D2D1HighlightsShadows,
+                &CLSID_D2D1TemperatureTint,
+                &CLSID_D2D1Tint,
+                &CLSID_D2D1Vignette,
+#endif
+            };
+
+            // These use the full range unless told to clamp their output.
+            static std::pair<IID const*, unsigned int> const clampingEffects[] =
+            {
+                { &CLSID_D2D1ArithmeticComposite, D2D1_ARITHMETICCOMPOSITE_PROP_CLAMP_OUTPUT },
+                { &CLSID_D2D1ConvolveMatrix,      D2D1_CONVOLVEMATRIX_PROP_CLAMP_OUTPUT },
+                { &CLSID_D2D1DiscreteTransfer,    D2D1_DISCRETETRANSFER_PROP_CLAMP_OUTPUT },
+                { &CLSID_D2D1GammaTransfer,       D2D1_GAMMATRANSFER_PROP_CLAMP_OUTPUT },
+                { &CLSID_D2D1LinearTransfer,      D2D1_LINEARTRANSFER_PROP_CLAMP_OUTPUT },
+                { &CLSID_D2D1TableTransfer,       D2D1_TABLETRANSFER_PROP_CLAMP_OUTPUT },
+            };
+
+            for (auto id : sameRangeEffects)
+            {
+                if (IsEqualGUID(effectId, *id))
+                    return OutputRange::SameAsSources;
+            }
+
+            for (auto id : extendedRangeEffects)
+            {
+                if (IsEqualGUID(effectId, *id))
+                    return OutputRange::Extended;
+            }
+
+            for (auto& clampingEffect : clampingEffects)
+            {
+                if (IsEqualGUID(effectId, *clampingEffect.first))
+                {
+                    BOOL clampOutput;
+
+                    return (GetProperty(effect, clampingEffect.second, PropertyType_Boolean, &clampOutput) && clampOutput) ?
+                        OutputRange::SameAsSources : OutputRange::Extended;
+                }
+            }
+
+            if (IsEqualGUID(effectId, CLSID_D2D1ColorMatrix))
+                return GetColorMatrixOutputRange(effect);
+
+            if (IsEqualGUID(effectId, CLSID_D2D1Composite))
+            {
+                uint32_t mode;
+
+                // Adding images together is the only composite mode that can go past 1.
+                return (GetProperty(effect, D2D1_COMPOSITE_PROP_MODE, PropertyType_UInt32, &mode) && mode != D2D1_COMPOSITE_MODE_PLUS) ?
+                    OutputRange::SameAsSources : OutputRange::Extended;
+            }
+
+            if (IsEqualGUID(effectId, CLSID_D2D1Flood))
+            {
+                D2D1_VECTOR_4F color;
+
+                return (GetProperty(effect, D2D1_FLOOD_PROP_COLOR, PropertyType_SingleArray, &color) && IsInUnitRange(color)) ?
+                    OutputRange::SameAsSources : OutputRange::Extended;
+            }
+
+            return OutputRange::Unknown;
+        }
+
+        static OutputRange GetColorMatrixOutputRange(EffectNode const& effect)
+        {
+            D2D1_MATRIX_5X4_F matrix;
+            BOOL clampOutput;
+
+            if (!GetProperty(effect, D2D1_COLORMATRIX_PROP_COLOR_MATRIX, PropertyType_SingleArray, &matrix) ||
+                !GetProperty(effect, D2D1_COLORMATRIX_PROP_CLAMP_OUTPUT, PropertyType_Boolean, &clampOutput))
+            {
+                return OutputRange::Extended;
+            }
+
+            if (clampOutput)
+                return OutputRange::SameAsSources;
+
+            // With each input between 0 and 1, the smallest an output can be is its offset
+            // plus the negative coefficients, and the largest its offset plus the positive ones.
+            for (int column = 0; column < 4; ++column)
+            {
+                float minimum = matrix.m[4][column];
+                float maximum = matrix.m[4][column];
+
+                for (int row = 0; row < 4; ++row)
+                {
+                    minimum += std::min(matrix.m[row][column], 0.0f);
+                    maximum += std::max(matrix.m[row][column], 0.0f);
+                }
+
+                if (minimum < 0 || maximum > 1)
+                    return OutputRange::Extended;
+            }
+
+            return OutputRange::SameAsSources;
+        }
+
+        static bool IsInUnitRange(D2D1_VECTOR_4F const& color)
+        {
+            for (float value : { color.x, color.y, color.z, color.w })
+            {
+                if (value < 0 || value > 1)
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+
+    CanvasEffectGraphTemplate::CanvasEffectGraphTemplate()
+        : m_choosesBufferPrecision(false)
+    { }
+
+
+    ComPtr<CanvasEffectGraphTemplate> CanvasEffectGraphTemplate::CreateNew(
+        IGraphicsEffect* rootEffect,
+        CanvasEffectGraphOptimizations optimizations)
+    {
+        CheckInPointer(rootEffect);
+
+        auto validOptimizations =
+            CanvasEffectGraphOptimizations::RemoveRedundantEffects |
+            CanvasEffectGraphOptimizations::ChooseBufferPrecision;
+
+        if ((optimizations & ~validOptimizations) != CanvasEffectGraphOptimizations::None)
+            ThrowHR(E_INVALIDARG);
+
+        // The root must be a Win2D effect, otherwise there would be nothing to instantiate.
+        if (!MaybeAs<ICanvasEffectInternal>(rootEffect))
+            ThrowHR(E_INVALIDARG);
+
+        auto graphTemplate = Make<CanvasEffectGraphTemplate>();
+        CheckMakeResult(graphTemplate);
+
+        Compiler compiler(graphTemplate.Get());
+
+        compiler.AddSource(As<IGraphicsEffectSource>(rootEffect).Get());
+
+        if ((optimizations & CanvasEffectGraphOptimizations::RemoveRedundantEffects) != CanvasEffectGraphOptimizations::None)
+        {
+            Optimizer optimizer(graphTemplate.Get());
+            optimizer.Run();
+        }
+
+        graphTemplate->m_choosesBufferPrecision = (optimizations & CanvasEffectGraphOptimizations::ChooseBufferPrecision) != CanvasEffectGraphOptimizations::None;
+
+        return graphTemplate;
+    }
+
+
+    IFACEMETHODIMP CanvasEffectGraphTemplate::get_EffectCount(uint32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = static_cast<uint32_t>(m_effects.size());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffectGraphTemplate::get_InputCount(uint32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = static_cast<uint32_t>(m_inputs.size());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffectGraphTemplate::Instantiate(
+        uint32_t inputCount,
+        IGraphicsEffectSource** inputs,
+        uint32_t* effectCount,
+        IGraphicsEffect*** effects)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(effectCount);
+                CheckAndClearOutPointer(effects);
+
+                if (inputCount != m_inputs.size())
+                    ThrowHR(E_INVALIDARG, Strings::EffectGraphTemplateWrongInputCount);
+
+                if (inputCount > 0)
+                    CheckInPointer(inputs);
+
+                ComArray<ComPtr<IGraphicsEffect>> newEffects(m_effects.size());
+
+                // Create all the effects first, so sources can refer to any of them.
+                for (uint32_t i = 0; i < m_effects.size(); ++i)
+                {
+                    ComPtr<IInspectable> newEffect;
+                    m_effects[i].State.MakeEffect(nullptr, nullptr, &newEffect);
+
+                    newEffects[i] = As<IGraphicsEffect>(newEffect);
+                }
+
+                std::vector<D2D1_BUFFER_PRECISION> bufferPrecisions;
+
+                if (m_choosesBufferPrecision)
+                    bufferPrecisions = PrecisionChooser(this, inputs).Run();
+
+                // Then copy across their state, and connect them together.
+                std::vector<ComPtr<IGraphicsEffectSource>> sources;
+
+                for (uint32_t i = 0; i < m_effects.size(); ++i)
+                {
+                    auto& effect = m_effects[i];
+
+                    sources.clear();
+
+                    for (auto& binding : effect.Sources)
+                    {
+                        switch (binding.Kind)
+                        {
+                        case SourceBinding::SourceKind::Null:
+                            sources.push_back(nullptr);
+                            break;
+
+                        case SourceBinding::SourceKind::Effect:
+                            sources.push_back(As<IGraphicsEffectSource>(newEffects[binding.Index]));
+                            break;
+
+                        case SourceBinding::SourceKind::Input:
+                            // Null inputs keep the source from the original graph.
+                            sources.push_back(inputs[binding.Index] ? inputs[binding.Index] : m_inputs[binding.Index].Get());
+                            break;
+                        }
+                    }
+
+                    if (!bufferPrecisions.empty() && bufferPrecisions[i] != effect.State.BufferPrecision)
+                    {
+                        auto state = effect.State;
+                        state.BufferPrecision = bufferPrecisions[i];
+
+                        As<ICanvasEffectInternal>(newEffects[i])->SetTemplateState(state, sources);
+                    }
+                    else
+                    {
+                        As<ICanvasEffectInternal>(newEffects[i])->SetTemplateState(effect.State, sources);
+                    }
+                }
+
+                newEffects.Detach(effectCount, effects);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffectGraphTemplateFactory::Compile(
+        IGraphicsEffect* rootEffect,
+        ICanvasEffectGraphTemplate** result)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(result);
+
+                auto graphTemplate = CanvasEffectGraphTemplate::CreateNew(rootEffect);
+
+                ThrowIfFailed(graphTemplate.CopyTo(result));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffectGraphTemplateFactory::CompileOptimized(
+        IGraphicsEffect* rootEffect,
+        ICanvasEffectGraphTemplate** result)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(result);
+
+                auto graphTemplate = CanvasEffectGraphTemplate::CreateNew(rootEffect, CanvasEffectGraphOptimizations::RemoveRedundantEffects);
+
+                ThrowIfFailed(graphTemplate.CopyTo(result));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasEffectGraphTemplateFactory::CompileOptimizedWithOptions(
+        IGraphicsEffect* rootEffect,
+        CanvasEffectGraphOptimizations optimizations,
+        ICanvasEffectGraphTemplate** result)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(result);
+
+                auto graphTemplate = CanvasEffectGraphTemplate::CreateNew(rootEffect, optimizations);
+
+                ThrowIfFailed(graphTemplate.CopyTo(result));
+            });
+    }
+
+
+    ActivatableStaticOnlyFactory(CanvasEffectGraphTemplateFactory);
+}}}}}
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    using namespace ::Microsoft::WRL;
+
+    class CanvasEffectGraphTemplate : public RuntimeClass<
+        ICanvasEffectGraphTemplate>,
+        private LifespanTracker<CanvasEffectGraphTemplate>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Effects_CanvasEffectGraphTemplate, BaseTrust);
+
+        // Where each effect source comes from when the graph is instantiated.
+        struct SourceBinding
+        {
+            enum class SourceKind { Null, Effect, Input };
+
+            SourceKind Kind;
+            uint32_t Index;     // Into m_effects or m_inputs, depending on Kind.
+        };
+
+        struct EffectNode
+        {
+            CanvasEffectTemplateState State;
+            std::vector<SourceBinding> Sources;
+        };
+
+        // The root effect is always first.
+        std::vector<EffectNode> m_effects;
+
+        // Anything in the original graph that is not a Win2D effect (bitmaps, command lists, etc.)
+        // becomes an input, which can be replaced each time the graph is instantiated.
+        std::vector<ComPtr<IGraphicsEffectSource>> m_inputs;
+
+        // Whether Instantiate sets the BufferPrecision of effects that don't have one.
+        bool m_choosesBufferPrecision;
+
+    public:
+        static ComPtr<CanvasEffectGraphTemplate> CreateNew(
+            IGraphicsEffect* rootEffect,
+            CanvasEffectGraphOptimizations optimizations = CanvasEffectGraphOptimizations::None);
+
+        CanvasEffectGraphTemplate();
+
+        IFACEMETHOD(get_EffectCount)(uint32_t* value) override;
+        IFACEMETHOD(get_InputCount)(uint32_t* value) override;
+
+        IFACEMETHOD(Instantiate)(
+            uint32_t inputCount,
+            IGraphicsEffectSource** inputs,
+            uint32_t* effectCount,
+            IGraphicsEffect*** effects) override;
+
+    private:
+        // Walks the original graph while it is being compiled.
+        class Compiler;
+
+        // Rewrites the compiled graph to do the same thing with fewer effects.
+        class Optimizer;
+
+        // Works out how precise each effect's output needs to be, given the inputs of an instance.
+        class PrecisionChooser;
+    };
+
+
+    class CanvasEffectGraphTemplateFactory
+        : public AgileActivationFactory<ICanvasEffectGraphTemplateStatics>
+        , private LifespanTracker<CanvasEffectGraphTemplateFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Effects_CanvasEffectGraphTemplate, BaseTrust);
+
+    public:
+        IFACEMETHOD(Compile)(
+            IGraphicsEffect* rootEffect,
+            ICanvasEffectGraphTemplate** result) override;
+
+        IFACEMETHOD(CompileOptimized)(
+            IGraphicsEffect* rootEffect,
+            ICanvasEffectGraphTemplate** result) override;
+
+        IFACEMETHOD(CompileOptimizedWithOptions)(
+            IGraphicsEffect* rootEffect,
+            CanvasEffectGraphOptimizations optimizations,
+            ICanvasEffectGraphTemplate** result) override;
+    };
+}}}}}
@@ -0,0 +1,377 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "ColorManagementConverter.h"
+#include "images/ScopedBitmapMappedPixelAccess.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    //
+    // ColorManagementConverterFactory
+    //
+
+    IFACEMETHODIMP ColorManagementConverterFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        IColorManagementProfile* sourceColorProfile,
+        IColorManagementProfile* outputColorProfile,
+        IColorManagementConverter** converter)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(sourceColorProfile);
+                CheckInPointer(outputColorProfile);
+                CheckAndClearOutPointer(converter);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newConverter = Make<ColorManagementConverter>(device.Get(), sourceColorProfile, outputColorProfile);
+                CheckMakeResult(newConverter);
+
+                ThrowIfFailed(newConverter.CopyTo(converter));
+            });
+    }
+
+
+    DXGI_FORMAT GetColorConversionTargetFormat(DXGI_FORMAT sourceFormat)
+    {
+        switch (sourceFormat)
+        {
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            return sourceFormat;
+
+        // Keep the extra precision of high bit depth sources.
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R10G10B10A2_UNORM:
+            return DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+        default:
+            return DXGI_FORMAT_B8G8R8A8_UNORM;
+        }
+    }
+
+
+    static std::vector<ComPtr<ICanvasBitmap>> GetBitmaps(IIterable<CanvasBitmap*>* items)
+    {
+        std::vector<ComPtr<ICanvasBitmap>> bitmaps;
+
+        ComPtr<IIterator<CanvasBitmap*>> iterator;
+        ThrowIfFailed(items->First(&iterator));
+
+        boolean hasCurrent;
+        ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+        while (hasCurrent)
+        {
+            ComPtr<ICanvasBitmap> bitmap;
+            ThrowIfFailed(iterator->get_Current(&bitmap));
+
+            CheckInPointer(bitmap.Get());
+
+            bitmaps.push_back(std::move(bitmap));
+
+            ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+        }
+
+        if (bitmaps.size() > INT32_MAX)
+            ThrowHR(E_INVALIDARG);
+
+        return bitmaps;
+    }
+
+
+    //
+    // ColorManagementConverter
+    //
+
+    ColorManagementConverter::ColorManagementConverter(
+        ICanvasDevice* device,
+        IColorManagementProfile* sourceColorProfile,
+        IColorManagementProfile* outputColorProfile)
+        : m_device(device)
+        , m_effect(Make<ColorManagementEffect>())
+    {
+        CheckMakeResult(m_effect);
+
+        ThrowIfFailed(m_effect->put_SourceColorProfile(sourceColorProfile));
+        ThrowIfFailed(m_effect->put_OutputColorProfile(outputColorProfile));
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::get_SourceColorProfile(IColorManagementProfile** value)
+    {
+        return m_effect->get_SourceColorProfile(value);
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::get_OutputColorProfile(IColorManagementProfile** value)
+    {
+        return m_effect->get_OutputColorProfile(value);
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::get_Quality(ColorManagementEffectQuality* value)
+    {
+        return m_effect->get_Quality(value);
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::put_Quality(ColorManagementEffectQuality value)
+    {
+        return m_effect->put_Quality(value);
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::ConvertAsync(
+        IIterable<CanvasBitmap*>* bitmaps,
+        IAsyncOperation<IVectorView<CanvasBitmap*>*>** convertedBitmaps)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(bitmaps);
+                CheckAndClearOutPointer(convertedBitmaps);
+
+                auto sources = GetBitmaps(bitmaps);
+                ComPtr<ColorManagementConverter> self = this;
+
+                auto asyncOperation = Make<AsyncOperation<IVectorView<CanvasBitmap*>>>(
+                    [=]
+                    {
+                        return self->Convert(sources);
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(convertedBitmaps));
+            });
+    }
+
+    IFACEMETHODIMP ColorManagementConverter::ConvertToPixelBytesAsync(
+        IIterable<CanvasBitmap*>* bitmaps,
+        IColorManagementConvertedPixelsHandler* rawHandler,
+        IAsyncAction** action)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(bitmaps);
+                CheckInPointer(rawHandler);
+                CheckAndClearOutPointer(action);
+
+                auto sources = GetBitmaps(bitmaps);
+                ComPtr<IColorManagementConvertedPixelsHandler> handler(rawHandler);
+                ComPtr<ColorManagementConverter> self = this;
+
+                auto asyncAction = Make<AsyncAction>(
+                    [=]
+                    {
+                        self->ConvertToPixelBytes(sources, handler.Get());
+                    });
+
+                CheckMakeResult(asyncAction);
+                ThrowIfFailed(asyncAction.CopyTo(action));
+            });
+    }
+
+    ComPtr<IVectorView<CanvasBitmap*>> ColorManagementConverter::Convert(std::vector<ComPtr<ICanvasBitmap>> const& bitmaps)
+    {
+        Lock lock(m_mutex);
+
+        auto vector = MakePooled<Vector<CanvasBitmap*>>();
+        CheckMakeResult(vector);
+
+        for (auto& bitmap : bitmaps)
+        {
+            AsyncCancellation::ThrowIfCanceled();
+
+            auto& source = As<ICanvasBitmapInternal>(bitmap)->GetD2DBitmap();
+            auto target = CreateTarget(source.Get());
+
+            DrawConverted(bitmap.Get(), source.Get(), target.Get());
+
+            auto convertedBitmap = Make<CanvasBitmap>(m_device.Get(), target.Get());
+            CheckMakeResult(convertedBitmap);
+
+            ThrowIfFailed(vector->Append(convertedBitmap.Get()));
+        }
+
+        ComPtr<IVectorView<CanvasBitmap*>> view;
+        ThrowIfFailed(vector->GetView(&view));
+
+        return view;
+    }
+
+    void ColorManagementConverter::ConvertToPixelBytes(std::vector<ComPtr<ICanvasBitmap>> const& bitmaps, IColorManagementConvertedPixelsHandler* handler)
+    {
+        Lock lock(m_mutex);
+
+        // Each bitmap is read back through a staging bitmap while the GPU
+        // converts the next one.
+        struct PendingCopy
+        {
+            ComPtr<ID2D1Bitmap1> Staging;
+            int32_t Index;
+            D2D1_SIZE_U Size;
+            DXGI_FORMAT Format;
+        };
+
+        PendingCopy pending{};
+        std::vector<uint8_t> packedPixels;
+
+        auto deliverPending = [&]
+        {
+            ScopedBitmapMappedPixelAccess pixels(m_device.Get(), pending.Staging);
+
+            auto bytesPerRow = pending.Size.width * GetBytesPerBlock(pending.Format);
+            auto totalBytes = bytesPerRow * pending.Size.height;
+
+            uint8_t* data = pixels.GetLockedData();
+
+            // Staging bitmaps come from a pool, so are usually wider than the image.
+            if (pixels.GetStride() != bytesPerRow)
+            {
+                packedPixels.resize(totalBytes);
+
+                for (uint32_t y = 0; y < pending.Size.height; y++)
+                {
+                    memcpy(packedPixels.data() + y * bytesPerRow, data + y * pixels.GetStride(), bytesPerRow);
+                }
+
+                data = packedPixels.data();
+            }
+
+            ThrowIfFailed(handler->Invoke(pending.Index, static_cast<DirectXPixelFormat>(pending.Format), totalBytes, data));
+
+            pending.Staging.Reset();
+        };
+
+        for (size_t i = 0; i < bitmaps.size(); i++)
+        {
+            AsyncCancellation::ThrowIfCanceled();
+
+            auto& source = As<ICanvasBitmapInternal>(bitmaps[i])->GetD2DBitmap();
+            auto target = GetPooledTarget(source.Get());
+
+            DrawConverted(bitmaps[i].Get(), source.Get(), target.Get());
+
+            auto staging = ScopedBitmapMappedPixelAccess::BeginCopy(m_device.Get(), target.Get(), nullptr);
+
+            if (pending.Staging)
+                deliverPending();
+
+            pending = PendingCopy{ staging, static_cast<int32_t>(i), target->GetPixelSize(), target->GetPixelFormat().format };
+        }
+
+        if (pending.Staging)
+            deliverPending();
+    }
+
+    ComPtr<ID2D1Bitmap1> ColorManagementConverter::CreateTarget(ID2D1Bitmap1* source)
+    {
+        auto size = source->GetPixelSize();
+        auto pixelFormat = source->GetPixelFormat();
+
+        float dpiX, dpiY;
+        source->GetDpi(&dpiX, &dpiY);
+
+        auto alpha = (pixelFormat.alphaMode == D2D1_ALPHA_MODE_IGNORE) ? CanvasAlphaMode::Ignore : CanvasAlphaMode::Premultiplied;
+
+        return As<ICanvasDeviceInternal>(m_device)->CreateRenderTargetBitmap(
+            PixelsToDips(size.width, dpiX),
+            PixelsToDips(size.height, dpiX),
+            dpiX,
+            static_cast<DirectXPixelFormat>(GetColorConversionTargetFormat(pixelFormat.format)),
+            alpha);
+    }
+
+    ComPtr<ID2D1Bitmap1> ColorManagementConverter::GetPooledTarget(ID2D1Bitmap1* source)
+    {
+        auto size = source->GetPixelSize();
+        auto pixelFormat = source->GetPixelFormat();
+        auto format = GetColorConversionTargetFormat(pixelFormat.format);
+        bool isOpaque = (pixelFormat.alphaMode == D2D1_ALPHA_MODE_IGNORE);
+
+        float dpiX, dpiY;
+        source->GetDpi(&dpiX, &dpiY);
+
+        for (auto it = m_targetPool.begin(); it != m_targetPool.end(); ++it)
+        {
+            auto& target = *it;
+
+            auto targetSize = target->GetPixelSize();
+            auto targetFormat = target->GetPixelFormat();
+
+            float targetDpiX, targetDpiY;
+            target->GetDpi(&targetDpiX, &targetDpiY);
+
+            if (targetSize.width == size.width &&
+                targetSize.height == size.height &&
+                targetFormat.format == format &&
+                (targetFormat.alphaMode == D2D1_ALPHA_MODE_IGNORE) == isOpaque &&
+                targetDpiX == dpiX)
+            {
+                // Most recently used at the front.
+                auto found = std::move(target);
+                m_targetPool.erase(it);
+                m_targetPool.insert(m_targetPool.begin(), found);
+                return found;
+            }
+        }
+
+        auto target = CreateTarget(source);
+
+        m_targetPool.insert(m_targetPool.begin(), target);
+
+        if (m_targetPool.size() > MaximumPooledTargets)
+            m_targetPool.pop_back();
+
+        return target;
+    }
+
+    void ColorManagementConverter::DrawConverted(ICanvasBitmap* bitmap, ID2D1Bitmap1* source, ID2D1Bitmap1* target)
+    {
+        ThrowIfFailed(m_effect->put_Source(As<IGraphicsEffectSource>(bitmap).Get()));
+
+        // Let go of the source once it has been drawn, so a batch does not
+        // keep the last bitmap alive.
+        auto clearSource = MakeScopeWarden([&] { m_effect->put_Source(nullptr); });
+
+        float dpiX, dpiY;
+        source->GetDpi(&dpiX, &dpiY);
+
+        auto lease = As<ICanvasDeviceInternal>(m_device)->GetResourceCreationDeviceContext();
+        auto deviceContext = lease.Get();
+
+        // Realizes the effect the first time, and just updates its input after that.
+        auto d2dImage = As<ICanvasImageInternal>(m_effect)->GetD2DImage(m_device.Get(), deviceContext, GetImageFlags::None, dpiX);
+
+        auto restoreState = MakeScopeWarden(
+            [&]
+            {
+                deviceContext->SetTarget(nullptr);
+                deviceContext->SetDpi(DEFAULT_DPI, DEFAULT_DPI);
+            });
+
+        deviceContext->SetTarget(target);
+        deviceContext->SetDpi(dpiX, dpiY);
+        deviceContext->BeginDraw();
+        deviceContext->Clear(D2D1::ColorF(0, 0));
+        deviceContext->DrawImage(d2dImage.Get());
+        ThrowIfFailed(deviceContext->EndDraw());
+    }
+}}}}}
+
+ActivatableClassWithFactory(ColorManagementConverter, ColorManagementConverterFactory);
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "generated/ColorManagementEffect.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    class ColorManagementConverterFactory
+        : public AgileActivationFactory<IColorManagementConverterFactory>
+        , private LifespanTracker<ColorManagementConverterFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Effects_ColorManagementConverter, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            IColorManagementProfile* sourceColorProfile,
+            IColorManagementProfile* outputColorProfile,
+            IColorManagementConverter** converter) override;
+    };
+
+
+    // Picks a format that a converted bitmap can be drawn into, as close as
+    // possible to that of the bitmap being converted.
+    DXGI_FORMAT GetColorConversionTargetFormat(DXGI_FORMAT sourceFormat);
+
+
+    //
+    // Converting a batch of bitmaps one ColorManagementEffect at a time means
+    // realizing a new effect, and looking up both color contexts, for every
+    // bitmap.  This keeps a single effect, and just swaps its source each
+    // time, so the realization is reused for the whole batch and for any
+    // later batches.
+    //
+    // ConvertAsync draws each bitmap into a new render target, which becomes
+    // the converted bitmap.  ConvertToPixelBytesAsync instead draws into
+    // render targets pooled by size and format, and reads each one back
+    // through a staging bitmap while the GPU converts the next bitmap, so
+    // reading back does not wait for the GPU to go idle.
+    //
+    // Converting is serialized, so one converter can be shared between
+    // threads, but only converts one batch at a time.
+    //
+    class ColorManagementConverter
+        : public RuntimeClass<
+            IColorManagementConverter,
+            ICanvasResourceCreator>
+        , private LifespanTracker<ColorManagementConverter>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Effects_ColorManagementConverter, BaseTrust);
+
+        ComPtr<ICanvasDevice> m_device;
+        ComPtr<ColorManagementEffect> m_effect;
+
+        std::mutex m_mutex;
+        std::vector<ComPtr<ID2D1Bitmap1>> m_targetPool;
+
+    public:
+        // Only a few sizes are kept, since batches tend to be photos from the
+        // same camera, or thumbnails of the same size.
+        static const size_t MaximumPooledTargets = 4;
+
+        ColorManagementConverter(ICanvasDevice* device, IColorManagementProfile* sourceColorProfile, IColorManagementProfile* outputColorProfile);
+
+        IFACEMETHOD(get_SourceColorProfile)(IColorManagementProfile** value) override;
+        IFACEMETHOD(get_OutputColorProfile)(IColorManagementProfile** value) override;
+
+        IFACEMETHOD(get_Quality)(ColorManagementEffectQuality* value) override;
+        IFACEMETHOD(put_Quality)(ColorManagementEffectQuality value) override;
+
+        IFACEMETHOD(ConvertAsync)(
+            IIterable<CanvasBitmap*>* bitmaps,
+            IAsyncOperation<IVectorView<CanvasBitmap*>*>** convertedBitmaps) override;
+
+        IFACEMETHOD(ConvertToPixelBytesAsync)(
+            IIterable<CanvasBitmap*>* bitmaps,
+            IColorManagementConvertedPixelsHandler* handler,
+            IAsyncAction** action) override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        // The bodies of the async methods, run on the worker thread.
+        ComPtr<IVectorView<CanvasBitmap*>> Convert(std::vector<ComPtr<ICanvasBitmap>> const& bitmaps);
+        void ConvertToPixelBytes(std::vector<ComPtr<ICanvasBitmap>> const& bitmaps, IColorManagementConvertedPixelsHandler* handler);
+
+        size_t GetPooledTargetCount() const { return m_targetPool.size(); }
+
+    private:
+        ComPtr<ID2D1Bitmap1> CreateTarget(ID2D1Bitmap1* source);
+        ComPtr<ID2D1Bitmap1> GetPooledTarget(ID2D1Bitmap1* source);
+
+        void DrawConverted(ICanvasBitmap* bitmap, ID2D1Bitmap1* source, ID2D1Bitmap1* target);
+    };
+}}}}}
@@ -291,7 +291,8 @@ void ColorManagementProfile::Realize(ICanvasDevice* device)
     }
 
     // Create the D2D color context.
-    auto deviceContext = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+    auto deviceInternal = As<ICanvasDeviceInternal>(device);
+    auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
     
     ComPtr<ID2D1ColorContext> newColorContext;
 
@@ -299,12 +300,32 @@ void ColorManagementProfile::Realize(ICanvasDevice* device)
     if (m_type == ColorManagementProfileType::Icc)
 #endif
     {
-        // Create an old style ICC color context.
-        ThrowIfFailed(deviceContext->CreateColorContext(
-            StaticCastAs<D2D1_COLOR_SPACE>(m_colorSpace),
-            m_iccProfile.data(),
-            static_cast<uint32_t>(m_iccProfile.size()),
-            &newColorContext));
+        // Create an old style ICC color context. Parsing a custom ICC profile is relatively
+        // expensive, and color contexts are immutable, so profiles created from the same
+        // bytes share one D2D color context via the device's EffectResourceCache.
+        auto createColorContext = [&]
+        {
+            ComPtr<ID2D1ColorContext> colorContext;
+
+            ThrowIfFailed(deviceContext->CreateColorContext(
+                StaticCastAs<D2D1_COLOR_SPACE>(m_colorSpace),
+                m_iccProfile.data(),
+                static_cast<uint32_t>(m_iccProfile.size()),
+                &colorContext));
+
+            return colorContext;
+        };
+
+        if (m_colorSpace == CanvasColorSpace::Custom)
+        {
+            auto key = EffectResourceCache::MakeKey(__uuidof(ID2D1ColorContext), m_iccProfile.data(), m_iccProfile.size(), {});
+
+            newColorContext = deviceInternal->GetEffectResourceCache()->GetOrCreate<ID2D1ColorContext>(key, createColorContext);
+        }
+        else
+        {
+            newColorContext = createColorContext();
+        }
     }
 #if WINVER > _WIN32_WINNT_WINBLUE
     else
@@ -341,7 +362,7 @@ void ColorManagementProfile::Realize(ICanvasDevice* device)
 #endif
 
     // Store our new realization.
-    SetResource(newColorContext.Get());
+    SetSharedResource(newColorContext.Get());
 
     m_device = device;
 
@@ -0,0 +1,353 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "DownsampledBlurEffectImpl.h"
+#include "shader/PixelShaderEffectImpl.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    // Same limit as GaussianBlurEffect and ShadowEffect.
+    static const float MaxBlurAmount = 250.0f;
+
+    // The blur, in pixels of the downscaled image, is kept at least this large.
+    static const float MinimumBlurAtLowestQuality = 2.0f;
+    static const float MinimumBlurAtHighestQuality = 16.0f;
+
+    static const float SmallestScale = 1.0f / 32;
+
+
+    float GetDownsampledBlurScale(float blurAmount, float quality)
+    {
+        auto minimumBlur = MinimumBlurAtLowestQuality + (MinimumBlurAtHighestQuality - MinimumBlurAtLowestQuality) * quality;
+
+        float scale = 1;
+
+        while (blurAmount * scale >= minimumBlur * 2 && scale > SmallestScale)
+        {
+            scale /= 2;
+        }
+
+        return scale;
+    }
+
+
+    DownsampledBlurEffectImpl::DownsampledBlurEffectImpl(bool isShadow)
+        : m_isShadow(isShadow)
+        , m_graphScale(0)
+        , m_blurAmount(3.0f)
+        , m_optimization(D2D1_GAUSSIANBLUR_OPTIMIZATION_BALANCED)
+        , m_borderMode(D2D1_BORDER_MODE_SOFT)
+        , m_shadowColor(D2D1::Vector4F(0, 0, 0, 1))
+        , m_quality(0.5f)
+    { }
+
+
+#define XML(xml) TEXT(#xml)
+
+    const wchar_t fastGaussianBlurEffectXml[] = XML
+    (
+        <?xml version='1.0'?>
+        <Effect>
+            <Property name='DisplayName' type='string' value='FastGaussianBlurEffect'/>
+            <Property name='Author'      type='string' value='Microsoft Corporation'/>
+            <Property name='Category'    type='string' value='Win2D'/>
+            <Property name='Description' type='string' value='Gaussian blur, applied at reduced resolution.'/>
+            <Inputs>
+                <Input name='Source'/>
+            </Inputs>
+            <Property name='BlurAmount' type='float'>
+                <Property name='DisplayName' type='string' value='BlurAmount'/>
+                <Property name='Min' type='float' value='0.0'/>
+                <Property name='Max' type='float' value='250.0'/>
+                <Property name='Default' type='float' value='3.0'/>
+            </Property>
+            <Property name='Optimization' type='uint32'>
+                <Property name='DisplayName' type='string' value='Optimization'/>
+                <Property name='Default' type='uint32' value='1'/>
+            </Property>
+            <Property name='BorderMode' type='uint32'>
+                <Property name='DisplayName' type='string' value='BorderMode'/>
+                <Property name='Default' type='uint32' value='0'/>
+            </Property>
+            <Property name='Quality' type='float'>
+                <Property name='DisplayName' type='string' value='Quality'/>
+                <Property name='Min' type='float' value='0.0'/>
+                <Property name='Max' type='float' value='1.0'/>
+                <Property name='Default' type='float' value='0.5'/>
+            </Property>
+        </Effect>
+    );
+
+    const wchar_t fastShadowEffectXml[] = XML
+    (
+        <?xml version='1.0'?>
+        <Effect>
+            <Property name='DisplayName' type='string' value='FastShadowEffect'/>
+            <Property name='Author'      type='string' value='Microsoft Corporation'/>
+            <Property name='Category'    type='string' value='Win2D'/>
+            <Property name='Description' type='string' value='Shadow, blurred at reduced resolution.'/>
+            <Inputs>
+                <Input name='Source'/>
+            </Inputs>
+            <Property name='BlurAmount' type='float'>
+                <Property name='DisplayName' type='string' value='BlurAmount'/>
+                <Property name='Min' type='float' value='0.0'/>
+                <Property name='Max' type='float' value='250.0'/>
+                <Property name='Default' type='float' value='3.0'/>
+            </Property>
+            <Property name='ShadowColor' type='vector4'>
+                <Property name='DisplayName' type='string' value='ShadowColor'/>
+                <Property name='Default' type='vector4' value='(0.0, 0.0, 0.0, 1.0)'/>
+            </Property>
+            <Property name='Optimization' type='uint32'>
+                <Property name='DisplayName' type='string' value='Optimization'/>
+                <Property name='Default' type='uint32' value='1'/>
+            </Property>
+            <Property name='Quality' type='float'>
+                <Property name='DisplayName' type='string' value='Quality'/>
+                <Property name='Min' type='float' value='0.0'/>
+                <Property name='Max' type='float' value='1.0'/>
+                <Property name='Default' type='float' value='0.5'/>
+            </Property>
+        </Effect>
+    );
+
+
+    static HRESULT STDMETHODCALLTYPE FastGaussianBlurEffectImplFactory(IUnknown** result)
+    {
+        return ExceptionBoundary([&]
+        {
+            auto effect = Make<DownsampledBlurEffectImpl>(false);
+            CheckMakeResult(effect);
+
+            ThrowIfFailed(effect.CopyTo(result));
+        });
+    }
+
+
+    static HRESULT STDMETHODCALLTYPE FastShadowEffectImplFactory(IUnknown** result)
+    {
+        return ExceptionBoundary([&]
+        {
+            auto effect = Make<DownsampledBlurEffectImpl>(true);
+            CheckMakeResult(effect);
+
+            ThrowIfFailed(effect.CopyTo(result));
+        });
+    }
+
+
+    void DownsampledBlurEffectImpl::Register(ID2D1Factory1* factory)
+    {
+        if (!IsEffectRegistered(factory, CLSID_FastGaussianBlurEffect))
+        {
+            static const D2D1_PROPERTY_BINDING bindings[] =
+            {
+                D2D1_VALUE_TYPE_BINDING(L"BlurAmount",   &SetBlurAmount,   &GetBlurAmount),
+                D2D1_VALUE_TYPE_BINDING(L"Optimization", &SetOptimization, &GetOptimization),
+                D2D1_VALUE_TYPE_BINDING(L"BorderMode",   &SetBorderMode,   &GetBorderMode),
+                D2D1_VALUE_TYPE_BINDING(L"Quality",      &SetQuality,      &GetQuality),
+            };
+
+            ThrowIfFailed(factory->RegisterEffectFromString(CLSID_FastGaussianBlurEffect, fastGaussianBlurEffectXml, bindings, _countof(bindings), FastGaussianBlurEffectImplFactory));
+        }
+
+        if (!IsEffectRegistered(factory, CLSID_FastShadowEffect))
+        {
+            static const D2D1_PROPERTY_BINDING bindings[] =
+            {
+                D2D1_VALUE_TYPE_BINDING(L"BlurAmount",   &SetBlurAmount,   &GetBlurAmount),
+                D2D1_VALUE_TYPE_BINDING(L"ShadowColor",  &SetShadowColor,  &GetShadowColor),
+                D2D1_VALUE_TYPE_BINDING(L"Optimization", &SetOptimization, &GetOptimization),
+                D2D1_VALUE_TYPE_BINDING(L"Quality",      &SetQuality,      &GetQuality),
+            };
+
+            ThrowIfFailed(factory->RegisterEffectFromString(CLSID_FastShadowEffect, fastShadowEffectXml, bindings, _countof(bindings), FastShadowEffectImplFactory));
+        }
+    }
+
+
+    IFACEMETHODIMP DownsampledBlurEffectImpl::Initialize(ID2D1EffectContext* effectContext, ID2D1TransformGraph* transformGraph)
+    {
+        return ExceptionBoundary([&]
+        {
+            m_effectContext = effectContext;
+            m_transformGraph = transformGraph;
+
+            // The inner effects are created once, then wrapped up as nodes of our transform graph.
+            ThrowIfFailed(effectContext->CreateEffect(CLSID_D2D1Scale, &m_downscaleEffect));
+            ThrowIfFailed(effectContext->CreateEffect(m_isShadow ? CLSID_D2D1Shadow : CLSID_D2D1GaussianBlur, &m_blurEffect));
+            ThrowIfFailed(effectContext->CreateEffect(CLSID_D2D1Scale, &m_upscaleEffect));
+
+            // Shrinking uses a prefiltered cubic, so detail smaller than a downscaled pixel averages
+            // out rather than flickering. Everything is smooth once blurred, so linear is fine for
+            // growing the result back to full size.
+            ThrowIfFailed(m_downscaleEffect->SetValue(D2D1_SCALE_PROP_INTERPOLATION_MODE, D2D1_SCALE_INTERPOLATION_MODE_HIGH_QUALITY_CUBIC));
+            ThrowIfFailed(m_upscaleEffect->SetValue(D2D1_SCALE_PROP_INTERPOLATION_MODE, D2D1_SCALE_INTERPOLATION_MODE_LINEAR));
+
+            ThrowIfFailed(effectContext->CreateTransformNodeFromEffect(m_downscaleEffect.Get(), &m_downscaleNode));
+            ThrowIfFailed(effectContext->CreateTransformNodeFromEffect(m_blurEffect.Get(), &m_blurNode));
+            ThrowIfFailed(effectContext->CreateTransformNodeFromEffect(m_upscaleEffect.Get(), &m_upscaleNode));
+        });
+    }
+
+
+    IFACEMETHODIMP DownsampledBlurEffectImpl::SetGraph(ID2D1TransformGraph*)
+    {
+        // We have a fixed single input, so D2D never needs to change our graph.
+        return E_NOTIMPL;
+    }
+
+
+    IFACEMETHODIMP DownsampledBlurEffectImpl::PrepareForRender(D2D1_CHANGE_TYPE)
+    {
+        return ExceptionBoundary([&]
+        {
+            auto scale = GetDownsampledBlurScale(m_blurAmount, m_quality);
+
+            // Only rebuild the graph when switching to or from full resolution.
+            if (m_graphScale == 0 || (scale == 1) != (m_graphScale == 1))
+            {
+                ConfigureTransformGraph(scale);
+            }
+
+            SetInnerEffectProperties(scale);
+
+            m_graphScale = scale;
+        });
+    }
+
+
+    void DownsampledBlurEffectImpl::ConfigureTransformGraph(float scale)
+    {
+        m_transformGraph->Clear();
+
+        if (scale == 1)
+        {
+            // Small blurs are cheap enough as they are, and would lose too much detail if downscaled.
+            ThrowIfFailed(m_transformGraph->AddNode(m_blurNode.Get()));
+            ThrowIfFailed(m_transformGraph->ConnectToEffectInput(0, m_blurNode.Get(), 0));
+            ThrowIfFailed(m_transformGraph->SetOutputNode(m_blurNode.Get()));
+        }
+        else
+        {
+            ThrowIfFailed(m_transformGraph->AddNode(m_downscaleNode.Get()));
+            ThrowIfFailed(m_transformGraph->AddNode(m_blurNode.Get()));
+            ThrowIfFailed(m_transformGraph->AddNode(m_upscaleNode.Get()));
+
+            ThrowIfFailed(m_transformGraph->ConnectToEffectInput(0, m_downscaleNode.Get(), 0));
+            ThrowIfFailed(m_transformGraph->ConnectNode(m_downscaleNode.Get(), m_blurNode.Get(), 0));
+            ThrowIfFailed(m_transformGraph->ConnectNode(m_blurNode.Get(), m_upscaleNode.Get(), 0));
+            ThrowIfFailed(m_transformGraph->SetOutputNode(m_upscaleNode.Get()));
+        }
+    }
+
+
+    void DownsampledBlurEffectImpl::SetInnerEffectProperties(float scale)
+    {
+        // The blur amount is in DIPs, so shrinks along with the image.
+        auto blurAmount = m_blurAmount * scale;
+
+        if (m_isShadow)
+        {
+            ThrowIfFailed(m_blurEffect->SetValue(D2D1_SHADOW_PROP_BLUR_STANDARD_DEVIATION, blurAmount));
+            ThrowIfFailed(m_blurEffect->SetValue(D2D1_SHADOW_PROP_COLOR, m_shadowColor));
+            ThrowIfFailed(m_blurEffect->SetValue(D2D1_SHADOW_PROP_OPTIMIZATION, m_optimization));
+        }
+        else
+        {
+            ThrowIfFailed(m_blurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, blurAmount));
+            ThrowIfFailed(m_blurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_OPTIMIZATION, m_optimization));
+            ThrowIfFailed(m_blurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, m_borderMode));
+        }
+
+        if (scale != 1)
+        {
+            ThrowIfFailed(m_downscaleEffect->SetValue(D2D1_SCALE_PROP_SCALE, D2D1::Vector2F(scale, scale)));
+            ThrowIfFailed(m_upscaleEffect->SetValue(D2D1_SCALE_PROP_SCALE, D2D1::Vector2F(1 / scale, 1 / scale)));
+
+            ThrowIfFailed(m_downscaleEffect->SetValue(D2D1_SCALE_PROP_BORDER_MODE, m_borderMode));
+            ThrowIfFailed(m_upscaleEffect->SetValue(D2D1_SCALE_PROP_BORDER_MODE, m_borderMode));
+        }
+    }
+
+
+    HRESULT DownsampledBlurEffectImpl::SetBlurAmount(float value)
+    {
+        if (value < 0 || value > MaxBlurAmount)
+            return E_INVALIDARG;
+
+        m_blurAmount = value;
+        return S_OK;
+    }
+
+
+    float DownsampledBlurEffectImpl::GetBlurAmount() const
+    {
+        return m_blurAmount;
+    }
+
+
+    HRESULT DownsampledBlurEffectImpl::SetOptimization(UINT32 value)
+    {
+        if (value > D2D1_GAUSSIANBLUR_OPTIMIZATION_QUALITY)
+            return E_INVALIDARG;
+
+        m_optimization = value;
+        return S_OK;
+    }
+
+
+    UINT32 DownsampledBlurEffectImpl::GetOptimization() const
+    {
+        return m_optimization;
+    }
+
+
+    HRESULT DownsampledBlurEffectImpl::SetBorderMode(UINT32 value)
+    {
+        if (value > D2D1_BORDER_MODE_HARD)
+            return E_INVALIDARG;
+
+        m_borderMode = value;
+        return S_OK;
+    }
+
+
+    UINT32 DownsampledBlurEffectImpl::GetBorderMode() const
+    {
+        return m_borderMode;
+    }
+
+
+    HRESULT DownsampledBlurEffectImpl::SetShadowColor(D2D1_VECTOR_4F value)
+    {
+        m_shadowColor = value;
+        return S_OK;
+    }
+
+
+    D2D1_VECTOR_4F DownsampledBlurEffectImpl::GetShadowColor() const
+    {
+        return m_shadowColor;
+    }
+
+
+    HRESULT DownsampledBlurEffectImpl::SetQuality(float value)
+    {
+        if (value < 0 || value > 1)
+            return E_INVALIDARG;
+
+        m_quality = value;
+        return S_OK;
+    }
+
+
+    float DownsampledBlurEffectImpl::GetQuality() const
+    {
+        return m_quality;
+    }
+
+}}}}}
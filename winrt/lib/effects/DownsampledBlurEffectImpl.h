@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
+{
+    DEFINE_GUID(CLSID_FastGaussianBlurEffect, 0x6f1c4a2e, 0x8d3b, 0x4e57, 0xa1, 0x9c, 0x52, 0x7e, 0x0b, 0xd4, 0x36, 0x81);
+    DEFINE_GUID(CLSID_FastShadowEffect,       0xc2a8e93d, 0x15f4, 0x4b6a, 0x9e, 0x07, 0xd3, 0x61, 0x4f, 0xa8, 0x2c, 0x5b);
+
+
+    // How much to shrink the source by before blurring it. Scales are powers of two, chosen so
+    // the blur at the reduced resolution is still at least a few pixels wide: the higher the
+    // quality (0 to 1), the more pixels it keeps.
+    float GetDownsampledBlurScale(float blurAmount, float quality);
+
+
+    // Our custom Direct2D effect, which implements both FastGaussianBlurEffect and FastShadowEffect.
+    // It wraps the built in blur or shadow effect, scaling the image down before blurring it and
+    // back up afterward. Large blurs then have far fewer pixels to work on.
+    class DownsampledBlurEffectImpl : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1EffectImpl>
+                                    , private LifespanTracker<DownsampledBlurEffectImpl>
+    {
+        bool m_isShadow;
+
+        ComPtr<ID2D1EffectContext> m_effectContext;
+        ComPtr<ID2D1TransformGraph> m_transformGraph;
+
+        ComPtr<ID2D1Effect> m_downscaleEffect;
+        ComPtr<ID2D1Effect> m_blurEffect;
+        ComPtr<ID2D1Effect> m_upscaleEffect;
+
+        ComPtr<ID2D1TransformNode> m_downscaleNode;
+        ComPtr<ID2D1TransformNode> m_blurNode;
+        ComPtr<ID2D1TransformNode> m_upscaleNode;
+
+        // The scale the inner effects were last set up for. Zero means they haven't been yet.
+        float m_graphScale;
+
+        float m_blurAmount;
+        UINT32 m_optimization;
+        UINT32 m_borderMode;
+        D2D1_VECTOR_4F m_shadowColor;
+        float m_quality;
+
+    public:
+        DownsampledBlurEffectImpl(bool isShadow);
+
+        static void Register(ID2D1Factory1* factory);
+
+        IFACEMETHOD(Initialize)(ID2D1EffectContext* effectContext, ID2D1TransformGraph* transformGraph) override;
+        IFACEMETHOD(SetGraph)(ID2D1TransformGraph* transformGraph) override;
+        IFACEMETHOD(PrepareForRender)(D2D1_CHANGE_TYPE changeType) override;
+
+    private:
+        void ConfigureTransformGraph(float scale);
+        void SetInnerEffectProperties(float scale);
+
+        HRESULT SetBlurAmount(float value);
+        float GetBlurAmount() const;
+
+        HRESULT SetOptimization(UINT32 value);
+        UINT32 GetOptimization() const;
+
+        HRESULT SetBorderMode(UINT32 value);
+        UINT32 GetBorderMode() const;
+
+        HRESULT SetShadowColor(D2D1_VECTOR_4F value);
+        D2D1_VECTOR_4F GetShadowColor() const;
+
+        HRESULT SetQuality(float value);
+        float GetQuality() const;
+    };
+
+
+    // Direct2D effect property indices (must match the effect XML from DownsampledBlurEffectImpl.cpp).
+    // These follow the naming of d2d1effects.h, as they are used the same way by the effect wrappers.
+    enum FAST_GAUSSIANBLUR_PROP
+    {
+        FAST_GAUSSIANBLUR_PROP_STANDARD_DEVIATION = 0,
+        FAST_GAUSSIANBLUR_PROP_OPTIMIZATION = 1,
+        FAST_GAUSSIANBLUR_PROP_BORDER_MODE = 2,
+        FAST_GAUSSIANBLUR_PROP_QUALITY = 3,
+    };
+
+    enum FAST_SHADOW_PROP
+    {
+        FAST_SHADOW_PROP_BLUR_STANDARD_DEVIATION = 0,
+        FAST_SHADOW_PROP_COLOR = 1,
+        FAST_SHADOW_PROP_OPTIMIZATION = 2,
+        FAST_SHADOW_PROP_QUALITY = 3,
+    };
+
+}}}}}
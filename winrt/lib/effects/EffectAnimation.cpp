@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "EffectAnimation.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    void ValidateAnimation(uint32_t keyframeCount, EffectKeyframe const* keyframes, EffectAnimationEasing easing)
+    {
+        switch (easing)
+        {
+        case EffectAnimationEasing::Linear:
+        case EffectAnimationEasing::Step:
+        case EffectAnimationEasing::EaseIn:
+        case EffectAnimationEasing::EaseOut:
+        case EffectAnimationEasing::EaseInOut:
+            break;
+
+        default:
+            ThrowHR(E_INVALIDARG);
+        }
+
+        if (keyframeCount == 0)
+            ThrowHR(E_INVALIDARG, Strings::EffectAnimationBadKeyframes);
+
+        for (uint32_t i = 1; i < keyframeCount; i++)
+        {
+            if (keyframes[i].Time.Duration < keyframes[i - 1].Time.Duration)
+                ThrowHR(E_INVALIDARG, Strings::EffectAnimationBadKeyframes);
+        }
+    }
+
+
+    // Maps linear progress (0 to 1) between two keyframes onto the easing curve.
+    static float ApplyEasing(EffectAnimationEasing easing, float t)
+    {
+        switch (easing)
+        {
+        case EffectAnimationEasing::Step:
+            return 0;
+
+        case EffectAnimationEasing::EaseIn:
+            return t * t * t;
+
+        case EffectAnimationEasing::EaseOut:
+        {
+            auto u = 1 - t;
+            return 1 - u * u * u;
+        }
+
+        case EffectAnimationEasing::EaseInOut:
+            if (t < 0.5f)
+            {
+                return 4 * t * t * t;
+            }
+            else
+            {
+                auto u = 2 - 2 * t;
+                return 1 - u * u * u / 2;
+            }
+
+        default:
+            return t;
+        }
+    }
+
+
+    Numerics::Vector4 EvaluateKeyframes(std::vector<EffectKeyframe> const& keyframes, EffectAnimationEasing easing, int64_t time)
+    {
+        assert(!keyframes.empty());
+
+        // Find the first keyframe that comes after the requested time.
+        auto next = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+            [](int64_t time, EffectKeyframe const& keyframe)
+            {
+                return time < keyframe.Time.Duration;
+            });
+
+        if (next == keyframes.begin())
+            return keyframes.front().Value;
+
+        if (next == keyframes.end())
+            return keyframes.back().Value;
+
+        auto& a = *(next - 1);
+        auto& b = *next;
+
+        auto t = static_cast<float>(time - a.Time.Duration) / static_cast<float>(b.Time.Duration - a.Time.Duration);
+
+        t = ApplyEasing(easing, t);
+
+        return Numerics::Vector4
+        {
+            a.Value.X + (b.Value.X - a.Value.X) * t,
+            a.Value.Y + (b.Value.Y - a.Value.Y) * t,
+            a.Value.Z + (b.Value.Z - a.Value.Z) * t,
+            a.Value.W + (b.Value.W - a.Value.W) * t,
+        };
+    }
+}}}}}
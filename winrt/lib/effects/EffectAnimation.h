@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    // Where an animated value goes, worked out once when the animation is set up.
+    struct EffectAnimationTarget
+    {
+        unsigned int PropertyIndex;                 // D2D property index, or shader variable index.
+        GRAPHICS_EFFECT_PROPERTY_MAPPING Mapping;
+        PropertyType Type;
+        unsigned int ComponentCount;                // How many floats the property holds.
+        bool IsShaderProperty;
+    };
+
+    struct EffectAnimationTrack
+    {
+        std::vector<EffectKeyframe> Keyframes;
+        EffectAnimationEasing Easing;
+        EffectAnimationTarget Target;
+    };
+
+    // Throws unless there is at least one keyframe, and they are in time order.
+    void ValidateAnimation(uint32_t keyframeCount, EffectKeyframe const* keyframes, EffectAnimationEasing easing);
+
+    // Times are in TimeSpan units (100ns). Holds the first and last values outside the keyframe range.
+    Numerics::Vector4 EvaluateKeyframes(std::vector<EffectKeyframe> const& keyframes, EffectAnimationEasing easing, int64_t time);
+}}}}}
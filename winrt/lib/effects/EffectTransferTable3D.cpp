@@ -77,14 +77,11 @@ ComPtr<EffectTransferTable3D> EffectTransferTable3D::CreateNew(
         ThrowHR(E_INVALIDARG);
     }
 
-    // Get a resource creation device context.
     ComPtr<ICanvasDevice> device;
     ThrowIfFailed(resourceCreator->get_Device(&device));
 
-    auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
-    auto deviceContext = As<ID2D1DeviceContext2>(lease.Get());
+    auto deviceInternal = As<ICanvasDeviceInternal>(device);
 
-    // Create the D2D lookup table resource.
     uint32_t extents[3] =
     {
         static_cast<uint32_t>(sizeB),
@@ -98,13 +95,27 @@ ComPtr<EffectTransferTable3D> EffectTransferTable3D::CreateNew(
         bytesPerPixel * sizeB * sizeG,
     };
 
-    ComPtr<ID2D1LookupTable3D> lookupTable;
-    ThrowIfFailed(deviceContext->CreateLookupTable3D(precision, extents, bytes, byteCount, strides, &lookupTable));
+    // Lookup tables are immutable, so tables created from the same data can share one D2D resource.
+    auto key = EffectResourceCache::MakeKey(__uuidof(ID2D1LookupTable3D), bytes, byteCount, { static_cast<uint32_t>(precision), extents[0], extents[1], extents[2], strides[0], strides[1] });
+
+    auto lookupTable = deviceInternal->GetEffectResourceCache()->GetOrCreate<ID2D1LookupTable3D>(key, [&]
+    {
+        // Create the D2D lookup table resource.
+        auto lease = deviceInternal->GetResourceCreationDeviceContext();
+        auto deviceContext = As<ID2D1DeviceContext2>(lease.Get());
+
+        ComPtr<ID2D1LookupTable3D> newLookupTable;
+        ThrowIfFailed(deviceContext->CreateLookupTable3D(precision, extents, bytes, byteCount, strides, &newLookupTable));
+
+        return newLookupTable;
+    });
 
     // Create the Win2D wrapper.
-    auto transferTable = Make<EffectTransferTable3D>(device.Get(), lookupTable.Get());
+    auto transferTable = Make<EffectTransferTable3D>(device.Get(), nullptr);
     CheckMakeResult(transferTable);
 
+    transferTable->SetSharedResource(lookupTable.Get());
+
     return transferTable;
 }
 
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "FastGaussianBlurEffect.h"
+#include "DownsampledBlurEffectImpl.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(FastGaussianBlurEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(FAST_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, 3.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(FAST_GAUSSIANBLUR_PROP_OPTIMIZATION, D2D1_GAUSSIANBLUR_OPTIMIZATION_BALANCED),
+        EFFECT_PROPERTY_DEFAULT_UINT32(FAST_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(FAST_GAUSSIANBLUR_PROP_QUALITY, 0.5f))
+
+    FastGaussianBlurEffect::FastGaussianBlurEffect(ICanvasDevice* device, ID2D1Effect* effect)
+        : CanvasEffect(EffectId(), FastGaussianBlurEffectPropertyDefaults, 1, true, device, effect, static_cast<IFastGaussianBlurEffect*>(this))
+    {
+    }
+
+    IID const& FastGaussianBlurEffect::EffectId()
+    {
+        return CLSID_FastGaussianBlurEffect;
+    }
+
+    bool FastGaussianBlurEffect::Realize(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext)
+    {
+        // Before trying to instantiate our custom effect type, we must register it with the D2D factory.
+        ComPtr<ID2D1Factory> factory;
+        As<ICanvasDeviceInternal>(RealizationDevice())->GetD2DDevice()->GetFactory(&factory);
+
+        DownsampledBlurEffectImpl::Register(As<ID2D1Factory1>(factory).Get());
+
+        return CanvasEffect::Realize(flags, targetDpi, deviceContext);
+    }
+
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(FastGaussianBlurEffect,
+        BlurAmount,
+        float,
+        float,
+        FAST_GAUSSIANBLUR_PROP_STANDARD_DEVIATION,
+        0.0f,
+        250.0f)
+
+    IMPLEMENT_EFFECT_PROPERTY(FastGaussianBlurEffect,
+        Optimization,
+        uint32_t,
+        EffectOptimization,
+        FAST_GAUSSIANBLUR_PROP_OPTIMIZATION)
+
+    IMPLEMENT_EFFECT_PROPERTY(FastGaussianBlurEffect,
+        BorderMode,
+        uint32_t,
+        EffectBorderMode,
+        FAST_GAUSSIANBLUR_PROP_BORDER_MODE)
+
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(FastGaussianBlurEffect,
+        Quality,
+        float,
+        float,
+        FAST_GAUSSIANBLUR_PROP_QUALITY,
+        0.0f,
+        1.0f)
+
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(FastGaussianBlurEffect,
+        Source,
+        0)
+
+    IMPLEMENT_EFFECT_PROPERTY_MAPPING(FastGaussianBlurEffect,
+        { L"BlurAmount",   FAST_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT },
+        { L"Optimization", FAST_GAUSSIANBLUR_PROP_OPTIMIZATION,       GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT },
+        { L"BorderMode",   FAST_GAUSSIANBLUR_PROP_BORDER_MODE,        GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT },
+        { L"Quality",      FAST_GAUSSIANBLUR_PROP_QUALITY,            GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT })
+
+    ActivatableClassWithFactory(FastGaussianBlurEffect, ::SimpleAgileActivationFactory<FastGaussianBlurEffect>);
+}}}}}
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Microsoft::Graphics::Canvas;
+
+    // A drop-in replacement for GaussianBlurEffect, which blurs a downscaled copy of its source.
+    class FastGaussianBlurEffect : public RuntimeClass<
+        IFastGaussianBlurEffect,
+        MixIn<FastGaussianBlurEffect, CanvasEffect>>,
+        public CanvasEffect
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Effects_FastGaussianBlurEffect, BaseTrust);
+
+    public:
+        FastGaussianBlurEffect(ICanvasDevice* device = nullptr, ID2D1Effect* effect = nullptr);
+
+        static IID const& EffectId();
+
+        EFFECT_PROPERTY(BlurAmount, float);
+        EFFECT_PROPERTY(Optimization, EffectOptimization);
+        EFFECT_PROPERTY(BorderMode, EffectBorderMode);
+        EFFECT_PROPERTY(Quality, float);
+        EFFECT_PROPERTY(Source, IGraphicsEffectSource*);
+
+        EFFECT_PROPERTY_MAPPING();
+
+    protected:
+        virtual bool Realize(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext) override;
+    };
+}}}}}
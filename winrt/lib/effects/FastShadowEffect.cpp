@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "FastShadowEffect.h"
+#include "DownsampledBlurEffectImpl.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(FastShadowEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(FAST_SHADOW_PROP_BLUR_STANDARD_DEVIATION, 3.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(FAST_SHADOW_PROP_COLOR, 4, 0, 0, 0, 1),
+        EFFECT_PROPERTY_DEFAULT_UINT32(FAST_SHADOW_PROP_OPTIMIZATION, D2D1_SHADOW_OPTIMIZATION_BALANCED),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(FAST_SHADOW_PROP_QUALITY, 0.5f))
+
+    FastShadowEffect::FastShadowEffect(ICanvasDevice* device, ID2D1Effect* effect)
+        : CanvasEffect(EffectId(), FastShadowEffectPropertyDefaults, 1, true, device, effect, static_cast<IFastShadowEffect*>(this))
+    {
+    }
+
+    IID const& FastShadowEffect::EffectId()
+    {
+        return CLSID_FastShadowEffect;
+    }
+
+    bool FastShadowEffect::Realize(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext)
+    {
+        // Before trying to instantiate our custom effect type, we must register it with the D2D factory.
+        ComPtr<ID2D1Factory> factory;
+        As<ICanvasDeviceInternal>(RealizationDevice())->GetD2DDevice()->GetFactory(&factory);
+
+        DownsampledBlurEffectImpl::Register(As<ID2D1Factory1>(factory).Get());
+
+        return CanvasEffect::Realize(flags, targetDpi, deviceContext);
+    }
+
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(FastShadowEffect,
+        BlurAmount,
+        float,
+        float,
+        FAST_SHADOW_PROP_BLUR_STANDARD_DEVIATION,
+        0.0f,
+        250.0f)
+
+    IMPLEMENT_EFFECT_PROPERTY(FastShadowEffect,
+        ShadowColor,
+        float[4],
+        Color,
+        FAST_SHADOW_PROP_COLOR)
+
+    IMPLEMENT_EFFECT_PROPERTY(FastShadowEffect,
+        Optimization,
+        uint32_t,
+        EffectOptimization,
+        FAST_SHADOW_PROP_OPTIMIZATION)
+
+    IMPLEMENT_EFFECT_PROPERTY(FastShadowEffect,
+        ShadowColorHdr,
+        float[4],
+        Numerics::Vector4,
+        FAST_SHADOW_PROP_COLOR)
+
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(FastShadowEffect,
+        Quality,
+        float,
+        float,
+        FAST_SHADOW_PROP_QUALITY,
+        0.0f,
+        1.0f)
+
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(FastShadowEffect,
+        Source,
+        0)
+
+    IMPLEMENT_EFFECT_PROPERTY_MAPPING(FastShadowEffect,
+        { L"BlurAmount",     FAST_SHADOW_PROP_BLUR_STANDARD_DEVIATION, GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT           },
+        { L"ShadowColor",    FAST_SHADOW_PROP_COLOR,                   GRAPHICS_EFFECT_PROPERTY_MAPPING_COLOR_TO_VECTOR4 },
+        { L"Optimization",   FAST_SHADOW_PROP_OPTIMIZATION,            GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT           },
+        { L"ShadowColorHdr", FAST_SHADOW_PROP_COLOR,                   GRAPHICS_EFFECT_PROPERTY_MAPPING_UNKNOWN          },
+        { L"Quality",        FAST_SHADOW_PROP_QUALITY,                 GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT           })
+
+    ActivatableClassWithFactory(FastShadowEffect, ::SimpleAgileActivationFactory<FastShadowEffect>);
+}}}}}
@@ -16,11 +16,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         if (!SharedDeviceState::GetInstance()->IsID2D1Factory5Supported())
             ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);
-
-        if (!effect)
-        {
-            // Set default values
-        }
     }
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(AlphaMaskEffect,
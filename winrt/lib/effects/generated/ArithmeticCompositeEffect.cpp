@@ -9,15 +9,13 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ArithmeticCompositeEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_ARITHMETICCOMPOSITE_PROP_COEFFICIENTS, 4, 1.0f, 0.0f, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_ARITHMETICCOMPOSITE_PROP_CLAMP_OUTPUT, false))
+
     ArithmeticCompositeEffect::ArithmeticCompositeEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 2, true, device, effect, static_cast<IArithmeticCompositeEffect*>(this))
+        : CanvasEffect(EffectId(), ArithmeticCompositeEffectPropertyDefaults, 2, true, device, effect, static_cast<IArithmeticCompositeEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_ARITHMETICCOMPOSITE_PROP_COEFFICIENTS, Numerics::Vector4{ 1.0f, 0.0f, 0.0f, 0.0f });
-            SetBoxedProperty<boolean>(D2D1_ARITHMETICCOMPOSITE_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(ArithmeticCompositeEffect,
@@ -9,15 +9,13 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(AtlasEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_ATLAS_PROP_INPUT_RECT, 4, 0, 0, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_ATLAS_PROP_INPUT_PADDING_RECT, 4, 0, 0, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()))
+
     AtlasEffect::AtlasEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<IAtlasEffect*>(this))
+        : CanvasEffect(EffectId(), AtlasEffectPropertyDefaults, 1, true, device, effect, static_cast<IAtlasEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_ATLAS_PROP_INPUT_RECT, Rect{ 0, 0, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() });
-            SetBoxedProperty<float[4]>(D2D1_ATLAS_PROP_INPUT_PADDING_RECT, Rect{ 0, 0, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() });
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(AtlasEffect,
@@ -9,14 +9,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(BlendEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_BLEND_PROP_MODE, D2D1_BLEND_MODE_MULTIPLY))
+
     BlendEffect::BlendEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 2, true, device, effect, static_cast<IBlendEffect*>(this))
+        : CanvasEffect(EffectId(), BlendEffectPropertyDefaults, 2, true, device, effect, static_cast<IBlendEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_BLEND_PROP_MODE, D2D1_BLEND_MODE_MULTIPLY);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(BlendEffect,
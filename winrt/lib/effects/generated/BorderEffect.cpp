@@ -9,15 +9,13 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(BorderEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_BORDER_PROP_EDGE_MODE_X, D2D1_BORDER_EDGE_MODE_CLAMP),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_BORDER_PROP_EDGE_MODE_Y, D2D1_BORDER_EDGE_MODE_CLAMP))
+
     BorderEffect::BorderEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<IBorderEffect*>(this))
+        : CanvasEffect(EffectId(), BorderEffectPropertyDefaults, 1, true, device, effect, static_cast<IBorderEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_BORDER_PROP_EDGE_MODE_X, D2D1_BORDER_EDGE_MODE_CLAMP);
-            SetBoxedProperty<uint32_t>(D2D1_BORDER_PROP_EDGE_MODE_Y, D2D1_BORDER_EDGE_MODE_CLAMP);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(BorderEffect,
@@ -9,30 +9,30 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(BrightnessEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_BRIGHTNESS_PROP_WHITE_POINT, 2, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_BRIGHTNESS_PROP_BLACK_POINT, 2, 0.0f, 0.0f))
+
     BrightnessEffect::BrightnessEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<IBrightnessEffect*>(this))
+        : CanvasEffect(EffectId(), BrightnessEffectPropertyDefaults, 1, true, device, effect, static_cast<IBrightnessEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[2]>(D2D1_BRIGHTNESS_PROP_WHITE_POINT, Numerics::Vector2{ 1.0f, 1.0f });
-            SetBoxedProperty<float[2]>(D2D1_BRIGHTNESS_PROP_BLACK_POINT, Numerics::Vector2{ 0.0f, 0.0f });
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(BrightnessEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(BrightnessEffect,
         WhitePoint,
         float[2],
         Numerics::Vector2,
         D2D1_BRIGHTNESS_PROP_WHITE_POINT,
-        (value.X >= 0.0f) && (value.Y >= 0.0f) && (value.X <= 1.0f) && (value.Y <= 1.0f))
+        Numerics::Vector2{ 0.0f, 0.0f },
+        Numerics::Vector2{ 1.0f, 1.0f })
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(BrightnessEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(BrightnessEffect,
         BlackPoint,
         float[2],
         Numerics::Vector2,
         D2D1_BRIGHTNESS_PROP_BLACK_POINT,
-        (value.X >= 0.0f) && (value.Y >= 0.0f) && (value.X <= 1.0f) && (value.Y <= 1.0f))
+        Numerics::Vector2{ 0.0f, 0.0f },
+        Numerics::Vector2{ 1.0f, 1.0f })
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(BrightnessEffect,
         Source,
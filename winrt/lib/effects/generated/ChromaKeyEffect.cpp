@@ -11,17 +11,15 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ChromaKeyEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_CHROMAKEY_PROP_COLOR, 3, 0, 0, 0),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_CHROMAKEY_PROP_TOLERANCE, 0.1f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_CHROMAKEY_PROP_INVERT_ALPHA, false),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_CHROMAKEY_PROP_FEATHER, false))
+
     ChromaKeyEffect::ChromaKeyEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 4, 1, true, device, effect, static_cast<IChromaKeyEffect*>(this))
+        : CanvasEffect(EffectId(), ChromaKeyEffectPropertyDefaults, 1, true, device, effect, static_cast<IChromaKeyEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[3]>(D2D1_CHROMAKEY_PROP_COLOR, Color{ 255, 0, 0, 0 });
-            SetBoxedProperty<float>(D2D1_CHROMAKEY_PROP_TOLERANCE, 0.1f);
-            SetBoxedProperty<boolean>(D2D1_CHROMAKEY_PROP_INVERT_ALPHA, static_cast<boolean>(false));
-            SetBoxedProperty<boolean>(D2D1_CHROMAKEY_PROP_FEATHER, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(ChromaKeyEffect,
@@ -30,12 +28,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Color,
         D2D1_CHROMAKEY_PROP_COLOR)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ChromaKeyEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ChromaKeyEffect,
         Tolerance,
         float,
         float,
         D2D1_CHROMAKEY_PROP_TOLERANCE,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(ChromaKeyEffect,
         InvertAlpha,
@@ -9,19 +9,17 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ColorManagementEffect,
+        EFFECT_PROPERTY_DEFAULT_INTERFACE(D2D1_COLORMANAGEMENT_PROP_SOURCE_COLOR_CONTEXT),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_COLORMANAGEMENT_PROP_SOURCE_RENDERING_INTENT, D2D1_COLORMANAGEMENT_RENDERING_INTENT_PERCEPTUAL),
+        EFFECT_PROPERTY_DEFAULT_INTERFACE(D2D1_COLORMANAGEMENT_PROP_DESTINATION_COLOR_CONTEXT),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_COLORMANAGEMENT_PROP_DESTINATION_RENDERING_INTENT, D2D1_COLORMANAGEMENT_RENDERING_INTENT_PERCEPTUAL),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_COLORMANAGEMENT_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_COLORMANAGEMENT_PROP_QUALITY, D2D1_COLORMANAGEMENT_QUALITY_NORMAL))
+
     ColorManagementEffect::ColorManagementEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 6, 1, true, device, effect, static_cast<IColorManagementEffect*>(this))
+        : CanvasEffect(EffectId(), ColorManagementEffectPropertyDefaults, 1, true, device, effect, static_cast<IColorManagementEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<IColorManagementProfile*>(D2D1_COLORMANAGEMENT_PROP_SOURCE_COLOR_CONTEXT, static_cast<IColorManagementProfile*>(nullptr));
-            SetBoxedProperty<uint32_t>(D2D1_COLORMANAGEMENT_PROP_SOURCE_RENDERING_INTENT, D2D1_COLORMANAGEMENT_RENDERING_INTENT_PERCEPTUAL);
-            SetBoxedProperty<IColorManagementProfile*>(D2D1_COLORMANAGEMENT_PROP_DESTINATION_COLOR_CONTEXT, static_cast<IColorManagementProfile*>(nullptr));
-            SetBoxedProperty<uint32_t>(D2D1_COLORMANAGEMENT_PROP_DESTINATION_RENDERING_INTENT, D2D1_COLORMANAGEMENT_RENDERING_INTENT_PERCEPTUAL);
-            SetBoxedProperty<uint32_t>(D2D1_COLORMANAGEMENT_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED);
-            SetBoxedProperty<uint32_t>(D2D1_COLORMANAGEMENT_PROP_QUALITY, D2D1_COLORMANAGEMENT_QUALITY_NORMAL);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(ColorManagementEffect,
@@ -9,16 +9,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ColorMatrixEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, 20, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_COLORMATRIX_PROP_ALPHA_MODE, D2D1_COLORMATRIX_ALPHA_MODE_PREMULTIPLIED),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_COLORMATRIX_PROP_CLAMP_OUTPUT, false))
+
     ColorMatrixEffect::ColorMatrixEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IColorMatrixEffect*>(this))
+        : CanvasEffect(EffectId(), ColorMatrixEffectPropertyDefaults, 1, true, device, effect, static_cast<IColorMatrixEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[20]>(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, Matrix5x4{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0 });
-            SetBoxedProperty<uint32_t>(D2D1_COLORMATRIX_PROP_ALPHA_MODE, D2D1_COLORMATRIX_ALPHA_MODE_PREMULTIPLIED);
-            SetBoxedProperty<boolean>(D2D1_COLORMATRIX_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(ColorMatrixEffect,
@@ -9,14 +9,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ColorSourceEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_FLOOD_PROP_COLOR, 4, 0, 0, 0, 1))
+
     ColorSourceEffect::ColorSourceEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 0, true, device, effect, static_cast<IColorSourceEffect*>(this))
+        : CanvasEffect(EffectId(), ColorSourceEffectPropertyDefaults, 0, true, device, effect, static_cast<IColorSourceEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_FLOOD_PROP_COLOR, Color{ 255, 0, 0, 0 });
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(ColorSourceEffect,
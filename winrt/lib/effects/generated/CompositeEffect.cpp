@@ -9,14 +9,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(CompositeEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_COMPOSITE_PROP_MODE, D2D1_COMPOSITE_MODE_SOURCE_OVER))
+
     CompositeEffect::CompositeEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 0, false, device, effect, static_cast<ICompositeEffect*>(this))
+        : CanvasEffect(EffectId(), CompositeEffectPropertyDefaults, 0, false, device, effect, static_cast<ICompositeEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_COMPOSITE_PROP_MODE, D2D1_COMPOSITE_MODE_SOURCE_OVER);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(CompositeEffect,
@@ -11,23 +11,22 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ContrastEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_CONTRAST_PROP_CONTRAST, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_CONTRAST_PROP_CLAMP_INPUT, false))
+
     ContrastEffect::ContrastEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<IContrastEffect*>(this))
+        : CanvasEffect(EffectId(), ContrastEffectPropertyDefaults, 1, true, device, effect, static_cast<IContrastEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_CONTRAST_PROP_CONTRAST, 0.0f);
-            SetBoxedProperty<boolean>(D2D1_CONTRAST_PROP_CLAMP_INPUT, static_cast<boolean>(false));
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ContrastEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ContrastEffect,
         Contrast,
         float,
         float,
         D2D1_CONTRAST_PROP_CONTRAST,
-        (value >= -1.0f) && (value <= 1.0f))
+        -1.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(ContrastEffect,
         ClampSource,
@@ -9,32 +9,31 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ConvolveMatrixEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_CONVOLVEMATRIX_PROP_KERNEL_UNIT_LENGTH, 2, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_CONVOLVEMATRIX_PROP_SCALE_MODE, D2D1_CONVOLVEMATRIX_SCALE_MODE_LINEAR),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_CONVOLVEMATRIX_PROP_KERNEL_SIZE_X, 3),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_CONVOLVEMATRIX_PROP_KERNEL_SIZE_Y, 3),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_CONVOLVEMATRIX_PROP_KERNEL_MATRIX, 9, 0, 0, 0, 0, 1, 0, 0, 0, 0),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_CONVOLVEMATRIX_PROP_DIVISOR, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_CONVOLVEMATRIX_PROP_BIAS, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_CONVOLVEMATRIX_PROP_KERNEL_OFFSET, 2, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_CONVOLVEMATRIX_PROP_PRESERVE_ALPHA, false),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_CONVOLVEMATRIX_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_CONVOLVEMATRIX_PROP_CLAMP_OUTPUT, false))
+
     ConvolveMatrixEffect::ConvolveMatrixEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 11, 1, true, device, effect, static_cast<IConvolveMatrixEffect*>(this))
+        : CanvasEffect(EffectId(), ConvolveMatrixEffectPropertyDefaults, 1, true, device, effect, static_cast<IConvolveMatrixEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[2]>(D2D1_CONVOLVEMATRIX_PROP_KERNEL_UNIT_LENGTH, Numerics::Vector2{ 1.0f, 1.0f });
-            SetBoxedProperty<uint32_t>(D2D1_CONVOLVEMATRIX_PROP_SCALE_MODE, D2D1_CONVOLVEMATRIX_SCALE_MODE_LINEAR);
-            SetBoxedProperty<int32_t>(D2D1_CONVOLVEMATRIX_PROP_KERNEL_SIZE_X, 3);
-            SetBoxedProperty<int32_t>(D2D1_CONVOLVEMATRIX_PROP_KERNEL_SIZE_Y, 3);
-            SetArrayProperty<float>(D2D1_CONVOLVEMATRIX_PROP_KERNEL_MATRIX, { 0, 0, 0, 0, 1, 0, 0, 0, 0 });
-            SetBoxedProperty<float>(D2D1_CONVOLVEMATRIX_PROP_DIVISOR, 1.0f);
-            SetBoxedProperty<float>(D2D1_CONVOLVEMATRIX_PROP_BIAS, 0.0f);
-            SetBoxedProperty<float[2]>(D2D1_CONVOLVEMATRIX_PROP_KERNEL_OFFSET, Numerics::Vector2{ 0.0f, 0.0f });
-            SetBoxedProperty<boolean>(D2D1_CONVOLVEMATRIX_PROP_PRESERVE_ALPHA, static_cast<boolean>(false));
-            SetBoxedProperty<uint32_t>(D2D1_CONVOLVEMATRIX_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-            SetBoxedProperty<boolean>(D2D1_CONVOLVEMATRIX_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ConvolveMatrixEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ConvolveMatrixEffect,
         KernelScale,
         float[2],
         Numerics::Vector2,
         D2D1_CONVOLVEMATRIX_PROP_KERNEL_UNIT_LENGTH,
-        (value.X >= 0.01f) && (value.Y >= 0.01f) && (value.X <= 100.0f) && (value.Y <= 100.0f))
+        Numerics::Vector2{ 0.01f, 0.01f },
+        Numerics::Vector2{ 100.0f, 100.0f })
 
     IMPLEMENT_EFFECT_PROPERTY(ConvolveMatrixEffect,
         InterpolationMode,
@@ -42,19 +41,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         CanvasImageInterpolation,
         D2D1_CONVOLVEMATRIX_PROP_SCALE_MODE)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ConvolveMatrixEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ConvolveMatrixEffect,
         KernelWidth,
         int32_t,
         int32_t,
         D2D1_CONVOLVEMATRIX_PROP_KERNEL_SIZE_X,
-        (value >= 1) && (value <= 100))
+        1,
+        100)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ConvolveMatrixEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ConvolveMatrixEffect,
         KernelHeight,
         int32_t,
         int32_t,
         D2D1_CONVOLVEMATRIX_PROP_KERNEL_SIZE_Y,
-        (value >= 1) && (value <= 100))
+        1,
+        100)
 
     IMPLEMENT_EFFECT_ARRAY_PROPERTY(ConvolveMatrixEffect,
         KernelMatrix,
@@ -73,12 +74,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         float,
         D2D1_CONVOLVEMATRIX_PROP_BIAS)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ConvolveMatrixEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ConvolveMatrixEffect,
         KernelOffset,
         float[2],
         Numerics::Vector2,
         D2D1_CONVOLVEMATRIX_PROP_KERNEL_OFFSET,
-        (value.X >= -50.0f) && (value.Y >= -50.0f) && (value.X <= 50.0f) && (value.Y <= 50.0f))
+        Numerics::Vector2{ -50.0f, -50.0f },
+        Numerics::Vector2{ 50.0f, 50.0f })
 
     IMPLEMENT_EFFECT_PROPERTY(ConvolveMatrixEffect,
         PreserveAlpha,
@@ -9,15 +9,13 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(CropEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_CROP_PROP_RECT, 4, -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_CROP_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT))
+
     CropEffect::CropEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<ICropEffect*>(this))
+        : CanvasEffect(EffectId(), CropEffectPropertyDefaults, 1, true, device, effect, static_cast<ICropEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_CROP_PROP_RECT, Rect{ -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() });
-            SetBoxedProperty<uint32_t>(D2D1_CROP_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(CropEffect,
@@ -11,25 +11,23 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(CrossFadeEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_CROSSFADE_PROP_WEIGHT, 0.5f))
+
     CrossFadeEffect::CrossFadeEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 2, true, device, effect, static_cast<ICrossFadeEffect*>(this))
+        : CanvasEffect(EffectId(), CrossFadeEffectPropertyDefaults, 2, true, device, effect, static_cast<ICrossFadeEffect*>(this))
     {
         if (!SharedDeviceState::GetInstance()->IsID2D1Factory5Supported())
             ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);
-
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_CROSSFADE_PROP_WEIGHT, 0.5f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(CrossFadeEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(CrossFadeEffect,
         CrossFade,
         float,
         float,
         D2D1_CROSSFADE_PROP_WEIGHT,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(CrossFadeEffect,
         Source2,
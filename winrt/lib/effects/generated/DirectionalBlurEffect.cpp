@@ -9,25 +9,24 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(DirectionalBlurEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DIRECTIONALBLUR_PROP_STANDARD_DEVIATION, 3.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DIRECTIONALBLUR_PROP_ANGLE, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DIRECTIONALBLUR_PROP_OPTIMIZATION, D2D1_DIRECTIONALBLUR_OPTIMIZATION_BALANCED),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DIRECTIONALBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT))
+
     DirectionalBlurEffect::DirectionalBlurEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 4, 1, true, device, effect, static_cast<IDirectionalBlurEffect*>(this))
+        : CanvasEffect(EffectId(), DirectionalBlurEffectPropertyDefaults, 1, true, device, effect, static_cast<IDirectionalBlurEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_DIRECTIONALBLUR_PROP_STANDARD_DEVIATION, 3.0f);
-            SetBoxedProperty<float>(D2D1_DIRECTIONALBLUR_PROP_ANGLE, 0.0f);
-            SetBoxedProperty<uint32_t>(D2D1_DIRECTIONALBLUR_PROP_OPTIMIZATION, D2D1_DIRECTIONALBLUR_OPTIMIZATION_BALANCED);
-            SetBoxedProperty<uint32_t>(D2D1_DIRECTIONALBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(DirectionalBlurEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(DirectionalBlurEffect,
         BlurAmount,
         float,
         float,
         D2D1_DIRECTIONALBLUR_PROP_STANDARD_DEVIATION,
-        (value >= 0.0f) && (value <= 250.0f))
+        0.0f,
+        250.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(DirectionalBlurEffect,
         Angle,
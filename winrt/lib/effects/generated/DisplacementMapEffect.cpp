@@ -9,16 +9,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(DisplacementMapEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DISPLACEMENTMAP_PROP_SCALE, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DISPLACEMENTMAP_PROP_X_CHANNEL_SELECT, EffectChannelSelect::Alpha),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DISPLACEMENTMAP_PROP_Y_CHANNEL_SELECT, EffectChannelSelect::Alpha))
+
     DisplacementMapEffect::DisplacementMapEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 2, true, device, effect, static_cast<IDisplacementMapEffect*>(this))
+        : CanvasEffect(EffectId(), DisplacementMapEffectPropertyDefaults, 2, true, device, effect, static_cast<IDisplacementMapEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_DISPLACEMENTMAP_PROP_SCALE, 0.0f);
-            SetBoxedProperty<uint32_t>(D2D1_DISPLACEMENTMAP_PROP_X_CHANNEL_SELECT, EffectChannelSelect::Alpha);
-            SetBoxedProperty<uint32_t>(D2D1_DISPLACEMENTMAP_PROP_Y_CHANNEL_SELECT, EffectChannelSelect::Alpha);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(DisplacementMapEffect,
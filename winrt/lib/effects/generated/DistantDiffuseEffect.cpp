@@ -9,20 +9,18 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(DistantDiffuseEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DISTANTDIFFUSE_PROP_AZIMUTH, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DISTANTDIFFUSE_PROP_ELEVATION, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DISTANTDIFFUSE_PROP_DIFFUSE_CONSTANT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_DISTANTDIFFUSE_PROP_SURFACE_SCALE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_DISTANTDIFFUSE_PROP_COLOR, 3, 1.0f, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_DISTANTDIFFUSE_PROP_KERNEL_UNIT_LENGTH, 2, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DISTANTDIFFUSE_PROP_SCALE_MODE, D2D1_DISTANTDIFFUSE_SCALE_MODE_LINEAR))
+
     DistantDiffuseEffect::DistantDiffuseEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 7, 1, true, device, effect, static_cast<IDistantDiffuseEffect*>(this))
+        : CanvasEffect(EffectId(), DistantDiffuseEffectPropertyDefaults, 1, true, device, effect, static_cast<IDistantDiffuseEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_DISTANTDIFFUSE_PROP_AZIMUTH, 0.0f);
-            SetBoxedProperty<float>(D2D1_DISTANTDIFFUSE_PROP_ELEVATION, 0.0f);
-            SetBoxedProperty<float>(D2D1_DISTANTDIFFUSE_PROP_DIFFUSE_CONSTANT, 1.0f);
-            SetBoxedProperty<float>(D2D1_DISTANTDIFFUSE_PROP_SURFACE_SCALE, 1.0f);
-            SetBoxedProperty<float[3]>(D2D1_DISTANTDIFFUSE_PROP_COLOR, Color{ 255, 255, 255, 255 });
-            SetBoxedProperty<float[2]>(D2D1_DISTANTDIFFUSE_PROP_KERNEL_UNIT_LENGTH, Numerics::Vector2{ 1.0f, 1.0f });
-            SetBoxedProperty<uint32_t>(D2D1_DISTANTDIFFUSE_PROP_SCALE_MODE, D2D1_DISTANTDIFFUSE_SCALE_MODE_LINEAR);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(DistantDiffuseEffect,
@@ -37,19 +35,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         float,
         D2D1_DISTANTDIFFUSE_PROP_ELEVATION)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(DistantDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(DistantDiffuseEffect,
         DiffuseAmount,
         float,
         float,
         D2D1_DISTANTDIFFUSE_PROP_DIFFUSE_CONSTANT,
-        (value >= 0.0f) && (value <= 10000.0f))
+        0.0f,
+        10000.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(DistantDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(DistantDiffuseEffect,
         HeightMapScale,
         float,
         float,
         D2D1_DISTANTDIFFUSE_PROP_SURFACE_SCALE,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(DistantDiffuseEffect,
         LightColor,
@@ -57,12 +57,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Color,
         D2D1_DISTANTDIFFUSE_PROP_COLOR)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(DistantDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(DistantDiffuseEffect,
         HeightMapKernelSize,
         float[2],
         Numerics::Vector2,
         D2D1_DISTANTDIFFUSE_PROP_KERNEL_UNIT_LENGTH,
-        (value.X >= 0.01f) && (value.Y >= 0.01f) && (value.X <= 100.0f) && (value.Y <= 100.0f))
+        Numerics::Vector2{ 0.01f, 0.01f },
+        Numerics::Vector2{ 100.0f, 100.0f })
 
     IMPLEMENT_EFFECT_PROPERTY(DistantDiffuseEffect,
         HeightMapInterpolationMode,
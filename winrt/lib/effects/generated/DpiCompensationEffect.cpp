@@ -9,16 +9,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(DpiCompensationEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DPICOMPENSATION_PROP_INTERPOLATION_MODE, D2D1_DPICOMPENSATION_INTERPOLATION_MODE_LINEAR),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_DPICOMPENSATION_PROP_BORDER_MODE, D2D1_BORDER_MODE_HARD),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_DPICOMPENSATION_PROP_INPUT_DPI, 2, 96, 96))
+
     DpiCompensationEffect::DpiCompensationEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IDpiCompensationEffect*>(this))
+        : CanvasEffect(EffectId(), DpiCompensationEffectPropertyDefaults, 1, true, device, effect, static_cast<IDpiCompensationEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_DPICOMPENSATION_PROP_INTERPOLATION_MODE, D2D1_DPICOMPENSATION_INTERPOLATION_MODE_LINEAR);
-            SetBoxedProperty<uint32_t>(D2D1_DPICOMPENSATION_PROP_BORDER_MODE, D2D1_BORDER_MODE_HARD);
-            SetBoxedProperty<float[2]>(D2D1_DPICOMPENSATION_PROP_INPUT_DPI, Numerics::Vector2{ 96, 96 });
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(DpiCompensationEffect,
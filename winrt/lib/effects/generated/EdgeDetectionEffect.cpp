@@ -11,33 +11,33 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(EdgeDetectionEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_EDGEDETECTION_PROP_STRENGTH, 0.5f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_EDGEDETECTION_PROP_BLUR_RADIUS, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_EDGEDETECTION_PROP_MODE, EdgeDetectionEffectMode::Sobel),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_EDGEDETECTION_PROP_OVERLAY_EDGES, false),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_EDGEDETECTION_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED))
+
     EdgeDetectionEffect::EdgeDetectionEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 5, 1, true, device, effect, static_cast<IEdgeDetectionEffect*>(this))
+        : CanvasEffect(EffectId(), EdgeDetectionEffectPropertyDefaults, 1, true, device, effect, static_cast<IEdgeDetectionEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_EDGEDETECTION_PROP_STRENGTH, 0.5f);
-            SetBoxedProperty<float>(D2D1_EDGEDETECTION_PROP_BLUR_RADIUS, 0.0f);
-            SetBoxedProperty<uint32_t>(D2D1_EDGEDETECTION_PROP_MODE, EdgeDetectionEffectMode::Sobel);
-            SetBoxedProperty<boolean>(D2D1_EDGEDETECTION_PROP_OVERLAY_EDGES, static_cast<boolean>(false));
-            SetBoxedProperty<uint32_t>(D2D1_EDGEDETECTION_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(EdgeDetectionEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(EdgeDetectionEffect,
         Amount,
         float,
         float,
         D2D1_EDGEDETECTION_PROP_STRENGTH,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(EdgeDetectionEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(EdgeDetectionEffect,
         BlurAmount,
         float,
         float,
         D2D1_EDGEDETECTION_PROP_BLUR_RADIUS,
-        (value >= 0.0f) && (value <= 10.0f))
+        0.0f,
+        10.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(EdgeDetectionEffect,
         Mode,
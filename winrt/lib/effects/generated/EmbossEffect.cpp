@@ -11,23 +11,22 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(EmbossEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_EMBOSS_PROP_HEIGHT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_EMBOSS_PROP_DIRECTION, 0.0f))
+
     EmbossEffect::EmbossEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<IEmbossEffect*>(this))
+        : CanvasEffect(EffectId(), EmbossEffectPropertyDefaults, 1, true, device, effect, static_cast<IEmbossEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_EMBOSS_PROP_HEIGHT, 1.0f);
-            SetBoxedProperty<float>(D2D1_EMBOSS_PROP_DIRECTION, 0.0f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(EmbossEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(EmbossEffect,
         Amount,
         float,
         float,
         D2D1_EMBOSS_PROP_HEIGHT,
-        (value >= 0.0f) && (value <= 10.0f))
+        0.0f,
+        10.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(EmbossEffect,
         Angle,
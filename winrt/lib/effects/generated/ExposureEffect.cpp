@@ -11,22 +11,21 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ExposureEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_EXPOSURE_PROP_EXPOSURE_VALUE, 0.0f))
+
     ExposureEffect::ExposureEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<IExposureEffect*>(this))
+        : CanvasEffect(EffectId(), ExposureEffectPropertyDefaults, 1, true, device, effect, static_cast<IExposureEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_EXPOSURE_PROP_EXPOSURE_VALUE, 0.0f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ExposureEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ExposureEffect,
         Exposure,
         float,
         float,
         D2D1_EXPOSURE_PROP_EXPOSURE_VALUE,
-        (value >= -2.0f) && (value <= 2.0f))
+        -2.0f,
+        2.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(ExposureEffect,
         Source,
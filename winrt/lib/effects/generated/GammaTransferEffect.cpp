@@ -9,30 +9,28 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(GammaTransferEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_RED_AMPLITUDE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_RED_EXPONENT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_RED_OFFSET, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_GAMMATRANSFER_PROP_RED_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_GREEN_AMPLITUDE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_GREEN_EXPONENT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_GREEN_OFFSET, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_GAMMATRANSFER_PROP_GREEN_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_BLUE_AMPLITUDE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_BLUE_EXPONENT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_BLUE_OFFSET, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_GAMMATRANSFER_PROP_BLUE_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_ALPHA_AMPLITUDE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_ALPHA_EXPONENT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAMMATRANSFER_PROP_ALPHA_OFFSET, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_GAMMATRANSFER_PROP_ALPHA_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_GAMMATRANSFER_PROP_CLAMP_OUTPUT, false))
+
     GammaTransferEffect::GammaTransferEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 17, 1, true, device, effect, static_cast<IGammaTransferEffect*>(this))
+        : CanvasEffect(EffectId(), GammaTransferEffectPropertyDefaults, 1, true, device, effect, static_cast<IGammaTransferEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_RED_AMPLITUDE, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_RED_EXPONENT, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_RED_OFFSET, 0.0f);
-            SetBoxedProperty<boolean>(D2D1_GAMMATRANSFER_PROP_RED_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_GREEN_AMPLITUDE, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_GREEN_EXPONENT, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_GREEN_OFFSET, 0.0f);
-            SetBoxedProperty<boolean>(D2D1_GAMMATRANSFER_PROP_GREEN_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_BLUE_AMPLITUDE, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_BLUE_EXPONENT, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_BLUE_OFFSET, 0.0f);
-            SetBoxedProperty<boolean>(D2D1_GAMMATRANSFER_PROP_BLUE_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_ALPHA_AMPLITUDE, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_ALPHA_EXPONENT, 1.0f);
-            SetBoxedProperty<float>(D2D1_GAMMATRANSFER_PROP_ALPHA_OFFSET, 0.0f);
-            SetBoxedProperty<boolean>(D2D1_GAMMATRANSFER_PROP_ALPHA_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<boolean>(D2D1_GAMMATRANSFER_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(GammaTransferEffect,
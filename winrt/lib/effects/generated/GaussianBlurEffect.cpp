@@ -9,24 +9,23 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(GaussianBlurEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, 3.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_GAUSSIANBLUR_PROP_OPTIMIZATION, D2D1_GAUSSIANBLUR_OPTIMIZATION_BALANCED),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT))
+
     GaussianBlurEffect::GaussianBlurEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IGaussianBlurEffect*>(this))
+        : CanvasEffect(EffectId(), GaussianBlurEffectPropertyDefaults, 1, true, device, effect, static_cast<IGaussianBlurEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, 3.0f);
-            SetBoxedProperty<uint32_t>(D2D1_GAUSSIANBLUR_PROP_OPTIMIZATION, D2D1_GAUSSIANBLUR_OPTIMIZATION_BALANCED);
-            SetBoxedProperty<uint32_t>(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(GaussianBlurEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(GaussianBlurEffect,
         BlurAmount,
         float,
         float,
         D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION,
-        (value >= 0.0f) && (value <= 250.0f))
+        0.0f,
+        250.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(GaussianBlurEffect,
         Optimization,
@@ -14,10 +14,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     GrayscaleEffect::GrayscaleEffect(ICanvasDevice* device, ID2D1Effect* effect)
         : CanvasEffect(EffectId(), 0, 1, true, device, effect, static_cast<IGrayscaleEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-        }
     }
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(GrayscaleEffect,
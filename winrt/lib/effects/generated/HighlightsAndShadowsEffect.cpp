@@ -11,47 +11,49 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(HighlightsAndShadowsEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_HIGHLIGHTSANDSHADOWS_PROP_HIGHLIGHTS, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_HIGHLIGHTSANDSHADOWS_PROP_SHADOWS, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_HIGHLIGHTSANDSHADOWS_PROP_CLARITY, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_HIGHLIGHTSANDSHADOWS_PROP_INPUT_GAMMA, D2D1_HIGHLIGHTSANDSHADOWS_INPUT_GAMMA_SRGB),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_HIGHLIGHTSANDSHADOWS_PROP_MASK_BLUR_RADIUS, 1.25f))
+
     HighlightsAndShadowsEffect::HighlightsAndShadowsEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 5, 1, true, device, effect, static_cast<IHighlightsAndShadowsEffect*>(this))
+        : CanvasEffect(EffectId(), HighlightsAndShadowsEffectPropertyDefaults, 1, true, device, effect, static_cast<IHighlightsAndShadowsEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_HIGHLIGHTSANDSHADOWS_PROP_HIGHLIGHTS, 0.0f);
-            SetBoxedProperty<float>(D2D1_HIGHLIGHTSANDSHADOWS_PROP_SHADOWS, 0.0f);
-            SetBoxedProperty<float>(D2D1_HIGHLIGHTSANDSHADOWS_PROP_CLARITY, 0.0f);
-            SetBoxedProperty<uint32_t>(D2D1_HIGHLIGHTSANDSHADOWS_PROP_INPUT_GAMMA, D2D1_HIGHLIGHTSANDSHADOWS_INPUT_GAMMA_SRGB);
-            SetBoxedProperty<float>(D2D1_HIGHLIGHTSANDSHADOWS_PROP_MASK_BLUR_RADIUS, 1.25f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(HighlightsAndShadowsEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(HighlightsAndShadowsEffect,
         Highlights,
         float,
         float,
         D2D1_HIGHLIGHTSANDSHADOWS_PROP_HIGHLIGHTS,
-        (value >= -1.0f) && (value <= 1.0f))
+        -1.0f,
+        1.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(HighlightsAndShadowsEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(HighlightsAndShadowsEffect,
         Shadows,
         float,
         float,
         D2D1_HIGHLIGHTSANDSHADOWS_PROP_SHADOWS,
-        (value >= -1.0f) && (value <= 1.0f))
+        -1.0f,
+        1.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(HighlightsAndShadowsEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(HighlightsAndShadowsEffect,
         Clarity,
         float,
         float,
         D2D1_HIGHLIGHTSANDSHADOWS_PROP_CLARITY,
-        (value >= -1.0f) && (value <= 1.0f))
+        -1.0f,
+        1.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(HighlightsAndShadowsEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(HighlightsAndShadowsEffect,
         MaskBlurAmount,
         float,
         float,
         D2D1_HIGHLIGHTSANDSHADOWS_PROP_MASK_BLUR_RADIUS,
-        (value >= 0.0f) && (value <= 10.0f))
+        0.0f,
+        10.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(HighlightsAndShadowsEffect,
         Source,
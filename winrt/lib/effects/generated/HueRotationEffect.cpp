@@ -9,14 +9,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(HueRotationEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_HUEROTATION_PROP_ANGLE, 0.0f))
+
     HueRotationEffect::HueRotationEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<IHueRotationEffect*>(this))
+        : CanvasEffect(EffectId(), HueRotationEffectPropertyDefaults, 1, true, device, effect, static_cast<IHueRotationEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_HUEROTATION_PROP_ANGLE, 0.0f);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(HueRotationEffect,
@@ -11,14 +11,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(HueToRgbEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_HUETORGB_PROP_INPUT_COLOR_SPACE, EffectHueColorSpace::Hsv))
+
     HueToRgbEffect::HueToRgbEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<IHueToRgbEffect*>(this))
+        : CanvasEffect(EffectId(), HueToRgbEffectPropertyDefaults, 1, true, device, effect, static_cast<IHueToRgbEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_HUETORGB_PROP_INPUT_COLOR_SPACE, EffectHueColorSpace::Hsv);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(HueToRgbEffect,
@@ -14,10 +14,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     InvertEffect::InvertEffect(ICanvasDevice* device, ID2D1Effect* effect)
         : CanvasEffect(EffectId(), 0, 1, true, device, effect, static_cast<IInvertEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-        }
     }
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(InvertEffect,
@@ -9,26 +9,24 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(LinearTransferEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_RED_Y_INTERCEPT, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_RED_SLOPE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_LINEARTRANSFER_PROP_RED_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_GREEN_Y_INTERCEPT, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_GREEN_SLOPE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_LINEARTRANSFER_PROP_GREEN_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_BLUE_Y_INTERCEPT, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_BLUE_SLOPE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_LINEARTRANSFER_PROP_BLUE_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_ALPHA_Y_INTERCEPT, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_LINEARTRANSFER_PROP_ALPHA_SLOPE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_LINEARTRANSFER_PROP_ALPHA_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_LINEARTRANSFER_PROP_CLAMP_OUTPUT, false))
+
     LinearTransferEffect::LinearTransferEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 13, 1, true, device, effect, static_cast<ILinearTransferEffect*>(this))
+        : CanvasEffect(EffectId(), LinearTransferEffectPropertyDefaults, 1, true, device, effect, static_cast<ILinearTransferEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_RED_Y_INTERCEPT, 0.0f);
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_RED_SLOPE, 1.0f);
-            SetBoxedProperty<boolean>(D2D1_LINEARTRANSFER_PROP_RED_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_GREEN_Y_INTERCEPT, 0.0f);
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_GREEN_SLOPE, 1.0f);
-            SetBoxedProperty<boolean>(D2D1_LINEARTRANSFER_PROP_GREEN_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_BLUE_Y_INTERCEPT, 0.0f);
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_BLUE_SLOPE, 1.0f);
-            SetBoxedProperty<boolean>(D2D1_LINEARTRANSFER_PROP_BLUE_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_ALPHA_Y_INTERCEPT, 0.0f);
-            SetBoxedProperty<float>(D2D1_LINEARTRANSFER_PROP_ALPHA_SLOPE, 1.0f);
-            SetBoxedProperty<boolean>(D2D1_LINEARTRANSFER_PROP_ALPHA_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<boolean>(D2D1_LINEARTRANSFER_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(LinearTransferEffect,
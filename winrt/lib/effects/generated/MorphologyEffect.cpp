@@ -9,16 +9,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(MorphologyEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_MORPHOLOGY_PROP_MODE, D2D1_MORPHOLOGY_MODE_ERODE),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_MORPHOLOGY_PROP_WIDTH, 1),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_MORPHOLOGY_PROP_HEIGHT, 1))
+
     MorphologyEffect::MorphologyEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IMorphologyEffect*>(this))
+        : CanvasEffect(EffectId(), MorphologyEffectPropertyDefaults, 1, true, device, effect, static_cast<IMorphologyEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_MORPHOLOGY_PROP_MODE, D2D1_MORPHOLOGY_MODE_ERODE);
-            SetBoxedProperty<int32_t>(D2D1_MORPHOLOGY_PROP_WIDTH, 1);
-            SetBoxedProperty<int32_t>(D2D1_MORPHOLOGY_PROP_HEIGHT, 1);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(MorphologyEffect,
@@ -27,19 +25,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         MorphologyEffectMode,
         D2D1_MORPHOLOGY_PROP_MODE)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(MorphologyEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(MorphologyEffect,
         Width,
         int32_t,
         int32_t,
         D2D1_MORPHOLOGY_PROP_WIDTH,
-        (value >= 1) && (value <= 100))
+        1,
+        100)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(MorphologyEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(MorphologyEffect,
         Height,
         int32_t,
         int32_t,
         D2D1_MORPHOLOGY_PROP_HEIGHT,
-        (value >= 1) && (value <= 100))
+        1,
+        100)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(MorphologyEffect,
         Source,
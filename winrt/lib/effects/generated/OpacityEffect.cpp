@@ -11,25 +11,23 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(OpacityEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_OPACITY_PROP_OPACITY, 1.0f))
+
     OpacityEffect::OpacityEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<IOpacityEffect*>(this))
+        : CanvasEffect(EffectId(), OpacityEffectPropertyDefaults, 1, true, device, effect, static_cast<IOpacityEffect*>(this))
     {
         if (!SharedDeviceState::GetInstance()->IsID2D1Factory5Supported())
             ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);
-
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_OPACITY_PROP_OPACITY, 1.0f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(OpacityEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(OpacityEffect,
         Opacity,
         float,
         float,
         D2D1_OPACITY_PROP_OPACITY,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(OpacityEffect,
         Source,
@@ -9,14 +9,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(OpacityMetadataEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_OPACITYMETADATA_PROP_INPUT_OPAQUE_RECT, 4, -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()))
+
     OpacityMetadataEffect::OpacityMetadataEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<IOpacityMetadataEffect*>(this))
+        : CanvasEffect(EffectId(), OpacityMetadataEffectPropertyDefaults, 1, true, device, effect, static_cast<IOpacityMetadataEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_OPACITYMETADATA_PROP_INPUT_OPAQUE_RECT, Rect{ -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() });
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(OpacityMetadataEffect,
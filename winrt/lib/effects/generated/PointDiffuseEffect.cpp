@@ -9,19 +9,17 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(PointDiffuseEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_POINTDIFFUSE_PROP_LIGHT_POSITION, 3, 0.0f, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_POINTDIFFUSE_PROP_DIFFUSE_CONSTANT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_POINTDIFFUSE_PROP_SURFACE_SCALE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_POINTDIFFUSE_PROP_COLOR, 3, 1.0f, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_POINTDIFFUSE_PROP_KERNEL_UNIT_LENGTH, 2, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_POINTDIFFUSE_PROP_SCALE_MODE, D2D1_POINTDIFFUSE_SCALE_MODE_LINEAR))
+
     PointDiffuseEffect::PointDiffuseEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 6, 1, true, device, effect, static_cast<IPointDiffuseEffect*>(this))
+        : CanvasEffect(EffectId(), PointDiffuseEffectPropertyDefaults, 1, true, device, effect, static_cast<IPointDiffuseEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[3]>(D2D1_POINTDIFFUSE_PROP_LIGHT_POSITION, Numerics::Vector3{ 0.0f, 0.0f, 0.0f });
-            SetBoxedProperty<float>(D2D1_POINTDIFFUSE_PROP_DIFFUSE_CONSTANT, 1.0f);
-            SetBoxedProperty<float>(D2D1_POINTDIFFUSE_PROP_SURFACE_SCALE, 1.0f);
-            SetBoxedProperty<float[3]>(D2D1_POINTDIFFUSE_PROP_COLOR, Color{ 255, 255, 255, 255 });
-            SetBoxedProperty<float[2]>(D2D1_POINTDIFFUSE_PROP_KERNEL_UNIT_LENGTH, Numerics::Vector2{ 1.0f, 1.0f });
-            SetBoxedProperty<uint32_t>(D2D1_POINTDIFFUSE_PROP_SCALE_MODE, D2D1_POINTDIFFUSE_SCALE_MODE_LINEAR);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(PointDiffuseEffect,
@@ -30,19 +28,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Numerics::Vector3,
         D2D1_POINTDIFFUSE_PROP_LIGHT_POSITION)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(PointDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(PointDiffuseEffect,
         DiffuseAmount,
         float,
         float,
         D2D1_POINTDIFFUSE_PROP_DIFFUSE_CONSTANT,
-        (value >= 0.0f) && (value <= 10000.0f))
+        0.0f,
+        10000.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(PointDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(PointDiffuseEffect,
         HeightMapScale,
         float,
         float,
         D2D1_POINTDIFFUSE_PROP_SURFACE_SCALE,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(PointDiffuseEffect,
         LightColor,
@@ -50,12 +50,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Color,
         D2D1_POINTDIFFUSE_PROP_COLOR)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(PointDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(PointDiffuseEffect,
         HeightMapKernelSize,
         float[2],
         Numerics::Vector2,
         D2D1_POINTDIFFUSE_PROP_KERNEL_UNIT_LENGTH,
-        (value.X >= 0.01f) && (value.Y >= 0.01f) && (value.X <= 100.0f) && (value.Y <= 100.0f))
+        Numerics::Vector2{ 0.01f, 0.01f },
+        Numerics::Vector2{ 100.0f, 100.0f })
 
     IMPLEMENT_EFFECT_PROPERTY(PointDiffuseEffect,
         HeightMapInterpolationMode,
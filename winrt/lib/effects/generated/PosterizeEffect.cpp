@@ -11,38 +11,39 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(PosterizeEffect,
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_POSTERIZE_PROP_RED_VALUE_COUNT, 4),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_POSTERIZE_PROP_GREEN_VALUE_COUNT, 4),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_POSTERIZE_PROP_BLUE_VALUE_COUNT, 4))
+
     PosterizeEffect::PosterizeEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IPosterizeEffect*>(this))
+        : CanvasEffect(EffectId(), PosterizeEffectPropertyDefaults, 1, true, device, effect, static_cast<IPosterizeEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<int32_t>(D2D1_POSTERIZE_PROP_RED_VALUE_COUNT, 4);
-            SetBoxedProperty<int32_t>(D2D1_POSTERIZE_PROP_GREEN_VALUE_COUNT, 4);
-            SetBoxedProperty<int32_t>(D2D1_POSTERIZE_PROP_BLUE_VALUE_COUNT, 4);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(PosterizeEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(PosterizeEffect,
         RedValueCount,
         int32_t,
         int32_t,
         D2D1_POSTERIZE_PROP_RED_VALUE_COUNT,
-        (value >= 2) && (value <= 16))
+        2,
+        16)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(PosterizeEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(PosterizeEffect,
         GreenValueCount,
         int32_t,
         int32_t,
         D2D1_POSTERIZE_PROP_GREEN_VALUE_COUNT,
-        (value >= 2) && (value <= 16))
+        2,
+        16)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(PosterizeEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(PosterizeEffect,
         BlueValueCount,
         int32_t,
         int32_t,
         D2D1_POSTERIZE_PROP_BLUE_VALUE_COUNT,
-        (value >= 2) && (value <= 16))
+        2,
+        16)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(PosterizeEffect,
         Source,
@@ -12,10 +12,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     PremultiplyEffect::PremultiplyEffect(ICanvasDevice* device, ID2D1Effect* effect)
         : CanvasEffect(EffectId(), 0, 1, true, device, effect, static_cast<IPremultiplyEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-        }
     }
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(PremultiplyEffect,
@@ -11,14 +11,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(RgbToHueEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_RGBTOHUE_PROP_OUTPUT_COLOR_SPACE, EffectHueColorSpace::Hsv))
+
     RgbToHueEffect::RgbToHueEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<IRgbToHueEffect*>(this))
+        : CanvasEffect(EffectId(), RgbToHueEffectPropertyDefaults, 1, true, device, effect, static_cast<IRgbToHueEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_RGBTOHUE_PROP_OUTPUT_COLOR_SPACE, EffectHueColorSpace::Hsv);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(RgbToHueEffect,
@@ -9,22 +9,21 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(SaturationEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SATURATION_PROP_SATURATION, 0.5f))
+
     SaturationEffect::SaturationEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<ISaturationEffect*>(this))
+        : CanvasEffect(EffectId(), SaturationEffectPropertyDefaults, 1, true, device, effect, static_cast<ISaturationEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_SATURATION_PROP_SATURATION, 0.5f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SaturationEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SaturationEffect,
         Saturation,
         float,
         float,
         D2D1_SATURATION_PROP_SATURATION,
-        (value >= 0.0f) && (value <= 2.0f))
+        0.0f,
+        2.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(SaturationEffect,
         Source,
@@ -9,26 +9,25 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ScaleEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SCALE_PROP_SCALE, 2, 1, 1),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SCALE_PROP_CENTER_POINT, 2, 0, 0),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_SCALE_PROP_INTERPOLATION_MODE, D2D1_CONVOLVEMATRIX_SCALE_MODE_LINEAR),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_SCALE_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SCALE_PROP_SHARPNESS, 0.0f))
+
     ScaleEffect::ScaleEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 5, 1, true, device, effect, static_cast<IScaleEffect*>(this))
+        : CanvasEffect(EffectId(), ScaleEffectPropertyDefaults, 1, true, device, effect, static_cast<IScaleEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[2]>(D2D1_SCALE_PROP_SCALE, Numerics::Vector2{ 1, 1 });
-            SetBoxedProperty<float[2]>(D2D1_SCALE_PROP_CENTER_POINT, Numerics::Vector2{ 0, 0 });
-            SetBoxedProperty<uint32_t>(D2D1_SCALE_PROP_INTERPOLATION_MODE, D2D1_CONVOLVEMATRIX_SCALE_MODE_LINEAR);
-            SetBoxedProperty<uint32_t>(D2D1_SCALE_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-            SetBoxedProperty<float>(D2D1_SCALE_PROP_SHARPNESS, 0.0f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ScaleEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ScaleEffect,
         Scale,
         float[2],
         Numerics::Vector2,
         D2D1_SCALE_PROP_SCALE,
-        (value.X >= 0.01f) && (value.Y >= 0.01f))
+        Numerics::Vector2{ 0.01f, 0.01f },
+        Numerics::Vector2{ std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() })
 
     IMPLEMENT_EFFECT_PROPERTY(ScaleEffect,
         CenterPoint,
@@ -48,12 +47,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         EffectBorderMode,
         D2D1_SCALE_PROP_BORDER_MODE)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ScaleEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ScaleEffect,
         Sharpness,
         float,
         float,
         D2D1_SCALE_PROP_SHARPNESS,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(ScaleEffect,
         Source,
@@ -11,23 +11,22 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(SepiaEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SEPIA_PROP_INTENSITY, 0.5f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_SEPIA_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED))
+
     SepiaEffect::SepiaEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<ISepiaEffect*>(this))
+        : CanvasEffect(EffectId(), SepiaEffectPropertyDefaults, 1, true, device, effect, static_cast<ISepiaEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_SEPIA_PROP_INTENSITY, 0.5f);
-            SetBoxedProperty<uint32_t>(D2D1_SEPIA_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SepiaEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SepiaEffect,
         Intensity,
         float,
         float,
         D2D1_SEPIA_PROP_INTENSITY,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(SepiaEffect,
         AlphaMode,
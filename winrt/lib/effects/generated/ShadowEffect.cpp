@@ -9,24 +9,23 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(ShadowEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SHADOW_PROP_BLUR_STANDARD_DEVIATION, 3.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SHADOW_PROP_COLOR, 4, 0, 0, 0, 1),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_SHADOW_PROP_OPTIMIZATION, D2D1_SHADOW_OPTIMIZATION_BALANCED))
+
     ShadowEffect::ShadowEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IShadowEffect*>(this))
+        : CanvasEffect(EffectId(), ShadowEffectPropertyDefaults, 1, true, device, effect, static_cast<IShadowEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_SHADOW_PROP_BLUR_STANDARD_DEVIATION, 3.0f);
-            SetBoxedProperty<float[4]>(D2D1_SHADOW_PROP_COLOR, Color{ 255, 0, 0, 0 });
-            SetBoxedProperty<uint32_t>(D2D1_SHADOW_PROP_OPTIMIZATION, D2D1_SHADOW_OPTIMIZATION_BALANCED);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(ShadowEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(ShadowEffect,
         BlurAmount,
         float,
         float,
         D2D1_SHADOW_PROP_BLUR_STANDARD_DEVIATION,
-        (value >= 0.0f) && (value <= 250.0f))
+        0.0f,
+        250.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(ShadowEffect,
         ShadowColor,
@@ -11,30 +11,30 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(SharpenEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SHARPEN_PROP_SHARPNESS, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SHARPEN_PROP_THRESHOLD, 0.0f))
+
     SharpenEffect::SharpenEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<ISharpenEffect*>(this))
+        : CanvasEffect(EffectId(), SharpenEffectPropertyDefaults, 1, true, device, effect, static_cast<ISharpenEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_SHARPEN_PROP_SHARPNESS, 0.0f);
-            SetBoxedProperty<float>(D2D1_SHARPEN_PROP_THRESHOLD, 0.0f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SharpenEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SharpenEffect,
         Amount,
         float,
         float,
         D2D1_SHARPEN_PROP_SHARPNESS,
-        (value >= 0.0f) && (value <= 10.0f))
+        0.0f,
+        10.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SharpenEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SharpenEffect,
         Threshold,
         float,
         float,
         D2D1_SHARPEN_PROP_THRESHOLD,
-        (value >= 0.0f) && (value <= 10.0f))
+        0.0f,
+        10.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(SharpenEffect,
         Source,
@@ -9,22 +9,20 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(SpotDiffuseEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTDIFFUSE_PROP_LIGHT_POSITION, 3, 0.0f, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTDIFFUSE_PROP_POINTS_AT, 3, 0.0f, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTDIFFUSE_PROP_FOCUS, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTDIFFUSE_PROP_LIMITING_CONE_ANGLE, 90.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTDIFFUSE_PROP_DIFFUSE_CONSTANT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTDIFFUSE_PROP_SURFACE_SCALE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTDIFFUSE_PROP_COLOR, 3, 1.0f, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTDIFFUSE_PROP_KERNEL_UNIT_LENGTH, 2, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_SPOTDIFFUSE_PROP_SCALE_MODE, D2D1_SPOTDIFFUSE_SCALE_MODE_LINEAR))
+
     SpotDiffuseEffect::SpotDiffuseEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 9, 1, true, device, effect, static_cast<ISpotDiffuseEffect*>(this))
+        : CanvasEffect(EffectId(), SpotDiffuseEffectPropertyDefaults, 1, true, device, effect, static_cast<ISpotDiffuseEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[3]>(D2D1_SPOTDIFFUSE_PROP_LIGHT_POSITION, Numerics::Vector3{ 0.0f, 0.0f, 0.0f });
-            SetBoxedProperty<float[3]>(D2D1_SPOTDIFFUSE_PROP_POINTS_AT, Numerics::Vector3{ 0.0f, 0.0f, 0.0f });
-            SetBoxedProperty<float>(D2D1_SPOTDIFFUSE_PROP_FOCUS, 1.0f);
-            SetBoxedProperty<float>(D2D1_SPOTDIFFUSE_PROP_LIMITING_CONE_ANGLE, 90.0f);
-            SetBoxedProperty<float>(D2D1_SPOTDIFFUSE_PROP_DIFFUSE_CONSTANT, 1.0f);
-            SetBoxedProperty<float>(D2D1_SPOTDIFFUSE_PROP_SURFACE_SCALE, 1.0f);
-            SetBoxedProperty<float[3]>(D2D1_SPOTDIFFUSE_PROP_COLOR, Color{ 255, 255, 255, 255 });
-            SetBoxedProperty<float[2]>(D2D1_SPOTDIFFUSE_PROP_KERNEL_UNIT_LENGTH, Numerics::Vector2{ 1.0f, 1.0f });
-            SetBoxedProperty<uint32_t>(D2D1_SPOTDIFFUSE_PROP_SCALE_MODE, D2D1_SPOTDIFFUSE_SCALE_MODE_LINEAR);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(SpotDiffuseEffect,
@@ -39,12 +37,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Numerics::Vector3,
         D2D1_SPOTDIFFUSE_PROP_POINTS_AT)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotDiffuseEffect,
         Focus,
         float,
         float,
         D2D1_SPOTDIFFUSE_PROP_FOCUS,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(SpotDiffuseEffect,
         LimitingConeAngle,
@@ -52,19 +51,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         float,
         D2D1_SPOTDIFFUSE_PROP_LIMITING_CONE_ANGLE)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotDiffuseEffect,
         DiffuseAmount,
         float,
         float,
         D2D1_SPOTDIFFUSE_PROP_DIFFUSE_CONSTANT,
-        (value >= 0.0f) && (value <= 10000.0f))
+        0.0f,
+        10000.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotDiffuseEffect,
         HeightMapScale,
         float,
         float,
         D2D1_SPOTDIFFUSE_PROP_SURFACE_SCALE,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(SpotDiffuseEffect,
         LightColor,
@@ -72,12 +73,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Color,
         D2D1_SPOTDIFFUSE_PROP_COLOR)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotDiffuseEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotDiffuseEffect,
         HeightMapKernelSize,
         float[2],
         Numerics::Vector2,
         D2D1_SPOTDIFFUSE_PROP_KERNEL_UNIT_LENGTH,
-        (value.X >= 0.01f) && (value.Y >= 0.01f) && (value.X <= 100.0f) && (value.Y <= 100.0f))
+        Numerics::Vector2{ 0.01f, 0.01f },
+        Numerics::Vector2{ 100.0f, 100.0f })
 
     IMPLEMENT_EFFECT_PROPERTY(SpotDiffuseEffect,
         HeightMapInterpolationMode,
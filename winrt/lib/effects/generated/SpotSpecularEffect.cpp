@@ -9,23 +9,21 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(SpotSpecularEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTSPECULAR_PROP_LIGHT_POSITION, 3, 0.0f, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTSPECULAR_PROP_POINTS_AT, 3, 0.0f, 0.0f, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTSPECULAR_PROP_FOCUS, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTSPECULAR_PROP_LIMITING_CONE_ANGLE, 90.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTSPECULAR_PROP_SPECULAR_EXPONENT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTSPECULAR_PROP_SPECULAR_CONSTANT, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_SPOTSPECULAR_PROP_SURFACE_SCALE, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTSPECULAR_PROP_COLOR, 3, 1.0f, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_SPOTSPECULAR_PROP_KERNEL_UNIT_LENGTH, 2, 1.0f, 1.0f),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_SPOTSPECULAR_PROP_SCALE_MODE, D2D1_SPOTSPECULAR_SCALE_MODE_LINEAR))
+
     SpotSpecularEffect::SpotSpecularEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 10, 1, true, device, effect, static_cast<ISpotSpecularEffect*>(this))
+        : CanvasEffect(EffectId(), SpotSpecularEffectPropertyDefaults, 1, true, device, effect, static_cast<ISpotSpecularEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[3]>(D2D1_SPOTSPECULAR_PROP_LIGHT_POSITION, Numerics::Vector3{ 0.0f, 0.0f, 0.0f });
-            SetBoxedProperty<float[3]>(D2D1_SPOTSPECULAR_PROP_POINTS_AT, Numerics::Vector3{ 0.0f, 0.0f, 0.0f });
-            SetBoxedProperty<float>(D2D1_SPOTSPECULAR_PROP_FOCUS, 1.0f);
-            SetBoxedProperty<float>(D2D1_SPOTSPECULAR_PROP_LIMITING_CONE_ANGLE, 90.0f);
-            SetBoxedProperty<float>(D2D1_SPOTSPECULAR_PROP_SPECULAR_EXPONENT, 1.0f);
-            SetBoxedProperty<float>(D2D1_SPOTSPECULAR_PROP_SPECULAR_CONSTANT, 1.0f);
-            SetBoxedProperty<float>(D2D1_SPOTSPECULAR_PROP_SURFACE_SCALE, 1.0f);
-            SetBoxedProperty<float[3]>(D2D1_SPOTSPECULAR_PROP_COLOR, Color{ 255, 255, 255, 255 });
-            SetBoxedProperty<float[2]>(D2D1_SPOTSPECULAR_PROP_KERNEL_UNIT_LENGTH, Numerics::Vector2{ 1.0f, 1.0f });
-            SetBoxedProperty<uint32_t>(D2D1_SPOTSPECULAR_PROP_SCALE_MODE, D2D1_SPOTSPECULAR_SCALE_MODE_LINEAR);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(SpotSpecularEffect,
@@ -40,12 +38,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Numerics::Vector3,
         D2D1_SPOTSPECULAR_PROP_POINTS_AT)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotSpecularEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotSpecularEffect,
         Focus,
         float,
         float,
         D2D1_SPOTSPECULAR_PROP_FOCUS,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(SpotSpecularEffect,
         LimitingConeAngle,
@@ -53,26 +52,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         float,
         D2D1_SPOTSPECULAR_PROP_LIMITING_CONE_ANGLE)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotSpecularEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotSpecularEffect,
         SpecularExponent,
         float,
         float,
         D2D1_SPOTSPECULAR_PROP_SPECULAR_EXPONENT,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotSpecularEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotSpecularEffect,
         SpecularAmount,
         float,
         float,
         D2D1_SPOTSPECULAR_PROP_SPECULAR_CONSTANT,
-        (value >= 0.0f) && (value <= 10000.0f))
+        0.0f,
+        10000.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotSpecularEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotSpecularEffect,
         HeightMapScale,
         float,
         float,
         D2D1_SPOTSPECULAR_PROP_SURFACE_SCALE,
-        (value >= -10000.0f) && (value <= 10000.0f))
+        -10000.0f,
+        10000.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(SpotSpecularEffect,
         LightColor,
@@ -80,12 +82,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Color,
         D2D1_SPOTSPECULAR_PROP_COLOR)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(SpotSpecularEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(SpotSpecularEffect,
         HeightMapKernelSize,
         float[2],
         Numerics::Vector2,
         D2D1_SPOTSPECULAR_PROP_KERNEL_UNIT_LENGTH,
-        (value.X >= 0.01f) && (value.Y >= 0.01f) && (value.X <= 100.0f) && (value.Y <= 100.0f))
+        Numerics::Vector2{ 0.01f, 0.01f },
+        Numerics::Vector2{ 100.0f, 100.0f })
 
     IMPLEMENT_EFFECT_PROPERTY(SpotSpecularEffect,
         HeightMapInterpolationMode,
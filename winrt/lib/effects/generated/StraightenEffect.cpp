@@ -11,16 +11,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(StraightenEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_STRAIGHTEN_PROP_ANGLE, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_STRAIGHTEN_PROP_MAINTAIN_SIZE, false),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_STRAIGHTEN_PROP_SCALE_MODE, D2D1_INTERPOLATION_MODE_LINEAR))
+
     StraightenEffect::StraightenEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IStraightenEffect*>(this))
+        : CanvasEffect(EffectId(), StraightenEffectPropertyDefaults, 1, true, device, effect, static_cast<IStraightenEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_STRAIGHTEN_PROP_ANGLE, 0.0f);
-            SetBoxedProperty<boolean>(D2D1_STRAIGHTEN_PROP_MAINTAIN_SIZE, static_cast<boolean>(false));
-            SetBoxedProperty<uint32_t>(D2D1_STRAIGHTEN_PROP_SCALE_MODE, D2D1_INTERPOLATION_MODE_LINEAR);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(StraightenEffect,
@@ -11,15 +11,13 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(TableTransfer3DEffect,
+        EFFECT_PROPERTY_DEFAULT_INTERFACE(D2D1_LOOKUPTABLE3D_PROP_LUT),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_LOOKUPTABLE3D_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED))
+
     TableTransfer3DEffect::TableTransfer3DEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<ITableTransfer3DEffect*>(this))
+        : CanvasEffect(EffectId(), TableTransfer3DEffectPropertyDefaults, 1, true, device, effect, static_cast<ITableTransfer3DEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<IEffectTransferTable3D*>(D2D1_LOOKUPTABLE3D_PROP_LUT, static_cast<IEffectTransferTable3D*>(nullptr));
-            SetBoxedProperty<uint32_t>(D2D1_LOOKUPTABLE3D_PROP_ALPHA_MODE, D2D1_COLORMANAGEMENT_ALPHA_MODE_PREMULTIPLIED);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(TableTransfer3DEffect,
@@ -9,22 +9,20 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(TableTransferEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TABLETRANSFER_PROP_RED_TABLE, 2, 0.0, 1.0),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TABLETRANSFER_PROP_RED_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TABLETRANSFER_PROP_GREEN_TABLE, 2, 0.0, 1.0),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TABLETRANSFER_PROP_GREEN_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TABLETRANSFER_PROP_BLUE_TABLE, 2, 0.0, 1.0),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TABLETRANSFER_PROP_BLUE_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TABLETRANSFER_PROP_ALPHA_TABLE, 2, 0.0, 1.0),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TABLETRANSFER_PROP_ALPHA_DISABLE, false),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TABLETRANSFER_PROP_CLAMP_OUTPUT, false))
+
     TableTransferEffect::TableTransferEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 9, 1, true, device, effect, static_cast<ITableTransferEffect*>(this))
+        : CanvasEffect(EffectId(), TableTransferEffectPropertyDefaults, 1, true, device, effect, static_cast<ITableTransferEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetArrayProperty<float>(D2D1_TABLETRANSFER_PROP_RED_TABLE, { 0.0, 1.0 });
-            SetBoxedProperty<boolean>(D2D1_TABLETRANSFER_PROP_RED_DISABLE, static_cast<boolean>(false));
-            SetArrayProperty<float>(D2D1_TABLETRANSFER_PROP_GREEN_TABLE, { 0.0, 1.0 });
-            SetBoxedProperty<boolean>(D2D1_TABLETRANSFER_PROP_GREEN_DISABLE, static_cast<boolean>(false));
-            SetArrayProperty<float>(D2D1_TABLETRANSFER_PROP_BLUE_TABLE, { 0.0, 1.0 });
-            SetBoxedProperty<boolean>(D2D1_TABLETRANSFER_PROP_BLUE_DISABLE, static_cast<boolean>(false));
-            SetArrayProperty<float>(D2D1_TABLETRANSFER_PROP_ALPHA_TABLE, { 0.0, 1.0 });
-            SetBoxedProperty<boolean>(D2D1_TABLETRANSFER_PROP_ALPHA_DISABLE, static_cast<boolean>(false));
-            SetBoxedProperty<boolean>(D2D1_TABLETRANSFER_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_ARRAY_PROPERTY(TableTransferEffect,
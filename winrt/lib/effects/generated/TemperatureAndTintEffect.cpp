@@ -11,30 +11,30 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(TemperatureAndTintEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_TEMPERATUREANDTINT_PROP_TEMPERATURE, 0.0f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_TEMPERATUREANDTINT_PROP_TINT, 0.0f))
+
     TemperatureAndTintEffect::TemperatureAndTintEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<ITemperatureAndTintEffect*>(this))
+        : CanvasEffect(EffectId(), TemperatureAndTintEffectPropertyDefaults, 1, true, device, effect, static_cast<ITemperatureAndTintEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float>(D2D1_TEMPERATUREANDTINT_PROP_TEMPERATURE, 0.0f);
-            SetBoxedProperty<float>(D2D1_TEMPERATUREANDTINT_PROP_TINT, 0.0f);
-        }
     }
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(TemperatureAndTintEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(TemperatureAndTintEffect,
         Temperature,
         float,
         float,
         D2D1_TEMPERATUREANDTINT_PROP_TEMPERATURE,
-        (value >= -1.0f) && (value <= 1.0f))
+        -1.0f,
+        1.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(TemperatureAndTintEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(TemperatureAndTintEffect,
         Tint,
         float,
         float,
         D2D1_TEMPERATUREANDTINT_PROP_TINT,
-        (value >= -1.0f) && (value <= 1.0f))
+        -1.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(TemperatureAndTintEffect,
         Source,
@@ -9,14 +9,12 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(TileEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TILE_PROP_RECT, 4, 0.0f, 0.0f, 100.0f, 100.0f))
+
     TileEffect::TileEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 1, 1, true, device, effect, static_cast<ITileEffect*>(this))
+        : CanvasEffect(EffectId(), TileEffectPropertyDefaults, 1, true, device, effect, static_cast<ITileEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_TILE_PROP_RECT, Rect{ 0, 0, 100, 100 });
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(TileEffect,
@@ -11,18 +11,15 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(TintEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TINT_PROP_COLOR, 4, 1, 1, 1, 1),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TINT_PROP_CLAMP_OUTPUT, false))
+
     TintEffect::TintEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 2, 1, true, device, effect, static_cast<ITintEffect*>(this))
+        : CanvasEffect(EffectId(), TintEffectPropertyDefaults, 1, true, device, effect, static_cast<ITintEffect*>(this))
     {
         if (!SharedDeviceState::GetInstance()->IsID2D1Factory5Supported())
             ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);
-
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_TINT_PROP_COLOR, Color{ 255, 255, 255, 255 });
-            SetBoxedProperty<boolean>(D2D1_TINT_PROP_CLAMP_OUTPUT, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(TintEffect,
@@ -9,17 +9,15 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(Transform2DEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_2DAFFINETRANSFORM_PROP_INTERPOLATION_MODE, D2D1_2DAFFINETRANSFORM_INTERPOLATION_MODE_LINEAR),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_2DAFFINETRANSFORM_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX, 6, 1, 0, 0, 1, 0, 0),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_2DAFFINETRANSFORM_PROP_SHARPNESS, 0.0f))
+
     Transform2DEffect::Transform2DEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 4, 1, true, device, effect, static_cast<ITransform2DEffect*>(this))
+        : CanvasEffect(EffectId(), Transform2DEffectPropertyDefaults, 1, true, device, effect, static_cast<ITransform2DEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_2DAFFINETRANSFORM_PROP_INTERPOLATION_MODE, D2D1_2DAFFINETRANSFORM_INTERPOLATION_MODE_LINEAR);
-            SetBoxedProperty<uint32_t>(D2D1_2DAFFINETRANSFORM_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-            SetBoxedProperty<float[6]>(D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX, Numerics::Matrix3x2{ 1, 0, 0, 1, 0, 0 });
-            SetBoxedProperty<float>(D2D1_2DAFFINETRANSFORM_PROP_SHARPNESS, 0.0f);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(Transform2DEffect,
@@ -40,12 +38,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Numerics::Matrix3x2,
         D2D1_2DAFFINETRANSFORM_PROP_TRANSFORM_MATRIX)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(Transform2DEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(Transform2DEffect,
         Sharpness,
         float,
         float,
         D2D1_2DAFFINETRANSFORM_PROP_SHARPNESS,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(Transform2DEffect,
         Source,
@@ -9,16 +9,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(Transform3DEffect,
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_3DTRANSFORM_PROP_INTERPOLATION_MODE, D2D1_INTERPOLATION_MODE_LINEAR),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_3DTRANSFORM_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_3DTRANSFORM_PROP_TRANSFORM_MATRIX, 16, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1))
+
     Transform3DEffect::Transform3DEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<ITransform3DEffect*>(this))
+        : CanvasEffect(EffectId(), Transform3DEffectPropertyDefaults, 1, true, device, effect, static_cast<ITransform3DEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<uint32_t>(D2D1_3DTRANSFORM_PROP_INTERPOLATION_MODE, D2D1_INTERPOLATION_MODE_LINEAR);
-            SetBoxedProperty<uint32_t>(D2D1_3DTRANSFORM_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-            SetBoxedProperty<float[16]>(D2D1_3DTRANSFORM_PROP_TRANSFORM_MATRIX, Numerics::Matrix4x4{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 });
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(Transform3DEffect,
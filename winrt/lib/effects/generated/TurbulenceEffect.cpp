@@ -9,20 +9,18 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(TurbulenceEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TURBULENCE_PROP_OFFSET, 2, 0, 0),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TURBULENCE_PROP_SIZE, 2, 512, 512),
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_TURBULENCE_PROP_BASE_FREQUENCY, 2, 0.01f, 0.01f),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_TURBULENCE_PROP_NUM_OCTAVES, 1),
+        EFFECT_PROPERTY_DEFAULT_INT32(D2D1_TURBULENCE_PROP_SEED, 0),
+        EFFECT_PROPERTY_DEFAULT_UINT32(D2D1_TURBULENCE_PROP_NOISE, D2D1_TURBULENCE_NOISE_FRACTAL_SUM),
+        EFFECT_PROPERTY_DEFAULT_BOOLEAN(D2D1_TURBULENCE_PROP_STITCHABLE, false))
+
     TurbulenceEffect::TurbulenceEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 7, 0, true, device, effect, static_cast<ITurbulenceEffect*>(this))
+        : CanvasEffect(EffectId(), TurbulenceEffectPropertyDefaults, 0, true, device, effect, static_cast<ITurbulenceEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[2]>(D2D1_TURBULENCE_PROP_OFFSET, Numerics::Vector2{ 0, 0 });
-            SetBoxedProperty<float[2]>(D2D1_TURBULENCE_PROP_SIZE, Numerics::Vector2{ 512, 512 });
-            SetBoxedProperty<float[2]>(D2D1_TURBULENCE_PROP_BASE_FREQUENCY, Numerics::Vector2{ 0.01f, 0.01f });
-            SetBoxedProperty<int32_t>(D2D1_TURBULENCE_PROP_NUM_OCTAVES, 1);
-            SetBoxedProperty<int32_t>(D2D1_TURBULENCE_PROP_SEED, 0);
-            SetBoxedProperty<uint32_t>(D2D1_TURBULENCE_PROP_NOISE, D2D1_TURBULENCE_NOISE_FRACTAL_SUM);
-            SetBoxedProperty<boolean>(D2D1_TURBULENCE_PROP_STITCHABLE, static_cast<boolean>(false));
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(TurbulenceEffect,
@@ -31,33 +29,37 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Numerics::Vector2,
         D2D1_TURBULENCE_PROP_OFFSET)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(TurbulenceEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(TurbulenceEffect,
         Size,
         float[2],
         Numerics::Vector2,
         D2D1_TURBULENCE_PROP_SIZE,
-        (value.X >= 0) && (value.Y >= 0))
+        Numerics::Vector2{ 0, 0 },
+        Numerics::Vector2{ std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() })
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(TurbulenceEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(TurbulenceEffect,
         Frequency,
         float[2],
         Numerics::Vector2,
         D2D1_TURBULENCE_PROP_BASE_FREQUENCY,
-        (value.X >= 0) && (value.Y >= 0) && (value.X <= 1000) && (value.Y <= 1000))
+        Numerics::Vector2{ 0, 0 },
+        Numerics::Vector2{ 1000, 1000 })
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(TurbulenceEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(TurbulenceEffect,
         Octaves,
         int32_t,
         int32_t,
         D2D1_TURBULENCE_PROP_NUM_OCTAVES,
-        (value >= 1) && (value <= 15))
+        1,
+        15)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(TurbulenceEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(TurbulenceEffect,
         Seed,
         int32_t,
         int32_t,
         D2D1_TURBULENCE_PROP_SEED,
-        (value >= -10000) && (value <= 10000))
+        -10000,
+        10000)
 
     IMPLEMENT_EFFECT_PROPERTY(TurbulenceEffect,
         Noise,
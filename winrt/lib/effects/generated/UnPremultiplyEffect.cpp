@@ -12,10 +12,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     UnPremultiplyEffect::UnPremultiplyEffect(ICanvasDevice* device, ID2D1Effect* effect)
         : CanvasEffect(EffectId(), 0, 1, true, device, effect, static_cast<IUnPremultiplyEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-        }
     }
 
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(UnPremultiplyEffect,
@@ -11,16 +11,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
 {
+    IMPLEMENT_EFFECT_PROPERTY_DEFAULTS(VignetteEffect,
+        EFFECT_PROPERTY_DEFAULT_SINGLE_ARRAY(D2D1_VIGNETTE_PROP_COLOR, 4, 0, 0, 0, 1),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_VIGNETTE_PROP_TRANSITION_SIZE, 0.1f),
+        EFFECT_PROPERTY_DEFAULT_SINGLE(D2D1_VIGNETTE_PROP_STRENGTH, 0.5f))
+
     VignetteEffect::VignetteEffect(ICanvasDevice* device, ID2D1Effect* effect)
-        : CanvasEffect(EffectId(), 3, 1, true, device, effect, static_cast<IVignetteEffect*>(this))
+        : CanvasEffect(EffectId(), VignetteEffectPropertyDefaults, 1, true, device, effect, static_cast<IVignetteEffect*>(this))
     {
-        if (!effect)
-        {
-            // Set default values
-            SetBoxedProperty<float[4]>(D2D1_VIGNETTE_PROP_COLOR, Color{ 255, 0, 0, 0 });
-            SetBoxedProperty<float>(D2D1_VIGNETTE_PROP_TRANSITION_SIZE, 0.1f);
-            SetBoxedProperty<float>(D2D1_VIGNETTE_PROP_STRENGTH, 0.5f);
-        }
     }
 
     IMPLEMENT_EFFECT_PROPERTY(VignetteEffect,
@@ -29,19 +27,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         Color,
         D2D1_VIGNETTE_PROP_COLOR)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(VignetteEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(VignetteEffect,
         Amount,
         float,
         float,
         D2D1_VIGNETTE_PROP_TRANSITION_SIZE,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
-    IMPLEMENT_EFFECT_PROPERTY_WITH_VALIDATION(VignetteEffect,
+    IMPLEMENT_EFFECT_PROPERTY_WITH_RANGE(VignetteEffect,
         Curve,
         float,
         float,
         D2D1_VIGNETTE_PROP_STRENGTH,
-        (value >= 0.0f) && (value <= 1.0f))
+        0.0f,
+        1.0f)
 
     IMPLEMENT_EFFECT_PROPERTY(VignetteEffect,
         ColorHdr,
@@ -30,88 +30,120 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         return ExceptionBoundary([&]
         {
-            D2D_RECT_L accumulatedRect = { INT_MIN, INT_MIN, INT_MAX, INT_MAX };
-            bool gotRect = false;
-            bool gotOffset = false;
-
-            // Start at 1 to skip the output from PixelShaderTransform - we only care about its original input images.
-            for (unsigned i = 1; i < inputRectCount; i++)
+            // Skip the output from PixelShaderTransform - we only care about its original input images.
+            if (inputRectCount > 1)
+            {
+                *outputRect = CalculateOutputRect(*m_coordinateMapping, inputRects + 1, inputRectCount - 1);
+            }
+            else
             {
-                unsigned inputIndex = i - 1;
+                *outputRect = CalculateOutputRect(*m_coordinateMapping, nullptr, 0);
+            }
+
+            // We don't know how this shader handles opacity, so always just report an empty opaque subrect.
+            *outputOpaqueSubRect = D2D1_RECT_L{ 0, 0, 0, 0 };
+        });
+    }
 
-                if (inputIndex >= MaxShaderInputs)
-                    ThrowHR(E_INVALIDARG);
 
-                D2D_RECT_L rect;
-
-                switch (m_coordinateMapping->Mapping[inputIndex])
-                {
-                    case SamplerCoordinateMapping::Unknown:
-                        // Due to unknown coordinate mapping, this input does not contribute to the output rectangle.
-                        continue;
-
-                    case SamplerCoordinateMapping::OneToOne:
-                        // This input rectangle maps directly to the output.
-                        rect = inputRects[i];
-                        break;
-
-                    case SamplerCoordinateMapping::Offset:
-                        // This rectangle may need to be expanded due to the use of offset texture coordinates.
-                        if (!m_coordinateMapping->MaxOffset)
-                        {
-                            WinStringBuilder message;
-                            message.Format(Strings::CustomEffectOffsetMappingWithoutMaxOffset, i);
-                            ThrowHR(E_INVALIDARG, message.Get());
-                        }
-
-                        switch (m_coordinateMapping->BorderMode[inputIndex])
-                        {
-                            case EffectBorderMode::Soft:
-                                // In soft border mode, expand the input rectangle.
-                                rect = ExpandRectangle(inputRects[i], m_coordinateMapping->MaxOffset);
-                                break;
-
-                            case EffectBorderMode::Hard:
-                                // For hard borders, pass the input through unchanged.
-                                rect = inputRects[i];
-                                break;
-
-                            default:
-                                ThrowHR(E_INVALIDARG);
-                        }
+    D2D1_RECT_L ClipTransform::CalculateOutputRect(CoordinateMappingState const& coordinateMapping, D2D1_RECT_L const* sourceRects, unsigned sourceCount)
+    {
+        D2D_RECT_L accumulatedRect = { INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+        bool gotRect = false;
+        bool gotOffset = false;
+
+        for (unsigned i = 0; i < sourceCount; i++)
+        {
+            if (i >= MaxShaderInputs)
+                ThrowHR(E_INVALIDARG);
 
+            D2D_RECT_L rect;
+
+            switch (coordinateMapping.Mapping[i])
+            {
+                case SamplerCoordinateMapping::Unknown:
+                    // Due to unknown coordinate mapping, this input does not contribute to the output rectangle.
+                    continue;
+
+                case SamplerCoordinateMapping::OneToOne:
+                    // This input rectangle maps directly to the output.
+                    rect = sourceRects[i];
+                    break;
+
+                case SamplerCoordinateMapping::Offset:
+                    // This rectangle may need to be expanded due to the use of offset texture coordinates.
+                    if (!coordinateMapping.MaxOffset)
+                    {
+                        WinStringBuilder message;
+                        message.Format(Strings::CustomEffectOffsetMappingWithoutMaxOffset, i + 1);
+                        ThrowHR(E_INVALIDARG, message.Get());
+                    }
+
+                    switch (coordinateMapping.BorderMode[i])
+                    {
+                        case EffectBorderMode::Soft:
+                            // In soft border mode, expand the input rectangle.
+                            rect = ExpandRectangle(sourceRects[i], coordinateMapping.MaxOffset);
+                            break;
+
+                        case EffectBorderMode::Hard:
+                            // For hard borders, pass the input through unchanged.
+                            rect = sourceRects[i];
+                            break;
+
+                        default:
+                            ThrowHR(E_INVALIDARG);
+                    }
+
+                    gotOffset = true;
+                    break;
+
+                case SamplerCoordinateMapping::Transformed:
+                    {
+                        // The output pixels that sample from within this input are given by the inverse transform.
+                        auto inverse = *ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&coordinateMapping.Transform[i]);
+
+                        // A transform that can't be inverted tells us nothing, so treat it as unknown.
+                        if (!D2D1InvertMatrix(&inverse))
+                            continue;
+
+                        // As for Offset, soft borders extend the area affected by this input.
+                        auto sourceRect = sourceRects[i];
+
+                        if (coordinateMapping.BorderMode[i] == EffectBorderMode::Soft)
+                            sourceRect = ExpandRectangle(sourceRect, 1 + coordinateMapping.MaxOffset);
+
+                        rect = TransformRectangle(sourceRect, *ReinterpretAs<Numerics::Matrix3x2 const*>(&inverse));
+
+                        // MaxOffset is also applied around transformed sample positions.
                         gotOffset = true;
-                        break;
-
-                    default:
-                        ThrowHR(E_INVALIDARG);
-                }
-
-                if (!gotRect)
-                {
-                    // This is the first output rectangle we have seen, so store it directly.
-                    accumulatedRect = rect;
-                    gotRect = true;
-                }
-                else
-                {
-                    // Subsequent rectangles are combined with the existing region.
-                    accumulatedRect = RectangleUnion(accumulatedRect, rect);
-                }
+                    }
+                    break;
+
+                default:
+                    ThrowHR(E_INVALIDARG);
             }
 
-            // Validate that if MaxOffset is set, at least one input should be using SamplerCoordinateMapping::Offset.
-            if (m_coordinateMapping->MaxOffset && !gotOffset)
+            if (!gotRect)
+            {
+                // This is the first output rectangle we have seen, so store it directly.
+                accumulatedRect = rect;
+                gotRect = true;
+            }
+            else
             {
-                ThrowHR(E_INVALIDARG, Strings::CustomEffectMaxOffsetWithoutOffsetMapping);
+                // Subsequent rectangles are combined with the existing region.
+                accumulatedRect = RectangleUnion(accumulatedRect, rect);
             }
+        }
 
-            // Return the accumulated output rectangle.
-            *outputRect = accumulatedRect;
+        // Validate that if MaxOffset is set, at least one input should be using SamplerCoordinateMapping::Offset.
+        if (coordinateMapping.MaxOffset && !gotOffset)
+        {
+            ThrowHR(E_INVALIDARG, Strings::CustomEffectMaxOffsetWithoutOffsetMapping);
+        }
 
-            // We don't know how this shader handles opacity, so always just report an empty opaque subrect.
-            *outputOpaqueSubRect = D2D1_RECT_L{ 0, 0, 0, 0 };
-        });
+        return accumulatedRect;
     }
 
 
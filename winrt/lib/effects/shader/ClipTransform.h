@@ -28,6 +28,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHOD(MapInvalidRect)(UINT32 inputIndex, D2D1_RECT_L invalidInputRect, D2D1_RECT_L* invalidOutputRect) const override;
 
         IFACEMETHOD(SetDrawInfo)(ID2D1DrawInfo* drawInfo) override;
+
+        // Combines the source rectangles of a shader into its output rectangle, according to
+        // their coordinate mapping. Also used by ComputeShaderTransform.
+        static D2D1_RECT_L CalculateOutputRect(CoordinateMappingState const& coordinateMapping, D2D1_RECT_L const* sourceRects, unsigned sourceCount);
     };
 
 }}}}}
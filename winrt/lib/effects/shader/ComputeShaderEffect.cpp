@@ -0,0 +1,429 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "ComputeShaderEffect.h"
+#include "ComputeShaderEffectImpl.h"
+#include "SharedShaderState.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    ActivatableClassWithFactory(ComputeShaderEffect, ComputeShaderEffectFactory);
+
+
+    IFACEMETHODIMP ComputeShaderEffectFactory::Create(uint32_t shaderCodeCount, BYTE* shaderCode, IComputeShaderEffect** effect)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckInPointer(shaderCode);
+            CheckAndClearOutPointer(effect);
+
+            // Create a shared state object using the specified shader code.
+            auto sharedState = Make<SharedShaderState>(shaderCode, shaderCodeCount, D3D11_SHVER_COMPUTE_SHADER);
+            CheckMakeResult(sharedState);
+
+            // Create the WinRT effect instance.
+            auto newEffect = Make<ComputeShaderEffect>(nullptr, nullptr, sharedState.Get());
+            CheckMakeResult(newEffect);
+
+            ThrowIfFailed(newEffect.CopyTo(effect));
+        });
+    }
+
+
+    // Describe how to implement WinRT IMap<> methods in terms of our shader constant buffer.
+    template<typename TKey, typename TValue>
+    struct ComputeShaderEffectPropertyMapTraits
+    {
+        typedef ElementTraits<TKey> KeyTraits;
+        typedef ElementTraits<TValue> ValueTraits;
+
+        typedef ComputeShaderEffect* InternalMapType;
+
+        // Forward these accessors to the SharedShaderState.
+        static unsigned GetSize(ComputeShaderEffect* effect)                                      { return EnsureNotClosed(effect)->m_sharedState->GetPropertyCount(); };
+        static bool HasKey(ComputeShaderEffect* effect, HSTRING key)                              { return EnsureNotClosed(effect)->m_sharedState->HasProperty(key); }
+        static ComPtr<IInspectable> Lookup(ComputeShaderEffect* effect, HSTRING key)              { return EnsureNotClosed(effect)->m_sharedState->GetProperty(key); }
+        static bool Insert(ComputeShaderEffect* effect, HSTRING key, IInspectable* value, bool)   { EnsureNotClosed(effect)->SetProperty(key, value); return true; }
+        static std::vector<StringObjectPair> GetKeyValuePairs(ComputeShaderEffect* effect)        { return EnsureNotClosed(effect)->m_sharedState->EnumerateProperties(); }
+
+        // Our map is created with IsFixedSize=true, so these should never be called.
+        static void Remove(ComputeShaderEffect*, TKey const&) { assert(false); }
+        static void Clear(ComputeShaderEffect*)               { assert(false); }
+
+    private:
+        static ComputeShaderEffect* EnsureNotClosed(ComputeShaderEffect* effect)
+        {
+            if (!effect)
+                ThrowHR(RO_E_CLOSED);
+
+            return effect;
+        }
+    };
+
+
+    static ComPtr<ISharedShaderState> GetSharedStateFromD2DEffect(ID2D1Effect* effect)
+    {
+        ComPtr<IUnknown> sharedState;
+        ThrowIfFailed(effect->GetValue(ComputeShaderEffectProperty::SharedState, sharedState.GetAddressOf()));
+
+        if (!sharedState)
+            ThrowHR(E_INVALIDARG);
+
+        return As<ISharedShaderState>(sharedState);
+    }
+
+
+    ComputeShaderEffect::ComputeShaderEffect(ICanvasDevice* device, ID2D1Effect* effect)
+        : ComputeShaderEffect(device, effect, GetSharedStateFromD2DEffect(effect).Get())
+    { }
+
+
+    ComputeShaderEffect::ComputeShaderEffect(ICanvasDevice* device, ID2D1Effect* effect, ISharedShaderState* sharedState)
+        : CanvasEffect(CLSID_ComputeShaderEffect, 0, sharedState->Shader().InputCount, true, device, effect, static_cast<IComputeShaderEffect*>(this))
+        , m_sharedState(sharedState)
+    {
+        m_propertyMap = Make<PropertyMap>(true, this);
+        CheckMakeResult(m_propertyMap);
+    }
+
+
+    ComputeShaderEffect::~ComputeShaderEffect()
+    {
+        m_propertyMap->InternalMap() = nullptr;
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffect::Close()
+    {
+        m_propertyMap->InternalMap() = nullptr;
+
+        return CanvasEffect::Close();
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffect::get_Properties(IMap<HSTRING, IInspectable*>** value)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckAndClearOutPointer(value);
+            ThrowIfFailed(m_propertyMap.CopyTo(value));
+        });
+    }
+
+
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source1, 0)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source2, 1)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source3, 2)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source4, 3)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source5, 4)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source6, 5)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source7, 6)
+    IMPLEMENT_EFFECT_SOURCE_PROPERTY(ComputeShaderEffect, Source8, 7)
+
+    
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source1Mapping, 0)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source2Mapping, 1)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source3Mapping, 2)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source4Mapping, 3)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source5Mapping, 4)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source6Mapping, 5)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source7Mapping, 6)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(ComputeShaderEffect, Source8Mapping, 7)
+
+
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source1MappingTransform, 0)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source2MappingTransform, 1)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source3MappingTransform, 2)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source4MappingTransform, 3)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source5MappingTransform, 4)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source6MappingTransform, 5)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source7MappingTransform, 6)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(ComputeShaderEffect, Source8MappingTransform, 7)
+
+
+    IMPLEMENT_MAX_SAMPLER_OFFSET_PROPERTY(ComputeShaderEffect)
+
+
+    IFACEMETHODIMP ComputeShaderEffect::IsSupported(ICanvasDevice* device, boolean* result)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckInPointer(device);
+            CheckInPointer(result);
+
+            *result = IsSupported(device);
+        });
+    }
+
+
+    bool ComputeShaderEffect::IsSupported(ICanvasDevice* device)
+    {
+        ComPtr<ID3D11Device> d3dDevice;
+        ThrowIfFailed(As<IDirect3DDxgiInterfaceAccess>(device)->GetInterface(IID_PPV_ARGS(&d3dDevice)));
+
+        auto deviceFeatureLevel = d3dDevice->GetFeatureLevel();
+        auto shaderFeatureLevel = m_sharedState->Shader().MinFeatureLevel;
+
+        return deviceFeatureLevel >= shaderFeatureLevel;
+    }
+
+
+    bool ComputeShaderEffect::Realize(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext)
+    {
+        // Validate that this device supports the D3D feature level of the compute shader.
+        if (!IsSupported(RealizationDevice()))
+        {
+            ThrowHR(E_FAIL, Strings::ComputeEffectBadFeatureLevel);
+        }
+
+        // Before trying to instantiate our custom effect type, we must register it with the D2D factory.
+        ComPtr<ID2D1Factory> factory;
+        As<ICanvasDeviceInternal>(RealizationDevice())->GetD2DDevice()->GetFactory(&factory);
+
+        ComputeShaderEffectImpl::Register(As<ID2D1Factory1>(factory).Get());
+
+        // Chain to the base implementation.
+        if (!CanvasEffect::Realize(flags, targetDpi, deviceContext))
+        {
+            return false;
+        }
+
+        // Set our shared state as properties on the newly realized D2D effect instance.
+        ThrowIfFailed(GetResource()->SetValue(ComputeShaderEffectProperty::SharedState, m_sharedState.Get()));
+
+        SetD2DConstants();
+        SetD2DCoordinateMapping();
+        SetD2DThreadMapping();
+
+        return true;
+    }
+
+
+    void ComputeShaderEffect::Unrealize(unsigned int skipSourceIndex, bool skipAllSources)
+    {
+        // Break the link between ourselves and the old D2D effect instance
+        // by making a separate copy of the shared state object.
+        if (HasResource())
+        {
+            m_sharedState = m_sharedState->Clone();
+        }
+
+        // Chain to the base implementation.
+        CanvasEffect::Unrealize(skipSourceIndex, skipAllSources);
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffect::GetSource(unsigned int index, IGraphicsEffectSource** source)
+    {
+        if (index >= m_sharedState->Shader().InputCount && source)
+        {
+            // Getting an out of range source returns null, rather than throwing like most effects.
+            *source = nullptr;
+            return S_OK;
+        }
+        else
+        {
+            // Chain to the base implementation.
+            return CanvasEffect::GetSource(index, source);
+        }
+    }
+    
+    
+    void ComputeShaderEffect::SetSource(unsigned int index, IGraphicsEffectSource* source)
+    {
+        if (index >= m_sharedState->Shader().InputCount)
+        {
+            // Setting unused sources to null is valid.
+            // If the value is not null, we format a nice exception message.
+            if (source)
+            {
+                WinStringBuilder message;
+                message.Format(Strings::CustomEffectSourceOutOfRange, index + 1, m_sharedState->Shader().InputCount);
+                ThrowHR(E_INVALIDARG, message.Get());
+            }
+        }
+        else
+        {
+            // Chain to the base implementation.
+            CanvasEffect::SetSource(index, source);
+        }
+    }
+
+
+    void ComputeShaderEffect::SetProperty(HSTRING name, IInspectable* boxedValue)
+    {
+        auto lock = Lock(m_mutex);
+
+        // Store the new property value into our shared state object.
+        bool changed = m_sharedState->SetProperty(name, boxedValue);
+
+        // If we are realized, pass the updated constant buffer on to Direct2D.
+        // Skipping this when nothing changed avoids D2D invalidating the effect.
+        if (changed)
+        {
+            SetD2DConstants();
+        }
+    }
+
+
+    EffectAnimationTarget ComputeShaderEffect::ResolveAnimationTarget(HSTRING propertyName)
+    {
+        {
+            auto lock = Lock(m_mutex);
+
+            if (m_sharedState->HasProperty(propertyName))
+            {
+                // Shader properties are set directly in the constant buffer.
+                EffectAnimationTarget target{};
+
+                target.PropertyIndex = m_sharedState->GetAnimatableProperty(propertyName, &target.ComponentCount);
+                target.IsShaderProperty = true;
+
+                return target;
+            }
+        }
+
+        // Otherwise fall back to any D2D property mappings.
+        return CanvasEffect::ResolveAnimationTarget(propertyName);
+    }
+
+
+    void ComputeShaderEffect::SetAnimatedProperty(EffectAnimationTarget const& target, Numerics::Vector4 const& value)
+    {
+        if (!target.IsShaderProperty)
+        {
+            CanvasEffect::SetAnimatedProperty(target, value);
+            return;
+        }
+
+        float values[] = { value.X, value.Y, value.Z, value.W };
+
+        auto lock = Lock(m_mutex);
+
+        // As with SetProperty, only pass the constant buffer on to Direct2D if it changed.
+        if (m_sharedState->SetAnimatedProperty(target.PropertyIndex, values))
+        {
+            SetD2DConstants();
+        }
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffect::SetProperties(IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* values)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckInPointer(values);
+
+            if (!m_propertyMap->InternalMap())
+                ThrowHR(RO_E_CLOSED);
+
+            // Gather up the new values.
+            std::vector<StringObjectPair> newValues;
+
+            ComPtr<IIterator<IKeyValuePair<HSTRING, IInspectable*>*>> iterator;
+            ThrowIfFailed(values->First(&iterator));
+
+            boolean hasCurrent;
+            ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+            while (hasCurrent)
+            {
+                ComPtr<IKeyValuePair<HSTRING, IInspectable*>> pair;
+                ThrowIfFailed(iterator->get_Current(&pair));
+
+                WinString name;
+                ThrowIfFailed(pair->get_Key(name.GetAddressOf()));
+
+                ComPtr<IInspectable> value;
+                ThrowIfFailed(pair->get_Value(&value));
+
+                newValues.emplace_back(name, value);
+
+                ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+            }
+
+            auto lock = Lock(m_mutex);
+
+            // Store them all into our shared state object.
+            bool changed = m_sharedState->SetProperties(newValues);
+
+            // Pass the updated constant buffer on to Direct2D just once for the whole batch.
+            if (changed)
+            {
+                SetD2DConstants();
+            }
+        });
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffect::get_PixelsPerThread(BitmapSize* value)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckInPointer(value);
+
+            *value = m_sharedState->ThreadMapping().PixelsPerThread;
+        });
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffect::put_PixelsPerThread(BitmapSize value)
+    {
+        return ExceptionBoundary([&]
+        {
+            if (!value.Width || !value.Height)
+                ThrowHR(E_INVALIDARG);
+
+            auto lock = Lock(m_mutex);
+
+            // Store the new value into our shared state object.
+            m_sharedState->ThreadMapping().PixelsPerThread = value;
+
+            // If we are realized, pass the updated mapping state on to Direct2D.
+            SetD2DThreadMapping();
+        });
+    }
+
+
+    void ComputeShaderEffect::SetD2DConstants()
+    {
+        auto& d2dEffect = MaybeGetResource();
+        auto& constants = m_sharedState->Constants();
+
+        if (d2dEffect && !constants.empty())
+        {
+            ThrowIfFailed(d2dEffect->SetValue(ComputeShaderEffectProperty::Constants,
+                                              constants.data(),
+                                              static_cast<UINT32>(constants.size())));
+        }
+    }
+
+
+    void ComputeShaderEffect::SetD2DCoordinateMapping()
+    {
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            ThrowIfFailed(d2dEffect->SetValue(ComputeShaderEffectProperty::CoordinateMapping,
+                                              reinterpret_cast<BYTE*>(&m_sharedState->CoordinateMapping()),
+                                              sizeof(CoordinateMappingState)));
+        }
+    }
+
+
+    void ComputeShaderEffect::SetD2DThreadMapping()
+    {
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+        {
+            ThrowIfFailed(d2dEffect->SetValue(ComputeShaderEffectProperty::ThreadMapping,
+                                              reinterpret_cast<BYTE*>(&m_sharedState->ThreadMapping()),
+                                              sizeof(ThreadMappingState)));
+        }
+    }
+
+}}}}}
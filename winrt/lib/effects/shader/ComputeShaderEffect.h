@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "ShaderEffectCoordinateMapping.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
+{
+    template<typename TKey, typename TValue> struct ComputeShaderEffectPropertyMapTraits;
+
+
+    // WinRT activation factory.
+    class ComputeShaderEffectFactory : public AgileActivationFactory<IComputeShaderEffectFactory>
+                                     , private LifespanTracker<ComputeShaderEffectFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Effects_ComputeShaderEffect, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(uint32_t shaderCodeCount, BYTE* shaderCode, IComputeShaderEffect** effect) override;
+    };
+
+
+    // Public Win2D API surface for using custom compute shaders. This works like
+    // PixelShaderEffect, but the shader writes its output directly, one thread group
+    // at a time, so can share work between neighboring pixels.
+    class ComputeShaderEffect : public RuntimeClass<IComputeShaderEffect, MixIn<ComputeShaderEffect, CanvasEffect>>
+                              , public CanvasEffect
+                              , public ShaderEffectCoordinateMapping<ComputeShaderEffect>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Effects_ComputeShaderEffect, BaseTrust);
+
+        ComPtr<ISharedShaderState> m_sharedState;
+
+        friend ShaderEffectCoordinateMapping<ComputeShaderEffect>;
+
+        // Traits describe how to expose a view of our constant buffer as an IMap<> collection.
+        friend ComputeShaderEffectPropertyMapTraits<HSTRING, IInspectable*>;
+        typedef Map<HSTRING, IInspectable*, ComputeShaderEffectPropertyMapTraits> PropertyMap;
+        ComPtr<PropertyMap> m_propertyMap;
+
+    public:
+        ComputeShaderEffect(ICanvasDevice* device, ID2D1Effect* effect);
+        ComputeShaderEffect(ICanvasDevice* device, ID2D1Effect* effect, ISharedShaderState* sharedState);
+
+        virtual ~ComputeShaderEffect();
+
+        IFACEMETHOD(Close)() override;
+
+        IFACEMETHOD(get_Properties)(IMap<HSTRING, IInspectable*>** value) override;
+
+        EFFECT_PROPERTY(Source1, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source2, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source3, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source4, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source5, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source6, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source7, IGraphicsEffectSource*);
+        EFFECT_PROPERTY(Source8, IGraphicsEffectSource*);
+
+        EFFECT_PROPERTY(Source1Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source2Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source3Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source4Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source5Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source6Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source7Mapping, SamplerCoordinateMapping);
+        EFFECT_PROPERTY(Source8Mapping, SamplerCoordinateMapping);
+
+        EFFECT_PROPERTY(Source1MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source2MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source3MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source4MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source5MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source6MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source7MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source8MappingTransform, Numerics::Matrix3x2);
+
+        EFFECT_PROPERTY(MaxSamplerOffset, int);
+
+        EFFECT_PROPERTY(PixelsPerThread, BitmapSize);
+
+        IFACEMETHOD(IsSupported)(ICanvasDevice* device, boolean* result) override;
+
+        IFACEMETHOD(SetProperties)(IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* values) override;
+
+    protected:
+        bool IsSupported(ICanvasDevice* device);
+
+        virtual bool Realize(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext) override;
+        virtual void Unrealize(unsigned int skipSourceIndex, bool skipAllSources) override;
+
+        IFACEMETHOD(GetSource)(unsigned int index, IGraphicsEffectSource** source) override;
+        void SetSource(unsigned int index, IGraphicsEffectSource* source);
+
+        void SetProperty(HSTRING name, IInspectable* boxedValue);
+
+        virtual EffectAnimationTarget ResolveAnimationTarget(HSTRING propertyName) override;
+        virtual void SetAnimatedProperty(EffectAnimationTarget const& target, Numerics::Vector4 const& value) override;
+
+        void SetD2DConstants();
+        void SetD2DCoordinateMapping();
+        void SetD2DThreadMapping();
+    };
+
+}}}}}
@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "ComputeShaderEffectImpl.h"
+#include "ComputeShaderTransform.h"
+#include "PixelShaderEffectImpl.h"
+#include "SharedShaderState.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    ComputeShaderEffectImpl::ComputeShaderEffectImpl()
+        : m_constantsDirty(false)
+        , m_coordinateMapping(std::make_shared<CoordinateMappingState>())
+        , m_threadMapping(std::make_shared<ThreadMappingState>())
+    { }
+
+
+#define XML(xml) TEXT(#xml)
+
+    const wchar_t effectXml[] = XML
+    (
+        <?xml version='1.0'?>
+        <Effect>
+            <Property name='DisplayName' type='string' value='ComputeShaderEffect'/>
+            <Property name='Author'      type='string' value='Microsoft Corporation'/>
+            <Property name='Category'    type='string' value='Win2D'/>
+            <Property name='Description' type='string' value='Applies a custom compute shader.'/>
+            <Inputs minimum = '0' maximum = '8'>
+                <Input name='Source1'/>
+                <Input name='Source2'/>
+                <Input name='Source3'/>
+                <Input name='Source4'/>
+                <Input name='Source5'/>
+                <Input name='Source6'/>
+                <Input name='Source7'/>
+                <Input name='Source8'/>
+            </Inputs>
+            <Property name='SharedState' type='iunknown'>
+                <Property name='DisplayName' type='string' value='SharedState'/>
+                <Property name='Default' type='iunknown' value='null'/>
+            </Property>
+            <Property name='Constants' type='blob'>
+                <Property name='DisplayName' type='string' value='Constants'/>
+                <Property name='Default' type='blob' value=''/>
+            </Property>
+            <Property name='CoordinateMapping' type='blob'>
+                <Property name='DisplayName' type='string' value='CoordinateMapping'/>
+                <Property name='Default' type='blob' value=''/>
+            </Property>
+            <Property name='ThreadMapping' type='blob'>
+                <Property name='DisplayName' type='string' value='ThreadMapping'/>
+                <Property name='Default' type='blob' value=''/>
+            </Property>
+        </Effect>
+    );
+
+
+    static HRESULT STDMETHODCALLTYPE ComputeShaderEffectImplFactory(IUnknown** result)
+    {
+        return ExceptionBoundary([&]
+        {
+            auto effect = Make<ComputeShaderEffectImpl>();
+            CheckMakeResult(effect);
+
+            ThrowIfFailed(effect.CopyTo(result));
+        });
+    }
+
+
+    void ComputeShaderEffectImpl::Register(ID2D1Factory1* factory)
+    {
+        if (IsEffectRegistered(factory, CLSID_ComputeShaderEffect))
+            return;
+
+        static const D2D1_PROPERTY_BINDING bindings[] =
+        {
+            D2D1_VALUE_TYPE_BINDING(L"SharedState",       &SetSharedStateProperty,       &GetSharedStateProperty),
+            D2D1_BLOB_TYPE_BINDING (L"Constants",         &SetConstantsProperty,         &GetConstantsProperty),
+            D2D1_BLOB_TYPE_BINDING (L"CoordinateMapping", &SetCoordinateMappingProperty, &GetCoordinateMappingProperty),
+            D2D1_BLOB_TYPE_BINDING (L"ThreadMapping",     &SetThreadMappingProperty,     &GetThreadMappingProperty),
+        };
+
+        ThrowIfFailed(factory->RegisterEffectFromString(CLSID_ComputeShaderEffect, effectXml, bindings, _countof(bindings), ComputeShaderEffectImplFactory));
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffectImpl::Initialize(ID2D1EffectContext* effectContext, ID2D1TransformGraph* transformGraph)
+    {
+        m_effectContext = effectContext;
+        m_transformGraph = transformGraph;
+
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffectImpl::SetGraph(ID2D1TransformGraph* transformGraph)
+    {
+        // Our input count is write-once - we don't support changing the graph after it has been configured.
+        if (m_shaderTransform)
+            return E_FAIL;
+
+        m_transformGraph = transformGraph;
+
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP ComputeShaderEffectImpl::PrepareForRender(D2D1_CHANGE_TYPE)
+    {
+        return ExceptionBoundary([&]
+        {
+            // One-time initialize.
+            if (!m_shaderTransform)
+            {
+                PrepareForFirstDraw();
+            }
+
+            // Update D2D with our latest shader constants.
+            if (m_constantsDirty)
+            {
+                m_shaderTransform->SetConstants(m_constants);
+                m_constantsDirty = false;
+            }
+        });
+    }
+
+
+    void ComputeShaderEffectImpl::PrepareForFirstDraw()
+    {
+        // Shared state must be set before the effect can be drawn.
+        if (!m_sharedState)
+            ThrowHR(E_FAIL);
+
+        // Load our compute shader into D2D.
+        auto& shader = m_sharedState->Shader();
+
+        HRESULT hr = m_effectContext->LoadComputeShader(shader.Hash, shader.Code.data(), static_cast<UINT32>(shader.Code.size()));
+
+        if (FAILED(hr))
+            ThrowHR(hr, Strings::ComputeEffectBadShader);
+
+        // There are no border transforms, so all the effect inputs connect straight to the shader,
+        // which is also the effect output. Adding it to the graph calls SetComputeInfo.
+        m_shaderTransform = Make<ComputeShaderTransform>(m_sharedState.Get(), m_coordinateMapping, m_threadMapping);
+        CheckMakeResult(m_shaderTransform);
+
+        ThrowIfFailed(m_transformGraph->SetSingleTransformNode(As<ID2D1TransformNode>(m_shaderTransform).Get()));
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::SetSharedStateProperty(IUnknown* sharedState)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckInPointer(sharedState);
+
+            // Shared state is a write-once property.
+            if (m_sharedState)
+                ThrowHR(E_FAIL);
+
+            m_sharedState = As<ISharedShaderState>(sharedState);
+        });
+    }
+
+
+    IUnknown* ComputeShaderEffectImpl::GetSharedStateProperty() const
+    {
+        return m_sharedState ? As<IUnknown>(m_sharedState).Detach() : nullptr;
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::SetConstantsProperty(BYTE const* data, UINT32 dataSize)
+    {
+        return ExceptionBoundary([&]
+        {
+            // Only re-upload the constant buffer if its contents actually changed.
+            if (m_constants.size() == dataSize && std::equal(data, data + dataSize, m_constants.begin()))
+                return;
+
+            m_constants.assign(data, data + dataSize);
+            m_constantsDirty = true;
+        });
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::GetConstantsProperty(BYTE* data, UINT32 dataSize, UINT32 *actualSize) const
+    {
+        if (actualSize)
+            *actualSize = static_cast<UINT32>(m_constants.size());
+
+        if (data)
+            memcpy(data, m_constants.data(), std::min<size_t>(dataSize, m_constants.size()));
+
+        return S_OK;
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::SetCoordinateMappingProperty(BYTE const* data, UINT32 dataSize)
+    {
+        if (dataSize != sizeof(CoordinateMappingState))
+            return E_NOT_SUFFICIENT_BUFFER;
+
+        *m_coordinateMapping = *reinterpret_cast<CoordinateMappingState const*>(data);
+
+        return S_OK;
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::GetCoordinateMappingProperty(BYTE* data, UINT32 dataSize, UINT32 *actualSize) const
+    {
+        if (actualSize)
+            *actualSize = sizeof(CoordinateMappingState);
+
+        if (data)
+        {
+            if (dataSize != sizeof(CoordinateMappingState))
+                return E_NOT_SUFFICIENT_BUFFER;
+
+            *reinterpret_cast<CoordinateMappingState*>(data) = *m_coordinateMapping;
+        }
+
+        return S_OK;
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::SetThreadMappingProperty(BYTE const* data, UINT32 dataSize)
+    {
+        if (dataSize != sizeof(ThreadMappingState))
+            return E_NOT_SUFFICIENT_BUFFER;
+
+        auto newMapping = reinterpret_cast<ThreadMappingState const*>(data);
+
+        if (!newMapping->PixelsPerThread.Width || !newMapping->PixelsPerThread.Height)
+            return E_INVALIDARG;
+
+        *m_threadMapping = *newMapping;
+
+        return S_OK;
+    }
+
+
+    HRESULT ComputeShaderEffectImpl::GetThreadMappingProperty(BYTE* data, UINT32 dataSize, UINT32 *actualSize) const
+    {
+        if (actualSize)
+            *actualSize = sizeof(ThreadMappingState);
+
+        if (data)
+        {
+            if (dataSize != sizeof(ThreadMappingState))
+                return E_NOT_SUFFICIENT_BUFFER;
+
+            *reinterpret_cast<ThreadMappingState*>(data) = *m_threadMapping;
+        }
+
+        return S_OK;
+    }
+
+}}}}}
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
+{
+    class ISharedShaderState;
+    class ComputeShaderTransform;
+    struct CoordinateMappingState;
+    struct ThreadMappingState;
+
+    DEFINE_GUID(CLSID_ComputeShaderEffect, 0x3bf2509b, 0xbaf7, 0x45da, 0x8b, 0xee, 0xa7, 0xef, 0xb5, 0x21, 0x2d, 0x18);
+
+
+    // Our custom Direct2D compute effect.
+    class ComputeShaderEffectImpl : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1EffectImpl>
+                                  , private LifespanTracker<ComputeShaderEffectImpl>
+    {
+        ComPtr<ISharedShaderState> m_sharedState;
+        ComPtr<ComputeShaderTransform> m_shaderTransform;
+        ComPtr<ID2D1EffectContext> m_effectContext;
+        ComPtr<ID2D1TransformGraph> m_transformGraph;
+
+        std::vector<BYTE> m_constants;
+        bool m_constantsDirty;
+
+        std::shared_ptr<CoordinateMappingState> m_coordinateMapping;
+        std::shared_ptr<ThreadMappingState> m_threadMapping;
+
+    public:
+        ComputeShaderEffectImpl();
+
+        static void Register(ID2D1Factory1* factory);
+
+        IFACEMETHOD(Initialize)(ID2D1EffectContext* effectContext, ID2D1TransformGraph* transformGraph) override;
+        IFACEMETHOD(SetGraph)(ID2D1TransformGraph* transformGraph) override;
+        IFACEMETHOD(PrepareForRender)(D2D1_CHANGE_TYPE changeType) override;
+
+    private:
+        void PrepareForFirstDraw();
+
+        HRESULT SetSharedStateProperty(IUnknown* sharedState);
+        IUnknown* GetSharedStateProperty() const;
+
+        HRESULT SetConstantsProperty(BYTE const* data, UINT32 dataSize);
+        HRESULT GetConstantsProperty(BYTE* data, UINT32 dataSize, UINT32 *actualSize) const;
+
+        HRESULT SetCoordinateMappingProperty(BYTE const* data, UINT32 dataSize);
+        HRESULT GetCoordinateMappingProperty(BYTE* data, UINT32 dataSize, UINT32 *actualSize) const;
+
+        HRESULT SetThreadMappingProperty(BYTE const* data, UINT32 dataSize);
+        HRESULT GetThreadMappingProperty(BYTE* data, UINT32 dataSize, UINT32 *actualSize) const;
+    };
+
+
+    // Direct2D effect property indices (must match effectXml from ComputeShaderEffectImpl.cpp).
+    enum class ComputeShaderEffectProperty
+    {
+        SharedState,
+        Constants,
+        CoordinateMapping,
+        ThreadMapping,
+    };
+
+}}}}}
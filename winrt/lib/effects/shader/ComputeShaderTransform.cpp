@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "ComputeShaderTransform.h"
+#include "ClipTransform.h"
+#include "SharedShaderState.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    ComputeShaderTransform::ComputeShaderTransform(ISharedShaderState* sharedState, std::shared_ptr<CoordinateMappingState> const& coordinateMapping, std::shared_ptr<ThreadMappingState> const& threadMapping)
+        : m_sharedState(sharedState)
+        , m_coordinateMapping(coordinateMapping)
+        , m_threadMapping(threadMapping)
+    { }
+
+
+    IFACEMETHODIMP_(UINT32) ComputeShaderTransform::GetInputCount() const
+    {
+        return m_sharedState->Shader().InputCount;
+    }
+
+
+    IFACEMETHODIMP ComputeShaderTransform::MapInputRectsToOutputRect(D2D1_RECT_L const* inputRects, D2D1_RECT_L const* inputOpaqueSubRects, UINT32 inputRectCount, D2D1_RECT_L* outputRect, D2D1_RECT_L* outputOpaqueSubRect)
+    {
+        UNREFERENCED_PARAMETER(inputOpaqueSubRects);
+
+        return ExceptionBoundary([&]
+        {
+            // Remember the source bounds, so MapOutputRectToInputRects can ask for
+            // all of any source whose coordinate mapping is unknown.
+            m_sourceBounds.assign(inputRects, inputRects + inputRectCount);
+
+            *outputRect = ClipTransform::CalculateOutputRect(*m_coordinateMapping, inputRects, inputRectCount);
+
+            // We don't know how this shader handles opacity, so always just report an empty opaque subrect.
+            *outputOpaqueSubRect = D2D1_RECT_L{ 0, 0, 0, 0 };
+        });
+    }
+
+
+    IFACEMETHODIMP ComputeShaderTransform::MapOutputRectToInputRects(D2D1_RECT_L const* outputRect, D2D1_RECT_L* inputRects, UINT32 inputRectsCount) const
+    {
+        return ExceptionBoundary([&]
+        {
+            for (unsigned i = 0; i < inputRectsCount; i++)
+            {
+                switch (m_coordinateMapping->Mapping[i])
+                {
+                case SamplerCoordinateMapping::Unknown:
+                    // Due to unknown coordinate mapping, we must request the whole of this input.
+                    if (i < m_sourceBounds.size())
+                        inputRects[i] = m_sourceBounds[i];
+                    else
+                        inputRects[i] = D2D_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+                    break;
+
+                case SamplerCoordinateMapping::OneToOne:
+                    // This output rectangle maps directly to the input.
+                    inputRects[i] = *outputRect;
+                    break;
+
+                case SamplerCoordinateMapping::Offset:
+                    // This rectangle must be expanded due to the use of offset texture coordinates.
+                    inputRects[i] = ExpandRectangle(*outputRect, m_coordinateMapping->MaxOffset);
+                    break;
+
+                case SamplerCoordinateMapping::Transformed:
+                    // This output rectangle maps through the transform, plus a pixel for filtering.
+                    inputRects[i] = ExpandRectangle(TransformRectangle(*outputRect, m_coordinateMapping->Transform[i]), 1 + m_coordinateMapping->MaxOffset);
+                    break;
+
+                default:
+                    ThrowHR(E_INVALIDARG);
+                }
+            }
+
+            m_sourceRects.assign(inputRects, inputRects + inputRectsCount);
+        });
+    }
+
+
+    IFACEMETHODIMP ComputeShaderTransform::MapInvalidRect(UINT32 inputIndex, D2D1_RECT_L invalidInputRect, D2D1_RECT_L* invalidOutputRect) const
+    {
+        UNREFERENCED_PARAMETER(inputIndex);
+        UNREFERENCED_PARAMETER(invalidInputRect);
+
+        // Mark the entire output as invalid.
+        *invalidOutputRect = D2D_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP ComputeShaderTransform::SetComputeInfo(ID2D1ComputeInfo* computeInfo)
+    {
+        return ExceptionBoundary([&]
+        {
+            m_computeInfo = computeInfo;
+
+            // Tell D2D to use our compute shader.
+            ThrowIfFailed(computeInfo->SetComputeShader(m_sharedState->Shader().Hash));
+        });
+    }
+
+
+    static UINT32 GetThreadGroupCount(LONG start, LONG end, unsigned threadsPerGroup, unsigned pixelsPerThread)
+    {
+        if (end <= start)
+            return 0;
+
+        auto pixelCount = static_cast<uint64_t>(static_cast<int64_t>(end) - start);
+        auto pixelsPerGroup = static_cast<uint64_t>(threadsPerGroup) * pixelsPerThread;
+
+        auto groupCount = (pixelCount + pixelsPerGroup - 1) / pixelsPerGroup;
+
+        if (groupCount > D3D11_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION)
+            ThrowHR(E_INVALIDARG);
+
+        return static_cast<UINT32>(groupCount);
+    }
+
+
+    IFACEMETHODIMP ComputeShaderTransform::CalculateThreadgroups(D2D1_RECT_L const* outputRect, UINT32* dimensionX, UINT32* dimensionY, UINT32* dimensionZ)
+    {
+        return ExceptionBoundary([&]
+        {
+            auto& shader = m_sharedState->Shader();
+            auto& pixelsPerThread = m_threadMapping->PixelsPerThread;
+
+            // Each thread group covers its [numthreads] size times PixelsPerThread output pixels.
+            // Z is left to the shader, for example to split the work for each pixel between threads.
+            *dimensionX = GetThreadGroupCount(outputRect->left, outputRect->right, shader.ThreadGroupSize[0], pixelsPerThread.Width);
+            *dimensionY = GetThreadGroupCount(outputRect->top, outputRect->bottom, shader.ThreadGroupSize[1], pixelsPerThread.Height);
+            *dimensionZ = 1;
+
+            // Tell the shader which part of the output this dispatch is for, and where its
+            // sources are. The constant buffer may be updated here, before D2D dispatches.
+            if (HasReservedConstants())
+            {
+                WriteRect(shader.OutputRectOffset, *outputRect);
+
+                auto sourceCount = std::min<size_t>(shader.SourceRectsCount, m_sourceRects.size());
+
+                for (unsigned i = 0; i < sourceCount; i++)
+                {
+                    WriteRect(shader.SourceRectsOffset + static_cast<int>(i * sizeof(int32_t[4])), m_sourceRects[i]);
+                }
+
+                if (m_computeInfo)
+                {
+                    ThrowIfFailed(m_computeInfo->SetComputeShaderConstantBuffer(m_constants.data(), static_cast<UINT32>(m_constants.size())));
+                }
+            }
+        });
+    }
+
+
+    void ComputeShaderTransform::SetConstants(std::vector<BYTE> const& constants)
+    {
+        m_constants = constants;
+
+        if (m_computeInfo)
+        {
+            ThrowIfFailed(m_computeInfo->SetComputeShaderConstantBuffer(m_constants.data(), static_cast<UINT32>(m_constants.size())));
+        }
+    }
+
+
+    bool ComputeShaderTransform::HasReservedConstants() const
+    {
+        auto& shader = m_sharedState->Shader();
+
+        return shader.OutputRectOffset >= 0 || shader.SourceRectsOffset >= 0;
+    }
+
+
+    void ComputeShaderTransform::WriteRect(int offset, D2D1_RECT_L const& rect)
+    {
+        int32_t value[4] = { rect.left, rect.top, rect.right, rect.bottom };
+
+        if (offset < 0 || offset + sizeof(value) > m_constants.size())
+            return;
+
+        memcpy(m_constants.data() + offset, value, sizeof(value));
+    }
+
+}}}}}
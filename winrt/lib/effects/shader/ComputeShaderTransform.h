@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
+{
+    class ISharedShaderState;
+    struct CoordinateMappingState;
+    struct ThreadMappingState;
+
+
+    // Custom Direct2D compute transform runs our compute shader. Unlike PixelShaderTransform,
+    // this works out its own output rect (there are no border transforms to clip away), and
+    // chooses how many thread groups to dispatch to cover it.
+    class ComputeShaderTransform : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1ComputeTransform, ID2D1Transform, ID2D1TransformNode>
+                                 , private LifespanTracker<ComputeShaderTransform>
+    {
+        ComPtr<ISharedShaderState> m_sharedState;
+        std::shared_ptr<CoordinateMappingState> m_coordinateMapping;
+        std::shared_ptr<ThreadMappingState> m_threadMapping;
+        ComPtr<ID2D1ComputeInfo> m_computeInfo;
+
+        std::vector<BYTE> m_constants;
+
+        // Bounds of each source, as passed to MapInputRectsToOutputRect.
+        std::vector<D2D1_RECT_L> m_sourceBounds;
+
+        // The parts of each source requested by the most recent MapOutputRectToInputRects,
+        // which D2D calls before the CalculateThreadgroups for the same output rect.
+        mutable std::vector<D2D1_RECT_L> m_sourceRects;
+
+    public:
+        ComputeShaderTransform(ISharedShaderState* sharedState, std::shared_ptr<CoordinateMappingState> const& coordinateMapping, std::shared_ptr<ThreadMappingState> const& threadMapping);
+
+        IFACEMETHOD_(UINT32, GetInputCount)() const override;
+
+        IFACEMETHOD(MapInputRectsToOutputRect)(D2D1_RECT_L const* inputRects, D2D1_RECT_L const* inputOpaqueSubRects, UINT32 inputRectCount, D2D1_RECT_L* outputRect, D2D1_RECT_L* outputOpaqueSubRect) override;
+        IFACEMETHOD(MapOutputRectToInputRects)(D2D1_RECT_L const* outputRect, D2D1_RECT_L* inputRects, UINT32 inputRectsCount) const override;
+        IFACEMETHOD(MapInvalidRect)(UINT32 inputIndex, D2D1_RECT_L invalidInputRect, D2D1_RECT_L* invalidOutputRect) const override;
+
+        IFACEMETHOD(SetComputeInfo)(ID2D1ComputeInfo* computeInfo) override;
+        IFACEMETHOD(CalculateThreadgroups)(D2D1_RECT_L const* outputRect, UINT32* dimensionX, UINT32* dimensionY, UINT32* dimensionZ) override;
+
+        void SetConstants(std::vector<BYTE> const& constants);
+
+    private:
+        bool HasReservedConstants() const;
+        void WriteRect(int offset, D2D1_RECT_L const& rect);
+    };
+
+}}}}}
@@ -32,6 +32,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
+    IFACEMETHODIMP PixelShaderEffectFactory::PreloadShader(uint32_t shaderCodeCount, BYTE* shaderCode)
+    {
+        return ExceptionBoundary([&]
+        {
+            CheckInPointer(shaderCode);
+
+            SharedShaderState::Preload(shaderCode, shaderCodeCount);
+        });
+    }
+
+
     // Describe how to implement WinRT IMap<> methods in terms of our shader constant buffer.
     template<typename TKey, typename TValue>
     struct PixelShaderEffectPropertyMapTraits
@@ -123,27 +134,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     IMPLEMENT_EFFECT_SOURCE_PROPERTY(PixelShaderEffect, Source8, 7)
 
     
-#define IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PROPERTY, INDEX)                          \
-                                                                                        \
-    IFACEMETHODIMP PixelShaderEffect::get_##PROPERTY(SamplerCoordinateMapping* value)   \
-    {                                                                                   \
-        return GetCoordinateMapping(INDEX, value);                                      \
-    }                                                                                   \
-                                                                                        \
-    IFACEMETHODIMP PixelShaderEffect::put_##PROPERTY(SamplerCoordinateMapping value)    \
-    {                                                                                   \
-        return SetCoordinateMapping(INDEX, value);                                      \
-    }
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source1Mapping, 0)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source2Mapping, 1)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source3Mapping, 2)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source4Mapping, 3)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source5Mapping, 4)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source6Mapping, 5)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source7Mapping, 6)
+    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(PixelShaderEffect, Source8Mapping, 7)
 
 
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source1Mapping, 0)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source2Mapping, 1)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source3Mapping, 2)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source4Mapping, 3)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source5Mapping, 4)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source6Mapping, 5)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source7Mapping, 6)
-    IMPLEMENT_COORDINATE_MAPPING_PROPERTY(Source8Mapping, 7)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source1MappingTransform, 0)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source2MappingTransform, 1)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source3MappingTransform, 2)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source4MappingTransform, 3)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source5MappingTransform, 4)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source6MappingTransform, 5)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source7MappingTransform, 6)
+    IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(PixelShaderEffect, Source8MappingTransform, 7)
+
+
+    IMPLEMENT_MAX_SAMPLER_OFFSET_PROPERTY(PixelShaderEffect)
 
 
 #define IMPLEMENT_BORDER_MODE_PROPERTY(PROPERTY, INDEX)                                 \
@@ -303,96 +314,120 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         auto lock = Lock(m_mutex);
 
         // Store the new property value into our shared state object.
-        m_sharedState->SetProperty(name, boxedValue);
+        bool changed = m_sharedState->SetProperty(name, boxedValue);
 
         // If we are realized, pass the updated constant buffer on to Direct2D.
-        SetD2DConstants();
+        // Skipping this when nothing changed avoids D2D invalidating the effect.
+        if (changed)
+        {
+            SetD2DConstants();
+        }
     }
 
 
-    HRESULT PixelShaderEffect::GetCoordinateMapping(unsigned index, SamplerCoordinateMapping* value)
+    EffectAnimationTarget PixelShaderEffect::ResolveAnimationTarget(HSTRING propertyName)
     {
-        assert(index < MaxShaderInputs);
-
-        return ExceptionBoundary([&]
         {
-            CheckInPointer(value);
+            auto lock = Lock(m_mutex);
 
-            *value = m_sharedState->CoordinateMapping().Mapping[index];
-        });
+            if (m_sharedState->HasProperty(propertyName))
+            {
+                // Shader properties are set directly in the constant buffer.
+                EffectAnimationTarget target{};
+
+                target.PropertyIndex = m_sharedState->GetAnimatableProperty(propertyName, &target.ComponentCount);
+                target.IsShaderProperty = true;
+
+                return target;
+            }
+        }
+
+        // Otherwise fall back to any D2D property mappings.
+        return CanvasEffect::ResolveAnimationTarget(propertyName);
     }
 
 
-    HRESULT PixelShaderEffect::SetCoordinateMapping(unsigned index, SamplerCoordinateMapping value)
+    void PixelShaderEffect::SetAnimatedProperty(EffectAnimationTarget const& target, Numerics::Vector4 const& value)
     {
-        assert(index < MaxShaderInputs);
-
-        return ExceptionBoundary([&]
+        if (!target.IsShaderProperty)
         {
-            auto lock = Lock(m_mutex);
+            CanvasEffect::SetAnimatedProperty(target, value);
+            return;
+        }
 
-            // Store the new value into our shared state object.
-            m_sharedState->CoordinateMapping().Mapping[index] = value;
+        float values[] = { value.X, value.Y, value.Z, value.W };
 
-            // If we are realized, pass the updated mapping state on to Direct2D.
-            SetD2DCoordinateMapping();
-        });
+        auto lock = Lock(m_mutex);
+
+        // As with SetProperty, only pass the constant buffer on to Direct2D if it changed.
+        if (m_sharedState->SetAnimatedProperty(target.PropertyIndex, values))
+        {
+            SetD2DConstants();
+        }
     }
 
 
-    HRESULT PixelShaderEffect::GetBorderMode(unsigned index, EffectBorderMode* value)
+    IFACEMETHODIMP PixelShaderEffect::SetProperties(IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* values)
     {
-        assert(index < MaxShaderInputs);
-
         return ExceptionBoundary([&]
         {
-            CheckInPointer(value);
+            CheckInPointer(values);
 
-            *value = m_sharedState->CoordinateMapping().BorderMode[index];
-        });
-    }
+            if (!m_propertyMap->InternalMap())
+                ThrowHR(RO_E_CLOSED);
 
+            // Gather up the new values.
+            std::vector<StringObjectPair> newValues;
 
-    HRESULT PixelShaderEffect::SetBorderMode(unsigned index, EffectBorderMode value)
-    {
-        assert(index < MaxShaderInputs);
+            ComPtr<IIterator<IKeyValuePair<HSTRING, IInspectable*>*>> iterator;
+            ThrowIfFailed(values->First(&iterator));
+
+            boolean hasCurrent;
+            ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+            while (hasCurrent)
+            {
+                ComPtr<IKeyValuePair<HSTRING, IInspectable*>> pair;
+                ThrowIfFailed(iterator->get_Current(&pair));
+
+                WinString name;
+                ThrowIfFailed(pair->get_Key(name.GetAddressOf()));
+
+                ComPtr<IInspectable> value;
+                ThrowIfFailed(pair->get_Value(&value));
+
+                newValues.emplace_back(name, value);
+
+                ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+            }
 
-        return ExceptionBoundary([&]
-        {
             auto lock = Lock(m_mutex);
 
-            // Store the new value into our shared state object.
-            m_sharedState->CoordinateMapping().BorderMode[index] = value;
+            // Store them all into our shared state object.
+            bool changed = m_sharedState->SetProperties(newValues);
 
-            // If we are realized, pass the updated mapping state on to Direct2D.
-            SetD2DCoordinateMapping();
+            // Pass the updated constant buffer on to Direct2D just once for the whole batch.
+            if (changed)
+            {
+                SetD2DConstants();
+            }
         });
     }
 
 
-    IFACEMETHODIMP PixelShaderEffect::get_MaxSamplerOffset(int* value)
+    HRESULT PixelShaderEffect::GetBorderMode(unsigned index, EffectBorderMode* value)
     {
-        return ExceptionBoundary([&]
-        {
-            CheckInPointer(value);
+        assert(index < MaxShaderInputs);
 
-            *value = m_sharedState->CoordinateMapping().MaxOffset;
-        });
+        return GetCoordinateMappingValue(value, [=](CoordinateMappingState& state) -> EffectBorderMode& { return state.BorderMode[index]; });
     }
 
 
-    IFACEMETHODIMP PixelShaderEffect::put_MaxSamplerOffset(int value)
+    HRESULT PixelShaderEffect::SetBorderMode(unsigned index, EffectBorderMode value)
     {
-        return ExceptionBoundary([&]
-        {
-            auto lock = Lock(m_mutex);
-
-            // Store the new value into our shared state object.
-            m_sharedState->CoordinateMapping().MaxOffset = value;
+        assert(index < MaxShaderInputs);
 
-            // If we are realized, pass the updated mapping state on to Direct2D.
-            SetD2DCoordinateMapping();
-        });
+        return SetCoordinateMappingValue(value, [=](CoordinateMappingState& state) -> EffectBorderMode& { return state.BorderMode[index]; });
     }
 
 
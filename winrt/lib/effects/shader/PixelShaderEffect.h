@@ -4,32 +4,37 @@
 
 #pragma once
 
+#include "ShaderEffectCoordinateMapping.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
 {
-    class ISharedShaderState;
-
     template<typename TKey, typename TValue> struct PixelShaderEffectPropertyMapTraits;
 
 
     // WinRT activation factory.
-    class PixelShaderEffectFactory : public AgileActivationFactory<IPixelShaderEffectFactory>
+    class PixelShaderEffectFactory : public AgileActivationFactory<IPixelShaderEffectFactory, IPixelShaderEffectStatics>
                                    , private LifespanTracker<PixelShaderEffectFactory>
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Effects_PixelShaderEffect, BaseTrust);
 
     public:
         IFACEMETHOD(Create)(uint32_t shaderCodeCount, BYTE* shaderCode, IPixelShaderEffect** effect) override;
+
+        IFACEMETHOD(PreloadShader)(uint32_t shaderCodeCount, BYTE* shaderCode) override;
     };
 
 
     // Public Win2D API surface for using custom effects.
     class PixelShaderEffect : public RuntimeClass<IPixelShaderEffect, MixIn<PixelShaderEffect, CanvasEffect>>
                             , public CanvasEffect
+                            , public ShaderEffectCoordinateMapping<PixelShaderEffect>
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Effects_PixelShaderEffect, BaseTrust);
 
         ComPtr<ISharedShaderState> m_sharedState;
 
+        friend ShaderEffectCoordinateMapping<PixelShaderEffect>;
+
         // Traits describe how to expose a view of our constant buffer as an IMap<> collection.
         friend PixelShaderEffectPropertyMapTraits<HSTRING, IInspectable*>;
         typedef Map<HSTRING, IInspectable*, PixelShaderEffectPropertyMapTraits> PropertyMap;
@@ -63,6 +68,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         EFFECT_PROPERTY(Source7Mapping, SamplerCoordinateMapping);
         EFFECT_PROPERTY(Source8Mapping, SamplerCoordinateMapping);
 
+        EFFECT_PROPERTY(Source1MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source2MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source3MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source4MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source5MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source6MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source7MappingTransform, Numerics::Matrix3x2);
+        EFFECT_PROPERTY(Source8MappingTransform, Numerics::Matrix3x2);
+
         EFFECT_PROPERTY(Source1BorderMode, EffectBorderMode);
         EFFECT_PROPERTY(Source2BorderMode, EffectBorderMode);
         EFFECT_PROPERTY(Source3BorderMode, EffectBorderMode);
@@ -85,6 +99,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         IFACEMETHOD(IsSupported)(ICanvasDevice* device, boolean* result) override;
 
+        IFACEMETHOD(SetProperties)(IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* values) override;
+
     protected:
         bool IsSupported(ICanvasDevice* device);
 
@@ -96,8 +112,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         void SetProperty(HSTRING name, IInspectable* boxedValue);
 
-        HRESULT GetCoordinateMapping(unsigned index, SamplerCoordinateMapping* value);
-        HRESULT SetCoordinateMapping(unsigned index, SamplerCoordinateMapping value);
+        virtual EffectAnimationTarget ResolveAnimationTarget(HSTRING propertyName) override;
+        virtual void SetAnimatedProperty(EffectAnimationTarget const& target, Numerics::Vector4 const& value) override;
 
         HRESULT GetBorderMode(unsigned index, EffectBorderMode* value);
         HRESULT SetBorderMode(unsigned index, EffectBorderMode value);
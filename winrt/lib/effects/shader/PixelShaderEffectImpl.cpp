@@ -71,7 +71,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    static bool IsEffectRegistered(ID2D1Factory1* factory, IID const& effectId)
+    bool IsEffectRegistered(ID2D1Factory1* factory, IID const& effectId)
     {
         // Size query.
         UINT32 returnedCount, registeredCount;
@@ -184,10 +184,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     void PixelShaderEffectImpl::ConfigureTransformGraph()
     {
+        auto shaderTransform = As<ID2D1TransformNode>(m_shaderTransform);
+
+        // D2D can only link our shader with neighboring effects if it is the sole node
+        // in our graph, so when there are no border transforms, skip the clip node and
+        // let the shader transform compute the output rect itself.
+        if (CanUseSingleNodeGraph())
+        {
+            m_shaderTransform->SetIsOutputNode(true);
+            ThrowIfFailed(m_transformGraph->SetSingleTransformNode(shaderTransform.Get()));
+            return;
+        }
+
+        m_shaderTransform->SetIsOutputNode(false);
         m_transformGraph->Clear();
 
         // Add our pixel shader and clip nodes.
-        auto shaderTransform = As<ID2D1TransformNode>(m_shaderTransform);
         auto clipTransform = As<ID2D1TransformNode>(m_clipTransform);
 
         ThrowIfFailed(m_transformGraph->AddNode(shaderTransform.Get()));
@@ -231,6 +243,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
+    bool PixelShaderEffectImpl::CanUseSingleNodeGraph() const
+    {
+        auto& shader = m_sharedState->Shader();
+
+        if (!shader.SupportsLinking)
+            return false;
+
+        for (unsigned i = 0; i < shader.InputCount; i++)
+        {
+            if (m_coordinateMapping->BorderMode[i] != EffectBorderMode::Soft)
+                return false;
+        }
+
+        return true;
+    }
+
+
     HRESULT PixelShaderEffectImpl::SetSharedStateProperty(IUnknown* sharedState)
     {
         return ExceptionBoundary([&]
@@ -256,6 +285,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         return ExceptionBoundary([&]
         {
+            // Only re-upload the constant buffer if its contents actually changed.
+            if (m_constants.size() == dataSize && std::equal(data, data + dataSize, m_constants.begin()))
+                return;
+
             m_constants.assign(data, data + dataSize);
             m_constantsDirty = true;
         });
@@ -47,6 +47,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     private:
         void PrepareForFirstDraw();
         void ConfigureTransformGraph();
+        bool CanUseSingleNodeGraph() const;
 
         HRESULT SetSharedStateProperty(IUnknown* sharedState);
         IUnknown* GetSharedStateProperty() const;
@@ -62,6 +63,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     };
 
 
+    // Also used by ComputeShaderEffectImpl.
+    bool IsEffectRegistered(ID2D1Factory1* factory, IID const& effectId);
+
+
     // Direct2D effect property indices (must match effectXml from PixelShaderEffectImpl.cpp).
     enum class PixelShaderEffectProperty
     {
@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include "PixelShaderTransform.h"
+#include "ClipTransform.h"
 #include "SharedShaderState.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
@@ -11,6 +12,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     PixelShaderTransform::PixelShaderTransform(ISharedShaderState* sharedState, std::shared_ptr<CoordinateMappingState> const& coordinateMapping)
         : m_sharedState(sharedState)
         , m_coordinateMapping(coordinateMapping)
+        , m_isOutputNode(false)
     { }
 
 
@@ -22,15 +24,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     IFACEMETHODIMP PixelShaderTransform::MapInputRectsToOutputRect(D2D1_RECT_L const* inputRects, D2D1_RECT_L const* inputOpaqueSubRects, UINT32 inputRectCount, D2D1_RECT_L* outputRect, D2D1_RECT_L* outputOpaqueSubRect)
     {
-        UNREFERENCED_PARAMETER(inputRects);
         UNREFERENCED_PARAMETER(inputOpaqueSubRects);
-        UNREFERENCED_PARAMETER(inputRectCount);
 
-        // The proper output rect calculation is carried out by ClipTransform, which is inserted after the PixelShaderTransform.
-        *outputRect = D2D1_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX };
-        *outputOpaqueSubRect = D2D1_RECT_L{ 0, 0, 0, 0 };
+        return ExceptionBoundary([&]
+        {
+            if (m_isOutputNode)
+            {
+                // There are no border transforms in front of us, so our inputs are the original source rects.
+                *outputRect = ClipTransform::CalculateOutputRect(*m_coordinateMapping, inputRects, inputRectCount);
+            }
+            else
+            {
+                // The proper output rect calculation is carried out by ClipTransform, which is inserted after the PixelShaderTransform.
+                *outputRect = D2D1_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+            }
 
-        return S_OK;
+            *outputOpaqueSubRect = D2D1_RECT_L{ 0, 0, 0, 0 };
+        });
     }
 
 
@@ -57,6 +67,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                     inputRects[i] = ExpandRectangle(*outputRect, m_coordinateMapping->MaxOffset);
                     break;
 
+                case SamplerCoordinateMapping::Transformed:
+                    // This output rectangle maps through the transform, plus a pixel for filtering.
+                    inputRects[i] = ExpandRectangle(TransformRectangle(*outputRect, m_coordinateMapping->Transform[i]), 1 + m_coordinateMapping->MaxOffset);
+                    break;
+
                 default:
                     ThrowHR(E_INVALIDARG);
                 }
@@ -109,4 +124,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
     }
 
+
+    void PixelShaderTransform::SetIsOutputNode(bool isOutputNode)
+    {
+        m_isOutputNode = isOutputNode;
+    }
+
 }}}}}
@@ -18,6 +18,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<ISharedShaderState> m_sharedState;
         std::shared_ptr<CoordinateMappingState> m_coordinateMapping;
         ComPtr<ID2D1DrawInfo> m_drawInfo;
+        bool m_isOutputNode;
 
     public:
         PixelShaderTransform(ISharedShaderState* sharedState, std::shared_ptr<CoordinateMappingState> const& coordinateMapping);
@@ -32,6 +33,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         void SetConstants(std::vector<BYTE> const& constants);
         void SetSourceInterpolation(SourceInterpolationState const* sourceInterpolation);
+
+        // When there is no ClipTransform after us, we must work out the output rect ourselves.
+        void SetIsOutputNode(bool isOutputNode);
     };
 
 }}}}}
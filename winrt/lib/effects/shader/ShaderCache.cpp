@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "ShaderCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    ShaderCache& ShaderCache::GetInstance()
+    {
+        static ShaderCache instance;
+
+        return instance;
+    }
+
+
+    ShaderCache::ShaderCache()
+        : m_clock(0)
+    { }
+
+
+    bool ShaderCache::TryLookup(IID const& hash, BYTE const* shaderCode, uint32_t shaderCodeSize, Entry* result)
+    {
+        Lock lock(m_mutex);
+
+        auto it = Find(hash, shaderCode, shaderCodeSize);
+
+        if (it == m_shaders.end())
+            return false;
+
+        it->LastUsed = ++m_clock;
+
+        *result = it->Value;
+
+        return true;
+    }
+
+
+    void ShaderCache::Add(Entry const& entry, bool isPreloaded)
+    {
+        auto& code = entry.Shader->Code;
+
+        Lock lock(m_mutex);
+
+        auto it = Find(entry.Shader->Hash, code.data(), static_cast<uint32_t>(code.size()));
+
+        if (it != m_shaders.end())
+        {
+            it->IsPreloaded |= isPreloaded;
+            it->LastUsed = ++m_clock;
+            return;
+        }
+
+        if (!isPreloaded)
+        {
+            EvictLeastRecentlyUsed();
+        }
+
+        m_shaders.push_back(CachedShader{ entry, isPreloaded, ++m_clock });
+    }
+
+
+    std::vector<ShaderCache::CachedShader>::iterator ShaderCache::Find(IID const& hash, BYTE const* shaderCode, uint32_t shaderCodeSize)
+    {
+        return std::find_if(m_shaders.begin(), m_shaders.end(),
+            [&](CachedShader const& cached)
+            {
+                auto& cachedCode = cached.Value.Shader->Code;
+
+                return cached.Value.Shader->Hash == hash &&
+                       cachedCode.size() == shaderCodeSize &&
+                       memcmp(cachedCode.data(), shaderCode, shaderCodeSize) == 0;
+            });
+    }
+
+
+    void ShaderCache::EvictLeastRecentlyUsed()
+    {
+        auto unpreloadedCount = std::count_if(m_shaders.begin(), m_shaders.end(), [](CachedShader const& cached) { return !cached.IsPreloaded; });
+
+        if (static_cast<size_t>(unpreloadedCount) < MaxShaders)
+            return;
+
+        auto victim = m_shaders.end();
+
+        for (auto it = m_shaders.begin(); it != m_shaders.end(); ++it)
+        {
+            if (!it->IsPreloaded && (victim == m_shaders.end() || it->LastUsed < victim->LastUsed))
+            {
+                victim = it;
+            }
+        }
+
+        m_shaders.erase(victim);
+    }
+
+
+}}}}}
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "SharedShaderState.h"
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    // Process-wide cache of everything SharedShaderState works out from a compiled shader:
+    // the metadata obtained by shader reflection, and the initial values of its constant
+    // buffer and coordinate mapping. Creating any number of PixelShaderEffect instances
+    // from the same shader code then only pays for that once.
+    //
+    // Entries are looked up by ShaderDescription::Hash, and confirmed by comparing the
+    // shader code itself. The most recently used MaxShaders are kept, on top of any that were
+    // explicitly preloaded, which stay for the lifetime of the process.
+
+    class ShaderCache
+    {
+    public:
+        struct Entry
+        {
+            std::shared_ptr<ShaderDescription const> Shader;
+            std::vector<BYTE> DefaultConstants;
+            CoordinateMappingState DefaultCoordinateMapping;
+        };
+
+        static const size_t MaxShaders = 64;
+
+        static ShaderCache& GetInstance();
+
+        bool TryLookup(IID const& hash, BYTE const* shaderCode, uint32_t shaderCodeSize, Entry* result);
+
+        // Adding a shader that is already cached just updates whether it is preloaded.
+        void Add(Entry const& entry, bool isPreloaded = false);
+
+    private:
+        struct CachedShader
+        {
+            Entry Value;
+            bool IsPreloaded;
+            uint64_t LastUsed;
+        };
+
+        std::mutex m_mutex;
+        std::vector<CachedShader> m_shaders;
+        uint64_t m_clock;
+
+        ShaderCache();
+
+        std::vector<CachedShader>::iterator Find(IID const& hash, BYTE const* shaderCode, uint32_t shaderCodeSize);
+        void EvictLeastRecentlyUsed();
+    };
+
+}}}}}
@@ -76,20 +76,42 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             , InputCount(0)
             , InstructionCount(0)
             , MinFeatureLevel(static_cast<D3D_FEATURE_LEVEL>(0))
+            , SupportsLinking(false)
+            , Type(D3D11_SHVER_PIXEL_SHADER)
+            , ThreadGroupSize{ 1, 1, 1 }
+            , OutputRectOffset(-1)
+            , SourceRectsOffset(-1)
+            , SourceRectsCount(0)
         { }
 
 
         std::vector<BYTE> Code;
 
-        // Generated from the shader code following RFC 4122 section 4.3 (version 5 UUID).
+        // Generated from the shader code by GetFastUuid. Only stable within a single process.
         IID Hash;
 
         unsigned InputCount;
         unsigned InstructionCount;
         D3D_FEATURE_LEVEL MinFeatureLevel;
 
+        // True if the shader code includes an export function (compiled with D2D_FUNCTION and
+        // attached via /setprivate), which lets D2D link it into neighboring effects.
+        bool SupportsLinking;
+
         // Sorted by name.
         std::vector<ShaderVariable> Variables;
+
+        // D3D11_SHVER_PIXEL_SHADER for PixelShaderEffect, or D3D11_SHVER_COMPUTE_SHADER for ComputeShaderEffect.
+        D3D11_SHADER_VERSION_TYPE Type;
+
+        // Compute shaders only. The [numthreads] size declared by the shader, plus where in the
+        // constant buffer it declares the Win2DOutputRect and Win2DSourceRects variables
+        // (offset -1 if not). These are filled in by ComputeShaderTransform for each
+        // dispatch, so are not included in Variables.
+        unsigned ThreadGroupSize[3];
+        int OutputRectOffset;
+        int SourceRectsOffset;
+        unsigned SourceRectsCount;
     };
 
 }}}}}
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "SharedShaderState.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    // The Source*Mapping, Source*MappingTransform and MaxSamplerOffset properties
+    // of PixelShaderEffect and ComputeShaderEffect. Both store them in the
+    // CoordinateMappingState of their ISharedShaderState, and pass the whole of
+    // it on to Direct2D whenever one changes.
+    //
+    // TEffect must make this a friend, and provide m_sharedState and
+    // SetD2DCoordinateMapping, along with the CanvasEffect lock and
+    // InvalidateCachedImageBounds.
+    template<typename TEffect>
+    class ShaderEffectCoordinateMapping
+    {
+    protected:
+        HRESULT GetCoordinateMapping(unsigned index, SamplerCoordinateMapping* value)
+        {
+            assert(index < MaxShaderInputs);
+
+            return GetCoordinateMappingValue(value, [=](CoordinateMappingState& state) -> SamplerCoordinateMapping& { return state.Mapping[index]; });
+        }
+
+        HRESULT SetCoordinateMapping(unsigned index, SamplerCoordinateMapping value)
+        {
+            assert(index < MaxShaderInputs);
+
+            return SetCoordinateMappingValue(value, [=](CoordinateMappingState& state) -> SamplerCoordinateMapping& { return state.Mapping[index]; });
+        }
+
+        HRESULT GetMappingTransform(unsigned index, Numerics::Matrix3x2* value)
+        {
+            assert(index < MaxShaderInputs);
+
+            return GetCoordinateMappingValue(value, [=](CoordinateMappingState& state) -> Numerics::Matrix3x2& { return state.Transform[index]; });
+        }
+
+        HRESULT SetMappingTransform(unsigned index, Numerics::Matrix3x2 const& value)
+        {
+            assert(index < MaxShaderInputs);
+
+            return SetCoordinateMappingValue(value, [=](CoordinateMappingState& state) -> Numerics::Matrix3x2& { return state.Transform[index]; });
+        }
+
+        HRESULT GetMaxSamplerOffset(int* value)
+        {
+            return GetCoordinateMappingValue(value, [](CoordinateMappingState& state) -> int& { return state.MaxOffset; });
+        }
+
+        HRESULT SetMaxSamplerOffset(int value)
+        {
+            return SetCoordinateMappingValue(value, [](CoordinateMappingState& state) -> int& { return state.MaxOffset; });
+        }
+
+        // Reads the field of the shared coordinate mapping state that selectField returns.
+        template<typename T, typename TSelectField>
+        HRESULT GetCoordinateMappingValue(T* value, TSelectField&& selectField)
+        {
+            return ExceptionBoundary([&]
+            {
+                CheckInPointer(value);
+
+                *value = selectField(Effect()->m_sharedState->CoordinateMapping());
+            });
+        }
+
+        // Writes the field of the shared coordinate mapping state that selectField returns.
+        template<typename T, typename TSelectField>
+        HRESULT SetCoordinateMappingValue(T const& value, TSelectField&& selectField)
+        {
+            return ExceptionBoundary([&]
+            {
+                auto effect = Effect();
+                auto lock = Lock(effect->m_mutex);
+
+                // Store the new value into our shared state object.
+                selectField(effect->m_sharedState->CoordinateMapping()) = value;
+
+                // Coordinate mapping determines the bounds of the effect.
+                effect->InvalidateCachedImageBounds();
+
+                // If we are realized, pass the updated mapping state on to Direct2D.
+                effect->SetD2DCoordinateMapping();
+            });
+        }
+
+    private:
+        TEffect* Effect()
+        {
+            return static_cast<TEffect*>(this);
+        }
+    };
+
+
+#define IMPLEMENT_COORDINATE_MAPPING_PROPERTY(CLASS, PROPERTY, INDEX)                   \
+                                                                                        \
+    IFACEMETHODIMP CLASS::get_##PROPERTY(SamplerCoordinateMapping* value)               \
+    {                                                                                   \
+        return GetCoordinateMapping(INDEX, value);                                      \
+    }                                                                                   \
+                                                                                        \
+    IFACEMETHODIMP CLASS::put_##PROPERTY(SamplerCoordinateMapping value)                \
+    {                                                                                   \
+        return SetCoordinateMapping(INDEX, value);                                      \
+    }
+
+
+#define IMPLEMENT_MAPPING_TRANSFORM_PROPERTY(CLASS, PROPERTY, INDEX)                    \
+                                                                                        \
+    IFACEMETHODIMP CLASS::get_##PROPERTY(Numerics::Matrix3x2* value)                    \
+    {                                                                                   \
+        return GetMappingTransform(INDEX, value);                                       \
+    }                                                                                   \
+                                                                                        \
+    IFACEMETHODIMP CLASS::put_##PROPERTY(Numerics::Matrix3x2 value)                     \
+    {                                                                                   \
+        return SetMappingTransform(INDEX, value);                                       \
+    }
+
+
+#define IMPLEMENT_MAX_SAMPLER_OFFSET_PROPERTY(CLASS)                                    \
+                                                                                        \
+    IFACEMETHODIMP CLASS::get_MaxSamplerOffset(int* value)                              \
+    {                                                                                   \
+        return GetMaxSamplerOffset(value);                                              \
+    }                                                                                   \
+                                                                                        \
+    IFACEMETHODIMP CLASS::put_MaxSamplerOffset(int value)                               \
+    {                                                                                   \
+        return SetMaxSamplerOffset(value);                                              \
+    }
+
+}}}}}
@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include "SharedShaderState.h"
+#include "ShaderCache.h"
 #include "utils/HashUtilities.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
@@ -15,6 +16,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         {
             Mapping[i] = SamplerCoordinateMapping::Unknown;
             BorderMode[i] = EffectBorderMode::Soft;
+            Transform[i] = Identity3x2();
         }
     }
 
@@ -28,32 +30,85 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    SharedShaderState::SharedShaderState(ShaderDescription const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation)
+    ThreadMappingState::ThreadMappingState()
+        : PixelsPerThread{ 1, 1 }
+    { }
+
+
+    SharedShaderState::SharedShaderState(ShaderDescription const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation, ThreadMappingState const& threadMapping)
+        : SharedShaderState(std::make_shared<ShaderDescription>(shader), constants, coordinateMapping, sourceInterpolation, threadMapping)
+    { }
+
+
+    SharedShaderState::SharedShaderState(std::shared_ptr<ShaderDescription const> const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation, ThreadMappingState const& threadMapping)
         : m_shader(shader)
         , m_constants(constants)
         , m_coordinateMapping(coordinateMapping)
         , m_sourceInterpolation(sourceInterpolation)
+        , m_threadMapping(threadMapping)
     { }
 
 
-    SharedShaderState::SharedShaderState(BYTE* shaderCode, uint32_t shaderCodeSize)
+    static wchar_t const* GetBadShaderMessage(D3D11_SHADER_VERSION_TYPE shaderType)
     {
-        // Store the shader program code.
-        m_shader.Code.assign(shaderCode, shaderCode + shaderCodeSize);
+        return (shaderType == D3D11_SHVER_COMPUTE_SHADER) ? Strings::ComputeEffectBadShader : Strings::CustomEffectBadShader;
+    }
 
-        // Hash it to generate a unique ID.
+
+    SharedShaderState::SharedShaderState(BYTE* shaderCode, uint32_t shaderCodeSize, D3D11_SHADER_VERSION_TYPE shaderType)
+    {
+        // Hash the shader code to generate a unique ID. This is only used to identify the shader
+        // to D2D and our own ShaderCache within this process, so need not be stable across
+        // versions, which lets us use a fast non-cryptographic hash instead of a SHA-1 UUID.
         static const IID salt{ 0x489257f6, 0x6544, 0x4277, 0x89, 0x82, 0xea, 0xd1, 0x69, 0x39, 0x1f, 0x3d };
 
-        m_shader.Hash = GetVersion5Uuid(salt, shaderCode, shaderCodeSize);
+        auto hash = GetFastUuid(salt, shaderCode, shaderCodeSize);
+
+        // Reuse the results of reflecting over this shader if it has been seen before.
+        auto& cache = ShaderCache::GetInstance();
+
+        ShaderCache::Entry cached;
+
+        if (cache.TryLookup(hash, shaderCode, shaderCodeSize, &cached))
+        {
+            // The same code can't be both a pixel and a compute shader.
+            if (cached.Shader->Type != shaderType)
+                ThrowHR(E_INVALIDARG, GetBadShaderMessage(shaderType));
+
+            m_shader = std::move(cached.Shader);
+            m_constants = std::move(cached.DefaultConstants);
+            m_coordinateMapping = cached.DefaultCoordinateMapping;
+            return;
+        }
+
+        auto shader = std::make_shared<ShaderDescription>();
+
+        // Store the shader program code.
+        shader->Code.assign(shaderCode, shaderCode + shaderCodeSize);
+        shader->Hash = hash;
+        shader->Type = shaderType;
 
         // Look up shader metadata.
-        ReflectOverShader();
+        ReflectOverShader(*shader);
+
+        m_shader = std::move(shader);
+
+        cache.Add(ShaderCache::Entry{ m_shader, m_constants, m_coordinateMapping });
+    }
+
+
+    void SharedShaderState::Preload(BYTE* shaderCode, uint32_t shaderCodeSize)
+    {
+        auto state = Make<SharedShaderState>(shaderCode, shaderCodeSize);
+        CheckMakeResult(state);
+
+        ShaderCache::GetInstance().Add(ShaderCache::Entry{ state->m_shader, state->m_constants, state->m_coordinateMapping }, true);
     }
 
 
     ComPtr<ISharedShaderState> SharedShaderState::Clone()
     {
-        auto clone = Make<SharedShaderState>(m_shader, m_constants, m_coordinateMapping, m_sourceInterpolation);
+        auto clone = Make<SharedShaderState>(m_shader, m_constants, m_coordinateMapping, m_sourceInterpolation, m_threadMapping);
         CheckMakeResult(clone);
 
         return clone;
@@ -62,13 +117,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     unsigned SharedShaderState::GetPropertyCount()
     {
-        return static_cast<unsigned>(m_shader.Variables.size());
+        return static_cast<unsigned>(m_shader->Variables.size());
     }
 
 
     bool SharedShaderState::HasProperty(HSTRING name)
     {
-        return std::binary_search(m_shader.Variables.begin(), m_shader.Variables.end(), name, VariableNameComparison());
+        return std::binary_search(m_shader->Variables.begin(), m_shader->Variables.end(), name, VariableNameComparison());
     }
 
 
@@ -150,10 +205,127 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::SetProperty(HSTRING name, IInspectable* boxedValue)
+    bool SharedShaderState::SetProperty(HSTRING name, IInspectable* boxedValue)
+    {
+        auto& variable = FindVariable(name);
+
+        // Remember the old value, so we can tell whether this actually changes anything.
+        auto oldValue = m_constants.begin() + variable.Offset;
+        std::vector<BYTE> previousValue(oldValue, oldValue + variable.Size);
+
+        SetProperty(variable, boxedValue);
+
+        return !std::equal(previousValue.begin(), previousValue.end(), m_constants.begin() + variable.Offset);
+    }
+
+
+    unsigned SharedShaderState::GetAnimatableProperty(HSTRING name, unsigned* componentCount)
     {
         auto& variable = FindVariable(name);
 
+        bool isAnimatable = variable.Type == D3D_SVT_FLOAT &&
+                            (variable.Class == D3D_SVC_SCALAR || variable.Class == D3D_SVC_VECTOR) &&
+                            variable.Rows == 1 &&
+                            variable.Elements == 0;
+
+        if (!isAnimatable)
+        {
+            WinStringBuilder message;
+            message.Format(Strings::EffectAnimationUnsupportedProperty, WindowsGetStringRawBuffer(name, nullptr));
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        *componentCount = variable.Columns;
+
+        return static_cast<unsigned>(&variable - m_shader->Variables.data());
+    }
+
+
+    bool SharedShaderState::SetAnimatedProperty(unsigned index, float const* values)
+    {
+        assert(index < m_shader->Variables.size());
+
+        auto& variable = m_shader->Variables[index];
+
+        // Remember the old value, so we can tell whether this actually changes anything.
+        auto oldValue = m_constants.begin() + variable.Offset;
+        std::vector<BYTE> previousValue(oldValue, oldValue + variable.Size);
+
+        float components[4];
+        std::copy(values, values + variable.Columns, components);
+
+        CopyConstantData<CopyDirection::Write>(variable, components);
+
+        return !std::equal(previousValue.begin(), previousValue.end(), m_constants.begin() + variable.Offset);
+    }
+
+
+    bool SharedShaderState::SetProperties(std::vector<StringObjectPair> const& values)
+    {
+        // Sort the new values by name, so they can be matched up with our (also sorted)
+        // variable list in a single pass. The sort is stable, so if a name appears more
+        // than once, the last value wins, same as setting them one at a time.
+        std::vector<StringObjectPair const*> sortedValues;
+
+        sortedValues.reserve(values.size());
+
+        for (auto& value : values)
+        {
+            sortedValues.push_back(&value);
+        }
+
+        MapKeyComparison<WinString> nameComparison;
+
+        std::stable_sort(sortedValues.begin(), sortedValues.end(),
+            [&](StringObjectPair const* value1, StringObjectPair const* value2)
+            {
+                return nameComparison(value1->first, value2->first);
+            });
+
+        // Look up all the variables before changing anything.
+        VariableNameComparison variableComparison;
+
+        std::vector<ShaderVariable const*> variables;
+
+        variables.reserve(sortedValues.size());
+
+        auto it = m_shader->Variables.begin();
+
+        for (auto value : sortedValues)
+        {
+            it = std::lower_bound(it, m_shader->Variables.end(), value->first, variableComparison);
+
+            if (it == m_shader->Variables.end() || variableComparison(value->first, *it))
+            {
+                ThrowUnknownProperty(value->first);
+            }
+
+            variables.push_back(&*it);
+        }
+
+        // Apply the new values. If any of them are the wrong type, put everything back
+        // how it was, so a failed call leaves the constant buffer untouched.
+        auto previousConstants = m_constants;
+
+        try
+        {
+            for (size_t i = 0; i < variables.size(); i++)
+            {
+                SetProperty(*variables[i], sortedValues[i]->second.Get());
+            }
+        }
+        catch (...)
+        {
+            m_constants = std::move(previousConstants);
+            throw;
+        }
+
+        return m_constants != previousConstants;
+    }
+
+
+    void SharedShaderState::SetProperty(ShaderVariable const& variable, IInspectable* boxedValue)
+    {
         switch (variable.Type)
         {
             case D3D_SVT_FLOAT:
@@ -210,9 +382,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         std::vector<StringObjectPair> properties;
 
-        properties.reserve(m_shader.Variables.size());
+        properties.reserve(m_shader->Variables.size());
 
-        for (auto& variable : m_shader.Variables)
+        for (auto& variable : m_shader->Variables)
         {
             properties.emplace_back(variable.Name, GetProperty(variable));
         }
@@ -225,19 +397,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         VariableNameComparison comparison;
 
-        auto it = std::lower_bound(m_shader.Variables.begin(), m_shader.Variables.end(), name, comparison);
+        auto it = std::lower_bound(m_shader->Variables.begin(), m_shader->Variables.end(), name, comparison);
 
-        if (it == m_shader.Variables.end() || comparison(name, *it))
+        if (it == m_shader->Variables.end() || comparison(name, *it))
         {
-            WinStringBuilder message;
-            message.Format(Strings::CustomEffectUnknownProperty, WindowsGetStringRawBuffer(name, nullptr));
-            ThrowHR(E_INVALIDARG, message.Get());
+            ThrowUnknownProperty(name);
         }
 
         return *it;
     }
 
 
+    void SharedShaderState::ThrowUnknownProperty(HSTRING name)
+    {
+        WinStringBuilder message;
+        message.Format(Strings::CustomEffectUnknownProperty, WindowsGetStringRawBuffer(name, nullptr));
+        ThrowHR(E_INVALIDARG, message.Get());
+    }
+
+
     // For formatting error message strings.
     template<typename T> wchar_t const* PropertyTypeName() { static_assert(false, "missing specialization"); }
 
@@ -460,49 +638,60 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::ReflectOverShader()
+    void SharedShaderState::ReflectOverShader(ShaderDescription& shader)
     {
         // Create the shader reflection interface.
         ComPtr<ID3D11ShaderReflection> reflector;
 
-        HRESULT hr = D3DReflect(m_shader.Code.data(), m_shader.Code.size(), IID_PPV_ARGS(&reflector));
+        HRESULT hr = D3DReflect(shader.Code.data(), shader.Code.size(), IID_PPV_ARGS(&reflector));
 
         if (FAILED(hr))
-            ThrowHR(E_INVALIDARG, Strings::CustomEffectBadShader);
+            ThrowHR(E_INVALIDARG, GetBadShaderMessage(shader.Type));
 
         D3D11_SHADER_DESC desc;
         ThrowIfFailed(reflector->GetDesc(&desc));
 
-        // Make sure this is a pixel shader.
+        // Make sure this is the expected type of shader: pixel shaders use shader model 4,
+        // while compute shaders need shader model 5 (cs_4_x is too limited to be worth it).
         auto shaderType = D3D11_SHVER_GET_TYPE(desc.Version);
         auto shaderModel = D3D11_SHVER_GET_MAJOR(desc.Version);
+        auto isCompute = (shader.Type == D3D11_SHVER_COMPUTE_SHADER);
+
+        if (shaderType != static_cast<unsigned>(shader.Type) || 
+            shaderModel != (isCompute ? 5u : 4u))
+        {
+            ThrowHR(E_INVALIDARG, GetBadShaderMessage(shader.Type));
+        }
 
-        if (shaderType != D3D11_SHVER_PIXEL_SHADER || 
-            shaderModel != 4)
+        if (isCompute)
         {
-            ThrowHR(E_INVALIDARG, Strings::CustomEffectBadShader);
+            reflector->GetThreadGroupSize(&shader.ThreadGroupSize[0], &shader.ThreadGroupSize[1], &shader.ThreadGroupSize[2]);
         }
 
         // Examine the input bindings.
-        ReflectOverBindings(reflector.Get(), desc);
+        ReflectOverBindings(shader, reflector.Get(), desc);
 
         // Store the mapping from named constants to buffer locations.
         if (desc.ConstantBuffers)
         {
-            ReflectOverConstantBuffer(reflector->GetConstantBufferByIndex(0));
+            ReflectOverConstantBuffer(shader, reflector->GetConstantBufferByIndex(0));
         }
 
         // Grab some other metadata.
-        m_shader.InstructionCount = desc.InstructionCount;
+        shader.InstructionCount = desc.InstructionCount;
 
-        ThrowIfFailed(reflector->GetMinFeatureLevel(&m_shader.MinFeatureLevel));
+        ThrowIfFailed(reflector->GetMinFeatureLevel(&shader.MinFeatureLevel));
 
         // If this shader was compiled to support shader linking, we can also determine which inputs are simple vs. complex.
-        ReflectOverShaderLinkingFunction();
+        // That only applies to pixel shaders.
+        if (!isCompute)
+        {
+            ReflectOverShaderLinkingFunction(shader);
+        }
     }
 
 
-    void SharedShaderState::ReflectOverBindings(ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc)
+    void SharedShaderState::ReflectOverBindings(ShaderDescription& shader, ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc)
     {
         for (unsigned i = 0; i < desc.BoundResources; i++)
         {
@@ -516,7 +705,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                     ThrowHR(E_INVALIDARG, Strings::CustomEffectTooManyTextures);
 
                 // Record how many input textures this shader uses.
-                m_shader.InputCount = std::max(m_shader.InputCount, inputDesc.BindPoint + 1);
+                shader.InputCount = std::max(shader.InputCount, inputDesc.BindPoint + 1);
                 break;
 
             case D3D_SIT_CBUFFER:
@@ -529,7 +718,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::ReflectOverConstantBuffer(ID3D11ShaderReflectionConstantBuffer* constantBuffer)
+    void SharedShaderState::ReflectOverConstantBuffer(ShaderDescription& shader, ID3D11ShaderReflectionConstantBuffer* constantBuffer)
     {
         D3D11_SHADER_BUFFER_DESC desc;
         ThrowIfFailed(constantBuffer->GetDesc(&desc));
@@ -538,15 +727,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         m_constants.resize(desc.Size);
 
         // Look up variable metadata.
-        m_shader.Variables.reserve(desc.Variables);
+        shader.Variables.reserve(desc.Variables);
 
         for (unsigned i = 0; i < desc.Variables; i++)
         {
-            ReflectOverVariable(constantBuffer->GetVariableByIndex(i));
+            ReflectOverVariable(shader, constantBuffer->GetVariableByIndex(i));
         }
 
         // Sort the variables by name.
-        std::sort(m_shader.Variables.begin(), m_shader.Variables.end(), VariableNameComparison());
+        std::sort(shader.Variables.begin(), shader.Variables.end(), VariableNameComparison());
     }
 
 
@@ -629,7 +818,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::ReflectOverVariable(ID3D11ShaderReflectionVariable* variable)
+    void SharedShaderState::ReflectOverVariable(ShaderDescription& shader, ID3D11ShaderReflectionVariable* variable)
     {
         D3D11_SHADER_VARIABLE_DESC desc;
         ThrowIfFailed(variable->GetDesc(&desc));
@@ -657,6 +846,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ThrowHR(E_UNEXPECTED);
         }
 
+        if (ReflectOverReservedVariable(shader, desc, type))
+        {
+            return;
+        }
+
         // Initialize our constant buffer with the default value of the variable.
         if (desc.DefaultValue)
         {
@@ -664,11 +858,51 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
 
         // Store metadata about this variable.
-        m_shader.Variables.emplace_back(desc, type);
+        shader.Variables.emplace_back(desc, type);
     }
 
 
-    void SharedShaderState::ReflectOverShaderLinkingFunction()
+    bool SharedShaderState::ReflectOverReservedVariable(ShaderDescription& shader, D3D11_SHADER_VARIABLE_DESC const& desc, D3D11_SHADER_TYPE_DESC const& type)
+    {
+        // Compute shaders write directly to the output texture, so must be told which part of
+        // the output each dispatch covers (Win2DOutputRect), and which part of each source is
+        // available (Win2DSourceRects). Both are int4(left, top, right, bottom) in pixels.
+        if (shader.Type != D3D11_SHVER_COMPUTE_SHADER)
+            return false;
+
+        bool isOutputRect = !strcmp(desc.Name, "Win2DOutputRect");
+        bool isSourceRects = !strcmp(desc.Name, "Win2DSourceRects");
+
+        if (!isOutputRect && !isSourceRects)
+            return false;
+
+        bool isInt4 = type.Class == D3D_SVC_VECTOR &&
+                      type.Type == D3D_SVT_INT &&
+                      type.Rows == 1 &&
+                      type.Columns == 4;
+
+        if (!isInt4 || (isOutputRect && type.Elements))
+        {
+            WinStringBuilder message;
+            message.Format(Strings::CustomEffectBadPropertyType, desc.Name);
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        if (isOutputRect)
+        {
+            shader.OutputRectOffset = desc.StartOffset;
+        }
+        else
+        {
+            shader.SourceRectsOffset = desc.StartOffset;
+            shader.SourceRectsCount = std::max(type.Elements, 1u);
+        }
+
+        return true;
+    }
+
+
+    void SharedShaderState::ReflectOverShaderLinkingFunction(ShaderDescription& shader)
     {
         // If this shader was compiled to support shader linking, we can get extra information
         // (telling us which inputs are simple vs. complex) from the shader linking function.
@@ -676,7 +910,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // It's valid to use shaders that don't support linking, so we return on failure rather than throwing.
         ComPtr<ID3DBlob> privateData;
 
-        if (FAILED(D3DGetBlobPart(m_shader.Code.data(), m_shader.Code.size(), D3D_BLOB_PRIVATE_DATA, 0, &privateData)))
+        if (FAILED(D3DGetBlobPart(shader.Code.data(), shader.Code.size(), D3D_BLOB_PRIVATE_DATA, 0, &privateData)))
             return;
 
         ComPtr<ID3D11LibraryReflection> reflector;
@@ -691,6 +925,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         if (desc.FunctionCount != 1)
             return;
 
+        shader.SupportsLinking = true;
+
         auto function = reflector->GetFunctionByIndex(0);
 
         D3D11_FUNCTION_DESC functionDesc;
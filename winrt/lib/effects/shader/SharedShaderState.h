@@ -23,6 +23,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         SamplerCoordinateMapping Mapping[MaxShaderInputs];
         EffectBorderMode BorderMode[MaxShaderInputs];
         int MaxOffset;
+
+        // For Transformed inputs: maps output pixel positions to where the shader samples this input.
+        Numerics::Matrix3x2 Transform[MaxShaderInputs];
     };
 
 
@@ -35,7 +38,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     };
 
 
-    // Implementation state shared between PixelShaderEffect and PixelShaderEffectImpl.
+    // Compute shaders only: how many output pixels each thread is responsible for.
+    struct ThreadMappingState
+    {
+        ThreadMappingState();
+
+        BitmapSize PixelsPerThread;
+    };
+
+
+    // Implementation state shared between PixelShaderEffect and PixelShaderEffectImpl
+    // (or ComputeShaderEffect and ComputeShaderEffectImpl).
     // This stores the compiled shader code, metadata obtained via shader reflection,
     // and app-specified state such as the current constant buffer.
     //
@@ -55,45 +68,69 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual std::vector<BYTE> const& Constants() = 0;
         virtual CoordinateMappingState& CoordinateMapping() = 0;
         virtual SourceInterpolationState& SourceInterpolation() = 0;
+        virtual ThreadMappingState& ThreadMapping() = 0;
 
         // Property accessors.
         virtual unsigned GetPropertyCount() = 0;
         virtual bool HasProperty(HSTRING name) = 0;
         virtual ComPtr<IInspectable> GetProperty(HSTRING name) = 0;
-        virtual void SetProperty(HSTRING name, IInspectable* boxedValue) = 0;
         virtual std::vector<StringObjectPair> EnumerateProperties() = 0;
+
+        // Property setters return whether the constant buffer actually changed.
+        virtual bool SetProperty(HSTRING name, IInspectable* boxedValue) = 0;
+        virtual bool SetProperties(std::vector<StringObjectPair> const& values) = 0;
+
+        // Used by CanvasEffect.Animate. Looks up a float, float2, float3 or float4 property,
+        // returning an index for SetAnimatedProperty, or throwing if it cannot be animated.
+        virtual unsigned GetAnimatableProperty(HSTRING name, unsigned* componentCount) = 0;
+        virtual bool SetAnimatedProperty(unsigned index, float const* values) = 0;
     };
     
 
     class SharedShaderState : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ISharedShaderState>
                             , private LifespanTracker<SharedShaderState>
     {
-        ShaderDescription m_shader;
+        // Immutable once reflected, so shared by clones and by every state created from the same shader code.
+        std::shared_ptr<ShaderDescription const> m_shader;
         std::vector<BYTE> m_constants;
         CoordinateMappingState m_coordinateMapping;
         SourceInterpolationState m_sourceInterpolation;
+        ThreadMappingState m_threadMapping;
 
     public:
-        SharedShaderState(ShaderDescription const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation);
-        SharedShaderState(BYTE* shaderCode, uint32_t shaderCodeSize);
+        SharedShaderState(ShaderDescription const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation, ThreadMappingState const& threadMapping = ThreadMappingState());
+        SharedShaderState(std::shared_ptr<ShaderDescription const> const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation, ThreadMappingState const& threadMapping = ThreadMappingState());
+        SharedShaderState(BYTE* shaderCode, uint32_t shaderCodeSize, D3D11_SHADER_VERSION_TYPE shaderType = D3D11_SHVER_PIXEL_SHADER);
+
+        // Validates and reflects over a shader ahead of time, keeping the results in ShaderCache
+        // for the rest of the process lifetime.
+        static void Preload(BYTE* shaderCode, uint32_t shaderCodeSize);
 
         virtual ComPtr<ISharedShaderState> Clone() override;
 
-        virtual ShaderDescription const& Shader() override { return m_shader; }
+        virtual ShaderDescription const& Shader() override { return *m_shader; }
         virtual std::vector<BYTE> const& Constants() override { return m_constants; }
         virtual CoordinateMappingState& CoordinateMapping() override { return m_coordinateMapping; }
         virtual SourceInterpolationState& SourceInterpolation() { return m_sourceInterpolation; }
+        virtual ThreadMappingState& ThreadMapping() override { return m_threadMapping; }
 
         // Property accessors.
         virtual unsigned GetPropertyCount() override;
         virtual bool HasProperty(HSTRING name) override;
         virtual ComPtr<IInspectable> GetProperty(HSTRING name) override;
-        virtual void SetProperty(HSTRING name, IInspectable* boxedValue) override;
         virtual std::vector<StringObjectPair> EnumerateProperties() override;
 
+        virtual bool SetProperty(HSTRING name, IInspectable* boxedValue) override;
+        virtual bool SetProperties(std::vector<StringObjectPair> const& values) override;
+
+        virtual unsigned GetAnimatableProperty(HSTRING name, unsigned* componentCount) override;
+        virtual bool SetAnimatedProperty(unsigned index, float const* values) override;
+
     private:
         ComPtr<IInspectable> GetProperty(ShaderVariable const& variable);
+        void SetProperty(ShaderVariable const& variable, IInspectable* boxedValue);
         ShaderVariable const& FindVariable(HSTRING name);
+        static void ThrowUnknownProperty(HSTRING name);
 
 
         // Transfer property values between constant buffer and boxed IInspectable formats.
@@ -107,12 +144,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         void CopyConstantData(ShaderVariable const& variable, TComponent* values);
 
 
-        // Shader reflection (done at init time).
-        void ReflectOverShader();
-        void ReflectOverBindings(ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc);
-        void ReflectOverConstantBuffer(ID3D11ShaderReflectionConstantBuffer* constantBuffer);
-        void ReflectOverVariable(ID3D11ShaderReflectionVariable* variable);
-        void ReflectOverShaderLinkingFunction();
+        // Shader reflection (done at init time, unless ShaderCache already knows this shader).
+        void ReflectOverShader(ShaderDescription& shader);
+        void ReflectOverBindings(ShaderDescription& shader, ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc);
+        void ReflectOverConstantBuffer(ShaderDescription& shader, ID3D11ShaderReflectionConstantBuffer* constantBuffer);
+        void ReflectOverVariable(ShaderDescription& shader, ID3D11ShaderReflectionVariable* variable);
+        static bool ReflectOverReservedVariable(ShaderDescription& shader, D3D11_SHADER_VARIABLE_DESC const& desc, D3D11_SHADER_TYPE_DESC const& type);
+        void ReflectOverShaderLinkingFunction(ShaderDescription& shader);
     };
 
 }}}}}
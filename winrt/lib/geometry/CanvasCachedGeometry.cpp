@@ -141,6 +141,9 @@ ComPtr<CanvasCachedGeometry> CanvasCachedGeometry::CreateNew(
 
     auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometry);
 
+    EventWrite_CanvasCachedGeometry_Create_Start(false);
+    auto createEnd = MakeScopeWarden([] { EventWrite_CanvasCachedGeometry_Create_Stop(); });
+
     auto d2dGeometryRealization = deviceInternal->CreateFilledGeometryRealization(
         d2dGeometry.Get(),
         flatteningTolerance);
@@ -166,6 +169,9 @@ ComPtr<CanvasCachedGeometry> CanvasCachedGeometry::CreateNew(
 
     auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometry);
 
+    EventWrite_CanvasCachedGeometry_Create_Start(true);
+    auto createEnd = MakeScopeWarden([] { EventWrite_CanvasCachedGeometry_Create_Stop(); });
+
     auto d2dGeometryRealization = deviceInternal->CreateStrokedGeometryRealization(
         d2dGeometry.Get(),
         strokeWidth,
@@ -0,0 +1,362 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasCachedGeometryCache.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+namespace
+{
+    //
+    // Counts the points in a geometry flattened to lines, without keeping them.
+    //
+    class PointCountingSink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1SimplifiedGeometrySink>,
+                              private LifespanTracker<PointCountingSink>
+    {
+        uint64_t m_pointCount;
+
+    public:
+        PointCountingSink()
+            : m_pointCount(0)
+        { }
+
+        uint64_t GetPointCount() const { return m_pointCount; }
+
+        IFACEMETHODIMP_(void) SetFillMode(D2D1_FILL_MODE) override { }
+        IFACEMETHODIMP_(void) SetSegmentFlags(D2D1_PATH_SEGMENT) override { }
+        IFACEMETHODIMP_(void) BeginFigure(D2D1_POINT_2F, D2D1_FIGURE_BEGIN) override { m_pointCount++; }
+        IFACEMETHODIMP_(void) AddLines(D2D1_POINT_2F const*, UINT32 pointsCount) override { m_pointCount += pointsCount; }
+        IFACEMETHODIMP_(void) AddBeziers(D2D1_BEZIER_SEGMENT const*, UINT32 beziersCount) override { m_pointCount += beziersCount; }
+        IFACEMETHODIMP_(void) EndFigure(D2D1_FIGURE_END) override { }
+        IFACEMETHODIMP Close() override { return S_OK; }
+    };
+}
+
+
+//
+// CanvasCachedGeometryCacheFactory
+//
+
+IFACEMETHODIMP CanvasCachedGeometryCacheFactory::Create(
+    ICanvasResourceCreator* resourceCreator,
+    UINT64 maximumSizeInBytes,
+    ICanvasCachedGeometryCache** cache)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckAndClearOutPointer(cache);
+
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(resourceCreator->get_Device(&device));
+
+            auto newCache = Make<CanvasCachedGeometryCache>(device.Get(), maximumSizeInBytes);
+            CheckMakeResult(newCache);
+
+            ThrowIfFailed(newCache.CopyTo(cache));
+        });
+}
+
+
+//
+// CanvasCachedGeometryCache
+//
+
+size_t CanvasCachedGeometryCache::CacheKeyHash::operator()(CacheKey const& key) const
+{
+    size_t hash = std::hash<void*>()(key.Geometry);
+
+    auto combine = [&](size_t value)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    combine(std::hash<bool>()(key.IsStroke));
+    combine(std::hash<float>()(key.StrokeWidth));
+    combine(std::hash<void*>()(key.StrokeStyle));
+    combine(std::hash<float>()(key.FlatteningTolerance));
+
+    return hash;
+}
+
+
+CanvasCachedGeometryCache::CanvasCachedGeometryCache(ICanvasDevice* device, uint64_t maximumSize)
+    : m_device(device)
+    , m_size(0)
+    , m_maximumSize(maximumSize)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_evictionCount(0)
+{
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::GetFill(
+    ICanvasGeometry* geometry,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    return GetFillWithFlatteningTolerance(
+        geometry,
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        cachedGeometry);
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::GetFillWithFlatteningTolerance(
+    ICanvasGeometry* geometry,
+    float flatteningTolerance,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            GetImpl(geometry, false, 0, nullptr, flatteningTolerance, cachedGeometry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::GetStroke(
+    ICanvasGeometry* geometry,
+    float strokeWidth,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            GetImpl(geometry, true, strokeWidth, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE, cachedGeometry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::GetStrokeWithStrokeStyle(
+    ICanvasGeometry* geometry,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(strokeStyle);
+            GetImpl(geometry, true, strokeWidth, strokeStyle, D2D1_DEFAULT_FLATTENING_TOLERANCE, cachedGeometry);
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::GetStrokeWithStrokeStyleAndFlatteningTolerance(
+    ICanvasGeometry* geometry,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    float flatteningTolerance,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(strokeStyle);
+            GetImpl(geometry, true, strokeWidth, strokeStyle, flatteningTolerance, cachedGeometry);
+        });
+}
+
+
+void CanvasCachedGeometryCache::GetImpl(
+    ICanvasGeometry* geometry,
+    bool isStroke,
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    float flatteningTolerance,
+    ICanvasCachedGeometry** cachedGeometry)
+{
+    CheckInPointer(geometry);
+    CheckAndClearOutPointer(cachedGeometry);
+
+    ComPtr<ICanvasDevice> geometryDevice;
+    ThrowIfFailed(geometry->get_Device(&geometryDevice));
+
+    if (!IsSameInstance(geometryDevice.Get(), m_device.Get()))
+        ThrowHR(E_INVALIDARG, Strings::CachedGeometryCacheWrongDevice);
+
+    auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometry);
+    auto d2dStrokeStyle = MaybeGetStrokeStyleResource(d2dGeometry.Get(), strokeStyle);
+
+    CacheKey key{ geometry, isStroke, strokeWidth, d2dStrokeStyle.Get(), flatteningTolerance };
+
+    {
+        Lock lock(m_mutex);
+
+        auto it = m_entryMap.find(key);
+
+        if (it != m_entryMap.end())
+        {
+            m_hitCount++;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            ThrowIfFailed(it->second->CachedGeometry.CopyTo(cachedGeometry));
+            return;
+        }
+
+        m_missCount++;
+    }
+
+    // Realize the geometry without holding the lock, as this is the slow part.
+    auto newCachedGeometry = isStroke
+        ? CanvasCachedGeometry::CreateNew(m_device.Get(), geometry, strokeWidth, strokeStyle, flatteningTolerance)
+        : CanvasCachedGeometry::CreateNew(m_device.Get(), geometry, flatteningTolerance);
+
+    auto size = EstimateSize(d2dGeometry.Get(), isStroke, flatteningTolerance);
+
+    Lock lock(m_mutex);
+
+    // Another thread may have realized the same thing in the meantime, in
+    // which case everybody should share the one that is already cached.
+    auto it = m_entryMap.find(key);
+
+    if (it != m_entryMap.end())
+    {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        ThrowIfFailed(it->second->CachedGeometry.CopyTo(cachedGeometry));
+        return;
+    }
+
+    m_entries.push_front(Entry{ key, geometry, d2dStrokeStyle, newCachedGeometry, size });
+    m_entryMap.emplace(key, m_entries.begin());
+    m_size += size;
+
+    ThrowIfFailed(newCachedGeometry.CopyTo(cachedGeometry));
+
+    // A realization bigger than the whole budget is still returned, but not kept.
+    EvictToSize(lock, m_maximumSize);
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::Remove(ICanvasGeometry* geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometry);
+
+            Lock lock(m_mutex);
+
+            for (auto it = m_entries.begin(); it != m_entries.end();)
+            {
+                auto next = std::next(it);
+
+                if (IsSameInstance(it->Geometry.Get(), geometry))
+                    EraseEntry(lock, it);
+
+                it = next;
+            }
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::get_MaximumSizeInBytes(UINT64* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+            *value = m_maximumSize;
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::put_MaximumSizeInBytes(UINT64 value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+
+            m_maximumSize = value;
+            EvictToSize(lock, m_maximumSize);
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::get_Statistics(CanvasCachedGeometryCacheStatistics* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            value->Count = static_cast<UINT32>(m_entries.size());
+            value->SizeInBytes = m_size;
+            value->HitCount = m_hitCount;
+            value->MissCount = m_missCount;
+            value->EvictionCount = m_evictionCount;
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::Trim()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+            EvictToSize(lock, 0);
+        });
+}
+
+
+IFACEMETHODIMP CanvasCachedGeometryCache::get_Device(ICanvasDevice** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_device.CopyTo(value));
+        });
+}
+
+
+uint64_t CanvasCachedGeometryCache::EstimateSize(ID2D1Geometry* d2dGeometry, bool isStroke, float flatteningTolerance)
+{
+    auto sink = Make<PointCountingSink>();
+    CheckMakeResult(sink);
+
+    ThrowIfFailed(d2dGeometry->Simplify(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, nullptr, flatteningTolerance, sink.Get()));
+
+    auto sizePerPoint = isStroke ? StrokeSizePerPoint : FillSizePerPoint;
+
+    return SizePerRealization + sink->GetPointCount() * sizePerPoint;
+}
+
+
+void CanvasCachedGeometryCache::EvictToSize(Lock const& lock, uint64_t size)
+{
+    MustOwnLock(lock);
+
+    while (m_size > size && !m_entries.empty())
+    {
+        EraseEntry(lock, std::prev(m_entries.end()));
+    }
+}
+
+
+void CanvasCachedGeometryCache::EraseEntry(Lock const& lock, EntryList::iterator it)
+{
+    MustOwnLock(lock);
+
+    // The cache only drops its reference; anyone else still using the
+    // CanvasCachedGeometry keeps it alive until they release it.
+    m_size -= it->Size;
+    m_evictionCount++;
+
+    m_entryMap.erase(it->Key);
+    m_entries.erase(it);
+}
+
+
+ActivatableClassWithFactory(CanvasCachedGeometryCache, CanvasCachedGeometryCacheFactory);
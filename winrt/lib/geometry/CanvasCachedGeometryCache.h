@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "CanvasCachedGeometry.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    class CanvasCachedGeometryCacheFactory
+        : public AgileActivationFactory<ICanvasCachedGeometryCacheStatics>
+        , private LifespanTracker<CanvasCachedGeometryCacheFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasCachedGeometryCache, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            UINT64 maximumSizeInBytes,
+            ICanvasCachedGeometryCache** cache) override;
+    };
+
+
+    //
+    // Entries are kept in a list ordered by when they were last asked for,
+    // with a hash map from their key into that list.  Geometry realizations
+    // don't report how much memory they use, so each one's size is estimated
+    // from the number of points in the flattened geometry.
+    //
+    // Entries hold strong references to the geometry and D2D stroke style in
+    // their key, so neither pointer can be reused for a different object while
+    // the entry exists.  Keying on the realized ID2D1StrokeStyle rather than
+    // the CanvasStrokeStyle means changing a stroke style's properties is a
+    // cache miss, as it would be given a new D2D stroke style.
+    //
+    class CanvasCachedGeometryCache
+        : public RuntimeClass<
+            ICanvasCachedGeometryCache,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasCachedGeometryCache>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasCachedGeometryCache, BaseTrust);
+
+        struct CacheKey
+        {
+            ICanvasGeometry* Geometry;
+            bool IsStroke;
+            float StrokeWidth;
+            ID2D1StrokeStyle* StrokeStyle;
+            float FlatteningTolerance;
+
+            bool operator==(CacheKey const& other) const
+            {
+                return Geometry == other.Geometry &&
+                       IsStroke == other.IsStroke &&
+                       StrokeWidth == other.StrokeWidth &&
+                       StrokeStyle == other.StrokeStyle &&
+                       FlatteningTolerance == other.FlatteningTolerance;
+            }
+        };
+
+        struct CacheKeyHash
+        {
+            size_t operator()(CacheKey const& key) const;
+        };
+
+        struct Entry
+        {
+            CacheKey Key;
+            ComPtr<ICanvasGeometry> Geometry;
+            ComPtr<ID2D1StrokeStyle> StrokeStyle;
+            ComPtr<CanvasCachedGeometry> CachedGeometry;
+            uint64_t Size;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        ComPtr<ICanvasDevice> m_device;
+
+        std::mutex m_mutex;
+        EntryList m_entries;                                                // Most recently used at the front.
+        std::unordered_map<CacheKey, EntryList::iterator, CacheKeyHash> m_entryMap;
+        uint64_t m_size;
+        uint64_t m_maximumSize;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+    public:
+        // Rough device memory cost of a realization, per point of the
+        // geometry flattened to the same tolerance.  Fills store about one
+        // triangle per point plus an antialiasing fringe; strokes store both
+        // sides of the widened outline.
+        static const uint64_t FillSizePerPoint = 64;
+        static const uint64_t StrokeSizePerPoint = 128;
+        static const uint64_t SizePerRealization = 256;
+
+        CanvasCachedGeometryCache(ICanvasDevice* device, uint64_t maximumSize);
+
+        IFACEMETHOD(GetFill)(
+            ICanvasGeometry* geometry,
+            ICanvasCachedGeometry** cachedGeometry) override;
+
+        IFACEMETHOD(GetFillWithFlatteningTolerance)(
+            ICanvasGeometry* geometry,
+            float flatteningTolerance,
+            ICanvasCachedGeometry** cachedGeometry) override;
+
+        IFACEMETHOD(GetStroke)(
+            ICanvasGeometry* geometry,
+            float strokeWidth,
+            ICanvasCachedGeometry** cachedGeometry) override;
+
+        IFACEMETHOD(GetStrokeWithStrokeStyle)(
+            ICanvasGeometry* geometry,
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            ICanvasCachedGeometry** cachedGeometry) override;
+
+        IFACEMETHOD(GetStrokeWithStrokeStyleAndFlatteningTolerance)(
+            ICanvasGeometry* geometry,
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            float flatteningTolerance,
+            ICanvasCachedGeometry** cachedGeometry) override;
+
+        IFACEMETHOD(Remove)(ICanvasGeometry* geometry) override;
+
+        IFACEMETHOD(get_MaximumSizeInBytes)(UINT64* value) override;
+        IFACEMETHOD(put_MaximumSizeInBytes)(UINT64 value) override;
+
+        IFACEMETHOD(get_Statistics)(CanvasCachedGeometryCacheStatistics* value) override;
+
+        IFACEMETHOD(Trim)() override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        static uint64_t EstimateSize(ID2D1Geometry* d2dGeometry, bool isStroke, float flatteningTolerance);
+
+    private:
+        void GetImpl(
+            ICanvasGeometry* geometry,
+            bool isStroke,
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            float flatteningTolerance,
+            ICanvasCachedGeometry** cachedGeometry);
+
+        void EvictToSize(Lock const& lock, uint64_t size);
+        void EraseEntry(Lock const& lock, EntryList::iterator it);
+    };
+}}}}}
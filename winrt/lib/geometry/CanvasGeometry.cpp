@@ -7,9 +7,11 @@
 #include "CanvasGeometry.h"
 #include "CanvasPathBuilder.h"
 #include "GeometrySink.h"
+#include "PathDataParser.h"
 #include "TessellationSink.h"
 #include "../images/CanvasCommandList.h"
 #include "../text/DrawGlyphRunHelper.h"
+#include "../utils/ParallelFor.h"
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 #include "InkToGeometryCommandSink.h"
@@ -143,6 +145,11 @@ ComPtr<ID2D1TransformedGeometry> DefaultGeometryAdapter::CreateTransformedGeomet
     return transformedGeometry;
 }
 
+CanvasGeometryFactory::CanvasGeometryFactory()
+    : m_glyphOutlineCache(GlyphOutlineCache::GetInstance())
+{
+}
+
 IFACEMETHODIMP CanvasGeometryFactory::CreateRectangle(
     ICanvasResourceCreator* resourceCreator,
     Rect rect,
@@ -282,6 +289,73 @@ IFACEMETHODIMP CanvasGeometryFactory::CreatePolygon(
         });
 }
 
+IFACEMETHODIMP CanvasGeometryFactory::CreatePolylines(
+    ICanvasResourceCreator* resourceCreator,
+    uint32_t pointCount,
+    Numerics::Vector2* points,
+    uint32_t figureOffsetsCount,
+    uint32_t* figureOffsets,
+    CanvasFigureLoop figureLoop,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(geometry);
+
+            auto newCanvasGeometry = CanvasGeometry::CreateNew(resourceCreator, pointCount, points, figureOffsetsCount, figureOffsets, figureLoop);
+
+            ThrowIfFailed(newCanvasGeometry.CopyTo(geometry));
+        });
+}
+
+IFACEMETHODIMP CanvasGeometryFactory::CreateFromPathData(
+    ICanvasResourceCreator* resourceCreator,
+    HSTRING pathData,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(geometry);
+
+            uint32_t length;
+            auto buffer = WindowsGetStringRawBuffer(pathData, &length);
+
+            auto newCanvasGeometry = CanvasGeometry::CreateFromPathData(resourceCreator, length, buffer);
+
+            ThrowIfFailed(newCanvasGeometry.CopyTo(geometry));
+        });
+}
+
+IFACEMETHODIMP CanvasGeometryFactory::CreateFromPathDataUtf8(
+    ICanvasResourceCreator* resourceCreator,
+    uint32_t pathDataCount,
+    BYTE* pathData,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (pathDataCount > 0)
+                CheckInPointer(pathData);
+            CheckAndClearOutPointer(geometry);
+
+            auto buffer = reinterpret_cast<char const*>(pathData);
+
+            // Skip a byte order mark, as data read straight from a file may have one.
+            if (pathDataCount >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0)
+            {
+                buffer += 3;
+                pathDataCount -= 3;
+            }
+
+            auto newCanvasGeometry = CanvasGeometry::CreateFromPathData(resourceCreator, pathDataCount, buffer);
+
+            ThrowIfFailed(newCanvasGeometry.CopyTo(geometry));
+        });
+}
+
 IFACEMETHODIMP CanvasGeometryFactory::CreateGroup(
     ICanvasResourceCreator* resourceCreator,
     uint32_t geometryCount,
@@ -398,6 +472,38 @@ IFACEMETHODIMP CanvasGeometryFactory::CreateInkWithTransformAndFlatteningToleran
         });
 }
 
+IFACEMETHODIMP CanvasGeometryFactory::CreateInkBatch(
+    ICanvasResourceCreator* resourceCreator,
+    IIterable<IIterable<InkStroke*>*>* inkStrokeSets,
+    uint32_t* geometryCount,
+    ICanvasGeometry*** geometries)
+{
+    return CreateInkBatchWithTransformAndFlatteningTolerance(resourceCreator, inkStrokeSets, Identity3x2(), D2D1_DEFAULT_FLATTENING_TOLERANCE, geometryCount, geometries);
+}
+
+IFACEMETHODIMP CanvasGeometryFactory::CreateInkBatchWithTransformAndFlatteningTolerance(
+    ICanvasResourceCreator* resourceCreator,
+    IIterable<IIterable<InkStroke*>*>* inkStrokeSets,
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    uint32_t* geometryCount,
+    ICanvasGeometry*** geometries)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(inkStrokeSets);
+            CheckInPointer(geometryCount);
+            CheckAndClearOutPointer(geometries);
+
+            auto newCanvasGeometries = CanvasGeometry::CreateInkBatch(resourceCreator, inkStrokeSets, transform, flatteningTolerance);
+
+            ComArray<ComPtr<ICanvasGeometry>> array(newCanvasGeometries.begin(), newCanvasGeometries.end());
+            array.Detach(geometryCount, geometries);
+        });
+}
+
 #endif
 
 IFACEMETHODIMP CanvasGeometryFactory::ComputeFlatteningTolerance(
@@ -467,12 +573,244 @@ IFACEMETHODIMP CanvasGeometryFactory::get_DefaultFlatteningTolerance(float* theV
         });
 }
 
+
+//
+// TessellateManyAsync hands the geometries out to a number of threadpool
+// workers, each of which tessellates them one at a time into a vector of its
+// own. The async operation's thread does a share of the tessellating too, and
+// once everyone is done it packs the results into one array.
+//
+
+class CanvasGeometryBatchTessellator
+{
+    std::vector<ComPtr<ID2D1Geometry>> m_geometries;
+    D2D1_MATRIX_3X2_F m_transform;
+    float m_flatteningTolerance;
+
+    std::vector<std::vector<CanvasTriangleVertices>> m_results;
+
+public:
+    CanvasGeometryBatchTessellator(std::vector<ComPtr<ID2D1Geometry>>&& geometries, Matrix3x2 const& transform, float flatteningTolerance)
+        : m_geometries(std::move(geometries))
+        , m_transform(*ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform))
+        , m_flatteningTolerance(flatteningTolerance)
+        , m_results(m_geometries.size())
+    {
+    }
+
+    // Runs on the async operation's worker thread, and returns once every
+    // geometry has been tessellated. Fails with the first error any of the
+    // workers ran into.
+    ComPtr<CanvasGeometryTessellation> Run(uint32_t maximumParallelism)
+    {
+        ThrowIfFailed(ParallelFor(static_cast<uint32_t>(m_geometries.size()), maximumParallelism,
+            [&](uint32_t index)
+            {
+                auto tessellationSink = Make<TessellationSink>();
+                CheckMakeResult(tessellationSink);
+
+                ThrowIfFailed(m_geometries[index]->Tessellate(
+                    &m_transform,
+                    m_flatteningTolerance,
+                    tessellationSink.Get()));
+
+                m_results[index] = tessellationSink->TakeTriangles();
+            }));
+
+        return PackResults();
+    }
+
+private:
+    ComPtr<CanvasGeometryTessellation> PackResults()
+    {
+        std::vector<uint32_t> offsets;
+        offsets.reserve(m_results.size() + 1);
+
+        size_t totalCount = 0;
+
+        for (auto& result : m_results)
+        {
+            offsets.push_back(static_cast<uint32_t>(totalCount));
+            totalCount += result.size();
+        }
+
+        if (totalCount > UINT32_MAX)
+            ThrowHR(E_OUTOFMEMORY);
+
+        offsets.push_back(static_cast<uint32_t>(totalCount));
+
+        std::vector<CanvasTriangleVertices> triangles;
+        triangles.reserve(totalCount);
+
+        for (auto& result : m_results)
+        {
+            triangles.insert(triangles.end(), result.begin(), result.end());
+
+            // Free each one as we go, so the peak size is not double the result.
+            std::vector<CanvasTriangleVertices>().swap(result);
+        }
+
+        auto tessellation = Make<CanvasGeometryTessellation>(std::move(triangles), std::move(offsets));
+        CheckMakeResult(tessellation);
+
+        return tessellation;
+    }
+};
+
+static std::vector<ComPtr<ID2D1Geometry>> GetBatchGeometries(IIterable<CanvasGeometry*>* geometries)
+{
+    std::vector<ComPtr<ID2D1Geometry>> d2dGeometries;
+
+    ComPtr<IIterator<CanvasGeometry*>> iterator;
+    ThrowIfFailed(geometries->First(&iterator));
+
+    boolean hasCurrent;
+    ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+    while (hasCurrent)
+    {
+        ComPtr<ICanvasGeometry> geometry;
+        ThrowIfFailed(iterator->get_Current(&geometry));
+
+        CheckInPointer(geometry.Get());
+
+        d2dGeometries.push_back(GetWrappedResource<ID2D1Geometry>(geometry));
+
+        ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+    }
+
+    if (d2dGeometries.size() > INT32_MAX)
+        ThrowHR(E_INVALIDARG);
+
+    return d2dGeometries;
+}
+
+IFACEMETHODIMP CanvasGeometryFactory::TessellateManyAsync(
+    IIterable<CanvasGeometry*>* geometries,
+    IAsyncOperation<CanvasGeometryTessellation*>** tessellationAsyncOperation)
+{
+    return TessellateManyAsyncWithOptions(
+        geometries,
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        0,
+        tessellationAsyncOperation);
+}
+
+IFACEMETHODIMP CanvasGeometryFactory::TessellateManyAsyncWithOptions(
+    IIterable<CanvasGeometry*>* geometries,
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    int32_t maximumParallelism,
+    IAsyncOperation<CanvasGeometryTessellation*>** tessellationAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometries);
+            CheckAndClearOutPointer(tessellationAsyncOperation);
+
+            if (maximumParallelism < 0)
+                ThrowHR(E_INVALIDARG);
+
+            uint32_t parallelism = maximumParallelism ? static_cast<uint32_t>(maximumParallelism)
+                                                      : std::max(std::thread::hardware_concurrency(), 1U);
+
+            parallelism = AsyncScheduler::GetInstance().LimitParallelism(parallelism);
+
+            // The D2D geometries are looked up here on the calling thread, so
+            // a geometry being closed partway through can't affect the workers.
+            auto tessellator = std::make_shared<CanvasGeometryBatchTessellator>(
+                GetBatchGeometries(geometries),
+                transform,
+                flatteningTolerance);
+
+            auto asyncOperation = Make<AsyncOperation<CanvasGeometryTessellation>>(
+                [=]
+                {
+                    return tessellator->Run(parallelism);
+                });
+
+            CheckMakeResult(asyncOperation);
+            ThrowIfFailed(asyncOperation.CopyTo(tessellationAsyncOperation));
+        });
+}
+
+
+CanvasGeometryTessellation::CanvasGeometryTessellation(
+    std::vector<CanvasTriangleVertices>&& triangles,
+    std::vector<uint32_t>&& triangleOffsets)
+    : m_triangles(std::move(triangles))
+    , m_triangleOffsets(std::move(triangleOffsets))
+{
+}
+
+IFACEMETHODIMP CanvasGeometryTessellation::GetTriangles(
+    uint32_t* trianglesCount,
+    CanvasTriangleVertices** triangles)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(trianglesCount);
+            CheckAndClearOutPointer(triangles);
+
+            ComArray<CanvasTriangleVertices> array(m_triangles.begin(), m_triangles.end());
+            array.Detach(trianglesCount, triangles);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometryTessellation::GetTriangleOffsets(
+    uint32_t* offsetsCount,
+    uint32_t** offsets)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(offsetsCount);
+            CheckAndClearOutPointer(offsets);
+
+            ComArray<uint32_t> array(m_triangleOffsets.begin(), m_triangleOffsets.end());
+            array.Detach(offsetsCount, offsets);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometryTessellation::get_GeometryCount(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = static_cast<uint32_t>(m_triangleOffsets.size() - 1);
+        });
+}
+
 CanvasGeometry::CanvasGeometry(GeometryDevicePtr const& device, ID2D1Geometry* d2dGeometry)
     : ResourceWrapper(d2dGeometry)
     , m_device(device)
 {
 }
 
+CanvasGeometry::CanvasGeometry(GeometryDevicePtr const& device, ID2D1Geometry* d2dGeometry, std::shared_ptr<PolylineGeometry const> const& polylines)
+    : ResourceWrapper(d2dGeometry)
+    , m_device(device)
+    , m_polylines(polylines && !polylines->IsEmpty() ? polylines : nullptr)
+{
+}
+
+ComPtr<CanvasGeometry> CanvasGeometry::CreateShared(
+    ICanvasDevice* device,
+    ID2D1Geometry* d2dGeometry)
+{
+    auto canvasGeometry = Make<CanvasGeometry>(device, nullptr);
+    CheckMakeResult(canvasGeometry);
+
+    canvasGeometry->SetSharedResource(d2dGeometry);
+
+    return canvasGeometry;
+}
+
 CanvasGeometry::CanvasGeometry(ICanvasDevice* device, ID2D1Geometry* d2dGeometry)
     : ResourceWrapper(d2dGeometry)
     , m_device(device)
@@ -704,6 +1042,209 @@ IFACEMETHODIMP CanvasGeometry::Transform(
         });
 }
 
+IFACEMETHODIMP CanvasGeometry::CombineWithAsync(
+    ICanvasGeometry* otherGeometry,
+    Matrix3x2 otherGeometryTransform,
+    CanvasGeometryCombine combine,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return CombineWithUsingFlatteningToleranceAsync(
+        otherGeometry,
+        otherGeometryTransform,
+        combine,
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        geometryAsyncOperation);
+}
+
+IFACEMETHODIMP CanvasGeometry::CombineWithUsingFlatteningToleranceAsync(
+    ICanvasGeometry* otherGeometry,
+    Matrix3x2 otherGeometryTransform,
+    CanvasGeometryCombine combine,
+    float flatteningTolerance,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(otherGeometry);
+
+            ComPtr<ID2D1Geometry> resource = GetResource();
+            auto otherResource = GetWrappedResource<ID2D1Geometry>(otherGeometry);
+
+            StartGeometryAsyncOperation(
+                [=](ID2D1GeometrySink* sink)
+                {
+                    return resource->CombineWithGeometry(
+                        otherResource.Get(),
+                        static_cast<D2D1_COMBINE_MODE>(combine),
+                        ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&otherGeometryTransform),
+                        flatteningTolerance,
+                        sink);
+                },
+                geometryAsyncOperation);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometry::StrokeAsync(
+    float strokeWidth,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            StrokeAsyncImpl(strokeWidth, nullptr, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE, geometryAsyncOperation);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometry::StrokeWithStrokeStyleAsync(
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(strokeStyle);
+            StrokeAsyncImpl(strokeWidth, strokeStyle, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE, geometryAsyncOperation);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometry::StrokeWithAllOptionsAsync(
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(strokeStyle);
+            StrokeAsyncImpl(strokeWidth, strokeStyle, &transform, flatteningTolerance, geometryAsyncOperation);
+        });
+}
+
+void CanvasGeometry::StrokeAsyncImpl(
+    float strokeWidth,
+    ICanvasStrokeStyle* strokeStyle,
+    Matrix3x2* transform,
+    float flatteningTolerance,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    ComPtr<ID2D1Geometry> resource = GetResource();
+
+    // The stroke style is realized now, so later changes to it don't affect
+    // an operation that is already running.
+    auto d2dStrokeStyle = MaybeGetStrokeStyleResource(resource.Get(), strokeStyle);
+
+    bool hasTransform = transform != nullptr;
+    auto d2dTransform = hasTransform ? *ReinterpretAs<D2D1_MATRIX_3X2_F*>(transform) : D2D1::Matrix3x2F::Identity();
+
+    StartGeometryAsyncOperation(
+        [=](ID2D1GeometrySink* sink)
+        {
+            return resource->Widen(
+                strokeWidth,
+                d2dStrokeStyle.Get(),
+                hasTransform ? &d2dTransform : nullptr,
+                flatteningTolerance,
+                sink);
+        },
+        geometryAsyncOperation);
+}
+
+IFACEMETHODIMP CanvasGeometry::OutlineAsync(
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return OutlineWithTransformAndFlatteningToleranceAsync(
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        geometryAsyncOperation);
+}
+
+IFACEMETHODIMP CanvasGeometry::OutlineWithTransformAndFlatteningToleranceAsync(
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            ComPtr<ID2D1Geometry> resource = GetResource();
+
+            StartGeometryAsyncOperation(
+                [=](ID2D1GeometrySink* sink)
+                {
+                    return resource->Outline(
+                        ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform),
+                        flatteningTolerance,
+                        sink);
+                },
+                geometryAsyncOperation);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometry::SimplifyAsync(
+    CanvasGeometrySimplification simplification,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return SimplifyWithTransformAndFlatteningToleranceAsync(
+        simplification,
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        geometryAsyncOperation);
+}
+
+IFACEMETHODIMP CanvasGeometry::SimplifyWithTransformAndFlatteningToleranceAsync(
+    CanvasGeometrySimplification simplification,
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            ComPtr<ID2D1Geometry> resource = GetResource();
+
+            StartGeometryAsyncOperation(
+                [=](ID2D1GeometrySink* sink)
+                {
+                    return resource->Simplify(
+                        static_cast<D2D1_GEOMETRY_SIMPLIFICATION_OPTION>(simplification),
+                        ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform),
+                        flatteningTolerance,
+                        sink);
+                },
+                geometryAsyncOperation);
+        });
+}
+
+void CanvasGeometry::StartGeometryAsyncOperation(
+    std::function<HRESULT(ID2D1GeometrySink*)>&& writeToSink,
+    IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation)
+{
+    CheckAndClearOutPointer(geometryAsyncOperation);
+
+    // D2D factories created by CanvasDevice are multithreaded, so building
+    // the new path geometry on a worker thread is safe.
+    auto device = m_device.EnsureNotClosed();
+
+    auto asyncOperation = Make<AsyncOperation<CanvasGeometry>>(
+        [device, writeToSink]
+        {
+            auto temporaryPathBuilder = Make<CanvasPathBuilder>(device);
+            CheckMakeResult(temporaryPathBuilder);
+            auto targetPathBuilderInternal = As<ICanvasPathBuilderInternal>(temporaryPathBuilder);
+
+            ThrowIfFailed(writeToSink(targetPathBuilderInternal->GetGeometrySink().Get()));
+
+            return CanvasGeometry::CreateNew(temporaryPathBuilder.Get());
+        });
+
+    CheckMakeResult(asyncOperation);
+    ThrowIfFailed(asyncOperation.CopyTo(geometryAsyncOperation));
+}
+
 IFACEMETHODIMP CanvasGeometry::CompareWith(
     ICanvasGeometry* otherGeometry,
     CanvasGeometryRelation* relation)
@@ -772,13 +1313,27 @@ IFACEMETHODIMP CanvasGeometry::ComputeAreaWithTransformAndFlatteningTolerance(
 
             auto& resource = GetResource();
 
+            GeometryMetricsKey key{ *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform), flatteningTolerance };
+
+            {
+                Lock lock(m_metricsMutex);
+
+                if (m_metricsCache.Area.TryGet(key, area))
+                    return;
+            }
+
             FLOAT d2dArea;
 
             ThrowIfFailed(resource->ComputeArea(
-                ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform),
+                &key.Transform,
                 flatteningTolerance, 
                 &d2dArea));
 
+            {
+                Lock lock(m_metricsMutex);
+                m_metricsCache.Area.Set(key, d2dArea);
+            }
+
             *area = d2dArea;
         });
 }
@@ -804,12 +1359,33 @@ IFACEMETHODIMP CanvasGeometry::ComputePathLengthWithTransformAndFlatteningTolera
 
             auto& resource = GetResource();
 
+            GeometryMetricsKey key{ *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform), flatteningTolerance };
+
+            {
+                Lock lock(m_metricsMutex);
+
+                if (m_metricsCache.Length.TryGet(key, length))
+                    return;
+            }
+
             FLOAT d2dLength;
 
-            ThrowIfFailed(resource->ComputeLength(
-                ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform),
-                flatteningTolerance, 
-                &d2dLength));
+            if (m_polylines)
+            {
+                d2dLength = m_polylines->ComputeLength(key.Transform);
+            }
+            else
+            {
+                ThrowIfFailed(resource->ComputeLength(
+                    &key.Transform,
+                    flatteningTolerance, 
+                    &d2dLength));
+            }
+
+            {
+                Lock lock(m_metricsMutex);
+                m_metricsCache.Length.Set(key, d2dLength);
+            }
 
             *length = d2dLength;
         });
@@ -869,15 +1445,51 @@ void CanvasGeometry::ComputePointOnPathImpl(
 
     auto& resource = GetResource();
 
+    auto d2dTransform = ReinterpretAs<D2D1_MATRIX_3X2_F*>(transform);
+
+    GeometryMetricsKey key{ d2dTransform ? *d2dTransform : D2D1::Matrix3x2F::Identity(), flatteningTolerance };
+
+    // Once the same transform and tolerance have been asked about twice in a
+    // row, flatten the path once and look up points in that from then on.
+    // Geometry made of lines is cheap to flatten, so that's done straight away.
+    std::shared_ptr<FlattenedGeometry const> flattenedGeometry;
+    bool shouldFlatten = false;
+
+    {
+        Lock lock(m_metricsMutex);
+
+        if (!m_metricsCache.Flattened.TryGet(key, &flattenedGeometry))
+        {
+            bool unused;
+            shouldFlatten = m_metricsCache.LastPointOnPath.TryGet(key, &unused) || m_polylines != nullptr;
+
+            m_metricsCache.LastPointOnPath.Set(key, true);
+        }
+    }
+
+    if (shouldFlatten)
+    {
+        if (m_polylines)
+            flattenedGeometry = std::make_shared<FlattenedGeometry>(*m_polylines, key.Transform);
+        else
+            flattenedGeometry = std::make_shared<FlattenedGeometry>(resource.Get(), d2dTransform, flatteningTolerance);
+
+        Lock lock(m_metricsMutex);
+        m_metricsCache.Flattened.Set(key, flattenedGeometry);
+    }
+
     D2D1_POINT_2F d2dPoint;
     D2D1_POINT_2F d2dUnitTangentVector;
 
-    ThrowIfFailed(resource->ComputePointAtLength(
-        distance,
-        ReinterpretAs<D2D1_MATRIX_3X2_F*>(transform),
-        flatteningTolerance,
-        &d2dPoint,
-        &d2dUnitTangentVector));
+    if (!flattenedGeometry || !flattenedGeometry->TryComputePointAtLength(distance, &d2dPoint, &d2dUnitTangentVector))
+    {
+        ThrowIfFailed(resource->ComputePointAtLength(
+            distance,
+            d2dTransform,
+            flatteningTolerance,
+            &d2dPoint,
+            &d2dUnitTangentVector));
+    }
 
     *point = FromD2DPoint(d2dPoint);
 
@@ -940,11 +1552,32 @@ IFACEMETHODIMP CanvasGeometry::ComputeBoundsWithTransform(
 
             auto& resource = GetResource();
 
+            GeometryMetricsKey key{ *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform), 0 };
+
             D2D1_RECT_F d2dBounds;
+            bool isCached;
 
-            ThrowIfFailed(resource->GetBounds(
-                ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform),
-                &d2dBounds));
+            {
+                Lock lock(m_metricsMutex);
+                isCached = m_metricsCache.Bounds.TryGet(key, &d2dBounds);
+            }
+
+            if (!isCached)
+            {
+                if (m_polylines)
+                {
+                    d2dBounds = m_polylines->ComputeBounds(key.Transform);
+                }
+                else
+                {
+                    ThrowIfFailed(resource->GetBounds(
+                        &key.Transform,
+                        &d2dBounds));
+                }
+
+                Lock lock(m_metricsMutex);
+                m_metricsCache.Bounds.Set(key, d2dBounds);
+            }
 
             *bounds = FromD2DRect(d2dBounds);
         });
@@ -1106,16 +1739,79 @@ IFACEMETHODIMP CanvasGeometry::TessellateWithTransformAndFlatteningTolerance(
         auto tessellationSink = Make<TessellationSink>();
         CheckMakeResult(tessellationSink);
 
+        uint32_t triangleCount = 0;
+        EventWrite_CanvasGeometry_Tessellate_Start();
+        auto tessellateEnd = MakeScopeWarden([&] { EventWrite_CanvasGeometry_Tessellate_Stop(triangleCount); });
+
         ThrowIfFailed(resource->Tessellate(
             ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform),
             flatteningTolerance,
             tessellationSink.Get()));
 
         auto outputArray = tessellationSink->GetTriangles();
+        triangleCount = outputArray.GetSize();
         outputArray.Detach(trianglesCount, triangles);
     });
 }
 
+IFACEMETHODIMP CanvasGeometry::TessellateToBuffer(
+    IBuffer* buffer,
+    UINT32* trianglesCount)
+{
+    return TessellateToBufferWithTransformAndFlatteningTolerance(
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        buffer,
+        trianglesCount);
+}
+
+IFACEMETHODIMP CanvasGeometry::TessellateToBufferWithTransformAndFlatteningTolerance(
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    IBuffer* buffer,
+    UINT32* trianglesCount)
+{
+    using ::Windows::Storage::Streams::IBufferByteAccess;
+
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(buffer);
+        CheckInPointer(trianglesCount);
+
+        auto& resource = GetResource();
+
+        uint32_t capacity;
+        ThrowIfFailed(buffer->get_Capacity(&capacity));
+
+        uint8_t* bytes;
+        ThrowIfFailed(As<IBufferByteAccess>(buffer)->Buffer(&bytes));
+
+        auto tessellationSink = Make<BufferTessellationSink>(
+            reinterpret_cast<CanvasTriangleVertices*>(bytes),
+            capacity / static_cast<uint32_t>(sizeof(CanvasTriangleVertices)));
+        CheckMakeResult(tessellationSink);
+
+        uint32_t triangleCount = 0;
+        EventWrite_CanvasGeometry_Tessellate_Start();
+        auto tessellateEnd = MakeScopeWarden([&] { EventWrite_CanvasGeometry_Tessellate_Stop(triangleCount); });
+
+        ThrowIfFailed(resource->Tessellate(
+            ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform),
+            flatteningTolerance,
+            tessellationSink.Get()));
+
+        auto count = tessellationSink->GetCount();
+        triangleCount = count;
+
+        if (tessellationSink->Overflowed())
+            ThrowIfFailed(buffer->put_Length(0));
+        else
+            ThrowIfFailed(buffer->put_Length(count * static_cast<uint32_t>(sizeof(CanvasTriangleVertices))));
+
+        *trianglesCount = count;
+    });
+}
+
 IFACEMETHODIMP CanvasGeometry::SendPathTo(
     ICanvasPathReceiver* streamReader)
 {
@@ -1145,6 +1841,52 @@ IFACEMETHODIMP CanvasGeometry::SendPathTo(
     });
 }
 
+IFACEMETHODIMP CanvasGeometry::GetPathData(
+    uint32_t* commandCount,
+    CanvasGeometryPathCommand** commands,
+    uint32_t* segmentDataCount,
+    float** segmentData)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(commandCount);
+        CheckAndClearOutPointer(commands);
+        CheckInPointer(segmentDataCount);
+        CheckAndClearOutPointer(segmentData);
+
+        auto& resource = GetResource();
+
+        auto pathGeometry = MaybeAs<ID2D1PathGeometry>(resource);
+
+        auto pathDataSink = Make<PathDataSink>();
+        CheckMakeResult(pathDataSink);
+
+        // Same as SendPathTo: path geometries are streamed as they are,
+        // anything else is simplified to cubics and lines.
+        if (pathGeometry)
+        {
+            ThrowIfFailed(pathGeometry->Stream(pathDataSink.Get()));
+        }
+        else
+        {
+            ThrowIfFailed(resource->Simplify(
+                D2D1_GEOMETRY_SIMPLIFICATION_OPTION_CUBICS_AND_LINES,
+                nullptr,
+                pathDataSink.Get()));
+        }
+        ThrowIfFailed(pathDataSink->Close());
+
+        auto& sinkCommands = pathDataSink->GetCommands();
+        auto& sinkSegmentData = pathDataSink->GetSegmentData();
+
+        ComArray<CanvasGeometryPathCommand> commandArray(sinkCommands.begin(), sinkCommands.end());
+        ComArray<float> segmentDataArray(sinkSegmentData.begin(), sinkSegmentData.end());
+
+        commandArray.Detach(commandCount, commands);
+        segmentDataArray.Detach(segmentDataCount, segmentData);
+    });
+}
+
 IFACEMETHODIMP CanvasGeometry::GetGeometry(
     ID2D1Geometry** geometry)
 {
@@ -1241,11 +1983,14 @@ ComPtr<CanvasGeometry> CanvasGeometry::CreateNew(
 
     auto device = pathBuilderInternal->GetGeometryDevice();
 
+    auto polylines = pathBuilderInternal->GetPolylines();
+
     auto d2dGeometry = pathBuilderInternal->CloseAndReturnPath();
 
     auto canvasGeometry = Make<CanvasGeometry>(
         device,
-        d2dGeometry.Get());
+        d2dGeometry.Get(),
+        polylines);
     CheckMakeResult(canvasGeometry);
 
     return canvasGeometry;
@@ -1268,20 +2013,112 @@ ComPtr<CanvasGeometry> CanvasGeometry::CreateNew(
     ComPtr<ID2D1GeometrySink> geometrySink;
     ThrowIfFailed(pathGeometry->Open(&geometrySink));
 
+    auto polylines = std::make_shared<PolylineGeometry>();
+
     if (pointCount > 0)
     {
-        geometrySink->BeginFigure(ToD2DPoint(points[0]), D2D1_FIGURE_BEGIN_FILLED);
+        auto d2dPoints = ReinterpretAs<D2D1_POINT_2F*>(points);
+
+        geometrySink->BeginFigure(d2dPoints[0], D2D1_FIGURE_BEGIN_FILLED);
+        polylines->BeginFigure(d2dPoints[0]);
 
-        for (uint32_t i = 1; i < pointCount; i++)
+        if (pointCount > 1)
         {
-            geometrySink->AddLine(ToD2DPoint(points[i]));
+            geometrySink->AddLines(d2dPoints + 1, pointCount - 1);
+            polylines->AddLines(d2dPoints + 1, pointCount - 1);
         }
 
         geometrySink->EndFigure(D2D1_FIGURE_END_CLOSED);
+        polylines->EndFigure(D2D1_FIGURE_END_CLOSED);
+    }
+
+    ThrowIfFailed(geometrySink->Close());
+
+    auto canvasGeometry = Make<CanvasGeometry>(device, pathGeometry.Get(), polylines);
+    CheckMakeResult(canvasGeometry);
+
+    return canvasGeometry;
+}
+
+ComPtr<CanvasGeometry> CanvasGeometry::CreateNew(
+    ICanvasResourceCreator* resourceCreator,
+    uint32_t pointCount,
+    Vector2* points,
+    uint32_t figureOffsetsCount,
+    uint32_t* figureOffsets,
+    CanvasFigureLoop figureLoop)
+{
+    if (pointCount > 0)
+        CheckInPointer(points);
+
+    if (figureOffsetsCount > 0)
+    {
+        CheckInPointer(figureOffsets);
+
+        if (figureOffsets[0] != 0)
+            ThrowHR(E_INVALIDARG, Strings::InvalidFigureOffsets);
+
+        for (uint32_t i = 0; i < figureOffsetsCount; i++)
+        {
+            if (figureOffsets[i] >= pointCount || (i > 0 && figureOffsets[i] <= figureOffsets[i - 1]))
+                ThrowHR(E_INVALIDARG, Strings::InvalidFigureOffsets);
+        }
+    }
+
+    GeometryDevicePtr device(resourceCreator);
+
+    auto pathGeometry = GeometryAdapter::GetInstance()->CreatePathGeometry(device);
+
+    ComPtr<ID2D1GeometrySink> geometrySink;
+    ThrowIfFailed(pathGeometry->Open(&geometrySink));
+
+    auto polylines = std::make_shared<PolylineGeometry>();
+    auto d2dPoints = ReinterpretAs<D2D1_POINT_2F*>(points);
+    auto figureEnd = static_cast<D2D1_FIGURE_END>(figureLoop);
+
+    for (uint32_t i = 0; i < figureOffsetsCount; i++)
+    {
+        auto begin = figureOffsets[i];
+        auto end = (i + 1 < figureOffsetsCount) ? figureOffsets[i + 1] : pointCount;
+
+        geometrySink->BeginFigure(d2dPoints[begin], D2D1_FIGURE_BEGIN_FILLED);
+        polylines->BeginFigure(d2dPoints[begin]);
+
+        if (end - begin > 1)
+        {
+            geometrySink->AddLines(d2dPoints + begin + 1, end - begin - 1);
+            polylines->AddLines(d2dPoints + begin + 1, end - begin - 1);
+        }
+
+        geometrySink->EndFigure(figureEnd);
+        polylines->EndFigure(figureEnd);
     }
 
     ThrowIfFailed(geometrySink->Close());
 
+    auto canvasGeometry = Make<CanvasGeometry>(device, pathGeometry.Get(), polylines);
+    CheckMakeResult(canvasGeometry);
+
+    return canvasGeometry;
+}
+
+template<typename CHAR>
+ComPtr<CanvasGeometry> CanvasGeometry::CreateFromPathData(
+    ICanvasResourceCreator* resourceCreator,
+    uint32_t length,
+    CHAR const* pathData)
+{
+    GeometryDevicePtr device(resourceCreator);
+
+    auto pathGeometry = GeometryAdapter::GetInstance()->CreatePathGeometry(device);
+
+    ComPtr<ID2D1GeometrySink> geometrySink;
+    ThrowIfFailed(pathGeometry->Open(&geometrySink));
+
+    PathDataParser<CHAR>::Parse(pathData, length, geometrySink.Get());
+
+    ThrowIfFailed(geometrySink->Close());
+
     auto canvasGeometry = Make<CanvasGeometry>(device, pathGeometry.Get());
     CheckMakeResult(canvasGeometry);
 
@@ -1294,8 +2131,6 @@ ComPtr<CanvasGeometry> CanvasGeometry::CreateNew(
     ICanvasGeometry** geometryElements,
     CanvasFilledRegionDetermination filledRegionDetermination)
 {
-    GeometryDevicePtr device(resourceCreator);
-
     std::vector<ID2D1Geometry*> d2dGeometriesRaw;
     d2dGeometriesRaw.resize(geometryCount);
 
@@ -1316,16 +2151,34 @@ ComPtr<CanvasGeometry> CanvasGeometry::CreateNew(
         d2dGeometriesRaw[i] = d2dResource.Get();
     }
 
-    if (geometryCount == 0)
+    return CreateGroupNew(
+        resourceCreator,
+        geometryCount,
+        d2dGeometriesRaw.data(),
+        filledRegionDetermination);
+}
+
+ComPtr<CanvasGeometry> CanvasGeometry::CreateGroupNew(
+    ICanvasResourceCreator* resourceCreator,
+    uint32_t d2dGeometryCount,
+    ID2D1Geometry** d2dGeometries,
+    CanvasFilledRegionDetermination filledRegionDetermination)
+{
+    GeometryDevicePtr device(resourceCreator);
+
+    // D2D still wants a valid array pointer when the group is empty.
+    ID2D1Geometry* emptyGroup[] = { nullptr };
+
+    if (d2dGeometryCount == 0)
     {
-        d2dGeometriesRaw.push_back(nullptr);
+        d2dGeometries = emptyGroup;
     }
 
     auto d2dGeometry = GeometryAdapter::GetInstance()->CreateGeometryGroup(
         device,
         static_cast<D2D1_FILL_MODE>(filledRegionDetermination),
-        &d2dGeometriesRaw[0], 
-        geometryCount);
+        d2dGeometries,
+        d2dGeometryCount);
 
     auto canvasGeometry = Make<CanvasGeometry>(
         device,
@@ -1349,15 +2202,7 @@ static ComPtr<ID2D1TransformedGeometry> GetGlyphRunGeometry(
     ComPtr<ID2D1GeometrySink> d2dGeometrySink;
     ThrowIfFailed(d2dPathGeometry->Open(&d2dGeometrySink));
 
-    ThrowIfFailed(glyphRun->fontFace->GetGlyphRunOutline(
-        glyphRun->fontEmSize,
-        glyphRun->glyphIndices,
-        glyphRun->glyphAdvances,
-        glyphRun->glyphOffsets,
-        glyphRun->glyphCount,
-        glyphRun->isSideways,
-        glyphRun->bidiLevel % 2,
-        d2dGeometrySink.Get()));
+    GlyphOutlineCache::GetInstance()->GetGlyphRunOutline(glyphRun, d2dGeometrySink.Get());
 
     ThrowIfFailed(d2dGeometrySink->Close());
 
@@ -1759,6 +2604,99 @@ ComPtr<CanvasGeometry> CanvasGeometry::CreateNew(
     return canvasGeometry;
 }
 
+std::vector<ComPtr<CanvasGeometry>> CanvasGeometry::CreateInkBatch(
+    ICanvasResourceCreator* resourceCreator,
+    IIterable<IIterable<InkStroke*>*>* inkStrokeSets,
+    Matrix3x2 transform,
+    float flatteningTolerance)
+{
+    GeometryDevicePtr device(resourceCreator);
+
+    // Draw every stroke set into the same temporary command list, tagging
+    // each one with its position in the batch. This shares one drawing
+    // session and ink renderer between them all, and lets a single streaming
+    // pass separate the sets back out again.
+    auto commandList = CanvasCommandList::CreateNew(device.GetCanvasDevice().Get());
+
+    ComPtr<ICanvasDrawingSession> drawingSession;
+    ThrowIfFailed(commandList->CreateDrawingSession(&drawingSession));
+
+    auto deviceContext = GetWrappedResource<ID2D1DeviceContext1>(drawingSession);
+
+    ComPtr<IIterator<IIterable<InkStroke*>*>> iterator;
+    ThrowIfFailed(inkStrokeSets->First(&iterator));
+
+    boolean hasCurrent;
+    ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+    D2D1_TAG setCount = 0;
+
+    while (hasCurrent)
+    {
+        ComPtr<IIterable<InkStroke*>> inkStrokes;
+        ThrowIfFailed(iterator->get_Current(&inkStrokes));
+        CheckInPointer(inkStrokes.Get());
+
+        deviceContext->SetTags(++setCount, 0);
+
+        ThrowIfFailed(drawingSession->DrawInkWithHighContrast(inkStrokes.Get(), false));
+
+        ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+    }
+
+    deviceContext->SetTags(0, 0);
+
+    deviceContext.Reset();
+    drawingSession.Reset();
+
+    // Create a path geometry for each stroke set, and open their geometry sinks.
+    std::vector<ComPtr<ID2D1PathGeometry1>> pathGeometries;
+    std::vector<ComPtr<ID2D1GeometrySink>> geometrySinks;
+
+    pathGeometries.reserve(static_cast<size_t>(setCount));
+    geometrySinks.reserve(static_cast<size_t>(setCount));
+
+    for (D2D1_TAG i = 0; i < setCount; i++)
+    {
+        auto pathGeometry = GeometryAdapter::GetInstance()->CreatePathGeometry(device);
+
+        ComPtr<ID2D1GeometrySink> geometrySink;
+        ThrowIfFailed(pathGeometry->Open(&geometrySink));
+
+        pathGeometries.push_back(std::move(pathGeometry));
+        geometrySinks.push_back(std::move(geometrySink));
+    }
+
+    auto commandSink = Make<InkToGeometryCommandSink>(transform, flatteningTolerance, geometrySinks);
+    CheckMakeResult(commandSink);
+
+    auto d2dCommandList = GetWrappedResource<ID2D1CommandList>(commandList);
+
+    ThrowIfFailed(d2dCommandList->Close());
+
+    ThrowIfFailed(d2dCommandList->Stream(commandSink.Get()));
+
+    ThrowIfFailed(commandSink->GetResult());
+
+    for (auto& geometrySink : geometrySinks)
+    {
+        ThrowIfFailed(geometrySink->Close());
+    }
+
+    std::vector<ComPtr<CanvasGeometry>> canvasGeometries;
+    canvasGeometries.reserve(pathGeometries.size());
+
+    for (auto& pathGeometry : pathGeometries)
+    {
+        auto canvasGeometry = Make<CanvasGeometry>(device, pathGeometry.Get());
+        CheckMakeResult(canvasGeometry);
+
+        canvasGeometries.push_back(std::move(canvasGeometry));
+    }
+
+    return canvasGeometries;
+}
+
 #endif
 
 ActivatableClassWithFactory(CanvasGeometry, CanvasGeometryFactory);
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "drawing/CanvasStrokeStyle.h"
+#include "geometry/GeometryMetricsCache.h"
+#include "geometry/GlyphOutlineCache.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
 {
@@ -13,6 +15,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     class GeometryAdapter;
     class DefaultGeometryAdapter;
+    class CanvasGeometryTessellation;
 
 
     // When geometry is used without an associated CanvasDevice, this singleton provides
@@ -83,11 +86,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ABI::Windows::Graphics::IGeometrySource2D,
         ABI::Windows::Graphics::IGeometrySource2DInterop,
         CloakedIid<ICanvasResourceWrapperWithDevice>)
+        , private ObjectCounter<CountedObjectType::Geometry>
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometry, BaseTrust);
 
         GeometryDevicePtr m_device;
 
+        std::mutex m_metricsMutex;
+        GeometryMetricsCache m_metricsCache;
+
+        // Set when the geometry is known to contain only lines. Never
+        // changes once the geometry has been handed out.
+        std::shared_ptr<PolylineGeometry const> m_polylines;
+
     public:
         static ComPtr<CanvasGeometry> CreateNew(
             ICanvasResourceCreator* device,
@@ -113,12 +124,34 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             uint32_t pointCount,
             Vector2* points);
 
+        static ComPtr<CanvasGeometry> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t pointCount,
+            Vector2* points,
+            uint32_t figureOffsetsCount,
+            uint32_t* figureOffsets,
+            CanvasFigureLoop figureLoop);
+
+        template<typename CHAR>
+        static ComPtr<CanvasGeometry> CreateFromPathData(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t length,
+            CHAR const* pathData);
+
         static ComPtr<CanvasGeometry> CreateNew(
             ICanvasResourceCreator* resourceCreator,
             uint32_t geometryCount,
             ICanvasGeometry** geometryElements,
             CanvasFilledRegionDetermination filledRegionDetermination);
 
+        // Builds a group straight from D2D geometries the caller has already
+        // resolved, so callers can reuse the same array across rebuilds.
+        static ComPtr<CanvasGeometry> CreateGroupNew(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t d2dGeometryCount,
+            ID2D1Geometry** d2dGeometries,
+            CanvasFilledRegionDetermination filledRegionDetermination);
+
         static ComPtr<CanvasGeometry> CreateNew(
             ICanvasTextLayout* textLayout);
 
@@ -140,11 +173,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             IIterable<InkStroke*>* inkStrokes,
             Matrix3x2 transform,
             float flatteningTolerance);
+
+        static std::vector<ComPtr<CanvasGeometry>> CreateInkBatch(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<IIterable<InkStroke*>*>* inkStrokeSets,
+            Matrix3x2 transform,
+            float flatteningTolerance);
 #endif
 
+        // Wraps a geometry that other CanvasGeometry objects may be wrapping
+        // too, so closing one of them doesn't affect the rest.  Only for
+        // geometries that can't change, such as closed path geometries.
+        static ComPtr<CanvasGeometry> CreateShared(
+            ICanvasDevice* device,
+            ID2D1Geometry* d2dGeometry);
+
         CanvasGeometry(GeometryDevicePtr const& device, ID2D1Geometry* d2dGeometry);
         CanvasGeometry(ICanvasDevice* device, ID2D1Geometry* d2dGeometry);
 
+        // For geometry made only of lines, whose source points are kept so
+        // metric queries can skip D2D's flattening.
+        CanvasGeometry(GeometryDevicePtr const& device, ID2D1Geometry* d2dGeometry, std::shared_ptr<PolylineGeometry const> const& polylines);
+
         IFACEMETHOD(Close)();
 
         IFACEMETHOD(get_Device)(ICanvasDevice** device);
@@ -200,6 +250,53 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             Numerics::Matrix3x2 transform,
             ICanvasGeometry** geometry) override;
 
+        IFACEMETHOD(CombineWithAsync)(
+            ICanvasGeometry* otherGeometry,
+            Matrix3x2 otherGeometryTransform,
+            CanvasGeometryCombine combine,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(CombineWithUsingFlatteningToleranceAsync)(
+            ICanvasGeometry* otherGeometry,
+            Matrix3x2 otherGeometryTransform,
+            CanvasGeometryCombine combine,
+            float flatteningTolerance,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(StrokeAsync)(
+            float strokeWidth,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(StrokeWithStrokeStyleAsync)(
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(StrokeWithAllOptionsAsync)(
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(OutlineAsync)(
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(OutlineWithTransformAndFlatteningToleranceAsync)(
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(SimplifyAsync)(
+            CanvasGeometrySimplification simplification,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
+        IFACEMETHOD(SimplifyWithTransformAndFlatteningToleranceAsync)(
+            CanvasGeometrySimplification simplification,
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation) override;
+
         IFACEMETHOD(CompareWith)(
             ICanvasGeometry* otherGeometry,
             CanvasGeometryRelation* relation) override;
@@ -304,9 +401,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             UINT32* trianglesCount,
             CanvasTriangleVertices** triangles) override;
 
+        IFACEMETHOD(TessellateToBuffer)(
+            IBuffer* buffer,
+            UINT32* trianglesCount) override;
+
+        IFACEMETHOD(TessellateToBufferWithTransformAndFlatteningTolerance)(
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            IBuffer* buffer,
+            UINT32* trianglesCount) override;
+
         IFACEMETHOD(SendPathTo)(
             ICanvasPathReceiver* streamReader) override;
 
+        IFACEMETHOD(GetPathData)(
+            uint32_t* commandCount,
+            CanvasGeometryPathCommand** commands,
+            uint32_t* segmentDataCount,
+            float** segmentData) override;
+
         // IGeometrySource2DInterop
         IFACEMETHOD(GetGeometry)(
             ID2D1Geometry** geometry) override;
@@ -323,6 +436,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float flatteningTolerance,
             ICanvasGeometry** geometry);
 
+        void StrokeAsyncImpl(
+            float strokeWidth,
+            ICanvasStrokeStyle* strokeStyle,
+            Matrix3x2* transform,
+            float flatteningTolerance,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation);
+
+        // Starts an async operation that creates a new path geometry on this
+        // geometry's device, and has writeToSink fill it in.
+        void StartGeometryAsyncOperation(
+            std::function<HRESULT(ID2D1GeometrySink*)>&& writeToSink,
+            IAsyncOperation<CanvasGeometry*>** geometryAsyncOperation);
+
         void StrokeImpl(
             float strokeWidth,
             ICanvasStrokeStyle* strokeStyle,
@@ -360,7 +486,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometry, BaseTrust);
 
+        // Keeps glyph outlines cached for as long as geometry can be created, rather
+        // than only while a glyph run is being converted.
+        std::shared_ptr<GlyphOutlineCache> m_glyphOutlineCache;
+
     public:
+        CanvasGeometryFactory();
+
         IFACEMETHOD(CreateRectangle)(
             ICanvasResourceCreator* resourceCreator,
             Rect rect,
@@ -429,6 +561,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             Numerics::Vector2* points,
             ICanvasGeometry** geometry) override;
 
+        IFACEMETHOD(CreatePolylines)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t pointCount,
+            Numerics::Vector2* points,
+            uint32_t figureOffsetsCount,
+            uint32_t* figureOffsets,
+            CanvasFigureLoop figureLoop,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(CreateFromPathData)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING pathData,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(CreateFromPathDataUtf8)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t pathDataCount,
+            BYTE* pathData,
+            ICanvasGeometry** geometry) override;
+
         IFACEMETHOD(CreateGroup)(
             ICanvasResourceCreator* resourceCreator,
             uint32_t geometryCount,
@@ -471,6 +623,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             Matrix3x2 transform,
             float flatteningTolerance,
             ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(CreateInkBatch)(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<IIterable<InkStroke*>*>* inkStrokeSets,
+            uint32_t* geometryCount,
+            ICanvasGeometry*** geometries) override;
+
+        IFACEMETHOD(CreateInkBatchWithTransformAndFlatteningTolerance)(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<IIterable<InkStroke*>*>* inkStrokeSets,
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            uint32_t* geometryCount,
+            ICanvasGeometry*** geometries) override;
 #endif
 
         IFACEMETHOD(ComputeFlatteningTolerance)(
@@ -485,6 +651,46 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float* flatteningTolerance) override;
 
         IFACEMETHOD(get_DefaultFlatteningTolerance)(float* theValue) override;
+
+        IFACEMETHOD(TessellateManyAsync)(
+            IIterable<CanvasGeometry*>* geometries,
+            IAsyncOperation<CanvasGeometryTessellation*>** tessellationAsyncOperation) override;
+
+        IFACEMETHOD(TessellateManyAsyncWithOptions)(
+            IIterable<CanvasGeometry*>* geometries,
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            int32_t maximumParallelism,
+            IAsyncOperation<CanvasGeometryTessellation*>** tessellationAsyncOperation) override;
+    };
+
+
+    //
+    // The triangles from TessellateManyAsync, packed into one array, along
+    // with where each geometry's triangles start.
+    //
+    class CanvasGeometryTessellation : public RuntimeClass<ICanvasGeometryTessellation>
+                                     , private LifespanTracker<CanvasGeometryTessellation>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometryTessellation, BaseTrust);
+
+        std::vector<CanvasTriangleVertices> m_triangles;
+        std::vector<uint32_t> m_triangleOffsets;
+
+    public:
+        CanvasGeometryTessellation(
+            std::vector<CanvasTriangleVertices>&& triangles,
+            std::vector<uint32_t>&& triangleOffsets);
+
+        IFACEMETHOD(GetTriangles)(
+            uint32_t* trianglesCount,
+            CanvasTriangleVertices** triangles) override;
+
+        IFACEMETHOD(GetTriangleOffsets)(
+            uint32_t* offsetsCount,
+            uint32_t** offsets) override;
+
+        IFACEMETHOD(get_GeometryCount)(uint32_t* value) override;
     };
 
     inline ComPtr<ID2D1StrokeStyle> MaybeGetStrokeStyleResource(
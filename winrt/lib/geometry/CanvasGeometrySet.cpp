@@ -0,0 +1,296 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasGeometrySet.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+// D2D reports the bounds of an empty geometry as an inverted rectangle.
+static bool IsEmptyBounds(D2D1_RECT_F const& rect)
+{
+    return !(rect.left <= rect.right && rect.top <= rect.bottom);
+}
+
+static bool BoundsIntersect(D2D1_RECT_F const& a, D2D1_RECT_F const& b)
+{
+    return a.left <= b.right && b.left <= a.right &&
+           a.top <= b.bottom && b.top <= a.bottom;
+}
+
+static D2D1_RECT_F BoundsUnion(D2D1_RECT_F const& a, D2D1_RECT_F const& b)
+{
+    return D2D1_RECT_F{ std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+}
+
+
+GeometryBoundsTree::GeometryBoundsTree(std::vector<D2D1_RECT_F>&& bounds)
+    : m_bounds(std::move(bounds))
+{
+    for (uint32_t i = 0; i < m_bounds.size(); i++)
+    {
+        if (!IsEmptyBounds(m_bounds[i]))
+            m_items.push_back(i);
+    }
+
+    if (!m_items.empty())
+    {
+        m_nodes.reserve(m_items.size() / MaxLeafSize * 2 + 1);
+
+        BuildNode(0, static_cast<uint32_t>(m_items.size()));
+    }
+}
+
+uint32_t GeometryBoundsTree::BuildNode(uint32_t firstItem, uint32_t itemCount)
+{
+    auto nodeIndex = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{});
+
+    auto bounds = m_bounds[m_items[firstItem]];
+
+    for (uint32_t i = firstItem + 1; i < firstItem + itemCount; i++)
+    {
+        bounds = BoundsUnion(bounds, m_bounds[m_items[i]]);
+    }
+
+    m_nodes[nodeIndex].Bounds = bounds;
+
+    if (itemCount <= MaxLeafSize)
+    {
+        m_nodes[nodeIndex].FirstItem = firstItem;
+        m_nodes[nodeIndex].ItemCount = itemCount;
+        return nodeIndex;
+    }
+
+    // Split at the median item center along the wider axis.
+    bool splitOnX = (bounds.right - bounds.left) >= (bounds.bottom - bounds.top);
+
+    auto begin = m_items.begin() + firstItem;
+    auto end = begin + itemCount;
+    auto firstHalfCount = itemCount / 2;
+
+    std::nth_element(begin, begin + firstHalfCount, end,
+        [&](uint32_t a, uint32_t b)
+        {
+            auto& boundsA = m_bounds[a];
+            auto& boundsB = m_bounds[b];
+
+            return splitOnX ? (boundsA.left + boundsA.right) < (boundsB.left + boundsB.right)
+                            : (boundsA.top + boundsA.bottom) < (boundsB.top + boundsB.bottom);
+        });
+
+    BuildNode(firstItem, firstHalfCount);
+
+    auto secondChild = BuildNode(firstItem + firstHalfCount, itemCount - firstHalfCount);
+    m_nodes[nodeIndex].SecondChild = secondChild;
+
+    return nodeIndex;
+}
+
+
+ComPtr<CanvasGeometrySet> CanvasGeometrySet::CreateNew(
+    uint32_t geometryCount,
+    ICanvasGeometry** geometries)
+{
+    if (geometryCount > 0)
+        CheckInPointer(geometries);
+
+    std::vector<ComPtr<ICanvasGeometry>> canvasGeometries;
+    std::vector<ComPtr<ID2D1Geometry>> d2dGeometries;
+    std::vector<D2D1_RECT_F> bounds;
+
+    canvasGeometries.reserve(geometryCount);
+    d2dGeometries.reserve(geometryCount);
+    bounds.reserve(geometryCount);
+
+    for (uint32_t i = 0; i < geometryCount; i++)
+    {
+        CheckInPointer(geometries[i]);
+
+        auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometries[i]);
+
+        D2D1_RECT_F geometryBounds;
+        ThrowIfFailed(d2dGeometry->GetBounds(nullptr, &geometryBounds));
+
+        canvasGeometries.push_back(geometries[i]);
+        d2dGeometries.push_back(std::move(d2dGeometry));
+        bounds.push_back(geometryBounds);
+    }
+
+    auto geometrySet = Make<CanvasGeometrySet>(std::move(canvasGeometries), std::move(d2dGeometries), std::move(bounds));
+    CheckMakeResult(geometrySet);
+
+    return geometrySet;
+}
+
+CanvasGeometrySet::CanvasGeometrySet(
+    std::vector<ComPtr<ICanvasGeometry>>&& geometries,
+    std::vector<ComPtr<ID2D1Geometry>>&& d2dGeometries,
+    std::vector<D2D1_RECT_F>&& bounds)
+    : m_geometries(std::move(geometries))
+    , m_d2dGeometries(std::move(d2dGeometries))
+    , m_boundsTree(std::move(bounds))
+{
+    m_d2dGeometriesRaw.reserve(m_d2dGeometries.size());
+
+    for (auto& d2dGeometry : m_d2dGeometries)
+    {
+        m_d2dGeometriesRaw.push_back(d2dGeometry.Get());
+    }
+}
+
+IFACEMETHODIMP CanvasGeometrySet::get_Count(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = static_cast<uint32_t>(m_geometries.size());
+        });
+}
+
+IFACEMETHODIMP CanvasGeometrySet::GetGeometry(
+    uint32_t index,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(geometry);
+
+            if (index >= m_geometries.size())
+                ThrowHR(E_BOUNDS);
+
+            ThrowIfFailed(m_geometries[index].CopyTo(geometry));
+        });
+}
+
+IFACEMETHODIMP CanvasGeometrySet::FindGeometriesContainingPoint(
+    Numerics::Vector2 point,
+    uint32_t* indicesCount,
+    uint32_t** indices)
+{
+    return FindGeometriesContainingPointWithFlatteningTolerance(
+        point,
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        indicesCount,
+        indices);
+}
+
+IFACEMETHODIMP CanvasGeometrySet::FindGeometriesContainingPointWithFlatteningTolerance(
+    Numerics::Vector2 point,
+    float flatteningTolerance,
+    uint32_t* indicesCount,
+    uint32_t** indices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(indicesCount);
+            CheckAndClearOutPointer(indices);
+
+            // The flattened geometry can stray outside the exact bounds by up
+            // to the tolerance, so the candidate test allows for that.
+            auto tolerance = fabs(flatteningTolerance);
+            auto queryBounds = D2D1_RECT_F{ point.X - tolerance, point.Y - tolerance, point.X + tolerance, point.Y + tolerance };
+
+            std::vector<uint32_t> hits;
+
+            m_boundsTree.Query(
+                [&](D2D1_RECT_F const& bounds) { return BoundsIntersect(bounds, queryBounds); },
+                [&](uint32_t index)
+                {
+                    BOOL containsPoint;
+                    ThrowIfFailed(m_d2dGeometries[index]->FillContainsPoint(ToD2DPoint(point), nullptr, flatteningTolerance, &containsPoint));
+
+                    if (containsPoint)
+                        hits.push_back(index);
+                });
+
+            std::sort(hits.begin(), hits.end());
+
+            ComArray<uint32_t> array(hits.begin(), hits.end());
+            array.Detach(indicesCount, indices);
+        });
+}
+
+IFACEMETHODIMP CanvasGeometrySet::FindGeometriesWithBoundsIntersecting(
+    Rect rect,
+    uint32_t* indicesCount,
+    uint32_t** indices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(indicesCount);
+            CheckAndClearOutPointer(indices);
+
+            auto queryBounds = ToD2DRect(rect);
+
+            std::vector<uint32_t> hits;
+
+            m_boundsTree.Query(
+                [&](D2D1_RECT_F const& bounds) { return BoundsIntersect(bounds, queryBounds); },
+                [&](uint32_t index) { hits.push_back(index); });
+
+            std::sort(hits.begin(), hits.end());
+
+            ComArray<uint32_t> array(hits.begin(), hits.end());
+            array.Detach(indicesCount, indices);
+        });
+}
+
+
+IFACEMETHODIMP CanvasGeometrySet::CreateGroup(
+    ICanvasResourceCreator* resourceCreator,
+    ICanvasGeometry** geometry)
+{
+    return CreateGroupWithFilledRegionDetermination(
+        resourceCreator,
+        CanvasFilledRegionDetermination::Alternate,
+        geometry);
+}
+
+IFACEMETHODIMP CanvasGeometrySet::CreateGroupWithFilledRegionDetermination(
+    ICanvasResourceCreator* resourceCreator,
+    CanvasFilledRegionDetermination filledRegionDetermination,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckAndClearOutPointer(geometry);
+
+            // The D2D geometries were resolved when the set was created, so
+            // building a group costs nothing per element beyond what D2D does.
+            auto newCanvasGeometry = CanvasGeometry::CreateGroupNew(
+                resourceCreator,
+                static_cast<uint32_t>(m_d2dGeometriesRaw.size()),
+                m_d2dGeometriesRaw.data(),
+                filledRegionDetermination);
+
+            ThrowIfFailed(newCanvasGeometry.CopyTo(geometry));
+        });
+}
+
+IFACEMETHODIMP CanvasGeometrySetFactory::Create(
+    uint32_t geometryCount,
+    ICanvasGeometry** geometries,
+    ICanvasGeometrySet** geometrySet)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(geometrySet);
+
+            auto newGeometrySet = CanvasGeometrySet::CreateNew(geometryCount, geometries);
+
+            ThrowIfFailed(newGeometrySet.CopyTo(geometrySet));
+        });
+}
+
+ActivatableClassWithFactory(CanvasGeometrySet, CanvasGeometrySetFactory);
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // A bounding volume hierarchy over a list of rectangles. Each node covers
+    // the bounds of everything beneath it, and interior nodes split their
+    // items in half along the wider axis, so a query only visits the parts
+    // of the tree that overlap it. Items with empty bounds are left out.
+    //
+    class GeometryBoundsTree
+    {
+        struct Node
+        {
+            D2D1_RECT_F Bounds;
+            uint32_t FirstItem;     // Leaf nodes: index of the first item in m_items.
+            uint32_t ItemCount;     // Zero for interior nodes.
+            uint32_t SecondChild;   // Interior nodes: the first child always follows its parent.
+        };
+
+        std::vector<D2D1_RECT_F> m_bounds;
+        std::vector<uint32_t> m_items;
+        std::vector<Node> m_nodes;
+
+    public:
+        static const uint32_t MaxLeafSize = 4;
+
+        explicit GeometryBoundsTree(std::vector<D2D1_RECT_F>&& bounds);
+
+        size_t GetNodeCount() const { return m_nodes.size(); }
+
+        // Calls visit(itemIndex) for every item whose bounds pass testBounds,
+        // skipping any subtree whose combined bounds fail it.
+        template<typename TestBounds, typename Visit>
+        void Query(TestBounds const& testBounds, Visit const& visit) const
+        {
+            if (m_nodes.empty())
+                return;
+
+            std::vector<uint32_t> stack(1, 0);
+
+            while (!stack.empty())
+            {
+                auto nodeIndex = stack.back();
+                stack.pop_back();
+
+                auto& node = m_nodes[nodeIndex];
+
+                if (!testBounds(node.Bounds))
+                    continue;
+
+                if (node.ItemCount)
+                {
+                    for (uint32_t i = node.FirstItem; i < node.FirstItem + node.ItemCount; i++)
+                    {
+                        auto item = m_items[i];
+
+                        if (testBounds(m_bounds[item]))
+                            visit(item);
+                    }
+                }
+                else
+                {
+                    stack.push_back(node.SecondChild);
+                    stack.push_back(nodeIndex + 1);
+                }
+            }
+        }
+
+    private:
+        uint32_t BuildNode(uint32_t firstItem, uint32_t itemCount);
+    };
+
+
+    class CanvasGeometrySet : public RuntimeClass<ICanvasGeometrySet>,
+                              private LifespanTracker<CanvasGeometrySet>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometrySet, BaseTrust);
+
+        std::vector<ComPtr<ICanvasGeometry>> m_geometries;
+        std::vector<ComPtr<ID2D1Geometry>> m_d2dGeometries;
+        std::vector<ID2D1Geometry*> m_d2dGeometriesRaw;     // Kept alive by m_d2dGeometries, and reused by every CreateGroup call.
+        GeometryBoundsTree m_boundsTree;
+
+    public:
+        static ComPtr<CanvasGeometrySet> CreateNew(
+            uint32_t geometryCount,
+            ICanvasGeometry** geometries);
+
+        CanvasGeometrySet(
+            std::vector<ComPtr<ICanvasGeometry>>&& geometries,
+            std::vector<ComPtr<ID2D1Geometry>>&& d2dGeometries,
+            std::vector<D2D1_RECT_F>&& bounds);
+
+        IFACEMETHOD(get_Count)(uint32_t* value) override;
+
+        IFACEMETHOD(GetGeometry)(
+            uint32_t index,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(FindGeometriesContainingPoint)(
+            Numerics::Vector2 point,
+            uint32_t* indicesCount,
+            uint32_t** indices) override;
+
+        IFACEMETHOD(FindGeometriesContainingPointWithFlatteningTolerance)(
+            Numerics::Vector2 point,
+            float flatteningTolerance,
+            uint32_t* indicesCount,
+            uint32_t** indices) override;
+
+        IFACEMETHOD(FindGeometriesWithBoundsIntersecting)(
+            Rect rect,
+            uint32_t* indicesCount,
+            uint32_t** indices) override;
+
+        IFACEMETHOD(CreateGroup)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(CreateGroupWithFilledRegionDetermination)(
+            ICanvasResourceCreator* resourceCreator,
+            CanvasFilledRegionDetermination filledRegionDetermination,
+            ICanvasGeometry** geometry) override;
+    };
+
+
+    class CanvasGeometrySetFactory
+        : public AgileActivationFactory<ICanvasGeometrySetStatics>
+        , private LifespanTracker<CanvasGeometrySetFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometrySet, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            uint32_t geometryCount,
+            ICanvasGeometry** geometries,
+            ICanvasGeometrySet** geometrySet) override;
+    };
+}}}}}
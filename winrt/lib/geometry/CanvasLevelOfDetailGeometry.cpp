@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasLevelOfDetailGeometry.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+//
+// CanvasLevelOfDetailGeometryFactory
+//
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometryFactory::CreateSimplified(
+    ICanvasGeometry* geometry,
+    CanvasGeometrySimplification simplification,
+    ICanvasLevelOfDetailGeometry** levelOfDetailGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometry);
+            CheckAndClearOutPointer(levelOfDetailGeometry);
+
+            auto newGeometry = Make<CanvasLevelOfDetailGeometry>(geometry, false, simplification);
+            CheckMakeResult(newGeometry);
+
+            ThrowIfFailed(newGeometry.CopyTo(levelOfDetailGeometry));
+        });
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometryFactory::CreateOutlined(
+    ICanvasGeometry* geometry,
+    ICanvasLevelOfDetailGeometry** levelOfDetailGeometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometry);
+            CheckAndClearOutPointer(levelOfDetailGeometry);
+
+            auto newGeometry = Make<CanvasLevelOfDetailGeometry>(geometry, true, CanvasGeometrySimplification::Lines);
+            CheckMakeResult(newGeometry);
+
+            ThrowIfFailed(newGeometry.CopyTo(levelOfDetailGeometry));
+        });
+}
+
+
+//
+// CanvasLevelOfDetailGeometry
+//
+
+CanvasLevelOfDetailGeometry::CanvasLevelOfDetailGeometry(
+    ICanvasGeometry* sourceGeometry,
+    bool isOutline,
+    CanvasGeometrySimplification simplification)
+    : m_sourceGeometry(sourceGeometry)
+    , m_isOutline(isOutline)
+    , m_simplification(simplification)
+{
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometry::get_SourceGeometry(ICanvasGeometry** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_sourceGeometry.CopyTo(value));
+        });
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometry::GetGeometryForDrawingSession(
+    ICanvasDrawingSession* drawingSession,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(drawingSession);
+            CheckAndClearOutPointer(geometry);
+
+            auto deviceContext = GetWrappedResource<ID2D1DeviceContext>(drawingSession);
+
+            D2D1_MATRIX_3X2_F transform;
+            deviceContext->GetTransform(&transform);
+
+            // In pixel units the transform already maps straight to pixels.
+            float dpiX = DEFAULT_DPI;
+            float dpiY = DEFAULT_DPI;
+
+            if (deviceContext->GetUnitMode() == D2D1_UNIT_MODE_DIPS)
+                deviceContext->GetDpi(&dpiX, &dpiY);
+
+            auto level = GetLevel(GetFlatteningTolerance(transform, dpiX, dpiY));
+
+            ThrowIfFailed(GetLevelGeometry(level).CopyTo(geometry));
+        });
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometry::GetGeometryForFlatteningTolerance(
+    float flatteningTolerance,
+    ICanvasGeometry** geometry)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(geometry);
+
+            if (!(flatteningTolerance > 0))
+                ThrowHR(E_INVALIDARG);
+
+            ThrowIfFailed(GetLevelGeometry(GetLevel(flatteningTolerance)).CopyTo(geometry));
+        });
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometry::get_LevelCount(UINT32* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            *value = static_cast<UINT32>(m_levels.size());
+        });
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometry::Trim()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+
+            m_levels.clear();
+        });
+}
+
+IFACEMETHODIMP CanvasLevelOfDetailGeometry::get_Device(ICanvasDevice** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_sourceGeometry->get_Device(value));
+        });
+}
+
+int CanvasLevelOfDetailGeometry::GetLevel(float flatteningTolerance)
+{
+    // A degenerate transform needs no detail at all.
+    if (!std::isfinite(flatteningTolerance))
+        return MaximumLevel;
+
+    // frexp returns a mantissa in [0.5, 1), so the largest power of two
+    // not greater than the tolerance is 2^(exponent - 1).
+    int exponent;
+    std::frexp(flatteningTolerance, &exponent);
+
+    return std::min(std::max(exponent - 1, MinimumLevel), MaximumLevel);
+}
+
+float CanvasLevelOfDetailGeometry::GetFlatteningTolerance(D2D1_MATRIX_3X2_F const& transform, float dpiX, float dpiY)
+{
+    return D2D1::ComputeFlatteningTolerance(transform, dpiX, dpiY);
+}
+
+ComPtr<ICanvasGeometry> CanvasLevelOfDetailGeometry::GetLevelGeometry(int level)
+{
+    {
+        Lock lock(m_mutex);
+
+        auto it = m_levels.find(level);
+
+        if (it != m_levels.end())
+            return it->second;
+    }
+
+    auto flatteningTolerance = std::ldexp(1.0f, level);
+
+    ComPtr<ICanvasGeometry> levelGeometry;
+
+    if (m_isOutline)
+        ThrowIfFailed(m_sourceGeometry->OutlineWithTransformAndFlatteningTolerance(Identity3x2(), flatteningTolerance, &levelGeometry));
+    else
+        ThrowIfFailed(m_sourceGeometry->SimplifyWithTransformAndFlatteningTolerance(m_simplification, Identity3x2(), flatteningTolerance, &levelGeometry));
+
+    Lock lock(m_mutex);
+
+    // Another thread may have created this level in the meantime.
+    auto inserted = m_levels.emplace(level, levelGeometry);
+
+    return inserted.first->second;
+}
+
+ActivatableClassWithFactory(CanvasLevelOfDetailGeometry, CanvasLevelOfDetailGeometryFactory);
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    class CanvasLevelOfDetailGeometryFactory
+        : public AgileActivationFactory<ICanvasLevelOfDetailGeometryStatics>
+        , private LifespanTracker<CanvasLevelOfDetailGeometryFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasLevelOfDetailGeometry, BaseTrust);
+
+    public:
+        IFACEMETHOD(CreateSimplified)(
+            ICanvasGeometry* geometry,
+            CanvasGeometrySimplification simplification,
+            ICanvasLevelOfDetailGeometry** levelOfDetailGeometry) override;
+
+        IFACEMETHOD(CreateOutlined)(
+            ICanvasGeometry* geometry,
+            ICanvasLevelOfDetailGeometry** levelOfDetailGeometry) override;
+    };
+
+
+    //
+    // Each level is the source geometry simplified with a flattening
+    // tolerance of 2^level DIPs.  A requested tolerance is rounded down to
+    // the nearest level, so the result is never coarser than was asked for,
+    // and at most twice as detailed.
+    //
+    // Levels are created outside the lock, so two threads asking for the
+    // same new level may both simplify the geometry; only one result is kept.
+    //
+    class CanvasLevelOfDetailGeometry
+        : public RuntimeClass<
+            ICanvasLevelOfDetailGeometry,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasLevelOfDetailGeometry>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasLevelOfDetailGeometry, BaseTrust);
+
+        ComPtr<ICanvasGeometry> m_sourceGeometry;
+        bool m_isOutline;
+        CanvasGeometrySimplification m_simplification;
+
+        std::mutex m_mutex;
+        std::map<int, ComPtr<ICanvasGeometry>> m_levels;
+
+    public:
+        // Tolerances outside 2^MinimumLevel .. 2^MaximumLevel DIPs are clamped.
+        static const int MinimumLevel = -16;
+        static const int MaximumLevel = 16;
+
+        CanvasLevelOfDetailGeometry(
+            ICanvasGeometry* sourceGeometry,
+            bool isOutline,
+            CanvasGeometrySimplification simplification);
+
+        IFACEMETHOD(get_SourceGeometry)(ICanvasGeometry** value) override;
+
+        IFACEMETHOD(GetGeometryForDrawingSession)(
+            ICanvasDrawingSession* drawingSession,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(GetGeometryForFlatteningTolerance)(
+            float flatteningTolerance,
+            ICanvasGeometry** geometry) override;
+
+        IFACEMETHOD(get_LevelCount)(UINT32* value) override;
+
+        IFACEMETHOD(Trim)() override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        static int GetLevel(float flatteningTolerance);
+
+        // The tolerance that keeps flattening errors under the default
+        // tolerance once drawn with this transform and DPI.
+        static float GetFlatteningTolerance(D2D1_MATRIX_3X2_F const& transform, float dpiX, float dpiY);
+
+    private:
+        ComPtr<ICanvasGeometry> GetLevelGeometry(int level);
+    };
+}}}}}
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasMesh.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+IFACEMETHODIMP CanvasMeshFactory::CreateFromGeometry(
+    ICanvasGeometry* geometry,
+    ICanvasMesh** mesh)
+{
+    return CreateFromGeometryWithFlatteningTolerance(
+        geometry,
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        mesh);
+}
+
+IFACEMETHODIMP CanvasMeshFactory::CreateFromGeometryWithFlatteningTolerance(
+    ICanvasGeometry* geometry,
+    float flatteningTolerance,
+    ICanvasMesh** mesh)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometry);
+            CheckAndClearOutPointer(mesh);
+
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(geometry->get_Device(&device));
+
+            auto newCanvasMesh = CanvasMesh::CreateNew(device.Get(), geometry, flatteningTolerance);
+
+            ThrowIfFailed(newCanvasMesh.CopyTo(mesh));
+        });
+}
+
+IFACEMETHODIMP CanvasMeshFactory::CreateFromTriangles(
+    ICanvasResourceCreator* resourceCreator,
+    uint32_t trianglesCount,
+    CanvasTriangleVertices* triangles,
+    ICanvasMesh** mesh)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckAndClearOutPointer(mesh);
+
+            if (trianglesCount > 0)
+                CheckInPointer(triangles);
+
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(resourceCreator->get_Device(&device));
+
+            auto newCanvasMesh = CanvasMesh::CreateNew(device.Get(), trianglesCount, triangles);
+
+            ThrowIfFailed(newCanvasMesh.CopyTo(mesh));
+        });
+}
+
+CanvasMesh::CanvasMesh(
+    ICanvasDevice* device,
+    ID2D1Mesh* d2dMesh)
+    : ResourceWrapper(d2dMesh)
+    , m_canvasDevice(device)
+{
+}
+
+IFACEMETHODIMP CanvasMesh::Close()
+{
+    m_canvasDevice.Close();
+    return ResourceWrapper::Close();
+}
+
+IFACEMETHODIMP CanvasMesh::get_Device(ICanvasDevice** device)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(device);
+            auto& canvasDevice = m_canvasDevice.EnsureNotClosed();
+            ThrowIfFailed(canvasDevice.CopyTo(device));
+        });
+}
+
+ComPtr<CanvasMesh> CanvasMesh::CreateNew(
+    ICanvasDevice* device,
+    ICanvasGeometry* geometry,
+    float flatteningTolerance)
+{
+    CheckInPointer(device);
+    CheckInPointer(geometry);
+
+    auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometry);
+
+    return CreateNew(device,
+        [&](ID2D1TessellationSink* sink)
+        {
+            ThrowIfFailed(d2dGeometry->Tessellate(nullptr, flatteningTolerance, sink));
+        });
+}
+
+ComPtr<CanvasMesh> CanvasMesh::CreateNew(
+    ICanvasDevice* device,
+    uint32_t trianglesCount,
+    CanvasTriangleVertices const* triangles)
+{
+    CheckInPointer(device);
+
+    return CreateNew(device,
+        [&](ID2D1TessellationSink* sink)
+        {
+            if (trianglesCount > 0)
+                sink->AddTriangles(ReinterpretAs<D2D1_TRIANGLE const*>(triangles), trianglesCount);
+        });
+}
+
+template<typename FN>
+ComPtr<CanvasMesh> CanvasMesh::CreateNew(ICanvasDevice* device, FN&& addTriangles)
+{
+    ComPtr<ID2D1Mesh> d2dMesh;
+
+    {
+        auto deviceContext = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+        ThrowIfFailed(deviceContext->CreateMesh(&d2dMesh));
+    }
+
+    // The mesh's triangles are uploaded to the device when the sink is closed,
+    // after which the mesh can't be changed.
+    ComPtr<ID2D1TessellationSink> sink;
+    ThrowIfFailed(d2dMesh->Open(&sink));
+
+    addTriangles(sink.Get());
+
+    ThrowIfFailed(sink->Close());
+
+    auto canvasMesh = Make<CanvasMesh>(device, d2dMesh.Get());
+    CheckMakeResult(canvasMesh);
+
+    return canvasMesh;
+}
+
+ActivatableClassWithFactory(CanvasMesh, CanvasMeshFactory);
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // A set of triangles held on the device, which D2D can fill much more
+    // cheaply than the geometry they were tessellated from.  Meshes are only
+    // ever drawn aliased.
+    //
+    class CanvasMesh : RESOURCE_WRAPPER_RUNTIME_CLASS(
+        ID2D1Mesh,
+        CanvasMesh,
+        ICanvasMesh,
+        CloakedIid<ICanvasResourceWrapperWithDevice>)
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasMesh, BaseTrust);
+
+        ClosablePtr<ICanvasDevice> m_canvasDevice;
+
+    public:
+        static ComPtr<CanvasMesh> CreateNew(
+            ICanvasDevice* device,
+            ICanvasGeometry* geometry,
+            float flatteningTolerance);
+
+        static ComPtr<CanvasMesh> CreateNew(
+            ICanvasDevice* device,
+            uint32_t trianglesCount,
+            CanvasTriangleVertices const* triangles);
+
+        CanvasMesh(
+            ICanvasDevice* device,
+            ID2D1Mesh* d2dMesh);
+
+        IFACEMETHOD(Close)();
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** device);
+
+    private:
+        template<typename FN>
+        static ComPtr<CanvasMesh> CreateNew(ICanvasDevice* device, FN&& addTriangles);
+    };
+
+
+    class CanvasMeshFactory
+        : public AgileActivationFactory<ICanvasMeshStatics>
+        , private LifespanTracker<CanvasMeshFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasMesh, BaseTrust);
+
+    public:
+        IFACEMETHOD(CreateFromGeometry)(
+            ICanvasGeometry* geometry,
+            ICanvasMesh** mesh) override;
+
+        IFACEMETHOD(CreateFromGeometryWithFlatteningTolerance)(
+            ICanvasGeometry* geometry,
+            float flatteningTolerance,
+            ICanvasMesh** mesh) override;
+
+        IFACEMETHOD(CreateFromTriangles)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t trianglesCount,
+            CanvasTriangleVertices* triangles,
+            ICanvasMesh** mesh) override;
+    };
+}}}}}
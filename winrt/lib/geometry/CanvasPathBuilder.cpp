@@ -41,6 +41,7 @@ CanvasPathBuilder::CanvasPathBuilder(GeometryDevicePtr const& device)
 
     m_d2dPathGeometry = d2dPathGeometry;
 
+    m_polylines = std::make_shared<PolylineGeometry>();
 }
 
 IFACEMETHODIMP CanvasPathBuilder::Close()
@@ -59,6 +60,8 @@ IFACEMETHODIMP CanvasPathBuilder::Close()
         m_d2dPathGeometry.Close();
 
         m_device.Close();
+
+        m_polylines.reset();
     }
 
     return S_OK;
@@ -78,6 +81,14 @@ IFACEMETHODIMP CanvasPathBuilder::BeginFigureWithFigureFill(
                 ThrowHR(E_INVALIDARG, Strings::TwoBeginFigures);
             }
 
+            if (m_polylines)
+            {
+                if (figureFill == CanvasFigureFill::Default)
+                    m_polylines->BeginFigure(ToD2DPoint(startPoint));
+                else
+                    m_polylines.reset();
+            }
+
             d2dGeometrySink->BeginFigure(ToD2DPoint(startPoint), static_cast<D2D1_FIGURE_BEGIN>(figureFill));
 
             m_isInFigure = true;
@@ -122,6 +133,8 @@ IFACEMETHODIMP CanvasPathBuilder::AddArcToPoint(
 
             ValidateIsInFigure();
 
+            m_polylines.reset();
+
             d2dGeometrySink->AddArc(
                 D2D1::ArcSegment(
                     ToD2DPoint(endPoint), 
@@ -182,6 +195,8 @@ IFACEMETHODIMP CanvasPathBuilder::AddArcAroundEllipse(
                 (fabs(sweepAngle) > XM_PI) ? D2D1_ARC_SIZE_LARGE : D2D1_ARC_SIZE_SMALL,
             };
 
+            m_polylines.reset();
+
             // Insert a line to move the current path location to the arc start point.
             d2dGeometrySink->AddLine(startPoint);
 
@@ -209,6 +224,8 @@ IFACEMETHODIMP CanvasPathBuilder::AddCubicBezier(
 
             ValidateIsInFigure();
 
+            m_polylines.reset();
+
             d2dGeometrySink->AddBezier(D2D1::BezierSegment(ToD2DPoint(controlPoint1), ToD2DPoint(controlPoint2), ToD2DPoint(endPoint)));
         });
 }
@@ -223,7 +240,12 @@ IFACEMETHODIMP CanvasPathBuilder::AddLine(
 
             ValidateIsInFigure();
 
-            d2dGeometrySink->AddLine(ToD2DPoint(endPoint));
+            auto d2dEndPoint = ToD2DPoint(endPoint);
+
+            if (m_polylines)
+                m_polylines->AddLines(&d2dEndPoint, 1);
+
+            d2dGeometrySink->AddLine(d2dEndPoint);
         });
 }
 
@@ -245,10 +267,90 @@ IFACEMETHODIMP CanvasPathBuilder::AddQuadraticBezier(
 
             ValidateIsInFigure();
 
+            m_polylines.reset();
+
             d2dGeometrySink->AddQuadraticBezier(D2D1::QuadraticBezierSegment(ToD2DPoint(controlPoint), ToD2DPoint(endPoint)));
         });
 }
 
+IFACEMETHODIMP CanvasPathBuilder::AddLines(
+    uint32_t pointsCount,
+    Vector2* points)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (pointsCount > 0)
+                CheckInPointer(points);
+
+            auto& d2dGeometrySink = m_d2dGeometrySink.EnsureNotClosed();
+
+            ValidateIsInFigure();
+
+            if (pointsCount > 0)
+            {
+                auto d2dPoints = ReinterpretAs<D2D1_POINT_2F*>(points);
+
+                if (m_polylines)
+                    m_polylines->AddLines(d2dPoints, pointsCount);
+
+                d2dGeometrySink->AddLines(d2dPoints, pointsCount);
+            }
+        });
+}
+
+IFACEMETHODIMP CanvasPathBuilder::AddCubicBeziers(
+    uint32_t pointsCount,
+    Vector2* points)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (pointsCount > 0)
+                CheckInPointer(points);
+
+            auto& d2dGeometrySink = m_d2dGeometrySink.EnsureNotClosed();
+
+            ValidateIsInFigure();
+
+            if (pointsCount % 3 != 0)
+                ThrowHR(E_INVALIDARG, Strings::CubicBezierPointCountMustBeMultipleOf3);
+
+            static_assert(sizeof(D2D1_BEZIER_SEGMENT) == sizeof(Vector2) * 3, "Segments must be packed points");
+
+            m_polylines.reset();
+
+            if (pointsCount > 0)
+                d2dGeometrySink->AddBeziers(reinterpret_cast<D2D1_BEZIER_SEGMENT*>(points), pointsCount / 3);
+        });
+}
+
+IFACEMETHODIMP CanvasPathBuilder::AddQuadraticBeziers(
+    uint32_t pointsCount,
+    Vector2* points)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (pointsCount > 0)
+                CheckInPointer(points);
+
+            auto& d2dGeometrySink = m_d2dGeometrySink.EnsureNotClosed();
+
+            ValidateIsInFigure();
+
+            if (pointsCount % 2 != 0)
+                ThrowHR(E_INVALIDARG, Strings::QuadraticBezierPointCountMustBeMultipleOf2);
+
+            static_assert(sizeof(D2D1_QUADRATIC_BEZIER_SEGMENT) == sizeof(Vector2) * 2, "Segments must be packed points");
+
+            m_polylines.reset();
+
+            if (pointsCount > 0)
+                d2dGeometrySink->AddQuadraticBeziers(reinterpret_cast<D2D1_QUADRATIC_BEZIER_SEGMENT*>(points), pointsCount / 2);
+        });
+}
+
 IFACEMETHODIMP CanvasPathBuilder::AddGeometry(
     ICanvasGeometry* geometry)
 {        
@@ -266,6 +368,8 @@ IFACEMETHODIMP CanvasPathBuilder::AddGeometry(
                 ThrowHR(E_INVALIDARG, Strings::PathBuilderAddGeometryMidFigure);
             }
 
+            m_polylines.reset();
+
             auto otherD2DPathGeometry = MaybeAs<ID2D1PathGeometry>(otherD2DGeometry);
 
             if (otherD2DPathGeometry)
@@ -324,6 +428,9 @@ IFACEMETHODIMP CanvasPathBuilder::EndFigure(
                 ThrowHR(E_INVALIDARG, Strings::EndFigureWithoutBeginFigure);
             }
 
+            if (m_polylines)
+                m_polylines->EndFigure(static_cast<D2D1_FIGURE_END>(figureLoop));
+
             d2dGeometrySink->EndFigure(static_cast<D2D1_FIGURE_END>(figureLoop));
 
             m_isInFigure = false;
@@ -341,9 +448,17 @@ ComPtr<ID2D1GeometrySink> CanvasPathBuilder::GetGeometrySink()
 {
     auto& geometrySink = m_d2dGeometrySink.EnsureNotClosed();
 
+    // We can't tell what the caller will write to the sink.
+    m_polylines.reset();
+
     return geometrySink;
 }
 
+std::shared_ptr<PolylineGeometry const> CanvasPathBuilder::GetPolylines()
+{
+    return m_polylines;
+}
+
 ComPtr<ID2D1PathGeometry1> CanvasPathBuilder::CloseAndReturnPath()
 {
     //
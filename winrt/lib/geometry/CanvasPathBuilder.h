@@ -29,6 +29,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         virtual ComPtr<ID2D1GeometrySink> GetGeometrySink() = 0;
 
+        // Returns the figures added so far if they are all filled and made
+        // only of lines, or null otherwise.
+        virtual std::shared_ptr<PolylineGeometry const> GetPolylines() = 0;
+
         virtual ComPtr<ID2D1PathGeometry1> CloseAndReturnPath() = 0;
     };
 
@@ -54,6 +58,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         bool m_isInFigure;
         bool m_beginFigureOccurred;
 
+        // Tracks the path for as long as it contains only lines, so the
+        // resulting CanvasGeometry can answer metric queries without D2D.
+        std::shared_ptr<PolylineGeometry> m_polylines;
+
     public:
         CanvasPathBuilder(GeometryDevicePtr const& device);
 
@@ -106,6 +114,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             Vector2 controlPoint,
             Vector2 endPoint) override;
 
+        IFACEMETHOD(AddLines)(
+            uint32_t pointsCount,
+            Vector2* points) override;
+
+        IFACEMETHOD(AddCubicBeziers)(
+            uint32_t pointsCount,
+            Vector2* points) override;
+
+        IFACEMETHOD(AddQuadraticBeziers)(
+            uint32_t pointsCount,
+            Vector2* points) override;
+
         IFACEMETHOD(AddGeometry)(
             ICanvasGeometry* geometry) override;
 
@@ -126,6 +146,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         virtual ComPtr<ID2D1GeometrySink> GetGeometrySink() override;
 
+        virtual std::shared_ptr<PolylineGeometry const> GetPolylines() override;
+
         virtual ComPtr<ID2D1PathGeometry1> CloseAndReturnPath() override;
 
     private:
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "geometry/PolylineGeometry.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    struct GeometryMetricsKey
+    {
+        D2D1_MATRIX_3X2_F Transform;
+        float FlatteningTolerance;
+
+        bool operator==(GeometryMetricsKey const& other) const
+        {
+            return memcmp(&Transform, &other.Transform, sizeof(Transform)) == 0 &&
+                   FlatteningTolerance == other.FlatteningTolerance;
+        }
+    };
+
+
+    //
+    // A polyline approximation of a geometry, along with how far along the
+    // path each point is, so the point at a given distance can be found with
+    // a binary search rather than asking D2D to flatten the geometry again.
+    //
+    class FlattenedGeometry
+    {
+        std::vector<D2D1_POINT_2F> m_points;
+        std::vector<float> m_distances;
+
+        class Sink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1SimplifiedGeometrySink>,
+                     private LifespanTracker<Sink>
+        {
+            FlattenedGeometry* m_owner;
+            D2D1_POINT_2F m_figureStart;
+            HRESULT m_result;
+
+        public:
+            Sink(FlattenedGeometry* owner)
+                : m_owner(owner)
+                , m_figureStart{}
+                , m_result(S_OK)
+            { }
+
+            IFACEMETHODIMP_(void) SetFillMode(D2D1_FILL_MODE) override { }
+            IFACEMETHODIMP_(void) SetSegmentFlags(D2D1_PATH_SEGMENT) override { }
+
+            IFACEMETHODIMP_(void) BeginFigure(D2D1_POINT_2F startPoint, D2D1_FIGURE_BEGIN) override
+            {
+                m_figureStart = startPoint;
+                AddPoint(startPoint, true);
+            }
+
+            IFACEMETHODIMP_(void) AddLines(D2D1_POINT_2F const* points, UINT32 pointsCount) override
+            {
+                for (UINT32 i = 0; i < pointsCount; i++)
+                {
+                    AddPoint(points[i], false);
+                }
+            }
+
+            IFACEMETHODIMP_(void) AddBeziers(D2D1_BEZIER_SEGMENT const* beziers, UINT32 beziersCount) override
+            {
+                // Not expected when simplifying to lines, but keep the end points if it happens.
+                for (UINT32 i = 0; i < beziersCount; i++)
+                {
+                    AddPoint(beziers[i].point3, false);
+                }
+            }
+
+            IFACEMETHODIMP_(void) EndFigure(D2D1_FIGURE_END figureEnd) override
+            {
+                if (figureEnd == D2D1_FIGURE_END_CLOSED)
+                    AddPoint(m_figureStart, false);
+            }
+
+            IFACEMETHODIMP Close() override
+            {
+                return m_result;
+            }
+
+        private:
+            void AddPoint(D2D1_POINT_2F point, bool isFigureStart)
+            {
+                if (FAILED(m_result))
+                    return;
+
+                m_result = ExceptionBoundary([&]
+                {
+                    auto& points = m_owner->m_points;
+                    auto& distances = m_owner->m_distances;
+
+                    // Moving to the start of a new figure doesn't add to the length.
+                    float distance = distances.empty() ? 0.0f : distances.back();
+
+                    if (!isFigureStart && !points.empty())
+                    {
+                        auto dx = point.x - points.back().x;
+                        auto dy = point.y - points.back().y;
+
+                        distance += sqrtf(dx * dx + dy * dy);
+                    }
+
+                    points.push_back(point);
+                    distances.push_back(distance);
+                });
+            }
+        };
+
+    public:
+        FlattenedGeometry(ID2D1Geometry* geometry, D2D1_MATRIX_3X2_F const* transform, float flatteningTolerance)
+        {
+            auto sink = Make<Sink>(this);
+            CheckMakeResult(sink);
+
+            ThrowIfFailed(geometry->Simplify(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, transform, flatteningTolerance, sink.Get()));
+            ThrowIfFailed(sink->Close());
+        }
+
+        // Geometry that is already made of lines just needs transforming.
+        FlattenedGeometry(PolylineGeometry const& polylines, D2D1_MATRIX_3X2_F const& transform)
+        {
+            polylines.Flatten(transform, &m_points, &m_distances);
+        }
+
+        float GetLength() const
+        {
+            return m_distances.empty() ? 0.0f : m_distances.back();
+        }
+
+        // Returns false if there is no path to measure along, in which case
+        // the caller should fall back to asking D2D.
+        bool TryComputePointAtLength(float distance, D2D1_POINT_2F* point, D2D1_POINT_2F* unitTangentVector) const
+        {
+            auto length = GetLength();
+
+            if (!(length > 0) || isnan(distance))
+                return false;
+
+            distance = std::min(std::max(distance, 0.0f), length);
+
+            // Find the first point at or beyond the distance. The point before
+            // it is nearer than that, so the segment between them has some
+            // length, and is never the jump to the start of a new figure. A
+            // distance of zero uses the first segment that has any length.
+            auto end = std::lower_bound(m_distances.begin(), m_distances.end(), distance);
+
+            if (end == m_distances.begin())
+                end = std::upper_bound(m_distances.begin(), m_distances.end(), 0.0f);
+
+            auto i = static_cast<size_t>(end - m_distances.begin());
+
+            auto startDistance = m_distances[i - 1];
+            auto segmentLength = m_distances[i] - startDistance;
+
+            auto& p0 = m_points[i - 1];
+            auto& p1 = m_points[i];
+
+            auto dx = p1.x - p0.x;
+            auto dy = p1.y - p0.y;
+
+            auto t = (distance - startDistance) / segmentLength;
+
+            *point = D2D1_POINT_2F{ p0.x + dx * t, p0.y + dy * t };
+            *unitTangentVector = D2D1_POINT_2F{ dx / segmentLength, dy / segmentLength };
+
+            return true;
+        }
+    };
+
+
+    //
+    // D2D geometry objects are immutable, so CanvasGeometry can remember the
+    // results of its metric queries. Each entry holds the most recently used
+    // arguments, which covers the usual case of animation code asking the
+    // same question every frame.
+    //
+    struct GeometryMetricsCache
+    {
+        template<typename T>
+        struct Entry
+        {
+            bool IsValid = false;
+            GeometryMetricsKey Key;
+            T Value;
+
+            bool TryGet(GeometryMetricsKey const& key, T* value) const
+            {
+                if (!IsValid || !(Key == key))
+                    return false;
+
+                *value = Value;
+                return true;
+            }
+
+            void Set(GeometryMetricsKey const& key, T const& value)
+            {
+                IsValid = true;
+                Key = key;
+                Value = value;
+            }
+        };
+
+        Entry<float> Area;
+        Entry<float> Length;
+        Entry<D2D1_RECT_F> Bounds;
+
+        // Flattening the path costs more than a single D2D point-on-path
+        // query, so it is only worth doing once the same arguments come
+        // round a second time. LastPointOnPath remembers the arguments of
+        // the previous query that went straight to D2D.
+        Entry<std::shared_ptr<FlattenedGeometry const>> Flattened;
+        Entry<bool> LastPointOnPath;
+    };
+}}}}}
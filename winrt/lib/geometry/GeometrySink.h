@@ -156,4 +156,141 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             return m_result;
         }
     };
+
+
+    //
+    // Collects path contents into the packed command and segment data arrays
+    // returned by CanvasGeometry.GetPathData, rather than making a call per
+    // segment the way GeometrySink does.
+    //
+    class PathDataSink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1GeometrySink>,
+        private LifespanTracker<PathDataSink>
+    {
+        std::vector<CanvasGeometryPathCommand> m_commands;
+        std::vector<float> m_segmentData;
+        HRESULT m_result;
+
+    public:
+        PathDataSink()
+            : m_result(S_OK)
+        {}
+
+        std::vector<CanvasGeometryPathCommand> const& GetCommands() const { return m_commands; }
+        std::vector<float> const& GetSegmentData() const { return m_segmentData; }
+
+        IFACEMETHODIMP_(void) BeginFigure(
+            D2D1_POINT_2F startPoint,
+            D2D1_FIGURE_BEGIN figureBegin) override
+        {
+            Add(CanvasGeometryPathCommand::BeginFigure, { startPoint.x, startPoint.y, static_cast<float>(figureBegin) });
+        }
+
+        IFACEMETHODIMP_(void) AddLine(
+            D2D1_POINT_2F point) override
+        {
+            AddLines(&point, 1);
+        }
+
+        IFACEMETHODIMP_(void) AddLines(
+            _In_reads_(pointsCount) CONST D2D1_POINT_2F *points,
+            UINT32 pointsCount) override
+        {
+            AddMany(CanvasGeometryPathCommand::AddLine, reinterpret_cast<float const*>(points), pointsCount, 2);
+        }
+
+        IFACEMETHODIMP_(void) AddBezier(
+            _In_ CONST D2D1_BEZIER_SEGMENT *bezier) override
+        {
+            AddBeziers(bezier, 1);
+        }
+
+        IFACEMETHODIMP_(void) AddBeziers(
+            CONST D2D1_BEZIER_SEGMENT *beziers,
+            UINT32 beziersCount) override
+        {
+            static_assert(sizeof(D2D1_BEZIER_SEGMENT) == sizeof(float) * 6, "D2D1_BEZIER_SEGMENT is expected to be six packed floats");
+
+            AddMany(CanvasGeometryPathCommand::AddCubicBezier, reinterpret_cast<float const*>(beziers), beziersCount, 6);
+        }
+
+        IFACEMETHODIMP_(void) AddQuadraticBezier(
+            _In_ CONST D2D1_QUADRATIC_BEZIER_SEGMENT *bezier) override
+        {
+            AddQuadraticBeziers(bezier, 1);
+        }
+
+        IFACEMETHODIMP_(void) AddQuadraticBeziers(
+            _In_reads_(beziersCount) CONST D2D1_QUADRATIC_BEZIER_SEGMENT *beziers,
+            uint32_t beziersCount) override
+        {
+            static_assert(sizeof(D2D1_QUADRATIC_BEZIER_SEGMENT) == sizeof(float) * 4, "D2D1_QUADRATIC_BEZIER_SEGMENT is expected to be four packed floats");
+
+            AddMany(CanvasGeometryPathCommand::AddQuadraticBezier, reinterpret_cast<float const*>(beziers), beziersCount, 4);
+        }
+
+        IFACEMETHODIMP_(void) AddArc(
+            _In_ CONST D2D1_ARC_SEGMENT *arc) override
+        {
+            Add(CanvasGeometryPathCommand::AddArc,
+                {
+                    arc->point.x,
+                    arc->point.y,
+                    arc->size.width,
+                    arc->size.height,
+                    ::DirectX::XMConvertToRadians(arc->rotationAngle),
+                    static_cast<float>(arc->sweepDirection),
+                    static_cast<float>(arc->arcSize)
+                });
+        }
+
+        IFACEMETHODIMP_(void) SetFillMode(
+            D2D1_FILL_MODE fillMode) override
+        {
+            Add(CanvasGeometryPathCommand::SetFilledRegionDetermination, { static_cast<float>(fillMode) });
+        }
+
+        IFACEMETHODIMP_(void) SetSegmentFlags(
+            D2D1_PATH_SEGMENT vertexFlags) override
+        {
+            Add(CanvasGeometryPathCommand::SetSegmentOptions, { static_cast<float>(vertexFlags) });
+        }
+
+        IFACEMETHODIMP_(void) EndFigure(
+            D2D1_FIGURE_END figureEnd) override
+        {
+            Add(CanvasGeometryPathCommand::EndFigure, { static_cast<float>(figureEnd) });
+        }
+
+        IFACEMETHODIMP Close()
+        {
+            return m_result;
+        }
+
+    private:
+        // D2D sink methods can't report failure, so an allocation failure is
+        // remembered and returned from Close.
+        void Add(CanvasGeometryPathCommand command, std::initializer_list<float> segmentData)
+        {
+            if (FAILED(m_result))
+                return;
+
+            m_result = ExceptionBoundary([&]
+            {
+                m_commands.push_back(command);
+                m_segmentData.insert(m_segmentData.end(), segmentData);
+            });
+        }
+
+        void AddMany(CanvasGeometryPathCommand command, float const* segmentData, uint32_t count, uint32_t floatsPerSegment)
+        {
+            if (FAILED(m_result))
+                return;
+
+            m_result = ExceptionBoundary([&]
+            {
+                m_commands.insert(m_commands.end(), count, command);
+                m_segmentData.insert(m_segmentData.end(), segmentData, segmentData + count * floatsPerSegment);
+            });
+        }
+    };
 }}}}}
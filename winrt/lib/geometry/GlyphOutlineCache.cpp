@@ -0,0 +1,317 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "GlyphOutlineCache.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+
+namespace
+{
+    // Records what GetGlyphRunOutline streams for one glyph.
+    class GlyphOutlineRecorder : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1SimplifiedGeometrySink>,
+                                 private LifespanTracker<GlyphOutlineRecorder>
+    {
+        GlyphOutline* m_outline;
+        HRESULT m_result;
+
+    public:
+        GlyphOutlineRecorder(GlyphOutline* outline)
+            : m_outline(outline)
+            , m_result(S_OK)
+        { }
+
+        IFACEMETHODIMP_(void) SetFillMode(D2D1_FILL_MODE fillMode) override
+        {
+            m_outline->HasFillMode = true;
+            m_outline->FillMode = fillMode;
+        }
+
+        IFACEMETHODIMP_(void) SetSegmentFlags(D2D1_PATH_SEGMENT vertexFlags) override
+        {
+            Record(GlyphOutline::SegmentType::SetSegmentFlags, static_cast<uint32_t>(vertexFlags), nullptr, 0);
+        }
+
+        IFACEMETHODIMP_(void) BeginFigure(D2D1_POINT_2F startPoint, D2D1_FIGURE_BEGIN figureBegin) override
+        {
+            // The figure begin flag goes in the segment, and the start point after it.
+            Record(GlyphOutline::SegmentType::BeginFigure, static_cast<uint32_t>(figureBegin), &startPoint, 1);
+        }
+
+        IFACEMETHODIMP_(void) AddLines(D2D1_POINT_2F const* points, UINT32 pointsCount) override
+        {
+            Record(GlyphOutline::SegmentType::AddLines, pointsCount, points, pointsCount);
+        }
+
+        IFACEMETHODIMP_(void) AddBeziers(D2D1_BEZIER_SEGMENT const* beziers, UINT32 beziersCount) override
+        {
+            static_assert(sizeof(D2D1_BEZIER_SEGMENT) == 3 * sizeof(D2D1_POINT_2F), "Bezier segments are stored as three points");
+
+            Record(GlyphOutline::SegmentType::AddBeziers, beziersCount, &beziers->point1, beziersCount * 3);
+        }
+
+        IFACEMETHODIMP_(void) EndFigure(D2D1_FIGURE_END figureEnd) override
+        {
+            Record(GlyphOutline::SegmentType::EndFigure, static_cast<uint32_t>(figureEnd), nullptr, 0);
+        }
+
+        IFACEMETHODIMP Close() override
+        {
+            return m_result;
+        }
+
+    private:
+        void Record(GlyphOutline::SegmentType type, uint32_t value, D2D1_POINT_2F const* points, uint32_t pointCount)
+        {
+            if (FAILED(m_result))
+                return;
+
+            m_result = ExceptionBoundary([&]
+            {
+                m_outline->Segments.push_back(GlyphOutline::Segment{ type, value });
+                m_outline->Points.insert(m_outline->Points.end(), points, points + pointCount);
+            });
+        }
+    };
+}
+
+
+void GlyphOutline::SendTo(ID2D1SimplifiedGeometrySink* sink, D2D1_POINT_2F offset, std::vector<D2D1_POINT_2F>* scratch) const
+{
+    auto point = Points.data();
+
+    auto offsetPoints = [&](uint32_t count)
+    {
+        scratch->resize(count);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            (*scratch)[i] = D2D1_POINT_2F{ point[i].x + offset.x, point[i].y + offset.y };
+        }
+
+        point += count;
+
+        return scratch->data();
+    };
+
+    for (auto& segment : Segments)
+    {
+        switch (segment.Type)
+        {
+        case SegmentType::SetSegmentFlags:
+            sink->SetSegmentFlags(static_cast<D2D1_PATH_SEGMENT>(segment.Value));
+            break;
+
+        case SegmentType::BeginFigure:
+            sink->BeginFigure(*offsetPoints(1), static_cast<D2D1_FIGURE_BEGIN>(segment.Value));
+            break;
+
+        case SegmentType::AddLines:
+            sink->AddLines(offsetPoints(segment.Value), segment.Value);
+            break;
+
+        case SegmentType::AddBeziers:
+            sink->AddBeziers(reinterpret_cast<D2D1_BEZIER_SEGMENT const*>(offsetPoints(segment.Value * 3)), segment.Value);
+            break;
+
+        case SegmentType::EndFigure:
+            sink->EndFigure(static_cast<D2D1_FIGURE_END>(segment.Value));
+            break;
+        }
+    }
+}
+
+
+size_t GlyphOutlineCache::CacheKeyHash::operator()(CacheKey const& key) const
+{
+    size_t hash = std::hash<void*>()(key.FontFace);
+
+    auto combine = [&](size_t value)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    combine(std::hash<uint16_t>()(key.GlyphIndex));
+    combine(std::hash<float>()(key.EmSize));
+    combine(std::hash<bool>()(key.IsSideways));
+
+    return hash;
+}
+
+
+GlyphOutlineCache::GlyphOutlineCache()
+    : m_maximumCount(DefaultMaximumCount)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_evictionCount(0)
+{
+}
+
+
+void GlyphOutlineCache::GetGlyphRunOutline(DWRITE_GLYPH_RUN const* glyphRun, ID2D1SimplifiedGeometrySink* sink)
+{
+    bool isRightToLeft = (glyphRun->bidiLevel % 2) != 0;
+
+    if (!glyphRun->glyphAdvances || GetMaximumCount() == 0)
+    {
+        ThrowIfFailed(glyphRun->fontFace->GetGlyphRunOutline(
+            glyphRun->fontEmSize,
+            glyphRun->glyphIndices,
+            glyphRun->glyphAdvances,
+            glyphRun->glyphOffsets,
+            glyphRun->glyphCount,
+            glyphRun->isSideways,
+            isRightToLeft,
+            sink));
+        return;
+    }
+
+    std::vector<std::shared_ptr<GlyphOutline const>> outlines;
+    outlines.reserve(glyphRun->glyphCount);
+
+    for (uint32_t i = 0; i < glyphRun->glyphCount; i++)
+    {
+        outlines.push_back(GetOutline(glyphRun->fontFace, glyphRun->glyphIndices[i], glyphRun->fontEmSize, !!glyphRun->isSideways));
+    }
+
+    // DirectWrite sets the fill mode once at the start of a run.
+    for (auto& outline : outlines)
+    {
+        if (outline->HasFillMode)
+        {
+            sink->SetFillMode(outline->FillMode);
+            break;
+        }
+    }
+
+    // Glyphs are placed along the baseline by their advances, as
+    // GetGlyphRunOutline does.  Right-to-left runs extend leftwards from the
+    // origin, with each glyph's outline starting at its left edge.
+    std::vector<D2D1_POINT_2F> scratch;
+    float x = 0;
+
+    for (uint32_t i = 0; i < glyphRun->glyphCount; i++)
+    {
+        auto advance = glyphRun->glyphAdvances[i];
+        auto offset = glyphRun->glyphOffsets ? glyphRun->glyphOffsets[i] : DWRITE_GLYPH_OFFSET{};
+
+        D2D1_POINT_2F origin;
+
+        if (isRightToLeft)
+            origin = D2D1_POINT_2F{ x - advance - offset.advanceOffset, -offset.ascenderOffset };
+        else
+            origin = D2D1_POINT_2F{ x + offset.advanceOffset, -offset.ascenderOffset };
+
+        outlines[i]->SendTo(sink, origin, &scratch);
+
+        x += isRightToLeft ? -advance : advance;
+    }
+}
+
+
+std::shared_ptr<GlyphOutline const> GlyphOutlineCache::GetOutline(IDWriteFontFace* fontFace, uint16_t glyphIndex, float emSize, bool isSideways)
+{
+    CacheKey key{ fontFace, glyphIndex, emSize, isSideways };
+
+    {
+        Lock lock(m_mutex);
+
+        auto it = m_entryMap.find(key);
+
+        if (it != m_entryMap.end())
+        {
+            m_hitCount++;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->Outline;
+        }
+
+        m_missCount++;
+    }
+
+    auto outline = std::make_shared<GlyphOutline>();
+
+    auto recorder = Make<GlyphOutlineRecorder>(outline.get());
+    CheckMakeResult(recorder);
+
+    ThrowIfFailed(fontFace->GetGlyphRunOutline(emSize, &glyphIndex, nullptr, nullptr, 1, isSideways, FALSE, recorder.Get()));
+    ThrowIfFailed(recorder->Close());
+
+    Lock lock(m_mutex);
+
+    // If another thread got there first, use theirs so there is only ever one copy.
+    auto it = m_entryMap.find(key);
+
+    if (it != m_entryMap.end())
+    {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->Outline;
+    }
+
+    if (m_maximumCount == 0)
+        return outline;
+
+    EvictToCount(lock, m_maximumCount - 1);
+
+    m_entries.push_front(Entry{ key, fontFace, outline });
+    m_entryMap.emplace(key, m_entries.begin());
+
+    return outline;
+}
+
+
+GlyphOutlineCache::Statistics GlyphOutlineCache::GetStatistics()
+{
+    Lock lock(m_mutex);
+
+    return Statistics
+    {
+        static_cast<uint32_t>(m_entries.size()),
+        m_hitCount,
+        m_missCount,
+        m_evictionCount
+    };
+}
+
+
+uint32_t GlyphOutlineCache::GetMaximumCount()
+{
+    Lock lock(m_mutex);
+
+    return m_maximumCount;
+}
+
+
+void GlyphOutlineCache::SetMaximumCount(uint32_t value)
+{
+    Lock lock(m_mutex);
+
+    m_maximumCount = value;
+    EvictToCount(lock, value);
+}
+
+
+void GlyphOutlineCache::Clear()
+{
+    Lock lock(m_mutex);
+
+    EvictToCount(lock, 0);
+}
+
+
+void GlyphOutlineCache::EvictToCount(Lock const& lock, uint32_t count)
+{
+    MustOwnLock(lock);
+
+    while (m_entries.size() > count)
+    {
+        auto& entry = m_entries.back();
+
+        m_entryMap.erase(entry.Key);
+        m_entries.pop_back();
+
+        m_evictionCount++;
+    }
+}
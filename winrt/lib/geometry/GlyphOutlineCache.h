@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // The outline of a single glyph, as IDWriteFontFace::GetGlyphRunOutline
+    // streamed it for a glyph at the origin.  Points are stored in one array,
+    // with each segment recording how many of them it uses, so the outline
+    // can be replayed into any sink at an offset.
+    //
+    class GlyphOutline
+    {
+    public:
+        enum class SegmentType
+        {
+            SetSegmentFlags,
+            BeginFigure,
+            AddLines,
+            AddBeziers,
+            EndFigure
+        };
+
+        struct Segment
+        {
+            SegmentType Type;
+            uint32_t Value;         // Point count, or the flags for the segment type.
+        };
+
+        std::vector<Segment> Segments;
+        std::vector<D2D1_POINT_2F> Points;
+
+        bool HasFillMode = false;
+        D2D1_FILL_MODE FillMode = D2D1_FILL_MODE_ALTERNATE;
+
+        void SendTo(ID2D1SimplifiedGeometrySink* sink, D2D1_POINT_2F offset, std::vector<D2D1_POINT_2F>* scratch) const;
+    };
+
+
+    //
+    // Process-wide cache of glyph outlines, used when converting glyph runs
+    // to geometry.
+    //
+    // DirectWrite produces the outline of a whole run at once, so asking it
+    // for a run means decoding every glyph again even when the same glyphs
+    // were just converted.  Instead, each glyph's outline is fetched once per
+    // font face, size and sideways flag, and a run is assembled by replaying
+    // the cached outlines at each glyph's position.
+    //
+    // Outlines are recorded as plain points rather than D2D geometry, so
+    // they can be shared by every D2D factory.  Entries hold a reference to
+    // their font face, so a font face pointer can't be reused by a different
+    // face while an entry exists.  The least recently used entries beyond
+    // the maximum count are released.
+    //
+    class GlyphOutlineCache : public Singleton<GlyphOutlineCache>
+    {
+        struct CacheKey
+        {
+            IDWriteFontFace* FontFace;
+            uint16_t GlyphIndex;
+            float EmSize;
+            bool IsSideways;
+
+            bool operator==(CacheKey const& other) const
+            {
+                return FontFace == other.FontFace &&
+                       GlyphIndex == other.GlyphIndex &&
+                       EmSize == other.EmSize &&
+                       IsSideways == other.IsSideways;
+            }
+        };
+
+        struct CacheKeyHash
+        {
+            size_t operator()(CacheKey const& key) const;
+        };
+
+        struct Entry
+        {
+            CacheKey Key;
+            ComPtr<IDWriteFontFace> FontFace;
+            std::shared_ptr<GlyphOutline const> Outline;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+        EntryList m_entries;                                                // Most recently used at the front.
+        std::unordered_map<CacheKey, EntryList::iterator, CacheKeyHash> m_entryMap;
+        uint32_t m_maximumCount;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+    public:
+        struct Statistics
+        {
+            uint32_t Count;
+            uint64_t HitCount;          // Glyphs whose outline was already cached.
+            uint64_t MissCount;         // Glyphs that had to be fetched from the font face.
+            uint64_t EvictionCount;
+        };
+
+        static const uint32_t DefaultMaximumCount = 4096;
+
+        GlyphOutlineCache();
+
+        GlyphOutlineCache(GlyphOutlineCache const&) = delete;
+        GlyphOutlineCache& operator=(GlyphOutlineCache const&) = delete;
+
+        // Streams the outline of a glyph run into sink, the same as
+        // IDWriteFontFace::GetGlyphRunOutline.  Runs without explicit
+        // advances go straight to the font face, as the cache can't
+        // position their glyphs.  Does not close the sink.
+        void GetGlyphRunOutline(DWRITE_GLYPH_RUN const* glyphRun, ID2D1SimplifiedGeometrySink* sink);
+
+        Statistics GetStatistics();
+
+        uint32_t GetMaximumCount();
+        void SetMaximumCount(uint32_t value);
+
+        void Clear();
+
+    private:
+        std::shared_ptr<GlyphOutline const> GetOutline(IDWriteFontFace* fontFace, uint16_t glyphIndex, float emSize, bool isSideways);
+
+        void EvictToCount(Lock const& lock, uint32_t count);
+    };
+}}}}}
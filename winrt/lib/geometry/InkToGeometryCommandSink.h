@@ -6,6 +6,14 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
 {
+    //
+    // Streams ink from a command list into geometry sinks. Constructed with a
+    // single sink, everything goes into it. Constructed with a list of sinks,
+    // each piece of ink goes to the sink selected by the command list's most
+    // recent SetTags call: tag1 == 1 picks the first sink, and so on. This lets
+    // CreateInkBatch record many stroke sets into one command list and split
+    // them apart again in a single streaming pass.
+    //
     class InkToGeometryCommandSink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1CommandSink2>,
                                      private LifespanTracker<InkToGeometryCommandSink>
     {
@@ -14,14 +22,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         D2D1_MATRIX_3X2_F m_transform;
         float m_flatteningTolerance;
 
-        ComPtr<ID2D1GeometrySink> m_geometrySink;
+        std::vector<ComPtr<ID2D1GeometrySink>> m_geometrySinks;
+        bool m_selectSinkByTag;
+        ID2D1GeometrySink* m_currentSink;
 
     public:
         InkToGeometryCommandSink(Matrix3x2 const& transform, float flatteningTolerance, ID2D1GeometrySink* geometrySink)
             : m_result(S_OK)
             , m_transform(*ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform))
             , m_flatteningTolerance(flatteningTolerance)
-            , m_geometrySink(geometrySink)
+            , m_geometrySinks(1, geometrySink)
+            , m_selectSinkByTag(false)
+            , m_currentSink(geometrySink)
+        { }
+
+        InkToGeometryCommandSink(Matrix3x2 const& transform, float flatteningTolerance, std::vector<ComPtr<ID2D1GeometrySink>> geometrySinks)
+            : m_result(S_OK)
+            , m_transform(*ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform))
+            , m_flatteningTolerance(flatteningTolerance)
+            , m_geometrySinks(std::move(geometrySinks))
+            , m_selectSinkByTag(true)
+            , m_currentSink(nullptr)
         { }
 
         HRESULT GetResult()
@@ -31,18 +52,28 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         IFACEMETHODIMP DrawInk(ID2D1Ink* ink, ID2D1Brush*, ID2D1InkStyle* inkStyle) override
         {
-            if (SUCCEEDED(m_result))
+            if (SUCCEEDED(m_result) && m_currentSink)
             {
-                m_result = ink->StreamAsGeometry(inkStyle, m_transform, m_flatteningTolerance, m_geometrySink.Get());
+                m_result = ink->StreamAsGeometry(inkStyle, m_transform, m_flatteningTolerance, m_currentSink);
             }
 
             return m_result;
         }
 
+        IFACEMETHODIMP SetTags(D2D1_TAG tag1, D2D1_TAG) override
+        {
+            if (m_selectSinkByTag)
+            {
+                // Ink drawn under any tag we didn't set is ignored.
+                m_currentSink = (tag1 > 0 && tag1 <= m_geometrySinks.size()) ? m_geometrySinks[static_cast<size_t>(tag1 - 1)].Get() : nullptr;
+            }
+
+            return S_OK;
+        }
+
         IFACEMETHODIMP BeginDraw() override { return S_OK; }
         IFACEMETHODIMP EndDraw() override { return S_OK; }
         IFACEMETHODIMP SetAntialiasMode(D2D1_ANTIALIAS_MODE) override { return S_OK; }
-        IFACEMETHODIMP SetTags(D2D1_TAG, D2D1_TAG) override { return S_OK; }
         IFACEMETHODIMP SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE) override { return S_OK; }
         IFACEMETHODIMP SetTextRenderingParams(IDWriteRenderingParams*) override { return S_OK; }
         IFACEMETHODIMP SetTransform(CONST D2D1_MATRIX_3X2_F*) override { return S_OK; }
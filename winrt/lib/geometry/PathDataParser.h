@@ -0,0 +1,476 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    //
+    // Parses SVG path data - the syntax of the 'd' attribute - straight into
+    // a D2D geometry sink, for CanvasGeometry.CreateFromPathData.  This
+    // avoids both building a CanvasSvgDocument and making a WinRT call per
+    // segment through CanvasPathBuilder.
+    //
+    // All of the SVG 1.1 commands are supported, in absolute and relative
+    // form, including implicitly repeated commands, numbers that run
+    // together ("1-2.5.5") and arc flags without separators.  Smooth curves
+    // reflect the previous control point as SVG requires.  Arcs map onto
+    // D2D1_ARC_SEGMENT, which resolves out of range radii the same way SVG
+    // does.
+    //
+    // Malformed data throws E_INVALIDARG with the offset of the character
+    // that could not be parsed, rather than silently drawing the path up to
+    // that point the way an SVG renderer would.
+    //
+    // CHAR is wchar_t for strings and char for UTF-8 (path data is always
+    // ASCII, so the bytes can be used directly).
+    //
+    template<typename CHAR>
+    class PathDataParser
+    {
+        CHAR const* m_begin;
+        CHAR const* m_current;
+        CHAR const* m_end;
+
+        ID2D1GeometrySink* m_sink;
+
+        bool m_inFigure;
+        D2D1_POINT_2F m_figureStart;
+        D2D1_POINT_2F m_currentPoint;
+
+        // The control point that S and T reflect, and the command that set it.
+        D2D1_POINT_2F m_lastControlPoint;
+        char m_lastCommand;
+
+    public:
+        static void Parse(CHAR const* pathData, uint32_t length, ID2D1GeometrySink* sink)
+        {
+            PathDataParser parser(pathData, length, sink);
+
+            parser.Parse();
+        }
+
+    private:
+        PathDataParser(CHAR const* pathData, uint32_t length, ID2D1GeometrySink* sink)
+            : m_begin(pathData)
+            , m_current(pathData)
+            , m_end(pathData + length)
+            , m_sink(sink)
+            , m_inFigure(false)
+            , m_figureStart{}
+            , m_currentPoint{}
+            , m_lastControlPoint{}
+            , m_lastCommand(0)
+        {
+        }
+
+        void Parse()
+        {
+            SkipWhitespace();
+
+            char command = 0;
+
+            while (m_current < m_end)
+            {
+                if (IsCommand(*m_current))
+                {
+                    command = static_cast<char>(*m_current++);
+                    SkipWhitespace();
+                }
+                else if (command == 0 || command == 'Z' || command == 'z' || !StartsNumber(*m_current))
+                {
+                    // Only commands with arguments can be repeated implicitly.
+                    ThrowParseError();
+                }
+
+                ParseCommand(command);
+
+                // Repeated moveto arguments are treated as lineto.
+                if (command == 'M')
+                    command = 'L';
+                else if (command == 'm')
+                    command = 'l';
+
+                SkipCommaWhitespace();
+            }
+
+            EndFigure(D2D1_FIGURE_END_OPEN);
+        }
+
+        void ParseCommand(char command)
+        {
+            bool relative = (command >= 'a');
+            char absoluteCommand = relative ? static_cast<char>(command - ('a' - 'A')) : command;
+
+            if (absoluteCommand != 'M' && absoluteCommand != 'Z')
+            {
+                // The first command must be a moveto.
+                if (m_lastCommand == 0)
+                    ThrowParseError();
+
+                // A drawing command straight after closepath starts a new
+                // figure at the start of the one that was closed.
+                EnsureFigure();
+            }
+
+            switch (absoluteCommand)
+            {
+            case 'M':
+                {
+                    auto point = ReadPoint(relative);
+                    EndFigure(D2D1_FIGURE_END_OPEN);
+                    m_figureStart = point;
+                    m_currentPoint = point;
+                    EnsureFigure();
+                    break;
+                }
+
+            case 'Z':
+                if (m_lastCommand == 0)
+                    ThrowParseError();
+
+                EndFigure(D2D1_FIGURE_END_CLOSED);
+                m_currentPoint = m_figureStart;
+                break;
+
+            case 'L':
+                AddLine(ReadPoint(relative));
+                break;
+
+            case 'H':
+                {
+                    auto x = ReadNumber();
+                    AddLine(D2D1::Point2F(relative ? m_currentPoint.x + x : x, m_currentPoint.y));
+                    break;
+                }
+
+            case 'V':
+                {
+                    auto y = ReadNumber();
+                    AddLine(D2D1::Point2F(m_currentPoint.x, relative ? m_currentPoint.y + y : y));
+                    break;
+                }
+
+            case 'C':
+                {
+                    auto control1 = ReadPoint(relative);
+                    SkipCommaWhitespace();
+                    auto control2 = ReadPoint(relative);
+                    SkipCommaWhitespace();
+                    AddCubicBezier(control1, control2, ReadPoint(relative));
+                    break;
+                }
+
+            case 'S':
+                {
+                    auto control1 = ReflectLastControlPoint('C', 'S');
+                    auto control2 = ReadPoint(relative);
+                    SkipCommaWhitespace();
+                    AddCubicBezier(control1, control2, ReadPoint(relative));
+                    break;
+                }
+
+            case 'Q':
+                {
+                    auto control = ReadPoint(relative);
+                    SkipCommaWhitespace();
+                    AddQuadraticBezier(control, ReadPoint(relative));
+                    break;
+                }
+
+            case 'T':
+                {
+                    auto control = ReflectLastControlPoint('Q', 'T');
+                    AddQuadraticBezier(control, ReadPoint(relative));
+                    break;
+                }
+
+            case 'A':
+                AddArc(relative);
+                break;
+            }
+
+            m_lastCommand = absoluteCommand;
+        }
+
+        void EnsureFigure()
+        {
+            if (m_inFigure)
+                return;
+
+            m_sink->BeginFigure(m_currentPoint, D2D1_FIGURE_BEGIN_FILLED);
+            m_figureStart = m_currentPoint;
+            m_inFigure = true;
+        }
+
+        void EndFigure(D2D1_FIGURE_END figureEnd)
+        {
+            if (!m_inFigure)
+                return;
+
+            m_sink->EndFigure(figureEnd);
+            m_inFigure = false;
+        }
+
+        void AddLine(D2D1_POINT_2F const& point)
+        {
+            m_sink->AddLine(point);
+            m_currentPoint = point;
+        }
+
+        void AddCubicBezier(D2D1_POINT_2F const& control1, D2D1_POINT_2F const& control2, D2D1_POINT_2F const& end)
+        {
+            D2D1_BEZIER_SEGMENT bezier{ control1, control2, end };
+            m_sink->AddBezier(&bezier);
+
+            m_lastControlPoint = control2;
+            m_currentPoint = end;
+        }
+
+        void AddQuadraticBezier(D2D1_POINT_2F const& control, D2D1_POINT_2F const& end)
+        {
+            D2D1_QUADRATIC_BEZIER_SEGMENT bezier{ control, end };
+            m_sink->AddQuadraticBezier(&bezier);
+
+            m_lastControlPoint = control;
+            m_currentPoint = end;
+        }
+
+        void AddArc(bool relative)
+        {
+            auto radiusX = fabs(ReadNumber());
+            SkipCommaWhitespace();
+            auto radiusY = fabs(ReadNumber());
+            SkipCommaWhitespace();
+            auto rotationAngle = ReadNumber();
+            SkipCommaWhitespace();
+            auto isLargeArc = ReadFlag();
+            SkipCommaWhitespace();
+            auto isClockwise = ReadFlag();
+            SkipCommaWhitespace();
+            auto end = ReadPoint(relative);
+
+            // An arc that ends where it starts is omitted, and one with a
+            // zero radius is drawn as a straight line.
+            if (end.x == m_currentPoint.x && end.y == m_currentPoint.y)
+                return;
+
+            if (radiusX == 0 || radiusY == 0)
+            {
+                AddLine(end);
+                return;
+            }
+
+            D2D1_ARC_SEGMENT arc
+            {
+                end,
+                D2D1::SizeF(radiusX, radiusY),
+                rotationAngle,
+                isClockwise ? D2D1_SWEEP_DIRECTION_CLOCKWISE : D2D1_SWEEP_DIRECTION_COUNTER_CLOCKWISE,
+                isLargeArc ? D2D1_ARC_SIZE_LARGE : D2D1_ARC_SIZE_SMALL
+            };
+
+            m_sink->AddArc(&arc);
+            m_currentPoint = end;
+        }
+
+        D2D1_POINT_2F ReflectLastControlPoint(char curveCommand, char smoothCommand)
+        {
+            if (m_lastCommand != curveCommand && m_lastCommand != smoothCommand)
+                return m_currentPoint;
+
+            return D2D1::Point2F(2 * m_currentPoint.x - m_lastControlPoint.x,
+                                 2 * m_currentPoint.y - m_lastControlPoint.y);
+        }
+
+        D2D1_POINT_2F ReadPoint(bool relative)
+        {
+            auto x = ReadNumber();
+            SkipCommaWhitespace();
+            auto y = ReadNumber();
+
+            if (relative)
+            {
+                x += m_currentPoint.x;
+                y += m_currentPoint.y;
+            }
+
+            return D2D1::Point2F(x, y);
+        }
+
+        bool ReadFlag()
+        {
+            if (m_current < m_end && (*m_current == '0' || *m_current == '1'))
+                return *m_current++ == '1';
+
+            ThrowParseError();
+        }
+
+        // Reads a number in the SVG 'number' syntax.  The digits are
+        // accumulated into an integer and scaled once at the end, which is
+        // much cheaper than wcstod and doesn't depend on the current locale.
+        float ReadNumber()
+        {
+            auto start = m_current;
+
+            bool negative = false;
+
+            if (m_current < m_end && (*m_current == '+' || *m_current == '-'))
+                negative = (*m_current++ == '-');
+
+            uint64_t mantissa = 0;
+            int exponent = 0;
+            bool anyDigits = false;
+
+            const uint64_t maximumMantissa = 100000000000000000ull;
+
+            while (m_current < m_end && IsDigit(*m_current))
+            {
+                if (mantissa < maximumMantissa)
+                    mantissa = mantissa * 10 + (*m_current - '0');
+                else
+                    exponent++;
+
+                m_current++;
+                anyDigits = true;
+            }
+
+            if (m_current < m_end && *m_current == '.')
+            {
+                m_current++;
+
+                while (m_current < m_end && IsDigit(*m_current))
+                {
+                    if (mantissa < maximumMantissa)
+                    {
+                        mantissa = mantissa * 10 + (*m_current - '0');
+                        exponent--;
+                    }
+
+                    m_current++;
+                    anyDigits = true;
+                }
+            }
+
+            if (!anyDigits)
+            {
+                m_current = start;
+                ThrowParseError();
+            }
+
+            // Only treat 'e' as an exponent if digits follow it.
+            if (m_current < m_end && (*m_current == 'e' || *m_current == 'E'))
+            {
+                auto exponentStart = m_current + 1;
+                bool negativeExponent = false;
+
+                if (exponentStart < m_end && (*exponentStart == '+' || *exponentStart == '-'))
+                    negativeExponent = (*exponentStart++ == '-');
+
+                if (exponentStart < m_end && IsDigit(*exponentStart))
+                {
+                    int explicitExponent = 0;
+
+                    for (m_current = exponentStart; m_current < m_end && IsDigit(*m_current); m_current++)
+                    {
+                        if (explicitExponent < 1000)
+                            explicitExponent = explicitExponent * 10 + (*m_current - '0');
+                    }
+
+                    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                }
+            }
+
+            auto value = static_cast<float>(Scale(static_cast<double>(mantissa), exponent));
+
+            if (!std::isfinite(value))
+            {
+                m_current = start;
+                ThrowParseError();
+            }
+
+            return negative ? -value : value;
+        }
+
+        static double Scale(double value, int exponent)
+        {
+            static const double powersOfTen[] =
+            {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            const int tableSize = _countof(powersOfTen);
+
+            if (value == 0 || exponent == 0)
+                return value;
+            else if (exponent > 0 && exponent < tableSize)
+                return value * powersOfTen[exponent];
+            else if (exponent < 0 && -exponent < tableSize)
+                return value / powersOfTen[-exponent];
+            else
+                return value * pow(10.0, exponent);
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_current < m_end && IsWhitespace(*m_current))
+                m_current++;
+        }
+
+        void SkipCommaWhitespace()
+        {
+            SkipWhitespace();
+
+            if (m_current < m_end && *m_current == ',')
+            {
+                m_current++;
+                SkipWhitespace();
+            }
+        }
+
+        __declspec(noreturn) void ThrowParseError()
+        {
+            WinStringBuilder message;
+            message.Format(Strings::InvalidPathData, static_cast<int>(m_current - m_begin));
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        static bool IsWhitespace(CHAR c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f';
+        }
+
+        static bool IsDigit(CHAR c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static bool StartsNumber(CHAR c)
+        {
+            return IsDigit(c) || c == '+' || c == '-' || c == '.';
+        }
+
+        static bool IsCommand(CHAR c)
+        {
+            switch (c)
+            {
+            case 'M': case 'm':
+            case 'Z': case 'z':
+            case 'L': case 'l':
+            case 'H': case 'h':
+            case 'V': case 'v':
+            case 'C': case 'c':
+            case 'S': case 's':
+            case 'Q': case 'q':
+            case 'T': case 't':
+            case 'A': case 'a':
+                return true;
+
+            default:
+                return false;
+            }
+        }
+    };
+}}}}}
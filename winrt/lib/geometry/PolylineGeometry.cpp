@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "PolylineGeometry.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::DirectX;
+
+    static_assert(sizeof(D2D1_POINT_2F) * 2 == sizeof(XMFLOAT4), "Two D2D1_POINT_2F are expected to load as one XMFLOAT4");
+
+    namespace
+    {
+        // The rows of a 3x2 matrix, each repeated twice, so that a vector
+        // holding two points (x0, y0, x1, y1) is transformed in one go.
+        struct PairTransform
+        {
+            XMVECTOR M0;
+            XMVECTOR M1;
+            XMVECTOR M2;
+
+            PairTransform(D2D1_MATRIX_3X2_F const& transform)
+                : M0(XMVectorSet(transform._11, transform._12, transform._11, transform._12))
+                , M1(XMVectorSet(transform._21, transform._22, transform._21, transform._22))
+                , M2(XMVectorSet(transform._31, transform._32, transform._31, transform._32))
+            { }
+
+            XMVECTOR XM_CALLCONV TransformPoints(FXMVECTOR points) const
+            {
+                auto x = XMVectorSwizzle<0, 0, 2, 2>(points);
+                auto y = XMVectorSwizzle<1, 1, 3, 3>(points);
+
+                return XMVectorMultiplyAdd(x, M0, XMVectorMultiplyAdd(y, M1, M2));
+            }
+
+            // The vector between two points isn't affected by translation.
+            XMVECTOR XM_CALLCONV TransformVectors(FXMVECTOR vectors) const
+            {
+                auto x = XMVectorSwizzle<0, 0, 2, 2>(vectors);
+                auto y = XMVectorSwizzle<1, 1, 3, 3>(vectors);
+
+                return XMVectorMultiplyAdd(x, M0, XMVectorMultiply(y, M1));
+            }
+        };
+
+        XMVECTOR LoadPointPair(D2D1_POINT_2F const* points)
+        {
+            return XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(points));
+        }
+
+        // Loads a single point into both halves of a vector.
+        XMVECTOR LoadPoint(D2D1_POINT_2F const& point)
+        {
+            return XMVectorSet(point.x, point.y, point.x, point.y);
+        }
+
+        // Returns the lengths of two vectors (dx0, dy0, dx1, dy1) in the x and z lanes.
+        XMVECTOR XM_CALLCONV PairLengths(FXMVECTOR vectors)
+        {
+            auto squares = XMVectorMultiply(vectors, vectors);
+
+            return XMVectorSqrt(XMVectorAdd(squares, XMVectorSwizzle<1, 0, 3, 2>(squares)));
+        }
+
+        float SumSegmentLengths(PairTransform const& transform, D2D1_POINT_2F const* points, uint32_t pointCount)
+        {
+            auto sums = XMVectorZero();
+            uint32_t i = 0;
+
+            // Each step measures the segments from point i to i + 1, and i + 1 to i + 2.
+            for (; i + 2 < pointCount; i += 2)
+            {
+                auto segments = XMVectorSubtract(LoadPointPair(points + i + 1), LoadPointPair(points + i));
+
+                sums = XMVectorAdd(sums, PairLengths(transform.TransformVectors(segments)));
+            }
+
+            auto sum = XMVectorGetX(sums) + XMVectorGetZ(sums);
+
+            if (i + 1 < pointCount)
+            {
+                auto segment = XMVectorSubtract(LoadPoint(points[i + 1]), LoadPoint(points[i]));
+
+                sum += XMVectorGetX(PairLengths(transform.TransformVectors(segment)));
+            }
+
+            return sum;
+        }
+
+        void TransformPoints(PairTransform const& transform, D2D1_POINT_2F const* source, uint32_t pointCount, D2D1_POINT_2F* dest)
+        {
+            uint32_t i = 0;
+
+            for (; i + 1 < pointCount; i += 2)
+            {
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(dest + i), transform.TransformPoints(LoadPointPair(source + i)));
+            }
+
+            if (i < pointCount)
+            {
+                XMStoreFloat2(reinterpret_cast<XMFLOAT2*>(dest + i), transform.TransformPoints(LoadPoint(source[i])));
+            }
+        }
+    }
+
+
+    void PolylineGeometry::BeginFigure(D2D1_POINT_2F startPoint)
+    {
+        auto begin = static_cast<uint32_t>(m_points.size());
+
+        m_figures.push_back(Figure{ begin, begin + 1, false });
+        m_points.push_back(startPoint);
+    }
+
+
+    void PolylineGeometry::AddLines(D2D1_POINT_2F const* points, uint32_t pointCount)
+    {
+        m_points.insert(m_points.end(), points, points + pointCount);
+        m_figures.back().End = static_cast<uint32_t>(m_points.size());
+    }
+
+
+    void PolylineGeometry::EndFigure(D2D1_FIGURE_END figureEnd)
+    {
+        m_figures.back().IsClosed = (figureEnd == D2D1_FIGURE_END_CLOSED);
+    }
+
+
+    D2D1_RECT_F PolylineGeometry::ComputeBounds(D2D1_MATRIX_3X2_F const& transform) const
+    {
+        PairTransform pairTransform(transform);
+
+        auto minimum = XMVectorSplatInfinity();
+        auto maximum = XMVectorNegate(minimum);
+
+        auto points = m_points.data();
+        auto pointCount = static_cast<uint32_t>(m_points.size());
+        uint32_t i = 0;
+
+        for (; i + 1 < pointCount; i += 2)
+        {
+            auto transformed = pairTransform.TransformPoints(LoadPointPair(points + i));
+
+            minimum = XMVectorMin(minimum, transformed);
+            maximum = XMVectorMax(maximum, transformed);
+        }
+
+        if (i < pointCount)
+        {
+            auto transformed = pairTransform.TransformPoints(LoadPoint(points[i]));
+
+            minimum = XMVectorMin(minimum, transformed);
+            maximum = XMVectorMax(maximum, transformed);
+        }
+
+        // Combine the even and odd points.
+        minimum = XMVectorMin(minimum, XMVectorSwizzle<2, 3, 0, 1>(minimum));
+        maximum = XMVectorMax(maximum, XMVectorSwizzle<2, 3, 0, 1>(maximum));
+
+        return D2D1::RectF(XMVectorGetX(minimum), XMVectorGetY(minimum), XMVectorGetX(maximum), XMVectorGetY(maximum));
+    }
+
+
+    float PolylineGeometry::ComputeLength(D2D1_MATRIX_3X2_F const& transform) const
+    {
+        PairTransform pairTransform(transform);
+
+        // Summing each figure separately keeps rounding errors down on huge paths.
+        double length = 0;
+
+        for (auto& figure : m_figures)
+        {
+            auto points = m_points.data() + figure.Begin;
+            auto pointCount = figure.End - figure.Begin;
+
+            length += SumSegmentLengths(pairTransform, points, pointCount);
+
+            if (figure.IsClosed && pointCount > 1)
+            {
+                auto closingSegment = XMVectorSubtract(LoadPoint(points[0]), LoadPoint(points[pointCount - 1]));
+
+                length += XMVectorGetX(PairLengths(pairTransform.TransformVectors(closingSegment)));
+            }
+        }
+
+        return static_cast<float>(length);
+    }
+
+
+    void PolylineGeometry::Flatten(D2D1_MATRIX_3X2_F const& transform, std::vector<D2D1_POINT_2F>* points, std::vector<float>* distances) const
+    {
+        PairTransform pairTransform(transform);
+
+        points->clear();
+        distances->clear();
+
+        points->reserve(m_points.size() + m_figures.size());
+        distances->reserve(m_points.size() + m_figures.size());
+
+        float distance = 0;
+
+        for (auto& figure : m_figures)
+        {
+            auto figureStart = points->size();
+            auto sourceCount = figure.End - figure.Begin;
+
+            points->resize(figureStart + sourceCount);
+            TransformPoints(pairTransform, m_points.data() + figure.Begin, sourceCount, points->data() + figureStart);
+
+            if (figure.IsClosed)
+                points->push_back((*points)[figureStart]);
+
+            auto figurePoints = points->data() + figureStart;
+            auto figurePointCount = points->size() - figureStart;
+
+            // Moving to the start of a new figure doesn't add to the length.
+            distances->push_back(distance);
+
+            size_t i = 1;
+
+            for (; i + 1 < figurePointCount; i += 2)
+            {
+                auto lengths = PairLengths(XMVectorSubtract(LoadPointPair(figurePoints + i), LoadPointPair(figurePoints + i - 1)));
+
+                distance += XMVectorGetX(lengths);
+                distances->push_back(distance);
+
+                distance += XMVectorGetZ(lengths);
+                distances->push_back(distance);
+            }
+
+            if (i < figurePointCount)
+            {
+                auto dx = figurePoints[i].x - figurePoints[i - 1].x;
+                auto dy = figurePoints[i].y - figurePoints[i - 1].y;
+
+                distance += sqrtf(dx * dx + dy * dy);
+                distances->push_back(distance);
+            }
+        }
+    }
+}}}}}
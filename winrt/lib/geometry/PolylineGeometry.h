@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    //
+    // The source points of a geometry made up only of straight lines, as
+    // created by CanvasGeometry.CreatePolygon, CreatePolylines, or a
+    // CanvasPathBuilder that was only given lines.
+    //
+    // Lines need no flattening, so CanvasGeometry answers bounds, length and
+    // point-on-path queries for them directly from these points, rather than
+    // through D2D's general purpose path routines.  The results don't depend
+    // on the flattening tolerance.  Points are processed two at a time with
+    // DirectXMath, which compiles to SSE2 or NEON.
+    //
+    // Only filled figures are recorded, since those are all that the
+    // creation methods that use this produce.
+    //
+    class PolylineGeometry
+    {
+        struct Figure
+        {
+            uint32_t Begin;
+            uint32_t End;
+            bool IsClosed;
+        };
+
+        std::vector<D2D1_POINT_2F> m_points;
+        std::vector<Figure> m_figures;
+
+    public:
+        void BeginFigure(D2D1_POINT_2F startPoint);
+        void AddLines(D2D1_POINT_2F const* points, uint32_t pointCount);
+        void EndFigure(D2D1_FIGURE_END figureEnd);
+
+        bool IsEmpty() const { return m_points.empty(); }
+
+        D2D1_RECT_F ComputeBounds(D2D1_MATRIX_3X2_F const& transform) const;
+
+        float ComputeLength(D2D1_MATRIX_3X2_F const& transform) const;
+
+        // Produces the transformed points, with the start of each closed
+        // figure repeated at its end, and how far along the path each one is.
+        void Flatten(D2D1_MATRIX_3X2_F const& transform, std::vector<D2D1_POINT_2F>* points, std::vector<float>* distances) const;
+    };
+}}}}}
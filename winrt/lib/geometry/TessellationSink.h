@@ -41,5 +41,62 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
             return ComArray<CanvasTriangleVertices>(m_triangles.begin(), m_triangles.end());
         }
+
+        std::vector<CanvasTriangleVertices> TakeTriangles()
+        {
+            ThrowIfFailed(m_result);
+
+            return std::move(m_triangles);
+        }
+    };
+
+
+    //
+    // Writes triangles straight into a caller supplied buffer, rather than
+    // collecting them up to be copied out afterwards. If the buffer is too
+    // small the remaining triangles are only counted, so the caller can find
+    // out how big a buffer it needs.
+    //
+    class BufferTessellationSink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1TessellationSink>,
+                                   private LifespanTracker<BufferTessellationSink>
+    {
+        CanvasTriangleVertices* m_buffer;
+        uint32_t m_capacity;
+        uint32_t m_count;
+
+    public:
+        BufferTessellationSink(CanvasTriangleVertices* buffer, uint32_t capacity)
+            : m_buffer(buffer)
+            , m_capacity(capacity)
+            , m_count(0)
+        { }
+
+        IFACEMETHODIMP_(void) AddTriangles(D2D1_TRIANGLE const* triangles, UINT32 trianglesCount)
+        {
+            if (m_count < m_capacity)
+            {
+                auto canvasTriangles = ReinterpretAs<CanvasTriangleVertices const*>(triangles);
+                auto copyCount = std::min(trianglesCount, m_capacity - m_count);
+
+                std::copy(canvasTriangles, canvasTriangles + copyCount, stdext::make_checked_array_iterator(m_buffer + m_count, m_capacity - m_count));
+            }
+
+            m_count += trianglesCount;
+        }
+
+        IFACEMETHODIMP Close()
+        {
+            return S_OK;
+        }
+
+        uint32_t GetCount() const
+        {
+            return m_count;
+        }
+
+        bool Overflowed() const
+        {
+            return m_count > m_capacity;
+        }
     };
 }}}}}
@@ -0,0 +1,935 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasAnimatedBitmap.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasAnimatedBitmapFactory
+    //
+
+    static ComPtr<IWICBitmapDecoder> CreateDecoder(HSTRING fileName)
+    {
+        ComPtr<IWICBitmapDecoder> decoder;
+        ThrowIfFailed(WicAdapter::GetInstance()->GetFactory()->CreateDecoderFromFilename(
+            WindowsGetStringRawBuffer(fileName, nullptr),
+            nullptr,
+            GENERIC_READ,
+            WICDecodeMetadataCacheOnDemand,
+            &decoder));
+        return decoder;
+    }
+
+    static ComPtr<IWICBitmapDecoder> CreateDecoder(IStream* stream)
+    {
+        ComPtr<IWICBitmapDecoder> decoder;
+        ThrowIfFailed(WicAdapter::GetInstance()->GetFactory()->CreateDecoderFromStream(
+            stream,
+            nullptr,
+            WICDecodeMetadataCacheOnDemand,
+            &decoder));
+        return decoder;
+    }
+
+
+    IFACEMETHODIMP CanvasAnimatedBitmapFactory::LoadAsyncFromFileName(
+        ICanvasResourceCreator* rawResourceCreator,
+        HSTRING rawFileName,
+        IAsyncOperation<CanvasAnimatedBitmap*>** result)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(rawResourceCreator);
+                CheckInPointer(rawFileName);
+                CheckAndClearOutPointer(result);
+
+                WinString fileName(rawFileName);
+                ComPtr<ICanvasResourceCreator> resourceCreator(rawResourceCreator);
+
+                auto operation = Make<AsyncOperation<CanvasAnimatedBitmap>>(
+                    [=]
+                    {
+                        auto decoder = CreateDecoder(static_cast<HSTRING>(fileName));
+                        AsyncCancellation::ThrowIfCanceled();
+                        return CanvasAnimatedBitmap::CreateNew(resourceCreator.Get(), decoder.Get());
+                    });
+                CheckMakeResult(operation);
+                ThrowIfFailed(operation.CopyTo(result));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasAnimatedBitmapFactory::LoadAsyncFromUri(
+        ICanvasResourceCreator* rawResourceCreator,
+        IUriRuntimeClass* uri,
+        IAsyncOperation<CanvasAnimatedBitmap*>** result)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(rawResourceCreator);
+                CheckInPointer(uri);
+                CheckAndClearOutPointer(result);
+
+                ComPtr<ICanvasResourceCreator> resourceCreator(rawResourceCreator);
+
+                ComPtr<IRandomAccessStreamReferenceStatics> streamReferenceStatics;
+                ThrowIfFailed(GetActivationFactory(HStringReference(RuntimeClass_Windows_Storage_Streams_RandomAccessStreamReference).Get(), &streamReferenceStatics));
+
+                ComPtr<IRandomAccessStreamReference> streamReference;
+                ThrowIfFailed(streamReferenceStatics->CreateFromUri(uri, &streamReference));
+
+                // Start opening the file.
+                ComPtr<IAsyncOperation<IRandomAccessStreamWithContentType*>> openOperation;
+                ThrowIfFailed(streamReference->OpenReadAsync(&openOperation));
+
+                auto operation = Make<AsyncOperation<CanvasAnimatedBitmap>>(openOperation,
+                    [=]
+                    {
+                        ComPtr<IRandomAccessStreamWithContentType> randomAccessStream;
+                        ThrowIfFailed(openOperation->GetResults(&randomAccessStream));
+
+                        ComPtr<IStream> stream;
+                        ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
+
+                        auto decoder = CreateDecoder(stream.Get());
+                        AsyncCancellation::ThrowIfCanceled();
+                        return CanvasAnimatedBitmap::CreateNew(resourceCreator.Get(), decoder.Get());
+                    });
+                CheckMakeResult(operation);
+                ThrowIfFailed(operation.CopyTo(result));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasAnimatedBitmapFactory::LoadAsyncFromStream(
+        ICanvasResourceCreator* rawResourceCreator,
+        IRandomAccessStream* rawRandomAccessStream,
+        IAsyncOperation<CanvasAnimatedBitmap*>** result)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(rawResourceCreator);
+                CheckInPointer(rawRandomAccessStream);
+                CheckAndClearOutPointer(result);
+
+                ComPtr<ICanvasResourceCreator> resourceCreator(rawResourceCreator);
+                ComPtr<IRandomAccessStream> randomAccessStream(rawRandomAccessStream);
+
+                auto operation = Make<AsyncOperation<CanvasAnimatedBitmap>>(
+                    [=]
+                    {
+                        ComPtr<IStream> stream;
+                        ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
+
+                        auto decoder = CreateDecoder(stream.Get());
+                        AsyncCancellation::ThrowIfCanceled();
+                        return CanvasAnimatedBitmap::CreateNew(resourceCreator.Get(), decoder.Get());
+                    });
+                CheckMakeResult(operation);
+                ThrowIfFailed(operation.CopyTo(result));
+            });
+    }
+
+
+    //
+    // AnimationTimeline
+    //
+
+    AnimationTimeline::AnimationTimeline(std::vector<int64_t> const& frameDurations, int32_t loopCount)
+        : m_loopCount(loopCount)
+    {
+        int64_t end = 0;
+
+        for (auto duration : frameDurations)
+        {
+            end += duration;
+            m_frameEnds.push_back(end);
+        }
+    }
+
+    int32_t AnimationTimeline::GetFrameCount() const
+    {
+        return static_cast<int32_t>(m_frameEnds.size());
+    }
+
+    int32_t AnimationTimeline::GetLoopCount() const
+    {
+        return m_loopCount;
+    }
+
+    int64_t AnimationTimeline::GetDuration() const
+    {
+        return m_frameEnds.empty() ? 0 : m_frameEnds.back();
+    }
+
+    int64_t AnimationTimeline::GetFrameDuration(int32_t frameIndex) const
+    {
+        auto start = (frameIndex > 0) ? m_frameEnds[frameIndex - 1] : 0;
+
+        return m_frameEnds[frameIndex] - start;
+    }
+
+    int32_t AnimationTimeline::GetFrameAtTime(int64_t time) const
+    {
+        auto duration = GetDuration();
+
+        if (duration <= 0 || time <= 0)
+            return 0;
+
+        // Once the last loop is over, the last frame stays showing.
+        if (m_loopCount > 0 && time / duration >= m_loopCount)
+            return GetFrameCount() - 1;
+
+        auto timeInLoop = time % duration;
+
+        auto frameEnd = std::upper_bound(m_frameEnds.begin(), m_frameEnds.end(), timeInLoop);
+
+        return static_cast<int32_t>(frameEnd - m_frameEnds.begin());
+    }
+
+
+    //
+    // AnimatedFrameDecoder
+    //
+
+    AnimatedFrameDecoder::AnimatedFrameDecoder(ICanvasDevice* device, IWICBitmapDecoder* decoder, int32_t frameCount)
+        : m_device(device)
+        , m_frameCount(frameCount)
+        , m_decoder(decoder)
+        , m_currentFrame(0)
+        , m_isPrefetching(false)
+    {
+    }
+
+    ComPtr<ID2D1Bitmap1> AnimatedFrameDecoder::GetFrame(int32_t frameIndex)
+    {
+        bool startPrefetching = false;
+
+        {
+            Lock lock(m_mutex);
+
+            m_currentFrame = frameIndex;
+
+            // Frames we have moved past are no use any more.
+            m_prefetchedFrames.erase(
+                std::remove_if(m_prefetchedFrames.begin(), m_prefetchedFrames.end(),
+                    [&](std::pair<int32_t, ComPtr<ID2D1Bitmap1>> const& frame) { return !IsWanted(frame.first); }),
+                m_prefetchedFrames.end());
+
+            if (!m_isPrefetching && GetNextFrameToPrefetch() >= 0)
+            {
+                m_isPrefetching = true;
+                startPrefetching = true;
+            }
+        }
+
+        if (startPrefetching)
+            StartPrefetching();
+
+        auto frame = FindPrefetchedFrame(frameIndex);
+
+        if (frame)
+            return frame;
+
+        // The worker might be decoding this very frame, in which case we
+        // wait for it rather than decoding it a second time.
+        Lock decodeLock(m_decodeMutex);
+
+        frame = FindPrefetchedFrame(frameIndex);
+
+        if (frame)
+            return frame;
+
+        return DecodeFrame(frameIndex);
+    }
+
+    void AnimatedFrameDecoder::Close()
+    {
+        {
+            Lock decodeLock(m_decodeMutex);
+            m_decoder.Reset();
+        }
+
+        Lock lock(m_mutex);
+        m_prefetchedFrames.clear();
+    }
+
+    ComPtr<ID2D1Bitmap1> AnimatedFrameDecoder::DecodeFrame(int32_t frameIndex)
+    {
+        if (!m_decoder)
+            ThrowHR(RO_E_CLOSED);
+
+        ComPtr<IWICBitmapFrameDecode> frameDecode;
+        ThrowIfFailed(m_decoder->GetFrame(frameIndex, &frameDecode));
+
+        ComPtr<IWICFormatConverter> formatConverter;
+        ThrowIfFailed(WicAdapter::GetInstance()->GetFactory()->CreateFormatConverter(&formatConverter));
+
+        ThrowIfFailed(formatConverter->Initialize(
+            frameDecode.Get(),
+            GUID_WICPixelFormat32bppPBGRA,
+            WICBitmapDitherTypeNone,
+            nullptr,
+            0,
+            WICBitmapPaletteTypeMedianCut));
+
+        return As<ICanvasDeviceInternal>(m_device)->CreateBitmapFromWicResource(formatConverter.Get(), DEFAULT_DPI, CanvasAlphaMode::Premultiplied);
+    }
+
+    ComPtr<ID2D1Bitmap1> AnimatedFrameDecoder::FindPrefetchedFrame(int32_t frameIndex)
+    {
+        Lock lock(m_mutex);
+
+        for (auto& frame : m_prefetchedFrames)
+        {
+            if (frame.first == frameIndex)
+                return frame.second;
+        }
+
+        return nullptr;
+    }
+
+    bool AnimatedFrameDecoder::IsWanted(int32_t frameIndex) const
+    {
+        // The current frame and the few after it, wrapping around for
+        // animations that loop.  Short animations end up keeping every frame.
+        auto distance = (frameIndex - m_currentFrame + m_frameCount) % m_frameCount;
+
+        return distance <= PrefetchFrameCount;
+    }
+
+    int32_t AnimatedFrameDecoder::GetNextFrameToPrefetch() const
+    {
+        auto lookAhead = std::min(PrefetchFrameCount, m_frameCount - 1);
+
+        for (int32_t i = 1; i <= lookAhead; i++)
+        {
+            auto frameIndex = (m_currentFrame + i) % m_frameCount;
+
+            auto isPrefetched = std::any_of(m_prefetchedFrames.begin(), m_prefetchedFrames.end(),
+                [=](std::pair<int32_t, ComPtr<ID2D1Bitmap1>> const& frame) { return frame.first == frameIndex; });
+
+            if (!isPrefetched)
+                return frameIndex;
+        }
+
+        return -1;
+    }
+
+    void AnimatedFrameDecoder::StartPrefetching()
+    {
+        using ABI::Windows::System::Threading::IWorkItemHandler;
+
+        auto self = shared_from_this();
+
+        auto workItem = Callback<AddFtmBase<IWorkItemHandler>::Type>(
+            [self](IAsyncAction*)
+            {
+                self->PrefetchWorker();
+                return S_OK;
+            });
+
+        try
+        {
+            CheckMakeResult(workItem);
+
+            AsyncScheduler::GetInstance().Run(workItem);
+        }
+        catch (...)
+        {
+            Lock lock(m_mutex);
+            m_isPrefetching = false;
+            throw;
+        }
+    }
+
+    void AnimatedFrameDecoder::PrefetchWorker()
+    {
+        for (;;)
+        {
+            int32_t frameIndex;
+
+            {
+                Lock lock(m_mutex);
+
+                frameIndex = GetNextFrameToPrefetch();
+
+                if (frameIndex < 0)
+                {
+                    m_isPrefetching = false;
+                    return;
+                }
+            }
+
+            Lock decodeLock(m_decodeMutex);
+
+            ComPtr<ID2D1Bitmap1> bitmap;
+            HRESULT hr = ExceptionBoundary([&] { bitmap = DecodeFrame(frameIndex); });
+
+            Lock lock(m_mutex);
+
+            if (FAILED(hr))
+            {
+                // Leave it to GetFrame to decode the frame, and report what
+                // went wrong, when it is actually needed.
+                m_isPrefetching = false;
+                return;
+            }
+
+            // The current frame may have moved on while we were decoding.
+            if (IsWanted(frameIndex))
+                m_prefetchedFrames.emplace_back(frameIndex, bitmap);
+        }
+    }
+
+
+    //
+    // CanvasAnimatedBitmap
+    //
+
+    template<typename T>
+    static ComPtr<IWICMetadataQueryReader> TryGetMetadataQueryReader(T* frameOrDecoder)
+    {
+        ComPtr<IWICMetadataQueryReader> queryReader;
+
+        HRESULT hr = frameOrDecoder->GetMetadataQueryReader(&queryReader);
+
+        // This is expected for formats that have no metadata, such as BMP.
+        if (hr == WINCODEC_ERR_UNSUPPORTEDOPERATION)
+            return nullptr;
+
+        ThrowIfFailed(hr);
+
+        return queryReader;
+    }
+
+    template<typename TFunction>
+    static bool TryGetMetadata(IWICMetadataQueryReader* queryReader, wchar_t const* name, TFunction&& useValue)
+    {
+        if (!queryReader)
+            return false;
+
+        PROPVARIANT value;
+        PropVariantInit(&value);
+
+        auto clearValue = MakeScopeWarden([&] { PropVariantClear(&value); });
+
+        HRESULT hr = queryReader->GetMetadataByName(name, &value);
+
+        if (hr == WINCODEC_ERR_PROPERTYNOTFOUND || hr == WINCODEC_ERR_PROPERTYNOTSUPPORTED)
+            return false;
+
+        ThrowIfFailed(hr);
+
+        return useValue(value);
+    }
+
+    static uint32_t GetMetadataUInt(IWICMetadataQueryReader* queryReader, wchar_t const* name, uint32_t defaultValue)
+    {
+        uint32_t result = defaultValue;
+
+        TryGetMetadata(queryReader, name,
+            [&](PROPVARIANT const& value)
+            {
+                switch (value.vt)
+                {
+                case VT_UI1: result = value.bVal;  return true;
+                case VT_UI2: result = value.uiVal; return true;
+                case VT_UI4: result = value.ulVal; return true;
+                default:                           return false;
+                }
+            });
+
+        return result;
+    }
+
+    static std::vector<uint8_t> GetMetadataBytes(IWICMetadataQueryReader* queryReader, wchar_t const* name)
+    {
+        std::vector<uint8_t> result;
+
+        TryGetMetadata(queryReader, name,
+            [&](PROPVARIANT const& value)
+            {
+                if (value.vt != (VT_UI1 | VT_VECTOR))
+                    return false;
+
+                result.assign(value.caub.pElems, value.caub.pElems + value.caub.cElems);
+                return true;
+            });
+
+        return result;
+    }
+
+    static int32_t GetGifLoopCount(IWICMetadataQueryReader* queryReader)
+    {
+        // Looping is controlled by the NETSCAPE2.0 application extension.
+        // Without it, the animation plays once.
+        auto application = GetMetadataBytes(queryReader, L"/appext/Application");
+
+        static const char netscape[] = "NETSCAPE2.0";
+
+        if (application.size() != sizeof(netscape) - 1 ||
+            !std::equal(application.begin(), application.end(), netscape))
+        {
+            return 1;
+        }
+
+        // A sub-block of 3 bytes: 1, then a little endian repeat count.
+        auto data = GetMetadataBytes(queryReader, L"/appext/Data");
+
+        if (data.size() < 4 || data[0] != 3 || data[1] != 1)
+            return 1;
+
+        auto repeatCount = data[2] | (data[3] << 8);
+
+        // Zero repeats forever.  Anything else counts repeats after the
+        // first time through.
+        return repeatCount ? repeatCount + 1 : 0;
+    }
+
+    static AnimatedFrameDisposal ToAnimatedFrameDisposal(uint32_t gifDisposal)
+    {
+        switch (gifDisposal)
+        {
+        case 2:  return AnimatedFrameDisposal::RestoreBackground;
+        case 3:  return AnimatedFrameDisposal::RestorePrevious;
+        default: return AnimatedFrameDisposal::None;
+        }
+    }
+
+    // TimeSpan units are 100ns.
+    static const int64_t TicksPerMillisecond = 10000;
+
+    // Browsers slow down GIFs that ask for frames faster than this, since
+    // so many files were made relying on it, so we do the same.
+    static const uint32_t MinimumGifDelayInMilliseconds = 20;
+    static const uint32_t DefaultDelayInMilliseconds = 100;
+
+    ComPtr<CanvasAnimatedBitmap> CanvasAnimatedBitmap::CreateNew(
+        ICanvasResourceCreator* resourceCreator,
+        IWICBitmapDecoder* decoder)
+    {
+        auto device = GetCanvasDevice(resourceCreator);
+
+        GUID containerFormat;
+        ThrowIfFailed(decoder->GetContainerFormat(&containerFormat));
+
+        bool isGif = (containerFormat == GUID_ContainerFormatGif);
+
+        uint32_t frameCount;
+        ThrowIfFailed(decoder->GetFrameCount(&frameCount));
+
+        if (frameCount == 0)
+            ThrowHR(WINCODEC_ERR_FRAMEMISSING);
+
+        auto decoderMetadata = isGif ? TryGetMetadataQueryReader(decoder) : nullptr;
+
+        BitmapSize size
+        {
+            GetMetadataUInt(decoderMetadata.Get(), L"/logscrdesc/Width", 0),
+            GetMetadataUInt(decoderMetadata.Get(), L"/logscrdesc/Height", 0)
+        };
+
+        std::vector<AnimatedFrameInfo> frames;
+        std::vector<int64_t> frameDurations;
+
+        for (uint32_t i = 0; i < frameCount; i++)
+        {
+            ComPtr<IWICBitmapFrameDecode> frameDecode;
+            ThrowIfFailed(decoder->GetFrame(i, &frameDecode));
+
+            uint32_t width, height;
+            ThrowIfFailed(frameDecode->GetSize(&width, &height));
+
+            // Formats other than GIF (such as multi-page TIFF) have no
+            // placement or timing information, so each frame replaces the
+            // last one, at the size of the first.
+            AnimatedFrameInfo frame{};
+            uint32_t delayInMilliseconds = DefaultDelayInMilliseconds;
+
+            if (isGif)
+            {
+                auto frameMetadata = TryGetMetadataQueryReader(frameDecode.Get());
+
+                frame.Offset.x = GetMetadataUInt(frameMetadata.Get(), L"/imgdesc/Left", 0);
+                frame.Offset.y = GetMetadataUInt(frameMetadata.Get(), L"/imgdesc/Top", 0);
+                frame.Disposal = ToAnimatedFrameDisposal(GetMetadataUInt(frameMetadata.Get(), L"/grctlext/Disposal", 0));
+
+                // The delay is in hundredths of a second.
+                delayInMilliseconds = GetMetadataUInt(frameMetadata.Get(), L"/grctlext/Delay", 0) * 10;
+
+                if (delayInMilliseconds < MinimumGifDelayInMilliseconds)
+                    delayInMilliseconds = DefaultDelayInMilliseconds;
+            }
+            else
+            {
+                frame.Disposal = AnimatedFrameDisposal::RestoreBackground;
+            }
+
+            if (size.Width == 0 || size.Height == 0)
+                size = BitmapSize{ width, height };
+
+            frame.Rect = D2D1_RECT_U
+            {
+                std::min(frame.Offset.x, size.Width),
+                std::min(frame.Offset.y, size.Height),
+                std::min(frame.Offset.x + width, size.Width),
+                std::min(frame.Offset.y + height, size.Height)
+            };
+
+            frames.push_back(frame);
+            frameDurations.push_back(delayInMilliseconds * TicksPerMillisecond);
+        }
+
+        AnimationTimeline timeline(frameDurations, isGif ? GetGifLoopCount(decoderMetadata.Get()) : 0);
+
+        auto animatedBitmap = Make<CanvasAnimatedBitmap>(
+            device.Get(),
+            decoder,
+            size,
+            std::move(frames),
+            timeline);
+        CheckMakeResult(animatedBitmap);
+
+        {
+            Lock lock(animatedBitmap->m_mutex);
+            animatedBitmap->SetCurrentFrame(0);
+        }
+
+        return animatedBitmap;
+    }
+
+    CanvasAnimatedBitmap::CanvasAnimatedBitmap(
+        ICanvasDevice* device,
+        IWICBitmapDecoder* decoder,
+        BitmapSize size,
+        std::vector<AnimatedFrameInfo>&& frames,
+        AnimationTimeline const& timeline)
+        : m_device(device)
+        , m_size(size)
+        , m_frames(std::move(frames))
+        , m_timeline(timeline)
+        , m_decoder(std::make_shared<AnimatedFrameDecoder>(device, decoder, timeline.GetFrameCount()))
+        , m_composedFrame(-1)
+        , m_currentFrame(0)
+    {
+        m_composedBitmap = As<ICanvasDeviceInternal>(device)->CreateRenderTargetBitmap(
+            static_cast<float>(size.Width),
+            static_cast<float>(size.Height),
+            DEFAULT_DPI,
+            PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            CanvasAlphaMode::Premultiplied);
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::Close()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                Lock lock(m_mutex);
+
+                if (m_decoder)
+                    m_decoder->Close();
+
+                m_decoder.reset();
+                m_composedBitmap.Reset();
+                m_previousBitmap.Reset();
+                m_device.Reset();
+            });
+    }
+
+    void CanvasAnimatedBitmap::ThrowIfClosed()
+    {
+        if (!m_device)
+            ThrowHR(RO_E_CLOSED);
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_SizeInPixels(BitmapSize* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_size;
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_Size(Size* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                // Always 96 DPI, so DIPs are pixels.
+                *value = Size{ static_cast<float>(m_size.Width), static_cast<float>(m_size.Height) };
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_Bounds(Rect* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = Rect{ 0, 0, static_cast<float>(m_size.Width), static_cast<float>(m_size.Height) };
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_FrameCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_timeline.GetFrameCount();
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_LoopCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_timeline.GetLoopCount();
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_Duration(TimeSpan* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                value->Duration = m_timeline.GetDuration();
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::GetFrameDuration(int32_t frameIndex, TimeSpan* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                if (frameIndex < 0 || frameIndex >= m_timeline.GetFrameCount())
+                    ThrowHR(E_INVALIDARG);
+
+                value->Duration = m_timeline.GetFrameDuration(frameIndex);
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::get_CurrentFrame(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                Lock lock(m_mutex);
+
+                *value = m_currentFrame;
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::put_CurrentFrame(int32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 0 || value >= m_timeline.GetFrameCount())
+                    ThrowHR(E_INVALIDARG);
+
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                SetCurrentFrame(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::SetTime(TimeSpan time)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                SetCurrentFrame(m_timeline.GetFrameAtTime(time.Duration));
+            });
+    }
+
+    void CanvasAnimatedBitmap::SetCurrentFrame(int32_t frameIndex)
+    {
+        if (frameIndex != m_composedFrame)
+        {
+            // Frames build on the ones before them, so going backwards (which
+            // includes looping round to the start) means starting again.
+            bool isRestart = (m_composedFrame < 0 || frameIndex < m_composedFrame);
+            auto firstFrame = isRestart ? 0 : m_composedFrame + 1;
+
+            auto deviceContext = As<ICanvasDeviceInternal>(m_device)->CreateDeviceContextForDrawingSession();
+            deviceContext->SetDpi(DEFAULT_DPI, DEFAULT_DPI);
+
+            for (auto i = firstFrame; i <= frameIndex; i++)
+            {
+                // If this fails part way through, start again next time.
+                m_composedFrame = -1;
+
+                ComposeFrame(deviceContext.Get(), i, isRestart && i == 0);
+
+                m_composedFrame = i;
+            }
+        }
+
+        m_currentFrame = frameIndex;
+    }
+
+    static bool IsEmpty(D2D1_RECT_U const& r)
+    {
+        return r.right <= r.left || r.bottom <= r.top;
+    }
+
+    void CanvasAnimatedBitmap::ComposeFrame(ID2D1DeviceContext1* deviceContext, int32_t frameIndex, bool isFirst)
+    {
+        auto& frame = m_frames[frameIndex];
+
+        auto frameBitmap = m_decoder->GetFrame(frameIndex);
+
+        // Get rid of the previous frame, as it asked.
+        if (isFirst)
+        {
+            ClearRect(deviceContext, D2D1_RECT_U{ 0, 0, m_size.Width, m_size.Height });
+        }
+        else
+        {
+            auto& previous = m_frames[frameIndex - 1];
+
+            if (!IsEmpty(previous.Rect))
+            {
+                switch (previous.Disposal)
+                {
+                case AnimatedFrameDisposal::RestoreBackground:
+                    ClearRect(deviceContext, previous.Rect);
+                    break;
+
+                case AnimatedFrameDisposal::RestorePrevious:
+                    {
+                        auto destination = D2D1_POINT_2U{ previous.Rect.left, previous.Rect.top };
+                        ThrowIfFailed(m_composedBitmap->CopyFromBitmap(&destination, m_previousBitmap.Get(), &previous.Rect));
+                    }
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+
+        if (IsEmpty(frame.Rect))
+            return;
+
+        // Keep a copy of what this frame is about to cover, if it will need putting back.
+        if (frame.Disposal == AnimatedFrameDisposal::RestorePrevious)
+        {
+            if (!m_previousBitmap)
+            {
+                m_previousBitmap = As<ICanvasDeviceInternal>(m_device)->CreateRenderTargetBitmap(
+                    static_cast<float>(m_size.Width),
+                    static_cast<float>(m_size.Height),
+                    DEFAULT_DPI,
+                    PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                    CanvasAlphaMode::Premultiplied);
+            }
+
+            auto destination = D2D1_POINT_2U{ frame.Rect.left, frame.Rect.top };
+            ThrowIfFailed(m_previousBitmap->CopyFromBitmap(&destination, m_composedBitmap.Get(), &frame.Rect));
+        }
+
+        deviceContext->SetTarget(m_composedBitmap.Get());
+        deviceContext->BeginDraw();
+
+        auto offset = D2D1_POINT_2F{ static_cast<float>(frame.Offset.x), static_cast<float>(frame.Offset.y) };
+
+        deviceContext->DrawImage(frameBitmap.Get(), &offset, nullptr, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_COMPOSITE_MODE_SOURCE_OVER);
+
+        HRESULT hr = deviceContext->EndDraw();
+        deviceContext->SetTarget(nullptr);
+
+        ThrowIfFailed(hr);
+    }
+
+    void CanvasAnimatedBitmap::ClearRect(ID2D1DeviceContext1* deviceContext, D2D1_RECT_U const& rect)
+    {
+        deviceContext->SetTarget(m_composedBitmap.Get());
+        deviceContext->BeginDraw();
+
+        deviceContext->PushAxisAlignedClip(
+            D2D1_RECT_F
+            {
+                static_cast<float>(rect.left),
+                static_cast<float>(rect.top),
+                static_cast<float>(rect.right),
+                static_cast<float>(rect.bottom)
+            },
+            D2D1_ANTIALIAS_MODE_ALIASED);
+
+        deviceContext->Clear(D2D1_COLOR_F{ 0, 0, 0, 0 });
+        deviceContext->PopAxisAlignedClip();
+
+        HRESULT hr = deviceContext->EndDraw();
+        deviceContext->SetTarget(nullptr);
+
+        ThrowIfFailed(hr);
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::GetBounds(ICanvasResourceCreator* resourceCreator, Rect* bounds)
+    {
+        return GetImageBoundsImpl(this, resourceCreator, nullptr, bounds);
+    }
+
+    IFACEMETHODIMP CanvasAnimatedBitmap::GetBoundsWithTransform(ICanvasResourceCreator* resourceCreator, Numerics::Matrix3x2 transform, Rect* bounds)
+    {
+        return GetImageBoundsImpl(this, resourceCreator, &transform, bounds);
+    }
+
+    ComPtr<ID2D1Image> CanvasAnimatedBitmap::GetD2DImage(ICanvasDevice*, ID2D1DeviceContext*, GetImageFlags, float, float* realizedDpi)
+    {
+        if (realizedDpi)
+            *realizedDpi = DEFAULT_DPI;
+
+        Lock lock(m_mutex);
+        ThrowIfClosed();
+
+        return m_composedBitmap;
+    }
+}}}}
+
+ActivatableClassWithFactory(CanvasAnimatedBitmap, CanvasAnimatedBitmapFactory);
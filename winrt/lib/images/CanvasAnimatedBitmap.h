@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    class CanvasAnimatedBitmapFactory
+        : public AgileActivationFactory<ICanvasAnimatedBitmapStatics>
+        , private LifespanTracker<CanvasAnimatedBitmapFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasAnimatedBitmap, BaseTrust);
+
+    public:
+        IFACEMETHODIMP LoadAsyncFromFileName(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING fileName,
+            IAsyncOperation<CanvasAnimatedBitmap*>** result) override;
+
+        IFACEMETHODIMP LoadAsyncFromUri(
+            ICanvasResourceCreator* resourceCreator,
+            IUriRuntimeClass* uri,
+            IAsyncOperation<CanvasAnimatedBitmap*>** result) override;
+
+        IFACEMETHODIMP LoadAsyncFromStream(
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            IAsyncOperation<CanvasAnimatedBitmap*>** result) override;
+    };
+
+
+    //
+    // Works out which frame is showing at a given time, from how long each
+    // frame shows for and how many times the animation plays.  Times are in
+    // TimeSpan units (100ns).
+    //
+    class AnimationTimeline
+    {
+        // When each frame stops showing, measured from the start of a loop.
+        std::vector<int64_t> m_frameEnds;
+        int32_t m_loopCount;
+
+    public:
+        AnimationTimeline(std::vector<int64_t> const& frameDurations, int32_t loopCount);
+
+        int32_t GetFrameCount() const;
+        int32_t GetLoopCount() const;
+        int64_t GetDuration() const;
+        int64_t GetFrameDuration(int32_t frameIndex) const;
+
+        int32_t GetFrameAtTime(int64_t time) const;
+    };
+
+
+    enum class AnimatedFrameDisposal
+    {
+        // Leave the frame in place for the next one to be drawn over.
+        None,
+
+        // Clear the frame's rectangle to transparent.
+        RestoreBackground,
+
+        // Put back whatever was under the frame before it was drawn.
+        RestorePrevious,
+    };
+
+
+    struct AnimatedFrameInfo
+    {
+        // Where the frame goes, clipped to the bounds of the animation.
+        D2D1_RECT_U Rect;
+        D2D1_POINT_2U Offset;
+        AnimatedFrameDisposal Disposal;
+    };
+
+
+    //
+    // Owns the WIC decoder, and keeps the next few frames after the current
+    // one decoded and uploaded to the GPU, ready for it to move on to them.
+    // This is done on a worker thread, which keeps this alive until it
+    // finishes.  A frame that isn't ready when it is asked for is decoded
+    // there and then.
+    //
+    class AnimatedFrameDecoder : public std::enable_shared_from_this<AnimatedFrameDecoder>
+    {
+        static const int32_t PrefetchFrameCount = 3;
+
+        ComPtr<ICanvasDevice> m_device;
+        int32_t m_frameCount;
+
+        // WIC decoders must not be used by more than one thread at a time.
+        std::mutex m_decodeMutex;
+        ComPtr<IWICBitmapDecoder> m_decoder;
+
+        // Guards everything below.  When both are needed, m_decodeMutex is
+        // taken first.
+        std::mutex m_mutex;
+        int32_t m_currentFrame;
+        std::vector<std::pair<int32_t, ComPtr<ID2D1Bitmap1>>> m_prefetchedFrames;
+        bool m_isPrefetching;
+
+    public:
+        AnimatedFrameDecoder(ICanvasDevice* device, IWICBitmapDecoder* decoder, int32_t frameCount);
+
+        ComPtr<ID2D1Bitmap1> GetFrame(int32_t frameIndex);
+
+        void Close();
+
+    private:
+        // Must be called with m_decodeMutex held.
+        ComPtr<ID2D1Bitmap1> DecodeFrame(int32_t frameIndex);
+
+        ComPtr<ID2D1Bitmap1> FindPrefetchedFrame(int32_t frameIndex);
+
+        // These must be called with m_mutex held.
+        bool IsWanted(int32_t frameIndex) const;
+        int32_t GetNextFrameToPrefetch() const;
+
+        void StartPrefetching();
+        void PrefetchWorker();
+    };
+
+
+    class CanvasAnimatedBitmap
+        : public RuntimeClass<
+            ICanvasAnimatedBitmap,
+            ICanvasImage,
+            IGraphicsEffectSource,
+            IClosable,
+            CloakedIid<ICanvasImageInternal>>
+        , private LifespanTracker<CanvasAnimatedBitmap>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasAnimatedBitmap, BaseTrust);
+
+        std::mutex m_mutex;
+
+        ComPtr<ICanvasDevice> m_device;
+        BitmapSize m_size;
+        std::vector<AnimatedFrameInfo> m_frames;
+        AnimationTimeline m_timeline;
+        std::shared_ptr<AnimatedFrameDecoder> m_decoder;
+
+        // What has been drawn so far, up to and including m_composedFrame.
+        ComPtr<ID2D1Bitmap1> m_composedBitmap;
+        int32_t m_composedFrame;
+        int32_t m_currentFrame;
+
+        // Holds what was under a RestorePrevious frame, to put it back.
+        ComPtr<ID2D1Bitmap1> m_previousBitmap;
+
+    public:
+        static ComPtr<CanvasAnimatedBitmap> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            IWICBitmapDecoder* decoder);
+
+        CanvasAnimatedBitmap(
+            ICanvasDevice* device,
+            IWICBitmapDecoder* decoder,
+            BitmapSize size,
+            std::vector<AnimatedFrameInfo>&& frames,
+            AnimationTimeline const& timeline);
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+        // ICanvasAnimatedBitmap
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+        IFACEMETHOD(get_SizeInPixels)(BitmapSize* value) override;
+        IFACEMETHOD(get_Size)(Size* value) override;
+        IFACEMETHOD(get_Bounds)(Rect* value) override;
+        IFACEMETHOD(get_FrameCount)(int32_t* value) override;
+        IFACEMETHOD(get_LoopCount)(int32_t* value) override;
+        IFACEMETHOD(get_Duration)(TimeSpan* value) override;
+        IFACEMETHOD(GetFrameDuration)(int32_t frameIndex, TimeSpan* value) override;
+        IFACEMETHOD(get_CurrentFrame)(int32_t* value) override;
+        IFACEMETHOD(put_CurrentFrame)(int32_t value) override;
+        IFACEMETHOD(SetTime)(TimeSpan time) override;
+
+        // ICanvasImage
+        IFACEMETHOD(GetBounds)(ICanvasResourceCreator*, Rect*) override;
+        IFACEMETHOD(GetBoundsWithTransform)(ICanvasResourceCreator*, Numerics::Matrix3x2, Rect*) override;
+
+        // ICanvasImageInternal
+        ComPtr<ID2D1Image> GetD2DImage(ICanvasDevice*, ID2D1DeviceContext*, GetImageFlags, float, float*) override;
+
+    private:
+        void ThrowIfClosed();
+        void SetCurrentFrame(int32_t frameIndex);
+        void ComposeFrame(ID2D1DeviceContext1* deviceContext, int32_t frameIndex, bool isFirst);
+        void ClearRect(ID2D1DeviceContext1* deviceContext, D2D1_RECT_U const& rect);
+    };
+}}}}
@@ -5,6 +5,13 @@
 #include "pch.h"
 #include <propkey.h>
 
+#include "CanvasMappedPixels.h"
+#include "drawing/CanvasGpuFence.h"
+#include "MappedFileStream.h"
+#include "utils/BlockCompression.h"
+#include "utils/D2DResourceLock.h"
+#include "utils/ParallelFor.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     using namespace ABI::Windows::Storage::Streams;
@@ -231,11 +238,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
     template<typename T>
-    static ComPtr<IWICBitmapSource> CreateWicBitmapSourceWithExifTransform(ICanvasDevice* device, T fileNameOrStream)
+    static ComPtr<IWICBitmapSource> CreateWicBitmapSourceWithExifTransform(ICanvasDevice* device, T fileNameOrStream, BitmapSize maximumSize = BitmapSize{}, BitmapBounds sourceRectangle = BitmapBounds{})
     {
         auto adapter = CanvasBitmapAdapter::GetInstance();
 
-        auto source = adapter->CreateWicBitmapSource(device, fileNameOrStream);
+        auto source = adapter->CreateWicBitmapSource(device, fileNameOrStream, false, maximumSize, sourceRectangle);
 
         if (source.Transform == WICBitmapTransformRotate0)
             return source.Source;
@@ -253,15 +260,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
     }
 
-    WicBitmapSource DefaultBitmapAdapter::CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing)
+    WicBitmapSource DefaultBitmapAdapter::CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing, BitmapSize maximumSize, BitmapBounds sourceRectangle)
     {
-        ComPtr<IWICStream> stream;
-        ThrowIfFailed(m_wicAdapter->GetFactory()->CreateStream(&stream));
+        return CreateWicBitmapSource(device, OpenFile(fileName).Get(), tryEnableIndexing, maximumSize, sourceRectangle);
+    }
 
+    ComPtr<IStream> DefaultBitmapAdapter::OpenFile(HSTRING fileName)
+    {
         WinString fileNameString(fileName);
-        ThrowIfFailed(stream->InitializeFromFilename(static_cast<const wchar_t*>(fileNameString), GENERIC_READ));
 
-        return CreateWicBitmapSource(device, stream.Get(), tryEnableIndexing);
+        // Prefer decoding directly from a mapped view of the file, falling
+        // back to a regular file stream if it can't be mapped. Any error
+        // opening the file is then reported by the fallback.
+        ComPtr<IStream> stream = MappedFileStream::TryCreate(static_cast<const wchar_t*>(fileNameString));
+
+        if (!stream)
+        {
+            ComPtr<IWICStream> wicStream;
+            ThrowIfFailed(m_wicAdapter->GetFactory()->CreateStream(&wicStream));
+            ThrowIfFailed(wicStream->InitializeFromFilename(static_cast<const wchar_t*>(fileNameString), GENERIC_READ));
+            stream = wicStream;
+        }
+
+        return stream;
     }
 
     static bool IsSupportedPixelFormat(ICanvasDevice* device, GUID const& frameFormat, GUID const& wicFormat, DXGI_FORMAT dxgiFormat)
@@ -270,7 +291,100 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext()->IsDxgiFormatSupported(dxgiFormat);
     }
 
-    WicBitmapSource DefaultBitmapAdapter::CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing)
+    //
+    // Works out how big to decode an image so it fits within maximumSize,
+    // preserving its aspect ratio.  A zero width or height leaves that
+    // direction unconstrained, and images are never scaled up.
+    //
+    static D2D1_SIZE_U GetDecodeSize(uint32_t width, uint32_t height, BitmapSize maximumSize)
+    {
+        double scale = 1;
+
+        if (maximumSize.Width)
+            scale = std::min(scale, static_cast<double>(maximumSize.Width) / width);
+
+        if (maximumSize.Height)
+            scale = std::min(scale, static_cast<double>(maximumSize.Height) / height);
+
+        if (scale >= 1)
+            return D2D1_SIZE_U{ width, height };
+
+        return D2D1_SIZE_U
+        {
+            std::max(static_cast<uint32_t>(width * scale + 0.5), 1U),
+            std::max(static_cast<uint32_t>(height * scale + 0.5), 1U)
+        };
+    }
+
+    static bool IsRotatedByQuarterTurn(WICBitmapTransformOptions transformOptions)
+    {
+        // The rotations are values rather than flags: Rotate270 is Rotate90 | Rotate180.
+        auto rotation = transformOptions & WICBitmapTransformRotate270;
+
+        return rotation == WICBitmapTransformRotate90 ||
+               rotation == WICBitmapTransformRotate270;
+    }
+
+    //
+    // Source rectangles are given the way up the image will be displayed,
+    // so this maps them back through the EXIF transform to the region of the
+    // frame they come from.  The flip is applied to the frame before it is
+    // rotated (that is what makes Rotate270 | FlipHorizontal a transpose), so
+    // undoing it goes the other way around.
+    //
+    static WICRect GetFrameRectangle(BitmapBounds const& sourceRectangle, uint32_t frameWidth, uint32_t frameHeight, WICBitmapTransformOptions transformOptions)
+    {
+        bool isQuarterTurn = IsRotatedByQuarterTurn(transformOptions);
+
+        auto displayWidth = isQuarterTurn ? frameHeight : frameWidth;
+        auto displayHeight = isQuarterTurn ? frameWidth : frameHeight;
+
+        if (static_cast<uint64_t>(sourceRectangle.X) + sourceRectangle.Width > displayWidth ||
+            static_cast<uint64_t>(sourceRectangle.Y) + sourceRectangle.Height > displayHeight)
+        {
+            ThrowHR(E_INVALIDARG, Strings::SourceRectangleOutsideImage);
+        }
+
+        auto w = static_cast<int>(frameWidth);
+        auto h = static_cast<int>(frameHeight);
+
+        auto toFrame = [&](int x, int y)
+        {
+            POINT point;
+
+            switch (transformOptions & WICBitmapTransformRotate270)
+            {
+            case WICBitmapTransformRotate90:  point = POINT{ y, h - x }; break;
+            case WICBitmapTransformRotate180: point = POINT{ w - x, h - y }; break;
+            case WICBitmapTransformRotate270: point = POINT{ w - y, x }; break;
+            default:                          point = POINT{ x, y }; break;
+            }
+
+            if (transformOptions & WICBitmapTransformFlipHorizontal)
+                point.x = w - point.x;
+
+            if (transformOptions & WICBitmapTransformFlipVertical)
+                point.y = h - point.y;
+
+            return point;
+        };
+
+        auto corner0 = toFrame(static_cast<int>(sourceRectangle.X), static_cast<int>(sourceRectangle.Y));
+        auto corner1 = toFrame(static_cast<int>(sourceRectangle.X + sourceRectangle.Width), static_cast<int>(sourceRectangle.Y + sourceRectangle.Height));
+
+        auto left = std::min(corner0.x, corner1.x);
+        auto top = std::min(corner0.y, corner1.y);
+
+        return WICRect
+        {
+            left,
+            top,
+            std::max(corner0.x, corner1.x) - left,
+            std::max(corner0.y, corner1.y) - top
+        };
+    }
+
+    WicBitmapSource DefaultBitmapAdapter::CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing, BitmapSize maximumSize, BitmapBounds sourceRectangle)
     {
         ComPtr<IWICBitmapDecoder> wicBitmapDecoder;
         ThrowIfFailed(m_wicAdapter->GetFactory()->CreateDecoderFromStream(
@@ -279,7 +393,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             WICDecodeMetadataCacheOnDemand,
             &wicBitmapDecoder));
 
-        auto ddsDecoder = MaybeAs<IWICDdsDecoder>(wicBitmapDecoder);
+        bool hasSourceRectangle = sourceRectangle.Width && sourceRectangle.Height;
+
+        // DDS files with a source rectangle are decoded like any other image,
+        // so the rectangle doesn't have to line up with the compressed blocks.
+        ComPtr<IWICDdsDecoder> ddsDecoder;
+        if (!hasSourceRectangle)
+            ddsDecoder = MaybeAs<IWICDdsDecoder>(wicBitmapDecoder);
+
         if (ddsDecoder)
         {
             // If it's a block compressed DDS file then we want to pass the
@@ -309,6 +430,87 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         auto orientation = GetOrientationFromFrameDecode(wicBitmapFrameDecode);
         auto transformOptions = GetTransformOptionsFromPhotoOrientation(orientation);
 
+        ComPtr<IWICBitmapSource> frameSource = wicBitmapFrameDecode;
+
+        uint32_t width, height;
+        ThrowIfFailed(wicBitmapFrameDecode->GetSize(&width, &height));
+
+        // The part of frameSource to load: all of it, unless there is a source rectangle.
+        auto frameRect = WICRect{ 0, 0, static_cast<INT>(width), static_cast<INT>(height) };
+
+        if (hasSourceRectangle)
+        {
+            frameRect = GetFrameRectangle(sourceRectangle, width, height, transformOptions);
+
+            // Indexing covers the whole image, not just part of it.
+            isIndexed = false;
+        }
+
+        if (maximumSize.Width || maximumSize.Height)
+        {
+            // The maximum size applies to the image the way up it will be
+            // displayed, but the scaling happens before the EXIF rotation.
+            if (IsRotatedByQuarterTurn(transformOptions))
+                std::swap(maximumSize.Width, maximumSize.Height);
+
+            auto decodeSize = GetDecodeSize(frameRect.Width, frameRect.Height, maximumSize);
+
+            if (decodeSize.width != static_cast<uint32_t>(frameRect.Width) ||
+                decodeSize.height != static_cast<uint32_t>(frameRect.Height))
+            {
+                // The whole frame is scaled by however much the source
+                // rectangle needs to shrink, and the rectangle is then
+                // clipped out of the scaled frame below.
+                auto scaleX = static_cast<double>(decodeSize.width) / frameRect.Width;
+                auto scaleY = static_cast<double>(decodeSize.height) / frameRect.Height;
+
+                auto scaledWidth = std::max(static_cast<uint32_t>(width * scaleX + 0.5), decodeSize.width);
+                auto scaledHeight = std::max(static_cast<uint32_t>(height * scaleY + 0.5), decodeSize.height);
+
+                auto scaledX = std::min(static_cast<uint32_t>(frameRect.X * scaleX + 0.5), scaledWidth - decodeSize.width);
+                auto scaledY = std::min(static_cast<uint32_t>(frameRect.Y * scaleY + 0.5), scaledHeight - decodeSize.height);
+
+                frameRect = WICRect{ static_cast<INT>(scaledX), static_cast<INT>(scaledY), static_cast<INT>(decodeSize.width), static_cast<INT>(decodeSize.height) };
+
+                width = scaledWidth;
+                height = scaledHeight;
+
+                //
+                // Scaling the frame itself, rather than the format converted
+                // output, lets WIC pass the request on to the decoder's
+                // IWICBitmapSourceTransform.  For JPEG that does most of the
+                // work in the IDCT, so the full size image is never produced.
+                //
+                ComPtr<IWICBitmapScaler> scaler;
+                ThrowIfFailed(m_wicAdapter->GetFactory()->CreateBitmapScaler(&scaler));
+                ThrowIfFailed(scaler->Initialize(wicBitmapFrameDecode.Get(), scaledWidth, scaledHeight, WICBitmapInterpolationModeFant));
+
+                frameSource = scaler;
+
+                // Indexing lets CanvasVirtualBitmap read parts of the
+                // original image, which no longer line up with a scaled one.
+                isIndexed = false;
+            }
+        }
+
+        if (frameRect.X != 0 ||
+            frameRect.Y != 0 ||
+            static_cast<uint32_t>(frameRect.Width) != width ||
+            static_cast<uint32_t>(frameRect.Height) != height)
+        {
+            //
+            // The clipper only ever asks its source for pixels inside the
+            // rectangle.  Decoders of tiled or striped formats such as TIFF
+            // then read just the tiles or strips it overlaps, and JPEG does
+            // not need to decode anything below the bottom of the rectangle.
+            //
+            ComPtr<IWICBitmapClipper> clipper;
+            ThrowIfFailed(m_wicAdapter->GetFactory()->CreateBitmapClipper(&clipper));
+            ThrowIfFailed(clipper->Initialize(frameSource.Get(), &frameRect));
+
+            frameSource = clipper;
+        }
+
         ComPtr<IWICFormatConverter> wicFormatConverter;
         ThrowIfFailed(m_wicAdapter->GetFactory()->CreateFormatConverter(&wicFormatConverter));
 
@@ -335,7 +537,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
 
         ThrowIfFailed(wicFormatConverter->Initialize(
-            wicBitmapFrameDecode.Get(),
+            frameSource.Get(),
             targetPixelFormat,
             WICBitmapDitherTypeNone,
             NULL,
@@ -357,19 +559,215 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return bitmapFlipRotator;
     }
 
+    ProgressiveLoadInfo DefaultBitmapAdapter::GetProgressiveLoadInfo(ICanvasDevice* device, HSTRING fileName)
+    {
+        return GetProgressiveLoadInfo(device, OpenFile(fileName).Get());
+    }
+
+    ProgressiveLoadInfo DefaultBitmapAdapter::GetProgressiveLoadInfo(ICanvasDevice*, IStream* fileStream)
+    {
+        ComPtr<IWICBitmapDecoder> wicBitmapDecoder;
+        ThrowIfFailed(m_wicAdapter->GetFactory()->CreateDecoderFromStream(
+            fileStream,
+            nullptr,
+            WICDecodeMetadataCacheOnDemand,
+            &wicBitmapDecoder));
+
+        ComPtr<IWICBitmapFrameDecode> wicBitmapFrameDecode;
+        ThrowIfFailed(wicBitmapDecoder->GetFrame(0, &wicBitmapFrameDecode));
+
+        auto transformOptions = GetTransformOptionsFromPhotoOrientation(GetOrientationFromFrameDecode(wicBitmapFrameDecode));
+
+        ProgressiveLoadInfo info{};
+
+        ThrowIfFailed(wicBitmapFrameDecode->GetSize(&info.Size.Width, &info.Size.Height));
+
+        if (IsRotatedByQuarterTurn(transformOptions))
+            std::swap(info.Size.Width, info.Size.Height);
+
+        // Typically a JPEG's EXIF thumbnail, which is decoded from a few KB of
+        // metadata rather than the image itself.  Not every frame has one,
+        // and not every codec supports looking for one.
+        ComPtr<IWICBitmapSource> thumbnail;
+        HRESULT hr = wicBitmapFrameDecode->GetThumbnail(&thumbnail);
+
+        if (hr == WINCODEC_ERR_CODECNOTHUMBNAIL || hr == WINCODEC_ERR_UNSUPPORTEDOPERATION)
+            return info;
+
+        ThrowIfFailed(hr);
+
+        ComPtr<IWICFormatConverter> wicFormatConverter;
+        ThrowIfFailed(m_wicAdapter->GetFactory()->CreateFormatConverter(&wicFormatConverter));
+
+        ThrowIfFailed(wicFormatConverter->Initialize(
+            thumbnail.Get(),
+            GUID_WICPixelFormat32bppPBGRA,
+            WICBitmapDitherTypeNone,
+            NULL,
+            0,
+            WICBitmapPaletteTypeMedianCut));
+
+        // The thumbnail is stored the same way up as the image it belongs to.
+        info.Thumbnail = WicBitmapSource{ wicFormatConverter, transformOptions, false };
+
+        return info;
+    }
+
+
+    static D2D1_SIZE_U GetLoadedSize(ID2D1Bitmap1* d2dBitmap)
+    {
+        return d2dBitmap->GetPixelSize();
+    }
+
+
+    static D2D1_SIZE_U GetLoadedSize(IWICBitmapSource* wicBitmapSource)
+    {
+        D2D1_SIZE_U size{};
+        (void)wicBitmapSource->GetSize(&size.width, &size.height);
+        return size;
+    }
+
+
+    // Emits the CanvasBitmap_Load events around decoding a bitmap, with the
+    // size of the result.  The size is only read when tracing is enabled.
+    template<typename FN>
+    static auto TraceBitmapLoad(FN&& loadFn) -> decltype(loadFn())
+    {
+        EventWrite_CanvasBitmap_Load_Start();
+
+        D2D1_SIZE_U loadedSize{};
+        auto loadEnd = MakeScopeWarden([&] { EventWrite_CanvasBitmap_Load_Stop(loadedSize.width, loadedSize.height); });
+
+        auto result = loadFn();
+
+        if (EventEnabled_CanvasBitmap_Load_Stop())
+            loadedSize = GetLoadedSize(result.Get());
+
+        return result;
+    }
+
+
+    static bool IsBlockCompressedFormat(DirectXPixelFormat format)
+    {
+        return format == PIXEL_FORMAT(BC1UIntNormalized) ||
+               format == PIXEL_FORMAT(BC2UIntNormalized) ||
+               format == PIXEL_FORMAT(BC3UIntNormalized);
+    }
+
+
+    static void ValidateLoadFormat(DirectXPixelFormat format, CanvasAlphaMode alpha)
+    {
+        if (format == PIXEL_FORMAT(B8G8R8A8UIntNormalized))
+            return;
+
+        if (!IsBlockCompressedFormat(format))
+            ThrowHR(E_INVALIDARG);
+
+        if (alpha != CanvasAlphaMode::Premultiplied)
+            ThrowHR(E_INVALIDARG, Strings::BlockCompressedLoadRequiresPremultipliedAlpha);
+    }
+
+
+    //
+    // Decodes the image a band of 4 rows at a time, compressing each band
+    // before moving on to the next, so the uncompressed image never needs to
+    // be held in memory all at once.  The bitmap is rounded up to a multiple
+    // of 4 pixels, since D2D requires that of block compressed bitmaps.
+    //
+    static ComPtr<ID2D1Bitmap1> CreateBlockCompressedBitmap(
+        ICanvasDeviceInternal* canvasDeviceInternal,
+        IWICBitmapSource* wicBitmapSource,
+        float dpi,
+        DirectXPixelFormat format)
+    {
+        ComPtr<IWICFormatConverter> wicFormatConverter;
+        ThrowIfFailed(WicAdapter::GetInstance()->GetFactory()->CreateFormatConverter(&wicFormatConverter));
+
+        ThrowIfFailed(wicFormatConverter->Initialize(
+            wicBitmapSource,
+            GUID_WICPixelFormat32bppPBGRA,
+            WICBitmapDitherTypeNone,
+            NULL,
+            0,
+            WICBitmapPaletteTypeMedianCut));
+
+        uint32_t width, height;
+        ThrowIfFailed(wicFormatConverter->GetSize(&width, &height));
+
+        auto dxgiFormat = static_cast<DXGI_FORMAT>(format);
+        uint32_t bytesPerBlock = (dxgiFormat == DXGI_FORMAT_BC1_UNORM) ? 8 : 16;
+
+        auto blocksWide = (width + 3) / 4;
+        auto blocksHigh = (height + 3) / 4;
+        auto blockRowPitch = blocksWide * bytesPerBlock;
+
+        std::vector<uint8_t> blocks(static_cast<size_t>(blockRowPitch) * blocksHigh);
+
+        auto bandPitch = width * 4;
+        std::vector<uint8_t> band(static_cast<size_t>(bandPitch) * 4);
+
+        for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+        {
+            AsyncCancellation::ThrowIfCanceled();
+
+            auto y = blockY * 4;
+            auto bandHeight = std::min(4u, height - y);
+
+            WICRect rect{ 0, static_cast<INT>(y), static_cast<INT>(width), static_cast<INT>(bandHeight) };
+            ThrowIfFailed(wicFormatConverter->CopyPixels(&rect, bandPitch, bandPitch * bandHeight, band.data()));
+
+            CompressBlocks(dxgiFormat, band.data(), bandPitch, width, bandHeight, blocks.data() + static_cast<size_t>(blockY) * blockRowPitch);
+        }
+
+        return canvasDeviceInternal->CreateBitmapFromBytes(
+            blocks.data(),
+            blockRowPitch,
+            static_cast<int32_t>(blocksWide * 4),
+            static_cast<int32_t>(blocksHigh * 4),
+            dpi,
+            format,
+            CanvasAlphaMode::Premultiplied);
+    }
+
+
+    static ComPtr<ID2D1Bitmap1> CreateBitmapFromLoadedSource(
+        ICanvasDeviceInternal* canvasDeviceInternal,
+        IWICBitmapSource* wicBitmapSource,
+        float dpi,
+        CanvasAlphaMode alpha,
+        DirectXPixelFormat format)
+    {
+        // Block compressed DDS files are already in the format they'll be
+        // uploaded in, so are passed through as they are.
+        if (IsBlockCompressedFormat(format) && !MaybeAs<IWICDdsFrameDecode>(wicBitmapSource))
+            return CreateBlockCompressedBitmap(canvasDeviceInternal, wicBitmapSource, dpi, format);
+
+        return canvasDeviceInternal->CreateBitmapFromWicResource(wicBitmapSource, dpi, alpha);
+    }
+
 
     ComPtr<CanvasBitmap> CanvasBitmap::CreateNew(
         ICanvasDevice* canvasDevice,
         HSTRING fileName,
         float dpi,
-        CanvasAlphaMode alpha)
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        BitmapBounds sourceRectangle)
     {
         ComPtr<ICanvasDeviceInternal> canvasDeviceInternal;
         ThrowIfFailed(canvasDevice->QueryInterface(canvasDeviceInternal.GetAddressOf()));
 
-        auto wicBitmapSource = CreateWicBitmapSourceWithExifTransform(canvasDevice, fileName);
+        auto d2dBitmap = TraceBitmapLoad(
+            [&]
+            {
+                auto wicBitmapSource = CreateWicBitmapSourceWithExifTransform(canvasDevice, fileName, maximumSize, sourceRectangle);
 
-        auto d2dBitmap = canvasDeviceInternal->CreateBitmapFromWicResource(wicBitmapSource.Get(), dpi, alpha);
+                // Decoding, format conversion and upload all happen from here on.
+                AsyncCancellation::ThrowIfCanceled();
+
+                return CreateBitmapFromLoadedSource(canvasDeviceInternal.Get(), wicBitmapSource.Get(), dpi, alpha, format);
+            });
 
         auto bitmap = Make<CanvasBitmap>(
             canvasDevice,
@@ -384,14 +782,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ICanvasDevice* canvasDevice,
         IStream* fileStream,
         float dpi,
-        CanvasAlphaMode alpha)
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        BitmapBounds sourceRectangle)
     {
         ComPtr<ICanvasDeviceInternal> canvasDeviceInternal;
         ThrowIfFailed(canvasDevice->QueryInterface(canvasDeviceInternal.GetAddressOf()));
 
-        auto wicBitmapSource = CreateWicBitmapSourceWithExifTransform(canvasDevice, fileStream);
+        auto d2dBitmap = TraceBitmapLoad(
+            [&]
+            {
+                auto wicBitmapSource = CreateWicBitmapSourceWithExifTransform(canvasDevice, fileStream, maximumSize, sourceRectangle);
+
+                // Decoding, format conversion and upload all happen from here on.
+                AsyncCancellation::ThrowIfCanceled();
 
-        auto d2dBitmap = canvasDeviceInternal->CreateBitmapFromWicResource(wicBitmapSource.Get(), dpi, alpha);
+                return CreateBitmapFromLoadedSource(canvasDeviceInternal.Get(), wicBitmapSource.Get(), dpi, alpha, format);
+            });
 
         auto bitmap = Make<CanvasBitmap>(
             canvasDevice,
@@ -402,6 +810,127 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    //
+    // Each stage of a progressive load decodes the file again.  WIC reads
+    // streams from wherever they are positioned, so they are put back to the
+    // start before each stage.  File names are simply opened again.
+    //
+
+    static uint64_t GetStreamPosition(HSTRING)
+    {
+        return 0;
+    }
+
+    static uint64_t GetStreamPosition(IStream* stream)
+    {
+        LARGE_INTEGER zero{};
+        ULARGE_INTEGER position;
+        ThrowIfFailed(stream->Seek(zero, STREAM_SEEK_CUR, &position));
+        return position.QuadPart;
+    }
+
+    static void SetStreamPosition(HSTRING, uint64_t)
+    {
+    }
+
+    static void SetStreamPosition(IStream* stream, uint64_t position)
+    {
+        LARGE_INTEGER offset;
+        offset.QuadPart = static_cast<LONGLONG>(position);
+        ThrowIfFailed(stream->Seek(offset, STREAM_SEEK_SET, nullptr));
+    }
+
+
+    //
+    // Loads the embedded thumbnail (if there is one), then the image scaled
+    // down to previewSize (if that is bigger than the thumbnail but smaller
+    // than the image), passing each of them to previewHandler, and finally
+    // the full image.  Without a handler there is no point in any previews.
+    //
+    // Previews are given a DPI that makes them the same size in DIPs as the
+    // full resolution bitmap, so they can be drawn in its place.
+    //
+    template<typename T>
+    static ComPtr<CanvasBitmap> LoadProgressive(
+        ICanvasDevice* canvasDevice,
+        T fileNameOrStream,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize previewSize,
+        ComPtr<ICanvasBitmapPreviewHandler> const& previewHandler)
+    {
+        if (!previewHandler)
+            return CanvasBitmap::CreateNew(canvasDevice, fileNameOrStream, dpi, alpha);
+
+        auto adapter = CanvasBitmapAdapter::GetInstance();
+
+        auto startPosition = GetStreamPosition(fileNameOrStream);
+
+        auto info = adapter->GetProgressiveLoadInfo(canvasDevice, fileNameOrStream);
+
+        auto getPreviewDpi = [&](uint32_t previewWidth)
+        {
+            return dpi * previewWidth / info.Size.Width;
+        };
+
+        uint32_t previewWidth = 0;
+
+        if (info.Thumbnail.Source && info.Size.Width)
+        {
+            auto thumbnail = info.Thumbnail.Source;
+
+            if (info.Thumbnail.Transform != WICBitmapTransformRotate0)
+                thumbnail = adapter->CreateFlipRotator(thumbnail, info.Thumbnail.Transform);
+
+            uint32_t thumbnailWidth, thumbnailHeight;
+            ThrowIfFailed(thumbnail->GetSize(&thumbnailWidth, &thumbnailHeight));
+
+            if (thumbnailWidth < info.Size.Width)
+            {
+                AsyncCancellation::ThrowIfCanceled();
+
+                auto d2dBitmap = TraceBitmapLoad(
+                    [&]
+                    {
+                        return As<ICanvasDeviceInternal>(canvasDevice)->CreateBitmapFromWicResource(thumbnail.Get(), getPreviewDpi(thumbnailWidth), alpha);
+                    });
+
+                auto bitmap = Make<CanvasBitmap>(canvasDevice, d2dBitmap.Get());
+                CheckMakeResult(bitmap);
+
+                ThrowIfFailed(previewHandler->Invoke(bitmap.Get()));
+
+                previewWidth = thumbnailWidth;
+            }
+        }
+
+        // Done with the thumbnail, and the decoder behind it.
+        info.Thumbnail = WicBitmapSource{};
+
+        if ((previewSize.Width || previewSize.Height) && info.Size.Width)
+        {
+            auto decodeSize = GetDecodeSize(info.Size.Width, info.Size.Height, previewSize);
+
+            if (decodeSize.width > previewWidth && decodeSize.width < info.Size.Width)
+            {
+                AsyncCancellation::ThrowIfCanceled();
+
+                SetStreamPosition(fileNameOrStream, startPosition);
+
+                auto bitmap = CanvasBitmap::CreateNew(canvasDevice, fileNameOrStream, getPreviewDpi(decodeSize.width), alpha, previewSize);
+
+                ThrowIfFailed(previewHandler->Invoke(bitmap.Get()));
+            }
+        }
+
+        AsyncCancellation::ThrowIfCanceled();
+
+        SetStreamPosition(fileNameOrStream, startPosition);
+
+        return CanvasBitmap::CreateNew(canvasDevice, fileNameOrStream, dpi, alpha);
+    }
+
+
     ComPtr<CanvasBitmap> CanvasBitmap::CreateNew(
         ICanvasDevice* device,
         uint32_t byteCount,
@@ -469,29 +998,220 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
-#if WINVER > _WIN32_WINNT_WINBLUE
-
     //
-    // BitmapPixelFormat's values are intended to be reinterpreted as
-    // DXGI_FORMAT values.  Unfortunately, some of the chosen color values map
-    // to UINT rather than UNORM formats.  The intended use is UNORM, and so we
-    // fudge the BitmapPixelFormat values in these cases.
+    // There is no 24 bit DXGI format, so packed RGB has to be padded out to
+    // 32 bits before it can be uploaded. This is the only part of
+    // CreateFromBytesWithLayout that touches the pixels on the CPU, and
+    // leaves any channel swizzling to the GPU.
     //
-    static DirectXPixelFormat GetFudgedFormat(BitmapPixelFormat format)
+    static std::vector<uint8_t> PadTo32Bits(BYTE const* bytes, int32_t widthInPixels, int32_t heightInPixels)
     {
-        using namespace ABI::Windows::Graphics::Imaging;
-        
-        switch (format)
-        {
-        case BitmapPixelFormat_Rgba16: return PIXEL_FORMAT(R16G16B16A16UIntNormalized);
-        case BitmapPixelFormat_Rgba8:  return PIXEL_FORMAT(R8G8B8A8UIntNormalized);
-        case BitmapPixelFormat_Gray8:  return PIXEL_FORMAT(A8UIntNormalized);
+        auto pixelCount = static_cast<size_t>(widthInPixels) * static_cast<size_t>(heightInPixels);
 
-        case BitmapPixelFormat_Bgra8: // BitmapPixelFormat already uses the UNORM value here
-        default:
-            return static_cast<DirectXPixelFormat>(format);
-        }        
-    }
+        std::vector<uint8_t> padded(pixelCount * 4);
+
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            padded[i * 4 + 0] = bytes[i * 3 + 0];
+            padded[i * 4 + 1] = bytes[i * 3 + 1];
+            padded[i * 4 + 2] = bytes[i * 3 + 2];
+            padded[i * 4 + 3] = 255;
+        }
+
+        return padded;
+    }
+
+
+    static ComPtr<ID2D1Effect> CreateGrayToBgraEffect(ID2D1DeviceContext* deviceContext, ID2D1Bitmap1* gray)
+    {
+        // Gray8 data is uploaded as A8, so copy alpha into the color channels and make the result opaque.
+        D2D1_MATRIX_5X4_F matrix = D2D1::Matrix5x4F(
+            0, 0, 0, 0,
+            0, 0, 0, 0,
+            0, 0, 0, 0,
+            1, 1, 1, 0,
+            0, 0, 0, 1);
+
+        ComPtr<ID2D1Effect> effect;
+        ThrowIfFailed(deviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &effect));
+        ThrowIfFailed(effect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, matrix));
+
+        effect->SetInput(0, gray);
+
+        return effect;
+    }
+
+
+    static ComPtr<ID2D1Effect> CreateNv12ToBgraEffect(ID2D1DeviceContext* deviceContext, ID2D1Bitmap1* luma, ID2D1Bitmap1* chroma)
+    {
+        ComPtr<ID2D1Effect> effect;
+        ThrowIfFailed(deviceContext->CreateEffect(CLSID_D2D1YCbCr, &effect));
+        ThrowIfFailed(effect->SetValue(D2D1_YCBCR_PROP_CHROMA_SUBSAMPLING, D2D1_YCBCR_CHROMA_SUBSAMPLING_420));
+
+        effect->SetInput(0, luma);
+        effect->SetInput(1, chroma);
+
+        return effect;
+    }
+
+
+    ComPtr<CanvasBitmap> CanvasBitmap::CreateNew(
+        ICanvasDevice* device,
+        uint32_t byteCount,
+        BYTE* bytes,
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        CanvasBitmapSourceLayout layout,
+        float dpi)
+    {
+        if (widthInPixels < 0 || heightInPixels < 0)
+            ThrowHR(E_INVALIDARG);
+
+        auto pixelCount = static_cast<uint64_t>(widthInPixels) * static_cast<uint64_t>(heightInPixels);
+        uint64_t bytesNeeded;
+
+        switch (layout)
+        {
+        case CanvasBitmapSourceLayout::Rgba8:
+            bytesNeeded = pixelCount * 4;
+            break;
+
+        case CanvasBitmapSourceLayout::Bgr24:
+        case CanvasBitmapSourceLayout::Rgb24:
+            bytesNeeded = pixelCount * 3;
+            break;
+
+        case CanvasBitmapSourceLayout::Gray8:
+            bytesNeeded = pixelCount;
+            break;
+
+        case CanvasBitmapSourceLayout::Nv12:
+            if ((widthInPixels % 2) != 0 || (heightInPixels % 2) != 0)
+                ThrowHR(E_INVALIDARG, Strings::Nv12DimensionsMustBeEven);
+
+            // A full resolution Y plane, followed by a half resolution plane of interleaved U and V.
+            bytesNeeded = pixelCount + pixelCount / 2;
+            break;
+
+        default:
+            ThrowHR(E_INVALIDARG);
+        }
+
+        if (byteCount < bytesNeeded)
+            ThrowHR(E_INVALIDARG);
+
+        if (pixelCount == 0)
+        {
+            return CreateNew(device, 0, nullptr, widthInPixels, heightInPixels, dpi, PIXEL_FORMAT(B8G8R8A8UIntNormalized), CanvasAlphaMode::Premultiplied);
+        }
+
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+
+        //
+        // Upload the data in a format D2D can read directly. Sources are
+        // created at the default DPI so they map 1:1 onto the pixels of the
+        // destination when drawn through the resource creation context.
+        //
+        std::vector<uint8_t> padded;
+        ComPtr<ID2D1Bitmap1> source;
+        ComPtr<ID2D1Bitmap1> chroma;
+
+        switch (layout)
+        {
+        case CanvasBitmapSourceLayout::Rgba8:
+            source = deviceInternal->CreateBitmapFromBytes(bytes, widthInPixels * 4, widthInPixels, heightInPixels, DEFAULT_DPI, PIXEL_FORMAT(R8G8B8A8UIntNormalized), CanvasAlphaMode::Premultiplied);
+            break;
+
+        case CanvasBitmapSourceLayout::Bgr24:
+            // Once padded this is already in the native layout, so it needs no GPU pass.
+            padded = PadTo32Bits(bytes, widthInPixels, heightInPixels);
+            return CreateNew(device, static_cast<uint32_t>(padded.size()), padded.data(), widthInPixels, heightInPixels, dpi, PIXEL_FORMAT(B8G8R8A8UIntNormalized), CanvasAlphaMode::Premultiplied);
+
+        case CanvasBitmapSourceLayout::Rgb24:
+            padded = PadTo32Bits(bytes, widthInPixels, heightInPixels);
+            source = deviceInternal->CreateBitmapFromBytes(padded.data(), widthInPixels * 4, widthInPixels, heightInPixels, DEFAULT_DPI, PIXEL_FORMAT(R8G8B8A8UIntNormalized), CanvasAlphaMode::Ignore);
+            break;
+
+        case CanvasBitmapSourceLayout::Gray8:
+            source = deviceInternal->CreateBitmapFromBytes(bytes, widthInPixels, widthInPixels, heightInPixels, DEFAULT_DPI, PIXEL_FORMAT(A8UIntNormalized), CanvasAlphaMode::Premultiplied);
+            break;
+
+        case CanvasBitmapSourceLayout::Nv12:
+            source = deviceInternal->CreateBitmapFromBytes(bytes, widthInPixels, widthInPixels, heightInPixels, DEFAULT_DPI, PIXEL_FORMAT(R8UIntNormalized), CanvasAlphaMode::Ignore);
+            chroma = deviceInternal->CreateBitmapFromBytes(bytes + pixelCount, widthInPixels, widthInPixels / 2, heightInPixels / 2, DEFAULT_DPI, PIXEL_FORMAT(R8G8UIntNormalized), CanvasAlphaMode::Ignore);
+            break;
+        }
+
+        //
+        // Convert by drawing into a B8G8R8A8 bitmap. D2D swizzles RGBA to
+        // BGRA itself, while the other layouts go through an effect.
+        //
+        auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+        ComPtr<ID2D1Effect> effect;
+
+        if (layout == CanvasBitmapSourceLayout::Gray8)
+            effect = CreateGrayToBgraEffect(deviceContext.Get(), source.Get());
+        else if (layout == CanvasBitmapSourceLayout::Nv12)
+            effect = CreateNv12ToBgraEffect(deviceContext.Get(), source.Get(), chroma.Get());
+
+        D2D1_BITMAP_PROPERTIES1 targetProperties = D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_TARGET,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+            dpi,
+            dpi);
+
+        ComPtr<ID2D1Bitmap1> target;
+        HRESULT hr = deviceContext->CreateBitmap(D2D1::SizeU(widthInPixels, heightInPixels), nullptr, 0, &targetProperties, &target);
+        deviceInternal->ThrowIfCreateSurfaceFailed(hr, L"CanvasBitmap", widthInPixels, heightInPixels);
+
+        ComPtr<ID2D1Image> previousTarget;
+        deviceContext->GetTarget(&previousTarget);
+
+        auto restoreTarget = MakeScopeWarden([&] { deviceContext->SetTarget(previousTarget.Get()); });
+
+        deviceContext->SetTarget(target.Get());
+        deviceContext->BeginDraw();
+
+        if (effect)
+            deviceContext->DrawImage(effect.Get(), D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_COMPOSITE_MODE_SOURCE_COPY);
+        else
+            deviceContext->DrawImage(source.Get(), D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_COMPOSITE_MODE_SOURCE_COPY);
+
+        ThrowIfFailed(deviceContext->EndDraw());
+
+        auto bitmap = Make<CanvasBitmap>(
+            device,
+            target.Get());
+        CheckMakeResult(bitmap);
+
+        return bitmap;
+    }
+
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    //
+    // BitmapPixelFormat's values are intended to be reinterpreted as
+    // DXGI_FORMAT values.  Unfortunately, some of the chosen color values map
+    // to UINT rather than UNORM formats.  The intended use is UNORM, and so we
+    // fudge the BitmapPixelFormat values in these cases.
+    //
+    static DirectXPixelFormat GetFudgedFormat(BitmapPixelFormat format)
+    {
+        using namespace ABI::Windows::Graphics::Imaging;
+        
+        switch (format)
+        {
+        case BitmapPixelFormat_Rgba16: return PIXEL_FORMAT(R16G16B16A16UIntNormalized);
+        case BitmapPixelFormat_Rgba8:  return PIXEL_FORMAT(R8G8B8A8UIntNormalized);
+        case BitmapPixelFormat_Gray8:  return PIXEL_FORMAT(A8UIntNormalized);
+
+        case BitmapPixelFormat_Bgra8: // BitmapPixelFormat already uses the UNORM value here
+        default:
+            return static_cast<DirectXPixelFormat>(format);
+        }        
+    }
 
 
     ComPtr<CanvasBitmap> CanvasBitmap::CreateNew(
@@ -648,7 +1368,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     alpha = AlphaModeFromFormat(surfaceDescription.Format);
                 }
 
-                auto d2dBitmap = As<ICanvasDeviceInternal>(canvasDevice)->CreateBitmapFromSurface(surface, dpi, alpha);
+                auto deviceInternal = As<ICanvasDeviceInternal>(canvasDevice);
+                auto surfaceBitmapCache = deviceInternal->GetSurfaceBitmapCache();
+
+                ComPtr<ID2D1Bitmap1> d2dBitmap;
+
+                if (surfaceBitmapCache->IsEnabled())
+                {
+                    // Reusing the D2D bitmap also reuses its CanvasBitmap
+                    // wrapper, if the app is still holding on to that.
+                    d2dBitmap = surfaceBitmapCache->GetOrCreate(
+                        GetDXGIInterface<IDXGISurface2>(surface).Get(),
+                        dpi,
+                        ToD2DAlphaMode(alpha),
+                        [&] { return deviceInternal->CreateBitmapFromSurface(surface, dpi, alpha); });
+                }
+                else
+                {
+                    d2dBitmap = deviceInternal->CreateBitmapFromSurface(surface, dpi, alpha);
+                }
 
                 auto newBitmap = ResourceManager::GetOrCreate<ICanvasBitmap>(canvasDevice.Get(), d2dBitmap.Get());
 
@@ -812,6 +1550,60 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasBitmapFactory::CreateFromBytesWithLayout(
+        ICanvasResourceCreator* resourceCreator,
+        uint32_t byteCount,
+        BYTE* bytes,
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        CanvasBitmapSourceLayout layout,
+        ICanvasBitmap** canvasBitmap)
+    {
+        return CreateFromBytesWithLayoutAndDpi(
+            resourceCreator,
+            byteCount,
+            bytes,
+            widthInPixels,
+            heightInPixels,
+            layout,
+            DEFAULT_DPI,
+            canvasBitmap);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::CreateFromBytesWithLayoutAndDpi(
+        ICanvasResourceCreator* resourceCreator,
+        uint32_t byteCount,
+        BYTE* bytes,
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        CanvasBitmapSourceLayout layout,
+        float dpi,
+        ICanvasBitmap** canvasBitmap)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                if (byteCount)
+                    CheckInPointer(bytes);
+                CheckAndClearOutPointer(canvasBitmap);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                auto newBitmap = CanvasBitmap::CreateNew(
+                    canvasDevice.Get(),
+                    byteCount,
+                    bytes,
+                    widthInPixels,
+                    heightInPixels,
+                    layout,
+                    dpi);
+
+                ThrowIfFailed(newBitmap.CopyTo(canvasBitmap));
+            });
+    }
+
     IFACEMETHODIMP CanvasBitmapFactory::CreateFromColors(
         ICanvasResourceCreator* resourceCreator,
         uint32_t colorCount,
@@ -912,6 +1704,66 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
 #endif
 
+    IFACEMETHODIMP CanvasBitmapFactory::CreateCopyOnDevice(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasBitmap* sourceBitmap,
+        ICanvasBitmap** canvasBitmap)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(sourceBitmap);
+                CheckAndClearOutPointer(canvasBitmap);
+
+                ComPtr<ICanvasDevice> targetDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&targetDevice));
+
+                ComPtr<ICanvasDevice> sourceDevice;
+                ThrowIfFailed(As<ICanvasResourceCreator>(sourceBitmap)->get_Device(&sourceDevice));
+
+                auto d2dSourceBitmap = GetWrappedResource<ID2D1Bitmap1>(sourceBitmap);
+
+                auto size = d2dSourceBitmap->GetPixelSize();
+                auto pixelFormat = d2dSourceBitmap->GetPixelFormat();
+
+                float dpiX, dpiY;
+                d2dSourceBitmap->GetDpi(&dpiX, &dpiY);
+
+                auto format = static_cast<DirectXPixelFormat>(pixelFormat.format);
+                auto alphaMode = FromD2DAlphaMode(pixelFormat.alphaMode);
+
+                auto targetDeviceInternal = As<ICanvasDeviceInternal>(targetDevice);
+                ComPtr<ID2D1Bitmap1> d2dBitmap;
+
+                if (IsSameInstance(sourceDevice.Get(), targetDevice.Get()))
+                {
+                    d2dBitmap = targetDeviceInternal->CreateBitmapFromBytes(nullptr, 0, size.width, size.height, dpiX, format, alphaMode);
+
+                    ThrowIfFailed(d2dBitmap->CopyFromBitmap(nullptr, d2dSourceBitmap.Get(), nullptr));
+                }
+                else
+                {
+                    // Textures can't be shared between devices that may be on
+                    // different adapters, so go through the CPU.
+                    ScopedBitmapMappedPixelAccess pixels(sourceDevice.Get(), d2dSourceBitmap.Get());
+
+                    d2dBitmap = targetDeviceInternal->CreateBitmapFromBytes(
+                        pixels.GetLockedData(),
+                        pixels.GetStride(),
+                        size.width,
+                        size.height,
+                        dpiX,
+                        format,
+                        alphaMode);
+                }
+
+                auto newBitmap = ResourceManager::GetOrCreate<ICanvasBitmap>(targetDevice.Get(), d2dBitmap.Get());
+
+                ThrowIfFailed(newBitmap.CopyTo(canvasBitmap));
+            });
+    }
+
     IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromHstring(
         ICanvasResourceCreator* resourceCreator,
         HSTRING fileName,
@@ -940,10 +1792,67 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
     IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromHstringWithDpiAndAlpha(
+        ICanvasResourceCreator* resourceCreator,
+        HSTRING fileName,
+        float dpi,
+        CanvasAlphaMode alpha,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromHstringWithDpiAlphaAndMaximumSize(
+            resourceCreator,
+            fileName,
+            dpi,
+            alpha,
+            BitmapSize{},
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromHstringWithDpiAlphaAndMaximumSize(
+        ICanvasResourceCreator* resourceCreator,
+        HSTRING rawFileName,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromHstringWithDpiAlphaMaximumSizeAndFormat(
+            resourceCreator,
+            rawFileName,
+            dpi,
+            alpha,
+            maximumSize,
+            PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromHstringWithDpiAlphaMaximumSizeAndFormat(
+        ICanvasResourceCreator* resourceCreator,
+        HSTRING rawFileName,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromHstringWithDpiAlphaMaximumSizeFormatAndSourceRectangle(
+            resourceCreator,
+            rawFileName,
+            dpi,
+            alpha,
+            maximumSize,
+            format,
+            BitmapBounds{},
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromHstringWithDpiAlphaMaximumSizeFormatAndSourceRectangle(
         ICanvasResourceCreator* resourceCreator,
         HSTRING rawFileName,
         float dpi,
         CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        BitmapBounds sourceRectangle,
         ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
     {
         return ExceptionBoundary(
@@ -953,6 +1862,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 CheckInPointer(rawFileName);
                 CheckAndClearOutPointer(canvasBitmapAsyncOperation);
 
+                ValidateLoadFormat(format, alpha);
+
                 ComPtr<ICanvasDevice> canvasDevice;
                 ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
 
@@ -961,7 +1872,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 auto asyncOperation = Make<AsyncOperation<CanvasBitmap>>(
                     [=]
                     {
-                        return CanvasBitmap::CreateNew(canvasDevice.Get(), fileName, dpi, alpha);
+                        return CanvasBitmap::CreateNew(canvasDevice.Get(), fileName, dpi, alpha, maximumSize, format, sourceRectangle);
                     });
 
                 CheckMakeResult(asyncOperation);
@@ -1003,29 +1914,88 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         CanvasAlphaMode alpha,
         ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
     {
-        return ExceptionBoundary(
-            [&]
-            {
-                CheckInPointer(resourceCreator);
-                CheckInPointer(uri);
-                CheckAndClearOutPointer(canvasBitmapAsyncOperation);
-
-                ComPtr<ICanvasDevice> canvasDevice;
-                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
-
-                ComPtr<IRandomAccessStreamReferenceStatics> streamReferenceStatics;
-                ThrowIfFailed(GetActivationFactory(HStringReference(RuntimeClass_Windows_Storage_Streams_RandomAccessStreamReference).Get(), &streamReferenceStatics));
-
-                ComPtr<IRandomAccessStreamReference> streamReference;
-                ThrowIfFailed(streamReferenceStatics->CreateFromUri(uri, &streamReference));
+        return LoadAsyncFromUriWithDpiAlphaAndMaximumSize(
+            resourceCreator,
+            uri,
+            dpi,
+            alpha,
+            BitmapSize{},
+            canvasBitmapAsyncOperation);
+    }
 
-                // Start opening the file.
-                ComPtr<IAsyncOperation<IRandomAccessStreamWithContentType*>> openOperation;
-                ThrowIfFailed(streamReference->OpenReadAsync(&openOperation));
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromUriWithDpiAlphaAndMaximumSize(
+        ICanvasResourceCreator* resourceCreator,
+        ABI::Windows::Foundation::IUriRuntimeClass* uri,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromUriWithDpiAlphaMaximumSizeAndFormat(
+            resourceCreator,
+            uri,
+            dpi,
+            alpha,
+            maximumSize,
+            PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            canvasBitmapAsyncOperation);
+    }
 
-                // Our main async operation is constructed as a continuation of the file open,
-                // so the lambda will only start executing once the file is ready.
-                auto asyncOperation = Make<AsyncOperation<CanvasBitmap>>(openOperation, [=]
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromUriWithDpiAlphaMaximumSizeAndFormat(
+        ICanvasResourceCreator* resourceCreator,
+        ABI::Windows::Foundation::IUriRuntimeClass* uri,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromUriWithDpiAlphaMaximumSizeFormatAndSourceRectangle(
+            resourceCreator,
+            uri,
+            dpi,
+            alpha,
+            maximumSize,
+            format,
+            BitmapBounds{},
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromUriWithDpiAlphaMaximumSizeFormatAndSourceRectangle(
+        ICanvasResourceCreator* resourceCreator,
+        ABI::Windows::Foundation::IUriRuntimeClass* uri,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        BitmapBounds sourceRectangle,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(uri);
+                CheckAndClearOutPointer(canvasBitmapAsyncOperation);
+
+                ValidateLoadFormat(format, alpha);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                ComPtr<IRandomAccessStreamReferenceStatics> streamReferenceStatics;
+                ThrowIfFailed(GetActivationFactory(HStringReference(RuntimeClass_Windows_Storage_Streams_RandomAccessStreamReference).Get(), &streamReferenceStatics));
+
+                ComPtr<IRandomAccessStreamReference> streamReference;
+                ThrowIfFailed(streamReferenceStatics->CreateFromUri(uri, &streamReference));
+
+                // Start opening the file.
+                ComPtr<IAsyncOperation<IRandomAccessStreamWithContentType*>> openOperation;
+                ThrowIfFailed(streamReference->OpenReadAsync(&openOperation));
+
+                // Our main async operation is constructed as a continuation of the file open,
+                // so the lambda will only start executing once the file is ready.
+                auto asyncOperation = Make<AsyncOperation<CanvasBitmap>>(openOperation, [=]
                 {
                     ComPtr<IRandomAccessStreamWithContentType> randomAccessStream;
                     ThrowIfFailed(openOperation->GetResults(&randomAccessStream));
@@ -1033,7 +2003,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     ComPtr<IStream> stream;
                     ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
 
-                    return CanvasBitmap::CreateNew(canvasDevice.Get(), stream.Get(), dpi, alpha);
+                    return CanvasBitmap::CreateNew(canvasDevice.Get(), stream.Get(), dpi, alpha, maximumSize, format, sourceRectangle);
                 });
 
                 CheckMakeResult(asyncOperation);
@@ -1069,10 +2039,67 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
     IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromStreamWithDpiAndAlpha(
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* stream,
+        float dpi,
+        CanvasAlphaMode alpha,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromStreamWithDpiAlphaAndMaximumSize(
+            resourceCreator,
+            stream,
+            dpi,
+            alpha,
+            BitmapSize{},
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromStreamWithDpiAlphaAndMaximumSize(
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* rawStream,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromStreamWithDpiAlphaMaximumSizeAndFormat(
+            resourceCreator,
+            rawStream,
+            dpi,
+            alpha,
+            maximumSize,
+            PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromStreamWithDpiAlphaMaximumSizeAndFormat(
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* rawStream,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadAsyncFromStreamWithDpiAlphaMaximumSizeFormatAndSourceRectangle(
+            resourceCreator,
+            rawStream,
+            dpi,
+            alpha,
+            maximumSize,
+            format,
+            BitmapBounds{},
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadAsyncFromStreamWithDpiAlphaMaximumSizeFormatAndSourceRectangle(
         ICanvasResourceCreator* resourceCreator,
         IRandomAccessStream* rawStream,
         float dpi,
         CanvasAlphaMode alpha,
+        BitmapSize maximumSize,
+        DirectXPixelFormat format,
+        BitmapBounds sourceRectangle,
         ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
     {
         return ExceptionBoundary(
@@ -1082,6 +2109,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 CheckInPointer(rawStream);
                 CheckAndClearOutPointer(canvasBitmapAsyncOperation);
 
+                ValidateLoadFormat(format, alpha);
+
                 ComPtr<ICanvasDevice> canvasDevice;
                 ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
 
@@ -1093,118 +2122,961 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     ComPtr<IStream> nativeStream;
                     ThrowIfFailed(CreateStreamOverRandomAccessStream(stream.Get(), IID_PPV_ARGS(&nativeStream)));
 
-                    return CanvasBitmap::CreateNew(canvasDevice.Get(), nativeStream.Get(), dpi, alpha);
-                });
+                    return CanvasBitmap::CreateNew(canvasDevice.Get(), nativeStream.Get(), dpi, alpha, maximumSize, format, sourceRectangle);
+                });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(canvasBitmapAsyncOperation));
+            });
+    }
+
+
+    // Big enough to look reasonable in a gallery's grid of images, and small
+    // enough to decode quickly.
+    static const BitmapSize DefaultPreviewSize{ 256, 256 };
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadProgressiveAsyncFromHstring(
+        ICanvasResourceCreator* resourceCreator,
+        HSTRING rawFileName,
+        ICanvasBitmapPreviewHandler* previewHandler,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadProgressiveAsyncFromHstringWithDpiAlphaAndPreviewSize(
+            resourceCreator,
+            rawFileName,
+            DEFAULT_DPI,
+            CanvasAlphaMode::Premultiplied,
+            DefaultPreviewSize,
+            previewHandler,
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadProgressiveAsyncFromHstringWithDpiAlphaAndPreviewSize(
+        ICanvasResourceCreator* resourceCreator,
+        HSTRING rawFileName,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize previewSize,
+        ICanvasBitmapPreviewHandler* previewHandler,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(rawFileName);
+                CheckAndClearOutPointer(canvasBitmapAsyncOperation);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                ComPtr<ICanvasBitmapPreviewHandler> handler = previewHandler;
+
+                WinString fileName(rawFileName);
+
+                auto asyncOperation = Make<AsyncOperation<CanvasBitmap>>(
+                    [=]
+                    {
+                        return LoadProgressive(canvasDevice.Get(), static_cast<HSTRING>(fileName), dpi, alpha, previewSize, handler);
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(canvasBitmapAsyncOperation));
+            });
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadProgressiveAsyncFromUri(
+        ICanvasResourceCreator* resourceCreator,
+        ABI::Windows::Foundation::IUriRuntimeClass* uri,
+        ICanvasBitmapPreviewHandler* previewHandler,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadProgressiveAsyncFromUriWithDpiAlphaAndPreviewSize(
+            resourceCreator,
+            uri,
+            DEFAULT_DPI,
+            CanvasAlphaMode::Premultiplied,
+            DefaultPreviewSize,
+            previewHandler,
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadProgressiveAsyncFromUriWithDpiAlphaAndPreviewSize(
+        ICanvasResourceCreator* resourceCreator,
+        ABI::Windows::Foundation::IUriRuntimeClass* uri,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize previewSize,
+        ICanvasBitmapPreviewHandler* previewHandler,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(uri);
+                CheckAndClearOutPointer(canvasBitmapAsyncOperation);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                ComPtr<ICanvasBitmapPreviewHandler> handler = previewHandler;
+
+                ComPtr<IRandomAccessStreamReferenceStatics> streamReferenceStatics;
+                ThrowIfFailed(GetActivationFactory(HStringReference(RuntimeClass_Windows_Storage_Streams_RandomAccessStreamReference).Get(), &streamReferenceStatics));
+
+                ComPtr<IRandomAccessStreamReference> streamReference;
+                ThrowIfFailed(streamReferenceStatics->CreateFromUri(uri, &streamReference));
+
+                ComPtr<IAsyncOperation<IRandomAccessStreamWithContentType*>> openOperation;
+                ThrowIfFailed(streamReference->OpenReadAsync(&openOperation));
+
+                auto asyncOperation = Make<AsyncOperation<CanvasBitmap>>(openOperation, [=]
+                {
+                    ComPtr<IRandomAccessStreamWithContentType> randomAccessStream;
+                    ThrowIfFailed(openOperation->GetResults(&randomAccessStream));
+
+                    ComPtr<IStream> stream;
+                    ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
+
+                    return LoadProgressive(canvasDevice.Get(), stream.Get(), dpi, alpha, previewSize, handler);
+                });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(canvasBitmapAsyncOperation));
+            });
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadProgressiveAsyncFromStream(
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* rawStream,
+        ICanvasBitmapPreviewHandler* previewHandler,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return LoadProgressiveAsyncFromStreamWithDpiAlphaAndPreviewSize(
+            resourceCreator,
+            rawStream,
+            DEFAULT_DPI,
+            CanvasAlphaMode::Premultiplied,
+            DefaultPreviewSize,
+            previewHandler,
+            canvasBitmapAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadProgressiveAsyncFromStreamWithDpiAlphaAndPreviewSize(
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* rawStream,
+        float dpi,
+        CanvasAlphaMode alpha,
+        BitmapSize previewSize,
+        ICanvasBitmapPreviewHandler* previewHandler,
+        ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(rawStream);
+                CheckAndClearOutPointer(canvasBitmapAsyncOperation);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                ComPtr<ICanvasBitmapPreviewHandler> handler = previewHandler;
+
+                ComPtr<IRandomAccessStream> stream = rawStream;
+
+                auto asyncOperation = Make<AsyncOperation<CanvasBitmap>>(
+                    [=]
+                    {
+                        ComPtr<IStream> nativeStream;
+                        ThrowIfFailed(CreateStreamOverRandomAccessStream(stream.Get(), IID_PPV_ARGS(&nativeStream)));
+
+                        return LoadProgressive(canvasDevice.Get(), nativeStream.Get(), dpi, alpha, previewSize, handler);
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(canvasBitmapAsyncOperation));
+            });
+    }
+
+
+    //
+    // LoadManyAsync decodes its sources on a number of threadpool workers,
+    // while the async operation's own thread turns the decoded images into
+    // GPU bitmaps a batch at a time, and reports each one to the app as soon
+    // as it is ready.
+    //
+
+    static ComPtr<IWICBitmapSource> DecodeBatchSource(ComPtr<IWICBitmapSource> const& source)
+    {
+        // DDS frames are copied straight into a block compressed bitmap, so
+        // there is nothing to decode ahead of time.
+        if (MaybeAs<IWICDdsFrameDecode>(source))
+            return source;
+
+        // Decode into system memory now, so creating the GPU bitmap later is
+        // just an upload, and doesn't hold the Direct2D lock while decoding.
+
+        ComPtr<IWICBitmap> decodedBitmap;
+        ThrowIfFailed(WicAdapter::GetInstance()->GetFactory()->CreateBitmapFromSource(source.Get(), WICBitmapCacheOnLoad, &decodedBitmap));
+
+        return decodedBitmap;
+    }
+
+    static ComPtr<IWICBitmapSource> DecodeBatchItem(ICanvasDevice* device, WinString const& fileName)
+    {
+        CheckInPointer(static_cast<HSTRING>(fileName));
+
+        return TraceBitmapLoad([&] { return DecodeBatchSource(CreateWicBitmapSourceWithExifTransform(device, static_cast<HSTRING>(fileName))); });
+    }
+
+    static ComPtr<IWICBitmapSource> DecodeBatchItem(ICanvasDevice* device, ComPtr<IRandomAccessStream> const& stream)
+    {
+        CheckInPointer(stream.Get());
+
+        ComPtr<IStream> nativeStream;
+        ThrowIfFailed(CreateStreamOverRandomAccessStream(stream.Get(), IID_PPV_ARGS(&nativeStream)));
+
+        return TraceBitmapLoad([&] { return DecodeBatchSource(CreateWicBitmapSourceWithExifTransform(device, nativeStream.Get())); });
+    }
+
+    template<typename TSource, typename T>
+    static std::vector<TSource> GetBatchSources(IIterable<T>* items)
+    {
+        std::vector<TSource> sources;
+
+        ComPtr<IIterator<T>> iterator;
+        ThrowIfFailed(items->First(&iterator));
+
+        boolean hasCurrent;
+        ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+        while (hasCurrent)
+        {
+            TSource source;
+            ThrowIfFailed(iterator->get_Current(source.GetAddressOf()));
+
+            sources.push_back(std::move(source));
+
+            ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+        }
+
+        if (sources.size() > INT32_MAX)
+            ThrowHR(E_INVALIDARG);
+
+        return sources;
+    }
+
+    template<typename TSource>
+    class CanvasBitmapBatchLoader : public std::enable_shared_from_this<CanvasBitmapBatchLoader<TSource>>
+    {
+        struct DecodedItem
+        {
+            uint32_t Index;
+            ComPtr<IWICBitmapSource> Source;
+            HRESULT Result;
+        };
+
+        ComPtr<ICanvasDevice> m_device;
+        std::vector<TSource> m_sources;
+        float m_dpi;
+        CanvasAlphaMode m_alpha;
+
+        std::mutex m_mutex;
+        std::condition_variable m_itemDecoded;
+        std::vector<DecodedItem> m_decodedItems;
+
+    public:
+        // Limits how long the Direct2D lock is held for in one go, so other
+        // threads (such as the one drawing the UI) get a look in.
+        static const size_t MaxUploadBatchSize = 8;
+
+        CanvasBitmapBatchLoader(ICanvasDevice* device, std::vector<TSource>&& sources, float dpi, CanvasAlphaMode alpha)
+            : m_device(device)
+            , m_sources(std::move(sources))
+            , m_dpi(dpi)
+            , m_alpha(alpha)
+        {
+        }
+
+        // Runs on the async operation's worker thread, and returns once every
+        // source has been loaded (or failed to load).
+        ComPtr<IVectorView<CanvasBitmap*>> Run(uint32_t maximumParallelism, ComPtr<ICanvasBitmapLoadedHandler> const& loadedHandler)
+        {
+            auto itemCount = static_cast<uint32_t>(m_sources.size());
+
+            // The decode workers keep this loader alive, as they may still be
+            // finishing off an item after we bail out early.
+            auto self = this->shared_from_this();
+
+            auto decoders = std::make_shared<ParallelWorkers>(itemCount, [self](uint32_t index) { self->Decode(index); });
+
+            // Stop any decode workers that are still going if we bail out early.
+            auto abandonWarden = MakeScopeWarden([&] { decoders->Abandon(); });
+
+            // This thread is busy uploading, so does none of the decoding itself.
+            decoders->Start(maximumParallelism);
+
+            std::vector<ComPtr<CanvasBitmap>> bitmaps(itemCount);
+            uint32_t completedCount = 0;
+
+            while (completedCount < itemCount)
+            {
+                auto batch = TakeDecodedItems();
+
+                // Throwing abandons the decode workers too.
+                AsyncCancellation::ThrowIfCanceled();
+
+                Upload(batch, bitmaps);
+
+                for (auto& item : batch)
+                {
+                    if (loadedHandler)
+                        ThrowIfFailed(loadedHandler->Invoke(static_cast<int32_t>(item.Index), bitmaps[item.Index].Get(), item.Result));
+                    else if (FAILED(item.Result))
+                        ThrowHR(item.Result);
+                }
+
+                completedCount += static_cast<uint32_t>(batch.size());
+            }
+
+            auto vector = MakePooled<Vector<CanvasBitmap*>>();
+            CheckMakeResult(vector);
+
+            for (auto& bitmap : bitmaps)
+            {
+                ThrowIfFailed(vector->Append(bitmap.Get()));
+            }
+
+            ComPtr<IVectorView<CanvasBitmap*>> view;
+            ThrowIfFailed(vector->GetView(&view));
+
+            return view;
+        }
+
+    private:
+        // Decode failures travel with the item rather than being thrown, so
+        // Run can report them against the right index.
+        void Decode(uint32_t index)
+        {
+            DecodedItem item{ index };
+
+            item.Result = ExceptionBoundary(
+                [&]
+                {
+                    item.Source = DecodeBatchItem(m_device.Get(), m_sources[index]);
+                });
+
+            {
+                Lock lock(m_mutex);
+                m_decodedItems.push_back(std::move(item));
+            }
+
+            m_itemDecoded.notify_one();
+        }
+
+        std::vector<DecodedItem> TakeDecodedItems()
+        {
+            Lock lock(m_mutex);
+
+            m_itemDecoded.wait(lock, [&] { return !m_decodedItems.empty(); });
+
+            auto batchEnd = m_decodedItems.begin() + std::min(m_decodedItems.size(), MaxUploadBatchSize);
+
+            std::vector<DecodedItem> batch(
+                std::make_move_iterator(m_decodedItems.begin()),
+                std::make_move_iterator(batchEnd));
+
+            m_decodedItems.erase(m_decodedItems.begin(), batchEnd);
+
+            return batch;
+        }
+
+        void Upload(std::vector<DecodedItem>& batch, std::vector<ComPtr<CanvasBitmap>>& bitmaps)
+        {
+            auto deviceInternal = As<ICanvasDeviceInternal>(m_device);
+
+            std::vector<ComPtr<ID2D1Bitmap1>> d2dBitmaps(batch.size());
+
+            // Create the whole batch while holding the Direct2D lock just the
+            // once, rather than taking it again for every bitmap.
+            {
+                D2DResourceLock lock(deviceInternal->GetD2DDevice().Get());
+
+                for (size_t i = 0; i < batch.size(); i++)
+                {
+                    auto& item = batch[i];
+
+                    if (FAILED(item.Result))
+                        continue;
+
+                    item.Result = ExceptionBoundary(
+                        [&]
+                        {
+                            d2dBitmaps[i] = deviceInternal->CreateBitmapFromWicResource(item.Source.Get(), m_dpi, m_alpha);
+                        });
+
+                    item.Source.Reset();
+                }
+            }
+
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                auto& item = batch[i];
+
+                if (FAILED(item.Result))
+                    continue;
+
+                item.Result = ExceptionBoundary(
+                    [&]
+                    {
+                        auto bitmap = Make<CanvasBitmap>(m_device.Get(), d2dBitmaps[i].Get());
+                        CheckMakeResult(bitmap);
+
+                        bitmaps[item.Index] = bitmap;
+                    });
+            }
+        }
+    };
+
+    ComPtr<IVectorView<CanvasBitmap*>> LoadBitmapFilesInParallel(
+        ICanvasDevice* device,
+        std::vector<WinString>&& fileNames,
+        float dpi,
+        CanvasAlphaMode alpha)
+    {
+        auto loader = std::make_shared<CanvasBitmapBatchLoader<WinString>>(
+            device,
+            std::move(fileNames),
+            dpi,
+            alpha);
+
+        return loader->Run(AsyncScheduler::GetInstance().LimitParallelism(std::max(std::thread::hardware_concurrency(), 1U)), nullptr);
+    }
+
+    template<typename TSource, typename T>
+    static HRESULT LoadManyAsyncImpl(
+        ICanvasResourceCreator* resourceCreator,
+        IIterable<T>* items,
+        float dpi,
+        CanvasAlphaMode alpha,
+        int32_t maximumParallelism,
+        ICanvasBitmapLoadedHandler* loadedHandler,
+        IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(items);
+                CheckAndClearOutPointer(canvasBitmapsAsyncOperation);
+
+                if (maximumParallelism < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                uint32_t parallelism = maximumParallelism ? static_cast<uint32_t>(maximumParallelism)
+                                                          : std::max(std::thread::hardware_concurrency(), 1U);
+
+                parallelism = AsyncScheduler::GetInstance().LimitParallelism(parallelism);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                auto loader = std::make_shared<CanvasBitmapBatchLoader<TSource>>(
+                    canvasDevice.Get(),
+                    GetBatchSources<TSource>(items),
+                    dpi,
+                    alpha);
+
+                ComPtr<ICanvasBitmapLoadedHandler> handler = loadedHandler;
+
+                auto asyncOperation = Make<AsyncOperation<IVectorView<CanvasBitmap*>>>(
+                    [=]
+                    {
+                        return loader->Run(parallelism, handler);
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(canvasBitmapsAsyncOperation));
+            });
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadManyAsyncFromHstrings(
+        ICanvasResourceCreator* resourceCreator,
+        IIterable<HSTRING>* fileNames,
+        IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation)
+    {
+        return LoadManyAsyncFromHstringsWithOptions(
+            resourceCreator,
+            fileNames,
+            DEFAULT_DPI,
+            CanvasAlphaMode::Premultiplied,
+            0,
+            nullptr,
+            canvasBitmapsAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadManyAsyncFromHstringsWithOptions(
+        ICanvasResourceCreator* resourceCreator,
+        IIterable<HSTRING>* fileNames,
+        float dpi,
+        CanvasAlphaMode alpha,
+        int32_t maximumParallelism,
+        ICanvasBitmapLoadedHandler* loadedHandler,
+        IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation)
+    {
+        return LoadManyAsyncImpl<WinString>(
+            resourceCreator,
+            fileNames,
+            dpi,
+            alpha,
+            maximumParallelism,
+            loadedHandler,
+            canvasBitmapsAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadManyAsyncFromStreams(
+        ICanvasResourceCreator* resourceCreator,
+        IIterable<IRandomAccessStream*>* streams,
+        IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation)
+    {
+        return LoadManyAsyncFromStreamsWithOptions(
+            resourceCreator,
+            streams,
+            DEFAULT_DPI,
+            CanvasAlphaMode::Premultiplied,
+            0,
+            nullptr,
+            canvasBitmapsAsyncOperation);
+    }
+
+    IFACEMETHODIMP CanvasBitmapFactory::LoadManyAsyncFromStreamsWithOptions(
+        ICanvasResourceCreator* resourceCreator,
+        IIterable<IRandomAccessStream*>* streams,
+        float dpi,
+        CanvasAlphaMode alpha,
+        int32_t maximumParallelism,
+        ICanvasBitmapLoadedHandler* loadedHandler,
+        IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation)
+    {
+        return LoadManyAsyncImpl<ComPtr<IRandomAccessStream>>(
+            resourceCreator,
+            streams,
+            dpi,
+            alpha,
+            maximumParallelism,
+            loadedHandler,
+            canvasBitmapsAsyncOperation);
+    }
+
+
+    //
+    // CanvasBitmap
+    //
+
+    CanvasBitmap::CanvasBitmap(
+        ICanvasDevice* device,
+        ID2D1Bitmap1* d2dBitmap)
+        : CanvasBitmapImpl(device, d2dBitmap)
+    {
+        assert(!IsRenderTargetBitmap(d2dBitmap) 
+            && "CanvasBitmap should never be constructed with a render-target bitmap.  This should have been validated before construction.");
+    }
+
+    static void CopyPixelBytes(
+        BitmapSubRectangle const& r,
+        uint32_t sourceStride,
+        uint32_t destinationStride,
+        stdext::checked_array_iterator<uint8_t*> const& source,
+        stdext::checked_array_iterator<uint8_t*> const& destination)
+    {
+#ifdef NDEBUG
+        // Skip the iterator validation in release builds.
+        auto s = source.base();
+        auto d = destination.base();
+#else
+        auto s = source;
+        auto d = destination;
+#endif
+
+        for (auto i = 0u; i < r.GetBlocksHigh(); ++i)
+        {
+            std::copy(s, s + r.GetBytesPerRow(), d);
+
+            s += sourceStride;
+            d += destinationStride;
+        }
+    }
+
+    // Works out how pixels copied between a bitmap and the CPU need converting
+    // so that the CPU side is in callerAlphaMode. Only formats with 8 bit
+    // channels and alpha in the last byte can be converted.
+    static AlphaConversion GetPixelCopyAlphaConversion(
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        CanvasAlphaMode const* optionalCallerAlphaMode,
+        bool isUpload)
+    {
+        if (!optionalCallerAlphaMode)
+            return AlphaConversion::None;
+
+        auto callerAlphaMode = *optionalCallerAlphaMode;
+
+        if (ToD2DAlphaMode(callerAlphaMode) == D2D1_ALPHA_MODE_FORCE_DWORD)
+            ThrowHR(E_INVALIDARG);
+
+        auto pixelFormat = d2dBitmap->GetPixelFormat();
+        auto bitmapAlphaMode = FromD2DAlphaMode(pixelFormat.alphaMode);
+
+        auto conversion = isUpload ? GetAlphaConversion(callerAlphaMode, bitmapAlphaMode)
+                                   : GetAlphaConversion(bitmapAlphaMode, callerAlphaMode);
+
+        if (conversion != AlphaConversion::None)
+        {
+            switch (pixelFormat.format)
+            {
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+                break;
+
+            default:
+                ThrowHR(E_INVALIDARG, Strings::PixelAlphaConversionFormatRestriction);
+            }
+        }
+
+        return conversion;
+    }
+
+    void GetPixelBytesImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        uint32_t* valueCount,
+        uint8_t** valueElements)
+    {
+        CheckInPointer(valueCount);
+        CheckAndClearOutPointer(valueElements);
+
+        BitmapSubRectangle r(d2dBitmap, subRectangle);
+
+        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &subRectangle);
+
+        ComArray<BYTE> array(r.GetTotalBytes());
+
+        CopyPixelBytes(
+            r, 
+            bitmapPixelAccess.GetStride(), 
+            r.GetBytesPerRow(),
+            begin(bitmapPixelAccess),
+            begin(array));
+
+        array.Detach(valueCount, valueElements);
+    }
+
+    void GetPixelBytesImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        IBuffer* buffer,
+        CanvasAlphaMode const* optionalAlphaMode)
+    {
+        using ::Windows::Storage::Streams::IBufferByteAccess;
+
+        CheckInPointer(buffer);
+
+        auto byteAccess = As<IBufferByteAccess>(buffer);
+
+        BitmapSubRectangle r(d2dBitmap, subRectangle);
+
+        auto alphaConversion = GetPixelCopyAlphaConversion(d2dBitmap, optionalAlphaMode, false);
+
+        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &subRectangle);
+
+        uint32_t capacity;
+        ThrowIfFailed(buffer->get_Capacity(&capacity));
+
+        if (capacity < r.GetTotalBytes())
+        {
+            WinStringBuilder message;
+            message.Format(Strings::WrongArrayLength, r.GetTotalBytes(), capacity);
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        ThrowIfFailed(buffer->put_Length(r.GetTotalBytes()));
+
+        uint8_t* destination;
+        ThrowIfFailed(byteAccess->Buffer(&destination));
+
+        if (alphaConversion == AlphaConversion::None)
+        {
+            CopyPixelBytes(
+                r,
+                bitmapPixelAccess.GetStride(),
+                r.GetBytesPerRow(),
+                begin(bitmapPixelAccess),
+                stdext::make_checked_array_iterator(destination, capacity));
+        }
+        else
+        {
+            // Convert each row straight out of the mapped bitmap, rather than copying it first.
+            uint8_t const* source = bitmapPixelAccess.GetLockedData();
+
+            for (auto i = 0u; i < r.GetBlocksHigh(); ++i)
+            {
+                ConvertPixelAlpha(alphaConversion, source, destination, r.GetBytesPerRow() / 4);
+
+                source += bitmapPixelAccess.GetStride();
+                destination += r.GetBytesPerRow();
+            }
+        }
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    static ComPtr<CanvasMappedPixels> MakeMappedPixels(
+        std::unique_ptr<ScopedBitmapMappedPixelAccess>&& bitmapPixelAccess,
+        BitmapSubRectangle const& r,
+        D2D1_RECT_U const& subRectangle)
+    {
+        //
+        // The last row is only guaranteed to be as long as the pixel data,
+        // not the full stride, so that is as far as the buffer reaches.
+        //
+        auto capacity = bitmapPixelAccess->GetStride() * (r.GetBlocksHigh() - 1) + r.GetBytesPerRow();
+
+        BitmapSize sizeInPixels{ subRectangle.right - subRectangle.left, subRectangle.bottom - subRectangle.top };
+
+        auto pixels = Make<CanvasMappedPixels>(
+            std::move(bitmapPixelAccess),
+            sizeInPixels,
+            static_cast<DirectXPixelFormat>(r.GetFormat()),
+            capacity);
+        CheckMakeResult(pixels);
+
+        return pixels;
+    }
+
+    void MapPixelsImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        ICanvasMappedPixels** mappedPixels)
+    {
+        CheckAndClearOutPointer(mappedPixels);
+
+        BitmapSubRectangle r(d2dBitmap, subRectangle);
+
+        auto bitmapPixelAccess = std::make_unique<ScopedBitmapMappedPixelAccess>(device.Get(), d2dBitmap.Get(), &subRectangle);
+
+        auto pixels = MakeMappedPixels(std::move(bitmapPixelAccess), r, subRectangle);
+
+        ThrowIfFailed(pixels.CopyTo(mappedPixels));
+    }
+
+    void MapPixelsAsyncImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        IAsyncOperation<CanvasMappedPixels*>** asyncOperation)
+    {
+        CheckAndClearOutPointer(asyncOperation);
+
+        BitmapSubRectangle r(d2dBitmap, subRectangle);
+
+        //
+        // The copy is queued up here, on the calling thread, so it sees the
+        // bitmap as it is now, rather than after whatever the app draws next.
+        // Only waiting for the GPU to get through it happens on the
+        // threadpool, which lets the app carry on rendering in the meantime.
+        //
+        ComPtr<CanvasGpuFence> copyFence;
+        auto stagingBitmap = ScopedBitmapMappedPixelAccess::BeginCopy(device.Get(), d2dBitmap.Get(), &subRectangle, &copyFence);
+
+        auto operation = Make<AsyncOperation<CanvasMappedPixels>>(
+            [=]
+            {
+                ScopedBitmapMappedPixelAccess::WaitForCopy(copyFence.Get());
+
+                auto bitmapPixelAccess = std::make_unique<ScopedBitmapMappedPixelAccess>(device.Get(), stagingBitmap);
+
+                return MakeMappedPixels(std::move(bitmapPixelAccess), r, subRectangle);
+            });
+
+        CheckMakeResult(operation);
+        ThrowIfFailed(operation.CopyTo(asyncOperation));
+    }
+
+    using ABI::Windows::Graphics::Imaging::BitmapBufferAccessMode;
+    using ABI::Windows::Graphics::Imaging::BitmapBufferAccessMode_Read;
+    using ABI::Windows::Graphics::Imaging::BitmapBufferAccessMode_Write;
+    using ABI::Windows::Graphics::Imaging::BitmapPlaneDescription;
+    using ABI::Windows::Graphics::Imaging::IBitmapBuffer;
+
+    //
+    // Locks the pixels of a SoftwareBitmap so they can be copied straight
+    // to or from a CanvasBitmap.  The bitmaps must match in size and format,
+    // since converting would need the intermediate buffer this avoids.
+    //
+    class LockedSoftwareBitmapPixels
+    {
+        ComPtr<IBitmapBuffer> m_bitmapBuffer;
+        ComPtr<IMemoryBufferReference> m_memoryBuffer;
+        uint8_t* m_data;
+        uint32_t m_stride;
+
+    public:
+        LockedSoftwareBitmapPixels(
+            ISoftwareBitmap* softwareBitmap,
+            ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+            BitmapBufferAccessMode accessMode)
+        {
+            using ::Windows::Foundation::IMemoryBufferByteAccess;
+
+            BitmapPixelFormat bitmapPixelFormat;
+            ThrowIfFailed(softwareBitmap->get_BitmapPixelFormat(&bitmapPixelFormat));
+
+            if (static_cast<DXGI_FORMAT>(GetFudgedFormat(bitmapPixelFormat)) != d2dBitmap->GetPixelFormat().format)
+                ThrowHR(E_INVALIDARG, Strings::BitmapFormatsDiffer);
 
-                CheckMakeResult(asyncOperation);
-                ThrowIfFailed(asyncOperation.CopyTo(canvasBitmapAsyncOperation));
-            });
-    }
+            ThrowIfFailed(softwareBitmap->LockBuffer(accessMode, &m_bitmapBuffer));
+            ThrowIfFailed(As<IMemoryBuffer>(m_bitmapBuffer)->CreateReference(&m_memoryBuffer));
 
+            uint32_t bufferSize;
+            uint8_t* buffer;
+            ThrowIfFailed(As<IMemoryBufferByteAccess>(m_memoryBuffer)->GetBuffer(&buffer, &bufferSize));
 
-    //
-    // CanvasBitmap
-    //
+            BitmapPlaneDescription bitmapPlaneDescription;
+            ThrowIfFailed(m_bitmapBuffer->GetPlaneDescription(0, &bitmapPlaneDescription));
 
-    CanvasBitmap::CanvasBitmap(
-        ICanvasDevice* device,
-        ID2D1Bitmap1* d2dBitmap)
-        : CanvasBitmapImpl(device, d2dBitmap)
+            auto size = d2dBitmap->GetPixelSize();
+
+            if (static_cast<uint32_t>(bitmapPlaneDescription.Width) != size.width ||
+                static_cast<uint32_t>(bitmapPlaneDescription.Height) != size.height)
+            {
+                ThrowHR(E_INVALIDARG, Strings::BitmapSizesDiffer);
+            }
+
+            m_data = buffer + bitmapPlaneDescription.StartIndex;
+            m_stride = static_cast<uint32_t>(bitmapPlaneDescription.Stride);
+        }
+
+        uint8_t* GetData() const { return m_data; }
+        uint32_t GetStride() const { return m_stride; }
+    };
+
+    static D2D1_RECT_U GetBitmapExtents(ComPtr<ID2D1Bitmap1> const& d2dBitmap)
     {
-        assert(!IsRenderTargetBitmap(d2dBitmap) 
-            && "CanvasBitmap should never be constructed with a render-target bitmap.  This should have been validated before construction.");
+        auto size = d2dBitmap->GetPixelSize();
+        return D2D1::RectU(0, 0, size.width, size.height);
     }
 
-    static void CopyPixelBytes(
-        BitmapSubRectangle const& r,
-        uint32_t sourceStride,
-        uint32_t destinationStride,
-        stdext::checked_array_iterator<uint8_t*> const& source,
-        stdext::checked_array_iterator<uint8_t*> const& destination)
+    static void CopyMappedPixelsToSoftwareBitmap(
+        ScopedBitmapMappedPixelAccess const& bitmapPixelAccess,
+        LockedSoftwareBitmapPixels const& destination,
+        BitmapSubRectangle const& r)
     {
-#ifdef NDEBUG
-        // Skip the iterator validation in release builds.
-        auto s = source.base();
-        auto d = destination.base();
-#else
-        auto s = source;
-        auto d = destination;
-#endif
+        auto source = bitmapPixelAccess.GetLockedData();
+        auto dest = destination.GetData();
 
-        for (auto i = 0u; i < r.GetBlocksHigh(); ++i)
+        if (bitmapPixelAccess.GetStride() == destination.GetStride())
         {
-            std::copy(s, s + r.GetBytesPerRow(), d);
+            // The last row is only as long as the pixel data.
+            memcpy(dest, source, destination.GetStride() * (r.GetBlocksHigh() - 1) + r.GetBytesPerRow());
+        }
+        else
+        {
+            for (unsigned y = 0; y < r.GetBlocksHigh(); y++)
+            {
+                memcpy(dest, source, r.GetBytesPerRow());
 
-            s += sourceStride;
-            d += destinationStride;
+                source += bitmapPixelAccess.GetStride();
+                dest += destination.GetStride();
+            }
         }
     }
 
-    void GetPixelBytesImpl(
-        ComPtr<ICanvasDevice> const& device,
+    void CopyPixelsFromSoftwareBitmapImpl(
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
-        D2D1_RECT_U const& subRectangle,
-        uint32_t* valueCount,
-        uint8_t** valueElements)
+        ISoftwareBitmap* sourceBitmap)
     {
-        CheckInPointer(valueCount);
-        CheckAndClearOutPointer(valueElements);
-
-        BitmapSubRectangle r(d2dBitmap, subRectangle);
-
-        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &subRectangle);
+        CheckInPointer(sourceBitmap);
 
-        ComArray<BYTE> array(r.GetTotalBytes());
+        LockedSoftwareBitmapPixels source(sourceBitmap, d2dBitmap, BitmapBufferAccessMode_Read);
 
-        CopyPixelBytes(
-            r, 
-            bitmapPixelAccess.GetStride(), 
-            r.GetBytesPerRow(),
-            begin(bitmapPixelAccess),
-            begin(array));
+        ThrowIfFailed(d2dBitmap->CopyFromMemory(nullptr, source.GetData(), source.GetStride()));
 
-        array.Detach(valueCount, valueElements);
+        BitmapSubRectangle r(d2dBitmap, GetBitmapExtents(d2dBitmap));
+        PerformanceCounters::Increment(PerformanceCounter::BitmapBytesUploaded, r.GetTotalBytes());
     }
 
-    void GetPixelBytesImpl(
+    void CopyPixelsToSoftwareBitmapImpl(
         ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
-        D2D1_RECT_U const& subRectangle,
-        IBuffer* buffer)
+        ISoftwareBitmap* destinationBitmap)
     {
-        using ::Windows::Storage::Streams::IBufferByteAccess;
+        CheckInPointer(destinationBitmap);
 
-        CheckInPointer(buffer);
+        LockedSoftwareBitmapPixels destination(destinationBitmap, d2dBitmap, BitmapBufferAccessMode_Write);
 
-        auto byteAccess = As<IBufferByteAccess>(buffer);
+        auto extents = GetBitmapExtents(d2dBitmap);
+        BitmapSubRectangle r(d2dBitmap, extents);
 
-        BitmapSubRectangle r(d2dBitmap, subRectangle);
+        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &extents);
 
-        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &subRectangle);
+        CopyMappedPixelsToSoftwareBitmap(bitmapPixelAccess, destination, r);
+    }
 
-        uint32_t capacity;
-        ThrowIfFailed(buffer->get_Capacity(&capacity));
+    void CopyPixelsToSoftwareBitmapAsyncImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        ISoftwareBitmap* destinationBitmap,
+        IAsyncAction** asyncAction)
+    {
+        CheckInPointer(destinationBitmap);
+        CheckAndClearOutPointer(asyncAction);
 
-        if (capacity < r.GetTotalBytes())
+        // Checks the bitmaps match now, so mistakes are reported by this
+        // call rather than by the async action.
         {
-            WinStringBuilder message;
-            message.Format(Strings::WrongArrayLength, r.GetTotalBytes(), capacity);
-            ThrowHR(E_INVALIDARG, message.Get());
+            LockedSoftwareBitmapPixels destination(destinationBitmap, d2dBitmap, BitmapBufferAccessMode_Read);
         }
 
-        ThrowIfFailed(buffer->put_Length(r.GetTotalBytes()));
+        auto extents = GetBitmapExtents(d2dBitmap);
+        BitmapSubRectangle r(d2dBitmap, extents);
 
-        uint8_t* destination;
-        ThrowIfFailed(byteAccess->Buffer(&destination));
+        //
+        // As with MapPixelsAsync, the copy is queued up on the calling
+        // thread.  Each call takes its own staging bitmap from the device's
+        // StagingBitmapPool, and gives it back once its pixels are written
+        // into the SoftwareBitmap, so an app that keeps a few frames in
+        // flight cycles through the same staging bitmaps rather than
+        // allocating new ones.
+        //
+        ComPtr<CanvasGpuFence> copyFence;
+        auto stagingBitmap = ScopedBitmapMappedPixelAccess::BeginCopy(device.Get(), d2dBitmap.Get(), &extents, &copyFence);
 
-        CopyPixelBytes(
-            r,
-            bitmapPixelAccess.GetStride(),
-            r.GetBytesPerRow(),
-            begin(bitmapPixelAccess),
-            stdext::make_checked_array_iterator(destination, capacity));
+        ComPtr<ISoftwareBitmap> destinationBitmapPtr = destinationBitmap;
+
+        auto action = Make<AsyncAction>(
+            [=]
+            {
+                ScopedBitmapMappedPixelAccess::WaitForCopy(copyFence.Get());
+
+                ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), stagingBitmap);
+
+                LockedSoftwareBitmapPixels destination(destinationBitmapPtr.Get(), d2dBitmap, BitmapBufferAccessMode_Write);
+
+                CopyMappedPixelsToSoftwareBitmap(bitmapPixelAccess, destination, r);
+            });
+
+        CheckMakeResult(action);
+        ThrowIfFailed(action.CopyTo(asyncAction));
     }
 
+#endif
+
     void GetPixelColorsImpl(
         ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
@@ -1233,15 +3105,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         for (unsigned int y = 0; y < subRectangleHeight; y++)
         {
-            for (unsigned int x = 0; x < subRectangleWidth; x++)
-            {
-                uint32_t sourcePixel = *(reinterpret_cast<uint32_t*>(&sourceRowStart[x * 4]));
-                Color& destColor = array[y * subRectangleWidth + x];
-                destColor.B = (sourcePixel >> 0) & 0xFF;
-                destColor.G = (sourcePixel >> 8) & 0xFF;
-                destColor.R = (sourcePixel >> 16) & 0xFF;
-                destColor.A = (sourcePixel >> 24) & 0xFF;
-            }
+            auto destRowStart = reinterpret_cast<uint8_t*>(array.GetData() + y * subRectangleWidth);
+
+            SwizzlePixels(PixelSwizzle::BgraToArgb, sourceRowStart, destRowStart, subRectangleWidth);
+
             sourceRowStart += bitmapPixelAccess.GetStride();
         }
 
@@ -1253,7 +3120,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ID2D1Device* d2dDevice,
         IStream* stream,
         GUID const& containerFormat,
-        float quality)
+        float quality,
+        WicEncoderOptions const& options)
     {
         if (quality < 0.0f || quality > 1.0f)
             ThrowHR(E_INVALIDARG);
@@ -1297,18 +3165,220 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             d2dDevice,
             stream,
             containerFormat,
-            quality);
+            quality,
+            options);
     }
 
-    void SaveBitmapToFileImpl(
+    // Banded saves pick a band height that reads back about this many bytes at a time.
+    static const uint64_t DefaultSaveBandSize = 16 * 1024 * 1024;
+
+    //
+    // Works out which WIC pixel format describes the bitmap's own pixels, for
+    // the formats that a banded save can hand straight to the encoder.
+    //
+    static bool TryGetWicFormatForBandedSave(D2D1_PIXEL_FORMAT const& pixelFormat, GUID* wicFormat)
+    {
+        bool isPremultiplied = (pixelFormat.alphaMode == D2D1_ALPHA_MODE_PREMULTIPLIED);
+        bool isIgnored = (pixelFormat.alphaMode == D2D1_ALPHA_MODE_IGNORE);
+
+        switch (pixelFormat.format)
+        {
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            *wicFormat = isIgnored ? GUID_WICPixelFormat32bppBGR : isPremultiplied ? GUID_WICPixelFormat32bppPBGRA : GUID_WICPixelFormat32bppBGRA;
+            return true;
+
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            *wicFormat = isPremultiplied ? GUID_WICPixelFormat32bppPRGBA : GUID_WICPixelFormat32bppRGBA;
+            return !isIgnored;
+
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+            *wicFormat = isPremultiplied ? GUID_WICPixelFormat64bppPRGBA : GUID_WICPixelFormat64bppRGBA;
+            return !isIgnored;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            *wicFormat = isPremultiplied ? GUID_WICPixelFormat64bppPRGBAHalf : GUID_WICPixelFormat64bppRGBAHalf;
+            return !isIgnored;
+
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            *wicFormat = isPremultiplied ? GUID_WICPixelFormat128bppPRGBAFloat : GUID_WICPixelFormat128bppRGBAFloat;
+            return !isIgnored;
+
+        default:
+            return false;
+        }
+    }
+
+    static void WriteBand(
+        IWICImagingFactory* factory,
+        IWICBitmapFrameEncode* frame,
+        ScopedBitmapMappedPixelAccess const& band,
+        GUID const& bandFormat,
+        GUID const& encodeFormat,
+        uint32_t width,
+        uint32_t height)
+    {
+        auto stride = band.GetStride();
+
+        // If the encoder takes our pixels as they are, hand it the mapped memory directly.
+        if (bandFormat == encodeFormat)
+        {
+            ThrowIfFailed(frame->WritePixels(height, stride, stride * height, band.GetLockedData()));
+            return;
+        }
+
+        ComPtr<IWICBitmap> bandBitmap;
+        ThrowIfFailed(factory->CreateBitmapFromMemory(width, height, bandFormat, stride, stride * height, band.GetLockedData(), &bandBitmap));
+
+        ComPtr<IWICFormatConverter> converter;
+        ThrowIfFailed(factory->CreateFormatConverter(&converter));
+        ThrowIfFailed(converter->Initialize(bandBitmap.Get(), encodeFormat, WICBitmapDitherTypeNone, nullptr, 0, WICBitmapPaletteTypeCustom));
+
+        WICRect rect{ 0, 0, static_cast<INT>(width), static_cast<INT>(height) };
+        ThrowIfFailed(frame->WriteSource(converter.Get(), &rect));
+    }
+
+    //
+    // Saves a bitmap one band of rows at a time, rather than having WIC read
+    // back the whole image in one go.  Peak memory use is a couple of bands,
+    // and the GPU copies each band into a staging bitmap while the previous
+    // one is being encoded.
+    //
+    static void SaveBitmapInBands(
+        ICanvasDevice* device,
+        ID2D1Bitmap1* d2dBitmap,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality,
+        WicEncoderOptions const& options,
+        uint32_t bandHeight)
+    {
+        if (quality < 0.0f || quality > 1.0f)
+            ThrowHR(E_INVALIDARG);
+
+        auto pixelFormat = d2dBitmap->GetPixelFormat();
+
+        // GIF needs one palette for the whole image, and other pixel formats
+        // can't be read back in a form WIC understands, so those go the usual way.
+        GUID bandFormat;
+
+        if (containerFormat == GUID_ContainerFormatGif || !TryGetWicFormatForBandedSave(pixelFormat, &bandFormat))
+        {
+            auto d2dDevice = As<ICanvasDeviceInternal>(device)->GetD2DDevice();
+            SaveBitmap(d2dBitmap, d2dDevice.Get(), stream, containerFormat, quality, options);
+            return;
+        }
+
+        auto size = d2dBitmap->GetPixelSize();
+
+        if (bandHeight == 0)
+        {
+            auto bytesPerRow = static_cast<uint64_t>(size.width) * GetBytesPerBlock(pixelFormat.format);
+            bandHeight = static_cast<uint32_t>(std::max<uint64_t>(DefaultSaveBandSize / bytesPerRow, 1));
+        }
+
+        bandHeight = std::min(bandHeight, size.height);
+
+        float dpiX, dpiY;
+        d2dBitmap->GetDpi(&dpiX, &dpiY);
+
+        auto wicAdapter = WicAdapter::GetInstance();
+        auto& factory = wicAdapter->GetFactory();
+
+        ComPtr<IWICBitmapEncoder> encoder;
+        ComPtr<IWICBitmapFrameEncode> frame;
+        CreateWicFrameEncode(factory.Get(), stream, containerFormat, quality, options, &encoder, &frame);
+
+        ThrowIfFailed(frame->SetSize(size.width, size.height));
+        ThrowIfFailed(frame->SetResolution(dpiX, dpiY));
+
+        // As with SaveBitmap, extended range formats keep their own pixel
+        // format, while everything else is encoded from premultiplied BGRA.
+        // The encoder changes this to the closest format it supports.
+        GUID encodeFormat = FileFormatSupportsHdr(containerFormat) ? bandFormat : GUID_WICPixelFormat32bppPBGRA;
+        ThrowIfFailed(frame->SetPixelFormat(&encodeFormat));
+
+        auto getBand = [&](uint32_t top)
+        {
+            return D2D1::RectU(0, top, size.width, std::min(top + bandHeight, size.height));
+        };
+
+        auto firstBand = getBand(0);
+        auto pendingCopy = ScopedBitmapMappedPixelAccess::BeginCopy(device, d2dBitmap, &firstBand);
+
+        for (uint32_t top = 0; top < size.height; top += bandHeight)
+        {
+            auto bandRect = getBand(top);
+
+            AsyncCancellation::ThrowIfCanceled();
+
+            ScopedBitmapMappedPixelAccess band(device, pendingCopy);
+
+            // Start the GPU on the next band before encoding this one.
+            if (bandRect.bottom < size.height)
+            {
+                auto nextBand = getBand(bandRect.bottom);
+                pendingCopy = ScopedBitmapMappedPixelAccess::BeginCopy(device, d2dBitmap, &nextBand);
+            }
+
+            WriteBand(factory.Get(), frame.Get(), band, bandFormat, encodeFormat, size.width, bandRect.bottom - bandRect.top);
+        }
+
+        ThrowIfFailed(frame->Commit());
+        ThrowIfFailed(encoder->Commit());
+    }
+
+    static void SaveBitmapToIStream(
+        ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Device> const& d2dDevice,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality,
+        WicEncoderOptions const& options,
+        uint32_t const* optionalBandHeight)
+    {
+        // The number of bytes written is worked out from the stream position.
+        ULARGE_INTEGER startPosition{};
+        bool traceEnabled = EventEnabled_CanvasBitmap_Save_Start();
+
+        if (traceEnabled)
+        {
+            auto size = d2dBitmap->GetPixelSize();
+            EventWrite_CanvasBitmap_Save_Start(size.width, size.height, optionalBandHeight ? *optionalBandHeight : 0);
+            (void)stream->Seek(LARGE_INTEGER{}, STREAM_SEEK_CUR, &startPosition);
+        }
+
+        auto saveEnd = MakeScopeWarden(
+            [&]
+            {
+                if (!traceEnabled)
+                    return;
+
+                ULARGE_INTEGER endPosition = startPosition;
+                (void)stream->Seek(LARGE_INTEGER{}, STREAM_SEEK_CUR, &endPosition);
+                EventWrite_CanvasBitmap_Save_Stop(endPosition.QuadPart - startPosition.QuadPart);
+            });
+
+        if (optionalBandHeight)
+            SaveBitmapInBands(device.Get(), d2dBitmap.Get(), stream, containerFormat, quality, options, *optionalBandHeight);
+        else
+            SaveBitmap(d2dBitmap.Get(), d2dDevice.Get(), stream, containerFormat, quality, options);
+    }
+
+    void SaveBitmapToFileImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         HSTRING rawfileName,
         CanvasBitmapFileFormat fileFormat,
         float quality,
+        WicEncoderOptions const& options,
+        uint32_t const* optionalBandHeight,
         IAsyncAction **resultAsyncAction)
     {
         WinString fileName(rawfileName);
+        auto d2dDevice = GetWrappedResource<ID2D1Device>(device);
+        bool isBanded = (optionalBandHeight != nullptr);
+        uint32_t bandHeight = isBanded ? *optionalBandHeight : 0;
 
         auto asyncAction = Make<AsyncAction>(
             [=]
@@ -1324,7 +3394,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 
                 ThrowIfFailed(wicStream->InitializeFromFilename(static_cast<wchar_t const*>(fileName), GENERIC_WRITE));
 
-                SaveBitmap(d2dBitmap.Get(), d2dDevice.Get(), wicStream.Get(), encoderGuid, quality);
+                SaveBitmapToIStream(device, d2dDevice, d2dBitmap, wicStream.Get(), encoderGuid, quality, options, isBanded ? &bandHeight : nullptr);
             });
 
         CheckMakeResult(asyncAction);
@@ -1332,11 +3402,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
     void SaveBitmapToStreamImpl(
-        ComPtr<ID2D1Device> const& d2dDevice,
+        ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         ComPtr<IRandomAccessStream> const& randomAccessStream,
         CanvasBitmapFileFormat fileFormat,
         float quality,
+        WicEncoderOptions const& options,
+        uint32_t const* optionalBandHeight,
         IAsyncAction **resultAsyncAction)
     {
         if (fileFormat == CanvasBitmapFileFormat::Auto)
@@ -1344,13 +3416,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ThrowHR(E_INVALIDARG, Strings::AutoFileFormatNotAllowed);
         }
 
+        auto d2dDevice = GetWrappedResource<ID2D1Device>(device);
+        bool isBanded = (optionalBandHeight != nullptr);
+        uint32_t bandHeight = isBanded ? *optionalBandHeight : 0;
+
         auto asyncAction = Make<AsyncAction>(
             [=]
             {
                 ComPtr<IStream> stream;
                 ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
 
-                SaveBitmap(d2dBitmap.Get(), d2dDevice.Get(), stream.Get(), GetGUIDForFileFormat(fileFormat), quality);
+                SaveBitmapToIStream(device, d2dDevice, d2dBitmap, stream.Get(), GetGUIDForFileFormat(fileFormat), quality, options, isBanded ? &bandHeight : nullptr);
             });
 
         CheckMakeResult(asyncAction);
@@ -1361,7 +3437,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         D2D1_RECT_U const& subRectangle,
         uint32_t valueCount,
-        uint8_t* valueElements)
+        uint8_t* valueElements,
+        CanvasAlphaMode const* optionalAlphaMode)
     {
         CheckInPointer(valueElements);
 
@@ -1374,13 +3451,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ThrowHR(E_INVALIDARG, message.Get());
         }
 
-        ThrowIfFailed(d2dBitmap->CopyFromMemory(&subRectangle, valueElements, r.GetBytesPerRow()));
+        auto alphaConversion = GetPixelCopyAlphaConversion(d2dBitmap, optionalAlphaMode, true);
+
+        if (alphaConversion == AlphaConversion::None)
+        {
+            ThrowIfFailed(d2dBitmap->CopyFromMemory(&subRectangle, valueElements, r.GetBytesPerRow()));
+        }
+        else
+        {
+            std::vector<uint8_t> convertedBytes(r.GetTotalBytes());
+
+            ConvertPixelAlpha(alphaConversion, valueElements, convertedBytes.data(), r.GetTotalBytes() / 4);
+
+            ThrowIfFailed(d2dBitmap->CopyFromMemory(&subRectangle, convertedBytes.data(), r.GetBytesPerRow()));
+        }
+
+        PerformanceCounters::Increment(PerformanceCounter::BitmapBytesUploaded, r.GetTotalBytes());
     }
 
     void SetPixelBytesImpl(
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         D2D1_RECT_U const& subRectangle,
-        IBuffer* buffer)
+        IBuffer* buffer,
+        CanvasAlphaMode const* optionalAlphaMode)
     {
         using ::Windows::Storage::Streams::IBufferByteAccess;
 
@@ -1394,7 +3487,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ThrowIfFailed(buffer->get_Length(&byteCount));
         ThrowIfFailed(byteAccess->Buffer(&bytes));
 
-        SetPixelBytesImpl(d2dBitmap, subRectangle, byteCount, bytes);
+        SetPixelBytesImpl(d2dBitmap, subRectangle, byteCount, bytes, optionalAlphaMode);
     }
 
     void SetPixelColorsImpl(
@@ -1426,21 +3519,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         auto convertedValues = ConvertColorsToBgra(expectedArraySize, valueElements);
 
         ThrowIfFailed(d2dBitmap->CopyFromMemory(&subRectangle, convertedValues.data(), subRectangleWidth * 4));
+
+        PerformanceCounters::Increment(PerformanceCounter::BitmapBytesUploaded, static_cast<uint64_t>(expectedArraySize) * 4);
     }
 
 
-    void CopyPixelsFromBitmapImpl(
-        ICanvasBitmap* to,
+    static void CopyPixelsToD2DBitmap(
+        ID2D1Bitmap1* toD2dBitmap,
+        ICanvasDevice* toDevice,
         ICanvasBitmap* from,
         D2D1_POINT_2U const& destPoint,
         D2D1_RECT_U const* sourceRect)
     {
-        assert(to);
         CheckInPointer(from);
 
-        auto toBitmapInternal = As<ICanvasBitmapInternal>(to);
-        auto toD2dBitmap = toBitmapInternal->GetD2DBitmap();
-
         auto fromBitmapInternal = As<ICanvasBitmapInternal>(from);
         auto fromD2dBitmap = fromBitmapInternal->GetD2DBitmap();
 
@@ -1472,13 +3564,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
 
         // Are both bitmaps on the same device?
-        ComPtr<ICanvasDevice> toDevice;
         ComPtr<ICanvasDevice> fromDevice;
-
-        ThrowIfFailed(As<ICanvasResourceCreator>(to)->get_Device(&toDevice));
         ThrowIfFailed(As<ICanvasResourceCreator>(from)->get_Device(&fromDevice));
 
-        if (IsSameInstance(toDevice.Get(), fromDevice.Get()))
+        if (IsSameInstance(toDevice, fromDevice.Get()))
         {
             // Tell D2D to copy for us (typically done via GPU HW).
             ThrowIfFailed(toD2dBitmap->CopyFromBitmap(&destPoint, fromD2dBitmap.Get(), sourceRect));
@@ -1489,6 +3578,73 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ScopedBitmapMappedPixelAccess fromAccess(fromDevice.Get(), fromD2dBitmap.Get(), sourceRect);
 
             ThrowIfFailed(toD2dBitmap->CopyFromMemory(&destRect, fromAccess.GetLockedData(), fromAccess.GetStride()));
+
+            PerformanceCounters::Increment(PerformanceCounter::BitmapBytesUploaded, fromAccess.GetLockedBufferSize());
+        }
+    }
+
+
+    void CopyPixelsFromBitmapImpl(
+        ICanvasBitmap* to,
+        ICanvasBitmap* from,
+        D2D1_POINT_2U const& destPoint,
+        D2D1_RECT_U const* sourceRect)
+    {
+        assert(to);
+
+        auto toD2dBitmap = As<ICanvasBitmapInternal>(to)->GetD2DBitmap();
+
+        ComPtr<ICanvasDevice> toDevice;
+        ThrowIfFailed(As<ICanvasResourceCreator>(to)->get_Device(&toDevice));
+
+        CopyPixelsToD2DBitmap(toD2dBitmap.Get(), toDevice.Get(), from, destPoint, sourceRect);
+    }
+
+
+    void CopyPixelsFromBitmapsImpl(
+        ICanvasBitmap* to,
+        uint32_t bitmapCount,
+        ICanvasBitmap** bitmaps,
+        uint32_t destPointCount,
+        ABI::Windows::Graphics::PointInt32* destPoints,
+        uint32_t sourceRectCount,
+        BitmapBounds* sourceRects)
+    {
+        assert(to);
+
+        if (bitmapCount > 0)
+        {
+            CheckInPointer(bitmaps);
+            CheckInPointer(destPoints);
+        }
+
+        if (destPointCount != bitmapCount || (sourceRectCount != 0 && sourceRectCount != bitmapCount))
+            ThrowHR(E_INVALIDARG, Strings::BitmapCopyArraySizesMismatch);
+
+        if (sourceRectCount > 0)
+            CheckInPointer(sourceRects);
+
+        // The destination only has to be looked up once for the whole batch.
+        auto toD2dBitmap = As<ICanvasBitmapInternal>(to)->GetD2DBitmap();
+
+        ComPtr<ICanvasDevice> toDevice;
+        ThrowIfFailed(As<ICanvasResourceCreator>(to)->get_Device(&toDevice));
+
+        for (uint32_t i = 0; i < bitmapCount; i++)
+        {
+            auto destPoint = ToD2DPointU(destPoints[i].X, destPoints[i].Y);
+
+            if (sourceRectCount > 0)
+            {
+                auto& bounds = sourceRects[i];
+                D2D1_RECT_U sourceRect{ bounds.X, bounds.Y, bounds.X + bounds.Width, bounds.Y + bounds.Height };
+
+                CopyPixelsToD2DBitmap(toD2dBitmap.Get(), toDevice.Get(), bitmaps[i], destPoint, &sourceRect);
+            }
+            else
+            {
+                CopyPixelsToD2DBitmap(toD2dBitmap.Get(), toDevice.Get(), bitmaps[i], destPoint, nullptr);
+            }
         }
     }
 
@@ -14,6 +14,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     using namespace ::Microsoft::WRL;
     using namespace ABI::Microsoft::Graphics::Canvas::Effects;
     using namespace ABI::Windows::Foundation;
+    using namespace ABI::Windows::Foundation::Collections;
     using namespace ABI::Windows::Storage::Streams;
     using namespace ABI::Windows::Storage;
     using namespace ABI::Windows::UI;
@@ -32,6 +33,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         bool Indexed;
     };
 
+    // What LoadProgressiveAsync needs to know before it starts decoding.
+    struct ProgressiveLoadInfo
+    {
+        // The way up the image will be displayed.
+        BitmapSize Size;
+
+        // Source is null if the image has no embedded thumbnail.
+        WicBitmapSource Thumbnail;
+    };
+
     class DefaultBitmapAdapter;
 
     class CanvasBitmapAdapter : public Singleton<CanvasBitmapAdapter, DefaultBitmapAdapter>
@@ -39,8 +50,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     public:
         virtual ~CanvasBitmapAdapter() = default;
 
-        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing = false) = 0;
-        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing = false) = 0;
+        // A non-zero maximumSize decodes the image scaled down to fit within
+        // that size (after any EXIF rotation), instead of at full resolution.
+        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing = false, BitmapSize maximumSize = BitmapSize{}, BitmapBounds sourceRectangle = BitmapBounds{}) = 0;
+        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing = false, BitmapSize maximumSize = BitmapSize{}, BitmapBounds sourceRectangle = BitmapBounds{}) = 0;
+
+        virtual ProgressiveLoadInfo GetProgressiveLoadInfo(ICanvasDevice* device, HSTRING fileName) = 0;
+        virtual ProgressiveLoadInfo GetProgressiveLoadInfo(ICanvasDevice* device, IStream* fileStream) = 0;
 
         virtual ComPtr<IWICBitmapSource> CreateFlipRotator(
             ComPtr<IWICBitmapSource> const& source,
@@ -55,12 +71,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     public:
         DefaultBitmapAdapter();
 
-        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing) override;
-        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing) override;
+        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing, BitmapSize maximumSize, BitmapBounds sourceRectangle) override;
+        virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing, BitmapSize maximumSize, BitmapBounds sourceRectangle) override;
+
+        virtual ProgressiveLoadInfo GetProgressiveLoadInfo(ICanvasDevice* device, HSTRING fileName) override;
+        virtual ProgressiveLoadInfo GetProgressiveLoadInfo(ICanvasDevice* device, IStream* fileStream) override;
 
         virtual ComPtr<IWICBitmapSource> CreateFlipRotator(
             ComPtr<IWICBitmapSource> const& source,
             WICBitmapTransformOptions transformOptions) override;
+
+    private:
+        ComPtr<IStream> OpenFile(HSTRING fileName);
     };
 
 
@@ -185,6 +207,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasAlphaMode alpha,
             ICanvasBitmap** canvasBitmap) override;
 
+        IFACEMETHOD(CreateFromBytesWithLayout)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t byteCount,
+            BYTE* bytes,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            CanvasBitmapSourceLayout layout,
+            ICanvasBitmap** canvasBitmap) override;
+
+        IFACEMETHOD(CreateFromBytesWithLayoutAndDpi)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t byteCount,
+            BYTE* bytes,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            CanvasBitmapSourceLayout layout,
+            float dpi,
+            ICanvasBitmap** canvasBitmap) override;
+
 #if WINVER > _WIN32_WINNT_WINBLUE
         IFACEMETHOD(CreateFromSoftwareBitmap)(
             ICanvasResourceCreator* resourceCreator,
@@ -192,6 +233,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ICanvasBitmap** canvasBitmap) override;
 #endif        
 
+        IFACEMETHOD(CreateCopyOnDevice)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasBitmap* sourceBitmap,
+            ICanvasBitmap** canvasBitmap) override;
+
         IFACEMETHOD(LoadAsyncFromHstring)(
             ICanvasResourceCreator* resourceCreator,
             HSTRING fileName,
@@ -210,6 +256,33 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasAlphaMode alpha,
             ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
 
+        IFACEMETHOD(LoadAsyncFromHstringWithDpiAlphaAndMaximumSize)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING fileName,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadAsyncFromHstringWithDpiAlphaMaximumSizeAndFormat)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING fileName,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            DirectXPixelFormat format,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadAsyncFromHstringWithDpiAlphaMaximumSizeFormatAndSourceRectangle)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING fileName,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            DirectXPixelFormat format,
+            BitmapBounds sourceRectangle,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
         IFACEMETHOD(LoadAsyncFromUri)(
             ICanvasResourceCreator* resourceCreator,
             ABI::Windows::Foundation::IUriRuntimeClass* uri,
@@ -228,6 +301,33 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasAlphaMode alpha,
             ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
 
+        IFACEMETHOD(LoadAsyncFromUriWithDpiAlphaAndMaximumSize)(
+            ICanvasResourceCreator* resourceCreator,
+            ABI::Windows::Foundation::IUriRuntimeClass* uri,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadAsyncFromUriWithDpiAlphaMaximumSizeAndFormat)(
+            ICanvasResourceCreator* resourceCreator,
+            ABI::Windows::Foundation::IUriRuntimeClass* uri,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            DirectXPixelFormat format,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadAsyncFromUriWithDpiAlphaMaximumSizeFormatAndSourceRectangle)(
+            ICanvasResourceCreator* resourceCreator,
+            ABI::Windows::Foundation::IUriRuntimeClass* uri,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            DirectXPixelFormat format,
+            BitmapBounds sourceRectangle,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
         IFACEMETHOD(LoadAsyncFromStream)(
             ICanvasResourceCreator* resourceCreator,
             IRandomAccessStream* stream,
@@ -246,6 +346,106 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasAlphaMode alpha,
             ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
 
+        IFACEMETHOD(LoadAsyncFromStreamWithDpiAlphaAndMaximumSize)(
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadAsyncFromStreamWithDpiAlphaMaximumSizeAndFormat)(
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            DirectXPixelFormat format,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadAsyncFromStreamWithDpiAlphaMaximumSizeFormatAndSourceRectangle)(
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize,
+            DirectXPixelFormat format,
+            BitmapBounds sourceRectangle,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadProgressiveAsyncFromHstring)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING fileName,
+            ICanvasBitmapPreviewHandler* previewHandler,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadProgressiveAsyncFromHstringWithDpiAlphaAndPreviewSize)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING fileName,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize previewSize,
+            ICanvasBitmapPreviewHandler* previewHandler,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadProgressiveAsyncFromUri)(
+            ICanvasResourceCreator* resourceCreator,
+            ABI::Windows::Foundation::IUriRuntimeClass* uri,
+            ICanvasBitmapPreviewHandler* previewHandler,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadProgressiveAsyncFromUriWithDpiAlphaAndPreviewSize)(
+            ICanvasResourceCreator* resourceCreator,
+            ABI::Windows::Foundation::IUriRuntimeClass* uri,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize previewSize,
+            ICanvasBitmapPreviewHandler* previewHandler,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadProgressiveAsyncFromStream)(
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            ICanvasBitmapPreviewHandler* previewHandler,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadProgressiveAsyncFromStreamWithDpiAlphaAndPreviewSize)(
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            float dpi,
+            CanvasAlphaMode alpha,
+            BitmapSize previewSize,
+            ICanvasBitmapPreviewHandler* previewHandler,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasBitmap*>** canvasBitmapAsyncOperation) override;
+
+        IFACEMETHOD(LoadManyAsyncFromHstrings)(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<HSTRING>* fileNames,
+            ABI::Windows::Foundation::IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation) override;
+
+        IFACEMETHOD(LoadManyAsyncFromHstringsWithOptions)(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<HSTRING>* fileNames,
+            float dpi,
+            CanvasAlphaMode alpha,
+            int32_t maximumParallelism,
+            ICanvasBitmapLoadedHandler* loadedHandler,
+            ABI::Windows::Foundation::IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation) override;
+
+        IFACEMETHOD(LoadManyAsyncFromStreams)(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<IRandomAccessStream*>* streams,
+            ABI::Windows::Foundation::IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation) override;
+
+        IFACEMETHOD(LoadManyAsyncFromStreamsWithOptions)(
+            ICanvasResourceCreator* resourceCreator,
+            IIterable<IRandomAccessStream*>* streams,
+            float dpi,
+            CanvasAlphaMode alpha,
+            int32_t maximumParallelism,
+            ICanvasBitmapLoadedHandler* loadedHandler,
+            ABI::Windows::Foundation::IAsyncOperation<IVectorView<CanvasBitmap*>*>** canvasBitmapsAsyncOperation) override;
+
     private:
         HRESULT CreateFromDirect3D11SurfaceImpl(
             ICanvasResourceCreator* resourceCreator,
@@ -256,6 +456,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     };
 
 
+    // Decodes the files in parallel and creates bitmaps from them on the
+    // calling thread, returning once they are all loaded.  Throws if any of
+    // them fail to load.
+    ComPtr<IVectorView<CanvasBitmap*>> LoadBitmapFilesInParallel(
+        ICanvasDevice* device,
+        std::vector<WinString>&& fileNames,
+        float dpi,
+        CanvasAlphaMode alpha);
+
     void GetPixelBytesImpl(
         ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
@@ -263,11 +472,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         uint32_t* valueCount,
         uint8_t** valueElements);
 
+    // A non-null optionalAlphaMode converts the pixels from the bitmap's
+    // alpha mode into that one as they are copied.
     void GetPixelBytesImpl(
         ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         D2D1_RECT_U const& subRectangle,
-        IBuffer* buffer);
+        IBuffer* buffer,
+        CanvasAlphaMode const* optionalAlphaMode);
 
     void GetPixelColorsImpl(
         ComPtr<ICanvasDevice> const& device,
@@ -276,32 +488,75 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         uint32_t* valueCount,
         Color **valueElements);
 
+#if WINVER > _WIN32_WINNT_WINBLUE
+    void MapPixelsImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        ICanvasMappedPixels** mappedPixels);
+
+    void MapPixelsAsyncImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        IAsyncOperation<CanvasMappedPixels*>** asyncOperation);
+
+    // The SoftwareBitmap must be the same size and pixel format as the
+    // bitmap.  Its buffer is locked and copied in a single step, without
+    // going through an intermediate array.
+    void CopyPixelsFromSoftwareBitmapImpl(
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        ISoftwareBitmap* sourceBitmap);
+
+    void CopyPixelsToSoftwareBitmapImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        ISoftwareBitmap* destinationBitmap);
+
+    void CopyPixelsToSoftwareBitmapAsyncImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        ISoftwareBitmap* destinationBitmap,
+        IAsyncAction** asyncAction);
+#endif
+
+    // A non-null optionalBandHeight reads back and encodes the bitmap that
+    // many rows at a time (zero picks a band height automatically), and
+    // options are passed through to the WIC encoder.
     void SaveBitmapToFileImpl(
-        ComPtr<ID2D1Device> const& d2dDevice,
+        ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         HSTRING rawfileName,
         CanvasBitmapFileFormat fileFormat,
         float quality,
+        WicEncoderOptions const& options,
+        uint32_t const* optionalBandHeight,
         IAsyncAction **resultAsyncAction);
 
     void SaveBitmapToStreamImpl(
-        ComPtr<ID2D1Device> const& d2dDevice,
+        ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         ComPtr<IRandomAccessStream> const& stream,
         CanvasBitmapFileFormat fileFormat,
         float quality,
+        WicEncoderOptions const& options,
+        uint32_t const* optionalBandHeight,
         IAsyncAction **resultAsyncAction);
 
+    // A non-null optionalAlphaMode is the alpha mode of the source pixels,
+    // which are converted into the bitmap's alpha mode as they are copied.
     void SetPixelBytesImpl(
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         D2D1_RECT_U const& subRectangle,
         uint32_t valueCount,
-        uint8_t* valueElements);
+        uint8_t* valueElements,
+        CanvasAlphaMode const* optionalAlphaMode);
 
     void SetPixelBytesImpl(
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
         D2D1_RECT_U const& subRectangle,
-        IBuffer* buffer);
+        IBuffer* buffer,
+        CanvasAlphaMode const* optionalAlphaMode);
 
     void SetPixelColorsImpl(
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
@@ -315,6 +570,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_POINT_2U const& destPoint,
         D2D1_RECT_U const* sourceRect);
 
+    void CopyPixelsFromBitmapsImpl(
+        ICanvasBitmap* to,
+        uint32_t bitmapCount,
+        ICanvasBitmap** bitmaps,
+        uint32_t destPointCount,
+        ABI::Windows::Graphics::PointInt32* destPoints,
+        uint32_t sourceRectCount,
+        BitmapBounds* sourceRects);
+
 
     struct CanvasBitmapTraits
     {
@@ -345,6 +609,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 ABI::Windows::Foundation::IClosable,
                 CloakedIid<ICanvasResourceWrapperNative>>>
         , public ResourceWrapper<typename TRAITS::resource_t, typename TRAITS::wrapper_t, typename TRAITS::wrapper_interface_t>
+        , private ObjectCounter<CountedObjectType::Bitmap>
     {
         float m_dpi;
 
@@ -555,11 +820,69 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     CheckAndClearOutPointer(resultAsyncAction);
 
                     SaveBitmapToFileImpl(
-                        GetWrappedResource<ID2D1Device>(m_device),
+                        m_device,
                         GetResource(),
                         rawfileName,
                         fileFormat,
                         quality,
+                        WicEncoderOptions{},
+                        nullptr,
+                        resultAsyncAction);
+                });
+        }
+
+        IFACEMETHODIMP SaveToFileWithBitmapFileFormatQualityAndBandHeightAsync(
+            HSTRING rawfileName,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            int32_t bandHeight,
+            IAsyncAction **resultAsyncAction) override
+        {
+            return ExceptionBoundary(
+                [=]
+                {
+                    CheckInPointer(rawfileName);
+                    CheckAndClearOutPointer(resultAsyncAction);
+
+                    if (bandHeight < 0)
+                        ThrowHR(E_INVALIDARG);
+
+                    auto unsignedBandHeight = static_cast<uint32_t>(bandHeight);
+
+                    SaveBitmapToFileImpl(
+                        m_device,
+                        GetResource(),
+                        rawfileName,
+                        fileFormat,
+                        quality,
+                        WicEncoderOptions{},
+                        &unsignedBandHeight,
+                        resultAsyncAction);
+                });
+        }
+
+        IFACEMETHODIMP SaveToFileWithEncoderOptionsAsync(
+            HSTRING rawfileName,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            CanvasBitmapEncoderPreset preset,
+            IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* encoderOptions,
+            IAsyncAction **resultAsyncAction) override
+        {
+            return ExceptionBoundary(
+                [=]
+                {
+                    CheckInPointer(rawfileName);
+                    CheckAndClearOutPointer(resultAsyncAction);
+
+                    SaveBitmapToFileImpl(
+                        m_device,
+                        GetResource(),
+                        rawfileName,
+                        fileFormat,
+                        quality,
+                        MakeWicEncoderOptions(preset, encoderOptions),
+                        nullptr,
                         resultAsyncAction);
                 });
         }
@@ -589,11 +912,69 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     CheckAndClearOutPointer(asyncAction);
 
                     SaveBitmapToStreamImpl(
-                        GetWrappedResource<ID2D1Device>(m_device),
+                        m_device,
+                        GetResource(),
+                        stream,
+                        fileFormat,
+                        quality,
+                        WicEncoderOptions{},
+                        nullptr,
+                        asyncAction);
+                });
+        }
+
+        IFACEMETHODIMP SaveToStreamWithQualityAndBandHeightAsync(
+            IRandomAccessStream* stream,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            int32_t bandHeight,
+            IAsyncAction** asyncAction) override
+        {
+            return ExceptionBoundary(
+                [=]
+                {
+                    CheckInPointer(stream);
+                    CheckAndClearOutPointer(asyncAction);
+
+                    if (bandHeight < 0)
+                        ThrowHR(E_INVALIDARG);
+
+                    auto unsignedBandHeight = static_cast<uint32_t>(bandHeight);
+
+                    SaveBitmapToStreamImpl(
+                        m_device,
                         GetResource(),
                         stream,
                         fileFormat,
                         quality,
+                        WicEncoderOptions{},
+                        &unsignedBandHeight,
+                        asyncAction);
+                });
+        }
+
+        IFACEMETHODIMP SaveToStreamWithEncoderOptionsAsync(
+            IRandomAccessStream* stream,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            CanvasBitmapEncoderPreset preset,
+            IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* encoderOptions,
+            IAsyncAction** asyncAction) override
+        {
+            return ExceptionBoundary(
+                [=]
+                {
+                    CheckInPointer(stream);
+                    CheckAndClearOutPointer(asyncAction);
+
+                    SaveBitmapToStreamImpl(
+                        m_device,
+                        GetResource(),
+                        stream,
+                        fileFormat,
+                        quality,
+                        MakeWicEncoderOptions(preset, encoderOptions),
+                        nullptr,
                         asyncAction);
                 });
         }
@@ -650,7 +1031,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                         m_device,
                         d2dBitmap,
                         GetResourceBitmapExtents(d2dBitmap),
-                        buffer);
+                        buffer,
+                        nullptr);
                 });
         }
 
@@ -670,7 +1052,48 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                         m_device,
                         d2dBitmap,
                         ToD2DRectU(left, top, width, height),
-                        buffer);
+                        buffer,
+                        nullptr);
+                });
+        }
+
+        IFACEMETHODIMP GetPixelBytesWithBufferAndAlphaMode(
+            IBuffer* buffer,
+            CanvasAlphaMode alphaMode) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    GetPixelBytesImpl(
+                        m_device,
+                        d2dBitmap,
+                        GetResourceBitmapExtents(d2dBitmap),
+                        buffer,
+                        &alphaMode);
+                });
+        }
+
+        IFACEMETHODIMP GetPixelBytesWithBufferSubrectangleAndAlphaMode(
+            IBuffer* buffer,
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height,
+            CanvasAlphaMode alphaMode) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    GetPixelBytesImpl(
+                        m_device,
+                        d2dBitmap,
+                        ToD2DRectU(left, top, width, height),
+                        buffer,
+                        &alphaMode);
                 });
         }
 
@@ -714,6 +1137,128 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 });
         }
 
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+        IFACEMETHODIMP MapPixels(
+            ICanvasMappedPixels** mappedPixels) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    MapPixelsImpl(
+                        m_device,
+                        d2dBitmap,
+                        GetResourceBitmapExtents(d2dBitmap),
+                        mappedPixels);
+                });
+        }
+
+        IFACEMETHODIMP MapPixelsWithSubrectangle(
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height,
+            ICanvasMappedPixels** mappedPixels) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    MapPixelsImpl(
+                        m_device,
+                        d2dBitmap,
+                        ToD2DRectU(left, top, width, height),
+                        mappedPixels);
+                });
+        }
+
+        IFACEMETHODIMP MapPixelsAsync(
+            IAsyncOperation<CanvasMappedPixels*>** asyncOperation) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    MapPixelsAsyncImpl(
+                        m_device,
+                        d2dBitmap,
+                        GetResourceBitmapExtents(d2dBitmap),
+                        asyncOperation);
+                });
+        }
+
+        IFACEMETHODIMP MapPixelsAsyncWithSubrectangle(
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height,
+            IAsyncOperation<CanvasMappedPixels*>** asyncOperation) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    MapPixelsAsyncImpl(
+                        m_device,
+                        d2dBitmap,
+                        ToD2DRectU(left, top, width, height),
+                        asyncOperation);
+                });
+        }
+
+        IFACEMETHODIMP CopyPixelsFromSoftwareBitmap(
+            ISoftwareBitmap* sourceBitmap) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    CopyPixelsFromSoftwareBitmapImpl(
+                        d2dBitmap,
+                        sourceBitmap);
+                });
+        }
+
+        IFACEMETHODIMP CopyPixelsToSoftwareBitmap(
+            ISoftwareBitmap* destinationBitmap) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    CopyPixelsToSoftwareBitmapImpl(
+                        m_device,
+                        d2dBitmap,
+                        destinationBitmap);
+                });
+        }
+
+        IFACEMETHODIMP CopyPixelsToSoftwareBitmapAsync(
+            ISoftwareBitmap* destinationBitmap,
+            IAsyncAction** asyncAction) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    CopyPixelsToSoftwareBitmapAsyncImpl(
+                        m_device,
+                        d2dBitmap,
+                        destinationBitmap,
+                        asyncAction);
+                });
+        }
+
+#endif
+
         IFACEMETHODIMP SetPixelBytes(
             uint32_t valueCount,
             uint8_t* valueElements) override
@@ -727,7 +1272,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                         d2dBitmap,
                         GetResourceBitmapExtents(d2dBitmap),
                         valueCount, 
-                        valueElements);
+                        valueElements,
+                        nullptr);
                 });
         }
 
@@ -748,7 +1294,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                         d2dBitmap,
                         ToD2DRectU(left, top, width, height),
                         valueCount, 
-                        valueElements);
+                        valueElements,
+                        nullptr);
                 });
         }
 
@@ -763,7 +1310,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     SetPixelBytesImpl(
                         d2dBitmap,
                         GetResourceBitmapExtents(d2dBitmap),
-                        buffer);
+                        buffer,
+                        nullptr);
                 });
         }
 
@@ -782,7 +1330,88 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     SetPixelBytesImpl(
                         d2dBitmap,
                         ToD2DRectU(left, top, width, height),
-                        buffer);
+                        buffer,
+                        nullptr);
+                });
+        }
+
+        IFACEMETHODIMP SetPixelBytesWithAlphaMode(
+            uint32_t valueCount,
+            uint8_t* valueElements,
+            CanvasAlphaMode alphaMode) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    SetPixelBytesImpl(
+                        d2dBitmap,
+                        GetResourceBitmapExtents(d2dBitmap),
+                        valueCount, 
+                        valueElements,
+                        &alphaMode);
+                });
+        }
+
+        IFACEMETHODIMP SetPixelBytesWithSubrectangleAndAlphaMode(
+            uint32_t valueCount,
+            uint8_t* valueElements,
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height,
+            CanvasAlphaMode alphaMode) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    SetPixelBytesImpl(
+                        d2dBitmap,
+                        ToD2DRectU(left, top, width, height),
+                        valueCount, 
+                        valueElements,
+                        &alphaMode);
+                });
+        }
+
+        IFACEMETHODIMP SetPixelBytesWithBufferAndAlphaMode(
+            IBuffer* buffer,
+            CanvasAlphaMode alphaMode) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    SetPixelBytesImpl(
+                        d2dBitmap,
+                        GetResourceBitmapExtents(d2dBitmap),
+                        buffer,
+                        &alphaMode);
+                });
+        }
+
+        IFACEMETHODIMP SetPixelBytesWithBufferSubrectangleAndAlphaMode(
+            IBuffer* buffer,
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height,
+            CanvasAlphaMode alphaMode) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto& d2dBitmap = GetResource();
+
+                    SetPixelBytesImpl(
+                        d2dBitmap,
+                        ToD2DRectU(left, top, width, height),
+                        buffer,
+                        &alphaMode);
                 });
         }
 
@@ -879,6 +1508,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 });
         }
 
+        IFACEMETHODIMP CopyPixelsFromBitmaps(
+            uint32_t bitmapCount,
+            ICanvasBitmap** bitmaps,
+            uint32_t destPointCount,
+            ABI::Windows::Graphics::PointInt32* destPoints,
+            uint32_t sourceRectCount,
+            BitmapBounds* sourceRects)
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    CopyPixelsFromBitmapsImpl(this, bitmapCount, bitmaps, destPointCount, destPoints, sourceRectCount, sourceRects);
+                });
+        }
+
     private:
         static D2D1_RECT_U GetResourceBitmapExtents(ComPtr<ID2D1Bitmap1> const& d2dBitmap)
         {
@@ -901,13 +1545,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ICanvasDevice* canvasDevice,
             HSTRING fileName,
             float dpi,
-            CanvasAlphaMode alpha);
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize = BitmapSize{},
+            DirectXPixelFormat format = PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            BitmapBounds sourceRectangle = BitmapBounds{});
 
         static ComPtr<CanvasBitmap> CreateNew(
             ICanvasDevice* canvasDevice,
             IStream* fileStream,
             float dpi,
-            CanvasAlphaMode alpha);
+            CanvasAlphaMode alpha,
+            BitmapSize maximumSize = BitmapSize{},
+            DirectXPixelFormat format = PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            BitmapBounds sourceRectangle = BitmapBounds{});
 
         static ComPtr<CanvasBitmap> CreateNew(
             ICanvasDevice* device,
@@ -928,6 +1578,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             float dpi,
             CanvasAlphaMode alpha);
 
+        static ComPtr<CanvasBitmap> CreateNew(
+            ICanvasDevice* device,
+            uint32_t byteCount,
+            BYTE* bytes,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            CanvasBitmapSourceLayout layout,
+            float dpi);
+
 #if WINVER > _WIN32_WINNT_WINBLUE
 
         static ComPtr<CanvasBitmap> CreateNew(
@@ -0,0 +1,335 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasBitmapAtlas.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    BitmapAtlasLayout::BitmapAtlasLayout(std::vector<D2D1_SIZE_U> const& bitmapSizes, uint32_t maximumSize)
+        : m_size{ 0, 0 }
+        , m_positions(bitmapSizes.size())
+    {
+        uint64_t totalArea = 0;
+        uint32_t widestBitmap = 0;
+        uint32_t tallestBitmap = 0;
+
+        for (auto& size : bitmapSizes)
+        {
+            totalArea += static_cast<uint64_t>(size.width + Padding) * (size.height + Padding);
+            widestBitmap = std::max(widestBitmap, size.width);
+            tallestBitmap = std::max(tallestBitmap, size.height);
+        }
+
+        if (widestBitmap > maximumSize || tallestBitmap > maximumSize)
+            ThrowHR(E_INVALIDARG, Strings::BitmapAtlasTooLarge);
+
+        std::vector<uint32_t> order(bitmapSizes.size());
+
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+
+        std::stable_sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t b)
+            {
+                if (bitmapSizes[a].height != bitmapSizes[b].height)
+                    return bitmapSizes[a].height > bitmapSizes[b].height;
+
+                return bitmapSizes[a].width > bitmapSizes[b].width;
+            });
+
+        auto width = std::max(widestBitmap, static_cast<uint32_t>(ceil(sqrt(static_cast<double>(totalArea)))));
+        width = std::min(width, maximumSize);
+
+        Pack(bitmapSizes, order, width);
+
+        if (m_size.height > maximumSize && width < maximumSize)
+            Pack(bitmapSizes, order, maximumSize);
+
+        if (m_size.height > maximumSize)
+            ThrowHR(E_INVALIDARG, Strings::BitmapAtlasTooLarge);
+    }
+
+
+    void BitmapAtlasLayout::Pack(std::vector<D2D1_SIZE_U> const& bitmapSizes, std::vector<uint32_t> const& order, uint32_t width)
+    {
+        m_size = D2D1_SIZE_U{ 0, 0 };
+
+        // Every bitmap takes up Padding extra pixels to its right and below
+        // it.  Widening the skyline by the same amount lets the rightmost
+        // bitmaps reach the edge without leaving a gap.
+        std::vector<SkylineSegment> skyline{ SkylineSegment{ 0, 0, width + Padding } };
+
+        for (auto index : order)
+        {
+            auto& size = bitmapSizes[index];
+
+            if (size.width == 0 || size.height == 0)
+            {
+                m_positions[index] = D2D1_POINT_2U{ 0, 0 };
+                continue;
+            }
+
+            auto paddedWidth = size.width + Padding;
+            auto paddedHeight = size.height + Padding;
+
+            size_t bestSegment = 0;
+            uint32_t bestX = 0;
+            uint32_t bestY = UINT32_MAX;
+
+            for (size_t i = 0; i < skyline.size(); i++)
+            {
+                auto x = skyline[i].X;
+
+                if (x + paddedWidth > width + Padding)
+                    break;
+
+                // The bitmap rests on the highest segment beneath it.
+                uint32_t y = 0;
+                uint32_t remaining = paddedWidth;
+
+                for (size_t j = i; remaining > 0; j++)
+                {
+                    y = std::max(y, skyline[j].Y);
+                    remaining -= std::min(remaining, skyline[j].Width);
+                }
+
+                if (y < bestY)
+                {
+                    bestSegment = i;
+                    bestX = x;
+                    bestY = y;
+                }
+            }
+
+            m_positions[index] = D2D1_POINT_2U{ bestX, bestY };
+
+            m_size.width = std::max(m_size.width, bestX + size.width);
+            m_size.height = std::max(m_size.height, bestY + size.height);
+
+            // Raise the skyline over the new bitmap, trimming the segments it covers.
+            skyline.insert(skyline.begin() + bestSegment, SkylineSegment{ bestX, bestY + paddedHeight, paddedWidth });
+
+            auto right = bestX + paddedWidth;
+
+            while (bestSegment + 1 < skyline.size() && skyline[bestSegment + 1].X < right)
+            {
+                auto& next = skyline[bestSegment + 1];
+                auto overlap = right - next.X;
+
+                if (next.Width <= overlap)
+                {
+                    skyline.erase(skyline.begin() + bestSegment + 1);
+                }
+                else
+                {
+                    next.X += overlap;
+                    next.Width -= overlap;
+                    break;
+                }
+            }
+
+            // Merge neighbors at the same height.
+            for (size_t i = 0; i + 1 < skyline.size(); )
+            {
+                if (skyline[i].Y == skyline[i + 1].Y)
+                {
+                    skyline[i].Width += skyline[i + 1].Width;
+                    skyline.erase(skyline.begin() + i + 1);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+    }
+
+
+    ComPtr<CanvasBitmapAtlas> CanvasBitmapAtlas::CreateNew(
+        ICanvasResourceCreator* resourceCreator,
+        uint32_t bitmapCount,
+        ICanvasBitmap** bitmaps)
+    {
+        CheckInPointer(resourceCreator);
+        CheckInPointer(bitmaps);
+
+        if (bitmapCount == 0)
+            ThrowHR(E_INVALIDARG);
+
+        ComPtr<ICanvasDevice> device;
+        ThrowIfFailed(resourceCreator->get_Device(&device));
+
+        std::vector<D2D1_SIZE_U> pixelSizes;
+        pixelSizes.reserve(bitmapCount);
+
+        for (uint32_t i = 0; i < bitmapCount; i++)
+        {
+            CheckInPointer(bitmaps[i]);
+
+            pixelSizes.push_back(As<ICanvasBitmapInternal>(bitmaps[i])->GetD2DBitmap()->GetPixelSize());
+        }
+
+        int32_t maximumSize;
+        ThrowIfFailed(device->get_MaximumBitmapSizeInPixels(&maximumSize));
+
+        BitmapAtlasLayout layout(pixelSizes, static_cast<uint32_t>(maximumSize));
+
+        // The atlas takes the format of the first bitmap.  Render targets
+        // can't have straight alpha, so that becomes premultiplied; the
+        // pixels are copied as they are either way.
+        DirectXPixelFormat format;
+        ThrowIfFailed(bitmaps[0]->get_Format(&format));
+
+        CanvasAlphaMode alphaMode;
+        ThrowIfFailed(bitmaps[0]->get_AlphaMode(&alphaMode));
+
+        if (alphaMode == CanvasAlphaMode::Straight)
+            alphaMode = CanvasAlphaMode::Premultiplied;
+
+        auto size = layout.GetSize();
+
+        auto renderTarget = CanvasRenderTarget::CreateNew(
+            device.Get(),
+            static_cast<float>(size.width),
+            static_cast<float>(size.height),
+            DEFAULT_DPI,
+            format,
+            alphaMode);
+        CheckMakeResult(renderTarget);
+
+        // New render targets aren't cleared, and the padding must be transparent.
+        {
+            ComPtr<ICanvasDrawingSession> drawingSession;
+            ThrowIfFailed(renderTarget->CreateDrawingSession(&drawingSession));
+            ThrowIfFailed(drawingSession->Clear(Color{ 0, 0, 0, 0 }));
+            ThrowIfFailed(As<IClosable>(drawingSession)->Close());
+        }
+
+        std::vector<ABI::Windows::Graphics::PointInt32> destPoints;
+        std::vector<Rect> sourceRects;
+
+        destPoints.reserve(bitmapCount);
+        sourceRects.reserve(bitmapCount);
+
+        for (uint32_t i = 0; i < bitmapCount; i++)
+        {
+            auto position = layout.GetPosition(i);
+
+            destPoints.push_back(ABI::Windows::Graphics::PointInt32{ static_cast<int32_t>(position.x), static_cast<int32_t>(position.y) });
+
+            sourceRects.push_back(Rect
+            {
+                static_cast<float>(position.x),
+                static_cast<float>(position.y),
+                static_cast<float>(pixelSizes[i].width),
+                static_cast<float>(pixelSizes[i].height)
+            });
+        }
+
+        CopyPixelsFromBitmapsImpl(
+            As<ICanvasBitmap>(renderTarget).Get(),
+            bitmapCount,
+            bitmaps,
+            bitmapCount,
+            destPoints.data(),
+            0,
+            nullptr);
+
+        auto atlas = Make<CanvasBitmapAtlas>(renderTarget.Get(), std::move(sourceRects));
+        CheckMakeResult(atlas);
+
+        return atlas;
+    }
+
+
+    CanvasBitmapAtlas::CanvasBitmapAtlas(
+        ICanvasRenderTarget* renderTarget,
+        std::vector<Rect>&& sourceRects)
+        : m_renderTarget(renderTarget)
+        , m_sourceRects(std::move(sourceRects))
+    {
+    }
+
+
+    IFACEMETHODIMP CanvasBitmapAtlas::get_RenderTarget(ICanvasRenderTarget** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                ThrowIfFailed(m_renderTarget.CopyTo(value));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasBitmapAtlas::get_Count(uint32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = static_cast<uint32_t>(m_sourceRects.size());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasBitmapAtlas::GetSourceRect(
+        uint32_t index,
+        Rect* sourceRect)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(sourceRect);
+
+                if (index >= m_sourceRects.size())
+                    ThrowHR(E_BOUNDS);
+
+                *sourceRect = m_sourceRects[index];
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasBitmapAtlas::GetSourceRects(
+        uint32_t* sourceRectsCount,
+        Rect** sourceRects)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(sourceRectsCount);
+                CheckAndClearOutPointer(sourceRects);
+
+                ComArray<Rect> array(m_sourceRects.begin(), m_sourceRects.end());
+                array.Detach(sourceRectsCount, sourceRects);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasBitmapAtlasFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        uint32_t bitmapCount,
+        ICanvasBitmap** bitmaps,
+        ICanvasBitmapAtlas** atlas)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(atlas);
+
+                auto newAtlas = CanvasBitmapAtlas::CreateNew(resourceCreator, bitmapCount, bitmaps);
+
+                ThrowIfFailed(newAtlas.CopyTo(atlas));
+            });
+    }
+
+
+    ActivatableStaticOnlyFactory(CanvasBitmapAtlasFactory);
+}}}}
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // Skyline packing of bitmap sizes, in pixels, into one bitmap.  The
+    // skyline is the top edge of everything placed so far; each bitmap, in
+    // order of decreasing height, goes as near the top as it will fit,
+    // leftmost first.  Unlike rows, this fills in the gaps left
+    // beside short bitmaps, so mixed sizes waste less space.  The width is
+    // roughly the square root of the total area, so the bitmap comes out
+    // close to square, falling back to the full width if that is too tall.
+    // Bitmaps are separated by Padding transparent pixels, so linear
+    // filtering at their edges doesn't pick up their neighbors.
+    //
+    class BitmapAtlasLayout
+    {
+        struct SkylineSegment
+        {
+            uint32_t X;
+            uint32_t Y;
+            uint32_t Width;
+        };
+
+        D2D1_SIZE_U m_size;
+        std::vector<D2D1_POINT_2U> m_positions;
+
+    public:
+        static const uint32_t Padding = 1;
+
+        // Throws if the bitmaps don't fit within maximumSize in both dimensions.
+        BitmapAtlasLayout(std::vector<D2D1_SIZE_U> const& bitmapSizes, uint32_t maximumSize);
+
+        D2D1_SIZE_U GetSize() const { return m_size; }
+
+        D2D1_POINT_2U GetPosition(uint32_t index) const { return m_positions[index]; }
+
+    private:
+        // Places bitmaps in the given order within the given width.
+        void Pack(std::vector<D2D1_SIZE_U> const& bitmapSizes, std::vector<uint32_t> const& order, uint32_t width);
+    };
+
+
+    class CanvasBitmapAtlas : public RuntimeClass<ICanvasBitmapAtlas>,
+                              private LifespanTracker<CanvasBitmapAtlas>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasBitmapAtlas, BaseTrust);
+
+        ComPtr<ICanvasRenderTarget> m_renderTarget;
+        std::vector<Rect> m_sourceRects;
+
+    public:
+        static ComPtr<CanvasBitmapAtlas> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t bitmapCount,
+            ICanvasBitmap** bitmaps);
+
+        CanvasBitmapAtlas(
+            ICanvasRenderTarget* renderTarget,
+            std::vector<Rect>&& sourceRects);
+
+        IFACEMETHOD(get_RenderTarget)(ICanvasRenderTarget** value) override;
+
+        IFACEMETHOD(get_Count)(uint32_t* value) override;
+
+        IFACEMETHOD(GetSourceRect)(
+            uint32_t index,
+            Rect* sourceRect) override;
+
+        IFACEMETHOD(GetSourceRects)(
+            uint32_t* sourceRectsCount,
+            Rect** sourceRects) override;
+    };
+
+
+    class CanvasBitmapAtlasFactory
+        : public AgileActivationFactory<ICanvasBitmapAtlasStatics>
+        , private LifespanTracker<CanvasBitmapAtlasFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasBitmapAtlas, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t bitmapCount,
+            ICanvasBitmap** bitmaps,
+            ICanvasBitmapAtlas** atlas) override;
+    };
+}}}}
@@ -5,6 +5,8 @@
 #include "pch.h"
 
 #include "CanvasCommandList.h"
+#include "utils/LockUtilities.h"
+#include "utils/ParallelFor.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -31,6 +33,161 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    IFACEMETHODIMP CanvasCommandListFactory::CreateFromSerializedBytes(
+        ICanvasResourceCreator* resourceCreator,
+        uint32_t byteCount,
+        uint8_t* bytes,
+        ICanvasCommandList** commandList)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(bytes);
+                CheckAndClearOutPointer(commandList);
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto d2dCommandList = DeserializeCommandList(device.Get(), bytes, byteCount);
+
+                auto cl = Make<CanvasCommandList>(device.Get(), d2dCommandList.Get(), false);
+                CheckMakeResult(cl);
+
+                ThrowIfFailed(cl.CopyTo(commandList));
+#else
+                ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);
+#endif
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasCommandListFactory::CreateFromSerializedBuffer(
+        ICanvasResourceCreator* resourceCreator,
+        IBuffer* buffer,
+        ICanvasCommandList** commandList)
+    {
+        using ::Windows::Storage::Streams::IBufferByteAccess;
+
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(buffer);
+
+                auto byteAccess = As<IBufferByteAccess>(buffer);
+
+                uint32_t byteCount;
+                uint8_t* bytes;
+
+                ThrowIfFailed(buffer->get_Length(&byteCount));
+                ThrowIfFailed(byteAccess->Buffer(&bytes));
+
+                // The buffer is read in place, so a memory mapped file is never copied.
+                ThrowIfFailed(CreateFromSerializedBytes(resourceCreator, byteCount, bytes, commandList));
+            });
+    }
+
+
+    //
+    // ParallelCommandListRecorder hands the parts out to a number of
+    // threadpool workers, each of which records them one at a time into
+    // command lists of their own, on their own device contexts.  The async
+    // operation's thread records a share of the parts too, and once everyone
+    // is done it draws the parts, in order, into one command list.
+    //
+
+    class ParallelCommandListRecorder
+    {
+        ComPtr<ICanvasDevice> m_device;
+        ComPtr<ICanvasCommandListRecordingHandler> m_handler;
+
+        std::vector<ComPtr<CanvasCommandList>> m_parts;
+
+    public:
+        ParallelCommandListRecorder(ICanvasDevice* device, uint32_t partCount, ICanvasCommandListRecordingHandler* handler)
+            : m_device(device)
+            , m_handler(handler)
+            , m_parts(partCount)
+        {
+        }
+
+        // Runs on the async operation's worker thread, and returns once every
+        // part has been recorded.  Fails with the first error any of the
+        // workers ran into.
+        ComPtr<CanvasCommandList> Run(uint32_t maximumParallelism)
+        {
+            ThrowIfFailed(ParallelFor(static_cast<uint32_t>(m_parts.size()), maximumParallelism,
+                [&](uint32_t index)
+                {
+                    // Only the share of the parts recorded on the async operation's own
+                    // thread notices cancellation, but failing abandons the other workers too.
+                    AsyncCancellation::ThrowIfCanceled();
+
+                    auto part = CanvasCommandList::CreateNew(m_device.Get());
+
+                    ComPtr<ICanvasDrawingSession> drawingSession;
+                    ThrowIfFailed(part->CreateDrawingSession(&drawingSession));
+
+                    ThrowIfFailed(m_handler->Invoke(drawingSession.Get(), static_cast<int32_t>(index)));
+
+                    ThrowIfFailed(As<IClosable>(drawingSession)->Close());
+
+                    m_parts[index] = std::move(part);
+                }));
+
+            auto commandList = CanvasCommandList::CreateNew(m_device.Get());
+
+            ComPtr<ICanvasDrawingSession> drawingSession;
+            ThrowIfFailed(commandList->CreateDrawingSession(&drawingSession));
+
+            for (auto& part : m_parts)
+            {
+                ThrowIfFailed(drawingSession->DrawImageAtOrigin(part.Get()));
+            }
+
+            ThrowIfFailed(As<IClosable>(drawingSession)->Close());
+
+            return commandList;
+        }
+    };
+
+
+    IFACEMETHODIMP CanvasCommandListFactory::RecordInParallelAsync(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t partCount,
+        ICanvasCommandListRecordingHandler* handler,
+        IAsyncOperation<CanvasCommandList*>** commandList)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckInPointer(handler);
+                CheckAndClearOutPointer(commandList);
+
+                if (partCount < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto parallelism = AsyncScheduler::GetInstance().LimitParallelism(std::max(std::thread::hardware_concurrency(), 1U));
+
+                auto recorder = std::make_shared<ParallelCommandListRecorder>(device.Get(), static_cast<uint32_t>(partCount), handler);
+
+                auto asyncOperation = Make<AsyncOperation<CanvasCommandList>>(
+                    [=]
+                    {
+                        return recorder->Run(parallelism);
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(commandList));
+            });
+    }
+
+
     //
     // CanvasCommandList
     //
@@ -56,6 +213,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         , m_d2dCommandListIsClosed(false)
         , m_hasInteropBeenUsed(hasInteropBeenUsed)
         , m_hasActiveDrawingSession(std::make_shared<bool>())
+        , m_isSpatialIndexEnabled(false)
+#if WINVER > _WIN32_WINNT_WINBLUE
+        , m_hasBuiltSpatialIndex(false)
+        , m_culledRectangle{}
+#endif
     {
     }
 
@@ -102,6 +264,55 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    IFACEMETHODIMP CanvasCommandList::get_IsSpatialIndexEnabled(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_isSpatialIndexEnabled;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasCommandList::put_IsSpatialIndexEnabled(boolean value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                m_isSpatialIndexEnabled = !!value;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasCommandList::GetSerializedBytes(
+        uint32_t* valueCount,
+        uint8_t** valueElements)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(valueCount);
+                CheckAndClearOutPointer(valueElements);
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+                auto& device = m_device.EnsureNotClosed();
+
+                // The command list has to be closed before it can be streamed.
+                auto d2dCommandList = As<ID2D1CommandList>(GetD2DImage(device.Get(), nullptr, GetImageFlags::None, 0, nullptr));
+
+                auto bytes = SerializeCommandList(device.Get(), d2dCommandList.Get());
+
+                ComArray<BYTE> array(bytes.begin(), bytes.end());
+                array.Detach(valueCount, valueElements);
+#else
+                ThrowHR(E_NOTIMPL, Strings::NotSupportedOnThisVersionOfWindows);
+#endif
+            });
+    }
+
+
     IFACEMETHODIMP CanvasCommandList::Close()
     {
         m_device.Close();
@@ -113,7 +324,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ICanvasResourceCreator* resourceCreator,
         Rect* bounds)
     {
-        return GetImageBoundsImpl(this, resourceCreator, nullptr, bounds);
+        return GetImageBoundsImpl(this, resourceCreator, nullptr, bounds, &m_cachedBounds);
     }
 
 
@@ -122,7 +333,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         Numerics::Matrix3x2 transform,
         Rect* bounds)
     {
-        return GetImageBoundsImpl(this, resourceCreator, &transform, bounds);
+        return GetImageBoundsImpl(this, resourceCreator, &transform, bounds, &m_cachedBounds);
     }
 
     bool IsD2DCommandListClosed(
@@ -176,6 +387,61 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return commandList;
     }
 
+    ComPtr<ID2D1Image> CanvasCommandList::GetCulledD2DImage(
+        ICanvasDevice* device,
+        ID2D1DeviceContext* deviceContext,
+        D2D1_RECT_F const& visibleRectangle)
+    {
+#if WINVER > _WIN32_WINNT_WINBLUE
+        if (!m_isSpatialIndexEnabled || deviceContext->GetUnitMode() != D2D1_UNIT_MODE_DIPS)
+            return nullptr;
+
+        // Make sure the command list is closed before trying to stream it.
+        auto d2dCommandList = As<ID2D1CommandList>(GetD2DImage(device, deviceContext, GetImageFlags::None, 0, nullptr));
+
+        auto lock = Lock(m_spatialIndexMutex);
+
+        if (!m_hasBuiltSpatialIndex)
+        {
+            auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+            m_spatialIndex = CommandListSpatialIndex::Create(d2dCommandList.Get(), lease.Get());
+            m_hasBuiltSpatialIndex = true;
+        }
+
+        if (!m_spatialIndex || m_spatialIndex->IsEntirelyInside(visibleRectangle))
+            return nullptr;
+
+        // Drawing the same part of the command list repeatedly reuses the previous culling.
+        bool isSameRectangle = m_culledCommandList &&
+                               m_culledRectangle.left == visibleRectangle.left &&
+                               m_culledRectangle.top == visibleRectangle.top &&
+                               m_culledRectangle.right == visibleRectangle.right &&
+                               m_culledRectangle.bottom == visibleRectangle.bottom;
+
+        if (!isSameRectangle)
+        {
+            m_culledCommandList.Reset();
+
+            auto culledCommandList = As<ICanvasDeviceInternal>(device)->CreateCommandList();
+            auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+
+            m_spatialIndex->RecordCulledCommands(d2dCommandList.Get(), culledCommandList.Get(), lease.Get(), visibleRectangle);
+
+            m_culledCommandList = culledCommandList;
+            m_culledRectangle = visibleRectangle;
+        }
+
+        return m_culledCommandList;
+#else
+        UNREFERENCED_PARAMETER(device);
+        UNREFERENCED_PARAMETER(deviceContext);
+        UNREFERENCED_PARAMETER(visibleRectangle);
+
+        return nullptr;
+#endif
+    }
+
+
     IFACEMETHODIMP CanvasCommandList::GetNativeResource(ICanvasDevice* device, float dpi, REFIID iid, void** outResource)
     {
         m_hasInteropBeenUsed = true;
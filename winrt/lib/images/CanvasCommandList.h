@@ -4,14 +4,31 @@
 
 #pragma once
 
+#include "CommandListSerializer.h"
+#include "CommandListSpatialIndex.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
+    class __declspec(uuid("6A0E2B4D-93C1-4E27-8F5B-1D7C3A9E6B02"))
+    ICanvasCommandListInternal : public IUnknown
+    {
+    public:
+        // Returns a command list holding only the commands that intersect
+        // visibleRectangle, or null if the whole command list should be drawn.
+        virtual ComPtr<ID2D1Image> GetCulledD2DImage(
+            ICanvasDevice* device,
+            ID2D1DeviceContext* deviceContext,
+            D2D1_RECT_F const& visibleRectangle) = 0;
+    };
+
+
     class CanvasCommandList : RESOURCE_WRAPPER_RUNTIME_CLASS(
         ID2D1CommandList,
         CanvasCommandList,
         ICanvasCommandList,
         ICanvasImage,
         CloakedIid<ICanvasImageInternal>,
+        CloakedIid<ICanvasCommandListInternal>,
         CloakedIid<ICanvasResourceWrapperWithDevice>,
         Effects::IGraphicsEffectSource)
     {
@@ -22,6 +39,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         bool m_hasInteropBeenUsed;
         std::shared_ptr<bool> m_hasActiveDrawingSession;
 
+        // Measuring the bounds closes the command list, after which its contents can't change.
+        CachedImageBounds m_cachedBounds;
+
+        bool m_isSpatialIndexEnabled;
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+        // The index is built the first time a culled image is requested, since
+        // the command list has to be closed before it can be streamed.
+        std::mutex m_spatialIndexMutex;
+        bool m_hasBuiltSpatialIndex;
+        std::unique_ptr<CommandListSpatialIndex> m_spatialIndex;
+        D2D1_RECT_F m_culledRectangle;
+        ComPtr<ID2D1CommandList> m_culledCommandList;
+#endif
+
     public:
         static ComPtr<CanvasCommandList> CreateNew(
             ICanvasDevice* device);
@@ -38,6 +70,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
 
+        IFACEMETHOD(get_IsSpatialIndexEnabled)(boolean* value) override;
+        IFACEMETHOD(put_IsSpatialIndexEnabled)(boolean value) override;
+
+        IFACEMETHOD(GetSerializedBytes)(
+            uint32_t* valueCount,
+            uint8_t** valueElements) override;
+
         // IClosable
 
         IFACEMETHOD(Close)() override;
@@ -64,6 +103,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             float targetDpi,
             float* realizedDpi) override;
 
+        // ICanvasCommandListInternal
+
+        virtual ComPtr<ID2D1Image> GetCulledD2DImage(
+            ICanvasDevice* device,
+            ID2D1DeviceContext* deviceContext,
+            D2D1_RECT_F const& visibleRectangle) override;
+
         // ResourceWrapper
 
         IFACEMETHOD(GetNativeResource)(ICanvasDevice* device, float dpi, REFIID iid, void** outResource) override;
@@ -71,7 +117,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
 
     class CanvasCommandListFactory
-        : public AgileActivationFactory<ICanvasCommandListFactory>
+        : public AgileActivationFactory<ICanvasCommandListFactory, ICanvasCommandListStatics>
         , private LifespanTracker<CanvasCommandListFactory>
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasCommandList, BaseTrust);
@@ -80,5 +126,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(Create)(
             ICanvasResourceCreator* resourceCreator,
             ICanvasCommandList** commandList) override;
+
+        //
+        // ICanvasCommandListStatics
+        //
+
+        IFACEMETHOD(CreateFromSerializedBytes)(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t byteCount,
+            uint8_t* bytes,
+            ICanvasCommandList** commandList) override;
+
+        IFACEMETHOD(CreateFromSerializedBuffer)(
+            ICanvasResourceCreator* resourceCreator,
+            IBuffer* buffer,
+            ICanvasCommandList** commandList) override;
+
+        IFACEMETHOD(RecordInParallelAsync)(
+            ICanvasResourceCreator* resourceCreator,
+            int32_t partCount,
+            ICanvasCommandListRecordingHandler* handler,
+            IAsyncOperation<CanvasCommandList*>** commandList) override;
     };
 }}}}
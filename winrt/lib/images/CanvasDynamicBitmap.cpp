@@ -0,0 +1,423 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasDynamicBitmap.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasDynamicBitmapFactory
+    //
+
+    IFACEMETHODIMP CanvasDynamicBitmapFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        DirectXPixelFormat format,
+        CanvasAlphaMode alpha,
+        ICanvasDynamicBitmap** dynamicBitmap)
+    {
+        return CreateWithBufferCount(
+            resourceCreator,
+            widthInPixels,
+            heightInPixels,
+            format,
+            alpha,
+            CanvasDynamicBitmap::DefaultBufferCount,
+            dynamicBitmap);
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmapFactory::CreateWithBufferCount(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        DirectXPixelFormat format,
+        CanvasAlphaMode alpha,
+        int32_t bufferCount,
+        ICanvasDynamicBitmap** dynamicBitmap)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(dynamicBitmap);
+
+                auto bitmap = CanvasDynamicBitmap::CreateNew(
+                    resourceCreator,
+                    widthInPixels,
+                    heightInPixels,
+                    format,
+                    alpha,
+                    bufferCount);
+
+                ThrowIfFailed(bitmap.CopyTo(dynamicBitmap));
+            });
+    }
+
+
+    //
+    // CanvasDynamicBitmap
+    //
+
+    static bool IsEmpty(D2D1_RECT_U const& rect)
+    {
+        return rect.right <= rect.left || rect.bottom <= rect.top;
+    }
+
+    static bool Contains(D2D1_RECT_U const& outer, D2D1_RECT_U const& inner)
+    {
+        return inner.left >= outer.left &&
+               inner.top >= outer.top &&
+               inner.right <= outer.right &&
+               inner.bottom <= outer.bottom;
+    }
+
+    static void UnionInto(D2D1_RECT_U& rect, D2D1_RECT_U const& other)
+    {
+        if (IsEmpty(rect))
+        {
+            rect = other;
+        }
+        else
+        {
+            rect.left = std::min(rect.left, other.left);
+            rect.top = std::min(rect.top, other.top);
+            rect.right = std::max(rect.right, other.right);
+            rect.bottom = std::max(rect.bottom, other.bottom);
+        }
+    }
+
+    ComPtr<CanvasDynamicBitmap> CanvasDynamicBitmap::CreateNew(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t widthInPixels,
+        int32_t heightInPixels,
+        DirectXPixelFormat format,
+        CanvasAlphaMode alpha,
+        int32_t bufferCount)
+    {
+        if (widthInPixels <= 0 || heightInPixels <= 0 || bufferCount < 1)
+            ThrowHR(E_INVALIDARG);
+
+        // Updates are written a pixel at a time, so block compressed formats
+        // can't be used.
+        if (GetBlockSize(static_cast<DXGI_FORMAT>(format)) != 1)
+            ThrowHR(E_INVALIDARG);
+
+        auto device = GetCanvasDevice(resourceCreator);
+
+        auto dynamicBitmap = Make<CanvasDynamicBitmap>(
+            device.Get(),
+            BitmapSize{ static_cast<uint32_t>(widthInPixels), static_cast<uint32_t>(heightInPixels) },
+            format,
+            alpha,
+            bufferCount);
+        CheckMakeResult(dynamicBitmap);
+
+        return dynamicBitmap;
+    }
+
+    CanvasDynamicBitmap::CanvasDynamicBitmap(
+        ICanvasDevice* device,
+        BitmapSize size,
+        DirectXPixelFormat format,
+        CanvasAlphaMode alpha,
+        int32_t bufferCount)
+        : m_device(device)
+        , m_size(size)
+        , m_format(format)
+        , m_alphaMode(alpha)
+        , m_bytesPerPixel(GetBytesPerBlock(static_cast<DXGI_FORMAT>(format)))
+        , m_buffers(bufferCount)
+        , m_currentBuffer(0)
+    {
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+
+        // Every buffer starts out cleared, so they all agree before the first update.
+        auto pitch = size.Width * m_bytesPerPixel;
+        std::vector<uint8_t> zeroes(static_cast<size_t>(pitch) * size.Height);
+
+        for (auto& buffer : m_buffers)
+        {
+            buffer.Bitmap = deviceInternal->CreateBitmapFromBytes(
+                zeroes.data(),
+                pitch,
+                static_cast<int32_t>(size.Width),
+                static_cast<int32_t>(size.Height),
+                DEFAULT_DPI,
+                format,
+                alpha);
+
+            buffer.StaleRect = D2D1_RECT_U{};
+            buffer.WasDrawn = false;
+        }
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::Close()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                Lock lock(m_mutex);
+
+                m_buffers.clear();
+                m_device.Reset();
+            });
+    }
+
+    void CanvasDynamicBitmap::ThrowIfClosed()
+    {
+        if (!m_device)
+            ThrowHR(RO_E_CLOSED);
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_SizeInPixels(BitmapSize* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_size;
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_Size(Size* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                // Always 96 DPI, so DIPs are pixels.
+                *value = Size{ static_cast<float>(m_size.Width), static_cast<float>(m_size.Height) };
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_Bounds(Rect* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = Rect{ 0, 0, static_cast<float>(m_size.Width), static_cast<float>(m_size.Height) };
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_Format(DirectXPixelFormat* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_format;
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_AlphaMode(CanvasAlphaMode* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_alphaMode;
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::get_BufferCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                *value = static_cast<int32_t>(m_buffers.size());
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::SetPixelBytes(
+        uint32_t valueCount,
+        uint8_t* valueElements)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                SetPixelBytesImpl(valueCount, valueElements, D2D1_RECT_U{ 0, 0, m_size.Width, m_size.Height });
+            });
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::SetPixelBytesWithSubrectangle(
+        uint32_t valueCount,
+        uint8_t* valueElements,
+        int32_t left,
+        int32_t top,
+        int32_t width,
+        int32_t height)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                SetPixelBytesImpl(valueCount, valueElements, ToD2DRectU(left, top, width, height));
+            });
+    }
+
+    void CanvasDynamicBitmap::SetPixelBytesImpl(
+        uint32_t valueCount,
+        uint8_t* valueElements,
+        D2D1_RECT_U const& rect)
+    {
+        CheckInPointer(valueElements);
+
+        if (IsEmpty(rect) || rect.right > m_size.Width || rect.bottom > m_size.Height)
+            ThrowHR(E_INVALIDARG);
+
+        auto pitch = (rect.right - rect.left) * m_bytesPerPixel;
+        auto expectedArraySize = static_cast<uint64_t>(pitch) * (rect.bottom - rect.top);
+
+        if (valueCount < expectedArraySize)
+        {
+            WinStringBuilder message;
+            message.Format(Strings::WrongArrayLength, static_cast<uint32_t>(expectedArraySize), valueCount);
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        Lock lock(m_mutex);
+        ThrowIfClosed();
+
+        if (m_buffers.size() == 1)
+        {
+            // Nothing to rotate between, so D3D will have to wait for (or
+            // copy around) any drawing that still reads from the bitmap.
+            ThrowIfFailed(m_buffers[0].Bitmap->CopyFromMemory(&rect, valueElements, pitch));
+        }
+        else
+        {
+            FenceCurrentBuffer();
+
+            auto nextBuffer = ChooseNextBuffer();
+
+            auto& current = m_buffers[m_currentBuffer];
+            auto& next = m_buffers[nextBuffer];
+
+            // Bring the parts of the new buffer that this update isn't going
+            // to overwrite up to date, with a copy that stays on the GPU.
+            if (!IsEmpty(next.StaleRect) && !Contains(rect, next.StaleRect))
+            {
+                D2D1_POINT_2U destPoint{ next.StaleRect.left, next.StaleRect.top };
+                ThrowIfFailed(next.Bitmap->CopyFromBitmap(&destPoint, current.Bitmap.Get(), &next.StaleRect));
+            }
+
+            ThrowIfFailed(next.Bitmap->CopyFromMemory(&rect, valueElements, pitch));
+
+            next.StaleRect = D2D1_RECT_U{};
+            next.Fence.Reset();
+
+            for (size_t i = 0; i < m_buffers.size(); i++)
+            {
+                if (i != nextBuffer)
+                    UnionInto(m_buffers[i].StaleRect, rect);
+            }
+
+            m_currentBuffer = nextBuffer;
+
+            // Effects and image brushes drawing us still hold the old buffer.
+            InvalidateRealizedImageGraphs();
+        }
+
+        PerformanceCounters::Increment(PerformanceCounter::BitmapBytesUploaded, expectedArraySize);
+    }
+
+    // Must be called with m_mutex held.
+    size_t CanvasDynamicBitmap::ChooseNextBuffer()
+    {
+        auto bufferCount = m_buffers.size();
+
+        // Buffers are tried oldest first.
+        for (size_t i = 1; i < bufferCount; i++)
+        {
+            auto index = (m_currentBuffer + i) % bufferCount;
+            auto& fence = m_buffers[index].Fence;
+
+            if (!fence)
+                return index;
+
+            boolean isCompleted;
+            ThrowIfFailed(fence->get_IsCompleted(&isCompleted));
+
+            if (isCompleted)
+                return index;
+        }
+
+        // The GPU is more than BufferCount frames behind, so reuse the oldest
+        // buffer and let D3D deal with the drawing still reading from it.
+        return (m_currentBuffer + 1) % bufferCount;
+    }
+
+    // Must be called with m_mutex held.
+    void CanvasDynamicBitmap::FenceCurrentBuffer()
+    {
+        auto& current = m_buffers[m_currentBuffer];
+
+        if (!current.WasDrawn)
+            return;
+
+        auto d2dDevice = As<ICanvasDeviceInternal>(m_device)->GetD2DDevice();
+        auto d3dDevice = GetDXGIInterface<ID3D11Device>(m_device.Get());
+
+        auto fence = Make<CanvasGpuFence>(d2dDevice.Get(), d3dDevice.Get());
+        CheckMakeResult(fence);
+
+        current.Fence = fence;
+        current.WasDrawn = false;
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::GetBounds(ICanvasResourceCreator* resourceCreator, Rect* bounds)
+    {
+        return GetImageBoundsImpl(this, resourceCreator, nullptr, bounds);
+    }
+
+    IFACEMETHODIMP CanvasDynamicBitmap::GetBoundsWithTransform(ICanvasResourceCreator* resourceCreator, Numerics::Matrix3x2 transform, Rect* bounds)
+    {
+        return GetImageBoundsImpl(this, resourceCreator, &transform, bounds);
+    }
+
+    ComPtr<ID2D1Image> CanvasDynamicBitmap::GetD2DImage(ICanvasDevice*, ID2D1DeviceContext*, GetImageFlags, float, float* realizedDpi)
+    {
+        if (realizedDpi)
+            *realizedDpi = DEFAULT_DPI;
+
+        Lock lock(m_mutex);
+        ThrowIfClosed();
+
+        // The fence is inserted by the next update rather than here, since
+        // the drawing isn't submitted to the GPU until the session ends.
+        auto& current = m_buffers[m_currentBuffer];
+        current.WasDrawn = true;
+
+        return current.Bitmap;
+    }
+}}}}
+
+ActivatableClassWithFactory(CanvasDynamicBitmap, CanvasDynamicBitmapFactory);
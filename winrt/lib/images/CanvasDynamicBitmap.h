@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "drawing/CanvasGpuFence.h"
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    class CanvasDynamicBitmapFactory
+        : public AgileActivationFactory<ICanvasDynamicBitmapStatics>
+        , private LifespanTracker<CanvasDynamicBitmapFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasDynamicBitmap, BaseTrust);
+
+    public:
+        IFACEMETHODIMP Create(
+            ICanvasResourceCreator* resourceCreator,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            CanvasAlphaMode alpha,
+            ICanvasDynamicBitmap** dynamicBitmap) override;
+
+        IFACEMETHODIMP CreateWithBufferCount(
+            ICanvasResourceCreator* resourceCreator,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            CanvasAlphaMode alpha,
+            int32_t bufferCount,
+            ICanvasDynamicBitmap** dynamicBitmap) override;
+    };
+
+
+    class CanvasDynamicBitmap
+        : public RuntimeClass<
+            ICanvasDynamicBitmap,
+            ICanvasImage,
+            IGraphicsEffectSource,
+            IClosable,
+            CloakedIid<ICanvasImageInternal>>
+        , private LifespanTracker<CanvasDynamicBitmap>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasDynamicBitmap, BaseTrust);
+
+        struct Buffer
+        {
+            ComPtr<ID2D1Bitmap1> Bitmap;
+
+            // The union of the updates made since this buffer was last
+            // current, which it is missing.  Empty when right == 0.
+            D2D1_RECT_U StaleRect;
+
+            // Set once the buffer has been handed out for drawing, so it
+            // needs a fence before it is next written to.
+            bool WasDrawn;
+
+            // Signalled when the GPU has finished the last drawing that read
+            // from the buffer.  This only decides which buffer to write to
+            // next: D2D keeps the results right even if we guess wrong, it
+            // just has to wait for the GPU to do so.
+            ComPtr<CanvasGpuFence> Fence;
+        };
+
+        std::mutex m_mutex;
+
+        ComPtr<ICanvasDevice> m_device;
+        BitmapSize m_size;
+        DirectXPixelFormat m_format;
+        CanvasAlphaMode m_alphaMode;
+        uint32_t m_bytesPerPixel;
+
+        std::vector<Buffer> m_buffers;
+        size_t m_currentBuffer;
+
+    public:
+        static const int32_t DefaultBufferCount = 3;
+
+        static ComPtr<CanvasDynamicBitmap> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            CanvasAlphaMode alpha,
+            int32_t bufferCount);
+
+        CanvasDynamicBitmap(
+            ICanvasDevice* device,
+            BitmapSize size,
+            DirectXPixelFormat format,
+            CanvasAlphaMode alpha,
+            int32_t bufferCount);
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+        // ICanvasDynamicBitmap
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+        IFACEMETHOD(get_SizeInPixels)(BitmapSize* value) override;
+        IFACEMETHOD(get_Size)(Size* value) override;
+        IFACEMETHOD(get_Bounds)(Rect* value) override;
+        IFACEMETHOD(get_Format)(DirectXPixelFormat* value) override;
+        IFACEMETHOD(get_AlphaMode)(CanvasAlphaMode* value) override;
+        IFACEMETHOD(get_BufferCount)(int32_t* value) override;
+
+        IFACEMETHOD(SetPixelBytes)(
+            uint32_t valueCount,
+            uint8_t* valueElements) override;
+
+        IFACEMETHOD(SetPixelBytesWithSubrectangle)(
+            uint32_t valueCount,
+            uint8_t* valueElements,
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height) override;
+
+        // ICanvasImage
+        IFACEMETHOD(GetBounds)(ICanvasResourceCreator*, Rect*) override;
+        IFACEMETHOD(GetBoundsWithTransform)(ICanvasResourceCreator*, Numerics::Matrix3x2, Rect*) override;
+
+        // ICanvasImageInternal
+        ComPtr<ID2D1Image> GetD2DImage(ICanvasDevice*, ID2D1DeviceContext*, GetImageFlags, float, float*) override;
+
+    private:
+        void ThrowIfClosed();
+        void SetPixelBytesImpl(uint32_t valueCount, uint8_t* valueElements, D2D1_RECT_U const& rect);
+        size_t ChooseNextBuffer();
+        void FenceCurrentBuffer();
+    };
+}}}}
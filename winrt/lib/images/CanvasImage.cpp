@@ -4,6 +4,10 @@
 
 #include "pch.h"
 
+#include "ImageStatistics.h"
+#include "ScopedBitmapMappedPixelAccess.h"
+#include "utils/LockUtilities.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     using namespace ABI::Windows::Foundation;
@@ -23,16 +27,98 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
     }
     
+    // Starts at 1 so a zero CachedImageBounds::m_generation never matches.
+    static std::atomic<uint64_t> s_imageBoundsGeneration(1);
+
+
+    void InvalidateCachedImageBounds()
+    {
+        ++s_imageBoundsGeneration;
+    }
+
+
+    void InvalidateRealizedImageGraphs()
+    {
+        Effects::CanvasEffect::InvalidateRealizedGraphs();
+    }
+
+
+    uint64_t CachedImageBounds::CurrentGeneration()
+    {
+        return s_imageBoundsGeneration.load();
+    }
+
+
+    static bool IsSameTransform(Numerics::Matrix3x2 const& a, Numerics::Matrix3x2 const& b)
+    {
+        return a.M11 == b.M11 && a.M12 == b.M12 &&
+               a.M21 == b.M21 && a.M22 == b.M22 &&
+               a.M31 == b.M31 && a.M32 == b.M32;
+    }
+
+
+    bool CachedImageBounds::TryGet(ICanvasDevice* device, ID2D1DeviceContext* deviceContext, Numerics::Matrix3x2 const& transform, Rect* bounds)
+    {
+        auto lock = Lock(m_mutex);
+
+        if (m_generation != s_imageBoundsGeneration)
+            return false;
+
+        // Bounds are reported in the DPI and unit mode of the context they were measured with.
+        if (GetDpi(deviceContext) != m_dpi ||
+            deviceContext->GetUnitMode() != m_unitMode ||
+            !IsSameTransform(transform, m_transform))
+        {
+            return false;
+        }
+
+        auto cachedDevice = LockWeakRef<ICanvasDevice>(m_device);
+
+        if (!IsSameInstance(cachedDevice.Get(), device))
+            return false;
+
+        *bounds = m_bounds;
+        return true;
+    }
+
+
+    void CachedImageBounds::Set(uint64_t generation, ICanvasDevice* device, ID2D1DeviceContext* deviceContext, Numerics::Matrix3x2 const& transform, Rect const& bounds)
+    {
+        auto lock = Lock(m_mutex);
+
+        m_generation = generation;
+        m_device = AsWeak(device);
+        m_dpi = GetDpi(deviceContext);
+        m_unitMode = deviceContext->GetUnitMode();
+        m_transform = transform;
+        m_bounds = bounds;
+    }
+
+    
     static Rect GetImageBoundsImpl(
         ICanvasImageInternal* imageInternal,
         ICanvasResourceCreator* resourceCreator,
-        Numerics::Matrix3x2 const* transform)
+        Numerics::Matrix3x2 const* transform,
+        CachedImageBounds* cachedBounds)
     {
         ComPtr<ICanvasDevice> device;
         ThrowIfFailed(resourceCreator->get_Device(&device));
 
         auto d2dDeviceContext = GetDeviceContextForGetBounds(device.Get(), resourceCreator);
 
+        // The generation is read before measuring, so changes made meanwhile aren't missed.
+        uint64_t generation = 0;
+
+        if (cachedBounds)
+        {
+            Rect bounds;
+
+            if (cachedBounds->TryGet(device.Get(), d2dDeviceContext.Get(), *transform, &bounds))
+                return bounds;
+
+            generation = CachedImageBounds::CurrentGeneration();
+        }
+
         auto d2dImage = imageInternal->GetD2DImage(device.Get(), d2dDeviceContext.Get());
 
         D2D1_MATRIX_3X2_F previousTransform;
@@ -45,14 +131,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_RECT_F d2dBounds;
         ThrowIfFailed(d2dDeviceContext->GetImageWorldBounds(d2dImage.Get(), &d2dBounds));
 
-        return FromD2DRect(d2dBounds);
+        auto bounds = FromD2DRect(d2dBounds);
+
+        if (cachedBounds)
+        {
+            cachedBounds->Set(generation, device.Get(), d2dDeviceContext.Get(), *transform, bounds);
+        }
+
+        return bounds;
     }
 
     HRESULT GetImageBoundsImpl(
         ICanvasImageInternal* imageInternal,
         ICanvasResourceCreator* resourceCreator,
         Numerics::Matrix3x2 const* transform,
-        Rect* bounds)
+        Rect* bounds,
+        CachedImageBounds* cachedBounds)
     {
         if (!transform)
             transform = &Identity3x2();
@@ -63,7 +157,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 CheckInPointer(resourceCreator);
                 CheckInPointer(bounds);
 
-                *bounds = GetImageBoundsImpl(imageInternal, resourceCreator, transform);
+                *bounds = GetImageBoundsImpl(imageInternal, resourceCreator, transform, cachedBounds);
             });
     }
 
@@ -160,6 +254,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    // The WIC format matching the premultiplied pixels of a render target.
+    static GUID const& DxgiFormatToPremultipliedWic(DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+            return GUID_WICPixelFormat64bppPRGBA;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            return GUID_WICPixelFormat64bppPRGBAHalf;
+
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            return GUID_WICPixelFormat128bppPRGBAFloat;
+
+        default:
+            return GUID_WICPixelFormat32bppPBGRA;
+        }
+    }
+
+
     IFACEMETHODIMP CanvasImageFactory::SaveWithQualityAndBufferPrecisionAsync(
         ICanvasImage* image,
         Rect sourceRectangle,
@@ -170,6 +284,34 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         float quality,
         CanvasBufferPrecision bufferPrecision,
         IAsyncAction** action)
+    {
+        return SaveWithEncoderOptionsAsync(
+            image,
+            sourceRectangle,
+            dpi,
+            resourceCreator,
+            stream,
+            fileFormat,
+            quality,
+            bufferPrecision,
+            CanvasBitmapEncoderPreset::Default,
+            nullptr,
+            action);
+    }
+
+
+    IFACEMETHODIMP CanvasImageFactory::SaveWithEncoderOptionsAsync(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        float dpi,
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* stream,
+        CanvasBitmapFileFormat fileFormat,
+        float quality,
+        CanvasBufferPrecision bufferPrecision,
+        CanvasBitmapEncoderPreset preset,
+        IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* encoderOptions,
+        IAsyncAction** action)
     {
         return ExceptionBoundary(
             [&]
@@ -185,6 +327,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 if (quality < 0.0f || quality > 1.0f)
                     ThrowHR(E_INVALIDARG);
 
+                auto options = MakeWicEncoderOptions(preset, encoderOptions);
+
                 WICImageParameters wicImageParameters{};
                 wicImageParameters.PixelFormat.format = GetFormat(bufferPrecision);
                 wicImageParameters.PixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
@@ -212,13 +356,103 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                             d2dDevice.Get(),
                             istream.Get(),
                             GetGUIDForFileFormat(fileFormat),
-                            quality);
+                            quality,
+                            options);
                     });
                 ThrowIfFailed(newAction.CopyTo(action));
             });
     }
 
 
+    IFACEMETHODIMP CanvasImageFactory::SaveInStripsAsync(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        float dpi,
+        ICanvasResourceCreator* resourceCreator,
+        IRandomAccessStream* stream,
+        CanvasBitmapFileFormat fileFormat,
+        float quality,
+        CanvasBufferPrecision bufferPrecision,
+        int32_t stripHeightInPixels,
+        IAsyncAction** action)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(image);
+                CheckInPointer(resourceCreator);
+                CheckInPointer(stream);
+                CheckAndClearOutPointer(action);
+
+                if (fileFormat == CanvasBitmapFileFormat::Auto)
+                    ThrowHR(E_INVALIDARG, Strings::AutoFileFormatNotAllowed);
+
+                if (quality < 0.0f || quality > 1.0f)
+                    ThrowHR(E_INVALIDARG);
+
+                if (stripHeightInPixels <= 0)
+                    ThrowHR(E_INVALIDARG);
+
+                WICImageParameters wicImageParameters{};
+                wicImageParameters.PixelFormat.format = GetFormat(bufferPrecision);
+                wicImageParameters.PixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
+                wicImageParameters.DpiX = dpi;
+                wicImageParameters.DpiY = dpi;
+                wicImageParameters.Top = sourceRectangle.Y * dpi / DEFAULT_DPI;
+                wicImageParameters.Left = sourceRectangle.X * dpi / DEFAULT_DPI;
+                wicImageParameters.PixelWidth = static_cast<uint32_t>(SizeDipsToPixels(sourceRectangle.Width, dpi));
+                wicImageParameters.PixelHeight = static_cast<uint32_t>(SizeDipsToPixels(sourceRectangle.Height, dpi));
+
+                auto canvasDevice = GetCanvasDevice(resourceCreator);
+
+                auto d2dImage = As<ICanvasImageInternal>(image)->GetD2DImage(canvasDevice.Get(), nullptr, GetImageFlags::None, dpi);
+
+                auto adapter = m_adapter;
+                auto istream = adapter->CreateStreamOverRandomAccessStream(stream);
+                auto containerFormat = GetGUIDForFileFormat(fileFormat);
+
+                std::function<void()> save;
+
+                if (fileFormat == CanvasBitmapFileFormat::Gif)
+                {
+                    // The GIF encoder picks its palette from the whole image.
+                    auto d2dDevice = GetWrappedResource<ID2D1Device>(canvasDevice);
+
+                    save = [=]
+                    {
+                        adapter->SaveImage(
+                            d2dImage.Get(),
+                            wicImageParameters,
+                            d2dDevice.Get(),
+                            istream.Get(),
+                            containerFormat,
+                            quality,
+                            WicEncoderOptions{});
+                    };
+                }
+                else
+                {
+                    auto stripHeight = static_cast<uint32_t>(stripHeightInPixels);
+
+                    save = [=]
+                    {
+                        adapter->SaveImageInStrips(
+                            canvasDevice.Get(),
+                            d2dImage.Get(),
+                            wicImageParameters,
+                            stripHeight,
+                            istream.Get(),
+                            containerFormat,
+                            quality);
+                    };
+                }
+
+                auto newAction = adapter->RunAsync(std::move(save));
+                ThrowIfFailed(newAction.CopyTo(action));
+            });
+    }
+
+
     IFACEMETHODIMP CanvasImageFactory::ComputeHistogram(
         ICanvasImage* image,
         Rect sourceRectangle,
@@ -298,6 +532,260 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    static D2D1_CHANNEL_SELECTOR GetHistogramChannelSelector(CanvasHistogramChannels channel)
+    {
+        switch (channel)
+        {
+        case CanvasHistogramChannels::Red:   return D2D1_CHANNEL_SELECTOR_R;
+        case CanvasHistogramChannels::Green: return D2D1_CHANNEL_SELECTOR_G;
+        case CanvasHistogramChannels::Blue:  return D2D1_CHANNEL_SELECTOR_B;
+        case CanvasHistogramChannels::Alpha: return D2D1_CHANNEL_SELECTOR_A;
+
+        // Luminance is computed into the red channel by a color matrix.
+        default:                             return D2D1_CHANNEL_SELECTOR_R;
+        }
+    }
+
+
+    static ComPtr<ID2D1Effect> CreateLuminanceEffect(ID2D1DeviceContext* deviceContext, ID2D1Effect* input)
+    {
+        D2D1_MATRIX_5X4_F matrix = D2D1::Matrix5x4F(
+            0.2126f, 0, 0, 0,
+            0.7152f, 0, 0, 0,
+            0.0722f, 0, 0, 0,
+            0,       0, 0, 1,
+            0,       0, 0, 0);
+
+        ComPtr<ID2D1Effect> effect;
+        ThrowIfFailed(deviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &effect));
+        ThrowIfFailed(effect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, matrix));
+
+        effect->SetInputEffect(0, input);
+
+        return effect;
+    }
+
+
+    //
+    // Computes a histogram for each requested channel, concatenated in the
+    // order the CanvasHistogramChannels flags are declared. Every histogram
+    // effect reads from the same atlas effect, and they are all evaluated by
+    // a single draw, so this costs one GPU round trip however many channels
+    // are requested.
+    //
+    static std::vector<float> ComputeHistogramsImpl(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        ICanvasDevice* device,
+        CanvasHistogramChannels channels,
+        int32_t numberOfBins)
+    {
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+
+        auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+        CanvasHistogramChannels const allChannels[] =
+        {
+            CanvasHistogramChannels::Red,
+            CanvasHistogramChannels::Green,
+            CanvasHistogramChannels::Blue,
+            CanvasHistogramChannels::Alpha,
+            CanvasHistogramChannels::Luminance,
+        };
+
+        std::vector<ICanvasDeviceInternal::HistogramAndAtlasEffects> leased;
+
+        auto releaseEffects = MakeScopeWarden(
+            [&]
+            {
+                for (auto& effects : leased)
+                {
+                    effects.AtlasEffect->SetInput(0, nullptr);
+                    effects.HistogramEffect->SetInput(0, nullptr);
+                    deviceInternal->ReleaseHistogramEffect(std::move(effects));
+                }
+            });
+
+        for (auto channel : allChannels)
+        {
+            if ((channels & channel) != CanvasHistogramChannels::None)
+                leased.push_back(deviceInternal->LeaseHistogramEffect(deviceContext.Get()));
+        }
+
+        // Only the first atlas effect is used; the others just came along with their histogram effects.
+        auto& atlasEffect = leased.front().AtlasEffect;
+
+        float realizedDpi;
+
+        auto d2dImage = As<ICanvasImageInternal>(image)->GetD2DImage(device, deviceContext.Get(), GetImageFlags::None, DEFAULT_DPI, &realizedDpi);
+
+        if (realizedDpi != 0 && realizedDpi != DEFAULT_DPI)
+        {
+            ThrowIfFailed(D2D1::SetDpiCompensatedEffectInput(deviceContext.Get(), atlasEffect.Get(), 0, As<ID2D1Bitmap>(d2dImage).Get()));
+        }
+        else
+        {
+            atlasEffect->SetInput(0, d2dImage.Get());
+        }
+
+        ThrowIfFailed(atlasEffect->SetValue(D2D1_ATLAS_PROP_INPUT_RECT, ToD2DRect(sourceRectangle)));
+
+        size_t leasedIndex = 0;
+
+        for (auto channel : allChannels)
+        {
+            if ((channels & channel) == CanvasHistogramChannels::None)
+                continue;
+
+            auto& histogramEffect = leased[leasedIndex++].HistogramEffect;
+
+            if (channel == CanvasHistogramChannels::Luminance)
+                histogramEffect->SetInputEffect(0, CreateLuminanceEffect(deviceContext.Get(), atlasEffect.Get()).Get());
+            else
+                histogramEffect->SetInputEffect(0, atlasEffect.Get());
+
+            ThrowIfFailed(histogramEffect->SetValue(D2D1_HISTOGRAM_PROP_CHANNEL_SELECT, GetHistogramChannelSelector(channel)));
+            ThrowIfFailed(histogramEffect->SetValue(D2D1_HISTOGRAM_PROP_NUM_BINS, numberOfBins));
+        }
+
+        // Evaluate all the histograms together.
+        deviceContext->BeginDraw();
+
+        for (auto& effects : leased)
+        {
+            deviceContext->DrawImage(As<ID2D1Image>(effects.HistogramEffect).Get());
+        }
+
+        ThrowIfFailed(deviceContext->EndDraw());
+
+        // Read back the results.
+        std::vector<float> values(leased.size() * numberOfBins);
+
+        for (size_t i = 0; i < leased.size(); i++)
+        {
+            ThrowIfFailed(leased[i].HistogramEffect->GetValue(D2D1_HISTOGRAM_PROP_HISTOGRAM_OUTPUT,
+                                                              reinterpret_cast<BYTE*>(values.data() + i * numberOfBins),
+                                                              numberOfBins * sizeof(float)));
+        }
+
+        return values;
+    }
+
+
+    static void ValidateHistogramsArgs(CanvasHistogramChannels channels, int32_t numberOfBins)
+    {
+        auto const validChannels = CanvasHistogramChannels::Red |
+                                   CanvasHistogramChannels::Green |
+                                   CanvasHistogramChannels::Blue |
+                                   CanvasHistogramChannels::Alpha |
+                                   CanvasHistogramChannels::Luminance;
+
+        if (channels == CanvasHistogramChannels::None || (channels & ~validChannels) != CanvasHistogramChannels::None)
+            ThrowHR(E_INVALIDARG);
+
+        if (numberOfBins < 2 || numberOfBins > 1024)
+            ThrowHR(E_INVALIDARG);
+    }
+
+
+    IFACEMETHODIMP CanvasImageFactory::ComputeHistograms(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        ICanvasResourceCreator* resourceCreator,
+        CanvasHistogramChannels channels,
+        int32_t numberOfBins,
+        uint32_t* valueCount,
+        float** valueElements)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(image);
+                CheckInPointer(resourceCreator);
+                CheckInPointer(valueCount);
+                CheckAndClearOutPointer(valueElements);
+
+                ValidateHistogramsArgs(channels, numberOfBins);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto values = ComputeHistogramsImpl(image, sourceRectangle, device.Get(), channels, numberOfBins);
+
+                ComArray<float> array(values.begin(), values.end());
+                array.Detach(valueCount, valueElements);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasImageFactory::ComputeHistogramsAsync(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        ICanvasResourceCreator* resourceCreator,
+        CanvasHistogramChannels channels,
+        int32_t numberOfBins,
+        IAsyncOperation<IVectorView<float>*>** operation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(image);
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(operation);
+
+                ValidateHistogramsArgs(channels, numberOfBins);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                ComPtr<ICanvasImage> imageToMeasure = image;
+
+                auto asyncOperation = Make<AsyncOperation<IVectorView<float>>>(
+                    [=]
+                    {
+                        auto values = ComputeHistogramsImpl(imageToMeasure.Get(), sourceRectangle, device.Get(), channels, numberOfBins);
+
+                        auto vector = MakePooled<Vector<float>>();
+                        CheckMakeResult(vector);
+
+                        for (auto value : values)
+                        {
+                            ThrowIfFailed(vector->Append(value));
+                        }
+
+                        ComPtr<IVectorView<float>> view;
+                        ThrowIfFailed(vector->GetView(&view));
+
+                        return view;
+                    });
+
+                CheckMakeResult(asyncOperation);
+                ThrowIfFailed(asyncOperation.CopyTo(operation));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasImageFactory::ComputeStatistics(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        ICanvasResourceCreator* resourceCreator,
+        CanvasImageStatistics* statistics)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(image);
+                CheckInPointer(resourceCreator);
+                CheckInPointer(statistics);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                *statistics = ComputeImageStatistics(image, sourceRectangle, device.Get());
+            });
+    }
+
+
     IFACEMETHODIMP CanvasImageFactory::IsHistogramSupported(
         ICanvasDevice* device,
         boolean* result)
@@ -351,24 +839,244 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return istream;
     }
 
-    
-    void DefaultCanvasImageAdapter::SaveImage(
-        ID2D1Image* image,
-        WICImageParameters const& parameters,
-        ID2D1Device* device,
+
+    static VARIANT GetEncoderOptionValue(HSTRING name, IInspectable* value)
+    {
+        auto propertyValue = MaybeAs<IPropertyValue>(value);
+
+        PropertyType type = PropertyType_Empty;
+
+        if (propertyValue)
+            ThrowIfFailed(propertyValue->get_Type(&type));
+
+        VARIANT result{};
+
+        switch (type)
+        {
+        case PropertyType_UInt8:
+            result.vt = VT_UI1;
+            ThrowIfFailed(propertyValue->GetUInt8(&result.bVal));
+            break;
+
+        case PropertyType_Int16:
+            result.vt = VT_I2;
+            ThrowIfFailed(propertyValue->GetInt16(&result.iVal));
+            break;
+
+        case PropertyType_UInt16:
+            result.vt = VT_UI2;
+            ThrowIfFailed(propertyValue->GetUInt16(&result.uiVal));
+            break;
+
+        case PropertyType_Int32:
+            {
+                INT32 i;
+                ThrowIfFailed(propertyValue->GetInt32(&i));
+                result.vt = VT_I4;
+                result.lVal = i;
+            }
+            break;
+
+        case PropertyType_UInt32:
+            {
+                UINT32 u;
+                ThrowIfFailed(propertyValue->GetUInt32(&u));
+                result.vt = VT_UI4;
+                result.ulVal = u;
+            }
+            break;
+
+        case PropertyType_Int64:
+            result.vt = VT_I8;
+            ThrowIfFailed(propertyValue->GetInt64(&result.llVal));
+            break;
+
+        case PropertyType_UInt64:
+            result.vt = VT_UI8;
+            ThrowIfFailed(propertyValue->GetUInt64(&result.ullVal));
+            break;
+
+        case PropertyType_Single:
+            result.vt = VT_R4;
+            ThrowIfFailed(propertyValue->GetSingle(&result.fltVal));
+            break;
+
+        case PropertyType_Double:
+            result.vt = VT_R8;
+            ThrowIfFailed(propertyValue->GetDouble(&result.dblVal));
+            break;
+
+        case PropertyType_Boolean:
+            {
+                boolean b;
+                ThrowIfFailed(propertyValue->GetBoolean(&b));
+                result.vt = VT_BOOL;
+                result.boolVal = b ? VARIANT_TRUE : VARIANT_FALSE;
+            }
+            break;
+
+        default:
+            {
+                WinStringBuilder message;
+                message.Format(Strings::EncoderOptionWrongType, WindowsGetStringRawBuffer(name, nullptr));
+                ThrowHR(E_INVALIDARG, message.Get());
+            }
+        }
+
+        return result;
+    }
+
+
+    WicEncoderOptions MakeWicEncoderOptions(
+        CanvasBitmapEncoderPreset preset,
+        IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* values)
+    {
+        switch (preset)
+        {
+        case CanvasBitmapEncoderPreset::Default:
+        case CanvasBitmapEncoderPreset::Fast:
+            break;
+
+        default:
+            ThrowHR(E_INVALIDARG);
+        }
+
+        WicEncoderOptions options{ preset };
+
+        if (!values)
+            return options;
+
+        ComPtr<IIterator<IKeyValuePair<HSTRING, IInspectable*>*>> iterator;
+        ThrowIfFailed(values->First(&iterator));
+
+        boolean hasCurrent;
+        ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+        while (hasCurrent)
+        {
+            ComPtr<IKeyValuePair<HSTRING, IInspectable*>> pair;
+            ThrowIfFailed(iterator->get_Current(&pair));
+
+            WinString name;
+            ThrowIfFailed(pair->get_Key(name.GetAddressOf()));
+
+            ComPtr<IInspectable> value;
+            ThrowIfFailed(pair->get_Value(&value));
+
+            options.Values.emplace_back(name, GetEncoderOptionValue(name, value.Get()));
+
+            ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+        }
+
+        return options;
+    }
+
+
+    //
+    // Settings for CanvasBitmapEncoderPreset::Fast, which trade file size for
+    // encoding speed. These are only applied if the encoder has the option.
+    // BMP is always uncompressed so needs nothing here, and the WIC PNG encoder
+    // has no zlib level setting, so skipping its per-row filtering is the
+    // most that can be done there.
+    //
+    struct PresetEncoderOption
+    {
+        GUID const* ContainerFormat;
+        wchar_t const* Name;
+        BYTE Value;
+    };
+
+    static PresetEncoderOption const FastEncoderOptions[] =
+    {
+        { &GUID_ContainerFormatPng,  L"FilterOption",          WICPngFilterNone },
+        { &GUID_ContainerFormatJpeg, L"JpegYCrCbSubsampling",  WICJpegYCrCbSubsampling420 },
+        { &GUID_ContainerFormatTiff, L"TiffCompressionMethod", WICTiffCompressionNone },
+        { &GUID_ContainerFormatWmp,  L"Overlap",               0 },
+    };
+
+
+    // Looks up the names and types of the options this frame encoder supports.
+    static std::map<std::wstring, VARTYPE> GetEncoderOptionTypes(IPropertyBag2* properties)
+    {
+        std::map<std::wstring, VARTYPE> types;
+
+        ULONG count;
+        ThrowIfFailed(properties->CountProperties(&count));
+
+        for (ULONG i = 0; i < count; i++)
+        {
+            PROPBAG2 info{};
+            ULONG infoCount;
+            ThrowIfFailed(properties->GetPropertyInfo(i, 1, &info, &infoCount));
+
+            if (info.pstrName)
+            {
+                types[info.pstrName] = info.vt;
+                CoTaskMemFree(info.pstrName);
+            }
+        }
+
+        return types;
+    }
+
+
+    static void WriteEncoderOption(IPropertyBag2* properties, wchar_t const* name, VARTYPE type, VARIANT const& value)
+    {
+        VARIANT convertedValue{};
+
+        if (FAILED(VariantChangeType(&convertedValue, &value, 0, type)))
+        {
+            WinStringBuilder message;
+            message.Format(Strings::EncoderOptionWrongType, name);
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        PROPBAG2 option{};
+        option.pstrName = const_cast<wchar_t*>(name);
+        ThrowIfFailed(properties->Write(1, &option, &convertedValue));
+    }
+
+
+    void CreateWicFrameEncode(
+        IWICImagingFactory* factory,
         IStream* stream,
         GUID const& containerFormat,
-        float quality)
-    {        
-        auto factory = GetFactory();
-
-        ComPtr<IWICBitmapEncoder> encoder;
-        ThrowIfFailed(factory->CreateEncoder(containerFormat, nullptr, &encoder));
-        ThrowIfFailed(encoder->Initialize(stream, WICBitmapEncoderNoCache));
+        float quality,
+        WicEncoderOptions const& options,
+        ComPtr<IWICBitmapEncoder>* encoder,
+        ComPtr<IWICBitmapFrameEncode>* frame)
+    {
+        ThrowIfFailed(factory->CreateEncoder(containerFormat, nullptr, encoder->ReleaseAndGetAddressOf()));
+        ThrowIfFailed((*encoder)->Initialize(stream, WICBitmapEncoderNoCache));
 
-        ComPtr<IWICBitmapFrameEncode> frame;
         ComPtr<IPropertyBag2> frameProperties;
-        ThrowIfFailed(encoder->CreateNewFrame(&frame, &frameProperties));
+        ThrowIfFailed((*encoder)->CreateNewFrame(frame->ReleaseAndGetAddressOf(), &frameProperties));
+
+        // Only ask the encoder what it supports if there are options to set.
+        std::map<std::wstring, VARTYPE> optionTypes;
+
+        if (options.Preset != CanvasBitmapEncoderPreset::Default || !options.Values.empty())
+            optionTypes = GetEncoderOptionTypes(frameProperties.Get());
+
+        // Preset options come first, so explicitly specified values can override them.
+        if (options.Preset == CanvasBitmapEncoderPreset::Fast)
+        {
+            for (auto& presetOption : FastEncoderOptions)
+            {
+                if (*presetOption.ContainerFormat != containerFormat)
+                    continue;
+
+                auto it = optionTypes.find(presetOption.Name);
+
+                if (it == optionTypes.end())
+                    continue;
+
+                VARIANT value{};
+                value.vt = VT_UI1;
+                value.bVal = presetOption.Value;
+                WriteEncoderOption(frameProperties.Get(), presetOption.Name, it->second, value);
+            }
+        }
 
         bool supportsQuality =
             containerFormat == GUID_ContainerFormatJpeg ||
@@ -384,7 +1092,69 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ThrowIfFailed(frameProperties->Write(1, &option, &value));
         }
 
-        ThrowIfFailed(frame->Initialize(frameProperties.Get()));
+        for (auto& userOption : options.Values)
+        {
+            auto name = static_cast<wchar_t const*>(userOption.first);
+            auto it = optionTypes.find(name);
+
+            if (it == optionTypes.end())
+            {
+                WinStringBuilder message;
+                message.Format(Strings::EncoderOptionUnknown, name);
+                ThrowHR(E_INVALIDARG, message.Get());
+            }
+
+            WriteEncoderOption(frameProperties.Get(), name, it->second, userOption.second);
+        }
+
+        ThrowIfFailed((*frame)->Initialize(frameProperties.Get()));
+    }
+
+
+    void WriteWicFramePixels(
+        IWICImagingFactory* factory,
+        IWICBitmapFrameEncode* frame,
+        GUID const& pixelFormat,
+        GUID const& encodeFormat,
+        uint32_t width,
+        uint32_t height,
+        uint32_t stride,
+        uint32_t bufferSize,
+        uint8_t* pixels)
+    {
+        // If the encoder takes the pixels as they are, hand them over directly.
+        if (encodeFormat == pixelFormat)
+        {
+            ThrowIfFailed(frame->WritePixels(height, stride, bufferSize, pixels));
+            return;
+        }
+
+        ComPtr<IWICBitmap> bitmap;
+        ThrowIfFailed(factory->CreateBitmapFromMemory(width, height, pixelFormat, stride, bufferSize, pixels, &bitmap));
+
+        ComPtr<IWICFormatConverter> converter;
+        ThrowIfFailed(factory->CreateFormatConverter(&converter));
+        ThrowIfFailed(converter->Initialize(bitmap.Get(), encodeFormat, WICBitmapDitherTypeNone, nullptr, 0, WICBitmapPaletteTypeCustom));
+
+        WICRect rect{ 0, 0, static_cast<INT>(width), static_cast<INT>(height) };
+        ThrowIfFailed(frame->WriteSource(converter.Get(), &rect));
+    }
+
+
+    void DefaultCanvasImageAdapter::SaveImage(
+        ID2D1Image* image,
+        WICImageParameters const& parameters,
+        ID2D1Device* device,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality,
+        WicEncoderOptions const& options)
+    {        
+        auto factory = GetFactory();
+
+        ComPtr<IWICBitmapEncoder> encoder;
+        ComPtr<IWICBitmapFrameEncode> frame;
+        CreateWicFrameEncode(factory.Get(), stream, containerFormat, quality, options, &encoder, &frame);
 
         // If the file format supports extended range (JpegXR) then tell WIC to encode
         // using the same pixel format that we are rasterizing the D2D image with.
@@ -404,6 +1174,133 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    static void DrawStrip(
+        ID2D1DeviceContext1* deviceContext,
+        ID2D1Image* image,
+        ID2D1Bitmap1* target,
+        float dpi,
+        float left,
+        float top)
+    {
+        auto restoreState = MakeScopeWarden(
+            [&]
+            {
+                deviceContext->SetTarget(nullptr);
+                deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+                deviceContext->SetDpi(DEFAULT_DPI, DEFAULT_DPI);
+            });
+
+        deviceContext->SetTarget(target);
+        deviceContext->SetDpi(dpi, dpi);
+        deviceContext->BeginDraw();
+        deviceContext->Clear(D2D1::ColorF(0, 0));
+        deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(-left * DEFAULT_DPI / dpi, -top * DEFAULT_DPI / dpi));
+        deviceContext->DrawImage(image);
+        ThrowIfFailed(deviceContext->EndDraw());
+    }
+
+
+    void DefaultCanvasImageAdapter::SaveImageInStrips(
+        ICanvasDevice* device,
+        ID2D1Image* image,
+        WICImageParameters const& parameters,
+        uint32_t stripHeight,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality)
+    {
+        auto factory = GetFactory();
+
+        ComPtr<IWICBitmapEncoder> encoder;
+        ComPtr<IWICBitmapFrameEncode> frame;
+        CreateWicFrameEncode(factory.Get(), stream, containerFormat, quality, WicEncoderOptions{}, &encoder, &frame);
+
+        auto width = parameters.PixelWidth;
+        auto height = parameters.PixelHeight;
+        auto dpi = parameters.DpiX;
+
+        ThrowIfFailed(frame->SetSize(width, height));
+        ThrowIfFailed(frame->SetResolution(dpi, dpi));
+
+        // As with SaveImage, extended range formats are encoded at the
+        // precision they are drawn with.  The encoder changes this to the
+        // closest format it supports.
+        auto& stripFormat = DxgiFormatToPremultipliedWic(parameters.PixelFormat.format);
+        GUID encodeFormat = FileFormatSupportsHdr(containerFormat) ? DxgiFormatToWic(parameters.PixelFormat.format) : stripFormat;
+        ThrowIfFailed(frame->SetPixelFormat(&encodeFormat));
+
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+        auto lease = deviceInternal->GetResourceCreationDeviceContext();
+
+        stripHeight = std::min(stripHeight, height);
+
+        // The last strip may be shorter than the rest, so gets its own target.
+        ComPtr<ID2D1Bitmap1> targets[2];
+
+        auto getTarget = [&] (uint32_t rows)
+        {
+            auto& target = targets[rows == stripHeight ? 0 : 1];
+
+            if (!target)
+            {
+                target = deviceInternal->CreateRenderTargetBitmap(
+                    PixelsToDips(width, dpi),
+                    PixelsToDips(rows, dpi),
+                    dpi,
+                    static_cast<DirectXPixelFormat>(parameters.PixelFormat.format),
+                    CanvasAlphaMode::Premultiplied);
+            }
+
+            return target;
+        };
+
+        // Each strip is read back through a staging bitmap while the GPU
+        // draws the next one.
+        ComPtr<ID2D1Bitmap1> pendingCopy;
+        uint32_t pendingRows = 0;
+
+        auto writePendingStrip = [&]
+        {
+            ScopedBitmapMappedPixelAccess pixels(device, pendingCopy);
+
+            WriteWicFramePixels(
+                factory.Get(),
+                frame.Get(),
+                stripFormat,
+                encodeFormat,
+                width,
+                pendingRows,
+                pixels.GetStride(),
+                pixels.GetLockedBufferSize(),
+                pixels.GetLockedData());
+        };
+
+        for (uint32_t top = 0; top < height; top += stripHeight)
+        {
+            AsyncCancellation::ThrowIfCanceled();
+
+            auto rows = std::min(stripHeight, height - top);
+            auto target = getTarget(rows);
+
+            DrawStrip(lease.Get(), image, target.Get(), dpi, parameters.Left, parameters.Top + top);
+
+            auto copy = ScopedBitmapMappedPixelAccess::BeginCopy(device, target.Get(), nullptr);
+
+            if (pendingCopy)
+                writePendingStrip();
+
+            pendingCopy = copy;
+            pendingRows = rows;
+        }
+
+        if (pendingCopy)
+            writePendingStrip();
+
+        ThrowIfFailed(frame->Commit());
+        ThrowIfFailed(encoder->Commit());
+    }
+
+
     ComPtr<IWICImagingFactory2> const& DefaultCanvasImageAdapter::GetFactory()
     {
         if (!m_wicAdapter)
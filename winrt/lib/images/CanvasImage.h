@@ -12,6 +12,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     using namespace ::Microsoft::WRL;
     using namespace ABI::Windows::Foundation;
+    using namespace ABI::Windows::Foundation::Collections;
     using namespace ABI::Windows::Storage::Streams;
 
 
@@ -52,6 +53,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         // realizedDpi returns the DPI of a source bitmap, or zero if the image does not
         // have a fixed DPI. A D2D1DpiCompensation effect will be inserted if targetDpi
         // and realizedDpi are different (flags permitting).
+        //
+        // Realized effects and image brushes remember the ID2D1Image they got from their
+        // sources, and only ask again once something has bumped the realized graph
+        // generation (see CanvasEffect::IsGraphValidated). So an image whose GetD2DImage
+        // can start returning a different ID2D1Image, such as CanvasDynamicBitmap moving
+        // on to its next buffer, must call InvalidateRealizedImageGraphs when it does.
 
         virtual ComPtr<ID2D1Image> GetD2DImage(
             ICanvasDevice* device,
@@ -62,14 +69,97 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     };
 
 
+    //
+    // Remembers the most recent GetBounds result of an effect or command list.
+    // Measuring these makes D2D walk the whole image graph, which is slow for
+    // deep graphs, yet callers often ask again and again for the bounds of an
+    // image that has not changed.
+    //
+    // The bounds of an image can depend on anything upstream of it, so rather
+    // than tracking which images each one depends on, anything that might
+    // change the bounds of any image calls InvalidateCachedImageBounds, which
+    // discards every cached result at once. Such changes are rare compared to
+    // bounds queries.
+    //
+    class CachedImageBounds
+    {
+        std::mutex m_mutex;
+
+        uint64_t m_generation;      // Zero if nothing is cached.
+        WeakRef m_device;
+        float m_dpi;
+        D2D1_UNIT_MODE m_unitMode;
+        Numerics::Matrix3x2 m_transform;
+        Rect m_bounds;
+
+    public:
+        CachedImageBounds()
+            : m_generation(0)
+        { }
+
+        static uint64_t CurrentGeneration();
+
+        bool TryGet(ICanvasDevice* device, ID2D1DeviceContext* deviceContext, Numerics::Matrix3x2 const& transform, Rect* bounds);
+        void Set(uint64_t generation, ICanvasDevice* device, ID2D1DeviceContext* deviceContext, Numerics::Matrix3x2 const& transform, Rect const& bounds);
+    };
+
+    void InvalidateCachedImageBounds();
+
+    // Makes every realized effect graph and image brush fetch its source images again.
+    void InvalidateRealizedImageGraphs();
+
+
+    // cachedBounds is optional (for images that are cheap to measure, or that might
+    // change without InvalidateCachedImageBounds being called).
     HRESULT GetImageBoundsImpl(
         ICanvasImageInternal* imageInternal,
         ICanvasResourceCreator* resourceCreator,
         Numerics::Matrix3x2 const* optionalTransform,
-        Rect* bounds);
+        Rect* bounds,
+        CachedImageBounds* cachedBounds = nullptr);
 
     DeviceContextLease GetDeviceContextForGetBounds(ICanvasDevice* device, ICanvasResourceCreator* resourceCreator);
 
+    // Encoder options requested by the app, to be written into the WIC frame
+    // property bag. Values hold plain numeric VARIANTs, which are converted to
+    // whatever type the encoder advertises for each option when it is written.
+    struct WicEncoderOptions
+    {
+        CanvasBitmapEncoderPreset Preset;
+        std::vector<std::pair<WinString, VARIANT>> Values;
+    };
+
+    WicEncoderOptions MakeWicEncoderOptions(
+        CanvasBitmapEncoderPreset preset,
+        IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* values);
+
+    // Creates a WIC encoder writing to the stream, with its one frame
+    // initialized ready for pixels, and the quality and any other encoder
+    // options set. Options the encoder does not support are an error, except
+    // for those implied by the preset, which are only set where supported.
+    void CreateWicFrameEncode(
+        IWICImagingFactory* factory,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality,
+        WicEncoderOptions const& options,
+        ComPtr<IWICBitmapEncoder>* encoder,
+        ComPtr<IWICBitmapFrameEncode>* frame);
+
+    // Writes the next rows of a frame that was set up by CreateWicFrameEncode.
+    // If the encoder picked a different encodeFormat from the pixelFormat the
+    // rows are in, they are converted on the way.
+    void WriteWicFramePixels(
+        IWICImagingFactory* factory,
+        IWICBitmapFrameEncode* frame,
+        GUID const& pixelFormat,
+        GUID const& encodeFormat,
+        uint32_t width,
+        uint32_t height,
+        uint32_t stride,
+        uint32_t bufferSize,
+        uint8_t* pixels);
+
     class DefaultCanvasImageAdapter;
     
     class CanvasImageAdapter : public Singleton<CanvasImageAdapter, DefaultCanvasImageAdapter>
@@ -87,6 +177,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ID2D1Device* device,
             IStream* stream,
             GUID const& containerFormat,
+            float quality,
+            WicEncoderOptions const& options) = 0;
+
+        // Draws the image one strip of rows at a time, handing each strip to
+        // the encoder before drawing the next, so only a strip at a time is
+        // ever held in memory.
+        virtual void SaveImageInStrips(
+            ICanvasDevice* device,
+            ID2D1Image* d2dImage,
+            WICImageParameters const& wicImageParameters,
+            uint32_t stripHeight,
+            IStream* stream,
+            GUID const& containerFormat,
             float quality) = 0;
     };
 
@@ -106,6 +209,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ID2D1Device* device,
             IStream* stream,
             GUID const& containerFormat,
+            float quality,
+            WicEncoderOptions const& options) override;
+
+        virtual void SaveImageInStrips(
+            ICanvasDevice* device,
+            ID2D1Image* d2dImage,
+            WICImageParameters const& wicImageParameters,
+            uint32_t stripHeight,
+            IStream* stream,
+            GUID const& containerFormat,
             float quality) override;
 
     private:
@@ -154,6 +267,31 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CanvasBufferPrecision bufferPrecision,
             IAsyncAction** action) override;
 
+        IFACEMETHODIMP SaveWithEncoderOptionsAsync(
+            ICanvasImage* image,
+            Rect sourceRectangle,
+            float dpi,
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            CanvasBufferPrecision bufferPrecision,
+            CanvasBitmapEncoderPreset preset,
+            IIterable<IKeyValuePair<HSTRING, IInspectable*>*>* encoderOptions,
+            IAsyncAction** action) override;
+
+        IFACEMETHODIMP SaveInStripsAsync(
+            ICanvasImage* image,
+            Rect sourceRectangle,
+            float dpi,
+            ICanvasResourceCreator* resourceCreator,
+            IRandomAccessStream* stream,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            CanvasBufferPrecision bufferPrecision,
+            int32_t stripHeightInPixels,
+            IAsyncAction** action) override;
+
         IFACEMETHODIMP ComputeHistogram(
             ICanvasImage* image,
             Rect sourceRectangle,
@@ -163,6 +301,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             uint32_t* valueCount,
             float** valueElements) override;
 
+        IFACEMETHODIMP ComputeHistograms(
+            ICanvasImage* image,
+            Rect sourceRectangle,
+            ICanvasResourceCreator* resourceCreator,
+            CanvasHistogramChannels channels,
+            int32_t numberOfBins,
+            uint32_t* valueCount,
+            float** valueElements) override;
+
+        IFACEMETHODIMP ComputeHistogramsAsync(
+            ICanvasImage* image,
+            Rect sourceRectangle,
+            ICanvasResourceCreator* resourceCreator,
+            CanvasHistogramChannels channels,
+            int32_t numberOfBins,
+            IAsyncOperation<IVectorView<float>*>** operation) override;
+
+        IFACEMETHODIMP ComputeStatistics(
+            ICanvasImage* image,
+            Rect sourceRectangle,
+            ICanvasResourceCreator* resourceCreator,
+            CanvasImageStatistics* statistics) override;
+
         IFACEMETHODIMP IsHistogramSupported(
             ICanvasDevice* device,
             boolean* result) override;
@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CanvasMappedPixels.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    CanvasMappedPixels::CanvasMappedPixels(
+        std::unique_ptr<ScopedBitmapMappedPixelAccess>&& pixelAccess,
+        BitmapSize sizeInPixels,
+        DirectXPixelFormat format,
+        uint32_t capacity)
+        : m_pixelAccess(std::move(pixelAccess))
+        , m_sizeInPixels(sizeInPixels)
+        , m_format(format)
+        , m_capacity(capacity)
+        , m_stride(m_pixelAccess->GetStride())
+    {
+    }
+
+
+    CanvasMappedPixels::~CanvasMappedPixels()
+    {
+        (void)Close();
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixels::get_SizeInPixels(BitmapSize* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_sizeInPixels;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixels::get_Stride(uint32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_stride;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixels::get_Format(DirectXPixelFormat* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_format;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixels::CreateReference(IMemoryBufferReference** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                auto reference = Make<CanvasMappedPixelsReference>(this);
+                CheckMakeResult(reference);
+
+                Lock lock(m_mutex);
+
+                if (!m_pixelAccess)
+                    ThrowHR(RO_E_CLOSED);
+
+                // Forget about references that have already been released.
+                m_references.erase(
+                    std::remove_if(m_references.begin(), m_references.end(),
+                        [](std::pair<WeakRef, CanvasMappedPixelsReference*>& entry)
+                        {
+                            ComPtr<IMemoryBufferReference> alive;
+                            return FAILED(entry.first.As(&alive)) || !alive;
+                        }),
+                    m_references.end());
+
+                m_references.emplace_back(AsWeak(static_cast<IMemoryBufferReference*>(reference.Get())), reference.Get());
+
+                ThrowIfFailed(reference.CopyTo(value));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixels::Close()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                std::vector<ComPtr<IClosable>> references;
+                std::unique_ptr<ScopedBitmapMappedPixelAccess> pixelAccess;
+
+                {
+                    Lock lock(m_mutex);
+
+                    for (auto& entry : m_references)
+                    {
+                        ComPtr<IMemoryBufferReference> alive;
+
+                        if (SUCCEEDED(entry.first.As(&alive)) && alive)
+                            references.push_back(entry.second);
+                    }
+
+                    m_references.clear();
+
+                    pixelAccess = std::move(m_pixelAccess);
+                }
+
+                //
+                // Raise the references' Closed events, and unmap the staging
+                // bitmap, without holding our lock, so that handlers are free
+                // to call back into this object.
+                //
+                for (auto& reference : references)
+                {
+                    ThrowIfFailed(reference->Close());
+                }
+
+                pixelAccess.reset();
+            });
+    }
+
+
+    uint8_t* CanvasMappedPixels::GetBuffer(uint32_t* capacity)
+    {
+        Lock lock(m_mutex);
+
+        if (!m_pixelAccess)
+        {
+            *capacity = 0;
+            return nullptr;
+        }
+
+        *capacity = m_capacity;
+        return m_pixelAccess->GetLockedData();
+    }
+
+
+    CanvasMappedPixelsReference::CanvasMappedPixelsReference(CanvasMappedPixels* owner)
+        : m_owner(owner)
+    {
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixelsReference::get_Capacity(uint32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                Lock lock(m_mutex);
+
+                if (m_owner)
+                    m_owner->GetBuffer(value);
+                else
+                    *value = 0;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixelsReference::add_Closed(ClosedHandler* handler, EventRegistrationToken* token)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(handler);
+                CheckInPointer(token);
+
+                ThrowIfFailed(m_closedEventList.Add(handler, token));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixelsReference::remove_Closed(EventRegistrationToken token)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                ThrowIfFailed(m_closedEventList.Remove(token));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixelsReference::Close()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                ComPtr<CanvasMappedPixels> owner;
+
+                {
+                    Lock lock(m_mutex);
+                    owner = std::move(m_owner);
+                }
+
+                if (!owner)
+                    return;
+
+                ThrowIfFailed(m_closedEventList.InvokeAll(this, nullptr));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasMappedPixelsReference::GetBuffer(uint8_t** value, uint32_t* capacity)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                CheckInPointer(capacity);
+
+                *capacity = 0;
+
+                Lock lock(m_mutex);
+
+                if (!m_owner)
+                    ThrowHR(RO_E_CLOSED);
+
+                auto data = m_owner->GetBuffer(capacity);
+
+                if (!data)
+                    ThrowHR(RO_E_CLOSED);
+
+                *value = data;
+            });
+    }
+
+}}}}
+
+#endif
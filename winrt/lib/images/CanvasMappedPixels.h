@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "ScopedBitmapMappedPixelAccess.h"
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Windows::Foundation;
+    using namespace WinRTDirectX;
+
+    class CanvasMappedPixelsReference;
+
+    //
+    // Exposes a ScopedBitmapMappedPixelAccess, which keeps a CPU readable
+    // copy of some bitmap pixels mapped into memory, as an IMemoryBuffer.
+    // This lets apps read the pixels in place, rather than having
+    // GetPixelBytes copy them all into a newly allocated array.
+    //
+    // Closing the buffer unmaps the staging bitmap, and closes any references
+    // that are still outstanding, after which they report zero capacity.
+    //
+    class CanvasMappedPixels : public RuntimeClass<ICanvasMappedPixels, IMemoryBuffer, IClosable>
+                             , private LifespanTracker<CanvasMappedPixels>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasMappedPixels, BaseTrust);
+
+        std::mutex m_mutex;
+        std::unique_ptr<ScopedBitmapMappedPixelAccess> m_pixelAccess;
+
+        // Outstanding references, so Close can close them too.  The weak
+        // reference says whether the raw pointer is still alive.
+        std::vector<std::pair<WeakRef, CanvasMappedPixelsReference*>> m_references;
+
+        BitmapSize const m_sizeInPixels;
+        DirectXPixelFormat const m_format;
+        uint32_t const m_capacity;
+        uint32_t const m_stride;
+
+    public:
+        CanvasMappedPixels(
+            std::unique_ptr<ScopedBitmapMappedPixelAccess>&& pixelAccess,
+            BitmapSize sizeInPixels,
+            DirectXPixelFormat format,
+            uint32_t capacity);
+
+        virtual ~CanvasMappedPixels();
+
+        IFACEMETHOD(get_SizeInPixels)(BitmapSize* value) override;
+        IFACEMETHOD(get_Stride)(uint32_t* value) override;
+        IFACEMETHOD(get_Format)(DirectXPixelFormat* value) override;
+
+        // IMemoryBuffer
+        IFACEMETHOD(CreateReference)(IMemoryBufferReference** value) override;
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+        // Returns null once the buffer has been closed.
+        uint8_t* GetBuffer(uint32_t* capacity);
+    };
+
+
+    class CanvasMappedPixelsReference : public RuntimeClass<
+                                            RuntimeClassFlags<WinRtClassicComMix>,
+                                            IMemoryBufferReference,
+                                            IClosable,
+                                            ::Windows::Foundation::IMemoryBufferByteAccess>
+                                      , private LifespanTracker<CanvasMappedPixelsReference>
+    {
+        //
+        // This is exposed to the app through the IMemoryBufferReference interface,
+        // and not as a runtime class.
+        //
+        InspectableClass(L"Windows.Foundation.IMemoryBufferReference", BaseTrust);
+
+        typedef ITypedEventHandler<IMemoryBufferReference*, IInspectable*> ClosedHandler;
+
+        std::mutex m_mutex;
+        ComPtr<CanvasMappedPixels> m_owner;
+        EventSource<ClosedHandler, InvokeModeOptions<StopOnFirstError>> m_closedEventList;
+
+    public:
+        CanvasMappedPixelsReference(CanvasMappedPixels* owner);
+
+        // IMemoryBufferReference
+        IFACEMETHOD(get_Capacity)(uint32_t* value) override;
+        IFACEMETHOD(add_Closed)(ClosedHandler* handler, EventRegistrationToken* token) override;
+        IFACEMETHOD(remove_Closed)(EventRegistrationToken token) override;
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+        // IMemoryBufferByteAccess
+        IFACEMETHOD(GetBuffer)(uint8_t** value, uint32_t* capacity) override;
+    };
+
+}}}}
+
+#endif
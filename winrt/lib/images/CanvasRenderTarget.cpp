@@ -158,6 +158,117 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    static ComPtr<CanvasRenderTarget> CreateRenderTargetFromSharedTexture(
+        ICanvasDevice* canvasDevice,
+        ID3D11Texture2D* texture,
+        float dpi,
+        CanvasAlphaMode alpha)
+    {
+        D3D11_TEXTURE2D_DESC textureDesc;
+        texture->GetDesc(&textureDesc);
+
+        D2D1_BITMAP_PROPERTIES1 bitmapProperties = D2D1::BitmapProperties1();
+        bitmapProperties.bitmapOptions = D2D1_BITMAP_OPTIONS_TARGET;
+        bitmapProperties.dpiX = dpi;
+        bitmapProperties.dpiY = dpi;
+        bitmapProperties.pixelFormat.format = textureDesc.Format;
+        bitmapProperties.pixelFormat.alphaMode = ToD2DAlphaMode(alpha);
+
+        ComPtr<ID2D1Bitmap1> d2dBitmap;
+
+        {
+            auto deviceContext = As<ICanvasDeviceInternal>(canvasDevice)->GetResourceCreationDeviceContext();
+
+            ThrowIfFailed(deviceContext->CreateBitmapFromDxgiSurface(
+                As<IDXGISurface>(texture).Get(),
+                &bitmapProperties,
+                &d2dBitmap));
+        }
+
+        auto renderTarget = Make<CanvasRenderTarget>(canvasDevice, d2dBitmap.Get());
+        CheckMakeResult(renderTarget);
+
+        return renderTarget;
+    }
+
+    IFACEMETHODIMP CanvasRenderTargetFactory::CreateShared(
+        ICanvasResourceCreator* resourceCreator,
+        float width,
+        float height,
+        float dpi,
+        DirectXPixelFormat format,
+        CanvasAlphaMode alpha,
+        ICanvasRenderTarget** renderTarget)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(renderTarget);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                //
+                // D2D can't create shareable bitmaps itself, so the texture
+                // is created through D3D and wrapped.
+                //
+                D3D11_TEXTURE2D_DESC textureDesc{};
+                textureDesc.Width = static_cast<uint32_t>(SizeDipsToPixels(width, dpi));
+                textureDesc.Height = static_cast<uint32_t>(SizeDipsToPixels(height, dpi));
+                textureDesc.MipLevels = 1;
+                textureDesc.ArraySize = 1;
+                textureDesc.Format = static_cast<DXGI_FORMAT>(format);
+                textureDesc.SampleDesc.Count = 1;
+                textureDesc.Usage = D3D11_USAGE_DEFAULT;
+                textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+                textureDesc.MiscFlags = D3D11_RESOURCE_MISC_SHARED_NTHANDLE | D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+
+                auto d3dDevice = GetDXGIInterface<ID3D11Device>(canvasDevice.Get());
+
+                ComPtr<ID3D11Texture2D> texture;
+                HRESULT hr = d3dDevice->CreateTexture2D(&textureDesc, nullptr, &texture);
+
+                As<ICanvasDeviceInternal>(canvasDevice)->ThrowIfCreateSurfaceFailed(hr, L"CanvasRenderTarget", textureDesc.Width, textureDesc.Height);
+
+                auto newRenderTarget = CreateRenderTargetFromSharedTexture(canvasDevice.Get(), texture.Get(), dpi, alpha);
+
+                ThrowIfFailed(newRenderTarget.CopyTo(renderTarget));
+            });
+    }
+
+    IFACEMETHODIMP CanvasRenderTargetFactory::OpenShared(
+        ICanvasResourceCreator* resourceCreator,
+        uint64_t sharedHandle,
+        float dpi,
+        CanvasAlphaMode alpha,
+        ICanvasRenderTarget** renderTarget)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(renderTarget);
+
+                if (!sharedHandle)
+                    ThrowHR(E_INVALIDARG);
+
+                ComPtr<ICanvasDevice> canvasDevice;
+                ThrowIfFailed(resourceCreator->get_Device(&canvasDevice));
+
+                auto d3dDevice = As<ID3D11Device1>(GetDXGIInterface<ID3D11Device>(canvasDevice.Get()));
+
+                ComPtr<ID3D11Texture2D> texture;
+                ThrowIfFailed(d3dDevice->OpenSharedResource1(
+                    reinterpret_cast<HANDLE>(static_cast<uintptr_t>(sharedHandle)),
+                    IID_PPV_ARGS(&texture)));
+
+                auto newRenderTarget = CreateRenderTargetFromSharedTexture(canvasDevice.Get(), texture.Get(), dpi, alpha);
+
+                ThrowIfFailed(newRenderTarget.CopyTo(renderTarget));
+            });
+    }
+
 
     static ComPtr<ICanvasDrawingSession> CreateDrawingSessionOverD2DBitmap(
         ICanvasDevice* owner,
@@ -246,5 +357,93 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    static ComPtr<IDXGIKeyedMutex> GetKeyedMutex(ID2D1Bitmap1* d2dBitmap)
+    {
+        ComPtr<IDXGISurface> surface;
+        ThrowIfFailed(d2dBitmap->GetSurface(&surface));
+
+        auto keyedMutex = MaybeAs<IDXGIKeyedMutex>(surface);
+
+        if (!keyedMutex)
+            ThrowHR(E_INVALIDARG, Strings::RenderTargetNotShared);
+
+        return keyedMutex;
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTarget::CreateSharedHandle(
+        uint64_t* sharedHandle)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(sharedHandle);
+
+                auto& resource = GetD2DBitmap();
+
+                auto dxgiResource = As<IDXGIResource1>(GetKeyedMutex(resource.Get()));
+
+                HANDLE handle;
+                ThrowIfFailed(dxgiResource->CreateSharedHandle(
+                    nullptr,
+                    DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+                    nullptr,
+                    &handle));
+
+                *sharedHandle = reinterpret_cast<uintptr_t>(handle);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTarget::AcquireSharedAccess(
+        uint64_t key,
+        int32_t timeoutInMilliseconds,
+        boolean* acquired)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(acquired);
+
+                auto& resource = GetD2DBitmap();
+
+                auto keyedMutex = GetKeyedMutex(resource.Get());
+
+                auto timeout = timeoutInMilliseconds < 0 ? INFINITE : static_cast<DWORD>(timeoutInMilliseconds);
+
+                HRESULT hr = keyedMutex->AcquireSync(key, timeout);
+
+                // The other side went away while holding the mutex, so
+                // what is in the surface can't be trusted.
+                if (hr == WAIT_ABANDONED)
+                    ThrowHR(HRESULT_FROM_WIN32(ERROR_ABANDONED_WAIT_0));
+
+                ThrowIfFailed(hr);
+
+                *acquired = (hr != WAIT_TIMEOUT);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTarget::ReleaseSharedAccess(
+        uint64_t key)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto& resource = GetD2DBitmap();
+
+                auto keyedMutex = GetKeyedMutex(resource.Get());
+
+                // A drawing session holds commands that haven't been sent to
+                // the GPU yet, and those must happen before the hand over.
+                if (*m_hasActiveDrawingSession)
+                    ThrowHR(E_FAIL, Strings::SharedRenderTargetReleasedWithActiveDrawingSession);
+
+                ThrowIfFailed(keyedMutex->ReleaseSync(key));
+            });
+    }
+
+
     ActivatableClassWithFactory(CanvasRenderTarget, CanvasRenderTargetFactory);
 }}}}
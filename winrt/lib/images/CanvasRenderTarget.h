@@ -63,6 +63,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             float dpi,
             CanvasAlphaMode alpha,
             ICanvasRenderTarget** canvasRenderTarget) override;
+
+        IFACEMETHOD(CreateShared)(
+            ICanvasResourceCreator* resourceCreator,
+            float width,
+            float height,
+            float dpi,
+            DirectXPixelFormat format,
+            CanvasAlphaMode alpha,
+            ICanvasRenderTarget** renderTarget) override;
+
+        IFACEMETHOD(OpenShared)(
+            ICanvasResourceCreator* resourceCreator,
+            uint64_t sharedHandle,
+            float dpi,
+            CanvasAlphaMode alpha,
+            ICanvasRenderTarget** renderTarget) override;
     };
 
 
@@ -100,5 +116,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         IFACEMETHOD(CreateDrawingSession)(
             ICanvasDrawingSession** drawingSession) override;
+
+        IFACEMETHOD(CreateSharedHandle)(
+            uint64_t* sharedHandle) override;
+
+        IFACEMETHOD(AcquireSharedAccess)(
+            uint64_t key,
+            int32_t timeoutInMilliseconds,
+            boolean* acquired) override;
+
+        IFACEMETHOD(ReleaseSharedAccess)(
+            uint64_t key) override;
+
+        bool HasActiveDrawingSession() const
+        {
+            return *m_hasActiveDrawingSession;
+        }
     };
 }}}}
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasRenderTargetPool.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasRenderTargetPoolFactory
+    //
+
+    IFACEMETHODIMP CanvasRenderTargetPoolFactory::GetForDevice(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasRenderTargetPool** pool)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(pool);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newPool = Make<CanvasRenderTargetPool>(device.Get());
+                CheckMakeResult(newPool);
+
+                ThrowIfFailed(newPool.CopyTo(pool));
+            });
+    }
+
+
+    //
+    // CanvasRenderTargetPool
+    //
+
+    CanvasRenderTargetPool::CanvasRenderTargetPool(ICanvasDevice* device)
+        : m_device(device)
+    {
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::Rent(
+        Size size,
+        float dpi,
+        ICanvasRenderTarget** renderTarget)
+    {
+        return RentWithFormatAndAlpha(
+            size,
+            dpi,
+            PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+            CanvasAlphaMode::Premultiplied,
+            renderTarget);
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::RentWithFormatAndAlpha(
+        Size size,
+        float dpi,
+        DirectXPixelFormat format,
+        CanvasAlphaMode alpha,
+        ICanvasRenderTarget** renderTarget)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(renderTarget);
+
+                auto deviceInternal = As<ICanvasDeviceInternal>(m_device);
+                auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+                auto pixelWidth = static_cast<uint32_t>(SizeDipsToPixels(size.Width, dpi));
+                auto pixelHeight = static_cast<uint32_t>(SizeDipsToPixels(size.Height, dpi));
+
+                // Report oversized requests the same way CanvasRenderTarget does.
+                auto maximumBitmapSize = deviceContext->GetMaximumBitmapSize();
+
+                if (pixelWidth > maximumBitmapSize || pixelHeight > maximumBitmapSize)
+                    deviceInternal->ThrowIfCreateSurfaceFailed(E_INVALIDARG, L"CanvasRenderTarget", pixelWidth, pixelHeight);
+
+                auto d2dBitmap = deviceInternal->GetRenderTargetPool()->Acquire(
+                    deviceContext.Get(),
+                    D2D1_SIZE_U{ pixelWidth, pixelHeight },
+                    D2D1::PixelFormat(static_cast<DXGI_FORMAT>(format), ToD2DAlphaMode(alpha)),
+                    dpi);
+
+                auto newRenderTarget = Make<CanvasRenderTarget>(m_device.Get(), d2dBitmap.Get());
+                CheckMakeResult(newRenderTarget);
+
+                ThrowIfFailed(newRenderTarget.CopyTo(renderTarget));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::Return(
+        ICanvasRenderTarget* renderTarget)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(renderTarget);
+
+                auto renderTargetImpl = static_cast<CanvasRenderTarget*>(renderTarget);
+
+                if (renderTargetImpl->HasActiveDrawingSession())
+                    ThrowHR(E_FAIL, Strings::RenderTargetPoolCannotReturnWithActiveDrawingSession);
+
+                ComPtr<ICanvasDevice> renderTargetDevice;
+                ThrowIfFailed(As<ICanvasResourceCreator>(renderTarget)->get_Device(&renderTargetDevice));
+
+                if (!IsSameInstance(renderTargetDevice.Get(), m_device.Get()))
+                    ThrowHR(E_INVALIDARG, Strings::RenderTargetPoolWrongDevice);
+
+                ComPtr<ID2D1Bitmap1> d2dBitmap = As<ICanvasBitmapInternal>(renderTarget)->GetD2DBitmap();
+
+                // Close the wrapper, so nothing can go on drawing to the bitmap
+                // after it has been handed out to somebody else.
+                ThrowIfFailed(As<IClosable>(renderTarget)->Close());
+
+                As<ICanvasDeviceInternal>(m_device)->GetRenderTargetPool()->Release(d2dBitmap.Get());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::get_MaximumIdleCount(INT32* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = static_cast<INT32>(GetPool()->GetMaximumIdleCount());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::put_MaximumIdleCount(INT32 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                GetPool()->SetMaximumIdleCount(static_cast<uint32_t>(value));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::get_MaximumIdleSizeInBytes(UINT64* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = GetPool()->GetMaximumIdleSize();
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::put_MaximumIdleSizeInBytes(UINT64 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetPool()->SetMaximumIdleSize(value);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::get_Statistics(CanvasRenderTargetPoolStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto statistics = GetPool()->GetStatistics();
+
+                value->RentCount = statistics.RentCount;
+                value->ReuseCount = statistics.ReuseCount;
+                value->ReturnCount = statistics.ReturnCount;
+                value->IdleCount = statistics.IdleCount;
+                value->IdleSizeInBytes = statistics.IdleSize;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::Trim()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetPool()->Clear();
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasRenderTargetPool::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+
+    RenderTargetPool* CanvasRenderTargetPool::GetPool()
+    {
+        return As<ICanvasDeviceInternal>(m_device)->GetRenderTargetPool();
+    }
+
+
+    ActivatableStaticOnlyFactory(CanvasRenderTargetPoolFactory);
+}}}}
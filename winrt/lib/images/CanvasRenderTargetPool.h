@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Windows::Foundation;
+
+
+    class CanvasRenderTargetPoolFactory
+        : public AgileActivationFactory<ICanvasRenderTargetPoolStatics>
+        , private LifespanTracker<CanvasRenderTargetPoolFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasRenderTargetPool, BaseTrust);
+
+    public:
+        IFACEMETHOD(GetForDevice)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasRenderTargetPool** pool) override;
+    };
+
+
+    //
+    // The pooled bitmaps themselves belong to the device's RenderTargetPool,
+    // so this is just a handle onto that.  It holds the bitmaps rather than
+    // CanvasRenderTarget wrappers, since a wrapper would keep the device alive
+    // from inside the device.
+    //
+    class CanvasRenderTargetPool
+        : public RuntimeClass<
+            ICanvasRenderTargetPool,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasRenderTargetPool>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasRenderTargetPool, BaseTrust);
+
+        ComPtr<ICanvasDevice> m_device;
+
+    public:
+        CanvasRenderTargetPool(ICanvasDevice* device);
+
+        IFACEMETHOD(Rent)(
+            Size size,
+            float dpi,
+            ICanvasRenderTarget** renderTarget) override;
+
+        IFACEMETHOD(RentWithFormatAndAlpha)(
+            Size size,
+            float dpi,
+            DirectXPixelFormat format,
+            CanvasAlphaMode alpha,
+            ICanvasRenderTarget** renderTarget) override;
+
+        IFACEMETHOD(Return)(
+            ICanvasRenderTarget* renderTarget) override;
+
+        IFACEMETHOD(get_MaximumIdleCount)(INT32* value) override;
+        IFACEMETHOD(put_MaximumIdleCount)(INT32 value) override;
+
+        IFACEMETHOD(get_MaximumIdleSizeInBytes)(UINT64* value) override;
+        IFACEMETHOD(put_MaximumIdleSizeInBytes)(UINT64 value) override;
+
+        IFACEMETHOD(get_Statistics)(CanvasRenderTargetPoolStatistics* value) override;
+
+        IFACEMETHOD(Trim)() override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+    private:
+        RenderTargetPool* GetPool();
+    };
+}}}}
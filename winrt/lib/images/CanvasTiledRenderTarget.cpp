@@ -0,0 +1,604 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasTiledRenderTarget.h"
+#include "ScopedBitmapMappedPixelAccess.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasTiledRenderTargetFactory
+    //
+
+    IFACEMETHODIMP CanvasTiledRenderTargetFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        float width,
+        float height,
+        float dpi,
+        ICanvasTiledRenderTarget** renderTarget)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(renderTarget);
+
+                // A tile size of zero picks the default.
+                auto tiledRenderTarget = CanvasTiledRenderTarget::CreateNew(
+                    resourceCreator,
+                    width,
+                    height,
+                    dpi,
+                    0);
+
+                ThrowIfFailed(tiledRenderTarget.CopyTo(renderTarget));
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTargetFactory::CreateWithTileSize(
+        ICanvasResourceCreator* resourceCreator,
+        float width,
+        float height,
+        float dpi,
+        int32_t tileSizeInPixels,
+        ICanvasTiledRenderTarget** renderTarget)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(renderTarget);
+
+                if (tileSizeInPixels <= 0)
+                    ThrowHR(E_INVALIDARG);
+
+                auto tiledRenderTarget = CanvasTiledRenderTarget::CreateNew(
+                    resourceCreator,
+                    width,
+                    height,
+                    dpi,
+                    tileSizeInPixels);
+
+                ThrowIfFailed(tiledRenderTarget.CopyTo(renderTarget));
+            });
+    }
+
+
+    //
+    // TileLayout
+    //
+
+    TileLayout::TileLayout(BitmapSize size, uint32_t tileSize)
+        : m_size(size)
+        , m_tileSize(tileSize)
+    {
+    }
+
+    uint32_t TileLayout::GetColumnCount() const
+    {
+        return (m_size.Width + m_tileSize - 1) / m_tileSize;
+    }
+
+    uint32_t TileLayout::GetRowCount() const
+    {
+        return (m_size.Height + m_tileSize - 1) / m_tileSize;
+    }
+
+    D2D1_RECT_U TileLayout::GetTile(uint32_t column, uint32_t row) const
+    {
+        auto left = column * m_tileSize;
+        auto top = row * m_tileSize;
+
+        return D2D1_RECT_U
+        {
+            left,
+            top,
+            std::min(left + m_tileSize, m_size.Width),
+            std::min(top + m_tileSize, m_size.Height)
+        };
+    }
+
+
+    //
+    // Keeps one render target for each size of tile, so that the interior
+    // tiles and those cut down along the edges can each reuse theirs.
+    //
+    class TileTargets
+    {
+        ComPtr<ICanvasDevice> m_device;
+        float m_dpi;
+        std::vector<ComPtr<CanvasRenderTarget>> m_targets;
+
+    public:
+        TileTargets(ICanvasDevice* device, float dpi)
+            : m_device(device)
+            , m_dpi(dpi)
+        {
+        }
+
+        ComPtr<CanvasRenderTarget> Get(uint32_t width, uint32_t height)
+        {
+            for (auto& target : m_targets)
+            {
+                auto size = GetWrappedResource<ID2D1Bitmap1>(target)->GetPixelSize();
+
+                if (size.width == width && size.height == height)
+                    return target;
+            }
+
+            auto target = CanvasRenderTarget::CreateNew(
+                m_device.Get(),
+                PixelsToDips(width, m_dpi),
+                PixelsToDips(height, m_dpi),
+                m_dpi,
+                PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                CanvasAlphaMode::Premultiplied);
+
+            m_targets.push_back(target);
+            return target;
+        }
+    };
+
+
+    //
+    // Replays the command lists into one tile.  Commands that lie outside the
+    // tile are culled by the command lists' spatial indexes.
+    //
+    static void DrawTile(
+        ICanvasDevice* device,
+        ID2D1DeviceContext1* deviceContext,
+        std::vector<ComPtr<CanvasCommandList>> const& commandLists,
+        ID2D1Bitmap1* target,
+        float dpi,
+        D2D1_RECT_U const& tile)
+    {
+        D2D1_RECT_F visibleRectangle
+        {
+            PixelsToDips(tile.left, dpi),
+            PixelsToDips(tile.top, dpi),
+            PixelsToDips(tile.right, dpi),
+            PixelsToDips(tile.bottom, dpi)
+        };
+
+        auto restoreState = MakeScopeWarden(
+            [&]
+            {
+                deviceContext->SetTarget(nullptr);
+                deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+                deviceContext->SetDpi(DEFAULT_DPI, DEFAULT_DPI);
+            });
+
+        deviceContext->SetTarget(target);
+        deviceContext->SetDpi(dpi, dpi);
+        deviceContext->BeginDraw();
+        deviceContext->Clear(D2D1::ColorF(0, 0));
+        deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(-visibleRectangle.left, -visibleRectangle.top));
+
+        for (auto& commandList : commandLists)
+        {
+            auto d2dImage = commandList->GetCulledD2DImage(device, deviceContext, visibleRectangle);
+
+            if (!d2dImage)
+                d2dImage = commandList->GetD2DImage(device, deviceContext, GetImageFlags::None, dpi, nullptr);
+
+            deviceContext->DrawImage(d2dImage.Get());
+        }
+
+        ThrowIfFailed(deviceContext->EndDraw());
+    }
+
+
+    static void CopyTileToBand(
+        ICanvasDevice* device,
+        ComPtr<ID2D1Bitmap1> const& stagingBitmap,
+        D2D1_RECT_U const& tile,
+        uint8_t* band,
+        uint32_t bandStride)
+    {
+        ScopedBitmapMappedPixelAccess pixels(device, stagingBitmap);
+
+        auto rowBytes = (tile.right - tile.left) * 4;
+        auto dest = band + tile.left * 4;
+        auto source = pixels.GetLockedData();
+
+        for (uint32_t row = tile.top; row < tile.bottom; row++)
+        {
+            memcpy(dest, source, rowBytes);
+
+            dest += bandStride;
+            source += pixels.GetStride();
+        }
+    }
+
+
+    //
+    // Encodes a row of tiles at a time.  Each tile is read back through a
+    // staging bitmap while the GPU draws the next one.
+    //
+    static void SaveInTiles(
+        ICanvasDevice* device,
+        std::vector<ComPtr<CanvasCommandList>> const& commandLists,
+        BitmapSize size,
+        float dpi,
+        uint32_t tileSize,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality)
+    {
+        auto& factory = WicAdapter::GetInstance()->GetFactory();
+
+        ComPtr<IWICBitmapEncoder> encoder;
+        ComPtr<IWICBitmapFrameEncode> frame;
+        CreateWicFrameEncode(factory.Get(), stream, containerFormat, quality, WicEncoderOptions{}, &encoder, &frame);
+
+        ThrowIfFailed(frame->SetSize(size.Width, size.Height));
+        ThrowIfFailed(frame->SetResolution(dpi, dpi));
+
+        // The encoder changes this to the closest format it supports.
+        GUID encodeFormat = GUID_WICPixelFormat32bppPBGRA;
+        ThrowIfFailed(frame->SetPixelFormat(&encodeFormat));
+
+        auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+        TileTargets targets(device, dpi);
+        TileLayout layout(size, tileSize);
+
+        auto bandStride = size.Width * 4;
+        std::vector<uint8_t> band(static_cast<size_t>(bandStride) * std::min(tileSize, size.Height));
+
+        for (uint32_t row = 0; row < layout.GetRowCount(); row++)
+        {
+            ComPtr<ID2D1Bitmap1> pendingCopy;
+            D2D1_RECT_U pendingTile{};
+
+            for (uint32_t column = 0; column < layout.GetColumnCount(); column++)
+            {
+                AsyncCancellation::ThrowIfCanceled();
+
+                auto tile = layout.GetTile(column, row);
+                auto target = GetWrappedResource<ID2D1Bitmap1>(targets.Get(tile.right - tile.left, tile.bottom - tile.top));
+
+                DrawTile(device, lease.Get(), commandLists, target.Get(), dpi, tile);
+
+                auto copy = ScopedBitmapMappedPixelAccess::BeginCopy(device, target.Get(), nullptr);
+
+                if (pendingCopy)
+                    CopyTileToBand(device, pendingCopy, pendingTile, band.data(), bandStride);
+
+                pendingCopy = copy;
+                pendingTile = tile;
+            }
+
+            CopyTileToBand(device, pendingCopy, pendingTile, band.data(), bandStride);
+
+            auto bandHeight = pendingTile.bottom - pendingTile.top;
+
+            WriteWicFramePixels(
+                factory.Get(),
+                frame.Get(),
+                GUID_WICPixelFormat32bppPBGRA,
+                encodeFormat,
+                size.Width,
+                bandHeight,
+                bandStride,
+                bandStride * bandHeight,
+                band.data());
+        }
+
+        ThrowIfFailed(frame->Commit());
+        ThrowIfFailed(encoder->Commit());
+    }
+
+
+    //
+    // GIF encoders need to see the whole image to choose a palette, so are
+    // given the drawing as one command list for WIC to render as it likes.
+    //
+    static void SaveAsCommandList(
+        ICanvasDevice* device,
+        std::vector<ComPtr<CanvasCommandList>> const& commandLists,
+        BitmapSize size,
+        float dpi,
+        IStream* stream,
+        GUID const& containerFormat,
+        float quality)
+    {
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+        auto lease = deviceInternal->GetResourceCreationDeviceContext();
+        auto deviceContext = lease.Get();
+
+        auto d2dCommandList = deviceInternal->CreateCommandList();
+
+        {
+            auto restoreState = MakeScopeWarden([&] { deviceContext->SetTarget(nullptr); });
+
+            deviceContext->SetTarget(d2dCommandList.Get());
+            deviceContext->BeginDraw();
+
+            for (auto& commandList : commandLists)
+            {
+                deviceContext->DrawImage(commandList->GetD2DImage(device, deviceContext, GetImageFlags::None, dpi, nullptr).Get());
+            }
+
+            ThrowIfFailed(deviceContext->EndDraw());
+        }
+
+        ThrowIfFailed(d2dCommandList->Close());
+
+        WICImageParameters parameters{};
+        parameters.PixelFormat.format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        parameters.PixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
+        parameters.DpiX = dpi;
+        parameters.DpiY = dpi;
+        parameters.PixelWidth = size.Width;
+        parameters.PixelHeight = size.Height;
+
+        CanvasImageAdapter::GetInstance()->SaveImage(
+            d2dCommandList.Get(),
+            parameters,
+            deviceInternal->GetD2DDevice().Get(),
+            stream,
+            containerFormat,
+            quality,
+            WicEncoderOptions{});
+    }
+
+
+    //
+    // CanvasTiledRenderTarget
+    //
+
+    ComPtr<CanvasTiledRenderTarget> CanvasTiledRenderTarget::CreateNew(
+        ICanvasResourceCreator* resourceCreator,
+        float width,
+        float height,
+        float dpi,
+        int32_t tileSizeInPixels)
+    {
+        if (!(width > 0) || !(height > 0) || !(dpi > 0))
+            ThrowHR(E_INVALIDARG);
+
+        auto device = GetCanvasDevice(resourceCreator);
+
+        int32_t maximumBitmapSize;
+        ThrowIfFailed(device->get_MaximumBitmapSizeInPixels(&maximumBitmapSize));
+
+        if (tileSizeInPixels == 0)
+            tileSizeInPixels = std::min(DefaultTileSize, maximumBitmapSize);
+        else if (tileSizeInPixels > maximumBitmapSize)
+            ThrowHR(E_INVALIDARG);
+
+        auto tiledRenderTarget = Make<CanvasTiledRenderTarget>(
+            device.Get(),
+            Size{ width, height },
+            dpi,
+            tileSizeInPixels);
+        CheckMakeResult(tiledRenderTarget);
+
+        return tiledRenderTarget;
+    }
+
+    CanvasTiledRenderTarget::CanvasTiledRenderTarget(
+        ICanvasDevice* device,
+        Size size,
+        float dpi,
+        int32_t tileSizeInPixels)
+        : m_device(device)
+        , m_size(size)
+        , m_sizeInPixels{ static_cast<uint32_t>(SizeDipsToPixels(size.Width, dpi)), static_cast<uint32_t>(SizeDipsToPixels(size.Height, dpi)) }
+        , m_dpi(dpi)
+        , m_tileSize(tileSizeInPixels)
+    {
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::Close()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                Lock lock(m_mutex);
+
+                m_commandLists.clear();
+                m_device.Reset();
+            });
+    }
+
+    void CanvasTiledRenderTarget::ThrowIfClosed()
+    {
+        if (!m_device)
+            ThrowHR(RO_E_CLOSED);
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::CreateDrawingSession(ICanvasDrawingSession** drawingSession)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(drawingSession);
+
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                auto commandList = CanvasCommandList::CreateNew(m_device.Get());
+                ThrowIfFailed(commandList->put_IsSpatialIndexEnabled(true));
+
+                ThrowIfFailed(commandList->CreateDrawingSession(drawingSession));
+
+                m_commandLists.push_back(commandList);
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                Lock lock(m_mutex);
+                ThrowIfClosed();
+
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::get_Dpi(float* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_dpi;
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::get_Size(Size* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_size;
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::get_SizeInPixels(BitmapSize* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_sizeInPixels;
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::get_TileSizeInPixels(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_tileSize;
+            });
+    }
+
+    std::vector<ComPtr<CanvasCommandList>> CanvasTiledRenderTarget::GetCommandListsForDrawing()
+    {
+        Lock lock(m_mutex);
+        ThrowIfClosed();
+
+        for (auto& commandList : m_commandLists)
+        {
+            commandList->GetD2DImage(m_device.Get(), nullptr, GetImageFlags::None, m_dpi, nullptr);
+        }
+
+        return m_commandLists;
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::SaveAsync(
+        IRandomAccessStream* stream,
+        CanvasBitmapFileFormat fileFormat,
+        IAsyncAction** action)
+    {
+        return SaveWithQualityAsync(stream, fileFormat, DEFAULT_CANVASBITMAP_QUALITY, action);
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::SaveWithQualityAsync(
+        IRandomAccessStream* rawStream,
+        CanvasBitmapFileFormat fileFormat,
+        float quality,
+        IAsyncAction** action)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(rawStream);
+                CheckAndClearOutPointer(action);
+
+                if (fileFormat == CanvasBitmapFileFormat::Auto)
+                    ThrowHR(E_INVALIDARG, Strings::AutoFileFormatNotAllowed);
+
+                if (quality < 0.0f || quality > 1.0f)
+                    ThrowHR(E_INVALIDARG);
+
+                auto commandLists = GetCommandListsForDrawing();
+                auto containerFormat = GetGUIDForFileFormat(fileFormat);
+
+                ComPtr<ICanvasDevice> device = m_device;
+                ComPtr<IRandomAccessStream> randomAccessStream(rawStream);
+                auto size = m_sizeInPixels;
+                auto dpi = m_dpi;
+                auto tileSize = static_cast<uint32_t>(m_tileSize);
+
+                auto asyncAction = Make<AsyncAction>(
+                    [=]
+                    {
+                        ComPtr<IStream> stream;
+                        ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
+
+                        if (containerFormat == GUID_ContainerFormatGif)
+                            SaveAsCommandList(device.Get(), commandLists, size, dpi, stream.Get(), containerFormat, quality);
+                        else
+                            SaveInTiles(device.Get(), commandLists, size, dpi, tileSize, stream.Get(), containerFormat, quality);
+                    });
+
+                CheckMakeResult(asyncAction);
+                ThrowIfFailed(asyncAction.CopyTo(action));
+            });
+    }
+
+    IFACEMETHODIMP CanvasTiledRenderTarget::RenderTilesAsync(
+        ICanvasTiledRenderTargetTileHandler* rawHandler,
+        IAsyncAction** action)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(rawHandler);
+                CheckAndClearOutPointer(action);
+
+                auto commandLists = GetCommandListsForDrawing();
+
+                ComPtr<ICanvasDevice> device = m_device;
+                ComPtr<ICanvasTiledRenderTargetTileHandler> handler(rawHandler);
+                TileLayout layout(m_sizeInPixels, static_cast<uint32_t>(m_tileSize));
+                auto dpi = m_dpi;
+
+                auto asyncAction = Make<AsyncAction>(
+                    [=]
+                    {
+                        TileTargets targets(device.Get(), dpi);
+
+                        for (uint32_t row = 0; row < layout.GetRowCount(); row++)
+                        {
+                            for (uint32_t column = 0; column < layout.GetColumnCount(); column++)
+                            {
+                                AsyncCancellation::ThrowIfCanceled();
+
+                                auto tile = layout.GetTile(column, row);
+                                auto target = targets.Get(tile.right - tile.left, tile.bottom - tile.top);
+
+                                {
+                                    auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+                                    DrawTile(device.Get(), lease.Get(), commandLists, GetWrappedResource<ID2D1Bitmap1>(target).Get(), dpi, tile);
+                                }
+
+                                BitmapBounds bounds{ tile.left, tile.top, tile.right - tile.left, tile.bottom - tile.top };
+                                ThrowIfFailed(handler->Invoke(bounds, target.Get()));
+                            }
+                        }
+                    });
+
+                CheckMakeResult(asyncAction);
+                ThrowIfFailed(asyncAction.CopyTo(action));
+            });
+    }
+}}}}
+
+ActivatableClassWithFactory(CanvasTiledRenderTarget, CanvasTiledRenderTargetFactory);
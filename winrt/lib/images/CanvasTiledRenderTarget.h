@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "CanvasCommandList.h"
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    class CanvasTiledRenderTargetFactory
+        : public AgileActivationFactory<ICanvasTiledRenderTargetStatics>
+        , private LifespanTracker<CanvasTiledRenderTargetFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasTiledRenderTarget, BaseTrust);
+
+    public:
+        IFACEMETHODIMP Create(
+            ICanvasResourceCreator* resourceCreator,
+            float width,
+            float height,
+            float dpi,
+            ICanvasTiledRenderTarget** renderTarget) override;
+
+        IFACEMETHODIMP CreateWithTileSize(
+            ICanvasResourceCreator* resourceCreator,
+            float width,
+            float height,
+            float dpi,
+            int32_t tileSizeInPixels,
+            ICanvasTiledRenderTarget** renderTarget) override;
+    };
+
+
+    //
+    // Splits a render target into tiles no bigger than the tile size, in
+    // rows from the top.  Tiles along the right and bottom edges are cut
+    // down to fit.
+    //
+    class TileLayout
+    {
+        BitmapSize m_size;
+        uint32_t m_tileSize;
+
+    public:
+        TileLayout(BitmapSize size, uint32_t tileSize);
+
+        uint32_t GetColumnCount() const;
+        uint32_t GetRowCount() const;
+
+        D2D1_RECT_U GetTile(uint32_t column, uint32_t row) const;
+    };
+
+
+    class CanvasTiledRenderTarget
+        : public RuntimeClass<
+            ICanvasTiledRenderTarget,
+            IClosable>
+        , private LifespanTracker<CanvasTiledRenderTarget>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasTiledRenderTarget, BaseTrust);
+
+        std::mutex m_mutex;
+
+        ComPtr<ICanvasDevice> m_device;
+        Size m_size;
+        BitmapSize m_sizeInPixels;
+        float m_dpi;
+        int32_t m_tileSize;
+
+        // One for each drawing session, replayed in order.
+        std::vector<ComPtr<CanvasCommandList>> m_commandLists;
+
+    public:
+        // Tiles are no bigger than this unless asked, so that the GPU memory
+        // they take stays modest even where much bigger bitmaps are allowed.
+        static const int32_t DefaultTileSize = 1024;
+
+        static ComPtr<CanvasTiledRenderTarget> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            float width,
+            float height,
+            float dpi,
+            int32_t tileSizeInPixels);
+
+        CanvasTiledRenderTarget(
+            ICanvasDevice* device,
+            Size size,
+            float dpi,
+            int32_t tileSizeInPixels);
+
+        // IClosable
+        IFACEMETHOD(Close)() override;
+
+        // ICanvasTiledRenderTarget
+        IFACEMETHOD(CreateDrawingSession)(ICanvasDrawingSession** drawingSession) override;
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+        IFACEMETHOD(get_Dpi)(float* value) override;
+        IFACEMETHOD(get_Size)(Size* value) override;
+        IFACEMETHOD(get_SizeInPixels)(BitmapSize* value) override;
+        IFACEMETHOD(get_TileSizeInPixels)(int32_t* value) override;
+
+        IFACEMETHOD(SaveAsync)(
+            IRandomAccessStream* stream,
+            CanvasBitmapFileFormat fileFormat,
+            IAsyncAction** action) override;
+
+        IFACEMETHOD(SaveWithQualityAsync)(
+            IRandomAccessStream* stream,
+            CanvasBitmapFileFormat fileFormat,
+            float quality,
+            IAsyncAction** action) override;
+
+        IFACEMETHOD(RenderTilesAsync)(
+            ICanvasTiledRenderTargetTileHandler* handler,
+            IAsyncAction** action) override;
+
+    private:
+        void ThrowIfClosed();
+
+        // Closes the command lists, so that drawing sessions that are still
+        // open are reported on the calling thread, and returns them for a
+        // worker to draw.
+        std::vector<ComPtr<CanvasCommandList>> GetCommandListsForDrawing();
+    };
+}}}}
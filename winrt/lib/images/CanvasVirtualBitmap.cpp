@@ -56,6 +56,7 @@ IFACEMETHODIMP CanvasVirtualBitmapFactory::LoadAsyncFromFileNameWithOptionsAndAl
                 {
                     auto device = GetCanvasDevice(resourceCreator.Get());
                     auto source = CanvasBitmapAdapter::GetInstance()->CreateWicBitmapSource(device.Get(), fileName, true);
+                    AsyncCancellation::ThrowIfCanceled();
                     return CanvasVirtualBitmap::CreateNew(resourceCreator, source, options, alphaMode);
                 });
             CheckMakeResult(operation);
@@ -120,6 +121,7 @@ IFACEMETHODIMP CanvasVirtualBitmapFactory::LoadAsyncFromUriWithOptionsAndAlpha(
 
                     auto device = GetCanvasDevice(resourceCreator.Get());
                     auto source = CanvasBitmapAdapter::GetInstance()->CreateWicBitmapSource(device.Get(), stream.Get(), true);
+                    AsyncCancellation::ThrowIfCanceled();
                     return CanvasVirtualBitmap::CreateNew(resourceCreator, source, options, alphaMode);
                 });
             CheckMakeResult(operation);
@@ -172,6 +174,7 @@ IFACEMETHODIMP CanvasVirtualBitmapFactory::LoadAsyncFromStreamWithOptionsAndAlph
                     
                     auto device = GetCanvasDevice(resourceCreator.Get());
                     auto source = CanvasBitmapAdapter::GetInstance()->CreateWicBitmapSource(device.Get(), stream.Get(), true);
+                    AsyncCancellation::ThrowIfCanceled();
                     return CanvasVirtualBitmap::CreateNew(resourceCreator, source, options, alphaMode);
                 });
             CheckMakeResult(operation);
@@ -294,7 +297,10 @@ CanvasVirtualBitmap::CanvasVirtualBitmap(
     , m_imageSourceFromWic(imageSourceFromWic)
     , m_localBounds(localBounds)
     , m_orientation(orientation)
+    , m_cacheTileColumns((static_cast<uint32_t>(localBounds.Width) + CacheTileSize - 1) / CacheTileSize)
+    , m_cacheTileRows((static_cast<uint32_t>(localBounds.Height) + CacheTileSize - 1) / CacheTileSize)
 {
+    m_cachedTiles.resize(m_cacheTileColumns * m_cacheTileRows);
 }
 
 
@@ -391,20 +397,336 @@ IFACEMETHODIMP CanvasVirtualBitmap::get_IsCachedOnDemand(boolean* value)
         {
             CheckInPointer(value);
 
-            if (!m_imageSourceFromWic)
-                ThrowHR(E_FAIL);
+            *value = IsCachedOnDemand();
+        });
+}
+
+
+ComPtr<ID2D1ImageSourceFromWic> const& CanvasVirtualBitmap::GetImageSourceFromWic()
+{
+    if (!m_imageSourceFromWic)
+        ThrowHR(E_FAIL);
+
+    return m_imageSourceFromWic;
+}
+
+
+bool CanvasVirtualBitmap::IsCachedOnDemand()
+{
+    // We probe the image source to determine whether or not it supports
+    // demand caching by calling EnsureCached on a zero sized region.
+    //
+    // This will fail quickly if the image source doesn't support cache
+    // on demand.
+    HRESULT hr = GetImageSourceFromWic()->EnsureCached(D2D1_RECT_U{ 0, 0, 0, 0 });
+
+    return hr != D2DERR_UNSUPPORTED_OPERATION;
+}
+
+
+D2D1_RECT_U CanvasVirtualBitmap::ToPixelRect(Rect const& region)
+{
+    auto width = m_localBounds.Width;
+    auto height = m_localBounds.Height;
+
+    // CanvasVirtualBitmap is always 96 DPI, so DIPs are pixels.
+    auto left   = std::min(std::max(floorf(region.X - m_localBounds.X), 0.0f), width);
+    auto top    = std::min(std::max(floorf(region.Y - m_localBounds.Y), 0.0f), height);
+    auto right  = std::min(std::max(ceilf(region.X + region.Width - m_localBounds.X), left), width);
+    auto bottom = std::min(std::max(ceilf(region.Y + region.Height - m_localBounds.Y), top), height);
+
+    return D2D1_RECT_U
+    {
+        static_cast<uint32_t>(left),
+        static_cast<uint32_t>(top),
+        static_cast<uint32_t>(right),
+        static_cast<uint32_t>(bottom)
+    };
+}
+
+
+D2D1_RECT_U CanvasVirtualBitmap::ToSourceRect(D2D1_RECT_U const& r)
+{
+    //
+    // D2D1_ORIENTATION flips the source horizontally (if at all) and then
+    // rotates it clockwise, so we undo the rotation first and then the flip.
+    //
+    uint32_t quarterTurns = 0;
+    bool flip = false;
+
+    switch (m_orientation)
+    {
+    case D2D1_ORIENTATION_FLIP_HORIZONTAL:                      quarterTurns = 0; flip = true;  break;
+    case D2D1_ORIENTATION_ROTATE_CLOCKWISE180:                  quarterTurns = 2; flip = false; break;
+    case D2D1_ORIENTATION_ROTATE_CLOCKWISE180_FLIP_HORIZONTAL:  quarterTurns = 2; flip = true;  break;
+    case D2D1_ORIENTATION_ROTATE_CLOCKWISE90_FLIP_HORIZONTAL:   quarterTurns = 1; flip = true;  break;
+    case D2D1_ORIENTATION_ROTATE_CLOCKWISE270:                  quarterTurns = 3; flip = false; break;
+    case D2D1_ORIENTATION_ROTATE_CLOCKWISE270_FLIP_HORIZONTAL:  quarterTurns = 3; flip = true;  break;
+    case D2D1_ORIENTATION_ROTATE_CLOCKWISE90:                   quarterTurns = 1; flip = false; break;
+    }
+
+    auto width = static_cast<uint32_t>(m_localBounds.Width);
+    auto height = static_cast<uint32_t>(m_localBounds.Height);
+
+    D2D1_RECT_U source;
+
+    switch (quarterTurns)
+    {
+    case 1:  source = D2D1_RECT_U{ r.top, width - r.right, r.bottom, width - r.left }; break;
+    case 2:  source = D2D1_RECT_U{ width - r.right, height - r.bottom, width - r.left, height - r.top }; break;
+    case 3:  source = D2D1_RECT_U{ height - r.bottom, r.left, height - r.top, r.right }; break;
+    default: source = r; break;
+    }
+
+    if (flip)
+    {
+        auto sourceWidth = (quarterTurns % 2) ? height : width;
+        source = D2D1_RECT_U{ sourceWidth - source.right, source.top, sourceWidth - source.left, source.bottom };
+    }
+
+    return source;
+}
+
+
+D2D1_RECT_U CanvasVirtualBitmap::ToTileRect(D2D1_RECT_U const& r)
+{
+    return D2D1_RECT_U
+    {
+        r.left / CacheTileSize,
+        r.top / CacheTileSize,
+        (r.right + CacheTileSize - 1) / CacheTileSize,
+        (r.bottom + CacheTileSize - 1) / CacheTileSize
+    };
+}
+
+
+static bool IsEmpty(D2D1_RECT_U const& r)
+{
+    return r.right <= r.left || r.bottom <= r.top;
+}
+
+
+IFACEMETHODIMP CanvasVirtualBitmap::EnsureCached(Rect region)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto& imageSource = GetImageSourceFromWic();
+
+            auto pixelRect = ToPixelRect(region);
+
+            if (IsEmpty(pixelRect))
+                return;
+
+            // Round out to whole tiles, so we know exactly which of them are cached.
+            auto tiles = ToTileRect(pixelRect);
+
+            auto tileAlignedRect = D2D1_RECT_U
+            {
+                tiles.left * CacheTileSize,
+                tiles.top * CacheTileSize,
+                std::min(tiles.right * CacheTileSize, static_cast<uint32_t>(m_localBounds.Width)),
+                std::min(tiles.bottom * CacheTileSize, static_cast<uint32_t>(m_localBounds.Height))
+            };
+
+            auto sourceRect = ToSourceRect(tileAlignedRect);
+
+            HRESULT hr = imageSource->EnsureCached(&sourceRect);
+
+            // Without cache on demand the whole image is already loaded.
+            if (hr == D2DERR_UNSUPPORTED_OPERATION)
+                return;
+
+            ThrowIfFailed(hr);
+
+            Lock lock(m_cacheMutex);
+
+            for (auto y = tiles.top; y < tiles.bottom; y++)
+            {
+                for (auto x = tiles.left; x < tiles.right; x++)
+                {
+                    m_cachedTiles[y * m_cacheTileColumns + x] = true;
+                }
+            }
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualBitmap::TrimCache()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            HRESULT hr = GetImageSourceFromWic()->TrimCache(nullptr);
+
+            if (hr == D2DERR_UNSUPPORTED_OPERATION)
+                return;
+
+            ThrowIfFailed(hr);
+
+            Lock lock(m_cacheMutex);
+
+            std::fill(m_cachedTiles.begin(), m_cachedTiles.end(), false);
+        });
+}
 
-            // We probe the image source to determine whether or not it supports
-            // demand caching by calling EnsureCached on a zero sized region.
-            //
-            // This will fail quickly if the image source doesn't support cache
-            // on demand.
-            HRESULT hr = m_imageSourceFromWic->EnsureCached(D2D1_RECT_U{ 0, 0, 0, 0 });
+
+IFACEMETHODIMP CanvasVirtualBitmap::TrimCacheWithRegionToPreserve(Rect regionToPreserve)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto& imageSource = GetImageSourceFromWic();
+
+            auto pixelRect = ToPixelRect(regionToPreserve);
+            auto sourceRect = ToSourceRect(pixelRect);
+
+            HRESULT hr = imageSource->TrimCache(&sourceRect);
 
             if (hr == D2DERR_UNSUPPORTED_OPERATION)
-                *value = FALSE;
-            else
-                *value = TRUE;
+                return;
+
+            ThrowIfFailed(hr);
+
+            Lock lock(m_cacheMutex);
+
+            // Only tiles that are entirely inside the preserved region are still known to be cached.
+            for (uint32_t y = 0; y < m_cacheTileRows; y++)
+            {
+                for (uint32_t x = 0; x < m_cacheTileColumns; x++)
+                {
+                    auto tileRight = std::min((x + 1) * CacheTileSize, static_cast<uint32_t>(m_localBounds.Width));
+                    auto tileBottom = std::min((y + 1) * CacheTileSize, static_cast<uint32_t>(m_localBounds.Height));
+
+                    bool isPreserved = x * CacheTileSize >= pixelRect.left &&
+                                       y * CacheTileSize >= pixelRect.top &&
+                                       tileRight <= pixelRect.right &&
+                                       tileBottom <= pixelRect.bottom;
+
+                    if (!isPreserved)
+                        m_cachedTiles[y * m_cacheTileColumns + x] = false;
+                }
+            }
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualBitmap::IsRegionCached(Rect region, boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            if (!IsCachedOnDemand())
+            {
+                *value = true;
+                return;
+            }
+
+            auto tiles = ToTileRect(ToPixelRect(region));
+
+            Lock lock(m_cacheMutex);
+
+            *value = true;
+
+            for (auto y = tiles.top; y < tiles.bottom; y++)
+            {
+                for (auto x = tiles.left; x < tiles.right; x++)
+                {
+                    if (!m_cachedTiles[y * m_cacheTileColumns + x])
+                        *value = false;
+                }
+            }
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualBitmap::get_CachedBounds(Rect* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            if (!IsCachedOnDemand())
+            {
+                *value = m_localBounds;
+                return;
+            }
+
+            Lock lock(m_cacheMutex);
+
+            auto tiles = D2D1_RECT_U{ m_cacheTileColumns, m_cacheTileRows, 0, 0 };
+
+            for (uint32_t y = 0; y < m_cacheTileRows; y++)
+            {
+                for (uint32_t x = 0; x < m_cacheTileColumns; x++)
+                {
+                    if (m_cachedTiles[y * m_cacheTileColumns + x])
+                    {
+                        tiles.left = std::min(tiles.left, x);
+                        tiles.top = std::min(tiles.top, y);
+                        tiles.right = std::max(tiles.right, x + 1);
+                        tiles.bottom = std::max(tiles.bottom, y + 1);
+                    }
+                }
+            }
+
+            if (IsEmpty(tiles))
+            {
+                *value = Rect{};
+                return;
+            }
+
+            auto left = static_cast<float>(tiles.left * CacheTileSize);
+            auto top = static_cast<float>(tiles.top * CacheTileSize);
+            auto right = std::min(static_cast<float>(tiles.right * CacheTileSize), m_localBounds.Width);
+            auto bottom = std::min(static_cast<float>(tiles.bottom * CacheTileSize), m_localBounds.Height);
+
+            *value = Rect{ m_localBounds.X + left, m_localBounds.Y + top, right - left, bottom - top };
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualBitmap::get_CachedSizeInBytes(uint64_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            // D2D keeps cached pixels in a 32 bits per pixel format.
+            const uint64_t bytesPerPixel = 4;
+
+            auto width = static_cast<uint32_t>(m_localBounds.Width);
+            auto height = static_cast<uint32_t>(m_localBounds.Height);
+
+            if (!IsCachedOnDemand())
+            {
+                *value = static_cast<uint64_t>(width) * height * bytesPerPixel;
+                return;
+            }
+
+            Lock lock(m_cacheMutex);
+
+            uint64_t pixelCount = 0;
+
+            for (uint32_t y = 0; y < m_cacheTileRows; y++)
+            {
+                for (uint32_t x = 0; x < m_cacheTileColumns; x++)
+                {
+                    if (m_cachedTiles[y * m_cacheTileColumns + x])
+                    {
+                        auto tileWidth = std::min(width - x * CacheTileSize, static_cast<uint32_t>(CacheTileSize));
+                        auto tileHeight = std::min(height - y * CacheTileSize, static_cast<uint32_t>(CacheTileSize));
+
+                        pixelCount += static_cast<uint64_t>(tileWidth) * tileHeight;
+                    }
+                }
+            }
+
+            *value = pixelCount * bytesPerPixel;
         });
 }
 
@@ -6,6 +6,8 @@
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 
+#include "utils/LockUtilities.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     class CanvasVirtualBitmapFactory :
@@ -94,6 +96,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ComPtr<ID2D1ImageSourceFromWic> m_imageSourceFromWic;
         Rect m_localBounds;
         D2D1_ORIENTATION m_orientation;
+
+        //
+        // D2D doesn't report what a cache on demand image source has cached,
+        // so we keep track of the regions that EnsureCached has been asked
+        // for, as a grid of CacheTileSize square tiles over the bitmap.
+        //
+        static const uint32_t CacheTileSize = 256;
+
+        std::mutex m_cacheMutex;
+        std::vector<bool> m_cachedTiles;
+        uint32_t m_cacheTileColumns;
+        uint32_t m_cacheTileRows;
         
     public:
         static ComPtr<CanvasVirtualBitmap> CreateNew(
@@ -122,6 +136,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHODIMP get_SizeInPixels(BitmapSize* value) override;
         IFACEMETHODIMP get_Size(Size* value) override;
         IFACEMETHODIMP get_Bounds(Rect* value) override;
+        IFACEMETHODIMP EnsureCached(Rect region) override;
+        IFACEMETHODIMP TrimCache() override;
+        IFACEMETHODIMP TrimCacheWithRegionToPreserve(Rect regionToPreserve) override;
+        IFACEMETHODIMP IsRegionCached(Rect region, boolean* value) override;
+        IFACEMETHODIMP get_CachedBounds(Rect* value) override;
+        IFACEMETHODIMP get_CachedSizeInBytes(uint64_t* value) override;
 
         // ICanvasImage
         IFACEMETHODIMP GetBounds(ICanvasResourceCreator*, Rect*) override;
@@ -129,6 +149,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         // ICanvasImageInternal
         ComPtr<ID2D1Image> GetD2DImage(ICanvasDevice* , ID2D1DeviceContext*, GetImageFlags, float, float*) override;
+
+    private:
+        ComPtr<ID2D1ImageSourceFromWic> const& GetImageSourceFromWic();
+        bool IsCachedOnDemand();
+
+        // Converts a region of the bitmap to whole pixels, clipped to its bounds.
+        D2D1_RECT_U ToPixelRect(Rect const& region);
+
+        // Maps a pixel rectangle of the oriented bitmap to the WIC source, which D2D caches.
+        D2D1_RECT_U ToSourceRect(D2D1_RECT_U const& rect);
+
+        // Returns the range of cache tiles that a pixel rectangle touches.
+        D2D1_RECT_U ToTileRect(D2D1_RECT_U const& rect);
     };
 
 }}}}
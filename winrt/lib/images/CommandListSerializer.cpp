@@ -0,0 +1,1679 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CommandListSerializer.h"
+#include "ScopedBitmapMappedPixelAccess.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    enum class CommandListRecordType : uint16_t
+    {
+        // Resource definitions.
+        SolidColorBrush = 1,
+        GradientStopCollection,
+        LinearGradientBrush,
+        RadialGradientBrush,
+        BitmapBrush,
+        ImageBrush,
+        Bitmap,
+        Geometry,
+        StrokeStyle,
+        CommandList,
+
+        // Drawing commands.
+        SetAntialiasMode = 100,
+        SetTags,
+        SetPrimitiveBlend,
+        SetUnitMode,
+        SetTransform,
+        Clear,
+        DrawLine,
+        DrawRectangle,
+        FillRectangle,
+        DrawGeometry,
+        FillGeometry,
+        DrawBitmap,
+        DrawImage,
+        FillOpacityMask,
+        PushAxisAlignedClip,
+        PopAxisAlignedClip,
+        PushLayer,
+        PopLayer,
+    };
+
+    enum class GeometryOperation : uint32_t
+    {
+        BeginFigure = 1,
+        AddLines,
+        AddBeziers,
+        EndFigure,
+        SetSegmentFlags,
+    };
+
+    static const uint32_t NoResource = 0xFFFFFFFF;
+
+    enum OptionalFields : uint32_t
+    {
+        HasDestinationRectangle = 1,
+        HasSourceRectangle = 2,
+        HasPerspectiveTransform = 4,
+        HasTargetOffset = 8,
+    };
+
+
+    //
+    // Record payloads. These are written and read with memcpy, so their layout
+    // is part of the file format.
+    //
+
+    struct BrushProperties
+    {
+        float Opacity;
+        D2D1_MATRIX_3X2_F Transform;
+    };
+
+    struct SolidColorBrushRecord
+    {
+        BrushProperties Brush;
+        D2D1_COLOR_F Color;
+    };
+
+    struct GradientStopCollectionRecord
+    {
+        uint32_t PreInterpolationSpace;
+        uint32_t PostInterpolationSpace;
+        uint32_t BufferPrecision;
+        uint32_t ExtendMode;
+        uint32_t ColorInterpolationMode;
+        uint32_t StopCount;
+        // Followed by StopCount D2D1_GRADIENT_STOPs.
+    };
+
+    struct LinearGradientBrushRecord
+    {
+        BrushProperties Brush;
+        D2D1_POINT_2F StartPoint;
+        D2D1_POINT_2F EndPoint;
+        uint32_t GradientStops;
+    };
+
+    struct RadialGradientBrushRecord
+    {
+        BrushProperties Brush;
+        D2D1_POINT_2F Center;
+        D2D1_POINT_2F GradientOriginOffset;
+        float RadiusX;
+        float RadiusY;
+        uint32_t GradientStops;
+    };
+
+    struct BitmapBrushRecord
+    {
+        BrushProperties Brush;
+        uint32_t Bitmap;
+        uint32_t ExtendModeX;
+        uint32_t ExtendModeY;
+        uint32_t InterpolationMode;
+    };
+
+    struct ImageBrushRecord
+    {
+        BrushProperties Brush;
+        uint32_t Image;
+        D2D1_RECT_F SourceRectangle;
+        uint32_t ExtendModeX;
+        uint32_t ExtendModeY;
+        uint32_t InterpolationMode;
+    };
+
+    struct BitmapRecord
+    {
+        uint32_t PixelWidth;
+        uint32_t PixelHeight;
+        uint32_t Format;
+        uint32_t AlphaMode;
+        float DpiX;
+        float DpiY;
+        uint32_t Pitch;
+        uint32_t ByteCount;
+        // Followed by ByteCount bytes of pixel data.
+    };
+
+    struct StrokeStyleRecord
+    {
+        uint32_t StartCap;
+        uint32_t EndCap;
+        uint32_t DashCap;
+        uint32_t LineJoin;
+        float MiterLimit;
+        uint32_t DashStyle;
+        float DashOffset;
+        uint32_t TransformType;
+        uint32_t DashCount;
+        // Followed by DashCount floats.
+    };
+
+    struct TagsRecord
+    {
+        uint64_t Tag1;
+        uint64_t Tag2;
+    };
+
+    struct ClearRecord
+    {
+        uint32_t HasColor;
+        D2D1_COLOR_F Color;
+    };
+
+    struct DrawLineRecord
+    {
+        D2D1_POINT_2F Point0;
+        D2D1_POINT_2F Point1;
+        uint32_t Brush;
+        float StrokeWidth;
+        uint32_t StrokeStyle;
+    };
+
+    struct DrawRectangleRecord
+    {
+        D2D1_RECT_F Rectangle;
+        uint32_t Brush;
+        float StrokeWidth;
+        uint32_t StrokeStyle;
+    };
+
+    struct FillRectangleRecord
+    {
+        D2D1_RECT_F Rectangle;
+        uint32_t Brush;
+    };
+
+    struct DrawGeometryRecord
+    {
+        uint32_t Geometry;
+        uint32_t Brush;
+        float StrokeWidth;
+        uint32_t StrokeStyle;
+    };
+
+    struct FillGeometryRecord
+    {
+        uint32_t Geometry;
+        uint32_t Brush;
+        uint32_t OpacityBrush;
+    };
+
+    struct DrawBitmapRecord
+    {
+        uint32_t Bitmap;
+        uint32_t Fields;
+        D2D1_RECT_F DestinationRectangle;
+        float Opacity;
+        uint32_t InterpolationMode;
+        D2D1_RECT_F SourceRectangle;
+        D2D1_MATRIX_4X4_F PerspectiveTransform;
+    };
+
+    struct DrawImageRecord
+    {
+        uint32_t Image;
+        uint32_t Fields;
+        D2D1_POINT_2F TargetOffset;
+        D2D1_RECT_F SourceRectangle;
+        uint32_t InterpolationMode;
+        uint32_t CompositeMode;
+    };
+
+    struct FillOpacityMaskRecord
+    {
+        uint32_t OpacityMask;
+        uint32_t Brush;
+        uint32_t Fields;
+        D2D1_RECT_F DestinationRectangle;
+        D2D1_RECT_F SourceRectangle;
+    };
+
+    struct PushAxisAlignedClipRecord
+    {
+        D2D1_RECT_F ClipRectangle;
+        uint32_t AntialiasMode;
+    };
+
+    struct PushLayerRecord
+    {
+        D2D1_RECT_F ContentBounds;
+        uint32_t GeometricMask;
+        uint32_t MaskAntialiasMode;
+        D2D1_MATRIX_3X2_F MaskTransform;
+        float Opacity;
+        uint32_t OpacityBrush;
+        uint32_t LayerOptions;
+    };
+
+
+    __declspec(noreturn) static void ThrowInvalidData()
+    {
+        ThrowHR(E_INVALIDARG, Strings::InvalidSerializedCommandList);
+    }
+
+
+    //
+    // Writing.
+    //
+
+    class BinaryWriter
+    {
+        std::vector<uint8_t>& m_buffer;
+
+    public:
+        BinaryWriter(std::vector<uint8_t>& buffer)
+            : m_buffer(buffer)
+        { }
+
+        void WriteBytes(void const* data, size_t size)
+        {
+            auto bytes = static_cast<uint8_t const*>(data);
+            m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        }
+
+        template<typename T>
+        void Write(T const& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be serialized");
+            WriteBytes(&value, sizeof(T));
+        }
+
+        template<typename T>
+        void WriteArray(T const* values, uint32_t count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be serialized");
+            WriteBytes(values, sizeof(T) * count);
+        }
+    };
+
+
+    template<typename FN>
+    static void WriteRecord(std::vector<uint8_t>& buffer, CommandListRecordType type, FN&& writePayload)
+    {
+        auto headerOffset = buffer.size();
+        buffer.resize(headerOffset + sizeof(CommandListRecordHeader));
+
+        BinaryWriter writer(buffer);
+        writePayload(writer);
+
+        auto payloadSize = buffer.size() - headerOffset - sizeof(CommandListRecordHeader);
+
+        if (payloadSize > UINT32_MAX)
+            ThrowHR(E_OUTOFMEMORY);
+
+        CommandListRecordHeader header{ static_cast<uint16_t>(type), 0, static_cast<uint32_t>(payloadSize) };
+        memcpy(&buffer[headerOffset], &header, sizeof(header));
+
+        // Keep records 4 byte aligned.
+        buffer.resize((buffer.size() + 3) & ~3);
+    }
+
+
+    //
+    // Records the figures of a geometry or glyph outline.
+    //
+    class GeometryRecorder : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1SimplifiedGeometrySink>,
+                             private LifespanTracker<GeometryRecorder>
+    {
+        std::vector<uint8_t> m_operations;
+        D2D1_FILL_MODE m_fillMode;
+        D2D1_POINT_2F m_offset;
+        HRESULT m_result;
+
+    public:
+        GeometryRecorder(D2D1_POINT_2F offset = D2D1_POINT_2F{ 0, 0 })
+            : m_fillMode(D2D1_FILL_MODE_ALTERNATE)
+            , m_offset(offset)
+            , m_result(S_OK)
+        { }
+
+        void WritePayload(BinaryWriter& writer) const
+        {
+            writer.Write(static_cast<uint32_t>(m_fillMode));
+            writer.WriteBytes(m_operations.data(), m_operations.size());
+        }
+
+        IFACEMETHODIMP_(void) SetFillMode(D2D1_FILL_MODE fillMode) override
+        {
+            m_fillMode = fillMode;
+        }
+
+        IFACEMETHODIMP_(void) SetSegmentFlags(D2D1_PATH_SEGMENT vertexFlags) override
+        {
+            Record(GeometryOperation::SetSegmentFlags, [&](BinaryWriter& writer)
+            {
+                writer.Write(static_cast<uint32_t>(vertexFlags));
+            });
+        }
+
+        IFACEMETHODIMP_(void) BeginFigure(D2D1_POINT_2F startPoint, D2D1_FIGURE_BEGIN figureBegin) override
+        {
+            Record(GeometryOperation::BeginFigure, [&](BinaryWriter& writer)
+            {
+                writer.Write(Offset(startPoint));
+                writer.Write(static_cast<uint32_t>(figureBegin));
+            });
+        }
+
+        IFACEMETHODIMP_(void) AddLines(D2D1_POINT_2F const* points, UINT32 pointsCount) override
+        {
+            Record(GeometryOperation::AddLines, [&](BinaryWriter& writer)
+            {
+                writer.Write(pointsCount);
+
+                for (uint32_t i = 0; i < pointsCount; i++)
+                    writer.Write(Offset(points[i]));
+            });
+        }
+
+        IFACEMETHODIMP_(void) AddBeziers(D2D1_BEZIER_SEGMENT const* beziers, UINT32 beziersCount) override
+        {
+            Record(GeometryOperation::AddBeziers, [&](BinaryWriter& writer)
+            {
+                writer.Write(beziersCount);
+
+                for (uint32_t i = 0; i < beziersCount; i++)
+                {
+                    writer.Write(Offset(beziers[i].point1));
+                    writer.Write(Offset(beziers[i].point2));
+                    writer.Write(Offset(beziers[i].point3));
+                }
+            });
+        }
+
+        IFACEMETHODIMP_(void) EndFigure(D2D1_FIGURE_END figureEnd) override
+        {
+            Record(GeometryOperation::EndFigure, [&](BinaryWriter& writer)
+            {
+                writer.Write(static_cast<uint32_t>(figureEnd));
+            });
+        }
+
+        IFACEMETHODIMP Close() override
+        {
+            return m_result;
+        }
+
+    private:
+        D2D1_POINT_2F Offset(D2D1_POINT_2F const& point) const
+        {
+            return D2D1_POINT_2F{ point.x + m_offset.x, point.y + m_offset.y };
+        }
+
+        template<typename FN>
+        void Record(GeometryOperation operation, FN&& writeOperation)
+        {
+            if (FAILED(m_result))
+                return;
+
+            m_result = ExceptionBoundary(
+                [&]
+                {
+                    BinaryWriter writer(m_operations);
+                    writer.Write(static_cast<uint32_t>(operation));
+                    writeOperation(writer);
+                });
+        }
+    };
+
+
+    //
+    // Owns the resource table while a command list (and any command lists
+    // nested inside it) is being serialized.
+    //
+    class CommandListWriter
+    {
+        ComPtr<ICanvasDevice> m_device;
+
+        std::vector<uint8_t> m_resources;
+        std::unordered_map<IUnknown*, uint32_t> m_resourceIds;
+        std::vector<ComPtr<IUnknown>> m_keepAlive;     // Stops pointers in m_resourceIds being reused.
+
+        bool m_hasUnsupportedContent;
+
+    public:
+        CommandListWriter(ICanvasDevice* device)
+            : m_device(device)
+            , m_hasUnsupportedContent(false)
+        { }
+
+        std::vector<uint8_t> WriteFile(ID2D1CommandList* commandList)
+        {
+            auto commands = WriteCommands(commandList);
+
+            if (m_resources.size() > UINT32_MAX)
+                ThrowHR(E_OUTOFMEMORY);
+
+            CommandListFileHeader header
+            {
+                CommandListFileHeader::ExpectedMagic,
+                CommandListFileHeader::CurrentVersion,
+                static_cast<uint32_t>(m_keepAlive.size()),
+                static_cast<uint32_t>(m_resources.size())
+            };
+
+            std::vector<uint8_t> file;
+            file.reserve(sizeof(header) + m_resources.size() + commands.size());
+
+            BinaryWriter writer(file);
+            writer.Write(header);
+            writer.WriteBytes(m_resources.data(), m_resources.size());
+            writer.WriteBytes(commands.data(), commands.size());
+
+            return file;
+        }
+
+        std::vector<uint8_t> WriteCommands(ID2D1CommandList* commandList);
+
+        __declspec(noreturn) void ThrowUnsupported()
+        {
+            m_hasUnsupportedContent = true;
+            ThrowHR(E_NOTIMPL);
+        }
+
+        void MarkUnsupported()
+        {
+            m_hasUnsupportedContent = true;
+        }
+
+        uint32_t GetBrushId(ID2D1Brush* brush)
+        {
+            if (!brush)
+                return NoResource;
+
+            return GetResourceId(brush, [&]
+            {
+                BrushProperties properties{ brush->GetOpacity() };
+                brush->GetTransform(&properties.Transform);
+
+                if (auto solidColorBrush = MaybeAs<ID2D1SolidColorBrush>(brush))
+                {
+                    WriteResource(CommandListRecordType::SolidColorBrush, SolidColorBrushRecord{ properties, solidColorBrush->GetColor() });
+                }
+                else if (auto linearGradientBrush = MaybeAs<ID2D1LinearGradientBrush>(brush))
+                {
+                    ComPtr<ID2D1GradientStopCollection> stops;
+                    linearGradientBrush->GetGradientStopCollection(&stops);
+
+                    LinearGradientBrushRecord record
+                    {
+                        properties,
+                        linearGradientBrush->GetStartPoint(),
+                        linearGradientBrush->GetEndPoint(),
+                        GetGradientStopsId(stops.Get())
+                    };
+
+                    WriteResource(CommandListRecordType::LinearGradientBrush, record);
+                }
+                else if (auto radialGradientBrush = MaybeAs<ID2D1RadialGradientBrush>(brush))
+                {
+                    ComPtr<ID2D1GradientStopCollection> stops;
+                    radialGradientBrush->GetGradientStopCollection(&stops);
+
+                    RadialGradientBrushRecord record
+                    {
+                        properties,
+                        radialGradientBrush->GetCenter(),
+                        radialGradientBrush->GetGradientOriginOffset(),
+                        radialGradientBrush->GetRadiusX(),
+                        radialGradientBrush->GetRadiusY(),
+                        GetGradientStopsId(stops.Get())
+                    };
+
+                    WriteResource(CommandListRecordType::RadialGradientBrush, record);
+                }
+                else if (auto bitmapBrush = MaybeAs<ID2D1BitmapBrush1>(brush))
+                {
+                    ComPtr<ID2D1Bitmap> bitmap;
+                    bitmapBrush->GetBitmap(&bitmap);
+
+                    BitmapBrushRecord record
+                    {
+                        properties,
+                        GetBitmapId(bitmap.Get()),
+                        static_cast<uint32_t>(bitmapBrush->GetExtendModeX()),
+                        static_cast<uint32_t>(bitmapBrush->GetExtendModeY()),
+                        static_cast<uint32_t>(bitmapBrush->GetInterpolationMode1())
+                    };
+
+                    WriteResource(CommandListRecordType::BitmapBrush, record);
+                }
+                else if (auto imageBrush = MaybeAs<ID2D1ImageBrush>(brush))
+                {
+                    ComPtr<ID2D1Image> image;
+                    imageBrush->GetImage(&image);
+
+                    ImageBrushRecord record
+                    {
+                        properties,
+                        GetImageId(image.Get())
+                    };
+
+                    imageBrush->GetSourceRectangle(&record.SourceRectangle);
+                    record.ExtendModeX = static_cast<uint32_t>(imageBrush->GetExtendModeX());
+                    record.ExtendModeY = static_cast<uint32_t>(imageBrush->GetExtendModeY());
+                    record.InterpolationMode = static_cast<uint32_t>(imageBrush->GetInterpolationMode());
+
+                    WriteResource(CommandListRecordType::ImageBrush, record);
+                }
+                else
+                {
+                    ThrowUnsupported();
+                }
+            });
+        }
+
+        uint32_t GetGeometryId(ID2D1Geometry* geometry)
+        {
+            if (!geometry)
+                return NoResource;
+
+            return GetResourceId(geometry, [&]
+            {
+                auto recorder = Make<GeometryRecorder>();
+                CheckMakeResult(recorder);
+
+                ThrowIfFailed(geometry->Simplify(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_CUBICS_AND_LINES, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE, recorder.Get()));
+                ThrowIfFailed(recorder->Close());
+
+                WriteRecord(m_resources, CommandListRecordType::Geometry, [&](BinaryWriter& writer) { recorder->WritePayload(writer); });
+            });
+        }
+
+        // Glyph runs are converted to geometry, which is never shared.
+        uint32_t AddGlyphRunGeometry(D2D1_POINT_2F baselineOrigin, DWRITE_GLYPH_RUN const* glyphRun)
+        {
+            auto recorder = Make<GeometryRecorder>(baselineOrigin);
+            CheckMakeResult(recorder);
+
+            recorder->SetFillMode(D2D1_FILL_MODE_WINDING);
+
+            ThrowIfFailed(glyphRun->fontFace->GetGlyphRunOutline(
+                glyphRun->fontEmSize,
+                glyphRun->glyphIndices,
+                glyphRun->glyphAdvances,
+                glyphRun->glyphOffsets,
+                glyphRun->glyphCount,
+                glyphRun->isSideways,
+                glyphRun->bidiLevel % 2,
+                recorder.Get()));
+
+            ThrowIfFailed(recorder->Close());
+
+            WriteRecord(m_resources, CommandListRecordType::Geometry, [&](BinaryWriter& writer) { recorder->WritePayload(writer); });
+
+            auto id = static_cast<uint32_t>(m_keepAlive.size());
+            m_keepAlive.push_back(recorder);
+            return id;
+        }
+
+        uint32_t GetStrokeStyleId(ID2D1StrokeStyle* strokeStyle)
+        {
+            if (!strokeStyle)
+                return NoResource;
+
+            return GetResourceId(strokeStyle, [&]
+            {
+                auto strokeStyle1 = As<ID2D1StrokeStyle1>(strokeStyle);
+
+                std::vector<float> dashes(strokeStyle1->GetDashesCount());
+
+                if (!dashes.empty())
+                    strokeStyle1->GetDashes(dashes.data(), static_cast<uint32_t>(dashes.size()));
+
+                StrokeStyleRecord record
+                {
+                    static_cast<uint32_t>(strokeStyle1->GetStartCap()),
+                    static_cast<uint32_t>(strokeStyle1->GetEndCap()),
+                    static_cast<uint32_t>(strokeStyle1->GetDashCap()),
+                    static_cast<uint32_t>(strokeStyle1->GetLineJoin()),
+                    strokeStyle1->GetMiterLimit(),
+                    static_cast<uint32_t>(strokeStyle1->GetDashStyle()),
+                    strokeStyle1->GetDashOffset(),
+                    static_cast<uint32_t>(strokeStyle1->GetStrokeTransformType()),
+                    static_cast<uint32_t>(dashes.size())
+                };
+
+                WriteRecord(m_resources, CommandListRecordType::StrokeStyle, [&](BinaryWriter& writer)
+                {
+                    writer.Write(record);
+                    writer.WriteArray(dashes.data(), record.DashCount);
+                });
+            });
+        }
+
+        uint32_t GetBitmapId(ID2D1Bitmap* bitmap)
+        {
+            if (!bitmap)
+                return NoResource;
+
+            return GetResourceId(bitmap, [&]
+            {
+                auto bitmap1 = As<ID2D1Bitmap1>(bitmap);
+
+                auto size = bitmap1->GetPixelSize();
+                auto pixelFormat = bitmap1->GetPixelFormat();
+
+                BitmapRecord record
+                {
+                    size.width,
+                    size.height,
+                    static_cast<uint32_t>(pixelFormat.format),
+                    static_cast<uint32_t>(pixelFormat.alphaMode)
+                };
+
+                bitmap1->GetDpi(&record.DpiX, &record.DpiY);
+
+                auto blockSize = GetBlockSize(pixelFormat.format);
+                auto blocksWide = (size.width + blockSize - 1) / blockSize;
+                auto blocksHigh = (size.height + blockSize - 1) / blockSize;
+
+                uint64_t pitch = static_cast<uint64_t>(blocksWide) * GetBytesPerBlock(pixelFormat.format);
+                uint64_t byteCount = pitch * blocksHigh;
+
+                if (byteCount > UINT32_MAX)
+                    ThrowHR(E_OUTOFMEMORY);
+
+                record.Pitch = static_cast<uint32_t>(pitch);
+                record.ByteCount = static_cast<uint32_t>(byteCount);
+
+                ScopedBitmapMappedPixelAccess pixels(m_device.Get(), bitmap1.Get());
+
+                WriteRecord(m_resources, CommandListRecordType::Bitmap, [&](BinaryWriter& writer)
+                {
+                    writer.Write(record);
+
+                    for (uint32_t y = 0; y < blocksHigh; y++)
+                    {
+                        writer.WriteBytes(pixels.GetLockedData() + y * pixels.GetStride(), record.Pitch);
+                    }
+                });
+            });
+        }
+
+        // Only bitmaps and command lists can be serialized; effects would need their whole graph stored.
+        uint32_t GetImageId(ID2D1Image* image)
+        {
+            if (!image)
+                return NoResource;
+
+            if (auto bitmap = MaybeAs<ID2D1Bitmap>(image))
+                return GetBitmapId(bitmap.Get());
+
+            if (auto commandList = MaybeAs<ID2D1CommandList>(image))
+            {
+                return GetResourceId(commandList.Get(), [&]
+                {
+                    auto commands = WriteCommands(commandList.Get());
+
+                    WriteRecord(m_resources, CommandListRecordType::CommandList, [&](BinaryWriter& writer)
+                    {
+                        writer.WriteBytes(commands.data(), commands.size());
+                    });
+                });
+            }
+
+            ThrowUnsupported();
+        }
+
+    private:
+        uint32_t GetGradientStopsId(ID2D1GradientStopCollection* stops)
+        {
+            return GetResourceId(stops, [&]
+            {
+                auto stops1 = As<ID2D1GradientStopCollection1>(stops);
+
+                std::vector<D2D1_GRADIENT_STOP> gradientStops(stops1->GetGradientStopCount());
+                stops1->GetGradientStops1(gradientStops.data(), static_cast<uint32_t>(gradientStops.size()));
+
+                GradientStopCollectionRecord record
+                {
+                    static_cast<uint32_t>(stops1->GetPreInterpolationSpace()),
+                    static_cast<uint32_t>(stops1->GetPostInterpolationSpace()),
+                    static_cast<uint32_t>(stops1->GetBufferPrecision()),
+                    static_cast<uint32_t>(stops1->GetExtendMode()),
+                    static_cast<uint32_t>(stops1->GetColorInterpolationMode()),
+                    static_cast<uint32_t>(gradientStops.size())
+                };
+
+                WriteRecord(m_resources, CommandListRecordType::GradientStopCollection, [&](BinaryWriter& writer)
+                {
+                    writer.Write(record);
+                    writer.WriteArray(gradientStops.data(), record.StopCount);
+                });
+            });
+        }
+
+        template<typename T>
+        void WriteResource(CommandListRecordType type, T const& record)
+        {
+            WriteRecord(m_resources, type, [&](BinaryWriter& writer) { writer.Write(record); });
+        }
+
+        // Resources are numbered in the order their definitions are written,
+        // which for nested command lists is after everything they reference.
+        template<typename FN>
+        uint32_t GetResourceId(IUnknown* resource, FN&& writeDefinition)
+        {
+            ComPtr<IUnknown> identity;
+            ThrowIfFailed(resource->QueryInterface(IID_PPV_ARGS(&identity)));
+
+            auto it = m_resourceIds.find(identity.Get());
+
+            if (it != m_resourceIds.end())
+                return it->second;
+
+            writeDefinition();
+
+            auto id = static_cast<uint32_t>(m_keepAlive.size());
+            m_resourceIds.insert(std::make_pair(identity.Get(), id));
+            m_keepAlive.push_back(identity);
+            return id;
+        }
+    };
+
+
+    //
+    // Streams a command list into command records.
+    //
+    class CommandListWriterSink : public RuntimeClass<
+                                      RuntimeClassFlags<ClassicCom>,
+                                      ChainInterfaces<ID2D1CommandSink3, ID2D1CommandSink2, ID2D1CommandSink1, ID2D1CommandSink>>,
+                                  private LifespanTracker<CommandListWriterSink>
+    {
+        CommandListWriter* m_writer;
+        std::vector<uint8_t>& m_commands;
+
+    public:
+        CommandListWriterSink(CommandListWriter* writer, std::vector<uint8_t>& commands)
+            : m_writer(writer)
+            , m_commands(commands)
+        { }
+
+        IFACEMETHODIMP BeginDraw() override { return S_OK; }
+        IFACEMETHODIMP EndDraw() override { return S_OK; }
+
+        // Text is stored as outlines, so its rendering options don't apply.
+        IFACEMETHODIMP SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE) override { return S_OK; }
+        IFACEMETHODIMP SetTextRenderingParams(IDWriteRenderingParams*) override { return S_OK; }
+
+        IFACEMETHODIMP SetAntialiasMode(D2D1_ANTIALIAS_MODE antialiasMode) override
+        {
+            return Command(CommandListRecordType::SetAntialiasMode, [&] { return static_cast<uint32_t>(antialiasMode); });
+        }
+
+        IFACEMETHODIMP SetTags(D2D1_TAG tag1, D2D1_TAG tag2) override
+        {
+            return Command(CommandListRecordType::SetTags, [&] { return TagsRecord{ tag1, tag2 }; });
+        }
+
+        IFACEMETHODIMP SetTransform(D2D1_MATRIX_3X2_F const* transform) override
+        {
+            return Command(CommandListRecordType::SetTransform, [&] { return *transform; });
+        }
+
+        IFACEMETHODIMP SetPrimitiveBlend(D2D1_PRIMITIVE_BLEND primitiveBlend) override
+        {
+            return Command(CommandListRecordType::SetPrimitiveBlend, [&] { return static_cast<uint32_t>(primitiveBlend); });
+        }
+
+        IFACEMETHODIMP SetPrimitiveBlend1(D2D1_PRIMITIVE_BLEND primitiveBlend) override
+        {
+            return SetPrimitiveBlend(primitiveBlend);
+        }
+
+        IFACEMETHODIMP SetUnitMode(D2D1_UNIT_MODE unitMode) override
+        {
+            return Command(CommandListRecordType::SetUnitMode, [&] { return static_cast<uint32_t>(unitMode); });
+        }
+
+        IFACEMETHODIMP Clear(D2D1_COLOR_F const* color) override
+        {
+            return Command(CommandListRecordType::Clear, [&]
+            {
+                return ClearRecord{ color ? 1u : 0u, color ? *color : D2D1_COLOR_F{} };
+            });
+        }
+
+        IFACEMETHODIMP DrawGlyphRun(D2D1_POINT_2F baselineOrigin, DWRITE_GLYPH_RUN const* glyphRun, DWRITE_GLYPH_RUN_DESCRIPTION const*, ID2D1Brush* foregroundBrush, DWRITE_MEASURING_MODE) override
+        {
+            return Command(CommandListRecordType::FillGeometry, [&]
+            {
+                return FillGeometryRecord
+                {
+                    m_writer->AddGlyphRunGeometry(baselineOrigin, glyphRun),
+                    m_writer->GetBrushId(foregroundBrush),
+                    NoResource
+                };
+            });
+        }
+
+        IFACEMETHODIMP DrawLine(D2D1_POINT_2F point0, D2D1_POINT_2F point1, ID2D1Brush* brush, FLOAT strokeWidth, ID2D1StrokeStyle* strokeStyle) override
+        {
+            return Command(CommandListRecordType::DrawLine, [&]
+            {
+                return DrawLineRecord{ point0, point1, m_writer->GetBrushId(brush), strokeWidth, m_writer->GetStrokeStyleId(strokeStyle) };
+            });
+        }
+
+        IFACEMETHODIMP DrawGeometry(ID2D1Geometry* geometry, ID2D1Brush* brush, FLOAT strokeWidth, ID2D1StrokeStyle* strokeStyle) override
+        {
+            return Command(CommandListRecordType::DrawGeometry, [&]
+            {
+                return DrawGeometryRecord{ m_writer->GetGeometryId(geometry), m_writer->GetBrushId(brush), strokeWidth, m_writer->GetStrokeStyleId(strokeStyle) };
+            });
+        }
+
+        IFACEMETHODIMP DrawRectangle(D2D1_RECT_F const* rect, ID2D1Brush* brush, FLOAT strokeWidth, ID2D1StrokeStyle* strokeStyle) override
+        {
+            return Command(CommandListRecordType::DrawRectangle, [&]
+            {
+                return DrawRectangleRecord{ *rect, m_writer->GetBrushId(brush), strokeWidth, m_writer->GetStrokeStyleId(strokeStyle) };
+            });
+        }
+
+        IFACEMETHODIMP DrawBitmap(ID2D1Bitmap* bitmap, D2D1_RECT_F const* destinationRectangle, FLOAT opacity, D2D1_INTERPOLATION_MODE interpolationMode, D2D1_RECT_F const* sourceRectangle, D2D1_MATRIX_4X4_F const* perspectiveTransform) override
+        {
+            return Command(CommandListRecordType::DrawBitmap, [&]
+            {
+                DrawBitmapRecord record{ m_writer->GetBitmapId(bitmap) };
+
+                record.Opacity = opacity;
+                record.InterpolationMode = static_cast<uint32_t>(interpolationMode);
+
+                if (destinationRectangle)
+                {
+                    record.Fields |= HasDestinationRectangle;
+                    record.DestinationRectangle = *destinationRectangle;
+                }
+
+                if (sourceRectangle)
+                {
+                    record.Fields |= HasSourceRectangle;
+                    record.SourceRectangle = *sourceRectangle;
+                }
+
+                if (perspectiveTransform)
+                {
+                    record.Fields |= HasPerspectiveTransform;
+                    record.PerspectiveTransform = *perspectiveTransform;
+                }
+
+                return record;
+            });
+        }
+
+        IFACEMETHODIMP DrawImage(ID2D1Image* image, D2D1_POINT_2F const* targetOffset, D2D1_RECT_F const* imageRectangle, D2D1_INTERPOLATION_MODE interpolationMode, D2D1_COMPOSITE_MODE compositeMode) override
+        {
+            return Command(CommandListRecordType::DrawImage, [&]
+            {
+                DrawImageRecord record{ m_writer->GetImageId(image) };
+
+                record.InterpolationMode = static_cast<uint32_t>(interpolationMode);
+                record.CompositeMode = static_cast<uint32_t>(compositeMode);
+
+                if (targetOffset)
+                {
+                    record.Fields |= HasTargetOffset;
+                    record.TargetOffset = *targetOffset;
+                }
+
+                if (imageRectangle)
+                {
+                    record.Fields |= HasSourceRectangle;
+                    record.SourceRectangle = *imageRectangle;
+                }
+
+                return record;
+            });
+        }
+
+        IFACEMETHODIMP FillOpacityMask(ID2D1Bitmap* opacityMask, ID2D1Brush* brush, D2D1_RECT_F const* destinationRectangle, D2D1_RECT_F const* sourceRectangle) override
+        {
+            return Command(CommandListRecordType::FillOpacityMask, [&]
+            {
+                FillOpacityMaskRecord record{ m_writer->GetBitmapId(opacityMask), m_writer->GetBrushId(brush) };
+
+                if (destinationRectangle)
+                {
+                    record.Fields |= HasDestinationRectangle;
+                    record.DestinationRectangle = *destinationRectangle;
+                }
+
+                if (sourceRectangle)
+                {
+                    record.Fields |= HasSourceRectangle;
+                    record.SourceRectangle = *sourceRectangle;
+                }
+
+                return record;
+            });
+        }
+
+        IFACEMETHODIMP FillGeometry(ID2D1Geometry* geometry, ID2D1Brush* brush, ID2D1Brush* opacityBrush) override
+        {
+            return Command(CommandListRecordType::FillGeometry, [&]
+            {
+                return FillGeometryRecord{ m_writer->GetGeometryId(geometry), m_writer->GetBrushId(brush), m_writer->GetBrushId(opacityBrush) };
+            });
+        }
+
+        IFACEMETHODIMP FillRectangle(D2D1_RECT_F const* rect, ID2D1Brush* brush) override
+        {
+            return Command(CommandListRecordType::FillRectangle, [&]
+            {
+                return FillRectangleRecord{ *rect, m_writer->GetBrushId(brush) };
+            });
+        }
+
+        IFACEMETHODIMP PushAxisAlignedClip(D2D1_RECT_F const* clipRect, D2D1_ANTIALIAS_MODE antialiasMode) override
+        {
+            return Command(CommandListRecordType::PushAxisAlignedClip, [&]
+            {
+                return PushAxisAlignedClipRecord{ *clipRect, static_cast<uint32_t>(antialiasMode) };
+            });
+        }
+
+        IFACEMETHODIMP PushLayer(D2D1_LAYER_PARAMETERS1 const* layerParameters, ID2D1Layer*) override
+        {
+            return Command(CommandListRecordType::PushLayer, [&]
+            {
+                return PushLayerRecord
+                {
+                    layerParameters->contentBounds,
+                    m_writer->GetGeometryId(layerParameters->geometricMask),
+                    static_cast<uint32_t>(layerParameters->maskAntialiasMode),
+                    layerParameters->maskTransform,
+                    layerParameters->opacity,
+                    m_writer->GetBrushId(layerParameters->opacityBrush),
+                    static_cast<uint32_t>(layerParameters->layerOptions)
+                };
+            });
+        }
+
+        IFACEMETHODIMP PopAxisAlignedClip() override
+        {
+            return EmptyCommand(CommandListRecordType::PopAxisAlignedClip);
+        }
+
+        IFACEMETHODIMP PopLayer() override
+        {
+            return EmptyCommand(CommandListRecordType::PopLayer);
+        }
+
+        //
+        // Commands that can't be serialized.
+        //
+
+        IFACEMETHODIMP DrawGdiMetafile(ID2D1GdiMetafile*, D2D1_POINT_2F const*) override { return Unsupported(); }
+        IFACEMETHODIMP DrawGdiMetafile(ID2D1GdiMetafile*, D2D1_RECT_F const*, D2D1_RECT_F const*) override { return Unsupported(); }
+        IFACEMETHODIMP FillMesh(ID2D1Mesh*, ID2D1Brush*) override { return Unsupported(); }
+        IFACEMETHODIMP DrawInk(ID2D1Ink*, ID2D1Brush*, ID2D1InkStyle*) override { return Unsupported(); }
+        IFACEMETHODIMP DrawGradientMesh(ID2D1GradientMesh*) override { return Unsupported(); }
+        IFACEMETHODIMP DrawSpriteBatch(ID2D1SpriteBatch*, UINT32, UINT32, ID2D1Bitmap*, D2D1_BITMAP_INTERPOLATION_MODE, D2D1_SPRITE_OPTIONS) override { return Unsupported(); }
+
+    private:
+        template<typename FN>
+        HRESULT Command(CommandListRecordType type, FN&& getRecord)
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    // Resources referenced by the record are defined before the record is written.
+                    auto record = getRecord();
+
+                    WriteRecord(m_commands, type, [&](BinaryWriter& writer) { writer.Write(record); });
+                });
+        }
+
+        HRESULT EmptyCommand(CommandListRecordType type)
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    WriteRecord(m_commands, type, [](BinaryWriter&) {});
+                });
+        }
+
+        HRESULT Unsupported()
+        {
+            m_writer->MarkUnsupported();
+            return E_NOTIMPL;
+        }
+    };
+
+
+    std::vector<uint8_t> CommandListWriter::WriteCommands(ID2D1CommandList* commandList)
+    {
+        std::vector<uint8_t> commands;
+
+        auto sink = Make<CommandListWriterSink>(this, commands);
+        CheckMakeResult(sink);
+
+        auto hr = commandList->Stream(sink.Get());
+
+        if (m_hasUnsupportedContent)
+            ThrowHR(E_INVALIDARG, Strings::CommandListCannotBeSerialized);
+
+        ThrowIfFailed(hr);
+
+        return commands;
+    }
+
+
+    std::vector<uint8_t> SerializeCommandList(
+        ICanvasDevice* device,
+        ID2D1CommandList* commandList)
+    {
+        CommandListWriter writer(device);
+        return writer.WriteFile(commandList);
+    }
+
+
+    //
+    // Reading.
+    //
+
+    class BinaryReader
+    {
+        uint8_t const* m_data;
+        size_t m_remaining;
+
+    public:
+        BinaryReader(uint8_t const* data, size_t size)
+            : m_data(data)
+            , m_remaining(size)
+        { }
+
+        bool IsAtEnd() const
+        {
+            return m_remaining == 0;
+        }
+
+        uint8_t const* ReadBytes(size_t size)
+        {
+            if (size > m_remaining)
+                ThrowInvalidData();
+
+            auto bytes = m_data;
+            m_data += size;
+            m_remaining -= size;
+            return bytes;
+        }
+
+        template<typename T>
+        T Read()
+        {
+            T value;
+            memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        // Arrays are used in place, without copying.
+        template<typename T>
+        T const* ReadArray(uint32_t count)
+        {
+            if (count > m_remaining / sizeof(T))
+                ThrowInvalidData();
+
+            return reinterpret_cast<T const*>(ReadBytes(count * sizeof(T)));
+        }
+
+        BinaryReader ReadRecord(CommandListRecordType* type)
+        {
+            auto header = Read<CommandListRecordHeader>();
+
+            *type = static_cast<CommandListRecordType>(header.Type);
+
+            BinaryReader payload(ReadBytes(header.Size), header.Size);
+
+            auto padding = (4 - (header.Size & 3)) & 3;
+            ReadBytes(std::min<size_t>(padding, m_remaining));
+
+            return payload;
+        }
+    };
+
+
+    class CommandListReader
+    {
+        ComPtr<ICanvasDevice> m_device;
+        ComPtr<ID2D1DeviceContext1> m_deviceContext;
+        ComPtr<ID2D1Factory1> m_factory;
+
+        std::vector<ComPtr<IUnknown>> m_resources;
+
+    public:
+        CommandListReader(ICanvasDevice* device)
+            : m_device(device)
+            , m_deviceContext(As<ICanvasDeviceInternal>(device)->CreateDeviceContextForDrawingSession())
+        {
+            ComPtr<ID2D1Factory> factory;
+            m_deviceContext->GetFactory(&factory);
+            m_factory = As<ID2D1Factory1>(factory);
+        }
+
+        ComPtr<ID2D1CommandList> ReadFile(uint8_t const* bytes, size_t byteCount)
+        {
+            BinaryReader file(bytes, byteCount);
+
+            auto header = file.Read<CommandListFileHeader>();
+
+            if (header.Magic != CommandListFileHeader::ExpectedMagic ||
+                header.Version != CommandListFileHeader::CurrentVersion)
+            {
+                ThrowInvalidData();
+            }
+
+            BinaryReader resources(file.ReadBytes(header.ResourceBytes), header.ResourceBytes);
+
+            while (!resources.IsAtEnd())
+            {
+                if (m_resources.size() == header.ResourceCount)
+                    ThrowInvalidData();
+
+                CommandListRecordType type;
+                auto payload = resources.ReadRecord(&type);
+
+                m_resources.push_back(ReadResource(type, payload));
+            }
+
+            if (m_resources.size() != header.ResourceCount)
+                ThrowInvalidData();
+
+            // Whatever is left are the top level commands.
+            auto commandList = As<ICanvasDeviceInternal>(m_device)->CreateCommandList();
+            ReadCommandList(commandList.Get(), file);
+
+            return commandList;
+        }
+
+    private:
+        template<typename T>
+        ComPtr<T> GetResource(uint32_t id, bool isOptional = false)
+        {
+            if (id == NoResource && isOptional)
+                return nullptr;
+
+            if (id >= m_resources.size())
+                ThrowInvalidData();
+
+            auto resource = MaybeAs<T>(m_resources[id]);
+
+            if (!resource)
+                ThrowInvalidData();
+
+            return resource;
+        }
+
+        template<typename T>
+        ComPtr<T> GetOptionalResource(uint32_t id)
+        {
+            return GetResource<T>(id, true);
+        }
+
+        void ReadCommandList(ID2D1CommandList* commandList, BinaryReader& commands)
+        {
+            m_deviceContext->SetTarget(commandList);
+
+            auto clearTarget = MakeScopeWarden([&] { m_deviceContext->SetTarget(nullptr); });
+
+            // Each command list starts from the default drawing state.
+            m_deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+            m_deviceContext->SetUnitMode(D2D1_UNIT_MODE_DIPS);
+            m_deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+            m_deviceContext->SetPrimitiveBlend(D2D1_PRIMITIVE_BLEND_SOURCE_OVER);
+            m_deviceContext->SetTags(0, 0);
+
+            m_deviceContext->BeginDraw();
+
+            auto endDraw = MakeScopeWarden([&] { m_deviceContext->EndDraw(); });
+
+            while (!commands.IsAtEnd())
+            {
+                CommandListRecordType type;
+                auto payload = commands.ReadRecord(&type);
+
+                ReadCommand(type, payload);
+            }
+
+            endDraw.Dismiss();
+            ThrowIfFailed(m_deviceContext->EndDraw());
+        }
+
+        ComPtr<IUnknown> ReadResource(CommandListRecordType type, BinaryReader& payload)
+        {
+            switch (type)
+            {
+            case CommandListRecordType::SolidColorBrush:
+                {
+                    auto record = payload.Read<SolidColorBrushRecord>();
+
+                    ComPtr<ID2D1SolidColorBrush> brush;
+                    ThrowIfFailed(m_deviceContext->CreateSolidColorBrush(&record.Color, ToBrushProperties(record.Brush), &brush));
+                    return brush;
+                }
+
+            case CommandListRecordType::GradientStopCollection:
+                {
+                    auto record = payload.Read<GradientStopCollectionRecord>();
+                    auto stops = payload.ReadArray<D2D1_GRADIENT_STOP>(record.StopCount);
+
+                    ComPtr<ID2D1GradientStopCollection1> stopCollection;
+                    ThrowIfFailed(m_deviceContext->CreateGradientStopCollection(
+                        stops,
+                        record.StopCount,
+                        static_cast<D2D1_COLOR_SPACE>(record.PreInterpolationSpace),
+                        static_cast<D2D1_COLOR_SPACE>(record.PostInterpolationSpace),
+                        static_cast<D2D1_BUFFER_PRECISION>(record.BufferPrecision),
+                        static_cast<D2D1_EXTEND_MODE>(record.ExtendMode),
+                        static_cast<D2D1_COLOR_INTERPOLATION_MODE>(record.ColorInterpolationMode),
+                        &stopCollection));
+                    return stopCollection;
+                }
+
+            case CommandListRecordType::LinearGradientBrush:
+                {
+                    auto record = payload.Read<LinearGradientBrushRecord>();
+
+                    auto linearGradientProperties = D2D1::LinearGradientBrushProperties(record.StartPoint, record.EndPoint);
+
+                    ComPtr<ID2D1LinearGradientBrush> brush;
+                    ThrowIfFailed(m_deviceContext->CreateLinearGradientBrush(
+                        &linearGradientProperties,
+                        ToBrushProperties(record.Brush),
+                        GetResource<ID2D1GradientStopCollection>(record.GradientStops).Get(),
+                        &brush));
+                    return brush;
+                }
+
+            case CommandListRecordType::RadialGradientBrush:
+                {
+                    auto record = payload.Read<RadialGradientBrushRecord>();
+
+                    auto radialGradientProperties = D2D1::RadialGradientBrushProperties(record.Center, record.GradientOriginOffset, record.RadiusX, record.RadiusY);
+
+                    ComPtr<ID2D1RadialGradientBrush> brush;
+                    ThrowIfFailed(m_deviceContext->CreateRadialGradientBrush(
+                        &radialGradientProperties,
+                        ToBrushProperties(record.Brush),
+                        GetResource<ID2D1GradientStopCollection>(record.GradientStops).Get(),
+                        &brush));
+                    return brush;
+                }
+
+            case CommandListRecordType::BitmapBrush:
+                {
+                    auto record = payload.Read<BitmapBrushRecord>();
+
+                    auto bitmapBrushProperties = D2D1::BitmapBrushProperties1(
+                        static_cast<D2D1_EXTEND_MODE>(record.ExtendModeX),
+                        static_cast<D2D1_EXTEND_MODE>(record.ExtendModeY),
+                        static_cast<D2D1_INTERPOLATION_MODE>(record.InterpolationMode));
+
+                    ComPtr<ID2D1BitmapBrush1> brush;
+                    ThrowIfFailed(m_deviceContext->CreateBitmapBrush(
+                        GetOptionalResource<ID2D1Bitmap>(record.Bitmap).Get(),
+                        &bitmapBrushProperties,
+                        ToBrushProperties(record.Brush),
+                        &brush));
+                    return brush;
+                }
+
+            case CommandListRecordType::ImageBrush:
+                {
+                    auto record = payload.Read<ImageBrushRecord>();
+
+                    auto imageBrushProperties = D2D1::ImageBrushProperties(
+                        record.SourceRectangle,
+                        static_cast<D2D1_EXTEND_MODE>(record.ExtendModeX),
+                        static_cast<D2D1_EXTEND_MODE>(record.ExtendModeY),
+                        static_cast<D2D1_INTERPOLATION_MODE>(record.InterpolationMode));
+
+                    ComPtr<ID2D1ImageBrush> brush;
+                    ThrowIfFailed(m_deviceContext->CreateImageBrush(
+                        GetOptionalResource<ID2D1Image>(record.Image).Get(),
+                        &imageBrushProperties,
+                        ToBrushProperties(record.Brush),
+                        &brush));
+                    return brush;
+                }
+
+            case CommandListRecordType::Bitmap:
+                return ReadBitmap(payload);
+
+            case CommandListRecordType::Geometry:
+                return ReadGeometry(payload);
+
+            case CommandListRecordType::StrokeStyle:
+                {
+                    auto record = payload.Read<StrokeStyleRecord>();
+                    auto dashes = payload.ReadArray<float>(record.DashCount);
+
+                    D2D1_STROKE_STYLE_PROPERTIES1 properties
+                    {
+                        static_cast<D2D1_CAP_STYLE>(record.StartCap),
+                        static_cast<D2D1_CAP_STYLE>(record.EndCap),
+                        static_cast<D2D1_CAP_STYLE>(record.DashCap),
+                        static_cast<D2D1_LINE_JOIN>(record.LineJoin),
+                        record.MiterLimit,
+                        static_cast<D2D1_DASH_STYLE>(record.DashStyle),
+                        record.DashOffset,
+                        static_cast<D2D1_STROKE_TRANSFORM_TYPE>(record.TransformType)
+                    };
+
+                    // D2D only accepts dashes along with the custom dash style.
+                    bool isCustom = properties.dashStyle == D2D1_DASH_STYLE_CUSTOM;
+
+                    ComPtr<ID2D1StrokeStyle1> strokeStyle;
+                    ThrowIfFailed(m_factory->CreateStrokeStyle(
+                        properties,
+                        isCustom ? dashes : nullptr,
+                        isCustom ? record.DashCount : 0,
+                        &strokeStyle));
+                    return strokeStyle;
+                }
+
+            case CommandListRecordType::CommandList:
+                {
+                    ComPtr<ID2D1CommandList> commandList;
+                    ThrowIfFailed(m_deviceContext->CreateCommandList(&commandList));
+
+                    ReadCommandList(commandList.Get(), payload);
+
+                    // Command lists must be closed before they can be drawn.
+                    ThrowIfFailed(commandList->Close());
+                    return commandList;
+                }
+
+            default:
+                ThrowInvalidData();
+            }
+        }
+
+        ComPtr<ID2D1Bitmap1> ReadBitmap(BinaryReader& payload)
+        {
+            auto record = payload.Read<BitmapRecord>();
+            auto pixels = payload.ReadArray<uint8_t>(record.ByteCount);
+
+            auto format = static_cast<DXGI_FORMAT>(record.Format);
+
+            if (record.PixelWidth == 0 || record.PixelHeight == 0)
+                ThrowInvalidData();
+
+            // Make sure D2D won't read past the end of the pixel data.
+            auto blockSize = GetBlockSize(format);
+            auto blocksWide = (record.PixelWidth + blockSize - 1) / blockSize;
+            auto blocksHigh = (record.PixelHeight + blockSize - 1) / blockSize;
+
+            uint64_t bytesPerRow = static_cast<uint64_t>(blocksWide) * GetBytesPerBlock(format);
+
+            if (record.Pitch < bytesPerRow ||
+                static_cast<uint64_t>(record.Pitch) * (blocksHigh - 1) + bytesPerRow > record.ByteCount)
+            {
+                ThrowInvalidData();
+            }
+
+            auto bitmapProperties = D2D1::BitmapProperties1(
+                D2D1_BITMAP_OPTIONS_NONE,
+                D2D1::PixelFormat(format, static_cast<D2D1_ALPHA_MODE>(record.AlphaMode)),
+                record.DpiX,
+                record.DpiY);
+
+            ComPtr<ID2D1Bitmap1> bitmap;
+            ThrowIfFailed(m_deviceContext->CreateBitmap(
+                D2D1::SizeU(record.PixelWidth, record.PixelHeight),
+                pixels,
+                record.Pitch,
+                bitmapProperties,
+                &bitmap));
+            return bitmap;
+        }
+
+        ComPtr<ID2D1PathGeometry1> ReadGeometry(BinaryReader& payload)
+        {
+            ComPtr<ID2D1PathGeometry1> geometry;
+            ThrowIfFailed(m_factory->CreatePathGeometry(&geometry));
+
+            ComPtr<ID2D1GeometrySink> sink;
+            ThrowIfFailed(geometry->Open(&sink));
+
+            sink->SetFillMode(static_cast<D2D1_FILL_MODE>(payload.Read<uint32_t>()));
+
+            while (!payload.IsAtEnd())
+            {
+                switch (static_cast<GeometryOperation>(payload.Read<uint32_t>()))
+                {
+                case GeometryOperation::BeginFigure:
+                    {
+                        auto startPoint = payload.Read<D2D1_POINT_2F>();
+                        auto figureBegin = payload.Read<uint32_t>();
+                        sink->BeginFigure(startPoint, static_cast<D2D1_FIGURE_BEGIN>(figureBegin));
+                    }
+                    break;
+
+                case GeometryOperation::AddLines:
+                    {
+                        auto count = payload.Read<uint32_t>();
+                        sink->AddLines(payload.ReadArray<D2D1_POINT_2F>(count), count);
+                    }
+                    break;
+
+                case GeometryOperation::AddBeziers:
+                    {
+                        auto count = payload.Read<uint32_t>();
+                        sink->AddBeziers(payload.ReadArray<D2D1_BEZIER_SEGMENT>(count), count);
+                    }
+                    break;
+
+                case GeometryOperation::EndFigure:
+                    sink->EndFigure(static_cast<D2D1_FIGURE_END>(payload.Read<uint32_t>()));
+                    break;
+
+                case GeometryOperation::SetSegmentFlags:
+                    sink->SetSegmentFlags(static_cast<D2D1_PATH_SEGMENT>(payload.Read<uint32_t>()));
+                    break;
+
+                default:
+                    ThrowInvalidData();
+                }
+            }
+
+            ThrowIfFailed(sink->Close());
+
+            return geometry;
+        }
+
+        void ReadCommand(CommandListRecordType type, BinaryReader& payload)
+        {
+            auto& dc = m_deviceContext;
+
+            switch (type)
+            {
+            case CommandListRecordType::SetAntialiasMode:
+                dc->SetAntialiasMode(static_cast<D2D1_ANTIALIAS_MODE>(payload.Read<uint32_t>()));
+                break;
+
+            case CommandListRecordType::SetTags:
+                {
+                    auto record = payload.Read<TagsRecord>();
+                    dc->SetTags(record.Tag1, record.Tag2);
+                }
+                break;
+
+            case CommandListRecordType::SetPrimitiveBlend:
+                dc->SetPrimitiveBlend(static_cast<D2D1_PRIMITIVE_BLEND>(payload.Read<uint32_t>()));
+                break;
+
+            case CommandListRecordType::SetUnitMode:
+                dc->SetUnitMode(static_cast<D2D1_UNIT_MODE>(payload.Read<uint32_t>()));
+                break;
+
+            case CommandListRecordType::SetTransform:
+                dc->SetTransform(payload.Read<D2D1_MATRIX_3X2_F>());
+                break;
+
+            case CommandListRecordType::Clear:
+                {
+                    auto record = payload.Read<ClearRecord>();
+                    dc->Clear(record.HasColor ? &record.Color : nullptr);
+                }
+                break;
+
+            case CommandListRecordType::DrawLine:
+                {
+                    auto record = payload.Read<DrawLineRecord>();
+                    dc->DrawLine(
+                        record.Point0,
+                        record.Point1,
+                        GetResource<ID2D1Brush>(record.Brush).Get(),
+                        record.StrokeWidth,
+                        GetOptionalResource<ID2D1StrokeStyle>(record.StrokeStyle).Get());
+                }
+                break;
+
+            case CommandListRecordType::DrawRectangle:
+                {
+                    auto record = payload.Read<DrawRectangleRecord>();
+                    dc->DrawRectangle(
+                        record.Rectangle,
+                        GetResource<ID2D1Brush>(record.Brush).Get(),
+                        record.StrokeWidth,
+                        GetOptionalResource<ID2D1StrokeStyle>(record.StrokeStyle).Get());
+                }
+                break;
+
+            case CommandListRecordType::FillRectangle:
+                {
+                    auto record = payload.Read<FillRectangleRecord>();
+                    dc->FillRectangle(record.Rectangle, GetResource<ID2D1Brush>(record.Brush).Get());
+                }
+                break;
+
+            case CommandListRecordType::DrawGeometry:
+                {
+                    auto record = payload.Read<DrawGeometryRecord>();
+                    dc->DrawGeometry(
+                        GetResource<ID2D1Geometry>(record.Geometry).Get(),
+                        GetResource<ID2D1Brush>(record.Brush).Get(),
+                        record.StrokeWidth,
+                        GetOptionalResource<ID2D1StrokeStyle>(record.StrokeStyle).Get());
+                }
+                break;
+
+            case CommandListRecordType::FillGeometry:
+                {
+                    auto record = payload.Read<FillGeometryRecord>();
+                    dc->FillGeometry(
+                        GetResource<ID2D1Geometry>(record.Geometry).Get(),
+                        GetResource<ID2D1Brush>(record.Brush).Get(),
+                        GetOptionalResource<ID2D1Brush>(record.OpacityBrush).Get());
+                }
+                break;
+
+            case CommandListRecordType::DrawBitmap:
+                {
+                    auto record = payload.Read<DrawBitmapRecord>();
+                    dc->DrawBitmap(
+                        GetResource<ID2D1Bitmap>(record.Bitmap).Get(),
+                        (record.Fields & HasDestinationRectangle) ? &record.DestinationRectangle : nullptr,
+                        record.Opacity,
+                        static_cast<D2D1_INTERPOLATION_MODE>(record.InterpolationMode),
+                        (record.Fields & HasSourceRectangle) ? &record.SourceRectangle : nullptr,
+                        (record.Fields & HasPerspectiveTransform) ? &record.PerspectiveTransform : nullptr);
+                }
+                break;
+
+            case CommandListRecordType::DrawImage:
+                {
+                    auto record = payload.Read<DrawImageRecord>();
+                    dc->DrawImage(
+                        GetResource<ID2D1Image>(record.Image).Get(),
+                        (record.Fields & HasTargetOffset) ? &record.TargetOffset : nullptr,
+                        (record.Fields & HasSourceRectangle) ? &record.SourceRectangle : nullptr,
+                        static_cast<D2D1_INTERPOLATION_MODE>(record.InterpolationMode),
+                        static_cast<D2D1_COMPOSITE_MODE>(record.CompositeMode));
+                }
+                break;
+
+            case CommandListRecordType::FillOpacityMask:
+                {
+                    auto record = payload.Read<FillOpacityMaskRecord>();
+                    dc->FillOpacityMask(
+                        GetResource<ID2D1Bitmap>(record.OpacityMask).Get(),
+                        GetResource<ID2D1Brush>(record.Brush).Get(),
+                        (record.Fields & HasDestinationRectangle) ? &record.DestinationRectangle : nullptr,
+                        (record.Fields & HasSourceRectangle) ? &record.SourceRectangle : nullptr);
+                }
+                break;
+
+            case CommandListRecordType::PushAxisAlignedClip:
+                {
+                    auto record = payload.Read<PushAxisAlignedClipRecord>();
+                    dc->PushAxisAlignedClip(record.ClipRectangle, static_cast<D2D1_ANTIALIAS_MODE>(record.AntialiasMode));
+                }
+                break;
+
+            case CommandListRecordType::PopAxisAlignedClip:
+                dc->PopAxisAlignedClip();
+                break;
+
+            case CommandListRecordType::PushLayer:
+                {
+                    auto record = payload.Read<PushLayerRecord>();
+
+                    auto geometricMask = GetOptionalResource<ID2D1Geometry>(record.GeometricMask);
+                    auto opacityBrush = GetOptionalResource<ID2D1Brush>(record.OpacityBrush);
+
+                    auto layerParameters = D2D1::LayerParameters1(
+                        record.ContentBounds,
+                        geometricMask.Get(),
+                        static_cast<D2D1_ANTIALIAS_MODE>(record.MaskAntialiasMode),
+                        record.MaskTransform,
+                        record.Opacity,
+                        opacityBrush.Get(),
+                        static_cast<D2D1_LAYER_OPTIONS1>(record.LayerOptions));
+
+                    dc->PushLayer(layerParameters, nullptr);
+                }
+                break;
+
+            case CommandListRecordType::PopLayer:
+                dc->PopLayer();
+                break;
+
+            default:
+                ThrowInvalidData();
+            }
+        }
+
+        static D2D1_BRUSH_PROPERTIES const* ToBrushProperties(BrushProperties const& properties)
+        {
+            static_assert(sizeof(BrushProperties) == sizeof(D2D1_BRUSH_PROPERTIES), "BrushProperties must match D2D1_BRUSH_PROPERTIES");
+            return reinterpret_cast<D2D1_BRUSH_PROPERTIES const*>(&properties);
+        }
+    };
+
+
+    ComPtr<ID2D1CommandList> DeserializeCommandList(
+        ICanvasDevice* device,
+        uint8_t const* bytes,
+        size_t byteCount)
+    {
+        CommandListReader reader(device);
+        return reader.ReadFile(bytes, byteCount);
+    }
+
+}}}}
+
+#endif
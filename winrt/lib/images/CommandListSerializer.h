@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // Binary format used by CanvasCommandList.GetSerializedBytes.
+    //
+    // Everything is little endian and 4 byte aligned, so a serialized command
+    // list can be read in place from a memory mapped file. The file starts
+    // with a CommandListFileHeader, followed by ResourceCount resource
+    // definitions (taking up ResourceBytes), followed by the drawing commands.
+    //
+    // Each definition and command is a record: a CommandListRecordHeader
+    // followed by Size bytes of payload, padded to a multiple of 4. Resources
+    // (brushes, gradient stops, geometry, stroke styles, bitmaps and nested
+    // command lists) are defined once, numbered in the order they are
+    // defined, and referenced from commands by that number, so an object that
+    // is used many times is only stored once.
+    //
+    // Text is stored as glyph outlines, since fonts may not be available where
+    // the command list is deserialized.
+    //
+    struct CommandListFileHeader
+    {
+        static const uint32_t ExpectedMagic = 0x43443257;   // "W2DC"
+        static const uint32_t CurrentVersion = 1;
+
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t ResourceCount;
+        uint32_t ResourceBytes;
+    };
+
+    struct CommandListRecordHeader
+    {
+        uint16_t Type;
+        uint16_t Reserved;
+        uint32_t Size;
+    };
+
+    static_assert(sizeof(CommandListFileHeader) == 16, "CommandListFileHeader layout must not change");
+    static_assert(sizeof(CommandListRecordHeader) == 8, "CommandListRecordHeader layout must not change");
+
+
+    std::vector<uint8_t> SerializeCommandList(
+        ICanvasDevice* device,
+        ID2D1CommandList* commandList);
+
+    // The returned command list is still open, so more commands can be added to it.
+    ComPtr<ID2D1CommandList> DeserializeCommandList(
+        ICanvasDevice* device,
+        uint8_t const* bytes,
+        size_t byteCount);
+
+}}}}
+
+#endif
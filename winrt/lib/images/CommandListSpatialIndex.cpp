@@ -0,0 +1,586 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CommandListSpatialIndex.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    static D2D1_RECT_F TransformBounds(D2D1_RECT_F const& bounds, D2D1_MATRIX_3X2_F const& transform)
+    {
+        D2D1_POINT_2F const corners[] =
+        {
+            { bounds.left,  bounds.top },
+            { bounds.right, bounds.top },
+            { bounds.left,  bounds.bottom },
+            { bounds.right, bounds.bottom },
+        };
+
+        auto matrix = D2D1::Matrix3x2F::ReinterpretBaseType(&transform);
+
+        auto first = matrix->TransformPoint(corners[0]);
+        D2D1_RECT_F result{ first.x, first.y, first.x, first.y };
+
+        for (auto& corner : corners)
+        {
+            auto point = matrix->TransformPoint(corner);
+
+            result.left   = std::min(result.left,   point.x);
+            result.top    = std::min(result.top,    point.y);
+            result.right  = std::max(result.right,  point.x);
+            result.bottom = std::max(result.bottom, point.y);
+        }
+
+        // Transforming an infinite rectangle can produce NaNs.
+        if (!std::isfinite(result.left) || !std::isfinite(result.top) ||
+            !std::isfinite(result.right) || !std::isfinite(result.bottom))
+        {
+            return D2D1::InfiniteRect();
+        }
+
+        return result;
+    }
+
+
+    static D2D1_RECT_F InflateBounds(D2D1_RECT_F const& bounds, float amount)
+    {
+        return D2D1_RECT_F{ bounds.left - amount, bounds.top - amount, bounds.right + amount, bounds.bottom + amount };
+    }
+
+
+    static D2D1_RECT_F OffsetBounds(D2D1_RECT_F const& bounds, float x, float y)
+    {
+        return D2D1_RECT_F{ bounds.left + x, bounds.top + y, bounds.right + x, bounds.bottom + y };
+    }
+
+
+    static bool Intersects(D2D1_RECT_F const& a, D2D1_RECT_F const& b)
+    {
+        return a.left <= b.right && a.right >= b.left &&
+               a.top <= b.bottom && a.bottom >= b.top;
+    }
+
+
+    //
+    // Streams a command list in one of two modes. When measuring, it records
+    // the bounds of each drawing command. When culling, it forwards commands to
+    // a device context, leaving out drawing commands whose previously measured
+    // bounds don't intersect the visible rectangle. Using the same class for
+    // both keeps the numbering of drawing commands in sync.
+    //
+    class SpatialIndexCommandSink : public RuntimeClass<
+                                        RuntimeClassFlags<ClassicCom>,
+                                        ChainInterfaces<ID2D1CommandSink3, ID2D1CommandSink2, ID2D1CommandSink1, ID2D1CommandSink>>,
+                                    private LifespanTracker<SpatialIndexCommandSink>
+    {
+        ComPtr<ID2D1DeviceContext2> m_deviceContext;
+
+        std::vector<D2D1_RECT_F>* m_measuredBounds;         // Only set when measuring.
+        std::vector<D2D1_RECT_F> const* m_commandBounds;    // Only set when culling.
+        D2D1_RECT_F m_visibleRectangle;
+        size_t m_nextCommand;
+
+        D2D1_MATRIX_3X2_F m_transform;
+        bool m_usesPixelUnits;
+
+    public:
+        // Measuring constructor.
+        SpatialIndexCommandSink(ID2D1DeviceContext* measuringContext, std::vector<D2D1_RECT_F>* measuredBounds)
+            : m_deviceContext(As<ID2D1DeviceContext2>(measuringContext))
+            , m_measuredBounds(measuredBounds)
+            , m_commandBounds(nullptr)
+            , m_visibleRectangle{}
+            , m_nextCommand(0)
+            , m_transform(D2D1::Matrix3x2F::Identity())
+            , m_usesPixelUnits(false)
+        { }
+
+        // Culling constructor.
+        SpatialIndexCommandSink(ID2D1DeviceContext* recordingContext, std::vector<D2D1_RECT_F> const& commandBounds, D2D1_RECT_F const& visibleRectangle)
+            : m_deviceContext(As<ID2D1DeviceContext2>(recordingContext))
+            , m_measuredBounds(nullptr)
+            , m_commandBounds(&commandBounds)
+            , m_visibleRectangle(visibleRectangle)
+            , m_nextCommand(0)
+            , m_transform(D2D1::Matrix3x2F::Identity())
+            , m_usesPixelUnits(false)
+        { }
+
+        bool UsesPixelUnits() const
+        {
+            return m_usesPixelUnits;
+        }
+
+        IFACEMETHODIMP BeginDraw() override { return S_OK; }
+        IFACEMETHODIMP EndDraw() override { return S_OK; }
+
+        //
+        // State commands.
+        //
+
+        IFACEMETHODIMP SetTransform(D2D1_MATRIX_3X2_F const* transform) override
+        {
+            // Both modes need this: measuring glyph runs and gradient meshes reads it from the device context.
+            m_transform = *transform;
+            m_deviceContext->SetTransform(transform);
+            return S_OK;
+        }
+
+        IFACEMETHODIMP SetUnitMode(D2D1_UNIT_MODE unitMode) override
+        {
+            if (m_measuredBounds)
+            {
+                // Commands in pixel units can't be compared with visible rectangles in DIPs.
+                if (unitMode != D2D1_UNIT_MODE_DIPS)
+                    m_usesPixelUnits = true;
+            }
+            else
+            {
+                m_deviceContext->SetUnitMode(unitMode);
+            }
+
+            return S_OK;
+        }
+
+        IFACEMETHODIMP SetAntialiasMode(D2D1_ANTIALIAS_MODE antialiasMode) override
+        {
+            return StateCommand([&] { m_deviceContext->SetAntialiasMode(antialiasMode); });
+        }
+
+        IFACEMETHODIMP SetTags(D2D1_TAG tag1, D2D1_TAG tag2) override
+        {
+            return StateCommand([&] { m_deviceContext->SetTags(tag1, tag2); });
+        }
+
+        IFACEMETHODIMP SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE textAntialiasMode) override
+        {
+            return StateCommand([&] { m_deviceContext->SetTextAntialiasMode(textAntialiasMode); });
+        }
+
+        IFACEMETHODIMP SetTextRenderingParams(IDWriteRenderingParams* textRenderingParams) override
+        {
+            return StateCommand([&] { m_deviceContext->SetTextRenderingParams(textRenderingParams); });
+        }
+
+        IFACEMETHODIMP SetPrimitiveBlend(D2D1_PRIMITIVE_BLEND primitiveBlend) override
+        {
+            return StateCommand([&] { m_deviceContext->SetPrimitiveBlend(primitiveBlend); });
+        }
+
+        IFACEMETHODIMP SetPrimitiveBlend1(D2D1_PRIMITIVE_BLEND primitiveBlend) override
+        {
+            return StateCommand([&] { m_deviceContext->SetPrimitiveBlend(primitiveBlend); });
+        }
+
+        IFACEMETHODIMP PushAxisAlignedClip(D2D1_RECT_F const* clipRect, D2D1_ANTIALIAS_MODE antialiasMode) override
+        {
+            return StateCommand([&] { m_deviceContext->PushAxisAlignedClip(clipRect, antialiasMode); });
+        }
+
+        IFACEMETHODIMP PushLayer(D2D1_LAYER_PARAMETERS1 const* layerParameters, ID2D1Layer* layer) override
+        {
+            return StateCommand([&] { m_deviceContext->PushLayer(layerParameters, layer); });
+        }
+
+        IFACEMETHODIMP PopAxisAlignedClip() override
+        {
+            return StateCommand([&] { m_deviceContext->PopAxisAlignedClip(); });
+        }
+
+        IFACEMETHODIMP PopLayer() override
+        {
+            return StateCommand([&] { m_deviceContext->PopLayer(); });
+        }
+
+        //
+        // Drawing commands.
+        //
+
+        IFACEMETHODIMP Clear(D2D1_COLOR_F const* color) override
+        {
+            return DrawingCommand(
+                [&] { return D2D1::InfiniteRect(); },
+                [&] { m_deviceContext->Clear(color); });
+        }
+
+        IFACEMETHODIMP DrawGlyphRun(D2D1_POINT_2F baselineOrigin, DWRITE_GLYPH_RUN const* glyphRun, DWRITE_GLYPH_RUN_DESCRIPTION const* glyphRunDescription, ID2D1Brush* foregroundBrush, DWRITE_MEASURING_MODE measuringMode) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(m_deviceContext->GetGlyphRunWorldBounds(baselineOrigin, glyphRun, measuringMode, &bounds));
+                    return bounds;
+                },
+                [&] { m_deviceContext->DrawGlyphRun(baselineOrigin, glyphRun, glyphRunDescription, foregroundBrush, measuringMode); });
+        }
+
+        IFACEMETHODIMP DrawLine(D2D1_POINT_2F point0, D2D1_POINT_2F point1, ID2D1Brush* brush, FLOAT strokeWidth, ID2D1StrokeStyle* strokeStyle) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds
+                    {
+                        std::min(point0.x, point1.x),
+                        std::min(point0.y, point1.y),
+                        std::max(point0.x, point1.x),
+                        std::max(point0.y, point1.y)
+                    };
+
+                    return GetStrokeBounds(bounds, strokeWidth, strokeStyle);
+                },
+                [&] { m_deviceContext->DrawLine(point0, point1, brush, strokeWidth, strokeStyle); });
+        }
+
+        IFACEMETHODIMP DrawGeometry(ID2D1Geometry* geometry, ID2D1Brush* brush, FLOAT strokeWidth, ID2D1StrokeStyle* strokeStyle) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(geometry->GetWidenedBounds(strokeWidth, strokeStyle, &m_transform, &bounds));
+                    return bounds;
+                },
+                [&] { m_deviceContext->DrawGeometry(geometry, brush, strokeWidth, strokeStyle); });
+        }
+
+        IFACEMETHODIMP DrawRectangle(D2D1_RECT_F const* rect, ID2D1Brush* brush, FLOAT strokeWidth, ID2D1StrokeStyle* strokeStyle) override
+        {
+            return DrawingCommand(
+                [&] { return GetStrokeBounds(*rect, strokeWidth, strokeStyle); },
+                [&] { m_deviceContext->DrawRectangle(rect, brush, strokeWidth, strokeStyle); });
+        }
+
+        IFACEMETHODIMP DrawBitmap(ID2D1Bitmap* bitmap, D2D1_RECT_F const* destinationRectangle, FLOAT opacity, D2D1_INTERPOLATION_MODE interpolationMode, D2D1_RECT_F const* sourceRectangle, D2D1_MATRIX_4X4_F const* perspectiveTransform) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    if (perspectiveTransform)
+                        return D2D1::InfiniteRect();
+
+                    if (destinationRectangle)
+                        return TransformBounds(*destinationRectangle, m_transform);
+
+                    auto size = bitmap->GetSize();
+
+                    if (sourceRectangle)
+                        size = D2D1_SIZE_F{ sourceRectangle->right - sourceRectangle->left, sourceRectangle->bottom - sourceRectangle->top };
+
+                    return TransformBounds(D2D1_RECT_F{ 0, 0, size.width, size.height }, m_transform);
+                },
+                [&] { m_deviceContext->DrawBitmap(bitmap, destinationRectangle, opacity, interpolationMode, sourceRectangle, perspectiveTransform); });
+        }
+
+        IFACEMETHODIMP DrawImage(ID2D1Image* image, D2D1_POINT_2F const* targetOffset, D2D1_RECT_F const* imageRectangle, D2D1_INTERPOLATION_MODE interpolationMode, D2D1_COMPOSITE_MODE compositeMode) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(m_deviceContext->GetImageLocalBounds(image, &bounds));
+
+                    // The top left of the image rectangle (or the image origin if there isn't one) is drawn at the target offset.
+                    D2D1_POINT_2F origin{ 0, 0 };
+
+                    if (imageRectangle)
+                    {
+                        bounds.left   = std::max(bounds.left,   imageRectangle->left);
+                        bounds.top    = std::max(bounds.top,    imageRectangle->top);
+                        bounds.right  = std::min(bounds.right,  imageRectangle->right);
+                        bounds.bottom = std::min(bounds.bottom, imageRectangle->bottom);
+
+                        origin = D2D1_POINT_2F{ imageRectangle->left, imageRectangle->top };
+                    }
+
+                    if (targetOffset)
+                        bounds = OffsetBounds(bounds, targetOffset->x - origin.x, targetOffset->y - origin.y);
+                    else
+                        bounds = OffsetBounds(bounds, -origin.x, -origin.y);
+
+                    return TransformBounds(bounds, m_transform);
+                },
+                [&] { m_deviceContext->DrawImage(image, targetOffset, imageRectangle, interpolationMode, compositeMode); });
+        }
+
+        IFACEMETHODIMP DrawGdiMetafile(ID2D1GdiMetafile* gdiMetafile, D2D1_POINT_2F const* targetOffset) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(gdiMetafile->GetBounds(&bounds));
+
+                    if (targetOffset)
+                        bounds = OffsetBounds(bounds, targetOffset->x, targetOffset->y);
+
+                    return TransformBounds(bounds, m_transform);
+                },
+                [&] { m_deviceContext->DrawGdiMetafile(gdiMetafile, targetOffset); });
+        }
+
+        IFACEMETHODIMP DrawGdiMetafile(ID2D1GdiMetafile* gdiMetafile, D2D1_RECT_F const* destinationRectangle, D2D1_RECT_F const* sourceRectangle) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    if (destinationRectangle)
+                        return TransformBounds(*destinationRectangle, m_transform);
+
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(gdiMetafile->GetBounds(&bounds));
+                    return TransformBounds(bounds, m_transform);
+                },
+                [&] { m_deviceContext->DrawGdiMetafile(gdiMetafile, destinationRectangle, sourceRectangle); });
+        }
+
+        IFACEMETHODIMP FillMesh(ID2D1Mesh* mesh, ID2D1Brush* brush) override
+        {
+            // Meshes don't know their bounds.
+            return DrawingCommand(
+                [&] { return D2D1::InfiniteRect(); },
+                [&] { m_deviceContext->FillMesh(mesh, brush); });
+        }
+
+        IFACEMETHODIMP FillOpacityMask(ID2D1Bitmap* opacityMask, ID2D1Brush* brush, D2D1_RECT_F const* destinationRectangle, D2D1_RECT_F const* sourceRectangle) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    if (destinationRectangle)
+                        return TransformBounds(*destinationRectangle, m_transform);
+
+                    auto size = opacityMask->GetSize();
+                    return TransformBounds(D2D1_RECT_F{ 0, 0, size.width, size.height }, m_transform);
+                },
+                [&] { m_deviceContext->FillOpacityMask(opacityMask, brush, destinationRectangle, sourceRectangle); });
+        }
+
+        IFACEMETHODIMP FillGeometry(ID2D1Geometry* geometry, ID2D1Brush* brush, ID2D1Brush* opacityBrush) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(geometry->GetBounds(&m_transform, &bounds));
+                    return bounds;
+                },
+                [&] { m_deviceContext->FillGeometry(geometry, brush, opacityBrush); });
+        }
+
+        IFACEMETHODIMP FillRectangle(D2D1_RECT_F const* rect, ID2D1Brush* brush) override
+        {
+            return DrawingCommand(
+                [&] { return TransformBounds(*rect, m_transform); },
+                [&] { m_deviceContext->FillRectangle(rect, brush); });
+        }
+
+        IFACEMETHODIMP DrawInk(ID2D1Ink* ink, ID2D1Brush* brush, ID2D1InkStyle* inkStyle) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(ink->GetBounds(inkStyle, &m_transform, &bounds));
+                    return bounds;
+                },
+                [&] { m_deviceContext->DrawInk(ink, brush, inkStyle); });
+        }
+
+        IFACEMETHODIMP DrawGradientMesh(ID2D1GradientMesh* gradientMesh) override
+        {
+            return DrawingCommand(
+                [&]
+                {
+                    D2D1_RECT_F bounds;
+                    ThrowIfFailed(m_deviceContext->GetGradientMeshWorldBounds(gradientMesh, &bounds));
+                    return bounds;
+                },
+                [&] { m_deviceContext->DrawGradientMesh(gradientMesh); });
+        }
+
+        IFACEMETHODIMP DrawSpriteBatch(ID2D1SpriteBatch* spriteBatch, UINT32 startIndex, UINT32 spriteCount, ID2D1Bitmap* bitmap, D2D1_BITMAP_INTERPOLATION_MODE interpolationMode, D2D1_SPRITE_OPTIONS spriteOptions) override
+        {
+            // Sprites can be anywhere, and reading them all back to find out would cost more than drawing them.
+            return DrawingCommand(
+                [&] { return D2D1::InfiniteRect(); },
+                [&] { As<ID2D1DeviceContext3>(m_deviceContext)->DrawSpriteBatch(spriteBatch, startIndex, spriteCount, bitmap, interpolationMode, spriteOptions); });
+        }
+
+    private:
+        template<typename FN>
+        HRESULT StateCommand(FN&& forward)
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    if (!m_measuredBounds)
+                        forward();
+                });
+        }
+
+        template<typename MEASURE, typename FORWARD>
+        HRESULT DrawingCommand(MEASURE&& measure, FORWARD&& forward)
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    if (m_measuredBounds)
+                    {
+                        m_measuredBounds->push_back(measure());
+                    }
+                    else
+                    {
+                        // Anything that wasn't measured is assumed to be visible.
+                        bool isVisible = m_nextCommand >= m_commandBounds->size() ||
+                                         Intersects((*m_commandBounds)[m_nextCommand], m_visibleRectangle);
+
+                        m_nextCommand++;
+
+                        if (isVisible)
+                            forward();
+                    }
+                });
+        }
+
+        //
+        // A conservative estimate of the area covered by stroking a rectangle or
+        // line, which can extend sqrt(2) * half the stroke width past a square
+        // corner or cap. Unless the stroke style says otherwise, stroke widths
+        // scale with the transform, while hairlines are one pixel whatever it is.
+        //
+        D2D1_RECT_F GetStrokeBounds(D2D1_RECT_F const& bounds, float strokeWidth, ID2D1StrokeStyle* strokeStyle)
+        {
+            float scale = std::sqrt(std::max(m_transform._11 * m_transform._11 + m_transform._12 * m_transform._12,
+                                             m_transform._21 * m_transform._21 + m_transform._22 * m_transform._22));
+
+            if (auto strokeStyle1 = MaybeAs<ID2D1StrokeStyle1>(strokeStyle))
+            {
+                switch (strokeStyle1->GetStrokeTransformType())
+                {
+                case D2D1_STROKE_TRANSFORM_TYPE_FIXED:
+                    scale = 1;
+                    break;
+
+                case D2D1_STROKE_TRANSFORM_TYPE_HAIRLINE:
+                    strokeWidth = 1;
+                    scale = 1;
+                    break;
+                }
+            }
+
+            auto inflation = std::abs(strokeWidth) * scale * 0.5f * 1.4143f;
+
+            return InflateBounds(TransformBounds(bounds, m_transform), inflation);
+        }
+    };
+
+
+    std::unique_ptr<CommandListSpatialIndex> CommandListSpatialIndex::Create(
+        ID2D1CommandList* commandList,
+        ID2D1DeviceContext* measuringContext)
+    {
+        D2D1_MATRIX_3X2_F previousTransform;
+        measuringContext->GetTransform(&previousTransform);
+
+        auto previousUnitMode = measuringContext->GetUnitMode();
+
+        auto restoreDeviceContext = MakeScopeWarden(
+            [&]
+            {
+                measuringContext->SetTransform(&previousTransform);
+                measuringContext->SetUnitMode(previousUnitMode);
+            });
+
+        measuringContext->SetTransform(D2D1::Matrix3x2F::Identity());
+        measuringContext->SetUnitMode(D2D1_UNIT_MODE_DIPS);
+
+        std::vector<D2D1_RECT_F> commandBounds;
+
+        auto sink = Make<SpatialIndexCommandSink>(measuringContext, &commandBounds);
+        CheckMakeResult(sink);
+
+        // Streaming fails if the command list holds anything our sink doesn't implement.
+        if (FAILED(commandList->Stream(sink.Get())) || sink->UsesPixelUnits())
+            return nullptr;
+
+        return std::make_unique<CommandListSpatialIndex>(std::move(commandBounds));
+    }
+
+
+    CommandListSpatialIndex::CommandListSpatialIndex(std::vector<D2D1_RECT_F>&& commandBounds)
+        : m_commandBounds(std::move(commandBounds))
+        , m_totalBounds{ 0, 0, 0, 0 }
+    {
+        if (!m_commandBounds.empty())
+        {
+            m_totalBounds = m_commandBounds.front();
+
+            for (auto& bounds : m_commandBounds)
+            {
+                m_totalBounds.left   = std::min(m_totalBounds.left,   bounds.left);
+                m_totalBounds.top    = std::min(m_totalBounds.top,    bounds.top);
+                m_totalBounds.right  = std::max(m_totalBounds.right,  bounds.right);
+                m_totalBounds.bottom = std::max(m_totalBounds.bottom, bounds.bottom);
+            }
+        }
+    }
+
+
+    bool CommandListSpatialIndex::IsEntirelyInside(D2D1_RECT_F const& visibleRectangle) const
+    {
+        return m_totalBounds.left >= visibleRectangle.left &&
+               m_totalBounds.top >= visibleRectangle.top &&
+               m_totalBounds.right <= visibleRectangle.right &&
+               m_totalBounds.bottom <= visibleRectangle.bottom;
+    }
+
+
+    void CommandListSpatialIndex::RecordCulledCommands(
+        ID2D1CommandList* commandList,
+        ID2D1CommandList* culledCommandList,
+        ID2D1DeviceContext* recordingContext,
+        D2D1_RECT_F const& visibleRectangle) const
+    {
+        ComPtr<ID2D1Image> previousTarget;
+        recordingContext->GetTarget(&previousTarget);
+
+        D2D1_MATRIX_3X2_F previousTransform;
+        recordingContext->GetTransform(&previousTransform);
+
+        auto previousUnitMode = recordingContext->GetUnitMode();
+
+        auto restoreDeviceContext = MakeScopeWarden(
+            [&]
+            {
+                recordingContext->SetTarget(previousTarget.Get());
+                recordingContext->SetTransform(&previousTransform);
+                recordingContext->SetUnitMode(previousUnitMode);
+            });
+
+        recordingContext->SetTarget(culledCommandList);
+        recordingContext->SetTransform(D2D1::Matrix3x2F::Identity());
+        recordingContext->SetUnitMode(D2D1_UNIT_MODE_DIPS);
+
+        auto sink = Make<SpatialIndexCommandSink>(recordingContext, m_commandBounds, visibleRectangle);
+        CheckMakeResult(sink);
+
+        recordingContext->BeginDraw();
+
+        auto streamResult = commandList->Stream(sink.Get());
+        auto endDrawResult = recordingContext->EndDraw();
+
+        ThrowIfFailed(streamResult);
+        ThrowIfFailed(endDrawResult);
+
+        ThrowIfFailed(culledCommandList->Close());
+    }
+
+}}}}
+
+#endif
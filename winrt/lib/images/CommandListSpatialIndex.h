@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // Records the bounds of every drawing command in a closed command list, so
+    // it can be played back leaving out commands that are entirely outside a
+    // visible rectangle.
+    //
+    // Playback has to stream the whole D2D command list regardless (there is
+    // no way to seek within one), so a flat table of bounds, tested as each
+    // command goes past, is as cheap as any tree would be. What culling saves
+    // is D2D having to render the commands that are left out.
+    //
+    // State commands (transforms, clips, layers, blend modes and so on) are
+    // always kept. Drawing commands whose bounds can't be worked out cheaply
+    // are treated as covering everything.
+    //
+    class CommandListSpatialIndex
+    {
+        std::vector<D2D1_RECT_F> m_commandBounds;   // One per drawing command, in command list space.
+        D2D1_RECT_F m_totalBounds;
+
+    public:
+        // Returns null if the command list can't be indexed, for instance because
+        // it uses pixel units, or contains commands the index doesn't understand.
+        static std::unique_ptr<CommandListSpatialIndex> Create(
+            ID2D1CommandList* commandList,
+            ID2D1DeviceContext* measuringContext);
+
+        CommandListSpatialIndex(std::vector<D2D1_RECT_F>&& commandBounds);
+
+        // If every command is inside visibleRectangle, culling would not leave anything out.
+        bool IsEntirelyInside(D2D1_RECT_F const& visibleRectangle) const;
+
+        // Records the commands of commandList that intersect visibleRectangle into
+        // culledCommandList (which must be newly created), and closes it.
+        void RecordCulledCommands(
+            ID2D1CommandList* commandList,
+            ID2D1CommandList* culledCommandList,
+            ID2D1DeviceContext* recordingContext,
+            D2D1_RECT_F const& visibleRectangle) const;
+    };
+
+}}}}
+
+#endif
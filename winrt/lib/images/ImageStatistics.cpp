@@ -0,0 +1,386 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "ImageStatistics.h"
+#include "effects/generated/AtlasEffect.h"
+#include "effects/shader/PixelShaderEffect.h"
+#include "effects/shader/SharedShaderState.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ABI::Microsoft::Graphics::Canvas::Effects;
+
+    // Each reduction pass turns a block of this many pixels square into one.
+    static const int StatisticsBlockSize = 16;
+
+    enum class StatisticsOperation
+    {
+        Minimum,
+        Maximum,
+        Sum,
+        SumOfSquares,
+    };
+
+    //
+    // Output pixel (x, y) combines the input pixels in the block starting at
+    // (x, y) * BLOCK_SIZE, skipping any that fall outside Size. Origin is
+    // where the region being measured starts in the input image.
+    //
+    // The first pass reads the source image, so it unpremultiplies the
+    // colors (matching ComputeHistogram) and squares them when summing
+    // squares. Later passes just combine the results of the previous one.
+    //
+    static char const StatisticsShaderSource[] = R"(
+
+        #define BLOCK_SIZE 16
+
+        Texture2D Input : register(t0);
+        SamplerState InputSampler : register(s0);
+
+        cbuffer Constants : register(b0)
+        {
+            int Operation;
+            bool FirstPass;
+            float2 Origin;
+            float2 Size;
+        };
+
+        float4 main(float4 clipPosition : SV_POSITION, float4 scenePosition : SCENE_POSITION, float4 texCoord : TEXCOORD0) : SV_TARGET
+        {
+            float infinity = asfloat(0x7f800000);
+
+            float4 result = (Operation == 0) ? infinity :
+                            (Operation == 1) ? -infinity : 0;
+
+            float2 blockStart = floor(scenePosition.xy) * BLOCK_SIZE;
+
+            [loop]
+            for (int y = 0; y < BLOCK_SIZE; y++)
+            {
+                [loop]
+                for (int x = 0; x < BLOCK_SIZE; x++)
+                {
+                    float2 texel = blockStart + float2(x, y);
+
+                    if (any(texel < 0) || any(texel >= Size))
+                        continue;
+
+                    float2 samplePosition = Origin + texel + 0.5;
+                    float4 value = Input.SampleLevel(InputSampler, texCoord.xy + (samplePosition - scenePosition.xy) * texCoord.zw, 0);
+
+                    if (FirstPass)
+                    {
+                        if (value.a > 0)
+                            value.rgb /= value.a;
+
+                        if (Operation == 3)
+                            value *= value;
+                    }
+
+                    if (Operation == 0)
+                        result = min(result, value);
+                    else if (Operation == 1)
+                        result = max(result, value);
+                    else
+                        result += value;
+                }
+            }
+
+            return result;
+        }
+
+    )";
+
+
+    //
+    // The shader is compiled on first use, using the copy of the HLSL compiler
+    // that ships with Windows, rather than carrying precompiled bytecode that
+    // would need regenerating whenever the source above changes.
+    //
+    static std::vector<BYTE> const& GetStatisticsShaderCode()
+    {
+        static std::vector<BYTE> const code = []
+        {
+            ComPtr<ID3DBlob> shaderBlob;
+            ComPtr<ID3DBlob> errorBlob;
+
+            ThrowIfFailed(D3DCompile(
+                StatisticsShaderSource,
+                sizeof(StatisticsShaderSource) - 1,
+                "ImageStatistics",
+                nullptr,
+                nullptr,
+                "main",
+                "ps_4_0",
+                D3DCOMPILE_OPTIMIZATION_LEVEL3,
+                0,
+                &shaderBlob,
+                &errorBlob));
+
+            auto begin = static_cast<BYTE const*>(shaderBlob->GetBufferPointer());
+
+            return std::vector<BYTE>(begin, begin + shaderBlob->GetBufferSize());
+        }();
+
+        return code;
+    }
+
+
+    template<typename T>
+    static void SetShaderProperty(ISharedShaderState* sharedState, wchar_t const* name, T const& value)
+    {
+        auto boxedValue = Make<Nullable<T>>(value);
+        CheckMakeResult(boxedValue);
+
+        sharedState->SetProperty(HStringReference(name).Get(), boxedValue.Get());
+    }
+
+
+    static ComPtr<ICanvasImage> CreateReductionPass(
+        ICanvasImage* input,
+        StatisticsOperation operation,
+        bool firstPass,
+        Vector2 origin,
+        Vector2 size)
+    {
+        auto& shaderCode = GetStatisticsShaderCode();
+
+        auto sharedState = Make<SharedShaderState>(const_cast<BYTE*>(shaderCode.data()), static_cast<uint32_t>(shaderCode.size()));
+        CheckMakeResult(sharedState);
+
+        SetShaderProperty(sharedState.Get(), L"Operation", static_cast<int>(operation));
+        SetShaderProperty(sharedState.Get(), L"FirstPass", firstPass);
+        SetShaderProperty(sharedState.Get(), L"Origin", origin);
+        SetShaderProperty(sharedState.Get(), L"Size", size);
+
+        // The shader reads a whole block for each output pixel, and must see exact texel values.
+        sharedState->CoordinateMapping().Mapping[0] = SamplerCoordinateMapping::Unknown;
+        sharedState->SourceInterpolation().Filter[0] = D2D1_FILTER_MIN_MAG_MIP_POINT;
+
+        auto effect = Make<PixelShaderEffect>(nullptr, nullptr, sharedState.Get());
+        CheckMakeResult(effect);
+
+        ThrowIfFailed(effect->put_Source1(As<IGraphicsEffectSource>(input).Get()));
+
+        return As<ICanvasImage>(effect);
+    }
+
+
+    static ComPtr<ID2D1Bitmap1> CreateFloatBitmap(ID2D1DeviceContext* deviceContext, uint32_t width, uint32_t height, D2D1_BITMAP_OPTIONS options)
+    {
+        auto properties = D2D1::BitmapProperties1(
+            options,
+            D2D1::PixelFormat(DXGI_FORMAT_R32G32B32A32_FLOAT, D2D1_ALPHA_MODE_PREMULTIPLIED));
+
+        ComPtr<ID2D1Bitmap1> bitmap;
+        ThrowIfFailed(deviceContext->CreateBitmap(D2D1::SizeU(width, height), nullptr, 0, &properties, &bitmap));
+
+        return bitmap;
+    }
+
+
+    static void DrawReductionPass(
+        ID2D1DeviceContext* deviceContext,
+        ID2D1Bitmap1* target,
+        ID2D1Image* pass,
+        uint32_t width,
+        uint32_t height,
+        D2D1_POINT_2F const& targetOffset)
+    {
+        // Limit the draw to the pixels that hold results, so neighboring results aren't overwritten.
+        D2D1_RECT_F imageRectangle{ 0, 0, static_cast<float>(width), static_cast<float>(height) };
+
+        deviceContext->SetTarget(target);
+        deviceContext->BeginDraw();
+        deviceContext->DrawImage(pass, &targetOffset, &imageRectangle, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_COMPOSITE_MODE_SOURCE_COPY);
+        ThrowIfFailed(deviceContext->EndDraw());
+    }
+
+
+    static uint32_t DivideRoundingUp(uint32_t value, uint32_t divisor)
+    {
+        return (value + divisor - 1) / divisor;
+    }
+
+
+    static void ValidateFeatureLevel(ICanvasDevice* device)
+    {
+        // Check up front, as the shader would otherwise fail to compile or
+        // realize with no explanation of why.
+        ComPtr<ID3D11Device> d3dDevice;
+        ThrowIfFailed(As<IDirect3DDxgiInterfaceAccess>(device)->GetInterface(IID_PPV_ARGS(&d3dDevice)));
+
+        if (d3dDevice->GetFeatureLevel() < D3D_FEATURE_LEVEL_10_0)
+            ThrowHR(E_FAIL, Strings::ComputeStatisticsBadFeatureLevel);
+    }
+
+
+    std::vector<D2D1_SIZE_U> GetStatisticsReductionPassSizes(uint32_t width, uint32_t height)
+    {
+        std::vector<D2D1_SIZE_U> sizes;
+
+        do
+        {
+            width = DivideRoundingUp(width, StatisticsBlockSize);
+            height = DivideRoundingUp(height, StatisticsBlockSize);
+
+            sizes.push_back(D2D1::SizeU(width, height));
+        }
+        while (width > 1 || height > 1);
+
+        return sizes;
+    }
+
+
+    CanvasImageStatistics GetStatisticsFromReductionResults(
+        Vector4 const& minimum,
+        Vector4 const& maximum,
+        Vector4 const& sum,
+        Vector4 const& sumOfSquares,
+        float pixelCount)
+    {
+        auto mean = [&](float sum) { return sum / pixelCount; };
+
+        // Rounding can leave this very slightly negative for a constant channel.
+        auto variance = [&](float sum, float sumOfSquares) { return std::max(sumOfSquares / pixelCount - mean(sum) * mean(sum), 0.0f); };
+
+        CanvasImageStatistics statistics;
+
+        statistics.Minimum = minimum;
+        statistics.Maximum = maximum;
+        statistics.Mean = Vector4{ mean(sum.X), mean(sum.Y), mean(sum.Z), mean(sum.W) };
+        statistics.Variance = Vector4
+        {
+            variance(sum.X, sumOfSquares.X),
+            variance(sum.Y, sumOfSquares.Y),
+            variance(sum.Z, sumOfSquares.Z),
+            variance(sum.W, sumOfSquares.W)
+        };
+
+        return statistics;
+    }
+
+
+    CanvasImageStatistics ComputeImageStatistics(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        ICanvasDevice* device)
+    {
+        // Like ComputeHistogram, this measures whole pixels at the default DPI.
+        auto left = std::floor(sourceRectangle.X);
+        auto top = std::floor(sourceRectangle.Y);
+        auto right = std::ceil(sourceRectangle.X + sourceRectangle.Width);
+        auto bottom = std::ceil(sourceRectangle.Y + sourceRectangle.Height);
+
+        if (!(right > left) || !(bottom > top))
+            ThrowHR(E_INVALIDARG);
+
+        auto width = static_cast<uint32_t>(right - left);
+        auto height = static_cast<uint32_t>(bottom - top);
+
+        ValidateFeatureLevel(device);
+
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+        auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+        // Crop the source, so the reduction shader (which may read from anywhere) has a bounded input.
+        auto atlas = Make<AtlasEffect>();
+        CheckMakeResult(atlas);
+
+        ThrowIfFailed(atlas->put_SourceRectangle(Rect{ left, top, right - left, bottom - top }));
+        ThrowIfFailed(atlas->put_Source(As<IGraphicsEffectSource>(image).Get()));
+
+        auto sourceImage = As<ICanvasImage>(atlas);
+
+        // Render in floating point, so sums don't saturate and values outside 0-1 survive.
+        D2D1_RENDERING_CONTROLS previousRenderingControls;
+        deviceContext->GetRenderingControls(&previousRenderingControls);
+
+        ComPtr<ID2D1Image> previousTarget;
+        deviceContext->GetTarget(&previousTarget);
+
+        auto restoreDeviceContext = MakeScopeWarden(
+            [&]
+            {
+                deviceContext->SetTarget(previousTarget.Get());
+                deviceContext->SetRenderingControls(previousRenderingControls);
+            });
+
+        auto renderingControls = previousRenderingControls;
+        renderingControls.bufferPrecision = D2D1_BUFFER_PRECISION_32BPC_FLOAT;
+        deviceContext->SetRenderingControls(renderingControls);
+
+        // Each operation reduces down to one pixel of this bitmap.
+        StatisticsOperation const operations[] =
+        {
+            StatisticsOperation::Minimum,
+            StatisticsOperation::Maximum,
+            StatisticsOperation::Sum,
+            StatisticsOperation::SumOfSquares,
+        };
+
+        auto results = CreateFloatBitmap(deviceContext.Get(), _countof(operations), 1, D2D1_BITMAP_OPTIONS_TARGET);
+
+        auto passSizes = GetStatisticsReductionPassSizes(width, height);
+
+        for (uint32_t i = 0; i < _countof(operations); i++)
+        {
+            ComPtr<ICanvasImage> input = sourceImage;
+            Vector2 origin{ left, top };
+            auto inputSize = D2D1::SizeU(width, height);
+
+            for (size_t passIndex = 0; passIndex < passSizes.size(); passIndex++)
+            {
+                auto& outputSize = passSizes[passIndex];
+
+                auto pass = CreateReductionPass(
+                    input.Get(),
+                    operations[i],
+                    passIndex == 0,
+                    origin,
+                    Vector2{ static_cast<float>(inputSize.width), static_cast<float>(inputSize.height) });
+
+                float realizedDpi;
+                auto d2dPass = As<ICanvasImageInternal>(pass)->GetD2DImage(device, deviceContext.Get(), GetImageFlags::None, DEFAULT_DPI, &realizedDpi);
+
+                if (passIndex == passSizes.size() - 1)
+                {
+                    DrawReductionPass(deviceContext.Get(), results.Get(), d2dPass.Get(), 1, 1, D2D1::Point2F(static_cast<float>(i), 0));
+                    break;
+                }
+
+                auto intermediate = CreateFloatBitmap(deviceContext.Get(), outputSize.width, outputSize.height, D2D1_BITMAP_OPTIONS_TARGET);
+
+                DrawReductionPass(deviceContext.Get(), intermediate.Get(), d2dPass.Get(), outputSize.width, outputSize.height, D2D1::Point2F());
+
+                auto intermediateBitmap = Make<CanvasBitmap>(device, intermediate.Get());
+                CheckMakeResult(intermediateBitmap);
+
+                input = As<ICanvasImage>(intermediateBitmap);
+                origin = Vector2{ 0, 0 };
+                inputSize = outputSize;
+            }
+        }
+
+        // Read back the four result pixels.
+        auto readback = CreateFloatBitmap(deviceContext.Get(), _countof(operations), 1, D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW);
+
+        ThrowIfFailed(readback->CopyFromBitmap(nullptr, results.Get(), nullptr));
+
+        D2D1_MAPPED_RECT mapped;
+        ThrowIfFailed(readback->Map(D2D1_MAP_OPTIONS_READ, &mapped));
+
+        Vector4 values[_countof(operations)];
+        memcpy(values, mapped.bits, sizeof(values));
+
+        ThrowIfFailed(readback->Unmap());
+
+        auto pixelCount = static_cast<float>(width) * static_cast<float>(height);
+
+        return GetStatisticsFromReductionResults(values[0], values[1], values[2], values[3], pixelCount);
+    }
+
+}}}}
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // Computes per channel minimum, maximum, mean and variance of part of an
+    // image on the GPU. The image is reduced a block of pixels at a time by
+    // a PixelShaderEffect running a built-in shader, until only one pixel
+    // per statistic is left, so just those few values are read back.
+    //
+    // The reduction shader targets ps_4_0, so this throws on feature level 9.x devices.
+    CanvasImageStatistics ComputeImageStatistics(
+        ICanvasImage* image,
+        Rect sourceRectangle,
+        ICanvasDevice* device);
+
+    // The size each reduction pass shrinks a width x height region down to,
+    // in order. The last is always 1x1.
+    std::vector<D2D1_SIZE_U> GetStatisticsReductionPassSizes(uint32_t width, uint32_t height);
+
+    // Turns the values the reductions read back into statistics for a region of pixelCount pixels.
+    CanvasImageStatistics GetStatisticsFromReductionResults(
+        Vector4 const& minimum,
+        Vector4 const& maximum,
+        Vector4 const& sum,
+        Vector4 const& sumOfSquares,
+        float pixelCount);
+
+}}}}
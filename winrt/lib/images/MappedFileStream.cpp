@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "MappedFileStream.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL::Wrappers;
+
+    ComPtr<IStream> MappedFileStream::TryCreate(wchar_t const* fileName)
+    {
+        FileHandle file(CreateFile2(fileName, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr));
+
+        if (!file.IsValid())
+            return nullptr;
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(file.Get(), &fileSize) || fileSize.QuadPart <= 0)
+            return nullptr;
+
+        // 32 bit processes can't map views this big.
+        if (static_cast<uint64_t>(fileSize.QuadPart) > std::numeric_limits<SIZE_T>::max())
+            return nullptr;
+
+        HandleT<HandleTraits::HANDLENullTraits> mapping(CreateFileMappingFromApp(file.Get(), nullptr, PAGE_READONLY, 0, nullptr));
+
+        if (!mapping.IsValid())
+            return nullptr;
+
+        // The view keeps the file and mapping open, so their handles can be closed straight away.
+        auto view = MapViewOfFileFromApp(mapping.Get(), FILE_MAP_READ, 0, 0);
+
+        if (!view)
+            return nullptr;
+
+        auto stream = Make<MappedFileStream>(fileName, static_cast<uint8_t const*>(view), static_cast<uint64_t>(fileSize.QuadPart));
+
+        if (!stream)
+        {
+            UnmapViewOfFile(view);
+            return nullptr;
+        }
+
+        return stream;
+    }
+
+
+    MappedFileStream::MappedFileStream(std::wstring fileName, uint8_t const* data, uint64_t size)
+        : m_fileName(std::move(fileName))
+        , m_data(data)
+        , m_size(size)
+        , m_position(0)
+    {
+    }
+
+
+    MappedFileStream::~MappedFileStream()
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+
+    ULONG MappedFileStream::GetBytesAvailable(ULONG byteCount) const
+    {
+        if (m_position >= m_size)
+            return 0;
+
+        return static_cast<ULONG>(std::min<uint64_t>(byteCount, m_size - m_position));
+    }
+
+
+    //
+    // Reading a mapped view raises an exception, rather than returning an
+    // error, if the file can't be paged in (for instance because it is on a
+    // network share that has gone away, or was truncated by someone else).
+    //
+    static HRESULT CopyFromMappedView(void* destination, void const* source, SIZE_T byteCount)
+    {
+        __try
+        {
+            memcpy(destination, source, byteCount);
+            return S_OK;
+        }
+        __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+        {
+            return HRESULT_FROM_WIN32(ERROR_READ_FAULT);
+        }
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Read(void* buffer, ULONG byteCount, ULONG* bytesRead)
+    {
+        if (!buffer)
+            return STG_E_INVALIDPOINTER;
+
+        auto count = GetBytesAvailable(byteCount);
+
+        HRESULT hr = count ? CopyFromMappedView(buffer, m_data + m_position, count) : S_OK;
+
+        if (FAILED(hr))
+            count = 0;
+
+        m_position += count;
+
+        if (bytesRead)
+            *bytesRead = count;
+
+        if (FAILED(hr))
+            return hr;
+
+        return (count < byteCount) ? S_FALSE : S_OK;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Write(void const*, ULONG, ULONG* bytesWritten)
+    {
+        if (bytesWritten)
+            *bytesWritten = 0;
+
+        return STG_E_ACCESSDENIED;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Seek(LARGE_INTEGER move, DWORD origin, ULARGE_INTEGER* newPosition)
+    {
+        int64_t base;
+
+        switch (origin)
+        {
+        case STREAM_SEEK_SET: base = 0;                                   break;
+        case STREAM_SEEK_CUR: base = static_cast<int64_t>(m_position);    break;
+        case STREAM_SEEK_END: base = static_cast<int64_t>(m_size);        break;
+        default:
+            return STG_E_INVALIDFUNCTION;
+        }
+
+        auto position = base + move.QuadPart;
+
+        if (position < 0)
+            return STG_E_INVALIDFUNCTION;
+
+        m_position = static_cast<uint64_t>(position);
+
+        if (newPosition)
+            newPosition->QuadPart = m_position;
+
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::SetSize(ULARGE_INTEGER)
+    {
+        return STG_E_ACCESSDENIED;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::CopyTo(IStream* stream, ULARGE_INTEGER byteCount, ULARGE_INTEGER* bytesRead, ULARGE_INTEGER* bytesWritten)
+    {
+        if (!stream)
+            return STG_E_INVALIDPOINTER;
+
+        uint64_t totalRead = 0;
+        uint64_t totalWritten = 0;
+        HRESULT hr = S_OK;
+
+        // Write straight out of the view, a chunk at a time since Write takes a ULONG count.
+        while (totalRead < byteCount.QuadPart && m_position < m_size)
+        {
+            auto count = GetBytesAvailable(static_cast<ULONG>(std::min<uint64_t>(byteCount.QuadPart - totalRead, ULONG_MAX)));
+
+            ULONG written = 0;
+            hr = stream->Write(m_data + m_position, count, &written);
+
+            m_position += count;
+            totalRead += count;
+            totalWritten += written;
+
+            if (FAILED(hr))
+                break;
+        }
+
+        if (bytesRead)
+            bytesRead->QuadPart = totalRead;
+
+        if (bytesWritten)
+            bytesWritten->QuadPart = totalWritten;
+
+        return hr;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Commit(DWORD)
+    {
+        // Nothing can have been written, so there is nothing to commit.
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Revert()
+    {
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::LockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD)
+    {
+        return STG_E_INVALIDFUNCTION;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::UnlockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD)
+    {
+        return STG_E_INVALIDFUNCTION;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Stat(STATSTG* stat, DWORD flags)
+    {
+        if (!stat)
+            return STG_E_INVALIDPOINTER;
+
+        *stat = STATSTG{};
+
+        if (!(flags & STATFLAG_NONAME))
+        {
+            auto nameSize = (m_fileName.size() + 1) * sizeof(wchar_t);
+
+            stat->pwcsName = static_cast<LPOLESTR>(CoTaskMemAlloc(nameSize));
+
+            if (!stat->pwcsName)
+                return E_OUTOFMEMORY;
+
+            memcpy(stat->pwcsName, m_fileName.c_str(), nameSize);
+        }
+
+        stat->type = STGTY_STREAM;
+        stat->cbSize.QuadPart = m_size;
+        stat->grfMode = STGM_READ | STGM_SHARE_DENY_WRITE;
+
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP MappedFileStream::Clone(IStream** stream)
+    {
+        if (!stream)
+            return STG_E_INVALIDPOINTER;
+
+        *stream = nullptr;
+
+        // A clone would need to share ownership of the view, which nothing needs.
+        return E_NOTIMPL;
+    }
+
+}}}}
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // A read-only IStream over a memory mapped view of a whole file. WIC
+    // decoders reading from this copy straight out of the page cache, rather
+    // than going through a file handle (or a WinRT stream and its adapters)
+    // for every Read. The view stays mapped for as long as the stream is
+    // referenced, so a CanvasVirtualBitmap that is cached on demand keeps
+    // decoding from it without reopening the file.
+    //
+    class MappedFileStream : public RuntimeClass<
+                                 RuntimeClassFlags<ClassicCom>,
+                                 ChainInterfaces<IStream, ISequentialStream>>
+                           , private LifespanTracker<MappedFileStream>
+    {
+        std::wstring m_fileName;
+        uint8_t const* m_data;
+        uint64_t m_size;
+        uint64_t m_position;
+
+    public:
+        // Returns null if the file can't be mapped (for instance if it doesn't
+        // exist or is empty), so callers can fall back to opening it normally.
+        static ComPtr<IStream> TryCreate(wchar_t const* fileName);
+
+        MappedFileStream(std::wstring fileName, uint8_t const* data, uint64_t size);
+        virtual ~MappedFileStream();
+
+        // ISequentialStream
+        IFACEMETHOD(Read)(void* buffer, ULONG byteCount, ULONG* bytesRead) override;
+        IFACEMETHOD(Write)(void const* buffer, ULONG byteCount, ULONG* bytesWritten) override;
+
+        // IStream
+        IFACEMETHOD(Seek)(LARGE_INTEGER move, DWORD origin, ULARGE_INTEGER* newPosition) override;
+        IFACEMETHOD(SetSize)(ULARGE_INTEGER newSize) override;
+        IFACEMETHOD(CopyTo)(IStream* stream, ULARGE_INTEGER byteCount, ULARGE_INTEGER* bytesRead, ULARGE_INTEGER* bytesWritten) override;
+        IFACEMETHOD(Commit)(DWORD flags) override;
+        IFACEMETHOD(Revert)() override;
+        IFACEMETHOD(LockRegion)(ULARGE_INTEGER offset, ULARGE_INTEGER byteCount, DWORD lockType) override;
+        IFACEMETHOD(UnlockRegion)(ULARGE_INTEGER offset, ULARGE_INTEGER byteCount, DWORD lockType) override;
+        IFACEMETHOD(Stat)(STATSTG* stat, DWORD flags) override;
+        IFACEMETHOD(Clone)(IStream** stream) override;
+
+    private:
+        ULONG GetBytesAvailable(ULONG byteCount) const;
+    };
+
+}}}}
@@ -4,17 +4,69 @@
 
 #include "pch.h"
 #include "ScopedBitmapMappedPixelAccess.h"
+#include "drawing/CanvasGpuFence.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     ScopedBitmapMappedPixelAccess::ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle)
+        : ScopedBitmapMappedPixelAccess(device, BeginCopy(device, d2dBitmap, optionalSubRectangle))
+    {
+    }
+
+
+    ScopedBitmapMappedPixelAccess::ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ComPtr<ID2D1Bitmap1> const& stagingResource)
+        : m_device(device)
+        , m_lockedBufferSize(0)
+        , m_stagingResource(stagingResource)
+    {
+        // Mapping waits for the GPU to finish copying into the staging resource.
+        EventWrite_CanvasBitmap_MapPixels_Start();
+        auto mapEnd = MakeScopeWarden([&] { EventWrite_CanvasBitmap_MapPixels_Stop(m_lockedBufferSize); });
+
+        ThrowIfFailed(m_stagingResource->Map(
+            D2D1_MAP_OPTIONS_READ,
+            &m_mappedSubresource));
+
+        m_lockedBufferSize = m_mappedSubresource.pitch * m_stagingResource->GetPixelSize().height;
+
+        PerformanceCounters::Increment(PerformanceCounter::BitmapBytesReadBack, m_lockedBufferSize);
+    }
+
+
+    ScopedBitmapMappedPixelAccess::~ScopedBitmapMappedPixelAccess()
+    {
+        ThrowIfFailed(m_stagingResource->Unmap());
+
+        As<ICanvasDeviceInternal>(m_device)->GetStagingBitmapPool()->Release(m_stagingResource.Get());
+    }
+
+
+    // Looks up the D3D staging texture behind a CPU readable D2D bitmap.
+    static bool TryGetStagingTexture(ID2D1Bitmap1* stagingResource, ComPtr<ID3D11Texture2D>* texture, ComPtr<ID3D11DeviceContext>* immediateContext)
+    {
+        ComPtr<IDXGISurface> surface;
+
+        if (FAILED(stagingResource->GetSurface(&surface)) || !surface)
+            return false;
+
+        if (FAILED(surface.As(texture)))
+            return false;
+
+        ComPtr<ID3D11Device> d3dDevice;
+        (*texture)->GetDevice(&d3dDevice);
+        d3dDevice->GetImmediateContext(immediateContext->ReleaseAndGetAddressOf());
+
+        return true;
+    }
+
+
+    ComPtr<ID2D1Bitmap1> ScopedBitmapMappedPixelAccess::BeginCopy(
+        ICanvasDevice* device,
+        ID2D1Bitmap1* d2dBitmap,
+        D2D1_RECT_U const* optionalSubRectangle,
+        ComPtr<CanvasGpuFence>* copyFence)
     {
         auto bitmapSize = d2dBitmap->GetPixelSize();
-        
-        auto bitmapOptions = D2D1_BITMAP_OPTIONS_CPU_READ | 
-                             D2D1_BITMAP_OPTIONS_CANNOT_DRAW;
-        
-        D2D1_BITMAP_PROPERTIES1 bitmapProperties = D2D1::BitmapProperties1(bitmapOptions, d2dBitmap->GetPixelFormat());
 
         if (optionalSubRectangle)
         {
@@ -25,36 +77,68 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             bitmapSize.height = optionalSubRectangle->bottom - optionalSubRectangle->top;
         }
 
-        auto deviceContext = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+        auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
 
-        ThrowIfFailed(deviceContext->CreateBitmap(
-            bitmapSize, 
-            nullptr,
-            0,
-            &bitmapProperties,
-            &m_stagingResource));
+        auto stagingResource = deviceInternal->GetStagingBitmapPool()->Acquire(
+            deviceContext.Get(),
+            bitmapSize,
+            d2dBitmap->GetPixelFormat());
 
         // 
         // This class copies only the requested subrectangle, not the
         // whole texture, in the interest of a small perf gain.
         // The copied area is located at (0,0).
         //
-        ThrowIfFailed(m_stagingResource->CopyFromBitmap(
+        ThrowIfFailed(stagingResource->CopyFromBitmap(
             nullptr, 
             d2dBitmap,
             optionalSubRectangle));
 
-        ThrowIfFailed(m_stagingResource->Map(
-            D2D1_MAP_OPTIONS_READ,
-            &m_mappedSubresource));
+        //
+        // Submit the copy to the GPU now, rather than whenever the command
+        // buffer next fills up, so that it is under way while the caller
+        // waits.  Inserting a fence flushes as well.
+        //
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+
+        if (copyFence)
+            copyFence->Reset();
+
+        if (TryGetStagingTexture(stagingResource.Get(), &texture, &immediateContext))
+        {
+            if (copyFence)
+            {
+                ComPtr<ID3D11Device> d3dDevice;
+                texture->GetDevice(&d3dDevice);
+
+                auto fence = Make<CanvasGpuFence>(deviceInternal->GetD2DDevice().Get(), d3dDevice.Get());
+                CheckMakeResult(fence);
 
-        m_lockedBufferSize = m_mappedSubresource.pitch * bitmapSize.height;
+                *copyFence = fence;
+            }
+            else
+            {
+                D2DResourceLock lock(stagingResource.Get());
+
+                immediateContext->Flush();
+            }
+        }
+
+        return stagingResource;
     }
 
 
-    ScopedBitmapMappedPixelAccess::~ScopedBitmapMappedPixelAccess()
+    void ScopedBitmapMappedPixelAccess::WaitForCopy(CanvasGpuFence* copyFence)
     {
-        ThrowIfFailed(m_stagingResource->Unmap());
+        // Map would also wait for the copy, but it does so while holding
+        // the D2D lock, which stalls rendering on every other thread.
+        // Waiting on the fence first means Map never has to block.  Without
+        // a fence there is no way to tell when the copy is done, so Map
+        // has to do the waiting.
+        if (copyFence)
+            copyFence->WaitForCompletion();
     }
 
 }}}}
@@ -8,19 +8,45 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
+    class CanvasGpuFence;
+
     class ScopedBitmapMappedPixelAccess : LifespanTracker<ScopedBitmapMappedPixelAccess>
     {
+        ComPtr<ICanvasDevice> m_device;
         D2D1_MAPPED_RECT m_mappedSubresource;
         unsigned int m_lockedBufferSize;
         ComPtr<ID2D1Bitmap1> m_stagingResource;
 
     public:
         ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle = nullptr);
+
+        // Maps a staging bitmap that was filled by BeginCopy.
+        ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ComPtr<ID2D1Bitmap1> const& stagingResource);
+
+        // Unmaps the staging bitmap and gives it back to the device's StagingBitmapPool.
         ~ScopedBitmapMappedPixelAccess();
 
         uint8_t* GetLockedData()           const { return m_mappedSubresource.bits; }
         unsigned int GetLockedBufferSize() const { return m_lockedBufferSize; }
         unsigned int GetStride()           const { return m_mappedSubresource.pitch; }
+
+        //
+        // Queues up a GPU copy of the pixels into a staging bitmap, without
+        // waiting for it to happen.  Mapping the staging bitmap straight
+        // away blocks until the copy is done.  Callers that want to wait
+        // somewhere else first can ask for copyFence, which is signalled
+        // once the copy is done; it is left null if the staging bitmap
+        // isn't backed by a D3D texture, in which case Map does the waiting.
+        //
+        static ComPtr<ID2D1Bitmap1> BeginCopy(
+            ICanvasDevice* device,
+            ID2D1Bitmap1* d2dBitmap,
+            D2D1_RECT_U const* optionalSubRectangle,
+            ComPtr<CanvasGpuFence>* copyFence = nullptr);
+
+        // Blocks until the copy behind copyFence is done, without holding
+        // the D2D lock while it waits.
+        static void WaitForCopy(CanvasGpuFence* copyFence);
     };
 
 
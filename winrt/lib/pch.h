@@ -18,6 +18,7 @@
 
 // Standard C++
 #include <algorithm>
+#include <array>
 #include <assert.h>
 #include <atomic>
 #include <condition_variable>
@@ -25,6 +26,7 @@
 #include <functional>
 #include <future>
 #include <iterator>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -42,6 +44,7 @@
 #include <strsafe.h>
 #include <d2d1_2.h>
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <dwrite_2.h>
 #include <dxgi1_3.h>
 #include <d2d1effectauthor.h>  
@@ -49,6 +52,7 @@
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include <wincodec.h>
+#include <oleauto.h>
 #include <shcore.h>
 #include <robuffer.h>
 
@@ -59,7 +63,10 @@
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 #include <d2d1_3.h>
+#include <d3d11_4.h>
 #include <dwrite_3.h>
+#include <dxgi1_5.h>
+#include <dxgi1_6.h>
 #include <inkrenderer.h>
 #include <MemoryBuffer.h>
 #endif
@@ -75,6 +82,7 @@
 #include <windows.ui.xaml.media.h>
 #include <windows.ui.xaml.media.dxinterop.h>
 #include <windows.ui.xaml.shapes.h>
+#include <windows.graphics.h>
 #include <windows.graphics.display.h>
 #include <windows.graphics.interop.h>
 
@@ -99,6 +107,7 @@
 #include <LifespanTracker.h>
 #include <Map.h>
 #include <Nullable.h>
+#include <PooledAllocation.h>
 #include <ReferenceArray.h>
 #include <RegisteredEvent.h>
 #include <ScopeWarden.h>
@@ -122,7 +131,10 @@
 // local
 #include "utils/Conversion.h"
 #include "utils/DxgiUtilities.h"
+#include "utils/HashUtilities.h"
 #include "utils/MathUtilities.h"
+#include "utils/PerformanceCounters.h"
+#include "utils/PixelSwizzle.h"
 #include "utils/ResourceManager.h"
 #include "utils/ResourceWrapper.h"
 #include "utils/CachedResourceReference.h"
@@ -130,6 +142,7 @@
 #include "images/CanvasImage.h"
 #include "images/CanvasBitmap.h"
 #include "images/CanvasRenderTarget.h"
+#include "effects/EffectAnimation.h"
 #include "effects/CanvasEffect.h"
 #include "brushes/CanvasBrush.h"
 #include "brushes/CanvasImageBrush.h"
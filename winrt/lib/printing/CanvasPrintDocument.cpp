@@ -77,6 +77,8 @@ CanvasPrintDocument::CanvasPrintDocument(
     , m_displayDpi(adapter->GetLogicalDpi())
     , m_waitForUIThread(adapter->ShouldWaitForUIThread())
     , m_device(device.Get())
+    , m_isPreviewCacheEnabled(false)
+    , m_previewCacheVersion(0)
     , m_eventSources(std::make_shared<EventSources>())
     , m_newPreviewPageNumber(1)
 {
@@ -161,6 +163,8 @@ IFACEMETHODIMP CanvasPrintDocument::InvalidatePreview()
             // m_previewTarget since it may potentially call back to us on a
             // different thread.
 
+            ClearPreviewCache();
+
             auto previewTarget = GetPreviewTarget();
 
             if (previewTarget)
@@ -181,6 +185,38 @@ IFACEMETHODIMP CanvasPrintDocument::SetIntermediatePageCount(uint32_t count)
 }
 
 
+IFACEMETHODIMP CanvasPrintDocument::get_IsPreviewCacheEnabled(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            *value = m_isPreviewCacheEnabled;
+        });
+}
+
+
+IFACEMETHODIMP CanvasPrintDocument::put_IsPreviewCacheEnabled(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+
+            m_isPreviewCacheEnabled = !!value;
+
+            if (!m_isPreviewCacheEnabled)
+            {
+                m_previewPages.clear();
+                m_previewCacheVersion++;
+            }
+        });
+}
+
+
 HRESULT CanvasPrintDocument::SetJobPageCount(PageCountType type, uint32_t count)
 {
     return ExceptionBoundary(
@@ -209,6 +245,8 @@ IFACEMETHODIMP CanvasPrintDocument::Close()
 
             m_device.Close();
             m_previewTarget.Reset();
+            m_previewPages.clear();
+            m_previewCacheVersion++;
             m_eventSources.reset();
             m_printTaskOptions.Reset();
         });
@@ -260,6 +298,12 @@ void CanvasPrintDocument::PaginateImpl(
     //
     m_printTaskOptions = printTaskOptions;
 
+    //
+    // Recorded preview pages may no longer match the new options (eg. the
+    // page size could have changed).
+    //
+    ClearPreviewCache();
+
     auto args = Make<CanvasPrintTaskOptionsChangedEventArgs>(task, currentPreviewPageNumber, printTaskOptions);
     CheckMakeResult(args);
 
@@ -307,19 +351,66 @@ void CanvasPrintDocument::MakePageImpl(DeferrableTask* task, uint32_t pageNumber
 
     auto dpi = CalculateDpiForPreviewBitmap(Size{ previewWidth, previewHeight }, pageDesc.PageSize);
 
+    auto device = m_device.EnsureNotClosed();
+
     auto renderTarget = CanvasRenderTarget::CreateNew(
-        m_device.EnsureNotClosed().Get(),
+        device.Get(),
         pageDesc.PageSize.Width,
         pageDesc.PageSize.Height,
         dpi,
         PIXEL_FORMAT(B8G8R8A8UIntNormalized),
         CanvasAlphaMode::Premultiplied);
 
+    //
+    // If this page has been previewed before then we can replay what was drawn
+    // last time, rather than asking the app to draw it again.
+    //
+    bool isPreviewCacheEnabled;
+    uint64_t previewCacheVersion;
+    auto cachedPage = GetCachedPreviewPage(pageNumber, &isPreviewCacheEnabled, &previewCacheVersion);
+
+    if (cachedPage)
+    {
+        task->SetCompletionFn(
+            [=]
+            {
+                DrawRecordedPreviewPage(renderTarget.Get(), cachedPage.Get());
+                ShowPreviewPage(pageNumber, renderTarget.Get(), dpi);
+            });
+
+        task->NonDeferredComplete();
+        return;
+    }
+
     ComPtr<ICanvasDrawingSession> ds;
-    ThrowIfFailed(renderTarget->CreateDrawingSession(&ds));
+    ComPtr<ID2D1CommandList> recording;
 
-    auto white = Color{ 255, 255, 255, 255 };
-    ThrowIfFailed(ds->Clear(white));
+    if (isPreviewCacheEnabled)
+    {
+        //
+        // The app draws into a command list, which is then played back into
+        // the render target.  As with CanvasPrintEventArgs, we set up our own
+        // drawing session over the D2D command list, so that it rasterizes at
+        // the same DPI as the render target would have.
+        //
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+
+        recording = deviceInternal->CreateCommandList();
+
+        auto deviceContext = deviceInternal->CreateDeviceContextForDrawingSession();
+        deviceContext->SetTarget(recording.Get());
+        deviceContext->SetDpi(dpi, dpi);
+
+        auto adapter = std::make_shared<SimpleCanvasDrawingSessionAdapter>(deviceContext.Get());
+        ds = CanvasDrawingSession::CreateNew(deviceContext.Get(), adapter, device.Get());
+    }
+    else
+    {
+        ThrowIfFailed(renderTarget->CreateDrawingSession(&ds));
+
+        auto white = Color{ 255, 255, 255, 255 };
+        ThrowIfFailed(ds->Clear(white));
+    }
 
     //
     // Raise the Preview event; this is where the app gets to draw the print
@@ -333,23 +424,15 @@ void CanvasPrintDocument::MakePageImpl(DeferrableTask* task, uint32_t pageNumber
         {
             ThrowIfFailed(As<IClosable>(ds)->Close());
 
-            //
-            // Show the preview
-            //
-            auto d2dBitmap = renderTarget->GetResource();
-            ComPtr<IDXGISurface> dxgiSurface;
-            ThrowIfFailed(d2dBitmap->GetSurface(&dxgiSurface));
+            if (recording)
+            {
+                ThrowIfFailed(recording->Close());
 
-            auto previewTarget = GetPreviewTarget();
-            auto hr = previewTarget->DrawPage(pageNumber, dxgiSurface.Get(), dpi, dpi);
+                CachePreviewPage(pageNumber, recording.Get(), previewCacheVersion);
+                DrawRecordedPreviewPage(renderTarget.Get(), recording.Get());
+            }
 
-            //
-            // DrawPage() is extremely picky about surface sizes, and will return
-            // E_INVALIDARG if the surface doesn't match its requirements.  We swallow
-            // these errors as there's not much we can do in response.
-            //
-            if (FAILED(hr) && hr != E_INVALIDARG)
-                ThrowHR(hr);
+            ShowPreviewPage(pageNumber, renderTarget.Get(), dpi);
         });
 
     ThrowIfFailed(GetEventSources()->Preview.InvokeAll(this, args.Get()));
@@ -358,6 +441,75 @@ void CanvasPrintDocument::MakePageImpl(DeferrableTask* task, uint32_t pageNumber
 }
 
 
+void CanvasPrintDocument::DrawRecordedPreviewPage(CanvasRenderTarget* renderTarget, ID2D1CommandList* recording)
+{
+    ComPtr<ICanvasDrawingSession> ds;
+    ThrowIfFailed(renderTarget->CreateDrawingSession(&ds));
+
+    auto white = Color{ 255, 255, 255, 255 };
+    ThrowIfFailed(ds->Clear(white));
+
+    GetWrappedResource<ID2D1DeviceContext>(ds)->DrawImage(recording);
+
+    ThrowIfFailed(As<IClosable>(ds)->Close());
+}
+
+
+void CanvasPrintDocument::ShowPreviewPage(uint32_t pageNumber, CanvasRenderTarget* renderTarget, float dpi)
+{
+    auto d2dBitmap = renderTarget->GetResource();
+    ComPtr<IDXGISurface> dxgiSurface;
+    ThrowIfFailed(d2dBitmap->GetSurface(&dxgiSurface));
+
+    auto previewTarget = GetPreviewTarget();
+    auto hr = previewTarget->DrawPage(pageNumber, dxgiSurface.Get(), dpi, dpi);
+
+    //
+    // DrawPage() is extremely picky about surface sizes, and will return
+    // E_INVALIDARG if the surface doesn't match its requirements.  We swallow
+    // these errors as there's not much we can do in response.
+    //
+    if (FAILED(hr) && hr != E_INVALIDARG)
+        ThrowHR(hr);
+}
+
+
+ComPtr<ID2D1CommandList> CanvasPrintDocument::GetCachedPreviewPage(uint32_t pageNumber, bool* isPreviewCacheEnabled, uint64_t* previewCacheVersion)
+{
+    Lock lock(m_mutex);
+
+    *isPreviewCacheEnabled = m_isPreviewCacheEnabled;
+    *previewCacheVersion = m_previewCacheVersion;
+
+    auto it = m_previewPages.find(pageNumber);
+
+    if (it == m_previewPages.end())
+        return nullptr;
+
+    return it->second;
+}
+
+
+void CanvasPrintDocument::CachePreviewPage(uint32_t pageNumber, ID2D1CommandList* recording, uint64_t previewCacheVersion)
+{
+    Lock lock(m_mutex);
+
+    // Don't cache the page if the cache was cleared or disabled while the
+    // page was being drawn.
+    if (m_isPreviewCacheEnabled && m_previewCacheVersion == previewCacheVersion)
+        m_previewPages[pageNumber] = recording;
+}
+
+
+void CanvasPrintDocument::ClearPreviewCache()
+{
+    Lock lock(m_mutex);
+
+    m_previewPages.clear();
+    m_previewCacheVersion++;
+}
+
+
 float CanvasPrintDocument::CalculateDpiForPreviewBitmap(Size previewSize, Size pageSize) const
 {
     //
@@ -57,6 +57,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ClosablePtr<ICanvasDevice> m_device;
         ComPtr<IPrintPreviewDxgiPackageTarget> m_previewTarget;
 
+        // Recordings of previewed pages, keyed by page number.  The version
+        // is bumped whenever the recordings are discarded, so that a page whose
+        // Preview handler was still running at the time isn't cached.
+        bool m_isPreviewCacheEnabled;
+        uint64_t m_previewCacheVersion;
+        std::map<uint32_t, ComPtr<ID2D1CommandList>> m_previewPages;
+
         // Event sources are stored in a shared_ptr so we can destroy them when
         // Close() is called.  Although the event sources are threadsafe, we
         // hold the mutex when accessing m_eventSources.
@@ -91,6 +98,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHODIMP InvalidatePreview() override;
         IFACEMETHODIMP SetPageCount(uint32_t) override;
         IFACEMETHODIMP SetIntermediatePageCount(uint32_t) override;
+        IFACEMETHODIMP get_IsPreviewCacheEnabled(boolean*) override;
+        IFACEMETHODIMP put_IsPreviewCacheEnabled(boolean) override;
       
         //
         // IClosable
@@ -139,6 +148,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float width,
             float height);
 
+        void DrawRecordedPreviewPage(CanvasRenderTarget* renderTarget, ID2D1CommandList* recording);
+        void ShowPreviewPage(uint32_t pageNumber, CanvasRenderTarget* renderTarget, float dpi);
+
+        ComPtr<ID2D1CommandList> GetCachedPreviewPage(uint32_t pageNumber, bool* isPreviewCacheEnabled, uint64_t* previewCacheVersion);
+        void CachePreviewPage(uint32_t pageNumber, ID2D1CommandList* recording, uint64_t previewCacheVersion);
+        void ClearPreviewCache();
+
         float CalculateDpiForPreviewBitmap(Size previewSize, Size pageSize) const;
 
         void MakeDocumentImpl(
@@ -7,6 +7,7 @@
 #ifndef WINDOWS_PHONE
 
 #include "CanvasPrintEventArgs.h"
+#include "utils/ParallelFor.h"
 
 using namespace ABI::Microsoft::Graphics::Canvas::Printing;
 
@@ -22,6 +23,7 @@ CanvasPrintEventArgs::CanvasPrintEventArgs(
     , m_dpi(initialDpi)
     , m_target(target)
     , m_currentPage(0)
+    , m_isDrawingPages(false)
 {
 }
 
@@ -154,7 +156,7 @@ ComPtr<ICanvasDrawingSession> CanvasPrintEventArgs::CreateDrawingSessionImpl()
     // list and create our own drawing session on top of it.
     //
 
-    if (m_currentCommandList)
+    if (m_currentCommandList || m_isDrawingPages)
         ThrowHR(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
 
     auto d2dCommandList = deviceInternal->CreateCommandList();
@@ -180,15 +182,172 @@ void CanvasPrintEventArgs::DrawingSessionClosed()
     assert(m_currentCommandList);
 
     ThrowIfFailed(m_currentCommandList->Close());
-            
+
+    AddPage(m_currentPage, m_currentCommandList.Get());
+
+    m_currentCommandList.Reset();
+}
+
+
+// Callers must hold m_mutex.
+void CanvasPrintEventArgs::AddPage(int pageNumber, ID2D1CommandList* commandList)
+{
     PrintPageDescription desc;
-    ThrowIfFailed(m_printTaskOptions->GetPageDescription(m_currentPage, &desc));
+    ThrowIfFailed(m_printTaskOptions->GetPageDescription(pageNumber, &desc));
 
     auto pageSize = D2D1_SIZE_F{ desc.PageSize.Width, desc.PageSize.Height };
 
-    ThrowIfFailed(m_printControl->AddPage(m_currentCommandList.Get(), pageSize, nullptr, nullptr, nullptr));
+    ThrowIfFailed(m_printControl->AddPage(commandList, pageSize, nullptr, nullptr, nullptr));
+}
 
-    m_currentCommandList.Reset();
+
+//
+// DrawPagesAsync hands the pages out to a number of threadpool workers, each
+// of which draws them one at a time into a command list of its own. The
+// thread that runs the renderer does a share of the drawing too. Pages can
+// finish in any order, so each finished command list waits until every page
+// before it has been added to the print control.
+//
+
+class CanvasPrintEventArgs::PageRenderer
+{
+    ComPtr<CanvasPrintEventArgs> m_args;
+    ComPtr<ICanvasPrintPageHandler> m_handler;
+    int m_firstPage;
+    uint32_t m_pageCount;
+
+    std::mutex m_mutex;
+    std::vector<ComPtr<ID2D1CommandList>> m_drawnPages;    // Indexed from m_firstPage.
+    uint32_t m_nextPageToAdd;
+
+public:
+    PageRenderer(CanvasPrintEventArgs* args, ICanvasPrintPageHandler* handler, int firstPage, uint32_t pageCount)
+        : m_args(args)
+        , m_handler(handler)
+        , m_firstPage(firstPage)
+        , m_pageCount(pageCount)
+        , m_drawnPages(pageCount)
+        , m_nextPageToAdd(0)
+    {
+    }
+
+    // Returns once every page has been added to the print control. Fails
+    // with the first error any of the workers ran into.
+    void Run(uint32_t maximumParallelism)
+    {
+        auto endWarden = MakeScopeWarden([&] { m_args->EndDrawingPages(); });
+
+        auto deviceInternal = As<ICanvasDeviceInternal>(m_args->m_device);
+
+        ThrowIfFailed(ParallelFor(m_pageCount, maximumParallelism,
+            [&](uint32_t index)
+            {
+                auto d2dCommandList = deviceInternal->CreateCommandList();
+                auto d2dDeviceContext = deviceInternal->CreateDeviceContextForDrawingSession();
+                d2dDeviceContext->SetTarget(d2dCommandList.Get());
+                d2dDeviceContext->SetDpi(m_args->m_dpi, m_args->m_dpi);
+
+                auto adapter = std::make_shared<SimpleCanvasDrawingSessionAdapter>(d2dDeviceContext.Get());
+                auto ds = CanvasDrawingSession::CreateNew(d2dDeviceContext.Get(), adapter, m_args->m_device.Get());
+
+                ThrowIfFailed(m_handler->Invoke(m_firstPage + index, ds.Get()));
+                ThrowIfFailed(ds->Close());
+
+                ThrowIfFailed(d2dCommandList->Close());
+
+                PageDrawn(index, d2dCommandList.Get());
+            }));
+    }
+
+private:
+    void PageDrawn(uint32_t index, ID2D1CommandList* commandList)
+    {
+        Lock lock(m_mutex);
+
+        m_drawnPages[index] = commandList;
+
+        // Add every page that is now ready, in order.
+        while (m_nextPageToAdd < m_pageCount && m_drawnPages[m_nextPageToAdd])
+        {
+            {
+                Lock argsLock(m_args->m_mutex);
+                m_args->AddPage(m_firstPage + m_nextPageToAdd, m_drawnPages[m_nextPageToAdd].Get());
+            }
+
+            m_drawnPages[m_nextPageToAdd].Reset();
+            m_nextPageToAdd++;
+        }
+    }
+};
+
+
+IFACEMETHODIMP CanvasPrintEventArgs::DrawPagesAsync(uint32_t pageCount, int32_t maximumParallelism, ICanvasPrintPageHandler* handler, IAsyncAction** action)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(handler);
+            CheckAndClearOutPointer(action);
+
+            if (maximumParallelism < 0)
+                ThrowHR(E_INVALIDARG);
+
+            uint32_t parallelism = maximumParallelism ? static_cast<uint32_t>(maximumParallelism)
+                                                      : std::max(std::thread::hardware_concurrency(), 1U);
+
+            parallelism = AsyncScheduler::GetInstance().LimitParallelism(parallelism);
+
+            // The pages are claimed here, so CreateDrawingSession fails from
+            // now on rather than once the action starts running.
+            auto renderer = BeginDrawingPages(pageCount, handler);
+
+            auto asyncAction = Make<AsyncAction>(
+                [=]
+                {
+                    renderer->Run(parallelism);
+                });
+
+            CheckMakeResult(asyncAction);
+            ThrowIfFailed(asyncAction.CopyTo(action));
+        });
+}
+
+
+void CanvasPrintEventArgs::DrawPages(uint32_t pageCount, uint32_t maximumParallelism, ICanvasPrintPageHandler* handler)
+{
+    BeginDrawingPages(pageCount, handler)->Run(maximumParallelism);
+}
+
+
+std::shared_ptr<CanvasPrintEventArgs::PageRenderer> CanvasPrintEventArgs::BeginDrawingPages(uint32_t pageCount, ICanvasPrintPageHandler* handler)
+{
+    Lock lock(m_mutex);
+
+    if (m_currentCommandList || m_isDrawingPages)
+        ThrowHR(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
+
+    if (pageCount > static_cast<uint32_t>(INT_MAX - m_currentPage))
+        ThrowHR(E_INVALIDARG);
+
+    if (!m_printControl)
+    {
+        m_printControl = As<ICanvasDeviceInternal>(m_device)->CreatePrintControl(m_target.Get(), m_dpi);
+    }
+
+    auto renderer = std::make_shared<PageRenderer>(this, handler, m_currentPage + 1, pageCount);
+
+    m_currentPage += pageCount;
+    m_isDrawingPages = true;
+
+    return renderer;
+}
+
+
+void CanvasPrintEventArgs::EndDrawingPages()
+{
+    Lock lock(m_mutex);
+
+    m_isDrawingPages = false;
 }
 
 #endif
\ No newline at end of file
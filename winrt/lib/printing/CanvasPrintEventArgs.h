@@ -33,6 +33,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ComPtr<ID2D1CommandList> m_currentCommandList;
         int m_currentPage;
+        bool m_isDrawingPages;
         
     public:
         CanvasPrintEventArgs(
@@ -49,12 +50,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHODIMP put_Dpi(float value) override;
         IFACEMETHODIMP GetDeferral(ICanvasPrintDeferral** value) override;
         IFACEMETHODIMP CreateDrawingSession(ICanvasDrawingSession** value) override;
+        IFACEMETHODIMP DrawPagesAsync(uint32_t pageCount, int32_t maximumParallelism, ICanvasPrintPageHandler* handler, IAsyncAction** action) override;
+
+        // Does the work of DrawPagesAsync, but returns once every page has
+        // been added to the print control.
+        void DrawPages(uint32_t pageCount, uint32_t maximumParallelism, ICanvasPrintPageHandler* handler);
 
     private:
         ComPtr<ICanvasDrawingSession> CreateDrawingSessionImpl();
         void DrawingSessionClosed();
+        void AddPage(int pageNumber, ID2D1CommandList* commandList);
 
         class DrawingSessionAdapter;
+        class PageRenderer;
+
+        std::shared_ptr<PageRenderer> BeginDrawingPages(uint32_t pageCount, ICanvasPrintPageHandler* handler);
+        void EndDrawingPages();
     };
 
 }}}}}
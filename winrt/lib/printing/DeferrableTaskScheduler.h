@@ -7,6 +7,18 @@
 #include "CanvasPrintDeferral.h"
 #include "DeferrableTask.h"
 
+//
+// Tasks run one at a time on the dispatcher's thread.  When a task finishes
+// the next one is started from the same dispatcher callback, rather than
+// with a fresh RunAsync, so that a print job made of many small pages isn't
+// dominated by round trips through the dispatcher.  A deferred task's
+// completion needs one round trip to get back onto the dispatcher thread,
+// and the tasks queued behind it then run from that callback.
+//
+// TaskCompleted is only ever called from inside one of these callbacks:
+// tasks complete from Invoke (NonDeferredComplete, or on failure) or from
+// the callback dispatched by DeferredTaskCompleted.
+//
 class DeferrableTaskScheduler
     : private LifespanTracker<DeferrableTaskScheduler>
 {
@@ -14,11 +26,17 @@ class DeferrableTaskScheduler
 
     std::mutex m_mutex;
     std::unique_ptr<DeferrableTask> m_currentTask;
+    bool m_isCurrentTaskStarted;
     std::queue<std::unique_ptr<DeferrableTask>> m_pending;
     
 public:    
+    // After this many tasks in one callback the rest go through the
+    // dispatcher again, so that the UI thread still gets to handle input.
+    static const uint32_t MaximumTasksPerCallback = 32;
+
     explicit DeferrableTaskScheduler(ComPtr<ICoreDispatcher> const& dispatcher)
         : m_dispatcher(dispatcher)
+        , m_isCurrentTaskStarted(false)
     {
     }
 
@@ -37,7 +55,9 @@ public:
         }
         else
         {
-            RunAsync(std::move(task));
+            m_currentTask = std::move(task);
+            m_isCurrentTaskStarted = false;
+            RunAsync(nullptr);
         }
     }
 
@@ -45,20 +65,9 @@ public:
     {
         assert(task == m_currentTask.get());
         
-        // Deferred completed tasks we dispatch via the dispatcher
-        auto handler = Callback<AddFtmBase<IDispatchedHandler>::Type>(
-            [task]() mutable
-            {
-                return ExceptionBoundary(
-                    [&]
-                    {
-                        task->Completed();
-                    });
-            });
-        CheckMakeResult(handler);
-
-        ComPtr<IAsyncAction> asyncAction;
-        ThrowIfFailed(m_dispatcher->RunAsync(CoreDispatcherPriority_Normal, handler.Get(), &asyncAction));
+        // Deferrals can be completed from any thread, so the completion is
+        // sent back to the dispatcher.
+        RunAsync(task);
     }
 
     void TaskCompleted(DeferrableTask* task)
@@ -72,30 +81,24 @@ public:
 
         if (!m_pending.empty())
         {
-            // It would be possible to immediately execute the pending task,
-            // rather than go via the dispatcher.  However, this complicates the
-            // code for a minimal (to non-existent) perf gain.
-            RunAsync(std::move(m_pending.front()));
+            // The callback that this task completed in starts the next one.
+            m_currentTask = std::move(m_pending.front());
+            m_isCurrentTaskStarted = false;
             m_pending.pop();
         }
     }
 
 
 private:
-    void RunAsync(std::unique_ptr<DeferrableTask> task)
+    void RunAsync(DeferrableTask* deferredTaskToComplete)
     {
-        assert(!m_currentTask);
-        m_currentTask = std::move(task);
-
-        DeferrableTask* t = m_currentTask.get();
-        
         auto handler = Callback<AddFtmBase<IDispatchedHandler>::Type>(
-            [t]() mutable
+            [this, deferredTaskToComplete]() mutable
             {
                 return ExceptionBoundary(
                     [&]
                     {
-                        t->Invoke();
+                        RunTasks(deferredTaskToComplete);
                     });
             });
         CheckMakeResult(handler);
@@ -103,6 +106,40 @@ private:
         ComPtr<IAsyncAction> asyncAction;
         ThrowIfFailed(m_dispatcher->RunAsync(CoreDispatcherPriority_Normal, handler.Get(), &asyncAction));
     }
+
+    void RunTasks(DeferrableTask* deferredTaskToComplete)
+    {
+        if (deferredTaskToComplete)
+            deferredTaskToComplete->Completed();
+
+        for (uint32_t i = 0; i < MaximumTasksPerCallback; ++i)
+        {
+            auto task = TryStartCurrentTask();
+
+            if (!task)
+                return;
+
+            task->Invoke();
+        }
+
+        Lock lock(m_mutex);
+
+        if (m_currentTask && !m_isCurrentTaskStarted)
+            RunAsync(nullptr);
+    }
+
+    // Returns null if there is no task, or if the current one has already
+    // been started and is waiting on a deferral.
+    DeferrableTask* TryStartCurrentTask()
+    {
+        Lock lock(m_mutex);
+
+        if (!m_currentTask || m_isCurrentTaskStarted)
+            return nullptr;
+
+        m_isCurrentTaskStarted = true;
+        return m_currentTask.get();
+    }
     
     
     DeferrableTaskScheduler(DeferrableTaskScheduler const&) = delete;
@@ -8,6 +8,18 @@
 
 namespace AttributeHelpers
 {
+    static std::atomic<uint64_t> s_contentVersion;
+
+    void MarkContentChanged()
+    {
+        ++s_contentVersion;
+    }
+
+    uint64_t GetContentVersion()
+    {
+        return s_contentVersion;
+    }
+
     void GetElementImpl(
         ClosablePtr<ICanvasDevice> closableDevice,
         ComPtr<ID2D1SvgAttribute> d2dResource,
@@ -42,6 +42,11 @@ namespace AttributeHelpers
         ICanvasSvgNamedElement** result);
 
     void ValidateRange(int32_t startIndex, int32_t elementCount, uint32_t available);
+
+    // Every change Win2D makes to SVG content bumps a process-wide version
+    // number, so cached renderings can tell when they may be out of date.
+    void MarkContentChanged();
+    uint64_t GetContentVersion();
 }
 
 #endif
\ No newline at end of file
@@ -20,12 +20,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         byte const* m_buffer;
         size_t m_bufferSizeInBytes;
         size_t m_seekLocation;
+        ComPtr<IUnknown> m_bufferOwner;
 
     public:
-        BufferStreamWrapper(byte const* buffer, size_t bufferSizeInBytes)
+        BufferStreamWrapper(byte const* buffer, size_t bufferSizeInBytes, IUnknown* bufferOwner = nullptr)
             : m_buffer(buffer)
             , m_bufferSizeInBytes(bufferSizeInBytes)
             , m_seekLocation(0)
+            , m_bufferOwner(bufferOwner)
         {}
 
         // ISequentialStream Interface
@@ -178,6 +180,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         return stream;
     }
 
+    ComPtr<IStream> WrapSvgBufferInStream(IBuffer* sourceBuffer)
+    {
+        using ::Windows::Storage::Streams::IBufferByteAccess;
+
+        CheckInPointer(sourceBuffer);
+
+        uint32_t byteCount;
+        ThrowIfFailed(sourceBuffer->get_Length(&byteCount));
+
+        if (byteCount == 0)
+            ThrowHR(E_INVALIDARG, Strings::SvgTextShouldHaveNonZeroLength);
+
+        uint8_t* bytes;
+        ThrowIfFailed(As<IBufferByteAccess>(sourceBuffer)->Buffer(&bytes));
+
+        // Direct2D detects the encoding itself, so UTF-8 is parsed as is
+        // rather than being converted to a string first.
+        auto stream = Make<BufferStreamWrapper>(bytes, byteCount, sourceBuffer);
+        CheckMakeResult(stream);
+
+        return stream;
+    }
+
 }}}}}
 
 #endif
\ No newline at end of file
@@ -8,4 +8,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 {    
     ComPtr<IStream> WrapSvgStringInStream(HSTRING sourceString);
 
+    // Wraps the bytes of a buffer, such as a UTF-8 file loaded into memory,
+    // in place.  The stream keeps the buffer alive.
+    ComPtr<IStream> WrapSvgBufferInStream(IBuffer* sourceBuffer);
+
 }}}}}
\ No newline at end of file
@@ -13,6 +13,8 @@
 #include "CanvasSvgPointsAttribute.h"
 #include "CanvasSvgStrokeDashArrayAttribute.h"
 #include "BufferStreamWrapper.h"
+#include "AttributeHelpers.h"
+#include "utils/ParallelFor.h"
 
 using namespace Microsoft::WRL::Wrappers;
 
@@ -29,6 +31,15 @@ ComPtr<CanvasSvgDocument> CanvasSvgDocument::CreateNew(ICanvasResourceCreator* r
 
     auto deviceInternal = As<ICanvasDeviceInternal>(device);
 
+    uint64_t byteCount = 0;
+    STATSTG streamStats;
+
+    if (stream && EventEnabled_CanvasSvgDocument_Load_Start() && SUCCEEDED(stream->Stat(&streamStats, STATFLAG_NONAME)))
+        byteCount = streamStats.cbSize.QuadPart;
+
+    EventWrite_CanvasSvgDocument_Load_Start(byteCount);
+    auto loadEnd = MakeScopeWarden([] { EventWrite_CanvasSvgDocument_Load_Stop(); });
+
     ComPtr<ID2D1SvgDocument> d2dSvgDocument = deviceInternal->CreateSvgDocument(stream);
 
     auto canvasSvgDocument = Make<CanvasSvgDocument>(
@@ -44,11 +55,18 @@ CanvasSvgDocument::CanvasSvgDocument(
     ID2D1SvgDocument* d2dSvgDocument)
     : ResourceWrapper(d2dSvgDocument)
     , m_canvasDevice(canvasDevice)
+    , m_isRasterizationCacheEnabled(false)
+    , m_rasterizationContentVersion(0)
 {
 }
 
 IFACEMETHODIMP CanvasSvgDocument::Close()
 {
+    {
+        Lock lock(m_rasterizationMutex);
+        m_rasterizations.clear();
+    }
+
     m_canvasDevice.Close();
     return ResourceWrapper::Close();
 }
@@ -160,6 +178,8 @@ IFACEMETHODIMP CanvasSvgDocument::SaveAsync(IRandomAccessStream* rawStream, IAsy
 
 IFACEMETHODIMP CanvasSvgDocument::put_Root(ICanvasSvgNamedElement* root)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [=]
         {
@@ -175,6 +195,295 @@ IFACEMETHODIMP CanvasSvgDocument::put_Root(ICanvasSvgNamedElement* root)
         });
 }
 
+IFACEMETHODIMP CanvasSvgDocument::get_IsRasterizationCacheEnabled(boolean* value)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            CheckInPointer(value);
+
+            GetResource();
+
+            Lock lock(m_rasterizationMutex);
+            *value = m_isRasterizationCacheEnabled;
+        });
+}
+
+IFACEMETHODIMP CanvasSvgDocument::put_IsRasterizationCacheEnabled(boolean value)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            GetResource();
+
+            Lock lock(m_rasterizationMutex);
+
+            m_isRasterizationCacheEnabled = !!value;
+
+            if (!m_isRasterizationCacheEnabled)
+                m_rasterizations.clear();
+        });
+}
+
+IFACEMETHODIMP CanvasSvgDocument::RegisterAttributeName(HSTRING attributeName, int32_t* attributeHandle)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            CheckInPointer(attributeHandle);
+
+            GetResource();
+
+            std::wstring name(GetStringBuffer(attributeName));
+
+            Lock lock(m_attributeNameMutex);
+
+            auto it = m_attributeHandles.find(name);
+
+            if (it == m_attributeHandles.end())
+            {
+                auto handle = static_cast<int32_t>(m_attributeNames.size());
+                m_attributeNames.push_back(name);
+                it = m_attributeHandles.emplace(std::move(name), handle).first;
+            }
+
+            *attributeHandle = it->second;
+        });
+}
+
+template<typename VALUE, typename TO_D2D_VALUE>
+void CanvasSvgDocument::SetAttributesImpl(
+    uint32_t elementCount,
+    ICanvasSvgNamedElement** elements,
+    uint32_t attributeHandleCount,
+    int32_t* attributeHandles,
+    uint32_t valueCount,
+    VALUE* values,
+    TO_D2D_VALUE&& toD2DValue)
+{
+    CheckInPointer(elements);
+    CheckInPointer(attributeHandles);
+    CheckInPointer(values);
+
+    if (attributeHandleCount != 1 && attributeHandleCount != elementCount)
+        ThrowHR(E_INVALIDARG, Strings::SvgAttributeBatchArraySizesMismatch);
+
+    if (valueCount != 1 && valueCount != elementCount)
+        ThrowHR(E_INVALIDARG, Strings::SvgAttributeBatchArraySizesMismatch);
+
+    auto device = m_canvasDevice.EnsureNotClosed();
+
+    AttributeHelpers::MarkContentChanged();
+
+    // Names are only appended to, so they can be looked up under one lock for the whole batch.
+    Lock lock(m_attributeNameMutex);
+
+    for (uint32_t i = 0; i < elementCount; i++)
+    {
+        CheckInPointer(elements[i]);
+
+        auto element = static_cast<CanvasSvgNamedElement*>(elements[i]);
+
+        if (!IsSameInstance(device.Get(), element->GetDevice().Get()))
+            ThrowHR(E_INVALIDARG, Strings::SvgDocumentTreeMustHaveConsistentDevice);
+
+        auto handle = attributeHandles[attributeHandleCount == 1 ? 0 : i];
+
+        if (handle < 0 || static_cast<size_t>(handle) >= m_attributeNames.size())
+            ThrowHR(E_INVALIDARG, Strings::SvgAttributeHandleNotValid);
+
+        auto& value = values[valueCount == 1 ? 0 : i];
+
+        ThrowIfFailed(element->GetResource()->SetAttributeValue(m_attributeNames[handle].c_str(), toD2DValue(value)));
+    }
+}
+
+IFACEMETHODIMP CanvasSvgDocument::SetFloatAttributes(
+    uint32_t elementCount,
+    ICanvasSvgNamedElement** elements,
+    uint32_t attributeHandleCount,
+    int32_t* attributeHandles,
+    uint32_t valueCount,
+    float* values)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            SetAttributesImpl(elementCount, elements, attributeHandleCount, attributeHandles, valueCount, values,
+                [](float value) { return value; });
+        });
+}
+
+IFACEMETHODIMP CanvasSvgDocument::SetColorAttributes(
+    uint32_t elementCount,
+    ICanvasSvgNamedElement** elements,
+    uint32_t attributeHandleCount,
+    int32_t* attributeHandles,
+    uint32_t valueCount,
+    Color* values)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            SetAttributesImpl(elementCount, elements, attributeHandleCount, attributeHandles, valueCount, values,
+                [](Color const& value) { return ToD2DColor(value); });
+        });
+}
+
+IFACEMETHODIMP CanvasSvgDocument::SetTransformAttributes(
+    uint32_t elementCount,
+    ICanvasSvgNamedElement** elements,
+    uint32_t attributeHandleCount,
+    int32_t* attributeHandles,
+    uint32_t valueCount,
+    Matrix3x2* values)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            SetAttributesImpl(elementCount, elements, attributeHandleCount, attributeHandles, valueCount, values,
+                [](Matrix3x2 const& value) { return *ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&value); });
+        });
+}
+
+bool CanvasSvgDocument::TryDrawRasterized(ID2D1DeviceContext5* deviceContext, Size viewportSize, float x, float y)
+{
+    Lock lock(m_rasterizationMutex);
+
+    if (!m_isRasterizationCacheEnabled)
+        return false;
+
+    // A bitmap can only stand in for the document if it is drawn axis aligned.
+    D2D1_MATRIX_3X2_F transform;
+    deviceContext->GetTransform(&transform);
+
+    if (transform._12 != 0 || transform._21 != 0 || transform._11 <= 0 || transform._22 <= 0)
+        return false;
+
+    // Other blends apply to each element of the document as it is drawn,
+    // which compositing one flattened bitmap would not match.
+    if (deviceContext->GetPrimitiveBlend() != D2D1_PRIMITIVE_BLEND_SOURCE_OVER)
+        return false;
+
+    float dpiX, dpiY;
+    deviceContext->GetDpi(&dpiX, &dpiY);
+
+    // In pixel unit mode the transform already maps straight to pixels.
+    if (deviceContext->GetUnitMode() == D2D1_UNIT_MODE_PIXELS)
+        dpiX = dpiY = DEFAULT_DPI;
+
+    auto scaleX = transform._11 * dpiX / DEFAULT_DPI;
+    auto scaleY = transform._22 * dpiY / DEFAULT_DPI;
+
+    auto pixelWidth = ceil(viewportSize.Width * scaleX);
+    auto pixelHeight = ceil(viewportSize.Height * scaleY);
+    auto maximumBitmapSize = static_cast<float>(deviceContext->GetMaximumBitmapSize());
+
+    if (pixelWidth > maximumBitmapSize || pixelHeight > maximumBitmapSize)
+        return false;
+
+    // Any change to SVG content made through Win2D invalidates every cached bitmap.
+    auto contentVersion = AttributeHelpers::GetContentVersion();
+
+    if (contentVersion != m_rasterizationContentVersion)
+    {
+        m_rasterizations.clear();
+        m_rasterizationContentVersion = contentVersion;
+    }
+
+    auto it = std::find_if(m_rasterizations.begin(), m_rasterizations.end(),
+        [&](Rasterization const& rasterization)
+        {
+            return rasterization.ViewportSize.Width == viewportSize.Width &&
+                   rasterization.ViewportSize.Height == viewportSize.Height &&
+                   rasterization.ScaleX == scaleX &&
+                   rasterization.ScaleY == scaleY;
+        });
+
+    ComPtr<ID2D1Bitmap1> bitmap;
+
+    if (it != m_rasterizations.end())
+    {
+        m_rasterizations.splice(m_rasterizations.begin(), m_rasterizations, it);
+        bitmap = it->Bitmap;
+    }
+    else
+    {
+        bitmap = Rasterize(lock, viewportSize, scaleX, scaleY, static_cast<uint32_t>(pixelWidth), static_cast<uint32_t>(pixelHeight));
+
+        if (m_rasterizations.size() >= MaximumRasterizationCount)
+            m_rasterizations.pop_back();
+
+        m_rasterizations.push_front(Rasterization{ viewportSize, scaleX, scaleY, bitmap });
+    }
+
+    // Snap the bitmap to whole device pixels, so each of its pixels lands on
+    // exactly one pixel of the target and needs no filtering.
+    auto pixelsPerDipX = dpiX / DEFAULT_DPI;
+    auto pixelsPerDipY = dpiY / DEFAULT_DPI;
+
+    auto targetLeft = round((x * transform._11 + transform._31) * pixelsPerDipX);
+    auto targetTop = round((y * transform._22 + transform._32) * pixelsPerDipY);
+
+    auto left = (targetLeft / pixelsPerDipX - transform._31) / transform._11;
+    auto top = (targetTop / pixelsPerDipY - transform._32) / transform._22;
+
+    auto destinationRect = D2D1::RectF(left, top, left + pixelWidth / scaleX, top + pixelHeight / scaleY);
+
+    deviceContext->DrawBitmap(bitmap.Get(), &destinationRect, 1.0f, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, nullptr, nullptr);
+
+    return true;
+}
+
+ComPtr<ID2D1Bitmap1> CanvasSvgDocument::Rasterize(Lock const& lock, Size viewportSize, float scaleX, float scaleY, uint32_t pixelWidth, uint32_t pixelHeight)
+{
+    MustOwnLock(lock);
+
+    auto& resource = GetResource();
+    auto& device = m_canvasDevice.EnsureNotClosed();
+
+    auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+    auto deviceContext = As<ID2D1DeviceContext5>(lease.Get());
+
+    ComPtr<ID2D1Bitmap1> bitmap;
+    ThrowIfFailed(deviceContext->CreateBitmap(
+        D2D1::SizeU(pixelWidth, pixelHeight),
+        nullptr,
+        0,
+        D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_TARGET,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+        &bitmap));
+
+    ComPtr<ID2D1Image> previousTarget;
+    deviceContext->GetTarget(&previousTarget);
+
+    D2D1_MATRIX_3X2_F previousTransform;
+    deviceContext->GetTransform(&previousTransform);
+
+    auto restoreState = MakeScopeWarden(
+        [&]
+        {
+            deviceContext->SetTarget(previousTarget.Get());
+            deviceContext->SetTransform(previousTransform);
+        });
+
+    deviceContext->SetTarget(bitmap.Get());
+    deviceContext->BeginDraw();
+    deviceContext->Clear(D2D1::ColorF(0, 0));
+    deviceContext->SetTransform(D2D1::Matrix3x2F::Scale(scaleX, scaleY));
+
+    {
+        TemporaryViewportSize viewportSizer(resource.Get(), viewportSize);
+
+        deviceContext->DrawSvgDocument(resource.Get());
+    }
+
+    ThrowIfFailed(deviceContext->EndDraw());
+
+    return bitmap;
+}
+
 IFACEMETHODIMP CanvasSvgDocument::get_Root(ICanvasSvgNamedElement** result)
 {
     return ExceptionBoundary(
@@ -213,6 +522,25 @@ IFACEMETHODIMP CanvasSvgDocument::LoadElementFromXml(
         });
 }
 
+IFACEMETHODIMP CanvasSvgDocument::LoadElementFromXmlBuffer(
+    IBuffer* xmlBuffer,
+    ICanvasSvgNamedElement** svgElement)
+{ 
+    return ExceptionBoundary(
+        [=]
+        {
+            CheckInPointer(xmlBuffer);
+            CheckAndClearOutPointer(svgElement);
+
+            m_canvasDevice.EnsureNotClosed();
+
+            ComPtr<IStream> stream = WrapSvgBufferInStream(xmlBuffer);
+                        
+            ComPtr<ICanvasSvgElement> newElement = CreateNewElementFromStream(this, stream.Get());
+            ThrowIfFailed(newElement.CopyTo(svgElement));
+        });
+}
+
 IFACEMETHODIMP CanvasSvgDocument::LoadElementAsync(
     IRandomAccessStream *rawStream,
     IAsyncOperation<CanvasSvgNamedElement*>** resultAsyncOperation)
@@ -266,6 +594,173 @@ IFACEMETHODIMP CanvasSvgDocument::FindElementById(HSTRING elementName, ICanvasSv
         });
 }
 
+namespace
+{
+    //
+    // Tests elements against a tag name and attribute without wrapping them,
+    // so that scanning a large document only pays for ResourceManager
+    // lookups on the elements that match.
+    //
+    class SvgElementQuery
+    {
+        std::wstring m_tagName;
+        std::wstring m_attributeName;
+        std::wstring m_attributeValue;
+        D2D1_SVG_ATTRIBUTE_STRING_TYPE m_stringType;
+        bool m_isClassAttribute;
+
+        std::vector<wchar_t> m_buffer;
+
+    public:
+        SvgElementQuery(HSTRING tagName, HSTRING attributeName, HSTRING attributeValue)
+            : m_tagName(GetStringBuffer(tagName))
+            , m_attributeName(GetStringBuffer(attributeName))
+            , m_attributeValue(GetStringBuffer(attributeValue))
+            , m_stringType(m_attributeName == L"id" ? D2D1_SVG_ATTRIBUTE_STRING_TYPE_ID : D2D1_SVG_ATTRIBUTE_STRING_TYPE_SVG)
+            , m_isClassAttribute(m_attributeName == L"class")
+        {
+            if (m_attributeName.empty() && !m_attributeValue.empty())
+                ThrowHR(E_INVALIDARG, Strings::SvgAttributeValueWithoutName);
+        }
+
+        // Walks the tree under root in document order.
+        void FindMatches(ID2D1SvgElement* root, std::vector<ComPtr<ID2D1SvgElement>>* matches)
+        {
+            std::vector<ComPtr<ID2D1SvgElement>> pending{ root };
+
+            while (!pending.empty())
+            {
+                auto element = std::move(pending.back());
+                pending.pop_back();
+
+                if (element->IsTextContent())
+                    continue;
+
+                if (Matches(element.Get()))
+                    matches->push_back(element);
+
+                // Children are pushed last first, so the first child is visited next.
+                ComPtr<ID2D1SvgElement> child;
+                element->GetLastChild(&child);
+
+                while (child)
+                {
+                    ComPtr<ID2D1SvgElement> previous;
+                    ThrowIfFailed(element->GetPreviousChild(child.Get(), &previous));
+
+                    pending.push_back(std::move(child));
+                    child = std::move(previous);
+                }
+            }
+        }
+
+    private:
+        bool Matches(ID2D1SvgElement* element)
+        {
+            if (!m_tagName.empty())
+            {
+                auto length = element->GetTagNameLength();
+
+                if (length != m_tagName.size())
+                    return false;
+
+                m_buffer.resize(length + 1);
+                ThrowIfFailed(element->GetTagName(m_buffer.data(), length + 1));
+
+                if (m_tagName.compare(0, length, m_buffer.data(), length) != 0)
+                    return false;
+            }
+
+            if (m_attributeName.empty())
+                return true;
+
+            if (!element->IsAttributeSpecified(m_attributeName.c_str(), nullptr))
+                return false;
+
+            if (m_attributeValue.empty())
+                return true;
+
+            // Values that can't be read as a string don't match.
+            uint32_t length;
+            if (FAILED(element->GetAttributeValueLength(m_attributeName.c_str(), m_stringType, &length)))
+                return false;
+
+            m_buffer.resize(length + 1);
+            if (FAILED(element->GetAttributeValue(m_attributeName.c_str(), m_stringType, m_buffer.data(), length + 1)))
+                return false;
+
+            if (m_isClassAttribute)
+                return HasClassName(m_buffer.data(), length);
+
+            return length == m_attributeValue.size() && m_attributeValue.compare(0, length, m_buffer.data(), length) == 0;
+        }
+
+        // The class attribute is a whitespace separated list of names.
+        bool HasClassName(wchar_t const* classNames, uint32_t length)
+        {
+            auto end = classNames + length;
+            auto name = classNames;
+
+            while (name < end)
+            {
+                while (name < end && iswspace(*name))
+                    ++name;
+
+                auto nameEnd = name;
+
+                while (nameEnd < end && !iswspace(*nameEnd))
+                    ++nameEnd;
+
+                auto nameLength = static_cast<size_t>(nameEnd - name);
+
+                if (nameLength && nameLength == m_attributeValue.size() && m_attributeValue.compare(0, nameLength, name, nameLength) == 0)
+                    return true;
+
+                name = nameEnd;
+            }
+
+            return false;
+        }
+    };
+}
+
+IFACEMETHODIMP CanvasSvgDocument::FindElements(
+    HSTRING tagName,
+    HSTRING attributeName,
+    HSTRING attributeValue,
+    uint32_t* elementCount,
+    ICanvasSvgNamedElement*** elements)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            CheckInPointer(elementCount);
+            CheckAndClearOutPointer(elements);
+
+            auto& resource = GetResource();
+
+            auto& device = m_canvasDevice.EnsureNotClosed();
+
+            SvgElementQuery query(tagName, attributeName, attributeValue);
+
+            std::vector<ComPtr<ID2D1SvgElement>> matches;
+
+            ComPtr<ID2D1SvgElement> root;
+            resource->GetRoot(&root);
+
+            if (root)
+                query.FindMatches(root.Get(), &matches);
+
+            auto array = TransformToComArray<ComPtr<ICanvasSvgNamedElement>>(matches.begin(), matches.end(),
+                [&](ComPtr<ID2D1SvgElement> const& match)
+                {
+                    return ResourceManager::GetOrCreate<ICanvasSvgNamedElement>(device.Get(), match.Get());
+                });
+
+            array.Detach(elementCount, elements);
+        });
+}
+
 void CanvasSvgDocument::CreatePaintAttributeImpl(D2D1_SVG_PAINT_TYPE d2dSvgPaintType, D2D1_COLOR_F d2dColor, wchar_t const* id, ICanvasSvgPaintAttribute** result)
 {
     auto& resource = GetResource();
@@ -456,6 +951,26 @@ IFACEMETHODIMP CanvasSvgDocumentStatics::LoadFromXml(
         });
 }
 
+IFACEMETHODIMP CanvasSvgDocumentStatics::LoadFromXmlBuffer(
+    ICanvasResourceCreator* resourceCreator,
+    IBuffer* xmlBuffer,
+    ICanvasSvgDocument** svgDocument)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(xmlBuffer);
+            CheckAndClearOutPointer(svgDocument);
+
+            // The buffer's bytes are parsed in place.
+            ComPtr<IStream> inputXmlStream = WrapSvgBufferInStream(xmlBuffer);
+
+            ComPtr<CanvasSvgDocument> newDocument = CanvasSvgDocument::CreateNew(resourceCreator, inputXmlStream.Get());
+            ThrowIfFailed(newDocument.CopyTo(svgDocument));
+        });
+}
+
 IFACEMETHODIMP CanvasSvgDocumentStatics::LoadAsync(
     ICanvasResourceCreator* resourceCreator,
     IRandomAccessStream* randomAccessStream,
@@ -485,6 +1000,137 @@ IFACEMETHODIMP CanvasSvgDocumentStatics::LoadAsync(
         });
 }
 
+//
+// LoadManyAsync hands the streams out to a number of threadpool workers,
+// each of which parses them one at a time. The async operation's thread does
+// a share of the parsing too, and once everyone is done it returns the
+// documents in stream order.
+//
+
+class CanvasSvgDocumentBatchLoader
+{
+    ComPtr<ICanvasResourceCreator> m_resourceCreator;
+    std::vector<ComPtr<IStream>> m_streams;
+
+    std::vector<ComPtr<CanvasSvgDocument>> m_documents;
+
+public:
+    CanvasSvgDocumentBatchLoader(ICanvasResourceCreator* resourceCreator, std::vector<ComPtr<IStream>>&& streams)
+        : m_resourceCreator(resourceCreator)
+        , m_streams(std::move(streams))
+        , m_documents(m_streams.size())
+    {
+    }
+
+    // Runs on the async operation's worker thread, and returns once every
+    // stream has been parsed. Fails with the first error any of the workers
+    // ran into.
+    ComPtr<IVectorView<CanvasSvgDocument*>> Run(uint32_t maximumParallelism)
+    {
+        ThrowIfFailed(ParallelFor(static_cast<uint32_t>(m_streams.size()), maximumParallelism,
+            [&](uint32_t index)
+            {
+                // Only the share of the parsing done on the async operation's own
+                // thread notices cancellation, but failing abandons the other workers too.
+                AsyncCancellation::ThrowIfCanceled();
+
+                m_documents[index] = CanvasSvgDocument::CreateNew(m_resourceCreator.Get(), m_streams[index].Get());
+
+                // Each stream is only read once, so let it go as soon as it has been parsed.
+                m_streams[index].Reset();
+            }));
+
+        auto vector = MakePooled<Vector<CanvasSvgDocument*>>();
+        CheckMakeResult(vector);
+
+        for (auto& document : m_documents)
+        {
+            ThrowIfFailed(vector->Append(document.Get()));
+        }
+
+        ComPtr<IVectorView<CanvasSvgDocument*>> view;
+        ThrowIfFailed(vector->GetView(&view));
+
+        return view;
+    }
+};
+
+static std::vector<ComPtr<IStream>> GetBatchStreams(IIterable<IRandomAccessStream*>* streams)
+{
+    std::vector<ComPtr<IStream>> result;
+
+    ComPtr<IIterator<IRandomAccessStream*>> iterator;
+    ThrowIfFailed(streams->First(&iterator));
+
+    boolean hasCurrent;
+    ThrowIfFailed(iterator->get_HasCurrent(&hasCurrent));
+
+    while (hasCurrent)
+    {
+        ComPtr<IRandomAccessStream> randomAccessStream;
+        ThrowIfFailed(iterator->get_Current(&randomAccessStream));
+
+        CheckInPointer(randomAccessStream.Get());
+
+        ComPtr<IStream> stream;
+        ThrowIfFailed(CreateStreamOverRandomAccessStream(randomAccessStream.Get(), IID_PPV_ARGS(&stream)));
+
+        result.push_back(std::move(stream));
+
+        ThrowIfFailed(iterator->MoveNext(&hasCurrent));
+    }
+
+    if (result.size() > INT32_MAX)
+        ThrowHR(E_INVALIDARG);
+
+    return result;
+}
+
+IFACEMETHODIMP CanvasSvgDocumentStatics::LoadManyAsync(
+    ICanvasResourceCreator* resourceCreator,
+    IIterable<IRandomAccessStream*>* streams,
+    IAsyncOperation<IVectorView<CanvasSvgDocument*>*>** svgDocuments)
+{
+    return LoadManyAsyncWithOptions(resourceCreator, streams, 0, svgDocuments);
+}
+
+IFACEMETHODIMP CanvasSvgDocumentStatics::LoadManyAsyncWithOptions(
+    ICanvasResourceCreator* resourceCreator,
+    IIterable<IRandomAccessStream*>* streams,
+    int32_t maximumParallelism,
+    IAsyncOperation<IVectorView<CanvasSvgDocument*>*>** svgDocuments)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(streams);
+            CheckAndClearOutPointer(svgDocuments);
+
+            if (maximumParallelism < 0)
+                ThrowHR(E_INVALIDARG);
+
+            uint32_t parallelism = maximumParallelism ? static_cast<uint32_t>(maximumParallelism)
+                                                      : std::max(std::thread::hardware_concurrency(), 1U);
+
+            parallelism = AsyncScheduler::GetInstance().LimitParallelism(parallelism);
+
+            // The streams are wrapped here on the calling thread, the same as LoadAsync does.
+            auto loader = std::make_shared<CanvasSvgDocumentBatchLoader>(
+                resourceCreator,
+                GetBatchStreams(streams));
+
+            auto asyncOperation = Make<AsyncOperation<IVectorView<CanvasSvgDocument*>>>(
+                [=]
+                {
+                    return loader->Run(parallelism);
+                });
+
+            CheckMakeResult(asyncOperation);
+            ThrowIfFailed(asyncOperation.CopyTo(svgDocuments));
+        });
+}
+
 IFACEMETHODIMP CanvasSvgDocumentStatics::IsSupported(ICanvasDevice* device, boolean* isSupported)
 {
     return ExceptionBoundary(
@@ -8,17 +8,57 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Svg
 {
+    class __declspec(uuid("D2793466-ABCF-48D0-B0F8-EBD476261F0D"))
+    ICanvasSvgDocumentInternal : public IUnknown
+    {
+    public:
+        // Draws the document from its rasterization cache, if the cache is
+        // enabled and the device context's transform allows it.  Returns
+        // false if the caller should draw the document itself.
+        virtual bool TryDrawRasterized(ID2D1DeviceContext5* deviceContext, Size viewportSize, float x, float y) = 0;
+    };
+
+    //
+    // When the rasterization cache is enabled, drawing the document renders
+    // it once into a bitmap for each viewport size and scale (the
+    // transform's scale multiplied by the DPI), and later draws with the same
+    // values just draw that bitmap.  Only transforms without rotation or skew
+    // can use the cache.
+    //
+    // Cached bitmaps are discarded whenever any SVG content is changed
+    // through Win2D.  Changes made directly to the D2D objects through
+    // interop are not noticed.
+    //
     class CanvasSvgDocument : RESOURCE_WRAPPER_RUNTIME_CLASS(
         ID2D1SvgDocument,
         CanvasSvgDocument,
         ICanvasSvgDocument,
-        CloakedIid<ICanvasResourceWrapperWithDevice>)
+        CloakedIid<ICanvasResourceWrapperWithDevice>,
+        CloakedIid<ICanvasSvgDocumentInternal>)
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Svg_CanvasSvgDocument, BaseTrust);
 
+        struct Rasterization
+        {
+            Size ViewportSize;
+            float ScaleX;
+            float ScaleY;
+            ComPtr<ID2D1Bitmap1> Bitmap;
+        };
+
         ClosablePtr<ICanvasDevice> m_canvasDevice;
 
+        std::mutex m_rasterizationMutex;
+        bool m_isRasterizationCacheEnabled;
+        uint64_t m_rasterizationContentVersion;
+        std::list<Rasterization> m_rasterizations;     // Most recently used at the front.
+
+        std::mutex m_attributeNameMutex;
+        std::vector<std::wstring> m_attributeNames;     // Indexed by attribute handle.
+        std::unordered_map<std::wstring, int32_t> m_attributeHandles;
+
     public:
+        static const uint32_t MaximumRasterizationCount = 4;
         
         static ComPtr<CanvasSvgDocument> CreateNew(ICanvasResourceCreator* resourceCreator, IStream* stream);
 
@@ -42,11 +82,45 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             HSTRING xmlString,
             ICanvasSvgNamedElement** svgElement) override;
 
+        IFACEMETHOD(LoadElementFromXmlBuffer)(
+            IBuffer* xmlBuffer,
+            ICanvasSvgNamedElement** svgElement) override;
+
         IFACEMETHOD(LoadElementAsync)(
             IRandomAccessStream *stream,
             IAsyncOperation<CanvasSvgNamedElement*>** svgElement) override;
         
+        IFACEMETHOD(get_IsRasterizationCacheEnabled)(boolean* value) override;
+        IFACEMETHOD(put_IsRasterizationCacheEnabled)(boolean value) override;
+
+        IFACEMETHOD(RegisterAttributeName)(HSTRING attributeName, int32_t* attributeHandle) override;
+
+        IFACEMETHOD(SetFloatAttributes)(
+            uint32_t elementCount,
+            ICanvasSvgNamedElement** elements,
+            uint32_t attributeHandleCount,
+            int32_t* attributeHandles,
+            uint32_t valueCount,
+            float* values) override;
+
+        IFACEMETHOD(SetColorAttributes)(
+            uint32_t elementCount,
+            ICanvasSvgNamedElement** elements,
+            uint32_t attributeHandleCount,
+            int32_t* attributeHandles,
+            uint32_t valueCount,
+            ABI::Windows::UI::Color* values) override;
+
+        IFACEMETHOD(SetTransformAttributes)(
+            uint32_t elementCount,
+            ICanvasSvgNamedElement** elements,
+            uint32_t attributeHandleCount,
+            int32_t* attributeHandles,
+            uint32_t valueCount,
+            ABI::Windows::Foundation::Numerics::Matrix3x2* values) override;
+
         IFACEMETHOD(FindElementById)(HSTRING, ICanvasSvgNamedElement**) override;
+        IFACEMETHOD(FindElements)(HSTRING, HSTRING, HSTRING, UINT32*, ICanvasSvgNamedElement***) override;
         IFACEMETHOD(CreatePaintAttributeWithDefaults)(ICanvasSvgPaintAttribute **) override;
         IFACEMETHOD(CreatePaintAttribute)(CanvasSvgPaintType, ABI::Windows::UI::Color, HSTRING, ICanvasSvgPaintAttribute **) override;
         IFACEMETHOD(CreatePathAttributeWithDefaults)(ICanvasSvgPathAttribute **) override;
@@ -59,7 +133,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // No exception boundary
         ComPtr<ICanvasDevice> GetDevice() { return m_canvasDevice.EnsureNotClosed(); }
 
+        // ICanvasSvgDocumentInternal
+        virtual bool TryDrawRasterized(ID2D1DeviceContext5* deviceContext, Size viewportSize, float x, float y) override;
+
     private:
+        ComPtr<ID2D1Bitmap1> Rasterize(Lock const& lock, Size viewportSize, float scaleX, float scaleY, uint32_t pixelWidth, uint32_t pixelHeight);
+
+        template<typename VALUE, typename TO_D2D_VALUE>
+        void SetAttributesImpl(
+            uint32_t elementCount,
+            ICanvasSvgNamedElement** elements,
+            uint32_t attributeHandleCount,
+            int32_t* attributeHandles,
+            uint32_t valueCount,
+            VALUE* values,
+            TO_D2D_VALUE&& toD2DValue);
+
         void CreatePaintAttributeImpl(D2D1_SVG_PAINT_TYPE d2dSvgPaintType, D2D1_COLOR_F d2dColor, wchar_t const* id, ICanvasSvgPaintAttribute** result);
 
         void CreatePathDataAttributeImpl(
@@ -95,11 +184,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             HSTRING xmlString, 
             ICanvasSvgDocument** svgDocument) override;
 
+        IFACEMETHODIMP LoadFromXmlBuffer(
+            ICanvasResourceCreator* resourceCreator, 
+            IBuffer* xmlBuffer, 
+            ICanvasSvgDocument** svgDocument) override;
+
         IFACEMETHODIMP LoadAsync(
             ICanvasResourceCreator* resourceCreator, 
             IRandomAccessStream *stream,
             IAsyncOperation<CanvasSvgDocument*>** svgDocument) override;
 
+        IFACEMETHODIMP LoadManyAsync(
+            ICanvasResourceCreator* resourceCreator, 
+            IIterable<IRandomAccessStream*>* streams,
+            IAsyncOperation<IVectorView<CanvasSvgDocument*>*>** svgDocuments) override;
+
+        IFACEMETHODIMP LoadManyAsyncWithOptions(
+            ICanvasResourceCreator* resourceCreator, 
+            IIterable<IRandomAccessStream*>* streams,
+            int32_t maximumParallelism,
+            IAsyncOperation<IVectorView<CanvasSvgDocument*>*>** svgDocuments) override;
+
         IFACEMETHODIMP IsSupported(ICanvasDevice* device, boolean* isSupported) override;
     };
 
@@ -130,6 +130,8 @@ static ComPtr<ID2D1SvgElement> VerifyDeviceBoundaryAndGetNativeResource(
 
 IFACEMETHODIMP CanvasSvgNamedElement::AppendChild(ICanvasSvgElement* child)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -145,6 +147,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::AppendChild(ICanvasSvgElement* child)
 
 IFACEMETHODIMP CanvasSvgNamedElement::CreateAndAppendNamedChildElement(HSTRING elementName, ICanvasSvgNamedElement** newElement)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -164,6 +168,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::CreateAndAppendNamedChildElement(HSTRING e
 
 IFACEMETHODIMP CanvasSvgNamedElement::CreateAndAppendTextChildElement(HSTRING text, ICanvasSvgTextElement** newElement)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -345,6 +351,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::InsertChildBefore(ICanvasSvgElement* newChild, ICanvasSvgElement* referenceChild)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -392,6 +400,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::RemoveAttribute(HSTRING attributeName)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -403,6 +413,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::RemoveChild(ICanvasSvgElement* child)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -419,6 +431,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::ReplaceChild(ICanvasSvgElement* newChild, ICanvasSvgElement* oldChild)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -494,6 +508,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::SetAttribute(HSTRING attributeName, ICanvasSvgAttribute* attributeValue)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -568,6 +584,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::SetIdAttribute(HSTRING attributeName, HSTRING attributeValue)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -586,6 +604,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::SetStringAttribute(HSTRING attributeName, HSTRING attributeValue)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -604,6 +624,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::SetFloatAttribute(HSTRING attributeName, float attributeValue)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -627,6 +649,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 
     IFACEMETHODIMP CanvasSvgNamedElement::SetColorAttribute(HSTRING attributeName, Color attributeValue)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(
             [&]
             {
@@ -738,6 +762,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::get_FirstChild(ICanvasSvgElement** result)
 #define SIMPLE_ATTRIBUTE(name, nativeType, wrappedType, nativeConversion, wrappedConversion) \
 IFACEMETHODIMP CanvasSvgNamedElement::Set##name##Attribute(HSTRING attributeName, wrappedType value)                                \
 {                                                                                                                                   \
+    AttributeHelpers::MarkContentChanged();                                                                                         \
+                                                                                                                                    \
     return ExceptionBoundary(                                                                                                       \
         [&]                                                                                                                         \
         {                                                                                                                           \
@@ -775,6 +801,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::Get##name##Attribute(HSTRING attributeName
 
 IFACEMETHODIMP CanvasSvgNamedElement::SetLengthAttribute(HSTRING attributeName, float value, CanvasSvgLengthUnits units)
 {   
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(       
         [&]                         
         {
@@ -807,6 +835,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::GetLengthAttribute(HSTRING attributeName,
 
     IFACEMETHODIMP CanvasSvgNamedElement::SetAspectRatioAttribute(HSTRING attributeName, CanvasSvgAspectAlignment alignment, CanvasSvgAspectScaling meetOrSlice)
     {
+        AttributeHelpers::MarkContentChanged();
+
         return ExceptionBoundary(       
             [&]                         
             {
@@ -851,6 +881,8 @@ IFACEMETHODIMP CanvasSvgNamedElement::GetLengthAttribute(HSTRING attributeName,
     
 IFACEMETHODIMP CanvasSvgNamedElement::SetRectangleAttribute(HSTRING attributeName, Rect value)
 {   
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(       
         [&]                         
         {                           
@@ -923,6 +955,8 @@ IFACEMETHODIMP CanvasSvgTextElement::get_Text(HSTRING* result)
 
 IFACEMETHODIMP CanvasSvgTextElement::put_Text(HSTRING text)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -0,0 +1,307 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CanvasSvgIconAtlas.h"
+#include "CanvasSvgDocument.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Svg;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+
+IconAtlasLayout::IconAtlasLayout(std::vector<D2D1_SIZE_U> const& iconSizes, uint32_t maximumSize)
+    : m_size{ 0, 0 }
+    , m_positions(iconSizes.size())
+{
+    uint64_t totalArea = 0;
+    uint32_t widestIcon = 0;
+
+    for (auto& size : iconSizes)
+    {
+        totalArea += static_cast<uint64_t>(size.width + Padding) * (size.height + Padding);
+        widestIcon = std::max(widestIcon, size.width);
+    }
+
+    if (widestIcon > maximumSize)
+        ThrowHR(E_INVALIDARG, Strings::SvgIconAtlasTooLarge);
+
+    std::vector<uint32_t> order(iconSizes.size());
+
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(),
+        [&](uint32_t a, uint32_t b)
+        {
+            return iconSizes[a].height > iconSizes[b].height;
+        });
+
+    auto rowWidth = std::max(widestIcon, static_cast<uint32_t>(ceil(sqrt(static_cast<double>(totalArea)))));
+    rowWidth = std::min(rowWidth, maximumSize);
+
+    Pack(iconSizes, order, rowWidth);
+
+    // Icons much wider than they are tall can overflow a square layout,
+    // but may still fit using the full width.
+    if (m_size.height > maximumSize && rowWidth < maximumSize)
+        Pack(iconSizes, order, maximumSize);
+
+    if (m_size.height > maximumSize)
+        ThrowHR(E_INVALIDARG, Strings::SvgIconAtlasTooLarge);
+}
+
+
+void IconAtlasLayout::Pack(std::vector<D2D1_SIZE_U> const& iconSizes, std::vector<uint32_t> const& order, uint32_t rowWidth)
+{
+    m_size = D2D1_SIZE_U{ 0, 0 };
+
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t rowHeight = 0;
+
+    for (auto index : order)
+    {
+        auto& size = iconSizes[index];
+
+        if (x > 0 && x + size.width > rowWidth)
+        {
+            y += rowHeight + Padding;
+            x = 0;
+            rowHeight = 0;
+        }
+
+        m_positions[index] = D2D1_POINT_2U{ x, y };
+
+        m_size.width = std::max(m_size.width, x + size.width);
+        m_size.height = std::max(m_size.height, y + size.height);
+
+        x += size.width + Padding;
+        rowHeight = std::max(rowHeight, size.height);
+    }
+}
+
+
+ComPtr<CanvasSvgIconAtlas> CanvasSvgIconAtlas::CreateNew(
+    ICanvasResourceCreatorWithDpi* resourceCreator,
+    uint32_t documentCount,
+    ICanvasSvgDocument** documents,
+    uint32_t sizeCount,
+    Size* sizes)
+{
+    CheckInPointer(resourceCreator);
+    CheckInPointer(documents);
+    CheckInPointer(sizes);
+
+    if (documentCount == 0)
+        ThrowHR(E_INVALIDARG);
+
+    if (sizeCount != 1 && sizeCount != documentCount)
+        ThrowHR(E_INVALIDARG, Strings::SvgIconAtlasSizesMismatch);
+
+    float dpi;
+    ThrowIfFailed(resourceCreator->get_Dpi(&dpi));
+
+    ComPtr<ICanvasDevice> device;
+    ThrowIfFailed(As<ICanvasResourceCreator>(resourceCreator)->get_Device(&device));
+
+    std::vector<ComPtr<ID2D1SvgDocument>> d2dDocuments;
+    std::vector<Size> viewportSizes;
+    std::vector<D2D1_SIZE_U> pixelSizes;
+
+    d2dDocuments.reserve(documentCount);
+    viewportSizes.reserve(documentCount);
+    pixelSizes.reserve(documentCount);
+
+    for (uint32_t i = 0; i < documentCount; i++)
+    {
+        CheckInPointer(documents[i]);
+
+        auto size = sizes[sizeCount == 1 ? 0 : i];
+
+        if (size.Width <= 0 || size.Height <= 0)
+            ThrowHR(E_INVALIDARG, Strings::SvgViewportSizeNotValid);
+
+        d2dDocuments.push_back(GetWrappedResource<ID2D1SvgDocument>(documents[i]));
+        viewportSizes.push_back(size);
+        pixelSizes.push_back(D2D1_SIZE_U{ static_cast<uint32_t>(SizeDipsToPixels(size.Width, dpi)), static_cast<uint32_t>(SizeDipsToPixels(size.Height, dpi)) });
+    }
+
+    auto lease = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+    auto deviceContext = MaybeAs<ID2D1DeviceContext5>(lease.Get());
+
+    if (!deviceContext)
+        ThrowHR(E_NOTIMPL, Strings::SvgNotAvailable);
+
+    IconAtlasLayout layout(pixelSizes, deviceContext->GetMaximumBitmapSize());
+
+    ComPtr<ID2D1Bitmap1> bitmap;
+    ThrowIfFailed(deviceContext->CreateBitmap(
+        layout.GetSize(),
+        nullptr,
+        0,
+        D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_TARGET,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+            dpi,
+            dpi),
+        &bitmap));
+
+    ComPtr<ID2D1Image> previousTarget;
+    deviceContext->GetTarget(&previousTarget);
+
+    float previousDpiX, previousDpiY;
+    deviceContext->GetDpi(&previousDpiX, &previousDpiY);
+
+    D2D1_MATRIX_3X2_F previousTransform;
+    deviceContext->GetTransform(&previousTransform);
+
+    auto restoreState = MakeScopeWarden(
+        [&]
+        {
+            deviceContext->SetTarget(previousTarget.Get());
+            deviceContext->SetDpi(previousDpiX, previousDpiY);
+            deviceContext->SetTransform(previousTransform);
+        });
+
+    deviceContext->SetTarget(bitmap.Get());
+    deviceContext->SetDpi(dpi, dpi);
+    deviceContext->BeginDraw();
+    deviceContext->Clear(D2D1::ColorF(0, 0));
+
+    std::vector<Rect> sourceRects;
+    sourceRects.reserve(documentCount);
+
+    for (uint32_t i = 0; i < documentCount; i++)
+    {
+        auto position = layout.GetPosition(i);
+
+        Rect sourceRect
+        {
+            PixelsToDips(static_cast<int>(position.x), dpi),
+            PixelsToDips(static_cast<int>(position.y), dpi),
+            PixelsToDips(static_cast<int>(pixelSizes[i].width), dpi),
+            PixelsToDips(static_cast<int>(pixelSizes[i].height), dpi)
+        };
+
+        // Clip each icon, so content outside its viewport can't spill onto its neighbors.
+        deviceContext->PushAxisAlignedClip(ToD2DRect(sourceRect), D2D1_ANTIALIAS_MODE_ALIASED);
+        deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(sourceRect.X, sourceRect.Y));
+
+        {
+            TemporaryViewportSize viewportSizer(d2dDocuments[i].Get(), viewportSizes[i]);
+
+            deviceContext->DrawSvgDocument(d2dDocuments[i].Get());
+        }
+
+        deviceContext->PopAxisAlignedClip();
+
+        sourceRects.push_back(sourceRect);
+    }
+
+    ThrowIfFailed(deviceContext->EndDraw());
+
+    auto renderTarget = Make<CanvasRenderTarget>(device.Get(), bitmap.Get());
+    CheckMakeResult(renderTarget);
+
+    auto atlas = Make<CanvasSvgIconAtlas>(renderTarget.Get(), std::move(sourceRects));
+    CheckMakeResult(atlas);
+
+    return atlas;
+}
+
+
+CanvasSvgIconAtlas::CanvasSvgIconAtlas(
+    ICanvasRenderTarget* renderTarget,
+    std::vector<Rect>&& sourceRects)
+    : m_renderTarget(renderTarget)
+    , m_sourceRects(std::move(sourceRects))
+{
+}
+
+
+IFACEMETHODIMP CanvasSvgIconAtlas::get_RenderTarget(ICanvasRenderTarget** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_renderTarget.CopyTo(value));
+        });
+}
+
+
+IFACEMETHODIMP CanvasSvgIconAtlas::get_Count(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = static_cast<uint32_t>(m_sourceRects.size());
+        });
+}
+
+
+IFACEMETHODIMP CanvasSvgIconAtlas::GetSourceRect(
+    uint32_t index,
+    Rect* sourceRect)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(sourceRect);
+
+            if (index >= m_sourceRects.size())
+                ThrowHR(E_BOUNDS);
+
+            *sourceRect = m_sourceRects[index];
+        });
+}
+
+
+IFACEMETHODIMP CanvasSvgIconAtlas::GetSourceRects(
+    uint32_t* sourceRectsCount,
+    Rect** sourceRects)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(sourceRectsCount);
+            CheckAndClearOutPointer(sourceRects);
+
+            ComArray<Rect> array(m_sourceRects.begin(), m_sourceRects.end());
+            array.Detach(sourceRectsCount, sourceRects);
+        });
+}
+
+
+IFACEMETHODIMP CanvasSvgIconAtlasFactory::Create(
+    ICanvasResourceCreatorWithDpi* resourceCreator,
+    uint32_t documentCount,
+    ICanvasSvgDocument** documents,
+    uint32_t sizeCount,
+    Size* sizes,
+    ICanvasSvgIconAtlas** atlas)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(atlas);
+
+            auto newAtlas = CanvasSvgIconAtlas::CreateNew(resourceCreator, documentCount, documents, sizeCount, sizes);
+
+            ThrowIfFailed(newAtlas.CopyTo(atlas));
+        });
+}
+
+
+ActivatableStaticOnlyFactory(CanvasSvgIconAtlasFactory);
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Svg
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // Shelf packing of icon sizes, in pixels, into one bitmap.  Icons are
+    // placed tallest first, left to right along rows no wider than roughly
+    // the square root of their total area, so the bitmap comes out close to
+    // square, falling back to full width rows if that is too tall.  Icons
+    // are separated by Padding transparent pixels, so linear filtering at
+    // their edges doesn't pick up their neighbors.
+    //
+    class IconAtlasLayout
+    {
+        D2D1_SIZE_U m_size;
+        std::vector<D2D1_POINT_2U> m_positions;
+
+    public:
+        static const uint32_t Padding = 1;
+
+        // Throws if the icons don't fit within maximumSize in both dimensions.
+        IconAtlasLayout(std::vector<D2D1_SIZE_U> const& iconSizes, uint32_t maximumSize);
+
+        D2D1_SIZE_U GetSize() const { return m_size; }
+
+        D2D1_POINT_2U GetPosition(uint32_t index) const { return m_positions[index]; }
+
+    private:
+        // Places icons in the given order along rows no wider than rowWidth.
+        void Pack(std::vector<D2D1_SIZE_U> const& iconSizes, std::vector<uint32_t> const& order, uint32_t rowWidth);
+    };
+
+
+    class CanvasSvgIconAtlas : public RuntimeClass<ICanvasSvgIconAtlas>,
+                               private LifespanTracker<CanvasSvgIconAtlas>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Svg_CanvasSvgIconAtlas, BaseTrust);
+
+        ComPtr<ICanvasRenderTarget> m_renderTarget;
+        std::vector<Rect> m_sourceRects;
+
+    public:
+        static ComPtr<CanvasSvgIconAtlas> CreateNew(
+            ICanvasResourceCreatorWithDpi* resourceCreator,
+            uint32_t documentCount,
+            ICanvasSvgDocument** documents,
+            uint32_t sizeCount,
+            Size* sizes);
+
+        CanvasSvgIconAtlas(
+            ICanvasRenderTarget* renderTarget,
+            std::vector<Rect>&& sourceRects);
+
+        IFACEMETHOD(get_RenderTarget)(ICanvasRenderTarget** value) override;
+
+        IFACEMETHOD(get_Count)(uint32_t* value) override;
+
+        IFACEMETHOD(GetSourceRect)(
+            uint32_t index,
+            Rect* sourceRect) override;
+
+        IFACEMETHOD(GetSourceRects)(
+            uint32_t* sourceRectsCount,
+            Rect** sourceRects) override;
+    };
+
+
+    class CanvasSvgIconAtlasFactory
+        : public AgileActivationFactory<ICanvasSvgIconAtlasStatics>
+        , private LifespanTracker<CanvasSvgIconAtlasFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Svg_CanvasSvgIconAtlas, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreatorWithDpi* resourceCreator,
+            uint32_t documentCount,
+            ICanvasSvgDocument** documents,
+            uint32_t sizeCount,
+            Size* sizes,
+            ICanvasSvgIconAtlas** atlas) override;
+    };
+}}}}}
+
+#endif
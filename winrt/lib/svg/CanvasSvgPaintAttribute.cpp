@@ -37,6 +37,8 @@ IFACEMETHODIMP CanvasSvgPaintAttribute::get_PaintType(CanvasSvgPaintType* value)
 
 IFACEMETHODIMP CanvasSvgPaintAttribute::put_PaintType(CanvasSvgPaintType value)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -60,6 +62,8 @@ IFACEMETHODIMP CanvasSvgPaintAttribute::get_Color(Color* value)
 
 IFACEMETHODIMP CanvasSvgPaintAttribute::put_Color(Color value)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {                
@@ -89,6 +93,8 @@ IFACEMETHODIMP CanvasSvgPaintAttribute::get_Id(HSTRING* value)
 
 IFACEMETHODIMP CanvasSvgPaintAttribute::put_Id(HSTRING value)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -20,6 +20,8 @@ CanvasSvgPathAttribute::CanvasSvgPathAttribute(
 
 IFACEMETHODIMP CanvasSvgPathAttribute::Close()
 {
+    InvalidatePathGeometries();
+
     m_canvasDevice.Close();
     return ResourceWrapper::Close();
 }
@@ -40,11 +42,27 @@ IFACEMETHODIMP CanvasSvgPathAttribute::CreatePathGeometryWithFill(CanvasFilledRe
 
             auto& device = m_canvasDevice.EnsureNotClosed();
 
+            auto fillMode = StaticCastAs<D2D1_FILL_MODE>(filledRegionDetermination);
+
+            if (fillMode != D2D1_FILL_MODE_ALTERNATE && fillMode != D2D1_FILL_MODE_WINDING)
+                ThrowHR(E_INVALIDARG);
+
             ComPtr<ID2D1PathGeometry1> d2dGeometry;
-            ThrowIfFailed(resource->CreatePathGeometry(StaticCastAs<D2D1_FILL_MODE>(filledRegionDetermination), &d2dGeometry));
 
-            auto canvasGeometry = Make<CanvasGeometry>(device.Get(), d2dGeometry.Get());
-            CheckMakeResult(canvasGeometry);
+            {
+                Lock lock(m_pathGeometryMutex);
+
+                auto& cachedGeometry = m_pathGeometries[fillMode];
+
+                if (!cachedGeometry)
+                    ThrowIfFailed(resource->CreatePathGeometry(fillMode, &cachedGeometry));
+
+                d2dGeometry = cachedGeometry;
+            }
+
+            // Path geometries are immutable, so each caller gets its own
+            // wrapper around the same one.
+            auto canvasGeometry = CanvasGeometry::CreateShared(device.Get(), d2dGeometry.Get());
 
             ThrowIfFailed(canvasGeometry.CopyTo(result));
         });
@@ -128,6 +146,8 @@ IFACEMETHODIMP CanvasSvgPathAttribute::GetSegmentData(int32_t startIndex, int32_
 
 IFACEMETHODIMP CanvasSvgPathAttribute::RemoveCommandsAtEnd(int32_t commandCount)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {            
@@ -135,12 +155,16 @@ IFACEMETHODIMP CanvasSvgPathAttribute::RemoveCommandsAtEnd(int32_t commandCount)
 
             auto& resource = GetResource();
 
+            InvalidatePathGeometries();
+
             resource->RemoveCommandsAtEnd(commandCount);
         });
 }
 
 IFACEMETHODIMP CanvasSvgPathAttribute::RemoveSegmentDataAtEnd(int32_t segmentDataCount)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {            
@@ -148,12 +172,16 @@ IFACEMETHODIMP CanvasSvgPathAttribute::RemoveSegmentDataAtEnd(int32_t segmentDat
 
             auto& resource = GetResource();
 
+            InvalidatePathGeometries();
+
             resource->RemoveSegmentDataAtEnd(segmentDataCount);
         });
 }
 
 IFACEMETHODIMP CanvasSvgPathAttribute::SetCommands(int32_t startIndex, uint32_t commandCount, CanvasSvgPathCommand* commands)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -161,12 +189,16 @@ IFACEMETHODIMP CanvasSvgPathAttribute::SetCommands(int32_t startIndex, uint32_t
 
             auto& resource = GetResource();
 
+            InvalidatePathGeometries();
+
             resource->UpdateCommands(ReinterpretAs<D2D1_SVG_PATH_COMMAND const*>(commands), commandCount, startIndex);
         });
 }
 
 IFACEMETHODIMP CanvasSvgPathAttribute::SetSegmentData(int32_t startIndex, uint32_t commandCount, float* segmentData)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -174,10 +206,22 @@ IFACEMETHODIMP CanvasSvgPathAttribute::SetSegmentData(int32_t startIndex, uint32
 
             auto& resource = GetResource();
 
+            InvalidatePathGeometries();
+
             resource->UpdateSegmentData(segmentData, commandCount, startIndex);
         });
 }
 
+void CanvasSvgPathAttribute::InvalidatePathGeometries()
+{
+    Lock lock(m_pathGeometryMutex);
+
+    for (auto& pathGeometry : m_pathGeometries)
+    {
+        pathGeometry.Reset();
+    }
+}
+
 IFACEMETHODIMP CanvasSvgPathAttribute::Clone(ICanvasSvgAttribute** result)
 {
     return ExceptionBoundary(
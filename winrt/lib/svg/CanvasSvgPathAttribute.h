@@ -27,6 +27,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ClosablePtr<ICanvasDevice> m_canvasDevice;
 
+        // Geometries already created from this path, indexed by D2D1_FILL_MODE,
+        // which stay valid until the path is changed.  Changes made directly to
+        // the ID2D1SvgPathData through interop are not noticed.
+        std::mutex m_pathGeometryMutex;
+        ComPtr<ID2D1PathGeometry1> m_pathGeometries[2];
+
     public:
 
         CanvasSvgPathAttribute(
@@ -61,6 +67,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         {
             return GetResource();
         }
+
+    private:
+        void InvalidatePathGeometries();
     };
 }}}}}
 
@@ -63,6 +63,8 @@ IFACEMETHODIMP CanvasSvgPointsAttribute::GetPoints(int32_t startIndex, int32_t e
 
 IFACEMETHODIMP CanvasSvgPointsAttribute::RemovePointsAtEnd(int32_t count)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {            
@@ -76,6 +78,8 @@ IFACEMETHODIMP CanvasSvgPointsAttribute::RemovePointsAtEnd(int32_t count)
 
 IFACEMETHODIMP CanvasSvgPointsAttribute::SetPoints(int32_t startIndex, uint32_t pointCount, Vector2* points)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -84,6 +84,8 @@ IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::GetDashesWithUnits(
 
 IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::RemoveDashesAtEnd(int32_t count)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {            
@@ -97,6 +99,8 @@ IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::RemoveDashesAtEnd(int32_t coun
 
 IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::SetDashes(int32_t startIndex, uint32_t dashCount, float* dashes)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -110,6 +114,8 @@ IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::SetDashes(int32_t startIndex,
 
 IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::SetDashesWithUnit(int32_t startIndex, uint32_t dashCount, float* dashValues, CanvasSvgLengthUnits dashUnits)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
@@ -148,6 +154,8 @@ std::vector<D2D1_SVG_LENGTH> CanvasSvgStrokeDashArrayAttribute::GetD2DSvgLengths
 
 IFACEMETHODIMP CanvasSvgStrokeDashArrayAttribute::SetDashesWithUnits(int32_t startIndex, uint32_t dashCount, float* dashValues, uint32_t unitsCount, CanvasSvgLengthUnits* dashUnits)
 {
+    AttributeHelpers::MarkContentChanged();
+
     return ExceptionBoundary(
         [&]
         {
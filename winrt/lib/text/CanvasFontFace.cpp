@@ -22,11 +22,206 @@ float CanvasFontFace::DesignSpaceToEmSpace(int designSpaceUnits, unsigned short
     return static_cast<float>(designSpaceUnits) / static_cast<float>(designUnitsPerEm);
 }
 
+CanvasGlyphMetrics CanvasFontFace::ToCanvasGlyphMetrics(DWRITE_GLYPH_METRICS const& glyphMetrics, DWRITE_FONT_METRICS1 const& fontMetrics)
+{
+    auto leftDesignSpace = glyphMetrics.leftSideBearing;
+    auto topDesignSpace = fontMetrics.lineGap + fontMetrics.ascent - glyphMetrics.verticalOriginY + glyphMetrics.topSideBearing;
+    auto widthDesignSpace = glyphMetrics.advanceWidth - glyphMetrics.leftSideBearing - glyphMetrics.rightSideBearing;
+    auto heightDesignSpace = glyphMetrics.advanceHeight - glyphMetrics.topSideBearing - glyphMetrics.bottomSideBearing;
+
+    auto left = DesignSpaceToEmSpace(leftDesignSpace, fontMetrics.designUnitsPerEm);
+    auto top = DesignSpaceToEmSpace(topDesignSpace, fontMetrics.designUnitsPerEm);
+    auto width = DesignSpaceToEmSpace(widthDesignSpace, fontMetrics.designUnitsPerEm);
+    auto height = DesignSpaceToEmSpace(heightDesignSpace, fontMetrics.designUnitsPerEm);
+
+    return CanvasGlyphMetrics{
+        DesignSpaceToEmSpace(glyphMetrics.leftSideBearing, fontMetrics.designUnitsPerEm),
+        DesignSpaceToEmSpace(glyphMetrics.advanceWidth, fontMetrics.designUnitsPerEm),
+        DesignSpaceToEmSpace(glyphMetrics.rightSideBearing, fontMetrics.designUnitsPerEm),
+        DesignSpaceToEmSpace(glyphMetrics.topSideBearing, fontMetrics.designUnitsPerEm),
+        DesignSpaceToEmSpace(glyphMetrics.advanceHeight, fontMetrics.designUnitsPerEm),
+        DesignSpaceToEmSpace(glyphMetrics.bottomSideBearing, fontMetrics.designUnitsPerEm),
+        DesignSpaceToEmSpace(glyphMetrics.verticalOriginY, fontMetrics.designUnitsPerEm),
+        Rect{ left, top, width, height }
+    };
+}
+
 CanvasFontFace::CanvasFontFace(DWriteFontReferenceType* fontFace)
     : ResourceWrapper(fontFace)
 {
 }
 
+
+uint16_t* FontFaceGlyphCache::FindGlyphIndex(Lock const& lock, uint32_t codePoint, bool create)
+{
+    MustOwnLock(lock);
+
+    auto blockIndex = codePoint / BlockSize;
+    auto it = m_glyphIndexBlocks.find(blockIndex);
+
+    if (it == m_glyphIndexBlocks.end())
+    {
+        if (!create)
+            return nullptr;
+
+        it = m_glyphIndexBlocks.emplace(blockIndex, std::vector<uint16_t>(BlockSize, NotCached)).first;
+    }
+
+    return &it->second[codePoint % BlockSize];
+}
+
+void FontFaceGlyphCache::GetGlyphIndices(
+    IDWriteFontFace* fontFace,
+    uint32_t codePointCount,
+    uint32_t const* codePoints,
+    uint16_t* glyphIndices)
+{
+    std::vector<uint32_t> missingPositions;
+    std::vector<uint32_t> missingCodePoints;
+
+    {
+        Lock lock(m_mutex);
+
+        for (uint32_t i = 0; i < codePointCount; ++i)
+        {
+            auto cached = FindGlyphIndex(lock, codePoints[i], false);
+
+            if (cached && *cached != NotCached)
+            {
+                glyphIndices[i] = *cached;
+            }
+            else
+            {
+                missingPositions.push_back(i);
+                missingCodePoints.push_back(codePoints[i]);
+            }
+        }
+    }
+
+    if (missingCodePoints.empty())
+        return;
+
+    auto missingCount = static_cast<uint32_t>(missingCodePoints.size());
+    std::vector<uint16_t> missingGlyphIndices(missingCount);
+    ThrowIfFailed(fontFace->GetGlyphIndices(missingCodePoints.data(), missingCount, missingGlyphIndices.data()));
+
+    Lock lock(m_mutex);
+
+    for (uint32_t i = 0; i < missingCount; ++i)
+    {
+        *FindGlyphIndex(lock, missingCodePoints[i], true) = missingGlyphIndices[i];
+        glyphIndices[missingPositions[i]] = missingGlyphIndices[i];
+    }
+}
+
+void FontFaceGlyphCache::GetDesignGlyphMetrics(
+    IDWriteFontFace* fontFace,
+    uint32_t glyphCount,
+    uint16_t const* glyphIndices,
+    bool isSideways,
+    DWRITE_GLYPH_METRICS* glyphMetrics)
+{
+    std::vector<uint32_t> missingPositions;
+    std::vector<uint16_t> missingGlyphIndices;
+
+    {
+        Lock lock(m_mutex);
+
+        auto& cache = m_designGlyphMetrics[isSideways];
+
+        for (uint32_t i = 0; i < glyphCount; ++i)
+        {
+            auto it = cache.find(glyphIndices[i]);
+
+            if (it != cache.end())
+            {
+                glyphMetrics[i] = it->second;
+            }
+            else
+            {
+                missingPositions.push_back(i);
+                missingGlyphIndices.push_back(glyphIndices[i]);
+            }
+        }
+    }
+
+    if (missingGlyphIndices.empty())
+        return;
+
+    auto missingCount = static_cast<uint32_t>(missingGlyphIndices.size());
+    std::vector<DWRITE_GLYPH_METRICS> missingGlyphMetrics(missingCount);
+    ThrowIfFailed(fontFace->GetDesignGlyphMetrics(missingGlyphIndices.data(), missingCount, missingGlyphMetrics.data(), isSideways));
+
+    Lock lock(m_mutex);
+
+    auto& cache = m_designGlyphMetrics[isSideways];
+
+    for (uint32_t i = 0; i < missingCount; ++i)
+    {
+        cache[missingGlyphIndices[i]] = missingGlyphMetrics[i];
+        glyphMetrics[missingPositions[i]] = missingGlyphMetrics[i];
+    }
+}
+
+void FontFaceGlyphCache::PreloadUnicodeRange(
+    IDWriteFontFace* fontFace,
+    uint32_t first,
+    uint32_t last,
+    bool isSideways)
+{
+    std::vector<uint32_t> codePoints;
+    std::vector<uint16_t> glyphIndices;
+
+    std::vector<bool> isGlyphFound(fontFace->GetGlyphCount());
+    std::vector<uint16_t> foundGlyphs;
+
+    for (uint32_t blockStart = first - first % BlockSize; blockStart <= last; blockStart += BlockSize)
+    {
+        auto blockFirst = std::max(first, blockStart);
+        auto blockLast = std::min(last, blockStart + BlockSize - 1);
+
+        codePoints.clear();
+
+        for (auto codePoint = blockFirst; codePoint <= blockLast; ++codePoint)
+            codePoints.push_back(codePoint);
+
+        auto count = static_cast<uint32_t>(codePoints.size());
+        glyphIndices.resize(count);
+        ThrowIfFailed(fontFace->GetGlyphIndices(codePoints.data(), count, glyphIndices.data()));
+
+        {
+            Lock lock(m_mutex);
+
+            for (uint32_t i = 0; i < count; ++i)
+                *FindGlyphIndex(lock, codePoints[i], true) = glyphIndices[i];
+        }
+
+        for (auto glyphIndex : glyphIndices)
+        {
+            if (glyphIndex < isGlyphFound.size() && !isGlyphFound[glyphIndex])
+            {
+                isGlyphFound[glyphIndex] = true;
+                foundGlyphs.push_back(glyphIndex);
+            }
+        }
+    }
+
+    if (foundGlyphs.empty())
+        return;
+
+    std::vector<DWRITE_GLYPH_METRICS> glyphMetrics(foundGlyphs.size());
+    GetDesignGlyphMetrics(fontFace, static_cast<uint32_t>(foundGlyphs.size()), foundGlyphs.data(), isSideways, glyphMetrics.data());
+}
+
+void FontFaceGlyphCache::Clear()
+{
+    Lock lock(m_mutex);
+
+    m_glyphIndexBlocks.clear();
+    m_designGlyphMetrics[0].clear();
+    m_designGlyphMetrics[1].clear();
+}
+
 class FontFileListEnumerator
     : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IDWriteFontFileEnumerator>
     , private LifespanTracker<FontFileListEnumerator>
@@ -655,7 +850,7 @@ IFACEMETHODIMP CanvasFontFace::GetGlyphIndices(
 
             std::vector<unsigned short> glyphIndices(inputCount);
 
-            ThrowIfFailed(GetRealizedFontFace()->GetGlyphIndices(inputElements, inputCount, glyphIndices.data()));
+            m_glyphCache.GetGlyphIndices(GetRealizedFontFace().Get(), inputCount, inputElements, glyphIndices.data());
 
             ComArray<int> output(inputCount);
 
@@ -691,7 +886,7 @@ IFACEMETHODIMP CanvasFontFace::GetGlyphMetrics(
             }
 
             std::vector<DWRITE_GLYPH_METRICS> glyphMetrics(inputCount);
-            ThrowIfFailed(GetRealizedFontFace()->GetDesignGlyphMetrics(glyphIndices.data(), inputCount, glyphMetrics.data(), isSideways));
+            m_glyphCache.GetDesignGlyphMetrics(GetRealizedFontFace().Get(), inputCount, glyphIndices.data(), !!isSideways, glyphMetrics.data());
 
             ComArray<CanvasGlyphMetrics> output(inputCount);
 
@@ -699,33 +894,26 @@ IFACEMETHODIMP CanvasFontFace::GetGlyphMetrics(
             GetRealizedFontFace()->GetMetrics(&metrics);
 
             for (uint32_t i = 0; i < inputCount; ++i)
-            {
-                auto leftDesignSpace = glyphMetrics[i].leftSideBearing;
-                auto topDesignSpace = metrics.lineGap + metrics.ascent - glyphMetrics[i].verticalOriginY + glyphMetrics[i].topSideBearing;
-                auto widthDesignSpace = glyphMetrics[i].advanceWidth - glyphMetrics[i].leftSideBearing - glyphMetrics[i].rightSideBearing;
-                auto heightDesignSpace = glyphMetrics[i].advanceHeight - glyphMetrics[i].topSideBearing - glyphMetrics[i].bottomSideBearing;
-
-                auto left = DesignSpaceToEmSpace(leftDesignSpace, metrics.designUnitsPerEm);
-                auto top = DesignSpaceToEmSpace(topDesignSpace, metrics.designUnitsPerEm);
-                auto width = DesignSpaceToEmSpace(widthDesignSpace, metrics.designUnitsPerEm);
-                auto height = DesignSpaceToEmSpace(heightDesignSpace, metrics.designUnitsPerEm);
-
-                output[i] = CanvasGlyphMetrics{
-                    DesignSpaceToEmSpace(glyphMetrics[i].leftSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].advanceWidth, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].rightSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].topSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].advanceHeight, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].bottomSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].verticalOriginY, metrics.designUnitsPerEm),
-                    Rect{ left, top, width, height }
-                };
-            }
+                output[i] = ToCanvasGlyphMetrics(glyphMetrics[i], metrics);
 
             output.Detach(outputCount, outputElements);
         });
 }
 
+IFACEMETHODIMP CanvasFontFace::PreloadUnicodeRange(
+    CanvasUnicodeRange range,
+    boolean isSideways)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (range.First > range.Last || range.Last > 0x10FFFF)
+                ThrowHR(E_INVALIDARG);
+
+            m_glyphCache.PreloadUnicodeRange(GetRealizedFontFace().Get(), range.First, range.Last, !!isSideways);
+        });
+}
+
 IFACEMETHODIMP CanvasFontFace::GetGdiCompatibleGlyphMetrics(
     float fontSize,
     float dpi,
@@ -763,28 +951,7 @@ IFACEMETHODIMP CanvasFontFace::GetGdiCompatibleGlyphMetrics(
             GetRealizedFontFace()->GetMetrics(&metrics);
 
             for (uint32_t i = 0; i < inputCount; ++i)
-            {
-                auto leftDesignSpace = glyphMetrics[i].leftSideBearing;
-                auto topDesignSpace = metrics.lineGap + metrics.ascent - glyphMetrics[i].verticalOriginY + glyphMetrics[i].topSideBearing;
-                auto widthDesignSpace = glyphMetrics[i].advanceWidth - glyphMetrics[i].leftSideBearing - glyphMetrics[i].rightSideBearing;
-                auto heightDesignSpace = glyphMetrics[i].advanceHeight - glyphMetrics[i].topSideBearing - glyphMetrics[i].bottomSideBearing;
-
-                auto left = DesignSpaceToEmSpace(leftDesignSpace, metrics.designUnitsPerEm);
-                auto top = DesignSpaceToEmSpace(topDesignSpace, metrics.designUnitsPerEm);
-                auto width = DesignSpaceToEmSpace(widthDesignSpace, metrics.designUnitsPerEm);
-                auto height = DesignSpaceToEmSpace(heightDesignSpace, metrics.designUnitsPerEm);
-
-                output[i] = CanvasGlyphMetrics{
-                    DesignSpaceToEmSpace(glyphMetrics[i].leftSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].advanceWidth, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].rightSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].topSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].advanceHeight, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].bottomSideBearing, metrics.designUnitsPerEm),
-                    DesignSpaceToEmSpace(glyphMetrics[i].verticalOriginY, metrics.designUnitsPerEm),
-                    Rect{ left, top, width, height }
-                };
-            }
+                output[i] = ToCanvasGlyphMetrics(glyphMetrics[i], metrics);
 
             output.Detach(outputCount, outputElements);
         });
@@ -1104,6 +1271,8 @@ IFACEMETHODIMP CanvasFontFace::GetTypographicFeatureGlyphSupportWithLocale(
 
 IFACEMETHODIMP CanvasFontFace::Close()
 {
+    m_glyphCache.Clear();
+
     return ResourceWrapper::Close();
 }
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "utils/LockUtilities.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
 {
     using namespace ::Microsoft::WRL;
@@ -29,6 +31,56 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual ComPtr<DWriteFontFaceType> const& GetRealizedFontFace() = 0;
     };
 
+
+    //
+    // Remembers the glyph indices of characters and the design metrics of
+    // glyphs once they have been looked up, so custom shaping layers that ask
+    // a font face about the same few hundred glyphs thousands of times only go
+    // to DirectWrite once for each of them.
+    //
+    // Glyph indices are kept in blocks of consecutive code points.  Design
+    // metrics are kept per glyph, separately for sideways and upright text.
+    //
+    class FontFaceGlyphCache
+    {
+        static const uint32_t BlockSize = 256;
+
+        // A font has fewer than 65535 glyphs, so this is never a real index.
+        static const uint16_t NotCached = 0xFFFF;
+
+        std::mutex m_mutex;
+        std::unordered_map<uint32_t, std::vector<uint16_t>> m_glyphIndexBlocks;        // Keyed on code point / BlockSize.
+        std::unordered_map<uint16_t, DWRITE_GLYPH_METRICS> m_designGlyphMetrics[2];   // Indexed by isSideways.
+
+    public:
+        void GetGlyphIndices(
+            IDWriteFontFace* fontFace,
+            uint32_t codePointCount,
+            uint32_t const* codePoints,
+            uint16_t* glyphIndices);
+
+        void GetDesignGlyphMetrics(
+            IDWriteFontFace* fontFace,
+            uint32_t glyphCount,
+            uint16_t const* glyphIndices,
+            bool isSideways,
+            DWRITE_GLYPH_METRICS* glyphMetrics);
+
+        // Looks up every code point from first to last, and the metrics of the
+        // glyphs they map to, a block at a time.
+        void PreloadUnicodeRange(
+            IDWriteFontFace* fontFace,
+            uint32_t first,
+            uint32_t last,
+            bool isSideways);
+
+        void Clear();
+
+    private:
+        uint16_t* FindGlyphIndex(Lock const& lock, uint32_t codePoint, bool create);
+    };
+
+
     class CanvasFontFace : RESOURCE_WRAPPER_RUNTIME_CLASS(
         DWriteFontReferenceType,
         CanvasFontFace,
@@ -39,6 +91,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ComPtr<DWriteFontFaceType> m_realizedFontFace;
 
+        FontFaceGlyphCache m_glyphCache;
+
     public:
         CanvasFontFace(DWriteFontReferenceType* fontFace);
 
@@ -129,6 +183,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
           uint32_t* outputCount,
           CanvasGlyphMetrics** outputElements) override;
 
+        IFACEMETHOD(PreloadUnicodeRange)(
+            CanvasUnicodeRange range,
+            boolean isSideways) override;
+
         IFACEMETHOD(GetGdiCompatibleGlyphMetrics)(
           float fontSize,
           float dpi,
@@ -220,6 +278,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     private:
         float DesignSpaceToEmSpace(int designSpaceUnits, unsigned short designUnitsPerEm);
 
+        CanvasGlyphMetrics ToCanvasGlyphMetrics(DWRITE_GLYPH_METRICS const& glyphMetrics, DWRITE_FONT_METRICS1 const& fontMetrics);
+
         ComPtr<DWritePhysicalFontPropertyContainer> GetPhysicalPropertyContainer();
     };
 
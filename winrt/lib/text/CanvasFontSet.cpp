@@ -100,6 +100,9 @@ IFACEMETHODIMP CanvasFontSetFactory::GetSystemFontSet(
 
 CanvasFontSet::CanvasFontSet(DWriteFontSetType* dwriteFontSet)
     : ResourceWrapper(dwriteFontSet)
+#if WINVER > _WIN32_WINNT_WINBLUE
+    , m_fontIndexBuilt(false)
+#endif
     , m_customFontManager(CustomFontManager::GetInstance())
 {
 }
@@ -181,7 +184,7 @@ IFACEMETHODIMP CanvasFontSet::get_Fonts(IVectorView<CanvasFontFace*>** value)
             const uint32_t fontCount = static_cast<uint32_t>(m_flatCollection.size());
 #endif
 
-            auto vector = Make<Vector<CanvasFontFace*>>();
+            auto vector = MakePooled<Vector<CanvasFontFace*>>();
 
             for (uint32_t i = 0; i < fontCount; ++i)
             {
@@ -370,6 +373,187 @@ IFACEMETHODIMP CanvasFontSet::GetPropertyValues(
         });
 }
 
+
+bool CanvasFontSet::FontIndexEntry::HasFamilyName(wchar_t const* filter, int32_t filterLength) const
+{
+    if (filterLength == 0)
+        return true;
+
+    for (auto& familyName : FamilyNames)
+    {
+        if (FindStringOrdinal(FIND_FROMSTART, familyName.c_str(), static_cast<int>(familyName.size()), filter, filterLength, TRUE) >= 0)
+            return true;
+    }
+
+    return false;
+}
+
+
+bool CanvasFontSet::FontIndexEntry::HasCharacters(uint32_t characterCount, uint32_t const* characters) const
+{
+    for (uint32_t i = 0; i < characterCount; ++i)
+    {
+        auto character = characters[i];
+
+        // Find the last range starting at or before the character.
+        auto it = std::upper_bound(UnicodeRanges.begin(), UnicodeRanges.end(), character,
+            [](uint32_t value, DWRITE_UNICODE_RANGE const& range) { return value < range.first; });
+
+        if (it == UnicodeRanges.begin() || character > (it - 1)->last)
+            return false;
+    }
+
+    return true;
+}
+
+
+std::vector<CanvasFontSet::FontIndexEntry> const& CanvasFontSet::EnsureFontIndex(ComPtr<IDWriteFontSet> const& resource)
+{
+    Lock lock(m_fontIndexMutex);
+
+    if (m_fontIndexBuilt)
+        return m_fontIndex;
+
+    const uint32_t fontCount = resource->GetFontCount();
+
+    std::vector<FontIndexEntry> fontIndex(fontCount);
+
+    for (uint32_t i = 0; i < fontCount; ++i)
+    {
+        auto& entry = fontIndex[i];
+
+        ComPtr<IDWriteFontFaceReference> fontFaceReference;
+        ThrowIfFailed(resource->GetFontFaceReference(i, &fontFaceReference));
+
+        ComPtr<IDWriteFontFace3> fontFace;
+        ThrowIfFailed(fontFaceReference->CreateFontFace(&fontFace));
+
+        ComPtr<IDWriteLocalizedStrings> familyNames;
+        ThrowIfFailed(fontFace->GetFamilyNames(&familyNames));
+
+        const uint32_t nameCount = familyNames->GetCount();
+        entry.FamilyNames.reserve(nameCount);
+
+        for (uint32_t j = 0; j < nameCount; ++j)
+        {
+            auto name = GetTextFromLocalizedStrings(j, familyNames);
+            entry.FamilyNames.emplace_back(static_cast<wchar_t const*>(name));
+        }
+
+        entry.Weight = fontFace->GetWeight();
+        entry.Stretch = fontFace->GetStretch();
+        entry.Style = fontFace->GetStyle();
+
+        uint32_t rangeCount;
+        if (fontFace->GetUnicodeRanges(0, nullptr, &rangeCount) != E_NOT_SUFFICIENT_BUFFER)
+        {
+            ThrowHR(E_UNEXPECTED);
+        }
+
+        entry.UnicodeRanges.resize(rangeCount);
+        ThrowIfFailed(fontFace->GetUnicodeRanges(rangeCount, entry.UnicodeRanges.data(), &rangeCount));
+
+        std::sort(entry.UnicodeRanges.begin(), entry.UnicodeRanges.end(),
+            [](DWRITE_UNICODE_RANGE const& a, DWRITE_UNICODE_RANGE const& b) { return a.first < b.first; });
+    }
+
+    m_fontIndex = std::move(fontIndex);
+    m_fontIndexBuilt = true;
+
+    // Once built the index never changes, so it can be read without the lock.
+    return m_fontIndex;
+}
+
+
+void CanvasFontSet::GetMatchingFontIndicesImpl(
+    HSTRING familyNameFilter,
+    std::function<bool(FontIndexEntry const&)> const& matchesStyle,
+    UINT32 characterCount,
+    UINT32* characters,
+    UINT32* indexCount,
+    UINT32** indices)
+{
+    if (characterCount > 0)
+        CheckInPointer(characters);
+    CheckInPointer(indexCount);
+    CheckAndClearOutPointer(indices);
+
+    auto& fontIndex = EnsureFontIndex(GetResource());
+
+    uint32_t filterLength;
+    auto filter = WindowsGetStringRawBuffer(familyNameFilter, &filterLength);
+
+    std::vector<uint32_t> matches;
+
+    for (uint32_t i = 0; i < fontIndex.size(); ++i)
+    {
+        auto& entry = fontIndex[i];
+
+        if (matchesStyle(entry) &&
+            entry.HasFamilyName(filter, static_cast<int32_t>(filterLength)) &&
+            entry.HasCharacters(characterCount, characters))
+        {
+            matches.push_back(i);
+        }
+    }
+
+    ComArray<uint32_t> output(matches.begin(), matches.end());
+    output.Detach(indexCount, indices);
+}
+
+
+IFACEMETHODIMP CanvasFontSet::GetMatchingFontIndices(
+    HSTRING familyNameFilter,
+    UINT32 characterCount,
+    UINT32* characters,
+    UINT32* indexCount,
+    UINT32** indices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            GetMatchingFontIndicesImpl(
+                familyNameFilter,
+                [](FontIndexEntry const&) { return true; },
+                characterCount,
+                characters,
+                indexCount,
+                indices);
+        });
+}
+
+
+IFACEMETHODIMP CanvasFontSet::GetMatchingFontIndicesWithStyle(
+    HSTRING familyNameFilter,
+    FontWeight weight,
+    FontStretch stretch,
+    FontStyle style,
+    UINT32 characterCount,
+    UINT32* characters,
+    UINT32* indexCount,
+    UINT32** indices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            // A weight of zero or an undefined stretch matches any font.
+            auto dwriteStyle = ToFontStyle(style);
+
+            GetMatchingFontIndicesImpl(
+                familyNameFilter,
+                [&](FontIndexEntry const& entry)
+                {
+                    return (weight.Weight == 0 || entry.Weight == ToFontWeight(weight)) &&
+                           (stretch == FontStretch_Undefined || entry.Stretch == ToFontStretch(stretch)) &&
+                           entry.Style == dwriteStyle;
+                },
+                characterCount,
+                characters,
+                indexCount,
+                indices);
+        });
+}
+
 #endif
 
 ActivatableClassWithFactory(CanvasFontSet, CanvasFontSetFactory);
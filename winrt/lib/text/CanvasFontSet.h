@@ -25,6 +25,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
 #if WINVER <= _WIN32_WINNT_WINBLUE
         std::vector<ComPtr<IDWriteFont>> m_flatCollection;
+#else
+        //
+        // What GetMatchingFontIndices filters on, for one font of the set.
+        // Font sets are immutable, so the index is built the first time it
+        // is needed and never changes after that.
+        //
+        struct FontIndexEntry
+        {
+            std::vector<std::wstring> FamilyNames;                  // In every locale the font has.
+            DWRITE_FONT_WEIGHT Weight;
+            DWRITE_FONT_STRETCH Stretch;
+            DWRITE_FONT_STYLE Style;
+            std::vector<DWRITE_UNICODE_RANGE> UnicodeRanges;        // Sorted by first.
+
+            bool HasFamilyName(wchar_t const* filter, int32_t filterLength) const;
+            bool HasCharacters(uint32_t characterCount, uint32_t const* characters) const;
+        };
+
+        std::mutex m_fontIndexMutex;
+        std::vector<FontIndexEntry> m_fontIndex;
+        bool m_fontIndexBuilt;
 #endif
         std::shared_ptr<CustomFontManager> m_customFontManager;
 
@@ -70,11 +91,38 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             CanvasFontPropertyIdentifier propertyIdentifier,
             UINT32* valueCount,
             CanvasFontProperty** valueElements) override;
+
+        IFACEMETHOD(GetMatchingFontIndices)(
+            HSTRING familyNameFilter,
+            UINT32 characterCount,
+            UINT32* characters,
+            UINT32* indexCount,
+            UINT32** indices) override;
+
+        IFACEMETHOD(GetMatchingFontIndicesWithStyle)(
+            HSTRING familyNameFilter,
+            FontWeight weight,
+            FontStretch stretch,
+            FontStyle style,
+            UINT32 characterCount,
+            UINT32* characters,
+            UINT32* indexCount,
+            UINT32** indices) override;
 #endif
 
-#if WINVER <= _WIN32_WINNT_WINBLUE
     private:
+#if WINVER <= _WIN32_WINNT_WINBLUE
         void EnsureFlatCollection(ComPtr<IDWriteFontCollection> const& resource);
+#else
+        std::vector<FontIndexEntry> const& EnsureFontIndex(ComPtr<IDWriteFontSet> const& resource);
+
+        void GetMatchingFontIndicesImpl(
+            HSTRING familyNameFilter,
+            std::function<bool(FontIndexEntry const&)> const& matchesStyle,
+            UINT32 characterCount,
+            UINT32* characters,
+            UINT32* indexCount,
+            UINT32** indices);
 #endif
     };
 
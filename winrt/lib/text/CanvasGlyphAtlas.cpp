@@ -0,0 +1,830 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include "CanvasGlyphAtlas.h"
+#include "CustomFontManager.h"
+#include "drawing/CanvasSpriteBatch.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    //
+    // CanvasGlyphAtlasFactory
+    //
+
+    IFACEMETHODIMP CanvasGlyphAtlasFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasGlyphAtlas** glyphAtlas)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(glyphAtlas);
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto newGlyphAtlas = Make<CanvasGlyphAtlas>(device.Get());
+                CheckMakeResult(newGlyphAtlas);
+
+                ThrowIfFailed(newGlyphAtlas.CopyTo(glyphAtlas));
+            });
+    }
+
+
+    //
+    // Glyph placement and packing
+    //
+
+    GlyphPlacement GetGlyphPlacement(float x, float y)
+    {
+        auto left = floor(x);
+        auto subpixelBin = static_cast<int>(round((x - left) * GlyphSubpixelBins));
+
+        // Rounding up from the last bin lands on the next pixel.
+        if (subpixelBin == GlyphSubpixelBins)
+        {
+            left += 1;
+            subpixelBin = 0;
+        }
+
+        return GlyphPlacement
+        {
+            static_cast<int>(left),
+            static_cast<int>(round(y)),
+            subpixelBin
+        };
+    }
+
+    GlyphAtlasPacker::GlyphAtlasPacker(uint32_t size)
+        : m_size(size)
+        , m_x(0)
+        , m_y(0)
+        , m_rowHeight(0)
+    {
+    }
+
+    bool GlyphAtlasPacker::TryAllocate(uint32_t width, uint32_t height, D2D1_POINT_2U* position)
+    {
+        if (width > m_size || height > m_size)
+            return false;
+
+        if (m_x + width > m_size)
+        {
+            m_x = 0;
+            m_y += m_rowHeight;
+            m_rowHeight = 0;
+        }
+
+        if (m_y + height > m_size)
+            return false;
+
+        *position = D2D1_POINT_2U{ m_x, m_y };
+
+        m_x += width;
+        m_rowHeight = std::max(m_rowHeight, height);
+
+        return true;
+    }
+
+
+    //
+    // Rasterizes glyphs into atlas pages, on a device context leased from the
+    // device so that it can be drawing while the drawing session is.  Drawing
+    // into one page is kept open across glyphs, and only ended when moving to
+    // another page or when the text has been laid out.
+    //
+    class GlyphRasterizer
+    {
+        ICanvasDevice* m_device;
+        float m_dpi;
+
+        DeviceContextLease m_lease;
+        ComPtr<ID2D1SolidColorBrush> m_brush;
+        ComPtr<ID2D1Bitmap1> m_target;
+
+    public:
+        GlyphRasterizer(ICanvasDevice* device, float dpi)
+            : m_device(device)
+            , m_dpi(dpi)
+        {
+        }
+
+        GlyphRasterizer(GlyphRasterizer const&) = delete;
+        GlyphRasterizer& operator=(GlyphRasterizer const&) = delete;
+
+        ~GlyphRasterizer()
+        {
+            if (!m_lease.Get())
+                return;
+
+            if (m_target)
+                (void)m_lease->EndDraw();
+
+            m_lease->SetTarget(nullptr);
+            m_lease->SetDpi(DEFAULT_DPI, DEFAULT_DPI);
+            m_lease->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_DEFAULT);
+        }
+
+        ID2D1DeviceContext1* GetDeviceContext()
+        {
+            if (!m_lease.Get())
+            {
+                m_lease = As<ICanvasDeviceInternal>(m_device)->GetResourceCreationDeviceContext();
+                m_lease->SetDpi(m_dpi, m_dpi);
+                m_lease->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+
+                ThrowIfFailed(m_lease->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), &m_brush));
+            }
+
+            return m_lease.Get();
+        }
+
+        ComPtr<ID2D1Bitmap1> CreatePage()
+        {
+            auto sizeInDips = PixelsToDips(CanvasGlyphAtlas::PageSizeInPixels, m_dpi);
+
+            auto page = As<ICanvasDeviceInternal>(m_device)->CreateRenderTargetBitmap(
+                sizeInDips,
+                sizeInDips,
+                m_dpi,
+                PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                CanvasAlphaMode::Premultiplied);
+
+            // New bitmaps start out with undefined contents.
+            SetTarget(page.Get());
+            m_lease->Clear(D2D1::ColorF(0, 0));
+
+            return page;
+        }
+
+        void DrawGlyph(
+            ID2D1Bitmap1* page,
+            D2D1_POINT_2F origin,
+            DWRITE_GLYPH_RUN const* glyphRun,
+            DWRITE_MEASURING_MODE measuringMode)
+        {
+            SetTarget(page);
+            m_lease->DrawGlyphRun(origin, glyphRun, m_brush.Get(), measuringMode);
+        }
+
+        void Flush()
+        {
+            if (!m_target)
+                return;
+
+            m_target.Reset();
+            ThrowIfFailed(m_lease->EndDraw());
+        }
+
+    private:
+        void SetTarget(ID2D1Bitmap1* page)
+        {
+            if (m_target.Get() == page)
+                return;
+
+            Flush();
+
+            auto deviceContext = GetDeviceContext();
+
+            deviceContext->SetTarget(page);
+            deviceContext->BeginDraw();
+            m_target = page;
+        }
+    };
+
+
+    //
+    // Receives the glyph runs of a text layout, adding those the atlas can
+    // draw to a sprite batch and drawing the rest straight away.
+    //
+    class GlyphAtlasTextRenderer
+        : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IDWriteTextRenderer>
+        , private LifespanTracker<GlyphAtlasTextRenderer>
+    {
+        CanvasGlyphAtlas* m_glyphAtlas;
+        GlyphRasterizer& m_rasterizer;
+        CanvasSpriteBatch* m_spriteBatch;
+        ID2D1DeviceContext1* m_deviceContext;
+        ID2D1SolidColorBrush* m_brush;
+        D2D1_DRAW_TEXT_OPTIONS m_options;
+        D2D1::Matrix3x2F m_transform;
+        float m_pixelsPerUnit;
+
+    public:
+        GlyphAtlasTextRenderer(
+            CanvasGlyphAtlas* glyphAtlas,
+            GlyphRasterizer& rasterizer,
+            CanvasSpriteBatch* spriteBatch,
+            ID2D1DeviceContext1* deviceContext,
+            ID2D1SolidColorBrush* brush,
+            D2D1_DRAW_TEXT_OPTIONS options,
+            D2D1::Matrix3x2F const& transform,
+            float pixelsPerUnit)
+            : m_glyphAtlas(glyphAtlas)
+            , m_rasterizer(rasterizer)
+            , m_spriteBatch(spriteBatch)
+            , m_deviceContext(deviceContext)
+            , m_brush(brush)
+            , m_options(options)
+            , m_transform(transform)
+            , m_pixelsPerUnit(pixelsPerUnit)
+        {
+        }
+
+        IFACEMETHODIMP DrawGlyphRun(
+            void*,
+            FLOAT baselineOriginX,
+            FLOAT baselineOriginY,
+            DWRITE_MEASURING_MODE measuringMode,
+            DWRITE_GLYPH_RUN const* glyphRun,
+            DWRITE_GLYPH_RUN_DESCRIPTION const* glyphRunDescription,
+            IUnknown* clientDrawingEffect) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    auto brush = GetBrush(clientDrawingEffect);
+
+                    if (auto solidColorBrush = MaybeAs<ID2D1SolidColorBrush>(brush))
+                    {
+                        auto x = (baselineOriginX + m_transform._31) * m_pixelsPerUnit;
+                        auto y = (baselineOriginY + m_transform._32) * m_pixelsPerUnit;
+
+                        if (m_glyphAtlas->TryAddGlyphRun(m_rasterizer, m_spriteBatch, x, y, m_pixelsPerUnit, measuringMode, glyphRun, m_options, GetTint(solidColorBrush.Get())))
+                            return;
+                    }
+
+                    DrawGlyphRunWithDirectWrite(D2D1::Point2F(baselineOriginX, baselineOriginY), measuringMode, glyphRun, glyphRunDescription, brush.Get());
+                });
+        }
+
+        IFACEMETHODIMP DrawUnderline(
+            void*,
+            FLOAT baselineOriginX,
+            FLOAT baselineOriginY,
+            DWRITE_UNDERLINE const* underline,
+            IUnknown* clientDrawingEffect) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    FillLine(baselineOriginX, baselineOriginY, underline->width, underline->offset, underline->thickness, clientDrawingEffect);
+                });
+        }
+
+        IFACEMETHODIMP DrawStrikethrough(
+            void*,
+            FLOAT baselineOriginX,
+            FLOAT baselineOriginY,
+            DWRITE_STRIKETHROUGH const* strikethrough,
+            IUnknown* clientDrawingEffect) override
+        {
+            return ExceptionBoundary(
+                [&]
+                {
+                    FillLine(baselineOriginX, baselineOriginY, strikethrough->width, strikethrough->offset, strikethrough->thickness, clientDrawingEffect);
+                });
+        }
+
+        IFACEMETHODIMP DrawInlineObject(
+            void* clientDrawingContext,
+            FLOAT originX,
+            FLOAT originY,
+            IDWriteInlineObject* inlineObject,
+            BOOL isSideways,
+            BOOL isRightToLeft,
+            IUnknown* clientDrawingEffect) override
+        {
+            if (!inlineObject)
+                return E_INVALIDARG;
+
+            // Trimming signs and the like call back into DrawGlyphRun.
+            return inlineObject->Draw(clientDrawingContext, this, originX, originY, isSideways, isRightToLeft, clientDrawingEffect);
+        }
+
+        IFACEMETHODIMP IsPixelSnappingDisabled(void*, BOOL* isDisabled) override
+        {
+            if (!isDisabled)
+                return E_INVALIDARG;
+
+            *isDisabled = FALSE;
+            return S_OK;
+        }
+
+        IFACEMETHODIMP GetCurrentTransform(void*, DWRITE_MATRIX* transform) override
+        {
+            if (!transform)
+                return E_INVALIDARG;
+
+            *transform = *ReinterpretAs<DWRITE_MATRIX const*>(&m_transform);
+            return S_OK;
+        }
+
+        IFACEMETHODIMP GetPixelsPerDip(void*, FLOAT* pixelsPerDip) override
+        {
+            if (!pixelsPerDip)
+                return E_INVALIDARG;
+
+            *pixelsPerDip = m_pixelsPerUnit;
+            return S_OK;
+        }
+
+    private:
+        ComPtr<ID2D1Brush> GetBrush(IUnknown* clientDrawingEffect)
+        {
+            // Not every drawing effect is a brush: D2D uses the default brush for those.
+            if (auto brush = MaybeAs<ID2D1Brush>(clientDrawingEffect))
+                return brush;
+
+            return m_brush;
+        }
+
+        static Vector4 GetTint(ID2D1SolidColorBrush* brush)
+        {
+            // Atlas pages are premultiplied white, so the tint must be premultiplied too.
+            auto color = brush->GetColor();
+            auto alpha = color.a * brush->GetOpacity();
+
+            return Vector4{ color.r * alpha, color.g * alpha, color.b * alpha, alpha };
+        }
+
+        void FillLine(float x, float y, float width, float offset, float thickness, IUnknown* clientDrawingEffect)
+        {
+            auto rect = D2D1::RectF(x, y + offset, x + width, y + offset + thickness);
+
+            m_deviceContext->FillRectangle(&rect, GetBrush(clientDrawingEffect).Get());
+        }
+
+        void DrawGlyphRunWithDirectWrite(
+            D2D1_POINT_2F const& origin,
+            DWRITE_MEASURING_MODE measuringMode,
+            DWRITE_GLYPH_RUN const* glyphRun,
+            DWRITE_GLYPH_RUN_DESCRIPTION const* glyphRunDescription,
+            ID2D1Brush* brush)
+        {
+            if (m_options & D2D1_DRAW_TEXT_OPTIONS_ENABLE_COLOR_FONT)
+            {
+                // ID2D1DeviceContext::DrawGlyphRun only draws in one color, so
+                // color fonts are split into their layers the same way
+                // DrawTextLayout does it.
+                auto factory = MaybeAs<IDWriteFactory2>(CustomFontManager::GetInstance()->GetSharedFactory());
+
+                if (factory)
+                {
+                    ComPtr<IDWriteColorGlyphRunEnumerator> layers;
+
+                    HRESULT hr = factory->TranslateColorGlyphRun(origin.x, origin.y, glyphRun, glyphRunDescription, measuringMode, nullptr, 0, &layers);
+
+                    if (SUCCEEDED(hr))
+                    {
+                        DrawColorLayers(layers.Get(), measuringMode, brush);
+                        return;
+                    }
+
+                    if (hr != DWRITE_E_NOCOLOR)
+                        ThrowHR(hr);
+                }
+            }
+
+            m_deviceContext->DrawGlyphRun(origin, glyphRun, glyphRunDescription, brush, measuringMode);
+        }
+
+        void DrawColorLayers(IDWriteColorGlyphRunEnumerator* layers, DWRITE_MEASURING_MODE measuringMode, ID2D1Brush* brush)
+        {
+            for (;;)
+            {
+                BOOL hasRun;
+                ThrowIfFailed(layers->MoveNext(&hasRun));
+
+                if (!hasRun)
+                    break;
+
+                DWRITE_COLOR_GLYPH_RUN const* layer;
+                ThrowIfFailed(layers->GetCurrentRun(&layer));
+
+                // Layers without a palette entry are drawn in the text color.
+                ComPtr<ID2D1Brush> layerBrush = brush;
+
+                if (layer->paletteIndex != 0xFFFF)
+                {
+                    ComPtr<ID2D1SolidColorBrush> paletteBrush;
+                    ThrowIfFailed(m_deviceContext->CreateSolidColorBrush(layer->runColor, &paletteBrush));
+                    layerBrush = paletteBrush;
+                }
+
+                m_deviceContext->DrawGlyphRun(
+                    D2D1::Point2F(layer->baselineOriginX, layer->baselineOriginY),
+                    &layer->glyphRun,
+                    layer->glyphRunDescription,
+                    layerBrush.Get(),
+                    measuringMode);
+            }
+        }
+    };
+
+
+    //
+    // CanvasGlyphAtlas
+    //
+
+    CanvasGlyphAtlas::CanvasGlyphAtlas(ICanvasDevice* device)
+        : m_device(device)
+        , m_maximumGlyphSizeInPixels(DefaultMaximumGlyphSizeInPixels)
+        , m_maximumPageCount(DefaultMaximumPageCount)
+        , m_dpi(0)
+    {
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::get_MaximumGlyphSizeInPixels(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_maximumGlyphSizeInPixels;
+            });
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::put_MaximumGlyphSizeInPixels(int32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                m_maximumGlyphSizeInPixels = value;
+            });
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::get_MaximumPageCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = m_maximumPageCount;
+            });
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::put_MaximumPageCount(int32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (value < 1)
+                    ThrowHR(E_INVALIDARG);
+
+                m_maximumPageCount = value;
+
+                if (m_pages.size() > static_cast<size_t>(value))
+                    ClearGlyphs();
+            });
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::get_PageCount(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                *value = static_cast<int32_t>(m_pages.size());
+            });
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::Clear()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                ClearGlyphs();
+            });
+    }
+
+    IFACEMETHODIMP CanvasGlyphAtlas::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+                ThrowIfFailed(m_device.CopyTo(value));
+            });
+    }
+
+    void CanvasGlyphAtlas::ClearGlyphs()
+    {
+        m_fonts.clear();
+        m_pages.clear();
+    }
+
+    static bool IsTranslation(D2D1::Matrix3x2F const& transform)
+    {
+        return transform._11 == 1 && transform._12 == 0 &&
+               transform._21 == 0 && transform._22 == 1;
+    }
+
+    void CanvasGlyphAtlas::DrawTextLayout(
+        ICanvasDevice* device,
+        ID2D1DeviceContext1* deviceContext,
+        IDWriteTextLayout* textLayout,
+        Vector2 const& point,
+        ID2D1SolidColorBrush* brush,
+        D2D1_DRAW_TEXT_OPTIONS options)
+    {
+        if (!IsSameInstance(device, m_device.Get()))
+            ThrowHR(E_INVALIDARG, Strings::GlyphAtlasWrongDevice);
+
+        auto deviceContext3 = MaybeAs<ID2D1DeviceContext3>(deviceContext);
+
+        D2D1::Matrix3x2F transform;
+        deviceContext->GetTransform(&transform);
+
+        // Glyphs are rasterized for the pixel grid, so anything that would
+        // scale or rotate them is left to DirectWrite.
+        if (!deviceContext3 || !IsTranslation(transform))
+        {
+            deviceContext->DrawTextLayout(ToD2DPoint(point), textLayout, brush, options);
+            return;
+        }
+
+        float dpiX, dpiY;
+        deviceContext->GetDpi(&dpiX, &dpiY);
+
+        // When the drawing session works in pixels, text is laid out in
+        // pixels too, so the glyphs are the same as at the default DPI.
+        auto pixelsPerUnit = (deviceContext->GetUnitMode() == D2D1_UNIT_MODE_PIXELS) ? 1.0f : dpiX / DEFAULT_DPI;
+        auto dpi = pixelsPerUnit * DEFAULT_DPI;
+
+        if (dpi != m_dpi)
+        {
+            ClearGlyphs();
+            m_dpi = dpi;
+        }
+
+        auto spriteBatch = Make<CanvasSpriteBatch>(
+            deviceContext3,
+            CanvasSpriteSortMode::Bitmap,
+            D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+            D2D1_SPRITE_OPTIONS_NONE);
+        CheckMakeResult(spriteBatch);
+
+        GlyphRasterizer rasterizer(m_device.Get(), dpi);
+
+        auto renderer = Make<GlyphAtlasTextRenderer>(
+            this,
+            rasterizer,
+            spriteBatch.Get(),
+            deviceContext,
+            brush,
+            options,
+            transform,
+            pixelsPerUnit);
+        CheckMakeResult(renderer);
+
+        ThrowIfFailed(textLayout->Draw(nullptr, renderer.Get(), point.X, point.Y));
+
+        // The pages must be finished before the drawing session reads them.
+        rasterizer.Flush();
+
+        // Sprite positions already include the translation.
+        auto identity = D2D1::Matrix3x2F::Identity();
+        deviceContext->SetTransform(&identity);
+
+        auto restoreTransform = MakeScopeWarden([&] { deviceContext->SetTransform(&transform); });
+
+        ThrowIfFailed(spriteBatch->Close());
+    }
+
+    bool CanvasGlyphAtlas::TryAddGlyphRun(
+        GlyphRasterizer& rasterizer,
+        CanvasSpriteBatch* spriteBatch,
+        float x,
+        float y,
+        float pixelsPerUnit,
+        DWRITE_MEASURING_MODE measuringMode,
+        DWRITE_GLYPH_RUN const* glyphRun,
+        D2D1_DRAW_TEXT_OPTIONS options,
+        Vector4 const& tint)
+    {
+        if (glyphRun->isSideways || !glyphRun->glyphAdvances)
+            return false;
+
+        if (glyphRun->fontEmSize * pixelsPerUnit > m_maximumGlyphSizeInPixels)
+            return false;
+
+        if (options & D2D1_DRAW_TEXT_OPTIONS_ENABLE_COLOR_FONT)
+        {
+            auto fontFace2 = MaybeAs<IDWriteFontFace2>(glyphRun->fontFace);
+
+            if (fontFace2 && fontFace2->IsColorFont())
+                return false;
+        }
+
+        FontKey fontKey(glyphRun->fontFace, glyphRun->fontEmSize, measuringMode);
+
+        bool isRightToLeft = (glyphRun->bidiLevel & 1) != 0;
+
+        //
+        // Every glyph is looked up, and rasterized if need be, before any
+        // sprites are added, so a run that turns out to need DirectWrite
+        // isn't drawn twice.
+        //
+
+        std::vector<std::pair<GlyphPlacement, CachedGlyph>> glyphs;
+        glyphs.reserve(glyphRun->glyphCount);
+
+        float advance = 0;
+
+        for (uint32_t i = 0; i < glyphRun->glyphCount; i++)
+        {
+            auto glyphAdvance = glyphRun->glyphAdvances[i] * pixelsPerUnit;
+
+            float glyphX, glyphY;
+
+            if (isRightToLeft)
+            {
+                // Right to left runs go leftwards from their origin.
+                advance += glyphAdvance;
+                glyphX = x - advance;
+            }
+            else
+            {
+                glyphX = x + advance;
+                advance += glyphAdvance;
+            }
+
+            glyphY = y;
+
+            if (glyphRun->glyphOffsets)
+            {
+                auto& offset = glyphRun->glyphOffsets[i];
+
+                glyphX += (isRightToLeft ? -offset.advanceOffset : offset.advanceOffset) * pixelsPerUnit;
+                glyphY -= offset.ascenderOffset * pixelsPerUnit;
+            }
+
+            auto placement = GetGlyphPlacement(glyphX, glyphY);
+
+            CachedGlyph glyph;
+
+            if (!TryGetGlyph(rasterizer, fontKey, glyphRun->fontFace, glyphRun->glyphIndices[i], placement.SubpixelBin, &glyph))
+                return false;
+
+            if (glyph.Bitmap)
+                glyphs.emplace_back(placement, std::move(glyph));
+        }
+
+        for (auto& entry : glyphs)
+        {
+            auto& placement = entry.first;
+            auto& glyph = entry.second;
+
+            auto left = static_cast<float>(placement.X + glyph.Left);
+            auto top = static_cast<float>(placement.Y + glyph.Top);
+            auto width = static_cast<float>(glyph.SourceRect.right - glyph.SourceRect.left);
+            auto height = static_cast<float>(glyph.SourceRect.bottom - glyph.SourceRect.top);
+
+            auto destinationRect = D2D1::RectF(
+                left / pixelsPerUnit,
+                top / pixelsPerUnit,
+                (left + width) / pixelsPerUnit,
+                (top + height) / pixelsPerUnit);
+
+            spriteBatch->AddSprite(As<ID2D1Bitmap>(glyph.Bitmap), destinationRect, glyph.SourceRect, tint);
+        }
+
+        return true;
+    }
+
+    bool CanvasGlyphAtlas::TryGetGlyph(
+        GlyphRasterizer& rasterizer,
+        FontKey const& fontKey,
+        IDWriteFontFace* fontFace,
+        uint16_t glyphIndex,
+        int subpixelBin,
+        CachedGlyph* glyph)
+    {
+        uint32_t glyphKey = (static_cast<uint32_t>(glyphIndex) << 8) | static_cast<uint32_t>(subpixelBin);
+
+        auto font = m_fonts.find(fontKey);
+
+        if (font != m_fonts.end())
+        {
+            auto cachedGlyph = font->second.Glyphs.find(glyphKey);
+
+            if (cachedGlyph != font->second.Glyphs.end())
+            {
+                *glyph = cachedGlyph->second;
+                return true;
+            }
+        }
+
+        //
+        // Work out which pixels the glyph covers when its origin is at the
+        // given subpixel position, padded by a pixel for antialiasing.
+        //
+
+        auto fontEmSize = std::get<1>(fontKey);
+        auto measuringMode = std::get<2>(fontKey);
+
+        float glyphAdvance = 0;
+
+        DWRITE_GLYPH_RUN glyphRun{};
+        glyphRun.fontFace = fontFace;
+        glyphRun.fontEmSize = fontEmSize;
+        glyphRun.glyphCount = 1;
+        glyphRun.glyphIndices = &glyphIndex;
+        glyphRun.glyphAdvances = &glyphAdvance;
+
+        auto pixelsPerDip = m_dpi / DEFAULT_DPI;
+        auto subpixelOffset = static_cast<float>(subpixelBin) / GlyphSubpixelBins;
+
+        D2D1_RECT_F bounds;
+        ThrowIfFailed(rasterizer.GetDeviceContext()->GetGlyphRunWorldBounds(
+            D2D1::Point2F(subpixelOffset / pixelsPerDip, 0),
+            &glyphRun,
+            measuringMode,
+            &bounds));
+
+        CachedGlyph newGlyph{};
+
+        if (bounds.right > bounds.left && bounds.bottom > bounds.top)
+        {
+            auto left = static_cast<int>(floor(bounds.left * pixelsPerDip)) - 1;
+            auto top = static_cast<int>(floor(bounds.top * pixelsPerDip)) - 1;
+            auto right = static_cast<int>(ceil(bounds.right * pixelsPerDip)) + 1;
+            auto bottom = static_cast<int>(ceil(bounds.bottom * pixelsPerDip)) + 1;
+
+            auto width = static_cast<uint32_t>(right - left);
+            auto height = static_cast<uint32_t>(bottom - top);
+
+            D2D1_POINT_2U position;
+
+            if (!TryAllocate(rasterizer, width, height, &newGlyph.Bitmap, &position))
+                return false;
+
+            newGlyph.SourceRect = D2D1_RECT_U{ position.x, position.y, position.x + width, position.y + height };
+            newGlyph.Left = left;
+            newGlyph.Top = top;
+
+            auto origin = D2D1::Point2F(
+                (position.x - left + subpixelOffset) / pixelsPerDip,
+                (position.y - top) / pixelsPerDip);
+
+            rasterizer.DrawGlyph(newGlyph.Bitmap.Get(), origin, &glyphRun, measuringMode);
+        }
+
+        // Allocating may have thrown every font away, so look this one up again.
+        auto& cachedFont = m_fonts[fontKey];
+
+        if (!cachedFont.FontFace)
+            cachedFont.FontFace = fontFace;
+
+        cachedFont.Glyphs[glyphKey] = newGlyph;
+
+        *glyph = newGlyph;
+        return true;
+    }
+
+    bool CanvasGlyphAtlas::TryAllocate(
+        GlyphRasterizer& rasterizer,
+        uint32_t width,
+        uint32_t height,
+        ComPtr<ID2D1Bitmap1>* pageBitmap,
+        D2D1_POINT_2U* position)
+    {
+        if (width > PageSizeInPixels || height > PageSizeInPixels)
+            return false;
+
+        // Only the newest page has room left.
+        if (!m_pages.empty() && m_pages.back().Packer.TryAllocate(width, height, position))
+        {
+            *pageBitmap = m_pages.back().Bitmap;
+            return true;
+        }
+
+        // Sprites already added keep the pages they use alive, so every page
+        // can be thrown away even partway through drawing some text.
+        if (m_pages.size() >= static_cast<size_t>(m_maximumPageCount))
+            ClearGlyphs();
+
+        m_pages.push_back(Page{ rasterizer.CreatePage(), GlyphAtlasPacker(PageSizeInPixels) });
+
+        auto allocated = m_pages.back().Packer.TryAllocate(width, height, position);
+        assert(allocated);
+        UNREFERENCED_PARAMETER(allocated);
+
+        *pageBitmap = m_pages.back().Bitmap;
+        return true;
+    }
+}}}}}
+
+ActivatableClassWithFactory(CanvasGlyphAtlas, CanvasGlyphAtlasFactory);
+
+#endif
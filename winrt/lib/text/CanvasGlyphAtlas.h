@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    class CanvasSpriteBatch;
+}}}}
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    class CanvasGlyphAtlasFactory
+        : public AgileActivationFactory<ICanvasGlyphAtlasFactory>
+        , private LifespanTracker<CanvasGlyphAtlasFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasGlyphAtlas, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasGlyphAtlas** glyphAtlas) override;
+    };
+
+
+    // Glyphs are rasterized at this many horizontal positions between two
+    // pixels, so text keeps its subpixel spacing without blurring.
+    static const int GlyphSubpixelBins = 4;
+
+    // Where a glyph whose origin lands at (x, y), in pixels, is drawn: the
+    // pixel to the left of the origin, and which of the subpixel positions
+    // to the right of that pixel the glyph was rasterized for.
+    struct GlyphPlacement
+    {
+        int X;
+        int Y;
+        int SubpixelBin;
+    };
+
+    GlyphPlacement GetGlyphPlacement(float x, float y);
+
+
+    // Hands out rectangles from an atlas page a row at a time, starting a
+    // new row when the current one is full.  Glyphs of one font are all
+    // about the same height, so little space is wasted.
+    class GlyphAtlasPacker
+    {
+        uint32_t m_size;
+        uint32_t m_x;
+        uint32_t m_y;
+        uint32_t m_rowHeight;
+
+    public:
+        explicit GlyphAtlasPacker(uint32_t size);
+
+        bool TryAllocate(uint32_t width, uint32_t height, D2D1_POINT_2U* position);
+    };
+
+
+    class GlyphRasterizer;
+
+
+    //
+    // Drawing huge amounts of small text, as terminals, log viewers and
+    // spreadsheets do, spends most of its time in DirectWrite rasterizing
+    // the same few glyphs over and over.  This rasterizes each glyph once,
+    // in grayscale, into atlas pages, and then draws text as sprites from
+    // those pages, tinted with the text color.
+    //
+    // Glyphs are keyed by font face, font size, measuring mode and subpixel
+    // position, and are rasterized for one DPI: drawing at a different DPI
+    // throws everything away.  Once MaximumPageCount pages are full, all of
+    // them are thrown away and glyphs are rasterized again as needed.
+    //
+    // Anything the atlas can't draw as a tinted sprite is drawn through
+    // DirectWrite as usual: text larger than MaximumGlyphSizeInPixels,
+    // color fonts, sideways text, brushes other than solid colors, and
+    // drawing under a transform that does more than translate.
+    //
+    class CanvasGlyphAtlas
+        : public RuntimeClass<
+            ICanvasGlyphAtlas,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasGlyphAtlas>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasGlyphAtlas, BaseTrust);
+
+        struct Page
+        {
+            ComPtr<ID2D1Bitmap1> Bitmap;
+            GlyphAtlasPacker Packer;
+        };
+
+        struct CachedGlyph
+        {
+            // Null for glyphs with nothing to draw, such as spaces.
+            ComPtr<ID2D1Bitmap1> Bitmap;
+            D2D1_RECT_U SourceRect;
+
+            // From the pixel the glyph is placed at to the top left of SourceRect.
+            int Left;
+            int Top;
+        };
+
+        typedef std::tuple<IDWriteFontFace*, float, DWRITE_MEASURING_MODE> FontKey;
+
+        struct CachedFont
+        {
+            ComPtr<IDWriteFontFace> FontFace;
+            std::unordered_map<uint32_t, CachedGlyph> Glyphs;
+        };
+
+        ComPtr<ICanvasDevice> m_device;
+
+        int32_t m_maximumGlyphSizeInPixels;
+        int32_t m_maximumPageCount;
+
+        float m_dpi;
+        std::vector<Page> m_pages;
+        std::map<FontKey, CachedFont> m_fonts;
+
+    public:
+        static const int32_t DefaultMaximumGlyphSizeInPixels = 64;
+        static const int32_t DefaultMaximumPageCount = 4;
+        static const uint32_t PageSizeInPixels = 1024;
+
+        CanvasGlyphAtlas(ICanvasDevice* device);
+
+        IFACEMETHOD(get_MaximumGlyphSizeInPixels)(int32_t* value) override;
+        IFACEMETHOD(put_MaximumGlyphSizeInPixels)(int32_t value) override;
+
+        IFACEMETHOD(get_MaximumPageCount)(int32_t* value) override;
+        IFACEMETHOD(put_MaximumPageCount)(int32_t value) override;
+
+        IFACEMETHOD(get_PageCount)(int32_t* value) override;
+
+        IFACEMETHOD(Clear)() override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+        // Draws a text layout through the atlas, using brush for anything that
+        // has no brush of its own.
+        void DrawTextLayout(
+            ICanvasDevice* device,
+            ID2D1DeviceContext1* deviceContext,
+            IDWriteTextLayout* textLayout,
+            Vector2 const& point,
+            ID2D1SolidColorBrush* brush,
+            D2D1_DRAW_TEXT_OPTIONS options);
+
+        // Adds sprites for a glyph run whose baseline starts at (x, y), in
+        // pixels.  Returns false, having added nothing, if the run must be
+        // drawn through DirectWrite instead.
+        bool TryAddGlyphRun(
+            GlyphRasterizer& rasterizer,
+            CanvasSpriteBatch* spriteBatch,
+            float x,
+            float y,
+            float pixelsPerUnit,
+            DWRITE_MEASURING_MODE measuringMode,
+            DWRITE_GLYPH_RUN const* glyphRun,
+            D2D1_DRAW_TEXT_OPTIONS options,
+            Vector4 const& tint);
+
+    private:
+        void ClearGlyphs();
+
+        bool TryGetGlyph(
+            GlyphRasterizer& rasterizer,
+            FontKey const& fontKey,
+            IDWriteFontFace* fontFace,
+            uint16_t glyphIndex,
+            int subpixelBin,
+            CachedGlyph* glyph);
+
+        bool TryAllocate(
+            GlyphRasterizer& rasterizer,
+            uint32_t width,
+            uint32_t height,
+            ComPtr<ID2D1Bitmap1>* pageBitmap,
+            D2D1_POINT_2U* position);
+    };
+}}}}}
+
+#endif
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasGlyphRun.h"
+#include "CanvasFontFace.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+using namespace ABI::Microsoft::Graphics::Canvas::Text;
+
+IFACEMETHODIMP CanvasGlyphRunFactory::Create(
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    uint32_t glyphCount,
+    CanvasGlyph* glyphs,
+    boolean isSideways,
+    uint32_t bidiLevel,
+    ICanvasGlyphRun** glyphRun)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(fontFace);
+            if (glyphCount > 0)
+                CheckInPointer(glyphs);
+            CheckAndClearOutPointer(glyphRun);
+
+            auto newGlyphRun = CanvasGlyphRun::CreateNew(fontFace, fontSize, glyphCount, glyphs, isSideways, bidiLevel);
+
+            ThrowIfFailed(newGlyphRun.CopyTo(glyphRun));
+        });
+}
+
+
+ComPtr<CanvasGlyphRun> CanvasGlyphRun::CreateNew(
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    uint32_t glyphCount,
+    CanvasGlyph* glyphs,
+    boolean isSideways,
+    uint32_t bidiLevel)
+{
+    std::vector<uint16_t> glyphIndices;
+    std::vector<float> glyphAdvances;
+    std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
+
+    glyphIndices.reserve(glyphCount);
+    glyphAdvances.reserve(glyphCount);
+    glyphOffsets.reserve(glyphCount);
+
+    for (uint32_t i = 0; i < glyphCount; ++i)
+    {
+        glyphIndices.push_back(CheckCastAsUShort(glyphs[i].Index));
+        glyphAdvances.push_back(glyphs[i].Advance);
+
+        DWRITE_GLYPH_OFFSET offset;
+        offset.advanceOffset = glyphs[i].AdvanceOffset;
+        offset.ascenderOffset = glyphs[i].AscenderOffset;
+        glyphOffsets.push_back(offset);
+    }
+
+    auto glyphRun = Make<CanvasGlyphRun>(
+        fontFace,
+        fontSize,
+        std::move(glyphIndices),
+        std::move(glyphAdvances),
+        std::move(glyphOffsets),
+        isSideways,
+        bidiLevel);
+    CheckMakeResult(glyphRun);
+
+    return glyphRun;
+}
+
+
+CanvasGlyphRun::CanvasGlyphRun(
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    std::vector<uint16_t>&& glyphIndices,
+    std::vector<float>&& glyphAdvances,
+    std::vector<DWRITE_GLYPH_OFFSET>&& glyphOffsets,
+    boolean isSideways,
+    uint32_t bidiLevel)
+    : m_fontFace(fontFace)
+    , m_dwriteFontFace(As<ICanvasFontFaceInternal>(fontFace)->GetRealizedFontFace())
+    , m_glyphIndices(std::move(glyphIndices))
+    , m_glyphAdvances(std::move(glyphAdvances))
+    , m_glyphOffsets(std::move(glyphOffsets))
+    , m_dwriteGlyphRun{}
+{
+    assert(m_glyphAdvances.size() == m_glyphIndices.size());
+    assert(m_glyphOffsets.size() == m_glyphIndices.size());
+
+    m_dwriteGlyphRun.fontFace = m_dwriteFontFace.Get();
+    m_dwriteGlyphRun.fontEmSize = fontSize;
+    m_dwriteGlyphRun.glyphCount = static_cast<uint32_t>(m_glyphIndices.size());
+    m_dwriteGlyphRun.glyphIndices = m_glyphIndices.data();
+    m_dwriteGlyphRun.glyphAdvances = m_glyphAdvances.data();
+    m_dwriteGlyphRun.glyphOffsets = m_glyphOffsets.data();
+    m_dwriteGlyphRun.isSideways = isSideways;
+    m_dwriteGlyphRun.bidiLevel = bidiLevel;
+}
+
+
+IFACEMETHODIMP CanvasGlyphRun::get_FontFace(ICanvasFontFace** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_fontFace.CopyTo(value));
+        });
+}
+
+
+IFACEMETHODIMP CanvasGlyphRun::get_FontSize(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_dwriteGlyphRun.fontEmSize;
+        });
+}
+
+
+IFACEMETHODIMP CanvasGlyphRun::get_IsSideways(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = !!m_dwriteGlyphRun.isSideways;
+        });
+}
+
+
+IFACEMETHODIMP CanvasGlyphRun::get_BidiLevel(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_dwriteGlyphRun.bidiLevel;
+        });
+}
+
+
+IFACEMETHODIMP CanvasGlyphRun::get_GlyphCount(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_dwriteGlyphRun.glyphCount;
+        });
+}
+
+
+IFACEMETHODIMP CanvasGlyphRun::GetGlyphs(
+    uint32_t* valueCount,
+    CanvasGlyph** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            ComArray<CanvasGlyph> glyphs(m_dwriteGlyphRun.glyphCount);
+
+            for (uint32_t i = 0; i < m_dwriteGlyphRun.glyphCount; ++i)
+            {
+                glyphs[i].Index = m_glyphIndices[i];
+                glyphs[i].Advance = m_glyphAdvances[i];
+                glyphs[i].AdvanceOffset = m_glyphOffsets[i].advanceOffset;
+                glyphs[i].AscenderOffset = m_glyphOffsets[i].ascenderOffset;
+            }
+
+            glyphs.Detach(valueCount, valueElements);
+        });
+}
+
+
+DWRITE_GLYPH_RUN const& CanvasGlyphRun::GetDWriteGlyphRun()
+{
+    return m_dwriteGlyphRun;
+}
+
+
+ActivatableClassWithFactory(CanvasGlyphRun, CanvasGlyphRunFactory);
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    class __declspec(uuid("FE79E503-DEB2-462B-9906-B807EE7DAB96"))
+    ICanvasGlyphRunInternal : public IUnknown
+    {
+    public:
+        // Points into arrays owned by the glyph run, so is only valid while
+        // it is alive.
+        virtual DWRITE_GLYPH_RUN const& GetDWriteGlyphRun() = 0;
+    };
+
+
+    //
+    // CanvasGlyphRun keeps a shaped glyph run in the form DirectWrite takes
+    // it, so drawing it again doesn't need to convert a CanvasGlyph array
+    // each time.  It never changes after it is created, so it can be drawn
+    // from multiple threads without locking.
+    //
+    class CanvasGlyphRun : public RuntimeClass<
+        ICanvasGlyphRun,
+        CloakedIid<ICanvasGlyphRunInternal>>,
+        private LifespanTracker<CanvasGlyphRun>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasGlyphRun, BaseTrust);
+
+        ComPtr<ICanvasFontFace> m_fontFace;
+        ComPtr<IDWriteFontFace> m_dwriteFontFace;
+        std::vector<uint16_t> m_glyphIndices;
+        std::vector<float> m_glyphAdvances;
+        std::vector<DWRITE_GLYPH_OFFSET> m_glyphOffsets;
+        DWRITE_GLYPH_RUN m_dwriteGlyphRun;
+
+    public:
+        static ComPtr<CanvasGlyphRun> CreateNew(
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            uint32_t glyphCount,
+            CanvasGlyph* glyphs,
+            boolean isSideways,
+            uint32_t bidiLevel);
+
+        CanvasGlyphRun(
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            std::vector<uint16_t>&& glyphIndices,
+            std::vector<float>&& glyphAdvances,
+            std::vector<DWRITE_GLYPH_OFFSET>&& glyphOffsets,
+            boolean isSideways,
+            uint32_t bidiLevel);
+
+        IFACEMETHOD(get_FontFace)(ICanvasFontFace** value) override;
+        IFACEMETHOD(get_FontSize)(float* value) override;
+        IFACEMETHOD(get_IsSideways)(boolean* value) override;
+        IFACEMETHOD(get_BidiLevel)(uint32_t* value) override;
+        IFACEMETHOD(get_GlyphCount)(uint32_t* value) override;
+
+        IFACEMETHOD(GetGlyphs)(
+            uint32_t* valueCount,
+            CanvasGlyph** valueElements) override;
+
+        // ICanvasGlyphRunInternal
+
+        virtual DWRITE_GLYPH_RUN const& GetDWriteGlyphRun() override;
+    };
+
+
+    //
+    // CanvasGlyphRunFactory
+    //
+
+    class CanvasGlyphRunFactory
+        : public AgileActivationFactory<ICanvasGlyphRunFactory>
+        , private LifespanTracker<CanvasGlyphRunFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasGlyphRun, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            uint32_t glyphCount,
+            CanvasGlyph* glyphs,
+            boolean isSideways,
+            uint32_t bidiLevel,
+            ICanvasGlyphRun** glyphRun) override;
+    };
+
+}}}}}
@@ -9,6 +9,11 @@
 using namespace ABI::Microsoft::Graphics::Canvas;
 using namespace ABI::Microsoft::Graphics::Canvas::Text;
 
+CanvasNumberSubstitutionFactory::CanvasNumberSubstitutionFactory()
+    : m_customFontManager(CustomFontManager::GetInstance())
+{
+}
+
 IFACEMETHODIMP CanvasNumberSubstitutionFactory::Create(
     CanvasNumberSubstitutionMethod method,
     ICanvasNumberSubstitution** numberSubstitution)
@@ -27,21 +32,16 @@ IFACEMETHODIMP CanvasNumberSubstitutionFactory::CreateWithLocaleAndIgnoreOverrid
         {
             CheckAndClearOutPointer(numberSubstitution);
 
-            auto customFontManager = CustomFontManager::GetInstance();
-            auto dwriteFactory = customFontManager->GetSharedFactory();
-
-            ComPtr<IDWriteNumberSubstitution> dwriteNumberSubstitution;
-
-            ThrowIfFailed(dwriteFactory->CreateNumberSubstitution(
+            // Number substitutions are immutable, so equal ones share both
+            // the DirectWrite object and, while it is alive, its wrapper.
+            auto dwriteNumberSubstitution = m_customFontManager->GetInternedNumberSubstitution(
                 ToDWriteNumberSubstitution(method),
                 WindowsGetStringRawBuffer(localeName, nullptr),
-                ignoreOverrides,
-                &dwriteNumberSubstitution));
+                !!ignoreOverrides);
 
-            auto newNumberSubstitution = Make<CanvasNumberSubstitution>(dwriteNumberSubstitution.Get());
-            CheckMakeResult(newNumberSubstitution);
+            auto canvasNumberSubstitution = ResourceManager::GetOrCreate<ICanvasNumberSubstitution>(dwriteNumberSubstitution.Get());
 
-            ThrowIfFailed(newNumberSubstitution.CopyTo(numberSubstitution));
+            ThrowIfFailed(canvasNumberSubstitution.CopyTo(numberSubstitution));
         });
 }
 
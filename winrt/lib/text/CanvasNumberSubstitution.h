@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "CustomFontManager.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
 {
     class CanvasNumberSubstitution : RESOURCE_WRAPPER_RUNTIME_CLASS(
@@ -28,7 +30,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasNumberSubstitution, BaseTrust);
 
+        std::shared_ptr<CustomFontManager> m_customFontManager;
+
     public:
+        CanvasNumberSubstitutionFactory();
 
         IFACEMETHOD(Create)(
             CanvasNumberSubstitutionMethod method,
@@ -0,0 +1,577 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasSegmentedTextLayout.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+using namespace ABI::Microsoft::Graphics::Canvas::Text;
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayoutFactory::Create(
+    ICanvasResourceCreator* resourceCreator,
+    HSTRING textString,
+    ICanvasTextFormat* textFormat,
+    float requestedWidth,
+    ICanvasSegmentedTextLayout** layout)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(textFormat);
+            CheckAndClearOutPointer(layout);
+
+            As<ICanvasTextFormatInternal>(textFormat)->ThrowIfClosed();
+
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(resourceCreator->get_Device(&device));
+
+            uint32_t textLength;
+            auto textBuffer = WindowsGetStringRawBuffer(textString, &textLength);
+
+            auto newLayout = Make<CanvasSegmentedTextLayout>(
+                device.Get(),
+                textFormat,
+                std::wstring(textBuffer, textLength),
+                requestedWidth);
+            CheckMakeResult(newLayout);
+
+            ThrowIfFailed(newLayout.CopyTo(layout));
+        });
+}
+
+
+CanvasSegmentedTextLayout::CanvasSegmentedTextLayout(
+    ICanvasDevice* device,
+    ICanvasTextFormat* textFormat,
+    std::wstring&& text,
+    float requestedWidth)
+    : m_device(device)
+    , m_textFormat(textFormat)
+    , m_text(std::move(text))
+    , m_requestedWidth(requestedWidth)
+    , m_paragraphTopsValid(false)
+{
+    SplitParagraphs(m_text, 0, static_cast<uint32_t>(m_text.size()), &m_paragraphs);
+}
+
+
+void CanvasSegmentedTextLayout::SplitParagraphs(
+    std::wstring const& text,
+    uint32_t begin,
+    uint32_t end,
+    std::vector<Paragraph>* paragraphs)
+{
+    uint32_t paragraphStart = begin;
+    uint32_t i = begin;
+
+    while (i < end)
+    {
+        uint32_t newlineLength = 0;
+
+        switch (text[i])
+        {
+        case L'\r':
+            newlineLength = (i + 1 < end && text[i + 1] == L'\n') ? 2 : 1;
+            break;
+
+        case L'\n':
+        case 0x0085:    // Next line
+        case 0x2029:    // Paragraph separator
+            newlineLength = 1;
+            break;
+        }
+
+        if (newlineLength)
+        {
+            paragraphs->push_back(Paragraph{ paragraphStart, i - paragraphStart, newlineLength, nullptr, 0.0f });
+            i += newlineLength;
+            paragraphStart = i;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if (paragraphStart < end || end == text.size())
+    {
+        paragraphs->push_back(Paragraph{ paragraphStart, end - paragraphStart, 0, nullptr, 0.0f });
+    }
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::get_Text(HSTRING* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            Lock lock(m_mutex);
+
+            WinString(m_text.data(), m_text.data() + m_text.size()).CopyTo(value);
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::get_RequestedWidth(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            *value = m_requestedWidth;
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::put_RequestedWidth(float value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Lock lock(m_mutex);
+
+            if (value == m_requestedWidth)
+                return;
+
+            m_requestedWidth = value;
+
+            for (auto& paragraph : m_paragraphs)
+            {
+                paragraph.Layout.Reset();
+            }
+
+            m_paragraphTopsValid = false;
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::get_ParagraphCount(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            *value = static_cast<uint32_t>(m_paragraphs.size());
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::get_LayoutHeight(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            Lock lock(m_mutex);
+
+            EnsureParagraphTops(lock);
+
+            *value = m_paragraphTops.back();
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::ReplaceText(
+    int32_t characterIndex,
+    int32_t characterCount,
+    HSTRING text)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            ThrowIfNegative(characterIndex);
+            ThrowIfNegative(characterCount);
+
+            Lock lock(m_mutex);
+
+            auto index = static_cast<uint32_t>(characterIndex);
+            auto count = static_cast<uint32_t>(characterCount);
+            auto textSize = static_cast<uint32_t>(m_text.size());
+
+            if (index > textSize || count > textSize - index)
+                ThrowHR(E_INVALIDARG);
+
+            uint32_t newLength;
+            auto newText = WindowsGetStringRawBuffer(text, &newLength);
+
+            //
+            // Every paragraph from the one holding the first replaced
+            // character, up to the one holding the character after the last
+            // replaced one, is split up again.  Text after that is untouched,
+            // and still follows a newline, so the new paragraphs end exactly
+            // where the old ones did.
+            //
+            auto first = FindParagraph(lock, index);
+            auto last = FindParagraph(lock, index + count);
+
+            auto regionStart = m_paragraphs[first].Start;
+            auto regionEnd = m_paragraphs[last].End() - count + newLength;
+
+            m_text.replace(index, count, newText, newLength);
+
+            // A lone CR before the edited text becomes half of a CRLF if the
+            // text now starts with a LF.
+            if (first > 0 && m_text[regionStart - 1] == L'\r' && regionStart < m_text.size() && m_text[regionStart] == L'\n')
+            {
+                first--;
+                regionStart = m_paragraphs[first].Start;
+            }
+
+            std::vector<Paragraph> newParagraphs;
+            SplitParagraphs(m_text, regionStart, regionEnd, &newParagraphs);
+
+            auto it = m_paragraphs.erase(m_paragraphs.begin() + first, m_paragraphs.begin() + last + 1);
+            it = m_paragraphs.insert(it, std::make_move_iterator(newParagraphs.begin()), std::make_move_iterator(newParagraphs.end()));
+
+            for (it += newParagraphs.size(); it != m_paragraphs.end(); ++it)
+            {
+                it->Start = it->Start - count + newLength;
+            }
+
+            m_paragraphTopsValid = false;
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::GetParagraphLayout(
+    uint32_t paragraphIndex,
+    ICanvasTextLayout** layout)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(layout);
+
+            Lock lock(m_mutex);
+
+            ThrowIfOutOfRange(lock, paragraphIndex);
+
+            ThrowIfFailed(GetLayout(lock, paragraphIndex).CopyTo(layout));
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::GetParagraphCharacterIndex(
+    uint32_t paragraphIndex,
+    int32_t* characterIndex)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(characterIndex);
+
+            Lock lock(m_mutex);
+
+            ThrowIfOutOfRange(lock, paragraphIndex);
+
+            *characterIndex = static_cast<int32_t>(m_paragraphs[paragraphIndex].Start);
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::GetParagraphTop(
+    uint32_t paragraphIndex,
+    float* top)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(top);
+
+            Lock lock(m_mutex);
+
+            ThrowIfOutOfRange(lock, paragraphIndex);
+            EnsureParagraphTops(lock);
+
+            *top = m_paragraphTops[paragraphIndex];
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::GetParagraphIndexAtCharacter(
+    int32_t characterIndex,
+    uint32_t* paragraphIndex)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(paragraphIndex);
+            ThrowIfNegative(characterIndex);
+
+            Lock lock(m_mutex);
+
+            *paragraphIndex = FindParagraph(lock, static_cast<uint32_t>(characterIndex));
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::get_LineMetrics(
+    uint32_t* valueCount,
+    CanvasLineMetrics** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            Lock lock(m_mutex);
+
+            std::vector<CanvasLineMetrics> lineMetrics;
+
+            for (uint32_t i = 0; i < m_paragraphs.size(); i++)
+            {
+                ComArray<CanvasLineMetrics> paragraphMetrics;
+                ThrowIfFailed(GetLayout(lock, i)->get_LineMetrics(paragraphMetrics.GetAddressOfSize(), paragraphMetrics.GetAddressOfData()));
+
+                if (paragraphMetrics.GetSize() == 0)
+                    continue;
+
+                lineMetrics.insert(lineMetrics.end(), begin(paragraphMetrics), end(paragraphMetrics));
+
+                // The newline was left out of the paragraph's layout, so add
+                // it back to the end of its last line.
+                auto newlineLength = static_cast<int>(m_paragraphs[i].NewlineLength);
+                auto& lastLine = lineMetrics.back();
+                lastLine.CharacterCount += newlineLength;
+                lastLine.TrailingWhitespaceCount += newlineLength;
+                lastLine.TerminalNewlineCount += newlineLength;
+            }
+
+            ComArray<CanvasLineMetrics> returnedMetrics(lineMetrics.begin(), lineMetrics.end());
+            returnedMetrics.Detach(valueCount, valueElements);
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::HitTest(
+    Vector2 point,
+    CanvasTextLayoutRegion* textLayoutRegion,
+    boolean* trailingSideOfCharacter,
+    boolean* isHit)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(textLayoutRegion);
+            CheckInPointer(trailingSideOfCharacter);
+            CheckInPointer(isHit);
+
+            Lock lock(m_mutex);
+
+            EnsureParagraphTops(lock);
+
+            // The last paragraph starting at or above the point.  Points
+            // above or below the document go to the first or last paragraph.
+            auto paragraphCount = m_paragraphs.size();
+            auto nextTop = std::upper_bound(m_paragraphTops.begin(), m_paragraphTops.begin() + paragraphCount, point.Y);
+            auto paragraphIndex = static_cast<uint32_t>(std::max<ptrdiff_t>(nextTop - m_paragraphTops.begin() - 1, 0));
+
+            auto top = m_paragraphTops[paragraphIndex];
+
+            ThrowIfFailed(GetLayout(lock, paragraphIndex)->HitTestWithDescriptionAndCoordsAndTrailingSide(
+                point.X,
+                point.Y - top,
+                textLayoutRegion,
+                trailingSideOfCharacter,
+                isHit));
+
+            textLayoutRegion->CharacterIndex += static_cast<int>(m_paragraphs[paragraphIndex].Start);
+            textLayoutRegion->LayoutBounds.Y += top;
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::GetCaretPosition(
+    int32_t characterIndex,
+    boolean trailingSideOfCharacter,
+    Vector2* location)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(location);
+            ThrowIfNegative(characterIndex);
+
+            Lock lock(m_mutex);
+
+            EnsureParagraphTops(lock);
+
+            auto paragraphIndex = FindParagraph(lock, static_cast<uint32_t>(characterIndex));
+            auto& paragraph = m_paragraphs[paragraphIndex];
+
+            auto localIndex = static_cast<uint32_t>(characterIndex) - paragraph.Start;
+
+            // A caret on the newline, or past the end of the document, goes
+            // at the end of the paragraph's text.
+            if (localIndex >= paragraph.Length)
+            {
+                localIndex = paragraph.Length;
+                trailingSideOfCharacter = false;
+            }
+
+            ThrowIfFailed(GetLayout(lock, paragraphIndex)->GetCaretPosition(
+                static_cast<int32_t>(localIndex),
+                trailingSideOfCharacter,
+                location));
+
+            location->Y += m_paragraphTops[paragraphIndex];
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::GetCharacterRegions(
+    int32_t characterIndex,
+    int32_t characterCount,
+    uint32_t* hitTestDescriptionCount,
+    CanvasTextLayoutRegion** hitTestDescriptions)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(hitTestDescriptionCount);
+            CheckAndClearOutPointer(hitTestDescriptions);
+            ThrowIfNegative(characterIndex);
+            ThrowIfNegative(characterCount);
+
+            Lock lock(m_mutex);
+
+            EnsureParagraphTops(lock);
+
+            auto rangeStart = static_cast<uint32_t>(characterIndex);
+            auto rangeEnd = rangeStart + static_cast<uint32_t>(characterCount);
+
+            std::vector<CanvasTextLayoutRegion> regions;
+
+            for (auto i = FindParagraph(lock, rangeStart); i < m_paragraphs.size() && m_paragraphs[i].Start < rangeEnd; i++)
+            {
+                auto& paragraph = m_paragraphs[i];
+
+                auto localStart = std::max(rangeStart, paragraph.Start) - paragraph.Start;
+                auto localEnd = std::min(rangeEnd, paragraph.Start + paragraph.Length) - paragraph.Start;
+
+                // Nothing but the newline, which has no region of its own.
+                if (localStart >= localEnd)
+                    continue;
+
+                ComArray<CanvasTextLayoutRegion> paragraphRegions;
+                ThrowIfFailed(GetLayout(lock, i)->GetCharacterRegions(
+                    static_cast<int32_t>(localStart),
+                    static_cast<int32_t>(localEnd - localStart),
+                    paragraphRegions.GetAddressOfSize(),
+                    paragraphRegions.GetAddressOfData()));
+
+                for (auto& region : paragraphRegions)
+                {
+                    region.CharacterIndex += static_cast<int>(paragraph.Start);
+                    region.LayoutBounds.Y += m_paragraphTops[i];
+                    regions.push_back(region);
+                }
+            }
+
+            ComArray<CanvasTextLayoutRegion> returnedRegions(regions.begin(), regions.end());
+            returnedRegions.Detach(hitTestDescriptionCount, hitTestDescriptions);
+        });
+}
+
+
+IFACEMETHODIMP CanvasSegmentedTextLayout::get_Device(ICanvasDevice** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_device.CopyTo(value));
+        });
+}
+
+
+uint32_t CanvasSegmentedTextLayout::FindParagraph(Lock const& lock, uint32_t characterIndex)
+{
+    MustOwnLock(lock);
+
+    // The last paragraph starting at or before the character.
+    auto next = std::upper_bound(
+        m_paragraphs.begin(),
+        m_paragraphs.end(),
+        characterIndex,
+        [](uint32_t index, Paragraph const& paragraph) { return index < paragraph.Start; });
+
+    assert(next != m_paragraphs.begin());
+
+    return static_cast<uint32_t>(next - m_paragraphs.begin() - 1);
+}
+
+
+ComPtr<CanvasTextLayout> const& CanvasSegmentedTextLayout::GetLayout(Lock const& lock, uint32_t paragraphIndex)
+{
+    MustOwnLock(lock);
+
+    auto& paragraph = m_paragraphs[paragraphIndex];
+
+    if (!paragraph.Layout)
+    {
+        auto textBegin = m_text.data() + paragraph.Start;
+
+        paragraph.Layout = CanvasTextLayout::CreateNew(
+            this,
+            WinString(textBegin, textBegin + paragraph.Length),
+            m_textFormat.Get(),
+            m_requestedWidth,
+            0.0f);
+
+        DWRITE_TEXT_METRICS1 metrics;
+        ThrowIfFailed(paragraph.Layout->GetResource()->GetMetrics(&metrics));
+
+        paragraph.Height = metrics.height;
+        m_paragraphTopsValid = false;
+    }
+
+    return paragraph.Layout;
+}
+
+
+void CanvasSegmentedTextLayout::EnsureParagraphTops(Lock const& lock)
+{
+    MustOwnLock(lock);
+
+    if (m_paragraphTopsValid)
+        return;
+
+    m_paragraphTops.resize(m_paragraphs.size() + 1);
+    m_paragraphTops[0] = 0;
+
+    for (uint32_t i = 0; i < m_paragraphs.size(); i++)
+    {
+        GetLayout(lock, i);
+        m_paragraphTops[i + 1] = m_paragraphTops[i] + m_paragraphs[i].Height;
+    }
+
+    m_paragraphTopsValid = true;
+}
+
+
+void CanvasSegmentedTextLayout::ThrowIfOutOfRange(Lock const& lock, uint32_t paragraphIndex)
+{
+    MustOwnLock(lock);
+
+    if (paragraphIndex >= m_paragraphs.size())
+        ThrowHR(E_BOUNDS);
+}
+
+
+ActivatableClassWithFactory(CanvasSegmentedTextLayout, CanvasSegmentedTextLayoutFactory);
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "CanvasTextLayout.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    using namespace ::Microsoft::WRL;
+
+    class CanvasSegmentedTextLayoutFactory
+        : public AgileActivationFactory<ICanvasSegmentedTextLayoutFactory>
+        , private LifespanTracker<CanvasSegmentedTextLayoutFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasSegmentedTextLayout, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING textString,
+            ICanvasTextFormat* textFormat,
+            float requestedWidth,
+            ICanvasSegmentedTextLayout** layout) override;
+    };
+
+
+    //
+    // The document is split after each newline (CR, LF, CRLF, NEL or the
+    // Unicode paragraph separator), and each paragraph gets its own
+    // CanvasTextLayout of the text before its newline.  Laying out the
+    // newline as well would give every paragraph an extra empty line.
+    //
+    // ReplaceText splits just the paragraphs the edit touched again, and
+    // throws away their layouts.  Layouts, and the running total of
+    // paragraph heights, are only recomputed when something asks for them.
+    //
+    class CanvasSegmentedTextLayout
+        : public RuntimeClass<
+            ICanvasSegmentedTextLayout,
+            ICanvasResourceCreator>
+        , private LifespanTracker<CanvasSegmentedTextLayout>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasSegmentedTextLayout, BaseTrust);
+
+        struct Paragraph
+        {
+            uint32_t Start;
+            uint32_t Length;            // Excluding the newline.
+            uint32_t NewlineLength;
+            ComPtr<CanvasTextLayout> Layout;
+            float Height;
+
+            uint32_t End() const { return Start + Length + NewlineLength; }
+        };
+
+        ComPtr<ICanvasDevice> m_device;
+        ComPtr<ICanvasTextFormat> m_textFormat;
+
+        std::mutex m_mutex;
+        std::wstring m_text;
+        float m_requestedWidth;
+        std::vector<Paragraph> m_paragraphs;
+        std::vector<float> m_paragraphTops;     // One more than m_paragraphs, ending with the total height.
+        bool m_paragraphTopsValid;
+
+    public:
+        CanvasSegmentedTextLayout(
+            ICanvasDevice* device,
+            ICanvasTextFormat* textFormat,
+            std::wstring&& text,
+            float requestedWidth);
+
+        IFACEMETHOD(get_Text)(HSTRING* value) override;
+
+        IFACEMETHOD(get_RequestedWidth)(float* value) override;
+        IFACEMETHOD(put_RequestedWidth)(float value) override;
+
+        IFACEMETHOD(get_ParagraphCount)(uint32_t* value) override;
+
+        IFACEMETHOD(get_LayoutHeight)(float* value) override;
+
+        IFACEMETHOD(ReplaceText)(
+            int32_t characterIndex,
+            int32_t characterCount,
+            HSTRING text) override;
+
+        IFACEMETHOD(GetParagraphLayout)(
+            uint32_t paragraphIndex,
+            ICanvasTextLayout** layout) override;
+
+        IFACEMETHOD(GetParagraphCharacterIndex)(
+            uint32_t paragraphIndex,
+            int32_t* characterIndex) override;
+
+        IFACEMETHOD(GetParagraphTop)(
+            uint32_t paragraphIndex,
+            float* top) override;
+
+        IFACEMETHOD(GetParagraphIndexAtCharacter)(
+            int32_t characterIndex,
+            uint32_t* paragraphIndex) override;
+
+        IFACEMETHOD(get_LineMetrics)(
+            uint32_t* valueCount,
+            CanvasLineMetrics** valueElements) override;
+
+        IFACEMETHOD(HitTest)(
+            Vector2 point,
+            CanvasTextLayoutRegion* textLayoutRegion,
+            boolean* trailingSideOfCharacter,
+            boolean* isHit) override;
+
+        IFACEMETHOD(GetCaretPosition)(
+            int32_t characterIndex,
+            boolean trailingSideOfCharacter,
+            Vector2* location) override;
+
+        IFACEMETHOD(GetCharacterRegions)(
+            int32_t characterIndex,
+            int32_t characterCount,
+            uint32_t* hitTestDescriptionCount,
+            CanvasTextLayoutRegion** hitTestDescriptions) override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+    private:
+        // Splits text[begin, end) into paragraphs.  A newline at the very
+        // end only starts another (empty) paragraph if end is the end of
+        // the document.
+        static void SplitParagraphs(
+            std::wstring const& text,
+            uint32_t begin,
+            uint32_t end,
+            std::vector<Paragraph>* paragraphs);
+
+        uint32_t FindParagraph(Lock const& lock, uint32_t characterIndex);
+        ComPtr<CanvasTextLayout> const& GetLayout(Lock const& lock, uint32_t paragraphIndex);
+        void EnsureParagraphTops(Lock const& lock);
+        void ThrowIfOutOfRange(Lock const& lock, uint32_t paragraphIndex);
+    };
+}}}}}
@@ -8,6 +8,7 @@
 #include "CanvasFontSet.h"
 #include "CanvasScaledFont.h"
 #include "CanvasFontFace.h"
+#include "CanvasGlyphRun.h"
 #include "CanvasTypography.h"
 #include "CanvasNumberSubstitution.h"
 
@@ -41,6 +42,12 @@ void DWriteTextAnalysisSource::SetLocaleName(WinString localeName)
     m_localeName = localeName;
 }
 
+void DWriteTextAnalysisSource::SetText(WinString text, uint32_t textLength)
+{
+    m_text = text;
+    m_textLength = textLength;
+}
+
 IFACEMETHODIMP DWriteTextAnalysisSource::GetTextAtPosition(
     uint32_t textPosition,
     WCHAR const** textString,
@@ -378,7 +385,7 @@ void DWriteTextAnalysisSink::EnsureAnalyzedBidi()
 {
     if (!m_analyzedBidi)
     {
-        m_analyzedBidi = Make<Vector<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedBidi>*>>();
+        m_analyzedBidi = MakePooled<Vector<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedBidi>*>>();
         CheckMakeResult(m_analyzedBidi);
     }
 }
@@ -395,7 +402,7 @@ void DWriteTextAnalysisSink::EnsureAnalyzedNumberSubstitution()
 {
     if (!m_analyzedNumberSubstitution)
     {
-        m_analyzedNumberSubstitution = Make<Vector<IKeyValuePair<CanvasCharacterRange, CanvasNumberSubstitution*>*>>();
+        m_analyzedNumberSubstitution = MakePooled<Vector<IKeyValuePair<CanvasCharacterRange, CanvasNumberSubstitution*>*>>();
         CheckMakeResult(m_analyzedNumberSubstitution);
     }
 }
@@ -404,7 +411,7 @@ void DWriteTextAnalysisSink::EnsureAnalyzedScript()
 {
     if (!m_analyzedScript)
     {
-        m_analyzedScript = Make<Vector<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedScript>*>>();
+        m_analyzedScript = MakePooled<Vector<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedScript>*>>();
         CheckMakeResult(m_analyzedScript);
     }
 }
@@ -413,11 +420,79 @@ void DWriteTextAnalysisSink::EnsureAnalyzedGlyphOrientation()
 {
     if (!m_analyzedGlyphOrientation)
     {
-        m_analyzedGlyphOrientation = Make<Vector<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedGlyphOrientation>*>>();
+        m_analyzedGlyphOrientation = MakePooled<Vector<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedGlyphOrientation>*>>();
         CheckMakeResult(m_analyzedGlyphOrientation);
     }
 }
 
+void DWriteBatchTextAnalysisSink::BeginText()
+{
+    m_lineBreakpointsStart = m_analyzedLineBreakpoints.size();
+}
+
+STDMETHODIMP DWriteBatchTextAnalysisSink::SetBidiLevel(
+    uint32_t textPosition,
+    uint32_t textLength,
+    uint8_t explicitLevel,
+    uint8_t resolvedLevel)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CanvasAnalyzedBidi analyzedBidi{};
+            analyzedBidi.ExplicitLevel = explicitLevel;
+            analyzedBidi.ResolvedLevel = resolvedLevel;
+
+            m_ranges.push_back(CanvasCharacterRange{ static_cast<int>(textPosition), static_cast<int>(textLength) });
+            m_analyzedBidi.push_back(analyzedBidi);
+        });
+}
+
+STDMETHODIMP DWriteBatchTextAnalysisSink::SetLineBreakpoints(
+    uint32_t textPosition,
+    uint32_t textLength,
+    DWRITE_LINE_BREAKPOINT const* dwriteLineBreakpoint)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto end = m_lineBreakpointsStart + textPosition + textLength;
+            if (m_analyzedLineBreakpoints.size() < end)
+                m_analyzedLineBreakpoints.resize(end);
+
+            for (uint32_t i = 0; i < textLength; ++i)
+            {
+                auto& b = m_analyzedLineBreakpoints[m_lineBreakpointsStart + textPosition + i];
+
+                b.BreakBefore = ToCanvasLineBreakCondition(dwriteLineBreakpoint[i].breakConditionBefore);
+                b.BreakAfter = ToCanvasLineBreakCondition(dwriteLineBreakpoint[i].breakConditionAfter);
+                b.IsWhitespace = dwriteLineBreakpoint[i].isWhitespace;
+                b.IsSoftHyphen = dwriteLineBreakpoint[i].isSoftHyphen;
+            }
+        });
+}
+
+STDMETHODIMP DWriteBatchTextAnalysisSink::SetNumberSubstitution(
+    uint32_t,
+    uint32_t,
+    IDWriteNumberSubstitution*)
+{
+    return S_OK;
+}
+
+STDMETHODIMP DWriteBatchTextAnalysisSink::SetScriptAnalysis(
+    uint32_t textPosition,
+    uint32_t textLength,
+    DWRITE_SCRIPT_ANALYSIS const* scriptAnalysis)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            m_ranges.push_back(CanvasCharacterRange{ static_cast<int>(textPosition), static_cast<int>(textLength) });
+            m_analyzedScript.push_back(ToCanvasAnalyzedScript(scriptAnalysis));
+        });
+}
+
 CanvasTextAnalyzer::CanvasTextAnalyzer(
     HSTRING text,
     CanvasTextDirection textDirection,
@@ -491,12 +566,15 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetFonts(
             CheckInPointer(textFormat);
             CheckAndClearOutPointer(result);
 
-            auto dwriteTextFormat = GetWrappedResource<IDWriteTextFormat>(textFormat);
+            auto textFormatInternal = As<ICanvasTextFormatInternal>(textFormat);
+            textFormatInternal->ThrowIfClosed();
+
+            auto dwriteTextFormat = textFormatInternal->GetRealizedTextFormat();
 
             WinString localeNameString = GetLocaleName(dwriteTextFormat.Get());
 
             uint32_t textLength;
-            WindowsGetStringRawBuffer(m_text, &textLength);
+            auto text = WindowsGetStringRawBuffer(m_text, &textLength);
 
             m_dwriteTextAnalysisSource->SetLocaleName(localeNameString);
 
@@ -525,40 +603,66 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetFonts(
             familyNameString.resize(dwriteTextFormat->GetFontFamilyNameLength() + 1);
             ThrowIfFailed(dwriteTextFormat->GetFontFamilyName(&familyNameString[0], static_cast<uint32_t>(familyNameString.size())));
 
+            // Analyzer options can vary the locale and number substitution
+            // from one character to the next, which the fallback cache
+            // doesn't track, and a requested font set gets a new collection
+            // every time.  So only the system font set is cached, and only
+            // with the default options.
+            bool useFallbackCache = !requestedFontSet && !m_source && !m_defaultNumberSubstitution;
+
+            auto& fallbackCache = m_customFontManager->GetFontFallbackCache();
+
+            FontFallbackCache::BaseFont baseFont
+            {
+                dwriteFontCollection,
+                familyNameString.c_str(),
+                dwriteTextFormat->GetFontWeight(),
+                dwriteTextFormat->GetFontStyle(),
+                dwriteTextFormat->GetFontStretch(),
+                static_cast<wchar_t const*>(localeNameString)
+            };
+
             uint32_t characterIndex = 0;
             uint32_t charactersLeft = textLength;
 
             uint32_t mappedLength;
-            ComPtr<IDWriteFont> mappedFont;
-            float scaleFactor;
+            FontFallbackCache::Mapping mapping;
 
-            auto vector = Make<Vector<IKeyValuePair<CanvasCharacterRange, CanvasScaledFont*>*>>();
+            auto vector = MakePooled<Vector<IKeyValuePair<CanvasCharacterRange, CanvasScaledFont*>*>>();
 
             while (charactersLeft > 0)
             {
-                ThrowIfFailed(m_customFontManager->GetSystemFontFallback()->MapCharacters(
-                    m_dwriteTextAnalysisSource.Get(),
-                    characterIndex,
-                    charactersLeft,
-                    dwriteFontCollection.Get(),
-                    &familyNameString[0],
-                    dwriteTextFormat->GetFontWeight(),
-                    dwriteTextFormat->GetFontStyle(),
-                    dwriteTextFormat->GetFontStretch(),
-                    &mappedLength,
-                    &mappedFont,
-                    &scaleFactor));
-
-                if (mappedFont)
+                mappedLength = useFallbackCache ? fallbackCache.TryMapCharacters(baseFont, text + characterIndex, charactersLeft, &mapping) : 0;
+
+                if (mappedLength == 0)
+                {
+                    ThrowIfFailed(m_customFontManager->GetSystemFontFallback()->MapCharacters(
+                        m_dwriteTextAnalysisSource.Get(),
+                        characterIndex,
+                        charactersLeft,
+                        dwriteFontCollection.Get(),
+                        &familyNameString[0],
+                        baseFont.Weight,
+                        baseFont.Style,
+                        baseFont.Stretch,
+                        &mappedLength,
+                        mapping.Font.ReleaseAndGetAddressOf(),
+                        &mapping.Scale));
+
+                    if (useFallbackCache)
+                        fallbackCache.AddMapping(baseFont, text + characterIndex, charactersLeft, mappedLength, mapping);
+                }
+
+                if (mapping.Font)
                 {
 #if WINVER > _WIN32_WINNT_WINBLUE
                     ComPtr<IDWriteFontFaceReference> fontFaceReference;
-                    ThrowIfFailed(As<IDWriteFont3>(mappedFont)->GetFontFaceReference(&fontFaceReference));
+                    ThrowIfFailed(As<IDWriteFont3>(mapping.Font)->GetFontFaceReference(&fontFaceReference));
                     auto canvasFontFace = ResourceManager::GetOrCreate<ICanvasFontFace>(fontFaceReference.Get());
 #else
-                    auto canvasFontFace = ResourceManager::GetOrCreate<ICanvasFontFace>(mappedFont.Get());
+                    auto canvasFontFace = ResourceManager::GetOrCreate<ICanvasFontFace>(mapping.Font.Get());
 #endif
-                    auto canvasScaledFont = Make<CanvasScaledFont>(canvasFontFace.Get(), scaleFactor);
+                    auto canvasScaledFont = Make<CanvasScaledFont>(canvasFontFace.Get(), mapping.Scale);
                     CheckMakeResult(canvasScaledFont);
 
                     auto newPair = MakeCharacterRangeKeyValue<CanvasScaledFont*, ICanvasScaledFont*>(characterIndex, mappedLength, canvasScaledFont.Get());
@@ -704,6 +808,72 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphOrientationsWithLocale(
         });
 }
 
+IFACEMETHODIMP CanvasTextAnalyzer::GetScriptRanges(
+    HSTRING locale,
+    uint32_t* rangeCount,
+    CanvasCharacterRange** ranges,
+    uint32_t* valueCount,
+    CanvasAnalyzedScript** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(rangeCount);
+            CheckAndClearOutPointer(ranges);
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            WinString localeString(locale);
+            m_dwriteTextAnalysisSource->SetLocaleName(localeString);
+
+            uint32_t textLength;
+            WindowsGetStringRawBuffer(m_text, &textLength);
+
+            auto sink = Make<DWriteBatchTextAnalysisSink>();
+            CheckMakeResult(sink);
+
+            ThrowIfFailed(m_customFontManager->GetTextAnalyzer()->AnalyzeScript(m_dwriteTextAnalysisSource.Get(), 0, textLength, sink.Get()));
+
+            auto& analyzedRanges = sink->GetRanges();
+            auto& analyzedScript = sink->GetAnalyzedScript();
+            ComArray<CanvasCharacterRange>(analyzedRanges.begin(), analyzedRanges.end()).Detach(rangeCount, ranges);
+            ComArray<CanvasAnalyzedScript>(analyzedScript.begin(), analyzedScript.end()).Detach(valueCount, valueElements);
+        });
+}
+
+IFACEMETHODIMP CanvasTextAnalyzer::GetBidiRanges(
+    HSTRING locale,
+    uint32_t* rangeCount,
+    CanvasCharacterRange** ranges,
+    uint32_t* valueCount,
+    CanvasAnalyzedBidi** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(rangeCount);
+            CheckAndClearOutPointer(ranges);
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            WinString localeString(locale);
+            m_dwriteTextAnalysisSource->SetLocaleName(localeString);
+
+            uint32_t textLength;
+            WindowsGetStringRawBuffer(m_text, &textLength);
+
+            auto sink = Make<DWriteBatchTextAnalysisSink>();
+            CheckMakeResult(sink);
+
+            ThrowIfFailed(m_customFontManager->GetTextAnalyzer()->AnalyzeBidi(m_dwriteTextAnalysisSource.Get(), 0, textLength, sink.Get()));
+
+            auto& analyzedRanges = sink->GetRanges();
+            auto& analyzedBidi = sink->GetAnalyzedBidi();
+            ComArray<CanvasCharacterRange>(analyzedRanges.begin(), analyzedRanges.end()).Detach(rangeCount, ranges);
+            ComArray<CanvasAnalyzedBidi>(analyzedBidi.begin(), analyzedBidi.end()).Detach(valueCount, valueElements);
+        });
+}
+
 WinString ToStringIsoCode(uint32_t code)
 {
     WinStringBuilder builder;
@@ -904,7 +1074,17 @@ static void ThrowIfInvalidCharacterRange(uint32_t textLength, CanvasCharacterRan
         ThrowHR(E_INVALIDARG);
 }
 
-IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
+struct CanvasTextAnalyzer::ShapedGlyphs
+{
+    std::vector<uint16_t> ClusterMap;
+    std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> ShapingTextProperties;
+    std::vector<uint16_t> GlyphIndices;
+    std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> ShapingGlyphProperties;
+    std::vector<float> GlyphAdvances;
+    std::vector<DWRITE_GLYPH_OFFSET> GlyphOffsets;
+};
+
+void CanvasTextAnalyzer::ShapeGlyphs(
     CanvasCharacterRange characterRange,
     ICanvasFontFace* fontFace,
     float fontSize,
@@ -914,129 +1094,140 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
     HSTRING locale,
     ICanvasNumberSubstitution* numberSubstitution,
     IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasTypography*>*>* typographyRanges,
-    uint32_t* clusterMapIndexCount,
-    int** clusterMapIndexElements,
-    uint32_t* isShapedAloneCount,
-    boolean** isShapedAloneElements,
-    uint32_t* glyphShapingCount,
-    CanvasGlyphShaping** glyphShapingElements,
-    uint32_t* valueCount,
-    CanvasGlyph** valueElements)
+    ShapedGlyphs* result)
 {
-    return ExceptionBoundary(
-        [&]
-        {
-            CheckInPointer(fontFace);
-            CheckAndClearOutPointer(valueElements);
-
-            ThrowIfNegative(characterRange.CharacterIndex);
-            ThrowIfNegative(characterRange.CharacterCount);
+    CheckInPointer(fontFace);
 
-            wchar_t const* text;
-            uint32_t textLength;
-
-            text = WindowsGetStringRawBuffer(m_text, &textLength);
+    ThrowIfNegative(characterRange.CharacterIndex);
+    ThrowIfNegative(characterRange.CharacterCount);
 
-            ThrowIfInvalidCharacterRange(textLength, characterRange);
-
-            text += characterRange.CharacterIndex;
-            textLength = characterRange.CharacterCount;
+    wchar_t const* text;
+    uint32_t textLength;
 
-            auto dwriteScriptAnalysis = ToDWriteScriptAnalysis(script);
+    text = WindowsGetStringRawBuffer(m_text, &textLength);
 
-            std::vector<uint16_t> clusterMap;
-            clusterMap.resize(textLength);
+    ThrowIfInvalidCharacterRange(textLength, characterRange);
 
-            std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> shapingTextProperties;
-            shapingTextProperties.resize(textLength);
+    text += characterRange.CharacterIndex;
+    textLength = characterRange.CharacterCount;
 
-            auto dwriteFontFace = As<ICanvasFontFaceInternal>(fontFace)->GetRealizedFontFace();
-            
-            ComPtr<IDWriteNumberSubstitution> dwriteNumberSubstitution;
-            if (numberSubstitution)
-                dwriteNumberSubstitution = GetWrappedResource<IDWriteNumberSubstitution>(numberSubstitution);
+    auto dwriteScriptAnalysis = ToDWriteScriptAnalysis(script);
 
-            uint32_t typographyRangeCount = 0;
-            DWriteTypographyRangeData dwriteTypographyRangeData;
-            if (typographyRanges)
-            {
-                GetDWriteTypographyRanges(characterRange, typographyRanges, &typographyRangeCount, &dwriteTypographyRangeData);
-            }
-
-            std::vector<DWRITE_TYPOGRAPHIC_FEATURES> featuresPerSpan;
+    result->ClusterMap.resize(textLength);
+    result->ShapingTextProperties.resize(textLength);
 
-            std::vector<uint16_t> glyphIndices;
-
-            std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> shapingGlyphProperties;
-
-            uint32_t actualGlyphCount{};    
-            RetryWithIncreasingGlyphCount(
-                textLength,
-                [&](uint32_t maxGlyphCount)
-                {
-                    glyphIndices.resize(maxGlyphCount);
-
-                    shapingGlyphProperties.resize(maxGlyphCount);
+    auto dwriteFontFace = As<ICanvasFontFaceInternal>(fontFace)->GetRealizedFontFace();
+    
+    ComPtr<IDWriteNumberSubstitution> dwriteNumberSubstitution;
+    if (numberSubstitution)
+        dwriteNumberSubstitution = GetWrappedResource<IDWriteNumberSubstitution>(numberSubstitution);
 
-                    return m_customFontManager->GetTextAnalyzer()->GetGlyphs(
-                        text,
-                        textLength,
-                        dwriteFontFace.Get(),
-                        isSideways,
-                        isRightToLeft,
-                        &dwriteScriptAnalysis,
-                        WindowsGetStringRawBuffer(locale, nullptr),
-                        dwriteNumberSubstitution.Get(),
-                        typographyRanges ? dwriteTypographyRangeData.FeatureDataPointers.data() : nullptr,
-                        typographyRanges ? dwriteTypographyRangeData.FeatureRangeLengths.data() : nullptr,
-                        typographyRangeCount,
-                        maxGlyphCount,
-                        clusterMap.data(),
-                        shapingTextProperties.data(),
-                        glyphIndices.data(),
-                        shapingGlyphProperties.data(),
-                        &actualGlyphCount);
-                });
+    uint32_t typographyRangeCount = 0;
+    DWriteTypographyRangeData dwriteTypographyRangeData;
+    if (typographyRanges)
+    {
+        GetDWriteTypographyRanges(characterRange, typographyRanges, &typographyRangeCount, &dwriteTypographyRangeData);
+    }
 
-            std::vector<float> glyphAdvances;
-            glyphAdvances.resize(actualGlyphCount);
+    uint32_t actualGlyphCount{};    
+    RetryWithIncreasingGlyphCount(
+        textLength,
+        [&](uint32_t maxGlyphCount)
+        {
+            result->GlyphIndices.resize(maxGlyphCount);
 
-            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
-            glyphOffsets.resize(actualGlyphCount);
+            result->ShapingGlyphProperties.resize(maxGlyphCount);
 
-            ThrowIfFailed(m_customFontManager->GetTextAnalyzer()->GetGlyphPlacements(
+            return m_customFontManager->GetTextAnalyzer()->GetGlyphs(
                 text,
-                clusterMap.data(),
-                shapingTextProperties.data(),
                 textLength,
-                glyphIndices.data(),
-                shapingGlyphProperties.data(),
-                actualGlyphCount,
                 dwriteFontFace.Get(),
-                fontSize,
                 isSideways,
                 isRightToLeft,
                 &dwriteScriptAnalysis,
                 WindowsGetStringRawBuffer(locale, nullptr),
+                dwriteNumberSubstitution.Get(),
                 typographyRanges ? dwriteTypographyRangeData.FeatureDataPointers.data() : nullptr,
                 typographyRanges ? dwriteTypographyRangeData.FeatureRangeLengths.data() : nullptr,
                 typographyRangeCount,
-                glyphAdvances.data(),
-                glyphOffsets.data()));
+                maxGlyphCount,
+                result->ClusterMap.data(),
+                result->ShapingTextProperties.data(),
+                result->GlyphIndices.data(),
+                result->ShapingGlyphProperties.data(),
+                &actualGlyphCount);
+        });
+
+    result->GlyphIndices.resize(actualGlyphCount);
+    result->ShapingGlyphProperties.resize(actualGlyphCount);
+
+    result->GlyphAdvances.resize(actualGlyphCount);
+    result->GlyphOffsets.resize(actualGlyphCount);
+
+    ThrowIfFailed(m_customFontManager->GetTextAnalyzer()->GetGlyphPlacements(
+        text,
+        result->ClusterMap.data(),
+        result->ShapingTextProperties.data(),
+        textLength,
+        result->GlyphIndices.data(),
+        result->ShapingGlyphProperties.data(),
+        actualGlyphCount,
+        dwriteFontFace.Get(),
+        fontSize,
+        isSideways,
+        isRightToLeft,
+        &dwriteScriptAnalysis,
+        WindowsGetStringRawBuffer(locale, nullptr),
+        typographyRanges ? dwriteTypographyRangeData.FeatureDataPointers.data() : nullptr,
+        typographyRanges ? dwriteTypographyRangeData.FeatureRangeLengths.data() : nullptr,
+        typographyRangeCount,
+        result->GlyphAdvances.data(),
+        result->GlyphOffsets.data()));
+}
+
+IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
+    CanvasCharacterRange characterRange,
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    boolean isSideways,
+    boolean isRightToLeft,
+    CanvasAnalyzedScript script,
+    HSTRING locale,
+    ICanvasNumberSubstitution* numberSubstitution,
+    IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasTypography*>*>* typographyRanges,
+    uint32_t* clusterMapIndexCount,
+    int** clusterMapIndexElements,
+    uint32_t* isShapedAloneCount,
+    boolean** isShapedAloneElements,
+    uint32_t* glyphShapingCount,
+    CanvasGlyphShaping** glyphShapingElements,
+    uint32_t* valueCount,
+    CanvasGlyph** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(fontFace);
+            CheckAndClearOutPointer(valueElements);
+
+            ShapedGlyphs shapedGlyphs;
+            ShapeGlyphs(characterRange, fontFace, fontSize, isSideways, isRightToLeft, script, locale, numberSubstitution, typographyRanges, &shapedGlyphs);
+
+            auto actualGlyphCount = static_cast<uint32_t>(shapedGlyphs.GlyphIndices.size());
 
             ComArray<CanvasGlyph> glyphs(actualGlyphCount);
             for (uint32_t i = 0; i < actualGlyphCount; ++i)
             {
-                glyphs[i].Index = glyphIndices[i];
-                glyphs[i].Advance = glyphAdvances[i];
-                glyphs[i].AdvanceOffset = glyphOffsets[i].advanceOffset;
-                glyphs[i].AscenderOffset = glyphOffsets[i].ascenderOffset;
+                glyphs[i].Index = shapedGlyphs.GlyphIndices[i];
+                glyphs[i].Advance = shapedGlyphs.GlyphAdvances[i];
+                glyphs[i].AdvanceOffset = shapedGlyphs.GlyphOffsets[i].advanceOffset;
+                glyphs[i].AscenderOffset = shapedGlyphs.GlyphOffsets[i].ascenderOffset;
             }
             glyphs.Detach(valueCount, valueElements);
 
             if (clusterMapIndexElements)
             {
-                auto clusterMapResult = TransformToComArray<int>(clusterMap.begin(), clusterMap.end(), 
+                auto clusterMapResult = TransformToComArray<int>(shapedGlyphs.ClusterMap.begin(), shapedGlyphs.ClusterMap.end(), 
                     [](uint16_t value)
                     {
                         return static_cast<int>(value);
@@ -1046,7 +1237,7 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
 
             if (isShapedAloneElements)
             {
-                auto isShapedAloneResult = TransformToComArray<boolean>(shapingTextProperties.begin(), shapingTextProperties.end(),
+                auto isShapedAloneResult = TransformToComArray<boolean>(shapedGlyphs.ShapingTextProperties.begin(), shapedGlyphs.ShapingTextProperties.end(),
                     [](DWRITE_SHAPING_TEXT_PROPERTIES const& value)
                     {
                         return !!value.isShapedAlone;
@@ -1056,7 +1247,7 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
 
             if (glyphShapingElements)
             {
-                auto glyphShaping = TransformToComArray<CanvasGlyphShaping>(shapingGlyphProperties.begin(), shapingGlyphProperties.begin() + actualGlyphCount,
+                auto glyphShaping = TransformToComArray<CanvasGlyphShaping>(shapedGlyphs.ShapingGlyphProperties.begin(), shapedGlyphs.ShapingGlyphProperties.end(),
                     [](DWRITE_SHAPING_GLYPH_PROPERTIES const& dwriteValue)
                     {
                         CanvasGlyphShaping result{};
@@ -1071,6 +1262,55 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
         });
 }
 
+IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphRun(
+    CanvasCharacterRange characterRange,
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    boolean isSideways,
+    boolean isRightToLeft,
+    CanvasAnalyzedScript script,
+    ICanvasGlyphRun** glyphRun)
+{
+    return GetGlyphRunWithAllOptions(characterRange, fontFace, fontSize, isSideways, isRightToLeft, script, nullptr, nullptr, nullptr, glyphRun);
+}
+
+IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphRunWithAllOptions(
+    CanvasCharacterRange characterRange,
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    boolean isSideways,
+    boolean isRightToLeft,
+    CanvasAnalyzedScript script,
+    HSTRING locale,
+    ICanvasNumberSubstitution* numberSubstitution,
+    IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasTypography*>*>* typographyRanges,
+    ICanvasGlyphRun** glyphRun)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(fontFace);
+            CheckAndClearOutPointer(glyphRun);
+
+            ShapedGlyphs shapedGlyphs;
+            ShapeGlyphs(characterRange, fontFace, fontSize, isSideways, isRightToLeft, script, locale, numberSubstitution, typographyRanges, &shapedGlyphs);
+
+            // The shaped arrays are handed over as they are, rather than
+            // round-tripping through CanvasGlyph.
+            auto newGlyphRun = Make<CanvasGlyphRun>(
+                fontFace,
+                fontSize,
+                std::move(shapedGlyphs.GlyphIndices),
+                std::move(shapedGlyphs.GlyphAdvances),
+                std::move(shapedGlyphs.GlyphOffsets),
+                isSideways,
+                isRightToLeft ? 1 : 0);
+            CheckMakeResult(newGlyphRun);
+
+            ThrowIfFailed(newGlyphRun.CopyTo(glyphRun));
+        });
+}
+
 static std::vector<uint16_t> GetDWriteClusterMap(
     uint32_t clusterMapIndicesCount,
     int* clusterMapIndicesElements)
@@ -1427,4 +1667,307 @@ HRESULT CanvasTextAnalyzerFactory::CreateWithOptions(
 }
 
 
-ActivatableClassWithFactory(CanvasTextAnalyzer, CanvasTextAnalyzerFactory);
\ No newline at end of file
+//
+// Runs one kind of analysis over each text of a batch, reusing the same
+// analysis source and sink for all of them.  If rangeStarts is set, it
+// receives the index of each text's first range in the sink, followed by
+// the total number of ranges.
+//
+static void AnalyzeBatch(
+    uint32_t textCount,
+    HSTRING* texts,
+    CanvasTextDirection textDirection,
+    DWriteBatchTextAnalysisSink* sink,
+    std::vector<uint32_t>* rangeStarts,
+    std::function<HRESULT(IDWriteTextAnalyzer2*, IDWriteTextAnalysisSource*, uint32_t, IDWriteTextAnalysisSink*)> const& analyze)
+{
+    if (textCount > 0)
+        CheckInPointer(texts);
+
+    auto source = Make<DWriteTextAnalysisSource>(
+        WinString(),
+        0,
+        textDirection,
+        nullptr,
+        nullptr,
+        CanvasVerticalGlyphOrientation::Default,
+        0);
+    CheckMakeResult(source);
+
+    auto customFontManager = CustomFontManager::GetInstance();
+    auto& textAnalyzer = customFontManager->GetTextAnalyzer();
+
+    if (rangeStarts)
+        rangeStarts->reserve(textCount + 1);
+
+    for (uint32_t i = 0; i < textCount; ++i)
+    {
+        if (rangeStarts)
+            rangeStarts->push_back(static_cast<uint32_t>(sink->GetRanges().size()));
+
+        uint32_t textLength;
+        WindowsGetStringRawBuffer(texts[i], &textLength);
+
+        if (textLength == 0)
+            continue;
+
+        source->SetText(WinString(texts[i]), textLength);
+        sink->BeginText();
+
+        ThrowIfFailed(analyze(textAnalyzer.Get(), source.Get(), textLength, sink));
+    }
+
+    if (rangeStarts)
+        rangeStarts->push_back(static_cast<uint32_t>(sink->GetRanges().size()));
+}
+
+template<typename VALUE>
+static void DetachBatchResults(
+    std::vector<uint32_t> const& rangeStarts,
+    std::vector<CanvasCharacterRange> const& ranges,
+    std::vector<VALUE> const& values,
+    uint32_t* rangeStartCount,
+    uint32_t** rangeStartElements,
+    uint32_t* rangeCount,
+    CanvasCharacterRange** rangeElements,
+    uint32_t* valueCount,
+    VALUE** valueElements)
+{
+    ComArray<uint32_t>(rangeStarts.begin(), rangeStarts.end()).Detach(rangeStartCount, rangeStartElements);
+    ComArray<CanvasCharacterRange>(ranges.begin(), ranges.end()).Detach(rangeCount, rangeElements);
+    ComArray<VALUE>(values.begin(), values.end()).Detach(valueCount, valueElements);
+}
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::GetScriptBatch(
+    uint32_t textCount,
+    HSTRING* texts,
+    CanvasTextDirection textDirection,
+    uint32_t* rangeStartCount,
+    uint32_t** rangeStarts,
+    uint32_t* rangeCount,
+    CanvasCharacterRange** ranges,
+    uint32_t* valueCount,
+    CanvasAnalyzedScript** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(rangeStartCount);
+            CheckAndClearOutPointer(rangeStarts);
+            CheckInPointer(rangeCount);
+            CheckAndClearOutPointer(ranges);
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            auto sink = Make<DWriteBatchTextAnalysisSink>();
+            CheckMakeResult(sink);
+
+            std::vector<uint32_t> starts;
+            AnalyzeBatch(textCount, texts, textDirection, sink.Get(), &starts,
+                [](IDWriteTextAnalyzer2* textAnalyzer, IDWriteTextAnalysisSource* source, uint32_t textLength, IDWriteTextAnalysisSink* analysisSink)
+                {
+                    return textAnalyzer->AnalyzeScript(source, 0, textLength, analysisSink);
+                });
+
+            DetachBatchResults(starts, sink->GetRanges(), sink->GetAnalyzedScript(), rangeStartCount, rangeStarts, rangeCount, ranges, valueCount, valueElements);
+        });
+}
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::GetBidiBatch(
+    uint32_t textCount,
+    HSTRING* texts,
+    CanvasTextDirection textDirection,
+    uint32_t* rangeStartCount,
+    uint32_t** rangeStarts,
+    uint32_t* rangeCount,
+    CanvasCharacterRange** ranges,
+    uint32_t* valueCount,
+    CanvasAnalyzedBidi** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(rangeStartCount);
+            CheckAndClearOutPointer(rangeStarts);
+            CheckInPointer(rangeCount);
+            CheckAndClearOutPointer(ranges);
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            auto sink = Make<DWriteBatchTextAnalysisSink>();
+            CheckMakeResult(sink);
+
+            std::vector<uint32_t> starts;
+            AnalyzeBatch(textCount, texts, textDirection, sink.Get(), &starts,
+                [](IDWriteTextAnalyzer2* textAnalyzer, IDWriteTextAnalysisSource* source, uint32_t textLength, IDWriteTextAnalysisSink* analysisSink)
+                {
+                    return textAnalyzer->AnalyzeBidi(source, 0, textLength, analysisSink);
+                });
+
+            DetachBatchResults(starts, sink->GetRanges(), sink->GetAnalyzedBidi(), rangeStartCount, rangeStarts, rangeCount, ranges, valueCount, valueElements);
+        });
+}
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::GetBreakpointsBatch(
+    uint32_t textCount,
+    HSTRING* texts,
+    uint32_t* valueCount,
+    CanvasAnalyzedBreakpoint** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            auto sink = Make<DWriteBatchTextAnalysisSink>();
+            CheckMakeResult(sink);
+
+            AnalyzeBatch(textCount, texts, CanvasTextDirection::LeftToRightThenTopToBottom, sink.Get(), nullptr,
+                [](IDWriteTextAnalyzer2* textAnalyzer, IDWriteTextAnalysisSource* source, uint32_t textLength, IDWriteTextAnalysisSink* analysisSink)
+                {
+                    return textAnalyzer->AnalyzeLineBreakpoints(source, 0, textLength, analysisSink);
+                });
+
+            auto& breakpoints = sink->GetAnalyzedLineBreakpoints();
+            ComArray<CanvasAnalyzedBreakpoint>(breakpoints.begin(), breakpoints.end()).Detach(valueCount, valueElements);
+        });
+}
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::GetGlyphsBatch(
+    uint32_t textCount,
+    HSTRING* texts,
+    CanvasTextDirection textDirection,
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    uint32_t* glyphStartCount,
+    uint32_t** glyphStarts,
+    uint32_t* valueCount,
+    CanvasGlyph** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(fontFace);
+            CheckInPointer(glyphStartCount);
+            CheckAndClearOutPointer(glyphStarts);
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            auto dwriteFontFace = As<ICanvasFontFaceInternal>(fontFace)->GetRealizedFontFace();
+            bool isRightToLeft = DWriteToCanvasTextDirection::Lookup(textDirection)->ReadingDirection == DWRITE_READING_DIRECTION_RIGHT_TO_LEFT;
+
+            auto sink = Make<DWriteBatchTextAnalysisSink>();
+            CheckMakeResult(sink);
+
+            std::vector<uint32_t> rangeStarts;
+            AnalyzeBatch(textCount, texts, textDirection, sink.Get(), &rangeStarts,
+                [](IDWriteTextAnalyzer2* textAnalyzer, IDWriteTextAnalysisSource* source, uint32_t textLength, IDWriteTextAnalysisSink* analysisSink)
+                {
+                    return textAnalyzer->AnalyzeScript(source, 0, textLength, analysisSink);
+                });
+
+            auto& ranges = sink->GetRanges();
+            auto& scripts = sink->GetAnalyzedScript();
+
+            auto customFontManager = CustomFontManager::GetInstance();
+            auto& textAnalyzer = customFontManager->GetTextAnalyzer();
+
+            // Shaping buffers are reused from one range to the next.
+            std::vector<uint16_t> clusterMap;
+            std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> shapingTextProperties;
+            std::vector<uint16_t> glyphIndices;
+            std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> shapingGlyphProperties;
+            std::vector<float> glyphAdvances;
+            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
+
+            std::vector<uint32_t> starts;
+            starts.reserve(textCount + 1);
+            std::vector<CanvasGlyph> glyphs;
+
+            for (uint32_t i = 0; i < textCount; ++i)
+            {
+                starts.push_back(static_cast<uint32_t>(glyphs.size()));
+
+                auto text = WindowsGetStringRawBuffer(texts[i], nullptr);
+
+                for (uint32_t r = rangeStarts[i]; r < rangeStarts[i + 1]; ++r)
+                {
+                    auto rangeText = text + ranges[r].CharacterIndex;
+                    auto rangeLength = static_cast<uint32_t>(ranges[r].CharacterCount);
+                    auto dwriteScriptAnalysis = ToDWriteScriptAnalysis(scripts[r]);
+
+                    clusterMap.resize(rangeLength);
+                    shapingTextProperties.resize(rangeLength);
+
+                    uint32_t actualGlyphCount{};
+                    RetryWithIncreasingGlyphCount(
+                        rangeLength,
+                        [&](uint32_t maxGlyphCount)
+                        {
+                            glyphIndices.resize(maxGlyphCount);
+                            shapingGlyphProperties.resize(maxGlyphCount);
+
+                            return textAnalyzer->GetGlyphs(
+                                rangeText,
+                                rangeLength,
+                                dwriteFontFace.Get(),
+                                FALSE,
+                                isRightToLeft,
+                                &dwriteScriptAnalysis,
+                                nullptr,
+                                nullptr,
+                                nullptr,
+                                nullptr,
+                                0,
+                                maxGlyphCount,
+                                clusterMap.data(),
+                                shapingTextProperties.data(),
+                                glyphIndices.data(),
+                                shapingGlyphProperties.data(),
+                                &actualGlyphCount);
+                        });
+
+                    glyphAdvances.resize(actualGlyphCount);
+                    glyphOffsets.resize(actualGlyphCount);
+
+                    ThrowIfFailed(textAnalyzer->GetGlyphPlacements(
+                        rangeText,
+                        clusterMap.data(),
+                        shapingTextProperties.data(),
+                        rangeLength,
+                        glyphIndices.data(),
+                        shapingGlyphProperties.data(),
+                        actualGlyphCount,
+                        dwriteFontFace.Get(),
+                        fontSize,
+                        FALSE,
+                        isRightToLeft,
+                        &dwriteScriptAnalysis,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        0,
+                        glyphAdvances.data(),
+                        glyphOffsets.data()));
+
+                    for (uint32_t g = 0; g < actualGlyphCount; ++g)
+                    {
+                        CanvasGlyph glyph{};
+                        glyph.Index = glyphIndices[g];
+                        glyph.Advance = glyphAdvances[g];
+                        glyph.AdvanceOffset = glyphOffsets[g].advanceOffset;
+                        glyph.AscenderOffset = glyphOffsets[g].ascenderOffset;
+                        glyphs.push_back(glyph);
+                    }
+                }
+            }
+
+            starts.push_back(static_cast<uint32_t>(glyphs.size()));
+
+            ComArray<uint32_t>(starts.begin(), starts.end()).Detach(glyphStartCount, glyphStarts);
+            ComArray<CanvasGlyph>(glyphs.begin(), glyphs.end()).Detach(valueCount, valueElements);
+        });
+}
+
+ActivatableClassWithFactory(CanvasTextAnalyzer, CanvasTextAnalyzerFactory);
@@ -32,6 +32,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         void SetLocaleName(WinString localeName);
 
+        // Lets one source be reused for each string of a batch.
+        void SetText(WinString text, uint32_t textLength);
+
         IFACEMETHODIMP GetTextAtPosition(
             uint32_t textPosition,
             WCHAR const** textString,
@@ -131,6 +134,52 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     };
 
+    //
+    // Collects analysis results into flat arrays, for one string or a batch
+    // of them.  Call BeginText before analyzing each string; ranges are
+    // recorded relative to the start of the current string.
+    //
+    class DWriteBatchTextAnalysisSink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IDWriteTextAnalysisSink>,
+        private LifespanTracker<DWriteBatchTextAnalysisSink>
+    {
+        std::vector<CanvasCharacterRange> m_ranges;
+        std::vector<CanvasAnalyzedScript> m_analyzedScript;
+        std::vector<CanvasAnalyzedBidi> m_analyzedBidi;
+        std::vector<CanvasAnalyzedBreakpoint> m_analyzedLineBreakpoints;
+        size_t m_lineBreakpointsStart;
+
+    public:
+        DWriteBatchTextAnalysisSink() : m_lineBreakpointsStart(0) {}
+
+        void BeginText();
+
+        STDMETHOD(SetBidiLevel)(
+            uint32_t textPosition,
+            uint32_t textLength,
+            uint8_t explicitLevel,
+            uint8_t resolvedLevel) override;
+
+        STDMETHOD(SetLineBreakpoints)(
+            uint32_t textPosition,
+            uint32_t textLength,
+            DWRITE_LINE_BREAKPOINT const* dwriteLineBreakpoint) override;
+
+        STDMETHOD(SetNumberSubstitution)(
+            uint32_t textPosition,
+            uint32_t textLength,
+            IDWriteNumberSubstitution* dwriteNumberSubstitution) override;
+
+        STDMETHOD(SetScriptAnalysis)(
+            uint32_t textPosition,
+            uint32_t textLength,
+            DWRITE_SCRIPT_ANALYSIS const* scriptAnalysis) override;
+
+        std::vector<CanvasCharacterRange>& GetRanges() { return m_ranges; }
+        std::vector<CanvasAnalyzedScript>& GetAnalyzedScript() { return m_analyzedScript; }
+        std::vector<CanvasAnalyzedBidi>& GetAnalyzedBidi() { return m_analyzedBidi; }
+        std::vector<CanvasAnalyzedBreakpoint>& GetAnalyzedLineBreakpoints() { return m_analyzedLineBreakpoints; }
+    };
+
     class CanvasTextAnalyzer : public RuntimeClass<
         RuntimeClassFlags<WinRtClassicComMix>,
         ICanvasTextAnalyzer>,
@@ -205,6 +254,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             HSTRING locale,
             IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasAnalyzedGlyphOrientation>*>** values) override;
 
+        IFACEMETHOD(GetScriptRanges)(
+            HSTRING locale,
+            uint32_t* rangeCount,
+            CanvasCharacterRange** ranges,
+            uint32_t* valueCount,
+            CanvasAnalyzedScript** valueElements) override;
+
+        IFACEMETHOD(GetBidiRanges)(
+            HSTRING locale,
+            uint32_t* rangeCount,
+            CanvasCharacterRange** ranges,
+            uint32_t* valueCount,
+            CanvasAnalyzedBidi** valueElements) override;
+
         IFACEMETHOD(GetScriptProperties)(
             CanvasAnalyzedScript analyzedScript,
             CanvasScriptProperties* scriptProperties) override;
@@ -238,6 +301,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             uint32_t* valueCount,
             CanvasGlyph** valueElements) override;
 
+        IFACEMETHOD(GetGlyphRun)(
+            CanvasCharacterRange characterRange,
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            boolean isSideways,
+            boolean isRightToLeft,
+            CanvasAnalyzedScript script,
+            ICanvasGlyphRun** glyphRun) override;
+
+        IFACEMETHOD(GetGlyphRunWithAllOptions)(
+            CanvasCharacterRange characterRange,
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            boolean isSideways,
+            boolean isRightToLeft,
+            CanvasAnalyzedScript script,
+            HSTRING locale,
+            ICanvasNumberSubstitution* numberSubstitution,
+            IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasTypography*>*>* typographyRanges,
+            ICanvasGlyphRun** glyphRun) override;
+
         IFACEMETHOD(GetJustificationOpportunities)(
             CanvasCharacterRange characterRange,
             ICanvasFontFace* fontFace,
@@ -294,6 +378,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     private:
         void CreateTextAnalysisSourceAndSink();
 
+        struct ShapedGlyphs;
+
+        void ShapeGlyphs(
+            CanvasCharacterRange characterRange,
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            boolean isSideways,
+            boolean isRightToLeft,
+            CanvasAnalyzedScript script,
+            HSTRING locale,
+            ICanvasNumberSubstitution* numberSubstitution,
+            IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasTypography*>*>* typographyRanges,
+            ShapedGlyphs* result);
+
     };
 
 
@@ -302,7 +400,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     //
 
     class CanvasTextAnalyzerFactory
-        : public AgileActivationFactory<ICanvasTextAnalyzerFactory>
+        : public AgileActivationFactory<ICanvasTextAnalyzerFactory, ICanvasTextAnalyzerStatics>
         , private LifespanTracker<CanvasTextAnalyzerFactory>
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasTextAnalyzer, BaseTrust);
@@ -327,6 +425,49 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             CanvasTextDirection textDirection,
             ICanvasTextAnalyzerOptions* source,
             ICanvasTextAnalyzer** textAnalyzer);
+
+        //
+        // ICanvasTextAnalyzerStatics
+        //
+
+        IFACEMETHOD(GetScriptBatch)(
+            uint32_t textCount,
+            HSTRING* texts,
+            CanvasTextDirection textDirection,
+            uint32_t* rangeStartCount,
+            uint32_t** rangeStarts,
+            uint32_t* rangeCount,
+            CanvasCharacterRange** ranges,
+            uint32_t* valueCount,
+            CanvasAnalyzedScript** valueElements) override;
+
+        IFACEMETHOD(GetBidiBatch)(
+            uint32_t textCount,
+            HSTRING* texts,
+            CanvasTextDirection textDirection,
+            uint32_t* rangeStartCount,
+            uint32_t** rangeStarts,
+            uint32_t* rangeCount,
+            CanvasCharacterRange** ranges,
+            uint32_t* valueCount,
+            CanvasAnalyzedBidi** valueElements) override;
+
+        IFACEMETHOD(GetBreakpointsBatch)(
+            uint32_t textCount,
+            HSTRING* texts,
+            uint32_t* valueCount,
+            CanvasAnalyzedBreakpoint** valueElements) override;
+
+        IFACEMETHOD(GetGlyphsBatch)(
+            uint32_t textCount,
+            HSTRING* texts,
+            CanvasTextDirection textDirection,
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            uint32_t* glyphStartCount,
+            uint32_t** glyphStarts,
+            uint32_t* valueCount,
+            CanvasGlyph** valueElements) override;
     };
     
 }}}}}
@@ -119,6 +119,9 @@ CanvasTextFormat::CanvasTextFormat()
     , m_verticalGlyphOrientation(CanvasVerticalGlyphOrientation::Default)
     , m_opticalAlignment(CanvasOpticalAlignment::Default)
     , m_lastLineWrapping(true)
+    , m_realizedTextFormatCloneWordWrapping(CanvasWordWrapping::NoWrap)
+    , m_realizedTextFormatExposed(false)
+    , m_realizedTextFormatVersion(1)
 {
 }
 
@@ -129,6 +132,9 @@ CanvasTextFormat::CanvasTextFormat(IDWriteTextFormat1* format)
     , m_closed(false)
     , m_drawTextOptions(CanvasDrawTextOptions::Default)
     , m_lineSpacingMode(CanvasLineSpacingMode::Default)
+    , m_realizedTextFormatCloneWordWrapping(CanvasWordWrapping::NoWrap)
+    , m_realizedTextFormatExposed(true)
+    , m_realizedTextFormatVersion(1)
 {
     SetShadowPropertiesFromDWrite();
 }
@@ -136,7 +142,15 @@ CanvasTextFormat::CanvasTextFormat(IDWriteTextFormat1* format)
 
 IFACEMETHODIMP CanvasTextFormat::Close()
 {
-    m_closed = true;
+    {
+        auto lock = GetLock();
+
+        m_closed = true;
+        DiscardRealizedTextFormatClone();
+    }
+
+    m_measurementCache.Clear();
+
     return ResourceWrapper::Close();
 }
 
@@ -158,7 +172,17 @@ IFACEMETHODIMP CanvasTextFormat::GetNativeResource(ICanvasDevice* device, float
         {
             CheckAndClearOutPointer(value);
             ThrowIfClosed();
-            ThrowIfFailed(GetRealizedTextFormat().CopyTo(iid, value));
+
+            auto realizedTextFormat = GetRealizedTextFormat();
+
+            {
+                auto lock = GetLock();
+
+                m_realizedTextFormatExposed = true;
+                DiscardRealizedTextFormatClone();
+            }
+
+            ThrowIfFailed(realizedTextFormat.CopyTo(iid, value));
         });
 }
 
@@ -252,6 +276,11 @@ ComPtr<IDWriteTextFormat> CanvasTextFormat::GetRealizedTextFormatClone(CanvasWor
 
     auto lock = GetLock();
 
+    if (m_realizedTextFormatClone && m_realizedTextFormatCloneWordWrapping == overrideWordWrapping)
+    {
+        return m_realizedTextFormatClone;
+    }
+
     if (HasResource())
     {
         SetShadowPropertiesFromDWrite();
@@ -261,10 +290,31 @@ ComPtr<IDWriteTextFormat> CanvasTextFormat::GetRealizedTextFormatClone(CanvasWor
 
     ThrowIfFailed(newFormat->SetWordWrapping(ToWordWrapping(overrideWordWrapping)));
 
+    if (!m_realizedTextFormatExposed)
+    {
+        m_realizedTextFormatClone = newFormat;
+        m_realizedTextFormatCloneWordWrapping = overrideWordWrapping;
+    }
+
     return newFormat;
 }
 
 
+void CanvasTextFormat::DiscardRealizedTextFormatClone()
+{
+    m_realizedTextFormatClone.Reset();
+    m_realizedTextFormatVersion++;
+}
+
+
+uint64_t CanvasTextFormat::GetRealizedTextFormatVersion()
+{
+    auto lock = GetLock();
+
+    return m_realizedTextFormatExposed ? 0 : m_realizedTextFormatVersion;
+}
+
+
 D2D1_DRAW_TEXT_OPTIONS CanvasTextFormat::GetDrawTextOptions()
 {
     return static_cast<D2D1_DRAW_TEXT_OPTIONS>(m_drawTextOptions);
@@ -282,7 +332,12 @@ void CanvasTextFormat::Unrealize()
         SetShadowPropertiesFromDWrite();
 
         ReleaseResource();
+
+        // Nobody outside can be holding the next realized format.
+        m_realizedTextFormatExposed = false;
     }
+
+    DiscardRealizedTextFormatClone();
 }
 
 
@@ -473,6 +528,9 @@ HRESULT __declspec(nothrow) CanvasTextFormat::PropertyPut(T value, TT* dest, FNV
                 Unrealize();
             }
 
+            // Any cached clone was made from the old value
+            DiscardRealizedTextFormatClone();
+
             // Set the shadow value
             SetFrom(dest, value);
 
@@ -1175,6 +1233,56 @@ void CanvasTextFormat::RealizeCustomTrimmingSign(IDWriteTextFormat1* textFormat)
     m_trimmingSignInformation.RealizeCustomTrimmingSign(textFormat);
 }
 
+IFACEMETHODIMP CanvasTextFormat::Measure(
+    HSTRING text,
+    float maxWidth,
+    CanvasTextMeasurement* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            ThrowIfClosed();
+
+            if (isnan(maxWidth) || maxWidth < 0)
+                ThrowHR(E_INVALIDARG);
+
+            uint32_t textLength;
+            auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+
+            // The version must be read before realizing, so that a property
+            // changed in between leaves us caching under a stale version
+            // rather than a current one.
+            auto formatVersion = GetRealizedTextFormatVersion();
+
+            *value = m_measurementCache.GetOrMeasure(textBuffer, textLength, formatVersion, maxWidth,
+                [&]
+                {
+                    auto textFormat = GetRealizedTextFormat();
+
+                    ComPtr<IDWriteTextLayout> textLayout;
+                    ThrowIfFailed(m_customFontManager->GetSharedFactory()->CreateTextLayout(
+                        textBuffer,
+                        textLength,
+                        textFormat.Get(),
+                        maxWidth,
+                        0,
+                        &textLayout));
+
+                    auto textLayout2 = As<IDWriteTextLayout2>(textLayout);
+
+                    DWRITE_TEXT_METRICS1 metrics;
+                    ThrowIfFailed(textLayout2->GetMetrics(&metrics));
+
+                    CanvasTextMeasurement measurement;
+                    measurement.LayoutBounds = GetLayoutBounds(metrics, textLayout2->GetReadingDirection());
+                    measurement.LineCount = static_cast<int32_t>(metrics.lineCount);
+
+                    return measurement;
+                });
+        });
+}
+
 
 static bool TryGetLocalizedName(
     wchar_t const* locale,
@@ -1282,4 +1390,78 @@ IFACEMETHODIMP CanvasTextFormatFactory::GetSystemFontFamiliesFromLocaleList(
 }
 
 
+IFACEMETHODIMP CanvasTextFormatFactory::PreloadFontFamiliesAsync(
+    uint32_t fontFamilyCount,
+    HSTRING* fontFamilies,
+    IAsyncAction** action)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (fontFamilyCount > 0)
+                CheckInPointer(fontFamilies);
+            CheckAndClearOutPointer(action);
+
+            auto customFontManager = GetCustomFontManager();
+
+            std::vector<WinString> uris;
+
+            for (uint32_t i = 0; i < fontFamilyCount; ++i)
+            {
+                auto uri = GetUriAndFontFamily(WinString(fontFamilies[i])).first;
+
+                customFontManager->ValidateUri(uri);
+
+                if (uri != WinString())
+                    uris.push_back(uri);
+            }
+
+            auto asyncAction = Make<AsyncAction>(
+                [=]
+                {
+                    for (auto const& uri : uris)
+                    {
+                        customFontManager->GetFontCollectionFromUri(uri);
+                    }
+                });
+
+            CheckMakeResult(asyncAction);
+            ThrowIfFailed(asyncAction.CopyTo(action));
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextFormatFactory::get_FontCollectionCacheCapacity(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = GetCustomFontManager()->GetFontCollectionCacheCapacity();
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextFormatFactory::put_FontCollectionCacheCapacity(uint32_t value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            GetCustomFontManager()->SetFontCollectionCacheCapacity(value);
+        });
+}
+
+
+std::shared_ptr<CustomFontManager> const& CanvasTextFormatFactory::GetCustomFontManager()
+{
+    Lock lock(m_mutex);
+
+    if (!m_customFontManager)
+        m_customFontManager = CustomFontManager::GetInstance();
+
+    return m_customFontManager;
+}
+
+
 ActivatableClassWithFactory(CanvasTextFormat, CanvasTextFormatFactory);
@@ -6,6 +6,7 @@
 
 #include "utils/LockUtilities.h"
 #include "CustomFontManager.h"
+#include "TextMeasurementCache.h"
 #include "TrimmingSignInformation.h"
 
 //
@@ -31,6 +32,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasTextFormat, BaseTrust);
 
+        // The font collection cache lives in the CustomFontManager, which
+        // otherwise goes away along with the last text object using it.
+        // Preloading or configuring the cache keeps it alive for as long as
+        // this factory is.
+        std::mutex m_mutex;
+        std::shared_ptr<CustomFontManager> m_customFontManager;
+
     public:
         IFACEMETHOD(ActivateInstance)(IInspectable** obj) override;
 
@@ -42,6 +50,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             IVectorView<HSTRING>* localeList,
             uint32_t* valueCount,
             HSTRING** valueElements) override;
+
+        IFACEMETHOD(PreloadFontFamiliesAsync)(
+            uint32_t fontFamilyCount,
+            HSTRING* fontFamilies,
+            IAsyncAction** action) override;
+
+        IFACEMETHOD(get_FontCollectionCacheCapacity)(uint32_t* value) override;
+        IFACEMETHOD(put_FontCollectionCacheCapacity)(uint32_t value) override;
+
+    private:
+        std::shared_ptr<CustomFontManager> const& GetCustomFontManager();
     };
 
 
@@ -56,6 +75,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual ComPtr<IDWriteTextFormat1> GetRealizedTextFormat() = 0;
         virtual ComPtr<IDWriteTextFormat> GetRealizedTextFormatClone(CanvasWordWrapping overrideWordWrapping) = 0;
         virtual D2D1_DRAW_TEXT_OPTIONS GetDrawTextOptions() = 0;
+
+        // Changes whenever the realized format, or any clone of it, might lay
+        // text out differently.  Zero means this can't be tracked because the
+        // realized format has been handed out through interop.
+        virtual uint64_t GetRealizedTextFormatVersion() = 0;
+
+        // Other Win2D types that only read the realized format use this and
+        // GetRealizedTextFormat rather than GetWrappedResource, which would
+        // count as handing the format out through interop.
+        virtual void ThrowIfClosed() = 0;
     };
 
 
@@ -70,6 +99,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         CanvasTextFormat,
         ICanvasTextFormat,
         CloakedIid<ICanvasTextFormatInternal>)
+        , private ObjectCounter<CountedObjectType::TextFormat>
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasTextFormat, BaseTrust);
 
@@ -115,6 +145,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         TrimmingSignInformation m_trimmingSignInformation;
 
+        //
+        // DrawText at a point needs a NoWrap copy of the realized format.
+        // Since the copy is never modified after it is made, it can be
+        // reused until one of our properties changes.  This isn't safe once
+        // the realized format has been handed out through interop, as it can
+        // then be changed without us knowing, so that turns the cache off
+        // until the format is next unrealized.
+        //
+        // The same applies to the version number handed to the device's
+        // text layout cache, which changes along with the cached clone.
+        //
+        ComPtr<IDWriteTextFormat1> m_realizedTextFormatClone;
+        CanvasWordWrapping m_realizedTextFormatCloneWordWrapping;
+        bool m_realizedTextFormatExposed;
+        uint64_t m_realizedTextFormatVersion;
+
         //
         // Draw text options are not part of IDWriteTextFormat, but are stored
         // in CanvasTextFormat.  These are not protected by the mutex since they
@@ -127,6 +173,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         //
         CanvasLineSpacingMode m_lineSpacingMode;
 
+        //
+        // Results of Measure, which checks the realized format version itself
+        // so has its own lock rather than sharing m_mutex.
+        //
+        TextMeasurementCache m_measurementCache;
+
     public:
         CanvasTextFormat();
         CanvasTextFormat(IDWriteTextFormat1* format);
@@ -167,6 +219,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
 #undef PROPERTY
 
+        IFACEMETHOD(Measure)(
+            HSTRING text,
+            float maxWidth,
+            CanvasTextMeasurement* value) override;
+
         //
         // IClosable
         //
@@ -180,6 +237,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual ComPtr<IDWriteTextFormat1> GetRealizedTextFormat() override;
         virtual ComPtr<IDWriteTextFormat> GetRealizedTextFormatClone(CanvasWordWrapping overrideWordWrapping) override;
         virtual D2D1_DRAW_TEXT_OPTIONS GetDrawTextOptions() override;
+        virtual uint64_t GetRealizedTextFormatVersion() override;
+        virtual void ThrowIfClosed() override;
 
         //
         // ICanvasResourceWrapperNative
@@ -192,8 +251,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         {
             return Lock(m_mutex);
         }
-        
-        void ThrowIfClosed();
 
         template<typename T, typename ST, typename FN>
         HRESULT __declspec(nothrow) PropertyGet(T* value, ST const& shadowValue, FN realizedGetter);
@@ -207,6 +264,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         void SetShadowPropertiesFromDWrite();
 
         void Unrealize();
+        void DiscardRealizedTextFormatClone();
 
         void RealizeDirection(IDWriteTextFormat1* textFormat);
         void RealizeIncrementalTabStop(IDWriteTextFormat1* textFormat);
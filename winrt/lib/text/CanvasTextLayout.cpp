@@ -60,19 +60,38 @@ ComPtr<CanvasTextLayout> CanvasTextLayout::CreateNew(
     ICanvasTextFormat* textFormat,
     float requestedWidth,
     float requestedHeight)
+{
+    uint32_t textLength;
+    auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
+
+    return CreateNew(resourceCreator, textBuffer, textLength, textFormat, requestedWidth, requestedHeight);
+}
+
+
+ComPtr<CanvasTextLayout> CanvasTextLayout::CreateNew(
+    ICanvasResourceCreator* resourceCreator,
+    wchar_t const* textBuffer,
+    uint32_t textLength,
+    ICanvasTextFormat* textFormat,
+    float requestedWidth,
+    float requestedHeight)
 {
     auto customFontManager = CustomFontManager::GetInstance();
     auto dwriteFactory = customFontManager->GetSharedFactory();
 
-    uint32_t textLength;
-    auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
     ThrowIfNullPointer(textBuffer, E_INVALIDARG);
 
+    auto textFormatInternal = As<ICanvasTextFormatInternal>(textFormat);
+    textFormatInternal->ThrowIfClosed();
+
+    EventWrite_CanvasTextLayout_Create_Start(textLength);
+    auto createEnd = MakeScopeWarden([] { EventWrite_CanvasTextLayout_Create_Stop(); });
+
     ComPtr<IDWriteTextLayout> dwriteTextLayout;
     ThrowIfFailed(dwriteFactory->CreateTextLayout(
         textBuffer,
         textLength,
-        GetWrappedResource<IDWriteTextFormat>(textFormat).Get(),
+        textFormatInternal->GetRealizedTextFormat().Get(),
         requestedWidth,
         requestedHeight,
         &dwriteTextLayout));
@@ -85,6 +104,8 @@ ComPtr<CanvasTextLayout> CanvasTextLayout::CreateNew(
         As<DWriteTextLayoutType>(dwriteTextLayout).Get());
     CheckMakeResult(textLayout);
 
+    PerformanceCounters::Increment(PerformanceCounter::TextLayoutsCreated);
+
     CanvasLineSpacingMode lineSpacingMode{};
 #if WINVER > _WIN32_WINNT_WINBLUE
     ThrowIfFailed(textFormat->get_LineSpacingMode(&lineSpacingMode));
@@ -129,6 +150,81 @@ IFACEMETHODIMP CanvasTextLayoutFactory::Create(
 }
 
 
+IFACEMETHODIMP CanvasTextLayoutFactory::CreateAsync(
+    ICanvasResourceCreator* resourceCreator,
+    HSTRING textString,
+    ICanvasTextFormat* textFormat,
+    float requestedWidth,
+    float requestedHeight,
+    ABI::Windows::Foundation::IAsyncOperation<CanvasTextLayout*>** canvasTextLayout)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(textFormat);
+            CheckAndClearOutPointer(canvasTextLayout);
+
+            As<ICanvasTextFormatInternal>(textFormat)->ThrowIfClosed();
+
+            // The resource creator may be a control that belongs to the
+            // calling thread, so only its device goes to the worker.
+            ComPtr<ICanvasDevice> device;
+            ThrowIfFailed(resourceCreator->get_Device(&device));
+
+            WinString text(textString);
+            ComPtr<ICanvasTextFormat> format(textFormat);
+
+            auto asyncOperation = Make<AsyncOperation<CanvasTextLayout>>(
+                [=]
+                {
+                    auto textLayout = CanvasTextLayout::CreateNew(
+                        As<ICanvasResourceCreator>(device).Get(),
+                        text,
+                        format.Get(),
+                        requestedWidth,
+                        requestedHeight);
+
+                    textLayout->PrecomputeLayout();
+
+                    return textLayout;
+                });
+
+            CheckMakeResult(asyncOperation);
+            ThrowIfFailed(asyncOperation.CopyTo(canvasTextLayout));
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextLayoutFactory::CreateFromBuffer(
+    IUnknown* resourceCreator,
+    wchar_t const* text,
+    UINT32 textLength,
+    IUnknown* textFormat,
+    float requestedWidth,
+    float requestedHeight,
+    IInspectable** textLayout)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(resourceCreator);
+            CheckInPointer(textFormat);
+            CheckAndClearOutPointer(textLayout);
+
+            auto newTextLayout = CanvasTextLayout::CreateNew(
+                As<ICanvasResourceCreator>(resourceCreator).Get(),
+                text,
+                textLength,
+                As<ICanvasTextFormat>(textFormat).Get(),
+                requestedWidth,
+                requestedHeight);
+
+            ThrowIfFailed(newTextLayout.CopyTo(textLayout));
+        });
+}
+
+
 IFACEMETHODIMP CanvasTextLayoutFactory::GetGlyphOrientationTransform(
     CanvasGlyphOrientation glyphOrientation,
     boolean isSideways,
@@ -163,10 +259,20 @@ CanvasTextLayout::CanvasTextLayout(
     , m_device(device)
     , m_customFontManager(CustomFontManager::GetInstance())
     , m_lineSpacingMode(CanvasLineSpacingMode::Default)
+    , m_cacheTextRendererCalls(false)
 {
     EnsureCustomTrimmingSignDevice(layout, device);
 }
 
+ComPtr<DWriteTextLayoutType> const& CanvasTextLayout::GetResourceForUpdate()
+{
+    auto& resource = GetResource();
+
+    m_textRendererRecording.Reset();
+
+    return resource;
+}
+
 IFACEMETHODIMP CanvasTextLayout::GetFormatChangeIndices(
     uint32_t* positionCount,
     int32_t** positions)
@@ -236,7 +342,7 @@ IFACEMETHODIMP CanvasTextLayout::##name(valueType value)            \
     return ExceptionBoundary(                                       \
         [&]                                                         \
         {                                                           \
-            auto& resource = GetResource();                         \
+            auto& resource = GetResourceForUpdate();                \
                                                                     \
             ThrowIfInvalid(value);                                  \
             resource->dwriteMethod(conversionFunc(value));          \
@@ -299,7 +405,7 @@ IFACEMETHODIMP CanvasTextLayout::put_Direction(CanvasTextDirection value)
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
             auto entry = DWriteToCanvasTextDirection::Lookup(value);
             ThrowIfFailed(resource->SetReadingDirection(entry->ReadingDirection));
             ThrowIfFailed(resource->SetFlowDirection(entry->FlowDirection));
@@ -343,7 +449,7 @@ IFACEMETHODIMP CanvasTextLayout::put_LineSpacing(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource(); 
+            auto& resource = GetResourceForUpdate(); 
 
             DWriteLineSpacing originalSpacing(resource.Get());
 
@@ -390,7 +496,7 @@ IFACEMETHODIMP CanvasTextLayout::put_LineSpacingBaseline(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             //
             // The Win10 IDWriteTextLayout3 interface definition omits a 'using' while
@@ -433,7 +539,7 @@ IFACEMETHODIMP CanvasTextLayout::put_LineSpacingMode(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             DWriteLineSpacing originalSpacing(resource.Get());
 
@@ -474,7 +580,7 @@ IFACEMETHODIMP CanvasTextLayout::put_TrimmingGranularity(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource(); 
+            auto& resource = GetResourceForUpdate(); 
 
             DWRITE_TRIMMING trimming;
             ComPtr<IDWriteInlineObject> inlineObject;
@@ -513,7 +619,7 @@ IFACEMETHODIMP CanvasTextLayout::put_TrimmingDelimiter(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource(); 
+            auto& resource = GetResourceForUpdate(); 
 
             DWRITE_TRIMMING trimming;
             ComPtr<IDWriteInlineObject> inlineObject;
@@ -554,7 +660,7 @@ IFACEMETHODIMP CanvasTextLayout::put_TrimmingDelimiterCount(
         [&]
         {
             ThrowIfNegative(value);
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             DWRITE_TRIMMING trimming;
             ComPtr<IDWriteInlineObject> inlineObject;
@@ -614,7 +720,7 @@ IFACEMETHODIMP CanvasTextLayout::put_RequestedSize(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetMaxWidth(value.Width));
             ThrowIfFailed(resource->SetMaxHeight(value.Height));
@@ -811,7 +917,7 @@ IFACEMETHODIMP CanvasTextLayout::SetColor(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             auto textRange = ToDWriteTextRange(characterIndex, characterCount);
 
@@ -845,7 +951,7 @@ IFACEMETHODIMP CanvasTextLayout::SetFontFamily(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             auto uriAndFontFamily = GetUriAndFontFamily(WinString(fontFamilyName));
             auto const& uri = uriAndFontFamily.first;
@@ -868,7 +974,7 @@ IFACEMETHODIMP CanvasTextLayout::SetFontSize(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetFontSize(fontSize, ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -882,7 +988,7 @@ IFACEMETHODIMP CanvasTextLayout::SetFontStretch(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetFontStretch(ToFontStretch(fontStretch), ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -896,7 +1002,7 @@ IFACEMETHODIMP CanvasTextLayout::SetFontStyle(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetFontStyle(ToFontStyle(fontStyle), ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -910,7 +1016,7 @@ IFACEMETHODIMP CanvasTextLayout::SetFontWeight(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetFontWeight(ToFontWeight(fontWeight), ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -924,7 +1030,7 @@ IFACEMETHODIMP CanvasTextLayout::SetLocaleName(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             const wchar_t* localeNameBuffer = WindowsGetStringRawBuffer(name, nullptr);
 
@@ -940,7 +1046,7 @@ IFACEMETHODIMP CanvasTextLayout::SetStrikethrough(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetStrikethrough(hasStrikethrough, ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -954,7 +1060,7 @@ IFACEMETHODIMP CanvasTextLayout::SetUnderline(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetUnderline(hasUnderline, ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -988,7 +1094,7 @@ IFACEMETHODIMP CanvasTextLayout::SetPairKerning(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetPairKerning(hasPairKerning, ToDWriteTextRange(characterIndex, characterCount)));
         });
@@ -1064,7 +1170,7 @@ IFACEMETHODIMP CanvasTextLayout::SetCharacterSpacing(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetCharacterSpacing(
                 leadingSpacing, 
@@ -1094,7 +1200,7 @@ IFACEMETHODIMP CanvasTextLayout::put_VerticalGlyphOrientation(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetVerticalGlyphOrientation(ToVerticalGlyphOrientation(value)));
 
@@ -1122,7 +1228,7 @@ IFACEMETHODIMP CanvasTextLayout::put_OpticalAlignment(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetOpticalAlignment(ToOpticalAlignment(value)));
 
@@ -1151,7 +1257,7 @@ IFACEMETHODIMP CanvasTextLayout::put_LastLineWrapping(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ThrowIfFailed(resource->SetLastLineWrapping(value));
 
@@ -1179,7 +1285,7 @@ IFACEMETHODIMP CanvasTextLayout::put_TrimmingSign(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             m_trimmingSignInformation.SetTrimmingSignOnResource(value, resource.Get());
         });
@@ -1211,7 +1317,7 @@ IFACEMETHODIMP CanvasTextLayout::put_CustomTrimmingSign(
     return ExceptionBoundary(
         [&]
         {
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             auto dwriteInlineObject = Make<InternalDWriteInlineObject>(value, m_device.EnsureNotClosed());
             CheckMakeResult(dwriteInlineObject);
@@ -1235,36 +1341,7 @@ IFACEMETHODIMP CanvasTextLayout::get_LayoutBounds(Rect* value)
             DWRITE_TEXT_METRICS1 dwriteMetrics;
             ThrowIfFailed(resource->GetMetrics(&dwriteMetrics));
 
-            Rect rect{ dwriteMetrics.left, dwriteMetrics.top, dwriteMetrics.width, dwriteMetrics.height };
-
-            //
-            // There's an adjustment to do here because 'left' and 'top' fields of this 
-            // struct are not always computed in the same way.
-            //
-            // On left-to-right reading direction, for example, the 'left' field is the left layout bound
-            // and everything is straightforward. As for right-to-left reading direction, however, 'left'
-            // is equal to the {right layout bound- not reported directly} - {widthIncludingTrailingWhitespace}. 
-            // Since the width of the rect we return doesn't include whitespace, its left bound needs to be
-            // adjusted accordingly. Likewise goes for bottom-to-top reading direction.
-            //
-            // Note that on horizontal reading directions, heightIncludingTrailingWhitespace == height.
-            // And on vertical ones, widthIncludingTrailingWhitespace == width.
-            //
-
-            auto readingDirection = resource->GetReadingDirection();
-
-            if (readingDirection == DWRITE_READING_DIRECTION_RIGHT_TO_LEFT)
-            {
-                const float whitespace = dwriteMetrics.widthIncludingTrailingWhitespace - dwriteMetrics.width;
-                rect.X += whitespace;
-            }
-            else if (readingDirection == DWRITE_READING_DIRECTION_BOTTOM_TO_TOP)
-            {
-                const float whitespace = dwriteMetrics.heightIncludingTrailingWhitespace - dwriteMetrics.height;
-                rect.Y += whitespace;
-            }
-
-            *value = rect;
+            *value = GetLayoutBounds(dwriteMetrics, resource->GetReadingDirection());
         });
 }
 
@@ -1529,6 +1606,18 @@ IFACEMETHODIMP CanvasTextLayout::DrawToTextRendererWithCoords(
 
             auto& device = m_device.EnsureNotClosed();
 
+            if (m_cacheTextRendererCalls)
+            {
+                if (!m_textRendererRecording || !m_textRendererRecording->CanReplay(textRenderer, x, y))
+                {
+                    m_textRendererRecording.Reset();
+                    m_textRendererRecording = TextRendererRecording::Record(device.Get(), resource.Get(), textRenderer, x, y);
+                }
+
+                m_textRendererRecording->Replay(textRenderer, x, y);
+                return;
+            }
+
             auto dwriteTextRenderer = Make<InternalDWriteTextRenderer>(device, textRenderer);
             CheckMakeResult(dwriteTextRenderer);
 
@@ -1540,6 +1629,35 @@ IFACEMETHODIMP CanvasTextLayout::DrawToTextRendererWithCoords(
         });
 }
 
+IFACEMETHODIMP CanvasTextLayout::get_CacheTextRendererCalls(
+    boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            GetResource();
+
+            *value = m_cacheTextRendererCalls;
+        });
+}
+
+IFACEMETHODIMP CanvasTextLayout::put_CacheTextRendererCalls(
+    boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            GetResource();
+
+            m_cacheTextRendererCalls = !!value;
+
+            if (!m_cacheTextRendererCalls)
+                m_textRendererRecording.Reset();
+        });
+}
+
 
 
 IFACEMETHODIMP CanvasTextLayout::SetInlineObject(
@@ -1553,13 +1671,21 @@ IFACEMETHODIMP CanvasTextLayout::SetInlineObject(
             ThrowIfNegative(characterIndex);
             ThrowIfNegative(characterCount);
 
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ComPtr<IDWriteInlineObject> dwriteInlineObject;
             if (inlineObject)
             {
-                dwriteInlineObject = Make<InternalDWriteInlineObject>(inlineObject, m_device.EnsureNotClosed());
-                CheckMakeResult(dwriteInlineObject);
+                auto& wrapper = m_inlineObjectWrappers[inlineObject];
+
+                if (!wrapper)
+                {
+                    auto newWrapper = Make<InternalDWriteInlineObject>(inlineObject, m_device.EnsureNotClosed());
+                    CheckMakeResult(newWrapper);
+                    wrapper = newWrapper;
+                }
+
+                dwriteInlineObject = wrapper;
             }
 
             ThrowIfFailed(resource->SetInlineObject(dwriteInlineObject.Get(), ToDWriteTextRange(characterIndex, characterCount)));
@@ -1747,7 +1873,7 @@ void CanvasTextLayout::SetCustomBrushInternal(
     int32_t characterCount, 
     IInspectable* brush)
 {
-    auto& resource = GetResource();
+    auto& resource = GetResourceForUpdate();
 
     auto textRange = ToDWriteTextRange(characterIndex, characterCount);
 
@@ -1818,7 +1944,7 @@ IFACEMETHODIMP CanvasTextLayout::SetTypography(
             ThrowIfNegative(characterIndex);
             ThrowIfNegative(characterCount);
 
-            auto& resource = GetResource();
+            auto& resource = GetResourceForUpdate();
 
             ComPtr<IDWriteTypography> dwriteTypography;
 
@@ -1832,6 +1958,7 @@ IFACEMETHODIMP CanvasTextLayout::SetTypography(
 IFACEMETHODIMP CanvasTextLayout::Close()
 {
     m_device.Close();
+    m_inlineObjectWrappers.clear();
 
     return ResourceWrapper::Close();
 }
@@ -1854,7 +1981,7 @@ void CanvasTextLayout::SetLineSpacingModeInternal(CanvasLineSpacingMode lineSpac
 
 void CanvasTextLayout::SetTrimmingSignInternal(CanvasTrimmingSign trimmingSign)
 {
-    m_trimmingSignInformation.SetTrimmingSignOnResource(trimmingSign, GetResource().Get());
+    m_trimmingSignInformation.SetTrimmingSignOnResource(trimmingSign, GetResourceForUpdate().Get());
 }
 
 
@@ -1871,4 +1998,20 @@ void CanvasTextLayout::EnsureCustomTrimmingSignDevice(IDWriteTextLayout2* layout
     internalDWriteInlineObject->SetDevice(device);
 }
 
+void CanvasTextLayout::PrecomputeLayout()
+{
+    auto& resource = GetResource();
+
+    // LayoutBounds and LineMetrics both read from the results of laying out
+    // the text, which DirectWrite keeps until the layout is changed.
+    DWRITE_TEXT_METRICS1 metrics;
+    ThrowIfFailed(resource->GetMetrics(&metrics));
+
+    uint32_t lineCount;
+    HRESULT hr = resource->GetLineMetrics(static_cast<DWriteMetricsType*>(nullptr), 0, &lineCount);
+
+    if (FAILED(hr) && hr != E_NOT_SUFFICIENT_BUFFER)
+        ThrowHR(hr);
+}
+
 ActivatableClassWithFactory(CanvasTextLayout, CanvasTextLayoutFactory);
@@ -6,6 +6,7 @@
 
 #include "CustomFontManager.h"
 #include "TrimmingSignInformation.h"
+#include "TextRendererRecording.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
 {
@@ -19,11 +20,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     typedef DWRITE_LINE_METRICS DWriteMetricsType;
 #endif
 
+    //
+    // CanvasTextLayout has no lock of its own.  A layout may be created on
+    // one thread and then used on another, but must not be used from two
+    // threads at the same time.
+    //
     class CanvasTextLayout : RESOURCE_WRAPPER_RUNTIME_CLASS(
         DWriteTextLayoutType,
         CanvasTextLayout,
         ICanvasTextLayout,
         CloakedIid<ICanvasResourceWrapperWithDevice>)
+        , private ObjectCounter<CountedObjectType::TextLayout>
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasTextLayout, BaseTrust);
 
@@ -37,6 +44,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         TrimmingSignInformation m_trimmingSignInformation;
 
+        // Inline objects set on several ranges share one wrapper.
+        std::unordered_map<ICanvasTextInlineObject*, ComPtr<IDWriteInlineObject>> m_inlineObjectWrappers;
+
+        bool m_cacheTextRendererCalls;
+        ComPtr<TextRendererRecording> m_textRendererRecording;
+
     public:
         static ComPtr<CanvasTextLayout> CreateNew(
             ICanvasResourceCreator* resourceCreator,
@@ -45,6 +58,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float requestedWidth,
             float requestedHeight);
 
+        static ComPtr<CanvasTextLayout> CreateNew(
+            ICanvasResourceCreator* resourceCreator,
+            wchar_t const* text,
+            uint32_t textLength,
+            ICanvasTextFormat* textFormat,
+            float requestedWidth,
+            float requestedHeight);
+
         CanvasTextLayout(
             ICanvasDevice* device,
             DWriteTextLayoutType* layout);
@@ -370,6 +391,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float x,
             float y)) override;
 
+        IFACEMETHOD(get_CacheTextRendererCalls)(
+            boolean* value) override;
+
+        IFACEMETHOD(put_CacheTextRendererCalls)(
+            boolean value) override;
+
         IFACEMETHOD(SetInlineObject)(
             int32_t characterIndex,
             int32_t characterCount,
@@ -422,7 +449,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         void EnsureCustomTrimmingSignDevice(IDWriteTextLayout2* layout, ICanvasDevice* device);
 
+        // DirectWrite lays text out the first time something asks about
+        // it.  This asks, so the work happens on the calling thread.
+        void PrecomputeLayout();
+
     private:
+        // Anything that changes the layout must go through this, so a
+        // recording of the old layout is not replayed.
+        ComPtr<DWriteTextLayoutType> const& GetResourceForUpdate();
+
         ComPtr<IInspectable> GetCustomBrushInternal(int32_t characterIndex);
 
         void SetCustomBrushInternal(
@@ -437,7 +472,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     //
 
     class CanvasTextLayoutFactory
-        : public AgileActivationFactory<ICanvasTextLayoutFactory, ICanvasTextLayoutStatics>
+        : public AgileActivationFactory<ICanvasTextLayoutFactory, ICanvasTextLayoutStatics, CloakedIid<ICanvasTextLayoutFactoryNative>>
         , private LifespanTracker<CanvasTextLayoutFactory>
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasTextLayout, BaseTrust);
@@ -456,5 +491,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             boolean isSideways,
             Vector2 position,
             Matrix3x2* transform) override;
+
+        IFACEMETHOD(CreateAsync)(
+            ICanvasResourceCreator* resourceCreator,
+            HSTRING textString,
+            ICanvasTextFormat* textFormat,
+            float requestedWidth,
+            float requestedHeight,
+            ABI::Windows::Foundation::IAsyncOperation<CanvasTextLayout*>** canvasTextLayout) override;
+
+        //
+        // ICanvasTextLayoutFactoryNative
+        //
+
+        IFACEMETHOD(CreateFromBuffer)(
+            IUnknown* resourceCreator,
+            wchar_t const* text,
+            UINT32 textLength,
+            IUnknown* textFormat,
+            float requestedWidth,
+            float requestedHeight,
+            IInspectable** textLayout) override;
     };
 }}}}}
@@ -7,6 +7,7 @@
 #include "pch.h"
 
 #include "CustomFontManager.h"
+#include "TextUtilities.h"
 
 using namespace ABI::Microsoft::Graphics::Canvas::Text;
 
@@ -96,6 +97,7 @@ public:
 
 CustomFontManager::CustomFontManager()
     : m_adapter(CustomFontManagerAdapter::GetInstance())
+    , m_fontCollectionCacheCapacity(DefaultFontCollectionCacheCapacity)
 {
     ThrowIfFailed(GetActivationFactory(
         HStringReference(RuntimeClass_Windows_Foundation_Uri).Get(),
@@ -156,19 +158,79 @@ ComPtr<IDWriteFontCollection> CustomFontManager::GetFontCollectionFromUri(WinStr
         return nullptr;
     }
 
+    {
+        Lock lock(m_fontCollectionMutex);
+
+        auto it = m_fontCollectionsByUri.find(static_cast<wchar_t const*>(uri));
+
+        if (it != m_fontCollectionsByUri.end())
+        {
+            m_fontCollections.splice(m_fontCollections.begin(), m_fontCollections, it->second);
+            return it->second->Collection;
+        }
+    }
+
     auto path = GetAbsolutePathFromUri(uri);
 
-    return GetFontCollectionFromPath(path);
+    return GetFontCollectionFromPath(path, uri);
 }
 
 ComPtr<IDWriteFontCollection> CustomFontManager::GetFontCollectionFromUri(IUriRuntimeClass* uri)
 {
     auto path = GetAbsolutePathFromUri(uri);
 
-    return GetFontCollectionFromPath(path);
+    return GetFontCollectionFromPath(path, WinString());
 }
 
-ComPtr<IDWriteFontCollection> CustomFontManager::GetFontCollectionFromPath(WinString& path)
+ComPtr<IDWriteFontCollection> CustomFontManager::GetFontCollectionFromPath(WinString& path, WinString const& uri)
+{
+    std::wstring pathKey(begin(path), end(path));
+
+    {
+        Lock lock(m_fontCollectionMutex);
+
+        auto it = m_fontCollectionsByPath.find(pathKey);
+
+        if (it != m_fontCollectionsByPath.end())
+        {
+            if (uri != WinString() && m_fontCollectionsByUri.emplace(static_cast<wchar_t const*>(uri), it->second).second)
+                it->second->Uris.push_back(static_cast<wchar_t const*>(uri));
+
+            m_fontCollections.splice(m_fontCollections.begin(), m_fontCollections, it->second);
+            return it->second->Collection;
+        }
+    }
+
+    auto collection = CreateFontCollectionFromPath(path);
+
+    Lock lock(m_fontCollectionMutex);
+
+    // If another thread loaded the same path meanwhile, keep theirs so
+    // that formats using the path share one collection.
+    auto it = m_fontCollectionsByPath.find(pathKey);
+
+    if (it == m_fontCollectionsByPath.end())
+    {
+        if (m_fontCollectionCacheCapacity == 0)
+            return collection;
+
+        EvictFontCollectionsToCount(lock, m_fontCollectionCacheCapacity - 1);
+
+        m_fontCollections.push_front(FontCollectionEntry{ pathKey, {}, collection });
+        it = m_fontCollectionsByPath.emplace(std::move(pathKey), m_fontCollections.begin()).first;
+    }
+    else
+    {
+        m_fontCollections.splice(m_fontCollections.begin(), m_fontCollections, it->second);
+    }
+
+    if (uri != WinString() && m_fontCollectionsByUri.emplace(static_cast<wchar_t const*>(uri), it->second).second)
+        it->second->Uris.push_back(static_cast<wchar_t const*>(uri));
+
+    return it->second->Collection;
+}
+
+ComPtr<IDWriteFontCollection> CustomFontManager::CreateFontCollectionFromPath(WinString& path)
 {
     auto pathBegin = begin(path);
     auto pathEnd = end(path);
@@ -186,6 +248,152 @@ ComPtr<IDWriteFontCollection> CustomFontManager::GetFontCollectionFromPath(WinSt
     return collection;
 }
 
+uint32_t CustomFontManager::GetFontCollectionCacheCapacity()
+{
+    Lock lock(m_fontCollectionMutex);
+
+    return m_fontCollectionCacheCapacity;
+}
+
+void CustomFontManager::SetFontCollectionCacheCapacity(uint32_t value)
+{
+    Lock lock(m_fontCollectionMutex);
+
+    m_fontCollectionCacheCapacity = value;
+    EvictFontCollectionsToCount(lock, value);
+}
+
+void CustomFontManager::EvictFontCollectionsToCount(Lock const& lock, uint32_t count)
+{
+    MustOwnLock(lock);
+
+    while (m_fontCollections.size() > count)
+    {
+        auto& entry = m_fontCollections.back();
+
+        for (auto& uri : entry.Uris)
+            m_fontCollectionsByUri.erase(uri);
+
+        m_fontCollectionsByPath.erase(entry.Path);
+        m_fontCollections.pop_back();
+    }
+}
+
+size_t CustomFontManager::NumberSubstitutionKeyHash::operator()(NumberSubstitutionKey const& key) const
+{
+    size_t hash = std::hash<std::wstring>()(key.LocaleName);
+
+    hash ^= std::hash<int>()(key.Method) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<bool>()(key.IgnoreUserOverride) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+    return hash;
+}
+
+size_t CustomFontManager::EllipsisTrimmingSignKeyHash::operator()(EllipsisTrimmingSignKey const& key) const
+{
+    size_t hash = std::hash<std::wstring>()(key.FontFamilyName);
+
+    hash ^= std::hash<std::wstring>()(key.LocaleName) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<void*>()(key.FontCollection.Get()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<float>()(key.FontSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.FontWeight) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.FontStyle) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.FontStretch) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.ReadingDirection) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.FlowDirection) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.VerticalGlyphOrientation) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+    return hash;
+}
+
+ComPtr<IDWriteNumberSubstitution> CustomFontManager::GetInternedNumberSubstitution(
+    DWRITE_NUMBER_SUBSTITUTION_METHOD method,
+    wchar_t const* localeName,
+    bool ignoreUserOverride)
+{
+    NumberSubstitutionKey key{ method, localeName ? localeName : L"", ignoreUserOverride };
+
+    {
+        Lock lock(m_internMutex);
+
+        auto it = m_numberSubstitutions.find(key);
+
+        if (it != m_numberSubstitutions.end())
+            return it->second;
+    }
+
+    ComPtr<IDWriteNumberSubstitution> numberSubstitution;
+    ThrowIfFailed(GetSharedFactory()->CreateNumberSubstitution(
+        method,
+        localeName,
+        ignoreUserOverride,
+        &numberSubstitution));
+
+    // Number substitutions can't be changed, and there are only as many
+    // as there are distinct locales in use, so they are never evicted.
+    Lock lock(m_internMutex);
+
+    return m_numberSubstitutions.emplace(std::move(key), numberSubstitution).first->second;
+}
+
+ComPtr<IDWriteInlineObject> CustomFontManager::GetInternedEllipsisTrimmingSign(IDWriteTextFormat* textFormat)
+{
+    ComPtr<IDWriteFontCollection> fontCollection;
+    ThrowIfFailed(textFormat->GetFontCollection(&fontCollection));
+
+    auto textFormat1 = MaybeAs<IDWriteTextFormat1>(textFormat);
+
+    EllipsisTrimmingSignKey key
+    {
+        fontCollection,
+        static_cast<wchar_t const*>(GetFontFamilyName(textFormat)),
+        static_cast<wchar_t const*>(GetLocaleName(textFormat)),
+        textFormat->GetFontWeight(),
+        textFormat->GetFontStyle(),
+        textFormat->GetFontStretch(),
+        textFormat->GetFontSize(),
+        textFormat->GetReadingDirection(),
+        textFormat->GetFlowDirection(),
+        textFormat1 ? textFormat1->GetVerticalGlyphOrientation() : DWRITE_VERTICAL_GLYPH_ORIENTATION_DEFAULT
+    };
+
+    {
+        Lock lock(m_internMutex);
+
+        auto it = m_ellipsisTrimmingSignsByKey.find(key);
+
+        if (it != m_ellipsisTrimmingSignsByKey.end())
+        {
+            m_ellipsisTrimmingSigns.splice(m_ellipsisTrimmingSigns.begin(), m_ellipsisTrimmingSigns, it->second);
+            return it->second->TrimmingSign;
+        }
+    }
+
+    ComPtr<IDWriteInlineObject> trimmingSign;
+    ThrowIfFailed(GetSharedFactory()->CreateEllipsisTrimmingSign(textFormat, &trimmingSign));
+
+    Lock lock(m_internMutex);
+
+    auto it = m_ellipsisTrimmingSignsByKey.find(key);
+
+    if (it != m_ellipsisTrimmingSignsByKey.end())
+    {
+        m_ellipsisTrimmingSigns.splice(m_ellipsisTrimmingSigns.begin(), m_ellipsisTrimmingSigns, it->second);
+        return it->second->TrimmingSign;
+    }
+
+    while (m_ellipsisTrimmingSigns.size() >= InternedEllipsisTrimmingSignCapacity)
+    {
+        m_ellipsisTrimmingSignsByKey.erase(m_ellipsisTrimmingSigns.back().Key);
+        m_ellipsisTrimmingSigns.pop_back();
+    }
+
+    m_ellipsisTrimmingSigns.push_front(EllipsisTrimmingSignEntry{ key, trimmingSign });
+    m_ellipsisTrimmingSignsByKey.emplace(std::move(key), m_ellipsisTrimmingSigns.begin());
+
+    return trimmingSign;
+}
+
 ComPtr<IDWriteFactory> const& CustomFontManager::GetIsolatedFactory()
 {
     RecursiveLock lock(m_mutex);
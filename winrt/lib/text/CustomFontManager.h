@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "FontFallbackCache.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
 {
     class DefaultCustomFontManagerAdapter;
@@ -29,6 +31,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     };
 
 
+    //
+    // Custom font collections are cached, since resolving an app URI to a
+    // path and enumerating the font file are both slow, and every
+    // CanvasTextFormat that names a font by URI needs a collection when it
+    // is realized.  The least recently used collections beyond the cache
+    // capacity are released.
+    //
+    // Entries are found by resolved path, and also by each URI string that
+    // resolved to that path, so that a hit does no URI resolution at all.
+    // The cache has its own mutex, which is only held while looking up or
+    // inserting entries; resolving and loading happen outside it.
+    //
+    // Number substitution objects made from the shared factory are
+    // interned by content, since they can't be changed once created.
+    // Ellipsis trimming signs are interned the same way, by the font
+    // properties of the format they were made from.  Typographies are not
+    // interned: layouts hand theirs back out through GetTypography, where
+    // AddFeature would change every other layout sharing it.
+    //
     class CustomFontManager : public Singleton<CustomFontManager>
     {
         std::shared_ptr<CustomFontManagerAdapter> m_adapter;
@@ -40,14 +61,103 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<IDWriteFontCollectionLoader> m_customLoader;
         ComPtr<IDWriteTextAnalyzer2> m_textAnalyzer;
         ComPtr<IDWriteFontFallback> m_systemFontFallback;
+        FontFallbackCache m_fontFallbackCache;
+
+        struct FontCollectionEntry
+        {
+            std::wstring Path;
+            std::vector<std::wstring> Uris;
+            ComPtr<IDWriteFontCollection> Collection;
+        };
+
+        typedef std::list<FontCollectionEntry> FontCollectionList;
+
+        std::mutex m_fontCollectionMutex;
+        FontCollectionList m_fontCollections;                                       // Most recently used at the front.
+        std::unordered_map<std::wstring, FontCollectionList::iterator> m_fontCollectionsByPath;
+        std::unordered_map<std::wstring, FontCollectionList::iterator> m_fontCollectionsByUri;
+        uint32_t m_fontCollectionCacheCapacity;
+
+        struct NumberSubstitutionKey
+        {
+            DWRITE_NUMBER_SUBSTITUTION_METHOD Method;
+            std::wstring LocaleName;
+            bool IgnoreUserOverride;
+
+            bool operator==(NumberSubstitutionKey const& other) const
+            {
+                return Method == other.Method &&
+                       LocaleName == other.LocaleName &&
+                       IgnoreUserOverride == other.IgnoreUserOverride;
+            }
+        };
+
+        struct NumberSubstitutionKeyHash
+        {
+            size_t operator()(NumberSubstitutionKey const& key) const;
+        };
+
+        // The properties of a text format that an ellipsis trimming sign
+        // copies when it is created.
+        struct EllipsisTrimmingSignKey
+        {
+            ComPtr<IDWriteFontCollection> FontCollection;
+            std::wstring FontFamilyName;
+            std::wstring LocaleName;
+            DWRITE_FONT_WEIGHT FontWeight;
+            DWRITE_FONT_STYLE FontStyle;
+            DWRITE_FONT_STRETCH FontStretch;
+            float FontSize;
+            DWRITE_READING_DIRECTION ReadingDirection;
+            DWRITE_FLOW_DIRECTION FlowDirection;
+            DWRITE_VERTICAL_GLYPH_ORIENTATION VerticalGlyphOrientation;
+
+            bool operator==(EllipsisTrimmingSignKey const& other) const
+            {
+                return FontCollection == other.FontCollection &&
+                       FontWeight == other.FontWeight &&
+                       FontStyle == other.FontStyle &&
+                       FontStretch == other.FontStretch &&
+                       FontSize == other.FontSize &&
+                       ReadingDirection == other.ReadingDirection &&
+                       FlowDirection == other.FlowDirection &&
+                       VerticalGlyphOrientation == other.VerticalGlyphOrientation &&
+                       FontFamilyName == other.FontFamilyName &&
+                       LocaleName == other.LocaleName;
+            }
+        };
+
+        struct EllipsisTrimmingSignKeyHash
+        {
+            size_t operator()(EllipsisTrimmingSignKey const& key) const;
+        };
+
+        struct EllipsisTrimmingSignEntry
+        {
+            EllipsisTrimmingSignKey Key;
+            ComPtr<IDWriteInlineObject> TrimmingSign;
+        };
+
+        typedef std::list<EllipsisTrimmingSignEntry> EllipsisTrimmingSignList;
+
+        std::mutex m_internMutex;
+        std::unordered_map<NumberSubstitutionKey, ComPtr<IDWriteNumberSubstitution>, NumberSubstitutionKeyHash> m_numberSubstitutions;
+        EllipsisTrimmingSignList m_ellipsisTrimmingSigns;                           // Most recently used at the front.
+        std::unordered_map<EllipsisTrimmingSignKey, EllipsisTrimmingSignList::iterator, EllipsisTrimmingSignKeyHash> m_ellipsisTrimmingSignsByKey;
 
     public:
+        static const uint32_t DefaultFontCollectionCacheCapacity = 16;
+        static const uint32_t InternedEllipsisTrimmingSignCapacity = 64;
+
         CustomFontManager();
 
         ComPtr<IDWriteFontCollection> GetFontCollectionFromUri(WinString const& uri);
 
         ComPtr<IDWriteFontCollection> GetFontCollectionFromUri(IUriRuntimeClass* uri);
 
+        uint32_t GetFontCollectionCacheCapacity();
+        void SetFontCollectionCacheCapacity(uint32_t value);
+
         void ValidateUri(WinString const& uriString);
 
         ComPtr<IDWriteFactory> const& GetSharedFactory();
@@ -56,6 +166,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ComPtr<IDWriteFontFallback> const& GetSystemFontFallback();
 
+        // Fonts previously picked by the system font fallback.
+        FontFallbackCache& GetFontFallbackCache() { return m_fontFallbackCache; }
+
+        ComPtr<IDWriteNumberSubstitution> GetInternedNumberSubstitution(
+            DWRITE_NUMBER_SUBSTITUTION_METHOD method,
+            wchar_t const* localeName,
+            bool ignoreUserOverride);
+
+        // Returns an ellipsis trimming sign for this format, shared with
+        // every other format that has the same font, directions and glyph
+        // orientation.
+        ComPtr<IDWriteInlineObject> GetInternedEllipsisTrimmingSign(IDWriteTextFormat* textFormat);
+
     private:
         ComPtr<IDWriteFactory> const& GetIsolatedFactory();
 
@@ -63,7 +186,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         WinString GetAbsolutePathFromUri(IUriRuntimeClass* uri);
 
-        ComPtr<IDWriteFontCollection> GetFontCollectionFromPath(WinString& path);
+        ComPtr<IDWriteFontCollection> GetFontCollectionFromPath(WinString& path, WinString const& uri);
+
+        ComPtr<IDWriteFontCollection> CreateFontCollectionFromPath(WinString& path);
+
+        void EvictFontCollectionsToCount(Lock const& lock, uint32_t count);
 
     };
 }}}}}
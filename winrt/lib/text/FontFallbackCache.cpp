@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "FontFallbackCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    uint32_t FontFallbackCache::TryMapCharacters(BaseFont const& baseFont, wchar_t const* text, uint32_t textLength, Mapping* mapping)
+    {
+        if (textLength == 0 || !IsCacheable(text, textLength, 0))
+            return 0;
+
+        Lock lock(m_mutex);
+
+        auto entry = Find(lock, baseFont);
+
+        if (entry == m_entries.end())
+            return 0;
+
+        auto& characters = entry->Characters;
+        auto it = characters.find(text[0]);
+
+        if (it == characters.end())
+            return 0;
+
+        *mapping = it->second;
+
+        uint32_t mappedLength = 1;
+
+        while (mappedLength < textLength && IsCacheable(text, textLength, mappedLength))
+        {
+            auto next = characters.find(text[mappedLength]);
+
+            if (next == characters.end() ||
+                next->second.Font != mapping->Font ||
+                next->second.Scale != mapping->Scale)
+            {
+                break;
+            }
+
+            mappedLength++;
+        }
+
+        return mappedLength;
+    }
+
+
+    void FontFallbackCache::AddMapping(BaseFont const& baseFont, wchar_t const* text, uint32_t textLength, uint32_t mappedLength, Mapping const& mapping)
+    {
+        Lock lock(m_mutex);
+
+        auto entry = Find(lock, baseFont);
+
+        if (entry == m_entries.end())
+        {
+            if (m_entries.size() >= BaseFontCapacity)
+                m_entries.pop_back();
+
+            m_entries.push_front(Entry{ baseFont });
+            entry = m_entries.begin();
+        }
+
+        for (uint32_t i = 0; i < mappedLength && i < textLength; i++)
+        {
+            if (IsCacheable(text, textLength, i))
+                entry->Characters[text[i]] = mapping;
+        }
+    }
+
+
+    void FontFallbackCache::Clear()
+    {
+        Lock lock(m_mutex);
+
+        m_entries.clear();
+    }
+
+
+    FontFallbackCache::EntryList::iterator FontFallbackCache::Find(Lock const& lock, BaseFont const& baseFont)
+    {
+        MustOwnLock(lock);
+
+        auto it = std::find_if(m_entries.begin(), m_entries.end(),
+            [&](Entry const& entry) { return entry.Key == baseFont; });
+
+        if (it != m_entries.end())
+            m_entries.splice(m_entries.begin(), m_entries, it);
+
+        return it;
+    }
+
+
+    bool FontFallbackCache::IsCacheable(wchar_t const* text, uint32_t textLength, uint32_t index)
+    {
+        if (!CanBeMappedOnItsOwn(text[index]))
+            return false;
+
+        // A following combining mark, joiner etc. may pull this character
+        // into a cluster that DirectWrite maps as a whole.
+        return index + 1 >= textLength || CanBeMappedOnItsOwn(text[index + 1]);
+    }
+
+
+    bool FontFallbackCache::CanBeMappedOnItsOwn(wchar_t c)
+    {
+        if (IS_HIGH_SURROGATE(c) || IS_LOW_SURROGATE(c))
+            return false;
+
+        if (c == 0x200C || c == 0x200D)                             // Zero width non-joiner and joiner
+            return false;
+
+        if (c >= 0xFE00 && c <= 0xFE0F)                             // Variation selectors
+            return false;
+
+        if ((c >= 0x1100 && c <= 0x11FF) ||                         // Hangul jamo
+            (c >= 0xA960 && c <= 0xA97F) ||
+            (c >= 0xD7B0 && c <= 0xD7FF))
+        {
+            return false;
+        }
+
+        WORD type;
+        if (!GetStringTypeW(CT_CTYPE3, &c, 1, &type))
+            return false;
+
+        return (type & (C3_NONSPACING | C3_DIACRITIC | C3_VOWELMARK)) == 0;
+    }
+}}}}}
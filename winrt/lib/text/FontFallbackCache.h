@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    //
+    // Remembers which fonts IDWriteFontFallback::MapCharacters picked for
+    // individual characters, so that analyzing many strings against the same
+    // base font (eg. a mixed-script UI) only asks DirectWrite about characters
+    // it hasn't seen before.
+    //
+    // Mappings are recorded per base font - the collection, family name,
+    // weight, style, stretch and locale passed to MapCharacters - and then
+    // per character.  They are not recorded per script or Unicode range:
+    // fallback fonts only cover parts of most scripts, so two characters of
+    // one script can legitimately map to different fonts.
+    //
+    // The font chosen for a character can also depend on its neighbours,
+    // since DirectWrite keeps clusters together.  So only BMP characters that
+    // are neither combining marks nor joiners, variation selectors or Hangul
+    // jamo are cached, and a cached mapping is only used when the character
+    // after it is of that kind too.  Anything else goes to DirectWrite.
+    //
+    // The least recently used base fonts are forgotten once there are more
+    // than BaseFontCapacity of them.
+    //
+    class FontFallbackCache
+    {
+    public:
+        struct BaseFont
+        {
+            ComPtr<IDWriteFontCollection> Collection;
+            std::wstring FamilyName;
+            DWRITE_FONT_WEIGHT Weight;
+            DWRITE_FONT_STYLE Style;
+            DWRITE_FONT_STRETCH Stretch;
+            std::wstring LocaleName;
+
+            bool operator==(BaseFont const& other) const
+            {
+                return Collection == other.Collection &&
+                       Weight == other.Weight &&
+                       Style == other.Style &&
+                       Stretch == other.Stretch &&
+                       FamilyName == other.FamilyName &&
+                       LocaleName == other.LocaleName;
+            }
+        };
+
+        struct Mapping
+        {
+            ComPtr<IDWriteFont> Font;   // Null if no font in the collection has the character.
+            float Scale;
+        };
+
+        static const uint32_t BaseFontCapacity = 16;
+
+        FontFallbackCache() = default;
+
+        FontFallbackCache(FontFallbackCache const&) = delete;
+        FontFallbackCache& operator=(FontFallbackCache const&) = delete;
+
+        // Looks up a run of characters at the start of text that all have the
+        // same cached mapping.  Returns the length of the run, or zero if the
+        // first character must be mapped by DirectWrite.
+        uint32_t TryMapCharacters(BaseFont const& baseFont, wchar_t const* text, uint32_t textLength, Mapping* mapping);
+
+        // Records that DirectWrite mapped the first mappedLength characters of
+        // text to this font.
+        void AddMapping(BaseFont const& baseFont, wchar_t const* text, uint32_t textLength, uint32_t mappedLength, Mapping const& mapping);
+
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            BaseFont Key;
+            std::unordered_map<wchar_t, Mapping> Characters;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+        EntryList m_entries;                                                // Most recently used at the front.
+
+        EntryList::iterator Find(Lock const& lock, BaseFont const& baseFont);
+
+        static bool IsCacheable(wchar_t const* text, uint32_t textLength, uint32_t index);
+        static bool CanBeMappedOnItsOwn(wchar_t c);
+    };
+}}}}}
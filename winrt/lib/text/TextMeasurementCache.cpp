@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "TextMeasurementCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    size_t TextMeasurementCache::ComputeHash(CacheKey const& key)
+    {
+        size_t hash = std::hash<std::wstring>()(key.Text);
+
+        hash ^= std::hash<float>()(key.Width) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+        return hash;
+    }
+
+
+    TextMeasurementCache::TextMeasurementCache()
+        : m_maximumCount(DefaultMaximumCount)
+        , m_formatVersion(0)
+        , m_hitCount(0)
+        , m_missCount(0)
+        , m_evictionCount(0)
+    {
+    }
+
+
+    bool TextMeasurementCache::TryGet(CacheKey const& key, uint64_t formatVersion, CanvasTextMeasurement* measurement)
+    {
+        Lock lock(m_mutex);
+
+        if (formatVersion > m_formatVersion)
+        {
+            // Everything cached was measured with an older version of the format.
+            EvictToCount(lock, 0);
+            m_formatVersion = formatVersion;
+        }
+        else if (formatVersion == m_formatVersion && formatVersion != 0)
+        {
+            auto it = m_entryMap.find(key);
+
+            if (it != m_entryMap.end())
+            {
+                m_hitCount++;
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                *measurement = it->second->Measurement;
+                return true;
+            }
+        }
+
+        m_missCount++;
+        return false;
+    }
+
+
+    void TextMeasurementCache::Add(CacheKey&& key, uint64_t formatVersion, CanvasTextMeasurement const& measurement)
+    {
+        Lock lock(m_mutex);
+
+        // Don't cache anything if the format changed while we were measuring,
+        // or if it can be changed without us knowing.
+        if (formatVersion == 0 || formatVersion != m_formatVersion || m_maximumCount == 0)
+            return;
+
+        // Another thread may have measured the same text in the meantime.
+        if (m_entryMap.find(key) != m_entryMap.end())
+            return;
+
+        EvictToCount(lock, m_maximumCount - 1);
+
+        m_entries.push_front(Entry{ key, measurement });
+        m_entryMap.emplace(std::move(key), m_entries.begin());
+    }
+
+
+    TextMeasurementCache::Statistics TextMeasurementCache::GetStatistics()
+    {
+        Lock lock(m_mutex);
+
+        return Statistics
+        {
+            static_cast<uint32_t>(m_entries.size()),
+            m_hitCount,
+            m_missCount,
+            m_evictionCount
+        };
+    }
+
+
+    uint32_t TextMeasurementCache::GetMaximumCount()
+    {
+        Lock lock(m_mutex);
+
+        return m_maximumCount;
+    }
+
+
+    void TextMeasurementCache::SetMaximumCount(uint32_t value)
+    {
+        Lock lock(m_mutex);
+
+        m_maximumCount = value;
+        EvictToCount(lock, value);
+    }
+
+
+    void TextMeasurementCache::Clear()
+    {
+        Lock lock(m_mutex);
+
+        EvictToCount(lock, 0);
+    }
+
+
+    void TextMeasurementCache::EvictToCount(Lock const& lock, uint32_t count)
+    {
+        MustOwnLock(lock);
+
+        while (m_entries.size() > count)
+        {
+            auto& entry = m_entries.back();
+
+            m_entryMap.erase(entry.Key);
+            m_entries.pop_back();
+
+            m_evictionCount++;
+        }
+    }
+}}}}}
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    //
+    // Per-format cache of the results of CanvasTextFormat.Measure.
+    //
+    // Virtualized lists measure thousands of items to find out how tall they
+    // are, long before (if ever) drawing them.  Unlike TextLayoutCache, this
+    // only keeps the measurements, not the IDWriteTextLayout they came from,
+    // so an entry costs little more than its text.
+    //
+    // Entries are keyed on the text and the maximum width.  The cache belongs
+    // to one CanvasTextFormat, so the format itself is not part of the key:
+    // instead the cache remembers the realized format version its entries
+    // were measured with, and throws them all away when that changes.  A
+    // version of zero means the format may be changed through interop without
+    // us knowing, so such measurements are never cached.
+    //
+    // Once full, the least recently used entries are released.
+    //
+    class TextMeasurementCache
+    {
+        struct CacheKey
+        {
+            std::wstring Text;
+            float Width;
+            size_t Hash;
+
+            bool operator==(CacheKey const& other) const
+            {
+                return Hash == other.Hash &&
+                       Width == other.Width &&
+                       Text == other.Text;
+            }
+        };
+
+        struct CacheKeyHash
+        {
+            size_t operator()(CacheKey const& key) const
+            {
+                return key.Hash;
+            }
+        };
+
+        struct Entry
+        {
+            CacheKey Key;
+            CanvasTextMeasurement Measurement;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+        EntryList m_entries;                                                // Most recently used at the front.
+        std::unordered_map<CacheKey, EntryList::iterator, CacheKeyHash> m_entryMap;
+        uint32_t m_maximumCount;
+        uint64_t m_formatVersion;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+    public:
+        static const uint32_t DefaultMaximumCount = 1024;
+
+        struct Statistics
+        {
+            uint32_t Count;
+            uint64_t HitCount;          // Calls to GetOrMeasure that found a cached measurement.
+            uint64_t MissCount;         // Calls to GetOrMeasure that had to measure.
+            uint64_t EvictionCount;
+        };
+
+        TextMeasurementCache();
+
+        TextMeasurementCache(TextMeasurementCache const&) = delete;
+        TextMeasurementCache& operator=(TextMeasurementCache const&) = delete;
+
+        // Returns the cached measurement of this text at this width, or calls
+        // measure (outside the cache lock) and caches what it returns.
+        template<typename FN>
+        CanvasTextMeasurement GetOrMeasure(
+            wchar_t const* text,
+            uint32_t textLength,
+            uint64_t formatVersion,
+            float width,
+            FN&& measure)
+        {
+            CacheKey key{ std::wstring(text, textLength), width };
+            key.Hash = ComputeHash(key);
+
+            CanvasTextMeasurement measurement;
+
+            if (TryGet(key, formatVersion, &measurement))
+                return measurement;
+
+            measurement = measure();
+
+            Add(std::move(key), formatVersion, measurement);
+
+            return measurement;
+        }
+
+        Statistics GetStatistics();
+
+        uint32_t GetMaximumCount();
+        void SetMaximumCount(uint32_t value);
+
+        void Clear();
+
+    private:
+        static size_t ComputeHash(CacheKey const& key);
+
+        bool TryGet(CacheKey const& key, uint64_t formatVersion, CanvasTextMeasurement* measurement);
+        void Add(CacheKey&& key, uint64_t formatVersion, CanvasTextMeasurement const& measurement);
+
+        void EvictToCount(Lock const& lock, uint32_t count);
+    };
+}}}}}
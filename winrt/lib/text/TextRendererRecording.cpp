@@ -0,0 +1,321 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "TextRendererRecording.h"
+#include "InternalDWriteTextRenderer.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+using namespace ABI::Microsoft::Graphics::Canvas::Text;
+
+
+ComPtr<TextRendererRecording> TextRendererRecording::Record(
+    ICanvasDevice* device,
+    IDWriteTextLayout* layout,
+    ICanvasTextRenderer* textRenderer,
+    float x,
+    float y)
+{
+    bool pixelSnappingDisabled;
+    float dpi;
+    Matrix3x2 transform;
+    GetRendererState(textRenderer, &pixelSnappingDisabled, &dpi, &transform);
+
+    auto position = pixelSnappingDisabled ? Vector2{ 0, 0 } : Vector2{ x, y };
+
+    auto recording = Make<TextRendererRecording>(pixelSnappingDisabled, dpi, transform, position);
+    CheckMakeResult(recording);
+
+    auto dwriteTextRenderer = Make<InternalDWriteTextRenderer>(device, recording.Get());
+    CheckMakeResult(dwriteTextRenderer);
+
+    ThrowIfFailed(layout->Draw(nullptr, dwriteTextRenderer.Get(), position.X, position.Y));
+
+    return recording;
+}
+
+
+TextRendererRecording::TextRendererRecording(bool pixelSnappingDisabled, float dpi, Matrix3x2 const& transform, Vector2 position)
+    : m_pixelSnappingDisabled(pixelSnappingDisabled)
+    , m_dpi(dpi)
+    , m_transform(transform)
+    , m_position(position)
+{
+}
+
+
+bool TextRendererRecording::CanReplay(ICanvasTextRenderer* textRenderer, float x, float y)
+{
+    bool pixelSnappingDisabled;
+    float dpi;
+    Matrix3x2 transform;
+    GetRendererState(textRenderer, &pixelSnappingDisabled, &dpi, &transform);
+
+    if (pixelSnappingDisabled != m_pixelSnappingDisabled)
+        return false;
+
+    // Without pixel snapping, positions don't depend on the DPI or transform.
+    if (pixelSnappingDisabled)
+        return true;
+
+    return dpi == m_dpi &&
+           transform.M11 == m_transform.M11 && transform.M12 == m_transform.M12 &&
+           transform.M21 == m_transform.M21 && transform.M22 == m_transform.M22 &&
+           transform.M31 == m_transform.M31 && transform.M32 == m_transform.M32 &&
+           x == m_position.X &&
+           y == m_position.Y;
+}
+
+
+void TextRendererRecording::Replay(ICanvasTextRenderer* textRenderer, float x, float y)
+{
+    auto offset = Vector2{ x - m_position.X, y - m_position.Y };
+
+    for (auto& call : m_calls)
+    {
+        auto baselineOrigin = Vector2{ call.BaselineOrigin.X + offset.X, call.BaselineOrigin.Y + offset.Y };
+
+        switch (call.Type)
+        {
+        case CallType::GlyphRun:
+            ThrowIfFailed(textRenderer->DrawGlyphRun(
+                baselineOrigin,
+                call.FontFace.Get(),
+                call.FontSize,
+                call.GlyphCount,
+                call.GlyphCount ? &m_glyphs[call.GlyphStart] : nullptr,
+                call.IsSideways,
+                call.BidiLevel,
+                call.Brush.Get(),
+                call.MeasuringMode,
+                call.Locale,
+                call.Text,
+                call.ClusterMapCount,
+                call.HasClusterMap ? m_clusterMapIndices.data() + call.ClusterMapStart : nullptr,
+                call.CharacterIndex,
+                call.GlyphOrientation));
+            break;
+
+        case CallType::Underline:
+            ThrowIfFailed(textRenderer->DrawUnderline(
+                baselineOrigin,
+                call.Width,
+                call.Thickness,
+                call.Offset,
+                call.RunHeight,
+                call.TextDirection,
+                call.Brush.Get(),
+                call.MeasuringMode,
+                call.Locale,
+                call.GlyphOrientation));
+            break;
+
+        case CallType::Strikethrough:
+            ThrowIfFailed(textRenderer->DrawStrikethrough(
+                baselineOrigin,
+                call.Width,
+                call.Thickness,
+                call.Offset,
+                call.TextDirection,
+                call.Brush.Get(),
+                call.MeasuringMode,
+                call.Locale,
+                call.GlyphOrientation));
+            break;
+
+        case CallType::InlineObject:
+            ThrowIfFailed(textRenderer->DrawInlineObject(
+                baselineOrigin,
+                call.InlineObject.Get(),
+                call.IsSideways,
+                call.IsRightToLeft,
+                call.Brush.Get(),
+                call.GlyphOrientation));
+            break;
+        }
+    }
+}
+
+
+IFACEMETHODIMP TextRendererRecording::DrawGlyphRun(
+    Vector2 baselineOrigin,
+    ICanvasFontFace* fontFace,
+    float fontSize,
+    uint32_t glyphCount,
+    CanvasGlyph* glyphs,
+    boolean isSideways,
+    uint32_t bidiLevel,
+    IInspectable* brush,
+    CanvasTextMeasuringMode measuringMode,
+    HSTRING locale,
+    HSTRING text,
+    uint32_t clusterMapIndicesCount,
+    int* clusterMapIndices,
+    uint32_t characterIndex,
+    CanvasGlyphOrientation glyphOrientation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Call call{};
+            call.Type = CallType::GlyphRun;
+            call.BaselineOrigin = baselineOrigin;
+            call.FontFace = fontFace;
+            call.FontSize = fontSize;
+            call.GlyphStart = static_cast<uint32_t>(m_glyphs.size());
+            call.GlyphCount = glyphCount;
+            call.IsSideways = isSideways;
+            call.BidiLevel = bidiLevel;
+            call.Brush = brush;
+            call.MeasuringMode = measuringMode;
+            call.Locale = locale;
+            call.Text = text;
+            call.HasClusterMap = clusterMapIndices != nullptr;
+            call.ClusterMapStart = static_cast<uint32_t>(m_clusterMapIndices.size());
+            call.ClusterMapCount = clusterMapIndicesCount;
+            call.CharacterIndex = characterIndex;
+            call.GlyphOrientation = glyphOrientation;
+
+            m_glyphs.insert(m_glyphs.end(), glyphs, glyphs + glyphCount);
+
+            if (clusterMapIndices)
+                m_clusterMapIndices.insert(m_clusterMapIndices.end(), clusterMapIndices, clusterMapIndices + clusterMapIndicesCount);
+
+            m_calls.push_back(std::move(call));
+        });
+}
+
+
+IFACEMETHODIMP TextRendererRecording::DrawStrikethrough(
+    Vector2 baselineOrigin,
+    float width,
+    float thickness,
+    float offset,
+    CanvasTextDirection textDirection,
+    IInspectable* brush,
+    CanvasTextMeasuringMode measuringMode,
+    HSTRING locale,
+    CanvasGlyphOrientation glyphOrientation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Call call{};
+            call.Type = CallType::Strikethrough;
+            call.BaselineOrigin = baselineOrigin;
+            call.Width = width;
+            call.Thickness = thickness;
+            call.Offset = offset;
+            call.TextDirection = textDirection;
+            call.Brush = brush;
+            call.MeasuringMode = measuringMode;
+            call.Locale = locale;
+            call.GlyphOrientation = glyphOrientation;
+
+            m_calls.push_back(std::move(call));
+        });
+}
+
+
+IFACEMETHODIMP TextRendererRecording::DrawUnderline(
+    Vector2 baselineOrigin,
+    float width,
+    float thickness,
+    float offset,
+    float runHeight,
+    CanvasTextDirection textDirection,
+    IInspectable* brush,
+    CanvasTextMeasuringMode measuringMode,
+    HSTRING locale,
+    CanvasGlyphOrientation glyphOrientation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Call call{};
+            call.Type = CallType::Underline;
+            call.BaselineOrigin = baselineOrigin;
+            call.Width = width;
+            call.Thickness = thickness;
+            call.Offset = offset;
+            call.RunHeight = runHeight;
+            call.TextDirection = textDirection;
+            call.Brush = brush;
+            call.MeasuringMode = measuringMode;
+            call.Locale = locale;
+            call.GlyphOrientation = glyphOrientation;
+
+            m_calls.push_back(std::move(call));
+        });
+}
+
+
+IFACEMETHODIMP TextRendererRecording::DrawInlineObject(
+    Vector2 baselineOrigin,
+    ICanvasTextInlineObject* inlineObject,
+    boolean isSideways,
+    boolean isRightToLeft,
+    IInspectable* brush,
+    CanvasGlyphOrientation glyphOrientation)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            Call call{};
+            call.Type = CallType::InlineObject;
+            call.BaselineOrigin = baselineOrigin;
+            call.InlineObject = inlineObject;
+            call.IsSideways = isSideways;
+            call.IsRightToLeft = isRightToLeft;
+            call.Brush = brush;
+            call.GlyphOrientation = glyphOrientation;
+
+            m_calls.push_back(std::move(call));
+        });
+}
+
+
+IFACEMETHODIMP TextRendererRecording::get_Dpi(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            *value = m_dpi;
+        });
+}
+
+
+IFACEMETHODIMP TextRendererRecording::get_PixelSnappingDisabled(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            *value = m_pixelSnappingDisabled;
+        });
+}
+
+
+IFACEMETHODIMP TextRendererRecording::get_Transform(Matrix3x2* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            *value = m_transform;
+        });
+}
+
+
+void TextRendererRecording::GetRendererState(ICanvasTextRenderer* textRenderer, bool* pixelSnappingDisabled, float* dpi, Matrix3x2* transform)
+{
+    boolean value;
+    ThrowIfFailed(textRenderer->get_PixelSnappingDisabled(&value));
+    *pixelSnappingDisabled = !!value;
+
+    ThrowIfFailed(textRenderer->get_Dpi(dpi));
+    ThrowIfFailed(textRenderer->get_Transform(transform));
+}
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // The calls a CanvasTextLayout makes on an ICanvasTextRenderer, recorded
+    // so they can be made again without drawing the layout.
+    //
+    // A recording is made by drawing the layout through an
+    // InternalDWriteTextRenderer with this object as its ICanvasTextRenderer,
+    // so the font faces, glyphs, strings and drawing objects are converted
+    // exactly once.  Replaying only makes the calls on the app's renderer.
+    //
+    // How DirectWrite positions the text depends on the renderer's pixel
+    // snapping, DPI and transform, which are captured at record time.  With
+    // pixel snapping disabled, the layout is recorded at the origin, and can
+    // be replayed at any position.  Otherwise it is only valid at the position
+    // it was recorded at.
+    //
+    class TextRendererRecording
+        : public RuntimeClass<RuntimeClassFlags<WinRtClassicComMix>, ICanvasTextRenderer>
+        , private LifespanTracker<TextRendererRecording>
+    {
+        enum class CallType
+        {
+            GlyphRun,
+            Underline,
+            Strikethrough,
+            InlineObject
+        };
+
+        struct Call
+        {
+            CallType Type;
+            Vector2 BaselineOrigin;
+            ComPtr<IInspectable> Brush;
+            CanvasGlyphOrientation GlyphOrientation;
+
+            // Glyph runs.
+            ComPtr<ICanvasFontFace> FontFace;
+            float FontSize;
+            uint32_t GlyphStart;            // Into m_glyphs.
+            uint32_t GlyphCount;
+            boolean IsSideways;
+            uint32_t BidiLevel;
+            WinString Text;
+            bool HasClusterMap;
+            uint32_t ClusterMapStart;       // Into m_clusterMapIndices.
+            uint32_t ClusterMapCount;
+            uint32_t CharacterIndex;
+
+            // Glyph runs, underlines and strikethroughs.
+            CanvasTextMeasuringMode MeasuringMode;
+            WinString Locale;
+
+            // Underlines and strikethroughs.
+            float Width;
+            float Thickness;
+            float Offset;
+            float RunHeight;
+            CanvasTextDirection TextDirection;
+
+            // Inline objects.
+            ComPtr<ICanvasTextInlineObject> InlineObject;
+            boolean IsRightToLeft;
+        };
+
+        bool m_pixelSnappingDisabled;
+        float m_dpi;
+        Matrix3x2 m_transform;
+        Vector2 m_position;
+
+        std::vector<Call> m_calls;
+        std::vector<CanvasGlyph> m_glyphs;
+        std::vector<int> m_clusterMapIndices;
+
+    public:
+        static ComPtr<TextRendererRecording> Record(
+            ICanvasDevice* device,
+            IDWriteTextLayout* layout,
+            ICanvasTextRenderer* textRenderer,
+            float x,
+            float y);
+
+        TextRendererRecording(bool pixelSnappingDisabled, float dpi, Matrix3x2 const& transform, Vector2 position);
+
+        // Whether replaying at this position on this renderer gives the same
+        // calls as drawing the layout would.
+        bool CanReplay(ICanvasTextRenderer* textRenderer, float x, float y);
+
+        void Replay(ICanvasTextRenderer* textRenderer, float x, float y);
+
+        // ICanvasTextRenderer
+
+        IFACEMETHOD(DrawGlyphRun)(
+            Vector2 baselineOrigin,
+            ICanvasFontFace* fontFace,
+            float fontSize,
+            uint32_t glyphCount,
+            CanvasGlyph* glyphs,
+            boolean isSideways,
+            uint32_t bidiLevel,
+            IInspectable* brush,
+            CanvasTextMeasuringMode measuringMode,
+            HSTRING locale,
+            HSTRING text,
+            uint32_t clusterMapIndicesCount,
+            int* clusterMapIndices,
+            uint32_t characterIndex,
+            CanvasGlyphOrientation glyphOrientation) override;
+
+        IFACEMETHOD(DrawStrikethrough)(
+            Vector2 baselineOrigin,
+            float width,
+            float thickness,
+            float offset,
+            CanvasTextDirection textDirection,
+            IInspectable* brush,
+            CanvasTextMeasuringMode measuringMode,
+            HSTRING locale,
+            CanvasGlyphOrientation glyphOrientation) override;
+
+        IFACEMETHOD(DrawUnderline)(
+            Vector2 baselineOrigin,
+            float width,
+            float thickness,
+            float offset,
+            float runHeight,
+            CanvasTextDirection textDirection,
+            IInspectable* brush,
+            CanvasTextMeasuringMode measuringMode,
+            HSTRING locale,
+            CanvasGlyphOrientation glyphOrientation) override;
+
+        IFACEMETHOD(DrawInlineObject)(
+            Vector2 baselineOrigin,
+            ICanvasTextInlineObject* inlineObject,
+            boolean isSideways,
+            boolean isRightToLeft,
+            IInspectable* brush,
+            CanvasGlyphOrientation glyphOrientation) override;
+
+        IFACEMETHOD(get_Dpi)(float* value) override;
+        IFACEMETHOD(get_PixelSnappingDisabled)(boolean* value) override;
+        IFACEMETHOD(get_Transform)(Matrix3x2* value) override;
+
+    private:
+        static void GetRendererState(ICanvasTextRenderer* textRenderer, bool* pixelSnappingDisabled, float* dpi, Matrix3x2* transform);
+    };
+}}}}}
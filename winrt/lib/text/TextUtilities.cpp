@@ -99,6 +99,38 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
     }
 
+    Rect GetLayoutBounds(DWRITE_TEXT_METRICS1 const& metrics, DWRITE_READING_DIRECTION readingDirection)
+    {
+        Rect rect{ metrics.left, metrics.top, metrics.width, metrics.height };
+
+        //
+        // There's an adjustment to do here because 'left' and 'top' fields of this 
+        // struct are not always computed in the same way.
+        //
+        // On left-to-right reading direction, for example, the 'left' field is the left layout bound
+        // and everything is straightforward. As for right-to-left reading direction, however, 'left'
+        // is equal to the {right layout bound- not reported directly} - {widthIncludingTrailingWhitespace}. 
+        // Since the width of the rect we return doesn't include whitespace, its left bound needs to be
+        // adjusted accordingly. Likewise goes for bottom-to-top reading direction.
+        //
+        // Note that on horizontal reading directions, heightIncludingTrailingWhitespace == height.
+        // And on vertical ones, widthIncludingTrailingWhitespace == width.
+        //
+
+        if (readingDirection == DWRITE_READING_DIRECTION_RIGHT_TO_LEFT)
+        {
+            const float whitespace = metrics.widthIncludingTrailingWhitespace - metrics.width;
+            rect.X += whitespace;
+        }
+        else if (readingDirection == DWRITE_READING_DIRECTION_BOTTOM_TO_TOP)
+        {
+            const float whitespace = metrics.heightIncludingTrailingWhitespace - metrics.height;
+            rect.Y += whitespace;
+        }
+
+        return rect;
+    }
+
     DWriteGlyphData GetDWriteGlyphData(uint32_t glyphCount, CanvasGlyph* sourceGlyphsElements, int whichFields)
     {
         assert(whichFields != 0);
@@ -157,6 +157,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     uint32_t ToTrimmingDelimiter(WinString const& value);
 
+    // The bounds of laid out text, not including trailing whitespace.
+    Rect GetLayoutBounds(DWRITE_TEXT_METRICS1 const& metrics, DWRITE_READING_DIRECTION readingDirection);
+
 
     inline DWRITE_WORD_WRAPPING ToWordWrapping(CanvasWordWrapping value)
     {
@@ -656,7 +659,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     //
     inline void CopyLocalizedStringsToMapView(ComPtr<IDWriteLocalizedStrings> const& localizedStrings, IMapView<HSTRING, HSTRING>** values)
     {
-        auto map = Make<Map<HSTRING, HSTRING>>();
+        auto map = MakePooled<Map<HSTRING, HSTRING>>();
         CheckMakeResult(map);
 
         if (localizedStrings)
@@ -15,6 +15,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         CanvasTrimmingSign m_trimmingSign;
 
         ComPtr<ICanvasTextInlineObject> m_customTrimmingSign;
+        ComPtr<IDWriteInlineObject> m_customTrimmingSignWrapper;
 
     public:
 
@@ -28,8 +29,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             DWRITE_TRIMMING trimming;
             if (!trustShadowState || GetTrimmingSignFromResource(textFormat, &trimming, &trimmingWasRead) == CanvasTrimmingSign::Ellipsis)
             {
-                auto dwriteFactory = CustomFontManager::GetInstance()->GetSharedFactory();
-                ThrowIfFailed(dwriteFactory->CreateEllipsisTrimmingSign(textFormat, &m_internalEllipsisTrimmingSign));
+                m_internalEllipsisTrimmingSign = CreateEllipsisTrimmingSign(textFormat);
 
                 if (!trimmingWasRead)
                 {
@@ -84,8 +84,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
             if (m_customTrimmingSign)
             {
-                auto dwriteInlineObject = Make<InternalDWriteInlineObject>(m_customTrimmingSign, nullptr);
-                ThrowIfFailed(textFormat->SetTrimming(&trimming, dwriteInlineObject.Get()));
+                // Every realization of a format wraps the same custom sign,
+                // so keep the wrapper until the sign is changed.
+                if (GetCanvasInlineObjectFromDWriteInlineObject(m_customTrimmingSignWrapper) != m_customTrimmingSign)
+                {
+                    auto dwriteInlineObject = Make<InternalDWriteInlineObject>(m_customTrimmingSign, nullptr);
+                    CheckMakeResult(dwriteInlineObject);
+                    m_customTrimmingSignWrapper = dwriteInlineObject;
+                }
+
+                ThrowIfFailed(textFormat->SetTrimming(&trimming, m_customTrimmingSignWrapper.Get()));
             }
         }
 
@@ -166,5 +174,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         CanvasTrimmingSign* GetAddressOfTrimmingSign() { return &m_trimmingSign; }
 
         ComPtr<ICanvasTextInlineObject>* GetAddressOfCustomTrimmingSign() { return &m_customTrimmingSign; }
+
+    private:
+        static ComPtr<IDWriteInlineObject> CreateEllipsisTrimmingSign(IDWriteTextFormat* textFormat)
+        {
+            auto customFontManager = CustomFontManager::GetInstance();
+
+            // A layout can give parts of its text different fonts from its
+            // defaults, so only plain formats share their trimming signs.
+            if (MaybeAs<IDWriteTextLayout>(textFormat))
+            {
+                ComPtr<IDWriteInlineObject> trimmingSign;
+                ThrowIfFailed(customFontManager->GetSharedFactory()->CreateEllipsisTrimmingSign(textFormat, &trimmingSign));
+                return trimmingSign;
+            }
+
+            return customFontManager->GetInternedEllipsisTrimmingSign(textFormat);
+        }
     };
 }}}}}
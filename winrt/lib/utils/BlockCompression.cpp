@@ -0,0 +1,324 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "BlockCompression.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    // 4x4 pixels, each in B, G, R, A byte order.
+    typedef uint8_t BlockPixels[16][4];
+
+    static const int Blue = 0;
+    static const int Green = 1;
+    static const int Red = 2;
+    static const int Alpha = 3;
+
+
+    static void LoadBlock(uint8_t const* pixels, uint32_t stride, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, BlockPixels& block)
+    {
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                auto pixelX = blockX * 4 + x;
+                auto pixelY = blockY * 4 + y;
+
+                auto& pixel = block[y * 4 + x];
+
+                if (pixelX < width && pixelY < height)
+                    memcpy(pixel, pixels + pixelY * stride + pixelX * 4, 4);
+                else
+                    memset(pixel, 0, 4);
+            }
+        }
+    }
+
+
+    static void WriteLittleEndian(uint8_t* dest, uint64_t value, int byteCount)
+    {
+        for (int i = 0; i < byteCount; i++)
+        {
+            dest[i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+
+
+    static uint16_t ToRgb565(int const (&color)[3])
+    {
+        auto r = (color[Red]   * 31 + 127) / 255;
+        auto g = (color[Green] * 63 + 127) / 255;
+        auto b = (color[Blue]  * 31 + 127) / 255;
+
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+
+    static void FromRgb565(uint16_t rgb565, int (&color)[3])
+    {
+        auto r = (rgb565 >> 11) & 31;
+        auto g = (rgb565 >> 5) & 63;
+        auto b = rgb565 & 31;
+
+        // Replicating the high bits into the low ones is how the GPU expands them.
+        color[Red]   = (r << 3) | (r >> 2);
+        color[Green] = (g << 2) | (g >> 4);
+        color[Blue]  = (b << 3) | (b >> 2);
+    }
+
+
+    // Writes the 8 byte color part of a block. BC1 blocks may use the 3 color
+    // mode, whose 4th palette entry is transparent black, for pixels that are
+    // less than half opaque. BC2 and BC3 always use 4 colors.
+    static void CompressColorBlock(BlockPixels const& block, bool isBC1, uint8_t* dest)
+    {
+        bool hasTransparentPixels = false;
+        int sum[3] = {};
+        int count = 0;
+
+        int minColor[3] = { 255, 255, 255 };
+        int maxColor[3] = { 0, 0, 0 };
+
+        for (auto& pixel : block)
+        {
+            if (isBC1 && pixel[Alpha] < 128)
+            {
+                hasTransparentPixels = true;
+                continue;
+            }
+
+            for (int c = 0; c < 3; c++)
+            {
+                minColor[c] = std::min<int>(minColor[c], pixel[c]);
+                maxColor[c] = std::max<int>(maxColor[c], pixel[c]);
+                sum[c] += pixel[c];
+            }
+
+            count++;
+        }
+
+        if (count == 0)
+        {
+            // Entirely transparent: both endpoints black, every pixel index 3.
+            WriteLittleEndian(dest, 0xFFFFFFFF00000000ULL, 8);
+            return;
+        }
+
+        // The corners of the bounding box give the endpoints, but which of its
+        // diagonals the colors lie along depends on whether each channel goes
+        // up or down along with the one that varies the most.
+        int mainChannel = 0;
+
+        for (int c = 1; c < 3; c++)
+        {
+            if (maxColor[c] - minColor[c] > maxColor[mainChannel] - minColor[mainChannel])
+                mainChannel = c;
+        }
+
+        int covariance[3] = {};
+
+        for (auto& pixel : block)
+        {
+            if (isBC1 && pixel[Alpha] < 128)
+                continue;
+
+            auto mainOffset = pixel[mainChannel] * count - sum[mainChannel];
+
+            for (int c = 0; c < 3; c++)
+            {
+                covariance[c] += mainOffset * (pixel[c] * count - sum[c]) / 256;
+            }
+        }
+
+        for (int c = 0; c < 3; c++)
+        {
+            if (covariance[c] < 0)
+                std::swap(minColor[c], maxColor[c]);
+        }
+
+        auto color0 = ToRgb565(maxColor);
+        auto color1 = ToRgb565(minColor);
+
+        // The order of the endpoints selects the mode.
+        bool useThreeColors = hasTransparentPixels;
+
+        if (useThreeColors ? (color0 > color1) : (color0 < color1))
+            std::swap(color0, color1);
+
+        int palette[4][3];
+        FromRgb565(color0, palette[0]);
+        FromRgb565(color1, palette[1]);
+
+        int paletteSize;
+
+        if (useThreeColors)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            }
+
+            paletteSize = 3;
+        }
+        else
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                palette[2][c] = (palette[0][c] * 2 + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + palette[1][c] * 2) / 3;
+            }
+
+            paletteSize = 4;
+        }
+
+        uint32_t indices = 0;
+
+        for (int i = 0; i < 16; i++)
+        {
+            auto& pixel = block[i];
+            uint32_t bestIndex = 3;
+
+            if (!useThreeColors || pixel[Alpha] >= 128)
+            {
+                int bestError = INT_MAX;
+
+                for (int p = 0; p < paletteSize; p++)
+                {
+                    int error = 0;
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        auto difference = pixel[c] - palette[p][c];
+                        error += difference * difference;
+                    }
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+            }
+
+            indices |= bestIndex << (i * 2);
+        }
+
+        WriteLittleEndian(dest, color0, 2);
+        WriteLittleEndian(dest + 2, color1, 2);
+        WriteLittleEndian(dest + 4, indices, 4);
+    }
+
+
+    // BC2 stores alpha explicitly, 4 bits per pixel.
+    static void CompressExplicitAlphaBlock(BlockPixels const& block, uint8_t* dest)
+    {
+        uint64_t alphas = 0;
+
+        for (int i = 0; i < 16; i++)
+        {
+            uint64_t alpha = (block[i][Alpha] * 15 + 127) / 255;
+            alphas |= alpha << (i * 4);
+        }
+
+        WriteLittleEndian(dest, alphas, 8);
+    }
+
+
+    // BC3 stores two alpha endpoints, and for each pixel a 3 bit index into
+    // the 8 levels between them.
+    static void CompressInterpolatedAlphaBlock(BlockPixels const& block, uint8_t* dest)
+    {
+        int minAlpha = 255;
+        int maxAlpha = 0;
+
+        for (auto& pixel : block)
+        {
+            minAlpha = std::min<int>(minAlpha, pixel[Alpha]);
+            maxAlpha = std::max<int>(maxAlpha, pixel[Alpha]);
+        }
+
+        uint64_t indices = 0;
+        auto range = maxAlpha - minAlpha;
+
+        if (range > 0)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                // 0 is the minimum and 7 the maximum. Index 0 holds alpha0
+                // (the maximum), index 1 alpha1, and indices 2 to 7 step
+                // from alpha0 down towards alpha1.
+                auto level = ((block[i][Alpha] - minAlpha) * 7 + range / 2) / range;
+
+                uint64_t index = (level == 7) ? 0 :
+                                 (level == 0) ? 1 :
+                                 8 - level;
+
+                indices |= index << (i * 3);
+            }
+        }
+
+        dest[0] = static_cast<uint8_t>(maxAlpha);
+        dest[1] = static_cast<uint8_t>(minAlpha);
+        WriteLittleEndian(dest + 2, indices, 6);
+    }
+
+
+    void CompressBlocks(
+        DXGI_FORMAT format,
+        uint8_t const* pixels,
+        uint32_t stride,
+        uint32_t width,
+        uint32_t height,
+        uint8_t* blocks)
+    {
+        uint32_t bytesPerBlock;
+
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+            bytesPerBlock = 8;
+            break;
+
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC3_UNORM:
+            bytesPerBlock = 16;
+            break;
+
+        default:
+            ThrowHR(E_INVALIDARG);
+        }
+
+        auto blocksWide = (width + 3) / 4;
+        auto blocksHigh = (height + 3) / 4;
+
+        BlockPixels block;
+
+        for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+        {
+            for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+            {
+                LoadBlock(pixels, stride, width, height, blockX, blockY, block);
+
+                auto dest = blocks + (static_cast<size_t>(blockY) * blocksWide + blockX) * bytesPerBlock;
+
+                switch (format)
+                {
+                case DXGI_FORMAT_BC1_UNORM:
+                    CompressColorBlock(block, true, dest);
+                    break;
+
+                case DXGI_FORMAT_BC2_UNORM:
+                    CompressExplicitAlphaBlock(block, dest);
+                    CompressColorBlock(block, false, dest + 8);
+                    break;
+
+                case DXGI_FORMAT_BC3_UNORM:
+                    CompressInterpolatedAlphaBlock(block, dest);
+                    CompressColorBlock(block, false, dest + 8);
+                    break;
+                }
+            }
+        }
+    }
+}}}}
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    // Compresses premultiplied B8G8R8A8 pixels into BC1, BC2 or BC3 blocks.
+    //
+    // Blocks are written (width + 3) / 4 to a row, one row of blocks after
+    // another with no padding in between. Where width or height isn't a
+    // multiple of 4, the blocks along the right and bottom edges are padded
+    // out with transparent pixels.
+    //
+    // This is a fast encoder, meant for compressing images as they are loaded
+    // rather than ahead of time: endpoints come from the bounding box of each
+    // block's colors rather than an exhaustive search.
+    void CompressBlocks(
+        DXGI_FORMAT format,
+        uint8_t const* pixels,
+        uint32_t stride,
+        uint32_t width,
+        uint32_t height,
+        uint8_t* blocks);
+}}}}
@@ -186,15 +186,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     // Converts color array to bytes according to the default format, B8G8R8A8_UNORM.
     std::vector<uint8_t> ConvertColorsToBgra(uint32_t colorCount, Color* colors)
     {
+        static_assert(sizeof(Color) == 4, "SwizzlePixels relies on Color being packed A, R, G, B");
+
         std::vector<uint8_t> convertedBytes(colorCount * 4);
 
-        for (uint32_t i = 0; i < colorCount; i++)
-        {
-            convertedBytes[i * 4 + 0] = colors[i].B;
-            convertedBytes[i * 4 + 1] = colors[i].G;
-            convertedBytes[i * 4 + 2] = colors[i].R;
-            convertedBytes[i * 4 + 3] = colors[i].A;
-        }
+        SwizzlePixels(PixelSwizzle::BgraToArgb, reinterpret_cast<uint8_t const*>(colors), convertedBytes.data(), colorCount);
 
         assert(convertedBytes.size() <= UINT_MAX);
 
@@ -207,13 +203,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
         std::vector<uint8_t> convertedBytes(colorCount * 4);
 
-        for (uint32_t i = 0; i < colorCount; i++)
-        {
-            convertedBytes[i * 4 + 0] = colors[i].R;
-            convertedBytes[i * 4 + 1] = colors[i].G;
-            convertedBytes[i * 4 + 2] = colors[i].B;
-            convertedBytes[i * 4 + 3] = colors[i].A;
-        }
+        SwizzlePixels(PixelSwizzle::ArgbToRgba, reinterpret_cast<uint8_t const*>(colors), convertedBytes.data(), colorCount);
 
         assert(convertedBytes.size() <= UINT_MAX);
 
@@ -9,5 +9,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     ComArray<BYTE> GetSha1Hash(BYTE const* data, size_t dataSize);
 
     IID GetVersion5Uuid(IID const& namespaceId, BYTE const* name, size_t nameSize);
+
+    // Like GetVersion5Uuid, but built on a fast non-cryptographic hash rather than SHA-1.
+    // The results are only stable within a single build of Win2D, so this must not be used
+    // for anything that gets persisted or compared against IDs from elsewhere.
+    IID GetFastUuid(IID const& namespaceId, BYTE const* name, size_t nameSize);
+
+
+    // Hash functor allowing IIDs to be used as std::unordered_map keys.
+    struct IIDHash
+    {
+        size_t operator()(IID const& iid) const
+        {
+            // GUIDs are already well distributed, so just fold the words together.
+            auto words = reinterpret_cast<uint32_t const*>(&iid);
+
+            return words[0] ^ words[1] ^ words[2] ^ words[3];
+        }
+    };
     
 }}}}
@@ -40,6 +40,43 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    // Returns the integer bounds of a rectangle after it has been transformed.
+    // Infinite rectangles stay infinite.
+    inline D2D1_RECT_L TransformRectangle(D2D1_RECT_L const& rect, Numerics::Matrix3x2 const& transform)
+    {
+        if (rect.left == INT_MIN || rect.top == INT_MIN || rect.right == INT_MAX || rect.bottom == INT_MAX)
+            return D2D1_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+
+        double const cornerX[] = { static_cast<double>(rect.left), static_cast<double>(rect.right), static_cast<double>(rect.left),  static_cast<double>(rect.right)  };
+        double const cornerY[] = { static_cast<double>(rect.top),  static_cast<double>(rect.top),   static_cast<double>(rect.bottom), static_cast<double>(rect.bottom) };
+
+        double transformedX[4];
+        double transformedY[4];
+
+        for (int i = 0; i < 4; i++)
+        {
+            transformedX[i] = cornerX[i] * transform.M11 + cornerY[i] * transform.M21 + transform.M31;
+            transformedY[i] = cornerX[i] * transform.M12 + cornerY[i] * transform.M22 + transform.M32;
+        }
+
+        auto rangeX = std::minmax_element(transformedX, transformedX + 4);
+        auto rangeY = std::minmax_element(transformedY, transformedY + 4);
+
+        auto toInt = [](double value)
+        {
+            return static_cast<int>(std::min<double>(std::max<double>(INT_MIN, value), INT_MAX));
+        };
+
+        return D2D1_RECT_L
+        {
+            toInt(floor(*rangeX.first)),
+            toInt(floor(*rangeY.first)),
+            toInt(ceil(*rangeX.second)),
+            toInt(ceil(*rangeY.second)),
+        };
+    }
+
+
     inline Numerics::Matrix3x2 const& Identity3x2()
     {
         static Numerics::Matrix3x2 identity{ 1, 0, 0, 1, 0, 0 };
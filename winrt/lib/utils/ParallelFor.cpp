@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "ParallelFor.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    ParallelWorkers::ParallelWorkers(uint32_t itemCount, Functor&& functor)
+        : m_itemCount(itemCount)
+        , m_functor(std::move(functor))
+        , m_nextIndex(0)
+        , m_isAbandoned(false)
+        , m_runningWorkerCount(0)
+        , m_result(S_OK)
+    {
+    }
+
+    void ParallelWorkers::Start(uint32_t workerCount)
+    {
+        // No use starting more workers than there are items.
+        workerCount = std::min(workerCount, m_itemCount);
+
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            {
+                Lock lock(m_mutex);
+                m_runningWorkerCount++;
+            }
+
+            try
+            {
+                StartWorker();
+            }
+            catch (...)
+            {
+                Abandon();
+
+                {
+                    Lock lock(m_mutex);
+                    m_runningWorkerCount--;
+                }
+
+                m_workerFinished.notify_one();
+                throw;
+            }
+        }
+    }
+
+    void ParallelWorkers::Work()
+    {
+        {
+            Lock lock(m_mutex);
+            m_runningWorkerCount++;
+        }
+
+        WorkerFinished(DoWork());
+    }
+
+    void ParallelWorkers::Abandon()
+    {
+        m_isAbandoned = true;
+    }
+
+    HRESULT ParallelWorkers::Wait()
+    {
+        Lock lock(m_mutex);
+
+        m_workerFinished.wait(lock, [&] { return m_runningWorkerCount == 0; });
+
+        return m_result;
+    }
+
+    void ParallelWorkers::StartWorker()
+    {
+        using ABI::Windows::System::Threading::IWorkItemHandler;
+
+        auto self = shared_from_this();
+
+        auto workItem = Callback<AddFtmBase<IWorkItemHandler>::Type>(
+            [self](IAsyncAction*)
+            {
+                self->WorkerFinished(self->DoWork());
+                return S_OK;
+            });
+
+        CheckMakeResult(workItem);
+
+        AsyncScheduler::GetInstance().Run(workItem);
+    }
+
+    HRESULT ParallelWorkers::DoWork()
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                while (!m_isAbandoned)
+                {
+                    auto index = m_nextIndex++;
+
+                    if (index >= m_itemCount)
+                        return;
+
+                    m_functor(index);
+                }
+            });
+    }
+
+    void ParallelWorkers::WorkerFinished(HRESULT hr)
+    {
+        // No point in the other workers carrying on once one has failed.
+        if (FAILED(hr))
+            Abandon();
+
+        {
+            Lock lock(m_mutex);
+
+            if (FAILED(hr) && SUCCEEDED(m_result))
+                m_result = hr;
+
+            m_runningWorkerCount--;
+        }
+
+        m_workerFinished.notify_one();
+    }
+
+
+    HRESULT ParallelFor(uint32_t itemCount, uint32_t maximumParallelism, ParallelWorkers::Functor functor)
+    {
+        if (itemCount == 0)
+            return S_OK;
+
+        auto workers = std::make_shared<ParallelWorkers>(itemCount, std::move(functor));
+
+        auto workerCount = std::max(std::min(maximumParallelism, itemCount), 1U);
+
+        // This thread is one of the workers, so starts one fewer.
+        auto startResult = ExceptionBoundary([&] { workers->Start(workerCount - 1); });
+
+        // Even if not all of them could be started, the ones that were are
+        // using the functor, so must be waited for. Work does nothing once
+        // the workers have been abandoned.
+        workers->Work();
+
+        auto result = workers->Wait();
+
+        return FAILED(startResult) ? startResult : result;
+    }
+
+}}}}
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // The worker pool behind the batch APIs. Each worker repeatedly claims the
+    // next unclaimed index in [0, itemCount) and calls the functor for it,
+    // until there are none left. Once the functor throws for one index the
+    // workers stop claiming more, and the first failure is what Wait returns.
+    //
+    // Workers run on the AsyncScheduler, and keep this object (and so the
+    // functor) alive until they finish.
+    //
+    class ParallelWorkers : public std::enable_shared_from_this<ParallelWorkers>
+    {
+    public:
+        typedef std::function<void(uint32_t index)> Functor;
+
+    private:
+        uint32_t m_itemCount;
+        Functor m_functor;
+
+        std::atomic<uint32_t> m_nextIndex;
+        std::atomic<bool> m_isAbandoned;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workerFinished;
+        uint32_t m_runningWorkerCount;
+        HRESULT m_result;
+
+    public:
+        ParallelWorkers(uint32_t itemCount, Functor&& functor);
+
+        // Starts up to workerCount workers on the thread pool. If one can't be
+        // started, the rest of the work is abandoned and the error is thrown.
+        void Start(uint32_t workerCount);
+
+        // Does a share of the work on the calling thread.
+        void Work();
+
+        // Stops the workers claiming any more indices.
+        void Abandon();
+
+        // Returns once every worker (including any Work calls) has finished.
+        HRESULT Wait();
+
+    private:
+        void StartWorker();
+        HRESULT DoWork();
+        void WorkerFinished(HRESULT hr);
+    };
+
+
+    // Calls functor for every index in [0, itemCount), sharing them out
+    // between this thread and up to maximumParallelism - 1 others. Returns
+    // once all of them have finished, with the first failure any of them ran
+    // into. The functor is not used after this returns, so it may refer to
+    // the caller's locals.
+    HRESULT ParallelFor(uint32_t itemCount, uint32_t maximumParallelism, ParallelWorkers::Functor functor);
+
+}}}}
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    std::atomic<uint64_t> PerformanceCounters::s_values[static_cast<size_t>(PerformanceCounter::Count)];
+
+
+    CanvasPerformanceCounters PerformanceCounters::GetSnapshot()
+    {
+        auto get = [](PerformanceCounter counter) { return s_values[static_cast<size_t>(counter)].load(std::memory_order_relaxed); };
+
+        CanvasPerformanceCounters snapshot;
+
+        snapshot.DeviceContextsCreated = get(PerformanceCounter::DeviceContextsCreated);
+        snapshot.DeviceContextsReused  = get(PerformanceCounter::DeviceContextsReused);
+        snapshot.EffectRealizations    = get(PerformanceCounter::EffectRealizations);
+        snapshot.EffectUnrealizations  = get(PerformanceCounter::EffectUnrealizations);
+        snapshot.WrappersCreated       = get(PerformanceCounter::WrappersCreated);
+        snapshot.BitmapBytesUploaded   = get(PerformanceCounter::BitmapBytesUploaded);
+        snapshot.BitmapBytesReadBack   = get(PerformanceCounter::BitmapBytesReadBack);
+        snapshot.SpritesDrawn          = get(PerformanceCounter::SpritesDrawn);
+        snapshot.TextLayoutsCreated    = get(PerformanceCounter::TextLayoutsCreated);
+
+        return snapshot;
+    }
+
+
+    std::atomic<uint64_t> ObjectCounters::s_live[static_cast<size_t>(CountedObjectType::Count)];
+    std::atomic<uint64_t> ObjectCounters::s_created[static_cast<size_t>(CountedObjectType::Count)];
+
+
+    CanvasObjectCounts ObjectCounters::GetSnapshot()
+    {
+        auto live    = [](CountedObjectType type) { return s_live[static_cast<size_t>(type)].load(std::memory_order_relaxed); };
+        auto created = [](CountedObjectType type) { return s_created[static_cast<size_t>(type)].load(std::memory_order_relaxed); };
+
+        CanvasObjectCounts snapshot;
+
+        snapshot.LiveBitmaps         = live(CountedObjectType::Bitmap);
+        snapshot.BitmapsCreated      = created(CountedObjectType::Bitmap);
+        snapshot.LiveGeometries      = live(CountedObjectType::Geometry);
+        snapshot.GeometriesCreated   = created(CountedObjectType::Geometry);
+        snapshot.LiveEffects         = live(CountedObjectType::Effect);
+        snapshot.EffectsCreated      = created(CountedObjectType::Effect);
+        snapshot.LiveTextFormats     = live(CountedObjectType::TextFormat);
+        snapshot.TextFormatsCreated  = created(CountedObjectType::TextFormat);
+        snapshot.LiveTextLayouts     = live(CountedObjectType::TextLayout);
+        snapshot.TextLayoutsCreated  = created(CountedObjectType::TextLayout);
+
+        return snapshot;
+    }
+}}}}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    enum class PerformanceCounter
+    {
+        DeviceContextsCreated,
+        DeviceContextsReused,
+        EffectRealizations,
+        EffectUnrealizations,
+        WrappersCreated,
+        BitmapBytesUploaded,
+        BitmapBytesReadBack,
+        SpritesDrawn,
+        TextLayoutsCreated,
+
+        Count
+    };
+
+
+    //
+    // Process wide counters, reported by CanvasDevice.GetPerformanceCounters.
+    // These are only ever added to, and don't order any other memory accesses,
+    // so the increments are relaxed.
+    //
+    class PerformanceCounters
+    {
+        static std::atomic<uint64_t> s_values[static_cast<size_t>(PerformanceCounter::Count)];
+
+    public:
+        static void Increment(PerformanceCounter counter, uint64_t amount = 1)
+        {
+            s_values[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        static CanvasPerformanceCounters GetSnapshot();
+    };
+
+
+    enum class CountedObjectType
+    {
+        Bitmap,
+        Geometry,
+        Effect,
+        TextFormat,
+        TextLayout,
+
+        Count
+    };
+
+
+    //
+    // Process wide live and created counts for the types that apps make most
+    // of, reported by CanvasDevice.GetObjectCounts.  Unlike LifespanTracker,
+    // which keeps a map behind a mutex and so is only on in debug builds,
+    // these are a pair of relaxed atomics per type and are always on.
+    //
+    class ObjectCounters
+    {
+        static std::atomic<uint64_t> s_live[static_cast<size_t>(CountedObjectType::Count)];
+        static std::atomic<uint64_t> s_created[static_cast<size_t>(CountedObjectType::Count)];
+
+    public:
+        static void AddObject(CountedObjectType type)
+        {
+            s_live[static_cast<size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+            s_created[static_cast<size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void RemoveObject(CountedObjectType type)
+        {
+            s_live[static_cast<size_t>(type)].fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        static CanvasObjectCounts GetSnapshot();
+    };
+
+
+    // Derive from this to have a type's instances counted by ObjectCounters.
+    template<CountedObjectType TYPE>
+    class ObjectCounter
+    {
+    protected:
+        ObjectCounter()
+        {
+            ObjectCounters::AddObject(TYPE);
+        }
+
+        ~ObjectCounter()
+        {
+            ObjectCounters::RemoveObject(TYPE);
+        }
+    };
+}}}}
@@ -0,0 +1,335 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "PixelSwizzle.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#define PIXEL_SWIZZLE_X86
+#elif defined(_M_ARM) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PIXEL_SWIZZLE_NEON
+#endif
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    static void SwizzlePixelsScalar(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        for (uint32_t i = 0; i < pixelCount; i++)
+        {
+            uint32_t pixel;
+            memcpy(&pixel, source + i * 4, sizeof(pixel));
+
+            pixel = (swizzle == PixelSwizzle::BgraToArgb) ? _byteswap_ulong(pixel)
+                                                          : _rotr(pixel, 8);
+
+            memcpy(dest + i * 4, &pixel, sizeof(pixel));
+        }
+    }
+
+
+#if defined(PIXEL_SWIZZLE_X86)
+
+    // The SIMD kernels process as many whole vectors as they can, returning how
+    // many pixels they converted. The scalar loop takes care of the remainder.
+    typedef uint32_t (*SwizzleKernel)(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount);
+
+    static __m128i GetShuffleMask(PixelSwizzle swizzle)
+    {
+        if (swizzle == PixelSwizzle::BgraToArgb)
+            return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        else
+            return _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    }
+
+    static uint32_t SwizzlePixelsSsse3(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        const __m128i mask = GetShuffleMask(swizzle);
+        const uint32_t vectorCount = pixelCount / 4;
+
+        for (uint32_t i = 0; i < vectorCount; i++)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source) + i);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest) + i, _mm_shuffle_epi8(pixels, mask));
+        }
+
+        return vectorCount * 4;
+    }
+
+    static uint32_t SwizzlePixelsAvx2(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        // vpshufb shuffles within each 128 bit lane, so the same mask goes in both halves.
+        const __m256i mask = _mm256_broadcastsi128_si256(GetShuffleMask(swizzle));
+        const uint32_t vectorCount = pixelCount / 8;
+
+        for (uint32_t i = 0; i < vectorCount; i++)
+        {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source) + i);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest) + i, _mm256_shuffle_epi8(pixels, mask));
+        }
+
+        _mm256_zeroupper();
+
+        return vectorCount * 8;
+    }
+
+    static bool IsSsse3Supported()
+    {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) != 0;
+    }
+
+    static bool IsAvx2Supported()
+    {
+        int info[4];
+
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // AVX2 is only usable if the OS saves the YMM registers across context switches.
+        __cpuid(info, 1);
+        const int osxsaveAndAvx = (1 << 27) | (1 << 28);
+        if ((info[2] & osxsaveAndAvx) != osxsaveAndAvx)
+            return false;
+
+        if ((_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+
+    static SwizzleKernel ChooseKernel()
+    {
+        if (IsAvx2Supported())
+            return SwizzlePixelsAvx2;
+
+        if (IsSsse3Supported())
+            return SwizzlePixelsSsse3;
+
+        return nullptr;
+    }
+
+#elif defined(PIXEL_SWIZZLE_NEON)
+
+    // NEON is always available on Windows ARM devices, so no runtime check is needed.
+    static uint32_t SwizzlePixelsNeon(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        const uint32_t vectorCount = pixelCount / 4;
+
+        for (uint32_t i = 0; i < vectorCount; i++)
+        {
+            uint8x16_t pixels = vld1q_u8(source + i * 16);
+
+            if (swizzle == PixelSwizzle::BgraToArgb)
+            {
+                pixels = vrev32q_u8(pixels);
+            }
+            else
+            {
+                // Rotate each 32 bit pixel right by one byte.
+                uint32x4_t words = vreinterpretq_u32_u8(pixels);
+                pixels = vreinterpretq_u8_u32(vsriq_n_u32(vshlq_n_u32(words, 24), words, 8));
+            }
+
+            vst1q_u8(dest + i * 16, pixels);
+        }
+
+        return vectorCount * 4;
+    }
+
+#endif
+
+
+    void SwizzlePixels(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        uint32_t converted = 0;
+
+#if defined(PIXEL_SWIZZLE_X86)
+        static const SwizzleKernel kernel = ChooseKernel();
+
+        if (kernel)
+            converted = kernel(swizzle, source, dest, pixelCount);
+#elif defined(PIXEL_SWIZZLE_NEON)
+        converted = SwizzlePixelsNeon(swizzle, source, dest, pixelCount);
+#endif
+
+        SwizzlePixelsScalar(swizzle, source + converted * 4, dest + converted * 4, pixelCount - converted);
+    }
+
+
+    AlphaConversion GetAlphaConversion(CanvasAlphaMode sourceAlphaMode, CanvasAlphaMode destAlphaMode)
+    {
+        if (sourceAlphaMode == CanvasAlphaMode::Straight && destAlphaMode == CanvasAlphaMode::Premultiplied)
+            return AlphaConversion::Premultiply;
+
+        if (sourceAlphaMode == CanvasAlphaMode::Premultiplied && destAlphaMode == CanvasAlphaMode::Straight)
+            return AlphaConversion::Unpremultiply;
+
+        return AlphaConversion::None;
+    }
+
+
+    // Computes round(value * alpha / 255) exactly, without a divide.
+    static uint8_t MultiplyByAlpha(uint32_t value, uint32_t alpha)
+    {
+        uint32_t t = value * alpha + 128;
+        return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+    }
+
+    static void PremultiplyPixelsScalar(uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        for (uint32_t i = 0; i < pixelCount; i++)
+        {
+            uint8_t alpha = source[i * 4 + 3];
+
+            dest[i * 4 + 0] = MultiplyByAlpha(source[i * 4 + 0], alpha);
+            dest[i * 4 + 1] = MultiplyByAlpha(source[i * 4 + 1], alpha);
+            dest[i * 4 + 2] = MultiplyByAlpha(source[i * 4 + 2], alpha);
+            dest[i * 4 + 3] = alpha;
+        }
+    }
+
+
+#if defined(PIXEL_SWIZZLE_X86)
+
+    // SSE2 is part of the Windows baseline on both x86 and x64, so this needs no runtime check.
+    static uint32_t PremultiplyPixelsSse2(uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i colorMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+        const __m128i alphaMultiplier = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+        const __m128i half = _mm_set1_epi16(128);
+
+        const uint32_t vectorCount = pixelCount / 4;
+
+        for (uint32_t i = 0; i < vectorCount; i++)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source) + i);
+
+            __m128i halves[] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+
+            for (auto& channels : halves)
+            {
+                // Multiply the color channels of each pixel by its alpha, and alpha by 255
+                // so that MultiplyByAlpha's divide by 255 leaves it unchanged.
+                __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                __m128i multiplier = _mm_or_si128(_mm_and_si128(alpha, colorMask), alphaMultiplier);
+
+                __m128i t = _mm_add_epi16(_mm_mullo_epi16(channels, multiplier), half);
+                channels = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest) + i, _mm_packus_epi16(halves[0], halves[1]));
+        }
+
+        return vectorCount * 4;
+    }
+
+#elif defined(PIXEL_SWIZZLE_NEON)
+
+    static uint32_t PremultiplyPixelsNeon(uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        const uint32_t vectorCount = pixelCount / 8;
+
+        for (uint32_t i = 0; i < vectorCount; i++)
+        {
+            // Deinterleave 8 pixels into one register per channel.
+            uint8x8x4_t pixels = vld4_u8(source + i * 32);
+
+            for (int channel = 0; channel < 3; channel++)
+            {
+                uint16x8_t t = vmull_u8(pixels.val[channel], pixels.val[3]);
+                pixels.val[channel] = vraddhn_u16(t, vrshrq_n_u16(t, 8));
+            }
+
+            vst4_u8(dest + i * 32, pixels);
+        }
+
+        return vectorCount * 8;
+    }
+
+#endif
+
+
+    static void PremultiplyPixels(uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        uint32_t converted = 0;
+
+#if defined(PIXEL_SWIZZLE_X86)
+        converted = PremultiplyPixelsSse2(source, dest, pixelCount);
+#elif defined(PIXEL_SWIZZLE_NEON)
+        converted = PremultiplyPixelsNeon(source, dest, pixelCount);
+#endif
+
+        PremultiplyPixelsScalar(source + converted * 4, dest + converted * 4, pixelCount - converted);
+    }
+
+
+    // Unpremultiplying computes round(value * 255 / alpha). Rewriting that as
+    // (2 * value * 255 + alpha) / (2 * alpha) and multiplying by a rounded up
+    // 32 bit reciprocal of 2 * alpha gives exactly the same results as dividing.
+    static std::array<uint32_t, 256> MakeUnpremultiplyTable()
+    {
+        std::array<uint32_t, 256> table{};
+
+        for (uint32_t alpha = 1; alpha < 256; alpha++)
+        {
+            table[alpha] = static_cast<uint32_t>(((1ull << 32) + 2 * alpha - 1) / (2 * alpha));
+        }
+
+        return table;
+    }
+
+    static void UnpremultiplyPixels(uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        static const std::array<uint32_t, 256> reciprocals = MakeUnpremultiplyTable();
+
+        for (uint32_t i = 0; i < pixelCount; i++)
+        {
+            uint32_t alpha = source[i * 4 + 3];
+
+            if (alpha == 0)
+            {
+                memset(dest + i * 4, 0, 4);
+                continue;
+            }
+
+            uint64_t reciprocal = reciprocals[alpha];
+
+            for (int channel = 0; channel < 3; channel++)
+            {
+                uint64_t value = source[i * 4 + channel];
+                uint64_t result = ((2 * value * 255 + alpha) * reciprocal) >> 32;
+
+                dest[i * 4 + channel] = static_cast<uint8_t>(std::min<uint64_t>(result, 255));
+            }
+
+            dest[i * 4 + 3] = static_cast<uint8_t>(alpha);
+        }
+    }
+
+
+    void ConvertPixelAlpha(AlphaConversion conversion, uint8_t const* source, uint8_t* dest, uint32_t pixelCount)
+    {
+        switch (conversion)
+        {
+        case AlphaConversion::Premultiply:
+            PremultiplyPixels(source, dest, pixelCount);
+            break;
+
+        case AlphaConversion::Unpremultiply:
+            UnpremultiplyPixels(source, dest, pixelCount);
+            break;
+
+        default:
+            if (source != dest)
+                memcpy(dest, source, pixelCount * 4);
+            break;
+        }
+    }
+}}}}
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    // Byte reorderings between the 32 bit pixel layouts we convert between.
+    // Windows::UI::Color is laid out in memory as A, R, G, B.
+    enum class PixelSwizzle
+    {
+        // B8G8R8A8 <-> Windows::UI::Color. This reverses the bytes of each
+        // pixel, so is its own inverse.
+        BgraToArgb,
+
+        // Windows::UI::Color -> R8G8B8A8.
+        ArgbToRgba,
+    };
+
+    // Reorders the bytes of pixelCount 32 bit pixels. Source and dest may be
+    // the same buffer, but must not otherwise overlap. Uses SSSE3 or AVX2
+    // shuffles on x86/x64 when the CPU has them, and NEON on ARM.
+    void SwizzlePixels(PixelSwizzle swizzle, uint8_t const* source, uint8_t* dest, uint32_t pixelCount);
+
+
+    // Alpha conversions for 8 bit per channel pixels with alpha in the last
+    // byte, ie. B8G8R8A8 or R8G8B8A8.
+    enum class AlphaConversion
+    {
+        None,
+        Premultiply,
+        Unpremultiply,
+    };
+
+    // Returns the conversion that turns pixels in sourceAlphaMode into
+    // destAlphaMode. Nothing needs converting if either side is Ignore.
+    AlphaConversion GetAlphaConversion(CanvasAlphaMode sourceAlphaMode, CanvasAlphaMode destAlphaMode);
+
+    // Same buffer rules as SwizzlePixels. AlphaConversion::None just copies.
+    // Premultiplying uses SSE2 or NEON; unpremultiplying replaces the
+    // per-channel divide with a reciprocal table.
+    void ConvertPixelAlpha(AlphaConversion conversion, uint8_t const* source, uint8_t* dest, uint32_t pixelCount);
+}}}}
@@ -10,6 +10,7 @@
 #include "effects/ColorManagementProfile.h"
 #include "effects/EffectTransferTable3D.h"
 #include "geometry/CanvasCachedGeometry.h"
+#include "geometry/CanvasMesh.h"
 #include "images/CanvasCommandList.h"
 #include "images/CanvasVirtualBitmap.h"
 #include "text/CanvasFontFace.h"
@@ -27,70 +28,106 @@
 #include "svg/CanvasSvgStrokeDashArrayAttribute.h"
 
 
-std::unordered_map<IUnknown*, WeakRef> ResourceManager::m_resources;
-std::recursive_mutex ResourceManager::m_mutex;
+ResourceManager::Shard ResourceManager::m_shards[ResourceManager::ShardCount];
 
 // When adding new types here, please also update the "Types that support interop" table in winrt\docsrc\Interop.aml.
-std::vector<ResourceManager::TryCreateFunction> ResourceManager::tryCreateFunctions =
+std::vector<ResourceManager::RegisteredType> ResourceManager::registeredTypes =
 {
-    TryCreate<ID2D1Device1,                CanvasDevice,                      MakeWrapper>,
-    TryCreate<ID2D1DeviceContext1,         CanvasDrawingSession,              MakeWrapper>,
-    TryCreate<ID2D1Bitmap1,                CanvasRenderTarget,                MakeWrapperWithDevice,  IsRenderTargetBitmap>,
-    TryCreate<ID2D1Bitmap1,                CanvasBitmap,                      MakeWrapperWithDevice>,
-    TryCreate<ID2D1CommandList,            CanvasCommandList,                 MakeWrapperWithDevice>,
-    TryCreate<IDXGISwapChain1,             CanvasSwapChain,                   MakeWrapperWithDeviceAndDpi>,
-    TryCreate<ID2D1Geometry,               CanvasGeometry,                    MakeWrapperWithDevice>,
-    TryCreate<ID2D1GeometryRealization,    CanvasCachedGeometry,              MakeWrapperWithDevice>,
-    TryCreate<DWriteTextLayoutType,        CanvasTextLayout,                  MakeWrapperWithDevice>,
-    TryCreate<IDWriteTextFormat1,          CanvasTextFormat,                  MakeWrapper>,
-    TryCreate<ID2D1StrokeStyle1,           CanvasStrokeStyle,                 MakeWrapper>,
-    TryCreate<ID2D1SolidColorBrush,        CanvasSolidColorBrush,             MakeWrapperWithDevice>,
-    TryCreate<ID2D1LinearGradientBrush,    CanvasLinearGradientBrush,         MakeWrapperWithDevice>,
-    TryCreate<ID2D1RadialGradientBrush,    CanvasRadialGradientBrush,         MakeWrapperWithDevice>,
-    TryCreate<ID2D1ImageBrush,             CanvasImageBrush,                  MakeWrapperWithDevice>,
-    TryCreate<ID2D1BitmapBrush1,           CanvasImageBrush,                  MakeWrapperWithDevice>,
+    MakeRegisteredType<ID2D1Device1,                CanvasDevice,                      MakeWrapper>(),
+    MakeRegisteredType<ID2D1DeviceContext1,         CanvasDrawingSession,              MakeWrapper>(),
+    MakeRegisteredType<ID2D1Bitmap1,                CanvasRenderTarget,                MakeWrapperWithDevice,  IsRenderTargetBitmap>(),
+    MakeRegisteredType<ID2D1Bitmap1,                CanvasBitmap,                      MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1CommandList,            CanvasCommandList,                 MakeWrapperWithDevice>(),
+    MakeUncachedRegisteredType<IDXGISwapChain1,     CanvasSwapChain,                   MakeWrapperWithDeviceAndDpi>(),
+    MakeRegisteredType<ID2D1Geometry,               CanvasGeometry,                    MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1GeometryRealization,    CanvasCachedGeometry,              MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1Mesh,                   CanvasMesh,                        MakeWrapperWithDevice>(),
+    MakeRegisteredType<DWriteTextLayoutType,        CanvasTextLayout,                  MakeWrapperWithDevice>(),
+    MakeRegisteredType<IDWriteTextFormat1,          CanvasTextFormat,                  MakeWrapper>(),
+    MakeRegisteredType<ID2D1StrokeStyle1,           CanvasStrokeStyle,                 MakeWrapper>(),
+    MakeRegisteredType<ID2D1SolidColorBrush,        CanvasSolidColorBrush,             MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1LinearGradientBrush,    CanvasLinearGradientBrush,         MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1RadialGradientBrush,    CanvasRadialGradientBrush,         MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1ImageBrush,             CanvasImageBrush,                  MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1BitmapBrush1,           CanvasImageBrush,                  MakeWrapperWithDevice>(),
 #if WINVER > _WIN32_WINNT_WINBLUE
-    TryCreate<ID2D1GradientMesh,           CanvasGradientMesh,                MakeWrapperWithDevice>,
-    TryCreate<ID2D1ImageSource,            CanvasVirtualBitmap,               MakeWrapperWithDevice>,
-    TryCreate<ID2D1TransformedImageSource, CanvasVirtualBitmap,               MakeWrapperWithDevice>,
-    TryCreate<ID2D1LookupTable3D,          EffectTransferTable3D,             MakeWrapperWithDevice>,
-    TryCreate<IDWriteRenderingParams3,     CanvasTextRenderingParameters,     MakeWrapper>,
-    TryCreate<IDWriteFontSet,              CanvasFontSet,                     MakeWrapper>,
-    TryCreate<IDWriteFontFaceReference,    CanvasFontFace,                    MakeWrapper>,
-    TryCreate<ID2D1SvgDocument,            CanvasSvgDocument,                 MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgElement,             CanvasSvgTextElement,              MakeWrapperWithDevice,  IsSvgTextElement>,
-    TryCreate<ID2D1SvgElement,             CanvasSvgNamedElement,             MakeWrapperWithDevice>,
-
-    TryCreate<ID2D1SvgPaint,               CanvasSvgPaintAttribute,           MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgPathData,            CanvasSvgPathAttribute,            MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgPointCollection,     CanvasSvgPointsAttribute,          MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgStrokeDashArray,     CanvasSvgStrokeDashArrayAttribute, MakeWrapperWithDevice>,
+    MakeRegisteredType<ID2D1GradientMesh,           CanvasGradientMesh,                MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1ImageSource,            CanvasVirtualBitmap,               MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1TransformedImageSource, CanvasVirtualBitmap,               MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1LookupTable3D,          EffectTransferTable3D,             MakeWrapperWithDevice>(),
+    MakeRegisteredType<IDWriteRenderingParams3,     CanvasTextRenderingParameters,     MakeWrapper>(),
+    MakeRegisteredType<IDWriteFontSet,              CanvasFontSet,                     MakeWrapper>(),
+    MakeRegisteredType<IDWriteFontFaceReference,    CanvasFontFace,                    MakeWrapper>(),
+    MakeRegisteredType<ID2D1SvgDocument,            CanvasSvgDocument,                 MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1SvgElement,             CanvasSvgTextElement,              MakeWrapperWithDevice,  IsSvgTextElement>(),
+    MakeRegisteredType<ID2D1SvgElement,             CanvasSvgNamedElement,             MakeWrapperWithDevice>(),
+
+    MakeRegisteredType<ID2D1SvgPaint,               CanvasSvgPaintAttribute,           MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1SvgPathData,            CanvasSvgPathAttribute,            MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1SvgPointCollection,     CanvasSvgPointsAttribute,          MakeWrapperWithDevice>(),
+    MakeRegisteredType<ID2D1SvgStrokeDashArray,     CanvasSvgStrokeDashArrayAttribute, MakeWrapperWithDevice>(),
 #else
-    TryCreate<IDWriteRenderingParams2,     CanvasTextRenderingParameters, MakeWrapper>,
-    TryCreate<IDWriteFontCollection,       CanvasFontSet,                 MakeWrapper>,
-    TryCreate<IDWriteFont2,                CanvasFontFace,                MakeWrapper>,
+    MakeRegisteredType<IDWriteRenderingParams2,     CanvasTextRenderingParameters, MakeWrapper>(),
+    MakeRegisteredType<IDWriteFontCollection,       CanvasFontSet,                 MakeWrapper>(),
+    MakeRegisteredType<IDWriteFont2,                CanvasFontFace,                MakeWrapper>(),
 #endif
-    TryCreate<IDWriteTypography,           CanvasTypography,              MakeWrapper>,
-    TryCreate<IDWriteNumberSubstitution,   CanvasNumberSubstitution,      MakeWrapper>,
-    TryCreate<ID2D1ColorContext,           ColorManagementProfile,        MakeWrapperWithDevice>,
+    MakeRegisteredType<IDWriteTypography,           CanvasTypography,              MakeWrapper>(),
+    MakeRegisteredType<IDWriteNumberSubstitution,   CanvasNumberSubstitution,      MakeWrapper>(),
+    MakeRegisteredType<ID2D1ColorContext,           ColorManagementProfile,        MakeWrapperWithDevice>(),
 
     // Effects get their very own try-create function. These are special because ID2D1Effect
     // can map to many different Win2D wrapper types depending on its D2D1_PROPERTY_CLSID.
-    CanvasEffect::TryCreateEffect
+    { __uuidof(ID2D1Effect), CanvasEffect::TryCreateEffect, true }
 };
 
+std::unordered_map<void const*, size_t> ResourceManager::m_probeStartIndices;
+std::mutex ResourceManager::m_probeStartIndicesMutex;
+
+
+ResourceManager::Shard& ResourceManager::GetShard(IUnknown* resourceIdentity)
+{
+    static_assert((ShardCount & (ShardCount - 1)) == 0, "ShardCount must be a power of two");
+
+    // The low bits of a heap pointer are always zero due to alignment, so
+    // skip over those before picking a shard.
+    auto address = reinterpret_cast<uintptr_t>(resourceIdentity);
+    auto hash = (address >> 4) ^ (address >> 12);
+
+    return m_shards[hash & (ShardCount - 1)];
+}
+
 
 // Called by the ResourceWrapper constructor, to add itself to the interop mapping table.
 void ResourceManager::Add(IUnknown* resource, IInspectable* wrapper)
 {
     ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    auto& shard = GetShard(resourceIdentity.Get());
 
-    auto result = m_resources.insert(std::make_pair(resourceIdentity.Get(), AsWeak(wrapper)));
+    Lock lock(shard.Mutex);
+
+    auto result = shard.Resources.insert(std::make_pair(resourceIdentity.Get(), AsWeak(wrapper)));
 
     if (!result.second)
         ThrowHR(E_UNEXPECTED);
+
+    PerformanceCounters::Increment(PerformanceCounter::WrappersCreated);
+}
+
+
+// Called by ResourceWrapper::SetSharedResource. Resources that are shared by more
+// than one wrapper map to whichever wrapper added them first.
+bool ResourceManager::TryAdd(IUnknown* resource, IInspectable* wrapper)
+{
+    ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
+
+    auto& shard = GetShard(resourceIdentity.Get());
+
+    Lock lock(shard.Mutex);
+
+    auto result = shard.Resources.insert(std::make_pair(resourceIdentity.Get(), AsWeak(wrapper)));
+
+    return result.second;
 }
 
 
@@ -99,40 +136,67 @@ void ResourceManager::Remove(IUnknown* resource)
 {
     ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    auto& shard = GetShard(resourceIdentity.Get());
 
-    auto result = m_resources.erase(resourceIdentity.Get());
+    Lock lock(shard.Mutex);
+
+    auto result = shard.Resources.erase(resourceIdentity.Get());
 
     if (result != 1)
         ThrowHR(E_UNEXPECTED);
 }
 
 
+ComPtr<IInspectable> ResourceManager::TryGetExistingWrapper(IUnknown* resourceIdentity)
+{
+    auto& shard = GetShard(resourceIdentity);
+
+    Lock lock(shard.Mutex);
+
+    auto it = shard.Resources.find(resourceIdentity);
+
+    if (it == shard.Resources.end())
+        return nullptr;
+
+    return LockWeakRef<IInspectable>(it->second);
+}
+
+
 ComPtr<IInspectable> ResourceManager::GetOrCreate(ICanvasDevice* device, IUnknown* resource, float dpi)
 {
     ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
-    ComPtr<IInspectable> wrapper;
-
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
     // Do we already have a wrapper around this resource?
-    auto it = m_resources.find(resourceIdentity.Get());
-
-    if (it != m_resources.end())
-    {
-        wrapper = LockWeakRef<IInspectable>(it->second);
-    }
+    auto wrapper = TryGetExistingWrapper(resourceIdentity.Get());
 
     // Create a new wrapper instance?
+    //
+    // This is done without holding any lock, so probing for the resource
+    // type doesn't block other threads. The new wrapper registers itself
+    // via Add, which fails if some other thread got there first - in that
+    // case we use the wrapper created by the winning thread instead.
     if (!wrapper)
     {
-        for (auto& tryCreateFunction : tryCreateFunctions)
+        try
         {
-            if (tryCreateFunction(device, resource, dpi, &wrapper))
+            auto startIndex = GetProbeStartIndex(resourceIdentity.Get());
+
+            // If probing from the cached start index fails, fall back to trying every type.
+            if (!TryCreateFrom(startIndex, device, resource, dpi, &wrapper) && startIndex > 0)
             {
-                break;
+                TryCreateFrom(0, device, resource, dpi, &wrapper);
             }
         }
+        catch (HResultException const& e)
+        {
+            if (e.GetHr() != E_UNEXPECTED)
+                throw;
+
+            wrapper = TryGetExistingWrapper(resourceIdentity.Get());
+
+            if (!wrapper)
+                throw;
+        }
 
         // Fail if we did not find a way to wrap this type.
         if (!wrapper)
@@ -149,6 +213,68 @@ ComPtr<IInspectable> ResourceManager::GetOrCreate(ICanvasDevice* device, IUnknow
 }
 
 
+size_t ResourceManager::GetProbeStartIndex(IUnknown* resourceIdentity)
+{
+    auto vtable = *reinterpret_cast<void const* const*>(resourceIdentity);
+
+    {
+        Lock lock(m_probeStartIndicesMutex);
+
+        auto it = m_probeStartIndices.find(vtable);
+
+        if (it != m_probeStartIndices.end())
+            return it->second;
+    }
+
+    // Find the first type whose interface this object supports. We can't look past
+    // entries with an unknown interface, since those could match anything.
+    //
+    // Only cache the result for classes known to keep the same interfaces. For anything
+    // else, another object with this vtable could support an earlier type, which would
+    // then be skipped without ever reaching the fallback.
+    size_t startIndex = 0;
+
+    for (; startIndex < registeredTypes.size(); startIndex++)
+    {
+        auto& iid = registeredTypes[startIndex].ResourceIid;
+
+        if (IsEqualGUID(iid, GUID_NULL))
+            break;
+
+        ComPtr<IUnknown> probe;
+
+        if (SUCCEEDED(resourceIdentity->QueryInterface(iid, &probe)))
+            break;
+    }
+
+    bool isCacheable = startIndex < registeredTypes.size() &&
+                       registeredTypes[startIndex].IsProbeCacheable;
+
+    if (isCacheable)
+    {
+        Lock lock(m_probeStartIndicesMutex);
+
+        m_probeStartIndices[vtable] = startIndex;
+    }
+
+    return startIndex;
+}
+
+
+bool ResourceManager::TryCreateFrom(size_t startIndex, ICanvasDevice* device, IUnknown* resource, float dpi, ComPtr<IInspectable>* result)
+{
+    for (size_t i = startIndex; i < registeredTypes.size(); i++)
+    {
+        if (registeredTypes[i].TryCreate(device, resource, dpi, result))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 // Validation rules:
 //  - If the caller specified a device or dpi, and the wrapper has device/dpi, these must match.
 //  - If the caller specified device or dpi but the wrapper has no device/dpi, we'll allow that, ignoring the parameter.
@@ -209,17 +335,23 @@ void ResourceManager::ValidateDpi(ICanvasResourceWrapperWithDpi* wrapper, float
 
 void ResourceManager::RegisterType(TryCreateFunction tryCreate)
 {
-    assert(std::find(tryCreateFunctions.begin(), tryCreateFunctions.end(), tryCreate) == tryCreateFunctions.end());
+    assert(std::find_if(registeredTypes.begin(), registeredTypes.end(), [=](RegisteredType const& type) { return type.TryCreate == tryCreate; }) == registeredTypes.end());
 
-    tryCreateFunctions.push_back(tryCreate);
+    registeredTypes.push_back(RegisteredType{ GUID_NULL, tryCreate, false });
+
+    Lock lock(m_probeStartIndicesMutex);
+    m_probeStartIndices.clear();
 }
 
 
 void ResourceManager::UnregisterType(TryCreateFunction tryCreate)
 {
-    auto it = std::find(tryCreateFunctions.begin(), tryCreateFunctions.end(), tryCreate);
+    auto it = std::find_if(registeredTypes.begin(), registeredTypes.end(), [=](RegisteredType const& type) { return type.TryCreate == tryCreate; });
+
+    assert(it != registeredTypes.end());
 
-    assert(it != tryCreateFunctions.end());
+    registeredTypes.erase(it);
 
-    tryCreateFunctions.erase(it);
+    Lock lock(m_probeStartIndicesMutex);
+    m_probeStartIndices.clear();
 }
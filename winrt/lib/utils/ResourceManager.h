@@ -27,6 +27,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     public:
         // Used by ResourceWrapper to maintain its state in the interop mapping table.
         static void Add(IUnknown* resource, IInspectable* wrapper);
+        static bool TryAdd(IUnknown* resource, IInspectable* wrapper);
         static void Remove(IUnknown* resource);
 
 
@@ -64,6 +65,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         typedef bool(*TryCreateFunction)(ICanvasDevice* device, IUnknown* resource, float dpi, ComPtr<IInspectable>* result);
 
 
+        // Each entry in the type table pairs a try-create function with the interface it probes for.
+        // Knowing the interface lets GetOrCreate skip entries that can never match a given class
+        // of native object. ResourceIid is GUID_NULL if the probed interface is not known.
+        //
+        // IsProbeCacheable is set for resources that D2D and DWrite implement themselves, whose
+        // classes always expose the same interfaces. Other objects, such as swap chains (which
+        // apps, overlays and debug layers can wrap or aggregate), may answer QueryInterface
+        // differently despite sharing a vtable, so they are probed from the start every time.
+        struct RegisteredType
+        {
+            IID ResourceIid;
+            TryCreateFunction TryCreate;
+            bool IsProbeCacheable;
+        };
+
+
         // Allow unit tests to inject additional try-create functions.
         static void RegisterType(TryCreateFunction tryCreate);
         static void UnregisterType(TryCreateFunction tryCreate);
@@ -101,6 +118,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
 
 
+        template<typename TResource, typename TWrapper, typename TMaker, bool TTester(TResource*) = DefaultTester<TResource>>
+        static RegisteredType MakeRegisteredType()
+        {
+            return RegisteredType{ __uuidof(TResource), TryCreate<TResource, TWrapper, TMaker, TTester>, true };
+        }
+
+        template<typename TResource, typename TWrapper, typename TMaker, bool TTester(TResource*) = DefaultTester<TResource>>
+        static RegisteredType MakeUncachedRegisteredType()
+        {
+            return RegisteredType{ __uuidof(TResource), TryCreate<TResource, TWrapper, TMaker, TTester>, false };
+        }
+
+
         //  Calls Make<> on a type whose constructor wants only a resource parameter.
         struct MakeWrapper
         {
@@ -155,10 +185,34 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
     private:
         // Native resource -> WinRT wrapper map, shared by all active resources.
-        static std::unordered_map<IUnknown*, WeakRef> m_resources;
-        static std::recursive_mutex m_mutex;
+        //
+        // This is split into shards, each with its own lock, so that threads
+        // creating and destroying unrelated wrappers don't serialize on a
+        // single global mutex. Resources are assigned to shards by hashing
+        // their COM identity pointer.
+        struct Shard
+        {
+            std::unordered_map<IUnknown*, WeakRef> Resources;
+            std::mutex Mutex;
+        };
+
+        static const size_t ShardCount = 32;
+
+        static Shard m_shards[ShardCount];
+
+        static Shard& GetShard(IUnknown* resourceIdentity);
+        static ComPtr<IInspectable> TryGetExistingWrapper(IUnknown* resourceIdentity);
 
         // Table of try-create functions, one per type.
-        static std::vector<TryCreateFunction> tryCreateFunctions;
+        static std::vector<RegisteredType> registeredTypes;
+
+        // Native objects of the same class share a vtable. For the classes whose first matching
+        // type is marked IsProbeCacheable, this caches, per vtable, the index of that type, so
+        // repeated wrapping skips the QIs for earlier entries.
+        static std::unordered_map<void const*, size_t> m_probeStartIndices;
+        static std::mutex m_probeStartIndicesMutex;
+
+        static size_t GetProbeStartIndex(IUnknown* resourceIdentity);
+        static bool TryCreateFrom(size_t startIndex, ICanvasDevice* device, IUnknown* resource, float dpi, ComPtr<IInspectable>* result);
     };
 }}}}
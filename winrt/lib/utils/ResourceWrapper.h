@@ -30,6 +30,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
         ClosablePtr<TResource> m_resource;
 
+        // False if this wrapper shares its resource with another one that owns the interop mapping.
+        bool m_ownsInteropMapping;
+
     protected:
         ResourceWrapper(TResource* resource)
             : ResourceWrapper(resource, GetOuterInspectable())
@@ -37,10 +40,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         ResourceWrapper(TResource* resource, IInspectable* outerInspectable)
             : m_resource(resource)
+            , m_ownsInteropMapping(false)
         {
             if (resource)
             {
                 ResourceManager::Add(resource, outerInspectable);
+                m_ownsInteropMapping = true;
             }
         }
 
@@ -55,7 +60,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             {
                 auto resource = m_resource.Close();
 
-                ResourceManager::Remove(resource.Get());
+                if (m_ownsInteropMapping)
+                {
+                    ResourceManager::Remove(resource.Get());
+                    m_ownsInteropMapping = false;
+                }
             }
         }
 
@@ -68,6 +77,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 m_resource = resource;
 
                 ResourceManager::Add(resource, GetOuterInspectable());
+                m_ownsInteropMapping = true;
+            }
+        }
+
+        // For immutable resources that may be wrapped by more than one wrapper at a
+        // time, for instance because they came from the device's EffectResourceCache.
+        // Interop lookups find whichever wrapper attached the resource first.
+        void SetSharedResource(TResource* resource)
+        {
+            ReleaseResource();
+
+            if (resource)
+            {
+                m_resource = resource;
+
+                m_ownsInteropMapping = ResourceManager::TryAdd(resource, GetOuterInspectable());
             }
         }
 
@@ -10,10 +10,18 @@
 // English, this data should be moved out to a proper resources file. But for 
 // now, simple C++ constants are "good enough"(tm).
 
+STRING(AdapterNotFound, L"There is no graphics adapter with the given AdapterId.")
 STRING(AutoFileFormatNotAllowed, L"The option CanvasFileFormat.Auto is not allowed when saving to a stream.")
+STRING(BatchedPrimitiveArraySizeMismatch, L"Each per-primitive array must contain either one element per primitive, or a single element that applies to all of them.")
+STRING(BitmapAtlasTooLarge, L"The bitmaps do not fit in a single bitmap of the maximum size supported by the device.")
+STRING(BitmapCopyArraySizesMismatch, L"There must be one destination point for each bitmap, and either no source rectangles or one for each bitmap.")
 STRING(BitmapFormatsDiffer, L"Bitmaps are not the same pixel format.")
+STRING(BitmapSizesDiffer, L"Bitmaps are not the same size.")
 STRING(BlockCompressedDimensionsMustBeMultipleOf4, L"Block compressed image width & height must be a multiple of 4 pixels.")
+STRING(BlockCompressedLoadRequiresPremultipliedAlpha, L"Block compressed bitmaps can only be loaded with premultiplied alpha.")
 STRING(BlockCompressedSubRectangleMustBeAligned, L"Subrectangles from block compressed images must be aligned to a multiple of 4 pixels.")
+STRING(CachedGeometryCacheWrongDevice, L"The CanvasGeometry passed to a CanvasCachedGeometryCache was created on a different device.")
+STRING(CachedSpriteBatchWrongDevice, L"This CanvasCachedSpriteBatch was created on a different device than the drawing session.")
 STRING(CacheOnDemandNotSet, L"This method may only be called if the CanvasVirtualBitmap was created with CanvasVirtualBitmapOptions.CacheOnDemand.")
 STRING(CannotCreateDrawingSessionUntilPreviousOneClosed, L"The last drawing session returned by CreateDrawingSession must be disposed before a new one can be created.")
 STRING(CanOnlyAddPathDataWhileInFigure, L"This operation is only allowed after a successful call to CanvasPathBuilder.BeginFigure.")
@@ -24,7 +32,12 @@ STRING(CanvasPrintDocumentGetDeferralMayOnlyBeCalledOnce, L"GetDeferral can only
 STRING(CanvasPrintDocumentDeferralCompleteMayOnlyBeCalledOnce, L"CanvasPrintDeferral.Complete may only be called once.")
 STRING(ColorManagementProfileTypeNotSupported, L"This type of ColorManagementProfile is not supported on this version of Windows. Use ColorManagementProfile.IsSupported to determine which types are available.")
 STRING(CommandListCannotBeDrawnToAfterItHasBeenUsed, L"CanvasCommandList.CreateDrawingSession cannot be called after the CanvasCommandList has been used as an image.")
+STRING(CommandListCannotBeSerialized, L"This CanvasCommandList contains drawing commands that cannot be serialized. Effects, meshes, ink, gradient meshes, sprite batches and GDI metafiles are not supported.")
+STRING(ComputeEffectBadFeatureLevel, L"This shader requires a higher Direct3D feature level than is supported by the device. Check ComputeShaderEffect.IsSupported before using it.")
+STRING(ComputeEffectBadShader, L"Unable to load the specified shader. This should be a Direct3D compute shader compiled for shader model 5.")
+STRING(ComputeStatisticsBadFeatureLevel, L"CanvasImage.ComputeStatistics requires Direct3D feature level 10 or higher, which this device does not support.")
 STRING(CreateDrawingSessionCalledBeforeRegionsInvalidated, L"CreateDrawingSession cannot be called before the RegionsInvalidated event has been raised.")
+STRING(CubicBezierPointCountMustBeMultipleOf3, L"CanvasPathBuilder.AddCubicBeziers requires three points (two control points and an end point) per segment.")
 STRING(CustomEffectBadFeatureLevel, L"This shader requires a higher Direct3D feature level than is supported by the device. Check PixelShaderEffect.IsSupported before using it.")
 STRING(CustomEffectBadShader, L"Unable to load the specified shader. This should be a Direct3D pixel shader compiled for shader model 4.")
 STRING(CustomEffectBadPropertyType, L"Shader property '%S' is an unsupported type.")
@@ -38,46 +51,86 @@ STRING(CustomEffectWrongPropertyArraySize, L"Wrong array size. Shader property '
 STRING(CustomEffectWrongPropertyType, L"Wrong type. Shader property '%s' is of type %s.")
 STRING(CustomEffectWrongPropertyTypeArray, L"Wrong type. Shader property '%s' is an array of %s.")
 STRING(DeviceExpectedToBeLost, L"This API was unexpectedly called when the Direct3D device is not lost.")
+STRING(DidNotPopClip, L"After calling CanvasDrawingSession.PushClip, you must call PopClip before ending the CanvasDrawingSession.")
 STRING(DidNotPopLayer, L"After calling CanvasDrawingSession.CreateLayer, you must close the resulting CanvasActiveLayer before ending the CanvasDrawingSession.")
 STRING(DrawImageMinBlendNotSupported, L"This DrawImage overload is not valid when CanvasDrawingSession.Blend is set to CanvasBlend.Min.")
+STRING(DrawingStateFromDifferentDevice, L"This CanvasDrawingState was saved from a drawing session on a different device.")
+STRING(DrawLinesRequiresPointPairs, L"CanvasDrawingSession.DrawLines expects an even number of points: each line is described by a pair of start and end points.")
+STRING(EffectAnimationBadKeyframes, L"Animations need at least one keyframe, and keyframes must be in order of increasing time.")
+STRING(EffectAnimationUnknownProperty, L"Effect does not have a property named '%s'.")
+STRING(EffectAnimationUnsupportedProperty, L"Property '%s' cannot be animated. Only float, vector, color and rectangle properties can be animated.")
+STRING(EffectGraphTemplateUnsupportedEffect, L"CanvasEffectGraphTemplate cannot contain PixelShaderEffect.")
+STRING(EffectGraphTemplateWrongInputCount, L"The number of inputs passed to CanvasEffectGraphTemplate.Instantiate must match InputCount.")
 STRING(EffectNoSources, L"Effect Sources collection is empty.")
 STRING(EffectNullSource, L"Effect source #%d is null.")
 STRING(EffectWrongDevice, L"Effect source #%d is associated with a different device.")
 STRING(EffectWrongSourceType, L"Effect source #%d is an unsupported type. To draw an effect using Win2D, all its sources must be Win2D ICanvasImage objects.")
+STRING(EncoderOptionUnknown, L"The image encoder does not have an option named '%s'.")
+STRING(EncoderOptionWrongType, L"Wrong type. Image encoder option '%s' must be a number or boolean that can be converted to the type the encoder expects.")
 STRING(EndFigureWithoutBeginFigure, L"A call to CanvasPathBuilder.EndFigure occurred without a previous call to CanvasPathBuilder.BeginFigure.")
 STRING(ExpectedPositiveNonzero, L"A positive, non-zero number was expected for this method.")
 STRING(ExternalInlineObject, L"Attempted to retrieve an inline object which was not implemented as an ICanvasTextInlineObject.")
 STRING_A(GameLoopThreadName, "Win2D game loop thread")
 STRING(GetResourceNoDevice, L"To unwrap this resource type, a device parameter must be passed to GetWrappedResource.")
+STRING(GlyphAtlasWrongDevice, L"This CanvasGlyphAtlas was created on a different device than the drawing session.")
 STRING(ImageBrushRequiresSourceRectangle, L"When using image types other than CanvasBitmap, CanvasImageBrush.SourceRectangle must not be null.")
 STRING(InvalidAlphaModeForImageSource, L"An invalid alpha mode was specified. Use either CanvasAlphaMode.Ignore or CanvasAlphaMode.Premultiplied.")
+STRING(InvalidDrawingTrace, L"The data is not a valid CanvasDrawingTrace.")
+STRING(InvalidFigureOffsets, L"Figure offsets must start at zero, be in increasing order, and be less than the number of points.")
 STRING(InvalidFontFamilyUri, L"The font URI specified is not a valid application URI that can be opened by StorageFile.GetFileFromApplicationUriAsync.")
 STRING(InvalidFontFamilyUriScheme, L"The URI specified in the CanvasTextFormat's FontFamily has an invalid scheme; the scheme may be omitted, or must be one of ms-appx:// or ms-appdata://.")
+STRING(InvalidPathData, L"The path data is not valid SVG path syntax. Parsing stopped at character %d.")
+STRING(InvalidSerializedCommandList, L"The data is not a valid serialized CanvasCommandList.")
 STRING(InvalidTypographyFeatureName, L"Attempted to add a typography feature without setting a valid feature name.")
+STRING(MaximumFrameLatencyOutOfRange, L"MaximumFrameLatency must be between 0 and 16.")
+STRING(MinimumResolutionScaleOutOfRange, L"MinimumResolutionScale must be greater than 0 and no more than 1.")
 STRING(MultipleAsyncCreateResourcesNotSupported, L"Only one asynchronous CreateResources action can be tracked at a time.")
 STRING(NotSupportedOnThisVersionOfWindows, L"This API is not supported on this version of Windows.")
+STRING(Nv12DimensionsMustBeEven, L"NV12 image width & height must be a multiple of 2 pixels.")
 STRING(PathBuilderAddGeometryMidFigure, L"CanvasPathBuilder.AddGeometry may not be called in the middle of a figure.")
 STRING(PathBuilderClosedMidFigure, L"There was an attempt to use a CanvasPathBuilder, which was missing a call to CanvasPathBuilder.EndFigure.")
+STRING(PixelAlphaConversionFormatRestriction, L"Converting between alpha modes is only supported for resources with pixel format DirectXPixelFormat.B8G8R8A8UIntNormalized or DirectXPixelFormat.R8G8B8A8UIntNormalized.")
 STRING(PixelColorsFormatRestriction, L"This method only supports resources with pixel format DirectXPixelFormat.B8G8R8A8UIntNormalized.")
+STRING(PoppedWrongClip, L"PopClip was called without a matching PushClip, or before closing a CanvasActiveLayer that was created after the clip was pushed.")
 STRING(PoppedWrongLayer, L"Attempting to close a CanvasActiveLayer that is not top of the stack. The most recently created layer must be closed first.")
+STRING(PopTransformWithoutPush, L"PopTransform was called without a matching PushTransform.")
+STRING(ProfileScopeResultNotAvailable, L"The GPU duration of this CanvasProfileScope is not available. Check that its Status is Complete first.")
+STRING(QuadraticBezierPointCountMustBeMultipleOf2, L"CanvasPathBuilder.AddQuadraticBeziers requires two points (a control point and an end point) per segment.")
 STRING(RemoteFontUnavailable, L"The requested font is not locally available.")
+STRING(RenderNodeCycle, L"A CanvasRenderNode cannot be a descendant of itself.")
+STRING(RenderTargetNotShared, L"This CanvasRenderTarget is not backed by a shared surface with a keyed mutex. Create it with CanvasRenderTarget.CreateShared or OpenShared.")
+STRING(RenderTargetPoolCannotReturnWithActiveDrawingSession, L"A CanvasRenderTarget cannot be returned to a CanvasRenderTargetPool while it has an active drawing session. Dispose the drawing session first.")
+STRING(RenderTargetPoolWrongDevice, L"The CanvasRenderTarget returned to a CanvasRenderTargetPool was created on a different device.")
 STRING(ResourceManagerNoDevice, L"To wrap this resource type, a device parameter must be passed to GetOrCreate.")
 STRING(ResourceManagerNoDpi, L"To wrap this resource type, a dpi parameter must be passed to GetOrCreate.")
 STRING(ResourceManagerUnknownType, L"Unsupported type. Win2D is not able to wrap the specified resource.")
 STRING(ResourceManagerWrongDevice, L"Existing resource wrapper is associated with a different device.")
 STRING(ResourceManagerWrongDpi, L"Existing resource wrapper has a different DPI.")
+STRING(ResourceManifestKeyNotFound, L"The resource manifest does not contain an entry with this key.")
+STRING(ResourceManifestNotLoaded, L"This resource has not been created yet. Call LoadAsync after adding entries to the resource manifest.")
+STRING(ResourceManifestUnknownGeometryKey, L"Cached geometries must refer to a geometry that has been added to the same resource manifest.")
+STRING(ResourceManifestWrongType, L"The resource manifest entry with this key is a different type of resource.")
 STRING(SetFilledRegionDeterminationAfterBeginFigure, L"This operation is not allowed after the first call to CanvasPathBuilder.BeginFigure.")
 STRING(SetPageCountCalledBeforePreviewing, L"CanvasPrintDocument.SetPageCount or CanvasPrintDocument.SetIntermediatePageCount cannot be called until the Paginate event has been raised.")
 STRING(SharedDeviceWrongDebugLevel, L"CanvasDevice.DebugLevel has changed since this shared device was created. The debug level must be set before the first call to GetSharedDevice.")
+STRING(SharedRenderTargetReleasedWithActiveDrawingSession, L"ReleaseSharedAccess cannot be called while a drawing session is open on this CanvasRenderTarget.")
+STRING(SourceRectangleOutsideImage, L"The source rectangle must lie within the bounds of the image.")
 STRING(SpriteBatchInvalidInterpolation, L"Invalid interpolation mode specified. Sprite batches only support CanvasImageInterpolation.NearestNeighbor or CanvasImageInterpolation.Linear.")
 STRING(SpriteBatchNotAvailable, L"Sprite batches are not supported on this device. Use CanvasSpriteBatch.IsSupported to determine if sprite batches are supported.")
+STRING(StrokeStyleIsFrozen, L"This CanvasStrokeStyle was created by CanvasStrokeStyle.CreateFrozen and cannot be changed.")
 STRING(SurfaceTooBig, L"Cannot create %s sized %d x %d; MaximumBitmapSizeInPixels for this device is %d.")
+STRING(SvgAttributeBatchArraySizesMismatch, L"There must be one attribute handle and one value for each SVG element, or a single handle or value used for all of them.")
+STRING(SvgAttributeHandleNotValid, L"The attribute handle was not returned by RegisterAttributeName on this SVG document.")
+STRING(SvgAttributeValueWithoutName, L"An SVG attribute value can only be matched if an attribute name is also given.")
 STRING(SvgDocumentTreeMustHaveConsistentDevice, L"There was an attempt to create an SVG document tree involving two different devices, which is not allowed. All parts of an SVG document tree should have the same device.");
+STRING(SvgIconAtlasSizesMismatch, L"There must be one size for each SVG document, or a single size used for all of them.")
+STRING(SvgIconAtlasTooLarge, L"The SVG icons do not fit in a single bitmap of the maximum size supported by the device.")
 STRING(SvgLineCapTriangleNotAllowed, L"An SVG line cap set to Triangle is not allowed.")
 STRING(SvgNotAvailable, L"SVG features are not supported on this version of Windows. Use CanvasSvgDocument.IsSupported to determine if SVG features are supported.")
 STRING(SvgStrokeDashArrayMismatchingArraySizes, L"The two arrays used for setting CanvasStrokeDashArrayAttribute units and values must be the same size.")
 STRING(SvgTextShouldHaveNonZeroLength, L"The specified SVG string has length zero; a valid SVG string was expected.")
 STRING(SvgViewportSizeNotValid, L"The width and height of an SVG viewport must be positive, and nonzero.")
+STRING(SwapChainColorSpaceNotSupported, L"This swap chain cannot be presented in the requested color space. Use CanvasSwapChain.IsColorSpaceSupported to determine which color spaces are supported for its format.")
 STRING(TextRendererNotValid, L"The application called a method on a text renderer, but this text renderer is no longer valid.")
 STRING(TwoBeginFigures, L"A call to CanvasPathBuilder.BeginFigure occurred, when the figure was already begun.")
 STRING(UnrecognizedImageFileExtension, L"When saving a CanvasBitmap without specifying a CanvasBitmapFileFormat, the file name must include a recognized file extension such as '.jpeg' or '.png'.")
@@ -490,6 +490,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             return m_recreatableDeviceManager->IsReadyToDraw();
         }
 
+        float GetCreateResourcesProgress() const
+        {
+            return m_recreatableDeviceManager->GetCreateResourcesProgress();
+        }
+
         bool IsLoaded() const
         {
             return m_isLoaded;
@@ -978,9 +983,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         {
             ComPtr<ICanvasDrawingSession> drawingSession;
             ThrowIfFailed(target->CreateDrawingSession(clearColor, &drawingSession));
+            DrawWithSession(drawingSession.Get(), callDrawHandlers, isRunningSlowly);
+        }
+
+        //
+        // Optionally calls the draw handlers on an already created drawing
+        // session and then closes it.
+        //
+        void DrawWithSession(ICanvasDrawingSession* drawingSession, bool callDrawHandlers, bool isRunningSlowly)
+        {
             if (callDrawHandlers)
             {
-                auto drawEventArgs = GetControl()->CreateDrawEventArgs(drawingSession.Get(), isRunningSlowly);
+                auto drawEventArgs = GetControl()->CreateDrawEventArgs(drawingSession, isRunningSlowly);
                 ThrowIfFailed(m_drawEventList.InvokeAll(GetControl(), drawEventArgs.Get()));
             }
 
@@ -36,8 +36,9 @@ IFACEMETHODIMP CanvasAnimatedUpdateEventArgsFactory::Create(
 // CanvasAnimatedUpdateEventArgs implementation
 //
 
-CanvasAnimatedUpdateEventArgs::CanvasAnimatedUpdateEventArgs(CanvasTimingInformation timing)
+CanvasAnimatedUpdateEventArgs::CanvasAnimatedUpdateEventArgs(CanvasTimingInformation timing, IInspectable* state)
     : m_timingInformation(timing)
+    , m_state(state)
 {
 }
 
@@ -52,6 +53,26 @@ IFACEMETHODIMP CanvasAnimatedUpdateEventArgs::get_Timing(CanvasTimingInformation
         });
 }
 
+IFACEMETHODIMP CanvasAnimatedUpdateEventArgs::get_State(IInspectable** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_state.CopyTo(value));
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedUpdateEventArgs::put_State(IInspectable* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            m_state = value;
+        });
+}
+
 //
 // CanvasAnimatedDrawEventArgsFactory implementation
 //
@@ -79,9 +100,11 @@ IFACEMETHODIMP CanvasAnimatedDrawEventArgsFactory::Create(
 
 CanvasAnimatedDrawEventArgs::CanvasAnimatedDrawEventArgs(
     ICanvasDrawingSession* drawingSession,
-    CanvasTimingInformation timingInformation)
+    CanvasTimingInformation timingInformation,
+    IInspectable* state)
     : m_drawingSession(drawingSession)
     , m_timingInformation(timingInformation)
+    , m_state(state)
 {
 }
 
@@ -109,6 +132,17 @@ IFACEMETHODIMP CanvasAnimatedDrawEventArgs::get_Timing(CanvasTimingInformation*
         });
 }
 
+IFACEMETHODIMP CanvasAnimatedDrawEventArgs::get_State(IInspectable** value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckAndClearOutPointer(value);
+
+            ThrowIfFailed(m_state.CopyTo(value));
+        });
+}
+
 //
 // CanvasAnimatedControlFactory
 //
@@ -147,6 +181,15 @@ CanvasAnimatedControl::CanvasAnimatedControl(std::shared_ptr<ICanvasAnimatedCont
     : BaseControlWithDrawHandler<CanvasAnimatedControlTraits>(adapter, false)
     , m_stepTimer(adapter)
     , m_hasUpdated(false)
+    , m_shouldWaitForFrameLatency(false)
+    , m_isTearingRequestedForTarget(false)
+    , m_colorSpaceOfTarget(CanvasSwapChainColorSpace::Srgb)
+    , m_useSharedGameLoop(false)
+    , m_resolutionScaleOfTarget(1.0f)
+    , m_isWakingFromIdle(false)
+    , m_isOccluded(false)
+    , m_lastUpdate{}
+    , m_isDrawingLastUpdate(false)
 {
     CreateContentControl();
 
@@ -316,6 +359,299 @@ IFACEMETHODIMP CanvasAnimatedControl::get_TargetElapsedTime(TimeSpan* value)
         });
 }
 
+IFACEMETHODIMP CanvasAnimatedControl::put_MaximumFrameLatency(int32_t value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (value < 0 || value > DXGI_MAX_SWAP_CHAIN_BUFFERS)
+            {
+                ThrowHR(E_INVALIDARG, Strings::MaximumFrameLatencyOutOfRange);
+            }
+
+            // The update/render thread notices this change on its next tick,
+            // and stops if the swap chain needs to be recreated.
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.MaximumFrameLatency = static_cast<uint32_t>(value);
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_MaximumFrameLatency(int32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = static_cast<int32_t>(m_sharedState.MaximumFrameLatency);
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsUpdatePipelined(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.IsUpdatePipelined = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsUpdatePipelined(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsUpdatePipelined;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsTearingAllowed(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.IsTearingAllowed = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsTearingAllowed(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsTearingAllowed;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_ColorSpace(CanvasSwapChainColorSpace value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            switch (value)
+            {
+            case CanvasSwapChainColorSpace::Srgb:
+            case CanvasSwapChainColorSpace::ScRgb:
+            case CanvasSwapChainColorSpace::Hdr10:
+                break;
+
+            default:
+                ThrowHR(E_INVALIDARG);
+            }
+
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.ColorSpace = value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_ColorSpace(CanvasSwapChainColorSpace* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.ColorSpace;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsSwapChainOverallocationAllowed(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.IsSwapChainOverallocationAllowed = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsSwapChainOverallocationAllowed(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsSwapChainOverallocationAllowed;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsFramePacingAdaptive(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.IsFramePacingAdaptive = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsFramePacingAdaptive(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsFramePacingAdaptive;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_FrameTimeJitter(TimeSpan* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            value->Duration = static_cast<INT64>(m_sharedState.FrameTimeJitter);
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsFrameStatisticsEnabled(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+
+            if (value && !m_sharedState.IsFrameStatisticsEnabled)
+                m_sharedState.FrameStatistics.Reset();
+
+            m_sharedState.IsFrameStatisticsEnabled = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsFrameStatisticsEnabled(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsFrameStatisticsEnabled;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::GetFrameStatistics(CanvasAnimatedFrameStatistics* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.FrameStatistics.GetStatistics();
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsResolutionDynamic(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.IsResolutionDynamic = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsResolutionDynamic(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsResolutionDynamic;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_MinimumResolutionScale(float value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (!(value > 0.0f && value <= 1.0f))
+            {
+                ThrowHR(E_INVALIDARG, Strings::MinimumResolutionScaleOutOfRange);
+            }
+
+            auto lock = Lock(m_sharedStateMutex);
+            m_sharedState.MinimumResolutionScale = value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_MinimumResolutionScale(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.MinimumResolutionScale;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_ResolutionScale(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.ResolutionScale;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_IsUpdateOnDemand(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+
+            bool oldState = m_sharedState.IsUpdateOnDemand;
+            m_sharedState.IsUpdateOnDemand = !!value;
+
+            // The game loop may have stopped for want of a request, in which
+            // case it needs restarting.
+            if (oldState && !m_sharedState.IsUpdateOnDemand)
+            {
+                lock.unlock();
+                Changed(ChangeReason::Other);
+            }
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_IsUpdateOnDemand(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.IsUpdateOnDemand;
+        });
+}
+
 IFACEMETHODIMP CanvasAnimatedControl::put_Paused(boolean value)
 {
     return ExceptionBoundary(
@@ -400,6 +736,36 @@ IFACEMETHODIMP CanvasAnimatedControl::Invalidate()
             auto wasInvalidated = m_sharedState.Invalidated;
             
             m_sharedState.Invalidated = true;
+            m_sharedState.IsWholeFrameDirty = true;
+
+            lock.unlock();
+
+            if (!wasInvalidated)
+            {
+                Changed(ChangeReason::Other);
+            }
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::InvalidateRect(Rect rect)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (rect.Width < 0 || rect.Height < 0)
+                ThrowHR(E_INVALIDARG);
+
+            auto lock = Lock(m_sharedStateMutex);
+
+            auto wasInvalidated = m_sharedState.Invalidated;
+            
+            m_sharedState.Invalidated = true;
+
+            // Past a point tracking the rects costs more than it saves.
+            if (m_sharedState.DirtyRects.size() < MaximumDirtyRectCount)
+                m_sharedState.DirtyRects.push_back(rect);
+            else
+                m_sharedState.IsWholeFrameDirty = true;
 
             lock.unlock();
 
@@ -421,6 +787,28 @@ IFACEMETHODIMP CanvasAnimatedControl::ResetElapsedTime()
         });
 }
 
+IFACEMETHODIMP CanvasAnimatedControl::RequestUpdate()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_sharedStateMutex);
+
+            auto wasUpdateRequested = m_sharedState.IsUpdateRequested;
+
+            m_sharedState.IsUpdateRequested = true;
+
+            bool isUpdateOnDemand = m_sharedState.IsUpdateOnDemand;
+
+            lock.unlock();
+
+            if (isUpdateOnDemand && !wasUpdateRequested)
+            {
+                Changed(ChangeReason::Other);
+            }
+        });
+}
+
 IFACEMETHODIMP CanvasAnimatedControl::CreateCoreIndependentInputSource(
     CoreInputDeviceTypes deviceTypes,
     ICoreInputSourceBase** returnValue)
@@ -530,9 +918,10 @@ IFACEMETHODIMP CanvasAnimatedControl::RunOnGameLoopThreadAsync(
 
             ThrowIfFailed(newAsyncAction.CopyTo(asyncAction));
 
-            // If we're paused then we need to arrange to reschedule the tick
-            // loop, otherwise we won't get around to running the callback.
-            if (m_sharedState.IsPaused)
+            // If we're paused, or idle in on-demand mode, then we need to
+            // arrange to reschedule the tick loop, otherwise we won't get
+            // around to running the callback.
+            if (m_sharedState.IsPaused || m_sharedState.IsUpdateOnDemand)
             {
                 lock.unlock();
                 Changed(ChangeReason::Other);
@@ -540,6 +929,29 @@ IFACEMETHODIMP CanvasAnimatedControl::RunOnGameLoopThreadAsync(
         });
 }
 
+IFACEMETHODIMP CanvasAnimatedControl::put_UseSharedGameLoop(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckIsOnUIThread();
+
+            m_useSharedGameLoop = !!value;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_UseSharedGameLoop(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            CheckIsOnUIThread();
+
+            *value = m_useSharedGameLoop;
+        });
+}
+
 void CanvasAnimatedControl::CreateOrUpdateRenderTarget(
     ICanvasDevice* device,
     CanvasAlphaMode newAlphaMode,
@@ -547,15 +959,29 @@ void CanvasAnimatedControl::CreateOrUpdateRenderTarget(
     Size newSize,
     RenderTarget* renderTarget)
 {
+    auto lock = Lock(m_sharedStateMutex);
+    uint32_t maximumFrameLatency = m_sharedState.MaximumFrameLatency;
+    bool isTearingAllowed = m_sharedState.IsTearingAllowed;
+    auto colorSpace = m_sharedState.ColorSpace;
+    bool isSwapChainOverallocationAllowed = m_sharedState.IsSwapChainOverallocationAllowed;
+    lock.unlock();
+
     bool needsTarget = (renderTarget->Target == nullptr);
     bool alphaModeChanged = (renderTarget->AlphaMode != newAlphaMode);
     bool dpiChanged = (renderTarget->Dpi != newDpi);
     bool sizeChanged = (renderTarget->Size != newSize);
-    bool needsCreate = needsTarget || alphaModeChanged;
+    bool frameLatencyWaitableChanged = !needsTarget && (renderTarget->Target->IsFrameLatencyWaitable() != (maximumFrameLatency != 0));
+    bool tearingChanged = !needsTarget && (m_isTearingRequestedForTarget != isTearingAllowed);
+    bool colorSpaceChanged = !needsTarget && (m_colorSpaceOfTarget != colorSpace);
+    bool needsCreate = needsTarget || alphaModeChanged || frameLatencyWaitableChanged || tearingChanged || colorSpaceChanged;
 
     if (!needsCreate && !sizeChanged && !dpiChanged)
         return;
 
+    // New and resized swap chains are shown at their full size.
+    m_resolutionScaleOfTarget = 1.0f;
+    m_isOccluded = false;
+
     if (newSize.Width <= 0 || newSize.Height <= 0)
     {
         // Zero-sized controls don't have swap chain objects
@@ -564,24 +990,44 @@ void CanvasAnimatedControl::CreateOrUpdateRenderTarget(
     }
     else if ((sizeChanged || dpiChanged) && !needsCreate)
     {
-        ThrowIfFailed(renderTarget->Target->ResizeBuffersWithWidthAndHeightAndDpi(newSize.Width, newSize.Height, newDpi));
+        ResizeSwapChain(renderTarget->Target.Get(), newSize, newDpi, isSwapChainOverallocationAllowed);
 
         renderTarget->Size = newSize;
         renderTarget->Dpi = newDpi;
     }
     else
     {
-        renderTarget->Target = GetAdapter()->CreateCanvasSwapChain(
-            device,
-            newSize.Width,
-            newSize.Height,
-            newDpi,
-            newAlphaMode);
+        if (maximumFrameLatency || isTearingAllowed || colorSpace != CanvasSwapChainColorSpace::Srgb)
+        {
+            renderTarget->Target = GetAdapter()->CreateCanvasSwapChainWithOptions(
+                device,
+                newSize.Width,
+                newSize.Height,
+                newDpi,
+                newAlphaMode,
+                maximumFrameLatency,
+                isTearingAllowed,
+                colorSpace);
+        }
+        else
+        {
+            renderTarget->Target = GetAdapter()->CreateCanvasSwapChain(
+                device,
+                newSize.Width,
+                newSize.Height,
+                newDpi,
+                newAlphaMode);
+        }
 
         renderTarget->AlphaMode = newAlphaMode;
         renderTarget->Dpi = newDpi;
         renderTarget->Size = newSize;
 
+        // Remembered separately from the swap chain's IsTearingAllowed, since
+        // that stays false on devices that don't support tearing.
+        m_isTearingRequestedForTarget = isTearingAllowed;
+        m_colorSpaceOfTarget = colorSpace;
+
         ThrowIfFailed(m_canvasSwapChainPanel->put_SwapChain(renderTarget->Target.Get()));            
     }
 }
@@ -590,10 +1036,12 @@ ComPtr<CanvasAnimatedDrawEventArgs> CanvasAnimatedControl::CreateDrawEventArgs(
     ICanvasDrawingSession* drawingSession,
     bool isRunningSlowly)
 {
-    auto timing = GetTimingInformationFromTimer();
+    // When the update is pipelined the timer has already moved on to the next
+    // update, so we use the timing recorded when the update being drawn ran.
+    auto timing = m_isDrawingLastUpdate ? m_lastUpdate.Timing : GetTimingInformationFromTimer();
     timing.IsRunningSlowly = isRunningSlowly;
 
-    auto drawEventArgs = Make<CanvasAnimatedDrawEventArgs>(drawingSession, timing);
+    auto drawEventArgs = Make<CanvasAnimatedDrawEventArgs>(drawingSession, timing, m_lastUpdate.State.Get());
     CheckMakeResult(drawEventArgs);
     return drawEventArgs;
 }
@@ -610,7 +1058,7 @@ void CanvasAnimatedControl::Loaded()
         return;
     }
     
-    m_gameLoop = GetAdapter()->CreateAndStartGameLoop(this, As<ISwapChainPanel>(m_canvasSwapChainPanel).Get());
+    m_gameLoop = GetAdapter()->CreateAndStartGameLoop(this, As<ISwapChainPanel>(m_canvasSwapChainPanel).Get(), m_useSharedGameLoop);
 }
 
 void CanvasAnimatedControl::Unloaded()
@@ -659,6 +1107,23 @@ void CanvasAnimatedControl::WindowVisibilityChanged()
     // Note that we don't stop the game loop thread here, because
     // we still expect Update to be called.
     //
+    // Draws are skipped while the window is hidden, so in on-demand mode,
+    // where the game loop may have stopped since, we redraw once it is
+    // shown again.
+    //
+    if (!IsVisible())
+        return;
+
+    auto lock = Lock(m_sharedStateMutex);
+
+    if (!m_sharedState.IsUpdateOnDemand)
+        return;
+
+    m_sharedState.NeedsDraw = true;
+
+    lock.unlock();
+
+    Changed(ChangeReason::Other);
 }
 
 void CanvasAnimatedControl::Changed(ChangeReason reason)
@@ -743,6 +1208,10 @@ void CanvasAnimatedControl::ChangedImpl()
 
     bool needsDraw = m_sharedState.NeedsDraw || m_sharedState.Invalidated;
     bool isPaused = m_sharedState.IsPaused;
+
+    // In on-demand mode the loop has nothing to do until something is
+    // requested, unless it has yet to raise the first Update.
+    bool isIdle = m_sharedState.IsUpdateOnDemand && !m_sharedState.IsUpdateRequested && m_hasUpdated;
     bool hasPendingActions = !m_sharedState.PendingAsyncActions.empty();
 
     lock.unlock();
@@ -828,9 +1297,9 @@ void CanvasAnimatedControl::ChangedImpl()
         ignorePaused = true;
     }
 
-    if (isPaused && !ignorePaused)
+    if ((isPaused || isIdle) && !ignorePaused)
     {
-        // Don't start the render loop if we're paused
+        // Don't start the render loop if we're paused, or idle
         return;
     }
 
@@ -980,7 +1449,8 @@ void CanvasAnimatedControl::OnGameLoopStopped()
 
 bool CanvasAnimatedControl::Tick(
     CanvasSwapChain* swapChain, 
-    bool areResourcesCreated)
+    bool areResourcesCreated,
+    IGameLoopThread* thread)
 {
     EventWrite_CanvasAnimatedControl_Tick_Start();
     auto tickEnd = MakeScopeWarden([] { EventWrite_CanvasAnimatedControl_Tick_Stop(); });
@@ -1020,6 +1490,19 @@ bool CanvasAnimatedControl::Tick(
 
     m_stepTimer.SetTargetElapsedTicks(m_sharedState.TargetElapsedTime);
     m_stepTimer.SetFixedTimeStep(m_sharedState.IsStepTimerFixedStep);
+    m_stepTimer.SetAdaptivePacing(m_sharedState.IsFramePacingAdaptive);
+
+    bool isFramePacingAdaptive = m_sharedState.IsFramePacingAdaptive;
+    bool isFrameStatisticsEnabled = m_sharedState.IsFrameStatisticsEnabled;
+    bool isResolutionDynamic = m_sharedState.IsResolutionDynamic;
+    float minimumResolutionScale = m_sharedState.MinimumResolutionScale;
+    uint64_t targetElapsedTime = m_sharedState.TargetElapsedTime;
+    bool isUpdateOnDemand = m_sharedState.IsUpdateOnDemand;
+    bool isSwapChainOverallocationAllowed = m_sharedState.IsSwapChainOverallocationAllowed;
+
+    // This publishes what the previous tick measured; nothing else touches
+    // the step timer between ticks.
+    m_sharedState.FrameTimeJitter = m_stepTimer.GetFrameTimeJitterTicks();
 
     if (m_sharedState.ShouldResetElapsedTime)
     {
@@ -1041,6 +1524,26 @@ bool CanvasAnimatedControl::Tick(
         return false;
     }
 
+    // Similarly, turning low latency mode on or off needs a different kind of
+    // swap chain.
+    uint32_t maximumFrameLatency = m_sharedState.MaximumFrameLatency;
+
+    bool isUpdatePipelined = m_sharedState.IsUpdatePipelined;
+
+    if (renderTarget->Target &&
+        renderTarget->Target->IsFrameLatencyWaitable() != (maximumFrameLatency != 0))
+    {
+        return false;
+    }
+
+    // As does allowing or disallowing tearing, or changing the color space.
+    if (renderTarget->Target &&
+        (m_isTearingRequestedForTarget != m_sharedState.IsTearingAllowed ||
+         m_colorSpaceOfTarget != m_sharedState.ColorSpace))
+    {
+        return false;
+    }
+
     // If the device needs to be re-created with different options, this 
     // needs to happen before we can draw.
     if (deviceNeedsReCreationWithNewOptions)
@@ -1078,6 +1581,13 @@ bool CanvasAnimatedControl::Tick(
         }
     } 
 
+    // A requested update is taken by this tick.  If the step timer doesn't
+    // get round to running it, the request is put back at the end.
+    bool isUpdateRequested = m_sharedState.IsUpdateRequested;
+
+    if (areResourcesCreated && !isPaused)
+        m_sharedState.IsUpdateRequested = false;
+
     // We update, but forego drawing if the control is not in a visible state.
     // Force-draws, like those due to device lost, are not performed either.
     // Drawing behavior resumes when the control becomes visible once again.
@@ -1120,31 +1630,96 @@ bool CanvasAnimatedControl::Tick(
         }
     }
 
+    //
+    // In low latency mode we block here, rather than in Present(), until the
+    // swap chain is ready for another frame.  This way the Update handler
+    // runs as late as possible and so sees the most recent input.
+    //
+    if (swapChain && swapChain->IsFrameLatencyWaitable())
+    {
+        if (swapChain->GetMaximumFrameLatency() != maximumFrameLatency)
+            swapChain->SetMaximumFrameLatency(maximumFrameLatency);
+
+        if (m_shouldWaitForFrameLatency)
+            swapChain->WaitForFrameLatencyWaitableObject();
+    }
+
+    m_shouldWaitForFrameLatency = false;
+
     //
     // Now do the update/render for this tick
     //
 
     UpdateResult updateResult{};
+    std::future<UpdateResult> pipelinedUpdate;
 
-    EventWrite_CanvasAnimatedControl_Update_Start(areResourcesCreated, isPaused);
-    if (areResourcesCreated && !isPaused)
+    // The worker must never outlive this tick, including when we return
+    // early below.  Its result is dropped in that case; the game loop is
+    // stopping anyway.
+    auto waitForPipelinedUpdate = MakeScopeWarden(
+        [&]
+        {
+            if (pipelinedUpdate.valid())
+                pipelinedUpdate.wait();
+        });
+
+    bool shouldUpdate = areResourcesCreated && !isPaused && (!isUpdateOnDemand || isUpdateRequested || !m_hasUpdated);
+    bool forceUpdate = false;
+    bool updatedThisTick = false;
+
+    if (shouldUpdate && (!m_hasUpdated || m_isWakingFromIdle))
     {
-        bool forceUpdate = false;
+        // For the first update we reset the timer.  This handles the
+        // possibility of there being a long delay between construction and
+        // the first update.  The same goes for the first update after the
+        // game loop has been idle in on-demand mode.
+        m_stepTimer.ResetElapsedTime();
+        forceUpdate = true;
+        m_isWakingFromIdle = false;
+    }
 
-        if (!m_hasUpdated)
+    if (shouldUpdate && isUpdatePipelined)
+    {
+        //
+        // Run this tick's update on a worker thread while this thread draws
+        // and presents the previous update.  Until the worker is finished only
+        // it may touch m_stepTimer and m_updateState.
+        //
+        pipelinedUpdate = std::async(std::launch::async,
+            [=]
+            {
+                EventWrite_CanvasAnimatedControl_Update_Start(true, false);
+                auto result = Update(forceUpdate, timeSpentPaused);
+                EventWrite_CanvasAnimatedControl_Update_Stop(result.Updated);
+                return result;
+            });
+    }
+    else
+    {
+        EventWrite_CanvasAnimatedControl_Update_Start(areResourcesCreated, isPaused);
+        if (shouldUpdate)
         {
-            // For the first update we reset the timer.  This handles the
-            // possibility of there being a long delay between construction and
-            // the first update.
-            m_stepTimer.ResetElapsedTime();
-            forceUpdate = true;
-        }
+            updateResult = Update(forceUpdate, timeSpentPaused);
 
-        updateResult = Update(forceUpdate, timeSpentPaused);
+            m_hasUpdated |= updateResult.Updated;
+            updatedThisTick = updateResult.Updated;
+        }
+        EventWrite_CanvasAnimatedControl_Update_Stop(updateResult.Updated);
+    }
 
-        m_hasUpdated |= updateResult.Updated;
+    if (isUpdatePipelined)
+    {
+        // Draw the update that finished during the previous tick, if it
+        // hasn't been drawn yet.
+        updateResult = m_lastUpdate;
+    }
+    else if (updateResult.Updated)
+    {
+        m_lastUpdate = updateResult;
     }
-    EventWrite_CanvasAnimatedControl_Update_Stop(updateResult.Updated);
+
+    m_lastUpdate.Updated = false;
+    m_isDrawingLastUpdate = isUpdatePipelined;
 
     //
     // We only ever Draw/Present if an Update has actually happened.  This
@@ -1153,7 +1728,31 @@ bool CanvasAnimatedControl::Tick(
     // result in missed frames.
     //
     bool drew = false;
-    if ((updateResult.Updated || forceDraw || invalidated) && isVisible)
+    bool presentedAllowingTearing = false;
+
+    // With a pipelined update the step timer may be in use on the worker
+    // thread while we present, so display syncs are only passed to it once
+    // the update has finished.
+    bool hasFrameStatistics = false;
+    DXGI_FRAME_STATISTICS frameStatistics{};
+
+    FrameTimings frameTimings{};
+    std::vector<uint64_t> gpuTimes;
+
+    //
+    // While the swap chain is occluded anything presented is thrown away, so
+    // drawing is skipped until a test present finds that it can be seen
+    // again.  The frame shown then is drawn in full.
+    //
+    if (m_isOccluded && isVisible && renderTarget->Target)
+    {
+        m_isOccluded = renderTarget->Target->IsOccluded();
+
+        if (!m_isOccluded)
+            forceDraw = true;
+    }
+
+    if ((updateResult.Updated || forceDraw || invalidated) && isVisible && !m_isOccluded)
     {
         bool zeroSizedTarget = currentSize.Width <= 0 || currentSize.Height <= 0;
         
@@ -1194,7 +1793,7 @@ bool CanvasAnimatedControl::Tick(
                 //  - the current render target won't be updated by the UI thread
                 //    while the update/render thread is running
                 //
-                ThrowIfFailed(renderTarget->Target->ResizeBuffersWithWidthAndHeightAndDpi(currentSize.Width, currentSize.Height, currentDpi));
+                ResizeSwapChain(renderTarget->Target.Get(), currentSize, currentDpi, isSwapChainOverallocationAllowed);
 
                 //
                 // The size and dpi fields of the render target object represent the real, committed state of the render
@@ -1202,6 +1801,7 @@ bool CanvasAnimatedControl::Tick(
                 //
                 renderTarget->Size = currentSize;
                 renderTarget->Dpi = currentDpi;
+                m_resolutionScaleOfTarget = 1.0f;
             }
         }
 
@@ -1209,17 +1809,146 @@ bool CanvasAnimatedControl::Tick(
         {
             bool invokeDrawHandlers = (areResourcesCreated && (m_hasUpdated || invalidated));
 
+            //
+            // With dynamic resolution the frame is drawn into the top left
+            // part of the swap chain, which SourceSize tells the compositor
+            // to stretch over the whole control.  Draw handlers still work
+            // in the control's DIPs, since the drawing session's dpi is
+            // scaled to match.
+            //
+            float resolutionScale = isResolutionDynamic ? m_resolutionScaler.GetScale() : 1.0f;
+
+            if (resolutionScale != m_resolutionScaleOfTarget)
+            {
+                ThrowIfFailed(renderTarget->Target->put_SourceSize(Size{ renderTarget->Size.Width * resolutionScale, renderTarget->Size.Height * resolutionScale }));
+                m_resolutionScaleOfTarget = resolutionScale;
+            }
+
+            bool isGpuTimed = isFrameStatisticsEnabled || isResolutionDynamic;
+
+            auto drawStartTime = GetAdapter()->GetPerformanceCounter();
+
+            if (isGpuTimed)
+                BeginGpuFrame(renderTarget->Target.Get());
+
             EventWrite_CanvasAnimatedControl_Draw_Start(invokeDrawHandlers, updateResult.IsRunningSlowly);
-            Draw(renderTarget->Target.Get(), clearColor, invokeDrawHandlers, updateResult.IsRunningSlowly);
+            if (resolutionScale == 1.0f)
+            {
+                Draw(renderTarget->Target.Get(), clearColor, invokeDrawHandlers, updateResult.IsRunningSlowly);
+            }
+            else
+            {
+                auto drawingSession = renderTarget->Target->CreateDrawingSessionWithDpiScale(clearColor, resolutionScale);
+                DrawWithSession(drawingSession.Get(), invokeDrawHandlers, updateResult.IsRunningSlowly);
+            }
             EventWrite_CanvasAnimatedControl_Draw_Stop();
+
+            frameTimings.DrawTime = GetTicksSince(drawStartTime);
+
+            //
+            // Dirty rects recorded by InvalidateRect up to now, including
+            // those from this frame's Update and Draw handlers, describe what
+            // this frame changes.
+            //
+            std::vector<Rect> dirtyRects;
+            {
+                auto lock2 = Lock(m_sharedStateMutex);
+
+                if (!forceDraw && !m_sharedState.IsWholeFrameDirty)
+                    std::swap(dirtyRects, m_sharedState.DirtyRects);
+
+                m_sharedState.DirtyRects.clear();
+                m_sharedState.IsWholeFrameDirty = false;
+                m_sharedState.ResolutionScale = resolutionScale;
+            }
+
+            // Dirty rects are in the control's DIPs, so they are scaled along
+            // with the drawing.
+            if (resolutionScale != 1.0f)
+            {
+                for (auto& rect : dirtyRects)
+                {
+                    rect = Rect{ rect.X * resolutionScale, rect.Y * resolutionScale, rect.Width * resolutionScale, rect.Height * resolutionScale };
+                }
+            }
+
+            presentedAllowingTearing = renderTarget->Target->IsTearingAllowed();
+
+            auto presentStartTime = GetAdapter()->GetPerformanceCounter();
+
             EventWrite_CanvasAnimatedControl_Present_Start();            
-            ThrowIfFailed(renderTarget->Target->Present());
+            if (dirtyRects.empty())
+                ThrowIfFailed(presentedAllowingTearing ? renderTarget->Target->PresentAllowingTearing() : renderTarget->Target->Present());
+            else
+                renderTarget->Target->PresentWithOptions(presentedAllowingTearing, dirtyRects);
             EventWrite_CanvasAnimatedControl_Present_Stop();
 
+            frameTimings.PresentTime = GetTicksSince(presentStartTime);
+
+            if (isGpuTimed)
+                gpuTimes = EndGpuFrame(renderTarget->Target.Get());
+
+            m_isOccluded = renderTarget->Target->WasLastPresentOccluded();
+
+            if (isResolutionDynamic)
+            {
+                for (auto gpuTime : gpuTimes)
+                    m_resolutionScaler.AddGpuTime(gpuTime);
+
+                // The new scale is used from the next frame on.
+                m_resolutionScaler.AddFrame(frameTimings.DrawTime, targetElapsedTime, minimumResolutionScale);
+            }
+            else
+            {
+                m_resolutionScaler.Reset();
+            }
+
+            if (isFramePacingAdaptive || isFrameStatisticsEnabled)
+                hasFrameStatistics = renderTarget->Target->TryGetFrameStatistics(&frameStatistics);
+
             drew = true;
+
+            // The waitable object is only signaled for frames that have
+            // been presented, so we only wait after a Present.
+            m_shouldWaitForFrameLatency = renderTarget->Target->IsFrameLatencyWaitable();
         }
     }
 
+    uint64_t pipelinedUpdateTime = 0;
+
+    if (pipelinedUpdate.valid())
+    {
+        auto result = pipelinedUpdate.get();
+
+        pipelinedUpdateTime = result.UpdateTime;
+        m_hasUpdated |= result.Updated;
+        updatedThisTick = result.Updated;
+
+        if (result.Updated)
+            m_lastUpdate = result;
+    }
+
+    if (hasFrameStatistics && isFramePacingAdaptive)
+        m_stepTimer.AddDisplaySync(frameStatistics.SyncQPCTime.QuadPart, frameStatistics.SyncRefreshCount);
+
+    if (isFrameStatisticsEnabled && drew)
+    {
+        // With a pipelined update this is the update that ran alongside
+        // this frame's draw.
+        frameTimings.UpdateTime = isUpdatePipelined ? pipelinedUpdateTime : updateResult.UpdateTime;
+
+        auto lock2 = Lock(m_sharedStateMutex);
+        auto& statistics = m_sharedState.FrameStatistics;
+
+        if (hasFrameStatistics)
+            frameTimings.MissedVerticalBlankCount = statistics.CountMissedVerticalBlanks(frameStatistics);
+
+        statistics.AddFrame(frameTimings);
+
+        for (auto gpuTime : gpuTimes)
+            statistics.AddGpuTime(gpuTime);
+    }
+
     //
     // The call to Present() usually blocks until a previous frame has been
     // composed into the scene.  The happens because the swap chain has a
@@ -1247,21 +1976,74 @@ bool CanvasAnimatedControl::Tick(
     //   - if there's no swap chain (eg the window is invisible) then we just
     //     sleep
     //
-    if (!drew || !m_stepTimer.IsFixedTimeStep())
+    //   - in low latency mode Present() doesn't block, but the next tick will
+    //     wait for the swap chain's frame latency waitable object instead.
+    //
+    //   - when tearing is allowed the point is to not wait for vertical
+    //     blank, so after presenting we go straight on to the next tick.
+    //
+    //   - with adaptive frame pacing, instead of yielding or sleeping we
+    //     wait on a high resolution timer until the next update is due.
+    //
+    //   - on a shared game loop thread the wait is handed to the thread,
+    //     which waits once after ticking every control.
+    //
+    if (!drew || (!m_stepTimer.IsFixedTimeStep() && !m_shouldWaitForFrameLatency && !presentedAllowingTearing))
     {
-        EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Start();
-        if (swapChain)
-        {
-            ThrowIfFailed(swapChain->WaitForVerticalBlank());
-        }
-        else
-        {
-            GetAdapter()->Sleep(static_cast<DWORD>(StepTimer::TicksToMilliseconds(StepTimer::DefaultTargetElapsedTime)));
-        }
-        EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Stop();
+        bool canWaitForVerticalBlank = swapChain && (!isFramePacingAdaptive || swapChain->CanWaitForVerticalBlank());
+        ComPtr<CanvasSwapChain> waitSwapChain = swapChain;
+        auto nextTickTime = m_stepTimer.GetNextTickTime();
+        auto adapter = GetAdapter();
+
+        auto waitForNextFrame =
+            [=]
+            {
+                EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Start();
+                if (canWaitForVerticalBlank)
+                {
+                    ThrowIfFailed(waitSwapChain->WaitForVerticalBlank());
+                }
+                else if (isFramePacingAdaptive)
+                {
+                    adapter->WaitUntil(nextTickTime);
+                }
+                else
+                {
+                    adapter->Sleep(static_cast<DWORD>(StepTimer::TicksToMilliseconds(StepTimer::DefaultTargetElapsedTime)));
+                }
+                EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Stop();
+            };
+
+        if (!thread->TryDeferFrameWait(waitForNextFrame))
+            waitForNextFrame();
+    }
+
+    //
+    // In on-demand mode the game loop stops once there's nothing left to do.
+    // A pipelined update that has yet to be drawn, or an occluded swap chain
+    // that needs checking on, keeps it going.
+    //
+    bool isIdle = false;
+
+    if (isUpdateOnDemand && areResourcesCreated && !isPaused)
+    {
+        auto lock2 = Lock(m_sharedStateMutex);
+
+        if (isUpdateRequested && !updatedThisTick)
+            m_sharedState.IsUpdateRequested = true;
+
+        isIdle = m_hasUpdated &&
+            !m_lastUpdate.Updated &&
+            !m_isOccluded &&
+            !m_sharedState.IsUpdateRequested &&
+            !m_sharedState.Invalidated &&
+            !m_sharedState.NeedsDraw &&
+            m_sharedState.PendingAsyncActions.empty();
+
+        m_isWakingFromIdle = isIdle;
     }
     
-    return areResourcesCreated && !isPaused;
+    return areResourcesCreated && !isPaused && !isIdle;
 }
 
 void CanvasAnimatedControl::OnTickLoopEnded()
@@ -1273,19 +2055,28 @@ CanvasAnimatedControl::UpdateResult CanvasAnimatedControl::Update(bool forceUpda
 {
     UpdateResult result{};
 
+    auto startTime = GetAdapter()->GetPerformanceCounter();
+
     m_stepTimer.Tick(forceUpdate, timeSpentPaused,
         [this, &result](bool isRunningSlowly)
         {
             auto timing = GetTimingInformationFromTimer();
             timing.IsRunningSlowly = isRunningSlowly;
 
-            auto updateEventArgs = Make<CanvasAnimatedUpdateEventArgs>(timing);
+            auto updateEventArgs = Make<CanvasAnimatedUpdateEventArgs>(timing, m_updateState.Get());
+            CheckMakeResult(updateEventArgs);
             ThrowIfFailed(m_updateEventList.InvokeAll(this, updateEventArgs.Get()));
 
+            m_updateState = updateEventArgs->GetState();
+
             result.IsRunningSlowly = isRunningSlowly;
             result.Updated = true;
+            result.Timing = GetTimingInformationFromTimer();
+            result.State = m_updateState;
         });
 
+    result.UpdateTime = GetTicksSince(startTime);
+
     return result;
 }
 
@@ -1300,6 +2091,46 @@ CanvasTimingInformation CanvasAnimatedControl::GetTimingInformationFromTimer()
     return timing;
 }
 
+uint64_t CanvasAnimatedControl::GetTicksSince(int64_t performanceCounter)
+{
+    auto elapsed = std::max(GetAdapter()->GetPerformanceCounter() - performanceCounter, 0LL);
+
+    return static_cast<uint64_t>(elapsed) * StepTimer::TicksPerSecond / GetAdapter()->GetPerformanceFrequency();
+}
+
+void CanvasAnimatedControl::ResizeSwapChain(CanvasSwapChain* swapChain, Size size, float dpi, bool allowOverallocation)
+{
+    if (allowOverallocation)
+        ThrowIfFailed(swapChain->ResizeBuffersAllowingOverallocation(size.Width, size.Height, dpi));
+    else
+        ThrowIfFailed(swapChain->ResizeBuffersWithWidthAndHeightAndDpi(size.Width, size.Height, dpi));
+}
+
+void CanvasAnimatedControl::BeginGpuFrame(CanvasSwapChain* swapChain)
+{
+    ComPtr<ICanvasDevice> device;
+    ThrowIfFailed(swapChain->get_Device(&device));
+
+    auto d3dDevice = GetDXGIInterface<ID3D11Device>(device.Get());
+
+    if (!m_gpuFrameTimer || m_gpuFrameTimer->GetDevice() != d3dDevice.Get())
+        m_gpuFrameTimer = std::make_unique<GpuFrameTimer>(d3dDevice.Get());
+
+    D2DResourceLock lock(As<ICanvasDeviceInternal>(device)->GetD2DDevice().Get());
+    m_gpuFrameTimer->BeginFrame();
+}
+
+std::vector<uint64_t> CanvasAnimatedControl::EndGpuFrame(CanvasSwapChain* swapChain)
+{
+    ComPtr<ICanvasDevice> device;
+    ThrowIfFailed(swapChain->get_Device(&device));
+
+    D2DResourceLock lock(As<ICanvasDeviceInternal>(device)->GetD2DDevice().Get());
+    m_gpuFrameTimer->EndFrame();
+
+    return m_gpuFrameTimer->CollectResults();
+}
+
 ActivatableClassWithFactory(CanvasAnimatedUpdateEventArgs, CanvasAnimatedUpdateEventArgsFactory);
 ActivatableClassWithFactory(CanvasAnimatedDrawEventArgs, CanvasAnimatedDrawEventArgsFactory);
 ActivatableClassWithFactory(CanvasAnimatedControl, CanvasAnimatedControlFactory);
@@ -8,6 +8,7 @@
 #include "BaseControlAdapter.h"
 #include "CanvasGameLoop.h"
 #include "CanvasSwapChainPanel.h"
+#include "FrameStatistics.h"
 #include "StepTimer.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace UI { namespace Xaml
@@ -26,11 +27,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_UI_Xaml_CanvasAnimatedUpdateEventArgs, BaseTrust);
         
         CanvasTimingInformation m_timingInformation;
+        ComPtr<IInspectable> m_state;
 
     public:
-        CanvasAnimatedUpdateEventArgs(CanvasTimingInformation timing);
+        CanvasAnimatedUpdateEventArgs(CanvasTimingInformation timing, IInspectable* state = nullptr);
 
         IFACEMETHODIMP get_Timing(CanvasTimingInformation* value);
+
+        IFACEMETHODIMP get_State(IInspectable** value);
+        IFACEMETHODIMP put_State(IInspectable* value);
+
+        ComPtr<IInspectable> const& GetState() const { return m_state; }
     };
 
     class CanvasAnimatedUpdateEventArgsFactory : public AgileActivationFactory<ICanvasAnimatedUpdateEventArgsFactory>,
@@ -65,12 +72,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         CanvasTimingInformation m_timingInformation;
 
+        ComPtr<IInspectable> m_state;
+
      public:
-         CanvasAnimatedDrawEventArgs(ICanvasDrawingSession* drawingSession, CanvasTimingInformation timingInformation);
+         CanvasAnimatedDrawEventArgs(ICanvasDrawingSession* drawingSession, CanvasTimingInformation timingInformation, IInspectable* state = nullptr);
 
          IFACEMETHODIMP get_DrawingSession(ICanvasDrawingSession** value);
 
          IFACEMETHODIMP get_Timing(CanvasTimingInformation* value);
+
+         IFACEMETHODIMP get_State(IInspectable** value);
     };
 
     typedef ITypedEventHandler<CanvasAnimatedControl*, CanvasCreateResourcesEventArgs*> Animated_CreateResourcesEventHandler;
@@ -104,15 +115,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float dpi,
             CanvasAlphaMode alphaMode) = 0;
 
+        virtual ComPtr<CanvasSwapChain> CreateCanvasSwapChainWithOptions(
+            ICanvasDevice* device,
+            float width, 
+            float height, 
+            float dpi,
+            CanvasAlphaMode alphaMode,
+            uint32_t maximumFrameLatency,
+            bool allowTearing,
+            CanvasSwapChainColorSpace colorSpace) = 0;
+
         virtual ComPtr<CanvasSwapChainPanel> CreateCanvasSwapChainPanel() = 0;
 
         virtual ComPtr<IShape> CreateDesignModeShape() = 0;
 
         virtual std::unique_ptr<CanvasGameLoop> CreateAndStartGameLoop(
             CanvasAnimatedControl* control,
-            ISwapChainPanel* swapChainPanel) = 0;
+            ISwapChainPanel* swapChainPanel,
+            bool useSharedThread) = 0;
 
         virtual void Sleep(DWORD timeInMs) = 0;
+
+        // Blocks until the performance counter reaches the given value.
+        virtual void WaitUntil(int64_t performanceCounter) = 0;
     };
 
     std::shared_ptr<ICanvasAnimatedControlAdapter> CreateCanvasAnimatedControlAdapter();
@@ -139,6 +164,59 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         StepTimer m_stepTimer;
         bool m_hasUpdated;
+        bool m_shouldWaitForFrameLatency;   // only accessed from the update/render thread
+
+        // Whether IsTearingAllowed was set when the current swap chain was
+        // created.  Written on the UI thread only while the update/render
+        // thread is stopped.
+        bool m_isTearingRequestedForTarget;
+
+        // The ColorSpace the current swap chain was created with.  Written
+        // on the UI thread only while the update/render thread is stopped.
+        CanvasSwapChainColorSpace m_colorSpaceOfTarget;
+
+        // Whether the next game loop, created when the control is loaded,
+        // runs on the shared game loop thread.  Only accessed from the UI
+        // thread.
+        bool m_useSharedGameLoop;
+
+        struct UpdateResult
+        {
+            bool Updated;
+            bool IsRunningSlowly;
+            CanvasTimingInformation Timing;
+            ComPtr<IInspectable> State;
+            uint64_t UpdateTime;        // In ticks, including every Update raised.
+        };
+
+        // Only accessed from the update/render thread.
+        std::unique_ptr<GpuFrameTimer> m_gpuFrameTimer;
+        ResolutionScaler m_resolutionScaler;
+
+        // The fraction of the current swap chain's size that its SourceSize
+        // is set to.  Written on the UI thread only while the update/render
+        // thread is stopped.
+        float m_resolutionScaleOfTarget;
+
+        // Set when the game loop stopped because IsUpdateOnDemand found
+        // nothing to do, so that the time spent idle isn't caught up on.
+        // Only accessed from the update/render thread.
+        bool m_isWakingFromIdle;
+
+        // Set when a Present reported that the swap chain is occluded.  Until
+        // a test present says otherwise frames are updated but not drawn.
+        // Only accessed from the update/render thread.
+        bool m_isOccluded;
+
+        // The state set by the most recent Update handler.  Only accessed by
+        // Update, which in pipelined mode runs on a worker thread.
+        ComPtr<IInspectable> m_updateState;
+
+        // The most recent update that finished; Updated is cleared once it
+        // has been drawn.  Pipelined ticks draw this while the next update
+        // runs.  Only accessed from the update/render thread.
+        UpdateResult m_lastUpdate;
+        bool m_isDrawingLastUpdate;
 
         //
         // State shared between the UI thread and the update/render thread.
@@ -158,6 +236,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 , DeviceNeedsReCreationWithNewOptions(false)
                 , SizeSeenByGameLoop{}
                 , IsInTick(false)
+                , MaximumFrameLatency(0)
+                , IsUpdatePipelined(false)
+                , IsTearingAllowed(false)
+                , ColorSpace(CanvasSwapChainColorSpace::Srgb)
+                , IsSwapChainOverallocationAllowed(false)
+                , IsWholeFrameDirty(false)
+                , IsFramePacingAdaptive(false)
+                , FrameTimeJitter(0)
+                , IsFrameStatisticsEnabled(false)
+                , IsResolutionDynamic(false)
+                , MinimumResolutionScale(0.5f)
+                , ResolutionScale(1.0f)
+                , IsUpdateOnDemand(false)
+                , IsUpdateRequested(false)
             {}
 
             bool IsPaused;
@@ -171,6 +263,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             bool DeviceNeedsReCreationWithNewOptions;
             Size SizeSeenByGameLoop;
             bool IsInTick;
+            uint32_t MaximumFrameLatency;
+            bool IsUpdatePipelined;
+            bool IsTearingAllowed;
+            CanvasSwapChainColorSpace ColorSpace;
+            bool IsSwapChainOverallocationAllowed;
+            bool IsWholeFrameDirty;
+            bool IsFramePacingAdaptive;
+            uint64_t FrameTimeJitter;           // As of the previous tick.
+            bool IsFrameStatisticsEnabled;
+            FrameStatisticsTracker FrameStatistics;
+            bool IsResolutionDynamic;
+            float MinimumResolutionScale;
+            float ResolutionScale;              // As last applied to the swap chain.
+            bool IsUpdateOnDemand;
+            bool IsUpdateRequested;             // Since the last Update.
+            std::vector<Rect> DirtyRects;       // Since the last present.
             std::vector<ComPtr<AnimatedControlAsyncAction>> PendingAsyncActions;
         };
 
@@ -178,6 +286,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         SharedState m_sharedState;
 
     public:
+        // Frames with more InvalidateRect calls than this are presented whole.
+        static const size_t MaximumDirtyRectCount = 64;
+
         CanvasAnimatedControl(
             std::shared_ptr<ICanvasAnimatedControlAdapter> adapter);
 
@@ -219,6 +330,52 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         IFACEMETHODIMP get_TargetElapsedTime(TimeSpan* value) override;
 
+        IFACEMETHODIMP put_MaximumFrameLatency(int32_t value) override;
+
+        IFACEMETHODIMP get_MaximumFrameLatency(int32_t* value) override;
+
+        IFACEMETHODIMP put_IsUpdatePipelined(boolean value) override;
+
+        IFACEMETHODIMP get_IsUpdatePipelined(boolean* value) override;
+
+        IFACEMETHODIMP put_IsTearingAllowed(boolean value) override;
+
+        IFACEMETHODIMP get_IsTearingAllowed(boolean* value) override;
+
+        IFACEMETHODIMP put_ColorSpace(CanvasSwapChainColorSpace value) override;
+
+        IFACEMETHODIMP get_ColorSpace(CanvasSwapChainColorSpace* value) override;
+
+        IFACEMETHODIMP put_IsSwapChainOverallocationAllowed(boolean value) override;
+
+        IFACEMETHODIMP get_IsSwapChainOverallocationAllowed(boolean* value) override;
+
+        IFACEMETHODIMP put_IsFramePacingAdaptive(boolean value) override;
+
+        IFACEMETHODIMP get_IsFramePacingAdaptive(boolean* value) override;
+
+        IFACEMETHODIMP get_FrameTimeJitter(TimeSpan* value) override;
+
+        IFACEMETHODIMP put_IsFrameStatisticsEnabled(boolean value) override;
+
+        IFACEMETHODIMP get_IsFrameStatisticsEnabled(boolean* value) override;
+
+        IFACEMETHODIMP GetFrameStatistics(CanvasAnimatedFrameStatistics* value) override;
+
+        IFACEMETHODIMP put_IsResolutionDynamic(boolean value) override;
+
+        IFACEMETHODIMP get_IsResolutionDynamic(boolean* value) override;
+
+        IFACEMETHODIMP put_MinimumResolutionScale(float value) override;
+
+        IFACEMETHODIMP get_MinimumResolutionScale(float* value) override;
+
+        IFACEMETHODIMP get_ResolutionScale(float* value) override;
+
+        IFACEMETHODIMP put_IsUpdateOnDemand(boolean value) override;
+
+        IFACEMETHODIMP get_IsUpdateOnDemand(boolean* value) override;
+
         IFACEMETHODIMP put_Paused(boolean value) override;
 
         IFACEMETHODIMP get_Paused(boolean* value) override;
@@ -226,9 +383,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHODIMP get_Size(Size* value) override;
 
         IFACEMETHODIMP Invalidate() override;
+
+        IFACEMETHODIMP InvalidateRect(Rect rect) override;
         
         IFACEMETHODIMP ResetElapsedTime() override;
 
+        IFACEMETHODIMP RequestUpdate() override;
+
         IFACEMETHODIMP CreateCoreIndependentInputSource(
             CoreInputDeviceTypes deviceType,
             ICoreInputSourceBase** returnValue) override;
@@ -241,6 +402,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             IDispatchedHandler* callback,
             IAsyncAction** asyncAction) override;
 
+        IFACEMETHODIMP put_UseSharedGameLoop(boolean value) override;
+
+        IFACEMETHODIMP get_UseSharedGameLoop(boolean* value) override;
+
         //
         // BaseControl
         //
@@ -274,22 +439,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         virtual bool Tick(
             CanvasSwapChain* target, 
-            bool areResourcesCreated) override;
+            bool areResourcesCreated,
+            IGameLoopThread* thread) override;
 
         virtual void OnTickLoopEnded() override;
 
-        struct UpdateResult
-        {
-            bool Updated;
-            bool IsRunningSlowly;
-        };
-
         UpdateResult Update(bool forceUpdate, int64_t timeSpentPaused);
 
         void ChangedImpl();
 
         CanvasTimingInformation GetTimingInformationFromTimer();
 
+        uint64_t GetTicksSince(int64_t performanceCounter);
+
+        // Either way the swap chain's SourceSize ends up covering exactly
+        // the control.
+        static void ResizeSwapChain(CanvasSwapChain* swapChain, Size size, float dpi, bool allowOverallocation);
+
+        void BeginGpuFrame(CanvasSwapChain* swapChain);
+        std::vector<uint64_t> EndGpuFrame(CanvasSwapChain* swapChain);
+
         void IssueAsyncActions(
             std::vector<ComPtr<AnimatedControlAsyncAction>> const& pendingActions);
 
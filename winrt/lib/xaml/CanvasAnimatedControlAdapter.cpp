@@ -13,6 +13,12 @@ using namespace ::ABI::Microsoft::Graphics::Canvas::UI;
 using namespace ::ABI::Microsoft::Graphics::Canvas::UI::Xaml;
 using namespace ::Microsoft::WRL::Wrappers;
 
+#ifdef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+static DWORD const CreateWaitableTimerHighResolution = CREATE_WAITABLE_TIMER_HIGH_RESOLUTION;
+#else
+static DWORD const CreateWaitableTimerHighResolution = 0x00000002;
+#endif
+
 //
 // CanvasAnimatedControlAdapter
 //
@@ -23,6 +29,9 @@ class CanvasAnimatedControlAdapter : public BaseControlAdapter<CanvasAnimatedCon
     std::shared_ptr<CanvasSwapChainPanelAdapter> m_canvasSwapChainPanelAdapter;
     ComPtr<IActivationFactory> m_canvasSwapChainPanelActivationFactory;
 
+    // Created on first use; only ever used by the game loop thread.
+    HandleT<HandleTraits::HANDLENullTraits> m_waitableTimer;
+
 public:
     CanvasAnimatedControlAdapter()
         : m_canvasSwapChainPanelAdapter(std::make_shared<CanvasSwapChainPanelAdapter>())        
@@ -74,6 +83,33 @@ public:
         return static_cast<CanvasSwapChain*>(swapChain.Get());
     }
 
+    virtual ComPtr<CanvasSwapChain> CreateCanvasSwapChainWithOptions(
+        ICanvasDevice* device,
+        float width,
+        float height,
+        float dpi,
+        CanvasAlphaMode alphaMode,
+        uint32_t maximumFrameLatency,
+        bool allowTearing,
+        CanvasSwapChainColorSpace colorSpace) override
+    {
+        auto swapChain = CanvasSwapChain::CreateNew(
+            device,
+            width,
+            height,
+            dpi,
+            CanvasSwapChain::GetFormatForColorSpace(colorSpace),
+            2,
+            alphaMode,
+            maximumFrameLatency,
+            allowTearing);
+
+        if (colorSpace != CanvasSwapChainColorSpace::Srgb)
+            swapChain->SetColorSpace(colorSpace);
+
+        return swapChain;
+    }
+
     virtual ComPtr<IShape> CreateDesignModeShape() override
     {
         ComPtr<IActivationFactory> rectangleFactory;
@@ -98,16 +134,21 @@ public:
         return As<IShape>(rectangleInspectable);
     }
 
-    virtual std::unique_ptr<CanvasGameLoop> CreateAndStartGameLoop(CanvasAnimatedControl* control, ISwapChainPanel* swapChainPanel) override
+    virtual std::unique_ptr<CanvasGameLoop> CreateAndStartGameLoop(CanvasAnimatedControl* control, ISwapChainPanel* swapChainPanel, bool useSharedThread) override
     {
         //
         // This needs to start a new thread and, while executing code on that
         // thread, then get a CoreDispatcher set up on that thread, and then, on
         // the original thread, create a CanvasGameLoop that has access to that
-        // dispatcher.
+        // dispatcher.  A shared thread is only started by the first control
+        // to use it.
         //
 
-        return std::make_unique<CanvasGameLoop>(control, CreateGameLoopThread(swapChainPanel, control));
+        auto thread = useSharedThread
+            ? CreateSharedGameLoopThread(swapChainPanel, control)
+            : CreateGameLoopThread(swapChainPanel, control);
+
+        return std::make_unique<CanvasGameLoop>(control, std::move(thread));
     }
 
     virtual ComPtr<IInspectable> CreateSwapChainPanel(IInspectable* canvasSwapChainPanel) override
@@ -120,6 +161,37 @@ public:
         ::Sleep(timeInMs);
     }
 
+    virtual void WaitUntil(int64_t performanceCounter) override
+    {
+        auto now = GetPerformanceCounter();
+
+        if (performanceCounter <= now)
+            return;
+
+        if (!m_waitableTimer.IsValid())
+        {
+            // High resolution timers are only available from Windows 10
+            // version 1803; before that we fall back to a regular one.
+            m_waitableTimer.Attach(CreateWaitableTimerExW(nullptr, nullptr, CreateWaitableTimerHighResolution, TIMER_ALL_ACCESS));
+
+            if (!m_waitableTimer.IsValid())
+                m_waitableTimer.Attach(CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS));
+
+            if (!m_waitableTimer.IsValid())
+                ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Negative due times are relative, in 100 nanosecond units.
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -((performanceCounter - now) * 10000000 / GetPerformanceFrequency());
+
+        if (!SetWaitableTimer(m_waitableTimer.Get(), &dueTime, 0, nullptr, nullptr, FALSE))
+            ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+
+        if (WaitForSingleObjectEx(m_waitableTimer.Get(), INFINITE, FALSE) == WAIT_FAILED)
+            ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
     virtual int64_t GetPerformanceCounter() override
     {
         LARGE_INTEGER counter;
@@ -145,6 +145,12 @@ CanvasControl::CanvasControl(
     : BaseControlWithDrawHandler(adapter, true)
     , ImageControlMixIn(As<IUserControl>(GetComposableBase()).Get(), adapter.get())
     , m_needToHookCompositionRendering(false)
+    , m_isWholeControlInvalid(true)
+    , m_hasInvalidRegion(false)
+    , m_invalidRegion{}
+    , m_isSurfaceSizeBucketed(false)
+    , m_isTargetSizeBucketed(false)
+    , m_targetAllocatedSize{}
 {
 }
 
@@ -175,6 +181,110 @@ IFACEMETHODIMP CanvasControl::Invalidate()
 }
 
 
+IFACEMETHODIMP CanvasControl::InvalidateRegion(Rect region)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (region.Width < 0 || region.Height < 0)
+                ThrowHR(E_INVALIDARG);
+
+            if (region.Width == 0 || region.Height == 0)
+                return;
+
+            auto d2dRegion = ToD2DRect(region);
+
+            auto lock = Lock(m_renderingEventMutex);
+
+            if (m_hasInvalidRegion)
+            {
+                m_invalidRegion.left = std::min(m_invalidRegion.left, d2dRegion.left);
+                m_invalidRegion.top = std::min(m_invalidRegion.top, d2dRegion.top);
+                m_invalidRegion.right = std::max(m_invalidRegion.right, d2dRegion.right);
+                m_invalidRegion.bottom = std::max(m_invalidRegion.bottom, d2dRegion.bottom);
+            }
+            else
+            {
+                m_invalidRegion = d2dRegion;
+                m_hasInvalidRegion = true;
+            }
+
+            lock.unlock();
+
+            RequestDraw();
+        });
+}
+
+
+IFACEMETHODIMP CanvasControl::get_CreateResourcesProgress(float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+            CheckIsOnUIThread();
+
+            *value = GetCreateResourcesProgress();
+        });
+}
+
+
+IFACEMETHODIMP CanvasControl::add_DrawPlaceholder(
+    Static_DrawEventHandler* value,
+    EventRegistrationToken* token)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            ThrowIfFailed(m_drawPlaceholderEventList.Add(value, token));
+            Changed(ChangeReason::Other);
+        });
+}
+
+
+IFACEMETHODIMP CanvasControl::remove_DrawPlaceholder(
+    EventRegistrationToken token)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            ThrowIfFailed(m_drawPlaceholderEventList.Remove(token));
+        });
+}
+
+
+IFACEMETHODIMP CanvasControl::put_IsSurfaceSizeBucketed(boolean value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_renderingEventMutex);
+
+            if (m_isSurfaceSizeBucketed == !!value)
+                return;
+
+            m_isSurfaceSizeBucketed = !!value;
+            lock.unlock();
+
+            // The image source is reallocated for the new mode on the next draw.
+            Changed(ChangeReason::Other);
+        });
+}
+
+
+IFACEMETHODIMP CanvasControl::get_IsSurfaceSizeBucketed(boolean* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_renderingEventMutex);
+            *value = m_isSurfaceSizeBucketed;
+        });
+}
+
+
 HRESULT CanvasControl::OnCompositionRendering(IInspectable*, IInspectable*)
 {
     return ExceptionBoundary(
@@ -223,12 +333,77 @@ void CanvasControl::DrawControl()
         {
             if (!target)
                 return;
-                            
-            Draw(target, clearColor, callDrawHandlers, false);
+
+            auto lock = Lock(m_renderingEventMutex);
+            bool drawWholeControl = m_isWholeControlInvalid || !m_hasInvalidRegion;
+            auto invalidRegion = m_invalidRegion;
+            m_isWholeControlInvalid = false;
+            m_hasInvalidRegion = false;
+            lock.unlock();
+
+            if (!callDrawHandlers)
+            {
+                DrawPlaceholder(target, clearColor);
+                return;
+            }
+
+            if (drawWholeControl)
+            {
+                Draw(target, clearColor, callDrawHandlers, false);
+                return;
+            }
+
+            // The image source can only be updated within its bounds.
+            auto size = GetCurrentRenderTarget()->Size;
+            invalidRegion.left = std::max(invalidRegion.left, 0.0f);
+            invalidRegion.top = std::max(invalidRegion.top, 0.0f);
+            invalidRegion.right = std::min(invalidRegion.right, size.Width);
+            invalidRegion.bottom = std::min(invalidRegion.bottom, size.Height);
+
+            if (invalidRegion.right <= invalidRegion.left || invalidRegion.bottom <= invalidRegion.top)
+                return;
+
+            ComPtr<ICanvasDrawingSession> drawingSession;
+            ThrowIfFailed(target->CreateDrawingSessionWithUpdateRectangle(clearColor, FromD2DRect(invalidRegion), &drawingSession));
+            DrawWithSession(drawingSession.Get(), callDrawHandlers, false);
         });
 }
 
 
+void CanvasControl::DrawPlaceholder(CanvasImageSource* target, Color const& clearColor)
+{
+    // Placeholders always redraw the whole control, since until resources
+    // are created there is nothing else worth keeping.
+    ComPtr<ICanvasDrawingSession> drawingSession;
+    ThrowIfFailed(target->CreateDrawingSession(clearColor, &drawingSession));
+
+    auto drawEventArgs = CreateDrawEventArgs(drawingSession.Get(), false);
+    ThrowIfFailed(m_drawPlaceholderEventList.InvokeAll(this, drawEventArgs.Get()));
+
+    ThrowIfFailed(As<IClosable>(drawingSession)->Close());
+}
+
+
+//
+// With IsSurfaceSizeBucketed set, image sources are allocated in multiples of
+// this many pixels and the control draws into the top left of them, so
+// resizing the control only reallocates when a bucket boundary is crossed.
+// The allocation is kept until the control shrinks by more than a further
+// bucket, so that resizing back and forth across a boundary doesn't
+// reallocate each time either.
+//
+static const int sc_surfaceSizeBucket = 256;
+
+static int GetBucketedExtent(int pixels)
+{
+    return (pixels + sc_surfaceSizeBucket - 1) / sc_surfaceSizeBucket * sc_surfaceSizeBucket;
+}
+
+static bool IsAllocatedExtentReusable(int allocatedPixels, int pixels)
+{
+    return pixels <= allocatedPixels && allocatedPixels <= GetBucketedExtent(pixels) + sc_surfaceSizeBucket;
+}
+
 void CanvasControl::CreateOrUpdateRenderTarget(
     ICanvasDevice* device,
     CanvasAlphaMode newAlphaMode,
@@ -236,12 +411,18 @@ void CanvasControl::CreateOrUpdateRenderTarget(
     Size newSize,
     RenderTarget* renderTarget)
 {
+    auto lock = Lock(m_renderingEventMutex);
+    bool isSizeBucketed = m_isSurfaceSizeBucketed;
+    lock.unlock();
+
     bool needsCreate = (renderTarget->Target == nullptr);
     needsCreate |= (renderTarget->AlphaMode != newAlphaMode);
     needsCreate |= (renderTarget->Dpi != newDpi);
-    needsCreate |= (renderTarget->Size != newSize);
+    needsCreate |= (m_isTargetSizeBucketed != isSizeBucketed);
 
-    if (!needsCreate)
+    bool sizeChanged = (renderTarget->Size != newSize);
+
+    if (!needsCreate && !sizeChanged)
         return;
 
     if (newSize.Width <= 0 || newSize.Height <= 0)
@@ -252,19 +433,57 @@ void CanvasControl::CreateOrUpdateRenderTarget(
     }
     else
     {
-        renderTarget->Target = GetAdapter()->CreateCanvasImageSource(
-            device,
-            newSize.Width,
-            newSize.Height,
-            newDpi,
-            newAlphaMode);
-
-        renderTarget->AlphaMode = newAlphaMode;
-        renderTarget->Dpi = newDpi;
+        auto allocatedSize = newSize;
+
+        if (isSizeBucketed)
+        {
+            int width = SizeDipsToPixels(newSize.Width, newDpi);
+            int height = SizeDipsToPixels(newSize.Height, newDpi);
+
+            int allocatedWidth = SizeDipsToPixels(m_targetAllocatedSize.Width, newDpi);
+            int allocatedHeight = SizeDipsToPixels(m_targetAllocatedSize.Height, newDpi);
+
+            if (needsCreate ||
+                !IsAllocatedExtentReusable(allocatedWidth, width) ||
+                !IsAllocatedExtentReusable(allocatedHeight, height))
+            {
+                allocatedSize = Size{ PixelsToDips(GetBucketedExtent(width), newDpi), PixelsToDips(GetBucketedExtent(height), newDpi) };
+            }
+            else
+            {
+                allocatedSize = m_targetAllocatedSize;
+            }
+        }
+
+        if (needsCreate || allocatedSize != m_targetAllocatedSize)
+        {
+            renderTarget->Target = GetAdapter()->CreateCanvasImageSource(
+                device,
+                allocatedSize.Width,
+                allocatedSize.Height,
+                newDpi,
+                newAlphaMode);
+
+            renderTarget->AlphaMode = newAlphaMode;
+            renderTarget->Dpi = newDpi;
+
+            m_isTargetSizeBucketed = isSizeBucketed;
+            m_targetAllocatedSize = allocatedSize;
+
+            SetImageSource(As<IImageSource>(renderTarget->Target).Get());
+        }
+
+        // The size of the render target is the size of the control, which
+        // is all that the draw handlers see.
         renderTarget->Size = newSize;
 
-        SetImageSource(As<IImageSource>(renderTarget->Target).Get());
+        SetImageSize(isSizeBucketed ? allocatedSize : Size{});
     }
+
+    // A new image source has no valid contents, and a reused one has to be
+    // redrawn at the new size.
+    lock.lock();
+    m_isWholeControlInvalid = true;
 }
 
 ComPtr<CanvasDrawEventArgs> CanvasControl::CreateDrawEventArgs(ICanvasDrawingSession* drawingSession, bool)
@@ -275,6 +494,16 @@ ComPtr<CanvasDrawEventArgs> CanvasControl::CreateDrawEventArgs(ICanvasDrawingSes
 }
 
 void CanvasControl::Changed(ChangeReason)
+{
+    {
+        auto lock = Lock(m_renderingEventMutex);
+        m_isWholeControlInvalid = true;
+    }
+
+    RequestDraw();
+}
+
+void CanvasControl::RequestDraw()
 {
     if (!IsLoaded())
         return;
@@ -99,6 +99,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         std::mutex m_renderingEventMutex;
         RegisteredEvent m_renderingEventRegistration; // protected by m_renderingEventMutex
         bool m_needToHookCompositionRendering;        // protected by m_renderingEventMutex
+        bool m_isWholeControlInvalid;                 // protected by m_renderingEventMutex
+        bool m_hasInvalidRegion;                      // protected by m_renderingEventMutex
+        D2D1_RECT_F m_invalidRegion;                  // protected by m_renderingEventMutex
+        bool m_isSurfaceSizeBucketed;                 // protected by m_renderingEventMutex
+
+        // Only accessed from the UI thread.
+        bool m_isTargetSizeBucketed;
+        Size m_targetAllocatedSize;
+
+        EventSource<Static_DrawEventHandler, InvokeModeOptions<StopOnFirstError>> m_drawPlaceholderEventList;
 
     public:
         CanvasControl(std::shared_ptr<ICanvasControlAdapter> adapter);
@@ -108,6 +118,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         //
 
         IFACEMETHODIMP Invalidate() override;
+        IFACEMETHODIMP InvalidateRegion(Rect region) override;
+
+        IFACEMETHODIMP get_CreateResourcesProgress(float* value) override;
+
+        IFACEMETHODIMP add_DrawPlaceholder(
+            Static_DrawEventHandler* value,
+            EventRegistrationToken* token) override;
+
+        IFACEMETHODIMP remove_DrawPlaceholder(
+            EventRegistrationToken token) override;
+
+        IFACEMETHODIMP put_IsSurfaceSizeBucketed(boolean value) override;
+
+        IFACEMETHODIMP get_IsSurfaceSizeBucketed(boolean* value) override;
 
         //
         // BaseControl
@@ -132,6 +156,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual void WindowVisibilityChanged() override final;
 
     private:
+        void RequestDraw();
         void ChangedImpl();
         void HookCompositionRenderingIfNecessary(Lock const&);
 
@@ -140,6 +165,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         HRESULT OnCompositionRendering(IInspectable* sender, IInspectable* args);
         void DrawControl();
+        void DrawPlaceholder(CanvasImageSource* target, Color const& clearColor);
     };
 
 }}}}}}
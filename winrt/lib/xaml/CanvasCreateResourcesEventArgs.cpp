@@ -25,9 +25,13 @@ IFACEMETHODIMP CanvasCreateResourcesEventArgsFactory::Create(
         });
 }
 
-CanvasCreateResourcesEventArgs::CanvasCreateResourcesEventArgs(CanvasCreateResourcesReason reason, std::function<void(IAsyncAction*)> trackAsyncActionCallback)
+CanvasCreateResourcesEventArgs::CanvasCreateResourcesEventArgs(
+    CanvasCreateResourcesReason reason,
+    std::function<void(IAsyncAction*)> trackAsyncActionCallback,
+    std::function<void(IAsyncAction*)> trackBackgroundActionCallback)
     : m_reason(reason)
     , m_trackAsyncActionCallback(trackAsyncActionCallback)
+    , m_trackBackgroundActionCallback(trackBackgroundActionCallback)
 {
 }
 
@@ -76,4 +80,40 @@ IFACEMETHODIMP CanvasCreateResourcesEventArgs::GetTrackedAction(IAsyncAction** a
         });
 }
 
+IFACEMETHODIMP CanvasCreateResourcesEventArgs::RunOnBackgroundThread(ICanvasCreateResourcesWorkHandler* handler, IAsyncAction** action)
+{
+    return ExceptionBoundary(
+        [=]
+        {
+            using ABI::Windows::System::Threading::IThreadPoolStatics;
+            using ABI::Windows::System::Threading::IWorkItemHandler;
+
+            CheckInPointer(handler);
+            CheckAndClearOutPointer(action);
+
+            ComPtr<IThreadPoolStatics> threadPool;
+            ThrowIfFailed(GetActivationFactory(HStringReference(RuntimeClass_Windows_System_Threading_ThreadPool).Get(), &threadPool));
+
+            ComPtr<ICanvasCreateResourcesWorkHandler> workHandler(handler);
+
+            auto workItem = Callback<AddFtmBase<IWorkItemHandler>::Type>(
+                [workHandler](IAsyncAction*)
+                {
+                    return workHandler->Invoke();
+                });
+
+            CheckMakeResult(workItem);
+
+            ComPtr<IAsyncAction> workAction;
+            ThrowIfFailed(threadPool->RunAsync(workItem.Get(), &workAction));
+
+            if (m_trackBackgroundActionCallback)
+            {
+                m_trackBackgroundActionCallback(workAction.Get());
+            }
+
+            ThrowIfFailed(workAction.CopyTo(action));
+        });
+}
+
 ActivatableClassWithFactory(CanvasCreateResourcesEventArgs, CanvasCreateResourcesEventArgsFactory);
\ No newline at end of file
@@ -24,14 +24,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         CanvasCreateResourcesReason m_reason;
         std::function<void(IAsyncAction*)> m_trackAsyncActionCallback;
+        std::function<void(IAsyncAction*)> m_trackBackgroundActionCallback;
         ComPtr<IAsyncAction> m_trackedAction;
 
     public:
-        CanvasCreateResourcesEventArgs(CanvasCreateResourcesReason reason, std::function<void(IAsyncAction*)> trackAsyncActionCallback);
+        CanvasCreateResourcesEventArgs(
+            CanvasCreateResourcesReason reason,
+            std::function<void(IAsyncAction*)> trackAsyncActionCallback,
+            std::function<void(IAsyncAction*)> trackBackgroundActionCallback = nullptr);
 
         IFACEMETHODIMP get_Reason(CanvasCreateResourcesReason* value) override;
         IFACEMETHODIMP TrackAsyncAction(IAsyncAction* action) override;
         IFACEMETHODIMP GetTrackedAction(IAsyncAction** action) override;
+        IFACEMETHODIMP RunOnBackgroundThread(ICanvasCreateResourcesWorkHandler* handler, IAsyncAction** action) override;
     };
 
 } } } } }
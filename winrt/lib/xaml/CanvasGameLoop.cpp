@@ -45,7 +45,7 @@ CanvasGameLoop::~CanvasGameLoop()
 void CanvasGameLoop::Tick()
 {
     m_tickLoopShouldContinue = false;
-    m_tickLoopShouldContinue = m_client->Tick(m_target.Get(), m_areResourcesCreated);
+    m_tickLoopShouldContinue = m_client->Tick(m_target.Get(), m_areResourcesCreated, m_gameLoopThread.get());
 }
 
 void CanvasGameLoop::TickCompleted(IAsyncAction* action, AsyncStatus status)
@@ -16,7 +16,9 @@ public:
     virtual void OnGameLoopStarting() = 0;
     virtual void OnGameLoopStopped() = 0;
 
-    virtual bool Tick(CanvasSwapChain* target, bool areResourcesCreated) = 0;
+    // The thread is passed so that a tick can defer its wait for the next
+    // frame to it.
+    virtual bool Tick(CanvasSwapChain* target, bool areResourcesCreated, IGameLoopThread* thread) = 0;
     virtual void OnTickLoopEnded() = 0;
 };
 
@@ -148,6 +148,28 @@ IFACEMETHODIMP CanvasVirtualControl::CreateDrawingSession(Rect updateRectangle,
 }
 
 
+IFACEMETHODIMP CanvasVirtualControl::DrawRegions(
+    uint32_t regionCount,
+    Rect* regions,
+    int32_t maximumParallelism,
+    ICanvasRegionDrawHandler* handler)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto imageSource = GetCurrentRenderTarget()->Target;
+
+            if (!IsReadyToDraw() || !imageSource)
+            {
+                ThrowHR(E_FAIL, Strings::CreateDrawingSessionCalledBeforeRegionsInvalidated);
+            }
+
+            auto clearColor = GetClearColor();
+            ThrowIfFailed(imageSource->DrawRegions(clearColor, regionCount, regions, maximumParallelism, handler));
+        });
+}
+
+
 IFACEMETHODIMP CanvasVirtualControl::SuspendDrawingSession(ICanvasDrawingSession* ds)
 {
     return ExceptionBoundary(
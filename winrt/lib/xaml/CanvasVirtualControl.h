@@ -66,6 +66,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHODIMP CreateDrawingSession(Rect, ICanvasDrawingSession**) override;
         IFACEMETHODIMP SuspendDrawingSession(ICanvasDrawingSession*) override;
         IFACEMETHODIMP ResumeDrawingSession(ICanvasDrawingSession*) override;
+        IFACEMETHODIMP DrawRegions(uint32_t, Rect*, int32_t, ICanvasRegionDrawHandler*) override;
         IFACEMETHODIMP Invalidate() override;
         IFACEMETHODIMP InvalidateRegion(Rect) override;
 
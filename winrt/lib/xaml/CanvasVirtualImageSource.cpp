@@ -5,6 +5,7 @@
 #include "pch.h"
 
 #include "CanvasVirtualImageSource.h"
+#include "utils/ParallelFor.h"
 
 using namespace ABI::Microsoft::Graphics::Canvas;
 using namespace ABI::Microsoft::Graphics::Canvas::UI::Xaml;
@@ -167,6 +168,99 @@ void CanvasVirtualImageSourceFactory::Create(
 }
 
 
+//
+// VirtualImageTiles implementation
+//
+
+
+std::vector<VirtualImageTiles::Index> VirtualImageTiles::GetTilesCovering(RECT const& rect, SIZE const& imageSize)
+{
+    auto left = std::max(rect.left, 0L);
+    auto top = std::max(rect.top, 0L);
+    auto right = std::min(rect.right, static_cast<LONG>(imageSize.cx));
+    auto bottom = std::min(rect.bottom, static_cast<LONG>(imageSize.cy));
+
+    std::vector<Index> tiles;
+
+    if (right <= left || bottom <= top)
+        return tiles;
+
+    auto firstColumn = static_cast<int>(left / TileSize);
+    auto lastColumn = static_cast<int>((right - 1) / TileSize);
+    auto firstRow = static_cast<int>(top / TileSize);
+    auto lastRow = static_cast<int>((bottom - 1) / TileSize);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            tiles.push_back(Index{ column, row });
+        }
+    }
+
+    return tiles;
+}
+
+
+RECT VirtualImageTiles::GetTileRect(Index const& index, SIZE const& imageSize)
+{
+    auto left = index.first * TileSize;
+    auto top = index.second * TileSize;
+
+    return RECT
+    {
+        left,
+        top,
+        std::min(left + TileSize, static_cast<int>(imageSize.cx)),
+        std::min(top + TileSize, static_cast<int>(imageSize.cy))
+    };
+}
+
+
+bool VirtualImageTiles::TryGetTileIndex(RECT const& rect, SIZE const& imageSize, Index* index)
+{
+    if (rect.left < 0 || rect.top < 0 || rect.left % TileSize != 0 || rect.top % TileSize != 0)
+        return false;
+
+    Index candidate{ static_cast<int>(rect.left / TileSize), static_cast<int>(rect.top / TileSize) };
+    auto tileRect = GetTileRect(candidate, imageSize);
+
+    if (tileRect.right <= tileRect.left || tileRect.bottom <= tileRect.top)
+        return false;
+
+    if (rect.right != tileRect.right || rect.bottom != tileRect.bottom)
+        return false;
+
+    *index = candidate;
+    return true;
+}
+
+
+RECT VirtualImageTiles::GetPrefetchBounds(RECT const& visibleBounds, RECT const& previousVisibleBounds, int margin, SIZE const& imageSize)
+{
+    auto dx = visibleBounds.left - previousVisibleBounds.left;
+    auto dy = visibleBounds.top - previousVisibleBounds.top;
+
+    auto bounds = visibleBounds;
+
+    if (dx <= 0)
+        bounds.left -= margin;
+    if (dx >= 0)
+        bounds.right += margin;
+    if (dy <= 0)
+        bounds.top -= margin;
+    if (dy >= 0)
+        bounds.bottom += margin;
+
+    bounds.left = std::max(bounds.left, 0L);
+    bounds.top = std::max(bounds.top, 0L);
+    bounds.right = std::min(bounds.right, static_cast<LONG>(imageSize.cx));
+    bounds.bottom = std::min(bounds.bottom, static_cast<LONG>(imageSize.cy));
+
+    return bounds;
+}
+
+
 //
 // CanvasVirtualImageSource implementation
 //
@@ -187,6 +281,12 @@ CanvasVirtualImageSource::CanvasVirtualImageSource(
     , m_alphaMode(alphaMode)
     , m_registeredForUpdates(false)
     , m_deviceIsMultithreadProtected(false)
+    , m_prefetchMargin(0)
+    , m_maximumCachedTileCount(0)
+    , m_visibleBounds{}
+    , m_previousVisibleBounds{}
+    , m_hasVisibleBounds(false)
+    , m_isPrefetchPending(false)
 {
     SetDevice(GetCanvasDevice(resourceCreator).Get());
 }
@@ -205,6 +305,10 @@ void CanvasVirtualImageSource::SetDevice(ICanvasDevice* device)
 
     m_device = device;
     m_deviceIsMultithreadProtected = false;
+
+    // Cached tiles belong to the old device, and drawn ones need drawing again.
+    auto lock = Lock(m_tileMutex);
+    ForgetTiles(lock, nullptr);
 }
 
 
@@ -304,6 +408,191 @@ IFACEMETHODIMP CanvasVirtualImageSource::ResumeDrawingSession(
 }
 
 
+//
+// DrawRegions hands the regions out to a number of threadpool workers, each
+// of which records them one at a time into a command list of its own. The
+// thread that called DrawRegions does a share of the recording too, and then
+// plays the command lists back into the image source once they are all done.
+//
+
+class CanvasVirtualImageSource::RegionRecorder
+{
+    ComPtr<ICanvasDevice> m_device;
+    float m_dpi;
+    std::vector<Rect> m_regions;
+    ComPtr<ICanvasRegionDrawHandler> m_handler;
+
+    std::vector<ComPtr<ID2D1CommandList>> m_recordedRegions;  // Indexed the same as m_regions.
+
+public:
+    RegionRecorder(ICanvasDevice* device, float dpi, std::vector<Rect>&& regions, ICanvasRegionDrawHandler* handler)
+        : m_device(device)
+        , m_dpi(dpi)
+        , m_regions(std::move(regions))
+        , m_handler(handler)
+        , m_recordedRegions(m_regions.size())
+    {
+    }
+
+    // Returns a command list for each region once every region has been
+    // recorded. Fails with the first error any of the workers ran into.
+    std::vector<ComPtr<ID2D1CommandList>> Run(uint32_t maximumParallelism)
+    {
+        auto deviceInternal = As<ICanvasDeviceInternal>(m_device);
+
+        ThrowIfFailed(ParallelFor(static_cast<uint32_t>(m_regions.size()), maximumParallelism,
+            [&](uint32_t index)
+            {
+                auto d2dCommandList = deviceInternal->CreateCommandList();
+                auto d2dDeviceContext = deviceInternal->CreateDeviceContextForDrawingSession();
+                d2dDeviceContext->SetTarget(d2dCommandList.Get());
+                d2dDeviceContext->SetDpi(m_dpi, m_dpi);
+
+                auto adapter = std::make_shared<SimpleCanvasDrawingSessionAdapter>(d2dDeviceContext.Get());
+                auto ds = CanvasDrawingSession::CreateNew(d2dDeviceContext.Get(), adapter, m_device.Get());
+
+                ThrowIfFailed(m_handler->Invoke(m_regions[index], ds.Get()));
+                ThrowIfFailed(ds->Close());
+
+                ThrowIfFailed(d2dCommandList->Close());
+
+                // Each index is only ever written by the worker that claimed it.
+                m_recordedRegions[index] = d2dCommandList;
+            }));
+
+        return std::move(m_recordedRegions);
+    }
+};
+
+
+IFACEMETHODIMP CanvasVirtualImageSource::DrawRegions(
+    Color clearColor,
+    uint32_t regionCount,
+    Rect* regions,
+    int32_t maximumParallelism,
+    ICanvasRegionDrawHandler* handler)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(handler);
+
+            if (regionCount > 0)
+                CheckInPointer(regions);
+
+            if (maximumParallelism < 0)
+                ThrowHR(E_INVALIDARG);
+
+            if (regionCount == 0)
+                return;
+
+            uint32_t parallelism = maximumParallelism ? static_cast<uint32_t>(maximumParallelism)
+                                                      : std::max(std::thread::hardware_concurrency(), 1U);
+
+            parallelism = AsyncScheduler::GetInstance().LimitParallelism(parallelism);
+
+            RegionRecorder recorder(
+                m_device.Get(),
+                m_dpi,
+                std::vector<Rect>(regions, regions + regionCount),
+                handler);
+
+            auto recordedRegions = recorder.Run(parallelism);
+
+            auto imageSize = GetSizeInPixels();
+
+            for (uint32_t i = 0; i < regionCount; i++)
+            {
+                // Regions that are exactly one tile are drawn through a
+                // bitmap that is kept in the tile cache.
+                auto regionRect = ToRECT(regions[i], m_dpi);
+                VirtualImageTiles::Index tileIndex;
+
+                bool isCacheEnabled;
+                {
+                    auto lock = Lock(m_tileMutex);
+                    isCacheEnabled = m_maximumCachedTileCount > 0;
+                }
+
+                if (isCacheEnabled && VirtualImageTiles::TryGetTileIndex(regionRect, imageSize, &tileIndex))
+                {
+                    auto bitmap = RenderTile(clearColor, regionRect, recordedRegions[i].Get());
+
+                    CopyTileToImage(regionRect, bitmap.Get());
+
+                    auto lock = Lock(m_tileMutex);
+                    CacheTile(lock, tileIndex, bitmap.Get());
+                    continue;
+                }
+
+                auto ds = CreateDrawingSession(clearColor, regions[i]);
+
+                GetWrappedResource<ID2D1DeviceContext>(ds)->DrawImage(recordedRegions[i].Get());
+
+                ThrowIfFailed(As<IClosable>(ds)->Close());
+            }
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualImageSource::get_PrefetchMargin(
+    float* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_tileMutex);
+            *value = m_prefetchMargin;
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualImageSource::put_PrefetchMargin(
+    float value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (!(value >= 0))
+                ThrowHR(E_INVALIDARG);
+
+            auto lock = Lock(m_tileMutex);
+            m_prefetchMargin = value;
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualImageSource::get_MaximumCachedTileCount(
+    uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_tileMutex);
+            *value = m_maximumCachedTileCount;
+        });
+}
+
+
+IFACEMETHODIMP CanvasVirtualImageSource::put_MaximumCachedTileCount(
+    uint32_t value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            auto lock = Lock(m_tileMutex);
+            m_maximumCachedTileCount = value;
+
+            while (m_cachedTiles.size() > m_maximumCachedTileCount)
+                m_cachedTiles.pop_back();
+        });
+}
+
+
 IFACEMETHODIMP CanvasVirtualImageSource::Invalidate()
 {
     return ExceptionBoundary(
@@ -311,6 +600,11 @@ IFACEMETHODIMP CanvasVirtualImageSource::Invalidate()
         {
             RECT updateRect = ToRECT(Rect{ 0, 0, m_size.Width, m_size.Height }, m_dpi);
 
+            {
+                auto lock = Lock(m_tileMutex);
+                ForgetTiles(lock, nullptr);
+            }
+
             auto sisNative = As<IVirtualSurfaceImageSourceNative>(m_vsis);
             ThrowIfFailed(sisNative->Invalidate(updateRect));
         });
@@ -325,6 +619,11 @@ IFACEMETHODIMP CanvasVirtualImageSource::InvalidateRegion(
         {
             RECT updateRectangle = ToRECT(region, m_dpi);
 
+            {
+                auto lock = Lock(m_tileMutex);
+                ForgetTiles(lock, &updateRectangle);
+            }
+
             auto sisNative = As<IVirtualSurfaceImageSourceNative>(m_vsis);
             ThrowIfFailed(sisNative->Invalidate(updateRectangle));            
         });
@@ -408,6 +707,10 @@ IFACEMETHODIMP CanvasVirtualImageSource::ResizeWithWidthAndHeightAndDpi(
 
             m_dpi = dpi;
             m_size = Size{ width, height };
+
+            auto lock = Lock(m_tileMutex);
+            ForgetTiles(lock, nullptr);
+            m_hasVisibleBounds = false;
         });
 }
 
@@ -557,6 +860,46 @@ IFACEMETHODIMP CanvasVirtualImageSource::UpdatesNeeded()
 
             RECT visibleBounds;
             ThrowIfFailed(vsisNative->GetVisibleBounds(&visibleBounds));
+
+            bool isTiled;
+            {
+                auto lock = Lock(m_tileMutex);
+
+                isTiled = IsTiled(lock);
+
+                m_previousVisibleBounds = m_hasVisibleBounds ? m_visibleBounds : visibleBounds;
+                m_visibleBounds = visibleBounds;
+                m_hasVisibleBounds = true;
+            }
+
+            if (isTiled)
+            {
+                auto imageSize = GetSizeInPixels();
+
+                std::vector<VirtualImageTiles::Index> tiles;
+                std::set<VirtualImageTiles::Index> seenTiles;
+
+                for (auto& updateRECT : updateRECTs)
+                {
+                    for (auto& index : VirtualImageTiles::GetTilesCovering(updateRECT, imageSize))
+                    {
+                        if (seenTiles.insert(index).second)
+                            tiles.push_back(index);
+                    }
+                }
+
+                {
+                    // XAML is asking for these, so whatever we drew there before is gone.
+                    auto lock = Lock(m_tileMutex);
+
+                    for (auto& index : tiles)
+                        m_drawnTiles.erase(index);
+                }
+
+                DrawTiles(tiles, visibleBounds);
+                SchedulePrefetch();
+                return;
+            }
             
             auto args = Make<CanvasRegionsInvalidatedEventArgs>(std::move(updateRects), ToRect(visibleBounds, m_dpi));
             CheckMakeResult(args);
@@ -566,6 +909,272 @@ IFACEMETHODIMP CanvasVirtualImageSource::UpdatesNeeded()
 }
 
 
+//
+// Tiling.  While prefetching or tile caching is enabled, UpdatesNeeded
+// rounds the regions XAML asks for out to whole tiles, and remembers which
+// tiles it has already asked the app to draw (m_drawnTiles), so that tiles
+// drawn ahead of time by a prefetch aren't asked for again when they scroll
+// into view.  Tiles drawn through DrawRegions are also kept as bitmaps in an
+// LRU cache, so they can be copied back into the image without involving the
+// app when XAML discards and then asks for them again.
+//
+
+SIZE CanvasVirtualImageSource::GetSizeInPixels() const
+{
+    return SIZE{ SizeDipsToPixels(m_size.Width, m_dpi), SizeDipsToPixels(m_size.Height, m_dpi) };
+}
+
+
+bool CanvasVirtualImageSource::IsTiled(Lock const&) const
+{
+    return m_prefetchMargin > 0 || m_maximumCachedTileCount > 0;
+}
+
+
+void CanvasVirtualImageSource::ForgetTiles(Lock const&, RECT const* region)
+{
+    if (!region)
+    {
+        m_drawnTiles.clear();
+        m_cachedTiles.clear();
+        return;
+    }
+
+    for (auto& index : VirtualImageTiles::GetTilesCovering(*region, GetSizeInPixels()))
+    {
+        m_drawnTiles.erase(index);
+
+        m_cachedTiles.remove_if([&] (CachedTile const& tile) { return tile.Index == index; });
+    }
+}
+
+
+ComPtr<ID2D1Bitmap1> CanvasVirtualImageSource::FindCachedTile(Lock const&, VirtualImageTiles::Index const& index)
+{
+    auto it = std::find_if(m_cachedTiles.begin(), m_cachedTiles.end(), [&] (CachedTile const& tile) { return tile.Index == index; });
+
+    if (it == m_cachedTiles.end())
+        return nullptr;
+
+    m_cachedTiles.splice(m_cachedTiles.begin(), m_cachedTiles, it);
+
+    return it->Bitmap;
+}
+
+
+void CanvasVirtualImageSource::CacheTile(Lock const&, VirtualImageTiles::Index const& index, ID2D1Bitmap1* bitmap)
+{
+    m_cachedTiles.remove_if([&] (CachedTile const& tile) { return tile.Index == index; });
+
+    if (m_maximumCachedTileCount == 0)
+        return;
+
+    m_cachedTiles.push_front(CachedTile{ index, bitmap });
+
+    while (m_cachedTiles.size() > m_maximumCachedTileCount)
+        m_cachedTiles.pop_back();
+}
+
+
+ComPtr<ID2D1Bitmap1> CanvasVirtualImageSource::RenderTile(Color const& clearColor, RECT const& tileRect, ID2D1CommandList* commandList)
+{
+    auto lease = As<ICanvasDeviceInternal>(m_device)->GetResourceCreationDeviceContext();
+    auto deviceContext = lease.Get();
+
+    ComPtr<ID2D1Bitmap1> bitmap;
+    ThrowIfFailed(deviceContext->CreateBitmap(
+        D2D1_SIZE_U{ static_cast<uint32_t>(tileRect.right - tileRect.left), static_cast<uint32_t>(tileRect.bottom - tileRect.top) },
+        nullptr,
+        0,
+        D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_TARGET,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+            m_dpi,
+            m_dpi),
+        &bitmap));
+
+    ComPtr<ID2D1Image> previousTarget;
+    deviceContext->GetTarget(&previousTarget);
+
+    float previousDpiX, previousDpiY;
+    deviceContext->GetDpi(&previousDpiX, &previousDpiY);
+
+    D2D1_MATRIX_3X2_F previousTransform;
+    deviceContext->GetTransform(&previousTransform);
+
+    auto restoreState = MakeScopeWarden(
+        [&]
+        {
+            deviceContext->SetTarget(previousTarget.Get());
+            deviceContext->SetDpi(previousDpiX, previousDpiY);
+            deviceContext->SetTransform(previousTransform);
+        });
+
+    // The command list was recorded in image coordinates.
+    deviceContext->SetTarget(bitmap.Get());
+    deviceContext->SetDpi(m_dpi, m_dpi);
+    deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(
+        -PixelsToDips(static_cast<int>(tileRect.left), m_dpi),
+        -PixelsToDips(static_cast<int>(tileRect.top), m_dpi)));
+
+    deviceContext->BeginDraw();
+    deviceContext->Clear(ToD2DColor(clearColor));
+    deviceContext->DrawImage(commandList);
+    ThrowIfFailed(deviceContext->EndDraw());
+
+    return bitmap;
+}
+
+
+void CanvasVirtualImageSource::CopyTileToImage(RECT const& tileRect, ID2D1Bitmap1* bitmap)
+{
+    auto ds = CreateDrawingSession(Color{ 0, 0, 0, 0 }, ToRect(tileRect, m_dpi));
+
+    D2D1_POINT_2F position
+    {
+        PixelsToDips(static_cast<int>(tileRect.left), m_dpi),
+        PixelsToDips(static_cast<int>(tileRect.top), m_dpi)
+    };
+
+    GetWrappedResource<ID2D1DeviceContext>(ds)->DrawImage(
+        bitmap,
+        &position,
+        nullptr,
+        D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+        D2D1_COMPOSITE_MODE_SOURCE_COPY);
+
+    ThrowIfFailed(As<IClosable>(ds)->Close());
+}
+
+
+void CanvasVirtualImageSource::DrawTiles(std::vector<VirtualImageTiles::Index> const& tiles, RECT const& visibleBounds)
+{
+    auto imageSize = GetSizeInPixels();
+
+    std::vector<VirtualImageTiles::Index> tilesToRaise;
+
+    for (auto& index : tiles)
+    {
+        ComPtr<ID2D1Bitmap1> bitmap;
+
+        {
+            auto lock = Lock(m_tileMutex);
+
+            if (m_drawnTiles.count(index))
+                continue;
+
+            bitmap = FindCachedTile(lock, index);
+        }
+
+        if (!bitmap)
+        {
+            tilesToRaise.push_back(index);
+            continue;
+        }
+
+        CopyTileToImage(VirtualImageTiles::GetTileRect(index, imageSize), bitmap.Get());
+
+        auto lock = Lock(m_tileMutex);
+        m_drawnTiles.insert(index);
+    }
+
+    if (tilesToRaise.empty())
+        return;
+
+    std::vector<Rect> regions;
+    regions.reserve(tilesToRaise.size());
+
+    for (auto& index : tilesToRaise)
+    {
+        regions.push_back(ToRect(VirtualImageTiles::GetTileRect(index, imageSize), m_dpi));
+    }
+
+    auto args = Make<CanvasRegionsInvalidatedEventArgs>(std::move(regions), ToRect(visibleBounds, m_dpi));
+    CheckMakeResult(args);
+
+    ThrowIfFailed(m_regionsInvalidatedEventSource.InvokeAll(this, args.Get()));
+
+    auto lock = Lock(m_tileMutex);
+    m_drawnTiles.insert(tilesToRaise.begin(), tilesToRaise.end());
+}
+
+
+void CanvasVirtualImageSource::SchedulePrefetch()
+{
+    {
+        auto lock = Lock(m_tileMutex);
+
+        if (m_prefetchMargin <= 0 || m_isPrefetchPending)
+            return;
+    }
+
+    ComPtr<ICoreDispatcher> dispatcher;
+    HRESULT hr = As<IDependencyObject>(m_vsis)->get_Dispatcher(&dispatcher);
+    if (hr == E_FAIL)
+    {
+        // There is no dispatcher in the XAML designer, so nothing is
+        // prefetched there.
+        return;
+    }
+    else
+    {
+        ThrowIfFailed(hr);
+    }
+
+    // Prefetching waits until the dispatcher is otherwise idle, so that it
+    // doesn't hold up drawing the visible part of the image.
+    WeakRef weakSelf = AsWeak(this);
+    auto callback = Callback<AddFtmBase<IDispatchedHandler>::Type>([weakSelf]() mutable
+    {
+        return ExceptionBoundary([&]
+        {
+            auto strongSelf = LockWeakRef<ICanvasVirtualImageSource>(weakSelf);
+            auto self = static_cast<CanvasVirtualImageSource*>(strongSelf.Get());
+
+            if (self)
+            {
+                self->Prefetch();
+            }
+        });
+    });
+    CheckMakeResult(callback);
+
+    ComPtr<IAsyncAction> asyncAction;
+    ThrowIfFailed(dispatcher->RunAsync(CoreDispatcherPriority_Idle, callback.Get(), &asyncAction));
+
+    auto lock = Lock(m_tileMutex);
+    m_isPrefetchPending = true;
+}
+
+
+void CanvasVirtualImageSource::Prefetch()
+{
+    auto imageSize = GetSizeInPixels();
+
+    RECT prefetchBounds;
+    RECT visibleBounds;
+
+    {
+        auto lock = Lock(m_tileMutex);
+
+        m_isPrefetchPending = false;
+
+        if (m_prefetchMargin <= 0 || !m_hasVisibleBounds)
+            return;
+
+        auto margin = DipsToPixels(m_prefetchMargin, m_dpi, CanvasDpiRounding::Ceiling);
+
+        prefetchBounds = VirtualImageTiles::GetPrefetchBounds(m_visibleBounds, m_previousVisibleBounds, margin, imageSize);
+        visibleBounds = m_visibleBounds;
+    }
+
+    if (m_regionsInvalidatedEventSource.GetSize() == 0)
+        return;
+
+    DrawTiles(VirtualImageTiles::GetTilesCovering(prefetchBounds, imageSize), visibleBounds);
+}
+
+
 bool CanvasVirtualImageSource::IsOnUIThread()
 {
     ComPtr<ICoreDispatcher> dispatcher;
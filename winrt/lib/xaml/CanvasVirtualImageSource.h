@@ -63,6 +63,35 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     typedef ITypedEventHandler<CanvasVirtualImageSource*, CanvasRegionsInvalidatedEventArgs*> ImageSourceRegionsInvalidatedHandler;
 
+
+    //
+    // Tile arithmetic for CanvasVirtualImageSource's prefetching and tile
+    // cache.  Everything is in pixels.  Tiles are TileSize pixels square,
+    // apart from those along the right and bottom edges of the image, which
+    // are clipped to it.
+    //
+    class VirtualImageTiles
+    {
+    public:
+        static const int TileSize = 256;
+
+        typedef std::pair<int, int> Index;  // Column, row.
+
+        // Returns the tiles that overlap rect, in row major order.
+        static std::vector<Index> GetTilesCovering(RECT const& rect, SIZE const& imageSize);
+
+        static RECT GetTileRect(Index const& index, SIZE const& imageSize);
+
+        // Returns true, and the index of the tile, if rect is exactly one tile.
+        static bool TryGetTileIndex(RECT const& rect, SIZE const& imageSize, Index* index);
+
+        // Grows visibleBounds by margin on the sides it is moving towards,
+        // compared to previousVisibleBounds, or on every side if it hasn't
+        // moved.
+        static RECT GetPrefetchBounds(RECT const& visibleBounds, RECT const& previousVisibleBounds, int margin, SIZE const& imageSize);
+    };
+
+
     class CanvasVirtualImageSource
         : public RuntimeClass<
             RuntimeClassFlags<WinRtClassicComMix>,
@@ -85,6 +114,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         bool m_deviceIsMultithreadProtected;
         EventSource<ImageSourceRegionsInvalidatedHandler, InvokeModeOptions<StopOnFirstError>> m_regionsInvalidatedEventSource;
 
+        struct CachedTile
+        {
+            VirtualImageTiles::Index Index;
+            ComPtr<ID2D1Bitmap1> Bitmap;
+        };
+
+        std::mutex m_tileMutex;
+        float m_prefetchMargin;
+        uint32_t m_maximumCachedTileCount;
+        std::set<VirtualImageTiles::Index> m_drawnTiles;
+        std::list<CachedTile> m_cachedTiles;        // Most recently used at the front.
+        RECT m_visibleBounds;
+        RECT m_previousVisibleBounds;
+        bool m_hasVisibleBounds;
+        bool m_isPrefetchPending;
+
     public:
         CanvasVirtualImageSource(
             std::shared_ptr<ICanvasImageSourceDrawingSessionFactory> drawingSessionFactory,
@@ -112,6 +157,25 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHOD(ResumeDrawingSession)(
             ICanvasDrawingSession* drawingSession) override;
 
+        IFACEMETHOD(DrawRegions)(
+            Color clearColor,
+            uint32_t regionCount,
+            Rect* regions,
+            int32_t maximumParallelism,
+            ICanvasRegionDrawHandler* handler) override;
+
+        IFACEMETHOD(get_PrefetchMargin)(
+            float* value) override;
+
+        IFACEMETHOD(put_PrefetchMargin)(
+            float value) override;
+
+        IFACEMETHOD(get_MaximumCachedTileCount)(
+            uint32_t* value) override;
+
+        IFACEMETHOD(put_MaximumCachedTileCount)(
+            uint32_t value) override;
+
         IFACEMETHOD(Invalidate)() override;
 
         IFACEMETHOD(InvalidateRegion)(
@@ -172,12 +236,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHOD(UpdatesNeeded)() override;
         
     private:
+        class RegionRecorder;
+
         void SetDevice(ICanvasDevice* device);
 
         ComPtr<ICanvasDrawingSession> CreateDrawingSession(Color clearColor, Rect updateRectangle);
 
         bool IsOnUIThread();
         void EnsureMultithreadDeviceIfNotOnUIThread();
+
+        SIZE GetSizeInPixels() const;
+        bool IsTiled(Lock const& lock) const;
+        void ForgetTiles(Lock const& lock, RECT const* region);
+        ComPtr<ID2D1Bitmap1> FindCachedTile(Lock const& lock, VirtualImageTiles::Index const& index);
+        void CacheTile(Lock const& lock, VirtualImageTiles::Index const& index, ID2D1Bitmap1* bitmap);
+        ComPtr<ID2D1Bitmap1> RenderTile(Color const& clearColor, RECT const& tileRect, ID2D1CommandList* commandList);
+        void CopyTileToImage(RECT const& tileRect, ID2D1Bitmap1* bitmap);
+
+        void DrawTiles(std::vector<VirtualImageTiles::Index> const& tiles, RECT const& visibleBounds);
+        void SchedulePrefetch();
+        void Prefetch();
     };
 
 
@@ -0,0 +1,283 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "FrameStatistics.h"
+#include "StepTimer.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::UI::Xaml;
+
+//
+// FrameStatisticsTracker
+//
+
+FrameStatisticsTracker::FrameStatisticsTracker()
+{
+    Reset();
+}
+
+void FrameStatisticsTracker::Reset()
+{
+    m_frames.clear();
+    m_nextFrame = 0;
+    m_totals = FrameTimings{};
+
+    m_gpuTimes.clear();
+    m_nextGpuTime = 0;
+    m_gpuTimeTotal = 0;
+
+    m_hasPreviousPresent = false;
+    m_previousPresent = DXGI_FRAME_STATISTICS{};
+}
+
+void FrameStatisticsTracker::AddFrame(FrameTimings const& timings)
+{
+    if (m_frames.size() < SampleCount)
+    {
+        m_frames.push_back(FrameTimings{});
+    }
+
+    auto& oldest = m_frames[m_nextFrame];
+
+    m_totals.UpdateTime += timings.UpdateTime - oldest.UpdateTime;
+    m_totals.DrawTime += timings.DrawTime - oldest.DrawTime;
+    m_totals.PresentTime += timings.PresentTime - oldest.PresentTime;
+    m_totals.MissedVerticalBlankCount += timings.MissedVerticalBlankCount - oldest.MissedVerticalBlankCount;
+
+    oldest = timings;
+    m_nextFrame = (m_nextFrame + 1) % SampleCount;
+}
+
+void FrameStatisticsTracker::AddGpuTime(uint64_t ticks)
+{
+    if (m_gpuTimes.size() < SampleCount)
+    {
+        m_gpuTimes.push_back(0);
+    }
+
+    m_gpuTimeTotal += ticks - m_gpuTimes[m_nextGpuTime];
+    m_gpuTimes[m_nextGpuTime] = ticks;
+    m_nextGpuTime = (m_nextGpuTime + 1) % SampleCount;
+}
+
+uint32_t FrameStatisticsTracker::CountMissedVerticalBlanks(DXGI_FRAME_STATISTICS const& statistics)
+{
+    uint32_t missed = 0;
+
+    if (m_hasPreviousPresent && statistics.PresentCount > m_previousPresent.PresentCount)
+    {
+        // With a sync interval of one, each present should be displayed one
+        // refresh after the previous one.
+        auto presents = statistics.PresentCount - m_previousPresent.PresentCount;
+        auto refreshes = statistics.PresentRefreshCount - m_previousPresent.PresentRefreshCount;
+
+        if (refreshes > presents)
+            missed = refreshes - presents;
+    }
+
+    m_hasPreviousPresent = true;
+    m_previousPresent = statistics;
+
+    return missed;
+}
+
+CanvasAnimatedFrameStatistics FrameStatisticsTracker::GetStatistics() const
+{
+    CanvasAnimatedFrameStatistics statistics{};
+
+    auto frameCount = static_cast<uint64_t>(m_frames.size());
+
+    statistics.FrameCount = static_cast<uint32_t>(frameCount);
+    statistics.MissedVerticalBlankCount = m_totals.MissedVerticalBlankCount;
+
+    if (frameCount)
+    {
+        statistics.AverageUpdateTime.Duration = static_cast<INT64>(m_totals.UpdateTime / frameCount);
+        statistics.AverageDrawTime.Duration = static_cast<INT64>(m_totals.DrawTime / frameCount);
+        statistics.AveragePresentTime.Duration = static_cast<INT64>(m_totals.PresentTime / frameCount);
+    }
+
+    if (!m_gpuTimes.empty())
+    {
+        statistics.AverageGpuTime.Duration = static_cast<INT64>(m_gpuTimeTotal / m_gpuTimes.size());
+    }
+
+    return statistics;
+}
+
+//
+// ResolutionScaler
+//
+
+// Frames costing more than this fraction of their budget are scaled down,
+// and those costing less than the headroom fraction eventually scaled up.
+// Either way the new scale aims for the target fraction.
+static const float sc_overBudgetLoad = 0.9f;
+static const float sc_headroomLoad = 0.6f;
+static const float sc_targetLoad = 0.75f;
+
+// Going back up is done gently, since overshooting costs a missed frame.
+static const float sc_maximumScaleIncrease = 0.1f;
+
+static uint64_t Smooth(uint64_t average, uint64_t sample)
+{
+    if (average == 0)
+        return sample;
+
+    auto delta = static_cast<int64_t>(sample) - static_cast<int64_t>(average);
+
+    return static_cast<uint64_t>(static_cast<int64_t>(average) + delta / 8);
+}
+
+ResolutionScaler::ResolutionScaler()
+{
+    Reset();
+}
+
+void ResolutionScaler::Reset()
+{
+    m_scale = 1.0f;
+    m_drawTime = 0;
+    m_gpuTime = 0;
+    m_framesSinceChange = 0;
+    m_framesWithHeadroom = 0;
+}
+
+void ResolutionScaler::AddGpuTime(uint64_t ticks)
+{
+    m_gpuTime = Smooth(m_gpuTime, ticks);
+}
+
+bool ResolutionScaler::AddFrame(uint64_t drawTime, uint64_t targetElapsedTime, float minimumScale)
+{
+    m_drawTime = Smooth(m_drawTime, drawTime);
+    m_framesSinceChange++;
+
+    float newScale = m_scale;
+
+    if (m_framesSinceChange >= SettleFrameCount && targetElapsedTime)
+    {
+        auto cost = static_cast<float>(m_gpuTime ? m_gpuTime : m_drawTime);
+        auto budget = static_cast<float>(targetElapsedTime);
+
+        auto scaleForTargetLoad = m_scale * sqrtf(sc_targetLoad * budget / std::max(cost, 1.0f));
+
+        if (cost > budget * sc_overBudgetLoad)
+        {
+            newScale = scaleForTargetLoad;
+            m_framesWithHeadroom = 0;
+        }
+        else if (cost < budget * sc_headroomLoad)
+        {
+            if (++m_framesWithHeadroom >= HeadroomFrameCount)
+                newScale = std::min(scaleForTargetLoad, m_scale + sc_maximumScaleIncrease);
+        }
+        else
+        {
+            m_framesWithHeadroom = 0;
+        }
+    }
+
+    // The minimum may have changed since the last frame.
+    newScale = std::min(std::max(newScale, minimumScale), 1.0f);
+
+    if (newScale == m_scale)
+        return false;
+
+    // Until new measurements arrive, assume that the cost changes with the
+    // number of pixels drawn.
+    auto pixelRatio = (newScale * newScale) / (m_scale * m_scale);
+
+    m_drawTime = static_cast<uint64_t>(m_drawTime * pixelRatio);
+    m_gpuTime = static_cast<uint64_t>(m_gpuTime * pixelRatio);
+
+    m_scale = newScale;
+    m_framesSinceChange = 0;
+    m_framesWithHeadroom = 0;
+
+    return true;
+}
+
+//
+// GpuFrameTimer
+//
+
+GpuFrameTimer::GpuFrameTimer(ID3D11Device* d3dDevice)
+    : m_d3dDevice(d3dDevice)
+    , m_frames(FramesInFlight)
+    , m_currentFrame(0)
+{
+    m_d3dDevice->GetImmediateContext(&m_deviceContext);
+
+    D3D11_QUERY_DESC disjointDesc{ D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+    D3D11_QUERY_DESC timestampDesc{ D3D11_QUERY_TIMESTAMP, 0 };
+
+    for (auto& frame : m_frames)
+    {
+        ThrowIfFailed(m_d3dDevice->CreateQuery(&disjointDesc, &frame.Disjoint));
+        ThrowIfFailed(m_d3dDevice->CreateQuery(&timestampDesc, &frame.Begin));
+        ThrowIfFailed(m_d3dDevice->CreateQuery(&timestampDesc, &frame.End));
+        frame.IsPending = false;
+    }
+}
+
+void GpuFrameTimer::BeginFrame()
+{
+    auto& frame = m_frames[m_currentFrame];
+
+    // Any result still outstanding for these queries is lost.
+    frame.IsPending = false;
+
+    m_deviceContext->Begin(frame.Disjoint.Get());
+    m_deviceContext->End(frame.Begin.Get());
+}
+
+void GpuFrameTimer::EndFrame()
+{
+    auto& frame = m_frames[m_currentFrame];
+
+    m_deviceContext->End(frame.End.Get());
+    m_deviceContext->End(frame.Disjoint.Get());
+
+    frame.IsPending = true;
+    m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+}
+
+std::vector<uint64_t> GpuFrameTimer::CollectResults()
+{
+    std::vector<uint64_t> results;
+
+    // Oldest first, starting with the frame that will be reused next.
+    for (size_t i = 0; i < m_frames.size(); i++)
+    {
+        auto& frame = m_frames[(m_currentFrame + i) % m_frames.size()];
+
+        uint64_t ticks;
+        if (frame.IsPending && TryGetResult(frame, &ticks))
+            results.push_back(ticks);
+    }
+
+    return results;
+}
+
+bool GpuFrameTimer::TryGetResult(Frame& frame, uint64_t* ticks)
+{
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+
+    if (m_deviceContext->GetData(frame.Disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        return false;
+
+    // The disjoint query completes after both timestamps.
+    uint64_t begin, end;
+    ThrowIfFailed(m_deviceContext->GetData(frame.Begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH));
+    ThrowIfFailed(m_deviceContext->GetData(frame.End.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH));
+
+    frame.IsPending = false;
+
+    if (disjoint.Disjoint || disjoint.Frequency == 0 || end < begin)
+        return false;
+
+    *ticks = (end - begin) * StepTimer::TicksPerSecond / disjoint.Frequency;
+    return true;
+}
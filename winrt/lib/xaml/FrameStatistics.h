@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace UI { namespace Xaml
+{
+    // How long each part of one frame took, in StepTimer ticks.
+    struct FrameTimings
+    {
+        uint64_t UpdateTime;
+        uint64_t DrawTime;
+        uint64_t PresentTime;
+        uint32_t MissedVerticalBlankCount;
+    };
+
+    //
+    // Rolling totals of frame timings over the most recent SampleCount
+    // frames.  GPU times arrive a few frames after the rest, so they are
+    // kept in a window of their own.
+    //
+    class FrameStatisticsTracker
+    {
+        std::vector<FrameTimings> m_frames;
+        size_t m_nextFrame;
+        FrameTimings m_totals;
+
+        std::vector<uint64_t> m_gpuTimes;
+        size_t m_nextGpuTime;
+        uint64_t m_gpuTimeTotal;
+
+        bool m_hasPreviousPresent;
+        DXGI_FRAME_STATISTICS m_previousPresent;
+
+    public:
+        static const uint32_t SampleCount = 60;
+
+        FrameStatisticsTracker();
+
+        void Reset();
+
+        void AddFrame(FrameTimings const& timings);
+        void AddGpuTime(uint64_t ticks);
+
+        // Returns how many vertical blanks passed without a new frame being
+        // shown since the previous call, from DXGI's statistics for the
+        // most recently displayed present.
+        uint32_t CountMissedVerticalBlanks(DXGI_FRAME_STATISTICS const& statistics);
+
+        CanvasAnimatedFrameStatistics GetStatistics() const;
+    };
+
+    //
+    // Chooses the fraction of the control's size to draw at when
+    // IsResolutionDynamic is set, so that each frame's cost stays within the
+    // target elapsed time.  The cost is the smoothed GPU time, or the draw
+    // time on devices that can't measure GPU time, and is assumed to be
+    // proportional to the number of pixels drawn.
+    //
+    // The scale drops as soon as frames run over budget, but only rises again
+    // once there has been headroom for HeadroomFrameCount frames, so that it
+    // doesn't flip back and forth on the edge of the budget.
+    //
+    class ResolutionScaler
+    {
+        float m_scale;
+        uint64_t m_drawTime;
+        uint64_t m_gpuTime;
+        uint32_t m_framesSinceChange;
+        uint32_t m_framesWithHeadroom;
+
+    public:
+        // GPU times arrive a few frames late, so after each change we wait
+        // for measurements made at the new scale.
+        static const uint32_t SettleFrameCount = 8;
+        static const uint32_t HeadroomFrameCount = 60;
+
+        ResolutionScaler();
+
+        void Reset();
+
+        float GetScale() const { return m_scale; }
+
+        void AddGpuTime(uint64_t ticks);
+
+        // Returns true if the scale has changed.
+        bool AddFrame(uint64_t drawTime, uint64_t targetElapsedTime, float minimumScale);
+    };
+
+    //
+    // Measures how long the GPU takes over each frame, using D3D11 timestamp
+    // queries.  Results are read back several frames later without flushing
+    // or waiting, so this never stalls the CPU; frames whose results are not
+    // ready by the time their queries are reused, or whose timestamps were
+    // disjoint, are just not measured.
+    //
+    // The caller must hold the D2D device lock around each call, since these
+    // use the device's immediate context.
+    //
+    class GpuFrameTimer
+    {
+        struct Frame
+        {
+            ComPtr<ID3D11Query> Disjoint;
+            ComPtr<ID3D11Query> Begin;
+            ComPtr<ID3D11Query> End;
+            bool IsPending;
+        };
+
+        ComPtr<ID3D11Device> m_d3dDevice;
+        ComPtr<ID3D11DeviceContext> m_deviceContext;
+        std::vector<Frame> m_frames;
+        size_t m_currentFrame;
+
+    public:
+        static const uint32_t FramesInFlight = 4;
+
+        GpuFrameTimer(ID3D11Device* d3dDevice);
+
+        ID3D11Device* GetDevice() const { return m_d3dDevice.Get(); }
+
+        void BeginFrame();
+        void EndFrame();
+
+        // Returns the GPU times, in StepTimer ticks, of frames whose results
+        // have arrived since the last call.
+        std::vector<uint64_t> CollectResults();
+
+    private:
+        bool TryGetResult(Frame& frame, uint64_t* ticks);
+    };
+}}}}}}
@@ -95,6 +95,7 @@ class GameLoopThread : public IGameLoopThread
     std::vector<ComPtr<AnimatedControlAsyncAction>> m_pendingActions;
 
 public:
+    // The client may be null, for a thread that is shared between controls.
     GameLoopThread(ComPtr<ISwapChainPanel> swapChainPanel, ICanvasGameLoopClient* client)
         : m_client(client)
         , m_started(false)
@@ -202,6 +203,11 @@ public:
         }
     }
 
+    virtual bool TryDeferFrameWait(std::function<void()> const&) override
+    {
+        return false;
+    }
+
 private:
     Lock GetLock()
     {
@@ -218,9 +224,12 @@ private:
         swapChainPanel.Reset(); // we only needed this to create the dispatcher
         m_conditionVariable.notify_all();
 
-        lock.unlock();
-        m_client->OnGameLoopStarting();
-        lock.lock();
+        if (m_client)
+        {
+            lock.unlock();
+            m_client->OnGameLoopStarting();
+            lock.lock();
+        }
 
         m_started = true;
         m_conditionVariable.notify_all();        
@@ -259,7 +268,9 @@ private:
         CancelActions(lock);
 
         lock.unlock();
-        m_client->OnGameLoopStopped();
+
+        if (m_client)
+            m_client->OnGameLoopStopped();
 
         // falling out of ThreadMain will cause ThreadCompleted to be called,
         // which will mark the thread as shutdown.
@@ -305,3 +316,256 @@ std::unique_ptr<IGameLoopThread> CreateGameLoopThread(ISwapChainPanel* swapChain
 {
     return std::make_unique<GameLoopThread>(swapChainPanel, client);
 }
+
+
+//
+// The thread behind CreateSharedGameLoopThread.
+//
+// Ticks from all of the controls that share it are batched into rounds.  A
+// round runs the next tick of each control in turn and then waits, once, for
+// the next frame.  Without this each control would wait for its own vertical
+// blank, and a round of N controls would take N frames.
+//
+// A control stopping the dispatcher while its resources are recreated can't
+// be allowed to stall the others, so once started the dispatcher keeps
+// running until the thread is destroyed.  The stopped control's own ticks
+// aren't running at the time, since it only does this between tick loops.
+//
+class SharedGameLoopThread : private LifespanTracker<SharedGameLoopThread>
+{
+    class Client;
+
+    struct QueuedTick
+    {
+        Client* Owner;
+        ComPtr<AnimatedControlAsyncAction> Action;
+    };
+
+    GameLoopThread m_thread;
+    ComPtr<IDispatchedHandler> m_roundHandler;
+
+    std::mutex m_mutex;
+    std::vector<Client*> m_clients;
+    std::vector<QueuedTick> m_queuedTicks;
+    bool m_isRoundScheduled;
+
+    // The wait handed over by the first tick in this round that wanted one.
+    // Only accessed from the shared thread.
+    std::function<void()> m_deferredFrameWait;
+
+public:
+    SharedGameLoopThread(ComPtr<ISwapChainPanel> swapChainPanel)
+        : m_thread(swapChainPanel, nullptr)
+        , m_isRoundScheduled(false)
+    {
+        m_roundHandler = Callback<AddFtmBase<IDispatchedHandler>::Type>(
+            [this]
+            {
+                return ExceptionBoundary([&] { RunRound(); });
+            });
+        CheckMakeResult(m_roundHandler);
+    }
+
+    static std::unique_ptr<IGameLoopThread> CreateClient(ISwapChainPanel* swapChainPanel, ICanvasGameLoopClient* client)
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<SharedGameLoopThread> existingThread;
+
+        auto lock = Lock(mutex);
+
+        auto thread = existingThread.lock();
+
+        if (!thread)
+        {
+            thread = std::make_shared<SharedGameLoopThread>(swapChainPanel);
+            existingThread = thread;
+        }
+
+        lock.unlock();
+
+        return std::make_unique<Client>(thread, client);
+    }
+
+private:
+    class Client : public IGameLoopThread
+                 , private LifespanTracker<Client>
+    {
+        std::shared_ptr<SharedGameLoopThread> m_thread;
+        ICanvasGameLoopClient* m_client;
+
+    public:
+        Client(std::shared_ptr<SharedGameLoopThread> thread, ICanvasGameLoopClient* client)
+            : m_thread(std::move(thread))
+            , m_client(client)
+        {
+            m_thread->AddClient(this);
+            m_thread->RunAndWait([=] { m_client->OnGameLoopStarting(); });
+        }
+
+        ~Client()
+        {
+            m_thread->RemoveClient(this);
+
+            // This runs after any round that might still be ticking us, so
+            // once it returns none of our ticks are running.
+            ExceptionBoundary(
+                [&]
+                {
+                    m_thread->RunAndWait([=] { m_client->OnGameLoopStopped(); });
+                });
+        }
+
+        virtual void StartDispatcher() override
+        {
+            m_thread->m_thread.StartDispatcher();
+        }
+
+        virtual void StopDispatcher() override
+        {
+            // See the comment on SharedGameLoopThread.
+        }
+
+        virtual ComPtr<IAsyncAction> RunAsync(IDispatchedHandler* handler) override
+        {
+            return m_thread->QueueTick(this, handler);
+        }
+
+        virtual bool HasThreadAccess() override
+        {
+            return m_thread->m_thread.HasThreadAccess();
+        }
+
+        virtual bool TryDeferFrameWait(std::function<void()> const& wait) override
+        {
+            if (!m_thread->m_deferredFrameWait)
+                m_thread->m_deferredFrameWait = wait;
+
+            return true;
+        }
+    };
+
+    void AddClient(Client* client)
+    {
+        auto lock = Lock(m_mutex);
+        m_clients.push_back(client);
+    }
+
+    void RemoveClient(Client* client)
+    {
+        auto lock = Lock(m_mutex);
+
+        m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), client), m_clients.end());
+
+        // Ticks that haven't started are dropped; the game loop they would
+        // call back into is going away.
+        m_queuedTicks.erase(
+            std::remove_if(m_queuedTicks.begin(), m_queuedTicks.end(), [=](QueuedTick const& tick) { return tick.Owner == client; }),
+            m_queuedTicks.end());
+    }
+
+    bool IsClient(Lock const& lock, Client* client)
+    {
+        MustOwnLock(lock);
+
+        return std::find(m_clients.begin(), m_clients.end(), client) != m_clients.end();
+    }
+
+    ComPtr<IAsyncAction> QueueTick(Client* client, IDispatchedHandler* handler)
+    {
+        auto action = Make<AnimatedControlAsyncAction>(handler);
+        CheckMakeResult(action);
+
+        auto lock = Lock(m_mutex);
+
+        // A client being destroyed may still finish a tick, which then tries
+        // to schedule the next one.  That never runs.
+        if (!IsClient(lock, client))
+            return action;
+
+        m_queuedTicks.push_back(QueuedTick{ client, action });
+
+        if (!m_isRoundScheduled)
+        {
+            m_isRoundScheduled = true;
+            lock.unlock();
+
+            m_thread.RunAsync(m_roundHandler.Get());
+        }
+
+        return action;
+    }
+
+    void RunRound()
+    {
+        auto lock = Lock(m_mutex);
+
+        std::vector<QueuedTick> ticks;
+        std::swap(ticks, m_queuedTicks);
+
+        lock.unlock();
+
+        // Each tick's completion queues its next tick for the following round.
+        for (auto& tick : ticks)
+        {
+            lock.lock();
+            bool isClient = IsClient(lock, tick.Owner);
+            lock.unlock();
+
+            if (isClient)
+                tick.Action->InvokeAndFireCompletion();
+        }
+
+        std::function<void()> wait;
+        std::swap(wait, m_deferredFrameWait);
+
+        // A failed wait, eg. from a lost device, will be reported to its
+        // control by the next present, so all we need to do is carry on.
+        if (wait)
+            ExceptionBoundary(wait);
+
+        lock.lock();
+
+        m_isRoundScheduled = !m_queuedTicks.empty();
+        bool scheduleRound = m_isRoundScheduled;
+
+        lock.unlock();
+
+        if (scheduleRound)
+            m_thread.RunAsync(m_roundHandler.Get());
+    }
+
+    // Runs fn on the shared thread, blocking until it has finished.
+    void RunAndWait(std::function<void()> const& fn)
+    {
+        Wrappers::Event completedEvent(CreateEventEx(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+
+        if (!completedEvent.IsValid())
+            ThrowHR(HRESULT_FROM_WIN32(GetLastError()));
+
+        auto handler = Callback<AddFtmBase<IDispatchedHandler>::Type>(
+            [&]
+            {
+                return ExceptionBoundary(fn);
+            });
+        CheckMakeResult(handler);
+
+        auto completedHandler = Callback<AddFtmBase<IAsyncActionCompletedHandler>::Type>(
+            [&] (IAsyncAction*, AsyncStatus)
+            {
+                SetEvent(completedEvent.Get());
+                return S_OK;
+            });
+        CheckMakeResult(completedHandler);
+
+        auto action = m_thread.RunAsync(handler.Get());
+        ThrowIfFailed(action->put_Completed(completedHandler.Get()));
+
+        WaitForSingleObjectEx(completedEvent.Get(), INFINITE, FALSE);
+    }
+};
+
+
+std::unique_ptr<IGameLoopThread> CreateSharedGameLoopThread(ISwapChainPanel* swapChainPanel, ICanvasGameLoopClient* client)
+{
+    return SharedGameLoopThread::CreateClient(swapChainPanel, client);
+}
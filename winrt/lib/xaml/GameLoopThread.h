@@ -18,8 +18,18 @@ public:
     virtual void StopDispatcher() = 0;
     virtual ComPtr<IAsyncAction> RunAsync(IDispatchedHandler* handler) = 0;
     virtual bool HasThreadAccess() = 0;
+
+    // A shared thread ticks several controls in turn, and then waits once for
+    // the next frame.  Ticks on one hand over their wait, rather than waiting
+    // themselves, when this returns true.
+    virtual bool TryDeferFrameWait(std::function<void()> const& wait) = 0;
 };
 
 class ICanvasGameLoopClient;
 
 std::unique_ptr<IGameLoopThread> CreateGameLoopThread(ISwapChainPanel* swapChainPanel, ICanvasGameLoopClient* client);
+
+// Returns the client's view of the one thread that is shared between every
+// control that asks for it.  The thread is created, using swapChainPanel, by
+// the first of these and lasts until the last one is gone.
+std::unique_ptr<IGameLoopThread> CreateSharedGameLoopThread(ISwapChainPanel* swapChainPanel, ICanvasGameLoopClient* client);
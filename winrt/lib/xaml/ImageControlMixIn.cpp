@@ -10,8 +10,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 {
     ImageControlMixIn::ImageControlMixIn(IUserControl* userControl, IImageControlMixInAdapter* adapter)
         : m_composableBase(userControl)
+        , m_imageSize{}
+        , m_isImageClipped(false)
     {
         m_imageControl = adapter->CreateImageControl();
+        m_imageClip = adapter->CreateRectangleGeometry();
 
         //
         // Set the stretch mode to Fill. This will ensure that on high DPI, the
@@ -53,6 +56,30 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ThrowIfFailed(m_imageControl->put_Source(imageSource));
     }
 
+
+    void ImageControlMixIn::SetImageSize(Size imageSize)
+    {
+        if (imageSize.Width == m_imageSize.Width && imageSize.Height == m_imageSize.Height)
+            return;
+
+        m_imageSize = imageSize;
+
+        auto imageAsUIElement = As<IUIElement>(m_imageControl);
+
+        //
+        // The clip is only set once it's needed, and then left in place since
+        // clipping to the control's own bounds makes no difference when the
+        // image fills it.
+        //
+        if (imageSize.Width > 0 && !m_isImageClipped)
+        {
+            ThrowIfFailed(imageAsUIElement->put_Clip(m_imageClip.Get()));
+            m_isImageClipped = true;
+        }
+
+        ThrowIfFailed(imageAsUIElement->InvalidateArrange());
+    }
+
     
     IFACEMETHODIMP ImageControlMixIn::MeasureOverride(
         Size availableSize, 
@@ -86,9 +113,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             [&]
             {
                 //
-                // Call Arrange on our children (in this case just the image control).
+                // Call Arrange on our children (in this case just the image
+                // control).  An image source bigger than the control is
+                // arranged at its own size, so that it is drawn unscaled,
+                // and clipped to the control.
                 //
-                ThrowIfFailed(As<IUIElement>(m_imageControl)->Arrange(Rect{ 0, 0, finalSize.Width, finalSize.Height }));
+                auto imageSize = (m_imageSize.Width > 0) ? m_imageSize : finalSize;
+
+                ThrowIfFailed(As<IUIElement>(m_imageControl)->Arrange(Rect{ 0, 0, imageSize.Width, imageSize.Height }));
+
+                if (m_isImageClipped)
+                    ThrowIfFailed(m_imageClip->put_Rect(Rect{ 0, 0, finalSize.Width, finalSize.Height }));
                 
                 //
                 // Reply that we're happy to accept the size chosen by the layout engine.
@@ -13,6 +13,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     public:
         virtual RegisteredEvent AddSurfaceContentsLostCallback(IEventHandler<IInspectable*>*) = 0;
         virtual ComPtr<IImage> CreateImageControl() = 0;
+        virtual ComPtr<IRectangleGeometry> CreateRectangleGeometry() = 0;
         virtual void DisableAccessibilityView(IImage*) = 0;
     };
 
@@ -25,6 +26,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<IImage> m_imageControl;
         IUserControl* m_composableBase;
 
+        // When the image source is bigger than the control, the image control
+        // is arranged at m_imageSize and clipped to the control.
+        ComPtr<IRectangleGeometry> m_imageClip;
+        Size m_imageSize;
+        bool m_isImageClipped;
+
     public:
         ImageControlMixIn(IUserControl* userControl, IImageControlMixInAdapter* adapter);
         
@@ -54,6 +61,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         void UnregisterEventHandlers();
 
         void SetImageSource(IImageSource* imageSource);
+
+        // Sets the size, in DIPs, of an image source of which only the top
+        // left corner, the size of the control, is to be shown.  A zero size
+        // stretches the image source to fill the control.
+        void SetImageSize(Size imageSize);
     };
 
     
@@ -84,6 +96,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     class ImageControlMixInAdapter : public virtual IImageControlMixInAdapter
     {
         ComPtr<IActivationFactory> m_imageControlFactory;
+        ComPtr<IActivationFactory> m_rectangleGeometryFactory;
         ComPtr<ICompositionTargetStatics> m_compositionTargetStatics;
 
     public:
@@ -93,6 +106,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 HStringReference(RuntimeClass_Windows_UI_Xaml_Controls_Image).Get(),
                 &m_imageControlFactory));
 
+            ThrowIfFailed(GetActivationFactory(
+                HStringReference(RuntimeClass_Windows_UI_Xaml_Media_RectangleGeometry).Get(),
+                &m_rectangleGeometryFactory));
+
             ThrowIfFailed(GetActivationFactory(
                 HStringReference(RuntimeClass_Windows_UI_Xaml_Media_CompositionTarget).Get(),
                &m_compositionTargetStatics));            
@@ -120,6 +137,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             return image;
         }
 
+        virtual ComPtr<IRectangleGeometry> CreateRectangleGeometry() override
+        {
+            ComPtr<IInspectable> inspectableGeometry;
+            ThrowIfFailed(m_rectangleGeometryFactory->ActivateInstance(&inspectableGeometry));
+
+            ComPtr<IRectangleGeometry> geometry;
+            ThrowIfFailed(inspectableGeometry.As(&geometry));
+
+            return geometry;
+        }
+
         virtual void DisableAccessibilityView(IImage* imageControl) override
         {
             using namespace ::ABI::Windows::UI::Xaml::Automation;
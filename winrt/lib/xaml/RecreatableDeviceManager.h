@@ -63,6 +63,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual void RunWithDevice(Sender* sender, DeviceCreationOptions deviceCreationOptions, RunWithDeviceFunction fn) = 0;
         virtual ComPtr<ICanvasDevice> const& GetDevice() = 0;
         virtual bool IsReadyToDraw() = 0;
+        virtual float GetCreateResourcesProgress() = 0;
         virtual void SetDpiChanged() = 0;
 
         virtual EventRegistrationToken AddCreateResources(Sender* sender, CreateResourcesHandler* value) = 0;
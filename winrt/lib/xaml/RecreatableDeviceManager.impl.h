@@ -132,9 +132,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<ICanvasDevice> m_device;
         DeviceCreationOptions m_deviceCreationOptions;
 
+        //
+        // The operations CreateResources is waiting for: at most one action
+        // passed to TrackAsyncAction, plus any number of work items started
+        // with RunOnBackgroundThread, which run in parallel on the thread
+        // pool.  Resources are created once all of them have completed.
+        //
         std::recursive_mutex m_currentOperationMutex;
-        ComPtr<IAsyncInfo> m_currentOperation;
-        bool m_currentOperationIsPending;
+        std::vector<ComPtr<IAsyncInfo>> m_currentOperations;
+        uint32_t m_pendingOperationCount;
+        bool m_hasTrackedAsyncAction;
 
         std::unique_ptr<CommittedDevice> m_committedDevice;
 
@@ -144,7 +151,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         RecreatableDeviceManager(IActivationFactory* canvasDeviceFactory, IInspectable* parentControl)
             : m_canvasDeviceFactory(canvasDeviceFactory)
             , m_parentControl(parentControl)
-            , m_currentOperationIsPending(false)
+            , m_pendingOperationCount(0)
+            , m_hasTrackedAsyncAction(false)
             , m_dpiChanged(false)
         {
         }
@@ -214,7 +222,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 return false;
 
             std::unique_lock<std::recursive_mutex> lock(m_currentOperationMutex);
-            return !m_currentOperationIsPending;
+            return m_pendingOperationCount == 0;
+        }
+
+        virtual float GetCreateResourcesProgress() override
+        {
+            std::unique_lock<std::recursive_mutex> lock(m_currentOperationMutex);
+
+            if (m_currentOperations.empty())
+                return IsReadyToDraw() ? 1.0f : 0.0f;
+
+            auto operationCount = static_cast<float>(m_currentOperations.size());
+            return (operationCount - m_pendingOperationCount) / operationCount;
         }
 
         virtual void SetDpiChanged() override
@@ -223,7 +242,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
          
             m_dpiChanged = true;
 
-            if (!m_currentOperationIsPending && m_changedCallback)
+            if (m_pendingOperationCount == 0 && m_changedCallback)
             {
                 lock.unlock();
                 m_changedCallback(ChangeReason::Other);
@@ -317,10 +336,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             // While there's an operation pending we can't use any new device we
             // created.
             //
-            if (m_currentOperationIsPending)
+            if (m_pendingOperationCount > 0)
                 return flags | RunWithDeviceFlags::ResourcesNotCreated;
 
-            if (m_currentOperation)
+            if (!m_currentOperations.empty())
             {
                 try
                 {
@@ -378,7 +397,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 // One of the CreateResources handlers might have registered an
                 // operation for us to track.
                 //
-                if (m_currentOperationIsPending)
+                if (m_pendingOperationCount > 0)
                     flags = flags | RunWithDeviceFlags::ResourcesNotCreated;
                 else
                     m_committedDevice->SetResourcesCreated();
@@ -474,41 +493,64 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         void CancelAnyPendingOperation()
         {
             std::unique_lock<std::recursive_mutex> lock(m_currentOperationMutex);
-            if (m_currentOperationIsPending)
+            if (m_pendingOperationCount > 0)
             {
-                ThrowIfFailed(m_currentOperation->Cancel());
+                // Canceling can complete an operation synchronously, so
+                // iterate over a copy.
+                auto operations = m_currentOperations;
+
+                for (auto& operation : operations)
+                {
+                    ThrowIfFailed(operation->Cancel());
+                }
             }            
         }
 
         void ProcessCurrentOperationResult()
         {
-            auto operation = m_currentOperation;
-            m_currentOperation.Reset();
-  
-            AsyncStatus status;
-            ThrowIfFailed(operation->get_Status(&status));
+            auto operations = std::move(m_currentOperations);
+            m_currentOperations.clear();
+            m_hasTrackedAsyncAction = false;
 
-            switch (status)
+            //
+            // Resources are only created if every operation completed.  The
+            // first error is reported; if there was no error but something
+            // was canceled then CreateResources will be raised again.
+            //
+            bool allCompleted = true;
+
+            for (auto& operation : operations)
             {
-            case AsyncStatus::Completed:
-                assert(m_committedDevice);
-                m_committedDevice->SetResourcesCreated();
-                break;
+                AsyncStatus status;
+                ThrowIfFailed(operation->get_Status(&status));
+
+                switch (status)
+                {
+                case AsyncStatus::Completed:
+                    break;
                 
-            case AsyncStatus::Canceled:
-                break;
+                case AsyncStatus::Canceled:
+                    allCompleted = false;
+                    break;
 
-            case AsyncStatus::Error: 
-            {
-                HRESULT hr;
-                ThrowIfFailed(operation->get_ErrorCode(&hr));
-                ThrowHR(hr);
-                // (can't get here, we threw!)
-            }
+                case AsyncStatus::Error: 
+                {
+                    HRESULT hr;
+                    ThrowIfFailed(operation->get_ErrorCode(&hr));
+                    ThrowHR(hr);
+                    // (can't get here, we threw!)
+                }
             
-            default:
-                assert(false);
-                ThrowHR(E_UNEXPECTED);
+                default:
+                    assert(false);
+                    ThrowHR(E_UNEXPECTED);
+                }
+            }
+
+            if (allCompleted)
+            {
+                assert(m_committedDevice);
+                m_committedDevice->SetResourcesCreated();
             }
         }
 
@@ -518,6 +560,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 [=](IAsyncAction* action)
                 {
                     TrackAsyncAction(action);
+                },
+                [=](IAsyncAction* action)
+                {
+                    TrackOperation(action);
                 });
 
             CheckMakeResult(eventArgs);
@@ -528,9 +574,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         {
             std::unique_lock<std::recursive_mutex> lock(m_currentOperationMutex);
 
-            if (m_currentOperation)
+            if (m_hasTrackedAsyncAction)
                 ThrowHR(E_FAIL, Strings::MultipleAsyncCreateResourcesNotSupported);
 
+            TrackOperation(action);
+
+            m_hasTrackedAsyncAction = true;
+        }
+
+        void TrackOperation(IAsyncAction* action)
+        {
+            std::unique_lock<std::recursive_mutex> lock(m_currentOperationMutex);
+
             // The async completion handler closes over a weak reference to the parent control,
             // so it can detect if the control gets destroyed while the async create resources
             // operation is in progress. In that case we just discard the completion notification.
@@ -551,8 +606,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
             auto onCompleted = Callback<IAsyncActionCompletedHandler>(completedHandler);
             CheckMakeResult(onCompleted);
-            m_currentOperation = As<IAsyncInfo>(action);                
-            m_currentOperationIsPending = true;
+            m_currentOperations.push_back(As<IAsyncInfo>(action));
+            ++m_pendingOperationCount;
 
             // Release the lock before setting the completed handler, because if the action has already
             // completed this could result in an immediate call to OnAsynchronousCreateResourcesCompleted,
@@ -568,9 +623,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 [&]
                 {
                     std::unique_lock<std::recursive_mutex> lock(m_currentOperationMutex);
-                    m_currentOperationIsPending = false;
+                    assert(m_pendingOperationCount > 0);
+                    --m_pendingOperationCount;
                     lock.unlock();
                     
+                    // This is also called as each parallel operation
+                    // completes, so placeholders can show progress.
                     if (m_changedCallback)
                         m_changedCallback(ChangeReason::Other);
                 });
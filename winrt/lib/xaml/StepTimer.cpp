@@ -18,6 +18,13 @@ StepTimer::StepTimer(std::shared_ptr<ICanvasTimingAdapter> adapter)
     , m_secondCounter(0)
     , m_isFixedTimeStep(true)
     , m_targetElapsedTicks(DefaultTargetElapsedTime)
+    , m_isAdaptivePacing(false)
+    , m_refreshPeriod(0)
+    , m_lastSyncTime(0)
+    , m_lastSyncRefreshCount(0)
+    , m_pacingError(0)
+    , m_averageTimeDelta(0)
+    , m_frameTimeJitter(0)
 {
     m_frequency = m_adapter->GetPerformanceFrequency();
 
@@ -36,4 +43,75 @@ void StepTimer::ResetElapsedTime()
     m_framesPerSecond = 0;
     m_framesThisSecond = 0;
     m_secondCounter = 0;
+
+    m_pacingError = 0;
+    m_averageTimeDelta = 0;
+    m_frameTimeJitter = 0;
+}
+
+void StepTimer::AddDisplaySync(int64_t syncTime, uint32_t syncRefreshCount)
+{
+    // DXGI reports the same sync until the display refreshes again.
+    if (syncRefreshCount == m_lastSyncRefreshCount)
+        return;
+
+    if (m_lastSyncTime != 0 && syncRefreshCount > m_lastSyncRefreshCount && syncTime > m_lastSyncTime)
+    {
+        auto period = (syncTime - m_lastSyncTime) / (syncRefreshCount - m_lastSyncRefreshCount);
+
+        // Smooth the measurement, but follow a real change (such as the
+        // window moving to a different display) within a few frames.
+        if (m_refreshPeriod == 0 || period > m_refreshPeriod * 2 || period < m_refreshPeriod / 2)
+            m_refreshPeriod = period;
+        else
+            m_refreshPeriod = (m_refreshPeriod * 7 + period) / 8;
+    }
+
+    m_lastSyncTime = syncTime;
+    m_lastSyncRefreshCount = syncRefreshCount;
+}
+
+int64_t StepTimer::GetNextTickTime() const
+{
+    uint64_t ticksUntilNextUpdate = m_targetElapsedTicks;
+
+    if (m_isFixedTimeStep)
+        ticksUntilNextUpdate -= std::min(m_leftOverTicks, m_targetElapsedTicks);
+
+    return m_lastTime + static_cast<int64_t>(ticksUntilNextUpdate * m_frequency / TicksPerSecond);
+}
+
+uint64_t StepTimer::MeasureAndPace(uint64_t timeDelta)
+{
+    uint64_t expectedTimeDelta;
+
+    if (m_refreshPeriod > 0)
+    {
+        uint64_t refreshPeriod = static_cast<uint64_t>(m_refreshPeriod);
+        uint64_t periods = std::max<uint64_t>(1, (timeDelta + refreshPeriod / 2) / refreshPeriod);
+        expectedTimeDelta = periods * refreshPeriod;
+    }
+    else
+    {
+        expectedTimeDelta = m_averageTimeDelta ? m_averageTimeDelta : timeDelta;
+    }
+
+    m_averageTimeDelta = m_averageTimeDelta ? (m_averageTimeDelta * 15 + timeDelta) / 16 : timeDelta;
+
+    uint64_t deviation = timeDelta > expectedTimeDelta ? timeDelta - expectedTimeDelta : expectedTimeDelta - timeDelta;
+    m_frameTimeJitter = (m_frameTimeJitter * 15 + deviation * TicksPerSecond / m_frequency) / 16;
+
+    if (!m_isAdaptivePacing || m_refreshPeriod == 0 || deviation >= static_cast<uint64_t>(m_refreshPeriod / 4))
+        return timeDelta;
+
+    m_pacingError += static_cast<int64_t>(timeDelta) - static_cast<int64_t>(expectedTimeDelta);
+
+    if (llabs(m_pacingError) > m_refreshPeriod / 2)
+    {
+        auto correctedTimeDelta = static_cast<int64_t>(expectedTimeDelta) + m_pacingError;
+        m_pacingError = 0;
+        return static_cast<uint64_t>(std::max<int64_t>(correctedTimeDelta, 0));
+    }
+
+    return expectedTimeDelta;
 }
@@ -40,6 +40,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         bool m_isFixedTimeStep;
         uint64_t m_targetElapsedTicks;
 
+        // Members for adaptive frame pacing and jitter measurement.  The
+        // refresh period is measured from display sync times, and is 0 until
+        // two of them have been seen.
+        bool m_isAdaptivePacing;
+        int64_t m_refreshPeriod;
+        int64_t m_lastSyncTime;
+        uint32_t m_lastSyncRefreshCount;
+        int64_t m_pacingError;
+        uint64_t m_averageTimeDelta;
+        uint64_t m_frameTimeJitter;
+
     public:
         StepTimer(std::shared_ptr<ICanvasTimingAdapter> adapter);
 
@@ -104,6 +115,39 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             return m_targetElapsedTicks; 
         }
 
+        // Set whether to snap time deltas to whole display refresh periods.
+        void SetAdaptivePacing(bool isAdaptivePacing)
+        {
+            m_isAdaptivePacing = isAdaptivePacing;
+        }
+
+        bool IsAdaptivePacing() const
+        {
+            return m_isAdaptivePacing;
+        }
+
+        // Records the QPC time of a display refresh and the number of
+        // refreshes so far, as reported by DXGI frame statistics.
+        void AddDisplaySync(int64_t syncTime, uint32_t syncRefreshCount);
+
+        // Get the measured display refresh period in QPC units, or 0 if it
+        // isn't known yet.
+        int64_t GetRefreshPeriod() const
+        {
+            return m_refreshPeriod;
+        }
+
+        // Get the smoothed deviation of recent time deltas from a whole
+        // number of refresh periods, or from their average if the refresh
+        // period isn't known.
+        uint64_t GetFrameTimeJitterTicks() const
+        {
+            return m_frameTimeJitter;
+        }
+
+        // Get the performance counter value at which the next Update is due.
+        int64_t GetNextTickTime() const;
+
         // Integer format represents time using 10,000,000 ticks per second.
         static const uint64_t TicksPerSecond = 10000000;
 
@@ -154,6 +198,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 timeDelta = m_maxDelta;
             }
 
+            timeDelta = MeasureAndPace(timeDelta);
+
             // Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
             timeDelta *= TicksPerSecond;
             timeDelta /= m_frequency;
@@ -237,5 +283,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 m_secondCounter %= m_frequency;
             }
         }
+
+    private:
+        // Updates the jitter measurement with a time delta, in QPC units,
+        // and returns the delta to use.  With adaptive pacing, deltas close
+        // to a whole number of refresh periods are snapped to it, so that
+        // QPC noise doesn't make fixed timestep updates drift in and out of
+        // phase with the display.  The error this introduces is carried
+        // over, so the timer never gets more than half a period away from
+        // the real time.
+        uint64_t MeasureAndPace(uint64_t timeDelta);
     };
 }}}}}}
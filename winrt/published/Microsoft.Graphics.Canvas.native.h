@@ -40,6 +40,35 @@ namespace ABI
                 public:
                     IFACEMETHOD(GetNativeResource)(ICanvasDevice* device, float dpi, REFIID iid, void** resource) = 0;
                 };
+
+                //
+                // Interface provided by CanvasDrawingSession for drawing text
+                // that the caller already has in a UTF-16 buffer.  The buffer
+                // does not need to be null terminated, and is only read
+                // during the call.  brush must be an ICanvasBrush; format may
+                // be null, or an ICanvasTextFormat.
+                //
+                class __declspec(uuid("8F2C7A4E-3B9D-4C61-A5E8-1D07F6B2C934"))
+                ICanvasDrawingSessionNative : public IUnknown
+                {
+                public:
+                    IFACEMETHOD(DrawTextFromBufferAtPoint)(wchar_t const* text, UINT32 textLength, float x, float y, IUnknown* brush, IUnknown* format) = 0;
+                    IFACEMETHOD(DrawTextFromBufferAtRect)(wchar_t const* text, UINT32 textLength, float x, float y, float w, float h, IUnknown* brush, IUnknown* format) = 0;
+                };
+
+                //
+                // Interface provided by the CanvasTextLayout factory for
+                // creating a layout from a UTF-16 buffer.  The buffer does
+                // not need to be null terminated; DirectWrite keeps its own
+                // copy of the text.  resourceCreator must be an
+                // ICanvasResourceCreator and textFormat an ICanvasTextFormat.
+                //
+                class __declspec(uuid("2D6E9B13-7C4A-4F85-B0D2-9A3E51C8F607"))
+                ICanvasTextLayoutFactoryNative : public IInspectable
+                {
+                public:
+                    IFACEMETHOD(CreateFromBuffer)(IUnknown* resourceCreator, wchar_t const* text, UINT32 textLength, IUnknown* textFormat, float requestedWidth, float requestedHeight, IInspectable** textLayout) = 0;
+                };
             }
         }
     }
@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+using namespace Microsoft::Graphics::Canvas::Effects;
+
+//
+// Throughput benchmarks for the main rendering paths, run against a real
+// device.  Each benchmark repeats its body until it has run for a fixed
+// amount of time, and reports how many items per second it got through.
+// Work that goes to the GPU is waited for, by reading back a pixel, so
+// the numbers include GPU time as well as Win2D's CPU overhead.
+//
+// Results are written to the test log, and when the class finishes to
+// benchmarks.json in the app's local folder.  The file's format is kept
+// stable (results sorted by name, fixed set of fields) so that runs from
+// different releases can be compared by a script:
+//
+//     { "version": 1, "benchmarks": [
+//         { "name": "...", "iterations": N, "itemsPerIteration": N,
+//           "microsecondsPerIteration": X, "itemsPerSecond": X }, ... ] }
+//
+// The benchmarks are in the "Benchmark" category, so they can be
+// included or excluded from a test run with a category filter.
+//
+
+#define BENCHMARK(NAME)                                         \
+    BEGIN_TEST_METHOD_ATTRIBUTE(NAME)                           \
+        TEST_METHOD_ATTRIBUTE(L"Category", L"Benchmark")        \
+    END_TEST_METHOD_ATTRIBUTE()                                 \
+    TEST_METHOD(NAME)
+
+TEST_CLASS(Benchmarks)
+{
+    struct Result
+    {
+        std::wstring Name;
+        uint64_t Iterations;
+        uint32_t ItemsPerIteration;
+        double MicrosecondsPerIteration;
+        double ItemsPerSecond;
+    };
+
+    static std::vector<Result>& GetResults()
+    {
+        static std::vector<Result> results;
+        return results;
+    }
+
+    static double GetSeconds()
+    {
+        LARGE_INTEGER counter;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&counter);
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+    }
+
+    static void Run(wchar_t const* name, uint32_t itemsPerIteration, std::function<void()> const& iteration)
+    {
+        double const minimumSeconds = 0.25;
+        uint64_t const minimumIterations = 3;
+
+        // The first iteration warms up caches and lazily created resources.
+        iteration();
+
+        uint64_t iterations = 0;
+        double start = GetSeconds();
+        double elapsed = 0;
+
+        while (iterations < minimumIterations || elapsed < minimumSeconds)
+        {
+            iteration();
+            ++iterations;
+            elapsed = GetSeconds() - start;
+        }
+
+        Result result
+        {
+            name,
+            iterations,
+            itemsPerIteration,
+            elapsed * 1000000 / iterations,
+            iterations * itemsPerIteration / elapsed
+        };
+
+        GetResults().push_back(result);
+
+        Logger::WriteMessage(ToJson(result).c_str());
+    }
+
+    static std::wstring ToJson(Result const& result)
+    {
+        wchar_t buffer[512];
+
+        ThrowIfFailed(StringCchPrintf(
+            buffer,
+            _countof(buffer),
+            L"{ \"name\": \"%s\", \"iterations\": %llu, \"itemsPerIteration\": %u, \"microsecondsPerIteration\": %.3f, \"itemsPerSecond\": %.3f }",
+            result.Name.c_str(),
+            result.Iterations,
+            result.ItemsPerIteration,
+            result.MicrosecondsPerIteration,
+            result.ItemsPerSecond));
+
+        return buffer;
+    }
+
+    // Blocks until the GPU has finished drawing to the render target.
+    static void WaitForGpu(CanvasRenderTarget^ renderTarget)
+    {
+        renderTarget->GetPixelBytes(0, 0, 1, 1);
+    }
+
+    CanvasDevice^ m_device;
+    CanvasRenderTarget^ m_renderTarget;
+
+public:
+    Benchmarks()
+        : m_device(ref new CanvasDevice())
+    {
+        m_renderTarget = ref new CanvasRenderTarget(m_device, 512, 512, DEFAULT_DPI);
+    }
+
+    TEST_CLASS_CLEANUP(WriteResults)
+    {
+        auto& results = GetResults();
+
+        if (results.empty())
+            return;
+
+        std::sort(results.begin(), results.end(), [](Result const& a, Result const& b) { return a.Name < b.Name; });
+
+        std::wstring json = L"{ \"version\": 1, \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            json += L"    " + ToJson(results[i]);
+            json += (i + 1 < results.size()) ? L",\n" : L"\n";
+        }
+
+        json += L"] }\n";
+
+        auto path = std::wstring(Windows::Storage::ApplicationData::Current->LocalFolder->Path->Data()) + L"\\benchmarks.json";
+
+        FILE* file;
+        if (_wfopen_s(&file, path.c_str(), L"w") == 0)
+        {
+            fputws(json.c_str(), file);
+            fclose(file);
+        }
+
+        Logger::WriteMessage((L"Benchmark results written to " + path).c_str());
+    }
+
+    BENCHMARK(Benchmark_DrawingSession_FillRectangle)
+    {
+        uint32_t const count = 1000;
+
+        Run(L"DrawingSession_FillRectangle", count, [&]
+        {
+            auto ds = m_renderTarget->CreateDrawingSession();
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ds->FillRectangle(static_cast<float>(i % 500), static_cast<float>(i / 2 % 500), 10, 10, Windows::UI::Colors::CornflowerBlue);
+            }
+
+            delete ds;
+            WaitForGpu(m_renderTarget);
+        });
+    }
+
+    BENCHMARK(Benchmark_DrawingSession_DrawLine)
+    {
+        uint32_t const count = 1000;
+
+        Run(L"DrawingSession_DrawLine", count, [&]
+        {
+            auto ds = m_renderTarget->CreateDrawingSession();
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                float x = static_cast<float>(i % 512);
+                ds->DrawLine(x, 0, 511 - x, 511, Windows::UI::Colors::Black, 2);
+            }
+
+            delete ds;
+            WaitForGpu(m_renderTarget);
+        });
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    void RunSpriteBatchBenchmark(wchar_t const* name, CanvasSpriteSortMode sortMode)
+    {
+        if (!CanvasSpriteBatch::IsSupported(m_device))
+            return;
+
+        uint32_t const count = 10000;
+        uint32_t const bitmapCount = 4;
+
+        std::vector<CanvasBitmap^> bitmaps;
+
+        for (uint32_t i = 0; i < bitmapCount; i++)
+        {
+            bitmaps.push_back(ref new CanvasRenderTarget(m_device, 16, 16, DEFAULT_DPI));
+        }
+
+        Run(name, count, [&]
+        {
+            auto ds = m_renderTarget->CreateDrawingSession();
+            auto spriteBatch = ds->CreateSpriteBatch(sortMode);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                // Interleave the bitmaps, so that sorting has something to do.
+                spriteBatch->Draw(bitmaps[i % bitmapCount], float2(static_cast<float>(i % 496), static_cast<float>(i / 3 % 496)));
+            }
+
+            delete spriteBatch;
+            delete ds;
+            WaitForGpu(m_renderTarget);
+        });
+    }
+
+    BENCHMARK(Benchmark_SpriteBatch_Immediate)
+    {
+        RunSpriteBatchBenchmark(L"SpriteBatch_Immediate", CanvasSpriteSortMode::None);
+    }
+
+    BENCHMARK(Benchmark_SpriteBatch_SortByBitmap)
+    {
+        RunSpriteBatchBenchmark(L"SpriteBatch_SortByBitmap", CanvasSpriteSortMode::Bitmap);
+    }
+
+#endif
+
+    static ICanvasImage^ CreateEffectGraph(ICanvasImage^ source)
+    {
+        auto blur = ref new GaussianBlurEffect();
+        blur->Source = source;
+        blur->BlurAmount = 4;
+
+        auto saturation = ref new SaturationEffect();
+        saturation->Source = blur;
+        saturation->Saturation = 0.5f;
+
+        auto transform = ref new Transform2DEffect();
+        transform->Source = saturation;
+        transform->TransformMatrix = make_float3x2_rotation(0.1f);
+
+        auto composite = ref new CompositeEffect();
+        composite->Sources->Append(transform);
+        composite->Sources->Append(source);
+
+        return composite;
+    }
+
+    BENCHMARK(Benchmark_Effects_RealizeAndDraw)
+    {
+        auto source = ref new CanvasRenderTarget(m_device, 256, 256, DEFAULT_DPI);
+
+        Run(L"Effects_RealizeAndDraw", 1, [&]
+        {
+            // A new graph every time, so each draw has to realize it.
+            auto effect = CreateEffectGraph(source);
+
+            auto ds = m_renderTarget->CreateDrawingSession();
+            ds->DrawImage(effect);
+            delete ds;
+
+            WaitForGpu(m_renderTarget);
+        });
+    }
+
+    BENCHMARK(Benchmark_Effects_Redraw)
+    {
+        auto source = ref new CanvasRenderTarget(m_device, 256, 256, DEFAULT_DPI);
+        auto effect = CreateEffectGraph(source);
+
+        Run(L"Effects_Redraw", 1, [&]
+        {
+            auto ds = m_renderTarget->CreateDrawingSession();
+            ds->DrawImage(effect);
+            delete ds;
+
+            WaitForGpu(m_renderTarget);
+        });
+    }
+
+    BENCHMARK(Benchmark_Bitmap_GetPixelBytes)
+    {
+        auto bitmap = ref new CanvasRenderTarget(m_device, 1024, 1024, DEFAULT_DPI);
+
+        Run(L"Bitmap_GetPixelBytes", 1024 * 1024 * 4, [&]
+        {
+            bitmap->GetPixelBytes();
+        });
+    }
+
+    BENCHMARK(Benchmark_Bitmap_SetPixelBytes)
+    {
+        auto bitmap = ref new CanvasRenderTarget(m_device, 1024, 1024, DEFAULT_DPI);
+        auto bytes = ref new Platform::Array<byte>(1024 * 1024 * 4);
+
+        Run(L"Bitmap_SetPixelBytes", bytes->Length, [&]
+        {
+            bitmap->SetPixelBytes(bytes);
+            WaitForGpu(bitmap);
+        });
+    }
+
+    BENCHMARK(Benchmark_Bitmap_Decode)
+    {
+        Run(L"Bitmap_Decode", 1, [&]
+        {
+            WaitExecution(CanvasBitmap::LoadAsync(m_device, L"Assets/imageTiger.jpg"));
+        });
+    }
+
+    BENCHMARK(Benchmark_TextLayout_Create)
+    {
+        uint32_t const count = 100;
+
+        auto format = ref new CanvasTextFormat();
+        auto text = L"The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs.";
+
+        Run(L"TextLayout_Create", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                auto layout = ref new CanvasTextLayout(m_device, ref new Platform::String(text), format, 200, 200);
+
+                // Force DWrite to actually lay out the text.
+                layout->LayoutBounds;
+            }
+        });
+    }
+
+    BENCHMARK(Benchmark_Geometry_Tessellate)
+    {
+        uint32_t const count = 100;
+
+        auto ellipse = CanvasGeometry::CreateEllipse(m_device, 100, 100, 100, 50);
+        auto outline = ellipse->Stroke(10);
+
+        Run(L"Geometry_Tessellate", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                outline->Tessellate();
+            }
+        });
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    BENCHMARK(Benchmark_Svg_Load)
+    {
+        if (!CanvasSvgDocument::IsSupported(m_device))
+            return;
+
+        std::wstring xml = L"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"512\" height=\"512\">";
+
+        for (int i = 0; i < 100; i++)
+        {
+            xml += L"<rect x=\"" + std::to_wstring(i * 5) + L"\" y=\"" + std::to_wstring(i * 3) + L"\" width=\"20\" height=\"20\" fill=\"red\" stroke=\"blue\"/>";
+        }
+
+        xml += L"</svg>";
+
+        auto xmlString = ref new Platform::String(xml.c_str());
+
+        Run(L"Svg_Load", 1, [&]
+        {
+            CanvasSvgDocument::LoadFromXml(m_device, xmlString);
+        });
+    }
+
+#endif
+};
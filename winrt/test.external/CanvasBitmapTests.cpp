@@ -4,6 +4,10 @@
 
 #include "pch.h"
 
+#if WINVER > _WIN32_WINNT_WINBLUE
+#include <MemoryBuffer.h>
+#endif
+
 using Platform::String;
 using namespace Microsoft::Graphics::Canvas;
 using namespace Microsoft::WRL::Wrappers;
@@ -109,6 +113,107 @@ public:
             });
     }
 
+    TEST_METHOD(CanvasBitmap_LoadAsync_WithMaximumSize_DecodesScaledDown)
+    {
+        CanvasDevice^ canvasDevice = ref new CanvasDevice();
+
+        struct TestCase
+        {
+            BitmapSize MaximumSize;
+            unsigned ExpectedWidth;
+            unsigned ExpectedHeight;
+        } testCases[] =
+        {
+            { { 0, 0 },       testImageWidth, testImageHeight },    // No limit
+            { { 1000, 1000 }, testImageWidth, testImageHeight },    // Never scaled up
+            { { 98, 0 },      98, 74 },                             // Width only
+            { { 0, 49 },      65, 49 },                             // Height only
+            { { 98, 49 },     65, 49 },                             // Fits within both
+        };
+
+        for (auto& testCase : testCases)
+        {
+            auto bitmap = WaitExecution(CanvasBitmap::LoadAsync(canvasDevice, L"Assets/imageTiger.jpg", DEFAULT_DPI, CanvasAlphaMode::Premultiplied, testCase.MaximumSize));
+
+            Assert::AreEqual(testCase.ExpectedWidth, bitmap->SizeInPixels.Width);
+            Assert::AreEqual(testCase.ExpectedHeight, bitmap->SizeInPixels.Height);
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_LoadManyAsync_ReturnsBitmapsInSourceOrder)
+    {
+        CanvasDevice^ canvasDevice = ref new CanvasDevice();
+
+        auto fileNames = ref new Platform::Collections::Vector<Platform::String^>();
+
+        for (int i = 0; i < 3; i++)
+        {
+            fileNames->Append(L"Images/x.bmp");
+            fileNames->Append(L"Assets/imageTiger.jpg");
+        }
+
+        auto bitmaps = WaitExecution(CanvasBitmap::LoadManyAsync(canvasDevice, fileNames));
+
+        Assert::AreEqual(fileNames->Size, bitmaps->Size);
+
+        for (unsigned i = 0; i < bitmaps->Size; i++)
+        {
+            auto expected = WaitExecution(CanvasBitmap::LoadAsync(canvasDevice, fileNames->GetAt(i)));
+
+            Assert::AreEqual(expected->SizeInPixels.Width, bitmaps->GetAt(i)->SizeInPixels.Width);
+            Assert::AreEqual(expected->SizeInPixels.Height, bitmaps->GetAt(i)->SizeInPixels.Height);
+            Assert::AreEqual(canvasDevice, bitmaps->GetAt(i)->Device);
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_LoadManyAsync_ReportsEachItemToHandler)
+    {
+        CanvasDevice^ canvasDevice = ref new CanvasDevice();
+
+        auto fileNames = ref new Platform::Collections::Vector<Platform::String^>();
+        fileNames->Append(L"Images/x.bmp");
+        fileNames->Append(L"ThisImageFileDoesNotExist.jpg");
+        fileNames->Append(L"Images/x.tif");
+
+        std::vector<int> reportedIndices;
+        std::vector<HRESULT> reportedErrors(fileNames->Size, E_UNEXPECTED);
+
+        auto handler = ref new CanvasBitmapLoadedHandler(
+            [&](int index, CanvasBitmap^ bitmap, Windows::Foundation::HResult errorCode)
+            {
+                reportedIndices.push_back(index);
+                reportedErrors[index] = errorCode.Value;
+
+                Assert::AreEqual(SUCCEEDED(errorCode.Value), bitmap != nullptr);
+            });
+
+        auto bitmaps = WaitExecution(CanvasBitmap::LoadManyAsync(canvasDevice, fileNames, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, 2, handler));
+
+        std::sort(reportedIndices.begin(), reportedIndices.end());
+        Assert::IsTrue(reportedIndices == std::vector<int>({ 0, 1, 2 }));
+
+        Assert::AreEqual(S_OK, reportedErrors[0]);
+        Assert::AreEqual(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), reportedErrors[1]);
+        Assert::AreEqual(S_OK, reportedErrors[2]);
+
+        Assert::IsNotNull(bitmaps->GetAt(0));
+        Assert::IsNull(bitmaps->GetAt(1));
+        Assert::IsNotNull(bitmaps->GetAt(2));
+
+        // Without a handler, the first failure fails the whole operation.
+        ExpectCOMException(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND),
+            [&]
+            {
+                WaitExecution(CanvasBitmap::LoadManyAsync(canvasDevice, fileNames));
+            });
+
+        Assert::ExpectException<Platform::InvalidArgumentException^>(
+            [&]
+            {
+                CanvasBitmap::LoadManyAsync(canvasDevice, fileNames, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, -1, nullptr);
+            });
+    }
+
     TEST_METHOD(CanvasBitmap_LoadStreamAndUri)
     {
         CanvasDevice^ canvasDevice = ref new CanvasDevice();
@@ -374,6 +479,67 @@ public:
             });
     }
 
+    TEST_METHOD(CanvasBitmap_CreateFromBytesWithLayout_ConvertsToBgra)
+    {
+        auto device = ref new CanvasDevice();
+
+        Color red   { 255, 255, 0,   0   };
+        Color white { 255, 255, 255, 255 };
+        Color gray  { 255, 128, 128, 128 };
+
+        struct TestCase
+        {
+            CanvasBitmapSourceLayout Layout;
+            std::vector<BYTE> Bytes;
+            Color Expected;
+        } testCases[]
+        {
+            { CanvasBitmapSourceLayout::Rgba8, { 255, 0, 0, 255,  255, 0, 0, 255,  255, 0, 0, 255,  255, 0, 0, 255 }, red },
+            { CanvasBitmapSourceLayout::Bgr24, { 0, 0, 255,  0, 0, 255,  0, 0, 255,  0, 0, 255 }, red },
+            { CanvasBitmapSourceLayout::Rgb24, { 255, 0, 0,  255, 0, 0,  255, 0, 0,  255, 0, 0 }, red },
+            { CanvasBitmapSourceLayout::Gray8, { 128, 128, 128, 128 }, gray },
+            { CanvasBitmapSourceLayout::Nv12,  { 255, 255, 255, 255,  128, 128 }, white },
+        };
+
+        for (auto& testCase : testCases)
+        {
+            auto bytes = ref new Platform::Array<BYTE>(testCase.Bytes.data(), static_cast<unsigned>(testCase.Bytes.size()));
+
+            auto bitmap = CanvasBitmap::CreateFromBytesWithLayout(device, bytes, 2, 2, testCase.Layout, 120.0f);
+
+            Assert::AreEqual(DirectXPixelFormat::B8G8R8A8UIntNormalized, bitmap->Format);
+            Assert::AreEqual(120.0f, bitmap->Dpi);
+            Assert::AreEqual(2u, bitmap->SizeInPixels.Width);
+            Assert::AreEqual(2u, bitmap->SizeInPixels.Height);
+
+            // YCbCr conversion isn't exact, so allow a little rounding error.
+            for (auto color : bitmap->GetPixelColors())
+            {
+                Assert::AreEqual(testCase.Expected.A, color.A);
+                Assert::IsTrue(abs(testCase.Expected.R - color.R) <= 2);
+                Assert::IsTrue(abs(testCase.Expected.G - color.G) <= 2);
+                Assert::IsTrue(abs(testCase.Expected.B - color.B) <= 2);
+            }
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_CreateFromBytesWithLayout_InvalidArguments)
+    {
+        auto device = ref new CanvasDevice();
+
+        Assert::ExpectException<Platform::InvalidArgumentException^>(
+            [&]
+            {
+                CanvasBitmap::CreateFromBytesWithLayout(device, ref new Platform::Array<BYTE>(1), 16, 16, CanvasBitmapSourceLayout::Rgb24);
+            });
+
+        ExpectCOMException(E_INVALIDARG, L"NV12 image width & height must be a multiple of 2 pixels.",
+            [&]
+            {
+                CanvasBitmap::CreateFromBytesWithLayout(device, ref new Platform::Array<BYTE>(64), 3, 2, CanvasBitmapSourceLayout::Nv12);
+            });
+    }
+
     TEST_METHOD(CanvasBitmap_CreateFromColors_FailsIfArrayTooSmall)
     {
         auto device = ref new CanvasDevice();
@@ -507,6 +673,136 @@ public:
         }
     }
 
+    TEST_METHOD(CanvasBitmap_SaveAsync_InBands_MatchesWholeImageSave)
+    {
+        DisableDebugLayer disableDebug; // 6184116 causes the debug layer to fail when CanvasBitmap::SaveAsync is called
+        auto device = ref new CanvasDevice();
+        auto canvasBitmap = WaitExecution(CanvasBitmap::LoadAsync(device, testImageFileName));
+
+        auto wholeStream = ref new InMemoryRandomAccessStream();
+        WaitExecution(canvasBitmap->SaveAsync(wholeStream, CanvasBitmapFileFormat::Png));
+        wholeStream->Seek(0);
+
+        auto expectedPixels = WaitExecution(CanvasBitmap::LoadAsync(device, wholeStream))->GetPixelBytes();
+
+        // Bands that divide the height exactly, that don't, one row at a time, and the automatic choice.
+        int bandHeights[] = { 49, 10, 1, 0, testImageHeight * 2 };
+
+        for (auto bandHeight : bandHeights)
+        {
+            auto bandedStream = ref new InMemoryRandomAccessStream();
+            WaitExecution(canvasBitmap->SaveAsync(bandedStream, CanvasBitmapFileFormat::Png, 1.0f, bandHeight));
+            bandedStream->Seek(0);
+
+            auto reloaded = WaitExecution(CanvasBitmap::LoadAsync(device, bandedStream));
+
+            Assert::AreEqual<uint32_t>(testImageWidth, reloaded->SizeInPixels.Width);
+            Assert::AreEqual<uint32_t>(testImageHeight, reloaded->SizeInPixels.Height);
+
+            auto actualPixels = reloaded->GetPixelBytes();
+
+            Assert::AreEqual(expectedPixels->Length, actualPixels->Length);
+            Assert::AreEqual(0, memcmp(expectedPixels->Data, actualPixels->Data, actualPixels->Length));
+        }
+
+        // Every encoder accepts banded saves, including GIF, which falls back to saving the whole image.
+        CanvasBitmapFileFormat formats[] =
+        {
+            CanvasBitmapFileFormat::Jpeg,
+            CanvasBitmapFileFormat::Bmp,
+            CanvasBitmapFileFormat::Tiff,
+            CanvasBitmapFileFormat::Gif,
+            CanvasBitmapFileFormat::JpegXR,
+        };
+
+        for (auto format : formats)
+        {
+            auto stream = ref new InMemoryRandomAccessStream();
+            WaitExecution(canvasBitmap->SaveAsync(stream, format, 0.9f, 16));
+
+            auto bitmapDecoder = WaitExecution_RequiresWorkerThread(BitmapDecoder::CreateAsync(stream));
+            VerifyBitmapDecoderDimensionsMatchTestImage(bitmapDecoder);
+        }
+
+        Assert::ExpectException<Platform::InvalidArgumentException^>(
+            [&]
+            {
+                canvasBitmap->SaveAsync(ref new InMemoryRandomAccessStream(), CanvasBitmapFileFormat::Png, 1.0f, -1);
+            });
+    }
+
+    TEST_METHOD(CanvasBitmap_SaveAsync_WithEncoderOptions)
+    {
+        DisableDebugLayer disableDebug; // 6184116 causes the debug layer to fail when CanvasBitmap::SaveAsync is called
+        auto device = ref new CanvasDevice();
+        auto canvasBitmap = WaitExecution(CanvasBitmap::LoadAsync(device, testImageFileName));
+
+        auto noOptions = ref new Platform::Collections::Map<String^, Object^>();
+
+        // The fast preset works with every encoder, whether or not it has the options the preset uses.
+        CanvasBitmapFileFormat formats[] =
+        {
+            CanvasBitmapFileFormat::Bmp,
+            CanvasBitmapFileFormat::Png,
+            CanvasBitmapFileFormat::Jpeg,
+            CanvasBitmapFileFormat::Tiff,
+            CanvasBitmapFileFormat::Gif,
+            CanvasBitmapFileFormat::JpegXR,
+        };
+
+        for (auto format : formats)
+        {
+            auto stream = ref new InMemoryRandomAccessStream();
+            WaitExecution(canvasBitmap->SaveAsync(stream, format, 0.9f, CanvasBitmapEncoderPreset::Fast, noOptions));
+
+            auto bitmapDecoder = WaitExecution_RequiresWorkerThread(BitmapDecoder::CreateAsync(stream));
+            VerifyBitmapDecoderDimensionsMatchTestImage(bitmapDecoder);
+        }
+
+        // Explicit options override the preset, and are converted to the type the encoder expects.
+        auto pngOptions = ref new Platform::Collections::Map<String^, Object^>();
+        pngOptions->Insert(L"InterlaceOption", true);
+        pngOptions->Insert(L"FilterOption", static_cast<int>(WICPngFilterAdaptive));
+
+        auto pngStream = ref new InMemoryRandomAccessStream();
+        WaitExecution(canvasBitmap->SaveAsync(pngStream, CanvasBitmapFileFormat::Png, 1.0f, CanvasBitmapEncoderPreset::Fast, pngOptions));
+        pngStream->Seek(0);
+
+        auto expectedPixels = canvasBitmap->GetPixelBytes();
+        auto actualPixels = WaitExecution(CanvasBitmap::LoadAsync(device, pngStream))->GetPixelBytes();
+
+        Assert::AreEqual(expectedPixels->Length, actualPixels->Length);
+        Assert::AreEqual(0, memcmp(expectedPixels->Data, actualPixels->Data, actualPixels->Length));
+
+        auto jpegOptions = ref new Platform::Collections::Map<String^, Object^>();
+        jpegOptions->Insert(L"JpegYCrCbSubsampling", static_cast<uint8>(WICJpegYCrCbSubsampling444));
+
+        auto jpegStream = ref new InMemoryRandomAccessStream();
+        WaitExecution(canvasBitmap->SaveAsync(jpegStream, CanvasBitmapFileFormat::Jpeg, 0.9f, CanvasBitmapEncoderPreset::Default, jpegOptions));
+
+        VerifyBitmapDecoderDimensionsMatchTestImage(WaitExecution_RequiresWorkerThread(BitmapDecoder::CreateAsync(jpegStream)));
+
+        // Options the encoder doesn't have are an error.
+        auto unknownOptions = ref new Platform::Collections::Map<String^, Object^>();
+        unknownOptions->Insert(L"NotAnEncoderOption", 1);
+
+        ExpectCOMException(E_INVALIDARG, L"The image encoder does not have an option named 'NotAnEncoderOption'.",
+            [&]
+            {
+                WaitExecution(canvasBitmap->SaveAsync(ref new InMemoryRandomAccessStream(), CanvasBitmapFileFormat::Png, 1.0f, CanvasBitmapEncoderPreset::Default, unknownOptions));
+            });
+
+        // As are values that aren't numbers.
+        auto wrongTypeOptions = ref new Platform::Collections::Map<String^, Object^>();
+        wrongTypeOptions->Insert(L"InterlaceOption", L"yes");
+
+        Assert::ExpectException<Platform::InvalidArgumentException^>(
+            [&]
+            {
+                canvasBitmap->SaveAsync(ref new InMemoryRandomAccessStream(), CanvasBitmapFileFormat::Png, 1.0f, CanvasBitmapEncoderPreset::Default, wrongTypeOptions);
+            });
+    }
+
     TEST_METHOD(CanvasBitmap_SaveToFileAndStreamAsync_UseSpecifiedEncoder)
     {
         DisableDebugLayer disableDebug; // 6184116 causes the debug layer to fail when CanvasBitmap::SaveAsync is called
@@ -1187,6 +1483,252 @@ public:
         }
     }
 
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    TEST_METHOD(CanvasBitmap_MapPixels_MatchesGetPixelBytes)
+    {
+        using ::Windows::Foundation::IMemoryBufferByteAccess;
+
+        const int width = 8;
+        const int height = 9;
+        const int bytesPerPixel = 4;
+        Platform::Array<byte>^ imageData = ref new Platform::Array<byte>(width * height * bytesPerPixel);
+        for (auto i = 0u; i < imageData->Length; i++)
+        {
+            imageData[i] = ReferenceColorFromIndex<byte>(i);
+        }
+
+        auto canvasBitmap = CanvasBitmap::CreateFromBytes(
+            m_sharedDevice,
+            imageData,
+            width,
+            height,
+            DirectXPixelFormat::B8G8R8A8UIntNormalized,
+            DEFAULT_DPI,
+            CanvasAlphaMode::Premultiplied);
+
+        SignedRect testCases[] = {
+            SignedRect(0, 0, width, height),
+            SignedRect(1, 2, 3, 4),
+        };
+
+        for (SignedRect testCase : testCases)
+        {
+            auto expected = canvasBitmap->GetPixelBytes(testCase.Left, testCase.Top, testCase.Width, testCase.Height);
+            auto mappedPixels = canvasBitmap->MapPixels(testCase.Left, testCase.Top, testCase.Width, testCase.Height);
+
+            Assert::AreEqual<uint32_t>(testCase.Width, mappedPixels->SizeInPixels.Width);
+            Assert::AreEqual<uint32_t>(testCase.Height, mappedPixels->SizeInPixels.Height);
+            Assert::AreEqual(DirectXPixelFormat::B8G8R8A8UIntNormalized, mappedPixels->Format);
+
+            auto rowBytes = testCase.Width * bytesPerPixel;
+            auto stride = mappedPixels->Stride;
+            Assert::IsTrue(stride >= static_cast<uint32_t>(rowBytes));
+
+            auto reference = mappedPixels->CreateReference();
+
+            bool closedWasRaised = false;
+            reference->Closed += ref new TypedEventHandler<IMemoryBufferReference^, Platform::Object^>(
+                [&](IMemoryBufferReference^, Platform::Object^)
+                {
+                    closedWasRaised = true;
+                });
+
+            ComPtr<IMemoryBufferByteAccess> byteAccess;
+            ThrowIfFailed(reinterpret_cast<IInspectable*>(reference)->QueryInterface(IID_PPV_ARGS(&byteAccess)));
+
+            uint8_t* data;
+            uint32_t capacity;
+            ThrowIfFailed(byteAccess->GetBuffer(&data, &capacity));
+
+            Assert::AreEqual(capacity, reference->Capacity);
+            Assert::AreEqual<uint32_t>(stride * (testCase.Height - 1) + rowBytes, capacity);
+
+            for (int y = 0; y < testCase.Height; y++)
+            {
+                for (int x = 0; x < rowBytes; x++)
+                {
+                    Assert::AreEqual(expected[y * rowBytes + x], data[y * stride + x]);
+                }
+            }
+
+            // Closing the mapped pixels also closes the reference.
+            delete mappedPixels;
+
+            Assert::IsTrue(closedWasRaised);
+            Assert::AreEqual(0u, reference->Capacity);
+            Assert::AreEqual(RO_E_CLOSED, byteAccess->GetBuffer(&data, &capacity));
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_MapPixelsAsync_SeesTheBitmapAsItWasWhenCalled)
+    {
+        using ::Windows::Foundation::IMemoryBufferByteAccess;
+
+        auto renderTarget = ref new CanvasRenderTarget(m_sharedDevice, 4, 4, DEFAULT_DPI);
+
+        Color colors[] = { Colors::Red, Colors::Green, Colors::Blue };
+        std::vector<IAsyncOperation<CanvasMappedPixels^>^> operations;
+
+        // Queue up several readbacks, drawing in between them, before waiting for any.
+        for (auto color : colors)
+        {
+            auto drawingSession = renderTarget->CreateDrawingSession();
+            drawingSession->Clear(color);
+            delete drawingSession;
+
+            operations.push_back(renderTarget->MapPixelsAsync(1, 1, 2, 2));
+        }
+
+        for (size_t i = 0; i < operations.size(); i++)
+        {
+            auto mappedPixels = WaitExecution(operations[i]);
+
+            Assert::AreEqual<uint32_t>(2, mappedPixels->SizeInPixels.Width);
+            Assert::AreEqual<uint32_t>(2, mappedPixels->SizeInPixels.Height);
+
+            auto reference = mappedPixels->CreateReference();
+
+            ComPtr<IMemoryBufferByteAccess> byteAccess;
+            ThrowIfFailed(reinterpret_cast<IInspectable*>(reference)->QueryInterface(IID_PPV_ARGS(&byteAccess)));
+
+            uint8_t* data;
+            uint32_t capacity;
+            ThrowIfFailed(byteAccess->GetBuffer(&data, &capacity));
+
+            for (uint32_t y = 0; y < 2; y++)
+            {
+                for (uint32_t x = 0; x < 2; x++)
+                {
+                    auto pixel = data + y * mappedPixels->Stride + x * 4;
+
+                    Assert::AreEqual(colors[i].B, pixel[0]);
+                    Assert::AreEqual(colors[i].G, pixel[1]);
+                    Assert::AreEqual(colors[i].R, pixel[2]);
+                    Assert::AreEqual(colors[i].A, pixel[3]);
+                }
+            }
+
+            delete reference;
+            delete mappedPixels;
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_MapPixels_InvalidArguments)
+    {
+        auto canvasBitmap = ref new CanvasRenderTarget(m_sharedDevice, 1, 1, DEFAULT_DPI);
+
+        SignedRect testCases[] = {
+            SignedRect(0, 0, 0, 0),
+            SignedRect(0, 0, 2, 2),
+            SignedRect(-2, 3, 5, 4),
+            SignedRect(0, 0, -1, 3),
+        };
+
+        for (SignedRect testCase : testCases)
+        {
+            Assert::ExpectException<Platform::InvalidArgumentException^>(
+                [&]
+                {
+                    canvasBitmap->MapPixels(testCase.Left, testCase.Top, testCase.Width, testCase.Height);
+                });
+
+            Assert::ExpectException<Platform::InvalidArgumentException^>(
+                [&]
+                {
+                    canvasBitmap->MapPixelsAsync(testCase.Left, testCase.Top, testCase.Width, testCase.Height);
+                });
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_CopyPixelsToAndFromSoftwareBitmap)
+    {
+        using namespace Windows::Graphics::Imaging;
+
+        const int width = 8;
+        const int height = 9;
+
+        Platform::Array<byte>^ imageData = ref new Platform::Array<byte>(width * height * 4);
+        for (auto i = 0u; i < imageData->Length; i++)
+        {
+            imageData[i] = ReferenceColorFromIndex<byte>(i);
+        }
+
+        auto source = CanvasBitmap::CreateFromBytes(m_sharedDevice, imageData, width, height, DirectXPixelFormat::B8G8R8A8UIntNormalized);
+        auto softwareBitmap = ref new SoftwareBitmap(BitmapPixelFormat::Bgra8, width, height, BitmapAlphaMode::Premultiplied);
+
+        source->CopyPixelsToSoftwareBitmap(softwareBitmap);
+
+        auto destination = ref new CanvasRenderTarget(m_sharedDevice, width, height, DEFAULT_DPI);
+        destination->CopyPixelsFromSoftwareBitmap(softwareBitmap);
+
+        auto result = destination->GetPixelBytes();
+
+        for (auto i = 0u; i < imageData->Length; i++)
+        {
+            Assert::AreEqual(imageData[i], result[i]);
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_CopyPixelsToSoftwareBitmapAsync_SeesTheBitmapAsItWasWhenCalled)
+    {
+        using namespace Windows::Graphics::Imaging;
+
+        auto renderTarget = ref new CanvasRenderTarget(m_sharedDevice, 4, 4, DEFAULT_DPI);
+
+        Color colors[] = { Colors::Red, Colors::Green, Colors::Blue };
+        std::vector<SoftwareBitmap^> softwareBitmaps;
+        std::vector<IAsyncAction^> actions;
+
+        // Queue up several readbacks, drawing in between them, before waiting for any.
+        for (auto color : colors)
+        {
+            auto drawingSession = renderTarget->CreateDrawingSession();
+            drawingSession->Clear(color);
+            delete drawingSession;
+
+            auto softwareBitmap = ref new SoftwareBitmap(BitmapPixelFormat::Bgra8, 4, 4, BitmapAlphaMode::Premultiplied);
+
+            softwareBitmaps.push_back(softwareBitmap);
+            actions.push_back(renderTarget->CopyPixelsToSoftwareBitmapAsync(softwareBitmap));
+        }
+
+        for (size_t i = 0; i < actions.size(); i++)
+        {
+            WaitExecution(actions[i]);
+
+            auto bitmap = CanvasBitmap::CreateFromSoftwareBitmap(m_sharedDevice, softwareBitmaps[i]);
+            auto pixels = bitmap->GetPixelColors();
+
+            for (auto pixel : pixels)
+            {
+                Assert::AreEqual(colors[i], pixel);
+            }
+        }
+    }
+
+    TEST_METHOD(CanvasBitmap_CopyPixelsToAndFromSoftwareBitmap_InvalidArguments)
+    {
+        using namespace Windows::Graphics::Imaging;
+
+        auto canvasBitmap = ref new CanvasRenderTarget(m_sharedDevice, 4, 4, DEFAULT_DPI);
+
+        SoftwareBitmap^ testCases[] = {
+            nullptr,
+            ref new SoftwareBitmap(BitmapPixelFormat::Bgra8, 4, 5, BitmapAlphaMode::Premultiplied),
+            ref new SoftwareBitmap(BitmapPixelFormat::Rgba8, 4, 4, BitmapAlphaMode::Premultiplied),
+        };
+
+        for (auto testCase : testCases)
+        {
+            Assert::ExpectException<Platform::InvalidArgumentException^>([&] { canvasBitmap->CopyPixelsFromSoftwareBitmap(testCase); });
+            Assert::ExpectException<Platform::InvalidArgumentException^>([&] { canvasBitmap->CopyPixelsToSoftwareBitmap(testCase); });
+            Assert::ExpectException<Platform::InvalidArgumentException^>([&] { canvasBitmap->CopyPixelsToSoftwareBitmapAsync(testCase); });
+        }
+    }
+
+#endif
+
     TEST_METHOD(CanvasRenderTarget_SetPixelBytes_InvalidArraySize_ThrowsDescriptiveException)
     {
         auto rt = ref new CanvasRenderTarget(m_sharedDevice, 2, 2, DEFAULT_DPI);
@@ -1332,6 +1874,60 @@ public:
         bitmap->SetPixelBytes(data);
     }
 
+    TEST_METHOD(CanvasBitmap_GetAndSetPixelBytesWithAlphaMode_ConvertAlpha)
+    {
+        auto bitmap = ref new CanvasRenderTarget(m_sharedDevice, 2, 1, DEFAULT_DPI, DirectXPixelFormat::B8G8R8A8UIntNormalized, CanvasAlphaMode::Premultiplied);
+
+        uint8_t straight[] = { 200, 100, 50, 128, 10, 20, 30, 0 };
+        uint8_t premultiplied[] = { 100, 50, 25, 128, 0, 0, 0, 0 };
+        uint8_t straightAgain[] = { 199, 100, 50, 128, 0, 0, 0, 0 };
+
+        bitmap->SetPixelBytes(ref new Platform::Array<uint8_t>(straight, _countof(straight)), CanvasAlphaMode::Straight);
+
+        AssertPixelValues(AsArrayReference(premultiplied), bitmap->GetPixelBytes());
+
+        auto buffer = ref new Buffer(_countof(straight));
+        bitmap->GetPixelBytes(buffer, CanvasAlphaMode::Straight);
+
+        auto bytes = ref new Platform::Array<uint8_t>(buffer->Length);
+        DataReader::FromBuffer(buffer)->ReadBytes(bytes);
+
+        AssertPixelValues(AsArrayReference(straightAgain), bytes);
+
+        // Matching alpha modes, or Ignore, copy the bytes unchanged.
+        bitmap->SetPixelBytes(ref new Platform::Array<uint8_t>(straight, _countof(straight)), CanvasAlphaMode::Premultiplied);
+        AssertPixelValues(AsArrayReference(straight), bitmap->GetPixelBytes());
+
+        bitmap->GetPixelBytes(buffer, CanvasAlphaMode::Ignore);
+        DataReader::FromBuffer(buffer)->ReadBytes(bytes);
+        AssertPixelValues(AsArrayReference(straight), bytes);
+    }
+
+    TEST_METHOD(CanvasBitmap_PixelBytesWithAlphaMode_InvalidPixelFormat_ThrowsDescriptiveException)
+    {
+        auto rt = ref new CanvasRenderTarget(m_sharedDevice, 1, 1, DEFAULT_DPI, DirectXPixelFormat::R16G16B16A16Float, CanvasAlphaMode::Premultiplied);
+        auto bytes = ref new Platform::Array<uint8_t>(8);
+        auto buffer = ref new Buffer(8);
+
+        const wchar_t* expectedMessage = L"Converting between alpha modes is only supported for resources with pixel format DirectXPixelFormat.B8G8R8A8UIntNormalized or DirectXPixelFormat.R8G8B8A8UIntNormalized.";
+
+        ExpectCOMException(E_INVALIDARG, expectedMessage,
+            [&]
+            {
+                rt->SetPixelBytes(bytes, CanvasAlphaMode::Straight);
+            });
+
+        ExpectCOMException(E_INVALIDARG, expectedMessage,
+            [&]
+            {
+                rt->GetPixelBytes(buffer, CanvasAlphaMode::Straight);
+            });
+
+        // No conversion is needed, so this works on any format.
+        rt->SetPixelBytes(bytes, CanvasAlphaMode::Premultiplied);
+        rt->GetPixelBytes(buffer, CanvasAlphaMode::Ignore);
+    }
+
     TEST_METHOD(CanvasBitmap_SetPixelColors_AcceptsArraysLargerThanRequired)
     {
         auto width = 256;
@@ -5,6 +5,8 @@
 #include "pch.h"
 
 using Windows::Foundation::Rect;
+using Windows::Foundation::Numerics::float2;
+using Windows::Foundation::Numerics::float3x2;
 
 TEST_CLASS(CanvasCommandListTests)
 {
@@ -114,6 +116,236 @@ public:
         delete drawingSession;
     }
 
+    TEST_METHOD(CanvasCommandList_SpatialIndex_DrawingPartOfCommandListMatchesUnculledResult)
+    {
+        auto device = ref new CanvasDevice();
+
+        auto createCommandList = [&](bool isSpatialIndexEnabled)
+        {
+            auto commandList = ref new CanvasCommandList(device);
+            commandList->IsSpatialIndexEnabled = isSpatialIndexEnabled;
+
+            auto ds = commandList->CreateDrawingSession();
+
+            for (int y = 0; y < 16; y++)
+            {
+                for (int x = 0; x < 16; x++)
+                {
+                    auto color = Windows::UI::ColorHelper::FromArgb(255, (uint8_t)(x * 16), (uint8_t)(y * 16), 128);
+                    ds->FillRectangle(Rect{ (float)x * 8, (float)y * 8, 8, 8 }, color);
+                }
+            }
+
+            ds->DrawLine(0, 0, 128, 128, Windows::UI::Colors::White, 3);
+
+            delete ds;
+
+            return commandList;
+        };
+
+        auto drawPart = [&](CanvasCommandList^ commandList, Rect sourceRect)
+        {
+            auto renderTarget = ref new CanvasRenderTarget(device, 32, 32, DEFAULT_DPI);
+            auto ds = renderTarget->CreateDrawingSession();
+
+            ds->Clear(Windows::UI::Colors::Transparent);
+            ds->DrawImage(commandList, Rect{ 0, 0, 32, 32 }, sourceRect);
+
+            delete ds;
+
+            return renderTarget->GetPixelColors();
+        };
+
+        auto unculled = createCommandList(false);
+        auto culled = createCommandList(true);
+
+        Assert::IsFalse(unculled->IsSpatialIndexEnabled);
+        Assert::IsTrue(culled->IsSpatialIndexEnabled);
+
+        Rect sourceRects[] =
+        {
+            Rect{ 20, 30, 16, 16 },
+            Rect{ 20, 30, 16, 16 },     // Same again, to reuse the cached culling
+            Rect{ 100, 4, 32, 32 },
+            Rect{ -8, -8, 200, 200 },   // Contains everything, so nothing is culled
+        };
+
+        for (auto sourceRect : sourceRects)
+        {
+            auto expected = drawPart(unculled, sourceRect);
+            auto actual = drawPart(culled, sourceRect);
+
+            Assert::AreEqual(expected->Length, actual->Length);
+
+            for (unsigned i = 0; i < expected->Length; i++)
+            {
+                Assert::AreEqual(expected[i], actual[i]);
+            }
+        }
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    static Platform::Array<Windows::UI::Color>^ RenderCommandList(CanvasDevice^ device, CanvasCommandList^ commandList)
+    {
+        auto renderTarget = ref new CanvasRenderTarget(device, 64, 64, DEFAULT_DPI);
+        auto ds = renderTarget->CreateDrawingSession();
+
+        ds->Clear(Windows::UI::Colors::Transparent);
+        ds->DrawImage(commandList);
+
+        delete ds;
+
+        return renderTarget->GetPixelColors();
+    }
+
+    TEST_METHOD(CanvasCommandList_Serialization_RoundTripProducesSamePixels)
+    {
+        auto device = ref new CanvasDevice();
+
+        auto bitmapColors = ref new Platform::Array<Windows::UI::Color>(16);
+        for (unsigned i = 0; i < bitmapColors->Length; i++)
+            bitmapColors[i] = Windows::UI::ColorHelper::FromArgb(255, (uint8_t)(i * 16), 0, 255);
+
+        auto bitmap = CanvasBitmap::CreateFromColors(device, bitmapColors, 4, 4);
+
+        auto nested = ref new CanvasCommandList(device);
+        auto nestedDs = nested->CreateDrawingSession();
+        nestedDs->FillCircle(8, 8, 6, Windows::UI::Colors::Yellow);
+        delete nestedDs;
+
+        auto strokeStyle = ref new CanvasStrokeStyle();
+        strokeStyle->DashStyle = CanvasDashStyle::Dash;
+        strokeStyle->LineJoin = CanvasLineJoin::Round;
+
+        auto gradient = ref new CanvasLinearGradientBrush(device, Windows::UI::Colors::Red, Windows::UI::Colors::Blue);
+        gradient->StartPoint = float2{ 0, 0 };
+        gradient->EndPoint = float2{ 64, 0 };
+
+        auto original = ref new CanvasCommandList(device);
+        auto ds = original->CreateDrawingSession();
+
+        ds->FillRectangle(Rect{ 0, 0, 64, 16 }, gradient);
+        ds->DrawLine(0, 20, 64, 24, Windows::UI::Colors::Green, 3, strokeStyle);
+        ds->DrawLine(0, 28, 64, 28, Windows::UI::Colors::Green, 3, strokeStyle);
+        ds->FillEllipse(32, 40, 10, 6, gradient);
+        ds->Transform = float3x2{ 1, 0, 0, 1, 4, 44 };
+        ds->DrawImage(bitmap, Rect{ 0, 0, 16, 16 });
+        ds->DrawImage(nested, 20, 0);
+        ds->DrawImage(nested, 40, 0);
+
+        delete ds;
+
+        auto bytes = original->GetSerializedBytes();
+        auto copy = CanvasCommandList::CreateFromSerializedBytes(device, bytes);
+
+        auto expected = RenderCommandList(device, original);
+        auto actual = RenderCommandList(device, copy);
+
+        for (unsigned i = 0; i < expected->Length; i++)
+        {
+            Assert::AreEqual(expected[i], actual[i]);
+        }
+    }
+
+    TEST_METHOD(CanvasCommandList_Serialization_SharedResourcesAreOnlyStoredOnce)
+    {
+        auto device = ref new CanvasDevice();
+
+        auto bitmap = ref new CanvasRenderTarget(device, 128, 128, DEFAULT_DPI);
+
+        auto drawBitmap = [&](int count)
+        {
+            auto commandList = ref new CanvasCommandList(device);
+            auto ds = commandList->CreateDrawingSession();
+
+            for (int i = 0; i < count; i++)
+                ds->DrawImage(bitmap, (float)i, 0);
+
+            delete ds;
+
+            return commandList->GetSerializedBytes()->Length;
+        };
+
+        auto oneDraw = drawBitmap(1);
+        auto tenDraws = drawBitmap(10);
+
+        // 128x128 BGRA pixels are 64k, so storing the bitmap more than once would be obvious.
+        Assert::IsTrue(oneDraw > 128 * 128 * 4);
+        Assert::IsTrue(tenDraws < oneDraw + 4096);
+    }
+
+    TEST_METHOD(CanvasCommandList_Serialization_TextIsStoredAsOutlines)
+    {
+        auto device = ref new CanvasDevice();
+
+        auto original = ref new CanvasCommandList(device);
+        auto ds = original->CreateDrawingSession();
+        ds->DrawText(L"Win2D", 0, 0, Windows::UI::Colors::White);
+        delete ds;
+
+        auto copy = CanvasCommandList::CreateFromSerializedBytes(device, original->GetSerializedBytes());
+
+        auto expectedBounds = original->GetBounds(device);
+        auto actualBounds = copy->GetBounds(device);
+
+        // Outlines cover roughly the same area as the antialiased glyphs.
+        Assert::IsTrue(actualBounds.Width > 0 && actualBounds.Height > 0);
+        Assert::AreEqual(expectedBounds.X, actualBounds.X, 2.0f);
+        Assert::AreEqual(expectedBounds.Width, actualBounds.Width, 4.0f);
+    }
+
+    TEST_METHOD(CanvasCommandList_Serialization_FailsForEffects)
+    {
+        auto device = ref new CanvasDevice();
+
+        auto commandList = ref new CanvasCommandList(device);
+        auto ds = commandList->CreateDrawingSession();
+
+        auto effect = ref new Microsoft::Graphics::Canvas::Effects::ColorSourceEffect();
+        ds->DrawImage(effect);
+
+        delete ds;
+
+        ExpectCOMException(E_INVALIDARG,
+            L"This CanvasCommandList contains drawing commands that cannot be serialized. Effects, meshes, ink, gradient meshes, sprite batches and GDI metafiles are not supported.",
+            [&]
+            {
+                commandList->GetSerializedBytes();
+            });
+    }
+
+    TEST_METHOD(CanvasCommandList_Serialization_FailsForInvalidData)
+    {
+        auto device = ref new CanvasDevice();
+
+        auto commandList = ref new CanvasCommandList(device);
+        auto ds = commandList->CreateDrawingSession();
+        ds->FillRectangle(0, 0, 10, 10, Windows::UI::Colors::Red);
+        delete ds;
+
+        auto bytes = commandList->GetSerializedBytes();
+
+        // A truncated copy should be rejected, not read past its end.
+        auto truncated = ref new Platform::Array<uint8_t>(bytes->Length - 4);
+        memcpy(truncated->Data, bytes->Data, truncated->Length);
+
+        auto garbage = ref new Platform::Array<uint8_t>(64);
+        memset(garbage->Data, 0xAB, garbage->Length);
+
+        for (auto invalid : { truncated, garbage })
+        {
+            ExpectCOMException(E_INVALIDARG,
+                L"The data is not a valid serialized CanvasCommandList.",
+                [&]
+                {
+                    CanvasCommandList::CreateFromSerializedBytes(device, invalid);
+                });
+        }
+    }
+
+#endif
+
     TEST_METHOD(CanvasCommandList_NestedBeginDraw)
     {
         auto device = ref new CanvasDevice();
@@ -128,4 +360,51 @@ public:
                 commandList->CreateDrawingSession();
             });
     }
+
+    TEST_METHOD(CanvasCommandList_RecordInParallelAsync_DrawsPartsInOrder)
+    {
+        int const partCount = 16;
+
+        auto renderTarget = ref new CanvasRenderTarget(m_device, static_cast<float>(partCount), 1, DEFAULT_DPI);
+
+        auto partColor = [](int index)
+        {
+            return Windows::UI::ColorHelper::FromArgb(255, static_cast<uint8_t>(index * 15), 0, static_cast<uint8_t>(255 - index * 15));
+        };
+
+        // Each part covers everything from its own column to the right edge,
+        // so if the parts are drawn in order, each column ends up with the
+        // color of the part with the same index.
+        auto commandList = WaitExecution(CanvasCommandList::RecordInParallelAsync(m_device, partCount,
+            ref new CanvasCommandListRecordingHandler(
+                [=](CanvasDrawingSession^ ds, int partIndex)
+                {
+                    ds->FillRectangle(static_cast<float>(partIndex), 0, static_cast<float>(partCount - partIndex), 1, partColor(partIndex));
+                })));
+
+        auto ds = renderTarget->CreateDrawingSession();
+        ds->Clear(Windows::UI::Colors::Transparent);
+        ds->DrawImage(commandList);
+        delete ds;
+
+        auto colors = renderTarget->GetPixelColors();
+
+        for (int i = 0; i < partCount; i++)
+        {
+            Assert::AreEqual(partColor(i), colors[i]);
+        }
+    }
+
+    TEST_METHOD(CanvasCommandList_RecordInParallelAsync_WhenAPartFails_OperationFails)
+    {
+        auto operation = CanvasCommandList::RecordInParallelAsync(m_device, 8,
+            ref new CanvasCommandListRecordingHandler(
+                [](CanvasDrawingSession^, int partIndex)
+                {
+                    if (partIndex == 3)
+                        throw ref new Platform::InvalidArgumentException();
+                }));
+
+        ExpectCOMException(E_INVALIDARG, [&] { WaitExecution(operation); });
+    }
 };
@@ -131,4 +131,23 @@ TEST_CLASS(CanvasDeviceTests)
             Assert::AreEqual(debugLevel, CanvasDevice::DebugLevel);
         }
     }
+
+    TEST_METHOD(CanvasDevice_InsertFence_CompletesOnceGpuHasFinished)
+    {
+        auto device = ref new CanvasDevice();
+        auto renderTarget = ref new CanvasRenderTarget(device, 256, 256, DEFAULT_DPI);
+
+        auto drawingSession = renderTarget->CreateDrawingSession();
+        drawingSession->Clear(Windows::UI::Colors::Red);
+        delete drawingSession;
+
+        auto fence = device->InsertFence();
+
+        WaitExecution(fence->WaitAsync());
+
+        Assert::IsTrue(fence->IsCompleted);
+
+        // Waiting again on a completed fence finishes straight away.
+        WaitExecution(fence->WaitAsync());
+    }
 };
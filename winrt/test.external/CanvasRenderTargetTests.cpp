@@ -8,6 +8,8 @@ using namespace Microsoft::Graphics::Canvas;
 using namespace Microsoft::WRL::Wrappers;
 using namespace WinRTDirectX;
 using namespace Windows::Foundation;
+using namespace Windows::Graphics::Imaging;
+using namespace Windows::Storage::Streams;
 using namespace Windows::UI;
 
 TEST_CLASS(CanvasRenderTargetTests)
@@ -103,4 +105,92 @@ TEST_CLASS(CanvasRenderTargetTests)
                 renderTarget->CreateDrawingSession();
             });
     }
+
+    static CanvasTiledRenderTarget^ CreateRedAndBlueTiledRenderTarget(CanvasDevice^ device)
+    {
+        // Red on the left, blue on the right, split halfway through the middle tile.
+        auto tiledRenderTarget = CanvasTiledRenderTarget::Create(device, 300, 50, DEFAULT_DPI, 100);
+
+        auto drawingSession = tiledRenderTarget->CreateDrawingSession();
+        drawingSession->FillRectangle(0, 0, 150, 50, Colors::Red);
+        delete drawingSession;
+
+        // A second session is drawn after the first.
+        drawingSession = tiledRenderTarget->CreateDrawingSession();
+        drawingSession->FillRectangle(150, 0, 150, 50, Colors::Blue);
+        delete drawingSession;
+
+        return tiledRenderTarget;
+    }
+
+    TEST_METHOD(CanvasTiledRenderTarget_RenderTilesAsync_ReplaysDrawingIntoEachTile)
+    {
+        auto device = ref new CanvasDevice();
+        auto tiledRenderTarget = CreateRedAndBlueTiledRenderTarget(device);
+
+        Assert::AreEqual(300u, tiledRenderTarget->SizeInPixels.Width);
+        Assert::AreEqual(50u, tiledRenderTarget->SizeInPixels.Height);
+        Assert::AreEqual(100, tiledRenderTarget->TileSizeInPixels);
+
+        std::vector<BitmapBounds> tiles;
+        std::vector<Color> leftColors;
+        std::vector<Color> rightColors;
+
+        WaitExecution(tiledRenderTarget->RenderTilesAsync(ref new CanvasTiledRenderTargetTileHandler(
+            [&](BitmapBounds bounds, CanvasRenderTarget^ tile)
+            {
+                auto colors = tile->GetPixelColors();
+
+                tiles.push_back(bounds);
+                leftColors.push_back(colors[0]);
+                rightColors.push_back(colors[bounds.Width - 1]);
+            })));
+
+        Assert::AreEqual<size_t>(3, tiles.size());
+
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            Assert::AreEqual(i * 100, tiles[i].X);
+            Assert::AreEqual(0u, tiles[i].Y);
+            Assert::AreEqual(100u, tiles[i].Width);
+            Assert::AreEqual(50u, tiles[i].Height);
+        }
+
+        Assert::AreEqual(Colors::Red, leftColors[0]);
+        Assert::AreEqual(Colors::Red, rightColors[0]);
+        Assert::AreEqual(Colors::Red, leftColors[1]);
+        Assert::AreEqual(Colors::Blue, rightColors[1]);
+        Assert::AreEqual(Colors::Blue, leftColors[2]);
+        Assert::AreEqual(Colors::Blue, rightColors[2]);
+    }
+
+    TEST_METHOD(CanvasTiledRenderTarget_SaveAsync_MatchesRenderTarget)
+    {
+        DisableDebugLayer disableDebug; // 6184116 causes the debug layer to fail when SaveAsync is called
+        auto device = ref new CanvasDevice();
+        auto tiledRenderTarget = CreateRedAndBlueTiledRenderTarget(device);
+
+        auto renderTarget = ref new CanvasRenderTarget(device, 300, 50, DEFAULT_DPI);
+        auto drawingSession = renderTarget->CreateDrawingSession();
+        drawingSession->Clear(Colors::Transparent);
+        drawingSession->FillRectangle(0, 0, 150, 50, Colors::Red);
+        drawingSession->FillRectangle(150, 0, 150, 50, Colors::Blue);
+        delete drawingSession;
+
+        auto expectedPixels = renderTarget->GetPixelBytes();
+
+        auto stream = ref new InMemoryRandomAccessStream();
+        WaitExecution(tiledRenderTarget->SaveAsync(stream, CanvasBitmapFileFormat::Png));
+        stream->Seek(0);
+
+        auto reloaded = WaitExecution(CanvasBitmap::LoadAsync(device, stream));
+
+        Assert::AreEqual(300u, reloaded->SizeInPixels.Width);
+        Assert::AreEqual(50u, reloaded->SizeInPixels.Height);
+
+        auto actualPixels = reloaded->GetPixelBytes();
+
+        Assert::AreEqual(expectedPixels->Length, actualPixels->Length);
+        Assert::AreEqual(0, memcmp(expectedPixels->Data, actualPixels->Data, actualPixels->Length));
+    }
 };
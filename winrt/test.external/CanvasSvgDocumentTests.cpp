@@ -131,6 +131,10 @@ public:
             {
                 m_document = CanvasSvgDocument::LoadFromXml(m_device, input);
             }
+            else if (loadMethod == 1)
+            {
+                m_document = CanvasSvgDocument::LoadFromXml(m_device, WrapStringInUtf8Buffer(input));
+            }
             else
             {
                 m_document = WaitExecution(CanvasSvgDocument::LoadAsync(m_device, WrapStringInInputStream(input)));
@@ -144,6 +148,10 @@ public:
             {
                 result = m_document->LoadElementFromXml(input);
             }
+            else if (loadMethod == 1)
+            {
+                result = m_document->LoadElementFromXml(WrapStringInUtf8Buffer(input));
+            }
             else
             {
                 result = WaitExecution(m_document->LoadElementAsync(WrapStringInInputStream(input)));
@@ -171,6 +179,15 @@ public:
         }
 
     private:
+        IBuffer^ WrapStringInUtf8Buffer(Platform::String^ input)
+        {
+            DataWriter^ dataWriter = ref new DataWriter();
+            dataWriter->UnicodeEncoding = UnicodeEncoding::Utf8;
+            dataWriter->WriteString(input);
+
+            return dataWriter->DetachBuffer();
+        }
+
         InMemoryRandomAccessStream^ WrapStringInInputStream(Platform::String^ input)
         {
             InMemoryRandomAccessStream^ memoryStream = ref new InMemoryRandomAccessStream();
@@ -220,7 +237,7 @@ public:
             }
         };
 
-        for (int loadMethod = 0; loadMethod < 2; loadMethod++)
+        for (int loadMethod = 0; loadMethod < 3; loadMethod++)
         {
             for (int saveMethod = 0; saveMethod < 2; saveMethod++)
             {
@@ -285,7 +302,7 @@ public:
             }
         };
 
-        for (int loadMethod = 0; loadMethod < 2; loadMethod++)
+        for (int loadMethod = 0; loadMethod < 3; loadMethod++)
         {
             for (auto const& testCase : testCases)
             {
@@ -49,6 +49,23 @@ public:
         Assert::AreEqual(4.0f, bitmapFromStream->Size.Height);
     }
 
+    TEST_METHOD(CanvasVirtualBitmap_LoadFromFileName_CanBeOpenedMoreThanOnce)
+    {
+        //
+        // Bitmaps loaded from a file name decode from a mapped view of it
+        // that stays open for as long as the bitmap does, so check this
+        // doesn't stop the same file being loaded again meanwhile.
+        //
+        auto first = WaitExecution(CanvasVirtualBitmap::LoadAsync(m_device, "Assets/HighDpiGrid.png"));
+        auto second = WaitExecution(CanvasVirtualBitmap::LoadAsync(m_device, "Assets/HighDpiGrid.png"));
+        auto bitmap = WaitExecution(CanvasBitmap::LoadAsync(m_device, "Assets/HighDpiGrid.png"));
+
+        Assert::AreEqual(first->Size.Width, second->Size.Width);
+        Assert::AreEqual(first->Size.Height, second->Size.Height);
+        Assert::AreEqual(first->Size.Width, bitmap->Size.Width);
+        Assert::AreEqual(first->Size.Height, bitmap->Size.Height);
+    }
+
     TEST_METHOD(CanvasVirtualBitmap_GetBounds)
     {
         auto virtualBitmap = WaitExecution(CanvasVirtualBitmap::LoadAsync(m_device, "Assets/HighDpiGrid.png"));
@@ -0,0 +1,446 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+using namespace Microsoft::Graphics::Canvas::Effects;
+using namespace Microsoft::Graphics::Canvas::Geometry;
+using namespace Microsoft::Graphics::Canvas::Svg;
+using namespace Microsoft::Graphics::Canvas::Text;
+using namespace Windows::UI;
+
+//
+// Scripted scenes that each stress one rendering path, drawn frame after
+// frame into a swap chain for a fixed amount of time.  Where Benchmarks.cpp
+// measures the average cost of a single operation, these measure whole
+// frames, so they show up stutters and per-frame allocations as well as
+// throughput.
+//
+// Frames are presented with a sync interval of zero, so the frame rate
+// isn't capped by the display and the frame times show how long the CPU
+// and GPU took.  For each scene this reports:
+//
+//  - frame time percentiles, in milliseconds
+//  - video memory use at the end of the scene, and the most seen during it
+//  - how many Win2D objects, wrappers, effect realizations and text layouts
+//    were created while it ran, from CanvasDevice.GetObjectCounts and
+//    CanvasDevice.GetPerformanceCounters
+//
+// Results are written to the test log, and when the class finishes to
+// stressScenes.json in the app's local folder, in the same kind of stable
+// format as benchmarks.json, so runs on the same hardware can be compared
+// against a baseline by a script:
+//
+//     { "version": 1, "scenes": [
+//         { "name": "...", "frames": N, "p50": X, "p90": X, "p99": X, "max": X,
+//           "videoMemoryBytes": N, "peakVideoMemoryBytes": N,
+//           "objectsCreated": N, "wrappersCreated": N,
+//           "effectRealizations": N, "textLayoutsCreated": N }, ... ] }
+//
+// The scenes are in the "StressScene" category, so they can be included or
+// excluded from a test run with a category filter.
+//
+
+#define STRESS_SCENE(NAME)                                      \
+    BEGIN_TEST_METHOD_ATTRIBUTE(NAME)                           \
+        TEST_METHOD_ATTRIBUTE(L"Category", L"StressScene")      \
+    END_TEST_METHOD_ATTRIBUTE()                                 \
+    TEST_METHOD(NAME)
+
+TEST_CLASS(StressScenes)
+{
+    struct Result
+    {
+        std::wstring Name;
+        uint64_t Frames;
+        double P50;
+        double P90;
+        double P99;
+        double Max;
+        uint64_t VideoMemoryBytes;
+        uint64_t PeakVideoMemoryBytes;
+        uint64_t ObjectsCreated;
+        uint64_t WrappersCreated;
+        uint64_t EffectRealizations;
+        uint64_t TextLayoutsCreated;
+    };
+
+    static std::vector<Result>& GetResults()
+    {
+        static std::vector<Result> results;
+        return results;
+    }
+
+    static double GetSeconds()
+    {
+        LARGE_INTEGER counter;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&counter);
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+    }
+
+    static uint64_t CountObjectsCreated(CanvasObjectCounts const& counts)
+    {
+        return counts.BitmapsCreated +
+               counts.GeometriesCreated +
+               counts.EffectsCreated +
+               counts.TextFormatsCreated +
+               counts.TextLayoutsCreated;
+    }
+
+    // Returns the frame time, in milliseconds, that the given fraction of
+    // frames took no longer than.
+    static double GetPercentile(std::vector<double> const& sortedFrameTimes, double fraction)
+    {
+        auto index = static_cast<size_t>(fraction * sortedFrameTimes.size());
+
+        return sortedFrameTimes[std::min(index, sortedFrameTimes.size() - 1)];
+    }
+
+    static int const Width = 1280;
+    static int const Height = 720;
+
+    CanvasDevice^ m_device;
+    CanvasSwapChain^ m_swapChain;
+
+    void Run(wchar_t const* name, std::function<void(CanvasDrawingSession^, uint32_t frame)> const& drawFrame)
+    {
+        double const durationSeconds = 2;
+
+        // The first frame warms up caches and lazily created resources, so
+        // it isn't counted.
+        {
+            auto ds = m_swapChain->CreateDrawingSession(Colors::Black);
+            drawFrame(ds, 0);
+            delete ds;
+            m_swapChain->Present(0);
+        }
+
+        auto countsBefore = CanvasDevice::GetObjectCounts();
+        auto countersBefore = CanvasDevice::GetPerformanceCounters();
+
+        std::vector<double> frameTimes;
+        uint64_t peakVideoMemory = 0;
+
+        double sceneStart = GetSeconds();
+
+        for (uint32_t frame = 1; GetSeconds() - sceneStart < durationSeconds; frame++)
+        {
+            double frameStart = GetSeconds();
+
+            auto ds = m_swapChain->CreateDrawingSession(Colors::Black);
+            drawFrame(ds, frame);
+            delete ds;
+            m_swapChain->Present(0);
+
+            frameTimes.push_back((GetSeconds() - frameStart) * 1000);
+
+            // Reading the memory use is left out of the frame time.
+            peakVideoMemory = std::max(peakVideoMemory, m_device->MemoryUsage.CurrentUsage);
+        }
+
+        auto countsAfter = CanvasDevice::GetObjectCounts();
+        auto countersAfter = CanvasDevice::GetPerformanceCounters();
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+
+        Result result
+        {
+            name,
+            frameTimes.size(),
+            GetPercentile(frameTimes, 0.5),
+            GetPercentile(frameTimes, 0.9),
+            GetPercentile(frameTimes, 0.99),
+            frameTimes.back(),
+            m_device->MemoryUsage.CurrentUsage,
+            peakVideoMemory,
+            CountObjectsCreated(countsAfter) - CountObjectsCreated(countsBefore),
+            countersAfter.WrappersCreated - countersBefore.WrappersCreated,
+            countersAfter.EffectRealizations - countersBefore.EffectRealizations,
+            countersAfter.TextLayoutsCreated - countersBefore.TextLayoutsCreated
+        };
+
+        GetResults().push_back(result);
+
+        Logger::WriteMessage(ToJson(result).c_str());
+    }
+
+    static std::wstring ToJson(Result const& result)
+    {
+        wchar_t buffer[1024];
+
+        ThrowIfFailed(StringCchPrintf(
+            buffer,
+            _countof(buffer),
+            L"{ \"name\": \"%s\", \"frames\": %llu, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, "
+            L"\"videoMemoryBytes\": %llu, \"peakVideoMemoryBytes\": %llu, "
+            L"\"objectsCreated\": %llu, \"wrappersCreated\": %llu, \"effectRealizations\": %llu, \"textLayoutsCreated\": %llu }",
+            result.Name.c_str(),
+            result.Frames,
+            result.P50,
+            result.P90,
+            result.P99,
+            result.Max,
+            result.VideoMemoryBytes,
+            result.PeakVideoMemoryBytes,
+            result.ObjectsCreated,
+            result.WrappersCreated,
+            result.EffectRealizations,
+            result.TextLayoutsCreated));
+
+        return buffer;
+    }
+
+public:
+    StressScenes()
+        : m_device(ref new CanvasDevice())
+    {
+        m_swapChain = ref new CanvasSwapChain(m_device, static_cast<float>(Width), static_cast<float>(Height), DEFAULT_DPI);
+    }
+
+    TEST_CLASS_CLEANUP(WriteResults)
+    {
+        auto& results = GetResults();
+
+        if (results.empty())
+            return;
+
+        std::sort(results.begin(), results.end(), [](Result const& a, Result const& b) { return a.Name < b.Name; });
+
+        std::wstring json = L"{ \"version\": 1, \"scenes\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            json += L"    " + ToJson(results[i]);
+            json += (i + 1 < results.size()) ? L",\n" : L"\n";
+        }
+
+        json += L"] }\n";
+
+        auto path = std::wstring(Windows::Storage::ApplicationData::Current->LocalFolder->Path->Data()) + L"\\stressScenes.json";
+
+        FILE* file;
+        if (_wfopen_s(&file, path.c_str(), L"w") == 0)
+        {
+            fputws(json.c_str(), file);
+            fclose(file);
+        }
+
+        Logger::WriteMessage((L"Stress scene results written to " + path).c_str());
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    STRESS_SCENE(StressScene_SpriteStorm)
+    {
+        if (!CanvasSpriteBatch::IsSupported(m_device))
+            return;
+
+        uint32_t const count = 20000;
+        uint32_t const bitmapCount = 8;
+
+        std::vector<CanvasBitmap^> bitmaps;
+
+        for (uint32_t i = 0; i < bitmapCount; i++)
+        {
+            auto bitmap = ref new CanvasRenderTarget(m_device, 32, 32, DEFAULT_DPI);
+
+            auto ds = bitmap->CreateDrawingSession();
+            ds->Clear(ColorHelper::FromArgb(255, static_cast<uint8_t>(i * 30), 128, static_cast<uint8_t>(255 - i * 30)));
+            delete ds;
+
+            bitmaps.push_back(bitmap);
+        }
+
+        Run(L"SpriteStorm", [&](CanvasDrawingSession^ ds, uint32_t frame)
+        {
+            auto spriteBatch = ds->CreateSpriteBatch(CanvasSpriteSortMode::Bitmap);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                // Each sprite drifts a little further every frame.
+                float x = static_cast<float>((i * 37 + frame * (i % 7 + 1)) % Width);
+                float y = static_cast<float>((i * 53 + frame * (i % 5 + 1)) % Height);
+
+                spriteBatch->Draw(bitmaps[i % bitmapCount], float2(x, y));
+            }
+
+            delete spriteBatch;
+        });
+    }
+
+#endif
+
+    STRESS_SCENE(StressScene_EffectChainStack)
+    {
+        uint32_t const chainCount = 8;
+
+        auto source = ref new CanvasRenderTarget(m_device, 256, 256, DEFAULT_DPI);
+
+        auto sourceDs = source->CreateDrawingSession();
+        sourceDs->Clear(Colors::CornflowerBlue);
+        sourceDs->FillCircle(128, 128, 96, Colors::Orange);
+        delete sourceDs;
+
+        std::vector<Transform2DEffect^> transforms;
+        std::vector<ICanvasImage^> chains;
+
+        for (uint32_t i = 0; i < chainCount; i++)
+        {
+            auto blur = ref new GaussianBlurEffect();
+            blur->Source = source;
+            blur->BlurAmount = static_cast<float>(i + 1);
+
+            auto saturation = ref new SaturationEffect();
+            saturation->Source = blur;
+            saturation->Saturation = 0.5f;
+
+            auto hue = ref new HueRotationEffect();
+            hue->Source = saturation;
+
+            auto transform = ref new Transform2DEffect();
+            transform->Source = hue;
+
+            auto composite = ref new CompositeEffect();
+            composite->Sources->Append(transform);
+            composite->Sources->Append(source);
+
+            transforms.push_back(transform);
+            chains.push_back(composite);
+        }
+
+        Run(L"EffectChainStack", [&](CanvasDrawingSession^ ds, uint32_t frame)
+        {
+            for (uint32_t i = 0; i < chainCount; i++)
+            {
+                // Changing a property every frame, as an animation would,
+                // without changing the shape of the graph.
+                auto angle = static_cast<float>(frame + i) * 0.02f;
+                transforms[i]->TransformMatrix = make_float3x2_rotation(angle, float2(128, 128));
+
+                ds->DrawImage(chains[i], static_cast<float>(i % 4 * 300), static_cast<float>(i / 4 * 300));
+            }
+        });
+    }
+
+    STRESS_SCENE(StressScene_TextWall)
+    {
+        uint32_t const rowCount = 60;
+        uint32_t const columnCount = 4;
+
+        auto format = ref new CanvasTextFormat();
+        format->FontSize = 11;
+
+        Run(L"TextWall", [&](CanvasDrawingSession^ ds, uint32_t frame)
+        {
+            for (uint32_t row = 0; row < rowCount; row++)
+            {
+                for (uint32_t column = 0; column < columnCount; column++)
+                {
+                    // The text changes every frame, so nothing can be reused
+                    // from one frame to the next.
+                    auto text = L"Frame " + std::to_wstring(frame) + L", row " + std::to_wstring(row) + L", column " + std::to_wstring(column) +
+                                L": the quick brown fox jumps over the lazy dog";
+
+                    ds->DrawText(
+                        ref new Platform::String(text.c_str()),
+                        static_cast<float>(column * 320),
+                        static_cast<float>(row * 12),
+                        Colors::White,
+                        format);
+                }
+            }
+        });
+    }
+
+    STRESS_SCENE(StressScene_GeometryMap)
+    {
+        uint32_t const count = 500;
+
+        std::vector<CanvasGeometry^> geometries;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float x = static_cast<float>(i % 25 * 50);
+            float y = static_cast<float>(i / 25 * 36);
+
+            switch (i % 3)
+            {
+            case 0:
+                geometries.push_back(CanvasGeometry::CreateEllipse(m_device, x + 20, y + 15, 20, 15));
+                break;
+
+            case 1:
+                geometries.push_back(CanvasGeometry::CreateRoundedRectangle(m_device, x, y, 40, 30, 6, 6));
+                break;
+
+            default:
+                {
+                    // A small irregular region, like a parcel on a map.
+                    auto pathBuilder = ref new CanvasPathBuilder(m_device);
+                    pathBuilder->BeginFigure(x, y);
+                    pathBuilder->AddLine(x + 40, y + 5);
+                    pathBuilder->AddQuadraticBezier(float2(x + 45, y + 20), float2(x + 35, y + 30));
+                    pathBuilder->AddLine(x + 5, y + 25);
+                    pathBuilder->EndFigure(CanvasFigureLoop::Closed);
+
+                    geometries.push_back(CanvasGeometry::CreatePath(pathBuilder));
+                }
+                break;
+            }
+        }
+
+        Run(L"GeometryMap", [&](CanvasDrawingSession^ ds, uint32_t frame)
+        {
+            // Panning and zooming the map every frame.
+            auto zoom = 1 + 0.25f * sinf(static_cast<float>(frame) * 0.05f);
+            ds->Transform = make_float3x2_scale(zoom) * make_float3x2_translation(-static_cast<float>(frame % 100), 0);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ds->FillGeometry(geometries[i], ColorHelper::FromArgb(255, static_cast<uint8_t>(i * 7), static_cast<uint8_t>(i * 13), 160));
+                ds->DrawGeometry(geometries[i], Colors::Black, 1.5f);
+            }
+        });
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    STRESS_SCENE(StressScene_SvgIconGrid)
+    {
+        if (!CanvasSvgDocument::IsSupported(m_device))
+            return;
+
+        uint32_t const columnCount = 40;
+        uint32_t const rowCount = 22;
+        float const iconSize = 32;
+
+        auto icon = CanvasSvgDocument::LoadFromXml(m_device,
+            L"<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 24 24\">"
+            L"<circle cx=\"12\" cy=\"12\" r=\"10\" fill=\"steelblue\" stroke=\"white\" stroke-width=\"1.5\"/>"
+            L"<path d=\"M7 12 L11 16 L17 8\" fill=\"none\" stroke=\"white\" stroke-width=\"2\"/>"
+            L"<rect x=\"4\" y=\"19\" width=\"16\" height=\"2\" rx=\"1\" fill=\"gold\"/>"
+            L"</svg>");
+
+        Run(L"SvgIconGrid", [&](CanvasDrawingSession^ ds, uint32_t frame)
+        {
+            Windows::Foundation::Size viewportSize{ iconSize, iconSize };
+
+            for (uint32_t row = 0; row < rowCount; row++)
+            {
+                for (uint32_t column = 0; column < columnCount; column++)
+                {
+                    // Scroll the grid by a pixel every frame.
+                    float x = static_cast<float>((column * 32 + frame) % Width);
+                    float y = static_cast<float>(row * 32);
+
+                    ds->DrawSvg(icon, viewportSize, x, y);
+                }
+            }
+        });
+    }
+
+#endif
+};
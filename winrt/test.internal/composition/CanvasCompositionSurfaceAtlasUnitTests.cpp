@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include <lib/composition/CanvasCompositionSurfaceAtlas.h>
+
+using namespace ABI::Microsoft::Graphics::Canvas::UI::Composition;
+
+TEST_CLASS(CanvasCompositionSurfaceAtlasUnitTests)
+{
+public:
+    static bool Overlaps(AtlasAllocation const& a, AtlasAllocation const& b)
+    {
+        auto padding = SurfaceAtlasAllocator::Padding;
+
+        return a.Page == b.Page &&
+               a.Position.x < b.Position.x + b.Size.width + padding &&
+               b.Position.x < a.Position.x + a.Size.width + padding &&
+               a.Position.y < b.Position.y + b.Size.height + padding &&
+               b.Position.y < a.Position.y + a.Size.height + padding;
+    }
+
+    TEST_METHOD_EX(SurfaceAtlasAllocator_AllocationsArePaddedAndDoNotOverlap)
+    {
+        SurfaceAtlasAllocator allocator(D2D1_SIZE_U{ 256, 256 });
+
+        std::vector<AtlasAllocation> allocations;
+
+        for (uint32_t i = 0; i < 40; i++)
+        {
+            auto allocation = allocator.Allocate(D2D1_SIZE_U{ 8 + i % 5 * 6, 8 + i % 3 * 10 });
+
+            Assert::IsTrue(allocation.Position.x + allocation.Size.width <= 256u);
+            Assert::IsTrue(allocation.Position.y + allocation.Size.height <= 256u);
+
+            for (auto& other : allocations)
+            {
+                Assert::IsFalse(Overlaps(allocation, other));
+            }
+
+            allocations.push_back(allocation);
+        }
+
+        Assert::AreEqual(1u, allocator.GetPageCount());
+    }
+
+    TEST_METHOD_EX(SurfaceAtlasAllocator_WhenAPageIsFull_AddsAnother)
+    {
+        SurfaceAtlasAllocator allocator(D2D1_SIZE_U{ 64, 64 });
+
+        auto a = allocator.Allocate(D2D1_SIZE_U{ 64, 64 });
+        auto b = allocator.Allocate(D2D1_SIZE_U{ 10, 10 });
+
+        Assert::AreEqual(0u, a.Page);
+        Assert::AreEqual(1u, b.Page);
+        Assert::AreEqual(2u, allocator.GetPageCount());
+    }
+
+    TEST_METHOD_EX(SurfaceAtlasAllocator_FreedSpace_IsReused)
+    {
+        SurfaceAtlasAllocator allocator(D2D1_SIZE_U{ 64, 64 });
+
+        auto a = allocator.Allocate(D2D1_SIZE_U{ 20, 10 });
+        auto b = allocator.Allocate(D2D1_SIZE_U{ 20, 10 });
+        auto c = allocator.Allocate(D2D1_SIZE_U{ 20, 10 });
+
+        Assert::AreEqual(21u, b.Position.x);
+
+        allocator.Free(a);
+        allocator.Free(b);
+
+        // The two freed spans merge, so a wider allocation fits where they were.
+        auto d = allocator.Allocate(D2D1_SIZE_U{ 40, 10 });
+
+        Assert::AreEqual(0u, d.Page);
+        Assert::AreEqual(0u, d.Position.x);
+        Assert::AreEqual(0u, d.Position.y);
+
+        allocator.Free(c);
+        allocator.Free(d);
+
+        Assert::IsTrue(allocator.IsPageEmpty(0));
+
+        // An empty page starts again from scratch, so a full page allocation fits.
+        auto e = allocator.Allocate(D2D1_SIZE_U{ 64, 64 });
+
+        Assert::AreEqual(0u, e.Page);
+        Assert::AreEqual(1u, allocator.GetPageCount());
+    }
+
+    TEST_METHOD_EX(SurfaceAtlasAllocator_MuchShorterAllocations_StartANewShelf)
+    {
+        SurfaceAtlasAllocator allocator(D2D1_SIZE_U{ 64, 64 });
+
+        allocator.Allocate(D2D1_SIZE_U{ 10, 40 });
+        auto shortAllocation = allocator.Allocate(D2D1_SIZE_U{ 10, 10 });
+
+        Assert::AreEqual(0u, shortAllocation.Position.x);
+        Assert::AreEqual(41u, shortAllocation.Position.y);
+    }
+
+    TEST_METHOD_EX(SurfaceAtlasAllocator_InvalidSizes_Throw)
+    {
+        SurfaceAtlasAllocator allocator(D2D1_SIZE_U{ 64, 64 });
+
+        ExpectHResultException(E_INVALIDARG, [&] { allocator.Allocate(D2D1_SIZE_U{ 65, 10 }); });
+        ExpectHResultException(E_INVALIDARG, [&] { allocator.Allocate(D2D1_SIZE_U{ 10, 65 }); });
+        ExpectHResultException(E_INVALIDARG, [&] { allocator.Allocate(D2D1_SIZE_U{ 0, 10 }); });
+    }
+
+    struct Fixture
+    {
+        ComPtr<MockCompositionGraphicsDevice> GraphicsDevice = Make<MockCompositionGraphicsDevice>();
+        std::vector<ComPtr<MockCompositionDrawingSurface>> PageSurfaces;
+        ComPtr<ICanvasCompositionSurfaceAtlas> Atlas;
+
+        Fixture()
+        {
+            GraphicsDevice->CreateDrawingSurfaceMethod.AllowAnyCall(
+                [this] (Size size, DirectXPixelFormat pixelFormat, DirectXAlphaMode alphaMode, ICompositionDrawingSurface** value)
+                {
+                    Assert::AreEqual(Size{ 64, 64 }, size);
+                    Assert::AreEqual(PIXEL_FORMAT(B8G8R8A8UIntNormalized), pixelFormat);
+                    Assert::IsTrue(alphaMode == DirectXAlphaMode_Premultiplied);
+
+                    auto surface = Make<MockCompositionDrawingSurface>();
+                    PageSurfaces.push_back(surface);
+                    return surface.CopyTo(value);
+                });
+
+            ThrowIfFailed(Make<CanvasCompositionSurfaceAtlasFactory>()->Create(GraphicsDevice.Get(), Size{ 64, 64 }, &Atlas));
+        }
+
+        ComPtr<ICanvasCompositionAtlasSurface> Allocate(float width, float height)
+        {
+            ComPtr<ICanvasCompositionAtlasSurface> surface;
+            ThrowIfFailed(Atlas->Allocate(Size{ width, height }, &surface));
+            return surface;
+        }
+
+        int32_t GetPageCount()
+        {
+            int32_t pageCount;
+            ThrowIfFailed(Atlas->get_PageCount(&pageCount));
+            return pageCount;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasCompositionSurfaceAtlas_InvalidArguments)
+    {
+        Fixture f;
+
+        auto factory = Make<CanvasCompositionSurfaceAtlasFactory>();
+        ComPtr<ICanvasCompositionSurfaceAtlas> atlas;
+        ComPtr<ICanvasCompositionAtlasSurface> surface;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, Size{ 64, 64 }, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(f.GraphicsDevice.Get(), Size{ 0, 64 }, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(f.GraphicsDevice.Get(), Size{ 64, 64 }, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, f.Atlas->Allocate(Size{ 10, 10 }, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Atlas->Allocate(Size{ 0, 10 }, &surface));
+        Assert::AreEqual(E_INVALIDARG, f.Atlas->Allocate(Size{ 65, 10 }, &surface));
+    }
+
+    TEST_METHOD_EX(CanvasCompositionSurfaceAtlas_AllocationsShareAPageSurface)
+    {
+        Fixture f;
+
+        auto a = f.Allocate(10, 10);
+        auto b = f.Allocate(20, 10);
+
+        Assert::AreEqual(1, f.GetPageCount());
+
+        ComPtr<ICompositionDrawingSurface> surfaceA, surfaceB;
+        ThrowIfFailed(a->get_DrawingSurface(&surfaceA));
+        ThrowIfFailed(b->get_DrawingSurface(&surfaceB));
+
+        Assert::IsTrue(IsSameInstance(f.PageSurfaces[0].Get(), surfaceA.Get()));
+        Assert::IsTrue(IsSameInstance(f.PageSurfaces[0].Get(), surfaceB.Get()));
+
+        Rect bounds;
+        ThrowIfFailed(b->get_Bounds(&bounds));
+        Assert::AreEqual(Rect{ 11, 0, 20, 10 }, bounds);
+    }
+
+    TEST_METHOD_EX(CanvasCompositionSurfaceAtlas_WhenAPageIsFull_CreatesAnotherSurface)
+    {
+        Fixture f;
+
+        auto a = f.Allocate(64, 64);
+        auto b = f.Allocate(64, 64);
+
+        Assert::AreEqual(2, f.GetPageCount());
+        Assert::AreEqual<size_t>(2, f.PageSurfaces.size());
+    }
+
+    TEST_METHOD_EX(CanvasCompositionSurfaceAtlas_Trim_ReleasesEmptyPages)
+    {
+        Fixture f;
+
+        auto a = f.Allocate(64, 64);
+        auto b = f.Allocate(64, 64);
+
+        ThrowIfFailed(b->Close());
+        ThrowIfFailed(f.Atlas->Trim());
+
+        Assert::AreEqual(1, f.GetPageCount());
+
+        // The trimmed page gets a new surface when it is next used.
+        auto c = f.Allocate(10, 10);
+
+        Assert::AreEqual(2, f.GetPageCount());
+        Assert::AreEqual<size_t>(3, f.PageSurfaces.size());
+    }
+
+    TEST_METHOD_EX(CanvasCompositionSurfaceAtlas_ClosedSurface_FreesItsSpaceAndFailsCalls)
+    {
+        Fixture f;
+
+        auto a = f.Allocate(64, 64);
+        ThrowIfFailed(a->Close());
+
+        auto b = f.Allocate(64, 64);
+        Assert::AreEqual(1, f.GetPageCount());
+
+        ComPtr<ICompositionDrawingSurface> surface;
+        Rect bounds;
+        ComPtr<ICanvasDrawingSession> drawingSession;
+
+        Assert::AreEqual(RO_E_CLOSED, a->get_DrawingSurface(&surface));
+        Assert::AreEqual(RO_E_CLOSED, a->get_Bounds(&bounds));
+        Assert::AreEqual(RO_E_CLOSED, a->CreateDrawingSession(&drawingSession));
+    }
+
+    TEST_METHOD_EX(CanvasCompositionSurfaceAtlas_Closed_FailsAllocations)
+    {
+        Fixture f;
+
+        auto a = f.Allocate(10, 10);
+
+        ThrowIfFailed(As<IClosable>(f.Atlas)->Close());
+
+        ComPtr<ICanvasCompositionAtlasSurface> surface;
+        Assert::AreEqual(RO_E_CLOSED, f.Atlas->Allocate(Size{ 10, 10 }, &surface));
+        Assert::AreEqual(RO_E_CLOSED, f.Atlas->Trim());
+        Assert::AreEqual(0, f.GetPageCount());
+
+        // Closing a surface after its atlas is harmless.
+        ThrowIfFailed(a->Close());
+    }
+};
+
+#endif
@@ -7,6 +7,7 @@
 #if WINVER > _WIN32_WINNT_WINBLUE
 
 #include <lib/composition/CanvasComposition.h>
+#include <lib/drawing/CanvasLock.h>
 
 using namespace ABI::Microsoft::Graphics::Canvas::UI::Composition;
 
@@ -344,6 +345,110 @@ public:
         Assert::AreEqual(AnyErrorResult, f.Composition->Resize(f.DrawingSurface.Get(), anySize));
     }
 
+    struct DrawSurfacesFixture : public Fixture
+    {
+        ComPtr<MockD2DFactory> D2DFactory = Make<MockD2DFactory>();
+        ComPtr<MockCanvasDevice> CanvasDevice = Make<MockCanvasDevice>();
+        std::vector<ComPtr<MockCompositionDrawingSurface>> DrawingSurfaces;
+        std::vector<ICompositionDrawingSurface*> SurfacePointers;
+
+        DrawSurfacesFixture(int surfaceCount)
+        {
+            CanvasDevice->LockMethod.SetExpectedCalls(1,
+                [=] (ICanvasLock** value)
+                {
+                    return Make<CanvasLock>(D2DFactory.Get()).CopyTo(value);
+                });
+
+            for (int i = 0; i < surfaceCount; i++)
+            {
+                auto drawingSurface = Make<MockCompositionDrawingSurface>();
+
+                drawingSurface->BeginDrawMethod.SetExpectedCalls(1,
+                    [=] (const RECT* updateRect, REFIID iid, void** updateObject, POINT* updateOffset)
+                    {
+                        Assert::IsNull(updateRect);
+
+                        // The lock is already held, and no earlier surface is still being drawn.
+                        Assert::AreEqual(1, D2DFactory->GetEnterCount());
+                        Assert::AreEqual(0, D2DFactory->GetLeaveCount());
+
+                        for (int j = 0; j < i; j++)
+                        {
+                            Assert::AreEqual(1, DrawingSurfaces[j]->EndDrawMethod.GetCurrentCallCount());
+                        }
+
+                        auto deviceContext = Make<StubD2DDeviceContext>();
+                        deviceContext->SetTransformMethod.AllowAnyCall();
+                        deviceContext->SetDpiMethod.AllowAnyCall();
+
+                        *updateOffset = POINT{ 0, 0 };
+                        return deviceContext.CopyTo(iid, updateObject);
+                    });
+
+                drawingSurface->EndDrawMethod.SetExpectedCalls(1);
+
+                DrawingSurfaces.push_back(drawingSurface);
+                SurfacePointers.push_back(drawingSurface.Get());
+            }
+        }
+    };
+
+    TEST_METHOD_EX(CanvasComposition_DrawSurfaces_FailsWhenPassedNullParameters)
+    {
+        Fixture f;
+
+        auto canvasDevice = Make<MockCanvasDevice>();
+        auto handler = Callback<ICanvasCompositionDrawSurfaceHandler>([] (int32_t, ICanvasDrawingSession*) { return S_OK; });
+        ICompositionDrawingSurface* surfaces[] = { nullptr };
+
+        Assert::AreEqual(E_INVALIDARG, f.Composition->DrawSurfaces(nullptr,            0, nullptr,  handler.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.Composition->DrawSurfaces(canvasDevice.Get(), 0, nullptr,  nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Composition->DrawSurfaces(canvasDevice.Get(), 1, nullptr,  handler.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.Composition->DrawSurfaces(canvasDevice.Get(), 1, surfaces, handler.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasComposition_DrawSurfaces_DrawsEachSurfaceInTurnUnderOneLock)
+    {
+        DrawSurfacesFixture f(3);
+
+        std::vector<int32_t> drawnIndices;
+
+        auto handler = Callback<ICanvasCompositionDrawSurfaceHandler>(
+            [&] (int32_t surfaceIndex, ICanvasDrawingSession* drawingSession)
+            {
+                Assert::IsNotNull(drawingSession);
+                drawnIndices.push_back(surfaceIndex);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.Composition->DrawSurfaces(f.CanvasDevice.Get(), 3, f.SurfacePointers.data(), handler.Get()));
+
+        Assert::AreEqual<size_t>(3, drawnIndices.size());
+
+        for (int32_t i = 0; i < 3; i++)
+        {
+            Assert::AreEqual(i, drawnIndices[i]);
+        }
+
+        Assert::AreEqual(1, f.D2DFactory->GetEnterCount());
+        Assert::AreEqual(1, f.D2DFactory->GetLeaveCount());
+    }
+
+    TEST_METHOD_EX(CanvasComposition_DrawSurfaces_WhenTheHandlerFails_EndsDrawAndReleasesTheLock)
+    {
+        DrawSurfacesFixture f(1);
+
+        ComPtr<MockCompositionDrawingSurface> unusedSurface = Make<MockCompositionDrawingSurface>();
+        ICompositionDrawingSurface* surfaces[] = { f.SurfacePointers[0], unusedSurface.Get() };
+
+        auto handler = Callback<ICanvasCompositionDrawSurfaceHandler>([] (int32_t, ICanvasDrawingSession*) { return AnyErrorResult; });
+
+        Assert::AreEqual(AnyErrorResult, f.Composition->DrawSurfaces(f.CanvasDevice.Get(), 2, surfaces, handler.Get()));
+
+        Assert::AreEqual(1, f.D2DFactory->GetLeaveCount());
+    }
+
     TEST_METHOD_EX(CanvasComposition_When_CompositionApiNotPresent_CannotActivate)
     {
         auto apiInformation = ApiInformationTestAdapter::Create();
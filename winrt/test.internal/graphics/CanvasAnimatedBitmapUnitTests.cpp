@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/images/CanvasAnimatedBitmap.h>
+
+TEST_CLASS(CanvasAnimatedBitmapUnitTests)
+{
+    //
+    // Decoding and composing frames needs a real WIC decoder, so is covered
+    // by test.external.  These tests cover the factory argument checks and
+    // the timing of frames.
+    //
+
+    TEST_METHOD_EX(CanvasAnimatedBitmap_LoadAsync_NullArgs)
+    {
+        auto factory = Make<CanvasAnimatedBitmapFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(Make<StubCanvasDevice>());
+        WinString fileName(L"test.gif");
+
+        ComPtr<IAsyncOperation<CanvasAnimatedBitmap*>> operation;
+
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromFileName(nullptr, fileName, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromFileName(resourceCreator.Get(), nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromFileName(resourceCreator.Get(), fileName, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromUri(nullptr, nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromUri(resourceCreator.Get(), nullptr, &operation));
+
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromStream(nullptr, nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadAsyncFromStream(resourceCreator.Get(), nullptr, &operation));
+    }
+
+    TEST_METHOD_EX(AnimationTimeline_ReportsDurations)
+    {
+        AnimationTimeline timeline({ 100, 200, 300 }, 0);
+
+        Assert::AreEqual(3, timeline.GetFrameCount());
+        Assert::AreEqual(0, timeline.GetLoopCount());
+        Assert::AreEqual<int64_t>(600, timeline.GetDuration());
+
+        Assert::AreEqual<int64_t>(100, timeline.GetFrameDuration(0));
+        Assert::AreEqual<int64_t>(200, timeline.GetFrameDuration(1));
+        Assert::AreEqual<int64_t>(300, timeline.GetFrameDuration(2));
+    }
+
+    TEST_METHOD_EX(AnimationTimeline_GetFrameAtTime_WithinFirstLoop)
+    {
+        AnimationTimeline timeline({ 100, 200, 300 }, 0);
+
+        Assert::AreEqual(0, timeline.GetFrameAtTime(-50));
+        Assert::AreEqual(0, timeline.GetFrameAtTime(0));
+        Assert::AreEqual(0, timeline.GetFrameAtTime(99));
+        Assert::AreEqual(1, timeline.GetFrameAtTime(100));
+        Assert::AreEqual(1, timeline.GetFrameAtTime(299));
+        Assert::AreEqual(2, timeline.GetFrameAtTime(300));
+        Assert::AreEqual(2, timeline.GetFrameAtTime(599));
+    }
+
+    TEST_METHOD_EX(AnimationTimeline_GetFrameAtTime_LoopsForeverWhenLoopCountIsZero)
+    {
+        AnimationTimeline timeline({ 100, 200, 300 }, 0);
+
+        Assert::AreEqual(0, timeline.GetFrameAtTime(600));
+        Assert::AreEqual(1, timeline.GetFrameAtTime(700));
+        Assert::AreEqual(2, timeline.GetFrameAtTime(600 * 1000 + 450));
+    }
+
+    TEST_METHOD_EX(AnimationTimeline_GetFrameAtTime_StopsOnLastFrameAfterLastLoop)
+    {
+        AnimationTimeline timeline({ 100, 200, 300 }, 2);
+
+        Assert::AreEqual(0, timeline.GetFrameAtTime(600));
+        Assert::AreEqual(1, timeline.GetFrameAtTime(700));
+        Assert::AreEqual(2, timeline.GetFrameAtTime(1199));
+
+        Assert::AreEqual(2, timeline.GetFrameAtTime(1200));
+        Assert::AreEqual(2, timeline.GetFrameAtTime(1000000));
+    }
+
+    TEST_METHOD_EX(AnimationTimeline_GetFrameAtTime_SingleFrame)
+    {
+        AnimationTimeline timeline({ 100 }, 1);
+
+        Assert::AreEqual(0, timeline.GetFrameAtTime(0));
+        Assert::AreEqual(0, timeline.GetFrameAtTime(50));
+        Assert::AreEqual(0, timeline.GetFrameAtTime(5000));
+    }
+};
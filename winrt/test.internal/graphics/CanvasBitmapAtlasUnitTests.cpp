@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/images/CanvasBitmapAtlas.h>
+
+TEST_CLASS(CanvasBitmapAtlasUnitTests)
+{
+public:
+    static bool Overlaps(D2D1_POINT_2U positionA, D2D1_SIZE_U sizeA, D2D1_POINT_2U positionB, D2D1_SIZE_U sizeB)
+    {
+        return positionA.x < positionB.x + sizeB.width + BitmapAtlasLayout::Padding &&
+               positionB.x < positionA.x + sizeA.width + BitmapAtlasLayout::Padding &&
+               positionA.y < positionB.y + sizeB.height + BitmapAtlasLayout::Padding &&
+               positionB.y < positionA.y + sizeA.height + BitmapAtlasLayout::Padding;
+    }
+
+    static void AssertPaddedAndInside(BitmapAtlasLayout const& layout, std::vector<D2D1_SIZE_U> const& sizes)
+    {
+        for (uint32_t i = 0; i < sizes.size(); i++)
+        {
+            auto position = layout.GetPosition(i);
+
+            Assert::IsTrue(position.x + sizes[i].width <= layout.GetSize().width);
+            Assert::IsTrue(position.y + sizes[i].height <= layout.GetSize().height);
+
+            for (uint32_t j = 0; j < i; j++)
+            {
+                Assert::IsFalse(Overlaps(position, sizes[i], layout.GetPosition(j), sizes[j]));
+            }
+        }
+    }
+
+    TEST_METHOD_EX(BitmapAtlasLayout_SingleBitmap_FillsTheAtlas)
+    {
+        BitmapAtlasLayout layout({ D2D1_SIZE_U{ 16, 24 } }, 1024);
+
+        Assert::AreEqual(16u, layout.GetSize().width);
+        Assert::AreEqual(24u, layout.GetSize().height);
+        Assert::AreEqual(0u, layout.GetPosition(0).x);
+        Assert::AreEqual(0u, layout.GetPosition(0).y);
+    }
+
+    TEST_METHOD_EX(BitmapAtlasLayout_BitmapsArePaddedAndDoNotOverlap)
+    {
+        std::vector<D2D1_SIZE_U> sizes;
+
+        for (uint32_t i = 0; i < 50; i++)
+        {
+            sizes.push_back(D2D1_SIZE_U{ 4 + i * 7 % 29, 4 + i * 11 % 23 });
+        }
+
+        BitmapAtlasLayout layout(sizes, 1024);
+
+        AssertPaddedAndInside(layout, sizes);
+    }
+
+    TEST_METHOD_EX(BitmapAtlasLayout_EqualBitmaps_PackRoughlySquare)
+    {
+        std::vector<D2D1_SIZE_U> sizes(16, D2D1_SIZE_U{ 31, 31 });
+
+        BitmapAtlasLayout layout(sizes, 1024);
+
+        // Four rows of four, with a pixel of padding between them.
+        Assert::AreEqual(4 * 32u - 1, layout.GetSize().width);
+        Assert::AreEqual(4 * 32u - 1, layout.GetSize().height);
+    }
+
+    TEST_METHOD_EX(BitmapAtlasLayout_ShortBitmaps_FillTheGapBesideATallOne)
+    {
+        // Rows would put the short bitmaps on a second row below the tall
+        // one; the skyline stacks them in the space beside it instead.
+        std::vector<D2D1_SIZE_U> sizes{ D2D1_SIZE_U{ 20, 41 }, D2D1_SIZE_U{ 20, 20 }, D2D1_SIZE_U{ 20, 20 } };
+
+        BitmapAtlasLayout layout(sizes, 41);
+
+        Assert::AreEqual(0u, layout.GetPosition(0).x);
+        Assert::AreEqual(0u, layout.GetPosition(0).y);
+        Assert::AreEqual(21u, layout.GetPosition(1).x);
+        Assert::AreEqual(0u, layout.GetPosition(1).y);
+        Assert::AreEqual(21u, layout.GetPosition(2).x);
+        Assert::AreEqual(21u, layout.GetPosition(2).y);
+        Assert::AreEqual(41u, layout.GetSize().height);
+
+        AssertPaddedAndInside(layout, sizes);
+    }
+
+    TEST_METHOD_EX(BitmapAtlasLayout_WideBitmapsThatOverflowASquareLayout_UseTheFullWidth)
+    {
+        std::vector<D2D1_SIZE_U> sizes(10, D2D1_SIZE_U{ 30, 10 });
+
+        BitmapAtlasLayout layout(sizes, 64);
+
+        Assert::IsTrue(layout.GetSize().width <= 64u);
+        Assert::AreEqual(5 * 11u - 1, layout.GetSize().height);
+
+        AssertPaddedAndInside(layout, sizes);
+    }
+
+    TEST_METHOD_EX(BitmapAtlasLayout_BitmapsThatDoNotFit_Throw)
+    {
+        ExpectHResultException(E_INVALIDARG, [] { BitmapAtlasLayout({ D2D1_SIZE_U{ 65, 10 } }, 64); });
+        ExpectHResultException(E_INVALIDARG, [] { BitmapAtlasLayout({ D2D1_SIZE_U{ 10, 65 } }, 64); });
+
+        std::vector<D2D1_SIZE_U> sizes(5, D2D1_SIZE_U{ 64, 20 });
+        ExpectHResultException(E_INVALIDARG, [&] { BitmapAtlasLayout(sizes, 64); });
+    }
+
+    TEST_METHOD_EX(CanvasBitmapAtlas_Create_InvalidArguments)
+    {
+        auto factory = Make<CanvasBitmapAtlasFactory>();
+        auto device = Make<StubCanvasDevice>();
+
+        ICanvasBitmap* bitmaps[2] = { reinterpret_cast<ICanvasBitmap*>(0x1234), reinterpret_cast<ICanvasBitmap*>(0x5678) };
+
+        ComPtr<ICanvasBitmapAtlas> atlas;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, 2, bitmaps, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(device.Get(), 2, nullptr, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(device.Get(), 2, bitmaps, nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(device.Get(), 0, bitmaps, &atlas));
+    }
+};
@@ -98,6 +98,10 @@ TEST_CLASS(CanvasBitmapUnitTest)
         Assert::AreEqual(RO_E_CLOSED, canvasBitmap->CopyPixelsFromBitmap(otherBitmap.Get()));
         Assert::AreEqual(RO_E_CLOSED, canvasBitmap->CopyPixelsFromBitmapWithDestPoint(otherBitmap.Get(), 0, 0));
         Assert::AreEqual(RO_E_CLOSED, canvasBitmap->CopyPixelsFromBitmapWithDestPointAndSourceRect(otherBitmap.Get(), 0, 0, 0, 0, 0, 0));
+
+        ICanvasBitmap* otherBitmaps[] = { otherBitmap.Get() };
+        ABI::Windows::Graphics::PointInt32 destPoints[] = { { 0, 0 } };
+        Assert::AreEqual(RO_E_CLOSED, canvasBitmap->CopyPixelsFromBitmaps(1, otherBitmaps, 1, destPoints, 0, nullptr));
     }
 
     TEST_METHOD_EX(CanvasBitmap_GetDevice)
@@ -187,6 +191,151 @@ TEST_CLASS(CanvasBitmapUnitTest)
         Assert::AreEqual(f.m_testImageHeightDip, size.Height);
     }
 
+    TEST_METHOD_EX(CanvasBitmap_CreateNew_PassesMaximumSizeToAdapter)
+    {
+        Fixture f;
+
+        CanvasBitmap::CreateNew(f.m_canvasDevice.Get(), f.m_testFileName, DEFAULT_DPI, CanvasAlphaMode::Premultiplied);
+
+        Assert::AreEqual(0U, f.m_adapter->LastMaximumSize.Width);
+        Assert::AreEqual(0U, f.m_adapter->LastMaximumSize.Height);
+
+        CanvasBitmap::CreateNew(f.m_canvasDevice.Get(), f.m_testFileName, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, BitmapSize{ 256, 128 });
+
+        Assert::AreEqual(256U, f.m_adapter->LastMaximumSize.Width);
+        Assert::AreEqual(128U, f.m_adapter->LastMaximumSize.Height);
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_CreateNew_PassesSourceRectangleToAdapter)
+    {
+        Fixture f;
+
+        CanvasBitmap::CreateNew(f.m_canvasDevice.Get(), f.m_testFileName, DEFAULT_DPI, CanvasAlphaMode::Premultiplied);
+
+        Assert::AreEqual(0U, f.m_adapter->LastSourceRectangle.Width);
+        Assert::AreEqual(0U, f.m_adapter->LastSourceRectangle.Height);
+
+        CanvasBitmap::CreateNew(f.m_canvasDevice.Get(), f.m_testFileName, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, BitmapSize{ 64, 64 }, PIXEL_FORMAT(B8G8R8A8UIntNormalized), BitmapBounds{ 1, 2, 3, 4 });
+
+        Assert::AreEqual(1U, f.m_adapter->LastSourceRectangle.X);
+        Assert::AreEqual(2U, f.m_adapter->LastSourceRectangle.Y);
+        Assert::AreEqual(3U, f.m_adapter->LastSourceRectangle.Width);
+        Assert::AreEqual(4U, f.m_adapter->LastSourceRectangle.Height);
+        Assert::AreEqual(64U, f.m_adapter->LastMaximumSize.Width);
+    }
+
+    struct ProgressiveLoadFixture : public Fixture
+    {
+        std::vector<float> LoadedDpis;
+        std::vector<uint32_t> LoadedMaximumWidths;
+        std::vector<ComPtr<ICanvasBitmap>> Previews;
+
+        ComPtr<ICanvasBitmapPreviewHandler> PreviewHandler;
+
+        ProgressiveLoadFixture(uint32_t width, uint32_t height)
+        {
+            m_adapter->ProgressiveInfo.Size = BitmapSize{ width, height };
+
+            m_canvasDevice->MockCreateBitmapFromWicResource =
+                [=](IWICBitmapSource*, CanvasAlphaMode, float dpi) -> ComPtr<ID2D1Bitmap1>
+                {
+                    LoadedDpis.push_back(dpi);
+                    LoadedMaximumWidths.push_back(m_adapter->LastMaximumSize.Width);
+                    return Make<StubD2DBitmap>(D2D1_BITMAP_OPTIONS_NONE, dpi);
+                };
+
+            PreviewHandler = Callback<ICanvasBitmapPreviewHandler>(
+                [=](ICanvasBitmap* preview)
+                {
+                    Previews.push_back(preview);
+                    return S_OK;
+                });
+        }
+
+        ComPtr<ICanvasBitmap> Load(BitmapSize previewSize, ICanvasBitmapPreviewHandler* previewHandler)
+        {
+            auto factory = Make<CanvasBitmapFactory>();
+
+            ComPtr<IAsyncOperation<CanvasBitmap*>> operation;
+            ThrowIfFailed(factory->LoadProgressiveAsyncFromHstringWithDpiAlphaAndPreviewSize(
+                As<ICanvasResourceCreator>(m_canvasDevice).Get(),
+                m_testFileName,
+                DEFAULT_DPI,
+                CanvasAlphaMode::Premultiplied,
+                previewSize,
+                previewHandler,
+                &operation));
+
+            auto startTime = GetTickCount64();
+            AsyncStatus status = AsyncStatus::Started;
+
+            while (status == AsyncStatus::Started)
+            {
+                Assert::IsTrue(GetTickCount64() < startTime + 5000);
+                ThrowIfFailed(As<IAsyncInfo>(operation)->get_Status(&status));
+            }
+
+            Assert::AreEqual(AsyncStatus::Completed, status);
+
+            ComPtr<ICanvasBitmap> bitmap;
+            ThrowIfFailed(operation->GetResults(&bitmap));
+            return bitmap;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasBitmap_LoadProgressiveAsync_ReportsScaledPreviewBeforeFullImage)
+    {
+        ProgressiveLoadFixture f(1000, 500);
+
+        auto bitmap = f.Load(BitmapSize{ 100, 100 }, f.PreviewHandler.Get());
+
+        Assert::IsNotNull(bitmap.Get());
+        Assert::AreEqual<size_t>(1, f.Previews.size());
+
+        // The preview is decoded to fit within previewSize, with a DPI that
+        // makes it the same size in DIPs as the full image.
+        Assert::AreEqual<size_t>(2, f.LoadedDpis.size());
+        Assert::AreEqual(DEFAULT_DPI / 10, f.LoadedDpis[0]);
+        Assert::AreEqual(100U, f.LoadedMaximumWidths[0]);
+
+        Assert::AreEqual(DEFAULT_DPI, f.LoadedDpis[1]);
+        Assert::AreEqual(0U, f.LoadedMaximumWidths[1]);
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_LoadProgressiveAsync_SkipsPreviewWhenImageIsAlreadySmall)
+    {
+        ProgressiveLoadFixture f(80, 60);
+
+        f.Load(BitmapSize{ 100, 100 }, f.PreviewHandler.Get());
+
+        Assert::AreEqual<size_t>(0, f.Previews.size());
+        Assert::AreEqual<size_t>(1, f.LoadedDpis.size());
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_LoadProgressiveAsync_WithoutHandler_OnlyLoadsFullImage)
+    {
+        ProgressiveLoadFixture f(1000, 500);
+
+        f.Load(BitmapSize{ 100, 100 }, nullptr);
+
+        Assert::AreEqual(0, f.m_adapter->GetProgressiveLoadInfoCallCount);
+        Assert::AreEqual<size_t>(1, f.LoadedDpis.size());
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_LoadProgressiveAsync_NullArgs)
+    {
+        Fixture f;
+
+        auto factory = Make<CanvasBitmapFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(f.m_canvasDevice);
+
+        ComPtr<IAsyncOperation<CanvasBitmap*>> operation;
+        Assert::AreEqual(E_INVALIDARG, factory->LoadProgressiveAsyncFromHstring(nullptr, f.m_testFileName, nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadProgressiveAsyncFromHstring(resourceCreator.Get(), nullptr, nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadProgressiveAsyncFromHstring(resourceCreator.Get(), f.m_testFileName, nullptr, nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->LoadProgressiveAsyncFromStream(resourceCreator.Get(), nullptr, nullptr, &operation));
+    }
+
     TEST_METHOD_EX(CanvasBitmap_Get_Bounds)
     {
         Fixture f;
@@ -258,6 +407,45 @@ TEST_CLASS(CanvasBitmapUnitTest)
         Assert::AreEqual(E_INVALIDARG, canvasBitmap->CopyPixelsFromBitmapWithDestPointAndSourceRect(nullptr, 0, 0, 0, 0, 0, 0));
     }
 
+    TEST_METHOD_EX(CanvasBitmap_CreateCopyOnDevice_NullArgs)
+    {
+        Fixture f;
+
+        auto canvasBitmap = CanvasBitmap::CreateNew(f.m_canvasDevice.Get(), f.m_testFileName, DEFAULT_DPI, CanvasAlphaMode::Premultiplied);
+        auto factory = Make<CanvasBitmapFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(f.m_canvasDevice);
+
+        ComPtr<ICanvasBitmap> copy;
+        Assert::AreEqual(E_INVALIDARG, factory->CreateCopyOnDevice(nullptr, canvasBitmap.Get(), &copy));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateCopyOnDevice(resourceCreator.Get(), nullptr, &copy));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateCopyOnDevice(resourceCreator.Get(), canvasBitmap.Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_LoadAsyncWithFormat_InvalidFormats)
+    {
+        Fixture f;
+
+        auto factory = Make<CanvasBitmapFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(f.m_canvasDevice);
+
+        ComPtr<IAsyncOperation<CanvasBitmap*>> operation;
+
+        auto load = [&](DirectXPixelFormat format, CanvasAlphaMode alpha)
+        {
+            return factory->LoadAsyncFromHstringWithDpiAlphaMaximumSizeAndFormat(resourceCreator.Get(), f.m_testFileName, DEFAULT_DPI, alpha, BitmapSize{}, format, &operation);
+        };
+
+        Assert::AreEqual(E_INVALIDARG, load(PIXEL_FORMAT(R8G8B8A8UIntNormalized), CanvasAlphaMode::Premultiplied));
+        Assert::AreEqual(E_INVALIDARG, load(PIXEL_FORMAT(Unknown), CanvasAlphaMode::Premultiplied));
+
+        // Block compressed formats can only be loaded premultiplied.
+        Assert::AreEqual(E_INVALIDARG, load(PIXEL_FORMAT(BC1UIntNormalized), CanvasAlphaMode::Straight));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::BlockCompressedLoadRequiresPremultipliedAlpha);
+
+        Assert::AreEqual(E_INVALIDARG, load(PIXEL_FORMAT(BC3UIntNormalized), CanvasAlphaMode::Ignore));
+        Assert::IsNull(operation.Get());
+    }
+
     struct CopyFromBitmapFixture : public Fixture
     {
         ComPtr<CanvasBitmap> DestBitmap;
@@ -346,6 +534,65 @@ TEST_CLASS(CanvasBitmapUnitTest)
             sourceRect[3]));
     }
 
+    TEST_METHOD_EX(CanvasBitmap_CopyPixelsFromBitmaps)
+    {
+        D2D1_POINT_2U expectedDestPoint{ 234, 2 };
+        D2D1_RECT_U expectedSourceRect{ 111, 222, 111 + 333, 222 + 445 };
+
+        CopyFromBitmapFixture f(expectedDestPoint, expectedSourceRect);
+
+        ICanvasBitmap* bitmaps[] = { f.SourceBitmap.Get() };
+        ABI::Windows::Graphics::PointInt32 destPoints[] = { { 234, 2 } };
+        BitmapBounds sourceRects[] = { { 111, 222, 333, 445 } };
+
+        ThrowIfFailed(f.DestBitmap->CopyPixelsFromBitmaps(1, bitmaps, 1, destPoints, 1, sourceRects));
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_CopyPixelsFromBitmaps_WithoutSourceRects_CopiesWholeBitmaps)
+    {
+        D2D1_POINT_2U expectedDestPoint{ 5, 6 };
+        D2D1_RECT_U expectedSourceRect{ 0, 0, 1024, 1024 };
+
+        CopyFromBitmapFixture f(expectedDestPoint, expectedSourceRect);
+
+        ICanvasBitmap* bitmaps[] = { f.SourceBitmap.Get() };
+        ABI::Windows::Graphics::PointInt32 destPoints[] = { { 5, 6 } };
+
+        ThrowIfFailed(f.DestBitmap->CopyPixelsFromBitmaps(1, bitmaps, 1, destPoints, 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasBitmap_CopyPixelsFromBitmaps_InvalidArgs)
+    {
+        Fixture f;
+
+        auto canvasDevice = Make<StubCanvasDevice>();
+
+        auto d2dBitmap = Make<StubD2DBitmap>();
+        d2dBitmap->GetPixelFormatMethod.AllowAnyCall([] { return D2D1::PixelFormat(); });
+        canvasDevice->MockCreateBitmapFromWicResource = [&](IWICBitmapSource*, CanvasAlphaMode, float) -> ComPtr<ID2D1Bitmap1> { return d2dBitmap; };
+        auto destBitmap = CanvasBitmap::CreateNew(canvasDevice.Get(), f.m_testFileName, DEFAULT_DPI, CanvasAlphaMode::Premultiplied);
+
+        ICanvasBitmap* bitmaps[] = { nullptr };
+        ABI::Windows::Graphics::PointInt32 destPoints[] = { { 0, 0 }, { 0, 0 } };
+        BitmapBounds sourceRects[] = { { 0, 0, 1, 1 }, { 0, 0, 1, 1 } };
+
+        // Null arrays
+        Assert::AreEqual(E_INVALIDARG, destBitmap->CopyPixelsFromBitmaps(1, nullptr, 1, destPoints, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, destBitmap->CopyPixelsFromBitmaps(1, bitmaps, 1, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, destBitmap->CopyPixelsFromBitmaps(1, bitmaps, 1, destPoints, 1, nullptr));
+
+        // Mismatched array sizes
+        Assert::AreEqual(E_INVALIDARG, destBitmap->CopyPixelsFromBitmaps(1, bitmaps, 2, destPoints, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, destBitmap->CopyPixelsFromBitmaps(1, bitmaps, 1, destPoints, 2, sourceRects));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::BitmapCopyArraySizesMismatch);
+
+        // Null bitmap
+        Assert::AreEqual(E_INVALIDARG, destBitmap->CopyPixelsFromBitmaps(1, bitmaps, 1, destPoints, 0, nullptr));
+
+        // An empty batch does nothing
+        Assert::AreEqual(S_OK, destBitmap->CopyPixelsFromBitmaps(0, nullptr, 0, nullptr, 0, nullptr));
+    }
+
     TEST_METHOD_EX(CanvasBitmap_CopyPixelsFromBitmap_InvalidCoordinates)
     {
         Fixture f;
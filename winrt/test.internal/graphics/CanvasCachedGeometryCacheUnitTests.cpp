@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include <lib/geometry/CanvasCachedGeometryCache.h>
+#include "mocks/MockD2DGeometryRealization.h"
+#include "mocks/MockD2DRectangleGeometry.h"
+
+TEST_CLASS(CanvasCachedGeometryCacheTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+        {
+        }
+
+        // Makes a geometry that flattens to the given number of points.
+        ComPtr<ICanvasGeometry> CreateGeometry(uint32_t pointCount)
+        {
+            auto d2dGeometry = Make<MockD2DRectangleGeometry>();
+
+            d2dGeometry->SimplifyMethod.AllowAnyCall(
+                [=](D2D1_GEOMETRY_SIMPLIFICATION_OPTION, CONST D2D1_MATRIX_3X2_F*, FLOAT, ID2D1SimplifiedGeometrySink* sink)
+                {
+                    std::vector<D2D1_POINT_2F> points(pointCount - 1);
+
+                    sink->BeginFigure(D2D1_POINT_2F{}, D2D1_FIGURE_BEGIN_FILLED);
+                    sink->AddLines(points.data(), static_cast<UINT32>(points.size()));
+                    sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+
+                    return S_OK;
+                });
+
+            return Make<CanvasGeometry>(Device.Get(), d2dGeometry.Get());
+        }
+
+        ComPtr<CanvasCachedGeometryCache> CreateCache(uint64_t maximumSize)
+        {
+            return Make<CanvasCachedGeometryCache>(Device.Get(), maximumSize);
+        }
+
+        static uint64_t FillSize(uint32_t pointCount)
+        {
+            return CanvasCachedGeometryCache::SizePerRealization + pointCount * CanvasCachedGeometryCache::FillSizePerPoint;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_SameArguments_ReturnSameCachedGeometry)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(1024 * 1024);
+        auto geometry = f.CreateGeometry(4);
+
+        f.Device->CreateFilledGeometryRealizationMethod.SetExpectedCalls(1,
+            [](ID2D1Geometry*, FLOAT flatteningTolerance)
+            {
+                Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE, flatteningTolerance);
+                return Make<MockD2DGeometryRealization>();
+            });
+
+        ComPtr<ICanvasCachedGeometry> first, second;
+        Assert::AreEqual(S_OK, cache->GetFill(geometry.Get(), &first));
+        Assert::AreEqual(S_OK, cache->GetFill(geometry.Get(), &second));
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+
+        CanvasCachedGeometryCacheStatistics statistics;
+        Assert::AreEqual(S_OK, cache->get_Statistics(&statistics));
+
+        Assert::AreEqual(1u, statistics.Count);
+        Assert::AreEqual(Fixture::FillSize(4), statistics.SizeInBytes);
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+        Assert::AreEqual<uint64_t>(0, statistics.EvictionCount);
+    }
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_DifferentArguments_AreCachedSeparately)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(1024 * 1024);
+        auto geometry = f.CreateGeometry(4);
+
+        f.Device->CreateFilledGeometryRealizationMethod.SetExpectedCalls(2,
+            [](ID2D1Geometry*, FLOAT) { return Make<MockD2DGeometryRealization>(); });
+
+        f.Device->CreateStrokedGeometryRealizationMethod.SetExpectedCalls(2,
+            [](ID2D1Geometry*, FLOAT, ID2D1StrokeStyle*, FLOAT) { return Make<MockD2DGeometryRealization>(); });
+
+        ComPtr<ICanvasCachedGeometry> cachedGeometry;
+        Assert::AreEqual(S_OK, cache->GetFill(geometry.Get(), &cachedGeometry));
+        Assert::AreEqual(S_OK, cache->GetFillWithFlatteningTolerance(geometry.Get(), 2.0f, &cachedGeometry));
+        Assert::AreEqual(S_OK, cache->GetStroke(geometry.Get(), 1.0f, &cachedGeometry));
+        Assert::AreEqual(S_OK, cache->GetStroke(geometry.Get(), 3.0f, &cachedGeometry));
+
+        CanvasCachedGeometryCacheStatistics statistics;
+        Assert::AreEqual(S_OK, cache->get_Statistics(&statistics));
+
+        Assert::AreEqual(4u, statistics.Count);
+        Assert::AreEqual<uint64_t>(0, statistics.HitCount);
+    }
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_OverBudget_EvictsLeastRecentlyRequested)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(Fixture::FillSize(4) * 2);
+
+        auto a = f.CreateGeometry(4);
+        auto b = f.CreateGeometry(4);
+        auto c = f.CreateGeometry(4);
+
+        ComPtr<ICanvasCachedGeometry> cachedA, cachedB, cachedC, result;
+        Assert::AreEqual(S_OK, cache->GetFill(a.Get(), &cachedA));
+        Assert::AreEqual(S_OK, cache->GetFill(b.Get(), &cachedB));
+
+        // Asking for a again makes b the least recently used.
+        Assert::AreEqual(S_OK, cache->GetFill(a.Get(), &result));
+        Assert::AreEqual(S_OK, cache->GetFill(c.Get(), &cachedC));
+
+        CanvasCachedGeometryCacheStatistics statistics;
+        Assert::AreEqual(S_OK, cache->get_Statistics(&statistics));
+
+        Assert::AreEqual(2u, statistics.Count);
+        Assert::AreEqual<uint64_t>(1, statistics.EvictionCount);
+
+        Assert::AreEqual(S_OK, cache->GetFill(a.Get(), &result));
+        Assert::IsTrue(IsSameInstance(cachedA.Get(), result.Get()));
+
+        Assert::AreEqual(S_OK, cache->GetFill(b.Get(), &result));
+        Assert::IsFalse(IsSameInstance(cachedB.Get(), result.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_LoweringMaximumSize_Evicts)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(1024 * 1024);
+
+        auto a = f.CreateGeometry(4);
+        auto b = f.CreateGeometry(8);
+
+        ComPtr<ICanvasCachedGeometry> cachedGeometry;
+        Assert::AreEqual(S_OK, cache->GetFill(a.Get(), &cachedGeometry));
+        Assert::AreEqual(S_OK, cache->GetFill(b.Get(), &cachedGeometry));
+
+        Assert::AreEqual(S_OK, cache->put_MaximumSizeInBytes(Fixture::FillSize(8)));
+
+        CanvasCachedGeometryCacheStatistics statistics;
+        Assert::AreEqual(S_OK, cache->get_Statistics(&statistics));
+
+        Assert::AreEqual(1u, statistics.Count);
+        Assert::AreEqual(Fixture::FillSize(8), statistics.SizeInBytes);
+    }
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_RemoveAndTrim_ReleaseEntries)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(1024 * 1024);
+
+        auto a = f.CreateGeometry(4);
+        auto b = f.CreateGeometry(4);
+
+        ComPtr<ICanvasCachedGeometry> cachedGeometry;
+        Assert::AreEqual(S_OK, cache->GetFill(a.Get(), &cachedGeometry));
+        Assert::AreEqual(S_OK, cache->GetStroke(a.Get(), 1.0f, &cachedGeometry));
+        Assert::AreEqual(S_OK, cache->GetFill(b.Get(), &cachedGeometry));
+
+        CanvasCachedGeometryCacheStatistics statistics;
+
+        Assert::AreEqual(S_OK, cache->Remove(a.Get()));
+        Assert::AreEqual(S_OK, cache->get_Statistics(&statistics));
+        Assert::AreEqual(1u, statistics.Count);
+        Assert::AreEqual(Fixture::FillSize(4), statistics.SizeInBytes);
+
+        Assert::AreEqual(S_OK, cache->Trim());
+        Assert::AreEqual(S_OK, cache->get_Statistics(&statistics));
+        Assert::AreEqual(0u, statistics.Count);
+        Assert::AreEqual<uint64_t>(0, statistics.SizeInBytes);
+    }
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_GeometryFromDifferentDevice_Fails)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(1024 * 1024);
+
+        auto otherDevice = Make<StubCanvasDevice>();
+        auto geometry = Make<CanvasGeometry>(otherDevice.Get(), Make<MockD2DRectangleGeometry>().Get());
+
+        ComPtr<ICanvasCachedGeometry> cachedGeometry;
+        Assert::AreEqual(E_INVALIDARG, cache->GetFill(geometry.Get(), &cachedGeometry));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::CachedGeometryCacheWrongDevice);
+    }
+
+    TEST_METHOD_EX(CanvasCachedGeometryCache_NullArgs)
+    {
+        Fixture f;
+        auto cache = f.CreateCache(1024 * 1024);
+        auto geometry = f.CreateGeometry(4);
+
+        ComPtr<ICanvasCachedGeometry> cachedGeometry;
+        Assert::AreEqual(E_INVALIDARG, cache->GetFill(nullptr, &cachedGeometry));
+        Assert::AreEqual(E_INVALIDARG, cache->GetFill(geometry.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, cache->GetStrokeWithStrokeStyle(geometry.Get(), 1.0f, nullptr, &cachedGeometry));
+        Assert::AreEqual(E_INVALIDARG, cache->Remove(nullptr));
+        Assert::AreEqual(E_INVALIDARG, cache->get_Statistics(nullptr));
+        Assert::AreEqual(E_INVALIDARG, cache->get_MaximumSizeInBytes(nullptr));
+    }
+};
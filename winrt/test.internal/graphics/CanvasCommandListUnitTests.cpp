@@ -213,4 +213,49 @@ TEST_CLASS(CanvasCommandListTests)
         Assert::AreEqual(E_INVALIDARG, f.CommandList->CreateDrawingSession(&ds));
         ValidateStoredErrorState(E_INVALIDARG, Strings::CommandListCannotBeDrawnToAfterItHasBeenUsed);
     }
+
+    TEST_METHOD_EX(CanvasCommandList_RecordInParallelAsync_InvalidArgs)
+    {
+        Fixture f;
+
+        auto handler = Callback<ICanvasCommandListRecordingHandler>([] (ICanvasDrawingSession*, int32_t) { return S_OK; });
+        ComPtr<IAsyncOperation<CanvasCommandList*>> operation;
+
+        Assert::AreEqual(E_INVALIDARG, f.Factory->RecordInParallelAsync(nullptr, 1, handler.Get(), &operation));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->RecordInParallelAsync(f.Device.Get(), 1, nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->RecordInParallelAsync(f.Device.Get(), 1, handler.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->RecordInParallelAsync(f.Device.Get(), -1, handler.Get(), &operation));
+    }
+
+    TEST_METHOD_EX(CanvasCommandList_IsSpatialIndexEnabled_DefaultsToFalse)
+    {
+        Fixture f;
+
+        Assert::AreEqual(E_INVALIDARG, f.CommandList->get_IsSpatialIndexEnabled(nullptr));
+
+        boolean value = true;
+        ThrowIfFailed(f.CommandList->get_IsSpatialIndexEnabled(&value));
+        Assert::IsFalse(!!value);
+
+        ThrowIfFailed(f.CommandList->put_IsSpatialIndexEnabled(true));
+        ThrowIfFailed(f.CommandList->get_IsSpatialIndexEnabled(&value));
+        Assert::IsTrue(!!value);
+    }
+
+    TEST_METHOD_EX(CanvasCommandList_GetCulledD2DImage_ReturnsNullWhenSpatialIndexIsDisabled)
+    {
+        Fixture f;
+
+        auto d2dCommandList = GetWrappedResource<ID2D1CommandList>(f.CommandList);
+        auto mockCl = static_cast<MockD2DCommandList*>(d2dCommandList.Get());
+
+        // Neither closing nor streaming should happen.
+        mockCl->CloseMethod.SetExpectedCalls(0);
+        mockCl->StreamMethod.SetExpectedCalls(0);
+
+        auto stubDeviceContext = Make<StubD2DDeviceContext>();
+
+        auto culledImage = As<ICanvasCommandListInternal>(f.CommandList)->GetCulledD2DImage(f.Device.Get(), stubDeviceContext.Get(), D2D1_RECT_F{ 0, 0, 10, 10 });
+        Assert::IsNull(culledImage.Get());
+    }
 };
@@ -71,6 +71,55 @@ public:
         }
     }
 
+    TEST_METHOD_EX(CanvasDevice_CreateStrokeStyle_WithEveryFieldSet_KeysOnAllOfThem)
+    {
+        Fixture f;
+
+        auto d2dFactory = Make<StubD2DFactoryWithCreateStrokeStyle>();
+        f.DeviceAdapter->m_overrideD2DFactory = d2dFactory;
+
+        auto canvasDevice = CanvasDevice::CreateNew(false);
+
+        D2D1_STROKE_STYLE_PROPERTIES1 properties
+        {
+            D2D1_CAP_STYLE_ROUND,
+            D2D1_CAP_STYLE_SQUARE,
+            D2D1_CAP_STYLE_TRIANGLE,
+            D2D1_LINE_JOIN_ROUND,
+            3.5f,
+            D2D1_DASH_STYLE_CUSTOM,
+            1.5f,
+            D2D1_STROKE_TRANSFORM_TYPE_FIXED
+        };
+
+        std::vector<float> dashes{ 1, 2, 3 };
+
+        auto strokeStyle = canvasDevice->CreateStrokeStyle(properties, dashes);
+
+        Assert::AreEqual(1, d2dFactory->m_numCallsToCreateStrokeStyle);
+        Assert::AreEqual(D2D1_CAP_STYLE_ROUND, d2dFactory->m_startCap);
+        Assert::AreEqual(D2D1_CAP_STYLE_SQUARE, d2dFactory->m_endCap);
+        Assert::AreEqual(D2D1_CAP_STYLE_TRIANGLE, d2dFactory->m_dashCap);
+        Assert::AreEqual(D2D1_LINE_JOIN_ROUND, d2dFactory->m_lineJoin);
+        Assert::AreEqual(3.5f, d2dFactory->m_miterLimit);
+        Assert::AreEqual(D2D1_DASH_STYLE_CUSTOM, d2dFactory->m_dashStyle);
+        Assert::AreEqual(1.5f, d2dFactory->m_dashOffset);
+        Assert::AreEqual(D2D1_STROKE_TRANSFORM_TYPE_FIXED, d2dFactory->m_transformBehavior);
+        Assert::AreEqual<size_t>(3, d2dFactory->m_customDashElements.size());
+
+        // The same values give back the same stroke style.
+        Assert::IsTrue(IsSameInstance(strokeStyle.Get(), canvasDevice->CreateStrokeStyle(properties, dashes).Get()));
+        Assert::AreEqual(1, d2dFactory->m_numCallsToCreateStrokeStyle);
+
+        // Every field is part of the key, including the last one.
+        properties.transformType = D2D1_STROKE_TRANSFORM_TYPE_HAIRLINE;
+
+        auto hairlineStrokeStyle = canvasDevice->CreateStrokeStyle(properties, dashes);
+
+        Assert::AreEqual(2, d2dFactory->m_numCallsToCreateStrokeStyle);
+        Assert::IsFalse(IsSameInstance(strokeStyle.Get(), hairlineStrokeStyle.Get()));
+    }
+
     TEST_METHOD_EX(CanvasDevice_Create_With_Specific_Direct3DDevice)
     {
         ComPtr<StubD3D11Device> stubD3D11Device = Make<StubD3D11Device>();
@@ -104,6 +153,131 @@ public:
             [&] { CanvasDevice::CreateNew(nullptr); });
     }
 
+    TEST_METHOD_EX(CanvasDevice_CreateWithGpuPreference_UsesTheAdapterDxgiPicks)
+    {
+        Fixture f;
+
+        auto dxgiAdapter = Make<StubDxgiAdapter>();
+
+        f.DeviceAdapter->EnumAdapterByGpuPreferenceMethod.SetExpectedCalls(1,
+            [&] (CanvasGpuPreference gpuPreference)
+            {
+                Assert::AreEqual(CanvasGpuPreference::HighPerformance, gpuPreference);
+                return dxgiAdapter;
+            });
+
+        ComPtr<ICanvasDevice> canvasDevice;
+        ThrowIfFailed(Make<CanvasDeviceFactory>()->CreateWithGpuPreference(CanvasGpuPreference::HighPerformance, &canvasDevice));
+
+        Assert::IsTrue(IsSameInstance(dxgiAdapter.Get(), f.DeviceAdapter->m_retrievableDxgiAdapter.Get()));
+        Assert::AreEqual(1, f.DeviceAdapter->m_numD3dDeviceCreationCalls);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_CreateWithGpuPreference_WhenNoAdapterIsFound_FallsBackToTheDefault)
+    {
+        Fixture f;
+
+        f.DeviceAdapter->EnumAdapterByGpuPreferenceMethod.SetExpectedCalls(1,
+            [] (CanvasGpuPreference) { return nullptr; });
+
+        ComPtr<ICanvasDevice> canvasDevice;
+        ThrowIfFailed(Make<CanvasDeviceFactory>()->CreateWithGpuPreference(CanvasGpuPreference::MinimumPower, &canvasDevice));
+
+        Assert::IsNull(f.DeviceAdapter->m_retrievableDxgiAdapter.Get());
+        Assert::IsFalse(f.DeviceAdapter->m_retrievableForceSoftwareRenderer);
+
+        Assert::AreEqual(E_INVALIDARG, Make<CanvasDeviceFactory>()->CreateWithGpuPreference(CanvasGpuPreference::Default, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasDevice_CreateSoftwareDevice_PassesOptionsToTheAdapter)
+    {
+        Fixture f;
+
+        auto options = CanvasSoftwareDeviceOptions::SingleThreaded | CanvasSoftwareDeviceOptions::NoInternalThreading;
+
+        ComPtr<ICanvasDevice> canvasDevice;
+        ThrowIfFailed(Make<CanvasDeviceFactory>()->CreateSoftwareDevice(options, &canvasDevice));
+
+        Assert::AreEqual(options, f.DeviceAdapter->m_retrievableSoftwareDeviceOptions);
+        Assert::AreEqual(1, f.DeviceAdapter->m_numD3dDeviceCreationCalls);
+
+        boolean forceSoftwareRenderer;
+        ThrowIfFailed(canvasDevice->get_ForceSoftwareRenderer(&forceSoftwareRenderer));
+        Assert::IsTrue(!!forceSoftwareRenderer);
+
+        f.AssertDeviceManagerRoundtrip(canvasDevice.Get());
+    }
+
+    TEST_METHOD_EX(CanvasDevice_CreateSoftwareDevice_InvalidArgs)
+    {
+        Fixture f;
+
+        ComPtr<ICanvasDevice> canvasDevice;
+        Assert::AreEqual(E_INVALIDARG, Make<CanvasDeviceFactory>()->CreateSoftwareDevice(CanvasSoftwareDeviceOptions::None, nullptr));
+        Assert::AreEqual(E_INVALIDARG, Make<CanvasDeviceFactory>()->CreateSoftwareDevice(static_cast<CanvasSoftwareDeviceOptions>(4), &canvasDevice));
+        Assert::AreEqual(0, f.DeviceAdapter->m_numD3dDeviceCreationCalls);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_GetPerformanceCounters_NullArg)
+    {
+        Assert::AreEqual(E_INVALIDARG, Make<CanvasDeviceFactory>()->GetPerformanceCounters(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasDevice_GetObjectCounts_TracksLiveAndCreatedObjects)
+    {
+        auto factory = Make<CanvasDeviceFactory>();
+
+        Assert::AreEqual(E_INVALIDARG, factory->GetObjectCounts(nullptr));
+
+        CanvasObjectCounts before;
+        ThrowIfFailed(factory->GetObjectCounts(&before));
+
+        auto textFormat = Make<CanvasTextFormat>();
+
+        CanvasObjectCounts during;
+        ThrowIfFailed(factory->GetObjectCounts(&during));
+
+        Assert::AreEqual<uint64_t>(before.LiveTextFormats + 1, during.LiveTextFormats);
+        Assert::AreEqual<uint64_t>(before.TextFormatsCreated + 1, during.TextFormatsCreated);
+
+        textFormat.Reset();
+
+        CanvasObjectCounts after;
+        ThrowIfFailed(factory->GetObjectCounts(&after));
+
+        Assert::AreEqual<uint64_t>(before.LiveTextFormats, after.LiveTextFormats);
+        Assert::AreEqual<uint64_t>(during.TextFormatsCreated, after.TextFormatsCreated);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_CreateFromAdapterId_LooksUpTheAdapterByLuid)
+    {
+        Fixture f;
+
+        auto dxgiAdapter = Make<StubDxgiAdapter>();
+        ABI::Windows::Graphics::DisplayAdapterId anyAdapterId{ 0x1234, 0x5678 };
+
+        f.DeviceAdapter->EnumAdapterByLuidMethod.SetExpectedCalls(2,
+            [&] (LUID luid)
+            {
+                Assert::AreEqual<DWORD>(anyAdapterId.LowPart, luid.LowPart);
+                Assert::AreEqual<LONG>(anyAdapterId.HighPart, luid.HighPart);
+
+                // The second lookup finds nothing.
+                return f.DeviceAdapter->EnumAdapterByLuidMethod.GetCurrentCallCount() == 1 ? dxgiAdapter : nullptr;
+            });
+
+        auto factory = Make<CanvasDeviceFactory>();
+
+        ComPtr<ICanvasDevice> canvasDevice;
+        ThrowIfFailed(factory->CreateFromAdapterId(anyAdapterId, &canvasDevice));
+
+        Assert::IsTrue(IsSameInstance(dxgiAdapter.Get(), f.DeviceAdapter->m_retrievableDxgiAdapter.Get()));
+
+        canvasDevice.Reset();
+        Assert::AreEqual(E_INVALIDARG, factory->CreateFromAdapterId(anyAdapterId, &canvasDevice));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::AdapterNotFound);
+    }
+
     TEST_METHOD_EX(CanvasDevice_Create_From_D2DDevice)
     {
         auto d2dDevice = Make<MockD2DDevice>(Make<MockD2DFactory>().Get());
@@ -151,6 +325,13 @@ public:
         uint64_t cacheSize;
         Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumCacheSize(&cacheSize));
         Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumCacheSize(0));
+
+        int32_t poolSize;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumDeviceContextPoolSize(&poolSize));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumDeviceContextPoolSize(0));
+
+        ComPtr<ICanvasGpuFence> fence;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->InsertFence(&fence));
     }
 
     ComPtr<ID2D1Device1> GetD2DDevice(ComPtr<ICanvasDevice> const& canvasDevice)
@@ -419,6 +600,80 @@ public:
         ThrowIfFailed(canvasDevice->put_MaximumCacheSize(someOtherValue));
     }
 
+    TEST_METHOD_EX(CanvasDevice_MaximumDeviceContextPoolSize)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumDeviceContextPoolSize(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->put_MaximumDeviceContextPoolSize(-1));
+
+        int32_t value;
+        ThrowIfFailed(canvasDevice->get_MaximumDeviceContextPoolSize(&value));
+        Assert::AreEqual(static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1U)), value);
+
+        ThrowIfFailed(canvasDevice->put_MaximumDeviceContextPoolSize(2));
+        ThrowIfFailed(canvasDevice->get_MaximumDeviceContextPoolSize(&value));
+        Assert::AreEqual(2, value);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_DeviceContextPoolPrewarmCount_DefaultsToZero)
+    {
+        Fixture f;
+
+        auto factory = Make<CanvasDeviceFactory>();
+
+        Assert::AreEqual(E_INVALIDARG, factory->get_DeviceContextPoolPrewarmCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->put_DeviceContextPoolPrewarmCount(-1));
+
+        int32_t value;
+        ThrowIfFailed(factory->get_DeviceContextPoolPrewarmCount(&value));
+        Assert::AreEqual(0, value);
+
+        // No contexts are created up front by default.
+        auto d2dDevice = Make<MockD2DDevice>();
+        d2dDevice->MockCreateDeviceContext =
+            [](D2D1_DEVICE_CONTEXT_OPTIONS, ID2D1DeviceContext1**)
+            {
+                Assert::Fail(L"Unexpected call to CreateDeviceContext");
+            };
+
+        Make<CanvasDevice>(d2dDevice.Get());
+    }
+
+    TEST_METHOD_EX(CanvasDevice_DeviceContextPoolPrewarmCount_AppliesToEveryNewDevice)
+    {
+        Fixture f;
+
+        auto factory = Make<CanvasDeviceFactory>();
+        ThrowIfFailed(factory->put_DeviceContextPoolPrewarmCount(2));
+
+        // A device created to replace a lost one gets the same contexts as
+        // the first, without the app doing anything more.
+        for (int i = 0; i < 2; i++)
+        {
+            auto d2dDevice = Make<MockD2DDevice>();
+
+            int createCount = 0;
+
+            d2dDevice->MockCreateDeviceContext =
+                [&](D2D1_DEVICE_CONTEXT_OPTIONS, ID2D1DeviceContext1** value)
+                {
+                    createCount++;
+                    ThrowIfFailed(Make<StubD2DDeviceContext>(d2dDevice.Get()).CopyTo(value));
+                };
+
+            auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+            Assert::AreEqual(2, createCount);
+
+            // The pooled contexts are what resource creation uses.
+            canvasDevice->GetResourceCreationDeviceContext();
+            Assert::AreEqual(2, createCount);
+        }
+    }
+
     TEST_METHOD_EX(CanvasDevice_CreateCommandList_ReturnsCommandListFromDeviceContext)
     {
         auto d2dDevice = Make<MockD2DDevice>();
@@ -922,6 +1177,13 @@ public:
         Assert::AreEqual(E_INVALIDARG, canvasDeviceFactory->GetSharedDevice(nullptr));
     }
 
+    TEST_METHOD_EX(CanvasGetSharedDeviceTests_PreinitializeAsync_NullArg)
+    {
+        auto canvasDeviceFactory = Make<CanvasDeviceFactory>();
+
+        Assert::AreEqual(E_INVALIDARG, canvasDeviceFactory->PreinitializeAsync(nullptr));
+    }
+
     ComPtr<ICanvasDevice> GetSharedDevice_ExpectForceSoftwareRenderer(
         Fixture& f,
         bool passedInAndExpectedBack)
@@ -1016,6 +1278,39 @@ public:
         Assert::IsNotNull(device2.Get());
     }
 
+    TEST_METHOD_EX(CanvasGetSharedDeviceTests_ExistingDevice_Closed_CreatesNewDevice)
+    {
+        Fixture f;
+
+        auto device = f.SharedDeviceState->GetSharedDevice(false);
+        Assert::AreEqual(S_OK, As<IClosable>(device)->Close());
+
+        auto device2 = f.SharedDeviceState->GetSharedDevice(false);
+        Assert::IsFalse(IsSameInstance(device.Get(), device2.Get()));
+
+        auto device3 = f.SharedDeviceState->GetSharedDevice(false);
+        Assert::IsTrue(IsSameInstance(device2.Get(), device3.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasGetSharedDeviceTests_ExistingDevice_DebugLevelChanged_Fails)
+    {
+        Fixture f;
+
+        auto originalDebugLevel = f.SharedDeviceState->GetDebugLevel();
+        auto otherDebugLevel = (originalDebugLevel == CanvasDebugLevel::None) ? CanvasDebugLevel::Information : CanvasDebugLevel::None;
+
+        auto device = f.SharedDeviceState->GetSharedDevice(false);
+
+        // Called twice, so the second call would normally skip the lock.
+        f.SharedDeviceState->GetSharedDevice(false);
+
+        f.SharedDeviceState->SetDebugLevel(otherDebugLevel);
+        ExpectHResultException(E_FAIL, [&]{ f.SharedDeviceState->GetSharedDevice(false); });
+
+        f.SharedDeviceState->SetDebugLevel(originalDebugLevel);
+        Assert::IsTrue(IsSameInstance(device.Get(), f.SharedDeviceState->GetSharedDevice(false).Get()));
+    }
+
     TEST_METHOD_EX(CanvasGetSharedDeviceTests_ManagerReleasesAllReferences)
     {
         WeakRef weakDevices[2];
@@ -1119,4 +1414,127 @@ public:
 
         f.ValidateEnterLeaveCount(1, 1);
     }
+
+    TEST_METHOD_EX(CanvasDevice_LockStatistics_CountsLocksAndHoldTime)
+    {
+        LockFixture f;
+
+        CanvasLockStatistics statistics;
+        ThrowIfFailed(f.Device->get_LockStatistics(&statistics));
+        Assert::AreEqual(0ULL, statistics.LockCount);
+
+        ComPtr<ICanvasLock> firstLock, secondLock;
+        ThrowIfFailed(f.Device->Lock(&firstLock));
+        ThrowIfFailed(f.Device->Lock(&secondLock));
+
+        Sleep(1);
+        secondLock.Reset();
+
+        ThrowIfFailed(f.Device->get_LockStatistics(&statistics));
+        Assert::AreEqual(2ULL, statistics.LockCount);
+        Assert::IsTrue(statistics.TotalHoldTime.Duration > 0);
+        Assert::AreEqual(statistics.TotalHoldTime.Duration, statistics.MaximumHoldTime.Duration);
+        Assert::IsTrue(statistics.MaximumWaitTime.Duration <= statistics.TotalWaitTime.Duration);
+
+        // A lock still open is counted once it is closed.
+        firstLock.Reset();
+
+        ThrowIfFailed(f.Device->get_LockStatistics(&statistics));
+        Assert::IsTrue(statistics.TotalHoldTime.Duration > statistics.MaximumHoldTime.Duration);
+
+        ThrowIfFailed(f.Device->ResetLockStatistics());
+
+        ThrowIfFailed(f.Device->get_LockStatistics(&statistics));
+        Assert::AreEqual(0ULL, statistics.LockCount);
+        Assert::AreEqual(0LL, statistics.TotalHoldTime.Duration);
+
+        Assert::AreEqual(E_INVALIDARG, f.Device->get_LockStatistics(nullptr));
+    }
+
+    struct MemoryUsageFixture
+    {
+        ComPtr<MockDxgiAdapter> DxgiAdapter;
+        ComPtr<CanvasDevice> Device;
+
+        MemoryUsageFixture()
+            : DxgiAdapter(Make<MockDxgiAdapter>())
+        {
+            auto d3dDevice = Make<MockD3D11Device>();
+            d3dDevice->GetAdapterMethod.AllowAnyCall([=](IDXGIAdapter** value) { return DxgiAdapter.CopyTo(value); });
+
+            Device = Make<CanvasDevice>(Make<StubD2DDevice>().Get(), d3dDevice.Get());
+        }
+    };
+
+    TEST_METHOD_EX(CanvasDevice_MemoryUsage_QueriesLocalVideoMemory)
+    {
+        MemoryUsageFixture f;
+
+        f.DxgiAdapter->QueryVideoMemoryInfoMethod.SetExpectedCalls(1,
+            [](UINT nodeIndex, DXGI_MEMORY_SEGMENT_GROUP group, DXGI_QUERY_VIDEO_MEMORY_INFO* info)
+            {
+                Assert::AreEqual(0u, nodeIndex);
+                Assert::IsTrue(group == DXGI_MEMORY_SEGMENT_GROUP_LOCAL);
+
+                info->Budget = 1000;
+                info->CurrentUsage = 200;
+                info->AvailableForReservation = 300;
+                info->CurrentReservation = 40;
+                return S_OK;
+            });
+
+        CanvasMemoryUsage memoryUsage;
+        ThrowIfFailed(f.Device->get_MemoryUsage(&memoryUsage));
+
+        Assert::AreEqual(1000ULL, memoryUsage.Budget);
+        Assert::AreEqual(200ULL, memoryUsage.CurrentUsage);
+        Assert::AreEqual(300ULL, memoryUsage.AvailableForReservation);
+        Assert::AreEqual(40ULL, memoryUsage.CurrentReservation);
+
+        Assert::AreEqual(E_INVALIDARG, f.Device->get_MemoryUsage(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasDevice_MemoryBudgetChanged_IsRaisedWhenDxgiSignals)
+    {
+        MemoryUsageFixture f;
+
+        HANDLE budgetEvent = nullptr;
+        DWORD const anyCookie = 123;
+
+        f.DxgiAdapter->RegisterVideoMemoryBudgetChangeNotificationEventMethod.SetExpectedCalls(1,
+            [&](HANDLE event, DWORD* cookie)
+            {
+                budgetEvent = event;
+                *cookie = anyCookie;
+                return S_OK;
+            });
+
+        auto handlerCalled = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+        auto eventWarden = MakeScopeWarden([&] { CloseHandle(handlerCalled); });
+
+        auto handler = Callback<DeviceLostHandlerType>(
+            [&](ICanvasDevice* sender, IInspectable*)
+            {
+                Assert::IsTrue(IsSameInstance(f.Device.Get(), sender));
+                SetEvent(handlerCalled);
+                return S_OK;
+            });
+
+        // Subscribing more than once registers with DXGI just the once.
+        EventRegistrationToken token1, token2;
+        ThrowIfFailed(f.Device->add_MemoryBudgetChanged(handler.Get(), &token1));
+        ThrowIfFailed(f.Device->add_MemoryBudgetChanged(handler.Get(), &token2));
+        ThrowIfFailed(f.Device->remove_MemoryBudgetChanged(token2));
+
+        SetEvent(budgetEvent);
+        Assert::AreEqual<DWORD>(WAIT_OBJECT_0, WaitForSingleObjectEx(handlerCalled, 5000, FALSE));
+
+        f.DxgiAdapter->UnregisterVideoMemoryBudgetChangeNotificationMethod.SetExpectedCalls(1,
+            [&](DWORD cookie)
+            {
+                Assert::AreEqual(anyCookie, cookie);
+            });
+
+        ThrowIfFailed(f.Device->Close());
+    }
 };
@@ -6,16 +6,21 @@
 
 #include <lib/effects/generated/GaussianBlurEffect.h>
 #include <lib/geometry/CanvasCachedGeometry.h>
+#include <lib/geometry/CanvasMesh.h>
 #include <lib/images/CanvasCommandList.h>
 #include <lib/svg/CanvasSvgDocument.h>
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 #include <lib/drawing/CanvasGradientMesh.h>
+#include <lib/drawing/CanvasDrawingTrace.h>
 #include "stubs/StubInkAdapter.h"
 #endif
 
+#include "mocks/MockD2DDrawingStateBlock.h"
 #include "mocks/MockD2DGeometryRealization.h"
+#include "mocks/MockD2DMesh.h"
 #include "mocks/MockD2DRectangleGeometry.h"
+#include "mocks/MockD2DEllipseGeometry.h"
 #include "mocks/MockDWriteRenderingParams.h"
 #include "mocks/MockGeometryAdapter.h"
 #include "mocks/MockStream.h"
@@ -177,41 +182,44 @@ class BrushValidator
 {
     bool m_isColorOverload;
     ID2D1Brush* m_expectedBrush;
-    bool m_gotColor2;
+    ID2D1Brush* m_expectedBrush2;
     int m_checkCount;
 
 public:
     BrushValidator(CanvasDrawingSessionFixture const& f, bool isColorOverload)
         : m_isColorOverload(isColorOverload),
           m_expectedBrush(nullptr),
-          m_gotColor2(false),
+          m_expectedBrush2(nullptr),
           m_checkCount(0)
     {
         if (isColorOverload)
         {
             // When testing a WithColor overload, we expect to get two draw calls.
-            // The first draw uses ArbitraryMarkerColor1 and should trigger a call to CreateSolidColorBrush.
-            // The second uses ArbitraryMarkerColor2 and should call SetColor on the previously created brush.
+            // The first draw uses ArbitraryMarkerColor1 and the second uses
+            // ArbitraryMarkerColor2.  Each should trigger a call to
+            // CreateSolidColorBrush, since the session caches one brush per
+            // color rather than changing the color of a single brush.
 
             f.DeviceContext->CreateSolidColorBrushMethod.AllowAnyCall(
                 [&](const D2D1_COLOR_F* color, const D2D1_BRUSH_PROPERTIES* brushProperties, ID2D1SolidColorBrush** solidColorBrush)
                 {
-                    // First we should see a brush created using ArbitraryMarkerColor1.
-                    Assert::IsNull(m_expectedBrush);
-                    Assert::AreEqual(ToD2DColor(ArbitraryMarkerColor1), *color);
-
                     auto brush = Make<MockD2DSolidColorBrush>();
-                    m_expectedBrush = brush.Get();
-                    brush.CopyTo(solidColorBrush);
 
-                    // Then we should see SetColor called with ArbitraryMarkerColor2.
-                    brush->SetColorMethod.AllowAnyCall(
-                        [&](const D2D1_COLOR_F* color)
-                        {
-                            Assert::IsFalse(m_gotColor2);
-                            Assert::AreEqual(ToD2DColor(ArbitraryMarkerColor2), *color);
-                            m_gotColor2 = true;
-                        });
+                    if (!m_expectedBrush)
+                    {
+                        // First we should see a brush created using ArbitraryMarkerColor1.
+                        Assert::AreEqual(ToD2DColor(ArbitraryMarkerColor1), *color);
+                        m_expectedBrush = brush.Get();
+                    }
+                    else
+                    {
+                        // Then we should see a second brush created using ArbitraryMarkerColor2.
+                        Assert::IsNull(m_expectedBrush2);
+                        Assert::AreEqual(ToD2DColor(ArbitraryMarkerColor2), *color);
+                        m_expectedBrush2 = brush.Get();
+                    }
+
+                    brush.CopyTo(solidColorBrush);
 
                     return S_OK;
                 });
@@ -230,22 +238,26 @@ public:
             switch (m_checkCount)
             {
             case 0:
-                // During the first draw call, our brush should have been created but its color not changed yet.
+                // During the first draw call, only the first brush should have been created.
                 Assert::IsNotNull(m_expectedBrush);
-                Assert::IsFalse(m_gotColor2);
+                Assert::IsNull(m_expectedBrush2);
+                Assert::AreEqual(m_expectedBrush, brush);
                 break;
 
             case 1:
-                // During the second draw call, the brush color should have been changed.
-                Assert::IsTrue(m_gotColor2);
+                // During the second draw call, we should be using the second brush.
+                Assert::IsNotNull(m_expectedBrush2);
+                Assert::AreEqual(m_expectedBrush2, brush);
                 break;
 
             default:
                 Assert::Fail();
             }
         }
-
-        Assert::AreEqual(m_expectedBrush, brush);
+        else
+        {
+            Assert::AreEqual(m_expectedBrush, brush);
+        }
 
         m_checkCount++;
     }
@@ -376,6 +388,8 @@ public:
             DeviceContext->GetUnitModeMethod.AllowAnyCall([] { return D2D1_UNIT_MODE_DIPS; });            
 
             DeviceContext->GetImageLocalBoundsMethod.AllowAnyCall();
+
+            DeviceContext->GetTargetMethod.AllowAnyCall([](ID2D1Image** target) { *target = nullptr; });
         }
             
         virtual ~DrawImageFixture()
@@ -1427,6 +1441,122 @@ public:
     }
 
 
+    TEST_METHOD_EX(CanvasDrawingSession_DrawImage_WhenCalledRepeatedlyWithOpacity_ReusesOpacityEffect)
+    {
+        DrawImageNonBitmapFixture f;
+
+        f.Opacity = 0.5f;
+
+        f.DeviceContext->GetTransformMethod.AllowAnyCall();
+        f.DeviceContext->SetTransformMethod.AllowAnyCall();
+
+        ComPtr<StubD2DEffect> opacityEffect;
+
+        f.DeviceContext->CreateEffectMethod.SetExpectedCalls(1,
+            [&](IID const& iid, ID2D1Effect** effect)
+            {
+                opacityEffect = Make<StubD2DEffect>(iid);
+                return opacityEffect.CopyTo(effect);
+            });
+
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(3,
+            [&](ID2D1Image* actualImage, D2D1_POINT_2F const*, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+            {
+                Assert::IsTrue(IsSameInstance(opacityEffect.Get(), actualImage));
+
+                ComPtr<ID2D1Image> actualInput;
+                opacityEffect->GetInput(0, &actualInput);
+                Assert::IsTrue(IsSameInstance(f.D2DCommandList.Get(), actualInput.Get()));
+            });
+
+        f.DrawImageAtOffsetWithSourceRectAndOpacity();
+        f.DrawImageAtOffsetWithSourceRectAndOpacity();
+        f.DrawImageToRectWithSourceRectAndOpacity();
+
+        // The cached effect should not keep the last image alive.
+        ComPtr<ID2D1Image> remainingInput;
+        opacityEffect->GetInput(0, &remainingInput);
+        Assert::IsNull(remainingInput.Get());
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawImage_WhenRecordingCommandList_EachDrawGetsItsOwnOpacityEffect)
+    {
+        DrawImageNonBitmapFixture f;
+
+        f.DeviceContext->GetTransformMethod.AllowAnyCall();
+        f.DeviceContext->SetTransformMethod.AllowAnyCall();
+
+        auto targetCommandList = Make<MockD2DCommandList>();
+
+        f.DeviceContext->GetTargetMethod.AllowAnyCall(
+            [&](ID2D1Image** target)
+            {
+                targetCommandList.CopyTo(target);
+            });
+
+        std::vector<ComPtr<StubD2DEffect>> opacityEffects;
+
+        f.DeviceContext->CreateEffectMethod.SetExpectedCalls(3,
+            [&](IID const& iid, ID2D1Effect** effect)
+            {
+                auto opacityEffect = Make<StubD2DEffect>(iid);
+                opacityEffects.push_back(opacityEffect);
+                return opacityEffect.CopyTo(effect);
+            });
+
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(3,
+            [&](ID2D1Image* actualImage, D2D1_POINT_2F const*, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+            {
+                Assert::IsTrue(IsSameInstance(opacityEffects.back().Get(), actualImage));
+            });
+
+        float opacities[] = { 0.25f, 0.5f, 0.75f };
+
+        for (auto opacity : opacities)
+        {
+            f.Opacity = opacity;
+            f.DrawImageAtOffsetWithSourceRectAndOpacity();
+        }
+
+        // The command list plays back each draw with the effect it recorded,
+        // so every effect must keep its own input and opacity.
+        Assert::AreEqual<size_t>(3, opacityEffects.size());
+
+        for (size_t i = 0; i < opacityEffects.size(); ++i)
+        {
+            ComPtr<ID2D1Image> input;
+            opacityEffects[i]->GetInput(0, &input);
+            Assert::IsTrue(IsSameInstance(f.D2DCommandList.Get(), input.Get()));
+
+            D2D1_MATRIX_5X4_F matrix;
+            ThrowIfFailed(opacityEffects[i]->GetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, &matrix));
+            Assert::AreEqual(opacities[i], matrix._44);
+        }
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawImage_WhenCalledRepeatedlyWithBitmap_ReusesBorderAndDpiCompensationEffects)
+    {
+        DrawImageBitmapFixture f;
+
+        f.Interpolation = CanvasImageInterpolation::Cubic;
+
+        f.DeviceContext->GetTransformMethod.AllowAnyCall();
+        f.DeviceContext->SetTransformMethod.AllowAnyCall();
+
+        f.DeviceContext->CreateEffectMethod.SetExpectedCalls(2,
+            [](IID const& iid, ID2D1Effect** effect)
+            {
+                return Make<StubD2DEffect>(iid).CopyTo(effect);
+            });
+
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(5);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            f.DrawImageToRectWithSourceRectAndOpacityAndInterpolation();
+        }
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_DrawImage_GaussianBlurEffect)
     {
         DrawImageBitmapFixture f;
@@ -1558,6 +1688,17 @@ public:
             });
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_DrawLines)
+    {
+        TestDrawLine(true, 5, false,
+            [](CanvasDrawingSessionFixture const& f, Vector2 p0, Vector2 p1, CanvasStrokeStyle* strokeStyle)
+            {
+                Vector2 points[] = { p0, p1, p0, p1 };
+                Color colors[] = { ArbitraryMarkerColor1, ArbitraryMarkerColor2 };
+                ThrowIfFailed(f.DS->DrawLines(_countof(points), points, _countof(colors), colors, 5));
+            });
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_DrawLineWithBrushAndStrokeWidth)
     {
         TestDrawLine(false, 123, false,
@@ -1775,6 +1916,17 @@ public:
             });
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_DrawRectangles)
+    {
+        TestDrawRectangle(true, 123, false,
+            [](CanvasDrawingSessionFixture const& f, Rect rect, CanvasStrokeStyle* strokeStyle)
+            {
+                Rect rects[] = { rect, rect };
+                Color colors[] = { ArbitraryMarkerColor1, ArbitraryMarkerColor2 };
+                ThrowIfFailed(f.DS->DrawRectangles(_countof(rects), rects, _countof(colors), colors, 123));
+            });
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_DrawRectangleWithBrushAndStrokeWidthAndStrokeStyle)
     {
         TestDrawRectangle(false, 123, true,
@@ -1891,6 +2043,167 @@ public:
             });
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_FillRectangles)
+    {
+        TestFillRectangle(true,
+            [](CanvasDrawingSessionFixture const& f, Rect rect)
+            {
+                Rect rects[] = { rect, rect };
+                Color colors[] = { ArbitraryMarkerColor1, ArbitraryMarkerColor2 };
+                ThrowIfFailed(f.DS->FillRectangles(_countof(rects), rects, _countof(colors), colors));
+            });
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_FillRectangles_WithSingleColor_SetsBrushColorOnce)
+    {
+        CanvasDrawingSessionFixture f;
+
+        ComPtr<MockD2DSolidColorBrush> expectedBrush;
+
+        f.DeviceContext->CreateSolidColorBrushMethod.SetExpectedCalls(1,
+            [&](const D2D1_COLOR_F* color, const D2D1_BRUSH_PROPERTIES*, ID2D1SolidColorBrush** solidColorBrush)
+            {
+                Assert::AreEqual(ToD2DColor(ArbitraryMarkerColor1), *color);
+
+                expectedBrush = Make<MockD2DSolidColorBrush>();
+                return expectedBrush.CopyTo(solidColorBrush);
+            });
+
+        f.DeviceContext->FillRectangleMethod.SetExpectedCalls(3,
+            [&](D2D1_RECT_F const*, ID2D1Brush* brush)
+            {
+                Assert::AreEqual<ID2D1Brush*>(expectedBrush.Get(), brush);
+            });
+
+        Rect rects[] = { Rect{ 1, 2, 3, 4 }, Rect{ 5, 6, 7, 8 }, Rect{ 9, 10, 11, 12 } };
+        ThrowIfFailed(f.DS->FillRectangles(_countof(rects), rects, 1, &ArbitraryMarkerColor1));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_ColorOverloads_WhenColorsAlternate_ReuseCachedBrushes)
+    {
+        CanvasDrawingSessionFixture f;
+
+        std::vector<ComPtr<MockD2DSolidColorBrush>> createdBrushes;
+
+        f.DeviceContext->CreateSolidColorBrushMethod.SetExpectedCalls(2,
+            [&](const D2D1_COLOR_F*, const D2D1_BRUSH_PROPERTIES*, ID2D1SolidColorBrush** solidColorBrush)
+            {
+                auto brush = Make<MockD2DSolidColorBrush>();
+                createdBrushes.push_back(brush);
+                return brush.CopyTo(solidColorBrush);
+            });
+
+        std::vector<ID2D1Brush*> drawnBrushes;
+
+        f.DeviceContext->FillRectangleMethod.AllowAnyCall(
+            [&](D2D1_RECT_F const*, ID2D1Brush* brush)
+            {
+                drawnBrushes.push_back(brush);
+            });
+
+        // Neither brush should ever have its color changed.
+        for (int i = 0; i < 3; ++i)
+        {
+            ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{}, ArbitraryMarkerColor1));
+            ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{}, ArbitraryMarkerColor2));
+        }
+
+        Assert::AreEqual<size_t>(6, drawnBrushes.size());
+
+        for (size_t i = 0; i < drawnBrushes.size(); ++i)
+        {
+            Assert::AreEqual<ID2D1Brush*>(createdBrushes[i % 2].Get(), drawnBrushes[i]);
+        }
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_ColorOverloads_WhenBrushCacheIsFull_RecyclesLeastRecentlyUsedBrush)
+    {
+        CanvasDrawingSessionFixture f;
+
+        auto const capacity = SolidColorBrushCache::Capacity;
+
+        std::vector<ComPtr<MockD2DSolidColorBrush>> createdBrushes;
+
+        f.DeviceContext->CreateSolidColorBrushMethod.SetExpectedCalls(static_cast<int>(capacity),
+            [&](const D2D1_COLOR_F*, const D2D1_BRUSH_PROPERTIES*, ID2D1SolidColorBrush** solidColorBrush)
+            {
+                auto brush = Make<MockD2DSolidColorBrush>();
+                createdBrushes.push_back(brush);
+                return brush.CopyTo(solidColorBrush);
+            });
+
+        ID2D1Brush* lastDrawnBrush = nullptr;
+
+        f.DeviceContext->FillRectangleMethod.AllowAnyCall(
+            [&](D2D1_RECT_F const*, ID2D1Brush* brush)
+            {
+                lastDrawnBrush = brush;
+            });
+
+        // Fill the cache, then touch the first color again so that the second
+        // one becomes the least recently used.
+        for (uint8_t i = 0; i < capacity; ++i)
+        {
+            ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{}, Color{ 255, i, 0, 0 }));
+        }
+
+        ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{}, Color{ 255, 0, 0, 0 }));
+        Assert::AreEqual<ID2D1Brush*>(createdBrushes[0].Get(), lastDrawnBrush);
+
+        // A new color should recycle the brush that was created for the second color.
+        Color newColor{ 255, 0, 0, 255 };
+
+        createdBrushes[1]->SetColorMethod.SetExpectedCalls(1,
+            [&](const D2D1_COLOR_F* color)
+            {
+                Assert::AreEqual(ToD2DColor(newColor), *color);
+            });
+
+        ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{}, newColor));
+        Assert::AreEqual<ID2D1Brush*>(createdBrushes[1].Get(), lastDrawnBrush);
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_BatchedPrimitives_InvalidArgs)
+    {
+        CanvasDrawingSessionFixture f;
+
+        Rect rects[2] = {};
+        Vector2 points[4] = {};
+        float radii[2] = {};
+        Color colors[3] = {};
+
+        // Mismatched array sizes.
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillRectangles(2, rects, 3, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillRectangles(2, rects, 0, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawRectangles(2, rects, 3, colors, 1));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawLines(4, points, 3, colors, 1));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillCircles(2, points, 3, radii, 1, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillCircles(2, points, 2, radii, 3, colors));
+
+        // Lines need pairs of points.
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawLines(3, points, 1, colors, 1));
+
+        // Null arrays.
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillRectangles(2, nullptr, 1, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillRectangles(2, rects, 1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawRectangles(2, nullptr, 1, colors, 1));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawLines(4, nullptr, 1, colors, 1));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillCircles(2, nullptr, 1, radii, 1, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillCircles(2, points, 1, nullptr, 1, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawCachedGeometryInstances(f.CachedGeometry.Get(), 2, nullptr, 1, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawCachedGeometryInstances(f.CachedGeometry.Get(), 2, points, 1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawCachedGeometryInstances(nullptr, 2, points, 1, colors));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawCachedGeometryInstancesWithTransforms(f.CachedGeometry.Get(), 2, nullptr, 1, colors));
+
+        // Empty batches are fine, and don't draw anything.
+        Assert::AreEqual(S_OK, f.DS->FillRectangles(0, nullptr, 0, nullptr));
+        Assert::AreEqual(S_OK, f.DS->DrawRectangles(0, nullptr, 0, nullptr, 1));
+        Assert::AreEqual(S_OK, f.DS->DrawLines(0, nullptr, 0, nullptr, 1));
+        Assert::AreEqual(S_OK, f.DS->FillCircles(0, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(S_OK, f.DS->DrawCachedGeometryInstances(f.CachedGeometry.Get(), 0, nullptr, 0, nullptr));
+        Assert::AreEqual(S_OK, f.DS->DrawCachedGeometryInstancesWithTransforms(f.CachedGeometry.Get(), 0, nullptr, 0, nullptr));
+    }
+
     class FillOpacityMaskFixture : public CanvasDrawingSessionFixture
     {
     public:
@@ -2853,6 +3166,18 @@ public:
             });
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_FillCircles)
+    {
+        TestFillEllipse(true, 23, 23,
+            [](CanvasDrawingSessionFixture const& f, Vector2 point)
+            {
+                Vector2 centerPoints[] = { point, point };
+                float radius = 23;
+                Color colors[] = { ArbitraryMarkerColor1, ArbitraryMarkerColor2 };
+                ThrowIfFailed(f.DS->FillCircles(_countof(centerPoints), centerPoints, 1, &radius, _countof(colors), colors));
+            });
+    }
+
     //
     // DrawGeometry
     //
@@ -3618,6 +3943,141 @@ public:
         ThrowIfFailed(f.DS->DrawCachedGeometryWithBrush(f.CachedGeometry.Get(), f.DrawOffset, f.Brush.Get()));
     }
 
+    template<typename TDraw>
+    void TestDrawCachedGeometryInstances(std::vector<D2D1_MATRIX_3X2_F> const& expectedInstanceTransforms, TDraw const& callDrawFunction)
+    {
+        CanvasDrawingSessionFixture f;
+        BrushValidator brushValidator(f, true);
+
+        D2D1::Matrix3x2F sessionTransform = D2D1::Matrix3x2F::Scale(2, 3);
+        D2D1_MATRIX_3X2_F currentTransform = sessionTransform;
+        int drawCount = 0;
+
+        ComPtr<ID2D1GeometryRealization> nativeGeometryRealizationResource = f.CachedGeometry->GetResource();
+
+        f.DeviceContext->GetTransformMethod.SetExpectedCalls(1,
+            [&](D2D1_MATRIX_3X2_F* transform)
+            {
+                *transform = currentTransform;
+            });
+
+        f.DeviceContext->SetTransformMethod.SetExpectedCalls(static_cast<int>(expectedInstanceTransforms.size()) + 1,
+            [&](D2D1_MATRIX_3X2_F const* newTransform)
+            {
+                currentTransform = *newTransform;
+            });
+
+        f.DeviceContext->DrawGeometryRealizationMethod.SetExpectedCalls(static_cast<int>(expectedInstanceTransforms.size()),
+            [&](ID2D1GeometryRealization* geometryRealization, ID2D1Brush* brush)
+            {
+                auto expectedTransform = *D2D1::Matrix3x2F::ReinterpretBaseType(&expectedInstanceTransforms[drawCount]) * sessionTransform;
+                Assert::AreEqual<D2D1_MATRIX_3X2_F>(expectedTransform, currentTransform);
+
+                Assert::AreEqual(nativeGeometryRealizationResource.Get(), geometryRealization);
+                brushValidator.Check(brush);
+
+                drawCount++;
+            });
+
+        callDrawFunction(f);
+
+        // The session transform is put back afterwards.
+        Assert::AreEqual<D2D1_MATRIX_3X2_F>(sessionTransform, currentTransform);
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawCachedGeometryInstances)
+    {
+        TestDrawCachedGeometryInstances({ D2D1::Matrix3x2F::Translation(1, 2), D2D1::Matrix3x2F::Translation(3, 4) },
+            [](CanvasDrawingSessionFixture const& f)
+            {
+                Vector2 offsets[] = { Vector2{ 1, 2 }, Vector2{ 3, 4 } };
+                Color colors[] = { ArbitraryMarkerColor1, ArbitraryMarkerColor2 };
+                ThrowIfFailed(f.DS->DrawCachedGeometryInstances(f.CachedGeometry.Get(), _countof(offsets), offsets, _countof(colors), colors));
+            });
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawCachedGeometryInstancesWithTransforms)
+    {
+        Matrix3x2 transforms[] = { Matrix3x2{ 1, 2, 3, 4, 5, 6 }, Matrix3x2{ 7, 8, 9, 10, 11, 12 } };
+
+        TestDrawCachedGeometryInstances({ *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transforms[0]), *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transforms[1]) },
+            [&](CanvasDrawingSessionFixture const& f)
+            {
+                Color colors[] = { ArbitraryMarkerColor1, ArbitraryMarkerColor2 };
+                ThrowIfFailed(f.DS->DrawCachedGeometryInstancesWithTransforms(f.CachedGeometry.Get(), _countof(transforms), transforms, _countof(colors), colors));
+            });
+    }
+
+    //
+    // FillMesh
+    //
+
+    template<typename TDraw>
+    void TestFillMesh(bool isColorOverload, D2D1_ANTIALIAS_MODE antialiasMode, TDraw const& callDrawFunction)
+    {
+        CanvasDrawingSessionFixture f;
+        BrushValidator brushValidator(f, isColorOverload);
+
+        int expectedFillMeshCount = isColorOverload ? 2 : 1;
+        bool expectModeChange = antialiasMode != D2D1_ANTIALIAS_MODE_ALIASED;
+
+        auto d2dMesh = Make<MockD2DMesh>();
+        auto mesh = Make<CanvasMesh>(f.CanvasDevice.Get(), d2dMesh.Get());
+
+        auto currentMode = antialiasMode;
+
+        f.DeviceContext->GetAntialiasModeMethod.SetExpectedCalls(expectedFillMeshCount, [&] { return currentMode; });
+
+        f.DeviceContext->SetAntialiasModeMethod.SetExpectedCalls(expectModeChange ? expectedFillMeshCount * 2 : 0,
+            [&](D2D1_ANTIALIAS_MODE mode)
+            {
+                currentMode = mode;
+            });
+
+        f.DeviceContext->FillMeshMethod.SetExpectedCalls(expectedFillMeshCount,
+            [&](ID2D1Mesh* actualMesh, ID2D1Brush* brush)
+            {
+                Assert::AreEqual(D2D1_ANTIALIAS_MODE_ALIASED, currentMode);
+                Assert::IsTrue(IsSameInstance(d2dMesh.Get(), actualMesh));
+                brushValidator.Check(brush);
+            });
+
+        callDrawFunction(f, mesh.Get());
+
+        Assert::AreEqual(antialiasMode, currentMode);
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_FillMeshWithBrush)
+    {
+        for (auto mode : { D2D1_ANTIALIAS_MODE_PER_PRIMITIVE, D2D1_ANTIALIAS_MODE_ALIASED })
+        {
+            TestFillMesh(false, mode,
+                [](CanvasDrawingSessionFixture const& f, CanvasMesh* mesh)
+                {
+                    ThrowIfFailed(f.DS->FillMesh(mesh, f.Brush.Get()));
+                });
+        }
+
+        // Null brush or mesh.
+        CanvasDrawingSessionFixture f;
+        auto mesh = Make<CanvasMesh>(f.CanvasDevice.Get(), Make<MockD2DMesh>().Get());
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillMesh(mesh.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.DS->FillMesh(nullptr, f.Brush.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_FillMeshWithColor)
+    {
+        for (auto mode : { D2D1_ANTIALIAS_MODE_PER_PRIMITIVE, D2D1_ANTIALIAS_MODE_ALIASED })
+        {
+            TestFillMesh(true, mode,
+                [](CanvasDrawingSessionFixture const& f, CanvasMesh* mesh)
+                {
+                    ThrowIfFailed(f.DS->FillMeshWithColor(mesh, ArbitraryMarkerColor1));
+                    ThrowIfFailed(f.DS->FillMeshWithColor(mesh, ArbitraryMarkerColor2));
+                });
+        }
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_StateGettersWithNull)
     {
         CanvasDrawingSessionFixture f;
@@ -3999,6 +4459,47 @@ public:
         Assert::AreEqual(anyTransform, retrievedTransform);
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_PushTransform_CombinesWithTransform_AndPopTransformRestoresIt)
+    {
+        OffsetFixture f;
+
+        Numerics::Matrix3x2 initialTransform = { 2, 0, 0, 2, 10, 20 };
+        ThrowIfFailed(f.DrawingSession->put_Transform(initialTransform));
+
+        Numerics::Matrix3x2 pushedTransform = { 1, 0, 0, 1, 3, 4 };
+        ThrowIfFailed(f.DrawingSession->PushTransform(pushedTransform));
+
+        // The pushed transform applies first, so its translation is scaled by the initial one.
+        Numerics::Matrix3x2 transform;
+        ThrowIfFailed(f.DrawingSession->get_Transform(&transform));
+        Assert::AreEqual(Numerics::Matrix3x2{ 2, 0, 0, 2, 16, 28 }, transform);
+
+        D2D1_MATRIX_3X2_F expectedNativeTransform = D2D1::Matrix3x2F(2, 0, 0, 2, 16.0f + AnyOffsetX, 28.0f + AnyOffsetY);
+        Assert::AreEqual(expectedNativeTransform, f.NativeTransform);
+
+        ThrowIfFailed(f.DrawingSession->PushTransform(pushedTransform));
+        ThrowIfFailed(f.DrawingSession->get_Transform(&transform));
+        Assert::AreEqual(Numerics::Matrix3x2{ 2, 0, 0, 2, 22, 36 }, transform);
+
+        ThrowIfFailed(f.DrawingSession->PopTransform());
+        ThrowIfFailed(f.DrawingSession->get_Transform(&transform));
+        Assert::AreEqual(Numerics::Matrix3x2{ 2, 0, 0, 2, 16, 28 }, transform);
+
+        ThrowIfFailed(f.DrawingSession->PopTransform());
+        ThrowIfFailed(f.DrawingSession->get_Transform(&transform));
+        Assert::AreEqual(initialTransform, transform);
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_PopTransform_WithoutPushTransform_ExceptionIsThrown)
+    {
+        OffsetFixture f;
+
+        f.DeviceContext->SetTransformMethod.SetExpectedCalls(0);
+
+        Assert::AreEqual(E_FAIL, f.DrawingSession->PopTransform());
+        ValidateStoredErrorState(E_FAIL, Strings::PopTransformWithoutPush);
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_get_Device)
     {
         //
@@ -4202,6 +4703,175 @@ public:
         ThrowIfFailed(drawingSession->put_EffectTileSize(expectedBitmapSize));
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_Trace_RecordsSolidColorCallsAndSkipsOthers)
+    {
+        CanvasDrawingSessionFixture f;
+        auto trace = Make<CanvasDrawingTrace>();
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->get_Trace(nullptr));
+
+        ComPtr<ICanvasDrawingTrace> retrievedTrace;
+        ThrowIfFailed(f.DS->get_Trace(&retrievedTrace));
+        Assert::IsNull(retrievedTrace.Get());
+
+        ThrowIfFailed(f.DS->put_Trace(trace.Get()));
+        ThrowIfFailed(f.DS->get_Trace(&retrievedTrace));
+        Assert::IsTrue(IsSameInstance(trace.Get(), retrievedTrace.Get()));
+
+        f.DeviceContext->GetTransformMethod.AllowAnyCall([](D2D1_MATRIX_3X2_F* transform) { *transform = D2D1::Matrix3x2F::Identity(); });
+        f.DeviceContext->GetAntialiasModeMethod.AllowAnyCall([] { return D2D1_ANTIALIAS_MODE_PER_PRIMITIVE; });
+        f.DeviceContext->GetPrimitiveBlendMethod.AllowAnyCall([] { return D2D1_PRIMITIVE_BLEND_SOURCE_OVER; });
+        f.DeviceContext->FillRectangleMethod.AllowAnyCall();
+
+        f.DeviceContext->CreateSolidColorBrushMethod.AllowAnyCall(
+            [](D2D1_COLOR_F const* color, D2D1_BRUSH_PROPERTIES const*, ID2D1SolidColorBrush** solidColorBrush)
+            {
+                auto brush = Make<MockD2DSolidColorBrush>();
+                auto brushColor = *color;
+                brush->GetColorMethod.AllowAnyCall([=] { return brushColor; });
+                brush->GetOpacityMethod.AllowAnyCall([] { return 1.0f; });
+                return brush.CopyTo(solidColorBrush);
+            });
+
+        // A color is recorded, but StubCanvasBrush isn't a solid color brush.
+        ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{ 1, 2, 3, 4 }, ArbitraryMarkerColor1));
+        ThrowIfFailed(f.DS->FillRectangleWithBrush(Rect{ 1, 2, 3, 4 }, f.Brush.Get()));
+
+        uint32_t callCount;
+        ThrowIfFailed(trace->get_CallCount(&callCount));
+        Assert::AreEqual(1u, callCount);
+
+        uint32_t skippedCallCount;
+        ThrowIfFailed(trace->get_SkippedCallCount(&skippedCallCount));
+        Assert::AreEqual(1u, skippedCallCount);
+
+        // Nothing more is recorded once the trace is removed.
+        ThrowIfFailed(f.DS->put_Trace(nullptr));
+        ThrowIfFailed(f.DS->FillRectangleWithColor(Rect{ 1, 2, 3, 4 }, ArbitraryMarkerColor1));
+
+        ThrowIfFailed(trace->get_CallCount(&callCount));
+        Assert::AreEqual(1u, callCount);
+    }
+
+    class DrawingStateFixture : public CanvasDrawingSessionFixture
+    {
+    public:
+        ComPtr<MockD2DDrawingStateBlock> StateBlock;
+
+        DrawingStateFixture()
+            : StateBlock(Make<MockD2DDrawingStateBlock>())
+        {
+            DeviceContext->m_factory->MockCreateDrawingStateBlock = [=](auto, auto, ID2D1DrawingStateBlock1** result)
+            {
+                return StateBlock.CopyTo(result);
+            };
+
+            DeviceContext->GetTransformMethod.AllowAnyCall(
+                [](D2D1_MATRIX_3X2_F* m)
+                {
+                    *m = D2D1::Matrix3x2F(1, 2, 3, 4, 5, 6);
+                });
+
+            DeviceContext->GetUnitModeMethod.AllowAnyCall(
+                [] { return D2D1_UNIT_MODE_DIPS; });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasDrawingSession_SaveDrawingState_SavesIntoNewStateBlock)
+    {
+        DrawingStateFixture f;
+
+        f.DeviceContext->SaveDrawingStateMethod.SetExpectedCalls(1,
+            [&](ID2D1DrawingStateBlock* stateBlock)
+            {
+                Assert::IsTrue(IsSameInstance(f.StateBlock.Get(), stateBlock));
+            });
+
+        ComPtr<ICanvasDrawingState> drawingState;
+        ThrowIfFailed(f.DS->SaveDrawingState(&drawingState));
+        Assert::IsNotNull(drawingState.Get());
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->SaveDrawingState(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_RestoreDrawingState_RestoresSavedStateBlock)
+    {
+        DrawingStateFixture f;
+
+        f.DeviceContext->SaveDrawingStateMethod.AllowAnyCall();
+
+        ComPtr<ICanvasDrawingState> drawingState;
+        ThrowIfFailed(f.DS->SaveDrawingState(&drawingState));
+
+        f.DeviceContext->RestoreDrawingStateMethod.SetExpectedCalls(1,
+            [&](ID2D1DrawingStateBlock* stateBlock)
+            {
+                Assert::IsTrue(IsSameInstance(f.StateBlock.Get(), stateBlock));
+            });
+
+        // Same offset, so the restored transform is left alone.
+        f.DeviceContext->SetTransformMethod.SetExpectedCalls(0);
+
+        ThrowIfFailed(f.DS->RestoreDrawingState(drawingState.Get()));
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->RestoreDrawingState(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_RestoreDrawingState_FromDifferentDevice_Fails)
+    {
+        DrawingStateFixture f1;
+        DrawingStateFixture f2;
+
+        f1.DeviceContext->SaveDrawingStateMethod.AllowAnyCall();
+
+        ComPtr<ICanvasDrawingState> drawingState;
+        ThrowIfFailed(f1.DS->SaveDrawingState(&drawingState));
+
+        Assert::AreEqual(E_INVALIDARG, f2.DS->RestoreDrawingState(drawingState.Get()));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::DrawingStateFromDifferentDevice);
+    }
+
+    TEST_METHOD_EX(CanvasDrawingState_Properties_ReportSavedState)
+    {
+        DrawingStateFixture f;
+
+        f.DeviceContext->SaveDrawingStateMethod.AllowAnyCall();
+
+        f.StateBlock->Description.antialiasMode = D2D1_ANTIALIAS_MODE_ALIASED;
+        f.StateBlock->Description.primitiveBlend = D2D1_PRIMITIVE_BLEND_ADD;
+        f.StateBlock->Description.textAntialiasMode = D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE;
+        f.StateBlock->Description.unitMode = D2D1_UNIT_MODE_PIXELS;
+
+        ComPtr<ICanvasDrawingState> drawingState;
+        ThrowIfFailed(f.DS->SaveDrawingState(&drawingState));
+
+        Numerics::Matrix3x2 transform;
+        ThrowIfFailed(drawingState->get_Transform(&transform));
+        Assert::AreEqual(Numerics::Matrix3x2{ 1, 2, 3, 4, 5, 6 }, transform);
+
+        CanvasAntialiasing antialiasing;
+        ThrowIfFailed(drawingState->get_Antialiasing(&antialiasing));
+        Assert::AreEqual(CanvasAntialiasing::Aliased, antialiasing);
+
+        CanvasBlend blend;
+        ThrowIfFailed(drawingState->get_Blend(&blend));
+        Assert::AreEqual(CanvasBlend::Add, blend);
+
+        CanvasTextAntialiasing textAntialiasing;
+        ThrowIfFailed(drawingState->get_TextAntialiasing(&textAntialiasing));
+        Assert::AreEqual(CanvasTextAntialiasing::Grayscale, textAntialiasing);
+
+        CanvasUnits units;
+        ThrowIfFailed(drawingState->get_Units(&units));
+        Assert::AreEqual(CanvasUnits::Pixels, units);
+
+        Assert::AreEqual(E_INVALIDARG, drawingState->get_Transform(nullptr));
+        Assert::AreEqual(E_INVALIDARG, drawingState->get_Antialiasing(nullptr));
+        Assert::AreEqual(E_INVALIDARG, drawingState->get_Blend(nullptr));
+        Assert::AreEqual(E_INVALIDARG, drawingState->get_TextAntialiasing(nullptr));
+        Assert::AreEqual(E_INVALIDARG, drawingState->get_Units(nullptr));
+    }
+
 #if WINVER > _WIN32_WINNT_WINBLUE
 
     TEST_METHOD_EX(CanvasDrawingSession_DrawInk_NullArg)
@@ -4747,6 +5417,41 @@ TEST_CLASS(CanvasDrawingSession_DrawTextTests)
             });
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_DrawTextFromBuffer_PassesCallersBufferToD2D)
+    {
+        Fixture f;
+
+        // Only the first five characters are drawn, so the buffer needn't
+        // be null terminated after them.
+        wchar_t const buffer[] = L"hello world";
+
+        std::vector<D2D1_RECT_F> expectedRects{ D2D1_RECT_F{ 23, 42, 23, 42 }, D2D1_RECT_F{ 1, 2, 4, 6 } };
+        int callIndex = 0;
+
+        f.DeviceContext->DrawTextMethod.SetExpectedCalls(2,
+            [&](wchar_t const* actualText,
+                uint32_t actualTextLength,
+                IDWriteTextFormat* format,
+                D2D1_RECT_F const* actualRect,
+                ID2D1Brush*,
+                D2D1_DRAW_TEXT_OPTIONS,
+                DWRITE_MEASURING_MODE)
+            {
+                Assert::IsTrue(buffer == actualText);
+                Assert::AreEqual(5u, actualTextLength);
+                Assert::IsNotNull(format);
+                Assert::AreEqual(expectedRects[callIndex++], *actualRect);
+            });
+
+        auto native = As<ICanvasDrawingSessionNative>(f.DS);
+
+        ThrowIfFailed(native->DrawTextFromBufferAtPoint(buffer, 5, 23, 42, f.Brush.Get(), nullptr));
+        ThrowIfFailed(native->DrawTextFromBufferAtRect(buffer, 5, 1, 2, 3, 4, f.Brush.Get(), f.Format.Get()));
+
+        Assert::AreEqual(E_INVALIDARG, native->DrawTextFromBufferAtPoint(buffer, 5, 0, 0, nullptr, nullptr));
+        Assert::AreEqual(E_INVALIDARG, native->DrawTextFromBufferAtRect(nullptr, 0, 0, 0, 0, 0, f.Brush.Get(), nullptr));
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_DrawTextAtPoint_DoesNotModifyOriginalFormat)
     {
         Fixture f;
@@ -4776,6 +5481,44 @@ TEST_CLASS(CanvasDrawingSession_DrawTextTests)
             Color{ 1, 2, 3, 4 },
             f.Format.Get()));
     }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawText_WithTextLayoutCache_ReusesLayoutUntilFormatChanges)
+    {
+        Fixture f;
+
+        f.CanvasDevice->GetTextLayoutCache()->SetMaximumCount(4);
+
+        f.DeviceContext->DrawTextMethod.SetExpectedCalls(0);
+
+        std::vector<ComPtr<IDWriteTextLayout>> layouts;
+
+        f.DeviceContext->DrawTextLayoutMethod.SetExpectedCalls(3,
+            [&](D2D1_POINT_2F point, IDWriteTextLayout* textLayout, ID2D1Brush*, D2D1_DRAW_TEXT_OPTIONS)
+            {
+                Assert::AreEqual(1.0f, point.x);
+                Assert::AreEqual(2.0f, point.y);
+                Assert::AreEqual(3.0f, textLayout->GetMaxWidth());
+                Assert::AreEqual(4.0f, textLayout->GetMaxHeight());
+
+                layouts.push_back(textLayout);
+            });
+
+        WinString text(L"test");
+
+        ThrowIfFailed(f.DS->DrawTextAtRectWithColorAndFormat(text, Rect{ 1, 2, 3, 4 }, Color{}, f.Format.Get()));
+        ThrowIfFailed(f.DS->DrawTextAtRectWithColorAndFormat(text, Rect{ 1, 2, 3, 4 }, Color{}, f.Format.Get()));
+
+        ThrowIfFailed(f.Format->put_FontSize(50));
+        ThrowIfFailed(f.DS->DrawTextAtRectWithColorAndFormat(text, Rect{ 1, 2, 3, 4 }, Color{}, f.Format.Get()));
+
+        Assert::IsTrue(IsSameInstance(layouts[0].Get(), layouts[1].Get()));
+        Assert::IsFalse(IsSameInstance(layouts[1].Get(), layouts[2].Get()));
+        Assert::AreEqual(50.0f, layouts[2]->GetFontSize());
+
+        auto statistics = f.CanvasDevice->GetTextLayoutCache()->GetStatistics();
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(2, statistics.MissCount);
+    }
 };
 
 TEST_CLASS(CanvasDrawingSession_CloseTests)
@@ -4943,9 +5686,31 @@ TEST_CLASS(CanvasDrawingSession_CloseTests)
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRun(Vector2{}, nullptr, 0, 0, nullptr, false, 0u, nullptr));
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRunWithMeasuringMode(Vector2{}, nullptr, 0, 0, nullptr, false, 0u, nullptr, CanvasTextMeasuringMode::Natural));
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRunWithMeasuringModeAndDescription(Vector2{}, nullptr, 0, 0, nullptr, false, 0u, nullptr, CanvasTextMeasuringMode::Natural, nullptr, nullptr, 0, nullptr, 0));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRunObject(Vector2{}, nullptr, nullptr));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRunObjectWithMeasuringMode(Vector2{}, nullptr, nullptr, CanvasTextMeasuringMode::Natural));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRuns(0, nullptr, 0, nullptr, nullptr));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawGlyphRunsWithBrushes(0, nullptr, 0, nullptr, 0, nullptr));
+
+        ComPtr<ICanvasProfileScope> profileScope;
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->BeginProfileScope(nullptr, &profileScope));
+
+        ComPtr<ICanvasDrawingState> drawingState;
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->SaveDrawingState(&drawingState));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->RestoreDrawingState(nullptr));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->PushTransform(Matrix3x2{}));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->PopTransform());
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->PushClip(Rect{}));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->PopClip());
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawRenderNode(nullptr));
+
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->FillRectangles(0, nullptr, 0, nullptr));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawRectangles(0, nullptr, 0, nullptr, 0));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawLines(0, nullptr, 0, nullptr, 0));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->FillCircles(0, nullptr, 0, nullptr, 0, nullptr));
 
 #if WINVER > _WIN32_WINNT_WINBLUE
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawInk(nullptr));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->DrawInkWithCache(nullptr, false, nullptr));
 #endif
 
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->get_Antialiasing(nullptr));
@@ -4962,6 +5727,8 @@ TEST_CLASS(CanvasDrawingSession_CloseTests)
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->put_EffectBufferPrecision(nullptr));
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->get_EffectTileSize(nullptr));
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->put_EffectTileSize(BitmapSize{}));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->get_Trace(nullptr));
+        EXPECT_OBJECT_CLOSED(canvasDrawingSession->put_Trace(nullptr));
         EXPECT_OBJECT_CLOSED(canvasDrawingSession->get_Device(&deviceVerify));
 
 
@@ -5002,6 +5769,42 @@ TEST_CLASS(CanvasDrawingSession_CloseTests)
         Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunWithMeasuringModeAndDescription(Vector2{}, fakeFontFace, 0, 1, &glyph, false, 0u, nullptr, CanvasTextMeasuringMode::Natural, nullptr, nullptr, 0, nullptr, 0));
 
     }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawGlyphRunObject_NullArg)
+    {
+        CanvasDrawingSessionFixture f;
+
+        ICanvasGlyphRun* fakeGlyphRun = reinterpret_cast<ICanvasGlyphRun*>(0x12345678);
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunObject(Vector2{}, nullptr, f.Brush.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunObject(Vector2{}, fakeGlyphRun, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunObjectWithMeasuringMode(Vector2{}, nullptr, f.Brush.Get(), CanvasTextMeasuringMode::Natural));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunObjectWithMeasuringMode(Vector2{}, fakeGlyphRun, nullptr, CanvasTextMeasuringMode::Natural));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawGlyphRuns_InvalidArgs)
+    {
+        CanvasDrawingSessionFixture f;
+
+        Vector2 points[2]{};
+        ICanvasGlyphRun* glyphRuns[2]{};
+        ICanvasBrush* brushes[2] = { f.Brush.Get(), f.Brush.Get() };
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRuns(0, nullptr, 0, nullptr, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRuns(1, points, 2, glyphRuns, f.Brush.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRuns(2, nullptr, 2, glyphRuns, f.Brush.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRuns(2, points, 2, nullptr, f.Brush.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRuns(2, points, 2, glyphRuns, f.Brush.Get()));
+
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunsWithBrushes(2, points, 2, glyphRuns, 1, brushes));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunsWithBrushes(2, points, 2, glyphRuns, 2, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.DS->DrawGlyphRunsWithBrushes(2, points, 2, glyphRuns, 2, brushes));
+
+        // Nothing to draw is not an error.
+        Assert::AreEqual(S_OK, f.DS->DrawGlyphRuns(0, nullptr, 0, nullptr, f.Brush.Get()));
+        Assert::AreEqual(S_OK, f.DS->DrawGlyphRunsWithBrushes(0, nullptr, 0, nullptr, 0, nullptr));
+    }
 };
 
 TEST_CLASS(CanvasDrawingSession_Interop)
@@ -5082,6 +5885,19 @@ TEST_CLASS(CanvasDrawingSession_CreateLayerTests)
                     *transform = returnValue;
                 });
         }
+
+        ComPtr<CanvasGeometry> MakeRectangleGeometry(D2D1_RECT_F rect)
+        {
+            auto d2dGeometry = Make<MockD2DRectangleGeometry>();
+
+            d2dGeometry->GetRectMethod.AllowAnyCall(
+                [=](D2D1_RECT_F* result)
+                {
+                    *result = rect;
+                });
+
+            return Make<CanvasGeometry>(CanvasDevice.Get(), d2dGeometry.Get());
+        }
     };
 
     TEST_METHOD_EX(CanvasDrawingSession_CreateLayerWithOpacity)
@@ -5256,6 +6072,96 @@ TEST_CLASS(CanvasDrawingSession_CreateLayerTests)
         ValidateStoredErrorState(E_FAIL, Strings::DidNotPopLayer);
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_PushClip_WhenTransformIsScaleAndTranslate_UsesAxisAlignedClip)
+    {
+        Fixture f;
+
+        const Rect expectedRect{ 1, 2, 3, 4 };
+
+        f.ExpectOneGetTransform(D2D1_MATRIX_3X2_F{ 2, 0, 0, 3, 4, 5 });
+
+        f.DeviceContext->PushAxisAlignedClipMethod.SetExpectedCalls(1,
+            [=](D2D1_RECT_F const* clipRect, D2D1_ANTIALIAS_MODE antialiasMode)
+            {
+                Assert::AreEqual(expectedRect, FromD2DRect(*clipRect));
+                Assert::AreEqual(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE, antialiasMode);
+            });
+
+        ThrowIfFailed(f.DS->PushClip(expectedRect));
+
+        f.DeviceContext->PopAxisAlignedClipMethod.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.DS->PopClip());
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_PushClip_WhenTransformIsComplex_UsesLayer)
+    {
+        Fixture f;
+
+        const Rect expectedRect{ 1, 2, 3, 4 };
+
+        f.ExpectOneGetTransform(D2D1_MATRIX_3X2_F{ 1, 2, 3, 4, 5, 6 });
+
+        f.DeviceContext->PushLayerMethod.SetExpectedCalls(1,
+            [=](D2D1_LAYER_PARAMETERS1 const* parameters, ID2D1Layer* layer)
+            {
+                Assert::AreEqual(expectedRect, FromD2DRect(parameters->contentBounds));
+                Assert::IsNull(parameters->geometricMask);
+                Assert::IsNull(parameters->opacityBrush);
+                Assert::AreEqual(1.0f, parameters->opacity);
+                Assert::IsNull(layer);
+            });
+
+        ThrowIfFailed(f.DS->PushClip(expectedRect));
+
+        f.DeviceContext->PopLayerMethod.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.DS->PopClip());
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_PopClip_WithoutPushClip_ExceptionIsThrown)
+    {
+        Fixture f;
+
+        Assert::AreEqual(E_FAIL, f.DS->PopClip());
+        ValidateStoredErrorState(E_FAIL, Strings::PoppedWrongClip);
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_PushClip_NestsWithLayers)
+    {
+        Fixture f;
+        f.DeviceContext->GetTransformMethod.AllowAnyCall();
+        f.DeviceContext->PushAxisAlignedClipMethod.AllowAnyCall();
+        f.DeviceContext->PushLayerMethod.AllowAnyCall();
+
+        ThrowIfFailed(f.DS->PushClip(Rect{ 1, 2, 3, 4 }));
+
+        ComPtr<ICanvasActiveLayer> activeLayer;
+        ThrowIfFailed(f.DS->CreateLayerWithOpacity(0.5f, &activeLayer));
+
+        // The layer was created after the clip, so must be closed first.
+        Assert::AreEqual(E_FAIL, f.DS->PopClip());
+        ValidateStoredErrorState(E_FAIL, Strings::PoppedWrongClip);
+
+        f.DeviceContext->PopLayerMethod.SetExpectedCalls(1);
+        ThrowIfFailed(As<IClosable>(activeLayer)->Close());
+
+        f.DeviceContext->PopAxisAlignedClipMethod.SetExpectedCalls(1);
+        ThrowIfFailed(f.DS->PopClip());
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_PushClip_WhenClipNotPopped_ExceptionIsThrown)
+    {
+        Fixture f;
+        f.DeviceContext->GetTransformMethod.AllowAnyCall();
+        f.DeviceContext->PushAxisAlignedClipMethod.AllowAnyCall();
+
+        ThrowIfFailed(f.DS->PushClip(Rect{ 1, 2, 3, 4 }));
+
+        Assert::AreEqual(E_FAIL, As<IClosable>(f.DS)->Close());
+        ValidateStoredErrorState(E_FAIL, Strings::DidNotPopClip);
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_CreateLayer_WhenClipRectTransformIsScaleAndTranslate_UsesAxisAlignedClip)
     {
         Fixture f;
@@ -5287,6 +6193,74 @@ TEST_CLASS(CanvasDrawingSession_CreateLayerTests)
         ThrowIfFailed(f.DS->CreateLayerWithOpacityAndClipRectangle(1.0f, Rect{ 1, 2, 3, 4 }, &activeLayer));
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_CreateLayer_WhenClipGeometryIsRectangle_UsesAxisAlignedClip)
+    {
+        Fixture f;
+
+        auto geometry = f.MakeRectangleGeometry(D2D1_RECT_F{ 1, 2, 3, 4 });
+
+        f.ExpectOneGetTransform(D2D1_MATRIX_3X2_F{ 2, 0, 0, 3, 4, 5 });
+
+        f.DeviceContext->PushAxisAlignedClipMethod.SetExpectedCalls(1,
+            [=](D2D1_RECT_F const* clipRect, D2D1_ANTIALIAS_MODE)
+            {
+                // The geometry transform is flipped horizontally, scaled, and translated.
+                Assert::AreEqual(D2D1_RECT_F{ -3 * 2 + 10, 2 * 4 + 20, -1 * 2 + 10, 4 * 4 + 20 }, *clipRect);
+            });
+
+        ComPtr<ICanvasActiveLayer> activeLayer;
+        ThrowIfFailed(f.DS->CreateLayerWithOpacityAndClipGeometryAndTransform(1.0f, geometry.Get(), Matrix3x2{ -2, 0, 0, 4, 10, 20 }, &activeLayer));
+
+        f.DeviceContext->PopAxisAlignedClipMethod.SetExpectedCalls(1);
+        ThrowIfFailed(As<IClosable>(activeLayer)->Close());
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_CreateLayer_WhenClipGeometryIsRectangle_IntersectsWithClipRectangle)
+    {
+        Fixture f;
+
+        auto geometry = f.MakeRectangleGeometry(D2D1_RECT_F{ 0, 0, 10, 10 });
+
+        f.ExpectOneGetTransform(D2D1_MATRIX_3X2_F{ 1, 0, 0, 1, 0, 0 });
+
+        f.DeviceContext->PushAxisAlignedClipMethod.SetExpectedCalls(1,
+            [=](D2D1_RECT_F const* clipRect, D2D1_ANTIALIAS_MODE)
+            {
+                Assert::AreEqual(D2D1_RECT_F{ 5, 6, 10, 10 }, *clipRect);
+            });
+
+        ComPtr<ICanvasActiveLayer> activeLayer;
+        ThrowIfFailed(f.DS->CreateLayerWithAllOptions(1.0f, nullptr, Rect{ 5, 6, 20, 20 }, geometry.Get(), Matrix3x2{ 1, 0, 0, 1, 0, 0 }, CanvasLayerOptions::None, &activeLayer));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_CreateLayer_WhenClipGeometryIsRotated_DoesNotUseAxisAlignedClip)
+    {
+        Fixture f;
+
+        auto geometry = f.MakeRectangleGeometry(D2D1_RECT_F{ 1, 2, 3, 4 });
+
+        f.ExpectOneGetTransform(D2D1_MATRIX_3X2_F{ 1, 0, 0, 1, 0, 0 });
+
+        f.DeviceContext->PushLayerMethod.SetExpectedCalls(1);
+
+        ComPtr<ICanvasActiveLayer> activeLayer;
+        ThrowIfFailed(f.DS->CreateLayerWithOpacityAndClipGeometryAndTransform(1.0f, geometry.Get(), Matrix3x2{ 0, 1, -1, 0, 0, 0 }, &activeLayer));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_CreateLayer_WhenClipGeometryIsNotRectangle_DoesNotUseAxisAlignedClip)
+    {
+        Fixture f;
+
+        auto geometry = Make<CanvasGeometry>(f.CanvasDevice.Get(), Make<MockD2DEllipseGeometry>().Get());
+
+        f.ExpectOneGetTransform(D2D1_MATRIX_3X2_F{ 1, 0, 0, 1, 0, 0 });
+
+        f.DeviceContext->PushLayerMethod.SetExpectedCalls(1);
+
+        ComPtr<ICanvasActiveLayer> activeLayer;
+        ThrowIfFailed(f.DS->CreateLayerWithOpacityAndClipGeometry(1.0f, geometry.Get(), &activeLayer));
+    }
+
     TEST_METHOD_EX(CanvasDrawingSession_CreateLayer_AxisAlignedClip_UsesAntialiasModeFromDeviceContext)
     {
         Fixture f;
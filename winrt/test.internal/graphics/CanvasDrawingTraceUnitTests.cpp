@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/drawing/CanvasDrawingTrace.h>
+
+#include "mocks/MockCanvasDrawingSession.h"
+
+TEST_CLASS(CanvasDrawingTraceUnitTests)
+{
+    // Builds trace bytes by hand, the way GetBytes lays them out.
+    class TraceWriter
+    {
+    public:
+        std::vector<uint8_t> Bytes;
+
+        TraceWriter(uint32_t magic = DrawingTraceHeader::ExpectedMagic, uint32_t version = DrawingTraceHeader::CurrentVersion)
+        {
+            DrawingTraceHeader header{ magic, version };
+            Append(&header, sizeof(header));
+        }
+
+        void Add(DrawingTraceOp op, void const* payload = nullptr, uint32_t size = 0)
+        {
+            DrawingTraceRecordHeader header{ op, size };
+            Append(&header, sizeof(header));
+            Append(payload, size);
+        }
+
+        template<typename T>
+        void Add(DrawingTraceOp op, T const& payload)
+        {
+            Add(op, &payload, sizeof(payload));
+        }
+
+    private:
+        void Append(void const* data, uint32_t size)
+        {
+            auto bytes = static_cast<uint8_t const*>(data);
+            Bytes.insert(Bytes.end(), bytes, bytes + size);
+        }
+    };
+
+    static HRESULT Load(CanvasDrawingTrace* trace, TraceWriter& writer)
+    {
+        return trace->Load(static_cast<uint32_t>(writer.Bytes.size()), writer.Bytes.data());
+    }
+
+    static uint32_t GetCallCount(CanvasDrawingTrace* trace)
+    {
+        uint32_t value;
+        ThrowIfFailed(trace->get_CallCount(&value));
+        return value;
+    }
+
+    static uint32_t GetSkippedCallCount(CanvasDrawingTrace* trace)
+    {
+        uint32_t value;
+        ThrowIfFailed(trace->get_SkippedCallCount(&value));
+        return value;
+    }
+
+    TEST_METHOD_EX(CanvasDrawingTrace_InvalidArguments)
+    {
+        auto trace = Make<CanvasDrawingTrace>();
+        ABI::Windows::Foundation::TimeSpan elapsedTime;
+        uint32_t byteCount;
+        BYTE* bytes;
+
+        Assert::AreEqual(E_INVALIDARG, trace->get_CallCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, trace->get_SkippedCallCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, trace->GetBytes(nullptr, &bytes));
+        Assert::AreEqual(E_INVALIDARG, trace->GetBytes(&byteCount, nullptr));
+        Assert::AreEqual(E_INVALIDARG, trace->Load(0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, trace->Replay(nullptr, &elapsedTime));
+        Assert::AreEqual(E_INVALIDARG, trace->Replay(Make<MockCanvasDrawingSession>().Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingTrace_NewTrace_HasOnlyHeader)
+    {
+        auto trace = Make<CanvasDrawingTrace>();
+
+        Assert::AreEqual(0u, GetCallCount(trace.Get()));
+        Assert::AreEqual(0u, GetSkippedCallCount(trace.Get()));
+
+        ComArray<BYTE> bytes;
+        ThrowIfFailed(trace->GetBytes(bytes.GetAddressOfSize(), bytes.GetAddressOfData()));
+
+        TraceWriter expected;
+        Assert::AreEqual<uint32_t>(static_cast<uint32_t>(expected.Bytes.size()), bytes.GetSize());
+        Assert::AreEqual(0, memcmp(expected.Bytes.data(), bytes.GetData(), bytes.GetSize()));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingTrace_Load_CountsCallsAndRoundTrips)
+    {
+        TraceWriter writer;
+        writer.Add(DrawingTraceOp::BeginSession);
+        writer.Add(DrawingTraceOp::SetState, DrawingTraceState{ { 1, 0, 0, 1, 0, 0 }, CanvasAntialiasing::Antialiased, CanvasBlend::SourceOver });
+        writer.Add(DrawingTraceOp::FillRectangle, DrawingTraceRectangle{ { 1, 2, 3, 4 }, { 1, 0, 0, 1 }, 0 });
+        writer.Add(DrawingTraceOp::Skipped);
+        writer.Add(DrawingTraceOp::Skipped);
+
+        auto trace = Make<CanvasDrawingTrace>();
+        ThrowIfFailed(Load(trace.Get(), writer));
+
+        Assert::AreEqual(1u, GetCallCount(trace.Get()));
+        Assert::AreEqual(2u, GetSkippedCallCount(trace.Get()));
+
+        ComArray<BYTE> bytes;
+        ThrowIfFailed(trace->GetBytes(bytes.GetAddressOfSize(), bytes.GetAddressOfData()));
+
+        Assert::AreEqual<uint32_t>(static_cast<uint32_t>(writer.Bytes.size()), bytes.GetSize());
+        Assert::AreEqual(0, memcmp(writer.Bytes.data(), bytes.GetData(), bytes.GetSize()));
+
+        ThrowIfFailed(trace->Clear());
+
+        Assert::AreEqual(0u, GetCallCount(trace.Get()));
+        Assert::AreEqual(0u, GetSkippedCallCount(trace.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingTrace_Load_RejectsInvalidData)
+    {
+        auto trace = Make<CanvasDrawingTrace>();
+
+        TraceWriter valid;
+        valid.Add(DrawingTraceOp::Skipped);
+        ThrowIfFailed(Load(trace.Get(), valid));
+
+        auto assertIsInvalid = [&](TraceWriter& writer)
+        {
+            Assert::AreEqual(E_INVALIDARG, Load(trace.Get(), writer));
+            ValidateStoredErrorState(E_INVALIDARG, Strings::InvalidDrawingTrace);
+
+            // A failed load leaves the trace as it was.
+            Assert::AreEqual(1u, GetSkippedCallCount(trace.Get()));
+        };
+
+        // Wrong magic or version.
+        TraceWriter wrongMagic(0x12345678);
+        assertIsInvalid(wrongMagic);
+
+        TraceWriter wrongVersion(DrawingTraceHeader::ExpectedMagic, DrawingTraceHeader::CurrentVersion + 1);
+        assertIsInvalid(wrongVersion);
+
+        // Too short for a header.
+        TraceWriter truncatedHeader;
+        truncatedHeader.Bytes.resize(sizeof(DrawingTraceHeader) - 1);
+        assertIsInvalid(truncatedHeader);
+
+        // Record runs past the end.
+        TraceWriter truncatedRecord;
+        truncatedRecord.Add(DrawingTraceOp::FillRectangle, DrawingTraceRectangle{});
+        truncatedRecord.Bytes.pop_back();
+        assertIsInvalid(truncatedRecord);
+
+        // Unknown op.
+        TraceWriter unknownOp;
+        unknownOp.Add(DrawingTraceOp::Count);
+        assertIsInvalid(unknownOp);
+
+        // Payload the wrong size for its op.
+        TraceWriter wrongSize;
+        wrongSize.Add(DrawingTraceOp::Clear, DrawingTraceRectangle{});
+        assertIsInvalid(wrongSize);
+
+        // Geometry drawn before it is defined.
+        TraceWriter undefinedGeometry;
+        undefinedGeometry.Add(DrawingTraceOp::FillGeometry, DrawingTraceGeometry{ 0, { 1, 1, 1, 1 }, 0 });
+        assertIsInvalid(undefinedGeometry);
+
+        // Geometry whose commands don't match its segment data.
+        struct
+        {
+            DrawingTraceGeometryDefinition Definition;
+            CanvasGeometryPathCommand Command;
+            float SegmentData[2];
+        } badGeometry{ { 0, 1, 2 }, CanvasGeometryPathCommand::BeginFigure, { 0, 0 } };
+
+        TraceWriter mismatchedGeometry;
+        mismatchedGeometry.Add(DrawingTraceOp::DefineGeometry, badGeometry);
+        assertIsInvalid(mismatchedGeometry);
+    }
+
+    class RecordingDrawingSession : public MockCanvasDrawingSession
+    {
+    public:
+        std::vector<std::wstring> Calls;
+        Matrix3x2 LastTransform;
+        Rect LastRect;
+        Color LastColor;
+
+        IFACEMETHODIMP put_Transform(Matrix3x2 value) override
+        {
+            Calls.push_back(L"Transform");
+            LastTransform = value;
+            return S_OK;
+        }
+
+        IFACEMETHODIMP put_Antialiasing(CanvasAntialiasing) override
+        {
+            Calls.push_back(L"Antialiasing");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP put_Blend(CanvasBlend) override
+        {
+            Calls.push_back(L"Blend");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP ClearHdr(Vector4) override
+        {
+            Calls.push_back(L"Clear");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP FillRectangleWithColor(Rect rect, Color color) override
+        {
+            Calls.push_back(L"FillRectangle");
+            LastRect = rect;
+            LastColor = color;
+            return S_OK;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasDrawingTrace_Replay_MakesRecordedCalls)
+    {
+        Matrix3x2 transform{ 2, 0, 0, 2, 10, 20 };
+        Rect rect{ 1, 2, 3, 4 };
+
+        TraceWriter writer;
+        writer.Add(DrawingTraceOp::BeginSession);
+        writer.Add(DrawingTraceOp::SetState, DrawingTraceState{ transform, CanvasAntialiasing::Aliased, CanvasBlend::Copy });
+        writer.Add(DrawingTraceOp::Clear, D2D1_COLOR_F{ 0, 0, 0, 1 });
+        writer.Add(DrawingTraceOp::Skipped);
+        writer.Add(DrawingTraceOp::FillRectangle, DrawingTraceRectangle{ rect, { 0, 0, 1, 1 }, 0 });
+
+        auto trace = Make<CanvasDrawingTrace>();
+        ThrowIfFailed(Load(trace.Get(), writer));
+
+        auto drawingSession = Make<RecordingDrawingSession>();
+
+        ABI::Windows::Foundation::TimeSpan elapsedTime{ -1 };
+        ThrowIfFailed(trace->Replay(drawingSession.Get(), &elapsedTime));
+
+        std::vector<std::wstring> expectedCalls{ L"Transform", L"Antialiasing", L"Blend", L"Clear", L"FillRectangle" };
+
+        Assert::AreEqual<size_t>(expectedCalls.size(), drawingSession->Calls.size());
+        for (size_t i = 0; i < expectedCalls.size(); i++)
+            Assert::AreEqual(expectedCalls[i], drawingSession->Calls[i]);
+
+        Assert::AreEqual(transform, drawingSession->LastTransform);
+        Assert::AreEqual(rect, drawingSession->LastRect);
+        Assert::AreEqual(Color{ 255, 0, 0, 255 }, drawingSession->LastColor);
+
+        Assert::IsTrue(elapsedTime.Duration >= 0);
+    }
+};
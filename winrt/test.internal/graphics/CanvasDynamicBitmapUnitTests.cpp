@@ -0,0 +1,245 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/effects/generated/GaussianBlurEffect.h>
+#include <lib/images/CanvasDynamicBitmap.h>
+
+static const uint32_t TestWidth = 8;
+static const uint32_t TestHeight = 4;
+
+TEST_CLASS(CanvasDynamicBitmapUnitTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        std::vector<ComPtr<StubD2DBitmap>> Bitmaps;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+        {
+        }
+
+        ComPtr<CanvasDynamicBitmap> Create(int32_t bufferCount)
+        {
+            Device->CreateBitmapFromBytesMethod.SetExpectedCalls(bufferCount,
+                [=](uint8_t* bytes, uint32_t pitch, int32_t width, int32_t height, float dpi, DirectXPixelFormat format, CanvasAlphaMode alpha)
+                {
+                    Assert::AreEqual(TestWidth * 4u, pitch);
+                    Assert::AreEqual<int32_t>(TestWidth, width);
+                    Assert::AreEqual<int32_t>(TestHeight, height);
+                    Assert::AreEqual(DEFAULT_DPI, dpi);
+                    Assert::AreEqual(PIXEL_FORMAT(B8G8R8A8UIntNormalized), format);
+                    Assert::AreEqual(CanvasAlphaMode::Premultiplied, alpha);
+
+                    for (uint32_t i = 0; i < pitch * height; i++)
+                        Assert::AreEqual<uint8_t>(0, bytes[i]);
+
+                    auto bitmap = Make<StubD2DBitmap>();
+                    Bitmaps.push_back(bitmap);
+                    return bitmap;
+                });
+
+            return CanvasDynamicBitmap::CreateNew(
+                Device.Get(),
+                static_cast<int32_t>(TestWidth),
+                static_cast<int32_t>(TestHeight),
+                PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                CanvasAlphaMode::Premultiplied,
+                bufferCount);
+        }
+
+        void ExpectCopyFromMemory(int bitmapIndex, D2D1_RECT_U expectedRect)
+        {
+            Bitmaps[bitmapIndex]->CopyFromMemoryMethod.SetExpectedCalls(1,
+                [=](D2D1_RECT_U const* rect, void const*, UINT32 pitch)
+                {
+                    Assert::AreEqual(expectedRect, *rect);
+                    Assert::AreEqual((expectedRect.right - expectedRect.left) * 4, pitch);
+                    return S_OK;
+                });
+        }
+
+        void ExpectCopyFromBitmap(int bitmapIndex, int sourceIndex, D2D1_RECT_U expectedRect)
+        {
+            auto source = Bitmaps[sourceIndex];
+
+            Bitmaps[bitmapIndex]->CopyFromBitmapMethod.SetExpectedCalls(1,
+                [=](D2D1_POINT_2U const* destPoint, ID2D1Bitmap* bitmap, D2D1_RECT_U const* sourceRect)
+                {
+                    Assert::AreEqual(expectedRect.left, destPoint->x);
+                    Assert::AreEqual(expectedRect.top, destPoint->y);
+                    Assert::IsTrue(IsSameInstance(source.Get(), bitmap));
+                    Assert::AreEqual(expectedRect, *sourceRect);
+                    return S_OK;
+                });
+        }
+
+        ComPtr<ID2D1Image> GetCurrentImage(CanvasDynamicBitmap* dynamicBitmap)
+        {
+            return dynamicBitmap->GetD2DImage(nullptr, nullptr, GetImageFlags::None, DEFAULT_DPI, nullptr);
+        }
+    };
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_Create_InvalidArgs)
+    {
+        auto factory = Make<CanvasDynamicBitmapFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(Make<StubCanvasDevice>());
+        auto format = PIXEL_FORMAT(B8G8R8A8UIntNormalized);
+        auto alpha = CanvasAlphaMode::Premultiplied;
+
+        ComPtr<ICanvasDynamicBitmap> dynamicBitmap;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, 1, 1, format, alpha, &dynamicBitmap));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 1, 1, format, alpha, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 0, 1, format, alpha, &dynamicBitmap));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 1, -1, format, alpha, &dynamicBitmap));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithBufferCount(resourceCreator.Get(), 1, 1, format, alpha, 0, &dynamicBitmap));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 4, 4, PIXEL_FORMAT(BC1UIntNormalized), alpha, &dynamicBitmap));
+    }
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_Create_MakesOneBitmapPerBuffer)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(3);
+
+        int32_t bufferCount;
+        ThrowIfFailed(dynamicBitmap->get_BufferCount(&bufferCount));
+        Assert::AreEqual(3, bufferCount);
+
+        BitmapSize size;
+        ThrowIfFailed(dynamicBitmap->get_SizeInPixels(&size));
+        Assert::AreEqual(TestWidth, size.Width);
+        Assert::AreEqual(TestHeight, size.Height);
+
+        Assert::IsTrue(IsSameInstance(f.Bitmaps[0].Get(), f.GetCurrentImage(dynamicBitmap.Get()).Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_SetPixelBytes_InvalidArgs)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(2);
+        std::vector<uint8_t> bytes(TestWidth * TestHeight * 4);
+        auto count = static_cast<uint32_t>(bytes.size());
+
+        Assert::AreEqual(E_INVALIDARG, dynamicBitmap->SetPixelBytes(count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, dynamicBitmap->SetPixelBytes(count - 1, bytes.data()));
+        ValidateStoredErrorState(E_INVALIDARG, L"The array was expected to be of size 128; actual array was of size 127.");
+
+        Assert::AreEqual(E_INVALIDARG, dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), -1, 0, 1, 1));
+        Assert::AreEqual(E_INVALIDARG, dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 0, 0, 0, 1));
+        Assert::AreEqual(E_INVALIDARG, dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 1, 0, static_cast<int32_t>(TestWidth), 1));
+        Assert::AreEqual(E_INVALIDARG, dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 0, 0, 2, static_cast<int32_t>(TestHeight) + 1));
+    }
+
+    //
+    // Drawing a buffer makes the next update fence it, which needs a real
+    // D3D device, so these tests only look at which buffer is current once
+    // they are done updating.
+    //
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_SetPixelBytes_RotatesBetweenBuffers)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(3);
+        std::vector<uint8_t> bytes(TestWidth * TestHeight * 4);
+        D2D1_RECT_U wholeBitmap{ 0, 0, TestWidth, TestHeight };
+
+        for (int expectedBuffer : { 1, 2, 0, 1 })
+        {
+            f.ExpectCopyFromMemory(expectedBuffer, wholeBitmap);
+            ThrowIfFailed(dynamicBitmap->SetPixelBytes(static_cast<uint32_t>(bytes.size()), bytes.data()));
+        }
+
+        Assert::IsTrue(IsSameInstance(f.Bitmaps[1].Get(), f.GetCurrentImage(dynamicBitmap.Get()).Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_SetPixelBytesWithSubrectangle_CopiesWhatTheBufferMissedOnTheGpu)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(2);
+        std::vector<uint8_t> bytes(TestWidth * TestHeight * 4);
+        auto count = static_cast<uint32_t>(bytes.size());
+
+        // Buffer 1 gets the first update, which buffer 0 then misses.
+        f.ExpectCopyFromMemory(1, D2D1_RECT_U{ 0, 0, 2, 2 });
+        ThrowIfFailed(dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 0, 0, 2, 2));
+
+        f.ExpectCopyFromBitmap(0, 1, D2D1_RECT_U{ 0, 0, 2, 2 });
+        f.ExpectCopyFromMemory(0, D2D1_RECT_U{ 4, 1, 6, 3 });
+        ThrowIfFailed(dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 4, 1, 2, 2));
+
+        // An update that covers everything buffer 1 missed needs no copy.
+        f.ExpectCopyFromMemory(1, D2D1_RECT_U{ 3, 0, 7, 4 });
+        ThrowIfFailed(dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 3, 0, 4, 4));
+
+        // Buffer 0 has missed that one only.
+        f.ExpectCopyFromBitmap(0, 1, D2D1_RECT_U{ 3, 0, 7, 4 });
+        f.ExpectCopyFromMemory(0, D2D1_RECT_U{ 0, 0, 1, 1 });
+        ThrowIfFailed(dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 0, 0, 1, 1));
+    }
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_SetPixelBytes_WhenUsedAsEffectSource_InvalidatesRealizedGraphs)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(2);
+        std::vector<uint8_t> bytes(TestWidth * TestHeight * 4);
+        auto count = static_cast<uint32_t>(bytes.size());
+
+        auto effect = Make<Effects::GaussianBlurEffect>();
+        ThrowIfFailed(effect->put_Source(As<IGraphicsEffectSource>(dynamicBitmap).Get()));
+
+        auto generation = Effects::CanvasEffect::GetRealizedGraphGeneration();
+
+        // Moving to the next buffer changes the D2D image the effect must be given.
+        f.ExpectCopyFromMemory(1, D2D1_RECT_U{ 0, 0, TestWidth, TestHeight });
+        ThrowIfFailed(dynamicBitmap->SetPixelBytes(count, bytes.data()));
+
+        Assert::AreNotEqual(generation, Effects::CanvasEffect::GetRealizedGraphGeneration());
+        Assert::IsTrue(IsSameInstance(f.Bitmaps[1].Get(), f.GetCurrentImage(dynamicBitmap.Get()).Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_WithOneBuffer_UpdatesInPlace)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(1);
+        std::vector<uint8_t> bytes(TestWidth * TestHeight * 4);
+        auto count = static_cast<uint32_t>(bytes.size());
+
+        f.Bitmaps[0]->CopyFromMemoryMethod.SetExpectedCalls(2,
+            [](D2D1_RECT_U const*, void const*, UINT32) { return S_OK; });
+
+        ThrowIfFailed(dynamicBitmap->SetPixelBytesWithSubrectangle(count, bytes.data(), 0, 0, 2, 2));
+        Assert::IsTrue(IsSameInstance(f.Bitmaps[0].Get(), f.GetCurrentImage(dynamicBitmap.Get()).Get()));
+
+        ThrowIfFailed(dynamicBitmap->SetPixelBytes(count, bytes.data()));
+        Assert::IsTrue(IsSameInstance(f.Bitmaps[0].Get(), f.GetCurrentImage(dynamicBitmap.Get()).Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDynamicBitmap_Closed)
+    {
+        Fixture f;
+
+        auto dynamicBitmap = f.Create(2);
+        std::vector<uint8_t> bytes(TestWidth * TestHeight * 4);
+
+        Assert::AreEqual(S_OK, dynamicBitmap->Close());
+
+        ComPtr<ICanvasDevice> device;
+        int32_t bufferCount;
+
+        Assert::AreEqual(RO_E_CLOSED, dynamicBitmap->get_Device(&device));
+        Assert::AreEqual(RO_E_CLOSED, dynamicBitmap->get_BufferCount(&bufferCount));
+        Assert::AreEqual(RO_E_CLOSED, dynamicBitmap->SetPixelBytes(static_cast<uint32_t>(bytes.size()), bytes.data()));
+        ExpectHResultException(RO_E_CLOSED, [&] { f.GetCurrentImage(dynamicBitmap.Get()); });
+    }
+};
@@ -0,0 +1,433 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/effects/CanvasEffectGraphTemplate.h>
+#include <lib/effects/generated/ColorMatrixEffect.h>
+#include <lib/effects/generated/CompositeEffect.h>
+#include <lib/effects/generated/GaussianBlurEffect.h>
+#include <lib/effects/generated/Transform2DEffect.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+TEST_CLASS(CanvasEffectGraphTemplateUnitTests)
+{
+    class TestInput : public RuntimeClass<IGraphicsEffectSource>
+    {
+        InspectableClass(L"TestInput", BaseTrust);
+    };
+
+    static ComPtr<ICanvasEffectGraphTemplate> Compile(IGraphicsEffect* rootEffect)
+    {
+        auto factory = Make<CanvasEffectGraphTemplateFactory>();
+
+        ComPtr<ICanvasEffectGraphTemplate> graphTemplate;
+        ThrowIfFailed(factory->Compile(rootEffect, &graphTemplate));
+
+        return graphTemplate;
+    }
+
+    static ComArray<ComPtr<IGraphicsEffect>> CompileOptimizedAndInstantiate(
+        IGraphicsEffect* rootEffect,
+        CanvasEffectGraphOptimizations optimizations = CanvasEffectGraphOptimizations::RemoveRedundantEffects)
+    {
+        auto factory = Make<CanvasEffectGraphTemplateFactory>();
+
+        ComPtr<ICanvasEffectGraphTemplate> graphTemplate;
+        ThrowIfFailed(factory->CompileOptimizedWithOptions(rootEffect, optimizations, &graphTemplate));
+
+        uint32_t inputCount;
+        ThrowIfFailed(graphTemplate->get_InputCount(&inputCount));
+
+        std::vector<IGraphicsEffectSource*> inputs(inputCount);
+
+        ComArray<ComPtr<IGraphicsEffect>> effects;
+        ThrowIfFailed(graphTemplate->Instantiate(inputCount, inputs.data(), effects.GetAddressOfSize(), effects.GetAddressOfData()));
+
+        return effects;
+    }
+
+    static ComPtr<CanvasBitmap> MakeBitmap(DXGI_FORMAT format)
+    {
+        auto d2dBitmap = Make<StubD2DBitmap>();
+        d2dBitmap->GetPixelFormatMethod.AllowAnyCall([=] { return D2D1::PixelFormat(format, D2D1_ALPHA_MODE_PREMULTIPLIED); });
+
+        return Make<CanvasBitmap>(nullptr, d2dBitmap.Get());
+    }
+
+    static void AssertBufferPrecision(IGraphicsEffect* effect, CanvasBufferPrecision expected)
+    {
+        ComPtr<IReference<CanvasBufferPrecision>> bufferPrecision;
+        ThrowIfFailed(As<ICanvasEffect>(effect)->get_BufferPrecision(&bufferPrecision));
+        Assert::IsNotNull(bufferPrecision.Get());
+
+        CanvasBufferPrecision value;
+        ThrowIfFailed(bufferPrecision->get_Value(&value));
+        Assert::AreEqual(expected, value);
+    }
+
+    static void AssertBufferPrecisionIsNull(IGraphicsEffect* effect)
+    {
+        ComPtr<IReference<CanvasBufferPrecision>> bufferPrecision;
+        ThrowIfFailed(As<ICanvasEffect>(effect)->get_BufferPrecision(&bufferPrecision));
+        Assert::IsNull(bufferPrecision.Get());
+    }
+
+    static ComPtr<IGraphicsEffectSource> GetSource(ICompositeEffect* effect, unsigned int index)
+    {
+        ComPtr<IVector<IGraphicsEffectSource*>> sources;
+        ThrowIfFailed(effect->get_Sources(&sources));
+
+        ComPtr<IGraphicsEffectSource> source;
+        ThrowIfFailed(sources->GetAt(index, &source));
+
+        return source;
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_Instantiate_CopiesEffectsAndBindsInputs)
+    {
+        auto originalInput = Make<TestInput>();
+        auto replacedInput = Make<TestInput>();
+
+        auto blur = Make<GaussianBlurEffect>();
+        ThrowIfFailed(blur->put_BlurAmount(7));
+        ThrowIfFailed(blur->put_Source(originalInput.Get()));
+
+        // The blur is used twice, and should stay shared in the copies.
+        auto composite = Make<CompositeEffect>();
+        ThrowIfFailed(composite->put_Mode(CanvasComposite::Xor));
+
+        ComPtr<IVector<IGraphicsEffectSource*>> compositeSources;
+        ThrowIfFailed(composite->get_Sources(&compositeSources));
+        ThrowIfFailed(compositeSources->Append(blur.Get()));
+        ThrowIfFailed(compositeSources->Append(replacedInput.Get()));
+        ThrowIfFailed(compositeSources->Append(blur.Get()));
+
+        auto graphTemplate = Compile(composite.Get());
+
+        uint32_t count;
+        ThrowIfFailed(graphTemplate->get_EffectCount(&count));
+        Assert::AreEqual(2u, count);
+        ThrowIfFailed(graphTemplate->get_InputCount(&count));
+        Assert::AreEqual(2u, count);
+
+        // Changing the original graph after compiling it doesn't affect the template.
+        ThrowIfFailed(blur->put_BlurAmount(1));
+
+        auto newInput = Make<TestInput>();
+        IGraphicsEffectSource* inputs[] = { nullptr, newInput.Get() };
+
+        ComArray<ComPtr<IGraphicsEffect>> effects;
+        ThrowIfFailed(graphTemplate->Instantiate(_countof(inputs), inputs, effects.GetAddressOfSize(), effects.GetAddressOfData()));
+        Assert::AreEqual(2u, effects.GetSize());
+
+        auto newComposite = As<ICompositeEffect>(effects[0]);
+        auto newBlur = As<IGaussianBlurEffect>(effects[1]);
+
+        Assert::IsFalse(IsSameInstance(composite.Get(), newComposite.Get()));
+        Assert::IsFalse(IsSameInstance(blur.Get(), newBlur.Get()));
+
+        CanvasComposite mode;
+        ThrowIfFailed(newComposite->get_Mode(&mode));
+        Assert::IsTrue(mode == CanvasComposite::Xor);
+
+        float blurAmount;
+        ThrowIfFailed(newBlur->get_BlurAmount(&blurAmount));
+        Assert::AreEqual(7.0f, blurAmount);
+
+        Assert::IsTrue(IsSameInstance(newBlur.Get(), GetSource(newComposite.Get(), 0).Get()));
+        Assert::IsTrue(IsSameInstance(newInput.Get(), GetSource(newComposite.Get(), 1).Get()));
+        Assert::IsTrue(IsSameInstance(newBlur.Get(), GetSource(newComposite.Get(), 2).Get()));
+
+        // A null input keeps the source from the original graph.
+        ComPtr<IGraphicsEffectSource> blurSource;
+        ThrowIfFailed(newBlur->get_Source(&blurSource));
+        Assert::IsTrue(IsSameInstance(originalInput.Get(), blurSource.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_Compile_RejectsCycles)
+    {
+        auto blur1 = Make<GaussianBlurEffect>();
+        auto blur2 = Make<GaussianBlurEffect>();
+
+        ThrowIfFailed(blur1->put_Source(blur2.Get()));
+        ThrowIfFailed(blur2->put_Source(blur1.Get()));
+
+        auto factory = Make<CanvasEffectGraphTemplateFactory>();
+        ComPtr<ICanvasEffectGraphTemplate> graphTemplate;
+
+        Assert::AreEqual(D2DERR_CYCLIC_GRAPH, factory->Compile(blur1.Get(), &graphTemplate));
+
+        // Break the cycle, so the effects can be freed.
+        ThrowIfFailed(blur2->put_Source(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_CompileOptimized_RemovesIdentityEffects)
+    {
+        auto input = Make<TestInput>();
+
+        auto transform = Make<Transform2DEffect>();
+        ThrowIfFailed(transform->put_Source(input.Get()));
+
+        auto colorMatrix = Make<ColorMatrixEffect>();
+        ThrowIfFailed(colorMatrix->put_Source(transform.Get()));
+
+        auto blur = Make<GaussianBlurEffect>();
+        ThrowIfFailed(blur->put_Source(colorMatrix.Get()));
+
+        auto effects = CompileOptimizedAndInstantiate(blur.Get());
+        Assert::AreEqual(1u, effects.GetSize());
+
+        ComPtr<IGraphicsEffectSource> blurSource;
+        ThrowIfFailed(As<IGaussianBlurEffect>(effects[0])->get_Source(&blurSource));
+        Assert::IsTrue(IsSameInstance(input.Get(), blurSource.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_CompileOptimized_KeepsIdentityRootEffect)
+    {
+        auto transform = Make<Transform2DEffect>();
+        ThrowIfFailed(transform->put_Source(Make<TestInput>().Get()));
+
+        auto effects = CompileOptimizedAndInstantiate(transform.Get());
+        Assert::AreEqual(1u, effects.GetSize());
+        Assert::IsNotNull(MaybeAs<ITransform2DEffect>(effects[0]).Get());
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_CompileOptimized_MergesColorMatrices)
+    {
+        auto input = Make<TestInput>();
+
+        Matrix5x4 childMatrix{ 2, 0, 0, 0,
+                               0, 1, 0, 0,
+                               0, 0, 1, 0,
+                               0, 0, 0, 1,
+                               0.25f, 0, 0, 0 };
+
+        Matrix5x4 parentMatrix{ 3, 0, 0, 0,
+                                1, 1, 0, 0,
+                                0, 0, 1, 0,
+                                0, 0, 0, 1,
+                                0, 0.5f, 0, 0 };
+
+        auto child = Make<ColorMatrixEffect>();
+        ThrowIfFailed(child->put_ColorMatrix(childMatrix));
+        ThrowIfFailed(child->put_Source(input.Get()));
+
+        auto parent = Make<ColorMatrixEffect>();
+        ThrowIfFailed(parent->put_ColorMatrix(parentMatrix));
+        ThrowIfFailed(parent->put_ClampOutput(true));
+        ThrowIfFailed(parent->put_Source(child.Get()));
+
+        auto effects = CompileOptimizedAndInstantiate(parent.Get());
+        Assert::AreEqual(1u, effects.GetSize());
+
+        auto merged = As<IColorMatrixEffect>(effects[0]);
+
+        Matrix5x4 mergedMatrix;
+        ThrowIfFailed(merged->get_ColorMatrix(&mergedMatrix));
+
+        Assert::AreEqual(6.0f, mergedMatrix.M11);
+        Assert::AreEqual(0.0f, mergedMatrix.M12);
+        Assert::AreEqual(1.0f, mergedMatrix.M21);
+        Assert::AreEqual(1.0f, mergedMatrix.M22);
+        Assert::AreEqual(0.75f, mergedMatrix.M51);
+        Assert::AreEqual(0.5f, mergedMatrix.M52);
+
+        boolean clampOutput;
+        ThrowIfFailed(merged->get_ClampOutput(&clampOutput));
+        Assert::IsTrue(!!clampOutput);
+
+        ComPtr<IGraphicsEffectSource> source;
+        ThrowIfFailed(merged->get_Source(&source));
+        Assert::IsTrue(IsSameInstance(input.Get(), source.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_CompileOptimized_DoesNotMergeClampedColorMatrix)
+    {
+        Matrix5x4 matrix{ 2, 0, 0, 0,
+                          0, 1, 0, 0,
+                          0, 0, 1, 0,
+                          0, 0, 0, 1,
+                          0, 0, 0, 0 };
+
+        auto child = Make<ColorMatrixEffect>();
+        ThrowIfFailed(child->put_ColorMatrix(matrix));
+        ThrowIfFailed(child->put_ClampOutput(true));
+        ThrowIfFailed(child->put_Source(Make<TestInput>().Get()));
+
+        auto parent = Make<ColorMatrixEffect>();
+        ThrowIfFailed(parent->put_ColorMatrix(matrix));
+        ThrowIfFailed(parent->put_Source(child.Get()));
+
+        Assert::AreEqual(2u, CompileOptimizedAndInstantiate(parent.Get()).GetSize());
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_CompileOptimized_MergesTransforms)
+    {
+        auto input = Make<TestInput>();
+
+        auto translate = Make<Transform2DEffect>();
+        ThrowIfFailed(translate->put_TransformMatrix(Numerics::Matrix3x2{ 1, 0, 0, 1, 10, 5 }));
+        ThrowIfFailed(translate->put_Source(input.Get()));
+
+        auto scale = Make<Transform2DEffect>();
+        ThrowIfFailed(scale->put_TransformMatrix(Numerics::Matrix3x2{ 2, 0, 0, 3, 0, 0 }));
+        ThrowIfFailed(scale->put_Source(translate.Get()));
+
+        auto effects = CompileOptimizedAndInstantiate(scale.Get());
+        Assert::AreEqual(1u, effects.GetSize());
+
+        Numerics::Matrix3x2 matrix;
+        ThrowIfFailed(As<ITransform2DEffect>(effects[0])->get_TransformMatrix(&matrix));
+
+        Assert::AreEqual(2.0f, matrix.M11);
+        Assert::AreEqual(3.0f, matrix.M22);
+        Assert::AreEqual(20.0f, matrix.M31);
+        Assert::AreEqual(15.0f, matrix.M32);
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_CompileOptimized_KeepsObservableEffects)
+    {
+        auto input = Make<TestInput>();
+
+        // A cached identity effect can't be removed.
+        auto cached = Make<Transform2DEffect>();
+        ThrowIfFailed(cached->put_CacheOutput(true));
+        ThrowIfFailed(cached->put_Source(input.Get()));
+
+        // A shared transform can't be merged into either of its parents.
+        auto shared = Make<Transform2DEffect>();
+        ThrowIfFailed(shared->put_TransformMatrix(Numerics::Matrix3x2{ 2, 0, 0, 2, 0, 0 }));
+        ThrowIfFailed(shared->put_Source(cached.Get()));
+
+        auto parent1 = Make<Transform2DEffect>();
+        ThrowIfFailed(parent1->put_TransformMatrix(Numerics::Matrix3x2{ 1, 0, 0, 1, 1, 0 }));
+        ThrowIfFailed(parent1->put_Source(shared.Get()));
+
+        auto parent2 = Make<Transform2DEffect>();
+        ThrowIfFailed(parent2->put_TransformMatrix(Numerics::Matrix3x2{ 1, 0, 0, 1, 0, 1 }));
+        ThrowIfFailed(parent2->put_Source(shared.Get()));
+
+        auto composite = Make<CompositeEffect>();
+
+        ComPtr<IVector<IGraphicsEffectSource*>> compositeSources;
+        ThrowIfFailed(composite->get_Sources(&compositeSources));
+        ThrowIfFailed(compositeSources->Append(parent1.Get()));
+        ThrowIfFailed(compositeSources->Append(parent2.Get()));
+
+        Assert::AreEqual(5u, CompileOptimizedAndInstantiate(composite.Get()).GetSize());
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_ChooseBufferPrecision_FollowsRangeOfEffects)
+    {
+        auto bitmap = MakeBitmap(DXGI_FORMAT_B8G8R8A8_UNORM);
+
+        // Blurring an 8 bit image keeps it within 0 to 1.
+        auto blur = Make<GaussianBlurEffect>();
+        ThrowIfFailed(blur->put_Source(bitmap.Get()));
+
+        // Doubling red can go past 1.
+        auto brighten = Make<ColorMatrixEffect>();
+        ThrowIfFailed(brighten->put_ColorMatrix(Matrix5x4{ 2, 0, 0, 0,
+                                                           0, 1, 0, 0,
+                                                           0, 0, 1, 0,
+                                                           0, 0, 0, 1,
+                                                           0, 0, 0, 0 }));
+        ThrowIfFailed(brighten->put_Source(blur.Get()));
+
+        // So a transform of that must keep the extra range.
+        auto transform = Make<Transform2DEffect>();
+        ThrowIfFailed(transform->put_TransformMatrix(Numerics::Matrix3x2{ 2, 0, 0, 2, 0, 0 }));
+        ThrowIfFailed(transform->put_Source(brighten.Get()));
+
+        // An effect that already has a precision keeps it.
+        auto explicitBlur = Make<GaussianBlurEffect>();
+        ThrowIfFailed(explicitBlur->put_BufferPrecision(Make<Nullable<CanvasBufferPrecision>>(CanvasBufferPrecision::Precision32Float).Get()));
+        ThrowIfFailed(explicitBlur->put_Source(bitmap.Get()));
+
+        auto composite = Make<CompositeEffect>();
+
+        ComPtr<IVector<IGraphicsEffectSource*>> compositeSources;
+        ThrowIfFailed(composite->get_Sources(&compositeSources));
+        ThrowIfFailed(compositeSources->Append(blur.Get()));
+        ThrowIfFailed(compositeSources->Append(explicitBlur.Get()));
+
+        auto effects = CompileOptimizedAndInstantiate(transform.Get(), CanvasEffectGraphOptimizations::ChooseBufferPrecision);
+        Assert::AreEqual(3u, effects.GetSize());
+
+        AssertBufferPrecision(effects[0].Get(), CanvasBufferPrecision::Precision16Float);
+        AssertBufferPrecision(effects[1].Get(), CanvasBufferPrecision::Precision16Float);
+        AssertBufferPrecision(effects[2].Get(), CanvasBufferPrecision::Precision8UIntNormalized);
+
+        // Anything fed by a 32 bit float effect is left alone.
+        effects = CompileOptimizedAndInstantiate(composite.Get(), CanvasEffectGraphOptimizations::ChooseBufferPrecision);
+        Assert::AreEqual(3u, effects.GetSize());
+
+        AssertBufferPrecisionIsNull(effects[0].Get());
+        AssertBufferPrecision(effects[1].Get(), CanvasBufferPrecision::Precision8UIntNormalized);
+        AssertBufferPrecision(effects[2].Get(), CanvasBufferPrecision::Precision32Float);
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_ChooseBufferPrecision_FollowsInputFormats)
+    {
+        auto blur = Make<GaussianBlurEffect>();
+        ThrowIfFailed(blur->put_Source(MakeBitmap(DXGI_FORMAT_B8G8R8A8_UNORM).Get()));
+
+        auto factory = Make<CanvasEffectGraphTemplateFactory>();
+
+        ComPtr<ICanvasEffectGraphTemplate> graphTemplate;
+        ThrowIfFailed(factory->CompileOptimizedWithOptions(blur.Get(), CanvasEffectGraphOptimizations::ChooseBufferPrecision, &graphTemplate));
+
+        auto instantiate = [&](IGraphicsEffectSource* input)
+        {
+            ComArray<ComPtr<IGraphicsEffect>> effects;
+            ThrowIfFailed(graphTemplate->Instantiate(1, &input, effects.GetAddressOfSize(), effects.GetAddressOfData()));
+            return effects[0];
+        };
+
+        AssertBufferPrecision(instantiate(nullptr).Get(), CanvasBufferPrecision::Precision8UIntNormalized);
+        AssertBufferPrecision(instantiate(MakeBitmap(DXGI_FORMAT_R16G16B16A16_FLOAT).Get()).Get(), CanvasBufferPrecision::Precision16Float);
+
+        // Nothing is known about 32 bit float bitmaps, or about inputs that aren't bitmaps.
+        AssertBufferPrecisionIsNull(instantiate(MakeBitmap(DXGI_FORMAT_R32G32B32A32_FLOAT).Get()).Get());
+        AssertBufferPrecisionIsNull(instantiate(Make<TestInput>().Get()).Get());
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_WithoutChooseBufferPrecision_LeavesPrecisionAlone)
+    {
+        auto blur = Make<GaussianBlurEffect>();
+        ThrowIfFailed(blur->put_Source(MakeBitmap(DXGI_FORMAT_B8G8R8A8_UNORM).Get()));
+
+        auto effects = CompileOptimizedAndInstantiate(blur.Get());
+        AssertBufferPrecisionIsNull(effects[0].Get());
+    }
+
+    TEST_METHOD_EX(CanvasEffectGraphTemplate_InvalidArgs)
+    {
+        auto factory = Make<CanvasEffectGraphTemplateFactory>();
+        ComPtr<ICanvasEffectGraphTemplate> graphTemplate;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Compile(nullptr, &graphTemplate));
+
+        auto blur = Make<GaussianBlurEffect>();
+        Assert::AreEqual(E_INVALIDARG, factory->Compile(blur.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->CompileOptimized(nullptr, &graphTemplate));
+        Assert::AreEqual(E_INVALIDARG, factory->CompileOptimized(blur.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->CompileOptimizedWithOptions(nullptr, CanvasEffectGraphOptimizations::None, &graphTemplate));
+        Assert::AreEqual(E_INVALIDARG, factory->CompileOptimizedWithOptions(blur.Get(), CanvasEffectGraphOptimizations::None, nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->CompileOptimizedWithOptions(blur.Get(), static_cast<CanvasEffectGraphOptimizations>(4), &graphTemplate));
+
+        ThrowIfFailed(blur->put_Source(Make<TestInput>().Get()));
+        graphTemplate = Compile(blur.Get());
+
+        ComArray<ComPtr<IGraphicsEffect>> effects;
+        Assert::AreEqual(E_INVALIDARG, graphTemplate->Instantiate(0, nullptr, effects.GetAddressOfSize(), effects.GetAddressOfData()));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::EffectGraphTemplateWrongInputCount);
+
+        IGraphicsEffectSource* inputs[] = { nullptr };
+        Assert::AreEqual(E_INVALIDARG, graphTemplate->Instantiate(1, inputs, nullptr, effects.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, graphTemplate->Instantiate(1, inputs, effects.GetAddressOfSize(), nullptr));
+    }
+};
@@ -11,8 +11,11 @@
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 #include <lib/effects/generated/AlphaMaskEffect.h>
+#include <lib/effects/generated/ColorManagementEffect.h>
 #include <lib/effects/generated/CrossFadeEffect.h>
+#include <lib/effects/generated/GaussianBlurEffect.h>
 #include <lib/effects/generated/OpacityEffect.h>
+#include <lib/effects/generated/ScaleEffect.h>
 #include <lib/effects/generated/TintEffect.h>
 #endif
 
@@ -288,6 +291,73 @@ public:
         }
     };
 
+    TEST_METHOD_EX(CanvasEffect_AlternatingBetweenDevices_ReusesEachDevicesRealization)
+    {
+        Fixture f1;
+        Fixture f2;
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects1;
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects2;
+
+        auto expectCreateEffect = [](Fixture& f, std::vector<ComPtr<MockD2DEffectThatCountsCalls>>& mockEffects)
+        {
+            f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+            f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+                [&](IID const&, ID2D1Effect** effect)
+                {
+                    auto mockEffect = Make<MockD2DEffectThatCountsCalls>();
+                    auto rawMockEffect = mockEffect.Get();
+
+                    mockEffect->MockGetType = [](UINT32) { return D2D1_PROPERTY_TYPE_FLOAT; };
+
+                    mockEffect->MockGetValue =
+                        [rawMockEffect](UINT32 index, D2D1_PROPERTY_TYPE, BYTE* data, UINT32 dataSize)
+                        {
+                            if (index < rawMockEffect->m_properties.size())
+                                memcpy(data, rawMockEffect->m_properties[index].data(), dataSize);
+                            else
+                                ZeroMemory(data, dataSize);
+
+                            return S_OK;
+                        };
+
+                    mockEffects.push_back(mockEffect);
+
+                    return mockEffect.CopyTo(effect);
+                });
+        };
+
+        expectCreateEffect(f1, mockEffects1);
+        expectCreateEffect(f2, mockEffects2);
+
+        auto testEffect = Make<TestEffect>(m_blurGuid, 1, 0, true);
+        ThrowIfFailed(testEffect->put_BlurAmount(3));
+
+        ThrowIfFailed(f1.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+        ThrowIfFailed(f2.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+
+        // Switching back to the first device reuses its D2D effect, without setting properties again.
+        ThrowIfFailed(f1.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+        ThrowIfFailed(f2.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+
+        Assert::AreEqual<size_t>(1, mockEffects1.size());
+        Assert::AreEqual<size_t>(1, mockEffects2.size());
+        Assert::AreEqual(1, mockEffects1[0]->m_setValueCalls);
+        Assert::AreEqual(1, mockEffects2[0]->m_setValueCalls);
+
+        // After a property change, the reused effect is brought up to date.
+        ThrowIfFailed(testEffect->put_BlurAmount(5));
+        ThrowIfFailed(f1.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+
+        Assert::AreEqual<size_t>(1, mockEffects1.size());
+        Assert::AreEqual(5.0f, *reinterpret_cast<float*>(mockEffects1[0]->m_properties[0].data()));
+
+        float value;
+        ThrowIfFailed(testEffect->get_BlurAmount(&value));
+        Assert::AreEqual(5.0f, value);
+    }
+
     class InvalidEffectSourceType : public RuntimeClass<IGraphicsEffectSource>
     {
         InspectableClass(L"InvalidEffectSourceType", BaseTrust);
@@ -455,6 +525,276 @@ public:
         CheckCallCount(mockEffects, 3, { 2, 2, 2 }, { 2, 2, 2 });
     }
 
+    TEST_METHOD_EX(CanvasEffect_WhenGraphIsUnchanged_RedrawingDoesNotWalkTheGraph)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects;
+        int getInputCalls = 0;
+
+        f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+            [&](IID const&, ID2D1Effect** effect)
+            {
+                auto mockEffect = Make<MockD2DEffectThatCountsCalls>();
+
+                auto getInput = mockEffect->MockGetInput;
+                mockEffect->MockGetInput =
+                    [&getInputCalls, getInput](UINT32 index, ID2D1Image** input)
+                    {
+                        ++getInputCalls;
+                        getInput(index, input);
+                    };
+
+                mockEffects.push_back(mockEffect);
+
+                return mockEffect.CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        std::vector<ComPtr<TestEffect>> testEffects;
+
+        for (int i = 0; i < 3; i++)
+        {
+            testEffects.push_back(Make<TestEffect>(m_blurGuid, 1, 1, false));
+        }
+
+        testEffects[0]->put_Source(testEffects[1].Get());
+        testEffects[1]->put_Source(testEffects[2].Get());
+        testEffects[2]->put_Source(stubBitmap.Get());
+
+        // The first draw realizes the graph, and the second validates it.
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+
+        Assert::AreEqual<size_t>(3, mockEffects.size());
+
+        // After that, drawing the unchanged graph doesn't need to look at its inputs.
+        getInputCalls = 0;
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+        Assert::AreEqual(0, getInputCalls);
+
+        // Property changes go straight through to D2D, so don't require a walk either.
+        testEffects[2]->put_BlurAmount(1);
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+        Assert::AreEqual(0, getInputCalls);
+
+        // Changing a source anywhere in the graph does.
+        testEffects[2]->put_Source(stubBitmap.Get());
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+        Assert::AreNotEqual(0, getInputCalls);
+
+        // As does a source image saying its D2D image may have changed.
+        getInputCalls = 0;
+        InvalidateRealizedImageGraphs();
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+        Assert::AreNotEqual(0, getInputCalls);
+
+        // As does drawing at a different DPI.
+        getInputCalls = 0;
+        f.m_dpi = DEFAULT_DPI * 2;
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+        Assert::AreNotEqual(0, getInputCalls);
+
+        // Closing an effect in the graph means the next draw walks the graph, and fails.
+        testEffects[2]->Close();
+        Assert::AreEqual(RO_E_CLOSED, f.m_drawingSession->DrawImageAtOrigin(testEffects[0].Get()));
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GetBounds_CachesResultUntilGraphChanges)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+            [&](IID const&, ID2D1Effect** effect)
+            {
+                return Make<MockD2DEffectThatCountsCalls>().CopyTo(effect);
+            });
+
+        f.m_deviceContext->GetTransformMethod.AllowAnyCall([](D2D1_MATRIX_3X2_F* transform) { *transform = D2D1::Matrix3x2F::Identity(); });
+        f.m_deviceContext->SetTransformMethod.AllowAnyCall([](D2D1_MATRIX_3X2_F const*) { });
+        f.m_deviceContext->GetUnitModeMethod.AllowAnyCall([] { return D2D1_UNIT_MODE_DIPS; });
+
+        int getBoundsCalls = 0;
+
+        f.m_deviceContext->GetImageWorldBoundsMethod.AllowAnyCall(
+            [&](ID2D1Image*, D2D1_RECT_F* bounds)
+            {
+                ++getBoundsCalls;
+                *bounds = D2D1_RECT_F{ 1, 2, 3, 4 };
+                return S_OK;
+            });
+
+        auto testEffect = Make<TestEffect>(m_blurGuid, 1, 1, false);
+        testEffect->put_Source(stubBitmap.Get());
+
+        Rect bounds;
+        Numerics::Matrix3x2 transform{ 2, 0, 0, 2, 0, 0 };
+
+        // Asking again for the bounds of an unchanged effect reuses the previous result.
+        ThrowIfFailed(testEffect->GetBounds(f.m_drawingSession.Get(), &bounds));
+        ThrowIfFailed(testEffect->GetBounds(f.m_drawingSession.Get(), &bounds));
+        Assert::AreEqual(1, getBoundsCalls);
+        Assert::AreEqual(Rect{ 1, 2, 2, 2 }, bounds);
+
+        // A different transform has different bounds.
+        ThrowIfFailed(testEffect->GetBoundsWithTransform(f.m_drawingSession.Get(), transform, &bounds));
+        ThrowIfFailed(testEffect->GetBoundsWithTransform(f.m_drawingSession.Get(), transform, &bounds));
+        Assert::AreEqual(2, getBoundsCalls);
+
+        // As does a different DPI.
+        f.m_dpi = DEFAULT_DPI * 2;
+        ThrowIfFailed(testEffect->GetBoundsWithTransform(f.m_drawingSession.Get(), transform, &bounds));
+        Assert::AreEqual(3, getBoundsCalls);
+
+        // Changing a property or source means the bounds must be measured again.
+        testEffect->put_BlurAmount(1);
+        ThrowIfFailed(testEffect->GetBoundsWithTransform(f.m_drawingSession.Get(), transform, &bounds));
+        Assert::AreEqual(4, getBoundsCalls);
+
+        testEffect->put_Source(stubBitmap.Get());
+        ThrowIfFailed(testEffect->GetBoundsWithTransform(f.m_drawingSession.Get(), transform, &bounds));
+        Assert::AreEqual(5, getBoundsCalls);
+
+        // Closed effects don't report stale bounds.
+        testEffect->Close();
+        Assert::AreEqual(RO_E_CLOSED, testEffect->GetBoundsWithTransform(f.m_drawingSession.Get(), transform, &bounds));
+    }
+
+    TEST_METHOD_EX(CanvasEffect_StronglyTypedProperties_AreStoredInD2DFormat)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        ComPtr<MockD2DEffectThatCountsCalls> mockEffect;
+
+        f.m_deviceContext->CreateEffectMethod.SetExpectedCalls(1,
+            [&](IID const&, ID2D1Effect** effect)
+            {
+                mockEffect = Make<MockD2DEffectThatCountsCalls>();
+
+                // Strongly typed getters read straight from the D2D effect, without needing GetType.
+                mockEffect->MockGetValue =
+                    [&](UINT32 index, D2D1_PROPERTY_TYPE, BYTE* data, UINT32 dataSize)
+                    {
+                        Assert::AreEqual<size_t>(dataSize, mockEffect->m_properties[index].size());
+                        memcpy(data, mockEffect->m_properties[index].data(), dataSize);
+                        return S_OK;
+                    };
+
+                return mockEffect.CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        auto testEffect = Make<TestEffect>(m_blurGuid, 1, 1, false);
+        testEffect->put_Source(stubBitmap.Get());
+
+        // While unrealized, the value round-trips through the inline store.
+        float value = 0;
+        ThrowIfFailed(testEffect->put_BlurAmount(3));
+        ThrowIfFailed(testEffect->get_BlurAmount(&value));
+        Assert::AreEqual(3.0f, value);
+
+        // Interop readers still see a boxed value.
+        ComPtr<IPropertyValue> propertyValue;
+        ThrowIfFailed(testEffect->GetProperty(0, &propertyValue));
+
+        PropertyType propertyType;
+        ThrowIfFailed(propertyValue->get_Type(&propertyType));
+        Assert::AreEqual<int>(PropertyType_Single, propertyType);
+
+        ThrowIfFailed(propertyValue->GetSingle(&value));
+        Assert::AreEqual(3.0f, value);
+
+        // Realizing transfers the value as-is.
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+
+        Assert::AreEqual(1, mockEffect->m_setValueCalls);
+        Assert::AreEqual(sizeof(float), mockEffect->m_properties[0].size());
+        Assert::AreEqual(3.0f, *reinterpret_cast<float*>(mockEffect->m_properties[0].data()));
+
+        // Once realized, setting and getting goes directly to the D2D effect.
+        ThrowIfFailed(testEffect->put_BlurAmount(5));
+
+        Assert::AreEqual(2, mockEffect->m_setValueCalls);
+        Assert::AreEqual(5.0f, *reinterpret_cast<float*>(mockEffect->m_properties[0].data()));
+
+        ThrowIfFailed(testEffect->get_BlurAmount(&value));
+        Assert::AreEqual(5.0f, value);
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GeneratedEffect_ReadsDefaultsFromPropertyDefaultTable)
+    {
+        auto blurEffect = Make<GaussianBlurEffect>();
+
+        UINT count;
+        ThrowIfFailed(blurEffect->GetPropertyCount(&count));
+        Assert::AreEqual(3u, count);
+
+        float blurAmount;
+        ThrowIfFailed(blurEffect->get_BlurAmount(&blurAmount));
+        Assert::AreEqual(3.0f, blurAmount);
+
+        ComPtr<IPropertyValue> propertyValue;
+        ThrowIfFailed(blurEffect->GetProperty(D2D1_GAUSSIANBLUR_PROP_OPTIMIZATION, &propertyValue));
+
+        uint32_t optimization;
+        ThrowIfFailed(propertyValue->GetUInt32(&optimization));
+        Assert::AreEqual<uint32_t>(D2D1_GAUSSIANBLUR_OPTIMIZATION_BALANCED, optimization);
+
+        // Changing one property leaves the others at their defaults.
+        ThrowIfFailed(blurEffect->put_BlurAmount(5));
+        ThrowIfFailed(blurEffect->get_BlurAmount(&blurAmount));
+        Assert::AreEqual(5.0f, blurAmount);
+
+        EffectBorderMode borderMode;
+        ThrowIfFailed(blurEffect->get_BorderMode(&borderMode));
+        Assert::IsTrue(borderMode == EffectBorderMode::Soft);
+
+        // Interface properties default to null.
+        auto colorManagementEffect = Make<ColorManagementEffect>();
+
+        ComPtr<IColorManagementProfile> profile;
+        ThrowIfFailed(colorManagementEffect->get_SourceColorProfile(&profile));
+        Assert::IsNull(profile.Get());
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GeneratedEffect_ValidatesPropertiesAgainstRangeTable)
+    {
+        auto blurEffect = Make<GaussianBlurEffect>();
+
+        // Both ends of the range are inclusive.
+        Assert::AreEqual(S_OK, blurEffect->put_BlurAmount(0.0f));
+        Assert::AreEqual(S_OK, blurEffect->put_BlurAmount(250.0f));
+
+        Assert::AreEqual(E_INVALIDARG, blurEffect->put_BlurAmount(-0.5f));
+        Assert::AreEqual(E_INVALIDARG, blurEffect->put_BlurAmount(250.5f));
+        Assert::AreEqual(E_INVALIDARG, blurEffect->put_BlurAmount(std::numeric_limits<float>::quiet_NaN()));
+
+        // Rejected values leave the property unchanged.
+        float blurAmount;
+        ThrowIfFailed(blurEffect->get_BlurAmount(&blurAmount));
+        Assert::AreEqual(250.0f, blurAmount);
+
+        // Vectors are checked one component at a time, and a missing maximum leaves the range open.
+        auto scaleEffect = Make<ScaleEffect>();
+
+        Assert::AreEqual(S_OK, scaleEffect->put_Scale(Vector2{ 0.01f, 1000000.0f }));
+        Assert::AreEqual(E_INVALIDARG, scaleEffect->put_Scale(Vector2{ 1.0f, 0.0f }));
+        Assert::AreEqual(E_INVALIDARG, scaleEffect->put_Scale(Vector2{ 0.0f, 1.0f }));
+
+        Vector2 scale;
+        ThrowIfFailed(scaleEffect->get_Scale(&scale));
+        Assert::AreEqual(0.01f, scale.X);
+        Assert::AreEqual(1000000.0f, scale.Y);
+    }
+
     static void CheckCallCount(std::vector<ComPtr<MockD2DEffectThatCountsCalls>> const& mockEffects,
                                size_t expectedEffectCount,
                                std::initializer_list<int> const& expectedSetInputCalls,
@@ -932,6 +1272,123 @@ public:
         Assert::AreEqual(expectedResult2, result[1]);
     }
 
+    TEST_METHOD_EX(CanvasEffect_PrepareAsync_InvalidArgs)
+    {
+        Fixture f;
+
+        auto testEffect = Make<TestEffect>(m_blurGuid, 0, 1);
+        auto resourceCreator = As<ICanvasResourceCreator>(f.m_canvasDevice);
+
+        ComPtr<IAsyncAction> action;
+
+        Assert::AreEqual(E_INVALIDARG, testEffect->PrepareAsync(nullptr, DEFAULT_DPI, &action));
+        Assert::AreEqual(E_INVALIDARG, testEffect->PrepareAsync(resourceCreator.Get(), DEFAULT_DPI, nullptr));
+        Assert::AreEqual(E_INVALIDARG, testEffect->PrepareAsync(resourceCreator.Get(), 0, &action));
+        Assert::AreEqual(E_INVALIDARG, testEffect->PrepareAsync(resourceCreator.Get(), -1, &action));
+    }
+
+    static EffectKeyframe MakeKeyframe(int64_t time, float value)
+    {
+        return EffectKeyframe{ TimeSpan{ time }, Numerics::Vector4{ value, value * 2, 0, 0 } };
+    }
+
+    TEST_METHOD_EX(CanvasEffect_EvaluateKeyframes_HoldsEndValuesOutsideRange)
+    {
+        std::vector<EffectKeyframe> keyframes{ MakeKeyframe(100, 1), MakeKeyframe(200, 3) };
+
+        Assert::AreEqual(1.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 0).X);
+        Assert::AreEqual(1.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 100).X);
+        Assert::AreEqual(3.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 200).X);
+        Assert::AreEqual(3.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 5000).X);
+    }
+
+    TEST_METHOD_EX(CanvasEffect_EvaluateKeyframes_Easing)
+    {
+        std::vector<EffectKeyframe> keyframes{ MakeKeyframe(0, 0), MakeKeyframe(100, 8), MakeKeyframe(200, 0) };
+
+        Assert::AreEqual(2.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 25).X);
+        Assert::AreEqual(4.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 25).Y);
+        Assert::AreEqual(4.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Linear, 150).X);
+
+        Assert::AreEqual(0.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Step, 99).X);
+        Assert::AreEqual(8.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::Step, 100).X);
+
+        Assert::AreEqual(1.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::EaseIn, 50).X);
+        Assert::AreEqual(7.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::EaseOut, 50).X);
+        Assert::AreEqual(4.0f, EvaluateKeyframes(keyframes, EffectAnimationEasing::EaseInOut, 50).X);
+    }
+
+    TEST_METHOD_EX(CanvasEffect_ValidateAnimation_RejectsBadKeyframes)
+    {
+        EffectKeyframe outOfOrder[] = { MakeKeyframe(100, 1), MakeKeyframe(50, 2) };
+        EffectKeyframe sameTime[] = { MakeKeyframe(100, 1), MakeKeyframe(100, 2) };
+
+        ExpectHResultException(E_INVALIDARG, [&] { ValidateAnimation(0, outOfOrder, EffectAnimationEasing::Linear); });
+        ExpectHResultException(E_INVALIDARG, [&] { ValidateAnimation(2, outOfOrder, EffectAnimationEasing::Linear); });
+        ExpectHResultException(E_INVALIDARG, [&] { ValidateAnimation(2, sameTime, static_cast<EffectAnimationEasing>(-1)); });
+
+        ValidateAnimation(2, sameTime, EffectAnimationEasing::EaseInOut);
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    TEST_METHOD_EX(CanvasEffect_Animate_InvalidArgs)
+    {
+        auto blur = Make<GaussianBlurEffect>();
+        auto keyframe = MakeKeyframe(0, 1);
+
+        Assert::AreEqual(E_INVALIDARG, blur->Animate(nullptr, 1, &keyframe, EffectAnimationEasing::Linear));
+        Assert::AreEqual(E_INVALIDARG, blur->Animate(WinString(L"BlurAmount"), 1, nullptr, EffectAnimationEasing::Linear));
+        Assert::AreEqual(E_INVALIDARG, blur->Animate(WinString(L"BlurAmount"), 0, &keyframe, EffectAnimationEasing::Linear));
+        Assert::AreEqual(E_INVALIDARG, blur->Animate(WinString(L"NotAProperty"), 1, &keyframe, EffectAnimationEasing::Linear));
+        Assert::AreEqual(E_INVALIDARG, blur->Animate(WinString(L"Optimization"), 1, &keyframe, EffectAnimationEasing::Linear));
+
+        ThrowIfFailed(blur->Close());
+
+        Assert::AreEqual(RO_E_CLOSED, blur->Animate(WinString(L"BlurAmount"), 1, &keyframe, EffectAnimationEasing::Linear));
+        Assert::AreEqual(RO_E_CLOSED, blur->SetAnimationTime(TimeSpan{ 0 }));
+    }
+
+    TEST_METHOD_EX(CanvasEffect_SetAnimationTime_AppliesToWholeGraph)
+    {
+        auto blur1 = Make<GaussianBlurEffect>();
+        auto blur2 = Make<GaussianBlurEffect>();
+
+        // A cycle must not make SetAnimationTime recurse forever.
+        ThrowIfFailed(blur1->put_Source(blur2.Get()));
+        ThrowIfFailed(blur2->put_Source(blur1.Get()));
+
+        EffectKeyframe keyframes1[] = { MakeKeyframe(0, 0), MakeKeyframe(100, 10) };
+        EffectKeyframe keyframes2[] = { MakeKeyframe(0, 20), MakeKeyframe(100, 40) };
+
+        ThrowIfFailed(blur1->Animate(WinString(L"BlurAmount"), 2, keyframes1, EffectAnimationEasing::Linear));
+        ThrowIfFailed(blur2->Animate(WinString(L"blurAmount"), 2, keyframes2, EffectAnimationEasing::Linear));
+
+        ThrowIfFailed(blur1->SetAnimationTime(TimeSpan{ 50 }));
+
+        float value;
+        ThrowIfFailed(blur1->get_BlurAmount(&value));
+        Assert::AreEqual(5.0f, value);
+        ThrowIfFailed(blur2->get_BlurAmount(&value));
+        Assert::AreEqual(30.0f, value);
+
+        // Animating the same property again replaces the old animation.
+        ThrowIfFailed(blur1->Animate(WinString(L"BlurAmount"), 2, keyframes2, EffectAnimationEasing::Linear));
+        ThrowIfFailed(blur1->SetAnimationTime(TimeSpan{ 100 }));
+        ThrowIfFailed(blur1->get_BlurAmount(&value));
+        Assert::AreEqual(40.0f, value);
+
+        // Stopped animations leave the property where it was.
+        ThrowIfFailed(blur1->StopAnimation(WinString(L"BlurAmount")));
+        ThrowIfFailed(blur1->SetAnimationTime(TimeSpan{ 0 }));
+        ThrowIfFailed(blur1->get_BlurAmount(&value));
+        Assert::AreEqual(40.0f, value);
+        ThrowIfFailed(blur2->get_BlurAmount(&value));
+        Assert::AreEqual(20.0f, value);
+    }
+
+#endif
+
     struct EffectRealizationContextFixture : public Fixture
     {
         ComPtr<TestEffect> m_testEffect;
@@ -196,6 +196,8 @@ TEST_CLASS(CanvasFontFaceTests)
 
         Assert::AreEqual(RO_E_CLOSED, canvasFontFace->GetGlyphMetrics(1, &i, true, &u, &glyphMetricsPointer));
 
+        Assert::AreEqual(RO_E_CLOSED, canvasFontFace->PreloadUnicodeRange(CanvasUnicodeRange{ 0, 1 }, false));
+
         Assert::AreEqual(RO_E_CLOSED, canvasFontFace->GetGdiCompatibleGlyphMetrics(12, 96, m, true, 1, &i, true, &u, &glyphMetricsPointer));
 
         FontWeight fontWeight;
@@ -883,6 +885,152 @@ TEST_CLASS(CanvasFontFaceTests)
         Assert::AreEqual(Rect{ 2.f, 7.f, 8.f, 8.f }, outputElements[0].DrawBounds);
     }
 
+    TEST_METHOD_EX(CanvasFontFace_GetGlyphIndices_OnlyLooksUpEachCharacterOnce)
+    {
+        Fixture f;
+
+        f.RealizedDWriteFontFace->GetGlyphIndicesMethod.SetExpectedCalls(1,
+            [&](uint32_t const* codePoints, uint32_t codePointCount, UINT16* glyphIndices)
+            {
+                Assert::AreEqual(2u, codePointCount);
+
+                for (uint32_t i = 0; i < codePointCount; ++i)
+                    glyphIndices[i] = static_cast<UINT16>(codePoints[i] + 100);
+
+                return S_OK;
+            });
+
+        uint32_t firstInput[] { 4u, 5u };
+        uint32_t outputCount;
+        int* outputElements;
+        Assert::AreEqual(S_OK, f.FontFace->GetGlyphIndices(2, firstInput, &outputCount, &outputElements));
+
+        f.RealizedDWriteFontFace->GetGlyphIndicesMethod.SetExpectedCalls(1,
+            [&](uint32_t const* codePoints, uint32_t codePointCount, UINT16* glyphIndices)
+            {
+                Assert::AreEqual(1u, codePointCount);
+                Assert::AreEqual(6u, codePoints[0]);
+
+                glyphIndices[0] = 106ui16;
+
+                return S_OK;
+            });
+
+        uint32_t secondInput[] { 5u, 6u, 4u };
+        Assert::AreEqual(S_OK, f.FontFace->GetGlyphIndices(3, secondInput, &outputCount, &outputElements));
+        Assert::AreEqual(3u, outputCount);
+        Assert::AreEqual(105, outputElements[0]);
+        Assert::AreEqual(106, outputElements[1]);
+        Assert::AreEqual(104, outputElements[2]);
+    }
+
+    TEST_METHOD_EX(CanvasFontFace_GetGlyphMetrics_CachesUprightAndSidewaysSeparately)
+    {
+        Fixture f;
+
+        f.RealizedDWriteFontFace->GetMetricsMethod1.AllowAnyCall(
+            [&](DWRITE_FONT_METRICS1* out)
+            {
+                *out = DWRITE_FONT_METRICS1{};
+                out->designUnitsPerEm = 10;
+            });
+
+        std::vector<BOOL> sidewaysCalls;
+
+        f.RealizedDWriteFontFace->GetDesignGlyphMetricsMethod.SetExpectedCalls(2,
+            [&](UINT16 const* glyphIndices, UINT32 glyphCount, DWRITE_GLYPH_METRICS* glyphMetrics, BOOL isSideways)
+            {
+                Assert::AreEqual(1u, glyphCount);
+                Assert::AreEqual(61ui16, glyphIndices[0]);
+
+                sidewaysCalls.push_back(isSideways);
+                glyphMetrics[0] = DWRITE_GLYPH_METRICS{ 0, isSideways ? 20u : 10u };
+
+                return S_OK;
+            });
+
+        int inputGlyph = 61;
+        uint32_t outputCount;
+        CanvasGlyphMetrics* outputElements;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            Assert::AreEqual(S_OK, f.FontFace->GetGlyphMetrics(1, &inputGlyph, false, &outputCount, &outputElements));
+            Assert::AreEqual(1.f, outputElements[0].AdvanceWidth);
+
+            Assert::AreEqual(S_OK, f.FontFace->GetGlyphMetrics(1, &inputGlyph, true, &outputCount, &outputElements));
+            Assert::AreEqual(2.f, outputElements[0].AdvanceWidth);
+        }
+
+        Assert::AreEqual<size_t>(2, sidewaysCalls.size());
+        Assert::AreEqual(FALSE, sidewaysCalls[0]);
+        Assert::AreEqual(TRUE, sidewaysCalls[1]);
+    }
+
+    TEST_METHOD_EX(CanvasFontFace_PreloadUnicodeRange_BadArgs)
+    {
+        Fixture f(0);
+
+        Assert::AreEqual(E_INVALIDARG, f.FontFace->PreloadUnicodeRange(CanvasUnicodeRange{ 2, 1 }, false));
+        Assert::AreEqual(E_INVALIDARG, f.FontFace->PreloadUnicodeRange(CanvasUnicodeRange{ 0, 0x110000 }, false));
+    }
+
+    TEST_METHOD_EX(CanvasFontFace_PreloadUnicodeRange_LooksUpCharactersAndMetricsInBulk)
+    {
+        Fixture f;
+
+        f.RealizedDWriteFontFace->GetGlyphCountMethod.AllowAnyCall([] { return 10ui16; });
+
+        f.RealizedDWriteFontFace->GetGlyphIndicesMethod.SetExpectedCalls(1,
+            [&](uint32_t const* codePoints, uint32_t codePointCount, UINT16* glyphIndices)
+            {
+                Assert::AreEqual(3u, codePointCount);
+                Assert::AreEqual(0x41u, codePoints[0]);
+                Assert::AreEqual(0x43u, codePoints[2]);
+
+                glyphIndices[0] = 1ui16;
+                glyphIndices[1] = 2ui16;
+                glyphIndices[2] = 1ui16;
+
+                return S_OK;
+            });
+
+        f.RealizedDWriteFontFace->GetDesignGlyphMetricsMethod.SetExpectedCalls(1,
+            [&](UINT16 const* glyphIndices, UINT32 glyphCount, DWRITE_GLYPH_METRICS* glyphMetrics, BOOL isSideways)
+            {
+                Assert::AreEqual(FALSE, isSideways);
+                Assert::AreEqual(2u, glyphCount);
+                Assert::AreEqual(1ui16, glyphIndices[0]);
+                Assert::AreEqual(2ui16, glyphIndices[1]);
+
+                glyphMetrics[0] = DWRITE_GLYPH_METRICS{};
+                glyphMetrics[1] = DWRITE_GLYPH_METRICS{};
+
+                return S_OK;
+            });
+
+        Assert::AreEqual(S_OK, f.FontFace->PreloadUnicodeRange(CanvasUnicodeRange{ 0x41, 0x43 }, false));
+        Expectations::Instance()->Validate();
+
+        // Everything preloaded is now served without going back to DirectWrite.
+        f.RealizedDWriteFontFace->GetMetricsMethod1.AllowAnyCall(
+            [&](DWRITE_FONT_METRICS1* out)
+            {
+                *out = DWRITE_FONT_METRICS1{};
+                out->designUnitsPerEm = 10;
+            });
+
+        uint32_t inputCharacter = 0x42;
+        uint32_t outputCount;
+        int* outputIndices;
+        Assert::AreEqual(S_OK, f.FontFace->GetGlyphIndices(1, &inputCharacter, &outputCount, &outputIndices));
+        Assert::AreEqual(2, outputIndices[0]);
+
+        int inputGlyph = 2;
+        CanvasGlyphMetrics* outputMetrics;
+        Assert::AreEqual(S_OK, f.FontFace->GetGlyphMetrics(1, &inputGlyph, false, &outputCount, &outputMetrics));
+    }
+
     TEST_METHOD_EX(CanvasFontFace_GetGdiCompatibleGlyphMetrics_BadArgs)
     {
       Fixture f(0);
@@ -250,6 +250,12 @@ TEST_CLASS(CanvasFontSetTests)
         Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetPropertyValuesFromIdentifier(CanvasFontPropertyIdentifier::FaceName, WinString(L""), nullptr, &fpArray));
         Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetPropertyValues(CanvasFontPropertyIdentifier::FaceName, &u, nullptr));
         Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetPropertyValues(CanvasFontPropertyIdentifier::FaceName, nullptr, &fpArray));
+
+        uint32_t* indices{};
+        Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetMatchingFontIndices(WinString(L""), 0, nullptr, nullptr, &indices));
+        Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetMatchingFontIndices(WinString(L""), 0, nullptr, &u, nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetMatchingFontIndices(WinString(L""), 1, nullptr, &u, &indices));
+        Assert::AreEqual(E_INVALIDARG, canvasFontSet->GetMatchingFontIndicesWithStyle(WinString(L""), FontWeight{ 100 }, FontStretch_Normal, FontStyle_Normal, 0, nullptr, &u, nullptr));
 #endif
     }
 
@@ -278,6 +284,9 @@ TEST_CLASS(CanvasFontSetTests)
         Assert::AreEqual(RO_E_CLOSED, canvasFontSet->GetPropertyValuesFromIndex(0, CanvasFontPropertyIdentifier::FaceName, &map));
         Assert::AreEqual(RO_E_CLOSED, canvasFontSet->GetPropertyValuesFromIdentifier(CanvasFontPropertyIdentifier::FaceName, WinString(L""), &u, &fpArray));
         Assert::AreEqual(RO_E_CLOSED, canvasFontSet->GetPropertyValues(CanvasFontPropertyIdentifier::FaceName, &u, &fpArray));
+
+        uint32_t* indices{};
+        Assert::AreEqual(RO_E_CLOSED, canvasFontSet->GetMatchingFontIndices(WinString(L""), 0, nullptr, &u, &indices));
 #endif
     }
 
@@ -494,6 +503,114 @@ TEST_CLASS(CanvasFontSetTests)
         Assert::IsTrue(IsSameInstance(filteredDWriteResource.Get(), matchingFontsInnerResource.Get()));
     }
 
+    struct FontIndexFixture
+    {
+        struct TestFont
+        {
+            wchar_t const* FamilyName;
+            DWRITE_FONT_WEIGHT Weight;
+            DWRITE_FONT_STYLE Style;
+            DWRITE_UNICODE_RANGE UnicodeRange;
+        };
+
+        ComPtr<MockDWriteFontSet> DWriteResource;
+        std::vector<ComPtr<MockDWriteFontFaceReference>> FontFaceReferences;
+        ComPtr<CanvasFontSet> FontSet;
+
+        // Each font is only opened once, however many times the set is filtered.
+        FontIndexFixture(std::vector<TestFont> const& fonts)
+            : DWriteResource(Make<MockDWriteFontSet>())
+        {
+            for (auto& font : fonts)
+            {
+                auto fontFace = Make<MockDWriteFontFace>();
+
+                fontFace->GetFamilyNamesMethod.SetExpectedCalls(1,
+                    [=](IDWriteLocalizedStrings** out)
+                    {
+                        return Make<LocalizedFontNames>(font.FamilyName, L"en-us").CopyTo(out);
+                    });
+                fontFace->GetWeightMethod.SetExpectedCalls(1, [=] { return font.Weight; });
+                fontFace->GetStretchMethod.SetExpectedCalls(1, [] { return DWRITE_FONT_STRETCH_NORMAL; });
+                fontFace->GetStyleMethod.SetExpectedCalls(1, [=] { return font.Style; });
+                fontFace->GetUnicodeRangesMethod.SetExpectedCalls(2,
+                    [=](uint32_t maxRangeCount, DWRITE_UNICODE_RANGE* ranges, uint32_t* actualRangeCount)
+                    {
+                        *actualRangeCount = 1;
+
+                        if (maxRangeCount < 1)
+                            return E_NOT_SUFFICIENT_BUFFER;
+
+                        ranges[0] = font.UnicodeRange;
+                        return S_OK;
+                    });
+
+                auto fontFaceReference = Make<MockDWriteFontFaceReference>();
+                fontFaceReference->CreateFontFaceMethod.SetExpectedCalls(1,
+                    [=](IDWriteFontFace3** out)
+                    {
+                        return fontFace.CopyTo(out);
+                    });
+
+                FontFaceReferences.push_back(fontFaceReference);
+            }
+
+            DWriteResource->GetFontCountMethod.SetExpectedCalls(1, [=] { return static_cast<uint32_t>(fonts.size()); });
+            DWriteResource->GetFontFaceReferenceMethod.SetExpectedCalls(static_cast<int>(fonts.size()),
+                [&](UINT32 index, IDWriteFontFaceReference** out)
+                {
+                    return FontFaceReferences[index].CopyTo(out);
+                });
+
+            FontSet = Make<CanvasFontSet>(DWriteResource.Get());
+        }
+
+        std::vector<uint32_t> GetMatchingFontIndices(wchar_t const* familyNameFilter, std::vector<uint32_t> characters = {})
+        {
+            ComArray<uint32_t> indices;
+            ThrowIfFailed(FontSet->GetMatchingFontIndices(WinString(familyNameFilter), static_cast<uint32_t>(characters.size()), characters.data(), indices.GetAddressOfSize(), indices.GetAddressOfData()));
+            return std::vector<uint32_t>(begin(indices), end(indices));
+        }
+    };
+
+    TEST_METHOD_EX(CanvasFontSet_GetMatchingFontIndices_FiltersOnFamilyNameAndCharacters)
+    {
+        FontIndexFixture f({
+            { L"Segoe UI", DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, { 0x20, 0x7F } },
+            { L"Segoe UI Symbol", DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, { 0x2600, 0x26FF } },
+            { L"Arial", DWRITE_FONT_WEIGHT_BOLD, DWRITE_FONT_STYLE_ITALIC, { 0x20, 0x7F } },
+        });
+
+        Assert::IsTrue(std::vector<uint32_t>{ 0, 1, 2 } == f.GetMatchingFontIndices(L""));
+        Assert::IsTrue(std::vector<uint32_t>{ 0, 1 } == f.GetMatchingFontIndices(L"segoe"));
+        Assert::IsTrue(std::vector<uint32_t>{ 1 } == f.GetMatchingFontIndices(L"SYMBOL"));
+        Assert::IsTrue(std::vector<uint32_t>{ 0, 2 } == f.GetMatchingFontIndices(L"", { L'A', L'z' }));
+        Assert::IsTrue(std::vector<uint32_t>{ 1 } == f.GetMatchingFontIndices(L"", { 0x2603 }));
+        Assert::IsTrue(std::vector<uint32_t>{ } == f.GetMatchingFontIndices(L"Arial", { 0x2603 }));
+        Assert::IsTrue(std::vector<uint32_t>{ } == f.GetMatchingFontIndices(L"Times"));
+    }
+
+    TEST_METHOD_EX(CanvasFontSet_GetMatchingFontIndicesWithStyle)
+    {
+        FontIndexFixture f({
+            { L"Arial", DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, { 0x20, 0x7F } },
+            { L"Arial", DWRITE_FONT_WEIGHT_BOLD, DWRITE_FONT_STYLE_NORMAL, { 0x20, 0x7F } },
+            { L"Arial", DWRITE_FONT_WEIGHT_BOLD, DWRITE_FONT_STYLE_ITALIC, { 0x20, 0x7F } },
+        });
+
+        auto getMatchingFontIndices = [&](FontWeight weight, FontStyle style)
+        {
+            ComArray<uint32_t> indices;
+            ThrowIfFailed(f.FontSet->GetMatchingFontIndicesWithStyle(WinString(L"Arial"), weight, FontStretch_Undefined, style, 0, nullptr, indices.GetAddressOfSize(), indices.GetAddressOfData()));
+            return std::vector<uint32_t>(begin(indices), end(indices));
+        };
+
+        Assert::IsTrue(std::vector<uint32_t>{ 1 } == getMatchingFontIndices(FontWeight{ 700 }, FontStyle_Normal));
+        Assert::IsTrue(std::vector<uint32_t>{ 2 } == getMatchingFontIndices(FontWeight{ 700 }, FontStyle_Italic));
+        Assert::IsTrue(std::vector<uint32_t>{ 0, 1 } == getMatchingFontIndices(FontWeight{ 0 }, FontStyle_Normal));
+        Assert::IsTrue(std::vector<uint32_t>{ } == getMatchingFontIndices(FontWeight{ 400 }, FontStyle_Italic));
+    }
+
     TEST_METHOD_EX(CanvasFontSet_CountFontsMatchingProperty)
     {
         auto dwriteResource = Make<MockDWriteFontSet>();
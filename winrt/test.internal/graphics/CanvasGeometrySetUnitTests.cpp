@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include <lib/geometry/CanvasGeometrySet.h>
+#include "mocks/MockD2DGeometryGroup.h"
+#include "mocks/MockD2DRectangleGeometry.h"
+#include "mocks/MockGeometryAdapter.h"
+
+TEST_CLASS(CanvasGeometrySetTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        std::vector<ComPtr<MockD2DRectangleGeometry>> D2DGeometries;
+        std::vector<ComPtr<ICanvasGeometry>> Geometries;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+        {
+        }
+
+        // Adds a geometry whose fill is exactly its bounds.
+        void AddGeometry(D2D1_RECT_F bounds)
+        {
+            auto d2dGeometry = Make<MockD2DRectangleGeometry>();
+
+            d2dGeometry->GetBoundsMethod.AllowAnyCall(
+                [=](D2D1_MATRIX_3X2_F const* transform, D2D1_RECT_F* value)
+                {
+                    Assert::IsNull(transform);
+                    *value = bounds;
+                    return S_OK;
+                });
+
+            d2dGeometry->FillContainsPointMethod.AllowAnyCall(
+                [=](D2D1_POINT_2F point, D2D1_MATRIX_3X2_F const*, float, BOOL* contains)
+                {
+                    *contains = point.x >= bounds.left && point.x <= bounds.right &&
+                                point.y >= bounds.top && point.y <= bounds.bottom;
+                    return S_OK;
+                });
+
+            D2DGeometries.push_back(d2dGeometry);
+            Geometries.push_back(Make<CanvasGeometry>(As<ICanvasDevice>(Device).Get(), d2dGeometry.Get()));
+        }
+
+        ComPtr<CanvasGeometrySet> CreateSet()
+        {
+            std::vector<ICanvasGeometry*> geometries;
+
+            for (auto& geometry : Geometries)
+            {
+                geometries.push_back(geometry.Get());
+            }
+
+            return CanvasGeometrySet::CreateNew(static_cast<uint32_t>(geometries.size()), geometries.data());
+        }
+    };
+
+    static std::vector<uint32_t> ToVector(ComArray<uint32_t>& array)
+    {
+        return std::vector<uint32_t>(array.GetData(), array.GetData() + array.GetSize());
+    }
+
+    TEST_METHOD_EX(CanvasGeometrySet_FindGeometriesContainingPoint_OnlyTestsCandidates)
+    {
+        Fixture f;
+
+        for (int i = 0; i < 100; i++)
+        {
+            float x = static_cast<float>(i * 10);
+            f.AddGeometry(D2D1_RECT_F{ x, 0, x + 5, 5 });
+        }
+
+        // An overlapping geometry, added last.
+        f.AddGeometry(D2D1_RECT_F{ 500, 0, 520, 5 });
+
+        auto geometrySet = f.CreateSet();
+
+        for (auto& d2dGeometry : f.D2DGeometries)
+        {
+            d2dGeometry->FillContainsPointMethod.SetExpectedCalls(0);
+        }
+
+        // Only geometries whose bounds include the point are asked about it.
+        for (auto index : { 50, 100 })
+        {
+            f.D2DGeometries[index]->FillContainsPointMethod.SetExpectedCalls(1,
+                [](D2D1_POINT_2F, D2D1_MATRIX_3X2_F const*, float, BOOL* contains)
+                {
+                    *contains = TRUE;
+                    return S_OK;
+                });
+        }
+
+        ComArray<uint32_t> hits;
+        ThrowIfFailed(geometrySet->FindGeometriesContainingPoint(Vector2{ 502, 2 }, hits.GetAddressOfSize(), hits.GetAddressOfData()));
+
+        Assert::IsTrue(ToVector(hits) == std::vector<uint32_t>{ 50, 100 });
+    }
+
+    TEST_METHOD_EX(CanvasGeometrySet_FindGeometriesWithBoundsIntersecting_MatchesBruteForce)
+    {
+        Fixture f;
+
+        std::vector<D2D1_RECT_F> allBounds;
+
+        for (int y = 0; y < 20; y++)
+        {
+            for (int x = 0; x < 20; x++)
+            {
+                auto bounds = D2D1_RECT_F{ x * 10.0f, y * 10.0f, x * 10.0f + (x % 3) * 7.0f, y * 10.0f + (y % 4) * 5.0f };
+                allBounds.push_back(bounds);
+                f.AddGeometry(bounds);
+            }
+        }
+
+        auto geometrySet = f.CreateSet();
+
+        Rect queries[] =
+        {
+            { 0, 0, 1, 1 },
+            { 35, 42, 50, 13 },
+            { -10, -10, 5, 500 },
+            { 0, 0, 1000, 1000 },
+            { 500, 500, 10, 10 },
+        };
+
+        for (auto& query : queries)
+        {
+            auto queryBounds = ToD2DRect(query);
+
+            std::vector<uint32_t> expected;
+
+            for (uint32_t i = 0; i < allBounds.size(); i++)
+            {
+                auto& b = allBounds[i];
+
+                if (b.left <= queryBounds.right && queryBounds.left <= b.right &&
+                    b.top <= queryBounds.bottom && queryBounds.top <= b.bottom)
+                {
+                    expected.push_back(i);
+                }
+            }
+
+            ComArray<uint32_t> hits;
+            ThrowIfFailed(geometrySet->FindGeometriesWithBoundsIntersecting(query, hits.GetAddressOfSize(), hits.GetAddressOfData()));
+
+            Assert::IsTrue(expected == ToVector(hits));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasGeometrySet_EmptyGeometriesAreNeverFound)
+    {
+        Fixture f;
+
+        f.AddGeometry(D2D1_RECT_F{ FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX });
+        f.AddGeometry(D2D1_RECT_F{ 0, 0, 10, 10 });
+
+        auto geometrySet = f.CreateSet();
+
+        ComArray<uint32_t> hits;
+        ThrowIfFailed(geometrySet->FindGeometriesWithBoundsIntersecting(Rect{ -1000, -1000, 2000, 2000 }, hits.GetAddressOfSize(), hits.GetAddressOfData()));
+
+        Assert::IsTrue(ToVector(hits) == std::vector<uint32_t>{ 1 });
+
+        uint32_t count;
+        ThrowIfFailed(geometrySet->get_Count(&count));
+        Assert::AreEqual(2u, count);
+    }
+
+    TEST_METHOD_EX(CanvasGeometrySet_GetGeometry)
+    {
+        Fixture f;
+
+        f.AddGeometry(D2D1_RECT_F{ 0, 0, 1, 1 });
+        f.AddGeometry(D2D1_RECT_F{ 2, 2, 3, 3 });
+
+        auto geometrySet = f.CreateSet();
+
+        ComPtr<ICanvasGeometry> geometry;
+        ThrowIfFailed(geometrySet->GetGeometry(1, &geometry));
+        Assert::IsTrue(IsSameInstance(f.Geometries[1].Get(), geometry.Get()));
+
+        Assert::AreEqual(E_BOUNDS, geometrySet->GetGeometry(2, &geometry));
+    }
+
+    TEST_METHOD_EX(CanvasGeometrySet_InvalidArgs)
+    {
+        Fixture f;
+
+        ExpectHResultException(E_INVALIDARG, [] { CanvasGeometrySet::CreateNew(1, nullptr); });
+
+        ICanvasGeometry* nullGeometry = nullptr;
+        ExpectHResultException(E_INVALIDARG, [&] { CanvasGeometrySet::CreateNew(1, &nullGeometry); });
+
+        f.AddGeometry(D2D1_RECT_F{ 0, 0, 1, 1 });
+        auto geometrySet = f.CreateSet();
+
+        ComArray<uint32_t> hits;
+        uint32_t count;
+        Assert::AreEqual(E_INVALIDARG, geometrySet->get_Count(nullptr));
+        Assert::AreEqual(E_INVALIDARG, geometrySet->GetGeometry(0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, geometrySet->FindGeometriesContainingPoint(Vector2{}, nullptr, hits.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, geometrySet->FindGeometriesContainingPoint(Vector2{}, &count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, geometrySet->FindGeometriesWithBoundsIntersecting(Rect{}, nullptr, hits.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, geometrySet->FindGeometriesWithBoundsIntersecting(Rect{}, &count, nullptr));
+
+        ComPtr<ICanvasGeometry> group;
+        Assert::AreEqual(E_INVALIDARG, geometrySet->CreateGroup(nullptr, &group));
+        Assert::AreEqual(E_INVALIDARG, geometrySet->CreateGroup(f.Device.Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasGeometrySet_CreateGroup_UsesResolvedD2DGeometries)
+    {
+        Fixture f;
+
+        for (int i = 0; i < 3; i++)
+        {
+            float x = static_cast<float>(i * 10);
+            f.AddGeometry(D2D1_RECT_F{ x, 0, x + 5, 5 });
+        }
+
+        auto geometrySet = f.CreateSet();
+
+        auto adapter = std::make_shared<MockGeometryAdapter>();
+        GeometryAdapter::SetInstance(adapter);
+
+        ID2D1Geometry** firstArray = nullptr;
+
+        adapter->CreateGeometryGroupMethod.SetExpectedCalls(2,
+            [&](D2D1_FILL_MODE fillMode, ID2D1Geometry** geometries, uint32_t geometryCount)
+            {
+                Assert::AreEqual(3u, geometryCount);
+
+                for (uint32_t i = 0; i < geometryCount; i++)
+                {
+                    Assert::AreEqual(static_cast<ID2D1Geometry*>(f.D2DGeometries[i].Get()), geometries[i]);
+                }
+
+                // Rebuilding the group hands D2D the same array again.
+                if (!firstArray)
+                {
+                    Assert::AreEqual(D2D1_FILL_MODE_ALTERNATE, fillMode);
+                    firstArray = geometries;
+                }
+                else
+                {
+                    Assert::AreEqual(D2D1_FILL_MODE_WINDING, fillMode);
+                    Assert::IsTrue(firstArray == geometries);
+                }
+
+                return Make<MockD2DGeometryGroup>();
+            });
+
+        ComPtr<ICanvasGeometry> group;
+        ThrowIfFailed(geometrySet->CreateGroup(f.Device.Get(), &group));
+        Assert::IsNotNull(group.Get());
+
+        ThrowIfFailed(geometrySet->CreateGroupWithFilledRegionDetermination(f.Device.Get(), CanvasFilledRegionDetermination::Winding, &group));
+        Assert::IsNotNull(group.Get());
+    }
+};
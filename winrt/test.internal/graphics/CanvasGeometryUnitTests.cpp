@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include <lib/geometry/CanvasPathBuilder.h>
+#include <lib/geometry/TessellationSink.h>
 #include <lib/text/CanvasFontFace.h>
 #include "mocks/MockD2DRectangleGeometry.h"
 #include "mocks/MockD2DEllipseGeometry.h"
@@ -136,11 +137,8 @@ public:
 
     class CreatePolygonFixture : public Fixture
     {
-        int currentVertex;
-
     public:
         CreatePolygonFixture(int expectedVertexCount, Vector2 const* expectedVertices)
-            : currentVertex(0)
         {
             Adapter->CreatePathGeometryMethod.SetExpectedCalls(1,
                 [=]
@@ -161,11 +159,15 @@ public:
                                         Assert::AreEqual(D2D1_FIGURE_BEGIN_FILLED, mode);
                                     });
 
-                                geometrySink->AddLineMethod.SetExpectedCalls(expectedVertexCount - 1,
-                                    [=](D2D1_POINT_2F point)
+                                geometrySink->AddLinesMethod.SetExpectedCalls(expectedVertexCount > 1 ? 1 : 0,
+                                    [=](D2D1_POINT_2F const* points, UINT32 pointsCount)
                                     {
-                                        Assert::IsTrue(++currentVertex < expectedVertexCount);
-                                        Assert::AreEqual(ToD2DPoint(expectedVertices[currentVertex]), point);
+                                        Assert::AreEqual<UINT32>(expectedVertexCount - 1, pointsCount);
+
+                                        for (UINT32 i = 0; i < pointsCount; i++)
+                                        {
+                                            Assert::AreEqual(ToD2DPoint(expectedVertices[i + 1]), points[i]);
+                                        }
                                     });
 
                                 geometrySink->EndFigureMethod.SetExpectedCalls(1,
@@ -222,6 +224,225 @@ public:
         ExpectHResultException(E_INVALIDARG, [&]{ CanvasGeometry::CreateNew(f.Device.Get(), 1, nullptr); });
     }
 
+    TEST_METHOD_EX(CanvasGeometry_CreatePolygon_MetricsAreComputedWithoutD2D)
+    {
+        Vector2 square[] =
+        {
+            { 0, 0 },
+            { 10, 0 },
+            { 10, 10 },
+            { 0, 10 },
+        };
+
+        // The mock path geometry fails the test if any of its metric methods are called.
+        CreatePolygonFixture f(4, square);
+
+        auto canvasGeometry = CanvasGeometry::CreateNew(f.Device.Get(), 4, square);
+
+        float length;
+        ThrowIfFailed(canvasGeometry->ComputePathLength(&length));
+        Assert::AreEqual(40.0f, length);
+
+        Matrix3x2 scale{ 2, 0, 0, 2, 5, 5 };
+        ThrowIfFailed(canvasGeometry->ComputePathLengthWithTransformAndFlatteningTolerance(scale, D2D1_DEFAULT_FLATTENING_TOLERANCE, &length));
+        Assert::AreEqual(80.0f, length);
+
+        Rect bounds;
+        ThrowIfFailed(canvasGeometry->ComputeBoundsWithTransform(scale, &bounds));
+        Assert::AreEqual(Rect{ 5, 5, 20, 20 }, bounds);
+
+        Vector2 point;
+        Vector2 tangent;
+        ThrowIfFailed(canvasGeometry->ComputePointOnPathWithTangent(15, &tangent, &point));
+        Assert::AreEqual(Vector2{ 10, 5 }, point);
+        Assert::AreEqual(Vector2{ 0, 1 }, tangent);
+
+        // The closing segment counts as part of the path.
+        ThrowIfFailed(canvasGeometry->ComputePointOnPathWithTangent(35, &tangent, &point));
+        Assert::AreEqual(Vector2{ 0, 5 }, point);
+        Assert::AreEqual(Vector2{ 0, -1 }, tangent);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_CreatePolylines_AddsOneFigurePerOffset)
+    {
+        Fixture f;
+
+        Vector2 points[] = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 }, { 9, 10 } };
+        uint32_t figureOffsets[] = { 0, 3, 4 };
+
+        f.Adapter->CreatePathGeometryMethod.SetExpectedCalls(1,
+            [&]
+            {
+                auto pathGeometry = Make<MockD2DPathGeometry>();
+
+                pathGeometry->OpenMethod.SetExpectedCalls(1,
+                    [&](ID2D1GeometrySink** out)
+                    {
+                        auto geometrySink = Make<MockD2DGeometrySink>();
+
+                        int figure = 0;
+                        geometrySink->BeginFigureMethod.SetExpectedCalls(3,
+                            [=](D2D1_POINT_2F point, D2D1_FIGURE_BEGIN) mutable
+                            {
+                                Assert::AreEqual(ToD2DPoint(points[figureOffsets[figure++]]), point);
+                            });
+
+                        // The single point figure at offset 3 adds no lines.
+                        int addLinesCall = 0;
+                        geometrySink->AddLinesMethod.SetExpectedCalls(2,
+                            [=](D2D1_POINT_2F const* linePoints, UINT32 count) mutable
+                            {
+                                if (addLinesCall++ == 0)
+                                {
+                                    Assert::AreEqual(2u, count);
+                                    Assert::AreEqual(ToD2DPoint(points[1]), linePoints[0]);
+                                    Assert::AreEqual(ToD2DPoint(points[2]), linePoints[1]);
+                                }
+                                else
+                                {
+                                    Assert::AreEqual(1u, count);
+                                    Assert::AreEqual(ToD2DPoint(points[4]), linePoints[0]);
+                                }
+                            });
+
+                        geometrySink->EndFigureMethod.SetExpectedCalls(3,
+                            [](D2D1_FIGURE_END mode)
+                            {
+                                Assert::AreEqual(D2D1_FIGURE_END_OPEN, mode);
+                            });
+
+                        geometrySink->CloseMethod.SetExpectedCalls(1);
+
+                        return geometrySink.CopyTo(out);
+                    });
+
+                return pathGeometry;
+            });
+
+        CanvasGeometry::CreateNew(f.Device.Get(), _countof(points), points, _countof(figureOffsets), figureOffsets, CanvasFigureLoop::Open);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_CreatePolylines_InvalidOffsets)
+    {
+        Fixture f;
+
+        Vector2 points[3] = {};
+
+        auto check = [&](std::vector<uint32_t> offsets)
+        {
+            ExpectHResultException(E_INVALIDARG,
+                [&] { CanvasGeometry::CreateNew(f.Device.Get(), 3, points, static_cast<uint32_t>(offsets.size()), offsets.data(), CanvasFigureLoop::Open); });
+        };
+
+        check({ 1 });       // Doesn't start at zero
+        check({ 0, 3 });    // Past the end of the points
+        check({ 0, 2, 1 }); // Out of order
+        check({ 0, 0 });    // Empty figure
+
+        ExpectHResultException(E_INVALIDARG,
+            [&] { CanvasGeometry::CreateNew(f.Device.Get(), 3, nullptr, 1, nullptr, CanvasFigureLoop::Open); });
+    }
+
+    class CreateFromPathDataFixture : public Fixture
+    {
+    public:
+        CreateFromPathDataFixture()
+        {
+            Adapter->CreatePathGeometryMethod.SetExpectedCalls(1,
+                []
+                {
+                    auto pathGeometry = Make<MockD2DPathGeometry>();
+
+                    pathGeometry->OpenMethod.SetExpectedCalls(1,
+                        [](ID2D1GeometrySink** out)
+                        {
+                            auto geometrySink = Make<MockD2DGeometrySink>();
+
+                            geometrySink->BeginFigureMethod.SetExpectedCalls(1,
+                                [](D2D1_POINT_2F point, D2D1_FIGURE_BEGIN figureBegin)
+                                {
+                                    Assert::AreEqual(D2D1_POINT_2F{ 1, 2 }, point);
+                                    Assert::AreEqual(D2D1_FIGURE_BEGIN_FILLED, figureBegin);
+                                });
+
+                            geometrySink->AddLineMethod.SetExpectedCalls(1,
+                                [](D2D1_POINT_2F point)
+                                {
+                                    Assert::AreEqual(D2D1_POINT_2F{ 3, 4 }, point);
+                                });
+
+                            geometrySink->EndFigureMethod.SetExpectedCalls(1,
+                                [](D2D1_FIGURE_END figureEnd)
+                                {
+                                    Assert::AreEqual(D2D1_FIGURE_END_CLOSED, figureEnd);
+                                });
+
+                            geometrySink->CloseMethod.SetExpectedCalls(1);
+
+                            return geometrySink.CopyTo(out);
+                        });
+
+                    return pathGeometry;
+                });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasGeometry_CreateFromPathData_ParsesIntoPathGeometry)
+    {
+        CreateFromPathDataFixture f;
+
+        auto canvasGeometryFactory = Make<CanvasGeometryFactory>();
+
+        ComPtr<ICanvasGeometry> geometry;
+        ThrowIfFailed(canvasGeometryFactory->CreateFromPathData(f.Device.Get(), WinString(L"M1 2 L3 4 Z"), &geometry));
+
+        Assert::IsNotNull(geometry.Get());
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_CreateFromPathDataUtf8_SkipsByteOrderMark)
+    {
+        CreateFromPathDataFixture f;
+
+        auto canvasGeometryFactory = Make<CanvasGeometryFactory>();
+
+        char pathData[] = "\xEF\xBB\xBFM1 2 L3 4 Z";
+
+        ComPtr<ICanvasGeometry> geometry;
+        ThrowIfFailed(canvasGeometryFactory->CreateFromPathDataUtf8(f.Device.Get(), static_cast<uint32_t>(strlen(pathData)), reinterpret_cast<BYTE*>(pathData), &geometry));
+
+        Assert::IsNotNull(geometry.Get());
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_CreateFromPathData_InvalidArgs)
+    {
+        Fixture f;
+
+        // Only the malformed path data gets as far as opening a geometry,
+        // and the parser fails before adding anything to the sink.
+        f.Adapter->CreatePathGeometryMethod.SetExpectedCalls(1,
+            []
+            {
+                auto pathGeometry = Make<MockD2DPathGeometry>();
+
+                pathGeometry->OpenMethod.SetExpectedCalls(1,
+                    [](ID2D1GeometrySink** out)
+                    {
+                        return Make<MockD2DGeometrySink>().CopyTo(out);
+                    });
+
+                return pathGeometry;
+            });
+
+        auto canvasGeometryFactory = Make<CanvasGeometryFactory>();
+
+        ComPtr<ICanvasGeometry> geometry;
+
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateFromPathData(f.Device.Get(), WinString(L"M1 2"), nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateFromPathData(f.Device.Get(), WinString(L"L1 2"), &geometry));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateFromPathDataUtf8(f.Device.Get(), 1, nullptr, &geometry));
+        Assert::IsNull(geometry.Get());
+    }
+
     class GeometryGroupFixture : public Fixture
     {
         struct Resource
@@ -662,6 +883,20 @@ public:
         Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->SimplifyWithTransformAndFlatteningTolerance(CanvasGeometrySimplification::Lines, Matrix3x2{}, 0, nullptr));
     }
 
+    TEST_METHOD_EX(CanvasGeometry_GeometryOperationsAsync_NullArgs)
+    {
+        GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
+        IAsyncOperation<CanvasGeometry*>* operation;
+
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->CombineWithAsync(nullptr, Matrix3x2{}, CanvasGeometryCombine::Union, &operation));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->CombineWithAsync(f.RectangleGeometry.Get(), Matrix3x2{}, CanvasGeometryCombine::Union, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->StrokeAsync(1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->StrokeWithStrokeStyleAsync(1, nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->StrokeWithAllOptionsAsync(1, nullptr, Matrix3x2{}, 0, &operation));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->OutlineAsync(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->SimplifyAsync(CanvasGeometrySimplification::Lines, nullptr));
+    }
+
     TEST_METHOD_EX(CanvasGeometry_Transform)
     {
         GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
@@ -918,6 +1153,118 @@ public:
         Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->ComputePointOnPathWithTransformAndFlatteningToleranceAndTangent(0, Matrix3x2{}, 0, nullptr, &pt));
     }
 
+    static void ExpectSimplifyToSquare(MockD2DRectangleGeometry* geometry, int expectedCalls)
+    {
+        geometry->SimplifyMethod.SetExpectedCalls(expectedCalls,
+            [](D2D1_GEOMETRY_SIMPLIFICATION_OPTION simplification, CONST D2D1_MATRIX_3X2_F*, FLOAT, ID2D1SimplifiedGeometrySink* sink)
+            {
+                Assert::AreEqual(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, simplification);
+
+                D2D1_POINT_2F points[] = { { 10, 0 }, { 10, 10 }, { 0, 10 } };
+
+                sink->BeginFigure(D2D1_POINT_2F{ 0, 0 }, D2D1_FIGURE_BEGIN_FILLED);
+                sink->AddLines(points, _countof(points));
+                sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+
+                return S_OK;
+            });
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_ComputePointOnPath_WhenRepeatedWithSameArguments_UsesFlattenedPath)
+    {
+        GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
+
+        f.D2DRectangleGeometry->ComputePointAtLengthMethod.SetExpectedCalls(1,
+            [=](FLOAT, CONST D2D1_MATRIX_3X2_F*, FLOAT, D2D1_POINT_2F* position, D2D1_POINT_2F* tangent)
+            {
+                *position = D2D1_POINT_2F{ 10, 5 };
+                *tangent = D2D1_POINT_2F{ 0, 1 };
+                return S_OK;
+            });
+
+        Vector2 point;
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPath(15.0f, &point));
+        Assert::AreEqual(Vector2{ 10, 5 }, point);
+
+        ExpectSimplifyToSquare(f.D2DRectangleGeometry.Get(), 1);
+
+        Vector2 tangent;
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPathWithTangent(15.0f, &tangent, &point));
+        Assert::AreEqual(Vector2{ 10, 5 }, point);
+        Assert::AreEqual(Vector2{ 0, 1 }, tangent);
+
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPathWithTangent(25.0f, &tangent, &point));
+        Assert::AreEqual(Vector2{ 5, 10 }, point);
+        Assert::AreEqual(Vector2{ -1, 0 }, tangent);
+
+        // Distances are clamped to the ends of the path, including the closing segment.
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPathWithTangent(0.0f, &tangent, &point));
+        Assert::AreEqual(Vector2{ 0, 0 }, point);
+        Assert::AreEqual(Vector2{ 1, 0 }, tangent);
+
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPathWithTangent(100.0f, &tangent, &point));
+        Assert::AreEqual(Vector2{ 0, 0 }, point);
+        Assert::AreEqual(Vector2{ 0, -1 }, tangent);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_ComputePointOnPath_WithDifferentArguments_DoesNotFlatten)
+    {
+        GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
+
+        f.D2DRectangleGeometry->ComputePointAtLengthMethod.SetExpectedCalls(2,
+            [=](FLOAT, CONST D2D1_MATRIX_3X2_F*, FLOAT, D2D1_POINT_2F* position, D2D1_POINT_2F* tangent)
+            {
+                *position = D2D1_POINT_2F{};
+                *tangent = D2D1_POINT_2F{};
+                return S_OK;
+            });
+
+        Vector2 point, tangent;
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPath(1.0f, &point));
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePointOnPathWithTransformAndFlatteningToleranceAndTangent(1.0f, sc_someTransform, 2.0f, &tangent, &point));
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_ComputeMetrics_WhenRepeatedWithSameArguments_AreOnlyComputedOnce)
+    {
+        GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
+
+        f.D2DRectangleGeometry->ComputeAreaMethod.SetExpectedCalls(1,
+            [=](CONST D2D1_MATRIX_3X2_F*, FLOAT, float* area) { *area = 123.0f; return S_OK; });
+
+        f.D2DRectangleGeometry->ComputeLengthMethod.SetExpectedCalls(1,
+            [=](CONST D2D1_MATRIX_3X2_F*, FLOAT, float* length) { *length = 456.0f; return S_OK; });
+
+        f.D2DRectangleGeometry->GetBoundsMethod.SetExpectedCalls(1,
+            [=](CONST D2D1_MATRIX_3X2_F*, D2D1_RECT_F* bounds) { *bounds = D2D1_RECT_F{ 1, 2, 3, 4 }; return S_OK; });
+
+        for (int i = 0; i < 3; i++)
+        {
+            float area, length;
+            Rect bounds;
+
+            Assert::AreEqual(S_OK, f.RectangleGeometry->ComputeArea(&area));
+            Assert::AreEqual(S_OK, f.RectangleGeometry->ComputePathLength(&length));
+            Assert::AreEqual(S_OK, f.RectangleGeometry->ComputeBounds(&bounds));
+
+            Assert::AreEqual(123.0f, area);
+            Assert::AreEqual(456.0f, length);
+            Assert::AreEqual(Rect{ 1, 2, 2, 2 }, bounds);
+        }
+
+        // A different transform is asked of D2D again.
+        f.D2DRectangleGeometry->ComputeAreaMethod.SetExpectedCalls(1,
+            [=](CONST D2D1_MATRIX_3X2_F* transform, FLOAT, float* area)
+            {
+                Assert::AreEqual(sc_someD2DTransform, *transform);
+                *area = 789.0f;
+                return S_OK;
+            });
+
+        float area;
+        Assert::AreEqual(S_OK, f.RectangleGeometry->ComputeAreaWithTransformAndFlatteningTolerance(sc_someTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE, &area));
+        Assert::AreEqual(789.0f, area);
+    }
+
     TEST_METHOD_EX(CanvasGeometry_FillContainsPoint)
     {
         GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
@@ -1218,6 +1565,84 @@ public:
         f.ValidateTessellatedTriangles(triangles);
     }
 
+    TEST_METHOD_EX(CanvasGeometry_BufferTessellationSink_WritesDirectlyIntoBuffer)
+    {
+        TessellateFixture f;
+        f.ExpectOneTessellateCall(sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE);
+
+        CanvasTriangleVertices buffer[4] = {};
+
+        auto sink = Make<BufferTessellationSink>(buffer, 4);
+        ThrowIfFailed(f.D2DRectangleGeometry->Tessellate(&sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE, sink.Get()));
+
+        Assert::AreEqual(3u, sink->GetCount());
+        Assert::IsFalse(sink->Overflowed());
+
+        Assert::AreEqual(sc_triangle1, *ReinterpretAs<D2D1_TRIANGLE const*>(&buffer[0]));
+        Assert::AreEqual(sc_triangle2, *ReinterpretAs<D2D1_TRIANGLE const*>(&buffer[1]));
+        Assert::AreEqual(sc_triangle3, *ReinterpretAs<D2D1_TRIANGLE const*>(&buffer[2]));
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_BufferTessellationSink_WhenBufferTooSmall_CountsAllTriangles)
+    {
+        TessellateFixture f;
+        f.ExpectOneTessellateCall(sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE);
+
+        CanvasTriangleVertices buffer[2] = {};
+
+        auto sink = Make<BufferTessellationSink>(buffer, 2);
+        ThrowIfFailed(f.D2DRectangleGeometry->Tessellate(&sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE, sink.Get()));
+
+        Assert::AreEqual(3u, sink->GetCount());
+        Assert::IsTrue(sink->Overflowed());
+
+        // Nothing is written past the end of the buffer.
+        Assert::AreEqual(sc_triangle1, *ReinterpretAs<D2D1_TRIANGLE const*>(&buffer[0]));
+        Assert::AreEqual(sc_triangle2, *ReinterpretAs<D2D1_TRIANGLE const*>(&buffer[1]));
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_TessellateManyAsync_InvalidArgs)
+    {
+        auto canvasGeometryFactory = Make<CanvasGeometryFactory>();
+
+        auto fakeGeometries = reinterpret_cast<IIterable<CanvasGeometry*>*>(0x1234);
+        IAsyncOperation<CanvasGeometryTessellation*>* operation;
+
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->TessellateManyAsync(nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->TessellateManyAsync(fakeGeometries, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->TessellateManyAsyncWithOptions(fakeGeometries, Matrix3x2{}, 0, -1, &operation));
+    }
+
+    TEST_METHOD_EX(CanvasGeometryTessellation_ReturnsPackedTrianglesAndOffsets)
+    {
+        std::vector<CanvasTriangleVertices> triangles(3);
+        triangles[0].Vertex1 = Vector2{ 1, 2 };
+        triangles[2].Vertex3 = Vector2{ 3, 4 };
+
+        // Two geometries: the first tessellated into one triangle, the second into two.
+        auto tessellation = Make<CanvasGeometryTessellation>(std::move(triangles), std::vector<uint32_t>{ 0, 1, 3 });
+
+        ComArray<CanvasTriangleVertices> actualTriangles;
+        ThrowIfFailed(tessellation->GetTriangles(actualTriangles.GetAddressOfSize(), actualTriangles.GetAddressOfData()));
+
+        Assert::AreEqual(3u, actualTriangles.GetSize());
+        Assert::AreEqual(Vector2{ 1, 2 }, actualTriangles[0].Vertex1);
+        Assert::AreEqual(Vector2{ 3, 4 }, actualTriangles[2].Vertex3);
+
+        ComArray<uint32_t> offsets;
+        ThrowIfFailed(tessellation->GetTriangleOffsets(offsets.GetAddressOfSize(), offsets.GetAddressOfData()));
+
+        Assert::AreEqual(3u, offsets.GetSize());
+        Assert::AreEqual(0u, offsets[0]);
+        Assert::AreEqual(1u, offsets[1]);
+        Assert::AreEqual(3u, offsets[2]);
+
+        uint32_t geometryCount;
+        ThrowIfFailed(tessellation->get_GeometryCount(&geometryCount));
+        Assert::AreEqual(2u, geometryCount);
+    }
+
     TEST_METHOD_EX(CanvasGeometry_Tessellate_NullArgs)
     {
         GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
@@ -1228,6 +1653,10 @@ public:
 
         Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, nullptr, t.GetAddressOfData()));
         Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, t.GetAddressOfSize(), nullptr));
+
+        UINT32 count;
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBuffer(nullptr, &count));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBufferWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, nullptr, &count));
     }
 
     TEST_METHOD_EX(CanvasGeometry_Closure)
@@ -1265,6 +1694,18 @@ public:
 
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->Transform(m, &g));
 
+        IAsyncOperation<CanvasGeometry*>* operation;
+
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->CombineWithAsync(otherCanvasGeometry.Get(), m, CanvasGeometryCombine::Union, &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->CombineWithUsingFlatteningToleranceAsync(otherCanvasGeometry.Get(), m, CanvasGeometryCombine::Union, 0, &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->StrokeAsync(0, &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->StrokeWithStrokeStyleAsync(0, strokeStyle.Get(), &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->StrokeWithAllOptionsAsync(0, strokeStyle.Get(), m, 0, &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->OutlineAsync(&operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->OutlineWithTransformAndFlatteningToleranceAsync(m, 0, &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->SimplifyAsync(CanvasGeometrySimplification::Lines, &operation));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->SimplifyWithTransformAndFlatteningToleranceAsync(CanvasGeometrySimplification::Lines, m, 0, &operation));
+
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->CompareWith(otherCanvasGeometry.Get(), &r));
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->CompareWithUsingTransformAndFlatteningTolerance(otherCanvasGeometry.Get(), m, 0, &r));
 
@@ -1298,6 +1739,10 @@ public:
         auto geometrySink = Make<StubGeometrySink>();
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->SendPathTo(geometrySink.Get()));
 
+        ComArray<CanvasGeometryPathCommand> commands;
+        ComArray<float> segmentData;
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->GetPathData(commands.GetAddressOfSize(), commands.GetAddressOfData(), segmentData.GetAddressOfSize(), segmentData.GetAddressOfData()));
+
         ComPtr<ICanvasDevice> retrievedDevice;
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->get_Device(&retrievedDevice));
 
@@ -1353,6 +1798,94 @@ public:
 
     }
 
+    TEST_METHOD_EX(CanvasGeometry_GetPathData_NullArgs)
+    {
+        Fixture f;
+
+        auto canvasGeometry = CanvasGeometry::CreateNew(f.Device.Get(), Rect{});
+
+        ComArray<CanvasGeometryPathCommand> commands;
+        ComArray<float> segmentData;
+
+        Assert::AreEqual(E_INVALIDARG, canvasGeometry->GetPathData(nullptr, commands.GetAddressOfData(), segmentData.GetAddressOfSize(), segmentData.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometry->GetPathData(commands.GetAddressOfSize(), nullptr, segmentData.GetAddressOfSize(), segmentData.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometry->GetPathData(commands.GetAddressOfSize(), commands.GetAddressOfData(), nullptr, segmentData.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometry->GetPathData(commands.GetAddressOfSize(), commands.GetAddressOfData(), segmentData.GetAddressOfSize(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_GetPathData_PacksCommandsAndSegmentData)
+    {
+        Fixture f;
+
+        auto mockD2DPathGeometry = Make<MockD2DPathGeometry>();
+        auto canvasGeometry = Make<CanvasGeometry>(f.Device.Get(), mockD2DPathGeometry.Get());
+
+        mockD2DPathGeometry->StreamMethod.SetExpectedCalls(1,
+            [&](ID2D1GeometrySink* internalSink)
+            {
+                D2D1_POINT_2F points[] = { { 3, 4 }, { 5, 6 } };
+                D2D1_BEZIER_SEGMENT bezier{ { 7, 8 }, { 9, 10 }, { 11, 12 } };
+                D2D1_QUADRATIC_BEZIER_SEGMENT quadraticBezier{ { 13, 14 }, { 15, 16 } };
+                D2D1_ARC_SEGMENT arc{ { 17, 18 }, { 19, 20 }, 180, D2D1_SWEEP_DIRECTION_CLOCKWISE, D2D1_ARC_SIZE_LARGE };
+
+                internalSink->SetFillMode(D2D1_FILL_MODE_WINDING);
+                internalSink->BeginFigure(D2D1_POINT_2F{ 1, 2 }, D2D1_FIGURE_BEGIN_HOLLOW);
+                internalSink->AddLines(points, _countof(points));
+                internalSink->SetSegmentFlags(D2D1_PATH_SEGMENT_FORCE_ROUND_LINE_JOIN);
+                internalSink->AddBezier(&bezier);
+                internalSink->AddQuadraticBezier(&quadraticBezier);
+                internalSink->AddArc(&arc);
+                internalSink->EndFigure(D2D1_FIGURE_END_CLOSED);
+                return S_OK;
+            });
+
+        ComArray<CanvasGeometryPathCommand> commands;
+        ComArray<float> segmentData;
+        Assert::AreEqual(S_OK, canvasGeometry->GetPathData(commands.GetAddressOfSize(), commands.GetAddressOfData(), segmentData.GetAddressOfSize(), segmentData.GetAddressOfData()));
+
+        CanvasGeometryPathCommand expectedCommands[] =
+        {
+            CanvasGeometryPathCommand::SetFilledRegionDetermination,
+            CanvasGeometryPathCommand::BeginFigure,
+            CanvasGeometryPathCommand::AddLine,
+            CanvasGeometryPathCommand::AddLine,
+            CanvasGeometryPathCommand::SetSegmentOptions,
+            CanvasGeometryPathCommand::AddCubicBezier,
+            CanvasGeometryPathCommand::AddQuadraticBezier,
+            CanvasGeometryPathCommand::AddArc,
+            CanvasGeometryPathCommand::EndFigure,
+        };
+
+        Assert::AreEqual<uint32_t>(_countof(expectedCommands), commands.GetSize());
+
+        for (uint32_t i = 0; i < commands.GetSize(); i++)
+        {
+            Assert::AreEqual(expectedCommands[i], commands[i]);
+        }
+
+        float pi = 3.14159265f;
+
+        float expectedSegmentData[] =
+        {
+            static_cast<float>(CanvasFilledRegionDetermination::Winding),
+            1, 2, static_cast<float>(CanvasFigureFill::DoesNotAffectFills),
+            3, 4,
+            5, 6,
+            static_cast<float>(CanvasFigureSegmentOptions::ForceRoundLineJoin),
+            7, 8, 9, 10, 11, 12,
+            13, 14, 15, 16,
+            17, 18, 19, 20, pi, static_cast<float>(CanvasSweepDirection::Clockwise), static_cast<float>(CanvasArcSize::Large),
+            static_cast<float>(CanvasFigureLoop::Closed),
+        };
+
+        Assert::AreEqual<uint32_t>(_countof(expectedSegmentData), segmentData.GetSize());
+
+        for (uint32_t i = 0; i < segmentData.GetSize(); i++)
+        {
+            Assert::AreEqual(expectedSegmentData[i], segmentData[i], 0.0001f);
+        }
+    }
+
     TEST_METHOD_EX(CanvasGeometry_SendPathTo_BeginFigure)
     {
         Fixture f;
@@ -2223,6 +2756,136 @@ public:
         Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateInkWithTransformAndFlatteningTolerance(f.Device.Get(), inkStrokes.Get(), Matrix3x2{}, 0, nullptr));
     }
 
+    TEST_METHOD_EX(CanvasGeometry_CreateInkBatch_StreamsEachStrokeSetToItsOwnGeometry)
+    {
+        Fixture f;
+
+        auto canvasGeometryFactory = Make<CanvasGeometryFactory>();
+
+        std::vector<ComPtr<IIterable<InkStroke*>>> strokeSets{ Make<MockStrokeCollection>(), Make<MockStrokeCollection>() };
+        auto inkStrokeSets = Make<StubStrokeSetCollection>(strokeSets);
+
+        auto inkAdapter = std::make_shared<StubInkAdapter>();
+        InkAdapter::SetInstance(inkAdapter);
+
+        // Both stroke sets should be drawn into a single temporary command list.
+        auto d2dCommandList = Make<MockD2DCommandList>();
+        f.Device->CreateCommandListMethod.SetExpectedCalls(1, [&] { return d2dCommandList; });
+
+        auto d2dDeviceContext = Make<StubD2DDeviceContextWithGetFactory>();
+        f.Device->CreateDeviceContextForDrawingSessionMethod.SetExpectedCalls(1, [&] { return d2dDeviceContext; });
+
+        d2dDeviceContext->BeginDrawMethod.SetExpectedCalls(1);
+        d2dDeviceContext->EndDrawMethod.SetExpectedCalls(1);
+        d2dDeviceContext->SetTextAntialiasModeMethod.SetExpectedCalls(1);
+        d2dDeviceContext->SetTargetMethod.SetExpectedCalls(1);
+
+        d2dDeviceContext->m_factory->MockCreateDrawingStateBlock = [](auto, auto, ID2D1DrawingStateBlock1** result)
+        {
+            *result = nullptr;
+            return S_OK;
+        };
+
+        d2dDeviceContext->SaveDrawingStateMethod.SetExpectedCalls(2);
+        d2dDeviceContext->RestoreDrawingStateMethod.SetExpectedCalls(2);
+
+        // Each stroke set is tagged with its position in the batch.
+        std::vector<D2D1_TAG> tags;
+
+        d2dDeviceContext->SetTagsMethod.SetExpectedCalls(3, [&](D2D1_TAG tag1, D2D1_TAG tag2)
+        {
+            Assert::AreEqual<D2D1_TAG>(0, tag2);
+            tags.push_back(tag1);
+        });
+
+        int drawCount = 0;
+
+        inkAdapter->GetInkRenderer()->DrawMethod.SetExpectedCalls(2, [&](IUnknown*, IUnknown* strokeCollection, BOOL)
+        {
+            Assert::IsTrue(IsSameInstance(strokeSets[drawCount].Get(), strokeCollection));
+            Assert::AreEqual<D2D1_TAG>(drawCount + 1, tags.back());
+
+            drawCount++;
+            return S_OK;
+        });
+
+        // One path geometry is created per stroke set.
+        std::vector<ComPtr<MockD2DPathGeometry>> pathGeometries;
+        std::vector<ComPtr<MockD2DGeometrySink>> geometrySinks;
+
+        f.Adapter->CreatePathGeometryMethod.SetExpectedCalls(2, [&]
+        {
+            auto pathGeometry = Make<MockD2DPathGeometry>();
+            auto geometrySink = Make<MockD2DGeometrySink>();
+
+            pathGeometry->OpenMethod.SetExpectedCalls(1, [=](ID2D1GeometrySink** out) { return geometrySink.CopyTo(out); });
+            geometrySink->CloseMethod.SetExpectedCalls(1);
+
+            pathGeometries.push_back(pathGeometry);
+            geometrySinks.push_back(geometrySink);
+
+            return pathGeometry;
+        });
+
+        // Streaming the command list should route each piece of ink by its tag.
+        auto inkA = Make<MockD2DInk>();
+        auto inkB = Make<MockD2DInk>();
+        auto untaggedInk = Make<MockD2DInk>();
+
+        d2dCommandList->CloseMethod.SetExpectedCalls(1);
+
+        d2dCommandList->StreamMethod.SetExpectedCalls(1, [&](ID2D1CommandSink* sink)
+        {
+            auto sink2 = As<ID2D1CommandSink2>(sink);
+
+            ThrowIfFailed(sink2->SetTags(2, 0));
+            ThrowIfFailed(sink2->DrawInk(inkB.Get(), nullptr, nullptr));
+            ThrowIfFailed(sink2->SetTags(1, 0));
+            ThrowIfFailed(sink2->DrawInk(inkA.Get(), nullptr, nullptr));
+            ThrowIfFailed(sink2->SetTags(0, 0));
+            ThrowIfFailed(sink2->DrawInk(untaggedInk.Get(), nullptr, nullptr));
+
+            return S_OK;
+        });
+
+        inkA->StreamAsGeometryMethod.SetExpectedCalls(1, [&](ID2D1InkStyle*, D2D1_MATRIX_3X2_F const*, FLOAT, ID2D1SimplifiedGeometrySink* geometrySink)
+        {
+            Assert::IsTrue(IsSameInstance(geometrySinks[0].Get(), geometrySink));
+            return S_OK;
+        });
+
+        inkB->StreamAsGeometryMethod.SetExpectedCalls(1, [&](ID2D1InkStyle*, D2D1_MATRIX_3X2_F const*, FLOAT, ID2D1SimplifiedGeometrySink* geometrySink)
+        {
+            Assert::IsTrue(IsSameInstance(geometrySinks[1].Get(), geometrySink));
+            return S_OK;
+        });
+
+        ComArray<ComPtr<ICanvasGeometry>> geometries;
+        ThrowIfFailed(canvasGeometryFactory->CreateInkBatch(f.Device.Get(), inkStrokeSets.Get(), geometries.GetAddressOfSize(), geometries.GetAddressOfData()));
+
+        Assert::AreEqual(2u, geometries.GetSize());
+
+        for (uint32_t i = 0; i < geometries.GetSize(); i++)
+        {
+            Assert::IsTrue(IsSameInstance(pathGeometries[i].Get(), GetWrappedResource<ID2D1Geometry>(geometries[i]).Get()));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_CreateInkBatch_NullArg)
+    {
+        Fixture f;
+
+        auto canvasGeometryFactory = Make<CanvasGeometryFactory>();
+        auto inkStrokeSets = Make<StubStrokeSetCollection>(std::vector<ComPtr<IIterable<InkStroke*>>>());
+
+        ComArray<ComPtr<ICanvasGeometry>> geometries;
+
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateInkBatch(nullptr, inkStrokeSets.Get(), geometries.GetAddressOfSize(), geometries.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateInkBatch(f.Device.Get(), nullptr, geometries.GetAddressOfSize(), geometries.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateInkBatch(f.Device.Get(), inkStrokeSets.Get(), nullptr, geometries.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, canvasGeometryFactory->CreateInkBatch(f.Device.Get(), inkStrokeSets.Get(), geometries.GetAddressOfSize(), nullptr));
+    }
+
 #endif
 
     TEST_METHOD_EX(CanvasGeometry_GetGeometry)
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include <lib/text/CanvasGlyphAtlas.h>
+
+TEST_CLASS(CanvasGlyphAtlasTests)
+{
+    static ComPtr<ICanvasGlyphAtlas> CreateGlyphAtlas()
+    {
+        ComPtr<ICanvasGlyphAtlas> glyphAtlas;
+        ThrowIfFailed(Make<CanvasGlyphAtlasFactory>()->Create(Make<StubCanvasDevice>().Get(), &glyphAtlas));
+        return glyphAtlas;
+    }
+
+    TEST_METHOD_EX(CanvasGlyphAtlas_Create_InvalidArgs)
+    {
+        auto factory = Make<CanvasGlyphAtlasFactory>();
+        ComPtr<ICanvasGlyphAtlas> glyphAtlas;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, &glyphAtlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(Make<StubCanvasDevice>().Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasGlyphAtlas_Properties)
+    {
+        auto glyphAtlas = CreateGlyphAtlas();
+
+        int32_t value;
+        ThrowIfFailed(glyphAtlas->get_MaximumGlyphSizeInPixels(&value));
+        Assert::AreEqual(CanvasGlyphAtlas::DefaultMaximumGlyphSizeInPixels, value);
+
+        ThrowIfFailed(glyphAtlas->get_MaximumPageCount(&value));
+        Assert::AreEqual(CanvasGlyphAtlas::DefaultMaximumPageCount, value);
+
+        ThrowIfFailed(glyphAtlas->get_PageCount(&value));
+        Assert::AreEqual(0, value);
+
+        ThrowIfFailed(glyphAtlas->put_MaximumGlyphSizeInPixels(0));
+        ThrowIfFailed(glyphAtlas->get_MaximumGlyphSizeInPixels(&value));
+        Assert::AreEqual(0, value);
+
+        ThrowIfFailed(glyphAtlas->put_MaximumPageCount(1));
+        ThrowIfFailed(glyphAtlas->get_MaximumPageCount(&value));
+        Assert::AreEqual(1, value);
+
+        Assert::AreEqual(E_INVALIDARG, glyphAtlas->put_MaximumGlyphSizeInPixels(-1));
+        Assert::AreEqual(E_INVALIDARG, glyphAtlas->put_MaximumPageCount(0));
+        Assert::AreEqual(E_INVALIDARG, glyphAtlas->get_MaximumGlyphSizeInPixels(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphAtlas->get_MaximumPageCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphAtlas->get_PageCount(nullptr));
+
+        ThrowIfFailed(glyphAtlas->Clear());
+    }
+
+    TEST_METHOD_EX(CanvasGlyphAtlas_GetGlyphPlacement)
+    {
+        auto placement = GetGlyphPlacement(10, 20);
+        Assert::IsTrue(placement.X == 10 && placement.Y == 20 && placement.SubpixelBin == 0);
+
+        placement = GetGlyphPlacement(10.5f, 20.4f);
+        Assert::IsTrue(placement.X == 10 && placement.Y == 20 && placement.SubpixelBin == 2);
+
+        placement = GetGlyphPlacement(10.3f, 20.6f);
+        Assert::IsTrue(placement.X == 10 && placement.Y == 21 && placement.SubpixelBin == 1);
+
+        // Close enough to the next pixel to round onto it.
+        placement = GetGlyphPlacement(10.9f, 0);
+        Assert::IsTrue(placement.X == 11 && placement.SubpixelBin == 0);
+
+        placement = GetGlyphPlacement(-0.75f, 0);
+        Assert::IsTrue(placement.X == -1 && placement.SubpixelBin == 1);
+    }
+
+    TEST_METHOD_EX(CanvasGlyphAtlas_Packer_FillsRowsThenStartsNewOnes)
+    {
+        GlyphAtlasPacker packer(100);
+        D2D1_POINT_2U position;
+
+        Assert::IsTrue(packer.TryAllocate(60, 10, &position));
+        Assert::IsTrue(position.x == 0 && position.y == 0);
+
+        Assert::IsTrue(packer.TryAllocate(40, 20, &position));
+        Assert::IsTrue(position.x == 60 && position.y == 0);
+
+        // No room left in the first row, so the next row starts below its tallest entry.
+        Assert::IsTrue(packer.TryAllocate(10, 10, &position));
+        Assert::IsTrue(position.x == 0 && position.y == 20);
+
+        Assert::IsTrue(packer.TryAllocate(100, 70, &position));
+        Assert::IsTrue(position.x == 0 && position.y == 30);
+
+        Assert::IsFalse(packer.TryAllocate(1, 1, &position));
+    }
+
+    TEST_METHOD_EX(CanvasGlyphAtlas_Packer_RejectsEntriesLargerThanThePage)
+    {
+        GlyphAtlasPacker packer(100);
+        D2D1_POINT_2U position;
+
+        Assert::IsFalse(packer.TryAllocate(101, 1, &position));
+        Assert::IsFalse(packer.TryAllocate(1, 101, &position));
+        Assert::IsTrue(packer.TryAllocate(100, 100, &position));
+    }
+
+    TEST_METHOD_EX(CanvasGlyphAtlas_DrawWithGlyphAtlas_InvalidArgs)
+    {
+        auto glyphAtlas = CreateGlyphAtlas();
+        auto drawingSession = CanvasDrawingSession::CreateNew(Make<StubD2DDeviceContext>().Get(), std::make_shared<StubCanvasDrawingSessionAdapter>());
+
+        WinString text(L"text");
+
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawTextWithGlyphAtlas(text, Vector2{}, Color{}, nullptr, nullptr));
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawTextLayoutWithGlyphAtlas(nullptr, Vector2{}, Color{}, glyphAtlas.Get()));
+    }
+};
+
+#endif
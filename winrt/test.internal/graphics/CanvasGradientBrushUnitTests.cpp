@@ -522,6 +522,7 @@ TEST_CLASS(CanvasGradientBrushTests)
         ComPtr<typename T::ibrush_t> Brush;
 
         ComPtr<typename T::d2dBrush_t> ExpectedD2DBrush;
+        ComPtr<MockD2DGradientStopCollection> ExpectedCollection;
 
         FactoryFixture()
             : D2DDeviceContext(Make<MockD2DDeviceContext>())
@@ -576,6 +577,7 @@ TEST_CLASS(CanvasGradientBrushTests)
                     return collection.CopyTo(result);
                 });
 
+            ExpectedCollection = collection;
             ExpectedD2DBrush = T::ExpectCreateBrush(D2DDeviceContext, collection);
         }
 
@@ -798,6 +800,38 @@ TEST_CLASS(CanvasGradientBrushTests)
     }
 
 
+    template<typename T>
+    static void TestIdenticalStops_ShareStopCollection()
+    {
+        FactoryFixtureWithStops<T, CanvasGradientStop> f;
+
+        ThrowIfFailed(f.Factory->CreateWithStops(f.Device.Get(), _countof(f.Stops), f.Stops, &f.Brush));
+        f.Validate();
+
+        // A second brush with the same stops and options reuses the stop collection.
+        f.D2DDeviceContext->CreateGradientStopCollectionMethod.SetExpectedCalls(0);
+        f.ExpectedD2DBrush = T::ExpectCreateBrush(f.D2DDeviceContext, f.ExpectedCollection);
+
+        ThrowIfFailed(f.Factory->CreateWithStops(f.Device.Get(), _countof(f.Stops), f.Stops, &f.Brush));
+        f.Validate();
+
+        // Changing any of the options means a new stop collection.
+        f.ExpectCreateBrush(
+            {
+                D2D1_GRADIENT_STOP{ f.Stops[0].Position, ToD2DColor(f.Stops[0].Color) },
+                D2D1_GRADIENT_STOP{ f.Stops[1].Position, ToD2DColor(f.Stops[1].Color) },
+                D2D1_GRADIENT_STOP{ f.Stops[2].Position, ToD2DColor(f.Stops[2].Color) }
+            },
+            D2D1_COLOR_SPACE_SRGB,
+            D2D1_COLOR_SPACE_SRGB,
+            D2D1_BUFFER_PRECISION_8BPC_UNORM,
+            D2D1_EXTEND_MODE_WRAP,
+            D2D1_COLOR_INTERPOLATION_MODE_PREMULTIPLIED);
+
+        ThrowIfFailed(f.Factory->CreateWithEdgeBehaviorAndAlphaMode(f.Device.Get(), _countof(f.Stops), f.Stops, CanvasEdgeBehavior::Wrap, CanvasAlphaMode::Premultiplied, &f.Brush));
+        f.Validate();
+    }
+
     template<typename T, typename STOP, typename FN>
     static void TestGetStops(FN fn)
     {
@@ -887,4 +921,6 @@ TEST_CLASS(CanvasGradientBrushTests)
 
     TEST_BRUSHES(GetStops);
     TEST_BRUSHES(GetStopsHdr);
+
+    TEST_BRUSHES(IdenticalStops_ShareStopCollection);
 };
@@ -356,6 +356,36 @@ public:
         VerifyBackedByImageBrush(f.m_canvasBrushInternal);
     }
 
+    TEST_METHOD_EX(CanvasImageBrush_Switching_ReusesExistingD2DBrushes)
+    {
+        SwitchableTestBrushFixture f;
+
+        int bitmapBrushCount = 0;
+        int imageBrushCount = 0;
+
+        auto createBitmapBrush = f.m_canvasDevice->MockCreateBitmapBrush;
+        auto createImageBrush = f.m_canvasDevice->MockCreateImageBrush;
+
+        f.m_canvasDevice->MockCreateBitmapBrush = [&](ID2D1Bitmap1* bitmap) { bitmapBrushCount++; return createBitmapBrush(bitmap); };
+        f.m_canvasDevice->MockCreateImageBrush = [&](ID2D1Image* image) { imageBrushCount++; return createImageBrush(image); };
+
+        auto bitmap = CreateStubCanvasBitmap();
+        auto image = Make<TestEffect>(CLSID_D2D1GaussianBlur, 0, 0, true);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            f.m_canvasImageBrush->put_Image(image.Get());
+            VerifyBackedByImageBrush(f.m_canvasBrushInternal);
+
+            f.m_canvasImageBrush->put_Image(bitmap.Get());
+            VerifyBackedByBitmapBrush(f.m_canvasBrushInternal);
+        }
+
+        // The bitmap brush was created up front; switching retargets the existing brushes.
+        Assert::AreEqual(0, bitmapBrushCount);
+        Assert::AreEqual(1, imageBrushCount);
+    }
+
     TEST_METHOD_EX(CanvasImageBrush_Switching_TriggeredBySourceRect)
     {
         auto anyRectangle = Make<Nullable<Rect>>(Rect{0,0,10,10});
@@ -463,6 +493,58 @@ public:
 
     }
 
+    // An image whose D2D image can be swapped out from under the brush.
+    class SwappableImage : public RuntimeClass<
+        ICanvasImage,
+        IGraphicsEffectSource,
+        ABI::Windows::Foundation::IClosable,
+        CloakedIid<ICanvasImageInternal>>
+    {
+    public:
+        ComPtr<ID2D1Image> D2DImage;
+        int GetD2DImageCallCount = 0;
+
+        IFACEMETHODIMP Close() override { return S_OK; }
+        IFACEMETHODIMP GetBounds(ICanvasResourceCreator*, Rect*) override { return E_NOTIMPL; }
+        IFACEMETHODIMP GetBoundsWithTransform(ICanvasResourceCreator*, Numerics::Matrix3x2, Rect*) override { return E_NOTIMPL; }
+
+        virtual ComPtr<ID2D1Image> GetD2DImage(ICanvasDevice*, ID2D1DeviceContext*, GetImageFlags, float, float*) override
+        {
+            ++GetD2DImageCallCount;
+            return D2DImage;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasImageBrush_WhenSourceImageChangesItsD2DImage_PicksUpTheNewOne)
+    {
+        SwitchableTestBrushFixture f;
+
+        f.m_d2dDeviceContext->GetDpiMethod.AllowAnyCall();
+        f.m_d2dDeviceContext->GetTargetMethod.AllowAnyCallAlwaysCopyValueToParam<ID2D1Image>(nullptr);
+
+        auto image = Make<SwappableImage>();
+        image->D2DImage = Make<StubD2DBitmap>();
+
+        ThrowIfFailed(f.m_canvasImageBrush->put_SourceRectangle(Make<Nullable<Rect>>(Rect{ 0, 0, 10, 10 }).Get()));
+        ThrowIfFailed(f.m_canvasImageBrush->put_Image(image.Get()));
+
+        f.m_canvasBrushInternal->GetD2DBrush(f.m_d2dDeviceContext.Get(), GetBrushFlags::None);
+        Assert::IsTrue(IsSameInstance(image->D2DImage.Get(), f.m_targetImage.Get()));
+
+        // Drawing again with nothing changed uses the fast path.
+        image->GetD2DImageCallCount = 0;
+        f.m_canvasBrushInternal->GetD2DBrush(f.m_d2dDeviceContext.Get(), GetBrushFlags::None);
+        Assert::AreEqual(0, image->GetD2DImageCallCount);
+
+        // Once the image says it has changed, the next draw asks it again.
+        image->D2DImage = Make<StubD2DBitmap>();
+        InvalidateRealizedImageGraphs();
+
+        f.m_canvasBrushInternal->GetD2DBrush(f.m_d2dDeviceContext.Get(), GetBrushFlags::None);
+        Assert::AreEqual(1, image->GetD2DImageCallCount);
+        Assert::IsTrue(IsSameInstance(image->D2DImage.Get(), f.m_targetImage.Get()));
+    }
+
     TEST_METHOD_EX(CanvasImageBrush_BackedByEffect_SourceRectangle)
     {
         // Create an image brush backed by an effect.
@@ -0,0 +1,256 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/drawing/CanvasImageTileCache.h>
+#include <lib/images/CanvasCommandList.h>
+
+TEST_CLASS(CanvasImageTileCacheTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<CanvasImageTileCache> TileCache;
+        ComPtr<ICanvasImage> Image;
+
+        std::vector<D2D1_POINT_2F> RenderedTileOffsets;
+
+        Fixture(int tileSizeInPixels = 100)
+            : Device(Make<StubCanvasDevice>())
+        {
+            Device->CreateCommandListMethod.AllowAnyCall(
+                []
+                {
+                    auto commandList = Make<MockD2DCommandList>();
+                    commandList->CloseMethod.AllowAnyCall();
+                    return commandList;
+                });
+
+            Device->CreateRenderTargetBitmapMethod.AllowAnyCall(
+                [] (float, float, float, DirectXPixelFormat, CanvasAlphaMode)
+                {
+                    return Make<StubD2DBitmap>(D2D1_BITMAP_OPTIONS_TARGET);
+                });
+
+            Device->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+                [=]
+                {
+                    auto deviceContext = Make<StubD2DDeviceContext>();
+                    auto context = deviceContext.Get();
+
+                    deviceContext->DrawImageMethod.AllowAnyCall(
+                        [=] (ID2D1Image*, D2D1_POINT_2F const* offset, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+                        {
+                            // Drawing into a tile bitmap renders it; drawing into a command list replays tiles.
+                            ComPtr<ID2D1Image> target;
+                            context->GetTarget(&target);
+
+                            if (MaybeAs<ID2D1Bitmap>(target))
+                                RenderedTileOffsets.push_back(*offset);
+                        });
+
+                    return deviceContext;
+                });
+
+            Image = MakeImage();
+
+            ComPtr<ICanvasImageTileCache> tileCache;
+            ThrowIfFailed(Make<CanvasImageTileCacheFactory>()->CreateWithTileSize(Device.Get(), tileSizeInPixels, &tileCache));
+            TileCache = static_cast<CanvasImageTileCache*>(tileCache.Get());
+        }
+
+        ComPtr<ICanvasImage> MakeImage()
+        {
+            auto d2dCommandList = Make<MockD2DCommandList>();
+            d2dCommandList->CloseMethod.AllowAnyCall();
+
+            return As<ICanvasImage>(Make<CanvasCommandList>(Device.Get(), d2dCommandList.Get()));
+        }
+
+        ComPtr<ICanvasImage> Update(Rect const& visibleRect, float dpi = DEFAULT_DPI)
+        {
+            RenderedTileOffsets.clear();
+
+            return TileCache->Update(Image.Get(), visibleRect, dpi);
+        }
+    };
+
+    TEST_METHOD_EX(CanvasImageTileCache_Create_InvalidArgs)
+    {
+        auto factory = Make<CanvasImageTileCacheFactory>();
+        auto device = Make<StubCanvasDevice>();
+        ComPtr<ICanvasImageTileCache> tileCache;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, &tileCache));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(device.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithTileSize(device.Get(), 0, &tileCache));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithTileSize(device.Get(), -1, &tileCache));
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Properties)
+    {
+        ComPtr<ICanvasImageTileCache> tileCache;
+        ThrowIfFailed(Make<CanvasImageTileCacheFactory>()->Create(Make<StubCanvasDevice>().Get(), &tileCache));
+
+        int32_t value;
+        ThrowIfFailed(tileCache->get_TileSizeInPixels(&value));
+        Assert::AreEqual(CanvasImageTileCache::DefaultTileSizeInPixels, value);
+
+        ThrowIfFailed(tileCache->get_MaximumTileCount(&value));
+        Assert::AreEqual(CanvasImageTileCache::DefaultMaximumTileCount, value);
+
+        ThrowIfFailed(tileCache->put_MaximumTileCount(7));
+        ThrowIfFailed(tileCache->get_MaximumTileCount(&value));
+        Assert::AreEqual(7, value);
+
+        Assert::AreEqual(E_INVALIDARG, tileCache->put_MaximumTileCount(-1));
+        Assert::AreEqual(E_INVALIDARG, tileCache->get_TileSizeInPixels(nullptr));
+        Assert::AreEqual(E_INVALIDARG, tileCache->get_MaximumTileCount(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_GetTilesOverlappingRect)
+    {
+        auto range = GetTilesOverlappingRect(Rect{ 0, 0, 100, 100 }, 100, DEFAULT_DPI);
+        Assert::IsTrue(range.Left == 0 && range.Top == 0 && range.Right == 1 && range.Bottom == 1);
+
+        range = GetTilesOverlappingRect(Rect{ -1, 50, 200, 100 }, 100, DEFAULT_DPI);
+        Assert::IsTrue(range.Left == -1 && range.Top == 0 && range.Right == 2 && range.Bottom == 2);
+
+        // Tiles are sized in pixels, so cover fewer DIPs at higher DPI.
+        range = GetTilesOverlappingRect(Rect{ 0, 0, 100, 100 }, 100, DEFAULT_DPI * 2);
+        Assert::IsTrue(range.Left == 0 && range.Top == 0 && range.Right == 2 && range.Bottom == 2);
+
+        Assert::IsTrue(GetTilesOverlappingRect(Rect{ 10, 10, 0, 10 }, 100, DEFAULT_DPI).IsEmpty());
+        Assert::IsTrue(GetTilesOverlappingRect(Rect{ 10, 10, 10, -1 }, 100, DEFAULT_DPI).IsEmpty());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Update_WithEmptyVisibleRect_ReturnsNull)
+    {
+        Fixture f;
+
+        Assert::IsNull(f.Update(Rect{ 0, 0, 0, 0 }).Get());
+        Assert::AreEqual(0, f.TileCache->GetTileCount());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Update_RendersEachVisibleTileAtItsOffset)
+    {
+        Fixture f;
+
+        Assert::IsNotNull(f.Update(Rect{ 0, 0, 200, 100 }).Get());
+
+        Assert::AreEqual<size_t>(2, f.RenderedTileOffsets.size());
+        Assert::AreEqual(D2D1_POINT_2F{ 0, 0 }, f.RenderedTileOffsets[0]);
+        Assert::AreEqual(D2D1_POINT_2F{ -100, 0 }, f.RenderedTileOffsets[1]);
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Update_WhenScrolled_OnlyRendersNewlyVisibleTiles)
+    {
+        Fixture f;
+
+        auto first = f.Update(Rect{ 0, 0, 200, 100 });
+        Assert::AreEqual<size_t>(2, f.RenderedTileOffsets.size());
+
+        // Same tiles again: nothing rendered, and the same image is reused.
+        auto second = f.Update(Rect{ 10, 10, 180, 80 });
+        Assert::AreEqual<size_t>(0, f.RenderedTileOffsets.size());
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+
+        // Scrolling right by one tile only renders the column coming into view.
+        auto third = f.Update(Rect{ 100, 0, 200, 100 });
+        Assert::AreEqual<size_t>(1, f.RenderedTileOffsets.size());
+        Assert::AreEqual(D2D1_POINT_2F{ -200, 0 }, f.RenderedTileOffsets[0]);
+        Assert::IsFalse(IsSameInstance(first.Get(), third.Get()));
+
+        // Scrolling back renders nothing.
+        f.Update(Rect{ 0, 0, 200, 100 });
+        Assert::AreEqual<size_t>(0, f.RenderedTileOffsets.size());
+        Assert::AreEqual(3, f.TileCache->GetTileCount());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Update_WhenImageOrDpiChanges_RendersEverythingAgain)
+    {
+        Fixture f;
+
+        f.Update(Rect{ 0, 0, 100, 100 });
+
+        f.Image = f.MakeImage();
+        f.Update(Rect{ 0, 0, 100, 100 });
+        Assert::AreEqual<size_t>(1, f.RenderedTileOffsets.size());
+
+        f.Update(Rect{ 0, 0, 100, 100 }, DEFAULT_DPI * 2);
+        Assert::AreEqual<size_t>(4, f.RenderedTileOffsets.size());
+        Assert::AreEqual(4, f.TileCache->GetTileCount());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Invalidate_RendersEverythingAgain)
+    {
+        Fixture f;
+
+        f.Update(Rect{ 0, 0, 200, 200 });
+
+        ThrowIfFailed(f.TileCache->Invalidate());
+        Assert::AreEqual(0, f.TileCache->GetTileCount());
+
+        f.Update(Rect{ 0, 0, 200, 200 });
+        Assert::AreEqual<size_t>(4, f.RenderedTileOffsets.size());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_InvalidateRegion_OnlyRendersOverlappingTilesAgain)
+    {
+        Fixture f;
+
+        f.Update(Rect{ 0, 0, 200, 200 });
+
+        ThrowIfFailed(f.TileCache->InvalidateRegion(Rect{ 150, 150, 10, 10 }));
+        Assert::AreEqual(3, f.TileCache->GetTileCount());
+
+        f.Update(Rect{ 0, 0, 200, 200 });
+        Assert::AreEqual<size_t>(1, f.RenderedTileOffsets.size());
+        Assert::AreEqual(D2D1_POINT_2F{ -100, -100 }, f.RenderedTileOffsets[0]);
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Update_EvictsLeastRecentlyUsedTiles)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.TileCache->put_MaximumTileCount(2));
+
+        f.Update(Rect{ 0, 0, 100, 100 });
+        f.Update(Rect{ 100, 0, 100, 100 });
+        f.Update(Rect{ 200, 0, 100, 100 });
+
+        Assert::AreEqual(2, f.TileCache->GetTileCount());
+
+        // The first tile was thrown away, the second was kept.
+        f.Update(Rect{ 100, 0, 100, 100 });
+        Assert::AreEqual<size_t>(0, f.RenderedTileOffsets.size());
+
+        f.Update(Rect{ 0, 0, 100, 100 });
+        Assert::AreEqual<size_t>(1, f.RenderedTileOffsets.size());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_Update_NeverEvictsVisibleTiles)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.TileCache->put_MaximumTileCount(1));
+
+        f.Update(Rect{ 0, 0, 300, 100 });
+        Assert::AreEqual(3, f.TileCache->GetTileCount());
+
+        f.Update(Rect{ 0, 0, 300, 100 });
+        Assert::AreEqual<size_t>(0, f.RenderedTileOffsets.size());
+    }
+
+    TEST_METHOD_EX(CanvasImageTileCache_DrawCachedImage_InvalidArgs)
+    {
+        Fixture f;
+
+        auto drawingSession = CanvasDrawingSession::CreateNew(Make<StubD2DDeviceContext>().Get(), std::make_shared<StubCanvasDrawingSessionAdapter>());
+
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawCachedImage(nullptr, Vector2{}, f.TileCache.Get()));
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawCachedImage(f.Image.Get(), Vector2{}, nullptr));
+    }
+};
@@ -16,6 +16,8 @@
 
 #include "GetBoundsFixture.h"
 
+#include <lib/images/ImageStatistics.h>
+
 TEST_CLASS(CanvasImageGetBoundsUnitTests)
 {
     //
@@ -92,7 +94,7 @@ public:
         return CreateStreamOverRandomAccessStreamMethod.WasCalled(stream);
     }
 
-    CALL_COUNTER_WITH_MOCK(SaveImageMethod, void(ID2D1Image*, WICImageParameters const&, ID2D1Device*, IStream*, GUID const&, float));
+    CALL_COUNTER_WITH_MOCK(SaveImageMethod, void(ID2D1Image*, WICImageParameters const&, ID2D1Device*, IStream*, GUID const&, float, WicEncoderOptions const&));
     
     virtual void SaveImage(
         ID2D1Image* d2dImage,
@@ -100,9 +102,24 @@ public:
         ID2D1Device* device,
         IStream* stream,
         GUID const& containerFormat,
+        float quality,
+        WicEncoderOptions const& options) override
+    {
+        return SaveImageMethod.WasCalled(d2dImage, wicImageParameters, device, stream, containerFormat, quality, options);
+    }
+
+    CALL_COUNTER_WITH_MOCK(SaveImageInStripsMethod, void(ICanvasDevice*, ID2D1Image*, WICImageParameters const&, uint32_t, IStream*, GUID const&, float));
+
+    virtual void SaveImageInStrips(
+        ICanvasDevice* device,
+        ID2D1Image* d2dImage,
+        WICImageParameters const& wicImageParameters,
+        uint32_t stripHeight,
+        IStream* stream,
+        GUID const& containerFormat,
         float quality) override
     {
-        return SaveImageMethod.WasCalled(d2dImage, wicImageParameters, device, stream, containerFormat, quality);
+        return SaveImageInStripsMethod.WasCalled(device, d2dImage, wicImageParameters, stripHeight, stream, containerFormat, quality);
     }
 };
 
@@ -253,7 +270,7 @@ TEST_CLASS(CanvasImageSaveUnitTests)
         ImageFixture f;
 
         f.Adapter->SaveImageMethod.SetExpectedCalls(1,
-            [&] (ID2D1Image* image, WICImageParameters const& params, ID2D1Device* device, IStream* s, GUID const& formatGuid, float quality)
+            [&] (ID2D1Image* image, WICImageParameters const& params, ID2D1Device* device, IStream* s, GUID const& formatGuid, float quality, WicEncoderOptions const&)
             {
                 Assert::IsTrue(IsSameInstance(f.D2DImage.Get(), image), L"Image");
                 Assert::IsTrue(IsSameInstance(f.D2DDevice.Get(), device), L"Device");
@@ -291,7 +308,7 @@ TEST_CLASS(CanvasImageSaveUnitTests)
         float dpi = DEFAULT_DPI * 1.5f;
 
         f.Adapter->SaveImageMethod.SetExpectedCalls(1,
-            [&] (ID2D1Image*, WICImageParameters const& params, ID2D1Device*, IStream*, GUID const&, float)
+            [&] (ID2D1Image*, WICImageParameters const& params, ID2D1Device*, IStream*, GUID const&, float, WicEncoderOptions const&)
             {
                 Assert::AreEqual(dpi, params.DpiX);
                 Assert::AreEqual(dpi, params.DpiY);
@@ -333,7 +350,7 @@ TEST_CLASS(CanvasImageSaveUnitTests)
             ImageFixture f;
 
             f.Adapter->SaveImageMethod.SetExpectedCalls(1,
-                [&] (ID2D1Image*, WICImageParameters const& params, ID2D1Device*, IStream*, GUID const&, float)
+                [&] (ID2D1Image*, WICImageParameters const& params, ID2D1Device*, IStream*, GUID const&, float, WicEncoderOptions const&)
                 {
                     Assert::AreEqual(params.PixelFormat.format, format);
                     Assert::AreEqual(params.PixelFormat.alphaMode, D2D1_ALPHA_MODE_PREMULTIPLIED);
@@ -377,7 +394,7 @@ TEST_CLASS(CanvasImageSaveUnitTests)
             ImageFixture f;
             
             f.Adapter->SaveImageMethod.SetExpectedCalls(1,
-                [&] (ID2D1Image*, WICImageParameters const&, ID2D1Device*, IStream*, GUID const& g, float)
+                [&] (ID2D1Image*, WICImageParameters const&, ID2D1Device*, IStream*, GUID const& g, float, WicEncoderOptions const&)
                 {
                     Assert::AreEqual(guid, g);
                 });
@@ -397,6 +414,99 @@ TEST_CLASS(CanvasImageSaveUnitTests)
         }
     }
 
+    TEST_METHOD_EX(CanvasImage_SaveInStripsAsync_FailsWhenPassedInvalidParameters)
+    {
+        InvalidParamsFixture f;
+
+        ComPtr<IAsyncAction> action;
+
+        Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(nullptr,    f.AnyRect, f.AnyDpi, f.AnyResourceCreator, f.AnyRandomAccessStream, f.AnyFormat, f.AnyQuality, f.AnyPrecision, 1, &action));
+        Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(f.AnyImage, f.AnyRect, f.AnyDpi, nullptr,              f.AnyRandomAccessStream, f.AnyFormat, f.AnyQuality, f.AnyPrecision, 1, &action));
+        Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(f.AnyImage, f.AnyRect, f.AnyDpi, f.AnyResourceCreator, nullptr,                 f.AnyFormat, f.AnyQuality, f.AnyPrecision, 1, &action));
+        Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(f.AnyImage, f.AnyRect, f.AnyDpi, f.AnyResourceCreator, f.AnyRandomAccessStream, f.AnyFormat, f.AnyQuality, f.AnyPrecision, 1, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(f.AnyImage, f.AnyRect, f.AnyDpi, f.AnyResourceCreator, f.AnyRandomAccessStream, CanvasBitmapFileFormat::Auto, f.AnyQuality, f.AnyPrecision, 1, &action));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::AutoFileFormatNotAllowed);
+
+        Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(f.AnyImage, f.AnyRect, f.AnyDpi, f.AnyResourceCreator, f.AnyRandomAccessStream, f.AnyFormat, 1.1f, f.AnyPrecision, 1, &action));
+
+        for (auto invalidStripHeight : { 0, -1 })
+        {
+            Assert::AreEqual(E_INVALIDARG, f.CanvasImage->SaveInStripsAsync(f.AnyImage, f.AnyRect, f.AnyDpi, f.AnyResourceCreator, f.AnyRandomAccessStream, f.AnyFormat, f.AnyQuality, f.AnyPrecision, invalidStripHeight, &action));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasImage_SaveInStripsAsync_PassesThroughParameters)
+    {
+        ImageFixture f;
+
+        float dpi = DEFAULT_DPI * 1.5f;
+
+        f.Adapter->SaveImageInStripsMethod.SetExpectedCalls(1,
+            [&] (ICanvasDevice* device, ID2D1Image* image, WICImageParameters const& params, uint32_t stripHeight, IStream* s, GUID const& formatGuid, float quality)
+            {
+                Assert::IsTrue(IsSameInstance(f.Device.Get(), device), L"Device");
+                Assert::IsTrue(IsSameInstance(f.D2DImage.Get(), image), L"Image");
+                Assert::IsTrue(IsSameInstance(f.Stream.Get(), s), L"Stream");
+                Assert::AreEqual(GUID_ContainerFormatPng, formatGuid);
+                Assert::AreEqual(0.5f, quality);
+                Assert::AreEqual(64u, stripHeight);
+
+                Assert::AreEqual(DXGI_FORMAT_R16G16B16A16_FLOAT, params.PixelFormat.format);
+                Assert::AreEqual(D2D1_ALPHA_MODE_PREMULTIPLIED, params.PixelFormat.alphaMode);
+                Assert::AreEqual(dpi, params.DpiX);
+                Assert::AreEqual(dpi, params.DpiY);
+                Assert::AreEqual(1.5f, params.Left);
+                Assert::AreEqual(3.0f, params.Top);
+                Assert::AreEqual(5u, params.PixelWidth);
+                Assert::AreEqual(6u, params.PixelHeight);
+            });
+
+        ComPtr<IAsyncAction> action;
+        ThrowIfFailed(f.CanvasImage->SaveInStripsAsync(
+            f.AnyCanvasImage.Get(),
+            Rect{1, 2, 3, 4},
+            dpi,
+            f.Device.Get(),
+            f.RandomAccessStream.Get(),
+            CanvasBitmapFileFormat::Png,
+            0.5f,
+            CanvasBufferPrecision::Precision16Float,
+            64,
+            &action));
+
+        ValidateActionSucceeded(action);
+    }
+
+    TEST_METHOD_EX(CanvasImage_SaveInStripsAsync_SavesGifInOnePiece)
+    {
+        ImageFixture f;
+
+        f.Adapter->SaveImageMethod.SetExpectedCalls(1,
+            [&] (ID2D1Image* image, WICImageParameters const& params, ID2D1Device* device, IStream*, GUID const& formatGuid, float, WicEncoderOptions const&)
+            {
+                Assert::IsTrue(IsSameInstance(f.D2DImage.Get(), image), L"Image");
+                Assert::IsTrue(IsSameInstance(f.D2DDevice.Get(), device), L"Device");
+                Assert::AreEqual(GUID_ContainerFormatGif, formatGuid);
+                Assert::AreEqual(4u, params.PixelHeight);
+            });
+
+        ComPtr<IAsyncAction> action;
+        ThrowIfFailed(f.CanvasImage->SaveInStripsAsync(
+            f.AnyCanvasImage.Get(),
+            Rect{1, 2, 3, 4},
+            DEFAULT_DPI,
+            f.Device.Get(),
+            f.RandomAccessStream.Get(),
+            CanvasBitmapFileFormat::Gif,
+            DEFAULT_CANVASBITMAP_QUALITY,
+            CanvasBufferPrecision::Precision8UIntNormalized,
+            1,
+            &action));
+
+        ValidateActionSucceeded(action);
+    }
+
     void ValidateActionSucceeded(ComPtr<IAsyncAction> action)
     {
         HRESULT errorCode;
@@ -436,6 +546,8 @@ TEST_CLASS(DefaultCanvasImageAdapter_Tests)
         IStream* AnyStream;
         WICImageParameters AnyParameters;
         float AnyQuality;
+
+        ComPtr<MockPropertyBag> FrameProperties;
         
         Fixture()
             : Adapter(std::make_shared<WicTestAdapter>())
@@ -460,6 +572,7 @@ TEST_CLASS(DefaultCanvasImageAdapter_Tests)
             auto encoder = Make<MockWICBitmapEncoder>();
             auto frame = Make<MockWICBitmapFrameEncode>();
             auto frameProperties = Make<MockPropertyBag>();
+            FrameProperties = frameProperties;
             auto imageEncoder = Make<MockWICImageEncoder>();
 
             Adapter->WICFactory->CreateEncoderMethod.SetExpectedCalls(1,
@@ -571,9 +684,77 @@ TEST_CLASS(DefaultCanvasImageAdapter_Tests)
                 f.AnyD2DDevice,
                 f.AnyStream,
                 containerFormat,
-                f.AnyQuality);
+                f.AnyQuality,
+                WicEncoderOptions{});
         }
     }
+
+    TEST_METHOD_EX(CanvasImage_Adapter_SaveImage_WritesPresetThenEncoderOptions)
+    {
+        Fixture f;
+
+        f.Expect(GUID_ContainerFormatPng, false, false);
+
+        f.FrameProperties->CountPropertiesMethod.SetExpectedCalls(1,
+            [] (ULONG* count)
+            {
+                *count = 2;
+                return S_OK;
+            });
+
+        f.FrameProperties->GetPropertyInfoMethod.SetExpectedCalls(2,
+            [] (ULONG index, ULONG count, PROPBAG2* info, ULONG* infoCount)
+            {
+                wchar_t const* names[] = { L"InterlaceOption", L"FilterOption" };
+                VARTYPE types[] = { VT_BOOL, VT_UI1 };
+
+                Assert::AreEqual(1ul, count);
+
+                auto nameLength = wcslen(names[index]) + 1;
+                info->pstrName = static_cast<LPOLESTR>(CoTaskMemAlloc(nameLength * sizeof(wchar_t)));
+                wcscpy_s(info->pstrName, nameLength, names[index]);
+                info->vt = types[index];
+                *infoCount = 1;
+                return S_OK;
+            });
+
+        std::vector<std::pair<std::wstring, VARIANT>> written;
+
+        f.FrameProperties->WriteMethod.SetExpectedCalls(2,
+            [&] (ULONG count, PROPBAG2* p, VARIANT* v)
+            {
+                Assert::AreEqual(1ul, count);
+                written.emplace_back(p->pstrName, *v);
+                return S_OK;
+            });
+
+        // The app passes an int, which should be converted to the bool the encoder expects.
+        VARIANT interlace{};
+        interlace.vt = VT_I4;
+        interlace.lVal = 1;
+
+        WicEncoderOptions options{ CanvasBitmapEncoderPreset::Fast };
+        options.Values.emplace_back(WinString(L"InterlaceOption"), interlace);
+
+        CanvasImageAdapter::GetInstance()->SaveImage(
+            f.AnyD2DImage,
+            f.AnyParameters,
+            f.AnyD2DDevice,
+            f.AnyStream,
+            GUID_ContainerFormatPng,
+            f.AnyQuality,
+            options);
+
+        Assert::AreEqual<size_t>(2, written.size());
+
+        Assert::AreEqual<std::wstring>(L"FilterOption", written[0].first);
+        Assert::AreEqual<uint32_t>(VT_UI1, written[0].second.vt);
+        Assert::AreEqual<uint32_t>(WICPngFilterNone, written[0].second.bVal);
+
+        Assert::AreEqual<std::wstring>(L"InterlaceOption", written[1].first);
+        Assert::AreEqual<uint32_t>(VT_BOOL, written[1].second.vt);
+        Assert::IsTrue(written[1].second.boolVal == VARIANT_TRUE);
+    }
 };
 
 TEST_CLASS(CanvasImageHistogramUnitTests)
@@ -831,6 +1012,117 @@ TEST_CLASS(CanvasImageHistogramUnitTests)
         TestComputeHistogram(123);
     }
 
+    TEST_METHOD_EX(CanvasImage_ComputeHistograms_InvalidArgs)
+    {
+        auto factory = Make<CanvasImageFactory>();
+        auto canvasDevice = Make<StubCanvasDevice>();
+        auto bitmap = CreateStubCanvasBitmap();
+        Rect rect{ 1, 2, 3, 4 };
+        auto red = CanvasHistogramChannels::Red;
+        ComArray<float> result;
+        ComPtr<IAsyncOperation<IVectorView<float>*>> operation;
+
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(nullptr,      rect, canvasDevice.Get(), red, 64,   result.GetAddressOfSize(), result.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, nullptr,            red, 64,   result.GetAddressOfSize(), result.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, canvasDevice.Get(), red, 64,   nullptr,                   result.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, canvasDevice.Get(), red, 64,   result.GetAddressOfSize(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, canvasDevice.Get(), red, 1,    result.GetAddressOfSize(), result.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, canvasDevice.Get(), red, 1025, result.GetAddressOfSize(), result.GetAddressOfData()));
+
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, canvasDevice.Get(), CanvasHistogramChannels::None,                   64, result.GetAddressOfSize(), result.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistograms(bitmap.Get(), rect, canvasDevice.Get(), static_cast<CanvasHistogramChannels>(32),       64, result.GetAddressOfSize(), result.GetAddressOfData()));
+
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(nullptr,      rect, canvasDevice.Get(), red,                           64, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(bitmap.Get(), rect, nullptr,            red,                           64, &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(bitmap.Get(), rect, canvasDevice.Get(), red,                           64, nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(bitmap.Get(), rect, canvasDevice.Get(), red,                           1,  &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(bitmap.Get(), rect, canvasDevice.Get(), CanvasHistogramChannels::None, 64, &operation));
+    }
+
+    TEST_METHOD_EX(CanvasImage_ComputeHistograms_EvaluatesAllChannelsInOneDraw)
+    {
+        auto factory = Make<CanvasImageFactory>();
+        auto canvasDevice = Make<StubCanvasDevice>();
+        auto d2dContext = Make<MockD2DDeviceContext>();
+        auto d2dBitmap = Make<StubD2DBitmap>(D2D1_BITMAP_OPTIONS_NONE, DEFAULT_DPI);
+        auto canvasBitmap = Make<CanvasBitmap>(nullptr, d2dBitmap.Get());
+        Rect rect{ 1, 2, 3, 4 };
+        const int numBins = 16;
+        ComArray<float> result;
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> histograms;
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> atlases;
+
+        canvasDevice->GetResourceCreationDeviceContextMethod.SetExpectedCalls(1, [&]
+        {
+            return DeviceContextLease(d2dContext);
+        });
+
+        // Each channel gets its own leased histogram effect.
+        canvasDevice->LeaseHistogramEffectMethod.SetExpectedCalls(2, [&](ID2D1DeviceContext* context)
+        {
+            Assert::IsTrue(IsSameInstance(context, d2dContext.Get()));
+
+            auto histogram = Make<MockD2DEffectThatCountsCalls>(CLSID_D2D1Histogram);
+            auto atlas = Make<MockD2DEffectThatCountsCalls>(CLSID_D2D1Atlas);
+
+            auto atlasRaw = atlas.Get();
+            atlas->MockGetOutput = [=](ID2D1Image** output) { ThrowIfFailed(atlasRaw->QueryInterface(IID_PPV_ARGS(output))); };
+
+            float histogramValue = static_cast<float>(histograms.size() + 1);
+            histogram->MockGetValue = [=](UINT32 index, D2D1_PROPERTY_TYPE, BYTE* data, UINT32 dataSize)
+            {
+                Assert::AreEqual<uint32_t>(D2D1_HISTOGRAM_PROP_HISTOGRAM_OUTPUT, index);
+                Assert::AreEqual<size_t>(numBins * sizeof(float), dataSize);
+
+                std::fill_n(reinterpret_cast<float*>(data), numBins, histogramValue);
+                return S_OK;
+            };
+
+            histograms.push_back(histogram);
+            atlases.push_back(atlas);
+
+            return CanvasDevice::HistogramAndAtlasEffects{ histogram, atlas };
+        });
+
+        canvasDevice->ReleaseHistogramEffectMethod.SetExpectedCalls(2);
+
+        // ...but they are all drawn in a single batch, reading from the first atlas effect.
+        d2dContext->BeginDrawMethod.SetExpectedCalls(1);
+        d2dContext->EndDrawMethod.SetExpectedCalls(1);
+
+        int drawCount = 0;
+
+        d2dContext->DrawImageMethod.SetExpectedCalls(2, [&](ID2D1Image* image, D2D1_POINT_2F const*, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+        {
+            auto& histogram = histograms[drawCount++];
+
+            Assert::IsTrue(IsSameInstance(histogram.Get(), image));
+            Assert::IsTrue(IsSameInstance(atlases[0].Get(), histogram->m_inputs[0].Get()));
+            Assert::IsTrue(IsSameInstance(d2dBitmap.Get(), atlases[0]->m_inputs[0].Get()));
+        });
+
+        ThrowIfFailed(factory->ComputeHistograms(canvasBitmap.Get(), rect, canvasDevice.Get(), CanvasHistogramChannels::Red | CanvasHistogramChannels::Blue, numBins, result.GetAddressOfSize(), result.GetAddressOfData()));
+
+        Assert::AreEqual<int>(D2D1_CHANNEL_SELECTOR_R, *reinterpret_cast<int*>(histograms[0]->m_properties[D2D1_HISTOGRAM_PROP_CHANNEL_SELECT].data()));
+        Assert::AreEqual<int>(D2D1_CHANNEL_SELECTOR_B, *reinterpret_cast<int*>(histograms[1]->m_properties[D2D1_HISTOGRAM_PROP_CHANNEL_SELECT].data()));
+
+        // The results are concatenated in channel order.
+        Assert::AreEqual<uint32_t>(numBins * 2, result.GetSize());
+
+        for (int i = 0; i < numBins; i++)
+        {
+            Assert::AreEqual(1.0f, result[i]);
+            Assert::AreEqual(2.0f, result[numBins + i]);
+        }
+
+        // The leased effects are left with no inputs.
+        for (auto& effect : histograms)
+            Assert::IsNull(effect->m_inputs[0].Get());
+
+        Assert::IsNull(atlases[0]->m_inputs[0].Get());
+    }
+
     TEST_METHOD_EX(CanvasImage_ComputeHistogram_ReusesHistogramEffect)
     {
         auto deviceAdapter = std::make_shared<TestDeviceAdapter>();
@@ -926,17 +1218,26 @@ TEST_CLASS(CanvasImageHistogramUnitTests)
         AssertExpectedRefCount(d2dAtlas1.Get(), 2);
         AssertExpectedRefCount(d2dAtlas2.Get(), 2);
 
-        // Releasing the second effects should swap them with the ones the device is currently holding.
+        // Releasing the second effects should pool them alongside the first, rather than replacing them.
         deviceInternal->ReleaseHistogramEffect(std::move(effects2));
 
         Assert::IsNull(effects2.HistogramEffect.Get());
         Assert::IsNull(effects2.AtlasEffect.Get());
 
-        AssertExpectedRefCount(d2dHistogram1.Get(), 1);
+        AssertExpectedRefCount(d2dHistogram1.Get(), 2);
         AssertExpectedRefCount(d2dHistogram2.Get(), 2);
-        AssertExpectedRefCount(d2dAtlas1.Get(), 1);
+        AssertExpectedRefCount(d2dAtlas1.Get(), 2);
         AssertExpectedRefCount(d2dAtlas2.Get(), 2);
 
+        // Both pooled pairs can now be leased at the same time without creating new effects.
+        effects = deviceInternal->LeaseHistogramEffect(d2dContext.Get());
+        effects2 = deviceInternal->LeaseHistogramEffect(d2dContext.Get());
+
+        Assert::IsFalse(IsSameInstance(effects.HistogramEffect.Get(), effects2.HistogramEffect.Get()));
+
+        deviceInternal->ReleaseHistogramEffect(std::move(effects));
+        deviceInternal->ReleaseHistogramEffect(std::move(effects2));
+
         // Closing the device should release everything.
         canvasDevice->Close();
 
@@ -954,3 +1255,97 @@ TEST_CLASS(CanvasImageHistogramUnitTests)
         Assert::AreEqual(expected, refCount);
     }
 };
+
+TEST_CLASS(CanvasImageStatisticsUnitTests)
+{
+    TEST_METHOD_EX(CanvasImage_ComputeStatistics_InvalidArgs)
+    {
+        auto factory = Make<CanvasImageFactory>();
+        auto canvasDevice = Make<StubCanvasDevice>();
+        auto bitmap = CreateStubCanvasBitmap();
+        CanvasImageStatistics statistics;
+
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeStatistics(nullptr,      Rect{ 0, 0, 1, 1 }, canvasDevice.Get(), &statistics));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeStatistics(bitmap.Get(), Rect{ 0, 0, 1, 1 }, nullptr,            &statistics));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeStatistics(bitmap.Get(), Rect{ 0, 0, 1, 1 }, canvasDevice.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeStatistics(bitmap.Get(), Rect{ 0, 0, 0, 1 }, canvasDevice.Get(), &statistics));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeStatistics(bitmap.Get(), Rect{ 0, 0, 1, -1 }, canvasDevice.Get(), &statistics));
+    }
+
+    TEST_METHOD_EX(CanvasImage_ComputeStatistics_FailsOnFeatureLevel9)
+    {
+        auto factory = Make<CanvasImageFactory>();
+        auto d2dDevice = Make<StubD2DDevice>();
+        auto d3dDevice = Make<MockD3D11Device>();
+        auto canvasDevice = Make<StubCanvasDevice>(d2dDevice, d3dDevice);
+        auto bitmap = CreateStubCanvasBitmap();
+
+        d3dDevice->GetFeatureLevelMethod.AllowAnyCall([] { return D3D_FEATURE_LEVEL_9_3; });
+
+        // Fails before any of the reduction passes are created.
+        canvasDevice->GetResourceCreationDeviceContextMethod.SetExpectedCalls(0);
+
+        CanvasImageStatistics statistics;
+        Assert::AreEqual(E_FAIL, factory->ComputeStatistics(bitmap.Get(), Rect{ 0, 0, 4, 4 }, canvasDevice.Get(), &statistics));
+        ValidateStoredErrorState(E_FAIL, Strings::ComputeStatisticsBadFeatureLevel);
+    }
+
+    static void AssertReductionPassSizes(uint32_t width, uint32_t height, std::vector<D2D1_SIZE_U> const& expected)
+    {
+        auto sizes = GetStatisticsReductionPassSizes(width, height);
+
+        Assert::AreEqual(expected.size(), sizes.size());
+
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            Assert::AreEqual(expected[i].width, sizes[i].width);
+            Assert::AreEqual(expected[i].height, sizes[i].height);
+        }
+    }
+
+    TEST_METHOD_EX(CanvasImage_ComputeStatistics_ReductionPassSizes)
+    {
+        // Anything up to one block is reduced in a single pass.
+        AssertReductionPassSizes(1, 1, { { 1, 1 } });
+        AssertReductionPassSizes(16, 16, { { 1, 1 } });
+        AssertReductionPassSizes(16, 1, { { 1, 1 } });
+
+        // Partial blocks round up.
+        AssertReductionPassSizes(17, 1, { { 2, 1 }, { 1, 1 } });
+        AssertReductionPassSizes(256, 256, { { 16, 16 }, { 1, 1 } });
+        AssertReductionPassSizes(257, 16, { { 17, 1 }, { 2, 1 }, { 1, 1 } });
+
+        // Each dimension shrinks independently, carrying on until both are done.
+        AssertReductionPassSizes(1, 4097, { { 1, 257 }, { 1, 17 }, { 1, 2 }, { 1, 1 } });
+        AssertReductionPassSizes(1920, 1080, { { 120, 68 }, { 8, 5 }, { 1, 1 } });
+    }
+
+    TEST_METHOD_EX(CanvasImage_ComputeStatistics_StatisticsFromReductionResults)
+    {
+        // Four pixels, whose X channels are 1, 2, 3 and 4, Y channels are all 2,
+        // Z channels are all 0, and W channels are 0.5, 0.5, 0.5 and 1.
+        Vector4 minimum{ 1, 2, 0, 0.5f };
+        Vector4 maximum{ 4, 2, 0, 1 };
+        Vector4 sum{ 10, 8, 0, 2.5f };
+        Vector4 sumOfSquares{ 30, 16, 0, 1.75f };
+
+        auto statistics = GetStatisticsFromReductionResults(minimum, maximum, sum, sumOfSquares, 4);
+
+        Assert::AreEqual(minimum, statistics.Minimum);
+        Assert::AreEqual(maximum, statistics.Maximum);
+        Assert::AreEqual(Vector4{ 2.5f, 2, 0, 0.625f }, statistics.Mean);
+        Assert::AreEqual(Vector4{ 1.25f, 0, 0, 0.046875f }, statistics.Variance);
+    }
+
+    TEST_METHOD_EX(CanvasImage_ComputeStatistics_VarianceIsNeverNegative)
+    {
+        // Float rounding in the sums can leave sumOfSquares / n a fraction below the mean squared.
+        Vector4 value{ 0.1f, 0.1f, 0.1f, 0.1f };
+        Vector4 sum{ 0.3f, 0.3f, 0.3f, 0.3f };
+        Vector4 sumOfSquares{ 0.0299f, 0.0299f, 0.0299f, 0.0299f };
+
+        auto statistics = GetStatisticsFromReductionResults(value, value, sum, sumOfSquares, 3);
+
+        Assert::AreEqual(Vector4{ 0, 0, 0, 0 }, statistics.Variance);
+    }
+};
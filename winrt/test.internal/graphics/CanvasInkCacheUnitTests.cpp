@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include <lib/drawing/CanvasInkCache.h>
+
+#include "stubs/StubInkAdapter.h"
+
+TEST_CLASS(CanvasInkCacheTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        std::shared_ptr<StubInkAdapter> InkAdapter;
+        ComPtr<CanvasInkCache> InkCache;
+        ComPtr<Vector<InkStroke*>> Strokes;
+
+        std::vector<IInkStroke*> RenderedStrokes;
+        int CommandListCount;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , InkAdapter(std::make_shared<StubInkAdapter>())
+            , Strokes(Make<Vector<InkStroke*>>())
+            , CommandListCount(0)
+        {
+            InkAdapter::SetInstance(InkAdapter);
+
+            Device->CreateCommandListMethod.AllowAnyCall(
+                [=]
+                {
+                    CommandListCount++;
+
+                    auto commandList = Make<MockD2DCommandList>();
+                    commandList->CloseMethod.AllowAnyCall();
+                    return commandList;
+                });
+
+            Device->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+                []
+                {
+                    auto deviceContext = Make<StubD2DDeviceContext>();
+                    deviceContext->DrawImageMethod.AllowAnyCall();
+                    return deviceContext;
+                });
+
+            InkAdapter->GetInkRenderer()->DrawMethod.AllowAnyCall(
+                [=](IUnknown*, IUnknown* strokeCollection, BOOL)
+                {
+                    auto strokes = As<IVector<InkStroke*>>(strokeCollection);
+
+                    unsigned size;
+                    ThrowIfFailed(strokes->get_Size(&size));
+                    Assert::AreEqual(1u, size);
+
+                    ComPtr<IInkStroke> stroke;
+                    ThrowIfFailed(strokes->GetAt(0, &stroke));
+                    RenderedStrokes.push_back(stroke.Get());
+
+                    return S_OK;
+                });
+
+            ComPtr<ICanvasInkCache> inkCache;
+            ThrowIfFailed(Make<CanvasInkCacheFactory>()->Create(Device.Get(), &inkCache));
+            InkCache = static_cast<CanvasInkCache*>(inkCache.Get());
+        }
+
+        ComPtr<StubInkStroke> AddStroke()
+        {
+            auto stroke = Make<StubInkStroke>(Rect{ 0, 0, 10, 10 });
+            ThrowIfFailed(Strokes->Append(stroke.Get()));
+            return stroke;
+        }
+
+        ComPtr<ICanvasImage> Update(bool highContrast = false)
+        {
+            RenderedStrokes.clear();
+            CommandListCount = 0;
+
+            return InkCache->Update(Strokes.Get(), highContrast);
+        }
+    };
+
+    TEST_METHOD_EX(CanvasInkCache_Create_InvalidArgs)
+    {
+        auto factory = Make<CanvasInkCacheFactory>();
+        ComPtr<ICanvasInkCache> inkCache;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, &inkCache));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(Make<StubCanvasDevice>().Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_get_Device_ReturnsTheDevicePassedToCreate)
+    {
+        Fixture f;
+
+        ComPtr<ICanvasDevice> device;
+        ThrowIfFailed(f.InkCache->get_Device(&device));
+        Assert::IsTrue(IsSameInstance(f.Device.Get(), device.Get()));
+
+        Assert::AreEqual(E_INVALIDARG, f.InkCache->get_Device(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Update_WithNoStrokes_ReturnsNull)
+    {
+        Fixture f;
+
+        Assert::IsNull(f.Update().Get());
+        Assert::AreEqual(0, f.CommandListCount);
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Update_OnlyRendersNewStrokes)
+    {
+        Fixture f;
+
+        auto stroke1 = f.AddStroke();
+        auto stroke2 = f.AddStroke();
+
+        // The first update renders every stroke, then records them all together.
+        auto image = f.Update();
+        Assert::IsNotNull(image.Get());
+        Assert::AreEqual<size_t>(2, f.RenderedStrokes.size());
+        Assert::IsTrue(IsSameInstance(stroke1.Get(), f.RenderedStrokes[0]));
+        Assert::IsTrue(IsSameInstance(stroke2.Get(), f.RenderedStrokes[1]));
+        Assert::AreEqual(3, f.CommandListCount);
+
+        // Nothing changed, so the same image comes back.
+        Assert::IsTrue(IsSameInstance(image.Get(), f.Update().Get()));
+        Assert::IsTrue(f.RenderedStrokes.empty());
+        Assert::AreEqual(0, f.CommandListCount);
+
+        // A new stroke is rendered on its own.
+        auto stroke3 = f.AddStroke();
+
+        Assert::IsFalse(IsSameInstance(image.Get(), f.Update().Get()));
+        Assert::AreEqual<size_t>(1, f.RenderedStrokes.size());
+        Assert::IsTrue(IsSameInstance(stroke3.Get(), f.RenderedStrokes[0]));
+        Assert::AreEqual(2, f.CommandListCount);
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Update_RendersChangedStrokesAgain)
+    {
+        Fixture f;
+
+        auto stroke1 = f.AddStroke();
+        auto stroke2 = f.AddStroke();
+        f.Update();
+
+        stroke2->BoundingRect = Rect{ 5, 5, 10, 10 };
+        f.Update();
+        Assert::AreEqual<size_t>(1, f.RenderedStrokes.size());
+        Assert::IsTrue(IsSameInstance(stroke2.Get(), f.RenderedStrokes[0]));
+
+        stroke1->IsSelected = true;
+        f.Update();
+        Assert::AreEqual<size_t>(1, f.RenderedStrokes.size());
+        Assert::IsTrue(IsSameInstance(stroke1.Get(), f.RenderedStrokes[0]));
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Update_WhenStrokesAreRemovedOrReordered_RecordsWithoutRendering)
+    {
+        Fixture f;
+
+        f.AddStroke();
+        f.AddStroke();
+        auto stroke3 = f.AddStroke();
+        f.Update();
+
+        ThrowIfFailed(f.Strokes->RemoveAt(0));
+        Assert::IsNotNull(f.Update().Get());
+        Assert::IsTrue(f.RenderedStrokes.empty());
+        Assert::AreEqual(1, f.CommandListCount);
+
+        ThrowIfFailed(f.Strokes->RemoveAt(1));
+        ThrowIfFailed(f.Strokes->InsertAt(0, stroke3.Get()));
+        Assert::IsNotNull(f.Update().Get());
+        Assert::IsTrue(f.RenderedStrokes.empty());
+        Assert::AreEqual(1, f.CommandListCount);
+
+        ThrowIfFailed(f.Strokes->Clear());
+        Assert::IsNull(f.Update().Get());
+        Assert::AreEqual(0, f.CommandListCount);
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Update_WhenHighContrastChanges_RendersEverythingAgain)
+    {
+        Fixture f;
+
+        f.AddStroke();
+        f.AddStroke();
+        f.Update(false);
+
+        f.Update(true);
+        Assert::AreEqual<size_t>(2, f.RenderedStrokes.size());
+
+        f.Update(true);
+        Assert::IsTrue(f.RenderedStrokes.empty());
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Invalidate_RendersEverythingAgain)
+    {
+        Fixture f;
+
+        f.AddStroke();
+        f.AddStroke();
+        f.Update();
+
+        ThrowIfFailed(f.InkCache->Invalidate());
+
+        f.Update();
+        Assert::AreEqual<size_t>(2, f.RenderedStrokes.size());
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_Update_WhenRenderingFails_KeepsPreviousState)
+    {
+        Fixture f;
+
+        f.AddStroke();
+        f.Update();
+
+        f.AddStroke();
+
+        f.InkAdapter->GetInkRenderer()->DrawMethod.AllowAnyCall(
+            [](IUnknown*, IUnknown*, BOOL)
+            {
+                return E_FAIL;
+            });
+
+        ExpectHResultException(E_FAIL, [&] { f.Update(); });
+
+        // Only the new stroke is tried again.
+        int renderCount = 0;
+
+        f.InkAdapter->GetInkRenderer()->DrawMethod.AllowAnyCall(
+            [&](IUnknown*, IUnknown*, BOOL)
+            {
+                renderCount++;
+                return S_OK;
+            });
+
+        Assert::IsNotNull(f.Update().Get());
+        Assert::AreEqual(1, renderCount);
+    }
+
+    TEST_METHOD_EX(CanvasInkCache_DrawInkWithCache_InvalidArgs)
+    {
+        Fixture f;
+
+        auto drawingSession = CanvasDrawingSession::CreateNew(Make<StubD2DDeviceContext>().Get(), std::make_shared<StubCanvasDrawingSessionAdapter>());
+
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawInkWithCache(nullptr, false, f.InkCache.Get()));
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawInkWithCache(f.Strokes.Get(), false, nullptr));
+    }
+};
+
+#endif
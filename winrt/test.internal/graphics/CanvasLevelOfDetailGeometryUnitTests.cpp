@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include <lib/geometry/CanvasLevelOfDetailGeometry.h>
+#include "mocks/MockD2DGeometrySink.h"
+#include "mocks/MockD2DPathGeometry.h"
+#include "mocks/MockD2DRectangleGeometry.h"
+#include "mocks/MockGeometryAdapter.h"
+
+TEST_CLASS(CanvasLevelOfDetailGeometryTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        std::shared_ptr<MockGeometryAdapter> Adapter;
+        ComPtr<MockD2DRectangleGeometry> D2DGeometry;
+        ComPtr<ICanvasGeometry> Geometry;
+        std::vector<float> SimplifiedTolerances;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , Adapter(std::make_shared<MockGeometryAdapter>())
+            , D2DGeometry(Make<MockD2DRectangleGeometry>())
+        {
+            GeometryAdapter::SetInstance(Adapter);
+
+            Adapter->CreatePathGeometryMethod.AllowAnyCall(
+                []
+                {
+                    auto pathGeometry = Make<MockD2DPathGeometry>();
+
+                    pathGeometry->OpenMethod.AllowAnyCall(
+                        [](ID2D1GeometrySink** out)
+                        {
+                            auto geometrySink = Make<MockD2DGeometrySink>();
+                            geometrySink->CloseMethod.AllowAnyCall();
+                            return geometrySink.CopyTo(out);
+                        });
+
+                    return pathGeometry;
+                });
+
+            D2DGeometry->SimplifyMethod.AllowAnyCall(
+                [=](D2D1_GEOMETRY_SIMPLIFICATION_OPTION simplification, CONST D2D1_MATRIX_3X2_F* transform, FLOAT flatteningTolerance, ID2D1SimplifiedGeometrySink*)
+                {
+                    Assert::AreEqual(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, simplification);
+                    Assert::AreEqual<D2D1_MATRIX_3X2_F>(D2D1::Matrix3x2F::Identity(), *transform);
+
+                    SimplifiedTolerances.push_back(flatteningTolerance);
+                    return S_OK;
+                });
+
+            Geometry = Make<CanvasGeometry>(Device.Get(), D2DGeometry.Get());
+        }
+
+        ComPtr<ICanvasLevelOfDetailGeometry> Create()
+        {
+            auto factory = Make<CanvasLevelOfDetailGeometryFactory>();
+
+            ComPtr<ICanvasLevelOfDetailGeometry> levelOfDetailGeometry;
+            ThrowIfFailed(factory->CreateSimplified(Geometry.Get(), CanvasGeometrySimplification::Lines, &levelOfDetailGeometry));
+            return levelOfDetailGeometry;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasLevelOfDetailGeometry_GetLevel_RoundsDownToPowerOfTwo)
+    {
+        Assert::AreEqual(0, CanvasLevelOfDetailGeometry::GetLevel(1.0f));
+        Assert::AreEqual(0, CanvasLevelOfDetailGeometry::GetLevel(1.9f));
+        Assert::AreEqual(1, CanvasLevelOfDetailGeometry::GetLevel(2.0f));
+        Assert::AreEqual(-2, CanvasLevelOfDetailGeometry::GetLevel(0.25f));
+        Assert::AreEqual(-3, CanvasLevelOfDetailGeometry::GetLevel(0.24f));
+
+        Assert::AreEqual(CanvasLevelOfDetailGeometry::MinimumLevel, CanvasLevelOfDetailGeometry::GetLevel(1e-20f));
+        Assert::AreEqual(CanvasLevelOfDetailGeometry::MaximumLevel, CanvasLevelOfDetailGeometry::GetLevel(1e20f));
+        Assert::AreEqual(CanvasLevelOfDetailGeometry::MaximumLevel, CanvasLevelOfDetailGeometry::GetLevel(std::numeric_limits<float>::infinity()));
+    }
+
+    TEST_METHOD_EX(CanvasLevelOfDetailGeometry_GetFlatteningTolerance_ScalesWithZoom)
+    {
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE, CanvasLevelOfDetailGeometry::GetFlatteningTolerance(D2D1::Matrix3x2F::Identity(), DEFAULT_DPI, DEFAULT_DPI));
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE / 4, CanvasLevelOfDetailGeometry::GetFlatteningTolerance(D2D1::Matrix3x2F::Scale(4, 4), DEFAULT_DPI, DEFAULT_DPI));
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE / 2, CanvasLevelOfDetailGeometry::GetFlatteningTolerance(D2D1::Matrix3x2F::Identity(), DEFAULT_DPI * 2, DEFAULT_DPI * 2));
+    }
+
+    TEST_METHOD_EX(CanvasLevelOfDetailGeometry_SimilarTolerances_ShareOneSimplification)
+    {
+        Fixture f;
+        auto levelOfDetailGeometry = f.Create();
+
+        ComPtr<ICanvasGeometry> a, b, c;
+        ThrowIfFailed(levelOfDetailGeometry->GetGeometryForFlatteningTolerance(0.3f, &a));
+        ThrowIfFailed(levelOfDetailGeometry->GetGeometryForFlatteningTolerance(0.26f, &b));
+        ThrowIfFailed(levelOfDetailGeometry->GetGeometryForFlatteningTolerance(0.6f, &c));
+
+        Assert::IsTrue(IsSameInstance(a.Get(), b.Get()));
+        Assert::IsFalse(IsSameInstance(a.Get(), c.Get()));
+
+        Assert::AreEqual<size_t>(2, f.SimplifiedTolerances.size());
+        Assert::AreEqual(0.25f, f.SimplifiedTolerances[0]);
+        Assert::AreEqual(0.5f, f.SimplifiedTolerances[1]);
+
+        UINT32 levelCount;
+        ThrowIfFailed(levelOfDetailGeometry->get_LevelCount(&levelCount));
+        Assert::AreEqual(2u, levelCount);
+    }
+
+    TEST_METHOD_EX(CanvasLevelOfDetailGeometry_GetGeometryForDrawingSession_UsesTransformAndDpi)
+    {
+        Fixture f;
+        auto levelOfDetailGeometry = f.Create();
+
+        auto deviceContext = Make<StubD2DDeviceContextWithGetFactory>();
+        auto drawingSession = CanvasDrawingSession::CreateNew(deviceContext.Get(), std::make_shared<StubCanvasDrawingSessionAdapter>(), f.Device.Get());
+
+        // Zoomed in 8x at 192 DPI means 16 pixels per unit, so 0.25 / 16.
+        deviceContext->GetTransformMethod.AllowAnyCall([](D2D1_MATRIX_3X2_F* transform) { *transform = D2D1::Matrix3x2F::Scale(8, 8); });
+        deviceContext->GetUnitModeMethod.AllowAnyCall([] { return D2D1_UNIT_MODE_DIPS; });
+        deviceContext->GetDpiMethod.AllowAnyCall([](float* dpiX, float* dpiY) { *dpiX = *dpiY = DEFAULT_DPI * 2; });
+
+        ComPtr<ICanvasGeometry> geometry;
+        ThrowIfFailed(levelOfDetailGeometry->GetGeometryForDrawingSession(drawingSession.Get(), &geometry));
+
+        Assert::AreEqual<size_t>(1, f.SimplifiedTolerances.size());
+        Assert::AreEqual(1.0f / 64, f.SimplifiedTolerances[0]);
+    }
+
+    TEST_METHOD_EX(CanvasLevelOfDetailGeometry_Trim_ReleasesLevels)
+    {
+        Fixture f;
+        auto levelOfDetailGeometry = f.Create();
+
+        ComPtr<ICanvasGeometry> geometry;
+        ThrowIfFailed(levelOfDetailGeometry->GetGeometryForFlatteningTolerance(1, &geometry));
+        ThrowIfFailed(levelOfDetailGeometry->Trim());
+
+        UINT32 levelCount;
+        ThrowIfFailed(levelOfDetailGeometry->get_LevelCount(&levelCount));
+        Assert::AreEqual(0u, levelCount);
+
+        ThrowIfFailed(levelOfDetailGeometry->GetGeometryForFlatteningTolerance(1, &geometry));
+        Assert::AreEqual<size_t>(2, f.SimplifiedTolerances.size());
+    }
+
+    TEST_METHOD_EX(CanvasLevelOfDetailGeometry_InvalidArgs)
+    {
+        Fixture f;
+        auto factory = Make<CanvasLevelOfDetailGeometryFactory>();
+        auto levelOfDetailGeometry = f.Create();
+
+        ComPtr<ICanvasLevelOfDetailGeometry> created;
+        ComPtr<ICanvasGeometry> geometry;
+
+        Assert::AreEqual(E_INVALIDARG, factory->CreateSimplified(nullptr, CanvasGeometrySimplification::Lines, &created));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateOutlined(nullptr, &created));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateOutlined(f.Geometry.Get(), nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, levelOfDetailGeometry->GetGeometryForFlatteningTolerance(0, &geometry));
+        Assert::AreEqual(E_INVALIDARG, levelOfDetailGeometry->GetGeometryForFlatteningTolerance(-1, &geometry));
+        Assert::AreEqual(E_INVALIDARG, levelOfDetailGeometry->GetGeometryForFlatteningTolerance(1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, levelOfDetailGeometry->GetGeometryForDrawingSession(nullptr, &geometry));
+        Assert::AreEqual(E_INVALIDARG, levelOfDetailGeometry->get_LevelCount(nullptr));
+
+        Assert::AreEqual<size_t>(0, f.SimplifiedTolerances.size());
+    }
+};
@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include <lib/geometry/CanvasMesh.h>
+#include <lib/geometry/TessellationSink.h>
+#include "mocks/MockD2DMesh.h"
+#include "mocks/MockD2DRectangleGeometry.h"
+
+TEST_CLASS(CanvasMeshTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<StubD2DDeviceContext> DeviceContext;
+        ComPtr<MockD2DMesh> D2DMesh;
+        ComPtr<TessellationSink> Sink;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , DeviceContext(Make<StubD2DDeviceContext>())
+            , D2DMesh(Make<MockD2DMesh>())
+            , Sink(Make<TessellationSink>())
+        {
+            Device->GetResourceCreationDeviceContextMethod.AllowAnyCall([=] { return DeviceContextLease(DeviceContext); });
+        }
+
+        void ExpectCreateMesh()
+        {
+            DeviceContext->CreateMeshMethod.SetExpectedCalls(1,
+                [=](ID2D1Mesh** mesh)
+                {
+                    return D2DMesh.CopyTo(mesh);
+                });
+
+            D2DMesh->OpenMethod.SetExpectedCalls(1,
+                [=](ID2D1TessellationSink** sink)
+                {
+                    return Sink.CopyTo(sink);
+                });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasMesh_get_Device)
+    {
+        Fixture f;
+        auto mesh = Make<CanvasMesh>(f.Device.Get(), f.D2DMesh.Get());
+
+        ComPtr<ICanvasDevice> device;
+        Assert::AreEqual(S_OK, mesh->get_Device(&device));
+        Assert::AreEqual(static_cast<ICanvasDevice*>(f.Device.Get()), device.Get());
+
+        Assert::AreEqual(E_INVALIDARG, mesh->get_Device(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasMesh_Closed)
+    {
+        Fixture f;
+        auto mesh = Make<CanvasMesh>(f.Device.Get(), f.D2DMesh.Get());
+
+        Assert::AreEqual(S_OK, mesh->Close());
+
+        ComPtr<ICanvasDevice> device;
+        Assert::AreEqual(RO_E_CLOSED, mesh->get_Device(&device));
+    }
+
+    TEST_METHOD_EX(CanvasMesh_CreateFromGeometry_TessellatesIntoMesh)
+    {
+        Fixture f;
+        f.ExpectCreateMesh();
+
+        auto d2dGeometry = Make<MockD2DRectangleGeometry>();
+        auto geometry = Make<CanvasGeometry>(f.Device.Get(), d2dGeometry.Get());
+
+        D2D1_TRIANGLE triangle{ { 1, 2 }, { 3, 4 }, { 5, 6 } };
+
+        d2dGeometry->TessellateMethod.SetExpectedCalls(1,
+            [&](D2D1_MATRIX_3X2_F const* transform, float flatteningTolerance, ID2D1TessellationSink* sink)
+            {
+                Assert::IsNull(transform);
+                Assert::AreEqual(0.5f, flatteningTolerance);
+                Assert::AreEqual(static_cast<ID2D1TessellationSink*>(f.Sink.Get()), sink);
+
+                sink->AddTriangles(&triangle, 1);
+                return S_OK;
+            });
+
+        auto mesh = CanvasMesh::CreateNew(f.Device.Get(), geometry.Get(), 0.5f);
+
+        Assert::IsTrue(IsSameInstance(f.D2DMesh.Get(), GetWrappedResource<ID2D1Mesh>(mesh).Get()));
+        Assert::AreEqual<size_t>(1, f.Sink->TakeTriangles().size());
+    }
+
+    TEST_METHOD_EX(CanvasMesh_CreateFromTriangles_AddsTrianglesToMesh)
+    {
+        Fixture f;
+        f.ExpectCreateMesh();
+
+        CanvasTriangleVertices triangles[] =
+        {
+            { Vector2{ 0, 0 }, Vector2{ 1, 0 }, Vector2{ 0, 1 } },
+            { Vector2{ 1, 0 }, Vector2{ 1, 1 }, Vector2{ 0, 1 } },
+        };
+
+        auto factory = Make<CanvasMeshFactory>();
+
+        ComPtr<ICanvasMesh> mesh;
+        ThrowIfFailed(factory->CreateFromTriangles(f.Device.Get(), _countof(triangles), triangles, &mesh));
+
+        auto addedTriangles = f.Sink->TakeTriangles();
+
+        Assert::AreEqual<size_t>(2, addedTriangles.size());
+        Assert::AreEqual(triangles[1].Vertex2, addedTriangles[1].Vertex2);
+    }
+
+    TEST_METHOD_EX(CanvasMesh_Create_NullArgs)
+    {
+        Fixture f;
+        auto factory = Make<CanvasMeshFactory>();
+        CanvasTriangleVertices triangle{};
+        ComPtr<ICanvasMesh> mesh;
+
+        Assert::AreEqual(E_INVALIDARG, factory->CreateFromGeometry(nullptr, &mesh));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateFromTriangles(nullptr, 1, &triangle, &mesh));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateFromTriangles(f.Device.Get(), 1, nullptr, &mesh));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateFromTriangles(f.Device.Get(), 1, &triangle, nullptr));
+    }
+};
@@ -70,6 +70,9 @@ TEST_CLASS(CanvasPathBuilderUnitTests)
         Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->AddLine(Vector2{}));
         Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->AddLineWithCoords(0, 0));
         Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->AddQuadraticBezier(Vector2{}, Vector2{}));
+        Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->AddLines(0, nullptr));
+        Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->AddCubicBeziers(0, nullptr));
+        Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->AddQuadraticBeziers(0, nullptr));
         Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->SetSegmentOptions(CanvasFigureSegmentOptions::None));
         Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->SetFilledRegionDetermination(CanvasFilledRegionDetermination::Alternate));
         Assert::AreEqual(RO_E_CLOSED, canvasPathBuilder->EndFigure(CanvasFigureLoop::Closed));
@@ -442,6 +445,91 @@ TEST_CLASS(CanvasPathBuilderUnitTests)
         ValidateStoredErrorState(E_INVALIDARG, Strings::CanOnlyAddPathDataWhileInFigure);
     }
 
+    TEST_METHOD_EX(CanvasPathBuilder_AddLines)
+    {
+        SinkAccessFixture f;
+
+        f.PathBuilder->BeginFigure(Vector2{});
+
+        Vector2 points[] = { { 1, 2 }, { 3, 4 } };
+
+        f.GeometrySink->AddLinesMethod.SetExpectedCalls(1,
+            [](D2D1_POINT_2F const* points, UINT32 pointsCount)
+            {
+                Assert::AreEqual(2u, pointsCount);
+                Assert::AreEqual(D2D1::Point2F(1, 2), points[0]);
+                Assert::AreEqual(D2D1::Point2F(3, 4), points[1]);
+            });
+        ThrowIfFailed(f.PathBuilder->AddLines(_countof(points), points));
+
+        // Adding no lines doesn't call D2D at all.
+        ThrowIfFailed(f.PathBuilder->AddLines(0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasPathBuilder_AddCubicBeziers)
+    {
+        SinkAccessFixture f;
+
+        f.PathBuilder->BeginFigure(Vector2{});
+
+        Vector2 points[] = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 }, { 9, 10 }, { 11, 12 } };
+
+        f.GeometrySink->AddBeziersMethod.SetExpectedCalls(1,
+            [](D2D1_BEZIER_SEGMENT const* segments, UINT32 segmentsCount)
+            {
+                Assert::AreEqual(2u, segmentsCount);
+                Assert::AreEqual(D2D1::Point2F(1, 2), segments[0].point1);
+                Assert::AreEqual(D2D1::Point2F(5, 6), segments[0].point3);
+                Assert::AreEqual(D2D1::Point2F(7, 8), segments[1].point1);
+                Assert::AreEqual(D2D1::Point2F(11, 12), segments[1].point3);
+            });
+        ThrowIfFailed(f.PathBuilder->AddCubicBeziers(_countof(points), points));
+
+        Assert::AreEqual(E_INVALIDARG, f.PathBuilder->AddCubicBeziers(2, points));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::CubicBezierPointCountMustBeMultipleOf3);
+    }
+
+    TEST_METHOD_EX(CanvasPathBuilder_AddQuadraticBeziers)
+    {
+        SinkAccessFixture f;
+
+        f.PathBuilder->BeginFigure(Vector2{});
+
+        Vector2 points[] = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 } };
+
+        f.GeometrySink->AddQuadraticBeziersMethod.SetExpectedCalls(1,
+            [](D2D1_QUADRATIC_BEZIER_SEGMENT const* segments, UINT32 segmentsCount)
+            {
+                Assert::AreEqual(2u, segmentsCount);
+                Assert::AreEqual(D2D1::Point2F(1, 2), segments[0].point1);
+                Assert::AreEqual(D2D1::Point2F(3, 4), segments[0].point2);
+                Assert::AreEqual(D2D1::Point2F(5, 6), segments[1].point1);
+                Assert::AreEqual(D2D1::Point2F(7, 8), segments[1].point2);
+            });
+        ThrowIfFailed(f.PathBuilder->AddQuadraticBeziers(_countof(points), points));
+
+        Assert::AreEqual(E_INVALIDARG, f.PathBuilder->AddQuadraticBeziers(3, points));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::QuadraticBezierPointCountMustBeMultipleOf2);
+    }
+
+    TEST_METHOD_EX(CanvasPathBuilder_AddLinesAndBeziers_InvalidState)
+    {
+        SinkAccessFixture f;
+
+        Vector2 points[6] = {};
+
+        Assert::AreEqual(E_INVALIDARG, f.PathBuilder->AddLines(1, points));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::CanOnlyAddPathDataWhileInFigure);
+
+        Assert::AreEqual(E_INVALIDARG, f.PathBuilder->AddCubicBeziers(3, points));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::CanOnlyAddPathDataWhileInFigure);
+
+        Assert::AreEqual(E_INVALIDARG, f.PathBuilder->AddQuadraticBeziers(2, points));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::CanOnlyAddPathDataWhileInFigure);
+
+        Assert::AreEqual(E_INVALIDARG, f.PathBuilder->AddLines(1, nullptr));
+    }
+
     TEST_METHOD_EX(CanvasPathBuilder_SetSegmentOptions)
     {
         SinkAccessFixture f;
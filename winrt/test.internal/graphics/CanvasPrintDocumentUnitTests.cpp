@@ -649,6 +649,167 @@ TEST_CLASS(CanvasPrintDocumentUnitTests)
         f.Adapter->RunNextAction();
     }
 
+    TEST_METHOD_EX(CanvasPrintDocument_IsPreviewCacheEnabled_DefaultsToFalse)
+    {
+        Fixture f;
+        auto doc = f.Create();
+
+        Assert::AreEqual(E_INVALIDARG, doc->get_IsPreviewCacheEnabled(nullptr));
+
+        boolean value;
+        ThrowIfFailed(doc->get_IsPreviewCacheEnabled(&value));
+        Assert::IsFalse(!!value);
+
+        ThrowIfFailed(doc->put_IsPreviewCacheEnabled(true));
+        ThrowIfFailed(doc->get_IsPreviewCacheEnabled(&value));
+        Assert::IsTrue(!!value);
+    }
+
+    struct PreviewCacheFixture : public PrintPreviewFixture
+    {
+        ComPtr<MockPrintTaskOptions> PrintTaskOptions;
+        ComPtr<ID2D1Image> LastDrawnImage;
+
+        PreviewCacheFixture()
+            : PrintTaskOptions(Make<MockPrintTaskOptions>())
+        {
+            RegisterPreview();
+            ThrowIfFailed(Doc->put_IsPreviewCacheEnabled(true));
+
+            PrintTaskOptions->GetPageDescriptionMethod.AllowAnyCall(
+                [] (uint32_t, PrintPageDescription* outDesc)
+                {
+                    *outDesc = PrintPageDescription{
+                        Size{ 100, 200 },
+                        Rect{ 0, 0, 100, 200 },            // ImageableRect
+                        (uint32_t)AnyDpi, (uint32_t)AnyDpi  // DPI X, Y
+                    };
+                    return S_OK;
+                });
+
+            Adapter->SharedDevice->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+                [=]
+                {
+                    auto deviceContext = Make<StubD2DDeviceContext>(nullptr);
+                    deviceContext->DrawImageMethod.AllowAnyCall(
+                        [=] (ID2D1Image* image, D2D1_POINT_2F const*, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+                        {
+                            LastDrawnImage = image;
+                        });
+                    return deviceContext;
+                });
+
+            Paginate();
+        }
+
+        void Paginate()
+        {
+            ThrowIfFailed(PageCollection->Paginate(AnyPageNumber, PrintTaskOptions.Get()));
+            Adapter->RunNextAction();
+        }
+
+        ComPtr<MockD2DCommandList> ExpectRecording()
+        {
+            auto commandList = Make<MockD2DCommandList>();
+            commandList->CloseMethod.SetExpectedCalls(1);
+
+            Adapter->SharedDevice->CreateCommandListMethod.SetExpectedCalls(1,
+                [=] { return commandList; });
+
+            PreviewHandler.SetExpectedCalls(1);
+
+            return commandList;
+        }
+
+        void ExpectNoRecording()
+        {
+            Adapter->SharedDevice->CreateCommandListMethod.SetExpectedCalls(0);
+            PreviewHandler.SetExpectedCalls(0);
+        }
+
+        void MakePage(uint32_t pageNumber)
+        {
+            LastDrawnImage.Reset();
+            PreviewTarget->DrawPageMethod.SetExpectedCalls(1);
+
+            ThrowIfFailed(PageCollection->MakePage(pageNumber, AnyWidth, AnyHeight));
+            Adapter->RunNextAction();
+        }
+    };
+
+    TEST_METHOD_EX(CanvasPrintDocument_WhenPreviewCacheEnabled_PagesAreOnlyPreviewedOnce)
+    {
+        PreviewCacheFixture f;
+
+        auto page1 = f.ExpectRecording();
+        f.MakePage(1);
+        Assert::IsTrue(IsSameInstance(page1.Get(), f.LastDrawnImage.Get()));
+
+        auto page2 = f.ExpectRecording();
+        f.MakePage(2);
+        Assert::IsTrue(IsSameInstance(page2.Get(), f.LastDrawnImage.Get()));
+
+        // Going back to the first page replays its recording.
+        f.ExpectNoRecording();
+        f.MakePage(1);
+        Assert::IsTrue(IsSameInstance(page1.Get(), f.LastDrawnImage.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasPrintDocument_WhenPreviewCacheEnabled_InvalidatePreview_DiscardsRecordedPages)
+    {
+        PreviewCacheFixture f;
+
+        f.ExpectRecording();
+        f.MakePage(1);
+
+        f.PreviewTarget->InvalidatePreviewMethod.SetExpectedCalls(1);
+        ThrowIfFailed(f.Doc->InvalidatePreview());
+
+        auto page = f.ExpectRecording();
+        f.MakePage(1);
+        Assert::IsTrue(IsSameInstance(page.Get(), f.LastDrawnImage.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasPrintDocument_WhenPreviewCacheEnabled_Paginate_DiscardsRecordedPages)
+    {
+        PreviewCacheFixture f;
+
+        f.ExpectRecording();
+        f.MakePage(1);
+
+        f.Paginate();
+
+        f.ExpectRecording();
+        f.MakePage(1);
+    }
+
+    TEST_METHOD_EX(CanvasPrintDocument_WhenPreviewIsDeferred_AndCacheIsCleared_PageIsNotCached)
+    {
+        PreviewCacheFixture f;
+
+        ComPtr<ICanvasPrintDeferral> deferral;
+
+        f.ExpectRecording();
+        f.PreviewHandler.SetExpectedCalls(1,
+            [&] (ICanvasPrintDocument*, ICanvasPreviewEventArgs* args)
+            {
+                ThrowIfFailed(args->GetDeferral(&deferral));
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.PageCollection->MakePage(1, AnyWidth, AnyHeight));
+        f.Adapter->RunNextAction();
+
+        f.PreviewTarget->InvalidatePreviewMethod.SetExpectedCalls(1);
+        ThrowIfFailed(f.Doc->InvalidatePreview());
+
+        ThrowIfFailed(deferral->Complete());
+        f.Adapter->RunNextAction();
+
+        f.ExpectRecording();
+        f.MakePage(1);
+    }
+
     struct PrintFixture : public Fixture
     {
         ComPtr<ICanvasPrintDocument> Doc;
@@ -1158,6 +1319,119 @@ TEST_CLASS(CanvasPrintEventArgsUnitTests)
         ValidateStoredErrorState(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
     }
 
+    TEST_METHOD_EX(CanvasPrintEventArgs_DrawPagesAsync_FailsWithBadParams)
+    {
+        Fixture f;
+
+        auto handler = Callback<ICanvasPrintPageHandler>([] (uint32_t, ICanvasDrawingSession*) { return S_OK; });
+        ComPtr<IAsyncAction> action;
+
+        Assert::AreEqual(E_INVALIDARG, f.Args->DrawPagesAsync(1, 0, nullptr, &action));
+        Assert::AreEqual(E_INVALIDARG, f.Args->DrawPagesAsync(1, 0, handler.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Args->DrawPagesAsync(1, -1, handler.Get(), &action));
+    }
+
+    TEST_METHOD_EX(CanvasPrintEventArgs_DrawPages_AddsPagesInOrder_AfterPagesFromCreateDrawingSession)
+    {
+        Fixture f;
+
+        ComPtr<ICanvasDrawingSession> ds;
+        ThrowIfFailed(f.Args->CreateDrawingSession(&ds));
+        ThrowIfFailed(As<IClosable>(ds)->Close());
+
+        std::vector<uint32_t> drawnPages;
+        std::vector<ComPtr<IUnknown>> drawnCommandLists;
+
+        auto handler = Callback<ICanvasPrintPageHandler>(
+            [&] (uint32_t pageNumber, ICanvasDrawingSession* drawingSession)
+            {
+                ComPtr<ID2D1Image> d2dTarget;
+                GetWrappedResource<ID2D1DeviceContext>(drawingSession)->GetTarget(&d2dTarget);
+
+                drawnPages.push_back(pageNumber);
+                drawnCommandLists.push_back(d2dTarget);
+                return S_OK;
+            });
+
+        std::vector<uint32_t> describedPages;
+
+        f.PrintTaskOptions->GetPageDescriptionMethod.AllowAnyCall(
+            [&] (uint32_t page, PrintPageDescription* outDesc)
+            {
+                describedPages.push_back(page);
+                *outDesc = PrintPageDescription{};
+                return S_OK;
+            });
+
+        std::vector<ComPtr<IUnknown>> addedCommandLists;
+
+        f.PrintControl->AddPageMethod.SetExpectedCalls(3,
+            [&] (ID2D1CommandList* commandList, D2D_SIZE_F, IStream*, D2D1_TAG*, D2D1_TAG*)
+            {
+                addedCommandLists.push_back(commandList);
+                return S_OK;
+            });
+
+        f.Args->DrawPages(3, 1, handler.Get());
+
+        Assert::AreEqual(3U, static_cast<uint32_t>(drawnPages.size()));
+        Assert::AreEqual(3U, static_cast<uint32_t>(describedPages.size()));
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            // The first page came from CreateDrawingSession.
+            Assert::AreEqual(i + 2, drawnPages[i]);
+            Assert::AreEqual(i + 2, describedPages[i]);
+            Assert::IsTrue(IsSameInstance(drawnCommandLists[i].Get(), addedCommandLists[i].Get()));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasPrintEventArgs_WhileDrawingPages_CreateDrawingSessionFails)
+    {
+        Fixture f;
+
+        auto handler = Callback<ICanvasPrintPageHandler>(
+            [&] (uint32_t, ICanvasDrawingSession*)
+            {
+                ComPtr<ICanvasDrawingSession> ds;
+                Assert::AreEqual(E_FAIL, f.Args->CreateDrawingSession(&ds));
+                return S_OK;
+            });
+
+        f.Args->DrawPages(1, 1, handler.Get());
+
+        // Once the pages are done, drawing sessions can be created again.
+        ComPtr<ICanvasDrawingSession> ds;
+        ThrowIfFailed(f.Args->CreateDrawingSession(&ds));
+    }
+
+    TEST_METHOD_EX(CanvasPrintEventArgs_DrawPages_WhenHandlerFails_LaterPagesAreNotDrawn)
+    {
+        Fixture f;
+
+        HRESULT const handlerError = 0x87654321;
+        int callCount = 0;
+
+        auto handler = Callback<ICanvasPrintPageHandler>(
+            [&] (uint32_t, ICanvasDrawingSession*)
+            {
+                ++callCount;
+                return handlerError;
+            });
+
+        f.Device->CreateCommandListMethod.AllowAnyCall(
+            [=]
+            {
+                return Make<MockD2DCommandList>();
+            });
+
+        f.PrintControl->AddPageMethod.SetExpectedCalls(0);
+
+        ExpectHResultException(handlerError, [&] { f.Args->DrawPages(3, 1, handler.Get()); });
+
+        Assert::AreEqual(1, callCount);
+    }
+
     TEST_METHOD_EX(CanvasPrintEventArgs_When_GetDeferralCalledMultipleTimes_SecondCallFails)
     {
         Fixture f;
@@ -1313,6 +1587,82 @@ TEST_CLASS(CanvasPrintDeferrableTaskUnitTests)
         Assert::IsTrue(future.wait_for(Timeout) == std::future_status::ready);
         future.get();
     }
+
+    static void CompleteWithoutDeferral(DeferrableTask* task)
+    {
+        task->SetCompletionFn([] {});
+        task->NonDeferredComplete();
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTask_TasksThatDoNotDefer_RunInOneDispatcherCallback)
+    {
+        Fixture f;
+
+        std::vector<std::future<void>> futures;
+
+        for (int i = 0; i < 3; ++i)
+            futures.push_back(f.Schedule(CompleteWithoutDeferral));
+
+        f.Dispatcher->Tick();
+
+        Assert::IsFalse(f.Dispatcher->HasPendingActions());
+
+        for (auto& future : futures)
+        {
+            Assert::IsTrue(future.wait_for(Timeout) == std::future_status::ready);
+            future.get();
+        }
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTask_WhenDeferralCompletes_PendingTasksRunInTheSameCallback)
+    {
+        Fixture f;
+
+        ComPtr<CanvasPrintDeferral> deferral;
+
+        auto deferredFuture = f.Schedule(
+            [&] (DeferrableTask* task)
+            {
+                task->SetCompletionFn([] {});
+                deferral = task->GetDeferral();
+                task->NonDeferredComplete();
+            });
+
+        auto pendingFuture = f.Schedule(CompleteWithoutDeferral);
+
+        f.Dispatcher->Tick();
+
+        // The second task waits for the first one's deferral.
+        Assert::IsFalse(f.Dispatcher->HasPendingActions());
+        Assert::IsTrue(pendingFuture.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+
+        ThrowIfFailed(deferral->Complete());
+        f.Dispatcher->Tick();
+
+        Assert::IsFalse(f.Dispatcher->HasPendingActions());
+        Assert::IsTrue(deferredFuture.wait_for(Timeout) == std::future_status::ready);
+        Assert::IsTrue(pendingFuture.wait_for(Timeout) == std::future_status::ready);
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTask_LongRunsOfTasks_AreSplitAcrossDispatcherCallbacks)
+    {
+        Fixture f;
+
+        std::vector<std::future<void>> futures;
+
+        for (uint32_t i = 0; i < DeferrableTaskScheduler::MaximumTasksPerCallback + 1; ++i)
+            futures.push_back(f.Schedule(CompleteWithoutDeferral));
+
+        f.Dispatcher->Tick();
+
+        Assert::IsTrue(f.Dispatcher->HasPendingActions());
+        Assert::IsTrue(futures.back().wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+
+        f.Dispatcher->Tick();
+
+        Assert::IsFalse(f.Dispatcher->HasPendingActions());
+        Assert::IsTrue(futures.back().wait_for(Timeout) == std::future_status::ready);
+    }
 };
 
 
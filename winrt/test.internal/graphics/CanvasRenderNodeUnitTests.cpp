@@ -0,0 +1,324 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/drawing/CanvasActiveLayer.h>
+#include <lib/drawing/CanvasRenderNode.h>
+#include <lib/images/CanvasCommandList.h>
+
+#include "mocks/MockCanvasDrawingSession.h"
+
+TEST_CLASS(CanvasRenderNodeTests)
+{
+    class RecordingDrawingSession : public MockCanvasDrawingSession
+    {
+    public:
+        std::vector<std::wstring> Calls;
+        std::vector<ComPtr<ICanvasImage>> DrawnImages;
+
+        IFACEMETHODIMP DrawImageAtOrigin(ICanvasImage* image) override
+        {
+            Calls.push_back(L"DrawImage");
+            DrawnImages.push_back(image);
+            return S_OK;
+        }
+
+        IFACEMETHODIMP PushTransform(Matrix3x2) override
+        {
+            Calls.push_back(L"PushTransform");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP PopTransform() override
+        {
+            Calls.push_back(L"PopTransform");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP PushClip(Rect) override
+        {
+            Calls.push_back(L"PushClip");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP PopClip() override
+        {
+            Calls.push_back(L"PopClip");
+            return S_OK;
+        }
+
+        IFACEMETHODIMP CreateLayerWithOpacity(float, ICanvasActiveLayer** layer) override
+        {
+            Calls.push_back(L"CreateLayer");
+
+            auto activeLayer = MakePooled<CanvasActiveLayer>([this] { Calls.push_back(L"CloseLayer"); });
+            return activeLayer.CopyTo(layer);
+        }
+    };
+
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<CanvasRenderNodeFactory> Factory;
+        int CommandListCount;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , Factory(Make<CanvasRenderNodeFactory>())
+            , CommandListCount(0)
+        {
+            Device->CreateCommandListMethod.AllowAnyCall(
+                [=]
+                {
+                    CommandListCount++;
+
+                    auto commandList = Make<MockD2DCommandList>();
+                    commandList->CloseMethod.AllowAnyCall();
+                    return commandList;
+                });
+
+            Device->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+                []
+                {
+                    auto deviceContext = Make<StubD2DDeviceContext>();
+                    deviceContext->SetTargetMethod.AllowAnyCall();
+                    deviceContext->BeginDrawMethod.AllowAnyCall();
+                    deviceContext->EndDrawMethod.AllowAnyCall();
+                    deviceContext->GetPrimitiveBlendMethod.AllowAnyCall([] { return D2D1_PRIMITIVE_BLEND_SOURCE_OVER; });
+                    deviceContext->DrawImageMethod.AllowAnyCall();
+                    return deviceContext;
+                });
+        }
+
+        ComPtr<CanvasRenderNode> CreateNode()
+        {
+            ComPtr<ICanvasRenderNode> node;
+            ThrowIfFailed(Factory->Create(Device.Get(), &node));
+            return static_cast<CanvasRenderNode*>(node.Get());
+        }
+
+        ComPtr<ICanvasCommandList> CreateContent()
+        {
+            return CanvasCommandList::CreateNew(Device.Get());
+        }
+    };
+
+    TEST_METHOD_EX(CanvasRenderNode_Create_InvalidArgs)
+    {
+        Fixture f;
+        ComPtr<ICanvasRenderNode> node;
+
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(nullptr, &node));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(f.Device.Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_get_Device_ReturnsTheDevicePassedToCreate)
+    {
+        Fixture f;
+        auto node = f.CreateNode();
+
+        ComPtr<ICanvasDevice> device;
+        ThrowIfFailed(node->get_Device(&device));
+        Assert::IsTrue(IsSameInstance(f.Device.Get(), device.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_Properties_HaveDefaults_AndRoundTrip)
+    {
+        Fixture f;
+        auto node = f.CreateNode();
+
+        Numerics::Matrix3x2 transform;
+        ThrowIfFailed(node->get_Transform(&transform));
+        Assert::AreEqual(Numerics::Matrix3x2{ 1, 0, 0, 1, 0, 0 }, transform);
+
+        ComPtr<IReference<Rect>> clipRectangle;
+        ThrowIfFailed(node->get_ClipRectangle(&clipRectangle));
+        Assert::IsNull(clipRectangle.Get());
+
+        float opacity;
+        ThrowIfFailed(node->get_Opacity(&opacity));
+        Assert::AreEqual(1.0f, opacity);
+
+        boolean isVisible;
+        ThrowIfFailed(node->get_IsVisible(&isVisible));
+        Assert::IsTrue(!!isVisible);
+
+        ComPtr<ICanvasCommandList> content;
+        ThrowIfFailed(node->get_Content(&content));
+        Assert::IsNull(content.Get());
+
+        ThrowIfFailed(node->put_Transform(Numerics::Matrix3x2{ 1, 2, 3, 4, 5, 6 }));
+        ThrowIfFailed(node->get_Transform(&transform));
+        Assert::AreEqual(Numerics::Matrix3x2{ 1, 2, 3, 4, 5, 6 }, transform);
+
+        ThrowIfFailed(node->put_ClipRectangle(Make<Nullable<Rect>>(Rect{ 1, 2, 3, 4 }).Get()));
+        ThrowIfFailed(node->get_ClipRectangle(&clipRectangle));
+        Rect rect;
+        ThrowIfFailed(clipRectangle->get_Value(&rect));
+        Assert::AreEqual(Rect{ 1, 2, 3, 4 }, rect);
+
+        ThrowIfFailed(node->put_ClipRectangle(nullptr));
+        ThrowIfFailed(node->get_ClipRectangle(&clipRectangle));
+        Assert::IsNull(clipRectangle.Get());
+
+        ThrowIfFailed(node->put_Opacity(0.5f));
+        ThrowIfFailed(node->get_Opacity(&opacity));
+        Assert::AreEqual(0.5f, opacity);
+
+        ThrowIfFailed(node->put_IsVisible(false));
+        ThrowIfFailed(node->get_IsVisible(&isVisible));
+        Assert::IsFalse(!!isVisible);
+
+        auto newContent = f.CreateContent();
+        ThrowIfFailed(node->put_Content(newContent.Get()));
+        ThrowIfFailed(node->get_Content(&content));
+        Assert::IsTrue(IsSameInstance(newContent.Get(), content.Get()));
+
+        ComPtr<IVector<CanvasRenderNode*>> children;
+        ThrowIfFailed(node->get_Children(&children));
+        unsigned size;
+        ThrowIfFailed(children->get_Size(&size));
+        Assert::AreEqual(0u, size);
+
+        Assert::AreEqual(E_INVALIDARG, node->get_Transform(nullptr));
+        Assert::AreEqual(E_INVALIDARG, node->get_ClipRectangle(nullptr));
+        Assert::AreEqual(E_INVALIDARG, node->get_Opacity(nullptr));
+        Assert::AreEqual(E_INVALIDARG, node->get_IsVisible(nullptr));
+        Assert::AreEqual(E_INVALIDARG, node->get_Content(nullptr));
+        Assert::AreEqual(E_INVALIDARG, node->get_Children(nullptr));
+        Assert::AreEqual(E_INVALIDARG, node->get_Device(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_Draw_LeafNode_DrawsContentWithoutRecording)
+    {
+        Fixture f;
+        auto node = f.CreateNode();
+        auto content = f.CreateContent();
+        ThrowIfFailed(node->put_Content(content.Get()));
+
+        f.CommandListCount = 0;
+
+        auto drawingSession = Make<RecordingDrawingSession>();
+        node->Draw(drawingSession.Get());
+
+        Assert::AreEqual(0, f.CommandListCount);
+        Assert::AreEqual(1u, (unsigned)drawingSession->Calls.size());
+        Assert::IsTrue(IsSameInstance(content.Get(), drawingSession->DrawnImages[0].Get()));
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_Draw_AppliesTransformClipAndOpacity)
+    {
+        Fixture f;
+        auto node = f.CreateNode();
+        ThrowIfFailed(node->put_Content(f.CreateContent().Get()));
+        ThrowIfFailed(node->put_Transform(Numerics::Matrix3x2{ 2, 0, 0, 2, 0, 0 }));
+        ThrowIfFailed(node->put_ClipRectangle(Make<Nullable<Rect>>(Rect{ 1, 2, 3, 4 }).Get()));
+        ThrowIfFailed(node->put_Opacity(0.5f));
+
+        auto drawingSession = Make<RecordingDrawingSession>();
+        node->Draw(drawingSession.Get());
+
+        std::vector<std::wstring> expected{ L"PushTransform", L"PushClip", L"CreateLayer", L"DrawImage", L"CloseLayer", L"PopClip", L"PopTransform" };
+        Assert::IsTrue(expected == drawingSession->Calls);
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_Draw_WhenHiddenOrEmpty_DrawsNothing)
+    {
+        Fixture f;
+        auto node = f.CreateNode();
+
+        auto drawingSession = Make<RecordingDrawingSession>();
+        node->Draw(drawingSession.Get());
+        Assert::IsTrue(drawingSession->Calls.empty());
+
+        ThrowIfFailed(node->put_Content(f.CreateContent().Get()));
+        ThrowIfFailed(node->put_IsVisible(false));
+        node->Draw(drawingSession.Get());
+        Assert::IsTrue(drawingSession->Calls.empty());
+
+        ThrowIfFailed(node->put_IsVisible(true));
+        ThrowIfFailed(node->put_Opacity(0));
+        node->Draw(drawingSession.Get());
+        Assert::IsTrue(drawingSession->Calls.empty());
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_Draw_OnlyRecordsChangedSubtrees)
+    {
+        Fixture f;
+
+        auto root = f.CreateNode();
+        auto branch = f.CreateNode();
+        auto leaf1 = f.CreateNode();
+        auto leaf2 = f.CreateNode();
+
+        ThrowIfFailed(leaf1->put_Content(f.CreateContent().Get()));
+        ThrowIfFailed(leaf2->put_Content(f.CreateContent().Get()));
+
+        ComPtr<IVector<CanvasRenderNode*>> children;
+        ThrowIfFailed(root->get_Children(&children));
+        ThrowIfFailed(children->Append(branch.Get()));
+        ThrowIfFailed(children->Append(leaf1.Get()));
+
+        ThrowIfFailed(branch->get_Children(&children));
+        ThrowIfFailed(children->Append(leaf2.Get()));
+
+        auto drawingSession = Make<RecordingDrawingSession>();
+
+        // The first draw records both the root and the branch.
+        f.CommandListCount = 0;
+        root->Draw(drawingSession.Get());
+        Assert::AreEqual(2, f.CommandListCount);
+
+        // Nothing changed, so nothing is recorded.
+        f.CommandListCount = 0;
+        root->Draw(drawingSession.Get());
+        Assert::AreEqual(0, f.CommandListCount);
+
+        // Moving a node records its parent again, but not the node itself.
+        f.CommandListCount = 0;
+        ThrowIfFailed(branch->put_Transform(Numerics::Matrix3x2{ 1, 0, 0, 1, 10, 0 }));
+        root->Draw(drawingSession.Get());
+        Assert::AreEqual(1, f.CommandListCount);
+
+        // Changing something deeper down records every node above it.
+        f.CommandListCount = 0;
+        ThrowIfFailed(leaf2->put_Opacity(0.5f));
+        root->Draw(drawingSession.Get());
+        Assert::AreEqual(2, f.CommandListCount);
+
+        // As does changing the list of children.
+        f.CommandListCount = 0;
+        ThrowIfFailed(children->Clear());
+        root->Draw(drawingSession.Get());
+        Assert::AreEqual(1, f.CommandListCount);
+
+        // Drawing a subtree on its own doesn't record anything that is already up to date.
+        f.CommandListCount = 0;
+        branch->Draw(drawingSession.Get());
+        Assert::AreEqual(0, f.CommandListCount);
+    }
+
+    TEST_METHOD_EX(CanvasRenderNode_Draw_WhenNodeIsItsOwnDescendant_Fails)
+    {
+        Fixture f;
+
+        auto parent = f.CreateNode();
+        auto child = f.CreateNode();
+
+        ComPtr<IVector<CanvasRenderNode*>> children;
+        ThrowIfFailed(parent->get_Children(&children));
+        ThrowIfFailed(children->Append(child.Get()));
+
+        ThrowIfFailed(child->get_Children(&children));
+        ThrowIfFailed(children->Append(parent.Get()));
+
+        auto drawingSession = Make<RecordingDrawingSession>();
+
+        ExpectHResultException(E_INVALIDARG, [&] { parent->Draw(drawingSession.Get()); });
+
+        // Break the cycle so the nodes can be released.
+        ThrowIfFailed(children->Clear());
+    }
+};
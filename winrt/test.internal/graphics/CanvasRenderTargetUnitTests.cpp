@@ -216,4 +216,58 @@ TEST_CLASS(CanvasRenderTargetTests)
         Assert::AreEqual(static_cast<uint32_t>(expectedSize.Width), retrievedBitmapSize.Width);
         Assert::AreEqual(static_cast<uint32_t>(expectedSize.Height), retrievedBitmapSize.Height);
     }
+
+    TEST_METHOD_EX(CanvasRenderTarget_SharedAccess_FailsWhenNotShared)
+    {
+        Fixture f;
+        auto renderTarget = f.CreateRenderTarget();
+
+        uint64_t sharedHandle;
+        boolean acquired;
+
+        Assert::AreEqual(E_INVALIDARG, renderTarget->CreateSharedHandle(&sharedHandle));
+        Assert::AreEqual(E_INVALIDARG, renderTarget->AcquireSharedAccess(0, 0, &acquired));
+        Assert::AreEqual(E_INVALIDARG, renderTarget->ReleaseSharedAccess(0));
+
+        ValidateStoredErrorState(E_INVALIDARG, Strings::RenderTargetNotShared);
+    }
+
+    TEST_METHOD_EX(CanvasRenderTarget_SharedAccess_NullArgs)
+    {
+        Fixture f;
+        auto renderTarget = f.CreateRenderTarget();
+
+        Assert::AreEqual(E_INVALIDARG, renderTarget->CreateSharedHandle(nullptr));
+        Assert::AreEqual(E_INVALIDARG, renderTarget->AcquireSharedAccess(0, 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasRenderTarget_SharedAccess_Closed)
+    {
+        Fixture f;
+        auto renderTarget = f.CreateRenderTarget();
+
+        ThrowIfFailed(As<IClosable>(renderTarget)->Close());
+
+        uint64_t sharedHandle;
+        boolean acquired;
+
+        Assert::AreEqual(RO_E_CLOSED, renderTarget->CreateSharedHandle(&sharedHandle));
+        Assert::AreEqual(RO_E_CLOSED, renderTarget->AcquireSharedAccess(0, 0, &acquired));
+        Assert::AreEqual(RO_E_CLOSED, renderTarget->ReleaseSharedAccess(0));
+    }
+
+    TEST_METHOD_EX(CanvasRenderTarget_CreateAndOpenShared_NullArgs)
+    {
+        auto factory = Make<CanvasRenderTargetFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(Make<StubCanvasDevice>());
+
+        ComPtr<ICanvasRenderTarget> renderTarget;
+
+        Assert::AreEqual(E_INVALIDARG, factory->CreateShared(nullptr, 1, 1, DEFAULT_DPI, PIXEL_FORMAT(B8G8R8A8UIntNormalized), CanvasAlphaMode::Premultiplied, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateShared(resourceCreator.Get(), 1, 1, DEFAULT_DPI, PIXEL_FORMAT(B8G8R8A8UIntNormalized), CanvasAlphaMode::Premultiplied, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->OpenShared(nullptr, 1, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->OpenShared(resourceCreator.Get(), 0, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->OpenShared(resourceCreator.Get(), 1, DEFAULT_DPI, CanvasAlphaMode::Premultiplied, nullptr));
+    }
 };
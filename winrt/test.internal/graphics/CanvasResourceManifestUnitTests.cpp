@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/drawing/CanvasResourceManifest.h>
+#include "mocks/MockD2DGeometrySink.h"
+#include "mocks/MockD2DPathGeometry.h"
+#include "mocks/MockGeometryAdapter.h"
+
+TEST_CLASS(CanvasResourceManifestUnitTests)
+{
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        std::shared_ptr<MockGeometryAdapter> Adapter;
+        ComPtr<CanvasResourceManifest> Manifest;
+        uint8_t Bytes[4];
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , Adapter(std::make_shared<MockGeometryAdapter>())
+            , Manifest(Make<CanvasResourceManifest>())
+            , Bytes{}
+        {
+            GeometryAdapter::SetInstance(Adapter);
+
+            Adapter->CreatePathGeometryMethod.AllowAnyCall(
+                []
+                {
+                    auto pathGeometry = Make<MockD2DPathGeometry>();
+
+                    pathGeometry->OpenMethod.AllowAnyCall(
+                        [](ID2D1GeometrySink** out)
+                        {
+                            auto geometrySink = Make<MockD2DGeometrySink>();
+                            geometrySink->CloseMethod.AllowAnyCall();
+                            return geometrySink.CopyTo(out);
+                        });
+
+                    return pathGeometry;
+                });
+        }
+
+        void AddBitmap(wchar_t const* key)
+        {
+            ThrowIfFailed(Manifest->AddBitmapFromBytes(
+                HStringReference(key).Get(),
+                _countof(Bytes),
+                Bytes,
+                1,
+                1,
+                PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                DEFAULT_DPI,
+                CanvasAlphaMode::Premultiplied));
+        }
+
+        void AddGeometry(wchar_t const* key)
+        {
+            auto d2dGeometry = Make<MockD2DPathGeometry>();
+            d2dGeometry->StreamMethod.AllowAnyCall();
+
+            auto geometry = Make<CanvasGeometry>(Device.Get(), d2dGeometry.Get());
+
+            ThrowIfFailed(Manifest->AddGeometry(HStringReference(key).Get(), geometry.Get()));
+        }
+
+        int32_t GetCount()
+        {
+            int32_t count;
+            ThrowIfFailed(Manifest->get_Count(&count));
+            return count;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasResourceManifest_InvalidArguments)
+    {
+        Fixture f;
+
+        HStringReference key(L"key");
+        boolean wasRemoved;
+        ComPtr<ICanvasBitmap> bitmap;
+
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->AddBitmapFromFile(nullptr, HStringReference(L"file.png").Get(), DEFAULT_DPI, CanvasAlphaMode::Premultiplied));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->AddBitmapFromFile(key.Get(), nullptr, DEFAULT_DPI, CanvasAlphaMode::Premultiplied));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->AddBitmapFromBytes(key.Get(), 4, nullptr, 1, 1, PIXEL_FORMAT(B8G8R8A8UIntNormalized), DEFAULT_DPI, CanvasAlphaMode::Premultiplied));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->AddGeometry(key.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->Remove(key.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->Remove(nullptr, &wasRemoved));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->get_Count(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->GetBitmap(key.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->LoadAsync(nullptr, nullptr));
+
+        Assert::AreEqual(0, f.GetCount());
+    }
+
+    TEST_METHOD_EX(CanvasResourceManifest_AddingAnExistingKey_ReplacesItsEntry)
+    {
+        Fixture f;
+
+        f.AddBitmap(L"a");
+        f.AddBitmap(L"b");
+        f.AddBitmap(L"a");
+
+        Assert::AreEqual(2, f.GetCount());
+
+        boolean wasRemoved;
+
+        ThrowIfFailed(f.Manifest->Remove(HStringReference(L"a").Get(), &wasRemoved));
+        Assert::IsTrue(!!wasRemoved);
+
+        ThrowIfFailed(f.Manifest->Remove(HStringReference(L"a").Get(), &wasRemoved));
+        Assert::IsFalse(!!wasRemoved);
+
+        Assert::AreEqual(1, f.GetCount());
+    }
+
+    TEST_METHOD_EX(CanvasResourceManifest_GetBeforeLoad_Fails)
+    {
+        Fixture f;
+
+        f.AddBitmap(L"bitmap");
+
+        ComPtr<ICanvasBitmap> bitmap;
+        ComPtr<ICanvasGeometry> geometry;
+
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, f.Manifest->GetBitmap(HStringReference(L"bitmap").Get(), &bitmap));
+        ValidateStoredErrorState(E_ILLEGAL_METHOD_CALL, Strings::ResourceManifestNotLoaded);
+
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->GetGeometry(HStringReference(L"bitmap").Get(), &geometry));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::ResourceManifestWrongType);
+
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->GetBitmap(HStringReference(L"missing").Get(), &bitmap));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::ResourceManifestKeyNotFound);
+    }
+
+    TEST_METHOD_EX(CanvasResourceManifest_AddGeometry_RecordsItsPath)
+    {
+        Fixture f;
+
+        auto d2dGeometry = Make<MockD2DPathGeometry>();
+        auto geometry = Make<CanvasGeometry>(f.Device.Get(), d2dGeometry.Get());
+
+        auto recordingSink = Make<MockD2DGeometrySink>();
+        auto recordedGeometry = Make<MockD2DPathGeometry>();
+
+        f.Adapter->CreatePathGeometryMethod.SetExpectedCalls(1, [=] { return recordedGeometry; });
+        recordedGeometry->OpenMethod.SetExpectedCalls(1, [=](ID2D1GeometrySink** out) { return recordingSink.CopyTo(out); });
+
+        d2dGeometry->StreamMethod.SetExpectedCalls(1,
+            [=](ID2D1GeometrySink* sink)
+            {
+                Assert::IsTrue(IsSameInstance(recordingSink.Get(), sink));
+                return S_OK;
+            });
+
+        recordingSink->CloseMethod.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.Manifest->AddGeometry(HStringReference(L"geometry").Get(), geometry.Get()));
+
+        Assert::AreEqual(1, f.GetCount());
+    }
+
+    TEST_METHOD_EX(CanvasResourceManifest_CachedGeometries_MustReferToAGeometry)
+    {
+        Fixture f;
+
+        f.AddBitmap(L"bitmap");
+        f.AddGeometry(L"geometry");
+
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->AddCachedFill(HStringReference(L"fill").Get(), HStringReference(L"missing").Get(), D2D1_DEFAULT_FLATTENING_TOLERANCE));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::ResourceManifestUnknownGeometryKey);
+
+        Assert::AreEqual(E_INVALIDARG, f.Manifest->AddCachedStroke(HStringReference(L"stroke").Get(), HStringReference(L"bitmap").Get(), 1, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::ResourceManifestUnknownGeometryKey);
+
+        ThrowIfFailed(f.Manifest->AddCachedFill(HStringReference(L"fill").Get(), HStringReference(L"geometry").Get(), D2D1_DEFAULT_FLATTENING_TOLERANCE));
+        ThrowIfFailed(f.Manifest->AddCachedStroke(HStringReference(L"stroke").Get(), HStringReference(L"geometry").Get(), 1, nullptr, D2D1_DEFAULT_FLATTENING_TOLERANCE));
+
+        Assert::AreEqual(4, f.GetCount());
+    }
+};
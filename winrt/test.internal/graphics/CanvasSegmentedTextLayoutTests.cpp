@@ -0,0 +1,493 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/text/CanvasSegmentedTextLayout.h>
+
+#include "stubs/StubCanvasTextLayoutAdapter.h"
+
+static const float LineHeight = 10.0f;
+static const float CharacterWidth = 5.0f;
+
+TEST_CLASS(CanvasSegmentedTextLayoutTests)
+{
+    struct Fixture
+    {
+        std::shared_ptr<StubCanvasTextLayoutAdapter> Adapter;
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<ICanvasTextFormat> Format;
+        ComPtr<CanvasSegmentedTextLayoutFactory> Factory;
+
+        std::vector<std::wstring> LaidOutText;
+        std::vector<float> LaidOutWidths;
+
+        Fixture()
+            : Adapter(std::make_shared<StubCanvasTextLayoutAdapter>())
+            , Device(Make<StubCanvasDevice>())
+            , Factory(Make<CanvasSegmentedTextLayoutFactory>())
+        {
+            CustomFontManagerAdapter::SetInstance(Adapter);
+
+            Format = Make<CanvasTextFormat>();
+
+            // Every paragraph is one line, with fixed width characters.
+            Adapter->GetMockDWriteFactory()->CreateTextLayoutMethod.AllowAnyCall(
+                [this](WCHAR const* text, UINT32 textLength, IDWriteTextFormat*, FLOAT maxWidth, FLOAT maxHeight, IDWriteTextLayout** value)
+                {
+                    Assert::AreEqual(0.0f, maxHeight);
+
+                    LaidOutText.push_back(std::wstring(text, textLength));
+                    LaidOutWidths.push_back(maxWidth);
+
+                    auto layout = Make<StubTextLayout>();
+
+                    layout->GetMetricsMethod.AllowAnyCall(
+                        [](DWRITE_TEXT_METRICS1* metrics)
+                        {
+                            *metrics = DWRITE_TEXT_METRICS1{};
+                            metrics->height = LineHeight;
+                            return S_OK;
+                        });
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+                    auto& lineMetricsMethod = layout->GetLineMetricsMethod1;
+#else
+                    auto& lineMetricsMethod = layout->GetLineMetricsMethod;
+#endif
+                    lineMetricsMethod.AllowAnyCall(
+                        [textLength](DWriteMetricsType* lineMetrics, UINT32 maxLineCount, UINT32* actualLineCount)
+                        {
+                            *actualLineCount = 1;
+
+                            if (maxLineCount < 1)
+                                return E_NOT_SUFFICIENT_BUFFER;
+
+                            lineMetrics[0] = DWriteMetricsType{};
+                            lineMetrics[0].length = textLength;
+                            lineMetrics[0].height = LineHeight;
+                            return S_OK;
+                        });
+
+                    layout->HitTestPointMethod.AllowAnyCall(
+                        [textLength](FLOAT x, FLOAT y, BOOL* isTrailingHit, BOOL* isInside, DWRITE_HIT_TEST_METRICS* metrics)
+                        {
+                            *metrics = DWRITE_HIT_TEST_METRICS{};
+                            metrics->textPosition = std::min(static_cast<uint32_t>(x / CharacterWidth), textLength);
+                            metrics->length = 1;
+                            metrics->left = metrics->textPosition * CharacterWidth;
+                            metrics->width = CharacterWidth;
+                            metrics->height = LineHeight;
+
+                            *isTrailingHit = FALSE;
+                            *isInside = y >= 0 && y < LineHeight;
+                            return S_OK;
+                        });
+
+                    layout->HitTestTextPositionMethod.AllowAnyCall(
+                        [](UINT32 textPosition, BOOL isTrailingHit, FLOAT* x, FLOAT* y, DWRITE_HIT_TEST_METRICS* metrics)
+                        {
+                            *x = (textPosition + (isTrailingHit ? 1 : 0)) * CharacterWidth;
+                            *y = 0;
+                            *metrics = DWRITE_HIT_TEST_METRICS{};
+                            return S_OK;
+                        });
+
+                    layout->HitTestTextRangeMethod.AllowAnyCall(
+                        [](UINT32 textPosition, UINT32 textLength, FLOAT, FLOAT, DWRITE_HIT_TEST_METRICS* metrics, UINT32 maxMetricsCount, UINT32* actualMetricsCount)
+                        {
+                            *actualMetricsCount = 1;
+
+                            if (maxMetricsCount < 1)
+                                return E_NOT_SUFFICIENT_BUFFER;
+
+                            metrics[0] = DWRITE_HIT_TEST_METRICS{};
+                            metrics[0].textPosition = textPosition;
+                            metrics[0].length = textLength;
+                            metrics[0].left = textPosition * CharacterWidth;
+                            metrics[0].width = textLength * CharacterWidth;
+                            metrics[0].height = LineHeight;
+                            return S_OK;
+                        });
+
+                    return layout.CopyTo(value);
+                });
+        }
+
+        ComPtr<ICanvasSegmentedTextLayout> Create(wchar_t const* text)
+        {
+            ComPtr<ICanvasSegmentedTextLayout> layout;
+            Assert::AreEqual(S_OK, Factory->Create(Device.Get(), WinString(text), Format.Get(), 100.0f, &layout));
+            return layout;
+        }
+
+        // Lays out whatever hasn't been laid out yet.
+        void LayOut(ComPtr<ICanvasSegmentedTextLayout> const& layout)
+        {
+            float height;
+            ThrowIfFailed(layout->get_LayoutHeight(&height));
+        }
+    };
+
+    static std::vector<int32_t> GetParagraphStarts(ComPtr<ICanvasSegmentedTextLayout> const& layout)
+    {
+        uint32_t paragraphCount;
+        Assert::AreEqual(S_OK, layout->get_ParagraphCount(&paragraphCount));
+
+        std::vector<int32_t> starts(paragraphCount);
+
+        for (uint32_t i = 0; i < paragraphCount; i++)
+        {
+            Assert::AreEqual(S_OK, layout->GetParagraphCharacterIndex(i, &starts[i]));
+        }
+
+        return starts;
+    }
+
+    static std::wstring GetText(ComPtr<ICanvasSegmentedTextLayout> const& layout)
+    {
+        WinString text;
+        Assert::AreEqual(S_OK, layout->get_Text(text.GetAddressOf()));
+
+        uint32_t length;
+        auto buffer = WindowsGetStringRawBuffer(text, &length);
+        return std::wstring(buffer, length);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ImplementsExpectedInterfaces)
+    {
+        Fixture f;
+        auto layout = f.Create(L"");
+
+        ASSERT_IMPLEMENTS_INTERFACE(layout, ICanvasSegmentedTextLayout);
+        ASSERT_IMPLEMENTS_INTERFACE(layout, ICanvasResourceCreator);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_Create_NullArgs)
+    {
+        Fixture f;
+        ComPtr<ICanvasSegmentedTextLayout> layout;
+
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(nullptr, WinString(L"a"), f.Format.Get(), 0, &layout));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(f.Device.Get(), WinString(L"a"), nullptr, 0, &layout));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(f.Device.Get(), WinString(L"a"), f.Format.Get(), 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_NullArgs)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a");
+
+        CanvasTextLayoutRegion region;
+        boolean trailing;
+        boolean isHit;
+        uint32_t count;
+        CanvasLineMetrics* lineMetrics;
+        CanvasTextLayoutRegion* regions;
+
+        Assert::AreEqual(E_INVALIDARG, layout->get_Text(nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->get_RequestedWidth(nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->get_ParagraphCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->get_LayoutHeight(nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->GetParagraphLayout(0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->GetParagraphCharacterIndex(0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->GetParagraphTop(0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->GetParagraphIndexAtCharacter(0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->get_LineMetrics(nullptr, &lineMetrics));
+        Assert::AreEqual(E_INVALIDARG, layout->get_LineMetrics(&count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->HitTest(Vector2{}, nullptr, &trailing, &isHit));
+        Assert::AreEqual(E_INVALIDARG, layout->HitTest(Vector2{}, &region, nullptr, &isHit));
+        Assert::AreEqual(E_INVALIDARG, layout->HitTest(Vector2{}, &region, &trailing, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->GetCaretPosition(0, false, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->GetCharacterRegions(0, 1, nullptr, &regions));
+        Assert::AreEqual(E_INVALIDARG, layout->GetCharacterRegions(0, 1, &count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->get_Device(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_SplitsAfterEachKindOfNewline)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a\nb\r\nc\rd\x2029" L"e\x0085" L"f");
+
+        Assert::IsTrue(std::vector<int32_t>{ 0, 2, 5, 7, 9, 11 } == GetParagraphStarts(layout));
+
+        f.LayOut(layout);
+
+        Assert::IsTrue(std::vector<std::wstring>{ L"a", L"b", L"c", L"d", L"e", L"f" } == f.LaidOutText);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_TrailingNewline_IsFollowedByEmptyParagraph)
+    {
+        Fixture f;
+        auto layout = f.Create(L"abc\n");
+
+        Assert::IsTrue(std::vector<int32_t>{ 0, 4 } == GetParagraphStarts(layout));
+
+        float height;
+        Assert::AreEqual(S_OK, layout->get_LayoutHeight(&height));
+        Assert::AreEqual(2 * LineHeight, height);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_EmptyText_HasOneParagraph)
+    {
+        Fixture f;
+        auto layout = f.Create(L"");
+
+        Assert::IsTrue(std::vector<int32_t>{ 0 } == GetParagraphStarts(layout));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ParagraphsAreLaidOutWhenNeeded)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a\nb\nc");
+
+        Assert::AreEqual<size_t>(0, f.LaidOutText.size());
+
+        ComPtr<ICanvasTextLayout> paragraphLayout;
+        Assert::AreEqual(S_OK, layout->GetParagraphLayout(1, &paragraphLayout));
+        Assert::IsTrue(std::vector<std::wstring>{ L"b" } == f.LaidOutText);
+
+        ComPtr<ICanvasTextLayout> sameParagraphLayout;
+        Assert::AreEqual(S_OK, layout->GetParagraphLayout(1, &sameParagraphLayout));
+        Assert::IsTrue(IsSameInstance(paragraphLayout.Get(), sameParagraphLayout.Get()));
+
+        float top;
+        Assert::AreEqual(S_OK, layout->GetParagraphTop(2, &top));
+        Assert::AreEqual(2 * LineHeight, top);
+        Assert::IsTrue(std::vector<std::wstring>{ L"b", L"a", L"c" } == f.LaidOutText);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ParagraphIndexOutOfRange)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a\nb");
+
+        ComPtr<ICanvasTextLayout> paragraphLayout;
+        int32_t characterIndex;
+        float top;
+
+        Assert::AreEqual(E_BOUNDS, layout->GetParagraphLayout(2, &paragraphLayout));
+        Assert::AreEqual(E_BOUNDS, layout->GetParagraphCharacterIndex(2, &characterIndex));
+        Assert::AreEqual(E_BOUNDS, layout->GetParagraphTop(2, &top));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_GetParagraphIndexAtCharacter)
+    {
+        Fixture f;
+        auto layout = f.Create(L"ab\r\ncd");
+
+        uint32_t expectedParagraphs[] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+        for (int32_t i = 0; i < static_cast<int32_t>(_countof(expectedParagraphs)); i++)
+        {
+            uint32_t paragraphIndex;
+            Assert::AreEqual(S_OK, layout->GetParagraphIndexAtCharacter(i, &paragraphIndex));
+            Assert::AreEqual(expectedParagraphs[i], paragraphIndex);
+        }
+
+        uint32_t paragraphIndex;
+        Assert::AreEqual(E_INVALIDARG, layout->GetParagraphIndexAtCharacter(-1, &paragraphIndex));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ReplaceText_OnlyLaysOutEditedParagraph)
+    {
+        Fixture f;
+        auto layout = f.Create(L"one\ntwo\nthree");
+        f.LayOut(layout);
+
+        ComPtr<ICanvasTextLayout> untouchedLayout;
+        Assert::AreEqual(S_OK, layout->GetParagraphLayout(2, &untouchedLayout));
+
+        f.LaidOutText.clear();
+
+        Assert::AreEqual(S_OK, layout->ReplaceText(5, 1, WinString(L"WW")));
+        f.LayOut(layout);
+
+        Assert::AreEqual(L"one\ntWWo\nthree", GetText(layout).c_str());
+        Assert::IsTrue(std::vector<std::wstring>{ L"tWWo" } == f.LaidOutText);
+        Assert::IsTrue(std::vector<int32_t>{ 0, 4, 9 } == GetParagraphStarts(layout));
+
+        ComPtr<ICanvasTextLayout> laterLayout;
+        Assert::AreEqual(S_OK, layout->GetParagraphLayout(2, &laterLayout));
+        Assert::IsTrue(IsSameInstance(untouchedLayout.Get(), laterLayout.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ReplaceText_InsertingNewline_SplitsParagraph)
+    {
+        Fixture f;
+        auto layout = f.Create(L"one\ntwo");
+        f.LayOut(layout);
+        f.LaidOutText.clear();
+
+        Assert::AreEqual(S_OK, layout->ReplaceText(1, 0, WinString(L"\n")));
+        f.LayOut(layout);
+
+        Assert::AreEqual(L"o\nne\ntwo", GetText(layout).c_str());
+        Assert::IsTrue(std::vector<int32_t>{ 0, 2, 5 } == GetParagraphStarts(layout));
+        Assert::IsTrue(std::vector<std::wstring>{ L"o", L"ne" } == f.LaidOutText);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ReplaceText_DeletingNewline_JoinsParagraphs)
+    {
+        Fixture f;
+        auto layout = f.Create(L"one\ntwo\nthree");
+        f.LayOut(layout);
+        f.LaidOutText.clear();
+
+        Assert::AreEqual(S_OK, layout->ReplaceText(3, 1, nullptr));
+        f.LayOut(layout);
+
+        Assert::AreEqual(L"onetwo\nthree", GetText(layout).c_str());
+        Assert::IsTrue(std::vector<int32_t>{ 0, 7 } == GetParagraphStarts(layout));
+        Assert::IsTrue(std::vector<std::wstring>{ L"onetwo" } == f.LaidOutText);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ReplaceText_LineFeedAfterLoneCarriageReturn_MakesCrLf)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a\rb");
+
+        Assert::AreEqual(S_OK, layout->ReplaceText(2, 0, WinString(L"\n")));
+
+        Assert::IsTrue(std::vector<int32_t>{ 0, 3 } == GetParagraphStarts(layout));
+
+        uint32_t lineCount;
+        CanvasLineMetrics* lineMetrics;
+        Assert::AreEqual(S_OK, layout->get_LineMetrics(&lineCount, &lineMetrics));
+        Assert::AreEqual(2u, lineCount);
+        Assert::AreEqual(2, lineMetrics[0].TerminalNewlineCount);
+        CoTaskMemFree(lineMetrics);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ReplaceText_AtEnd)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a\n");
+
+        Assert::AreEqual(S_OK, layout->ReplaceText(2, 0, WinString(L"b\nc")));
+
+        Assert::AreEqual(L"a\nb\nc", GetText(layout).c_str());
+        Assert::IsTrue(std::vector<int32_t>{ 0, 2, 4 } == GetParagraphStarts(layout));
+
+        Assert::AreEqual(S_OK, layout->ReplaceText(0, 5, nullptr));
+
+        Assert::AreEqual(L"", GetText(layout).c_str());
+        Assert::IsTrue(std::vector<int32_t>{ 0 } == GetParagraphStarts(layout));
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_ReplaceText_InvalidRange)
+    {
+        Fixture f;
+        auto layout = f.Create(L"abc");
+
+        Assert::AreEqual(E_INVALIDARG, layout->ReplaceText(-1, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->ReplaceText(0, -1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->ReplaceText(4, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, layout->ReplaceText(2, 2, nullptr));
+
+        Assert::AreEqual(L"abc", GetText(layout).c_str());
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_RequestedWidth_LaysOutEveryParagraphAgain)
+    {
+        Fixture f;
+        auto layout = f.Create(L"a\nb");
+        f.LayOut(layout);
+
+        Assert::AreEqual(S_OK, layout->put_RequestedWidth(100.0f));
+        f.LayOut(layout);
+        Assert::AreEqual<size_t>(2, f.LaidOutText.size());
+
+        Assert::AreEqual(S_OK, layout->put_RequestedWidth(50.0f));
+        f.LayOut(layout);
+        Assert::IsTrue(std::vector<float>{ 100.0f, 100.0f, 50.0f, 50.0f } == f.LaidOutWidths);
+
+        float width;
+        Assert::AreEqual(S_OK, layout->get_RequestedWidth(&width));
+        Assert::AreEqual(50.0f, width);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_LineMetrics_IncludeNewlines)
+    {
+        Fixture f;
+        auto layout = f.Create(L"ab\r\ncd");
+
+        uint32_t lineCount;
+        CanvasLineMetrics* lineMetrics;
+        Assert::AreEqual(S_OK, layout->get_LineMetrics(&lineCount, &lineMetrics));
+
+        Assert::AreEqual(2u, lineCount);
+        Assert::AreEqual(4, lineMetrics[0].CharacterCount);
+        Assert::AreEqual(2, lineMetrics[0].TerminalNewlineCount);
+        Assert::AreEqual(2, lineMetrics[1].CharacterCount);
+        Assert::AreEqual(0, lineMetrics[1].TerminalNewlineCount);
+
+        CoTaskMemFree(lineMetrics);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_HitTest_UsesParagraphAtPoint)
+    {
+        Fixture f;
+        auto layout = f.Create(L"ab\ncd\nef");
+
+        CanvasTextLayoutRegion region;
+        boolean trailing;
+        boolean isHit;
+        Assert::AreEqual(S_OK, layout->HitTest(Vector2{ CharacterWidth, LineHeight * 1.5f }, &region, &trailing, &isHit));
+
+        Assert::IsTrue(!!isHit);
+        Assert::AreEqual(4, region.CharacterIndex);
+        Assert::AreEqual(LineHeight, region.LayoutBounds.Y);
+
+        // Below the document goes to the last paragraph.
+        Assert::AreEqual(S_OK, layout->HitTest(Vector2{ 0, LineHeight * 10 }, &region, &trailing, &isHit));
+
+        Assert::IsFalse(!!isHit);
+        Assert::AreEqual(6, region.CharacterIndex);
+        Assert::AreEqual(2 * LineHeight, region.LayoutBounds.Y);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_GetCaretPosition)
+    {
+        Fixture f;
+        auto layout = f.Create(L"ab\ncd");
+
+        Vector2 location;
+
+        Assert::AreEqual(S_OK, layout->GetCaretPosition(4, false, &location));
+        Assert::AreEqual(CharacterWidth, location.X);
+        Assert::AreEqual(LineHeight, location.Y);
+
+        // On the newline, the caret goes at the end of the first paragraph's text.
+        Assert::AreEqual(S_OK, layout->GetCaretPosition(2, true, &location));
+        Assert::AreEqual(2 * CharacterWidth, location.X);
+        Assert::AreEqual(0.0f, location.Y);
+    }
+
+    TEST_METHOD_EX(CanvasSegmentedTextLayout_GetCharacterRegions_SpansParagraphs)
+    {
+        Fixture f;
+        auto layout = f.Create(L"ab\ncd\nef");
+
+        uint32_t regionCount;
+        CanvasTextLayoutRegion* regions;
+        Assert::AreEqual(S_OK, layout->GetCharacterRegions(1, 6, &regionCount, &regions));
+
+        Assert::AreEqual(3u, regionCount);
+
+        Assert::AreEqual(1, regions[0].CharacterIndex);
+        Assert::AreEqual(1, regions[0].CharacterCount);
+        Assert::AreEqual(0.0f, regions[0].LayoutBounds.Y);
+
+        Assert::AreEqual(3, regions[1].CharacterIndex);
+        Assert::AreEqual(2, regions[1].CharacterCount);
+        Assert::AreEqual(LineHeight, regions[1].LayoutBounds.Y);
+
+        Assert::AreEqual(6, regions[2].CharacterIndex);
+        Assert::AreEqual(1, regions[2].CharacterCount);
+        Assert::AreEqual(2 * LineHeight, regions[2].LayoutBounds.Y);
+
+        CoTaskMemFree(regions);
+    }
+};
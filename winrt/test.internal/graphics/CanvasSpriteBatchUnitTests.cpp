@@ -687,6 +687,8 @@ public:
         Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawFromSpriteSheetToRectWithTintAndFlip(nullptr, destRect, sourceRect, tint, flip)); 
         Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawFromSpriteSheetWithTransformAndTintAndFlip(nullptr, transform, sourceRect, tint, flip)); 
         Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawFromSpriteSheetAtOffsetWithTintAndTransform(nullptr, offset, sourceRect, tint, origin, rotation, scale, flip)); 
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesToRects(nullptr, 1, &destRect, 1, &sourceRect, 1, &tint));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesWithTransforms(nullptr, 1, &transform, 1, &sourceRect, 1, &tint));
     }
 
 
@@ -725,6 +727,8 @@ public:
         Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawFromSpriteSheetToRectWithTintAndFlip(bitmap, destRect, sourceRect, tint, flip)); 
         Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawFromSpriteSheetWithTransformAndTintAndFlip(bitmap, transform, sourceRect, tint, flip)); 
         Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawFromSpriteSheetAtOffsetWithTintAndTransform(bitmap, offset, sourceRect, tint, origin, rotation, scale, flip));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawSpritesToRects(bitmap, 1, &destRect, 1, &sourceRect, 1, &tint));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawSpritesWithTransforms(bitmap, 1, &transform, 1, &sourceRect, 1, &tint));
 
         ComPtr<ICanvasDevice> device;
         Assert::AreEqual(RO_E_CLOSED, As<ICanvasResourceCreator>(f.SpriteBatch)->get_Device(&device));
@@ -1176,6 +1180,121 @@ public:
     }
 
     
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawSpritesToRects)
+    {
+        DrawFixture f;
+
+        ThrowIfFailed(f.SpriteBatch->DrawSpritesToRects(f.Bitmap.Get(), _countof(gRects), gRects, 0, nullptr, 1, &gAnyTint));
+
+        for (auto rect : gRects)
+        {
+            f.ExpectSprite(
+                ToD2DRect(rect),
+                f.FullBitmapSourceRect(),
+                *ReinterpretAs<D2D1_COLOR_F*>(&gAnyTint));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawSpritesToRects_WithPerSpriteSourceRectsAndTints)
+    {
+        DrawFixture f;
+
+        Rect sourceRects[] =
+        {
+            Rect{ 0.0f, 0.0f, 10.0f, 10.0f },
+            Rect{ 10.0f, 20.0f, 30.0f, 40.0f },
+            Rect{ 50.0f, 50.0f, 5.0f, 5.0f }
+        };
+
+        static_assert(_countof(sourceRects) == _countof(gRects), "arrays should be the same size");
+        static_assert(_countof(gTints) == _countof(gRects), "arrays should be the same size");
+
+        ThrowIfFailed(f.SpriteBatch->DrawSpritesToRects(f.Bitmap.Get(), _countof(gRects), gRects, _countof(sourceRects), sourceRects, _countof(gTints), gTints));
+
+        for (size_t i = 0; i < _countof(gRects); ++i)
+        {
+            auto& s = sourceRects[i];
+
+            // The fixture's bitmap is at 2x DPI
+            f.ExpectSprite(
+                ToD2DRect(gRects[i]),
+                D2D1_RECT_U{ static_cast<uint32_t>(s.X * 2), static_cast<uint32_t>(s.Y * 2), static_cast<uint32_t>((s.X + s.Width) * 2), static_cast<uint32_t>((s.Y + s.Height) * 2) },
+                *ReinterpretAs<D2D1_COLOR_F*>(&gTints[i]));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawSpritesWithTransforms)
+    {
+        DrawFixture f;
+
+        ThrowIfFailed(f.SpriteBatch->DrawSpritesWithTransforms(f.Bitmap.Get(), _countof(gMatrices), gMatrices, 0, nullptr, 0, nullptr));
+
+        for (auto matrix : gMatrices)
+        {
+            f.ExpectSprite(
+                f.FullBitmapDestRect(float2::zero()),
+                f.FullBitmapSourceRect(),
+                D2D1_COLOR_F{ 1.0f, 1.0f, 1.0f, 1.0f },
+                *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&matrix));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawSpritesWithTransforms_WithSharedSourceRect)
+    {
+        DrawFixture f;
+
+        auto width = 30.0f;
+        auto height = 40.0f;
+        Rect sourceRect{ 10.0f, 20.0f, width, height };
+
+        ThrowIfFailed(f.SpriteBatch->DrawSpritesWithTransforms(f.Bitmap.Get(), _countof(gMatrices), gMatrices, 1, &sourceRect, 1, &gAnyTint));
+
+        for (auto matrix : gMatrices)
+        {
+            f.ExpectSprite(
+                D2D1_RECT_F{ 0.0f, 0.0f, width, height },
+                D2D1_RECT_U{ 20, 40, static_cast<uint32_t>(20 + width * 2), static_cast<uint32_t>(40 + height * 2) },
+                *ReinterpretAs<D2D1_COLOR_F*>(&gAnyTint),
+                *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&matrix));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawSprites_InvalidArgs)
+    {
+        DrawFixture f;
+
+        auto bitmap = f.Bitmap.Get();
+        Rect rects[2]{};
+        Matrix3x2 transforms[2]{};
+        Vector4 tints[3]{};
+
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesToRects(nullptr, 2, rects, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesToRects(bitmap, 2, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesToRects(bitmap, 2, rects, 1, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesToRects(bitmap, 2, rects, 0, nullptr, 3, tints));
+
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesWithTransforms(nullptr, 2, transforms, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesWithTransforms(bitmap, 2, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesWithTransforms(bitmap, 2, transforms, 3, rects, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawSpritesWithTransforms(bitmap, 2, transforms, 0, nullptr, 1, nullptr));
+
+        // Nothing was added, so nothing should be drawn
+        ThrowIfFailed(As<IClosable>(f.SpriteBatch)->Close());
+    }
+
+
     TEST_METHOD_EX(CanvasSpriteBatch_DrawFromSpriteSheet_NegativeCoordinatesAreClamped)
     {
         DrawFixture f;
@@ -1522,6 +1641,40 @@ public:
         f.Validate();
     }
 
+    TEST_METHOD_EX(CanvasSpriteBatch_WhenSorted_ManyInterleavedSprites_AreGroupedByBitmapAndOtherwiseInOrder)
+    {
+        MultipleBitmapFixture f(CanvasSpriteSortMode::Bitmap);
+
+        std::sort(f.Bitmaps.begin(), f.Bitmaps.end());
+
+        // Add the bitmaps in reverse order, so the sort has something to do
+        int const spritesPerBitmap = 100;
+        int const bitmapCount = static_cast<int>(f.Bitmaps.size());
+
+        for (int i = 0; i < spritesPerBitmap * bitmapCount; ++i)
+        {
+            f.Add(f.Bitmaps[bitmapCount - 1 - (i % bitmapCount)], static_cast<float>(i));
+        }
+
+        for (int bitmap = 0; bitmap < bitmapCount; ++bitmap)
+        {
+            for (int j = 0; j < spritesPerBitmap; ++j)
+            {
+                f.Expect(static_cast<float>(j * bitmapCount + (bitmapCount - 1 - bitmap)));
+            }
+        }
+
+        f.ExpectBatches(
+        {
+            { f.Bitmaps[0], 0 * spritesPerBitmap, spritesPerBitmap },
+            { f.Bitmaps[1], 1 * spritesPerBitmap, spritesPerBitmap },
+            { f.Bitmaps[2], 2 * spritesPerBitmap, spritesPerBitmap },
+            { f.Bitmaps[3], 3 * spritesPerBitmap, spritesPerBitmap }
+        });
+
+        f.Validate();
+    }
+
     TEST_METHOD_EX(CanvasSpriteBatch_When_AntialiasingIsEnabled_ItMustBeDisabledAroundCallsToDrawSpriteBatch)
     {
         MultipleBitmapFixture f;
@@ -1612,6 +1765,295 @@ public:
             f.Validate();
         }
     }
+
+
+    //
+    // CanvasCachedSpriteBatch
+    //
+
+    struct CachedFixture : public Fixture
+    {
+        ComPtr<MockCanvasDevice> Device;
+        ComPtr<MockD2DSpriteBatch> D2DSpriteBatch;
+        ComPtr<CanvasCachedSpriteBatch> CachedSpriteBatch;
+
+        CachedFixture(uint32_t vendorId = 0, D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1)
+            : Device(Make<MockCanvasDevice>())
+            , D2DSpriteBatch(Make<MockD2DSpriteBatch>())
+            , CachedSpriteBatch(Make<CanvasCachedSpriteBatch>(
+                Device.Get(),
+                D2DSpriteBatch.Get(),
+                Bitmap.Get(),
+                D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+                D2D1_SPRITE_OPTIONS_CLAMP_TO_SOURCE_RECTANGLE))
+        {
+            // The batch is drawn to a session on the same device.
+            DrawingSession = Make<CanvasDrawingSession>(DeviceContext.Get(), nullptr, Device.Get());
+
+            SetReportedVendorIdAndFeatureLevel(DeviceContext.Get(), vendorId, featureLevel);
+        }
+
+        void SetSpriteCount(uint32_t count)
+        {
+            D2DSpriteBatch->GetSpriteCountMethod.AllowAnyCall([=] { return count; });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_AddSprites_ConvertsRectsAndPassesSharedElementsWithZeroStride)
+    {
+        CachedFixture f;
+
+        Rect destRects[] = { Rect{ 1, 2, 3, 4 }, Rect{ 5, 6, 7, 8 } };
+        Rect sourceRect{ 10, 20, 30, 40 };
+        Vector4 tints[] = { Vector4{ 1, 2, 3, 4 }, Vector4{ 5, 6, 7, 8 } };
+
+        f.D2DSpriteBatch->AddSpritesMethod.SetExpectedCalls(1,
+            [&] (UINT32 spriteCount, D2D1_RECT_F const* d2dDestRects, D2D1_RECT_U const* d2dSourceRects, D2D1_COLOR_F const* colors, D2D1_MATRIX_3X2_F const* transforms,
+                 UINT32 destRectsStride, UINT32 sourceRectsStride, UINT32 colorsStride, UINT32 transformsStride)
+            {
+                Assert::AreEqual(2U, spriteCount);
+
+                Assert::AreEqual(D2D1_RECT_F{ 1, 2, 4, 6 }, d2dDestRects[0]);
+                Assert::AreEqual(D2D1_RECT_F{ 5, 6, 12, 14 }, d2dDestRects[1]);
+                Assert::AreEqual(static_cast<UINT32>(sizeof(D2D1_RECT_F)), destRectsStride);
+
+                // Source rects are in DIPs, the bitmap is at twice the default DPI
+                Assert::AreEqual(20U, d2dSourceRects[0].left);
+                Assert::AreEqual(40U, d2dSourceRects[0].top);
+                Assert::AreEqual(80U, d2dSourceRects[0].right);
+                Assert::AreEqual(120U, d2dSourceRects[0].bottom);
+                Assert::AreEqual(0U, sourceRectsStride);
+
+                Assert::AreEqual(D2D1_COLOR_F{ 5, 6, 7, 8 }, colors[1]);
+                Assert::AreEqual(static_cast<UINT32>(sizeof(D2D1_COLOR_F)), colorsStride);
+
+                Assert::IsNull(transforms);
+                Assert::AreEqual(static_cast<UINT32>(sizeof(D2D1_MATRIX_3X2_F)), transformsStride);
+
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.CachedSpriteBatch->AddSprites(2, destRects, 1, &sourceRect, 2, tints, 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_SetSprites_UpdatesOnlyTheArraysThatArePassed)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(3);
+
+        Rect destRect{ 1, 2, 3, 4 };
+        Matrix3x2 transform{ 1, 2, 3, 4, 5, 6 };
+
+        f.D2DSpriteBatch->SetSpritesMethod.SetExpectedCalls(1,
+            [&] (UINT32 startIndex, UINT32 spriteCount, D2D1_RECT_F const*, D2D1_RECT_U const* sourceRects, D2D1_COLOR_F const* colors, D2D1_MATRIX_3X2_F const* transforms,
+                 UINT32, UINT32, UINT32, UINT32 transformsStride)
+            {
+                Assert::AreEqual(1U, startIndex);
+                Assert::AreEqual(2U, spriteCount);
+                Assert::IsNull(sourceRects);
+                Assert::IsNull(colors);
+                Assert::AreEqual(D2D1_MATRIX_3X2_F{ 1, 2, 3, 4, 5, 6 }, *transforms);
+                Assert::AreEqual(0U, transformsStride);
+                return S_OK;
+            });
+
+        Rect destRects[] = { destRect, destRect };
+        ThrowIfFailed(f.CachedSpriteBatch->SetSprites(1, 2, destRects, 0, nullptr, 0, nullptr, 1, &transform));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_SetSprites_WithNoDestRects_TakesCountFromTheOtherArrays)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(5);
+
+        Vector4 tints[] = { Vector4{ 1, 2, 3, 4 }, Vector4{ 5, 6, 7, 8 }, Vector4{ 9, 10, 11, 12 } };
+        Matrix3x2 transform{ 1, 2, 3, 4, 5, 6 };
+
+        f.D2DSpriteBatch->SetSpritesMethod.SetExpectedCalls(1,
+            [&] (UINT32 startIndex, UINT32 spriteCount, D2D1_RECT_F const* destRects, D2D1_RECT_U const* sourceRects, D2D1_COLOR_F const* colors, D2D1_MATRIX_3X2_F const* transforms,
+                 UINT32, UINT32, UINT32 colorsStride, UINT32 transformsStride)
+            {
+                Assert::AreEqual(1U, startIndex);
+                Assert::AreEqual(3U, spriteCount);
+                Assert::IsNull(destRects);
+                Assert::IsNull(sourceRects);
+                Assert::AreEqual(D2D1_COLOR_F{ 9, 10, 11, 12 }, colors[2]);
+                Assert::AreEqual(static_cast<UINT32>(sizeof(D2D1_COLOR_F)), colorsStride);
+                Assert::AreEqual(D2D1_MATRIX_3X2_F{ 1, 2, 3, 4, 5, 6 }, *transforms);
+                Assert::AreEqual(0U, transformsStride);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.CachedSpriteBatch->SetSprites(1, 0, nullptr, 0, nullptr, 3, tints, 1, &transform));
+
+        // With only shared elements, every sprite from startIndex on is updated.
+        f.D2DSpriteBatch->SetSpritesMethod.SetExpectedCalls(1,
+            [&] (UINT32 startIndex, UINT32 spriteCount, D2D1_RECT_F const* destRects, D2D1_RECT_U const*, D2D1_COLOR_F const* colors, D2D1_MATRIX_3X2_F const*,
+                 UINT32, UINT32, UINT32 colorsStride, UINT32)
+            {
+                Assert::AreEqual(2U, startIndex);
+                Assert::AreEqual(3U, spriteCount);
+                Assert::IsNull(destRects);
+                Assert::AreEqual(D2D1_COLOR_F{ 1, 2, 3, 4 }, *colors);
+                Assert::AreEqual(0U, colorsStride);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.CachedSpriteBatch->SetSprites(2, 0, nullptr, 0, nullptr, 1, tints, 0, nullptr));
+
+        // The per-sprite arrays still have to agree.
+        Matrix3x2 transforms[] = { transform, transform };
+        Assert::AreEqual(E_INVALIDARG, f.CachedSpriteBatch->SetSprites(0, 0, nullptr, 0, nullptr, 3, tints, 2, transforms));
+        Assert::AreEqual(E_BOUNDS, f.CachedSpriteBatch->SetSprites(3, 0, nullptr, 0, nullptr, 3, tints, 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_SetSprites_FailsWhenRangeIsOutOfBounds)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(3);
+
+        Rect destRects[2]{};
+
+        Assert::AreEqual(E_BOUNDS, f.CachedSpriteBatch->SetSprites(-1, 1, destRects, 0, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_BOUNDS, f.CachedSpriteBatch->SetSprites(2, 2, destRects, 0, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_BOUNDS, f.CachedSpriteBatch->SetSprites(4, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_InvalidArgs)
+    {
+        CachedFixture f;
+
+        Rect destRects[3]{};
+        Vector4 tints[2]{};
+
+        Assert::AreEqual(E_INVALIDARG, f.CachedSpriteBatch->AddSprites(1, nullptr, 0, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.CachedSpriteBatch->AddSprites(3, destRects, 0, nullptr, 2, tints, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.CachedSpriteBatch->AddSprites(3, destRects, 0, nullptr, 1, nullptr, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.CachedSpriteBatch->get_SpriteCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.CachedSpriteBatch->get_Bitmap(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.DrawingSession->DrawCachedSpriteBatch(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_MethodsFail_AfterClosed)
+    {
+        CachedFixture f;
+
+        ThrowIfFailed(f.CachedSpriteBatch->Close());
+
+        Rect destRect{};
+        int32_t count;
+        ComPtr<ICanvasBitmap> bitmap;
+        ComPtr<ICanvasDevice> device;
+
+        Assert::AreEqual(RO_E_CLOSED, f.CachedSpriteBatch->AddSprites(1, &destRect, 0, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(RO_E_CLOSED, f.CachedSpriteBatch->SetSprites(0, 1, &destRect, 0, nullptr, 0, nullptr, 0, nullptr));
+        Assert::AreEqual(RO_E_CLOSED, f.CachedSpriteBatch->Clear());
+        Assert::AreEqual(RO_E_CLOSED, f.CachedSpriteBatch->get_SpriteCount(&count));
+        Assert::AreEqual(RO_E_CLOSED, f.CachedSpriteBatch->get_Bitmap(&bitmap));
+        Assert::AreEqual(RO_E_CLOSED, f.CachedSpriteBatch->get_Device(&device));
+        Assert::AreEqual(RO_E_CLOSED, f.DrawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_DrawCachedSpriteBatch_DrawsTheRetainedBatchInOneCall)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(1000);
+
+        f.DeviceContext->DrawSpriteBatchMethod.SetExpectedCalls(1,
+            [&] (ID2D1SpriteBatch* spriteBatch, UINT32 startIndex, UINT32 spriteCount, ID2D1Bitmap* bitmap, D2D1_BITMAP_INTERPOLATION_MODE interpolation, D2D1_SPRITE_OPTIONS options)
+            {
+                Assert::IsTrue(IsSameInstance(f.D2DSpriteBatch.Get(), spriteBatch));
+                Assert::AreEqual(0U, startIndex);
+                Assert::AreEqual(1000U, spriteCount);
+                Assert::IsTrue(IsSameInstance(f.D2DBitmap.Get(), bitmap));
+                Assert::AreEqual(D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, interpolation);
+                Assert::AreEqual(D2D1_SPRITE_OPTIONS_CLAMP_TO_SOURCE_RECTANGLE, options);
+            });
+
+        ThrowIfFailed(f.DrawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+
+        // The D2D sprite batch is kept, so the same sprites can be drawn again
+        SetReportedVendorIdAndFeatureLevel(f.DeviceContext.Get(), 0, D3D_FEATURE_LEVEL_11_1);
+        f.DeviceContext->DrawSpriteBatchMethod.SetExpectedCalls(1);
+        ThrowIfFailed(f.DrawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_DrawCachedSpriteBatch_WhenEmpty_DoesNotDraw)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(0);
+
+        ThrowIfFailed(f.DrawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_DrawCachedSpriteBatch_WhenAntialiasingIsEnabled_ItIsDisabledAndRestored)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(10);
+
+        f.DeviceContext->GetAntialiasModeMethod.SetExpectedCalls(1,
+            [] { return D2D1_ANTIALIAS_MODE_PER_PRIMITIVE; });
+
+        int callCount = 0;
+        f.DeviceContext->SetAntialiasModeMethod.SetExpectedCalls(2,
+            [callCount] (D2D1_ANTIALIAS_MODE mode) mutable
+            {
+                if (callCount == 0)
+                    Assert::AreEqual(D2D1_ANTIALIAS_MODE_ALIASED, mode);
+                else
+                    Assert::AreEqual(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE, mode);
+
+                ++callCount;
+            });
+
+        f.DeviceContext->DrawSpriteBatchMethod.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.DrawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_DrawCachedSpriteBatch_WhenQuirkRequired_BatchesAreNotLargerThan256)
+    {
+        CachedFixture f(QUALCOMM_VENDOR_ID, D3D_FEATURE_LEVEL_9_3);
+        f.SetSpriteCount(1000);
+
+        std::vector<std::pair<UINT32, UINT32>> ranges;
+
+        f.DeviceContext->FlushMethod.SetExpectedCalls(4);
+        f.DeviceContext->DrawSpriteBatchMethod.SetExpectedCalls(4,
+            [&] (ID2D1SpriteBatch*, UINT32 startIndex, UINT32 spriteCount, ID2D1Bitmap*, D2D1_BITMAP_INTERPOLATION_MODE, D2D1_SPRITE_OPTIONS)
+            {
+                ranges.emplace_back(startIndex, spriteCount);
+            });
+
+        ThrowIfFailed(f.DrawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+
+        Assert::AreEqual<size_t>(4, ranges.size());
+        Assert::AreEqual(0U, ranges[0].first);
+        Assert::AreEqual(256U, ranges[0].second);
+        Assert::AreEqual(768U, ranges[3].first);
+        Assert::AreEqual(232U, ranges[3].second);
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_DrawCachedSpriteBatch_Fails_WhenBatchIsFromADifferentDevice)
+    {
+        CachedFixture f;
+        f.SetSpriteCount(1);
+
+        auto drawingSession = Make<CanvasDrawingSession>(f.DeviceContext.Get(), nullptr, Make<MockCanvasDevice>().Get());
+
+        Assert::AreEqual(E_INVALIDARG, drawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::CachedSpriteBatchWrongDevice);
+    }
+
+    TEST_METHOD_EX(CanvasCachedSpriteBatch_DrawCachedSpriteBatch_Fails_WhenSpriteBatchNotSupported)
+    {
+        CachedFixture f;
+
+        auto drawingSession = Make<CanvasDrawingSession>(Make<MockD2DDeviceContextThatDoesNotSupportSpriteBatch>().Get());
+
+        Assert::AreEqual(E_NOTIMPL, drawingSession->DrawCachedSpriteBatch(f.CachedSpriteBatch.Get()));
+        ValidateStoredErrorState(E_NOTIMPL, Strings::SpriteBatchNotAvailable);
+    }
 };
 
 #endif
@@ -363,4 +363,72 @@ public:
             [&]{ canvasStrokeStyle->put_CustomDashStyle(0, nullptr); });
     }
 
+    TEST_METHOD_EX(CanvasStrokeStyle_CreateFrozen_CopiesPropertiesAndUsesDeviceStrokeStyle)
+    {
+        auto testFactory = Make<StubD2DFactoryWithCreateStrokeStyle>();
+        auto device = Make<MockCanvasDevice>();
+
+        auto sourceStrokeStyle = Make<CanvasStrokeStyle>();
+        float customDashPattern[2] = { 3, 1 };
+        ThrowIfFailed(sourceStrokeStyle->put_LineJoin(CanvasLineJoin::Round));
+        ThrowIfFailed(sourceStrokeStyle->put_CustomDashStyle(2, customDashPattern));
+
+        device->CreateStrokeStyleMethod.SetExpectedCalls(1,
+            [&](D2D1_STROKE_STYLE_PROPERTIES1 const& properties, std::vector<float> const& dashes)
+            {
+                Assert::AreEqual(D2D1_LINE_JOIN_ROUND, properties.lineJoin);
+                Assert::AreEqual(D2D1_DASH_STYLE_CUSTOM, properties.dashStyle);
+                Assert::AreEqual(2u, static_cast<UINT32>(dashes.size()));
+
+                ComPtr<ID2D1StrokeStyle1> d2dStrokeStyle;
+                ThrowIfFailed(testFactory->CreateStrokeStyle(&properties, dashes.data(), static_cast<UINT32>(dashes.size()), &d2dStrokeStyle));
+                return d2dStrokeStyle;
+            });
+
+        auto frozenStrokeStyle = CanvasStrokeStyle::CreateFrozen(device.Get(), sourceStrokeStyle.Get());
+
+        CanvasLineJoin lineJoin;
+        ThrowIfFailed(frozenStrokeStyle->get_LineJoin(&lineJoin));
+        Assert::AreEqual(CanvasLineJoin::Round, lineJoin);
+
+        // Drawing with the factory the shared stroke style was created on doesn't realize a new one.
+        int realizationCount = testFactory->m_numCallsToCreateStrokeStyle;
+        auto realizedD2DStrokeStyle0 = frozenStrokeStyle->GetRealizedD2DStrokeStyle(testFactory.Get());
+        auto realizedD2DStrokeStyle1 = frozenStrokeStyle->GetRealizedD2DStrokeStyle(testFactory.Get());
+
+        Assert::AreEqual(realizationCount, testFactory->m_numCallsToCreateStrokeStyle);
+        Assert::AreEqual(realizedD2DStrokeStyle0.Get(), realizedD2DStrokeStyle1.Get());
+
+        // Changes to the source aren't seen by the frozen copy.
+        ThrowIfFailed(sourceStrokeStyle->put_LineJoin(CanvasLineJoin::Bevel));
+        ThrowIfFailed(frozenStrokeStyle->get_LineJoin(&lineJoin));
+        Assert::AreEqual(CanvasLineJoin::Round, lineJoin);
+    }
+
+    TEST_METHOD_EX(CanvasStrokeStyle_Frozen_SettersFail)
+    {
+        auto testFactory = Make<StubD2DFactoryWithCreateStrokeStyle>();
+        auto device = Make<MockCanvasDevice>();
+
+        device->CreateStrokeStyleMethod.SetExpectedCalls(1,
+            [&](D2D1_STROKE_STYLE_PROPERTIES1 const& properties, std::vector<float> const&)
+            {
+                ComPtr<ID2D1StrokeStyle1> d2dStrokeStyle;
+                ThrowIfFailed(testFactory->CreateStrokeStyle(&properties, nullptr, 0, &d2dStrokeStyle));
+                return d2dStrokeStyle;
+            });
+
+        auto frozenStrokeStyle = CanvasStrokeStyle::CreateFrozen(device.Get(), Make<CanvasStrokeStyle>().Get());
+
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_StartCap(CanvasCapStyle::Round));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_EndCap(CanvasCapStyle::Round));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_DashCap(CanvasCapStyle::Round));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_LineJoin(CanvasLineJoin::Round));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_MiterLimit(1.0f));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_DashStyle(CanvasDashStyle::Dot));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_DashOffset(1.0f));
+        float customDashPattern[2] = { 1, 2 };
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_CustomDashStyle(2, customDashPattern));
+        Assert::AreEqual(E_ILLEGAL_METHOD_CALL, frozenStrokeStyle->put_TransformBehavior(CanvasStrokeTransformBehavior::Fixed));
+    }
 };
@@ -457,6 +457,50 @@ namespace canvas
             }
         }
 
+        TEST_METHOD_EX(CanvasSvgAttributeTests_Path_CreatePathGeometry_ReusesGeometryUntilPathChanges)
+        {
+            Fixture f;
+            auto path = f.CreateSvgPathAttribute();
+
+            auto d2dPath = Make<MockD2DPathGeometry>();
+
+            f.m_mockD2DPathData->CreatePathGeometryMethod.SetExpectedCalls(1,
+                [=](D2D1_FILL_MODE, ID2D1PathGeometry1** d2dPathGeometry)
+                {
+                    return d2dPath.CopyTo(d2dPathGeometry);
+                });
+
+            ComPtr<ICanvasGeometry> geometry1, geometry2;
+            Assert::AreEqual(S_OK, path->CreatePathGeometry(&geometry1));
+            Assert::AreEqual(S_OK, path->CreatePathGeometry(&geometry2));
+
+            // Separate wrappers around the same D2D geometry, so closing one leaves the other usable.
+            Assert::IsFalse(IsSameInstance(geometry1.Get(), geometry2.Get()));
+            Assert::IsTrue(IsSameInstance(d2dPath.Get(), static_cast<CanvasGeometry*>(geometry2.Get())->GetResource().Get()));
+
+            Assert::AreEqual(S_OK, As<IClosable>(geometry1)->Close());
+            Assert::IsTrue(IsSameInstance(d2dPath.Get(), static_cast<CanvasGeometry*>(geometry2.Get())->GetResource().Get()));
+
+            // Changing the path makes the next call create a new geometry.
+            f.m_mockD2DPathData->UpdateSegmentDataMethod.SetExpectedCalls(1,
+                [=](CONST FLOAT*, UINT32, UINT32)
+                {
+                    return S_OK;
+                });
+
+            float segmentData[] = { 1, 2 };
+            Assert::AreEqual(S_OK, path->SetSegmentData(0, 2, segmentData));
+
+            f.m_mockD2DPathData->CreatePathGeometryMethod.SetExpectedCalls(1,
+                [=](D2D1_FILL_MODE, ID2D1PathGeometry1** d2dPathGeometry)
+                {
+                    return d2dPath.CopyTo(d2dPathGeometry);
+                });
+
+            ComPtr<ICanvasGeometry> geometry3;
+            Assert::AreEqual(S_OK, path->CreatePathGeometry(&geometry3));
+        }
+
         template<typename D2D_ELEMENT, typename WRAPPED_ELEMENT, typename GET_COUNT_METHOD, typename GET_DATA_METHOD>
         void VerifyRetrievalOfArray(
             GET_COUNT_METHOD&& getCountMethod,
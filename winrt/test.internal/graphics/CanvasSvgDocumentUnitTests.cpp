@@ -62,6 +62,81 @@ namespace canvas
 
             return mockD2DSvgElement;
         }
+
+        // Makes a named element that reports the given tag, string attributes and children.
+        static ComPtr<MockD2DSvgElement> CreateMockD2DElement(
+            std::wstring tag,
+            std::map<std::wstring, std::wstring> attributes,
+            std::vector<ComPtr<MockD2DSvgElement>> children = {})
+        {
+            auto element = CreateMockD2DElement();
+
+            element->GetTagNameLengthMethod.AllowAnyCall(
+                [=]
+                {
+                    return static_cast<UINT32>(tag.size());
+                });
+
+            element->GetTagNameMethod.AllowAnyCall(
+                [=](PWSTR buffer, UINT32 bufferSize)
+                {
+                    return StringCchCopyN(buffer, bufferSize, tag.c_str(), tag.size());
+                });
+
+            element->IsAttributeSpecifiedMethod.AllowAnyCall(
+                [=](PCWSTR name, BOOL*)
+                {
+                    return attributes.count(name) ? TRUE : FALSE;
+                });
+
+            element->GetAttributeValueLengthMethod.AllowAnyCall(
+                [=](PCWSTR name, D2D1_SVG_ATTRIBUTE_STRING_TYPE, UINT32* length)
+                {
+                    *length = static_cast<UINT32>(attributes.at(name).size());
+                    return S_OK;
+                });
+
+            element->GetAttributeValue_String_Method.AllowAnyCall(
+                [=](PCWSTR name, D2D1_SVG_ATTRIBUTE_STRING_TYPE type, PWSTR buffer, UINT32 bufferSize)
+                {
+                    Assert::AreEqual(wcscmp(name, L"id") == 0 ? D2D1_SVG_ATTRIBUTE_STRING_TYPE_ID : D2D1_SVG_ATTRIBUTE_STRING_TYPE_SVG, type);
+
+                    auto& value = attributes.at(name);
+                    return StringCchCopyN(buffer, bufferSize, value.c_str(), value.size());
+                });
+
+            element->GetLastChildMethod.AllowAnyCall(
+                [=](ID2D1SvgElement** child)
+                {
+                    *child = nullptr;
+
+                    if (!children.empty())
+                        children.back().CopyTo(child);
+                });
+
+            element->GetPreviousChildMethod.AllowAnyCall(
+                [=](ID2D1SvgElement* reference, ID2D1SvgElement** previous)
+                {
+                    *previous = nullptr;
+
+                    for (size_t i = 1; i < children.size(); i++)
+                    {
+                        if (IsSameInstance(children[i].Get(), reference))
+                            return children[i - 1].CopyTo(previous);
+                    }
+
+                    return S_OK;
+                });
+
+            return element;
+        }
+
+        static ComPtr<MockD2DSvgElement> CreateMockD2DTextElement()
+        {
+            auto element = Make<MockD2DSvgElement>();
+            element->IsTextContentMethod.AllowAnyCall([] { return TRUE; });
+            return element;
+        }
     };
 
     TEST_CLASS(CanvasSvgDocumentTests)
@@ -99,11 +174,21 @@ namespace canvas
 
             ComPtr<ICanvasSvgNamedElement> element;
             Assert::AreEqual(RO_E_CLOSED, svgDocument->LoadElementFromXml(WinString(L"<svg/>"), &element));
+            Assert::AreEqual(RO_E_CLOSED, svgDocument->LoadElementFromXmlBuffer(reinterpret_cast<IBuffer*>(0x1234), &element));
 
             IAsyncOperation<CanvasSvgNamedElement*>* operation;
             Assert::AreEqual(RO_E_CLOSED, svgDocument->LoadElementAsync(fakeStream, &operation));
 
             Assert::AreEqual(RO_E_CLOSED, svgDocument->FindElementById(WinString(L"id"), &fakeElement));
+
+            boolean isRasterizationCacheEnabled;
+            Assert::AreEqual(RO_E_CLOSED, svgDocument->get_IsRasterizationCacheEnabled(&isRasterizationCacheEnabled));
+            Assert::AreEqual(RO_E_CLOSED, svgDocument->put_IsRasterizationCacheEnabled(true));
+
+            int32_t handle = 0;
+            float value = 0;
+            Assert::AreEqual(RO_E_CLOSED, svgDocument->RegisterAttributeName(WinString(L"opacity"), &handle));
+            Assert::AreEqual(RO_E_CLOSED, svgDocument->SetFloatAttributes(1, &fakeElement, 1, &handle, 1, &value));
         }
 
         TEST_METHOD_EX(CanvasSvgDocumentTests_NullArgs)
@@ -127,12 +212,214 @@ namespace canvas
             ComPtr<ICanvasSvgNamedElement> element;
             Assert::AreEqual(E_INVALIDARG, svgDocument->LoadElementFromXml(nullptr, &element));
             Assert::AreEqual(E_INVALIDARG, svgDocument->LoadElementFromXml(WinString(L""), nullptr));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->LoadElementFromXmlBuffer(nullptr, &element));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->LoadElementFromXmlBuffer(reinterpret_cast<IBuffer*>(0x1234), nullptr));
 
             IAsyncOperation<CanvasSvgNamedElement*>* operation;
             Assert::AreEqual(E_INVALIDARG, svgDocument->LoadElementAsync(nullptr, &operation));
             Assert::AreEqual(E_INVALIDARG, svgDocument->LoadElementAsync(fakeStream, nullptr));
 
             Assert::AreEqual(E_INVALIDARG, svgDocument->FindElementById(WinString(L""), nullptr));
+
+            Assert::AreEqual(E_INVALIDARG, svgDocument->get_IsRasterizationCacheEnabled(nullptr));
+
+            ICanvasSvgNamedElement* fakeElement = reinterpret_cast<ICanvasSvgNamedElement*>(0x1234);
+            int32_t handle = 0;
+            float value = 0;
+            Assert::AreEqual(E_INVALIDARG, svgDocument->RegisterAttributeName(WinString(L"opacity"), nullptr));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(1, nullptr, 1, &handle, 1, &value));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(1, &fakeElement, 1, nullptr, 1, &value));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(1, &fakeElement, 1, &handle, 1, nullptr));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_RegisterAttributeName_SameNameGivesSameHandle)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            int32_t opacity, fill, opacityAgain;
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"opacity"), &opacity));
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"fill"), &fill));
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"opacity"), &opacityAgain));
+
+            Assert::AreNotEqual(opacity, fill);
+            Assert::AreEqual(opacity, opacityAgain);
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_SetFloatAttributes)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            int32_t handles[2];
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"opacity"), &handles[0]));
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"stroke-width"), &handles[1]));
+
+            ComPtr<MockD2DSvgElement> mockD2DElements[2];
+            ComPtr<ICanvasSvgNamedElement> elements[2];
+            ICanvasSvgNamedElement* elementPointers[2];
+            float values[2] = { 0.5f, 3.0f };
+
+            for (int i = 0; i < 2; i++)
+            {
+                mockD2DElements[i] = f.CreateMockD2DElement();
+                elements[i] = ResourceManager::GetOrCreate<ICanvasSvgNamedElement>(f.m_canvasDevice.Get(), mockD2DElements[i].Get());
+                elementPointers[i] = elements[i].Get();
+
+                auto expectedName = i == 0 ? L"opacity" : L"stroke-width";
+                auto expectedValue = values[i];
+
+                mockD2DElements[i]->SetAttributeValue_POD_Method.SetExpectedCalls(1,
+                    [=](PCWSTR name, D2D1_SVG_ATTRIBUTE_POD_TYPE podType, const void* data, uint32_t dataSize)
+                    {
+                        Assert::AreEqual(expectedName, name);
+                        Assert::AreEqual(D2D1_SVG_ATTRIBUTE_POD_TYPE_FLOAT, podType);
+                        Assert::AreEqual(sizeof(float), static_cast<size_t>(dataSize));
+                        Assert::AreEqual(expectedValue, *(static_cast<const float*>(data)));
+
+                        return S_OK;
+                    });
+            }
+
+            Assert::AreEqual(S_OK, svgDocument->SetFloatAttributes(2, elementPointers, 2, handles, 2, values));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_SetColorAttributes_WithSharedHandleAndValue)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            int32_t handle;
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"fill"), &handle));
+
+            ComPtr<MockD2DSvgElement> mockD2DElements[3];
+            ComPtr<ICanvasSvgNamedElement> elements[3];
+            ICanvasSvgNamedElement* elementPointers[3];
+            Color color = { 255, 0, 128, 255 };
+
+            for (int i = 0; i < 3; i++)
+            {
+                mockD2DElements[i] = f.CreateMockD2DElement();
+                elements[i] = ResourceManager::GetOrCreate<ICanvasSvgNamedElement>(f.m_canvasDevice.Get(), mockD2DElements[i].Get());
+                elementPointers[i] = elements[i].Get();
+
+                mockD2DElements[i]->SetAttributeValue_POD_Method.SetExpectedCalls(1,
+                    [=](PCWSTR name, D2D1_SVG_ATTRIBUTE_POD_TYPE podType, const void* data, uint32_t dataSize)
+                    {
+                        Assert::AreEqual(L"fill", name);
+                        Assert::AreEqual(D2D1_SVG_ATTRIBUTE_POD_TYPE_COLOR, podType);
+                        Assert::AreEqual(sizeof(D2D1_COLOR_F), static_cast<size_t>(dataSize));
+                        Assert::AreEqual(ToD2DColor(color), *(static_cast<const D2D1_COLOR_F*>(data)));
+
+                        return S_OK;
+                    });
+            }
+
+            Assert::AreEqual(S_OK, svgDocument->SetColorAttributes(3, elementPointers, 1, &handle, 1, &color));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_SetAttributes_InvalidArguments)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            int32_t handles[2];
+            ThrowIfFailed(svgDocument->RegisterAttributeName(WinString(L"opacity"), &handles[0]));
+            handles[1] = handles[0];
+
+            ComPtr<MockD2DSvgElement> mockD2DElement = f.CreateMockD2DElement();
+            auto element = ResourceManager::GetOrCreate<ICanvasSvgNamedElement>(f.m_canvasDevice.Get(), mockD2DElement.Get());
+            ICanvasSvgNamedElement* elementPointers[3] = { element.Get(), element.Get(), element.Get() };
+            float values[2] = {};
+
+            // Neither one entry per element nor a single shared entry.
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(3, elementPointers, 2, handles, 1, values));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(3, elementPointers, 1, handles, 2, values));
+
+            // Handles not returned by RegisterAttributeName.
+            int32_t badHandles[] = { -1, 1 };
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(1, elementPointers, 1, &badHandles[0], 1, values));
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(1, elementPointers, 1, &badHandles[1], 1, values));
+
+            // Elements from another device.
+            auto otherDevice = Make<StubCanvasDevice>();
+            auto otherElement = ResourceManager::GetOrCreate<ICanvasSvgNamedElement>(otherDevice.Get(), f.CreateMockD2DElement().Get());
+            ICanvasSvgNamedElement* otherElementPointer = otherElement.Get();
+            Assert::AreEqual(E_INVALIDARG, svgDocument->SetFloatAttributes(1, &otherElementPointer, 1, handles, 1, values));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_LoadManyAsync_InvalidArgs)
+        {
+            auto factory = Make<CanvasSvgDocumentStatics>();
+
+            auto fakeResourceCreator = reinterpret_cast<ICanvasResourceCreator*>(0x1234);
+            auto fakeStreams = reinterpret_cast<IIterable<IRandomAccessStream*>*>(0x5678);
+            IAsyncOperation<IVectorView<CanvasSvgDocument*>*>* operation;
+
+            Assert::AreEqual(E_INVALIDARG, factory->LoadManyAsync(nullptr, fakeStreams, &operation));
+            Assert::AreEqual(E_INVALIDARG, factory->LoadManyAsync(fakeResourceCreator, nullptr, &operation));
+            Assert::AreEqual(E_INVALIDARG, factory->LoadManyAsync(fakeResourceCreator, fakeStreams, nullptr));
+
+            Assert::AreEqual(E_INVALIDARG, factory->LoadManyAsyncWithOptions(fakeResourceCreator, fakeStreams, -1, &operation));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_IsRasterizationCacheEnabled)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            boolean isRasterizationCacheEnabled;
+            ThrowIfFailed(svgDocument->get_IsRasterizationCacheEnabled(&isRasterizationCacheEnabled));
+            Assert::IsFalse(!!isRasterizationCacheEnabled);
+
+            ThrowIfFailed(svgDocument->put_IsRasterizationCacheEnabled(true));
+            ThrowIfFailed(svgDocument->get_IsRasterizationCacheEnabled(&isRasterizationCacheEnabled));
+            Assert::IsTrue(!!isRasterizationCacheEnabled);
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_TryDrawRasterized_WhenCacheDisabled_DoesNotTouchDeviceContext)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+            auto deviceContext = Make<MockD2DDeviceContext>();
+
+            Assert::IsFalse(svgDocument->TryDrawRasterized(deviceContext.Get(), Size{ 10, 10 }, 0, 0));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_TryDrawRasterized_WithRotatedTransform_LeavesDrawingToCaller)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+            auto deviceContext = Make<MockD2DDeviceContext>();
+
+            ThrowIfFailed(svgDocument->put_IsRasterizationCacheEnabled(true));
+
+            deviceContext->GetTransformMethod.SetExpectedCalls(1,
+                [](D2D1_MATRIX_3X2_F* transform)
+                {
+                    *transform = D2D1::Matrix3x2F::Rotation(45);
+                });
+
+            Assert::IsFalse(svgDocument->TryDrawRasterized(deviceContext.Get(), Size{ 10, 10 }, 0, 0));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_TryDrawRasterized_WithNonDefaultBlend_LeavesDrawingToCaller)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+            auto deviceContext = Make<MockD2DDeviceContext>();
+
+            ThrowIfFailed(svgDocument->put_IsRasterizationCacheEnabled(true));
+
+            deviceContext->GetTransformMethod.SetExpectedCalls(1,
+                [](D2D1_MATRIX_3X2_F* transform)
+                {
+                    *transform = D2D1::Matrix3x2F::Identity();
+                });
+
+            deviceContext->GetPrimitiveBlendMethod.SetExpectedCalls(1, [] { return D2D1_PRIMITIVE_BLEND_COPY; });
+
+            Assert::IsFalse(svgDocument->TryDrawRasterized(deviceContext.Get(), Size{ 10, 10 }, 0, 0));
         }
 
         TEST_METHOD_EX(CanvasSvgDocumentTests_Device)
@@ -262,6 +549,98 @@ namespace canvas
                 static_cast<CanvasSvgNamedElement*>(retrievedElement.Get())->GetResource().Get()));
         }
 
+        struct FindElementsFixture : public Fixture
+        {
+            ComPtr<MockD2DSvgElement> Root;
+            ComPtr<MockD2DSvgElement> Rect;
+            ComPtr<MockD2DSvgElement> Group;
+            ComPtr<MockD2DSvgElement> Circle;
+            ComPtr<MockD2DSvgElement> GroupRect;
+            ComPtr<CanvasSvgDocument> Document;
+
+            FindElementsFixture()
+            {
+                Rect = CreateMockD2DElement(L"rect", { { L"id", L"first" }, { L"class", L"icon  big" } });
+                Circle = CreateMockD2DElement(L"circle", { { L"class", L"big" }, { L"fill", L"red" } });
+                GroupRect = CreateMockD2DElement(L"rect", { { L"fill", L"red" } });
+                Group = CreateMockD2DElement(L"g", { { L"class", L"bigger" } }, { Circle, CreateMockD2DTextElement(), GroupRect });
+                Root = CreateMockD2DElement(L"svg", {}, { Rect, Group });
+
+                m_createdDocument->GetRootMethod.AllowAnyCall(
+                    [=](ID2D1SvgElement** root)
+                    {
+                        Root.CopyTo(root);
+                    });
+
+                Document = CreateSvgDocument();
+            }
+
+            std::vector<ID2D1SvgElement*> Find(wchar_t const* tagName, wchar_t const* attributeName, wchar_t const* attributeValue)
+            {
+                ComArray<ComPtr<ICanvasSvgNamedElement>> elements;
+                ThrowIfFailed(Document->FindElements(WinString(tagName), WinString(attributeName), WinString(attributeValue), elements.GetAddressOfSize(), elements.GetAddressOfData()));
+
+                std::vector<ID2D1SvgElement*> found;
+
+                for (uint32_t i = 0; i < elements.GetSize(); i++)
+                {
+                    found.push_back(static_cast<CanvasSvgNamedElement*>(elements[i].Get())->GetResource().Get());
+                }
+
+                return found;
+            }
+        };
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_FindElements_MatchesInDocumentOrder)
+        {
+            FindElementsFixture f;
+
+            std::vector<ID2D1SvgElement*> all{ f.Root.Get(), f.Rect.Get(), f.Group.Get(), f.Circle.Get(), f.GroupRect.Get() };
+            Assert::IsTrue(all == f.Find(L"", L"", L""));
+
+            std::vector<ID2D1SvgElement*> rects{ f.Rect.Get(), f.GroupRect.Get() };
+            Assert::IsTrue(rects == f.Find(L"rect", L"", L""));
+
+            std::vector<ID2D1SvgElement*> filled{ f.Circle.Get(), f.GroupRect.Get() };
+            Assert::IsTrue(filled == f.Find(L"", L"fill", L""));
+
+            std::vector<ID2D1SvgElement*> filledRects{ f.GroupRect.Get() };
+            Assert::IsTrue(filledRects == f.Find(L"rect", L"fill", L"red"));
+
+            std::vector<ID2D1SvgElement*> byId{ f.Rect.Get() };
+            Assert::IsTrue(byId == f.Find(L"", L"id", L"first"));
+
+            Assert::IsTrue(f.Find(L"ellipse", L"", L"").empty());
+            Assert::IsTrue(f.Find(L"", L"fill", L"blue").empty());
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_FindElements_MatchesEachClassName)
+        {
+            FindElementsFixture f;
+
+            std::vector<ID2D1SvgElement*> big{ f.Rect.Get(), f.Circle.Get() };
+            Assert::IsTrue(big == f.Find(L"", L"class", L"big"));
+
+            std::vector<ID2D1SvgElement*> icon{ f.Rect.Get() };
+            Assert::IsTrue(icon == f.Find(L"", L"class", L"icon"));
+
+            Assert::IsTrue(f.Find(L"", L"class", L"ic").empty());
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_FindElements_InvalidArgs)
+        {
+            FindElementsFixture f;
+
+            uint32_t count;
+            ICanvasSvgNamedElement** elements;
+
+            Assert::AreEqual(E_INVALIDARG, f.Document->FindElements(nullptr, nullptr, nullptr, nullptr, &elements));
+            Assert::AreEqual(E_INVALIDARG, f.Document->FindElements(nullptr, nullptr, nullptr, &count, nullptr));
+
+            Assert::AreEqual(E_INVALIDARG, f.Document->FindElements(nullptr, nullptr, WinString(L"red"), &count, &elements));
+            ValidateStoredErrorState(E_INVALIDARG, Strings::SvgAttributeValueWithoutName);
+        }
+
         TEST_METHOD_EX(CanvasSvgDocumentTests_CreatePaintAttributeWithDefaults)
         {
             Fixture f;
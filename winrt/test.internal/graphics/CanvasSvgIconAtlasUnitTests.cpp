@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+#include <lib/svg/CanvasSvgIconAtlas.h>
+
+using namespace ABI::Microsoft::Graphics::Canvas::Svg;
+
+TEST_CLASS(CanvasSvgIconAtlasUnitTests)
+{
+public:
+    static bool Overlaps(D2D1_POINT_2U positionA, D2D1_SIZE_U sizeA, D2D1_POINT_2U positionB, D2D1_SIZE_U sizeB)
+    {
+        return positionA.x < positionB.x + sizeB.width + IconAtlasLayout::Padding &&
+               positionB.x < positionA.x + sizeA.width + IconAtlasLayout::Padding &&
+               positionA.y < positionB.y + sizeB.height + IconAtlasLayout::Padding &&
+               positionB.y < positionA.y + sizeA.height + IconAtlasLayout::Padding;
+    }
+
+    TEST_METHOD_EX(IconAtlasLayout_SingleIcon_FillsTheAtlas)
+    {
+        IconAtlasLayout layout({ D2D1_SIZE_U{ 16, 24 } }, 1024);
+
+        Assert::AreEqual(16u, layout.GetSize().width);
+        Assert::AreEqual(24u, layout.GetSize().height);
+        Assert::AreEqual(0u, layout.GetPosition(0).x);
+        Assert::AreEqual(0u, layout.GetPosition(0).y);
+    }
+
+    TEST_METHOD_EX(IconAtlasLayout_IconsArePaddedAndDoNotOverlap)
+    {
+        std::vector<D2D1_SIZE_U> sizes;
+
+        for (uint32_t i = 0; i < 20; i++)
+        {
+            sizes.push_back(D2D1_SIZE_U{ 8 + i % 5 * 4, 8 + i % 3 * 8 });
+        }
+
+        IconAtlasLayout layout(sizes, 1024);
+
+        for (uint32_t i = 0; i < sizes.size(); i++)
+        {
+            auto position = layout.GetPosition(i);
+
+            Assert::IsTrue(position.x + sizes[i].width <= layout.GetSize().width);
+            Assert::IsTrue(position.y + sizes[i].height <= layout.GetSize().height);
+
+            for (uint32_t j = 0; j < i; j++)
+            {
+                Assert::IsFalse(Overlaps(position, sizes[i], layout.GetPosition(j), sizes[j]));
+            }
+        }
+    }
+
+    TEST_METHOD_EX(IconAtlasLayout_EqualIcons_PackRoughlySquare)
+    {
+        std::vector<D2D1_SIZE_U> sizes(16, D2D1_SIZE_U{ 31, 31 });
+
+        IconAtlasLayout layout(sizes, 1024);
+
+        // Four rows of four, with a pixel of padding between them.
+        Assert::AreEqual(4 * 32u - 1, layout.GetSize().width);
+        Assert::AreEqual(4 * 32u - 1, layout.GetSize().height);
+    }
+
+    TEST_METHOD_EX(IconAtlasLayout_TallestIconsGoFirst)
+    {
+        IconAtlasLayout layout({ D2D1_SIZE_U{ 10, 10 }, D2D1_SIZE_U{ 10, 40 } }, 1024);
+
+        Assert::AreEqual(0u, layout.GetPosition(1).x);
+        Assert::AreEqual(0u, layout.GetPosition(1).y);
+        Assert::AreEqual(11u, layout.GetPosition(0).x);
+    }
+
+    TEST_METHOD_EX(IconAtlasLayout_WideIconsThatOverflowASquareLayout_UseFullWidthRows)
+    {
+        std::vector<D2D1_SIZE_U> sizes(10, D2D1_SIZE_U{ 30, 10 });
+
+        IconAtlasLayout layout(sizes, 64);
+
+        Assert::IsTrue(layout.GetSize().width <= 64u);
+        Assert::AreEqual(5 * 11u - 1, layout.GetSize().height);
+    }
+
+    TEST_METHOD_EX(IconAtlasLayout_IconsThatDoNotFit_Throw)
+    {
+        ExpectHResultException(E_INVALIDARG, [] { IconAtlasLayout({ D2D1_SIZE_U{ 65, 10 } }, 64); });
+
+        std::vector<D2D1_SIZE_U> sizes(5, D2D1_SIZE_U{ 64, 20 });
+        ExpectHResultException(E_INVALIDARG, [&] { IconAtlasLayout(sizes, 64); });
+    }
+
+    TEST_METHOD_EX(CanvasSvgIconAtlas_Create_InvalidArguments)
+    {
+        auto factory = Make<CanvasSvgIconAtlasFactory>();
+        auto resourceCreator = Make<StubResourceCreatorWithDpi>(Make<StubCanvasDevice>().Get());
+
+        ICanvasSvgDocument* documents[2] = { reinterpret_cast<ICanvasSvgDocument*>(0x1234), reinterpret_cast<ICanvasSvgDocument*>(0x5678) };
+        Size sizes[2] = { Size{ 16, 16 }, Size{ 24, 24 } };
+
+        ComPtr<ICanvasSvgIconAtlas> atlas;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, 2, documents, 2, sizes, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 2, nullptr, 2, sizes, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 2, documents, 2, nullptr, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 2, documents, 2, sizes, nullptr));
+
+        // No documents, or neither one size per document nor a single shared size.
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 0, documents, 1, sizes, &atlas));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 1, documents, 2, sizes, &atlas));
+    }
+};
+
+#endif
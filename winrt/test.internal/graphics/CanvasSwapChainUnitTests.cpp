@@ -337,11 +337,29 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->ResizeBuffersWithSize(Size{ 2, 2 }));
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->ResizeBuffersWithWidthAndHeight(2, 2));
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->ResizeBuffersWithAllOptions(2, 2, DEFAULT_DPI, PIXEL_FORMAT(B8G8R8A8UIntNormalized), 2));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->ResizeBuffersAllowingOverallocation(2, 2, DEFAULT_DPI));
 
         ComPtr<ICanvasDevice> device;
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->get_Device(&device));
 
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->WaitForVerticalBlank());
+
+        CanvasSwapChainFrameStatistics frameStatistics;
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->GetFrameStatistics(&frameStatistics));
+
+        boolean b;
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->get_IsTearingAllowed(&b));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->PresentAllowingTearing());
+
+        Rect dirtyRect{};
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->PresentWithDirtyRects(1, &dirtyRect));
+
+        CanvasSwapChainColorSpace colorSpace;
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->get_ColorSpace(&colorSpace));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->put_ColorSpace(CanvasSwapChainColorSpace::Srgb));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->IsColorSpaceSupported(CanvasSwapChainColorSpace::Srgb, &b));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->SetHdrMetadata(1000, 0, 1000, 400));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->ClearHdrMetadata());
     }
 
 
@@ -359,6 +377,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_BufferCount(nullptr));
         Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_AlphaMode(nullptr));
         Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_Device(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_IsTearingAllowed(nullptr));
     }
 
     void ResetForPropertyTest(ComPtr<MockDxgiSwapChain>& swapChain)
@@ -769,6 +788,146 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         }
     }
 
+    struct OverallocationFixture : public StubDeviceFixture
+    {
+        ComPtr<StubDxgiSwapChain> DxgiSwapChain;
+        ComPtr<CanvasSwapChain> SwapChain;
+        UINT BufferWidth;
+        UINT BufferHeight;
+        int ResizeCount;
+        D2D1_SIZE_U SourceSize;
+
+        OverallocationFixture()
+            : DxgiSwapChain(Make<StubDxgiSwapChain>())
+            , BufferWidth(100)
+            , BufferHeight(100)
+            , ResizeCount(0)
+            , SourceSize{}
+        {
+            m_canvasDevice->get_MaximumBitmapSizeInPixelsMethod.AllowAnyCall(
+                [](int32_t* value)
+                {
+                    *value = 1000;
+                    return S_OK;
+                });
+
+            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall(
+                [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+                {
+                    return DxgiSwapChain;
+                });
+
+            DxgiSwapChain->GetDesc1Method.AllowAnyCall(
+                [=](DXGI_SWAP_CHAIN_DESC1* desc)
+                {
+                    *desc = DXGI_SWAP_CHAIN_DESC1{};
+                    desc->Width = BufferWidth;
+                    desc->Height = BufferHeight;
+                    desc->Format = static_cast<DXGI_FORMAT>(CanvasSwapChain::DefaultPixelFormat);
+                    desc->BufferCount = CanvasSwapChain::DefaultBufferCount;
+                    return S_OK;
+                });
+
+            DxgiSwapChain->ResizeBuffersMethod.AllowAnyCall(
+                [=](UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT)
+                {
+                    Assert::AreEqual(static_cast<UINT>(CanvasSwapChain::DefaultBufferCount), bufferCount);
+                    Assert::AreEqual(static_cast<DXGI_FORMAT>(CanvasSwapChain::DefaultPixelFormat), format);
+
+                    BufferWidth = width;
+                    BufferHeight = height;
+                    ResizeCount++;
+                    return S_OK;
+                });
+
+            DxgiSwapChain->SetSourceSizeMethod.AllowAnyCall(
+                [=](UINT width, UINT height)
+                {
+                    SourceSize = D2D1_SIZE_U{ width, height };
+                    return S_OK;
+                });
+
+            SwapChain = CanvasSwapChain::CreateNew(
+                m_canvasDevice.Get(),
+                100.0f,
+                100.0f,
+                DEFAULT_DPI,
+                CanvasSwapChain::DefaultPixelFormat,
+                CanvasSwapChain::DefaultBufferCount,
+                CanvasSwapChain::DefaultCompositionAlphaMode);
+        }
+
+        void Resize(float width, float height, float dpi = DEFAULT_DPI)
+        {
+            ThrowIfFailed(SwapChain->ResizeBuffersAllowingOverallocation(width, height, dpi));
+        }
+    };
+
+    TEST_METHOD_EX(CanvasSwapChain_ResizeBuffersAllowingOverallocation_GrowsWithHeadroom)
+    {
+        OverallocationFixture f;
+
+        f.Resize(200, 120);
+        Assert::AreEqual(1, f.ResizeCount);
+        Assert::AreEqual(250u, f.BufferWidth);
+        Assert::AreEqual(150u, f.BufferHeight);
+        Assert::AreEqual(200u, f.SourceSize.width);
+        Assert::AreEqual(120u, f.SourceSize.height);
+
+        // Sizes that fit in the buffers only move the source size.
+        f.Resize(240, 150);
+        f.Resize(150, 100);
+        Assert::AreEqual(1, f.ResizeCount);
+        Assert::AreEqual(150u, f.SourceSize.width);
+        Assert::AreEqual(100u, f.SourceSize.height);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_ResizeBuffersAllowingOverallocation_HeadroomIsLimitedToMaximumBitmapSize)
+    {
+        OverallocationFixture f;
+
+        f.Resize(900, 1000);
+        Assert::AreEqual(1000u, f.BufferWidth);
+        Assert::AreEqual(1000u, f.BufferHeight);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_ResizeBuffersAllowingOverallocation_ShrinksWhenMostlyUnused)
+    {
+        OverallocationFixture f;
+
+        // Less than half in one direction isn't enough.
+        f.Resize(40, 60);
+        Assert::AreEqual(0, f.ResizeCount);
+
+        f.Resize(40, 40);
+        Assert::AreEqual(1, f.ResizeCount);
+        Assert::AreEqual(50u, f.BufferWidth);
+        Assert::AreEqual(50u, f.BufferHeight);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_ResizeBuffersAllowingOverallocation_ReallocatesWhenDpiChanges)
+    {
+        OverallocationFixture f;
+
+        f.Resize(50, 50, DEFAULT_DPI * 2);
+        Assert::AreEqual(1, f.ResizeCount);
+        Assert::AreEqual(125u, f.BufferWidth);
+        Assert::AreEqual(100u, f.SourceSize.width);
+
+        float dpi;
+        ThrowIfFailed(f.SwapChain->get_Dpi(&dpi));
+        Assert::AreEqual(DEFAULT_DPI * 2, dpi);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_ResizeBuffersAllowingOverallocation_InvalidArgs)
+    {
+        OverallocationFixture f;
+
+        Assert::AreEqual(E_INVALIDARG, f.SwapChain->ResizeBuffersAllowingOverallocation(0, 10, DEFAULT_DPI));
+        Assert::AreEqual(E_INVALIDARG, f.SwapChain->ResizeBuffersAllowingOverallocation(10, -1, DEFAULT_DPI));
+        Assert::AreEqual(0, f.ResizeCount);
+    }
+
     TEST_METHOD_EX(CanvasSwapChain_Present)
     {
         StubDeviceFixture f;
@@ -837,6 +996,254 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         ThrowIfFailed(canvasSwapChain->PresentWithSyncInterval(3));
     }
 
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    struct TearingFixture : public StubDeviceFixture
+    {
+        ComPtr<StubDxgiSwapChain> DxgiSwapChain;
+
+        TearingFixture(bool isTearingSupported)
+            : DxgiSwapChain(Make<StubDxgiSwapChain>())
+        {
+            m_canvasDevice->IsTearingSupportedMethod.AllowAnyCall([=] { return isTearingSupported; });
+
+            m_canvasDevice->CreateSwapChainForCompositionWithFlagsMethod.SetExpectedCalls(1,
+                [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, UINT flags)
+                {
+                    UINT expectedFlags = isTearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+                    Assert::AreEqual(expectedFlags, flags);
+                    return DxgiSwapChain;
+                });
+        }
+
+        ComPtr<ICanvasSwapChain> CreateAllowingTearing()
+        {
+            auto factory = Make<CanvasSwapChainFactory>();
+            auto resourceCreator = Make<StubResourceCreatorWithDpi>(m_canvasDevice.Get());
+
+            ComPtr<ICanvasSwapChain> swapChain;
+            ThrowIfFailed(factory->CreateAllowingTearing(
+                resourceCreator.Get(),
+                1.0f,
+                1.0f,
+                DEFAULT_DPI,
+                CanvasSwapChain::DefaultPixelFormat,
+                CanvasSwapChain::DefaultBufferCount,
+                CanvasSwapChain::DefaultCompositionAlphaMode,
+                &swapChain));
+
+            return swapChain;
+        }
+
+        void ExpectPresent(UINT expectedSyncInterval, UINT expectedFlags)
+        {
+            DxgiSwapChain->Present1Method.SetExpectedCalls(1,
+                [=](UINT syncInterval, UINT presentFlags, const DXGI_PRESENT_PARAMETERS* presentParameters)
+                {
+                    Assert::AreEqual(expectedSyncInterval, syncInterval);
+                    Assert::AreEqual(expectedFlags, presentFlags);
+                    Assert::IsNotNull(presentParameters);
+                    return S_OK;
+                });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasSwapChain_IsTearingSupported)
+    {
+        StubDeviceFixture f;
+        auto factory = Make<CanvasSwapChainFactory>();
+
+        f.m_canvasDevice->IsTearingSupportedMethod.SetExpectedCalls(1, [] { return true; });
+
+        boolean isSupported = FALSE;
+        ThrowIfFailed(factory->IsTearingSupported(f.m_canvasDevice.Get(), &isSupported));
+        Assert::IsTrue(!!isSupported);
+
+        Assert::AreEqual(E_INVALIDARG, factory->IsTearingSupported(nullptr, &isSupported));
+        Assert::AreEqual(E_INVALIDARG, factory->IsTearingSupported(f.m_canvasDevice.Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_CreateAllowingTearing_WhenSupported_PresentsAllowingTearing)
+    {
+        TearingFixture f(true);
+
+        auto swapChain = f.CreateAllowingTearing();
+
+        boolean isTearingAllowed = FALSE;
+        ThrowIfFailed(swapChain->get_IsTearingAllowed(&isTearingAllowed));
+        Assert::IsTrue(!!isTearingAllowed);
+
+        f.ExpectPresent(0, DXGI_PRESENT_ALLOW_TEARING);
+        ThrowIfFailed(swapChain->PresentAllowingTearing());
+
+        // Regular presents still wait for vertical blank.
+        f.ExpectPresent(1, 0);
+        ThrowIfFailed(swapChain->Present());
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_CreateAllowingTearing_WhenNotSupported_PresentsWithoutWaiting)
+    {
+        TearingFixture f(false);
+
+        auto swapChain = f.CreateAllowingTearing();
+
+        boolean isTearingAllowed = TRUE;
+        ThrowIfFailed(swapChain->get_IsTearingAllowed(&isTearingAllowed));
+        Assert::IsFalse(!!isTearingAllowed);
+
+        f.ExpectPresent(0, 0);
+        ThrowIfFailed(swapChain->PresentAllowingTearing());
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_CreateAllowingTearing_ResizeBuffersKeepsTheFlag)
+    {
+        TearingFixture f(true);
+
+        auto swapChain = f.CreateAllowingTearing();
+
+        f.DxgiSwapChain->ResizeBuffersMethod.SetExpectedCalls(1,
+            [](UINT, UINT, UINT, DXGI_FORMAT, UINT swapChainFlags)
+            {
+                Assert::AreEqual(static_cast<UINT>(DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING), swapChainFlags);
+                return S_OK;
+            });
+
+        ThrowIfFailed(swapChain->ResizeBuffersWithAllOptions(2, 2, DEFAULT_DPI, CanvasSwapChain::DefaultPixelFormat, CanvasSwapChain::DefaultBufferCount));
+    }
+
+#endif
+
+    struct DirtyRectsFixture : public StubDeviceFixture
+    {
+        ComPtr<StubDxgiSwapChain> DxgiSwapChain;
+        ComPtr<CanvasSwapChain> SwapChain;
+
+        DirtyRectsFixture()
+            : DxgiSwapChain(Make<StubDxgiSwapChain>())
+        {
+            DxgiSwapChain->GetDesc1Method.AllowAnyCall(
+                [](DXGI_SWAP_CHAIN_DESC1* desc)
+                {
+                    *desc = DXGI_SWAP_CHAIN_DESC1{};
+                    desc->Width = 10;
+                    desc->Height = 10;
+                    return S_OK;
+                });
+
+            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall(
+                [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+                {
+                    return DxgiSwapChain;
+                });
+
+            SwapChain = CreateTestSwapChain(DEFAULT_DPI * 2);
+        }
+
+        void PresentOnce()
+        {
+            DxgiSwapChain->Present1Method.SetExpectedCalls(1);
+            ThrowIfFailed(SwapChain->Present());
+        }
+
+        void ExpectPresent(std::vector<RECT> expectedDirtyRects, RECT const* expectedScrollRect = nullptr, POINT const* expectedScrollOffset = nullptr)
+        {
+            DxgiSwapChain->Present1Method.SetExpectedCalls(1,
+                [=](UINT syncInterval, UINT, const DXGI_PRESENT_PARAMETERS* presentParameters)
+                {
+                    Assert::AreEqual(1u, syncInterval);
+                    Assert::AreEqual(static_cast<UINT>(expectedDirtyRects.size()), presentParameters->DirtyRectsCount);
+
+                    for (size_t i = 0; i < expectedDirtyRects.size(); i++)
+                    {
+                        Assert::AreEqual(expectedDirtyRects[i], presentParameters->pDirtyRects[i]);
+                    }
+
+                    if (expectedScrollRect)
+                    {
+                        Assert::AreEqual(*expectedScrollRect, *presentParameters->pScrollRect);
+                        Assert::AreEqual(expectedScrollOffset->x, presentParameters->pScrollOffset->x);
+                        Assert::AreEqual(expectedScrollOffset->y, presentParameters->pScrollOffset->y);
+                    }
+                    else
+                    {
+                        Assert::IsNull(presentParameters->pScrollRect);
+                        Assert::IsNull(presentParameters->pScrollOffset);
+                    }
+
+                    return S_OK;
+                });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRects_FirstPresentIsWhole)
+    {
+        DirtyRectsFixture f;
+
+        Rect dirtyRect{ 0, 0, 1, 1 };
+
+        f.ExpectPresent({});
+        ThrowIfFailed(f.SwapChain->PresentWithDirtyRects(1, &dirtyRect));
+
+        // As is the first present after resizing.
+        ThrowIfFailed(f.SwapChain->ResizeBuffersWithWidthAndHeight(5, 5));
+
+        f.ExpectPresent({});
+        ThrowIfFailed(f.SwapChain->PresentWithDirtyRects(1, &dirtyRect));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRects_RoundsOutAndClipsToPixels)
+    {
+        DirtyRectsFixture f;
+        f.PresentOnce();
+
+        Rect dirtyRects[] =
+        {
+            Rect{ 0.25f, 0.5f, 1, 1 },      // Rounded out.
+            Rect{ -1, -1, 100, 2 },         // Clipped.
+            Rect{ 20, 20, 1, 1 },           // Dropped, since it is outside the swap chain.
+        };
+
+        f.ExpectPresent({ RECT{ 0, 1, 3, 3 }, RECT{ 0, 0, 10, 2 } });
+        ThrowIfFailed(f.SwapChain->PresentWithDirtyRects(_countof(dirtyRects), dirtyRects));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRects_WhenAllRectsAreClippedAway_PresentsOnePixel)
+    {
+        DirtyRectsFixture f;
+        f.PresentOnce();
+
+        Rect dirtyRect{ 20, 20, 1, 1 };
+
+        f.ExpectPresent({ RECT{ 0, 0, 1, 1 } });
+        ThrowIfFailed(f.SwapChain->PresentWithDirtyRects(1, &dirtyRect));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRectsAndScroll)
+    {
+        DirtyRectsFixture f;
+        f.PresentOnce();
+
+        Rect dirtyRect{ 0, 4, 5, 1 };
+
+        RECT expectedScrollRect{ 0, 0, 10, 8 };
+        POINT expectedScrollOffset{ 0, -2 };
+
+        f.ExpectPresent({ RECT{ 0, 8, 10, 10 } }, &expectedScrollRect, &expectedScrollOffset);
+        ThrowIfFailed(f.SwapChain->PresentWithDirtyRectsAndScroll(1, &dirtyRect, Rect{ 0, 0, 5, 4 }, Vector2{ 0, -1 }));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRects_InvalidArguments)
+    {
+        DirtyRectsFixture f;
+        f.PresentOnce();
+
+        Rect negativeRect{ 0, 0, -1, 1 };
+
+        Assert::AreEqual(E_INVALIDARG, f.SwapChain->PresentWithDirtyRects(1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SwapChain->PresentWithDirtyRects(1, &negativeRect));
+        Assert::AreEqual(E_INVALIDARG, f.SwapChain->PresentWithDirtyRectsAndScroll(1, nullptr, Rect{}, Vector2{}));
+    }
+
     TEST_METHOD_EX(CanvasSwapChain_CreateDrawingSession)
     {
         StubDeviceFixture f;
@@ -1241,6 +1648,226 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         Assert::IsTrue(sleepCalled);
     }
 
+    TEST_METHOD_EX(CanvasSwapChain_GetFrameStatistics)
+    {
+        StubDeviceFixture f;
+
+        auto dxgiSwapChain = Make<MockDxgiSwapChain>();
+        dxgiSwapChain->SetMatrixTransformMethod.AllowAnyCall();
+
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall(
+            [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+            {
+                return dxgiSwapChain;
+            });
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        CanvasSwapChainFrameStatistics statistics;
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->GetFrameStatistics(nullptr));
+
+        dxgiSwapChain->GetFrameStatisticsMethod.SetExpectedCalls(1,
+            [](DXGI_FRAME_STATISTICS* value)
+            {
+                value->PresentCount = 1;
+                value->PresentRefreshCount = 2;
+                value->SyncRefreshCount = 3;
+                value->SyncQPCTime.QuadPart = 4;
+                value->SyncGPUTime.QuadPart = 5;
+                return S_OK;
+            });
+
+        ThrowIfFailed(canvasSwapChain->GetFrameStatistics(&statistics));
+
+        Assert::AreEqual(1u, statistics.PresentCount);
+        Assert::AreEqual(2u, statistics.PresentRefreshCount);
+        Assert::AreEqual(3u, statistics.SyncRefreshCount);
+        Assert::AreEqual(4LL, statistics.SyncQpcTime);
+
+        dxgiSwapChain->GetFrameStatisticsMethod.SetExpectedCalls(1,
+            [](DXGI_FRAME_STATISTICS*)
+            {
+                return DXGI_ERROR_FRAME_STATISTICS_DISJOINT;
+            });
+
+        Assert::AreEqual(DXGI_ERROR_FRAME_STATISTICS_DISJOINT, canvasSwapChain->GetFrameStatistics(&statistics));
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    struct ColorSpaceFixture : public StubDeviceFixture
+    {
+        ComPtr<MockDxgiSwapChain> DxgiSwapChain;
+        DirectXPixelFormat CreatedFormat;
+
+        ColorSpaceFixture()
+            : DxgiSwapChain(Make<MockDxgiSwapChain>())
+            , CreatedFormat{}
+        {
+            DxgiSwapChain->SetMatrixTransformMethod.AllowAnyCall();
+
+            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall(
+                [=](int32_t, int32_t, DirectXPixelFormat format, int32_t, CanvasAlphaMode)
+                {
+                    CreatedFormat = format;
+                    return DxgiSwapChain;
+                });
+        }
+
+        void ExpectColorSpaceSupport(UINT support)
+        {
+            DxgiSwapChain->CheckColorSpaceSupportMethod.AllowAnyCall(
+                [=](DXGI_COLOR_SPACE_TYPE, UINT* value)
+                {
+                    *value = support;
+                    return S_OK;
+                });
+        }
+
+        ComPtr<ICanvasSwapChain> CreateWithColorSpace(CanvasSwapChainColorSpace colorSpace)
+        {
+            auto factory = Make<CanvasSwapChainFactory>();
+
+            ComPtr<ICanvasSwapChain> swapChain;
+            ThrowIfFailed(factory->CreateWithColorSpace(m_canvasDevice.Get(), 1, 1, DEFAULT_DPI, colorSpace, &swapChain));
+            return swapChain;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasSwapChain_ColorSpace_DefaultsToSrgb)
+    {
+        ColorSpaceFixture f;
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        CanvasSwapChainColorSpace colorSpace;
+        ThrowIfFailed(canvasSwapChain->get_ColorSpace(&colorSpace));
+        Assert::AreEqual(CanvasSwapChainColorSpace::Srgb, colorSpace);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_CreateWithColorSpace_PicksFormatAndSetsColorSpace)
+    {
+        std::pair<CanvasSwapChainColorSpace, std::pair<DirectXPixelFormat, DXGI_COLOR_SPACE_TYPE>> cases[] =
+        {
+            { CanvasSwapChainColorSpace::Srgb,  { PIXEL_FORMAT(B8G8R8A8UIntNormalized),    DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709 } },
+            { CanvasSwapChainColorSpace::ScRgb, { PIXEL_FORMAT(R16G16B16A16Float),         DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709 } },
+            { CanvasSwapChainColorSpace::Hdr10, { PIXEL_FORMAT(R10G10B10A2UIntNormalized), DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020 } },
+        };
+
+        for (auto& c : cases)
+        {
+            ColorSpaceFixture f;
+            f.ExpectColorSpaceSupport(DXGI_SWAP_CHAIN_COLOR_SPACE_SUPPORT_FLAG_PRESENT);
+
+            auto expectedDxgiColorSpace = c.second.second;
+
+            f.DxgiSwapChain->SetColorSpace1Method.SetExpectedCalls(1,
+                [=](DXGI_COLOR_SPACE_TYPE colorSpace)
+                {
+                    Assert::AreEqual<int>(expectedDxgiColorSpace, colorSpace);
+                    return S_OK;
+                });
+
+            auto canvasSwapChain = f.CreateWithColorSpace(c.first);
+
+            Assert::AreEqual(c.second.first, f.CreatedFormat);
+
+            CanvasSwapChainColorSpace colorSpace;
+            ThrowIfFailed(canvasSwapChain->get_ColorSpace(&colorSpace));
+            Assert::AreEqual(c.first, colorSpace);
+        }
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_ColorSpace_Unsupported_Fails)
+    {
+        ColorSpaceFixture f;
+        f.ExpectColorSpaceSupport(0);
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        boolean isSupported = true;
+        ThrowIfFailed(canvasSwapChain->IsColorSpaceSupported(CanvasSwapChainColorSpace::ScRgb, &isSupported));
+        Assert::IsFalse(!!isSupported);
+
+        f.DxgiSwapChain->SetColorSpace1Method.SetExpectedCalls(0);
+
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->put_ColorSpace(CanvasSwapChainColorSpace::ScRgb));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::SwapChainColorSpaceNotSupported);
+
+        CanvasSwapChainColorSpace colorSpace;
+        ThrowIfFailed(canvasSwapChain->get_ColorSpace(&colorSpace));
+        Assert::AreEqual(CanvasSwapChainColorSpace::Srgb, colorSpace);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_ColorSpace_InvalidArgs)
+    {
+        ColorSpaceFixture f;
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        auto invalidColorSpace = static_cast<CanvasSwapChainColorSpace>(3);
+        boolean isSupported;
+
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->put_ColorSpace(invalidColorSpace));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->IsColorSpaceSupported(invalidColorSpace, &isSupported));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->IsColorSpaceSupported(CanvasSwapChainColorSpace::Srgb, nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_ColorSpace(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_SetHdrMetadata_PassesHdr10MetadataToDxgi)
+    {
+        ColorSpaceFixture f;
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        f.DxgiSwapChain->SetHDRMetaDataMethod.SetExpectedCalls(1,
+            [](DXGI_HDR_METADATA_TYPE type, UINT size, void* data)
+            {
+                Assert::AreEqual<int>(DXGI_HDR_METADATA_TYPE_HDR10, type);
+                Assert::AreEqual<UINT>(sizeof(DXGI_HDR_METADATA_HDR10), size);
+
+                auto metadata = static_cast<DXGI_HDR_METADATA_HDR10*>(data);
+
+                Assert::AreEqual<UINT>(1000, metadata->MaxMasteringLuminance);
+                Assert::AreEqual<UINT>(500, metadata->MinMasteringLuminance);
+                Assert::AreEqual<UINT16>(800, metadata->MaxContentLightLevel);
+                Assert::AreEqual<UINT16>(300, metadata->MaxFrameAverageLightLevel);
+
+                Assert::AreEqual<UINT16>(35400, metadata->RedPrimary[0]);
+                Assert::AreEqual<UINT16>(15635, metadata->WhitePoint[0]);
+                return S_OK;
+            });
+
+        ThrowIfFailed(canvasSwapChain->SetHdrMetadata(1000, 0.05f, 800, 300));
+
+        f.DxgiSwapChain->SetHDRMetaDataMethod.SetExpectedCalls(1,
+            [](DXGI_HDR_METADATA_TYPE type, UINT size, void* data)
+            {
+                Assert::AreEqual<int>(DXGI_HDR_METADATA_TYPE_NONE, type);
+                Assert::AreEqual(0u, size);
+                Assert::IsNull(data);
+                return S_OK;
+            });
+
+        ThrowIfFailed(canvasSwapChain->ClearHdrMetadata());
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_SetHdrMetadata_InvalidArgs)
+    {
+        ColorSpaceFixture f;
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        f.DxgiSwapChain->SetHDRMetaDataMethod.SetExpectedCalls(0);
+
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->SetHdrMetadata(-1, 0, 1000, 400));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->SetHdrMetadata(1000, 2000, 1000, 400));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->SetHdrMetadata(1000, 0, -1, 400));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->SetHdrMetadata(1000, 0, 1000, NAN));
+    }
+
+#endif
+
     static void AssertLockCount(int expectedLockCount, MockD2DFactory* factory)
     {
         Assert::AreEqual(expectedLockCount, factory->GetEnterCount());
@@ -14,6 +14,7 @@
 #include <lib/text/CanvasNumberSubstitution.h>
 #include <lib/text/CanvasTextAnalyzer.h>
 #include <lib/text/CanvasFontFace.h>
+#include <lib/text/CanvasGlyphRun.h>
 
 #if WINVER > _WIN32_WINNT_WINBLUE
 typedef MockDWriteFontFaceReference MockDWriteFontFaceContainer;
@@ -89,6 +90,139 @@ TEST_CLASS(CanvasScaledFontTests)
     }
 };
 
+TEST_CLASS(CanvasGlyphRunTests)
+{
+    struct Fixture
+    {
+        ComPtr<MockDWriteFontFace> RealizedFontFace;
+        ComPtr<MockDWriteFontFaceContainer> DWriteFontResource;
+        ComPtr<CanvasFontFace> FontFace;
+        ComPtr<CanvasGlyphRunFactory> Factory;
+
+        Fixture()
+            : RealizedFontFace(Make<MockDWriteFontFace>())
+            , DWriteFontResource(Make<MockDWriteFontFaceContainer>())
+            , Factory(Make<CanvasGlyphRunFactory>())
+        {
+            DWriteFontResource->CreateFontFaceMethod.AllowAnyCall(
+                [this](RealizedFontFaceType** out)
+                {
+                    ThrowIfFailed(RealizedFontFace.CopyTo(out));
+                    return S_OK;
+                });
+            FontFace = Make<CanvasFontFace>(DWriteFontResource.Get());
+        }
+    };
+
+    TEST_METHOD_EX(CanvasGlyphRun_ImplementsExpectedInterfaces)
+    {
+        Fixture f;
+        auto glyphRun = CanvasGlyphRun::CreateNew(f.FontFace.Get(), 12.0f, 0, nullptr, false, 0);
+
+        ASSERT_IMPLEMENTS_INTERFACE(glyphRun, ICanvasGlyphRun);
+        ASSERT_IMPLEMENTS_INTERFACE(glyphRun, ICanvasGlyphRunInternal);
+    }
+
+    TEST_METHOD_EX(CanvasGlyphRun_Create_NullArgs)
+    {
+        Fixture f;
+        CanvasGlyph glyph{};
+        ComPtr<ICanvasGlyphRun> glyphRun;
+
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(nullptr, 12.0f, 1, &glyph, false, 0, &glyphRun));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(f.FontFace.Get(), 12.0f, 1, nullptr, false, 0, &glyphRun));
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(f.FontFace.Get(), 12.0f, 1, &glyph, false, 0, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasGlyphRun_Create_GlyphIndexOutOfRange)
+    {
+        Fixture f;
+        CanvasGlyph glyph{};
+        glyph.Index = 0x10000;
+        ComPtr<ICanvasGlyphRun> glyphRun;
+
+        Assert::AreEqual(E_INVALIDARG, f.Factory->Create(f.FontFace.Get(), 12.0f, 1, &glyph, false, 0, &glyphRun));
+    }
+
+    TEST_METHOD_EX(CanvasGlyphRun_NullArgs)
+    {
+        Fixture f;
+        auto glyphRun = CanvasGlyphRun::CreateNew(f.FontFace.Get(), 12.0f, 0, nullptr, false, 0);
+
+        uint32_t count;
+        CanvasGlyph* glyphs;
+
+        Assert::AreEqual(E_INVALIDARG, glyphRun->get_FontFace(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphRun->get_FontSize(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphRun->get_IsSideways(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphRun->get_BidiLevel(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphRun->get_GlyphCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, glyphRun->GetGlyphs(nullptr, &glyphs));
+        Assert::AreEqual(E_INVALIDARG, glyphRun->GetGlyphs(&count, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasGlyphRun_Create_KeepsGlyphsInDWriteForm)
+    {
+        Fixture f;
+
+        CanvasGlyph glyphs[] =
+        {
+            { 1, 10.0f, 0.5f, 1.5f },
+            { 2, 20.0f, 2.5f, 3.5f },
+        };
+
+        ComPtr<ICanvasGlyphRun> glyphRun;
+        Assert::AreEqual(S_OK, f.Factory->Create(f.FontFace.Get(), 12.0f, _countof(glyphs), glyphs, true, 3, &glyphRun));
+
+        ComPtr<ICanvasFontFace> fontFace;
+        Assert::AreEqual(S_OK, glyphRun->get_FontFace(&fontFace));
+        Assert::IsTrue(IsSameInstance(f.FontFace.Get(), fontFace.Get()));
+
+        float fontSize;
+        Assert::AreEqual(S_OK, glyphRun->get_FontSize(&fontSize));
+        Assert::AreEqual(12.0f, fontSize);
+
+        boolean isSideways;
+        Assert::AreEqual(S_OK, glyphRun->get_IsSideways(&isSideways));
+        Assert::IsTrue(!!isSideways);
+
+        uint32_t bidiLevel;
+        Assert::AreEqual(S_OK, glyphRun->get_BidiLevel(&bidiLevel));
+        Assert::AreEqual(3u, bidiLevel);
+
+        uint32_t glyphCount;
+        Assert::AreEqual(S_OK, glyphRun->get_GlyphCount(&glyphCount));
+        Assert::AreEqual(2u, glyphCount);
+
+        auto& dwriteGlyphRun = As<ICanvasGlyphRunInternal>(glyphRun)->GetDWriteGlyphRun();
+        Assert::IsTrue(IsSameInstance(f.RealizedFontFace.Get(), dwriteGlyphRun.fontFace));
+        Assert::AreEqual(12.0f, dwriteGlyphRun.fontEmSize);
+        Assert::AreEqual(2u, dwriteGlyphRun.glyphCount);
+        Assert::IsTrue(!!dwriteGlyphRun.isSideways);
+        Assert::AreEqual(3u, dwriteGlyphRun.bidiLevel);
+
+        uint32_t returnedCount;
+        CanvasGlyph* returnedGlyphs;
+        Assert::AreEqual(S_OK, glyphRun->GetGlyphs(&returnedCount, &returnedGlyphs));
+        Assert::AreEqual(2u, returnedCount);
+
+        for (uint32_t i = 0; i < _countof(glyphs); ++i)
+        {
+            Assert::AreEqual(glyphs[i].Index, static_cast<int>(dwriteGlyphRun.glyphIndices[i]));
+            Assert::AreEqual(glyphs[i].Advance, dwriteGlyphRun.glyphAdvances[i]);
+            Assert::AreEqual(glyphs[i].AdvanceOffset, dwriteGlyphRun.glyphOffsets[i].advanceOffset);
+            Assert::AreEqual(glyphs[i].AscenderOffset, dwriteGlyphRun.glyphOffsets[i].ascenderOffset);
+
+            Assert::AreEqual(glyphs[i].Index, returnedGlyphs[i].Index);
+            Assert::AreEqual(glyphs[i].Advance, returnedGlyphs[i].Advance);
+            Assert::AreEqual(glyphs[i].AdvanceOffset, returnedGlyphs[i].AdvanceOffset);
+            Assert::AreEqual(glyphs[i].AscenderOffset, returnedGlyphs[i].AscenderOffset);
+        }
+
+        CoTaskMemFree(returnedGlyphs);
+    }
+};
+
 class MockDWriteNumberSubstitution : public RuntimeClass<
     RuntimeClassFlags<ClassicCom>,
     IDWriteNumberSubstitution>
@@ -167,6 +301,21 @@ TEST_CLASS(CanvasNumberSubstitutionTests)
 
         f.ValidateCorrectObjectWrapped(numberSubstitution);
     }
+
+    TEST_METHOD_EX(CanvasNumberSubstitution_EqualSubstitutionsAreCreatedOnce)
+    {
+        Fixture f;
+
+        f.ExpectCreateNumberSubstitution(DWRITE_NUMBER_SUBSTITUTION_METHOD_CONTEXTUAL, L"xx-yy", false);
+
+        ComPtr<ICanvasNumberSubstitution> first;
+        ComPtr<ICanvasNumberSubstitution> second;
+        Assert::AreEqual(S_OK, f.GetFactory()->CreateWithLocaleAndIgnoreOverrides(CanvasNumberSubstitutionMethod::Contextual, WinString(L"xx-yy"), false, &first));
+        Assert::AreEqual(S_OK, f.GetFactory()->CreateWithLocaleAndIgnoreOverrides(CanvasNumberSubstitutionMethod::Contextual, WinString(L"xx-yy"), false, &second));
+
+        f.ValidateCorrectObjectWrapped(second);
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+    }
 };
 
 TEST_CLASS(CanvasTextAnalyzerTests)
@@ -677,6 +826,88 @@ TEST_CLASS(CanvasTextAnalyzerTests)
             }
         }
 
+        void VerifyGlyphRun(ComPtr<ICanvasGlyphRun> const& glyphRun)
+        {
+            const int extraGlyphs = AdditionalGlyphsToAddDuringExpansion;
+            const int expectedGlyphCount = static_cast<int>(this->Text.length()) + extraGlyphs;
+
+            ComPtr<ICanvasFontFace> fontFace;
+            Assert::AreEqual(S_OK, glyphRun->get_FontFace(&fontFace));
+            Assert::IsTrue(IsSameInstance(FontFace.Get(), fontFace.Get()));
+
+            float fontSize;
+            Assert::AreEqual(S_OK, glyphRun->get_FontSize(&fontSize));
+            Assert::AreEqual(FontSize, fontSize);
+
+            boolean isSideways;
+            Assert::AreEqual(S_OK, glyphRun->get_IsSideways(&isSideways));
+            Assert::AreEqual(IsSideways, !!isSideways);
+
+            uint32_t bidiLevel;
+            Assert::AreEqual(S_OK, glyphRun->get_BidiLevel(&bidiLevel));
+            Assert::AreEqual(IsRightToLeft ? 1u : 0u, bidiLevel);
+
+            auto& dwriteGlyphRun = As<ICanvasGlyphRunInternal>(glyphRun)->GetDWriteGlyphRun();
+            Assert::IsTrue(IsSameInstance(RealizedFontFace.Get(), dwriteGlyphRun.fontFace));
+            Assert::AreEqual(expectedGlyphCount, static_cast<int>(dwriteGlyphRun.glyphCount));
+
+            uint32_t glyphCount;
+            CanvasGlyph* glyphElements;
+            Assert::AreEqual(S_OK, glyphRun->GetGlyphs(&glyphCount, &glyphElements));
+            Assert::AreEqual(expectedGlyphCount, static_cast<int>(glyphCount));
+
+            for (int i = 0; i < expectedGlyphCount; ++i)
+            {
+                Assert::AreEqual(GetGlyphIndex(i), glyphElements[i].Index);
+                Assert::AreEqual(GetGlyphIndex(i), static_cast<int>(dwriteGlyphRun.glyphIndices[i]));
+                Assert::AreEqual(GetGlyphAdvance(i), glyphElements[i].Advance);
+                Assert::AreEqual(GetGlyphAdvance(i), dwriteGlyphRun.glyphAdvances[i]);
+
+                auto expectedOffset = GetGlyphOffset(i);
+                Assert::AreEqual(expectedOffset.advanceOffset, glyphElements[i].AdvanceOffset);
+                Assert::AreEqual(expectedOffset.ascenderOffset, glyphElements[i].AscenderOffset);
+                Assert::AreEqual(expectedOffset.advanceOffset, dwriteGlyphRun.glyphOffsets[i].advanceOffset);
+                Assert::AreEqual(expectedOffset.ascenderOffset, dwriteGlyphRun.glyphOffsets[i].ascenderOffset);
+            }
+
+            CoTaskMemFree(glyphElements);
+        }
+
+        void GetGlyphRun(ComPtr<ICanvasTextAnalyzer> const& textAnalyzer)
+        {
+            ComPtr<ICanvasGlyphRun> glyphRun;
+
+            Assert::AreEqual(S_OK, textAnalyzer->GetGlyphRun(
+                CharacterRange,
+                FontFace.Get(),
+                FontSize,
+                IsSideways,
+                IsRightToLeft,
+                AnalyzedScript,
+                &glyphRun));
+
+            VerifyGlyphRun(glyphRun);
+        }
+
+        void GetGlyphRunWithAllOptions(ComPtr<ICanvasTextAnalyzer> const& textAnalyzer)
+        {
+            ComPtr<ICanvasGlyphRun> glyphRun;
+
+            Assert::AreEqual(S_OK, textAnalyzer->GetGlyphRunWithAllOptions(
+                CharacterRange,
+                FontFace.Get(),
+                FontSize,
+                IsSideways,
+                IsRightToLeft,
+                AnalyzedScript,
+                WinString(Locale.c_str()),
+                NumberSubstitution.Get(),
+                TypographyRanges.Get(),
+                &glyphRun));
+
+            VerifyGlyphRun(glyphRun);
+        }
+
         void GetGlyphsWithAllOptions(ComPtr<ICanvasTextAnalyzer> const& textAnalyzer)
         {
             uint32_t clusterMapIndexCount;
@@ -1323,6 +1554,45 @@ TEST_CLASS(CanvasTextAnalyzerTests)
         Assert::AreEqual(S_OK, textAnalyzer->GetFontsUsingSystemFontSet(f.TextFormat.Get(), &result));
     }
 
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetFonts_SecondCallUsesCachedFallback)
+    {
+        Fixture f;
+
+        f.ExpectMapCharacters();
+
+        auto textAnalyzer = f.Create();
+
+        ComPtr<IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasScaledFont*>*>> result;
+        Assert::AreEqual(S_OK, textAnalyzer->GetFontsUsingSystemFontSet(f.TextFormat.Get(), &result));
+
+        Expectations::Instance()->Validate();
+
+        // No more calls to MapCharacters are expected.
+        Assert::AreEqual(S_OK, textAnalyzer->GetFontsUsingSystemFontSet(f.TextFormat.Get(), &result));
+
+        uint32_t size;
+        ThrowIfFailed(result->get_Size(&size));
+        Assert::AreEqual(1u, size);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetFonts_WithOptions_DoesNotUseCachedFallback)
+    {
+        Fixture f;
+
+        f.ExpectMapCharacters();
+
+        auto textAnalyzer = f.CreateWithOptions();
+
+        ComPtr<IVectorView<IKeyValuePair<CanvasCharacterRange, CanvasScaledFont*>*>> result;
+        Assert::AreEqual(S_OK, textAnalyzer->GetFontsUsingSystemFontSet(f.TextFormat.Get(), &result));
+
+        Expectations::Instance()->Validate();
+
+        f.ExpectMapCharacters();
+
+        Assert::AreEqual(S_OK, textAnalyzer->GetFontsUsingSystemFontSet(f.TextFormat.Get(), &result));
+    }
+
     TEST_METHOD_EX(CanvasTextAnalyzer_GetFonts_TextAtPosition)
     {
         struct TestCase
@@ -1979,6 +2249,64 @@ TEST_CLASS(CanvasTextAnalyzerTests)
         Assert::AreEqual(CanvasScriptShape::NoVisual, analyzedScript.Shape);
     }
 
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetScriptRanges_BadArg)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        uint32_t count;
+        CanvasCharacterRange* ranges;
+        CanvasAnalyzedScript* scripts;
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetScriptRanges(nullptr, nullptr, &ranges, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetScriptRanges(nullptr, &count, nullptr, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetScriptRanges(nullptr, &count, &ranges, nullptr, &scripts));
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetScriptRanges(nullptr, &count, &ranges, &count, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetScriptRanges_ReturnsFlatArrays)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        f.TextAnalyzer->AnalyzeScriptMethod.SetExpectedCalls(1,
+            [&](IDWriteTextAnalysisSource*, uint32_t textPosition, uint32_t textLength, IDWriteTextAnalysisSink* sink)
+            {
+                Assert::AreEqual(0u, textPosition);
+                Assert::AreEqual(static_cast<uint32_t>(f.Text.length()), textLength);
+
+                DWRITE_SCRIPT_ANALYSIS scriptAnalysis{};
+                scriptAnalysis.script = 12;
+                ThrowIfFailed(sink->SetScriptAnalysis(0, 1, &scriptAnalysis));
+
+                scriptAnalysis.script = 34;
+                scriptAnalysis.shapes = DWRITE_SCRIPT_SHAPES_NO_VISUAL;
+                ThrowIfFailed(sink->SetScriptAnalysis(1, textLength - 1, &scriptAnalysis));
+
+                return S_OK;
+            });
+
+        uint32_t rangeCount, scriptCount;
+        CanvasCharacterRange* ranges;
+        CanvasAnalyzedScript* scripts;
+        Assert::AreEqual(S_OK, textAnalyzer->GetScriptRanges(nullptr, &rangeCount, &ranges, &scriptCount, &scripts));
+
+        Assert::AreEqual(2u, rangeCount);
+        Assert::AreEqual(2u, scriptCount);
+
+        Assert::AreEqual(0, ranges[0].CharacterIndex);
+        Assert::AreEqual(1, ranges[0].CharacterCount);
+        Assert::AreEqual(12, scripts[0].ScriptIdentifier);
+        Assert::AreEqual(CanvasScriptShape::Default, scripts[0].Shape);
+
+        Assert::AreEqual(1, ranges[1].CharacterIndex);
+        Assert::AreEqual(static_cast<int>(f.Text.length()) - 1, ranges[1].CharacterCount);
+        Assert::AreEqual(34, scripts[1].ScriptIdentifier);
+        Assert::AreEqual(CanvasScriptShape::NoVisual, scripts[1].Shape);
+
+        CoTaskMemFree(ranges);
+        CoTaskMemFree(scripts);
+    }
+
     TEST_METHOD_EX(CanvasTextAnalyzer_GetScriptProperties_BadArg)
     {
         Fixture f;
@@ -2154,6 +2482,40 @@ TEST_CLASS(CanvasTextAnalyzerTests)
         f.GetGlyphsWithAllOptions(textAnalyzer);
     }
 
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetGlyphRun_BasicTest)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        f.ExpectGetGlyphs();
+        f.GetGlyphRun(textAnalyzer);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetGlyphRunWithAllOptions_BasicTest)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        f.ExpectGetGlyphs();
+        f.UseNumberSubstitution();
+        f.UseTypographyRanges();
+        f.Locale = L"xx-yy";
+        f.GetGlyphRunWithAllOptions(textAnalyzer);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetGlyphRun_NeedsToResizeBuffer)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        const int bufferSize = 3 * static_cast<int>(f.Text.length()) / 2 + 16;
+
+        f.ExpectGetGlyphs(2);
+        f.AdditionalGlyphsToAddDuringExpansion = bufferSize - static_cast<int>(f.Text.length()) + 1;
+
+        f.GetGlyphRun(textAnalyzer);
+    }
+
     TEST_METHOD_EX(CanvasGlyphJustification_Values)
     {
         Assert::AreEqual(0, static_cast<int>(CanvasGlyphJustification::None));
@@ -2238,6 +2600,48 @@ TEST_CLASS(CanvasTextAnalyzerTests)
         Assert::AreEqual(34u, element.ResolvedLevel);
     }
 
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetBidiRanges_BadArg)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        uint32_t count;
+        CanvasCharacterRange* ranges;
+        CanvasAnalyzedBidi* bidi;
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetBidiRanges(nullptr, nullptr, &ranges, &count, &bidi));
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetBidiRanges(nullptr, &count, nullptr, &count, &bidi));
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetBidiRanges(nullptr, &count, &ranges, nullptr, &bidi));
+        Assert::AreEqual(E_INVALIDARG, textAnalyzer->GetBidiRanges(nullptr, &count, &ranges, &count, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetBidiRanges_UniformSpan)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        f.TextAnalyzer->AnalyzeBidiMethod.SetExpectedCalls(1,
+            [&](IDWriteTextAnalysisSource*, uint32_t textPosition, uint32_t textLength, IDWriteTextAnalysisSink* sink)
+            {
+                ThrowIfFailed(sink->SetBidiLevel(textPosition, textLength, 12, 34));
+                return S_OK;
+            });
+
+        uint32_t rangeCount, bidiCount;
+        CanvasCharacterRange* ranges;
+        CanvasAnalyzedBidi* bidi;
+        Assert::AreEqual(S_OK, textAnalyzer->GetBidiRanges(nullptr, &rangeCount, &ranges, &bidiCount, &bidi));
+
+        Assert::AreEqual(1u, rangeCount);
+        Assert::AreEqual(1u, bidiCount);
+        Assert::AreEqual(0, ranges[0].CharacterIndex);
+        Assert::AreEqual(static_cast<int>(f.Text.length()), ranges[0].CharacterCount);
+        Assert::AreEqual(12u, bidi[0].ExplicitLevel);
+        Assert::AreEqual(34u, bidi[0].ResolvedLevel);
+
+        CoTaskMemFree(ranges);
+        CoTaskMemFree(bidi);
+    }
+
     TEST_METHOD_EX(CanvasTextAnalyzer_GetBreakpoints_BadArg)
     {
         Fixture f;
@@ -2298,6 +2702,158 @@ TEST_CLASS(CanvasTextAnalyzerTests)
         }
     }
 
+    TEST_METHOD_EX(CanvasTextAnalyzer_Batch_NullArgs)
+    {
+        Fixture f;
+        auto& factory = f.m_textAnalyzerFactory;
+
+        auto direction = CanvasTextDirection::LeftToRightThenTopToBottom;
+        uint32_t count{};
+        uint32_t* starts{};
+        CanvasCharacterRange* ranges{};
+        CanvasAnalyzedScript* scripts{};
+        CanvasAnalyzedBidi* bidi{};
+        CanvasAnalyzedBreakpoint* breakpoints{};
+        CanvasGlyph* glyphs{};
+
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(1, nullptr, direction, &count, &starts, &count, &ranges, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(0, nullptr, direction, nullptr, &starts, &count, &ranges, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(0, nullptr, direction, &count, nullptr, &count, &ranges, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(0, nullptr, direction, &count, &starts, nullptr, &ranges, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(0, nullptr, direction, &count, &starts, &count, nullptr, &count, &scripts));
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(0, nullptr, direction, &count, &starts, &count, &ranges, nullptr, &scripts));
+        Assert::AreEqual(E_INVALIDARG, factory->GetScriptBatch(0, nullptr, direction, &count, &starts, &count, &ranges, &count, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->GetBidiBatch(1, nullptr, direction, &count, &starts, &count, &ranges, &count, &bidi));
+        Assert::AreEqual(E_INVALIDARG, factory->GetBidiBatch(0, nullptr, direction, &count, &starts, &count, &ranges, &count, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->GetBreakpointsBatch(1, nullptr, &count, &breakpoints));
+        Assert::AreEqual(E_INVALIDARG, factory->GetBreakpointsBatch(0, nullptr, nullptr, &breakpoints));
+        Assert::AreEqual(E_INVALIDARG, factory->GetBreakpointsBatch(0, nullptr, &count, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->GetGlyphsBatch(0, nullptr, direction, nullptr, 1.0f, &count, &starts, &count, &glyphs));
+        Assert::AreEqual(E_INVALIDARG, factory->GetGlyphsBatch(0, nullptr, direction, f.FontFace.Get(), 1.0f, nullptr, &starts, &count, &glyphs));
+        Assert::AreEqual(E_INVALIDARG, factory->GetGlyphsBatch(0, nullptr, direction, f.FontFace.Get(), 1.0f, &count, &starts, &count, nullptr));
+    }
+
+    static std::wstring GetSourceText(IDWriteTextAnalysisSource* source)
+    {
+        WCHAR const* text;
+        uint32_t textLength;
+        ThrowIfFailed(source->GetTextAtPosition(0, &text, &textLength));
+        return std::wstring(text, textLength);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetScriptBatch_RangesAreRelativeToEachText)
+    {
+        Fixture f;
+
+        f.TextAnalyzer->AnalyzeScriptMethod.SetExpectedCalls(2,
+            [&](IDWriteTextAnalysisSource* source, uint32_t textPosition, uint32_t textLength, IDWriteTextAnalysisSink* sink)
+            {
+                Assert::AreEqual(0u, textPosition);
+
+                DWRITE_SCRIPT_ANALYSIS scriptAnalysis{};
+
+                if (GetSourceText(source) == L"ab")
+                {
+                    Assert::AreEqual(2u, textLength);
+                    scriptAnalysis.script = 1;
+                    ThrowIfFailed(sink->SetScriptAnalysis(0, 2, &scriptAnalysis));
+                }
+                else
+                {
+                    Assert::AreEqual(std::wstring(L"cde"), GetSourceText(source));
+                    scriptAnalysis.script = 2;
+                    ThrowIfFailed(sink->SetScriptAnalysis(0, 1, &scriptAnalysis));
+                    scriptAnalysis.script = 3;
+                    ThrowIfFailed(sink->SetScriptAnalysis(1, 2, &scriptAnalysis));
+                }
+
+                return S_OK;
+            });
+
+        WinString ab(L"ab");
+        WinString cde(L"cde");
+        HSTRING texts[] = { ab, nullptr, cde };
+
+        uint32_t startCount, rangeCount, scriptCount;
+        uint32_t* starts;
+        CanvasCharacterRange* ranges;
+        CanvasAnalyzedScript* scripts;
+        Assert::AreEqual(S_OK, f.m_textAnalyzerFactory->GetScriptBatch(
+            _countof(texts), texts, CanvasTextDirection::LeftToRightThenTopToBottom,
+            &startCount, &starts, &rangeCount, &ranges, &scriptCount, &scripts));
+
+        Assert::AreEqual(4u, startCount);
+        Assert::AreEqual(0u, starts[0]);
+        Assert::AreEqual(1u, starts[1]);
+        Assert::AreEqual(1u, starts[2]);
+        Assert::AreEqual(3u, starts[3]);
+
+        Assert::AreEqual(3u, rangeCount);
+        Assert::AreEqual(3u, scriptCount);
+
+        Assert::AreEqual(0, ranges[0].CharacterIndex);
+        Assert::AreEqual(2, ranges[0].CharacterCount);
+        Assert::AreEqual(1, scripts[0].ScriptIdentifier);
+
+        Assert::AreEqual(0, ranges[1].CharacterIndex);
+        Assert::AreEqual(1, ranges[1].CharacterCount);
+        Assert::AreEqual(2, scripts[1].ScriptIdentifier);
+
+        Assert::AreEqual(1, ranges[2].CharacterIndex);
+        Assert::AreEqual(2, ranges[2].CharacterCount);
+        Assert::AreEqual(3, scripts[2].ScriptIdentifier);
+
+        CoTaskMemFree(starts);
+        CoTaskMemFree(ranges);
+        CoTaskMemFree(scripts);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetBreakpointsBatch_ConcatenatesBreakpoints)
+    {
+        Fixture f;
+
+        f.TextAnalyzer->AnalyzeLineBreakpointsMethod.SetExpectedCalls(2,
+            [&](IDWriteTextAnalysisSource*, uint32_t textPosition, uint32_t textLength, IDWriteTextAnalysisSink* sink)
+            {
+                Assert::AreEqual(0u, textPosition);
+
+                std::vector<DWRITE_LINE_BREAKPOINT> dwriteLineBreakpoints(textLength);
+                for (uint32_t i = 0; i < textLength; ++i)
+                {
+                    dwriteLineBreakpoints[i] = GetTestBreakpoint(i).DWriteBreakpoint;
+                }
+
+                ThrowIfFailed(sink->SetLineBreakpoints(textPosition, textLength, dwriteLineBreakpoints.data()));
+
+                return S_OK;
+            });
+
+        WinString ab(L"ab");
+        WinString cde(L"cde");
+        HSTRING texts[] = { ab, cde };
+
+        uint32_t breakpointCount;
+        CanvasAnalyzedBreakpoint* breakpoints;
+        Assert::AreEqual(S_OK, f.m_textAnalyzerFactory->GetBreakpointsBatch(_countof(texts), texts, &breakpointCount, &breakpoints));
+
+        Assert::AreEqual(5u, breakpointCount);
+
+        uint32_t expectedIndices[] = { 0, 1, 0, 1, 2 };
+        for (uint32_t i = 0; i < breakpointCount; ++i)
+        {
+            auto expected = GetTestBreakpoint(expectedIndices[i]).Breakpoint;
+            Assert::AreEqual(expected.BreakBefore, breakpoints[i].BreakBefore);
+            Assert::AreEqual(expected.BreakAfter, breakpoints[i].BreakAfter);
+            Assert::AreEqual(expected.IsWhitespace, breakpoints[i].IsWhitespace);
+            Assert::AreEqual(expected.IsSoftHyphen, breakpoints[i].IsSoftHyphen);
+        }
+
+        CoTaskMemFree(breakpoints);
+    }
+
     TEST_METHOD_EX(CanvasTextAnalyzer_GetNumberSubstitutions_BadArg)
     {
         Fixture f;
@@ -860,6 +860,42 @@ namespace canvas
                 static_cast<CanvasWordWrapping>(999));
         }
 
+        TEST_METHOD_EX(CanvasTextFormat_RealizedTextFormatClone_IsReusedUntilAPropertyChanges)
+        {
+            auto ctf = Make<CanvasTextFormat>();
+
+            auto first = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+            Assert::IsTrue(DWRITE_WORD_WRAPPING_NO_WRAP == first->GetWordWrapping());
+            Assert::AreEqual(first.Get(), ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap).Get());
+
+            // The clone must never be the format itself, which still wraps.
+            Assert::AreNotEqual<IDWriteTextFormat*>(first.Get(), ctf->GetRealizedTextFormat().Get());
+
+            // A different override gets its own clone.
+            auto wholeWord = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::WholeWord);
+            Assert::AreNotEqual(first.Get(), wholeWord.Get());
+            Assert::IsTrue(DWRITE_WORD_WRAPPING_WHOLE_WORD == wholeWord->GetWordWrapping());
+
+            // Changing a property throws the clone away.
+            auto second = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+            ThrowIfFailed(ctf->put_FontSize(30));
+
+            auto third = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+            Assert::AreNotEqual(second.Get(), third.Get());
+            Assert::AreEqual(30.0f, third->GetFontSize());
+
+            // Once the realized format has been handed out through interop
+            // it can change behind our back, so clones are no longer reused.
+            ComPtr<IDWriteTextFormat> dwriteTextFormat;
+            ThrowIfFailed(ctf->GetNativeResource(nullptr, 0, IID_PPV_ARGS(&dwriteTextFormat)));
+
+            ThrowIfFailed(dwriteTextFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER));
+
+            auto fourth = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+            Assert::IsTrue(DWRITE_PARAGRAPH_ALIGNMENT_CENTER == fourth->GetParagraphAlignment());
+            Assert::AreNotEqual(fourth.Get(), ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap).Get());
+        }
+
         TEST_METHOD_EX(CanvasTextFormat_Options)
         {
             // 'Options' isn't part of IDWriteTextFormat, and so we can't use
@@ -1195,6 +1231,72 @@ namespace canvas
             Assert::IsFalse(IsSameInstance(fc1.Get(), fc2.Get()));
         }
 
+        TEST_METHOD_EX(CanvasTextFormat_FontCollectionIsSharedBetweenFormatsWithTheSameUri)
+        {
+            CustomFontFixture f;
+
+            f.ExpectCreateCustomFontCollection(f.AnyPath);
+
+            auto cf1 = Make<CanvasTextFormat>();
+            ThrowIfFailed(cf1->put_FontFamily(f.AnyFullFontFamilyName));
+            auto df1 = cf1->GetRealizedTextFormat();
+
+            f.DontExpectCreateCustomFontCollection();
+
+            auto cf2 = Make<CanvasTextFormat>();
+            ThrowIfFailed(cf2->put_FontFamily(f.AnyFullFontFamilyName));
+            auto df2 = cf2->GetRealizedTextFormat();
+
+            ComPtr<IDWriteFontCollection> fc1;
+            ThrowIfFailed(df1->GetFontCollection(&fc1));
+
+            ComPtr<IDWriteFontCollection> fc2;
+            ThrowIfFailed(df2->GetFontCollection(&fc2));
+
+            Assert::IsTrue(IsSameInstance(fc1.Get(), fc2.Get()));
+        }
+
+        TEST_METHOD_EX(CanvasTextFormat_FontCollectionCacheCapacityOfZero_DisablesCaching)
+        {
+            CustomFontFixture f;
+
+            auto factory = Make<CanvasTextFormatFactory>();
+
+            uint32_t capacity;
+            ThrowIfFailed(factory->get_FontCollectionCacheCapacity(&capacity));
+            uint32_t expectedCapacity = CustomFontManager::DefaultFontCollectionCacheCapacity;
+            Assert::AreEqual(expectedCapacity, capacity);
+
+            ThrowIfFailed(factory->put_FontCollectionCacheCapacity(0));
+
+            f.ExpectCreateCustomFontCollection(f.AnyPath);
+
+            auto cf1 = Make<CanvasTextFormat>();
+            ThrowIfFailed(cf1->put_FontFamily(f.AnyFullFontFamilyName));
+            cf1->GetRealizedTextFormat();
+
+            f.ExpectCreateCustomFontCollection(f.AnyPath);
+
+            auto cf2 = Make<CanvasTextFormat>();
+            ThrowIfFailed(cf2->put_FontFamily(f.AnyFullFontFamilyName));
+            cf2->GetRealizedTextFormat();
+        }
+
+        TEST_METHOD_EX(CanvasTextFormat_PreloadFontFamiliesAsync_InvalidArgs)
+        {
+            CustomFontFixture f;
+
+            auto factory = Make<CanvasTextFormatFactory>();
+            ComPtr<IAsyncAction> action;
+
+            Assert::AreEqual(E_INVALIDARG, factory->PreloadFontFamiliesAsync(1, nullptr, &action));
+            Assert::AreEqual(E_INVALIDARG, factory->PreloadFontFamiliesAsync(0, nullptr, nullptr));
+
+            WinString badUri(L"http://foo#family");
+            HSTRING fontFamilies[] = { badUri };
+            Assert::AreEqual(E_INVALIDARG, factory->PreloadFontFamiliesAsync(_countof(fontFamilies), fontFamilies, &action));
+        }
+
         TEST_METHOD_EX(CanvasTextFormat_WhenTextFormatRealized_FontFamilyNameIsUnmodified)
         {
             CustomFontFixture f;
@@ -1567,7 +1669,9 @@ namespace canvas
             //
             // These tests verify that calling the various setters of CanvasTextFormat
             // will cause the format's trimming sign to be recreated or not recreated,
-            // as expected for the situation.
+            // as expected for the situation.  Ellipsis trimming signs are shared
+            // between formats with the same font, directions and glyph orientation,
+            // so only setters that change those get a different sign.
             //
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
@@ -1596,28 +1700,34 @@ namespace canvas
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_HorizontalAlignment,
-                CanvasHorizontalAlignment::Center);
+                CanvasHorizontalAlignment::Center,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_IncrementalTabStop,
-                3.9f);
+                3.9f,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_LastLineWrapping,
-                static_cast<boolean>(false));
+                static_cast<boolean>(false),
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_LineSpacing,
-                201.0f);
+                201.0f,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_LineSpacingBaseline,
-                202.0f);
+                202.0f,
+                false);
 
 #if WINVER > _WIN32_WINNT_WINBLUE
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_LineSpacingMode,
-                CanvasLineSpacingMode::Proportional);
+                CanvasLineSpacingMode::Proportional,
+                false);
 #endif
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
@@ -1626,7 +1736,8 @@ namespace canvas
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_OpticalAlignment,
-                CanvasOpticalAlignment::NoSideBearings);
+                CanvasOpticalAlignment::NoSideBearings,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_Options,
@@ -1635,19 +1746,23 @@ namespace canvas
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_TrimmingDelimiter,
-                static_cast<HSTRING>(WinString(L"K")));
+                static_cast<HSTRING>(WinString(L"K")),
+                false);
             
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_TrimmingDelimiterCount,
-                2);
+                2,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_TrimmingGranularity,
-                CanvasTextTrimmingGranularity::Character);
+                CanvasTextTrimmingGranularity::Character,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_VerticalAlignment,
-                CanvasVerticalAlignment::Bottom);
+                CanvasVerticalAlignment::Bottom,
+                false);
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_VerticalGlyphOrientation,
@@ -1655,7 +1770,28 @@ namespace canvas
 
             CanvasTextFormat_TrimmingSign_AffectsTextFormatState_TestCase(
                 &CanvasTextFormat::put_WordWrapping,
-                CanvasWordWrapping::EmergencyBreak);
+                CanvasWordWrapping::EmergencyBreak,
+                false);
+        }
+
+        TEST_METHOD_EX(CanvasTextFormat_TrimmingSign_EqualFormatsShareEllipsis)
+        {
+            auto ctf1 = Make<CanvasTextFormat>();
+            auto ctf2 = Make<CanvasTextFormat>();
+            auto ctf3 = Make<CanvasTextFormat>();
+
+            ThrowIfFailed(ctf3->put_FontSize(99.0f));
+
+            for (auto ctf : { ctf1, ctf2, ctf3 })
+                ThrowIfFailed(ctf->put_TrimmingSign(CanvasTrimmingSign::Ellipsis));
+
+            auto sign1 = GetTrimmingSign(ctf1->GetRealizedTextFormat());
+            auto sign2 = GetTrimmingSign(ctf2->GetRealizedTextFormat());
+            auto sign3 = GetTrimmingSign(ctf3->GetRealizedTextFormat());
+
+            Assert::IsNotNull(sign1.Get());
+            Assert::AreEqual(sign1.Get(), sign2.Get());
+            Assert::AreNotEqual(sign1.Get(), sign3.Get());
         }
 
         TEST_METHOD_EX(CanvasTextFormat_CustomTrimmingSign_NullArg)
@@ -1753,6 +1889,20 @@ namespace canvas
             trimmingSign->Draw(nullptr, dwriteTextRenderer.Get(), 0, 0, FALSE, FALSE, nullptr);
         }
 
+        TEST_METHOD_EX(CanvasTextFormat_CustomTrimmingSign_ReRealizing_ReusesWrapper)
+        {
+            CustomTrimmingSignFixture f;
+
+            ThrowIfFailed(f.TextFormat->put_CustomTrimmingSign(f.InlineObject.Get()));
+            auto trimmingSign1 = GetTrimmingSignFromDWriteTextFormat(GetWrappedResource<IDWriteTextFormat>(f.TextFormat));
+
+            f.ReRealize();
+            auto trimmingSign2 = GetTrimmingSignFromDWriteTextFormat(GetWrappedResource<IDWriteTextFormat>(f.TextFormat));
+
+            Assert::IsNotNull(trimmingSign1.Get());
+            Assert::IsTrue(IsSameInstance(trimmingSign1.Get(), trimmingSign2.Get()));
+        }
+
         TEST_METHOD_EX(CanvasTextFormat_CustomTrimmingSign_PropertyUnaffectedByEllipsis)
         {
             CustomTrimmingSignFixture f;
@@ -1879,5 +2029,70 @@ namespace canvas
 
             TrimmingDelimiterValidationTest(textFormat);
         }
+
+        TEST_METHOD_EX(CanvasTextFormat_Measure_InvalidArgs)
+        {
+            auto ctf = Make<CanvasTextFormat>();
+            WinString text(L"text");
+            CanvasTextMeasurement measurement;
+
+            Assert::AreEqual(E_INVALIDARG, ctf->Measure(text, 100, nullptr));
+            Assert::AreEqual(E_INVALIDARG, ctf->Measure(text, -1, &measurement));
+            Assert::AreEqual(E_INVALIDARG, ctf->Measure(text, NAN, &measurement));
+
+            ThrowIfFailed(ctf->Close());
+            Assert::AreEqual(RO_E_CLOSED, ctf->Measure(text, 100, &measurement));
+        }
+
+        TEST_METHOD_EX(CanvasTextFormat_Measure_CachesUntilFormatChanges)
+        {
+            auto adapter = std::make_shared<StubCanvasTextLayoutAdapter>();
+            CustomFontManagerAdapter::SetInstance(adapter);
+
+            auto ctf = Make<CanvasTextFormat>();
+            WinString text(L"text");
+
+            adapter->MockTextLayout->GetMetricsMethod.AllowAnyCall(
+                [](DWRITE_TEXT_METRICS1* metrics)
+                {
+                    *metrics = DWRITE_TEXT_METRICS1{};
+                    metrics->left = 1;
+                    metrics->top = 2;
+                    metrics->width = 3;
+                    metrics->height = 4;
+                    metrics->widthIncludingTrailingWhitespace = 3;
+                    metrics->heightIncludingTrailingWhitespace = 4;
+                    metrics->lineCount = 5;
+                    return S_OK;
+                });
+
+            auto expectCreateTextLayout = [&]
+            {
+                adapter->GetMockDWriteFactory()->CreateTextLayoutMethod.SetExpectedCalls(1,
+                    [&](WCHAR const* string, UINT32 stringLength, IDWriteTextFormat*, FLOAT maxWidth, FLOAT maxHeight, IDWriteTextLayout** textLayout)
+                    {
+                        Assert::AreEqual(L"text", std::wstring(string, stringLength).c_str());
+                        Assert::AreEqual(100.0f, maxWidth);
+                        Assert::AreEqual(0.0f, maxHeight);
+
+                        return adapter->MockTextLayout.CopyTo(textLayout);
+                    });
+            };
+
+            CanvasTextMeasurement measurement;
+
+            expectCreateTextLayout();
+            ThrowIfFailed(ctf->Measure(text, 100, &measurement));
+            ThrowIfFailed(ctf->Measure(text, 100, &measurement));
+            Expectations::Instance()->Validate();
+
+            Assert::AreEqual(Rect{ 1, 2, 3, 4 }, measurement.LayoutBounds);
+            Assert::AreEqual(5, measurement.LineCount);
+
+            ThrowIfFailed(ctf->put_FontSize(30));
+
+            expectCreateTextLayout();
+            ThrowIfFailed(ctf->Measure(text, 100, &measurement));
+        }
     };
 }
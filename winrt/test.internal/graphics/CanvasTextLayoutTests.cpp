@@ -2194,6 +2194,26 @@ namespace canvas
             }
         }
 
+        TEST_METHOD_EX(CanvasTextLayoutTests_InlineObject_SameObjectOnSeveralRanges_SharesWrapper)
+        {
+            NonStubbedFixture f;
+            auto textLayout = f.CreateSimpleTextLayout();
+
+            auto inlineObject = Make<CustomInlineObject>();
+
+            Assert::AreEqual(S_OK, textLayout->SetInlineObject(0, 1, inlineObject.Get()));
+            Assert::AreEqual(S_OK, textLayout->SetInlineObject(4, 1, inlineObject.Get()));
+
+            auto dtl = GetWrappedResource<IDWriteTextLayout2>(textLayout);
+
+            ComPtr<IDWriteInlineObject> wrapper1, wrapper2;
+            ThrowIfFailed(dtl->GetInlineObject(0, &wrapper1, nullptr));
+            ThrowIfFailed(dtl->GetInlineObject(4, &wrapper2, nullptr));
+
+            Assert::IsNotNull(wrapper1.Get());
+            Assert::IsTrue(IsSameInstance(wrapper1.Get(), wrapper2.Get()));
+        }
+
         TEST_METHOD_EX(CanvasTextLayoutTests_InlineObject_ImplementedViaInterop_GetInlineObject_Throws)
         {
             NonStubbedFixture f;
@@ -2844,6 +2864,58 @@ namespace canvas
                 factory->GetGlyphOrientationTransform(CanvasGlyphOrientation::Upright, true, Vector2{ 0, 0 }, nullptr));
         }
 
+        TEST_METHOD_EX(CanvasTextLayoutTests_CreateAsync_NullArgs)
+        {
+            Fixture f;
+
+            auto factory = Make<CanvasTextLayoutFactory>();
+            WinString text(L"A string");
+
+            ComPtr<IAsyncOperation<CanvasTextLayout*>> operation;
+            Assert::AreEqual(E_INVALIDARG, factory->CreateAsync(nullptr, text, f.Format.Get(), 0, 0, &operation));
+            Assert::AreEqual(E_INVALIDARG, factory->CreateAsync(f.Device.Get(), text, nullptr, 0, 0, &operation));
+            Assert::AreEqual(E_INVALIDARG, factory->CreateAsync(f.Device.Get(), text, f.Format.Get(), 0, 0, nullptr));
+        }
+
+        TEST_METHOD_EX(CanvasTextLayoutTests_CreateFromBuffer_PassesCallersBufferToDWrite)
+        {
+            Fixture f;
+
+            auto factory = Make<CanvasTextLayoutFactory>();
+
+            // The buffer isn't null terminated after the characters used.
+            wchar_t const buffer[] = L"A string and more";
+
+            f.Adapter->GetMockDWriteFactory()->CreateTextLayoutMethod.SetExpectedCalls(1,
+                [&](WCHAR const* string, UINT32 stringLength, IDWriteTextFormat*, FLOAT maxWidth, FLOAT maxHeight, IDWriteTextLayout** textLayout)
+                {
+                    Assert::IsTrue(buffer == string);
+                    Assert::AreEqual(8u, stringLength);
+                    Assert::AreEqual(12.0f, maxWidth);
+                    Assert::AreEqual(34.0f, maxHeight);
+                    return f.Adapter->MockTextLayout.CopyTo(textLayout);
+                });
+
+            ComPtr<IInspectable> textLayout;
+            ThrowIfFailed(As<ICanvasTextLayoutFactoryNative>(factory)->CreateFromBuffer(f.Device.Get(), buffer, 8, f.Format.Get(), 12, 34, &textLayout));
+
+            ASSERT_IMPLEMENTS_INTERFACE(textLayout, ICanvasTextLayout);
+        }
+
+        TEST_METHOD_EX(CanvasTextLayoutTests_CreateFromBuffer_NullArgs)
+        {
+            Fixture f;
+
+            auto factory = As<ICanvasTextLayoutFactoryNative>(Make<CanvasTextLayoutFactory>());
+            wchar_t const buffer[] = L"A string";
+
+            ComPtr<IInspectable> textLayout;
+            Assert::AreEqual(E_INVALIDARG, factory->CreateFromBuffer(nullptr, buffer, 8, f.Format.Get(), 0, 0, &textLayout));
+            Assert::AreEqual(E_INVALIDARG, factory->CreateFromBuffer(f.Device.Get(), nullptr, 0, f.Format.Get(), 0, 0, &textLayout));
+            Assert::AreEqual(E_INVALIDARG, factory->CreateFromBuffer(f.Device.Get(), buffer, 8, nullptr, 0, 0, &textLayout));
+            Assert::AreEqual(E_INVALIDARG, factory->CreateFromBuffer(f.Device.Get(), buffer, 8, f.Format.Get(), 0, 0, nullptr));
+        }
+
         TEST_METHOD_EX(CanvasTextLayoutTests_GetGlyphOrientationTransform_PassesThrough)
         {
             auto factory = Make<CanvasTextLayoutFactory>();
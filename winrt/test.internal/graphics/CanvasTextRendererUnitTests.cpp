@@ -783,5 +783,135 @@ namespace canvas
             DrawInlineObjectTestCase(false);
             DrawInlineObjectTestCase(true);
         }
+
+        struct CachedCallsFixture : public Fixture
+        {
+            UINT16 GlyphIndex;
+            float GlyphAdvance;
+            std::vector<Vector2> BaselineOrigins;
+            ComPtr<CanvasTextLayout> TextLayout;
+
+            CachedCallsFixture()
+                : GlyphIndex(7)
+                , GlyphAdvance(5.0f)
+            {
+                TextRenderer->DrawGlyphRunMethod.AllowAnyCall(
+                    [this](Vector2 baselineOrigin, ICanvasFontFace* fontFace, float, uint32_t glyphCount, CanvasGlyph* glyphs, boolean, uint32_t, IInspectable*, CanvasTextMeasuringMode, HSTRING, HSTRING, uint32_t, int*, unsigned int, CanvasGlyphOrientation)
+                    {
+                        Assert::IsTrue(IsSameInstance(FontFace.Get(), fontFace));
+                        Assert::AreEqual(1u, glyphCount);
+                        Assert::AreEqual(7, glyphs[0].Index);
+                        Assert::AreEqual(5.0f, glyphs[0].Advance);
+
+                        BaselineOrigins.push_back(baselineOrigin);
+                        return S_OK;
+                    });
+
+                TextLayout = CreateSimpleTextLayout();
+                Assert::AreEqual(S_OK, TextLayout->put_CacheTextRendererCalls(true));
+            }
+
+            // The layout draws one glyph, one unit right of and two units below its origin.
+            void ExpectLayoutDraws(int expectedCalls)
+            {
+                Adapter->MockTextLayout->DrawMethod.SetExpectedCalls(expectedCalls,
+                    [this](void*, IDWriteTextRenderer* renderer, FLOAT originX, FLOAT originY)
+                    {
+                        DWRITE_GLYPH_RUN glyphRun{};
+                        glyphRun.fontFace = RealizedDWriteFontFace.Get();
+                        glyphRun.fontEmSize = 11.0f;
+                        glyphRun.glyphCount = 1;
+                        glyphRun.glyphIndices = &GlyphIndex;
+                        glyphRun.glyphAdvances = &GlyphAdvance;
+
+                        return renderer->DrawGlyphRun(nullptr, originX + 1, originY + 2, DWRITE_MEASURING_MODE_NATURAL, &glyphRun, nullptr, nullptr);
+                    });
+            }
+
+            void Draw(float x, float y)
+            {
+                Assert::AreEqual(S_OK, TextLayout->DrawToTextRendererWithCoords(TextRenderer.Get(), x, y));
+            }
+
+            void AssertBaselineOrigin(size_t index, float x, float y)
+            {
+                Assert::AreEqual(x, BaselineOrigins[index].X);
+                Assert::AreEqual(y, BaselineOrigins[index].Y);
+            }
+        };
+
+        TEST_METHOD_EX(CanvasTextRenderer_CacheTextRendererCalls_DefaultsToFalse)
+        {
+            Fixture f;
+
+            auto textLayout = f.CreateSimpleTextLayout();
+
+            boolean value = true;
+            Assert::AreEqual(S_OK, textLayout->get_CacheTextRendererCalls(&value));
+            Assert::IsFalse(!!value);
+
+            Assert::AreEqual(E_INVALIDARG, textLayout->get_CacheTextRendererCalls(nullptr));
+        }
+
+        TEST_METHOD_EX(CanvasTextRenderer_CacheTextRendererCalls_ReplaysAtAnyPositionWhenPixelSnappingIsDisabled)
+        {
+            CachedCallsFixture f;
+
+            f.ExpectLayoutDraws(1);
+
+            f.Draw(0, 0);
+            f.Draw(10, 20);
+
+            Assert::AreEqual(2u, static_cast<uint32_t>(f.BaselineOrigins.size()));
+            f.AssertBaselineOrigin(0, 1, 2);
+            f.AssertBaselineOrigin(1, 11, 22);
+        }
+
+        TEST_METHOD_EX(CanvasTextRenderer_CacheTextRendererCalls_RecordsAgainAtNewPositionWhenPixelSnapping)
+        {
+            CachedCallsFixture f;
+
+            f.TextRenderer->get_PixelSnappingDisabledMethod.AllowAnyCall([](boolean* out) { *out = false; return S_OK; });
+
+            f.ExpectLayoutDraws(2);
+
+            f.Draw(10, 20);
+            f.Draw(10, 20);
+            f.Draw(30, 40);
+
+            Assert::AreEqual(3u, static_cast<uint32_t>(f.BaselineOrigins.size()));
+            f.AssertBaselineOrigin(0, 11, 22);
+            f.AssertBaselineOrigin(1, 11, 22);
+            f.AssertBaselineOrigin(2, 31, 42);
+        }
+
+        TEST_METHOD_EX(CanvasTextRenderer_CacheTextRendererCalls_ChangingTheLayoutRecordsAgain)
+        {
+            CachedCallsFixture f;
+
+            f.Adapter->MockTextLayout->SetFontSizeMethod.AllowAnyCall();
+
+            f.ExpectLayoutDraws(1);
+            f.Draw(0, 0);
+            f.Draw(0, 0);
+
+            f.ExpectLayoutDraws(1);
+            Assert::AreEqual(S_OK, f.TextLayout->SetFontSize(0, 1, 20.0f));
+            f.Draw(0, 0);
+        }
+
+        TEST_METHOD_EX(CanvasTextRenderer_CacheTextRendererCalls_TurningItOffDrawsTheLayoutEachTime)
+        {
+            CachedCallsFixture f;
+
+            f.ExpectLayoutDraws(1);
+            f.Draw(0, 0);
+            f.Draw(0, 0);
+
+            f.ExpectLayoutDraws(2);
+            Assert::AreEqual(S_OK, f.TextLayout->put_CacheTextRendererCalls(false));
+            f.Draw(0, 0);
+            f.Draw(0, 0);
+        }
     };
 }
\ No newline at end of file
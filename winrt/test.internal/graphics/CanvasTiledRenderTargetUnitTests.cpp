@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/images/CanvasTiledRenderTarget.h>
+
+TEST_CLASS(CanvasTiledRenderTargetUnitTests)
+{
+    //
+    // Drawing and saving tiles needs a real device, so is covered by
+    // test.external.  These tests cover the factory argument checks and how
+    // the render target is split into tiles.
+    //
+
+    TEST_METHOD_EX(CanvasTiledRenderTarget_Create_InvalidArgs)
+    {
+        auto factory = Make<CanvasTiledRenderTargetFactory>();
+        auto resourceCreator = As<ICanvasResourceCreator>(Make<StubCanvasDevice>());
+
+        ComPtr<ICanvasTiledRenderTarget> renderTarget;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, 1, 1, DEFAULT_DPI, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 1, 1, DEFAULT_DPI, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 0, 1, DEFAULT_DPI, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 1, -1, DEFAULT_DPI, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(resourceCreator.Get(), 1, 1, 0, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithTileSize(resourceCreator.Get(), 1, 1, DEFAULT_DPI, 0, &renderTarget));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithTileSize(resourceCreator.Get(), 1, 1, DEFAULT_DPI, -1, &renderTarget));
+    }
+
+    TEST_METHOD_EX(TileLayout_ExactMultipleOfTileSize)
+    {
+        TileLayout layout(BitmapSize{ 300, 200 }, 100);
+
+        Assert::AreEqual(3u, layout.GetColumnCount());
+        Assert::AreEqual(2u, layout.GetRowCount());
+
+        Assert::AreEqual(D2D1_RECT_U{ 0, 0, 100, 100 }, layout.GetTile(0, 0));
+        Assert::AreEqual(D2D1_RECT_U{ 200, 0, 300, 100 }, layout.GetTile(2, 0));
+        Assert::AreEqual(D2D1_RECT_U{ 100, 100, 200, 200 }, layout.GetTile(1, 1));
+    }
+
+    TEST_METHOD_EX(TileLayout_EdgeTilesAreCutDownToFit)
+    {
+        TileLayout layout(BitmapSize{ 250, 101 }, 100);
+
+        Assert::AreEqual(3u, layout.GetColumnCount());
+        Assert::AreEqual(2u, layout.GetRowCount());
+
+        Assert::AreEqual(D2D1_RECT_U{ 200, 0, 250, 100 }, layout.GetTile(2, 0));
+        Assert::AreEqual(D2D1_RECT_U{ 0, 100, 100, 101 }, layout.GetTile(0, 1));
+        Assert::AreEqual(D2D1_RECT_U{ 200, 100, 250, 101 }, layout.GetTile(2, 1));
+    }
+
+    TEST_METHOD_EX(TileLayout_SmallerThanOneTile)
+    {
+        TileLayout layout(BitmapSize{ 40, 30 }, 1024);
+
+        Assert::AreEqual(1u, layout.GetColumnCount());
+        Assert::AreEqual(1u, layout.GetRowCount());
+
+        Assert::AreEqual(D2D1_RECT_U{ 0, 0, 40, 30 }, layout.GetTile(0, 0));
+    }
+};
@@ -283,6 +283,164 @@ TEST_CLASS(CanvasVirtualBitmapUnitTest)
         }
     }
 
+    struct CacheOnDemandFixture : public Fixture
+    {
+        ComPtr<MockD2DImageSourceFromWic> ImageSource;
+        ComPtr<CanvasVirtualBitmap> VirtualBitmap;
+        std::vector<D2D1_RECT_U> EnsuredRects;
+
+        CacheOnDemandFixture()
+            : Fixture(D2D1_RECT_F{ 0, 0, 1000, 600 })
+        {
+            Bitmap.Indexed = true;
+            ImageSource = ExpectCreateImageSourceFromWic(D2D1_IMAGE_SOURCE_LOADING_OPTIONS_CACHE_ON_DEMAND, D2D1_ALPHA_MODE_PREMULTIPLIED);
+            VirtualBitmap = CreateVirtualBitmap(CanvasVirtualBitmapOptions::CacheOnDemand, CanvasAlphaMode::Premultiplied);
+
+            // Zero sized calls are IsCachedOnDemand probes.
+            ImageSource->EnsureCachedMethod.AllowAnyCall(
+                [=] (D2D1_RECT_U const* r)
+                {
+                    if (r->right > r->left)
+                        EnsuredRects.push_back(*r);
+                    return S_OK;
+                });
+        }
+
+        uint64_t GetCachedSizeInBytes()
+        {
+            uint64_t value;
+            ThrowIfFailed(VirtualBitmap->get_CachedSizeInBytes(&value));
+            return value;
+        }
+
+        bool IsRegionCached(Rect region)
+        {
+            boolean value;
+            ThrowIfFailed(VirtualBitmap->IsRegionCached(region, &value));
+            return !!value;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasVirtualBitmap_EnsureCached_RoundsOutToWholeTiles)
+    {
+        CacheOnDemandFixture f;
+
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 300, 10, 10, 10 }));
+
+        Assert::AreEqual<size_t>(1, f.EnsuredRects.size());
+        Assert::AreEqual(D2D1_RECT_U{ 256, 0, 512, 256 }, f.EnsuredRects[0]);
+
+        Assert::IsTrue(f.IsRegionCached(Rect{ 260, 5, 200, 200 }));
+        Assert::IsFalse(f.IsRegionCached(Rect{ 0, 0, 10, 10 }));
+        Assert::AreEqual<uint64_t>(256 * 256 * 4, f.GetCachedSizeInBytes());
+
+        Rect cachedBounds;
+        ThrowIfFailed(f.VirtualBitmap->get_CachedBounds(&cachedBounds));
+        Assert::AreEqual(Rect{ 256, 0, 256, 256 }, cachedBounds);
+
+        // Regions are clipped to the bitmap, including partial tiles at its edges.
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 990, 590, 100, 100 }));
+
+        Assert::AreEqual<size_t>(2, f.EnsuredRects.size());
+        Assert::AreEqual(D2D1_RECT_U{ 768, 512, 1000, 600 }, f.EnsuredRects[1]);
+        Assert::AreEqual<uint64_t>((256 * 256 + 232 * 88) * 4, f.GetCachedSizeInBytes());
+
+        // Empty and out of bounds regions do nothing.
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 100, 100, 0, 0 }));
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 2000, 0, 10, 10 }));
+        Assert::AreEqual<size_t>(2, f.EnsuredRects.size());
+    }
+
+    TEST_METHOD_EX(CanvasVirtualBitmap_TrimCache_ForgetsTilesThatAreNotPreserved)
+    {
+        CacheOnDemandFixture f;
+
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 300, 10, 10, 10 }));
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 990, 590, 10, 10 }));
+
+        f.ImageSource->TrimCacheMethod.SetExpectedCalls(1,
+            [] (D2D1_RECT_U const* r)
+            {
+                Assert::IsNotNull(r);
+                Assert::AreEqual(D2D1_RECT_U{ 0, 0, 600, 300 }, *r);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.VirtualBitmap->TrimCacheWithRegionToPreserve(Rect{ 0, 0, 600, 300 }));
+
+        Assert::IsTrue(f.IsRegionCached(Rect{ 300, 10, 10, 10 }));
+        Assert::IsFalse(f.IsRegionCached(Rect{ 990, 590, 10, 10 }));
+        Assert::AreEqual<uint64_t>(256 * 256 * 4, f.GetCachedSizeInBytes());
+
+        f.ImageSource->TrimCacheMethod.SetExpectedCalls(1,
+            [] (D2D1_RECT_U const* r)
+            {
+                Assert::IsNull(r);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.VirtualBitmap->TrimCache());
+
+        Assert::IsFalse(f.IsRegionCached(Rect{ 300, 10, 10, 10 }));
+        Assert::AreEqual<uint64_t>(0, f.GetCachedSizeInBytes());
+
+        Rect cachedBounds;
+        ThrowIfFailed(f.VirtualBitmap->get_CachedBounds(&cachedBounds));
+        Assert::AreEqual(Rect{}, cachedBounds);
+    }
+
+    TEST_METHOD_EX(CanvasVirtualBitmap_EnsureCached_MapsRegionsThroughOrientation)
+    {
+        Fixture f(D2D1_RECT_F{ 0, 0, 600, 1000 });
+        f.Bitmap.Transform = WICBitmapTransformRotate90;
+        f.Bitmap.Indexed = true;
+
+        auto imageSource = f.ExpectCreateImageSourceFromWic(D2D1_IMAGE_SOURCE_LOADING_OPTIONS_CACHE_ON_DEMAND, D2D1_ALPHA_MODE_PREMULTIPLIED);
+
+        f.DeviceContext->CreateTransformedImageSourceMethod.SetExpectedCalls(1,
+            [] (auto, auto, auto result)
+            {
+                return Make<MockD2DTransformedImageSource>().CopyTo(result);
+            });
+
+        auto virtualBitmap = f.CreateVirtualBitmap(CanvasVirtualBitmapOptions::CacheOnDemand, CanvasAlphaMode::Premultiplied);
+
+        // The top left of the rotated image is the bottom left of the source.
+        imageSource->EnsureCachedMethod.SetExpectedCalls(1,
+            [] (D2D1_RECT_U const* r)
+            {
+                Assert::AreEqual(D2D1_RECT_U{ 0, 344, 256, 600 }, *r);
+                return S_OK;
+            });
+
+        ThrowIfFailed(virtualBitmap->EnsureCached(Rect{ 0, 0, 10, 10 }));
+    }
+
+    TEST_METHOD_EX(CanvasVirtualBitmap_WhenNotCachedOnDemand_WholeBitmapIsReportedAsCached)
+    {
+        CreatedFixture f;
+
+        f.ImageSource->EnsureCachedMethod.AllowAnyCall(
+            [] (D2D1_RECT_U const*)
+            {
+                return D2DERR_UNSUPPORTED_OPERATION;
+            });
+
+        ThrowIfFailed(f.VirtualBitmap->EnsureCached(Rect{ 10, 20, 5, 5 }));
+
+        boolean isCached;
+        ThrowIfFailed(f.VirtualBitmap->IsRegionCached(Rect{ 10, 20, 20, 20 }, &isCached));
+        Assert::IsTrue(!!isCached);
+
+        uint64_t sizeInBytes;
+        ThrowIfFailed(f.VirtualBitmap->get_CachedSizeInBytes(&sizeInBytes));
+        Assert::AreEqual<uint64_t>(20 * 20 * 4, sizeInBytes);
+
+        Rect cachedBounds;
+        ThrowIfFailed(f.VirtualBitmap->get_CachedBounds(&cachedBounds));
+        Assert::AreEqual(Rect{ 10, 20, 20, 20 }, cachedBounds);
+    }
+
     //
     // In the interop case, various properties of the interop'd image source
     // need to be obtained by probing the passed in resource.  We don't have
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/effects/ColorManagementConverter.h>
+#include <lib/effects/ColorManagementProfile.h>
+
+TEST_CLASS(ColorManagementConverterUnitTests)
+{
+    //
+    // Converting needs a real device, so is covered by test.external.  These
+    // tests cover argument checks, properties and the choice of target format.
+    //
+
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<IColorManagementProfile> SourceProfile;
+        ComPtr<IColorManagementProfile> OutputProfile;
+        ComPtr<IColorManagementConverter> Converter;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , SourceProfile(Make<ColorManagementProfile>(CanvasColorSpace::Srgb))
+            , OutputProfile(Make<ColorManagementProfile>(CanvasColorSpace::ScRgb))
+        {
+            ThrowIfFailed(Make<ColorManagementConverterFactory>()->Create(Device.Get(), SourceProfile.Get(), OutputProfile.Get(), &Converter));
+        }
+    };
+
+    TEST_METHOD_EX(ColorManagementConverter_Create_InvalidArgs)
+    {
+        Fixture f;
+
+        auto factory = Make<ColorManagementConverterFactory>();
+        ComPtr<IColorManagementConverter> converter;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, f.SourceProfile.Get(), f.OutputProfile.Get(), &converter));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(f.Device.Get(), nullptr, f.OutputProfile.Get(), &converter));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(f.Device.Get(), f.SourceProfile.Get(), nullptr, &converter));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(f.Device.Get(), f.SourceProfile.Get(), f.OutputProfile.Get(), nullptr));
+    }
+
+    TEST_METHOD_EX(ColorManagementConverter_Properties)
+    {
+        Fixture f;
+
+        ComPtr<IColorManagementProfile> profile;
+
+        ThrowIfFailed(f.Converter->get_SourceColorProfile(&profile));
+        Assert::IsTrue(IsSameInstance(f.SourceProfile.Get(), profile.Get()));
+
+        ThrowIfFailed(f.Converter->get_OutputColorProfile(&profile));
+        Assert::IsTrue(IsSameInstance(f.OutputProfile.Get(), profile.Get()));
+
+        ComPtr<ICanvasDevice> device;
+        ThrowIfFailed(As<ICanvasResourceCreator>(f.Converter)->get_Device(&device));
+        Assert::IsTrue(IsSameInstance(f.Device.Get(), device.Get()));
+
+        ColorManagementEffectQuality quality;
+        ThrowIfFailed(f.Converter->get_Quality(&quality));
+        Assert::IsTrue(quality == ColorManagementEffectQuality::Normal);
+
+        ThrowIfFailed(f.Converter->put_Quality(ColorManagementEffectQuality::Best));
+        ThrowIfFailed(f.Converter->get_Quality(&quality));
+        Assert::IsTrue(quality == ColorManagementEffectQuality::Best);
+    }
+
+    TEST_METHOD_EX(ColorManagementConverter_Convert_InvalidArgs)
+    {
+        Fixture f;
+
+        auto bitmaps = Make<Vector<CanvasBitmap*>>();
+        auto handler = Callback<IColorManagementConvertedPixelsHandler>([](int32_t, DirectXPixelFormat, uint32_t, uint8_t*) { return S_OK; });
+
+        ComPtr<IAsyncOperation<IVectorView<CanvasBitmap*>*>> operation;
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertAsync(nullptr, &operation));
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertAsync(bitmaps.Get(), nullptr));
+
+        ComPtr<IAsyncAction> action;
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertToPixelBytesAsync(nullptr, handler.Get(), &action));
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertToPixelBytesAsync(bitmaps.Get(), nullptr, &action));
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertToPixelBytesAsync(bitmaps.Get(), handler.Get(), nullptr));
+
+        // Null entries are caught before any work starts.
+        ThrowIfFailed(bitmaps->Append(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertAsync(bitmaps.Get(), &operation));
+        Assert::AreEqual(E_INVALIDARG, f.Converter->ConvertToPixelBytesAsync(bitmaps.Get(), handler.Get(), &action));
+    }
+
+    TEST_METHOD_EX(GetColorConversionTargetFormat_KeepsRenderableFormats)
+    {
+        Assert::AreEqual<int>(DXGI_FORMAT_B8G8R8A8_UNORM, GetColorConversionTargetFormat(DXGI_FORMAT_B8G8R8A8_UNORM));
+        Assert::AreEqual<int>(DXGI_FORMAT_R8G8B8A8_UNORM, GetColorConversionTargetFormat(DXGI_FORMAT_R8G8B8A8_UNORM));
+        Assert::AreEqual<int>(DXGI_FORMAT_R16G16B16A16_FLOAT, GetColorConversionTargetFormat(DXGI_FORMAT_R16G16B16A16_FLOAT));
+        Assert::AreEqual<int>(DXGI_FORMAT_R32G32B32A32_FLOAT, GetColorConversionTargetFormat(DXGI_FORMAT_R32G32B32A32_FLOAT));
+    }
+
+    TEST_METHOD_EX(GetColorConversionTargetFormat_ReplacesOtherFormats)
+    {
+        // High bit depth sources keep their precision.
+        Assert::AreEqual<int>(DXGI_FORMAT_R16G16B16A16_FLOAT, GetColorConversionTargetFormat(DXGI_FORMAT_R16G16B16A16_UNORM));
+        Assert::AreEqual<int>(DXGI_FORMAT_R16G16B16A16_FLOAT, GetColorConversionTargetFormat(DXGI_FORMAT_R10G10B10A2_UNORM));
+
+        // Anything else (such as block compressed or single channel formats) cannot be drawn into.
+        Assert::AreEqual<int>(DXGI_FORMAT_B8G8R8A8_UNORM, GetColorConversionTargetFormat(DXGI_FORMAT_BC1_UNORM));
+        Assert::AreEqual<int>(DXGI_FORMAT_B8G8R8A8_UNORM, GetColorConversionTargetFormat(DXGI_FORMAT_A8_UNORM));
+        Assert::AreEqual<int>(DXGI_FORMAT_B8G8R8A8_UNORM, GetColorConversionTargetFormat(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB));
+    }
+};
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/effects/shader/ComputeShaderEffect.h>
+#include <lib/effects/shader/ComputeShaderTransform.h>
+#include <lib/effects/shader/SharedShaderState.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+static ComPtr<SharedShaderState> MakeComputeShaderState(
+    ShaderDescription const& shader,
+    ThreadMappingState const& threadMapping = ThreadMappingState())
+{
+    return Make<SharedShaderState>(shader, std::vector<BYTE>(), CoordinateMappingState(), SourceInterpolationState(), threadMapping);
+}
+
+
+TEST_CLASS(ComputeShaderEffectUnitTests)
+{
+    static std::vector<BYTE> computeShader;
+    static std::vector<BYTE> pixelShader;
+
+    TEST_CLASS_INITIALIZE(Initialize)
+    {
+#define HLSL(quote) #quote
+
+        static char const* computeShaderCode = HLSL
+        (
+            cbuffer constants : register(b0)
+            {
+                float amount;
+                int4 Win2DOutputRect;
+                int4 Win2DSourceRects[2];
+            };
+
+            Texture2D<float4> source1 : register(t0);
+            Texture2D<float4> source2 : register(t1);
+            RWTexture2D<float4> output : register(u0);
+
+            [numthreads(8, 4, 1)]
+            void main(uint3 id : SV_DispatchThreadID)
+            {
+                int2 pos = Win2DOutputRect.xy + (int2)id.xy;
+
+                output[id.xy] = source1[pos - Win2DSourceRects[0].xy] * amount + source2[pos - Win2DSourceRects[1].xy];
+            }
+        );
+
+        static char const* pixelShaderCode = HLSL
+        (
+            float4 main() : SV_Target
+            {
+                return 1;
+            }
+        );
+
+        computeShader = CompileShader(computeShaderCode, "cs_5_0");
+        pixelShader = CompileShader(pixelShaderCode, "ps_4_0");
+    }
+
+
+    static std::vector<BYTE> CompileShader(char const* shaderCode, char const* target)
+    {
+        ComPtr<ID3DBlob> result;
+
+        ThrowIfFailed(D3DCompile(shaderCode, strlen(shaderCode), nullptr, nullptr, nullptr, "main", target, 0, 0, &result, nullptr));
+
+        auto buffer = reinterpret_cast<BYTE*>(result->GetBufferPointer());
+
+        return std::vector<BYTE>(buffer, buffer + result->GetBufferSize());
+    }
+
+
+    TEST_METHOD_EX(ComputeShaderEffect_ShaderReflection)
+    {
+        auto state = Make<SharedShaderState>(computeShader.data(), static_cast<unsigned>(computeShader.size()), D3D11_SHVER_COMPUTE_SHADER);
+
+        auto& shader = state->Shader();
+
+        Assert::AreEqual<int>(D3D11_SHVER_COMPUTE_SHADER, shader.Type);
+        Assert::AreEqual(2u, shader.InputCount);
+        Assert::AreEqual<int>(D3D_FEATURE_LEVEL_11_0, shader.MinFeatureLevel);
+
+        Assert::AreEqual(8u, shader.ThreadGroupSize[0]);
+        Assert::AreEqual(4u, shader.ThreadGroupSize[1]);
+        Assert::AreEqual(1u, shader.ThreadGroupSize[2]);
+
+        // The reserved rect variables are filled in by the effect, so are not properties.
+        Assert::AreEqual<size_t>(1, shader.Variables.size());
+        Assert::AreEqual<std::wstring>(L"amount", static_cast<wchar_t const*>(shader.Variables[0].Name));
+
+        Assert::AreEqual(16, shader.OutputRectOffset);
+        Assert::AreEqual(32, shader.SourceRectsOffset);
+        Assert::AreEqual(2u, shader.SourceRectsCount);
+    }
+
+
+    TEST_METHOD_EX(ComputeShaderEffect_WrongShaderTypeIsRejected)
+    {
+        ExpectHResultException(E_INVALIDARG, [&] { Make<SharedShaderState>(pixelShader.data(), static_cast<unsigned>(pixelShader.size()), D3D11_SHVER_COMPUTE_SHADER); });
+        ExpectHResultException(E_INVALIDARG, [&] { Make<SharedShaderState>(computeShader.data(), static_cast<unsigned>(computeShader.size())); });
+
+        // Also when the other type of shader is already cached.
+        Make<SharedShaderState>(pixelShader.data(), static_cast<unsigned>(pixelShader.size()));
+        Make<SharedShaderState>(computeShader.data(), static_cast<unsigned>(computeShader.size()), D3D11_SHVER_COMPUTE_SHADER);
+
+        ExpectHResultException(E_INVALIDARG, [&] { Make<SharedShaderState>(pixelShader.data(), static_cast<unsigned>(pixelShader.size()), D3D11_SHVER_COMPUTE_SHADER); });
+        ExpectHResultException(E_INVALIDARG, [&] { Make<SharedShaderState>(computeShader.data(), static_cast<unsigned>(computeShader.size())); });
+    }
+
+
+    TEST_METHOD_EX(ComputeShaderEffect_PixelsPerThread)
+    {
+        ShaderDescription desc;
+        desc.Type = D3D11_SHVER_COMPUTE_SHADER;
+
+        auto effect = Make<ComputeShaderEffect>(nullptr, nullptr, MakeComputeShaderState(desc).Get());
+
+        BitmapSize value;
+        ThrowIfFailed(effect->get_PixelsPerThread(&value));
+        Assert::AreEqual(1u, value.Width);
+        Assert::AreEqual(1u, value.Height);
+
+        ThrowIfFailed(effect->put_PixelsPerThread(BitmapSize{ 4, 2 }));
+        ThrowIfFailed(effect->get_PixelsPerThread(&value));
+        Assert::AreEqual(4u, value.Width);
+        Assert::AreEqual(2u, value.Height);
+
+        Assert::AreEqual(E_INVALIDARG, effect->put_PixelsPerThread(BitmapSize{ 0, 1 }));
+        Assert::AreEqual(E_INVALIDARG, effect->put_PixelsPerThread(BitmapSize{ 1, 0 }));
+        Assert::AreEqual(E_INVALIDARG, effect->get_PixelsPerThread(nullptr));
+    }
+};
+
+std::vector<BYTE> ComputeShaderEffectUnitTests::computeShader;
+std::vector<BYTE> ComputeShaderEffectUnitTests::pixelShader;
+
+
+TEST_CLASS(ComputeShaderTransformUnitTests)
+{
+public:
+    TEST_METHOD_EX(ComputeShaderTransform_CalculateThreadgroups)
+    {
+        ShaderDescription desc;
+        desc.Type = D3D11_SHVER_COMPUTE_SHADER;
+        desc.ThreadGroupSize[0] = 8;
+        desc.ThreadGroupSize[1] = 4;
+
+        auto threadMapping = std::make_shared<ThreadMappingState>();
+        auto transform = Make<ComputeShaderTransform>(MakeComputeShaderState(desc).Get(), std::make_shared<CoordinateMappingState>(), threadMapping);
+
+        D2D1_RECT_L output = { -10, 5, 90, 15 };
+        UINT32 x, y, z;
+
+        ThrowIfFailed(transform->CalculateThreadgroups(&output, &x, &y, &z));
+
+        Assert::AreEqual(13u, x);
+        Assert::AreEqual(3u, y);
+        Assert::AreEqual(1u, z);
+
+        // Each thread covering more pixels means fewer thread groups.
+        threadMapping->PixelsPerThread = BitmapSize{ 2, 10 };
+
+        ThrowIfFailed(transform->CalculateThreadgroups(&output, &x, &y, &z));
+
+        Assert::AreEqual(7u, x);
+        Assert::AreEqual(1u, y);
+        Assert::AreEqual(1u, z);
+
+        // An empty output needs no thread groups.
+        output = D2D1_RECT_L{ 5, 5, 5, 5 };
+
+        ThrowIfFailed(transform->CalculateThreadgroups(&output, &x, &y, &z));
+
+        Assert::AreEqual(0u, x);
+        Assert::AreEqual(0u, y);
+    }
+
+
+    TEST_METHOD_EX(ComputeShaderTransform_MapInputRectsToOutputRect_ReturnsUnionOfSources)
+    {
+        ShaderDescription desc;
+        desc.InputCount = 3;
+
+        auto mapping = std::make_shared<CoordinateMappingState>();
+
+        mapping->Mapping[0] = SamplerCoordinateMapping::OneToOne;
+        mapping->Mapping[1] = SamplerCoordinateMapping::Offset;
+        mapping->Mapping[2] = SamplerCoordinateMapping::Unknown;
+        mapping->MaxOffset = 2;
+
+        auto transform = Make<ComputeShaderTransform>(MakeComputeShaderState(desc).Get(), mapping, std::make_shared<ThreadMappingState>());
+
+        D2D1_RECT_L inputs[] = { { 0, 0, 10, 10 }, { 20, 20, 30, 30 }, { -100, -100, 100, 100 } };
+        D2D1_RECT_L output;
+        D2D1_RECT_L outputOpaqueSubRect;
+
+        ThrowIfFailed(transform->MapInputRectsToOutputRect(inputs, nullptr, 3, &output, &outputOpaqueSubRect));
+
+        Assert::AreEqual(D2D1_RECT_L{ 0, 0, 32, 32 }, output);
+        Assert::AreEqual(D2D1_RECT_L{ 0, 0, 0, 0 }, outputOpaqueSubRect);
+    }
+
+
+    TEST_METHOD_EX(ComputeShaderTransform_MapOutputRectToInputRects)
+    {
+        ShaderDescription desc;
+        desc.InputCount = 3;
+
+        auto mapping = std::make_shared<CoordinateMappingState>();
+
+        mapping->Mapping[0] = SamplerCoordinateMapping::Unknown;
+        mapping->Mapping[1] = SamplerCoordinateMapping::OneToOne;
+        mapping->Mapping[2] = SamplerCoordinateMapping::Offset;
+        mapping->MaxOffset = 2;
+
+        auto transform = Make<ComputeShaderTransform>(MakeComputeShaderState(desc).Get(), mapping, std::make_shared<ThreadMappingState>());
+
+        D2D1_RECT_L sourceBounds[] = { { 1, 2, 3, 4 }, { 0, 0, 100, 100 }, { 0, 0, 100, 100 } };
+        D2D1_RECT_L output = { 10, 11, 23, 42 };
+        D2D1_RECT_L outputOpaqueSubRect;
+        D2D1_RECT_L inputs[3];
+
+        ThrowIfFailed(transform->MapInputRectsToOutputRect(sourceBounds, nullptr, 3, &output, &outputOpaqueSubRect));
+
+        output = D2D1_RECT_L{ 10, 11, 23, 42 };
+
+        ThrowIfFailed(transform->MapOutputRectToInputRects(&output, inputs, 3));
+
+        // Unknown mapping = the whole of that source.
+        Assert::AreEqual(sourceBounds[0], inputs[0]);
+
+        // OneToOne mapping.
+        Assert::AreEqual(output, inputs[1]);
+
+        // Offset mapping.
+        Assert::AreEqual(D2D1_RECT_L{ 8, 9, 25, 44 }, inputs[2]);
+    }
+};
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/effects/generated/GaussianBlurEffect.h>
+
+#include "stubs/StubD2DEffect.h"
+#include "stubs/StubFontManagerAdapter.h"
+
+//
+// Measures the CPU time Win2D itself adds to common operations.  Unlike the
+// benchmarks in test.external, these run against the no-op D2D and DWrite
+// mocks, so the numbers leave out the time spent inside D2D and on the GPU
+// and show just Win2D's overhead per call (plus a roughly constant cost for
+// dispatching through the mocks).
+//
+// Each benchmark repeats its body until it has run for a fixed amount of
+// time, and writes nanoseconds per call to the test log.  Nothing is
+// asserted about the timings, so these can't fail on a slow machine.
+//
+// The benchmarks are in the "Benchmark" category, so they can be run on
+// their own, or left out of a test run, with a category filter.
+//
+
+#define BENCHMARK(NAME)                                         \
+    BEGIN_TEST_METHOD_ATTRIBUTE(NAME)                           \
+        TEST_METHOD_ATTRIBUTE(L"Category", L"Benchmark")        \
+    END_TEST_METHOD_ATTRIBUTE()                                 \
+    TEST_METHOD_EX(NAME)
+
+TEST_CLASS(CpuOverheadBenchmarks)
+{
+    static double GetSeconds()
+    {
+        LARGE_INTEGER counter;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&counter);
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+    }
+
+    static void Run(wchar_t const* name, uint32_t callsPerIteration, std::function<void()> const& iteration)
+    {
+        double const minimumSeconds = 0.1;
+        uint64_t const minimumIterations = 3;
+
+        // The first iteration warms up caches and lazily created resources.
+        iteration();
+
+        uint64_t iterations = 0;
+        double start = GetSeconds();
+        double elapsed = 0;
+
+        while (iterations < minimumIterations || elapsed < minimumSeconds)
+        {
+            iteration();
+            ++iterations;
+            elapsed = GetSeconds() - start;
+        }
+
+        wchar_t buffer[256];
+
+        ThrowIfFailed(StringCchPrintf(
+            buffer,
+            _countof(buffer),
+            L"{ \"name\": \"%s\", \"calls\": %llu, \"nanosecondsPerCall\": %.1f }",
+            name,
+            iterations * callsPerIteration,
+            elapsed * 1000000000 / (iterations * callsPerIteration)));
+
+        Logger::WriteMessage(buffer);
+    }
+
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> CanvasDevice;
+        ComPtr<StubD2DDeviceContextWithGetFactory> DeviceContext;
+        ComPtr<CanvasDrawingSession> DS;
+
+        Fixture()
+            : CanvasDevice(Make<StubCanvasDevice>())
+            , DeviceContext(Make<StubD2DDeviceContextWithGetFactory>())
+        {
+            DS = CanvasDrawingSession::CreateNew(
+                DeviceContext.Get(),
+                std::make_shared<StubCanvasDrawingSessionAdapter>(),
+                CanvasDevice.Get());
+
+            DeviceContext->CreateSolidColorBrushMethod.AllowAnyCall(
+                [](D2D1_COLOR_F const*, D2D1_BRUSH_PROPERTIES const*, ID2D1SolidColorBrush** brush)
+                {
+                    return Make<MockD2DSolidColorBrush>().CopyTo(brush);
+                });
+
+            DeviceContext->CreateEffectMethod.AllowAnyCall(
+                [](IID const& iid, ID2D1Effect** effect)
+                {
+                    return Make<StubD2DEffect>(iid).CopyTo(effect);
+                });
+
+            DeviceContext->GetTransformMethod.AllowAnyCall([](D2D1_MATRIX_3X2_F* m) { *m = D2D1::Matrix3x2F::Identity(); });
+            DeviceContext->SetTransformMethod.AllowAnyCall();
+            DeviceContext->GetPrimitiveBlendMethod.AllowAnyCall([] { return D2D1_PRIMITIVE_BLEND_SOURCE_OVER; });
+            DeviceContext->GetUnitModeMethod.AllowAnyCall([] { return D2D1_UNIT_MODE_DIPS; });
+            DeviceContext->GetImageLocalBoundsMethod.AllowAnyCall();
+            DeviceContext->GetDeviceMethod.AllowAnyCallAlwaysCopyValueToParam(CanvasDevice->GetD2DDevice());
+            DeviceContext->GetTargetMethod.AllowAnyCall([](ID2D1Image** target) { *target = nullptr; });
+            DeviceContext->GetDpiMethod.AllowAnyCall(
+                [](float* dpiX, float* dpiY)
+                {
+                    *dpiX = DEFAULT_DPI;
+                    *dpiY = DEFAULT_DPI;
+                });
+
+            DeviceContext->FillRectangleMethod.AllowAnyCall();
+            DeviceContext->DrawBitmapMethod.AllowAnyCall();
+            DeviceContext->DrawImageMethod.AllowAnyCall();
+        }
+
+        ComPtr<CanvasBitmap> MakeBitmap()
+        {
+            auto d2dBitmap = Make<StubD2DBitmap>();
+            d2dBitmap->GetSizeMethod.AllowAnyCall([] { return D2D1_SIZE_F{ 256, 256 }; });
+            d2dBitmap->GetPixelSizeMethod.AllowAnyCall([] { return D2D1_SIZE_U{ 256, 256 }; });
+
+            return Make<CanvasBitmap>(CanvasDevice.Get(), d2dBitmap.Get());
+        }
+    };
+
+public:
+    BENCHMARK(CpuOverhead_DrawingSession_FillRectangleWithColor)
+    {
+        Fixture f;
+
+        uint32_t const count = 1000;
+
+        Run(L"DrawingSession_FillRectangleWithColor", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ThrowIfFailed(f.DS->FillRectangleAtCoordsWithColor(static_cast<float>(i), 0, 10, 10, Color{ 255, 100, 149, 237 }));
+            }
+        });
+    }
+
+    BENCHMARK(CpuOverhead_DrawingSession_DrawBitmap)
+    {
+        Fixture f;
+
+        auto bitmap = f.MakeBitmap();
+        uint32_t const count = 1000;
+
+        Run(L"DrawingSession_DrawBitmap", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ThrowIfFailed(f.DS->DrawImageAtCoords(bitmap.Get(), static_cast<float>(i), 0));
+            }
+        });
+    }
+
+    BENCHMARK(CpuOverhead_Effect_RealizeAndDraw)
+    {
+        Fixture f;
+
+        auto bitmap = f.MakeBitmap();
+        uint32_t const count = 100;
+
+        Run(L"Effect_RealizeAndDraw", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                // A new effect every time, so each draw has to realize it.
+                auto blur = Make<Effects::GaussianBlurEffect>();
+                ThrowIfFailed(blur->put_Source(As<IGraphicsEffectSource>(bitmap).Get()));
+                ThrowIfFailed(blur->put_BlurAmount(5.0f));
+
+                ThrowIfFailed(f.DS->DrawImageAtOrigin(blur.Get()));
+            }
+        });
+    }
+
+    BENCHMARK(CpuOverhead_Effect_ChangePropertyAndRedraw)
+    {
+        Fixture f;
+
+        auto bitmap = f.MakeBitmap();
+        auto blur = Make<Effects::GaussianBlurEffect>();
+        ThrowIfFailed(blur->put_Source(As<IGraphicsEffectSource>(bitmap).Get()));
+
+        uint32_t const count = 1000;
+
+        Run(L"Effect_ChangePropertyAndRedraw", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ThrowIfFailed(blur->put_BlurAmount(static_cast<float>(i % 10)));
+                ThrowIfFailed(f.DS->DrawImageAtOrigin(blur.Get()));
+            }
+        });
+    }
+
+    BENCHMARK(CpuOverhead_TextFormat_Realize)
+    {
+        CustomFontManagerAdapter::SetInstance(std::make_shared<StubFontManagerAdapter>());
+
+        auto format = Make<CanvasTextFormat>();
+        uint32_t const count = 100;
+
+        Run(L"TextFormat_Realize", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                // DWrite can't change the font size of an existing format, so
+                // this forces a new one to be realized.
+                ThrowIfFailed(format->put_FontSize(static_cast<float>(10 + i % 2)));
+                format->GetRealizedTextFormat();
+            }
+        });
+    }
+
+    BENCHMARK(CpuOverhead_ResourceManager_GetOrCreate_ExistingWrapper)
+    {
+        Fixture f;
+
+        auto bitmap = f.MakeBitmap();
+        auto d2dBitmap = GetWrappedResource<ID2D1Bitmap1>(bitmap);
+        uint32_t const count = 1000;
+
+        Run(L"ResourceManager_GetOrCreate_ExistingWrapper", count, [&]
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ResourceManager::GetOrCreate<ICanvasBitmap>(d2dBitmap.Get());
+            }
+        });
+    }
+};
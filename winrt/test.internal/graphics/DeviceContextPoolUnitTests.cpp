@@ -93,6 +93,23 @@ public:
         }
     }
 
+    TEST_METHOD_EX(DeviceContextPool_Leases_UpdatePerformanceCounters)
+    {
+        Fixture f;
+        f.CreateDeviceContextMethod.SetExpectedCalls(1);
+
+        auto before = PerformanceCounters::GetSnapshot();
+
+        f.Pool.TakeLease();
+        f.Pool.TakeLease();
+        f.Pool.TakeLease();
+
+        auto after = PerformanceCounters::GetSnapshot();
+
+        Assert::AreEqual<uint64_t>(1, after.DeviceContextsCreated - before.DeviceContextsCreated);
+        Assert::AreEqual<uint64_t>(2, after.DeviceContextsReused - before.DeviceContextsReused);
+    }
+
     TEST_METHOD_EX(DeviceContextPool_DefaultConstructedDeviceContextLease_IsFine)
     {
         DeviceContextLease lease;
@@ -131,6 +148,111 @@ public:
         Assert::AreEqual<int>(std::thread::hardware_concurrency(), f.NumberOfActiveDeviceContexts);
     }
 
+    TEST_METHOD_EX(DeviceContextPool_LeaseTakenAndReturnedOnSameThread_IsCountedAsThreadSlotHit)
+    {
+        Fixture f;
+        f.CreateDeviceContextMethod.SetExpectedCalls(1);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            auto lease = f.Pool.TakeLease();
+        }
+
+        auto statistics = f.Pool.GetStatistics();
+
+        Assert::AreEqual<uint64_t>(1, statistics.Creations);
+        Assert::AreEqual<uint64_t>(9, statistics.ThreadSlotHits);
+        Assert::AreEqual<uint64_t>(0, statistics.OverflowHits);
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_WhenThreadSlotIsOccupied_ReturnedLeasesGoToOverflow)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+
+        if (std::thread::hardware_concurrency() < 2)
+            return;
+
+        {
+            auto lease1 = f.Pool.TakeLease();
+            auto lease2 = f.Pool.TakeLease();
+        }
+
+        auto statistics = f.Pool.GetStatistics();
+
+        Assert::AreEqual<uint64_t>(100, statistics.Creations);
+        Assert::AreEqual<uint64_t>(1, statistics.ThreadSlotHits);
+        Assert::AreEqual<uint64_t>(1, statistics.OverflowHits);
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_Prewarm_CreatesContextsUpToMaxPoolSize)
+    {
+        Fixture f;
+
+        f.Pool.SetMaxPoolSize(3);
+
+        f.CreateDeviceContextMethod.SetExpectedCalls(3);
+        f.Pool.Prewarm(10);
+
+        Assert::AreEqual(3, f.NumberOfActiveDeviceContexts);
+
+        // Leases now come from the pool rather than creating new contexts
+        auto lease1 = f.Pool.TakeLease();
+        auto lease2 = f.Pool.TakeLease();
+        auto lease3 = f.Pool.TakeLease();
+
+        Assert::AreEqual(3, f.NumberOfActiveDeviceContexts);
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_Prewarm_DoesNotCreateMoreThanRequested)
+    {
+        Fixture f;
+
+        f.Pool.SetMaxPoolSize(4);
+
+        f.CreateDeviceContextMethod.SetExpectedCalls(2);
+        f.Pool.Prewarm(2);
+        f.Pool.Prewarm(2);
+        f.Pool.Prewarm(1);
+
+        Assert::AreEqual(2, f.NumberOfActiveDeviceContexts);
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_Trim_ReleasesIdleContexts_ButNotOutstandingLeases)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+
+        auto lease = f.Pool.TakeLease();
+
+        f.Pool.Trim();
+
+        Assert::AreEqual(1, f.NumberOfActiveDeviceContexts);
+        Assert::IsNotNull(lease.Get());
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_ReducingMaxPoolSize_ReleasesExcessContexts)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+
+        f.Pool.SetMaxPoolSize(1);
+        Assert::AreEqual(1u, f.Pool.GetMaxPoolSize());
+        Assert::AreEqual(1, f.NumberOfActiveDeviceContexts);
+
+        f.Pool.SetMaxPoolSize(0);
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts);
+
+        // With a zero sized pool, returned leases are discarded
+        f.CreateDeviceContextMethod.SetExpectedCalls(102);
+        f.Pool.TakeLease();
+        f.Pool.TakeLease();
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts);
+    }
+
     TEST_METHOD_EX(DeviceContextPool_WhenClosed_PoolIsEmptied)
     {
         Fixture f;
@@ -166,4 +288,15 @@ public:
 
         ExpectHResultException(RO_E_CLOSED, [&] { f.Pool.TakeLease(); });
     }
+
+    TEST_METHOD_EX(DeviceContextPool_WhenClosed_ConfigurationMethods_Fail)
+    {
+        Fixture f;
+        f.Pool.Close();
+
+        ExpectHResultException(RO_E_CLOSED, [&] { f.Pool.Prewarm(1); });
+        ExpectHResultException(RO_E_CLOSED, [&] { f.Pool.Trim(); });
+        ExpectHResultException(RO_E_CLOSED, [&] { f.Pool.GetMaxPoolSize(); });
+        ExpectHResultException(RO_E_CLOSED, [&] { f.Pool.SetMaxPoolSize(1); });
+    }
 };
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+class CachedFlagD2DEffect : public MockD2DEffect
+{
+public:
+    bool IsCached;
+
+    CachedFlagD2DEffect()
+        : IsCached(false)
+    {
+        MockSetValue =
+            [=](UINT32 index, D2D1_PROPERTY_TYPE, CONST BYTE* data, UINT32 dataSize)
+            {
+                Assert::AreEqual<UINT32>(D2D1_PROPERTY_CACHED, index);
+                Assert::AreEqual<UINT32>(sizeof(BOOL), dataSize);
+
+                IsCached = !!*reinterpret_cast<BOOL const*>(data);
+                return S_OK;
+            };
+    }
+};
+
+
+TEST_CLASS(EffectCacheBudgetUnitTests)
+{
+public:
+    struct TestEntry
+    {
+        ComPtr<CachedFlagD2DEffect> Effect;
+        std::shared_ptr<EffectCacheEntry> Entry;
+
+        TestEntry(EffectCachePriority priority = EffectCachePriority_Normal)
+            : Effect(Make<CachedFlagD2DEffect>())
+            , Entry(std::make_shared<EffectCacheEntry>(Effect.Get(), priority))
+        {
+        }
+    };
+
+    TEST_METHOD_EX(EffectCacheBudget_EntriesThatFit_AreCached)
+    {
+        EffectCacheBudget budget(100);
+        TestEntry a, b;
+
+        Assert::IsTrue(budget.TryAdmit(a.Entry, 60));
+        Assert::IsTrue(budget.TryAdmit(b.Entry, 40));
+
+        Assert::IsTrue(a.Effect->IsCached);
+        Assert::IsTrue(b.Effect->IsCached);
+        Assert::AreEqual<uint64_t>(100, budget.GetCurrentSize());
+
+        budget.Release(a.Entry.get());
+
+        Assert::IsFalse(a.Effect->IsCached);
+        Assert::AreEqual<uint64_t>(40, budget.GetCurrentSize());
+    }
+
+    TEST_METHOD_EX(EffectCacheBudget_WhenFull_EntriesOfEqualPriorityAreNotDisplaced)
+    {
+        EffectCacheBudget budget(100);
+        TestEntry a, b;
+
+        Assert::IsTrue(budget.TryAdmit(a.Entry, 80));
+        Assert::IsFalse(budget.TryAdmit(b.Entry, 40));
+
+        Assert::IsTrue(a.Effect->IsCached);
+        Assert::IsFalse(b.Effect->IsCached);
+        Assert::IsFalse(b.Entry->IsCached);
+    }
+
+    TEST_METHOD_EX(EffectCacheBudget_WhenFull_HigherPriorityEvictsLeastRecentlyUsedLowerPriority)
+    {
+        EffectCacheBudget budget(100);
+        TestEntry low1(EffectCachePriority_Low);
+        TestEntry low2(EffectCachePriority_Low);
+        TestEntry high(EffectCachePriority_High);
+
+        Assert::IsTrue(budget.TryAdmit(low1.Entry, 50));
+        Assert::IsTrue(budget.TryAdmit(low2.Entry, 50));
+
+        budget.Touch(low1.Entry.get());
+
+        Assert::IsTrue(budget.TryAdmit(high.Entry, 50));
+
+        Assert::IsTrue(low1.Effect->IsCached);
+        Assert::IsFalse(low2.Effect->IsCached);
+        Assert::IsTrue(high.Effect->IsCached);
+        Assert::AreEqual<uint64_t>(100, budget.GetCurrentSize());
+    }
+
+    TEST_METHOD_EX(EffectCacheBudget_WhenEvictionWouldNotMakeEnoughRoom_NothingIsEvicted)
+    {
+        EffectCacheBudget budget(100);
+        TestEntry low(EffectCachePriority_Low);
+        TestEntry normal(EffectCachePriority_Normal);
+        TestEntry high(EffectCachePriority_High);
+
+        Assert::IsTrue(budget.TryAdmit(low.Entry, 30));
+        Assert::IsTrue(budget.TryAdmit(normal.Entry, 60));
+
+        Assert::IsFalse(budget.TryAdmit(high.Entry, 80));
+
+        Assert::IsTrue(low.Effect->IsCached);
+        Assert::IsTrue(normal.Effect->IsCached);
+    }
+
+    TEST_METHOD_EX(EffectCacheBudget_LoweringTheMaximumSize_EvictsUntilWithinBudget)
+    {
+        EffectCacheBudget budget(100);
+        TestEntry low(EffectCachePriority_Low);
+        TestEntry high(EffectCachePriority_High);
+
+        Assert::IsTrue(budget.TryAdmit(low.Entry, 50));
+        Assert::IsTrue(budget.TryAdmit(high.Entry, 50));
+
+        budget.SetMaximumSize(60);
+
+        Assert::IsFalse(low.Effect->IsCached);
+        Assert::IsTrue(high.Effect->IsCached);
+        Assert::AreEqual<uint64_t>(50, budget.GetCurrentSize());
+    }
+
+    TEST_METHOD_EX(EffectCacheBudget_DestroyedEntries_GiveBackTheirShare)
+    {
+        EffectCacheBudget budget(100);
+
+        {
+            TestEntry a;
+            Assert::IsTrue(budget.TryAdmit(a.Entry, 70));
+        }
+
+        Assert::AreEqual<uint64_t>(0, budget.GetCurrentSize());
+
+        TestEntry b;
+        Assert::IsTrue(budget.TryAdmit(b.Entry, 70));
+    }
+};
@@ -10,6 +10,18 @@
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
+class StubD2DLookupTable3D : public RuntimeClass<
+    RuntimeClassFlags<ClassicCom>,
+    ChainInterfaces<ID2D1LookupTable3D, ID2D1Resource>>
+{
+public:
+    IFACEMETHODIMP_(void) GetFactory(ID2D1Factory**) const override
+    {
+        Assert::Fail(L"Unexpected call to GetFactory");
+    }
+};
+
+
 TEST_CLASS(EffectTransferTable3DUnitTests)
 {
     template<typename TValue, typename TCreator, typename TInitializeData, typename TValidateData>
@@ -171,6 +183,49 @@ TEST_CLASS(EffectTransferTable3DUnitTests)
         // Invalid pixel format.
         ExpectHResultException(WINCODEC_ERR_UNSUPPORTEDPIXELFORMAT, [&] { EffectTransferTable3D::CreateNew(device.Get(), 32, bytes, 2, 2, 2, PIXEL_FORMAT(B8G8R8A8UIntNormalized)); });
     }
+
+
+    TEST_METHOD_EX(EffectTransferTable3D_CreatingFromTheSameData_SharesOneLookupTable)
+    {
+        auto canvasDevice = Make<StubCanvasDevice>();
+        auto d2dContext = Make<StubD2DDeviceContext>();
+
+        canvasDevice->GetResourceCreationDeviceContextMethod.AllowAnyCall([&] { return DeviceContextLease(d2dContext); });
+
+        auto createLookupTable = [](D2D1_BUFFER_PRECISION, UINT32 const*, BYTE const*, UINT32, UINT32 const*, ID2D1LookupTable3D** result)
+        {
+            return Make<StubD2DLookupTable3D>().CopyTo(result);
+        };
+
+        Color colors[16] = { 0 };
+
+        d2dContext->CreateLookupTable3DMethod.SetExpectedCalls(1, createLookupTable);
+
+        auto table1 = EffectTransferTable3D::CreateNew(canvasDevice.Get(), 16, colors, 2, 2, 4);
+        auto table2 = EffectTransferTable3D::CreateNew(canvasDevice.Get(), 16, colors, 2, 2, 4);
+
+        // Separate wrappers, sharing the same D2D resource.
+        Assert::IsFalse(IsSameInstance(table1.Get(), table2.Get()));
+        Assert::IsTrue(IsSameInstance(table1->GetResource().Get(), table2->GetResource().Get()));
+
+        // Interop finds the first wrapper.
+        Assert::IsTrue(IsSameInstance(table1.Get(), ResourceManager::GetOrCreate<IEffectTransferTable3D>(canvasDevice.Get(), table1->GetResource().Get()).Get()));
+
+        // Closing one wrapper leaves the other working.
+        ThrowIfFailed(table1->Close());
+        Assert::IsNotNull(table2->GetResource().Get());
+
+        Expectations::Instance()->Validate();
+
+        // The same data with a different shape, or different data, needs a new lookup table.
+        d2dContext->CreateLookupTable3DMethod.SetExpectedCalls(2, createLookupTable);
+
+        EffectTransferTable3D::CreateNew(canvasDevice.Get(), 16, colors, 2, 4, 2);
+
+        colors[0].R = 1;
+
+        EffectTransferTable3D::CreateNew(canvasDevice.Get(), 16, colors, 2, 2, 4);
+    }
 };
 
 #endif
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/effects/DownsampledBlurEffectImpl.h>
+#include <lib/effects/FastGaussianBlurEffect.h>
+#include <lib/effects/FastShadowEffect.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+TEST_CLASS(FastBlurEffectUnitTests)
+{
+    //
+    // The downsampled blur itself runs inside Direct2D, so is covered by
+    // test.external.  These tests cover the choice of scale and the
+    // strongly typed wrappers.
+    //
+
+    TEST_METHOD_EX(GetDownsampledBlurScale_SmallBlursAreNotDownscaled)
+    {
+        Assert::AreEqual(1.0f, GetDownsampledBlurScale(0, 0.5f));
+        Assert::AreEqual(1.0f, GetDownsampledBlurScale(3, 0.5f));
+        Assert::AreEqual(1.0f, GetDownsampledBlurScale(17, 0.5f));
+        Assert::AreEqual(1.0f, GetDownsampledBlurScale(3, 0));
+    }
+
+    TEST_METHOD_EX(GetDownsampledBlurScale_HalvesUntilBlurIsSmall)
+    {
+        // At quality 0 the downscaled blur is kept between 2 and 4 pixels.
+        Assert::AreEqual(0.5f, GetDownsampledBlurScale(4, 0));
+        Assert::AreEqual(0.25f, GetDownsampledBlurScale(10, 0));
+        Assert::AreEqual(0.125f, GetDownsampledBlurScale(20, 0));
+
+        // At quality 1 it is kept between 16 and 32.
+        Assert::AreEqual(1.0f, GetDownsampledBlurScale(20, 1));
+        Assert::AreEqual(0.5f, GetDownsampledBlurScale(40, 1));
+        Assert::AreEqual(0.125f, GetDownsampledBlurScale(250, 1));
+    }
+
+    TEST_METHOD_EX(GetDownsampledBlurScale_IsLimited)
+    {
+        Assert::AreEqual(1.0f / 32, GetDownsampledBlurScale(250, 0));
+    }
+
+    TEST_METHOD_EX(FastGaussianBlurEffect_Defaults)
+    {
+        auto effect = Make<FastGaussianBlurEffect>();
+
+        float blurAmount;
+        EffectOptimization optimization;
+        EffectBorderMode borderMode;
+        float quality;
+
+        ThrowIfFailed(effect->get_BlurAmount(&blurAmount));
+        ThrowIfFailed(effect->get_Optimization(&optimization));
+        ThrowIfFailed(effect->get_BorderMode(&borderMode));
+        ThrowIfFailed(effect->get_Quality(&quality));
+
+        Assert::AreEqual(3.0f, blurAmount);
+        Assert::IsTrue(optimization == EffectOptimization::Balanced);
+        Assert::IsTrue(borderMode == EffectBorderMode::Soft);
+        Assert::AreEqual(0.5f, quality);
+
+        GUID effectId;
+        ThrowIfFailed(effect->GetEffectId(&effectId));
+        Assert::IsTrue(IsEqualGUID(CLSID_FastGaussianBlurEffect, effectId));
+    }
+
+    TEST_METHOD_EX(FastGaussianBlurEffect_ValidatesProperties)
+    {
+        auto effect = Make<FastGaussianBlurEffect>();
+
+        Assert::AreEqual(E_INVALIDARG, effect->put_BlurAmount(-1));
+        Assert::AreEqual(E_INVALIDARG, effect->put_BlurAmount(251));
+        Assert::AreEqual(E_INVALIDARG, effect->put_Quality(-0.1f));
+        Assert::AreEqual(E_INVALIDARG, effect->put_Quality(1.1f));
+
+        ThrowIfFailed(effect->put_BlurAmount(100));
+        ThrowIfFailed(effect->put_Quality(1));
+
+        float value;
+        ThrowIfFailed(effect->get_BlurAmount(&value));
+        Assert::AreEqual(100.0f, value);
+        ThrowIfFailed(effect->get_Quality(&value));
+        Assert::AreEqual(1.0f, value);
+    }
+
+    TEST_METHOD_EX(FastShadowEffect_ColorProperties)
+    {
+        auto effect = Make<FastShadowEffect>();
+
+        Color color;
+        ThrowIfFailed(effect->get_ShadowColor(&color));
+        Assert::AreEqual(Color{ 255, 0, 0, 0 }, color);
+
+        ThrowIfFailed(effect->put_ShadowColorHdr(Numerics::Vector4{ 1, 0, 0, 1 }));
+        ThrowIfFailed(effect->get_ShadowColor(&color));
+        Assert::AreEqual(Color{ 255, 255, 0, 0 }, color);
+
+        float quality;
+        ThrowIfFailed(effect->get_Quality(&quality));
+        Assert::AreEqual(0.5f, quality);
+        Assert::AreEqual(E_INVALIDARG, effect->put_Quality(2));
+    }
+
+    TEST_METHOD_EX(FastEffects_CanBeAnimatedAndMapped)
+    {
+        auto effect = Make<FastGaussianBlurEffect>();
+
+        UINT index;
+        GRAPHICS_EFFECT_PROPERTY_MAPPING mapping;
+
+        ThrowIfFailed(effect->GetNamedPropertyMapping(L"Quality", &index, &mapping));
+        Assert::AreEqual<UINT>(FAST_GAUSSIANBLUR_PROP_QUALITY, index);
+        Assert::AreEqual<int>(GRAPHICS_EFFECT_PROPERTY_MAPPING_DIRECT, mapping);
+
+        EffectKeyframe keyframes[] = { { TimeSpan{ 0 }, Numerics::Vector4{ 0, 0, 0, 0 } }, { TimeSpan{ 100 }, Numerics::Vector4{ 50, 0, 0, 0 } } };
+        ThrowIfFailed(effect->Animate(WinString(L"BlurAmount"), 2, keyframes, EffectAnimationEasing::Linear));
+        ThrowIfFailed(effect->SetAnimationTime(TimeSpan{ 40 }));
+
+        float blurAmount;
+        ThrowIfFailed(effect->get_BlurAmount(&blurAmount));
+        Assert::AreEqual(20.0f, blurAmount);
+    }
+};
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/text/FontFallbackCache.h>
+
+TEST_CLASS(FontFallbackCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        FontFallbackCache Cache;
+        FontFallbackCache::BaseFont BaseFont;
+        FontFallbackCache::Mapping Latin;
+        FontFallbackCache::Mapping Greek;
+
+        Fixture()
+        {
+            BaseFont = FontFallbackCache::BaseFont{ Make<MockDWriteFontCollection>(), L"Segoe UI", DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, L"en-us" };
+            Latin = FontFallbackCache::Mapping{ Make<MockDWriteFont>(), 1.0f };
+            Greek = FontFallbackCache::Mapping{ Make<MockDWriteFont>(), 1.0f };
+        }
+
+        uint32_t TryMap(wchar_t const* text, FontFallbackCache::Mapping* mapping)
+        {
+            return Cache.TryMapCharacters(BaseFont, text, static_cast<uint32_t>(wcslen(text)), mapping);
+        }
+
+        void Add(wchar_t const* text, uint32_t mappedLength, FontFallbackCache::Mapping const& mapping)
+        {
+            Cache.AddMapping(BaseFont, text, static_cast<uint32_t>(wcslen(text)), mappedLength, mapping);
+        }
+    };
+
+    TEST_METHOD_EX(FontFallbackCache_EmptyCache_MapsNothing)
+    {
+        Fixture f;
+        FontFallbackCache::Mapping mapping;
+
+        Assert::AreEqual(0u, f.TryMap(L"abc", &mapping));
+    }
+
+    TEST_METHOD_EX(FontFallbackCache_MappedCharacters_AreReusedInOtherStrings)
+    {
+        Fixture f;
+
+        f.Add(L"ab\x03b1\x03b2", 2, f.Latin);
+        f.Add(L"\x03b1\x03b2", 2, f.Greek);
+
+        FontFallbackCache::Mapping mapping;
+
+        Assert::AreEqual(3u, f.TryMap(L"bab\x03b1", &mapping));
+        Assert::IsTrue(mapping.Font == f.Latin.Font);
+
+        Assert::AreEqual(2u, f.TryMap(L"\x03b2\x03b1" L"c", &mapping));
+        Assert::IsTrue(mapping.Font == f.Greek.Font);
+
+        // 'c' has never been mapped.
+        Assert::AreEqual(0u, f.TryMap(L"cab", &mapping));
+    }
+
+    TEST_METHOD_EX(FontFallbackCache_DifferentBaseFont_IsCachedSeparately)
+    {
+        Fixture f;
+
+        f.Add(L"abc", 3, f.Latin);
+
+        FontFallbackCache::Mapping mapping;
+
+        auto otherBaseFont = f.BaseFont;
+        otherBaseFont.Weight = DWRITE_FONT_WEIGHT_BOLD;
+        Assert::AreEqual(0u, f.Cache.TryMapCharacters(otherBaseFont, L"abc", 3, &mapping));
+
+        otherBaseFont = f.BaseFont;
+        otherBaseFont.LocaleName = L"ja-jp";
+        Assert::AreEqual(0u, f.Cache.TryMapCharacters(otherBaseFont, L"abc", 3, &mapping));
+
+        otherBaseFont = f.BaseFont;
+        otherBaseFont.Collection = Make<MockDWriteFontCollection>();
+        Assert::AreEqual(0u, f.Cache.TryMapCharacters(otherBaseFont, L"abc", 3, &mapping));
+    }
+
+    TEST_METHOD_EX(FontFallbackCache_CharactersThatCombineWithNeighbours_AreNotCached)
+    {
+        Fixture f;
+
+        // 'e' followed by a combining acute accent, then a surrogate pair.
+        f.Add(L"e\x0301\xd83d\xde00", 4, f.Latin);
+
+        FontFallbackCache::Mapping mapping;
+
+        Assert::AreEqual(0u, f.TryMap(L"e", &mapping));
+        Assert::AreEqual(0u, f.TryMap(L"\x0301", &mapping));
+        Assert::AreEqual(0u, f.TryMap(L"\xd83d\xde00", &mapping));
+
+        // A cached character isn't used when the next one combines with it.
+        f.Add(L"a", 1, f.Latin);
+        Assert::AreEqual(1u, f.TryMap(L"a", &mapping));
+        Assert::AreEqual(0u, f.TryMap(L"a\x0301", &mapping));
+        Assert::AreEqual(1u, f.TryMap(L"aa\x0301", &mapping));
+    }
+
+    TEST_METHOD_EX(FontFallbackCache_LeastRecentlyUsedBaseFontIsForgotten)
+    {
+        Fixture f;
+
+        f.Add(L"a", 1, f.Latin);
+
+        for (uint32_t i = 0; i < FontFallbackCache::BaseFontCapacity; i++)
+        {
+            auto otherBaseFont = f.BaseFont;
+            otherBaseFont.FamilyName = std::to_wstring(i);
+            f.Cache.AddMapping(otherBaseFont, L"a", 1, 1, f.Latin);
+        }
+
+        FontFallbackCache::Mapping mapping;
+        Assert::AreEqual(0u, f.TryMap(L"a", &mapping));
+    }
+
+    TEST_METHOD_EX(FontFallbackCache_Clear_ForgetsEverything)
+    {
+        Fixture f;
+
+        f.Add(L"a", 1, f.Latin);
+        f.Cache.Clear();
+
+        FontFallbackCache::Mapping mapping;
+        Assert::AreEqual(0u, f.TryMap(L"a", &mapping));
+    }
+};
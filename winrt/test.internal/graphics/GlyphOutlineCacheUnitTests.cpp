@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/geometry/GlyphOutlineCache.h>
+#include "mocks/MockD2DGeometrySink.h"
+#include "mocks/MockDWriteFontFace.h"
+
+TEST_CLASS(GlyphOutlineCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        ComPtr<MockDWriteFontFace> FontFace;
+        ComPtr<MockD2DGeometrySink> Sink;
+        GlyphOutlineCache Cache;
+
+        std::vector<D2D1_POINT_2F> BeginFigurePoints;
+
+        Fixture()
+            : FontFace(Make<MockDWriteFontFace>())
+            , Sink(Make<MockD2DGeometrySink>())
+        {
+            Sink->SetFillModeMethod.AllowAnyCall();
+            Sink->BeginFigureMethod.AllowAnyCall(
+                [this](D2D1_POINT_2F point, D2D1_FIGURE_BEGIN)
+                {
+                    BeginFigurePoints.push_back(point);
+                });
+            Sink->AddLinesMethod.AllowAnyCall();
+            Sink->EndFigureMethod.AllowAnyCall();
+        }
+
+        // Each glyph's outline is a line starting at (glyph index, 0).
+        void ExpectGetGlyphRunOutline(int expectedCalls)
+        {
+            FontFace->GetGlyphRunOutlineMethod.SetExpectedCalls(expectedCalls,
+                [](FLOAT, UINT16 const* glyphIndices, FLOAT const* glyphAdvances, DWRITE_GLYPH_OFFSET const*, uint32_t glyphCount, BOOL, BOOL isRightToLeft, IDWriteGeometrySink* sink)
+                {
+                    Assert::AreEqual(1u, glyphCount);
+                    Assert::IsNull(glyphAdvances);
+                    Assert::IsFalse(!!isRightToLeft);
+
+                    D2D1_POINT_2F end{ 0, 1 };
+
+                    sink->SetFillMode(D2D1_FILL_MODE_WINDING);
+                    sink->BeginFigure(D2D1_POINT_2F{ static_cast<float>(glyphIndices[0]), 0 }, D2D1_FIGURE_BEGIN_FILLED);
+                    sink->AddLines(&end, 1);
+                    sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+                    return S_OK;
+                });
+        }
+
+        void GetGlyphRunOutline(std::vector<UINT16> const& glyphIndices, std::vector<FLOAT> const& advances, float emSize = 10, uint32_t bidiLevel = 0)
+        {
+            DWRITE_GLYPH_RUN glyphRun{};
+            glyphRun.fontFace = FontFace.Get();
+            glyphRun.fontEmSize = emSize;
+            glyphRun.glyphCount = static_cast<uint32_t>(glyphIndices.size());
+            glyphRun.glyphIndices = glyphIndices.data();
+            glyphRun.glyphAdvances = advances.data();
+            glyphRun.bidiLevel = bidiLevel;
+
+            Cache.GetGlyphRunOutline(&glyphRun, Sink.Get());
+        }
+    };
+
+    TEST_METHOD_EX(GlyphOutlineCache_RepeatedGlyphs_AreOnlyOutlinedOnce)
+    {
+        Fixture f;
+
+        f.ExpectGetGlyphRunOutline(2);
+
+        f.GetGlyphRunOutline({ 1, 2, 1 }, { 10, 20, 30 });
+        f.GetGlyphRunOutline({ 2, 1 }, { 10, 20 });
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(2u, statistics.Count);
+        Assert::AreEqual(3ull, statistics.HitCount);
+        Assert::AreEqual(2ull, statistics.MissCount);
+    }
+
+    TEST_METHOD_EX(GlyphOutlineCache_DifferentSizes_AreCachedSeparately)
+    {
+        Fixture f;
+
+        f.ExpectGetGlyphRunOutline(2);
+
+        f.GetGlyphRunOutline({ 1 }, { 10 }, 10);
+        f.GetGlyphRunOutline({ 1 }, { 10 }, 20);
+        f.GetGlyphRunOutline({ 1 }, { 10 }, 10);
+    }
+
+    TEST_METHOD_EX(GlyphOutlineCache_GlyphsArePlacedByTheirAdvances)
+    {
+        Fixture f;
+
+        f.ExpectGetGlyphRunOutline(2);
+
+        f.GetGlyphRunOutline({ 1, 2, 1 }, { 10, 20, 30 });
+
+        Assert::AreEqual(3u, static_cast<uint32_t>(f.BeginFigurePoints.size()));
+        Assert::AreEqual(1.0f, f.BeginFigurePoints[0].x);
+        Assert::AreEqual(12.0f, f.BeginFigurePoints[1].x);
+        Assert::AreEqual(31.0f, f.BeginFigurePoints[2].x);
+    }
+
+    TEST_METHOD_EX(GlyphOutlineCache_RightToLeftGlyphs_ExtendLeftwards)
+    {
+        Fixture f;
+
+        f.ExpectGetGlyphRunOutline(2);
+
+        f.GetGlyphRunOutline({ 1, 2 }, { 10, 20 }, 10, 1);
+
+        Assert::AreEqual(2u, static_cast<uint32_t>(f.BeginFigurePoints.size()));
+        Assert::AreEqual(-9.0f, f.BeginFigurePoints[0].x);
+        Assert::AreEqual(-28.0f, f.BeginFigurePoints[1].x);
+    }
+
+    TEST_METHOD_EX(GlyphOutlineCache_MaximumCount_EvictsLeastRecentlyUsed)
+    {
+        Fixture f;
+
+        f.Cache.SetMaximumCount(2);
+        f.ExpectGetGlyphRunOutline(4);
+
+        f.GetGlyphRunOutline({ 1, 2 }, { 10, 10 });
+        f.GetGlyphRunOutline({ 1 }, { 10 });            // Glyph 2 is now the oldest.
+        f.GetGlyphRunOutline({ 3 }, { 10 });            // Evicts glyph 2.
+        f.GetGlyphRunOutline({ 1 }, { 10 });
+        f.GetGlyphRunOutline({ 2 }, { 10 });
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(2u, statistics.Count);
+        Assert::AreEqual(2ull, statistics.EvictionCount);
+    }
+
+    TEST_METHOD_EX(GlyphOutlineCache_MaximumCountOfZero_GoesStraightToFontFace)
+    {
+        Fixture f;
+
+        f.Cache.SetMaximumCount(0);
+
+        f.FontFace->GetGlyphRunOutlineMethod.SetExpectedCalls(2,
+            [](FLOAT, UINT16 const*, FLOAT const* glyphAdvances, DWRITE_GLYPH_OFFSET const*, uint32_t glyphCount, BOOL, BOOL, IDWriteGeometrySink*)
+            {
+                Assert::AreEqual(2u, glyphCount);
+                Assert::IsNotNull(glyphAdvances);
+                return S_OK;
+            });
+
+        f.GetGlyphRunOutline({ 1, 1 }, { 10, 10 });
+        f.GetGlyphRunOutline({ 1, 1 }, { 10, 10 });
+
+        Assert::AreEqual(0u, f.Cache.GetStatistics().Count);
+    }
+};
@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/geometry/GeometrySink.h>
+#include <lib/geometry/PathDataParser.h>
+
+typedef CanvasGeometryPathCommand Command;
+
+// Segment data values for BeginFigure and EndFigure.
+static const float sc_filled = static_cast<float>(D2D1_FIGURE_BEGIN_FILLED);
+static const float sc_open = static_cast<float>(D2D1_FIGURE_END_OPEN);
+static const float sc_closed = static_cast<float>(D2D1_FIGURE_END_CLOSED);
+
+TEST_CLASS(PathDataParserUnitTests)
+{
+public:
+    struct ParseResult
+    {
+        std::vector<Command> Commands;
+        std::vector<float> SegmentData;
+    };
+
+    template<typename CHAR>
+    static ParseResult Parse(CHAR const* pathData, size_t length)
+    {
+        auto sink = Make<PathDataSink>();
+
+        PathDataParser<CHAR>::Parse(pathData, static_cast<uint32_t>(length), sink.Get());
+
+        return ParseResult{ sink->GetCommands(), sink->GetSegmentData() };
+    }
+
+    static ParseResult Parse(wchar_t const* pathData)
+    {
+        return Parse(pathData, wcslen(pathData));
+    }
+
+    static void AssertParsesAs(wchar_t const* pathData, std::vector<Command> const& expectedCommands, std::vector<float> const& expectedSegmentData)
+    {
+        auto result = Parse(pathData);
+
+        Assert::AreEqual<uint32_t>(static_cast<uint32_t>(expectedCommands.size()), static_cast<uint32_t>(result.Commands.size()));
+        for (size_t i = 0; i < expectedCommands.size(); i++)
+            Assert::AreEqual(static_cast<int>(expectedCommands[i]), static_cast<int>(result.Commands[i]));
+
+        Assert::AreEqual<uint32_t>(static_cast<uint32_t>(expectedSegmentData.size()), static_cast<uint32_t>(result.SegmentData.size()));
+        for (size_t i = 0; i < expectedSegmentData.size(); i++)
+            Assert::AreEqual(expectedSegmentData[i], result.SegmentData[i], 0.0001f);
+    }
+
+    static void AssertIsInvalid(wchar_t const* pathData)
+    {
+        ExpectHResultException(E_INVALIDARG, [&] { Parse(pathData); });
+    }
+
+    TEST_METHOD_EX(PathDataParser_EmptyData_AddsNothing)
+    {
+        AssertParsesAs(L"", {}, {});
+        AssertParsesAs(L" \t\r\n", {}, {});
+    }
+
+    TEST_METHOD_EX(PathDataParser_AbsoluteLines)
+    {
+        AssertParsesAs(L"M 1 2 L 3 4 H 5 V 6 Z",
+            { Command::BeginFigure, Command::AddLine, Command::AddLine, Command::AddLine, Command::EndFigure },
+            { 1, 2, sc_filled, 3, 4, 5, 4, 5, 6, sc_closed });
+    }
+
+    TEST_METHOD_EX(PathDataParser_RelativeLines)
+    {
+        AssertParsesAs(L"m1,2 l3,4 h5 v6",
+            { Command::BeginFigure, Command::AddLine, Command::AddLine, Command::AddLine, Command::EndFigure },
+            { 1, 2, sc_filled, 4, 6, 9, 6, 9, 12, sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_RepeatedMoveTo_IsTreatedAsLineTo)
+    {
+        AssertParsesAs(L"M1 2 3 4m1 1 1 1",
+            { Command::BeginFigure, Command::AddLine, Command::EndFigure, Command::BeginFigure, Command::AddLine, Command::EndFigure },
+            { 1, 2, sc_filled, 3, 4, sc_open, 4, 5, sc_filled, 5, 6, sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_NumbersThatRunTogether)
+    {
+        AssertParsesAs(L"M-1-2L.5.5L1e1-2E-1L+3,.25e+1",
+            { Command::BeginFigure, Command::AddLine, Command::AddLine, Command::AddLine, Command::EndFigure },
+            { -1, -2, sc_filled, 0.5f, 0.5f, 10, -0.2f, 3, 2.5f, sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_CubicBeziers_ReflectPreviousControlPoint)
+    {
+        AssertParsesAs(L"M0 0 C1 2 3 4 5 6 S7 8 9 10 s1 1 2 2",
+            { Command::BeginFigure, Command::AddCubicBezier, Command::AddCubicBezier, Command::AddCubicBezier, Command::EndFigure },
+            {
+                0, 0, sc_filled,
+                1, 2, 3, 4, 5, 6,
+                7, 8, 7, 8, 9, 10,
+                11, 12, 10, 11, 11, 12,
+                sc_open
+            });
+
+        // Without a previous cubic, the first control point is the current point.
+        AssertParsesAs(L"M1 1 Q2 2 3 3 S4 4 5 5",
+            { Command::BeginFigure, Command::AddQuadraticBezier, Command::AddCubicBezier, Command::EndFigure },
+            { 1, 1, sc_filled, 2, 2, 3, 3, 3, 3, 4, 4, 5, 5, sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_QuadraticBeziers_ReflectPreviousControlPoint)
+    {
+        AssertParsesAs(L"M0 0 Q1 1 2 0 T4 0 t2 0",
+            { Command::BeginFigure, Command::AddQuadraticBezier, Command::AddQuadraticBezier, Command::AddQuadraticBezier, Command::EndFigure },
+            { 0, 0, sc_filled, 1, 1, 2, 0, 3, -1, 4, 0, 5, 1, 6, 0, sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_Arcs)
+    {
+        AssertParsesAs(L"M0 0 A10 20 30 1 0 40 50 a5,5 0 0,1 10,0",
+            { Command::BeginFigure, Command::AddArc, Command::AddArc, Command::EndFigure },
+            {
+                0, 0, sc_filled,
+                40, 50, 10, 20, DirectX::XMConvertToRadians(30), static_cast<float>(D2D1_SWEEP_DIRECTION_COUNTER_CLOCKWISE), static_cast<float>(D2D1_ARC_SIZE_LARGE),
+                50, 50, 5, 5, 0, static_cast<float>(D2D1_SWEEP_DIRECTION_CLOCKWISE), static_cast<float>(D2D1_ARC_SIZE_SMALL),
+                sc_open
+            });
+    }
+
+    TEST_METHOD_EX(PathDataParser_ArcFlagsWithoutSeparators)
+    {
+        AssertParsesAs(L"M0 0a1 1 0 1110 0",
+            { Command::BeginFigure, Command::AddArc, Command::EndFigure },
+            { 0, 0, sc_filled, 10, 0, 1, 1, 0, static_cast<float>(D2D1_SWEEP_DIRECTION_CLOCKWISE), static_cast<float>(D2D1_ARC_SIZE_LARGE), sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_DegenerateArcs)
+    {
+        // A zero radius draws a line, and an arc to the current point is omitted.
+        AssertParsesAs(L"M0 0 A0 5 0 0 0 10 10 A5 5 0 0 0 10 10",
+            { Command::BeginFigure, Command::AddLine, Command::EndFigure },
+            { 0, 0, sc_filled, 10, 10, sc_open });
+    }
+
+    TEST_METHOD_EX(PathDataParser_DrawingAfterClosePath_StartsFigureAtPreviousStart)
+    {
+        AssertParsesAs(L"M1 1 L5 1 Z l0 4 z",
+            { Command::BeginFigure, Command::AddLine, Command::EndFigure, Command::BeginFigure, Command::AddLine, Command::EndFigure },
+            { 1, 1, sc_filled, 5, 1, sc_closed, 1, 1, sc_filled, 1, 5, sc_closed });
+    }
+
+    TEST_METHOD_EX(PathDataParser_Utf8)
+    {
+        char pathData[] = "M1 2L3 4";
+
+        auto result = Parse(pathData, strlen(pathData));
+
+        Assert::AreEqual<uint32_t>(3, static_cast<uint32_t>(result.Commands.size()));
+        Assert::AreEqual(3.0f, result.SegmentData[3]);
+        Assert::AreEqual(4.0f, result.SegmentData[4]);
+    }
+
+    TEST_METHOD_EX(PathDataParser_InvalidData)
+    {
+        AssertIsInvalid(L"L1 2");           // Doesn't start with a moveto
+        AssertIsInvalid(L"Z");
+        AssertIsInvalid(L"1 2");
+        AssertIsInvalid(L"M1");             // Missing argument
+        AssertIsInvalid(L"M1 2 L");
+        AssertIsInvalid(L"M1 2 X3 4");      // Unknown command
+        AssertIsInvalid(L"M1 2 Z 3 4");     // Closepath has no arguments to repeat
+        AssertIsInvalid(L"M1,,2");          // Two separators
+        AssertIsInvalid(L"M. 2");           // No digits
+        AssertIsInvalid(L"M0 0 A1 1 0 2 0 3 3"); // Bad arc flag
+        AssertIsInvalid(L"M1e999 0");       // Out of range
+        AssertIsInvalid(L"M0 0 C1 2 3");
+    }
+};
@@ -267,6 +267,60 @@ TEST_CLASS(PixelShaderEffectUnitTests)
     }
 
 
+    TEST_METHOD_EX(PixelShaderEffect_SetProperties_PassesWholeBatchThroughToD2D)
+    {
+        Fixture f;
+
+        // Construct a shader description containing two integer variables.
+        D3D11_SHADER_VARIABLE_DESC variableDescA = { "a", 0,           sizeof(int) };
+        D3D11_SHADER_VARIABLE_DESC variableDescB = { "b", sizeof(int), sizeof(int) };
+        D3D11_SHADER_TYPE_DESC variableType = { D3D_SVC_SCALAR, D3D_SVT_INT, 1, 1 };
+
+        ShaderDescription desc;
+        desc.Variables.push_back(ShaderVariable(variableDescA, variableType));
+        desc.Variables.push_back(ShaderVariable(variableDescB, variableType));
+
+        auto sharedState = MakeSharedShaderState(desc, std::vector<BYTE>(sizeof(int) * 2));
+        auto effect = Make<PixelShaderEffect>(nullptr, nullptr, sharedState.Get());
+
+        // Realize the effect.
+        effect->GetD2DImage(f.CanvasDevice.Get(), f.DeviceContext.Get(), GetImageFlags::None, 0, nullptr);
+
+        auto& d2dConstants = f.GetEffectPropertyValue<std::pair<int, int>>(PixelShaderEffectProperty::Constants);
+
+        // Set both values at once, listed out of order.
+        auto values = Make<Map<HSTRING, IInspectable*>>();
+
+        boolean replaced;
+        ThrowIfFailed(values->Insert(HStringReference(L"b").Get(), Make<Nullable<int>>(7).Get(), &replaced));
+        ThrowIfFailed(values->Insert(HStringReference(L"a").Get(), Make<Nullable<int>>(3).Get(), &replaced));
+
+        ThrowIfFailed(effect->SetProperties(values.Get()));
+
+        Assert::AreEqual(3, d2dConstants.first);
+        Assert::AreEqual(7, d2dConstants.second);
+
+        // An unknown name or wrong type fails without changing either value.
+        ThrowIfFailed(values->Insert(HStringReference(L"a").Get(), Make<Nullable<int>>(4).Get(), &replaced));
+        ThrowIfFailed(values->Insert(HStringReference(L"b").Get(), Make<Nullable<float>>(1.0f).Get(), &replaced));
+
+        Assert::AreEqual(E_INVALIDARG, effect->SetProperties(values.Get()));
+
+        ThrowIfFailed(values->Insert(HStringReference(L"b").Get(), Make<Nullable<int>>(8).Get(), &replaced));
+        ThrowIfFailed(values->Insert(HStringReference(L"c").Get(), Make<Nullable<int>>(1).Get(), &replaced));
+
+        Assert::AreEqual(E_INVALIDARG, effect->SetProperties(values.Get()));
+
+        Assert::AreEqual(3, d2dConstants.first);
+        Assert::AreEqual(7, d2dConstants.second);
+
+        auto storedConstants = reinterpret_cast<std::pair<int, int> const*>(sharedState->Constants().data());
+
+        Assert::AreEqual(3, storedConstants->first);
+        Assert::AreEqual(7, storedConstants->second);
+    }
+
+
     TEST_METHOD_EX(PixelShaderEffect_CoordinateMappingChangesArePassedThroughToD2D)
     {
         Fixture f;
@@ -277,6 +331,8 @@ TEST_CLASS(PixelShaderEffectUnitTests)
         // Change some coordinate mapping settings.
         ThrowIfFailed(effect->put_Source1Mapping(SamplerCoordinateMapping::OneToOne));
         ThrowIfFailed(effect->put_Source2Mapping(SamplerCoordinateMapping::Offset));
+        ThrowIfFailed(effect->put_Source3Mapping(SamplerCoordinateMapping::Transformed));
+        ThrowIfFailed(effect->put_Source3MappingTransform(Numerics::Matrix3x2{ 2, 0, 0, 2, 5, 7 }));
         ThrowIfFailed(effect->put_Source5BorderMode(EffectBorderMode::Hard));
         ThrowIfFailed(effect->put_MaxSamplerOffset(23));
 
@@ -288,6 +344,9 @@ TEST_CLASS(PixelShaderEffectUnitTests)
 
         Assert::AreEqual(SamplerCoordinateMapping::OneToOne, d2dMapping.Mapping[0]);
         Assert::AreEqual(SamplerCoordinateMapping::Offset, d2dMapping.Mapping[1]);
+        Assert::AreEqual(SamplerCoordinateMapping::Transformed, d2dMapping.Mapping[2]);
+        Assert::AreEqual(Numerics::Matrix3x2{ 2, 0, 0, 2, 5, 7 }, d2dMapping.Transform[2]);
+        Assert::AreEqual(Identity3x2(), d2dMapping.Transform[0]);
         Assert::AreEqual(EffectBorderMode::Hard, d2dMapping.BorderMode[4]);
         Assert::AreEqual(23, d2dMapping.MaxOffset);
 
@@ -301,6 +360,9 @@ TEST_CLASS(PixelShaderEffectUnitTests)
         ThrowIfFailed(effect->put_Source5BorderMode(EffectBorderMode::Soft));
         Assert::AreEqual(EffectBorderMode::Soft, d2dMapping.BorderMode[4]);
 
+        ThrowIfFailed(effect->put_Source3MappingTransform(Identity3x2()));
+        Assert::AreEqual(Identity3x2(), d2dMapping.Transform[2]);
+
         ThrowIfFailed(effect->put_MaxSamplerOffset(42));
         Assert::AreEqual(42, d2dMapping.MaxOffset);
     }
@@ -558,6 +620,53 @@ public:
     }
 
 
+    TEST_METHOD_EX(PixelShaderEffectImpl_LinkableShader_UsesSingleNodeGraph)
+    {
+        Fixture f;
+        PixelShaderEffectImpl::Register(f.Factory.Get());
+
+        auto impl = Make<PixelShaderEffectImpl>();
+
+        ThrowIfFailed(impl->Initialize(f.MockEffectContext.Get(), f.MockTransformGraph.Get()));
+
+        ShaderDescription desc;
+        desc.InputCount = 2;
+        desc.SupportsLinking = true;
+
+        auto sharedState = MakeSharedShaderState(desc);
+
+        ThrowIfFailed(f.FindBinding(L"SharedState").setFunction(impl.Get(), reinterpret_cast<BYTE*>(sharedState.GetAddressOf()), sizeof(ISharedShaderState*)));
+
+        f.MockEffectContext->LoadPixelShaderMethod.SetExpectedCalls(1);
+
+        // With soft borders, the shader transform should be the only node, so D2D can link it.
+        f.MockTransformGraph->SetSingleTransformNodeMethod.SetExpectedCalls(1, [](ID2D1TransformNode* node)
+        {
+            Assert::IsNotNull(MaybeAs<ID2D1DrawTransform>(node).Get());
+            return S_OK;
+        });
+
+        ThrowIfFailed(impl->PrepareForRender(D2D1_CHANGE_TYPE_NONE));
+
+        Expectations::Instance()->Validate();
+
+        // Hard borders need a border transform, so fall back to the full graph.
+        CoordinateMappingState mapping;
+        mapping.BorderMode[1] = EffectBorderMode::Hard;
+
+        ThrowIfFailed(f.FindBinding(L"CoordinateMapping").setFunction(impl.Get(), reinterpret_cast<BYTE*>(&mapping), sizeof(mapping)));
+
+        f.MockEffectContext->CreateBorderTransformMethod.SetExpectedCalls(1, [](D2D1_EXTEND_MODE, D2D1_EXTEND_MODE, ID2D1BorderTransform** transform)
+        {
+            return Make<MockD2DBorderTransform>().CopyTo(transform);
+        });
+
+        f.ExpectTransformGraph(desc.InputCount, 1);
+
+        ThrowIfFailed(impl->PrepareForRender(D2D1_CHANGE_TYPE_NONE));
+    }
+
+
     TEST_METHOD_EX(PixelShaderEffectImpl_SharedState)
     {
         Fixture f;
@@ -672,6 +781,13 @@ public:
         mockDrawInfo->SetPixelShaderConstantBufferMethod.SetExpectedCalls(1, validateConstants);
 
         ThrowIfFailed(impl->PrepareForRender(D2D1_CHANGE_TYPE_NONE));
+
+        Expectations::Instance()->Validate();
+
+        // Setting the same constants again should not cause them to be set a second time.
+        ThrowIfFailed(binding.setFunction(impl.Get(), constants.data(), static_cast<unsigned>(constants.size())));
+
+        ThrowIfFailed(impl->PrepareForRender(D2D1_CHANGE_TYPE_NONE));
     }
 
 
@@ -1000,6 +1116,33 @@ public:
     }
 
 
+    TEST_METHOD_EX(PixelShaderTransform_MapInputRectsToOutputRect_WhenOutputNode_ReturnsUnion)
+    {
+        auto mapping = std::make_shared<CoordinateMappingState>();
+
+        mapping->Mapping[0] = SamplerCoordinateMapping::OneToOne;
+        mapping->Mapping[1] = SamplerCoordinateMapping::OneToOne;
+
+        auto transform = Make<PixelShaderTransform>(nullptr, mapping);
+
+        transform->SetIsOutputNode(true);
+
+        D2D1_RECT_L inputs[] =
+        {
+            { 1, 2, 3, 4 },
+            { 2, 1, 5, 3 },
+        };
+
+        D2D1_RECT_L output;
+        D2D1_RECT_L outputOpaqueSubRect;
+
+        ThrowIfFailed(transform->MapInputRectsToOutputRect(inputs, nullptr, _countof(inputs), &output, &outputOpaqueSubRect));
+
+        Assert::AreEqual(D2D1_RECT_L{ 1, 1, 5, 4 }, output);
+        Assert::AreEqual(D2D1_RECT_L{ 0, 0, 0, 0 }, outputOpaqueSubRect);
+    }
+
+
     TEST_METHOD_EX(PixelShaderTransform_MapOutputRectToInputRects)
     {
         auto mapping = std::make_shared<CoordinateMappingState>();
@@ -1007,15 +1150,17 @@ public:
         mapping->Mapping[0] = SamplerCoordinateMapping::Unknown;
         mapping->Mapping[1] = SamplerCoordinateMapping::OneToOne;
         mapping->Mapping[2] = SamplerCoordinateMapping::Offset;
+        mapping->Mapping[3] = SamplerCoordinateMapping::Transformed;
+        mapping->Transform[3] = Numerics::Matrix3x2{ 0.5f, 0, 0, 2, 100, 0 };
         mapping->MaxOffset = 2;
 
         auto transform = Make<PixelShaderTransform>(nullptr, mapping);
 
         // Map backward from an output region being drawn to parts of our input images.
         D2D1_RECT_L output = { 10, 11, 23, 42 };
-        D2D1_RECT_L inputs[3];
+        D2D1_RECT_L inputs[4];
 
-        ThrowIfFailed(transform->MapOutputRectToInputRects(&output, inputs, 3));
+        ThrowIfFailed(transform->MapOutputRectToInputRects(&output, inputs, 4));
 
         // Unknown mapping = return infinite region.
         Assert::AreEqual(D2D1_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX }, inputs[0]);
@@ -1025,6 +1170,9 @@ public:
 
         // Offset mapping.
         Assert::AreEqual(D2D1_RECT_L{ 8, 9, 25, 44 }, inputs[2]);
+
+        // Transformed mapping, expanded by MaxOffset plus a pixel for filtering.
+        Assert::AreEqual(D2D1_RECT_L{ 105 - 3, 22 - 3, 112 + 3, 84 + 3 }, inputs[3]);
     }
 
 
@@ -1217,6 +1365,48 @@ public:
     }
 
 
+    TEST_METHOD_EX(ClipTransform_MapInputRectsToOutputRect_WhenMappingIsTransformed_ReturnsInverseTransformedRect)
+    {
+        auto mapping = std::make_shared<CoordinateMappingState>();
+
+        // The shader samples its input at half the output position.
+        mapping->Mapping[0] = SamplerCoordinateMapping::Transformed;
+        mapping->Transform[0] = Numerics::Matrix3x2{ 0.5f, 0, 0, 0.5f, 0, 0 };
+
+        auto transform = Make<ClipTransform>(nullptr, mapping);
+
+        D2D1_RECT_L inputs[] =
+        {
+            { -1234, -1234, 1234, 1234 },
+            { 0, 0, 100, 50 },
+        };
+
+        D2D1_RECT_L output;
+        D2D1_RECT_L outputOpaqueSubRect;
+
+        // Hard borders do not expand the source.
+        mapping->BorderMode[0] = EffectBorderMode::Hard;
+
+        ThrowIfFailed(transform->MapInputRectsToOutputRect(inputs, nullptr, _countof(inputs), &output, &outputOpaqueSubRect));
+
+        Assert::AreEqual(D2D1_RECT_L{ 0, 0, 200, 100 }, output);
+
+        // Soft borders expand the source by a pixel for filtering.
+        mapping->BorderMode[0] = EffectBorderMode::Soft;
+
+        ThrowIfFailed(transform->MapInputRectsToOutputRect(inputs, nullptr, _countof(inputs), &output, &outputOpaqueSubRect));
+
+        Assert::AreEqual(D2D1_RECT_L{ -2, -2, 202, 102 }, output);
+
+        // A transform that can't be inverted is treated like Unknown mapping.
+        mapping->Transform[0] = Numerics::Matrix3x2{ 1, 0, 0, 0, 0, 0 };
+
+        ThrowIfFailed(transform->MapInputRectsToOutputRect(inputs, nullptr, _countof(inputs), &output, &outputOpaqueSubRect));
+
+        Assert::AreEqual(D2D1_RECT_L{ INT_MIN, INT_MIN, INT_MAX, INT_MAX }, output);
+    }
+
+
     TEST_METHOD_EX(ClipTransform_MapInputRectsToOutputRect_WhenNoInputs_ReturnsInfinite)
     {
         auto transform = Make<ClipTransform>(nullptr, std::make_shared<CoordinateMappingState>());
@@ -1367,7 +1557,9 @@ TEST_CLASS(SharedShaderStateUnitTests)
         Assert::AreEqual(coordinateMapping.MaxOffset, clone->CoordinateMapping().MaxOffset);
         Assert::AreEqual<int>(sourceInterpolation.Filter[0], clone->SourceInterpolation().Filter[0]);
 
-        Assert::AreNotEqual<void const*>(&originalState->Shader(), &clone->Shader());
+        // The shader description is immutable, so clones share it.
+        Assert::AreEqual<void const*>(&originalState->Shader(), &clone->Shader());
+
         Assert::AreNotEqual<void const*>(&originalState->Constants(), &clone->Constants());
         Assert::AreNotEqual<void const*>(&originalState->CoordinateMapping(), &clone->CoordinateMapping());
         Assert::AreNotEqual<void const*>(&originalState->SourceInterpolation(), &clone->SourceInterpolation());
@@ -1389,6 +1581,37 @@ TEST_CLASS(SharedShaderStateUnitTests)
     };
 
 
+    TEST_METHOD_EX(SharedShaderState_SameShaderCode_SharesShaderDescription)
+    {
+        auto state1 = Make<SharedShaderState>(compiledShader1.data(), static_cast<unsigned>(compiledShader1.size()));
+        auto state2 = Make<SharedShaderState>(compiledShader1.data(), static_cast<unsigned>(compiledShader1.size()));
+
+        Assert::AreEqual<void const*>(&state1->Shader(), &state2->Shader());
+
+        Assert::AreNotEqual<void const*>(&state1->Constants(), &state2->Constants());
+        Assert::AreEqual(state1->Constants(), state2->Constants());
+
+        Assert::IsTrue(state1->SetProperty(HStringReference(L"f").Get(), Make<Nullable<float>>(1.0f).Get()));
+
+        Assert::AreNotEqual(state1->Constants(), state2->Constants());
+
+        // Setting the same value again does not count as a change.
+        Assert::IsFalse(state1->SetProperty(HStringReference(L"f").Get(), Make<Nullable<float>>(1.0f).Get()));
+    };
+
+
+    TEST_METHOD_EX(SharedShaderState_PreloadedShader_IsUsedByNewInstances)
+    {
+        SharedShaderState::Preload(compiledShader2.data(), static_cast<unsigned>(compiledShader2.size()));
+
+        auto state1 = Make<SharedShaderState>(compiledShader2.data(), static_cast<unsigned>(compiledShader2.size()));
+        auto state2 = Make<SharedShaderState>(compiledShader2.data(), static_cast<unsigned>(compiledShader2.size()));
+
+        Assert::AreEqual(compiledShader2, state1->Shader().Code);
+        Assert::AreEqual<void const*>(&state1->Shader(), &state2->Shader());
+    };
+
+
     TEST_METHOD_EX(SharedShaderState_ShaderReflection)
     {
         auto state = Make<SharedShaderState>(compiledShader1.data(), static_cast<unsigned>(compiledShader1.size()));
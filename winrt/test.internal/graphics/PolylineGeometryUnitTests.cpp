@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/geometry/PolylineGeometry.h>
+
+static const D2D1_MATRIX_3X2_F sc_identity = D2D1::Matrix3x2F::Identity();
+
+TEST_CLASS(PolylineGeometryUnitTests)
+{
+public:
+    static void AddFigure(PolylineGeometry& polylines, std::vector<D2D1_POINT_2F> const& points, D2D1_FIGURE_END figureEnd)
+    {
+        polylines.BeginFigure(points[0]);
+        polylines.AddLines(points.data() + 1, static_cast<uint32_t>(points.size() - 1));
+        polylines.EndFigure(figureEnd);
+    }
+
+    TEST_METHOD_EX(PolylineGeometry_ComputeBounds_IncludesEveryPoint)
+    {
+        // Odd and even point counts take different paths through the vectorized loop.
+        for (uint32_t pointCount = 1; pointCount <= 6; pointCount++)
+        {
+            std::vector<D2D1_POINT_2F> points;
+
+            for (uint32_t i = 0; i < pointCount; i++)
+                points.push_back(D2D1::Point2F(static_cast<float>(i), -static_cast<float>(i * 2)));
+
+            PolylineGeometry polylines;
+            AddFigure(polylines, points, D2D1_FIGURE_END_OPEN);
+
+            auto last = static_cast<float>(pointCount - 1);
+
+            Assert::AreEqual(D2D1::RectF(0, -last * 2, last, 0), polylines.ComputeBounds(sc_identity));
+        }
+    }
+
+    TEST_METHOD_EX(PolylineGeometry_ComputeBounds_AppliesTransform)
+    {
+        PolylineGeometry polylines;
+        AddFigure(polylines, { { 1, 2 }, { 3, 4 }, { -1, 5 } }, D2D1_FIGURE_END_CLOSED);
+
+        auto transform = D2D1::Matrix3x2F::Rotation(90) * D2D1::Matrix3x2F::Translation(10, 20);
+        auto bounds = polylines.ComputeBounds(transform);
+
+        // Rotating 90 degrees maps (x, y) to (-y, x).
+        Assert::AreEqual(5.0f, bounds.left, 0.0001f);
+        Assert::AreEqual(19.0f, bounds.top, 0.0001f);
+        Assert::AreEqual(8.0f, bounds.right, 0.0001f);
+        Assert::AreEqual(23.0f, bounds.bottom, 0.0001f);
+    }
+
+    TEST_METHOD_EX(PolylineGeometry_ComputeLength)
+    {
+        PolylineGeometry polylines;
+        AddFigure(polylines, { { 0, 0 }, { 3, 4 }, { 3, 0 } }, D2D1_FIGURE_END_OPEN);        // 5 + 4
+        AddFigure(polylines, { { 0, 0 }, { 3, 0 }, { 3, 4 } }, D2D1_FIGURE_END_CLOSED);      // 3 + 4 + 5
+        AddFigure(polylines, { { 7, 7 } }, D2D1_FIGURE_END_CLOSED);                          // 0
+
+        Assert::AreEqual(21.0f, polylines.ComputeLength(sc_identity));
+
+        // Translation doesn't change the length, but scale does.
+        Assert::AreEqual(21.0f, polylines.ComputeLength(D2D1::Matrix3x2F::Translation(100, 100)));
+        Assert::AreEqual(42.0f, polylines.ComputeLength(D2D1::Matrix3x2F::Scale(2, 2)));
+    }
+
+    TEST_METHOD_EX(PolylineGeometry_Flatten_RepeatsClosedFigureStarts)
+    {
+        PolylineGeometry polylines;
+        AddFigure(polylines, { { 0, 0 }, { 3, 4 } }, D2D1_FIGURE_END_OPEN);
+        AddFigure(polylines, { { 10, 0 }, { 13, 0 }, { 13, 4 } }, D2D1_FIGURE_END_CLOSED);
+
+        std::vector<D2D1_POINT_2F> points;
+        std::vector<float> distances;
+        polylines.Flatten(D2D1::Matrix3x2F::Translation(1, 1), &points, &distances);
+
+        std::vector<D2D1_POINT_2F> expectedPoints = { { 1, 1 }, { 4, 5 }, { 11, 1 }, { 14, 1 }, { 14, 5 }, { 11, 1 } };
+
+        // Moving to the second figure doesn't add to the distance.
+        std::vector<float> expectedDistances = { 0, 5, 5, 8, 12, 17 };
+
+        Assert::AreEqual<uint32_t>(static_cast<uint32_t>(expectedPoints.size()), static_cast<uint32_t>(points.size()));
+        Assert::AreEqual<uint32_t>(static_cast<uint32_t>(expectedDistances.size()), static_cast<uint32_t>(distances.size()));
+
+        for (size_t i = 0; i < expectedPoints.size(); i++)
+        {
+            Assert::AreEqual(expectedPoints[i], points[i]);
+            Assert::AreEqual(expectedDistances[i], distances[i]);
+        }
+    }
+};
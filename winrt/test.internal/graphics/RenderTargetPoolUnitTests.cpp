@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+TEST_CLASS(RenderTargetPoolUnitTests)
+{
+public:
+    struct Fixture
+    {
+        ComPtr<StubD2DDeviceContext> DeviceContext;
+        RenderTargetPool Pool;
+        D2D1_PIXEL_FORMAT Format;
+
+        Fixture()
+            : DeviceContext(Make<StubD2DDeviceContext>(nullptr))
+            , Format(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED))
+        {
+            DeviceContext->GetMaximumBitmapSizeMethod.AllowAnyCall([] { return 16384; });
+        }
+
+        void ExpectCreateBitmap(int expectedCalls)
+        {
+            DeviceContext->CreateBitmapMethod.SetExpectedCalls(expectedCalls,
+                [](D2D1_SIZE_U size, void const* sourceData, UINT32, D2D1_BITMAP_PROPERTIES1 const* bitmapProperties, ID2D1Bitmap1** value)
+                {
+                    Assert::IsNull(sourceData);
+                    Assert::AreEqual(D2D1_BITMAP_OPTIONS_TARGET, bitmapProperties->bitmapOptions);
+
+                    auto bitmap = Make<MockD2DBitmap>();
+                    auto format = bitmapProperties->pixelFormat;
+                    auto dpi = bitmapProperties->dpiX;
+                    bitmap->GetPixelSizeMethod.AllowAnyCall([=] { return size; });
+                    bitmap->GetPixelFormatMethod.AllowAnyCall([=] { return format; });
+                    bitmap->GetDpiMethod.AllowAnyCall([=](float* dpiX, float* dpiY) { *dpiX = *dpiY = dpi; return S_OK; });
+
+                    return bitmap.CopyTo(value);
+                });
+        }
+
+        ComPtr<ID2D1Bitmap1> Acquire(uint32_t width, uint32_t height, float dpi = DEFAULT_DPI)
+        {
+            return Pool.Acquire(DeviceContext.Get(), D2D1_SIZE_U{ width, height }, Format, dpi);
+        }
+    };
+
+    TEST_METHOD_EX(RenderTargetPool_ReturnedBitmapsOfTheSameSize_AreReused)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        auto first = f.Acquire(256, 128);
+
+        f.Pool.Release(first.Get());
+
+        f.ExpectCreateBitmap(0);
+        auto second = f.Acquire(256, 128);
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_BitmapsInUse_AreNotShared)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(256, 128);
+        auto second = f.Acquire(256, 128);
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_BitmapsOfADifferentDpi_AreNotReused)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(256, 128, DEFAULT_DPI);
+        f.Pool.Release(first.Get());
+
+        auto second = f.Acquire(256, 128, DEFAULT_DPI * 2);
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_GetBucketSize_RoundsUpByAtMostAnEighth)
+    {
+        auto check = [](uint32_t value, uint32_t expected)
+        {
+            auto bucket = RenderTargetPool::GetBucketSize(D2D1_SIZE_U{ value, value }, 16384);
+            Assert::AreEqual(expected, bucket.width);
+            Assert::AreEqual(expected, bucket.height);
+        };
+
+        check(1, RenderTargetPool::MinimumSizeGranularity);
+        check(8, 8);
+        check(100, 104);
+        check(1000, 1024);
+        check(1080, 1152);
+        check(1920, 1920);
+
+        // Never past the maximum bitmap size.
+        auto bucket = RenderTargetPool::GetBucketSize(D2D1_SIZE_U{ 99, 1 }, 100);
+        Assert::AreEqual(100u, bucket.width);
+        Assert::AreEqual(RenderTargetPool::MinimumSizeGranularity, bucket.height);
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_SimilarSizes_ShareBitmaps)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        auto first = f.Acquire(100, 97);
+        f.Pool.Release(first.Get());
+
+        f.ExpectCreateBitmap(0);
+        auto second = f.Acquire(103, 100);
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_IdleBitmapsAreLimitedByCount)
+    {
+        Fixture f;
+
+        f.Pool.SetMaximumIdleCount(2);
+
+        std::vector<ComPtr<ID2D1Bitmap1>> bitmaps;
+
+        f.ExpectCreateBitmap(3);
+
+        for (int i = 0; i < 3; i++)
+        {
+            bitmaps.push_back(f.Acquire(64, 64));
+        }
+
+        for (auto& bitmap : bitmaps)
+        {
+            f.Pool.Release(bitmap.Get());
+        }
+
+        Assert::AreEqual(2u, f.Pool.GetStatistics().IdleCount);
+
+        // The least recently returned bitmap was dropped; the rest are reused most recent first.
+        f.ExpectCreateBitmap(0);
+        Assert::IsTrue(IsSameInstance(bitmaps[2].Get(), f.Acquire(64, 64).Get()));
+        Assert::IsTrue(IsSameInstance(bitmaps[1].Get(), f.Acquire(64, 64).Get()));
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_IdleBitmapsAreLimitedByTotalSize)
+    {
+        Fixture f;
+
+        // Room for exactly one idle 64x64 B8G8R8A8 bitmap.
+        uint64_t bitmapSize = 64 * 64 * 4;
+        f.Pool.SetMaximumIdleSize(bitmapSize);
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(64, 64);
+        auto second = f.Acquire(64, 64);
+
+        f.Pool.Release(first.Get());
+        f.Pool.Release(second.Get());
+
+        Assert::AreEqual(bitmapSize, f.Pool.GetStatistics().IdleSize);
+
+        // Lowering the limit drops idle bitmaps that no longer fit.
+        f.Pool.SetMaximumIdleSize(bitmapSize - 1);
+
+        Assert::AreEqual<uint64_t>(0, f.Pool.GetStatistics().IdleSize);
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_WhenOutOfMemory_IdleBitmapsAreReleasedAndCreationIsRetried)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        f.Pool.Release(f.Acquire(64, 64).Get());
+
+        bool failed = false;
+
+        f.DeviceContext->CreateBitmapMethod.SetExpectedCalls(2,
+            [&](D2D1_SIZE_U, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const*, ID2D1Bitmap1** value)
+            {
+                if (!failed)
+                {
+                    failed = true;
+                    return E_OUTOFMEMORY;
+                }
+
+                Assert::AreEqual(0u, f.Pool.GetStatistics().IdleCount);
+                return Make<MockD2DBitmap>().CopyTo(value);
+            });
+
+        f.Acquire(512, 64);
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_Statistics_CountRentsReusesAndReturns)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(64, 64);
+        f.Pool.Release(first.Get());
+        f.Acquire(64, 64);
+        f.Acquire(64, 64);
+
+        auto statistics = f.Pool.GetStatistics();
+
+        Assert::AreEqual<uint64_t>(3, statistics.RentCount);
+        Assert::AreEqual<uint64_t>(1, statistics.ReuseCount);
+        Assert::AreEqual<uint64_t>(1, statistics.ReturnCount);
+        Assert::AreEqual(0u, statistics.IdleCount);
+        Assert::AreEqual<uint64_t>(0, statistics.IdleSize);
+    }
+
+    TEST_METHOD_EX(RenderTargetPool_Clear_ReleasesIdleBitmaps)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        f.Pool.Release(f.Acquire(64, 64).Get());
+
+        f.Pool.Clear();
+
+        f.ExpectCreateBitmap(1);
+        f.Acquire(64, 64);
+    }
+};
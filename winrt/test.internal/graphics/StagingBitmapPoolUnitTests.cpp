@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+TEST_CLASS(StagingBitmapPoolUnitTests)
+{
+public:
+    struct Fixture
+    {
+        ComPtr<StubD2DDeviceContext> DeviceContext;
+        StagingBitmapPool Pool;
+        D2D1_PIXEL_FORMAT Format;
+
+        Fixture()
+            : DeviceContext(Make<StubD2DDeviceContext>(nullptr))
+            , Format(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED))
+        {
+            DeviceContext->GetMaximumBitmapSizeMethod.AllowAnyCall([] { return 16384; });
+        }
+
+        void ExpectCreateBitmap(int expectedCalls)
+        {
+            DeviceContext->CreateBitmapMethod.SetExpectedCalls(expectedCalls,
+                [](D2D1_SIZE_U size, void const* sourceData, UINT32, D2D1_BITMAP_PROPERTIES1 const* bitmapProperties, ID2D1Bitmap1** value)
+                {
+                    Assert::IsNull(sourceData);
+                    Assert::AreEqual(D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW, bitmapProperties->bitmapOptions);
+
+                    auto bitmap = Make<MockD2DBitmap>();
+                    auto format = bitmapProperties->pixelFormat;
+                    bitmap->GetPixelSizeMethod.AllowAnyCall([=] { return size; });
+                    bitmap->GetPixelFormatMethod.AllowAnyCall([=] { return format; });
+
+                    return bitmap.CopyTo(value);
+                });
+        }
+
+        ComPtr<ID2D1Bitmap1> Acquire(uint32_t width, uint32_t height)
+        {
+            return Pool.Acquire(DeviceContext.Get(), D2D1_SIZE_U{ width, height }, Format);
+        }
+    };
+
+    TEST_METHOD_EX(StagingBitmapPool_ReleasedBitmapsOfTheSameSize_AreReused)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        auto first = f.Acquire(16, 8);
+
+        f.Pool.Release(first.Get());
+
+        f.ExpectCreateBitmap(0);
+        auto second = f.Acquire(16, 8);
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_BitmapsInUse_AreNotShared)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(16, 8);
+        auto second = f.Acquire(16, 8);
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_SizesAreRoundedUp_SoSimilarSizesShareBitmaps)
+    {
+        Fixture f;
+
+        f.DeviceContext->CreateBitmapMethod.SetExpectedCalls(1,
+            [](D2D1_SIZE_U size, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const* bitmapProperties, ID2D1Bitmap1** value)
+            {
+                Assert::AreEqual(StagingBitmapPool::SizeGranularity, size.width);
+                Assert::AreEqual(StagingBitmapPool::SizeGranularity * 2, size.height);
+
+                auto bitmap = Make<MockD2DBitmap>();
+                auto format = bitmapProperties->pixelFormat;
+                bitmap->GetPixelSizeMethod.AllowAnyCall([=] { return size; });
+                bitmap->GetPixelFormatMethod.AllowAnyCall([=] { return format; });
+
+                return bitmap.CopyTo(value);
+            });
+
+        auto first = f.Acquire(16, StagingBitmapPool::SizeGranularity + 1);
+        f.Pool.Release(first.Get());
+
+        auto second = f.Acquire(StagingBitmapPool::SizeGranularity, StagingBitmapPool::SizeGranularity * 2);
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_SizesAreNotRoundedUpPastTheMaximumBitmapSize)
+    {
+        Fixture f;
+
+        f.DeviceContext->GetMaximumBitmapSizeMethod.AllowAnyCall([] { return 100; });
+
+        f.DeviceContext->CreateBitmapMethod.SetExpectedCalls(1,
+            [](D2D1_SIZE_U size, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const*, ID2D1Bitmap1** value)
+            {
+                Assert::AreEqual(100u, size.width);
+                Assert::AreEqual(StagingBitmapPool::SizeGranularity, size.height);
+
+                return Make<MockD2DBitmap>().CopyTo(value);
+            });
+
+        f.Acquire(99, 1);
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_ReleasedBitmapsOfADifferentSize_AreNotReused)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(16, 8);
+        f.Pool.Release(first.Get());
+
+        auto second = f.Acquire(StagingBitmapPool::SizeGranularity * 2, 8);
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_IdleBitmapsAreLimitedByTotalSize)
+    {
+        Fixture f;
+
+        // Room for exactly one idle 64x64 B8G8R8A8 bitmap.
+        auto bitmapSize = StagingBitmapPool::SizeGranularity * StagingBitmapPool::SizeGranularity * 4;
+        f.Pool.SetMaximumIdleSize(bitmapSize);
+
+        f.ExpectCreateBitmap(2);
+        auto first = f.Acquire(16, 8);
+        auto second = f.Acquire(16, 8);
+
+        f.Pool.Release(first.Get());
+        f.Pool.Release(second.Get());
+
+        Assert::AreEqual<uint64_t>(bitmapSize, f.Pool.GetIdleSize());
+
+        f.ExpectCreateBitmap(0);
+        Assert::IsTrue(IsSameInstance(second.Get(), f.Acquire(16, 8).Get()));
+        Assert::AreEqual<uint64_t>(0, f.Pool.GetIdleSize());
+
+        // Lowering the limit drops idle bitmaps that no longer fit.
+        f.Pool.Release(second.Get());
+        f.Pool.SetMaximumIdleSize(bitmapSize - 1);
+
+        Assert::AreEqual<uint64_t>(0, f.Pool.GetIdleSize());
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_WhenOutOfMemory_IdleBitmapsAreReleasedAndCreationIsRetried)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        auto idle = f.Acquire(16, 8);
+        f.Pool.Release(idle.Get());
+
+        bool failed = false;
+
+        f.DeviceContext->CreateBitmapMethod.SetExpectedCalls(2,
+            [&](D2D1_SIZE_U, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const*, ID2D1Bitmap1** value)
+            {
+                if (!failed)
+                {
+                    failed = true;
+                    return E_OUTOFMEMORY;
+                }
+
+                Assert::AreEqual<uint64_t>(0, f.Pool.GetIdleSize());
+                return Make<MockD2DBitmap>().CopyTo(value);
+            });
+
+        f.Acquire(StagingBitmapPool::SizeGranularity * 2, 8);
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_KeepsOnlyTheMostRecentlyReleasedBitmaps)
+    {
+        Fixture f;
+
+        std::vector<ComPtr<ID2D1Bitmap1>> bitmaps;
+
+        f.ExpectCreateBitmap(StagingBitmapPool::MaxIdleBitmaps + 1);
+
+        for (size_t i = 0; i < StagingBitmapPool::MaxIdleBitmaps + 1; i++)
+        {
+            bitmaps.push_back(f.Acquire(16, 8));
+        }
+
+        for (auto& bitmap : bitmaps)
+        {
+            f.Pool.Release(bitmap.Get());
+        }
+
+        // Everything but the first bitmap to be released is reused, most recent first.
+        f.ExpectCreateBitmap(0);
+
+        for (size_t i = StagingBitmapPool::MaxIdleBitmaps; i > 0; i--)
+        {
+            Assert::IsTrue(IsSameInstance(bitmaps[i].Get(), f.Acquire(16, 8).Get()));
+        }
+
+        f.ExpectCreateBitmap(1);
+        Assert::IsFalse(IsSameInstance(bitmaps[0].Get(), f.Acquire(16, 8).Get()));
+    }
+
+    TEST_METHOD_EX(StagingBitmapPool_Clear_ReleasesIdleBitmaps)
+    {
+        Fixture f;
+
+        f.ExpectCreateBitmap(1);
+        f.Pool.Release(f.Acquire(16, 8).Get());
+
+        f.Pool.Clear();
+
+        f.ExpectCreateBitmap(1);
+        f.Acquire(16, 8);
+    }
+};
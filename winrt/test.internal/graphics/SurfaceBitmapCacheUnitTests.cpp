@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/drawing/SurfaceBitmapCache.h>
+
+TEST_CLASS(SurfaceBitmapCacheUnitTests)
+{
+public:
+    class FakeSurface : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IUnknown>
+    {
+    };
+
+    struct Fixture
+    {
+        SurfaceBitmapCache Cache;
+        int CreateCount;
+
+        Fixture()
+            : CreateCount(0)
+        {
+            Cache.SetMaximumCount(2);
+        }
+
+        ComPtr<ID2D1Bitmap1> Get(IUnknown* surface, float dpi = DEFAULT_DPI, D2D1_ALPHA_MODE alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED)
+        {
+            return Cache.GetOrCreate(surface, dpi, alphaMode,
+                [&]() -> ComPtr<ID2D1Bitmap1>
+                {
+                    CreateCount++;
+                    return Make<MockD2DBitmap>();
+                });
+        }
+    };
+
+    TEST_METHOD_EX(SurfaceBitmapCache_IsDisabledByDefault)
+    {
+        SurfaceBitmapCache cache;
+
+        Assert::IsFalse(cache.IsEnabled());
+        Assert::AreEqual(0u, cache.GetMaximumCount());
+    }
+
+    TEST_METHOD_EX(SurfaceBitmapCache_SameSurface_ReturnsSameBitmap)
+    {
+        Fixture f;
+        auto surface = Make<FakeSurface>();
+
+        auto first = f.Get(surface.Get());
+        auto second = f.Get(surface.Get());
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+        Assert::AreEqual(1, f.CreateCount);
+        Assert::AreEqual(1u, f.Cache.GetCount());
+    }
+
+    TEST_METHOD_EX(SurfaceBitmapCache_DifferentSurfaces_ReturnDifferentBitmaps)
+    {
+        Fixture f;
+        auto surface1 = Make<FakeSurface>();
+        auto surface2 = Make<FakeSurface>();
+
+        auto first = f.Get(surface1.Get());
+        auto second = f.Get(surface2.Get());
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+        Assert::AreEqual(2, f.CreateCount);
+    }
+
+    TEST_METHOD_EX(SurfaceBitmapCache_DifferentDpiOrAlphaMode_ReplacesEntry)
+    {
+        Fixture f;
+        auto surface = Make<FakeSurface>();
+
+        auto first = f.Get(surface.Get());
+        auto second = f.Get(surface.Get(), 144);
+        auto third = f.Get(surface.Get(), 144, D2D1_ALPHA_MODE_IGNORE);
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+        Assert::IsFalse(IsSameInstance(second.Get(), third.Get()));
+        Assert::AreEqual(3, f.CreateCount);
+        Assert::AreEqual(1u, f.Cache.GetCount());
+
+        auto fourth = f.Get(surface.Get(), 144, D2D1_ALPHA_MODE_IGNORE);
+
+        Assert::IsTrue(IsSameInstance(third.Get(), fourth.Get()));
+        Assert::AreEqual(3, f.CreateCount);
+    }
+
+    TEST_METHOD_EX(SurfaceBitmapCache_LeastRecentlyUsedEntriesAreEvicted)
+    {
+        Fixture f;
+        auto surface1 = Make<FakeSurface>();
+        auto surface2 = Make<FakeSurface>();
+        auto surface3 = Make<FakeSurface>();
+
+        auto bitmap1 = f.Get(surface1.Get());
+        f.Get(surface2.Get());
+
+        // Touching surface1 makes surface2 the least recently used.
+        f.Get(surface1.Get());
+        f.Get(surface3.Get());
+
+        Assert::AreEqual(3, f.CreateCount);
+        Assert::AreEqual(2u, f.Cache.GetCount());
+
+        Assert::IsTrue(IsSameInstance(bitmap1.Get(), f.Get(surface1.Get()).Get()));
+        Assert::AreEqual(3, f.CreateCount);
+
+        f.Get(surface2.Get());
+        Assert::AreEqual(4, f.CreateCount);
+    }
+
+    TEST_METHOD_EX(SurfaceBitmapCache_LoweringMaximumCount_EvictsEntries)
+    {
+        Fixture f;
+        auto surface1 = Make<FakeSurface>();
+        auto surface2 = Make<FakeSurface>();
+
+        f.Get(surface1.Get());
+        f.Get(surface2.Get());
+
+        f.Cache.SetMaximumCount(1);
+        Assert::AreEqual(1u, f.Cache.GetCount());
+
+        f.Cache.SetMaximumCount(0);
+        Assert::AreEqual(0u, f.Cache.GetCount());
+        Assert::IsFalse(f.Cache.IsEnabled());
+    }
+
+    TEST_METHOD_EX(SurfaceBitmapCache_Clear_ReleasesEverything)
+    {
+        Fixture f;
+        auto surface = Make<FakeSurface>();
+
+        auto first = f.Get(surface.Get());
+
+        f.Cache.Clear();
+        Assert::AreEqual(0u, f.Cache.GetCount());
+
+        auto second = f.Get(surface.Get());
+
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+        Assert::AreEqual(2, f.CreateCount);
+    }
+};
@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/drawing/TextLayoutCache.h>
+#include "mocks/MockDWriteFactory.h"
+#include "mocks/MockDWriteTextFormat.h"
+#include "mocks/MockDWriteTextLayout.h"
+
+TEST_CLASS(TextLayoutCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        ComPtr<MockDWriteFactory> Factory;
+        ComPtr<MockDWriteTextFormat> Format;
+        TextLayoutCache Cache;
+
+        Fixture()
+            : Factory(Make<MockDWriteFactory>())
+            , Format(Make<MockDWriteTextFormat>())
+        {
+            Cache.SetMaximumCount(2);
+        }
+
+        void ExpectCreateTextLayout(int expectedCalls)
+        {
+            Factory->CreateTextLayoutMethod.SetExpectedCalls(expectedCalls,
+                [](WCHAR const*, uint32_t, IDWriteTextFormat*, FLOAT, FLOAT, IDWriteTextLayout** value)
+                {
+                    return Make<MockDWriteTextLayout>().CopyTo(value);
+                });
+        }
+
+        ComPtr<IDWriteTextLayout> Get(wchar_t const* text, uint64_t formatVersion = 1, float width = 100, float height = 50)
+        {
+            return Cache.GetOrCreate(Factory.Get(), text, static_cast<uint32_t>(wcslen(text)), Format.Get(), formatVersion, width, height);
+        }
+    };
+
+    TEST_METHOD_EX(TextLayoutCache_IsDisabledByDefault)
+    {
+        TextLayoutCache cache;
+
+        Assert::IsFalse(cache.IsEnabled());
+        Assert::AreEqual(0u, cache.GetMaximumCount());
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_SameArguments_ReturnSameLayout)
+    {
+        Fixture f;
+
+        f.Factory->CreateTextLayoutMethod.SetExpectedCalls(1,
+            [&](WCHAR const* text, uint32_t textLength, IDWriteTextFormat* format, FLOAT width, FLOAT height, IDWriteTextLayout** value)
+            {
+                Assert::AreEqual(L"hello", std::wstring(text, textLength).c_str());
+                Assert::IsTrue(IsSameInstance(f.Format.Get(), format));
+                Assert::AreEqual(100.0f, width);
+                Assert::AreEqual(50.0f, height);
+
+                return Make<MockDWriteTextLayout>().CopyTo(value);
+            });
+
+        auto first = f.Get(L"hello");
+        auto second = f.Get(L"hello");
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(1u, statistics.Count);
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+        Assert::AreEqual<uint64_t>(0, statistics.EvictionCount);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_KeepsItsOwnCopyOfTheText)
+    {
+        Fixture f;
+        f.ExpectCreateTextLayout(1);
+
+        wchar_t buffer[] = L"hello";
+        auto first = f.Get(buffer);
+
+        // Changing the caller's buffer doesn't affect the entry, and the
+        // same text from a different buffer still finds it.
+        buffer[0] = L'j';
+
+        std::wstring sameText(L"hello");
+        auto second = f.Get(sameText.c_str());
+
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+
+        f.ExpectCreateTextLayout(1);
+        f.Get(buffer);
+
+        Assert::AreEqual(2u, f.Cache.GetStatistics().Count);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_DifferentArguments_AreCachedSeparately)
+    {
+        Fixture f;
+        f.Cache.SetMaximumCount(10);
+        f.ExpectCreateTextLayout(4);
+
+        f.Get(L"hello");
+        f.Get(L"world");
+        f.Get(L"hello", 2);
+        f.Get(L"hello", 1, 200);
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(4u, statistics.Count);
+        Assert::AreEqual<uint64_t>(0, statistics.HitCount);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_OverMaximumCount_EvictsLeastRecentlyUsed)
+    {
+        Fixture f;
+        f.ExpectCreateTextLayout(4);
+
+        auto a = f.Get(L"a");
+        auto b = f.Get(L"b");
+
+        // Asking for a again makes b the least recently used.
+        f.Get(L"a");
+        f.Get(L"c");
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(2u, statistics.Count);
+        Assert::AreEqual<uint64_t>(1, statistics.EvictionCount);
+
+        Assert::IsTrue(IsSameInstance(a.Get(), f.Get(L"a").Get()));
+        Assert::IsFalse(IsSameInstance(b.Get(), f.Get(L"b").Get()));
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_LoweringMaximumCountAndClear_ReleaseEntries)
+    {
+        Fixture f;
+        f.ExpectCreateTextLayout(2);
+
+        f.Get(L"a");
+        f.Get(L"b");
+
+        f.Cache.SetMaximumCount(1);
+        Assert::AreEqual(1u, f.Cache.GetStatistics().Count);
+
+        f.Cache.Clear();
+        Assert::AreEqual(0u, f.Cache.GetStatistics().Count);
+        Assert::AreEqual<uint64_t>(2, f.Cache.GetStatistics().EvictionCount);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_WhenDisabled_CreatesLayoutWithoutKeepingIt)
+    {
+        Fixture f;
+        f.Cache.SetMaximumCount(0);
+        f.ExpectCreateTextLayout(2);
+
+        auto first = f.Get(L"a");
+        auto second = f.Get(L"a");
+
+        Assert::IsNotNull(first.Get());
+        Assert::IsFalse(IsSameInstance(first.Get(), second.Get()));
+        Assert::AreEqual(0u, f.Cache.GetStatistics().Count);
+    }
+};
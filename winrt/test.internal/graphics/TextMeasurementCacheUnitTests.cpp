@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/text/TextMeasurementCache.h>
+
+TEST_CLASS(TextMeasurementCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        TextMeasurementCache Cache;
+        int MeasureCount;
+
+        Fixture()
+            : MeasureCount(0)
+        {
+            Cache.SetMaximumCount(2);
+        }
+
+        CanvasTextMeasurement Get(wchar_t const* text, uint64_t formatVersion = 1, float width = 100)
+        {
+            return Cache.GetOrMeasure(text, static_cast<uint32_t>(wcslen(text)), formatVersion, width,
+                [&]
+                {
+                    MeasureCount++;
+
+                    CanvasTextMeasurement measurement{ Rect{ 0, 0, width, static_cast<float>(MeasureCount) }, MeasureCount };
+                    return measurement;
+                });
+        }
+    };
+
+    TEST_METHOD_EX(TextMeasurementCache_IsEnabledByDefault)
+    {
+        TextMeasurementCache cache;
+
+        Assert::AreEqual(TextMeasurementCache::DefaultMaximumCount, cache.GetMaximumCount());
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_SameArguments_MeasureOnce)
+    {
+        Fixture f;
+
+        auto first = f.Get(L"hello");
+        auto second = f.Get(L"hello");
+
+        Assert::AreEqual(1, f.MeasureCount);
+        Assert::AreEqual(first.LineCount, second.LineCount);
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(1u, statistics.Count);
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+        Assert::AreEqual<uint64_t>(0, statistics.EvictionCount);
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_DifferentArguments_AreMeasuredSeparately)
+    {
+        Fixture f;
+        f.Cache.SetMaximumCount(10);
+
+        f.Get(L"hello");
+        f.Get(L"world");
+        f.Get(L"hello", 1, 200);
+
+        Assert::AreEqual(3, f.MeasureCount);
+        Assert::AreEqual(3u, f.Cache.GetStatistics().Count);
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_NewFormatVersion_DiscardsEverything)
+    {
+        Fixture f;
+
+        f.Get(L"hello", 1);
+        f.Get(L"world", 1);
+        f.Get(L"hello", 2);
+
+        Assert::AreEqual(3, f.MeasureCount);
+
+        auto statistics = f.Cache.GetStatistics();
+
+        Assert::AreEqual(1u, statistics.Count);
+        Assert::AreEqual<uint64_t>(2, statistics.EvictionCount);
+
+        // Measurements made with an older version don't replace newer ones.
+        f.Get(L"world", 1);
+        f.Get(L"hello", 2);
+
+        Assert::AreEqual(4, f.MeasureCount);
+        Assert::AreEqual(1u, f.Cache.GetStatistics().Count);
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_FormatVersionZero_IsNeverCached)
+    {
+        Fixture f;
+
+        f.Get(L"hello", 0);
+        f.Get(L"hello", 0);
+
+        Assert::AreEqual(2, f.MeasureCount);
+        Assert::AreEqual(0u, f.Cache.GetStatistics().Count);
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_LeastRecentlyUsedEntryIsEvicted)
+    {
+        Fixture f;
+
+        f.Get(L"a");
+        f.Get(L"b");
+        f.Get(L"a");        // Makes "b" the least recently used.
+        f.Get(L"c");        // Evicts "b".
+
+        Assert::AreEqual(3, f.MeasureCount);
+
+        f.Get(L"a");
+        Assert::AreEqual(3, f.MeasureCount);
+
+        f.Get(L"b");
+        Assert::AreEqual(4, f.MeasureCount);
+
+        Assert::AreEqual<uint64_t>(2, f.Cache.GetStatistics().EvictionCount);
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_SetMaximumCountToZero_DisablesCaching)
+    {
+        Fixture f;
+
+        f.Get(L"a");
+        f.Cache.SetMaximumCount(0);
+
+        Assert::AreEqual(0u, f.Cache.GetStatistics().Count);
+
+        f.Get(L"a");
+        f.Get(L"a");
+
+        Assert::AreEqual(3, f.MeasureCount);
+    }
+
+    TEST_METHOD_EX(TextMeasurementCache_Clear_ReleasesEverything)
+    {
+        Fixture f;
+
+        f.Get(L"a");
+        f.Get(L"b");
+        f.Cache.Clear();
+
+        Assert::AreEqual(0u, f.Cache.GetStatistics().Count);
+
+        f.Get(L"a");
+        Assert::AreEqual(3, f.MeasureCount);
+    }
+};
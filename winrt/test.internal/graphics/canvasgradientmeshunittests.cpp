@@ -121,6 +121,12 @@ public:
 
         ComPtr<ICanvasDevice> device;
         Assert::AreEqual(RO_E_CLOSED, gradientMesh->get_Device(&device));
+
+        Assert::AreEqual(RO_E_CLOSED, gradientMesh->SetPatches(1, &f.DefaultPatches[0]));
+
+        uint64_t sizeInBytes;
+        Assert::AreEqual(RO_E_CLOSED, gradientMesh->get_PatchCount(&valueCount));
+        Assert::AreEqual(RO_E_CLOSED, gradientMesh->get_SizeInBytes(&sizeInBytes));
     }
 
     TEST_METHOD_EX(CanvasGradientMesh_get_Device)
@@ -373,6 +379,79 @@ public:
         Assert::IsNotNull(gradientMesh.Get());
     }
 
+    TEST_METHOD_EX(CanvasGradientMesh_SetPatches_RebuildsResourceInPlace)
+    {
+        Fixture f;
+
+        auto gradientMesh = CanvasGradientMesh::CreateNew(f.Device.Get(), 1, &f.DefaultPatches[0]);
+
+        auto newD2DGradientMesh = Make<MockD2DGradientMesh>();
+
+        f.Device->CreateGradientMeshMethod.SetExpectedCalls(1,
+            [&](D2D1_GRADIENT_MESH_PATCH const* d2dPatches, uint32_t d2dPatchCount)
+            {
+                Assert::AreEqual(3u, d2dPatchCount);
+                for (int i = 0; i < 3; ++i)
+                {
+                    VerifyGradientMeshPatchEqualToD2DGradientMeshPatch(f.DefaultPatches[i], d2dPatches[i]);
+                }
+                return newD2DGradientMesh;
+            });
+
+        ThrowIfFailed(gradientMesh->SetPatches(3, f.DefaultPatches));
+
+        Assert::IsTrue(IsSameInstance(newD2DGradientMesh.Get(), gradientMesh->GetResource().Get()));
+    }
+
+    TEST_METHOD_EX(CanvasGradientMesh_SetPatches_SamePatches_DoesNotRebuild)
+    {
+        Fixture f;
+
+        auto gradientMesh = CanvasGradientMesh::CreateNew(f.Device.Get(), 3, f.DefaultPatches);
+
+        f.Device->CreateGradientMeshMethod.SetExpectedCalls(0);
+        ThrowIfFailed(gradientMesh->SetPatches(3, f.DefaultPatches));
+
+        // Changing one patch rebuilds the mesh.
+        f.DefaultPatches[1].Point11 = Vector2{ 123, 456 };
+
+        f.Device->CreateGradientMeshMethod.SetExpectedCalls(1,
+            [&](D2D1_GRADIENT_MESH_PATCH const* d2dPatches, uint32_t d2dPatchCount)
+            {
+                Assert::AreEqual(3u, d2dPatchCount);
+                VerifyGradientMeshPatchEqualToD2DGradientMeshPatch(f.DefaultPatches[1], d2dPatches[1]);
+                return Make<MockD2DGradientMesh>();
+            });
+
+        ThrowIfFailed(gradientMesh->SetPatches(3, f.DefaultPatches));
+    }
+
+    TEST_METHOD_EX(CanvasGradientMesh_SetPatches_NullArg)
+    {
+        Fixture f;
+
+        auto gradientMesh = CanvasGradientMesh::CreateNew(f.Device.Get(), 1, &f.DefaultPatches[0]);
+
+        Assert::AreEqual(E_INVALIDARG, gradientMesh->SetPatches(1, nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasGradientMesh_SizeInBytes_IsProportionalToPatchCount)
+    {
+        Fixture f;
+
+        f.D2DGradientMesh->GetPatchCountMethod.AllowAnyCall([] { return 3; });
+
+        auto gradientMesh = CanvasGradientMesh::CreateNew(f.Device.Get(), 3, f.DefaultPatches);
+
+        uint32_t patchCount;
+        ThrowIfFailed(gradientMesh->get_PatchCount(&patchCount));
+        Assert::AreEqual(3u, patchCount);
+
+        uint64_t sizeInBytes;
+        ThrowIfFailed(gradientMesh->get_SizeInBytes(&sizeInBytes));
+        Assert::AreEqual<uint64_t>(3 * sizeof(D2D1_GRADIENT_MESH_PATCH), sizeInBytes);
+    }
+
     //
     // The CanvasGradientMesh GetBounds and GetBoundsWithTransform methods are
     // expected to behave in the same way as the ICanvasImage methods, even
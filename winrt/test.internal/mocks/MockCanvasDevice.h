@@ -43,8 +43,10 @@ namespace canvas
         CALL_COUNTER_WITH_MOCK(CreateBitmapFromSurfaceMethod, ComPtr<ID2D1Bitmap1>(IDirect3DSurface*, float, CanvasAlphaMode));
         CALL_COUNTER_WITH_MOCK(CreateRenderTargetBitmapMethod, ComPtr<ID2D1Bitmap1>(float, float, float, DirectXPixelFormat, CanvasAlphaMode));
         CALL_COUNTER_WITH_MOCK(CreateSwapChainForCompositionMethod, ComPtr<IDXGISwapChain1>(int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode));
+        CALL_COUNTER_WITH_MOCK(CreateSwapChainForCompositionWithFlagsMethod, ComPtr<IDXGISwapChain1>(int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, UINT));
         CALL_COUNTER_WITH_MOCK(CreateSwapChainForCoreWindowMethod, ComPtr<IDXGISwapChain1>(ICoreWindow*, int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode));
         CALL_COUNTER_WITH_MOCK(CreateCommandListMethod, ComPtr<ID2D1CommandList>());
+        CALL_COUNTER_WITH_MOCK(CreateStrokeStyleMethod, ComPtr<ID2D1StrokeStyle1>(D2D1_STROKE_STYLE_PROPERTIES1 const&, std::vector<float> const&));
 
         CALL_COUNTER_WITH_MOCK(CreateFilledGeometryRealizationMethod, ComPtr<ID2D1GeometryRealization>(ID2D1Geometry*, float));
         CALL_COUNTER_WITH_MOCK(CreateStrokedGeometryRealizationMethod, ComPtr<ID2D1GeometryRealization>(ID2D1Geometry*, float, ID2D1StrokeStyle*, float));
@@ -54,10 +56,19 @@ namespace canvas
         CALL_COUNTER_WITH_MOCK(GetResourceCreationDeviceContextMethod, DeviceContextLease());
 
         CALL_COUNTER_WITH_MOCK(GetPrimaryDisplayOutputMethod, ComPtr<IDXGIOutput>());
+        CALL_COUNTER_WITH_MOCK(IsTearingSupportedMethod, bool());
+
+        CALL_COUNTER_WITH_MOCK(GetEffectCacheBudgetMethod, EffectCacheBudget*());
+        CALL_COUNTER_WITH_MOCK(GetEffectResourceCacheMethod, EffectResourceCache*());
+        CALL_COUNTER_WITH_MOCK(GetStagingBitmapPoolMethod, StagingBitmapPool*());
+        CALL_COUNTER_WITH_MOCK(GetRenderTargetPoolMethod, RenderTargetPool*());
+        CALL_COUNTER_WITH_MOCK(GetSurfaceBitmapCacheMethod, SurfaceBitmapCache*());
+        CALL_COUNTER_WITH_MOCK(GetTextLayoutCacheMethod, TextLayoutCache*());
 
         CALL_COUNTER_WITH_MOCK(LeaseHistogramEffectMethod, HistogramAndAtlasEffects(ID2D1DeviceContext*));
         CALL_COUNTER_WITH_MOCK(ReleaseHistogramEffectMethod, void(HistogramAndAtlasEffects));
 
+        CALL_COUNTER_WITH_MOCK(get_MaximumBitmapSizeInPixelsMethod, HRESULT(int32_t*));
         CALL_COUNTER_WITH_MOCK(IsBufferPrecisionSupportedMethod, HRESULT(CanvasBufferPrecision, boolean*));
 
         CALL_COUNTER_WITH_MOCK(RaiseDeviceLostMethod, HRESULT());
@@ -90,8 +101,7 @@ namespace canvas
 
         IFACEMETHODIMP get_MaximumBitmapSizeInPixels(int32_t* value) override
         {
-            Assert::Fail(L"Unexpected call to get_MaximumBitmapSizeInPixels");
-            return E_NOTIMPL;
+            return get_MaximumBitmapSizeInPixelsMethod.WasCalled(value);
         }
 
         IFACEMETHODIMP IsPixelFormatSupported(DirectXPixelFormat pixelFormat, boolean* value) override
@@ -129,6 +139,66 @@ namespace canvas
             return E_NOTIMPL;
         }
 
+        IFACEMETHODIMP get_MaximumDeviceContextPoolSize(int32_t* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumDeviceContextPoolSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumDeviceContextPoolSize(int32_t value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumDeviceContextPoolSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumEffectCacheSize(UINT64* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumEffectCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumEffectCacheSize(UINT64 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumEffectCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_EffectCacheSize(UINT64* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_EffectCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumTextLayoutCacheCount(UINT32* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumTextLayoutCacheCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumTextLayoutCacheCount(UINT32 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumTextLayoutCacheCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_TextLayoutCacheStatistics(CanvasTextLayoutCacheStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_TextLayoutCacheStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumSurfaceBitmapCacheCount(UINT32* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumSurfaceBitmapCacheCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumSurfaceBitmapCacheCount(UINT32 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumSurfaceBitmapCacheCount");
+            return E_NOTIMPL;
+        }
+
         IFACEMETHODIMP add_DeviceLost(
             DeviceLostHandlerType* value,
             EventRegistrationToken* token)
@@ -159,6 +229,48 @@ namespace canvas
             return LockMethod.WasCalled(value);
         }
 
+        IFACEMETHODIMP get_LockStatistics(CanvasLockStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_LockStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP ResetLockStatistics() override
+        {
+            Assert::Fail(L"Unexpected call to ResetLockStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_AdapterId(ABI::Windows::Graphics::DisplayAdapterId* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_AdapterId");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MemoryUsage(CanvasMemoryUsage* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MemoryUsage");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP InsertFence(ICanvasGpuFence** value) override
+        {
+            Assert::Fail(L"Unexpected call to InsertFence");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP add_MemoryBudgetChanged(DeviceLostHandlerType* value, EventRegistrationToken* token) override
+        {
+            Assert::Fail(L"Unexpected call to add_MemoryBudgetChanged");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP remove_MemoryBudgetChanged(EventRegistrationToken token) override
+        {
+            Assert::Fail(L"Unexpected call to remove_MemoryBudgetChanged");
+            return E_NOTIMPL;
+        }
+
         //
         // ICanvasResourceCreator
         //
@@ -345,6 +457,17 @@ namespace canvas
             return CreateSwapChainForCompositionMethod.WasCalled(widthInPixels, heightInPixels, format, bufferCount, alphaMode);
         }
 
+        virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCompositionWithFlags(
+            int32_t widthInPixels,
+            int32_t heightInPixels,
+            DirectXPixelFormat format,
+            int32_t bufferCount,
+            CanvasAlphaMode alphaMode,
+            UINT flags) override
+        {
+            return CreateSwapChainForCompositionWithFlagsMethod.WasCalled(widthInPixels, heightInPixels, format, bufferCount, alphaMode, flags);
+        }
+
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCoreWindow(
             ICoreWindow* coreWindow,
             int32_t widthInPixels,
@@ -361,6 +484,13 @@ namespace canvas
             return CreateCommandListMethod.WasCalled();
         }
 
+        virtual ComPtr<ID2D1StrokeStyle1> CreateStrokeStyle(
+            D2D1_STROKE_STYLE_PROPERTIES1 const& properties,
+            std::vector<float> const& dashes) override
+        {
+            return CreateStrokeStyleMethod.WasCalled(properties, dashes);
+        }
+
         virtual ComPtr<ID2D1GeometryRealization> CreateFilledGeometryRealization(ID2D1Geometry* geometry, float flatteningTolerance) override
         {
             return CreateFilledGeometryRealizationMethod.WasCalled(geometry, flatteningTolerance);
@@ -390,6 +520,41 @@ namespace canvas
             return GetPrimaryDisplayOutputMethod.WasCalled();
         }
 
+        virtual bool IsTearingSupported() override
+        {
+            return IsTearingSupportedMethod.WasCalled();
+        }
+
+        virtual EffectCacheBudget* GetEffectCacheBudget() override
+        {
+            return GetEffectCacheBudgetMethod.WasCalled();
+        }
+
+        virtual EffectResourceCache* GetEffectResourceCache() override
+        {
+            return GetEffectResourceCacheMethod.WasCalled();
+        }
+
+        virtual StagingBitmapPool* GetStagingBitmapPool() override
+        {
+            return GetStagingBitmapPoolMethod.WasCalled();
+        }
+
+        virtual RenderTargetPool* GetRenderTargetPool() override
+        {
+            return GetRenderTargetPoolMethod.WasCalled();
+        }
+
+        virtual SurfaceBitmapCache* GetSurfaceBitmapCache() override
+        {
+            return GetSurfaceBitmapCacheMethod.WasCalled();
+        }
+
+        virtual TextLayoutCache* GetTextLayoutCache() override
+        {
+            return GetTextLayoutCacheMethod.WasCalled();
+        }
+
         virtual void ThrowIfCreateSurfaceFailed(HRESULT hr, wchar_t const* typeName, uint32_t width, uint32_t height) override
         {
             ThrowIfFailed(hr);
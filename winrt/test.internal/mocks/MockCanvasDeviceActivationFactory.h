@@ -52,6 +52,20 @@ public:
         return E_NOTIMPL;
     }
 
+    IFACEMETHODIMP CreateWithGpuPreference(
+        CanvasGpuPreference gpuPreference,
+        ICanvasDevice** canvasDevice) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP CreateFromAdapterId(
+        ABI::Windows::Graphics::DisplayAdapterId adapterId,
+        ICanvasDevice** canvasDevice) override
+    {
+        return E_NOTIMPL;
+    }
+
     IFACEMETHODIMP GetSharedDevice(ICanvasDevice** device) override
     {
         return GetSharedDeviceWithForceSoftwareRenderer(FALSE, device);
@@ -64,6 +78,11 @@ public:
         return GetSharedDeviceWithForceSoftwareRendererMethod.WasCalled(forceSoftwareRenderer, device);
     }
 
+    IFACEMETHODIMP PreinitializeAsync(ABI::Windows::Foundation::IAsyncOperation<CanvasDevice*>**) override
+    {
+        return E_NOTIMPL;
+    }
+
     IFACEMETHODIMP put_DebugLevel(CanvasDebugLevel debugLevel) override
     {
         return put_DebugLevelMethod.WasCalled(debugLevel);
@@ -73,4 +92,44 @@ public:
     {
         return get_DebugLevelMethod.WasCalled(debugLevel);
     }
+
+    IFACEMETHODIMP put_DeviceContextPoolPrewarmCount(int32_t) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP get_DeviceContextPoolPrewarmCount(int32_t*) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP put_MaximumAsyncConcurrency(uint32_t) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP get_MaximumAsyncConcurrency(uint32_t*) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP put_AsyncWorkItemPriority(ABI::Windows::System::Threading::WorkItemPriority) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP get_AsyncWorkItemPriority(ABI::Windows::System::Threading::WorkItemPriority*) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP GetPerformanceCounters(CanvasPerformanceCounters*) override
+    {
+        return E_NOTIMPL;
+    }
+
+    IFACEMETHODIMP GetObjectCounts(CanvasObjectCounts*) override
+    {
+        return E_NOTIMPL;
+    }
 };
@@ -63,6 +63,8 @@ namespace canvas
         DONT_EXPECT(DrawImageAtCoordsWithSourceRectAndOpacityAndInterpolationAndPerspective , ICanvasBitmap*, float, float, Rect, float, CanvasImageInterpolation, Matrix4x4);
         DONT_EXPECT(DrawImageToRectWithSourceRectAndOpacityAndInterpolationAndPerspective   , ICanvasBitmap*, Rect, Rect, float, CanvasImageInterpolation, Matrix4x4);
 
+        DONT_EXPECT(DrawCachedImage                                       , ICanvasImage*, Vector2, ICanvasImageTileCache*);
+
         DONT_EXPECT(DrawLineWithBrush                                     , Vector2, Vector2, ICanvasBrush*);
         DONT_EXPECT(DrawLineAtCoordsWithBrush                             , float, float, float, float, ICanvasBrush*);
         DONT_EXPECT(DrawLineWithColor                                     , Vector2, Vector2, Color);
@@ -197,6 +199,9 @@ namespace canvas
         DONT_EXPECT(DrawCachedGeometryAtOriginWithBrush, ICanvasCachedGeometry*, ICanvasBrush*);
         DONT_EXPECT(DrawCachedGeometryAtOriginWithColor, ICanvasCachedGeometry*, Color);
 
+        DONT_EXPECT(FillMesh         , ICanvasMesh*, ICanvasBrush*);
+        DONT_EXPECT(FillMeshWithColor, ICanvasMesh*, Color);
+
         DONT_EXPECT(DrawTextLayoutWithBrush, ICanvasTextLayout*, Vector2, ICanvasBrush*);
         DONT_EXPECT(DrawTextLayoutAtCoordsWithBrush, ICanvasTextLayout*, float, float, ICanvasBrush*);
         DONT_EXPECT(DrawTextLayoutWithColor, ICanvasTextLayout*, Vector2, Color);
@@ -205,6 +210,7 @@ namespace canvas
 #if WINVER > _WIN32_WINNT_WINBLUE
         DONT_EXPECT(DrawInk, IIterable<InkStroke*>*);
         DONT_EXPECT(DrawInkWithHighContrast, IIterable<InkStroke*>*, boolean);
+        DONT_EXPECT(DrawInkWithCache, IIterable<InkStroke*>*, boolean, ICanvasInkCache*);
 
         DONT_EXPECT(DrawGradientMeshAtOrigin, ICanvasGradientMesh*);
         DONT_EXPECT(DrawGradientMesh, ICanvasGradientMesh*, Vector2);
@@ -214,6 +220,10 @@ namespace canvas
         DONT_EXPECT(DrawGlyphRun, Vector2, ICanvasFontFace*, float, uint32_t, CanvasGlyph*, boolean, uint32_t, ICanvasBrush*);
         DONT_EXPECT(DrawGlyphRunWithMeasuringMode, Vector2, ICanvasFontFace*, float, uint32_t, CanvasGlyph*, boolean, uint32_t, ICanvasBrush*, CanvasTextMeasuringMode);
         DONT_EXPECT(DrawGlyphRunWithMeasuringModeAndDescription, Vector2, ICanvasFontFace*, float, uint32_t, CanvasGlyph*, boolean, uint32_t, ICanvasBrush*, CanvasTextMeasuringMode, HSTRING, HSTRING, uint32_t, int*, uint32_t);
+        DONT_EXPECT(DrawGlyphRunObject, Vector2, ICanvasGlyphRun*, ICanvasBrush*);
+        DONT_EXPECT(DrawGlyphRunObjectWithMeasuringMode, Vector2, ICanvasGlyphRun*, ICanvasBrush*, CanvasTextMeasuringMode);
+        DONT_EXPECT(DrawGlyphRuns, uint32_t, Vector2*, uint32_t, ICanvasGlyphRun**, ICanvasBrush*);
+        DONT_EXPECT(DrawGlyphRunsWithBrushes, uint32_t, Vector2*, uint32_t, ICanvasGlyphRun**, uint32_t, ICanvasBrush**);
     
         DONT_EXPECT(get_Antialiasing            , CanvasAntialiasing*);
         DONT_EXPECT(put_Antialiasing            , CanvasAntialiasing);
@@ -231,6 +241,8 @@ namespace canvas
         DONT_EXPECT(put_EffectBufferPrecision   , IReference<CanvasBufferPrecision>*);
         DONT_EXPECT(get_EffectTileSize          , BitmapSize*);
         DONT_EXPECT(put_EffectTileSize          , BitmapSize);
+        DONT_EXPECT(get_Trace                   , ICanvasDrawingTrace**);
+        DONT_EXPECT(put_Trace                   , ICanvasDrawingTrace*);
 
         DONT_EXPECT(CreateLayerWithOpacity                                , float, ICanvasActiveLayer**);
         DONT_EXPECT(CreateLayerWithOpacityBrush                           , ICanvasBrush*, ICanvasActiveLayer**);
@@ -242,16 +254,39 @@ namespace canvas
         DONT_EXPECT(CreateLayerWithOpacityBrushAndClipGeometryAndTransform, ICanvasBrush*, ICanvasGeometry*, Matrix3x2, ICanvasActiveLayer**);
         DONT_EXPECT(CreateLayerWithAllOptions                             , float, ICanvasBrush*, Rect, ICanvasGeometry*, Matrix3x2, CanvasLayerOptions, ICanvasActiveLayer**);
 
+        DONT_EXPECT(BeginProfileScope, HSTRING, ICanvasProfileScope**);
+
+        DONT_EXPECT(SaveDrawingState, ICanvasDrawingState**);
+        DONT_EXPECT(RestoreDrawingState, ICanvasDrawingState*);
+
+        DONT_EXPECT(PushTransform, Matrix3x2);
+        DONT_EXPECT(PopTransform);
+        DONT_EXPECT(PushClip, Rect);
+        DONT_EXPECT(PopClip);
+
+        DONT_EXPECT(DrawRenderNode, ICanvasRenderNode*);
+
 #if WINVER > _WIN32_WINNT_WINBLUE
         DONT_EXPECT(CreateSpriteBatch                                       , ICanvasSpriteBatch**);
         DONT_EXPECT(CreateSpriteBatchWithSortMode                           , CanvasSpriteSortMode, ICanvasSpriteBatch**);
         DONT_EXPECT(CreateSpriteBatchWithSortModeAndInterpolation           , CanvasSpriteSortMode, CanvasImageInterpolation, ICanvasSpriteBatch**);
         DONT_EXPECT(CreateSpriteBatchWithSortModeAndInterpolationAndOptions , CanvasSpriteSortMode, CanvasImageInterpolation, CanvasSpriteOptions, ICanvasSpriteBatch**);
+        DONT_EXPECT(DrawCachedSpriteBatch                                   , ICanvasCachedSpriteBatch*);
+
+        DONT_EXPECT(DrawTextWithGlyphAtlas                                  , HSTRING, Vector2, Color, ICanvasTextFormat*, ICanvasGlyphAtlas*);
+        DONT_EXPECT(DrawTextLayoutWithGlyphAtlas                            , ICanvasTextLayout*, Vector2, Color, ICanvasGlyphAtlas*);
 
         DONT_EXPECT(DrawSvgAtOrigin, ICanvasSvgDocument*, Size);
         DONT_EXPECT(DrawSvgAtPoint, ICanvasSvgDocument*, Size, Vector2);
         DONT_EXPECT(DrawSvgAtCoords, ICanvasSvgDocument*, Size, float, float);
 #endif
+
+        DONT_EXPECT(FillRectangles, uint32_t, Rect*, uint32_t, Color*);
+        DONT_EXPECT(DrawRectangles, uint32_t, Rect*, uint32_t, Color*, float);
+        DONT_EXPECT(DrawLines, uint32_t, Vector2*, uint32_t, Color*, float);
+        DONT_EXPECT(FillCircles, uint32_t, Vector2*, uint32_t, float*, uint32_t, Color*);
+        DONT_EXPECT(DrawCachedGeometryInstances, ICanvasCachedGeometry*, uint32_t, Vector2*, uint32_t, Color*);
+        DONT_EXPECT(DrawCachedGeometryInstancesWithTransforms, ICanvasCachedGeometry*, uint32_t, Matrix3x2*, uint32_t, Color*);
         
         // ICanvasResourceWrapperNative
         DONT_EXPECT(GetNativeResource, ICanvasDevice* device, float dpi, REFIID iid, void**);
@@ -161,6 +161,15 @@ namespace canvas
             return E_NOTIMPL;
         }
 
+        IFACEMETHOD(ResizeBuffersAllowingOverallocation)(
+            float newWidth,
+            float newHeight,
+            float newDpi) override
+        {
+            Assert::Fail(L"Unexpected call to ResizeBuffersAllowingOverallocation");
+            return E_NOTIMPL;
+        }
+
         // IClosable
         IFACEMETHOD(Close)() override
         {
@@ -15,6 +15,11 @@ public:
     CALL_COUNTER_WITH_MOCK(CreateDrawingSessionMethod, HRESULT(Color,Rect,ICanvasDrawingSession**));
     CALL_COUNTER_WITH_MOCK(SuspendDrawingSessionMethod, HRESULT(ICanvasDrawingSession*));
     CALL_COUNTER_WITH_MOCK(ResumeDrawingSessionMethod, HRESULT(ICanvasDrawingSession*));
+    CALL_COUNTER_WITH_MOCK(DrawRegionsMethod, HRESULT(Color,uint32_t,Rect*,int32_t,ICanvasRegionDrawHandler*));
+    CALL_COUNTER_WITH_MOCK(get_PrefetchMarginMethod, HRESULT(float*));
+    CALL_COUNTER_WITH_MOCK(put_PrefetchMarginMethod, HRESULT(float));
+    CALL_COUNTER_WITH_MOCK(get_MaximumCachedTileCountMethod, HRESULT(uint32_t*));
+    CALL_COUNTER_WITH_MOCK(put_MaximumCachedTileCountMethod, HRESULT(uint32_t));
     CALL_COUNTER_WITH_MOCK(InvalidateMethod, HRESULT());
     CALL_COUNTER_WITH_MOCK(InvalidateRegionMethod, HRESULT(Rect));
     CALL_COUNTER_WITH_MOCK(RaiseRegionsInvalidatedIfAnyMethod, HRESULT());
@@ -56,6 +61,31 @@ public:
         return ResumeDrawingSessionMethod.WasCalled(d);
     }
 
+    IFACEMETHODIMP DrawRegions(Color c, uint32_t n, Rect* r, int32_t p, ICanvasRegionDrawHandler* h) override
+    {
+        return DrawRegionsMethod.WasCalled(c, n, r, p, h);
+    }
+
+    IFACEMETHODIMP get_PrefetchMargin(float* value) override
+    {
+        return get_PrefetchMarginMethod.WasCalled(value);
+    }
+
+    IFACEMETHODIMP put_PrefetchMargin(float value) override
+    {
+        return put_PrefetchMarginMethod.WasCalled(value);
+    }
+
+    IFACEMETHODIMP get_MaximumCachedTileCount(uint32_t* value) override
+    {
+        return get_MaximumCachedTileCountMethod.WasCalled(value);
+    }
+
+    IFACEMETHODIMP put_MaximumCachedTileCount(uint32_t value) override
+    {
+        return put_MaximumCachedTileCountMethod.WasCalled(value);
+    }
+
     IFACEMETHODIMP Invalidate() override
     {
         return InvalidateMethod.WasCalled();
@@ -40,6 +40,7 @@ namespace canvas
         MOCK_METHOD1(SetTextAntialiasMode             , void(D2D1_TEXT_ANTIALIAS_MODE));
         MOCK_METHOD0_CONST(GetUnitMode                , D2D1_UNIT_MODE());
         MOCK_METHOD1(SetUnitMode                      , void(D2D1_UNIT_MODE));
+        MOCK_METHOD2(SetTags                          , void(D2D1_TAG, D2D1_TAG));
         MOCK_METHOD2(SetDpi                           , void(float dpiX, float dpiY));
         MOCK_METHOD2_CONST(GetDpi                     , void(float* dpiX, float* dpiY));
         MOCK_METHOD5(DrawLine                         , void(D2D1_POINT_2F,D2D1_POINT_2F,ID2D1Brush*,float,ID2D1StrokeStyle*));
@@ -67,6 +68,8 @@ namespace canvas
         MOCK_METHOD2(EndDraw                          , HRESULT(D2D1_TAG*, D2D1_TAG*));
         MOCK_METHOD4(DrawGeometry                     , void(ID2D1Geometry*, ID2D1Brush*,float,ID2D1StrokeStyle*));
         MOCK_METHOD3(FillGeometry                     , void(ID2D1Geometry*,ID2D1Brush*,ID2D1Brush*));
+        MOCK_METHOD1(CreateMesh                       , HRESULT(ID2D1Mesh**));
+        MOCK_METHOD2(FillMesh                         , void(ID2D1Mesh*,ID2D1Brush*));
         MOCK_METHOD4(DrawTextLayout                   , void(D2D1_POINT_2F, IDWriteTextLayout*, ID2D1Brush*, D2D1_DRAW_TEXT_OPTIONS));
         MOCK_METHOD2(PushLayer                        , void(const D2D1_LAYER_PARAMETERS1*, ID2D1Layer*));
         MOCK_METHOD0(PopLayer                         , void());
@@ -188,17 +191,6 @@ namespace canvas
             return E_NOTIMPL;
         }
 
-        IFACEMETHODIMP CreateMesh(ID2D1Mesh **) override
-        {
-            Assert::Fail(L"Unexpected call to CreateMesh");
-            return E_NOTIMPL;
-        }
-
-        IFACEMETHODIMP_(void) FillMesh(ID2D1Mesh *,ID2D1Brush *) override
-        {
-            Assert::Fail(L"Unexpected call to FillMesh");
-        }
-
         IFACEMETHODIMP_(void) FillOpacityMask(ID2D1Bitmap *,ID2D1Brush *,D2D1_OPACITY_MASK_CONTENT,const D2D1_RECT_F *,const D2D1_RECT_F *) override
         {
             Assert::Fail(L"Unexpected call to FillOpacityMask");
@@ -216,11 +208,6 @@ namespace canvas
         }
 
 
-        IFACEMETHODIMP_(void) SetTags(D2D1_TAG,D2D1_TAG) override
-        {
-            Assert::Fail(L"Unexpected call to SetTags");
-        }
-
         IFACEMETHODIMP_(void) GetTags(D2D1_TAG *,D2D1_TAG *) const override
         {
             Assert::Fail(L"Unexpected call to GetTags");
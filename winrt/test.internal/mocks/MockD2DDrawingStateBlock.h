@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace canvas
+{
+    class MockD2DDrawingStateBlock : public RuntimeClass<
+        RuntimeClassFlags<ClassicCom>,
+        ChainInterfaces<ID2D1DrawingStateBlock1, ID2D1DrawingStateBlock, ID2D1Resource>>
+    {
+    public:
+        D2D1_DRAWING_STATE_DESCRIPTION1 Description;
+
+        MockD2DDrawingStateBlock()
+            : Description{}
+        {
+        }
+
+        // ID2D1DrawingStateBlock1
+
+        IFACEMETHODIMP_(void) GetDescription(D2D1_DRAWING_STATE_DESCRIPTION1* description) const override
+        {
+            *description = Description;
+        }
+
+        IFACEMETHODIMP_(void) SetDescription(D2D1_DRAWING_STATE_DESCRIPTION1 const* description) override
+        {
+            Description = *description;
+        }
+
+        // ID2D1DrawingStateBlock
+
+        IFACEMETHODIMP_(void) GetDescription(D2D1_DRAWING_STATE_DESCRIPTION*) const override
+        {
+            Assert::Fail(L"Unexpected call to GetDescription(D2D1_DRAWING_STATE_DESCRIPTION*)");
+        }
+
+        IFACEMETHODIMP_(void) SetDescription(D2D1_DRAWING_STATE_DESCRIPTION const*) override
+        {
+            Assert::Fail(L"Unexpected call to SetDescription(D2D1_DRAWING_STATE_DESCRIPTION const*)");
+        }
+
+        IFACEMETHODIMP_(void) SetTextRenderingParams(IDWriteRenderingParams*) override
+        {
+            Assert::Fail(L"Unexpected call to SetTextRenderingParams");
+        }
+
+        IFACEMETHODIMP_(void) GetTextRenderingParams(IDWriteRenderingParams**) const override
+        {
+            Assert::Fail(L"Unexpected call to GetTextRenderingParams");
+        }
+
+        // ID2D1Resource
+
+        IFACEMETHODIMP_(void) GetFactory(ID2D1Factory**) const override
+        {
+            Assert::Fail(L"Unexpected call to GetFactory");
+        }
+    };
+}
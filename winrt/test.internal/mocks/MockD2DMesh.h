@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace canvas
+{
+    class MockD2DMesh : public RuntimeClass<
+        RuntimeClassFlags<ClassicCom>,
+        ChainInterfaces<ID2D1Mesh, ID2D1Resource>>
+    {
+    public:
+
+        MOCK_METHOD1(Open, HRESULT(ID2D1TessellationSink**));
+        MOCK_METHOD1_CONST(GetFactory, void(ID2D1Factory**));
+
+    };
+}
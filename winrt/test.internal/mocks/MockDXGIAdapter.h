@@ -8,7 +8,7 @@ namespace canvas
 {
     class MockDxgiAdapter : public RuntimeClass<
         RuntimeClassFlags<ClassicCom>,
-        ChainInterfaces<IDXGIAdapter2, IDXGIAdapter1, IDXGIAdapter, IDXGIObject >>
+        ChainInterfaces<IDXGIAdapter3, IDXGIAdapter2, IDXGIAdapter1, IDXGIAdapter, IDXGIObject >>
     {
     public:
         // IDXGIObject
@@ -27,5 +27,13 @@ namespace canvas
 
         // IDXGIAdapter2
         MOCK_METHOD1(GetDesc2, HRESULT(DXGI_ADAPTER_DESC2*));
+
+        // IDXGIAdapter3
+        MOCK_METHOD2(RegisterHardwareContentProtectionTeardownStatusEvent, HRESULT(HANDLE, DWORD*));
+        MOCK_METHOD1(UnregisterHardwareContentProtectionTeardownStatus, void(DWORD));
+        MOCK_METHOD3(QueryVideoMemoryInfo, HRESULT(UINT, DXGI_MEMORY_SEGMENT_GROUP, DXGI_QUERY_VIDEO_MEMORY_INFO*));
+        MOCK_METHOD3(SetVideoMemoryReservation, HRESULT(UINT, DXGI_MEMORY_SEGMENT_GROUP, UINT64));
+        MOCK_METHOD2(RegisterVideoMemoryBudgetChangeNotificationEvent, HRESULT(HANDLE, DWORD*));
+        MOCK_METHOD1(UnregisterVideoMemoryBudgetChangeNotification, void(DWORD));
     };
 }
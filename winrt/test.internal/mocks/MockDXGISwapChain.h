@@ -6,11 +6,24 @@
 
 namespace canvas
 {
+#if WINVER > _WIN32_WINNT_WINBLUE
+    typedef ChainInterfaces<IDXGISwapChain4, IDXGISwapChain3, IDXGISwapChain2, IDXGISwapChain1, IDXGISwapChain, IDXGIDeviceSubObject, IDXGIObject> MockDxgiSwapChainInterfaces;
+#else
+    typedef ChainInterfaces<IDXGISwapChain2, IDXGISwapChain1, IDXGISwapChain, IDXGIDeviceSubObject, IDXGIObject> MockDxgiSwapChainInterfaces;
+#endif
+
     class MockDxgiSwapChain : public RuntimeClass<
         RuntimeClassFlags<ClassicCom>,
-        ChainInterfaces<IDXGISwapChain2, IDXGISwapChain1, IDXGISwapChain, IDXGIDeviceSubObject, IDXGIObject>>
+        MockDxgiSwapChainInterfaces>
     {
     public:
+#if WINVER > _WIN32_WINNT_WINBLUE
+        CALL_COUNTER_WITH_MOCK(SetHDRMetaDataMethod, HRESULT(DXGI_HDR_METADATA_TYPE, UINT, void*));
+        CALL_COUNTER_WITH_MOCK(GetCurrentBackBufferIndexMethod, UINT());
+        CALL_COUNTER_WITH_MOCK(CheckColorSpaceSupportMethod, HRESULT(DXGI_COLOR_SPACE_TYPE, UINT*));
+        CALL_COUNTER_WITH_MOCK(SetColorSpace1Method, HRESULT(DXGI_COLOR_SPACE_TYPE));
+        CALL_COUNTER_WITH_MOCK(ResizeBuffers1Method, HRESULT(UINT, UINT, UINT, DXGI_FORMAT, UINT, const UINT*, IUnknown* const*));
+#endif
         CALL_COUNTER_WITH_MOCK(SetSourceSizeMethod, HRESULT(UINT, UINT));
         CALL_COUNTER_WITH_MOCK(GetSourceSizeMethod, HRESULT(UINT*, UINT*));
         CALL_COUNTER_WITH_MOCK(SetMaximumFrameLatencyMethod, HRESULT(UINT));
@@ -43,6 +56,50 @@ namespace canvas
         CALL_COUNTER_WITH_MOCK(GetPrivateDataMethod, HRESULT(REFIID, UINT*, void*));
         CALL_COUNTER_WITH_MOCK(GetParentMethod, HRESULT(REFIID, void**));
 
+#if WINVER > _WIN32_WINNT_WINBLUE
+        // IDXGISwapChain4
+
+        virtual HRESULT STDMETHODCALLTYPE SetHDRMetaData(
+            DXGI_HDR_METADATA_TYPE type,
+            UINT size,
+            void* metaData) override
+        {
+            return SetHDRMetaDataMethod.WasCalled(type, size, metaData);
+        }
+
+        // IDXGISwapChain3
+
+        virtual UINT STDMETHODCALLTYPE GetCurrentBackBufferIndex() override
+        {
+            return GetCurrentBackBufferIndexMethod.WasCalled();
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE CheckColorSpaceSupport(
+            DXGI_COLOR_SPACE_TYPE colorSpace,
+            UINT* colorSpaceSupport) override
+        {
+            return CheckColorSpaceSupportMethod.WasCalled(colorSpace, colorSpaceSupport);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE SetColorSpace1(
+            DXGI_COLOR_SPACE_TYPE colorSpace) override
+        {
+            return SetColorSpace1Method.WasCalled(colorSpace);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE ResizeBuffers1(
+            UINT bufferCount,
+            UINT width,
+            UINT height,
+            DXGI_FORMAT format,
+            UINT swapChainFlags,
+            const UINT* creationNodeMask,
+            IUnknown* const* presentQueue) override
+        {
+            return ResizeBuffers1Method.WasCalled(bufferCount, width, height, format, swapChainFlags, creationNodeMask, presentQueue);
+        }
+#endif
+
         // IDXGISwapChain2
 
         virtual HRESULT STDMETHODCALLTYPE SetSourceSize(
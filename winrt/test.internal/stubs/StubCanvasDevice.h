@@ -24,6 +24,12 @@ namespace canvas
         ComPtr<MockD3D11Device> m_d3dDevice;
         ComPtr<MockEventSource<DeviceLostHandlerType>> m_deviceLostEventSource;
         DeviceContextPool m_deviceContextPool;
+        EffectCacheBudget m_effectCacheBudget;
+        EffectResourceCache m_effectResourceCache;
+        StagingBitmapPool m_stagingBitmapPool;
+        RenderTargetPool m_renderTargetPool;
+        SurfaceBitmapCache m_surfaceBitmapCache;
+        TextLayoutCache m_textLayoutCache;
         
     public:
         StubCanvasDevice(ComPtr<ID2D1Device1> device = Make<StubD2DDevice>(), ComPtr<MockD3D11Device> d3dDevice = nullptr)
@@ -60,6 +66,42 @@ namespace canvas
                     return m_deviceContextPool.TakeLease();
                 });
 
+            GetEffectCacheBudgetMethod.AllowAnyCall(
+                [=]
+                {
+                    return &m_effectCacheBudget;
+                });
+
+            GetEffectResourceCacheMethod.AllowAnyCall(
+                [=]
+                {
+                    return &m_effectResourceCache;
+                });
+
+            GetStagingBitmapPoolMethod.AllowAnyCall(
+                [=]
+                {
+                    return &m_stagingBitmapPool;
+                });
+
+            GetRenderTargetPoolMethod.AllowAnyCall(
+                [=]
+                {
+                    return &m_renderTargetPool;
+                });
+
+            GetSurfaceBitmapCacheMethod.AllowAnyCall(
+                [=]
+                {
+                    return &m_surfaceBitmapCache;
+                });
+
+            GetTextLayoutCacheMethod.AllowAnyCall(
+                [=]
+                {
+                    return &m_textLayoutCache;
+                });
+
             GetPrimaryDisplayOutputMethod.AllowAnyCall(
                 [=]
                 {
@@ -55,3 +55,89 @@ class MockStrokeCollection : public RuntimeClass<IIterable<InkStroke*>>
     }
 };
 
+
+class StubInkStroke : public RuntimeClass<IInkStroke>
+{
+public:
+    Rect BoundingRect;
+    bool IsSelected;
+
+    StubInkStroke(Rect const& boundingRect = Rect{})
+        : BoundingRect(boundingRect)
+        , IsSelected(false)
+    { }
+
+    IFACEMETHODIMP get_BoundingRect(Rect* value) override
+    {
+        *value = BoundingRect;
+        return S_OK;
+    }
+
+    IFACEMETHODIMP get_Selected(boolean* value) override
+    {
+        *value = IsSelected;
+        return S_OK;
+    }
+
+    IFACEMETHODIMP get_DrawingAttributes(IInkDrawingAttributes**) override { return E_NOTIMPL; }
+    IFACEMETHODIMP put_DrawingAttributes(IInkDrawingAttributes*) override { return E_NOTIMPL; }
+    IFACEMETHODIMP put_Selected(boolean) override { return E_NOTIMPL; }
+    IFACEMETHODIMP get_Recognized(boolean*) override { return E_NOTIMPL; }
+    IFACEMETHODIMP GetRenderingSegments(IVectorView<InkStrokeRenderingSegment*>**) override { return E_NOTIMPL; }
+    IFACEMETHODIMP Clone(IInkStroke**) override { return E_NOTIMPL; }
+};
+
+
+class StubStrokeSetCollection : public RuntimeClass<IIterable<IIterable<InkStroke*>*>>
+{
+    typedef std::vector<ComPtr<IIterable<InkStroke*>>> StrokeSets;
+
+    class Iterator : public RuntimeClass<IIterator<IIterable<InkStroke*>*>>
+    {
+        StrokeSets m_strokeSets;
+        size_t m_index;
+
+    public:
+        Iterator(StrokeSets const& strokeSets)
+            : m_strokeSets(strokeSets)
+            , m_index(0)
+        { }
+
+        IFACEMETHODIMP get_Current(IIterable<InkStroke*>** value) override
+        {
+            if (m_index >= m_strokeSets.size())
+                return E_BOUNDS;
+
+            return m_strokeSets[m_index].CopyTo(value);
+        }
+
+        IFACEMETHODIMP get_HasCurrent(boolean* value) override
+        {
+            *value = m_index < m_strokeSets.size();
+            return S_OK;
+        }
+
+        IFACEMETHODIMP MoveNext(boolean* value) override
+        {
+            m_index++;
+            return get_HasCurrent(value);
+        }
+
+        IFACEMETHODIMP GetMany(unsigned, IIterable<InkStroke*>**, unsigned*) override
+        {
+            return E_NOTIMPL;
+        }
+    };
+
+    StrokeSets m_strokeSets;
+
+public:
+    StubStrokeSetCollection(StrokeSets const& strokeSets)
+        : m_strokeSets(strokeSets)
+    { }
+
+    IFACEMETHODIMP First(IIterator<IIterable<InkStroke*>*>** value) override
+    {
+        return Make<Iterator>(m_strokeSets).CopyTo(value);
+    }
+};
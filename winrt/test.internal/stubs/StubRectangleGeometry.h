@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace canvas
+{
+    class StubRectangleGeometry : public RuntimeClass<ABI::Windows::UI::Xaml::Media::IRectangleGeometry>
+    {
+    public:
+        ABI::Windows::Foundation::Rect Rect;
+
+        StubRectangleGeometry()
+            : Rect{}
+        {
+        }
+
+        IFACEMETHODIMP get_Rect(ABI::Windows::Foundation::Rect* value) override { *value = Rect; return S_OK; }
+        IFACEMETHODIMP put_Rect(ABI::Windows::Foundation::Rect value) override { Rect = value; return S_OK; }
+    };
+}
@@ -10,25 +10,47 @@ class TestBitmapAdapter : public CanvasBitmapAdapter
 
 public:
     std::function<void()> MockCreateWicBitmapSource;
+    BitmapSize LastMaximumSize;
+    BitmapBounds LastSourceRectangle;
+    ProgressiveLoadInfo ProgressiveInfo;
+    int GetProgressiveLoadInfoCallCount;
 
     TestBitmapAdapter(ComPtr<IWICFormatConverter> converter)
         : m_converter(converter)
+        , LastMaximumSize{}
+        , LastSourceRectangle{}
+        , ProgressiveInfo{}
+        , GetProgressiveLoadInfoCallCount(0)
     {
     }
 
-    virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing) override
+    virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, HSTRING fileName, bool tryEnableIndexing, BitmapSize maximumSize, BitmapBounds sourceRectangle) override
     {
+        LastMaximumSize = maximumSize;
+        LastSourceRectangle = sourceRectangle;
         if (MockCreateWicBitmapSource)
             MockCreateWicBitmapSource();
         return WicBitmapSource{ m_converter, WICBitmapTransformRotate0 };
     }
 
-    virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing) override
+    virtual WicBitmapSource CreateWicBitmapSource(ICanvasDevice* device, IStream* fileStream, bool tryEnableIndexing, BitmapSize maximumSize, BitmapBounds sourceRectangle) override
     {
         Assert::Fail(); // Unexpected
         return WicBitmapSource{ m_converter, WICBitmapTransformRotate0 };
     }
 
+    virtual ProgressiveLoadInfo GetProgressiveLoadInfo(ICanvasDevice* device, HSTRING fileName) override
+    {
+        GetProgressiveLoadInfoCallCount++;
+        return ProgressiveInfo;
+    }
+
+    virtual ProgressiveLoadInfo GetProgressiveLoadInfo(ICanvasDevice* device, IStream* fileStream) override
+    {
+        Assert::Fail(); // Unexpected
+        return ProgressiveLoadInfo{};
+    }
+
     virtual ComPtr<IWICBitmapSource> CreateFlipRotator(
             ComPtr<IWICBitmapSource> const& source,
             WICBitmapTransformOptions transformOptions) override
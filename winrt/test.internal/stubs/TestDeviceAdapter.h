@@ -47,6 +47,8 @@ class TestDeviceAdapter : public CanvasDeviceAdapter
 
 public:
     CALL_COUNTER_WITH_MOCK(GetCoreApplicationMethod, ComPtr<ICoreApplication>());
+    CALL_COUNTER_WITH_MOCK(EnumAdapterByGpuPreferenceMethod, ComPtr<IDXGIAdapter>(CanvasGpuPreference));
+    CALL_COUNTER_WITH_MOCK(EnumAdapterByLuidMethod, ComPtr<IDXGIAdapter>(LUID));
 
     TestDeviceAdapter()
         : m_numD2DFactoryCreationCalls(0)
@@ -55,6 +57,7 @@ public:
         , m_allowHardware(true)
         , m_retrievableForceSoftwareRenderer(false)
         , m_retrievableUseDebugD3DDevice(false)
+        , m_retrievableSoftwareDeviceOptions(CanvasSoftwareDeviceOptions::None)
     {
         GetCoreApplicationMethod.AllowAnyCall(
             [&]
@@ -119,6 +122,46 @@ public:
         }
     }
 
+    virtual bool TryCreateD3DDeviceOnAdapter(
+        IDXGIAdapter* dxgiAdapter,
+        bool useDebugD3DDevice,
+        ComPtr<ID3D11Device>* device) override
+    {
+        m_retrievableDxgiAdapter = dxgiAdapter;
+        m_retrievableUseDebugD3DDevice = useDebugD3DDevice;
+
+        if (!m_allowHardware)
+            return false;
+
+        m_numD3dDeviceCreationCalls++;
+        *device = CreateStubD3D11Device();
+        return true;
+    }
+
+    virtual bool TryCreateSoftwareD3DDevice(
+        CanvasSoftwareDeviceOptions options,
+        bool useDebugD3DDevice,
+        ComPtr<ID3D11Device>* device) override
+    {
+        m_retrievableForceSoftwareRenderer = true;
+        m_retrievableSoftwareDeviceOptions = options;
+        m_retrievableUseDebugD3DDevice = useDebugD3DDevice;
+
+        m_numD3dDeviceCreationCalls++;
+        *device = CreateStubD3D11Device();
+        return true;
+    }
+
+    virtual ComPtr<IDXGIAdapter> EnumAdapterByGpuPreference(CanvasGpuPreference gpuPreference) override
+    {
+        return EnumAdapterByGpuPreferenceMethod.WasCalled(gpuPreference);
+    }
+
+    virtual ComPtr<IDXGIAdapter> EnumAdapterByLuid(LUID adapterLuid) override
+    {
+        return EnumAdapterByLuidMethod.WasCalled(adapterLuid);
+    }
+
     virtual ComPtr<IDXGIDevice3> GetDxgiDevice(ID2D1Device1* d2dDevice) override
     {
         ComPtr<ID2DDeviceWithDxgiDevice> d2dDeviceWithDxgiDevice;
@@ -154,6 +197,8 @@ public:
     int m_numD3dDeviceCreationCalls;
     bool m_retrievableForceSoftwareRenderer;
     bool m_retrievableUseDebugD3DDevice;
+    CanvasSoftwareDeviceOptions m_retrievableSoftwareDeviceOptions;
+    ComPtr<IDXGIAdapter> m_retrievableDxgiAdapter;
 
     ComPtr<ID2D1Factory2> m_overrideD2DFactory;
 };
@@ -325,6 +325,100 @@ TEST_CLASS(AsyncOperationTests)
     }
 
 
+    TEST_METHOD_EX(AsyncCanceledTest_WorkerCanObserveCancellation)
+    {
+        Event workerStarted(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event asyncCanFinishNow(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event asyncFinished(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+
+        bool wasCanceledAtStart = true;
+        bool wasCanceledAtEnd = false;
+        bool didContinuePastCheck = false;
+
+        auto async = Make<AsyncAction>([&]
+        {
+            wasCanceledAtStart = AsyncCancellation::IsCanceled();
+            SetEvent(workerStarted.Get());
+
+            Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(asyncCanFinishNow.Get(), waitTimeout, false));
+
+            wasCanceledAtEnd = AsyncCancellation::IsCanceled();
+
+            AsyncCancellation::ThrowIfCanceled();
+            didContinuePastCheck = true;
+        });
+
+        auto completedCallback = Callback<IAsyncActionCompletedHandler>([&](IAsyncAction*, AsyncStatus status)
+        {
+            Assert::AreEqual(AsyncStatus::Canceled, status);
+            SetEvent(asyncFinished.Get());
+            return S_OK;
+        });
+
+        ThrowIfFailed(async->put_Completed(completedCallback.Get()));
+
+        Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(workerStarted.Get(), waitTimeout, false));
+
+        async->Cancel();
+        SetEvent(asyncCanFinishNow.Get());
+
+        Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(asyncFinished.Get(), waitTimeout, false));
+
+        Assert::IsFalse(wasCanceledAtStart);
+        Assert::IsTrue(wasCanceledAtEnd);
+        Assert::IsFalse(didContinuePastCheck);
+
+        // Failing after cancellation must not turn into an error.
+        HRESULT errorCode = E_UNEXPECTED;
+        ThrowIfFailed(async->get_ErrorCode(&errorCode));
+        Assert::AreEqual(S_OK, errorCode);
+
+        // Outside of a worker function nothing is cancelled.
+        Assert::IsFalse(AsyncCancellation::IsCanceled());
+    }
+
+
+    TEST_METHOD_EX(AsyncCanceledTest_QueuedWorkerDoesNotRun)
+    {
+        auto& scheduler = AsyncScheduler::GetInstance();
+
+        scheduler.SetMaximumConcurrency(1);
+        auto restoreLimit = MakeScopeWarden([&] { scheduler.SetMaximumConcurrency(0); });
+
+        Event firstCanFinish(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event secondFinished(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+
+        auto first = Make<AsyncAction>([&]
+        {
+            Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(firstCanFinish.Get(), waitTimeout, false));
+        });
+
+        bool didSecondRun = false;
+
+        auto second = Make<AsyncAction>([&]
+        {
+            didSecondRun = true;
+        });
+
+        auto completedCallback = Callback<IAsyncActionCompletedHandler>([&](IAsyncAction*, AsyncStatus status)
+        {
+            Assert::AreEqual(AsyncStatus::Canceled, status);
+            SetEvent(secondFinished.Get());
+            return S_OK;
+        });
+
+        ThrowIfFailed(second->put_Completed(completedCallback.Get()));
+
+        // The second action is still queued behind the first.
+        second->Cancel();
+        SetEvent(firstCanFinish.Get());
+
+        Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(secondFinished.Get(), waitTimeout, false));
+
+        Assert::IsFalse(didSecondRun);
+    }
+
+
     TEST_METHOD_EX(AsyncContinuationTest)
     {
         MockAsyncResult result1, result2;
@@ -555,6 +649,90 @@ TEST_CLASS(AsyncOperationTests)
     }
 
 
+    TEST_METHOD_EX(AsyncScheduler_MaximumConcurrency_QueuesWorkBeyondTheLimit)
+    {
+        auto& scheduler = AsyncScheduler::GetInstance();
+
+        scheduler.SetMaximumConcurrency(1);
+        auto restoreLimit = MakeScopeWarden([&] { scheduler.SetMaximumConcurrency(0); });
+
+        Event firstCanFinish(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event firstFinished(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event secondStarted(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+
+        auto first = Make<AsyncAction>([&]
+        {
+            Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(firstCanFinish.Get(), waitTimeout, false));
+            SetEvent(firstFinished.Get());
+        });
+
+        auto second = Make<AsyncAction>([&]
+        {
+            // Only one work item may run at a time, so the first must be done by now.
+            Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(firstFinished.Get(), 0, false));
+            SetEvent(secondStarted.Get());
+        });
+
+        // The second action is queued behind the first.
+        Assert::AreEqual(static_cast<DWORD>(WAIT_TIMEOUT), WaitForSingleObjectEx(secondStarted.Get(), 100, false));
+
+        SetEvent(firstCanFinish.Get());
+
+        Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(secondStarted.Get(), waitTimeout, false));
+    }
+
+    TEST_METHOD_EX(AsyncScheduler_MaximumConcurrency_DoesNotQueueNestedWork)
+    {
+        auto& scheduler = AsyncScheduler::GetInstance();
+
+        scheduler.SetMaximumConcurrency(1);
+        auto restoreLimit = MakeScopeWarden([&] { scheduler.SetMaximumConcurrency(0); });
+
+        Event innerFinished(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event outerFinished(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+
+        auto outer = Make<AsyncAction>([&]
+        {
+            // This would deadlock if the inner action had to wait for the outer one's slot.
+            auto inner = Make<AsyncAction>([&] { SetEvent(innerFinished.Get()); });
+
+            Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(innerFinished.Get(), waitTimeout, false));
+            SetEvent(outerFinished.Get());
+        });
+
+        Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(outerFinished.Get(), waitTimeout, false));
+    }
+
+    TEST_METHOD_EX(AsyncScheduler_LimitParallelism)
+    {
+        auto& scheduler = AsyncScheduler::GetInstance();
+
+        Assert::AreEqual(8u, scheduler.LimitParallelism(8));
+
+        scheduler.SetMaximumConcurrency(3);
+        auto restoreLimit = MakeScopeWarden([&] { scheduler.SetMaximumConcurrency(0); });
+
+        Assert::AreEqual(3u, scheduler.LimitParallelism(8));
+        Assert::AreEqual(2u, scheduler.LimitParallelism(2));
+        Assert::AreEqual(1u, scheduler.LimitParallelism(0));
+    }
+
+    TEST_METHOD_EX(AsyncScheduler_SetPriority_RejectsInvalidValues)
+    {
+        using namespace ABI::Windows::System::Threading;
+
+        auto& scheduler = AsyncScheduler::GetInstance();
+
+        Assert::IsTrue(WorkItemPriority_Normal == scheduler.GetPriority());
+
+        scheduler.SetPriority(WorkItemPriority_Low);
+        Assert::IsTrue(WorkItemPriority_Low == scheduler.GetPriority());
+        scheduler.SetPriority(WorkItemPriority_Normal);
+
+        ExpectHResultException(E_INVALIDARG, [&] { scheduler.SetPriority(static_cast<WorkItemPriority>(2)); });
+    }
+
+
     template<typename T>
     static void AssertExpectedRefCount(ComPtr<T> const& ptr, unsigned long expected)
     {
@@ -0,0 +1,364 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "../lib/utils/BlockCompression.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+TEST_CLASS(BlockCompressionTests)
+{
+    static uint32_t ReadLittleEndian(uint8_t const* source, int byteCount)
+    {
+        uint32_t value = 0;
+
+        for (int i = byteCount - 1; i >= 0; i--)
+        {
+            value = (value << 8) | source[i];
+        }
+
+        return value;
+    }
+
+    static void DecodeRgb565(uint32_t rgb565, int (&bgr)[3])
+    {
+        auto r = (rgb565 >> 11) & 31;
+        auto g = (rgb565 >> 5) & 63;
+        auto b = rgb565 & 31;
+
+        bgr[0] = (b << 3) | (b >> 2);
+        bgr[1] = (g << 2) | (g >> 4);
+        bgr[2] = (r << 3) | (r >> 2);
+    }
+
+    // Decodes the color half of a block into BGRA, following the D3D rules.
+    static void DecodeColorBlock(uint8_t const* source, bool isBC1, uint8_t (&pixels)[16][4])
+    {
+        auto color0 = ReadLittleEndian(source, 2);
+        auto color1 = ReadLittleEndian(source + 2, 2);
+        auto indices = ReadLittleEndian(source + 4, 4);
+
+        int palette[4][4];
+        DecodeRgb565(color0, reinterpret_cast<int(&)[3]>(palette[0]));
+        DecodeRgb565(color1, reinterpret_cast<int(&)[3]>(palette[1]));
+
+        for (int p = 0; p < 4; p++)
+        {
+            palette[p][3] = 255;
+        }
+
+        for (int c = 0; c < 3; c++)
+        {
+            if (!isBC1 || color0 > color1)
+            {
+                palette[2][c] = (palette[0][c] * 2 + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + palette[1][c] * 2) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+
+        if (isBC1 && color0 <= color1)
+            palette[3][3] = 0;
+
+        for (int i = 0; i < 16; i++)
+        {
+            auto& entry = palette[(indices >> (i * 2)) & 3];
+
+            for (int c = 0; c < 4; c++)
+            {
+                pixels[i][c] = static_cast<uint8_t>(entry[c]);
+            }
+        }
+    }
+
+    static void DecodeExplicitAlphaBlock(uint8_t const* source, uint8_t (&pixels)[16][4])
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            auto alpha = (source[i / 2] >> ((i % 2) * 4)) & 15;
+            pixels[i][3] = static_cast<uint8_t>(alpha * 17);
+        }
+    }
+
+    static void DecodeInterpolatedAlphaBlock(uint8_t const* source, uint8_t (&pixels)[16][4])
+    {
+        int alpha0 = source[0];
+        int alpha1 = source[1];
+
+        int palette[8] = { alpha0, alpha1 };
+
+        if (alpha0 > alpha1)
+        {
+            for (int i = 1; i < 7; i++)
+            {
+                palette[i + 1] = (alpha0 * (7 - i) + alpha1 * i) / 7;
+            }
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+            {
+                palette[i + 1] = (alpha0 * (5 - i) + alpha1 * i) / 5;
+            }
+
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+
+        for (int i = 5; i >= 0; i--)
+        {
+            indices = (indices << 8) | source[2 + i];
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            pixels[i][3] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+        }
+    }
+
+    // Compresses an image then decodes it again, giving back a BGRA image
+    // the size of the blocks (ie. rounded up to a multiple of 4).
+    static std::vector<uint8_t> RoundTrip(DXGI_FORMAT format, std::vector<uint8_t> const& pixels, uint32_t width, uint32_t height)
+    {
+        uint32_t bytesPerBlock = (format == DXGI_FORMAT_BC1_UNORM) ? 8 : 16;
+
+        auto blocksWide = (width + 3) / 4;
+        auto blocksHigh = (height + 3) / 4;
+
+        std::vector<uint8_t> blocks(blocksWide * blocksHigh * bytesPerBlock);
+        CompressBlocks(format, pixels.data(), width * 4, width, height, blocks.data());
+
+        auto decodedWidth = blocksWide * 4;
+        std::vector<uint8_t> decoded(decodedWidth * blocksHigh * 4 * 4);
+
+        for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+        {
+            for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+            {
+                auto source = blocks.data() + (blockY * blocksWide + blockX) * bytesPerBlock;
+                uint8_t block[16][4];
+
+                switch (format)
+                {
+                case DXGI_FORMAT_BC1_UNORM:
+                    DecodeColorBlock(source, true, block);
+                    break;
+
+                case DXGI_FORMAT_BC2_UNORM:
+                    DecodeColorBlock(source + 8, false, block);
+                    DecodeExplicitAlphaBlock(source, block);
+                    break;
+
+                case DXGI_FORMAT_BC3_UNORM:
+                    DecodeColorBlock(source + 8, false, block);
+                    DecodeInterpolatedAlphaBlock(source, block);
+                    break;
+                }
+
+                for (int i = 0; i < 16; i++)
+                {
+                    auto x = blockX * 4 + i % 4;
+                    auto y = blockY * 4 + i / 4;
+
+                    memcpy(&decoded[(y * decodedWidth + x) * 4], block[i], 4);
+                }
+            }
+        }
+
+        return decoded;
+    }
+
+    static std::vector<uint8_t> MakeSolidImage(uint32_t width, uint32_t height, uint8_t b, uint8_t g, uint8_t r, uint8_t a)
+    {
+        std::vector<uint8_t> pixels(width * height * 4);
+
+        for (size_t i = 0; i < pixels.size(); i += 4)
+        {
+            pixels[i + 0] = b;
+            pixels[i + 1] = g;
+            pixels[i + 2] = r;
+            pixels[i + 3] = a;
+        }
+
+        return pixels;
+    }
+
+    static void AssertPixel(std::vector<uint8_t> const& decoded, uint32_t decodedWidth, uint32_t x, uint32_t y, int b, int g, int r, int a, int tolerance = 0)
+    {
+        auto pixel = &decoded[(y * decodedWidth + x) * 4];
+        int expected[4] = { b, g, r, a };
+
+        for (int c = 0; c < 4; c++)
+        {
+            Assert::IsTrue(abs(pixel[c] - expected[c]) <= tolerance);
+        }
+    }
+
+    TEST_METHOD_EX(BlockCompression_SolidColorsRoundTripExactly)
+    {
+        // Colors that are exactly representable as 565.
+        uint8_t colors[][3] =
+        {
+            { 0, 0, 0 },
+            { 255, 255, 255 },
+            { 255, 0, 0 },
+            { 0, 255, 0 },
+            { 0, 0, 255 },
+            { 132, 65, 24 },
+        };
+
+        for (auto format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC2_UNORM, DXGI_FORMAT_BC3_UNORM })
+        {
+            for (auto& color : colors)
+            {
+                auto pixels = MakeSolidImage(8, 8, color[0], color[1], color[2], 255);
+                auto decoded = RoundTrip(format, pixels, 8, 8);
+
+                Assert::IsTrue(pixels == decoded);
+            }
+        }
+    }
+
+    TEST_METHOD_EX(BlockCompression_GradientsAreClose)
+    {
+        for (auto format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC2_UNORM, DXGI_FORMAT_BC3_UNORM })
+        {
+            std::vector<uint8_t> pixels(16 * 4 * 4);
+
+            for (uint32_t x = 0; x < 16; x++)
+            {
+                for (uint32_t y = 0; y < 4; y++)
+                {
+                    auto pixel = &pixels[(y * 16 + x) * 4];
+                    pixel[0] = static_cast<uint8_t>(x * 16);
+                    pixel[1] = static_cast<uint8_t>(255 - x * 16);
+                    pixel[2] = static_cast<uint8_t>(128);
+                    pixel[3] = 255;
+                }
+            }
+
+            auto decoded = RoundTrip(format, pixels, 16, 4);
+
+            for (uint32_t x = 0; x < 16; x++)
+            {
+                for (uint32_t y = 0; y < 4; y++)
+                {
+                    auto pixel = &pixels[(y * 16 + x) * 4];
+                    AssertPixel(decoded, 16, x, y, pixel[0], pixel[1], pixel[2], 255, 12);
+                }
+            }
+        }
+    }
+
+    TEST_METHOD_EX(BlockCompression_BC1_TransparentPixelsDecodeAsTransparent)
+    {
+        auto pixels = MakeSolidImage(4, 4, 0, 0, 255, 255);
+
+        // Make the left half transparent.
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            for (uint32_t x = 0; x < 2; x++)
+            {
+                memset(&pixels[(y * 4 + x) * 4], 0, 4);
+            }
+        }
+
+        auto decoded = RoundTrip(DXGI_FORMAT_BC1_UNORM, pixels, 4, 4);
+
+        Assert::IsTrue(pixels == decoded);
+    }
+
+    TEST_METHOD_EX(BlockCompression_BC1_FullyTransparentBlock)
+    {
+        auto pixels = MakeSolidImage(4, 4, 0, 0, 0, 0);
+        auto decoded = RoundTrip(DXGI_FORMAT_BC1_UNORM, pixels, 4, 4);
+
+        Assert::IsTrue(pixels == decoded);
+    }
+
+    TEST_METHOD_EX(BlockCompression_BC2_AlphaIsQuantizedTo4Bits)
+    {
+        std::vector<uint8_t> pixels(4 * 4 * 4);
+
+        for (int i = 0; i < 16; i++)
+        {
+            // Premultiplied, so the color can't exceed alpha.
+            pixels[i * 4 + 3] = static_cast<uint8_t>(i * 17);
+        }
+
+        auto decoded = RoundTrip(DXGI_FORMAT_BC2_UNORM, pixels, 4, 4);
+
+        for (int i = 0; i < 16; i++)
+        {
+            Assert::AreEqual<int>(i * 17, decoded[i * 4 + 3]);
+        }
+    }
+
+    TEST_METHOD_EX(BlockCompression_BC3_AlphaIsInterpolated)
+    {
+        std::vector<uint8_t> pixels(4 * 4 * 4);
+
+        for (int i = 0; i < 16; i++)
+        {
+            pixels[i * 4 + 3] = static_cast<uint8_t>(40 + i * 10);
+        }
+
+        auto decoded = RoundTrip(DXGI_FORMAT_BC3_UNORM, pixels, 4, 4);
+
+        for (int i = 0; i < 16; i++)
+        {
+            // The range 40 to 190 is split into 7 steps of about 21.
+            Assert::IsTrue(abs(decoded[i * 4 + 3] - pixels[i * 4 + 3]) <= 11);
+        }
+
+        Assert::AreEqual<int>(40, decoded[3]);
+        Assert::AreEqual<int>(190, decoded[15 * 4 + 3]);
+    }
+
+    TEST_METHOD_EX(BlockCompression_BC3_ConstantAlpha)
+    {
+        auto pixels = MakeSolidImage(4, 4, 0, 0, 100, 100);
+        auto decoded = RoundTrip(DXGI_FORMAT_BC3_UNORM, pixels, 4, 4);
+
+        for (int i = 0; i < 16; i++)
+        {
+            Assert::AreEqual<int>(100, decoded[i * 4 + 3]);
+        }
+    }
+
+    TEST_METHOD_EX(BlockCompression_PartialBlocksArePaddedWithTransparentPixels)
+    {
+        for (auto format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC2_UNORM, DXGI_FORMAT_BC3_UNORM })
+        {
+            auto pixels = MakeSolidImage(5, 6, 255, 255, 255, 255);
+            auto decoded = RoundTrip(format, pixels, 5, 6);
+
+            for (uint32_t y = 0; y < 8; y++)
+            {
+                for (uint32_t x = 0; x < 8; x++)
+                {
+                    if (x < 5 && y < 6)
+                        AssertPixel(decoded, 8, x, y, 255, 255, 255, 255);
+                    else
+                        AssertPixel(decoded, 8, x, y, 0, 0, 0, 0);
+                }
+            }
+        }
+    }
+
+    TEST_METHOD_EX(BlockCompression_UnsupportedFormatsThrow)
+    {
+        uint8_t pixels[4 * 4 * 4] = {};
+        uint8_t blocks[16];
+
+        ExpectHResultException(E_INVALIDARG, [&] { CompressBlocks(DXGI_FORMAT_B8G8R8A8_UNORM, pixels, 16, 4, 4, blocks); });
+        ExpectHResultException(E_INVALIDARG, [&] { CompressBlocks(DXGI_FORMAT_BC7_UNORM, pixels, 16, 4, 4, blocks); });
+    }
+};
@@ -62,6 +62,72 @@ TEST_CLASS(HashUtilitiesTests)
     }
 
 
+    TEST_METHOD_EX(FastUuidTest)
+    {
+        static const IID salt1{ 0xA911588C, 0xDB0A, 0x41D2, 0xAF, 0x64, 0xEB, 0xEC, 0x03, 0x72, 0x94, 0xD0 };
+        static const IID salt2{ 0x88B56025, 0x60BC, 0x4FE9, 0xAA, 0x3F, 0x11, 0x48, 0xBD, 0x0C, 0x65, 0x3E };
+
+        // Cover block sized input, partial tails on both halves of a block, and empty input.
+        std::vector<BYTE> name(37);
+
+        for (size_t i = 0; i < name.size(); i++)
+        {
+            name[i] = static_cast<BYTE>(i * 7);
+        }
+
+        std::vector<IID> results;
+
+        for (size_t size : { 0, 5, 12, 16, 37 })
+        {
+            results.push_back(GetFastUuid(salt1, name.data(), size));
+            results.push_back(GetFastUuid(salt2, name.data(), size));
+
+            // Hashing the same inputs a second time should give the same result.
+            Assert::AreEqual(results[results.size() - 2], GetFastUuid(salt1, name.data(), size));
+            Assert::AreEqual(results[results.size() - 1], GetFastUuid(salt2, name.data(), size));
+        }
+
+        // Changing a single byte alters the UUID.
+        auto modified = name;
+        modified[36] ^= 1;
+        results.push_back(GetFastUuid(salt1, modified.data(), modified.size()));
+
+        // All results should be different.
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            for (size_t j = i + 1; j < results.size(); j++)
+            {
+                Assert::AreNotEqual(results[i], results[j]);
+            }
+
+            // Standard RFC 4122 variant, version 8 (custom) UUID.
+            Assert::AreEqual(2, GetUuidVariant(results[i]));
+            Assert::AreEqual(8, GetUuidVersion(results[i]));
+        }
+    }
+
+
+    TEST_METHOD_EX(IIDHash_CanBeUsedAsUnorderedMapKey)
+    {
+        std::unordered_map<IID, int, IIDHash> map;
+
+        map[__uuidof(ID2D1Bitmap1)] = 1;
+        map[__uuidof(ID2D1Effect)] = 2;
+        map[__uuidof(ID2D1Geometry)] = 3;
+
+        Assert::AreEqual<size_t>(3, map.size());
+        Assert::AreEqual(1, map[__uuidof(ID2D1Bitmap1)]);
+        Assert::AreEqual(2, map[__uuidof(ID2D1Effect)]);
+        Assert::AreEqual(3, map[__uuidof(ID2D1Geometry)]);
+
+        Assert::IsTrue(map.find(__uuidof(ID2D1Image)) == map.end());
+
+        // Equal IIDs must hash equally.
+        IID copy = __uuidof(ID2D1Effect);
+        Assert::AreEqual(IIDHash()(__uuidof(ID2D1Effect)), IIDHash()(copy));
+    }
+
+
     static int GetUuidVariant(IID const& uuid)
     {
         return (uuid.Data4[0] & 0xC0) >> 6;
@@ -228,6 +228,22 @@ namespace Microsoft
                 END_ENUM(CanvasDebugLevel);
             }
 
+            ENUM_TO_STRING(CanvasGpuPreference)
+            {
+                ENUM_VALUE(CanvasGpuPreference::Default);
+                ENUM_VALUE(CanvasGpuPreference::MinimumPower);
+                ENUM_VALUE(CanvasGpuPreference::HighPerformance);
+                END_ENUM(CanvasGpuPreference);
+            }
+
+            ENUM_TO_STRING(CanvasSoftwareDeviceOptions)
+            {
+                ENUM_VALUE(CanvasSoftwareDeviceOptions::None);
+                ENUM_VALUE(CanvasSoftwareDeviceOptions::SingleThreaded);
+                ENUM_VALUE(CanvasSoftwareDeviceOptions::NoInternalThreading);
+                END_ENUM(CanvasSoftwareDeviceOptions);
+            }
+
             ENUM_TO_STRING(RunWithDeviceFlags)
             {
                 ENUM_VALUE(RunWithDeviceFlags::None);
@@ -253,6 +269,14 @@ namespace Microsoft
                 END_ENUM(CanvasSwapChainRotation);
             }
 
+            ENUM_TO_STRING(CanvasSwapChainColorSpace)
+            {
+                ENUM_VALUE(CanvasSwapChainColorSpace::Srgb);
+                ENUM_VALUE(CanvasSwapChainColorSpace::ScRgb);
+                ENUM_VALUE(CanvasSwapChainColorSpace::Hdr10);
+                END_ENUM(CanvasSwapChainColorSpace);
+            }
+
             ENUM_TO_STRING(ChangeReason)
             {
                 ENUM_VALUE(ChangeReason::Other);
@@ -1119,6 +1143,19 @@ namespace Microsoft
                 END_ENUM(CanvasFigureFill);
             }
 
+            ENUM_TO_STRING(CanvasGeometryPathCommand)
+            {
+                ENUM_VALUE(CanvasGeometryPathCommand::BeginFigure);
+                ENUM_VALUE(CanvasGeometryPathCommand::AddLine);
+                ENUM_VALUE(CanvasGeometryPathCommand::AddCubicBezier);
+                ENUM_VALUE(CanvasGeometryPathCommand::AddQuadraticBezier);
+                ENUM_VALUE(CanvasGeometryPathCommand::AddArc);
+                ENUM_VALUE(CanvasGeometryPathCommand::SetFilledRegionDetermination);
+                ENUM_VALUE(CanvasGeometryPathCommand::SetSegmentOptions);
+                ENUM_VALUE(CanvasGeometryPathCommand::EndFigure);
+                END_ENUM(CanvasGeometryPathCommand);
+            }
+
             ENUM_TO_STRING(CanvasSweepDirection)
             {
                 ENUM_VALUE(CanvasSweepDirection::CounterClockwise);
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "../lib/utils/ParallelFor.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+TEST_CLASS(ParallelForTests)
+{
+    TEST_METHOD_EX(ParallelFor_CallsFunctorOnceForEveryIndex)
+    {
+        for (uint32_t parallelism : { 1u, 2u, 4u, 64u })
+        {
+            const uint32_t itemCount = 100;
+
+            std::vector<std::atomic<int>> callCounts(itemCount);
+
+            auto hr = ParallelFor(itemCount, parallelism,
+                [&](uint32_t index)
+                {
+                    Assert::IsTrue(index < itemCount);
+                    callCounts[index]++;
+                });
+
+            Assert::AreEqual(S_OK, hr);
+
+            for (auto& callCount : callCounts)
+            {
+                Assert::AreEqual(1, callCount.load());
+            }
+        }
+    }
+
+    TEST_METHOD_EX(ParallelFor_WithNoItems_DoesNotCallFunctor)
+    {
+        auto hr = ParallelFor(0, 4, [](uint32_t) { Assert::Fail(); });
+
+        Assert::AreEqual(S_OK, hr);
+    }
+
+    TEST_METHOD_EX(ParallelFor_WhenFunctorThrows_ReturnsTheFailure)
+    {
+        auto hr = ParallelFor(100, 4,
+            [&](uint32_t index)
+            {
+                if (index == 50)
+                    ThrowHR(E_ABORT);
+            });
+
+        Assert::AreEqual(E_ABORT, hr);
+    }
+
+    TEST_METHOD_EX(ParallelFor_WhenFunctorThrows_StopsClaimingIndices)
+    {
+        uint32_t callCount = 0;
+
+        // With a parallelism of one everything runs on this thread, in order.
+        auto hr = ParallelFor(100, 1,
+            [&](uint32_t index)
+            {
+                callCount++;
+
+                if (index == 2)
+                    ThrowHR(E_ABORT);
+            });
+
+        Assert::AreEqual(E_ABORT, hr);
+        Assert::AreEqual(3u, callCount);
+    }
+
+    TEST_METHOD_EX(ParallelFor_DoesNotStartMoreWorkersThanItems)
+    {
+        DWORD threadId = 0;
+
+        auto hr = ParallelFor(1, 64,
+            [&](uint32_t)
+            {
+                threadId = GetCurrentThreadId();
+            });
+
+        Assert::AreEqual(S_OK, hr);
+
+        // With only one item, it is done on the calling thread.
+        Assert::AreEqual(GetCurrentThreadId(), threadId);
+    }
+};
@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "../lib/utils/PixelSwizzle.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+TEST_CLASS(PixelSwizzleTests)
+{
+    static std::vector<uint8_t> MakeTestPixels(uint32_t pixelCount)
+    {
+        std::vector<uint8_t> pixels(pixelCount * 4);
+
+        for (size_t i = 0; i < pixels.size(); i++)
+        {
+            pixels[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+
+        return pixels;
+    }
+
+    static void VerifySwizzle(PixelSwizzle swizzle, int const (&order)[4])
+    {
+        // Cover lengths that exercise the SIMD loops as well as their scalar tails.
+        for (uint32_t pixelCount = 0; pixelCount < 40; pixelCount++)
+        {
+            auto source = MakeTestPixels(pixelCount);
+            std::vector<uint8_t> dest(source.size());
+
+            SwizzlePixels(swizzle, source.data(), dest.data(), pixelCount);
+
+            for (uint32_t i = 0; i < pixelCount; i++)
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    Assert::AreEqual<int>(source[i * 4 + order[j]], dest[i * 4 + j]);
+                }
+            }
+
+            // Converting in place should give the same result.
+            SwizzlePixels(swizzle, source.data(), source.data(), pixelCount);
+            Assert::IsTrue(source == dest);
+        }
+    }
+
+    TEST_METHOD_EX(PixelSwizzle_BgraToArgb)
+    {
+        VerifySwizzle(PixelSwizzle::BgraToArgb, { 3, 2, 1, 0 });
+    }
+
+    TEST_METHOD_EX(PixelSwizzle_BgraToArgb_IsItsOwnInverse)
+    {
+        auto source = MakeTestPixels(37);
+        std::vector<uint8_t> dest(source.size());
+
+        SwizzlePixels(PixelSwizzle::BgraToArgb, source.data(), dest.data(), 37);
+        SwizzlePixels(PixelSwizzle::BgraToArgb, dest.data(), dest.data(), 37);
+
+        Assert::IsTrue(source == dest);
+    }
+
+    TEST_METHOD_EX(PixelSwizzle_ArgbToRgba)
+    {
+        VerifySwizzle(PixelSwizzle::ArgbToRgba, { 1, 2, 3, 0 });
+    }
+
+    TEST_METHOD_EX(PixelSwizzle_MatchesColorLayout)
+    {
+        Color color{ 1, 2, 3, 4 };  // A, R, G, B
+        uint8_t bgra[4];
+        uint8_t rgba[4];
+
+        SwizzlePixels(PixelSwizzle::BgraToArgb, reinterpret_cast<uint8_t const*>(&color), bgra, 1);
+        SwizzlePixels(PixelSwizzle::ArgbToRgba, reinterpret_cast<uint8_t const*>(&color), rgba, 1);
+
+        Assert::AreEqual<int>(color.B, bgra[0]);
+        Assert::AreEqual<int>(color.G, bgra[1]);
+        Assert::AreEqual<int>(color.R, bgra[2]);
+        Assert::AreEqual<int>(color.A, bgra[3]);
+
+        Assert::AreEqual<int>(color.R, rgba[0]);
+        Assert::AreEqual<int>(color.G, rgba[1]);
+        Assert::AreEqual<int>(color.B, rgba[2]);
+        Assert::AreEqual<int>(color.A, rgba[3]);
+    }
+
+    // One pixel for every combination of color and alpha value.
+    static std::vector<uint8_t> MakeAllColorAlphaPairs()
+    {
+        std::vector<uint8_t> pixels;
+
+        for (int alpha = 0; alpha < 256; alpha++)
+        {
+            for (int value = 0; value < 256; value++)
+            {
+                pixels.push_back(static_cast<uint8_t>(value));
+                pixels.push_back(static_cast<uint8_t>(255 - value));
+                pixels.push_back(static_cast<uint8_t>(value / 2));
+                pixels.push_back(static_cast<uint8_t>(alpha));
+            }
+        }
+
+        // Odd one out, so the SIMD paths have a tail to deal with.
+        pixels.insert(pixels.end(), { 1, 2, 3, 200 });
+
+        return pixels;
+    }
+
+    TEST_METHOD_EX(ConvertPixelAlpha_Premultiply_MatchesDivision)
+    {
+        auto source = MakeAllColorAlphaPairs();
+        std::vector<uint8_t> dest(source.size());
+        auto pixelCount = static_cast<uint32_t>(source.size() / 4);
+
+        ConvertPixelAlpha(AlphaConversion::Premultiply, source.data(), dest.data(), pixelCount);
+
+        for (size_t i = 0; i < source.size(); i++)
+        {
+            int alpha = source[i | 3];
+            int expected = ((i & 3) == 3) ? alpha : (source[i] * alpha * 2 + 255) / 510;
+
+            Assert::AreEqual(expected, static_cast<int>(dest[i]));
+        }
+    }
+
+    TEST_METHOD_EX(ConvertPixelAlpha_Unpremultiply_MatchesDivision)
+    {
+        auto source = MakeAllColorAlphaPairs();
+        std::vector<uint8_t> dest(source.size());
+        auto pixelCount = static_cast<uint32_t>(source.size() / 4);
+
+        ConvertPixelAlpha(AlphaConversion::Unpremultiply, source.data(), dest.data(), pixelCount);
+
+        for (size_t i = 0; i < source.size(); i++)
+        {
+            int alpha = source[i | 3];
+            int expected;
+
+            if (alpha == 0)
+                expected = 0;
+            else if ((i & 3) == 3)
+                expected = alpha;
+            else
+                expected = std::min(255, (source[i] * 255 + alpha / 2) / alpha);
+
+            Assert::AreEqual(expected, static_cast<int>(dest[i]));
+        }
+    }
+
+    TEST_METHOD_EX(ConvertPixelAlpha_None_Copies)
+    {
+        auto source = MakeAllColorAlphaPairs();
+        std::vector<uint8_t> dest(source.size());
+
+        ConvertPixelAlpha(AlphaConversion::None, source.data(), dest.data(), static_cast<uint32_t>(source.size() / 4));
+
+        Assert::IsTrue(source == dest);
+    }
+
+    TEST_METHOD_EX(GetAlphaConversion_OnlyConvertsBetweenStraightAndPremultiplied)
+    {
+        Assert::IsTrue(AlphaConversion::Premultiply == GetAlphaConversion(CanvasAlphaMode::Straight, CanvasAlphaMode::Premultiplied));
+        Assert::IsTrue(AlphaConversion::Unpremultiply == GetAlphaConversion(CanvasAlphaMode::Premultiplied, CanvasAlphaMode::Straight));
+
+        Assert::IsTrue(AlphaConversion::None == GetAlphaConversion(CanvasAlphaMode::Straight, CanvasAlphaMode::Straight));
+        Assert::IsTrue(AlphaConversion::None == GetAlphaConversion(CanvasAlphaMode::Premultiplied, CanvasAlphaMode::Premultiplied));
+        Assert::IsTrue(AlphaConversion::None == GetAlphaConversion(CanvasAlphaMode::Ignore, CanvasAlphaMode::Straight));
+        Assert::IsTrue(AlphaConversion::None == GetAlphaConversion(CanvasAlphaMode::Premultiplied, CanvasAlphaMode::Ignore));
+    }
+};
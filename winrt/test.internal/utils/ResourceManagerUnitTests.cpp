@@ -378,6 +378,63 @@ TEST_CLASS(ResourceManagerUnitTests)
         ValidateStoredErrorState(E_INVALIDARG, Strings::ResourceManagerWrongDpi);
     }
 
+    static ComPtr<DummyWrapper> s_racingWrapper;
+
+    static bool TryCreateDummyResourceWhileRacing(ICanvasDevice* device, IUnknown* resource, float dpi, ComPtr<IInspectable>* result)
+    {
+        // Simulate another thread wrapping the same resource while we are
+        // still in the middle of creating our own wrapper.
+        s_racingWrapper = Make<DummyWrapper>(As<IDummyResource>(resource).Get());
+
+        return ResourceManager::TryCreate<IDummyResource, DummyWrapper, ResourceManager::MakeWrapper>(device, resource, dpi, result);
+    }
+
+    TEST_METHOD_EX(ResourceManager_GetOrCreate_WhenAnotherWrapperIsCreatedConcurrently_ReturnsTheOtherWrapper)
+    {
+        ResourceManager::RegisterType(TryCreateDummyResourceWhileRacing);
+        auto restoreTypeTable = MakeScopeWarden([&]
+        {
+            ResourceManager::UnregisterType(TryCreateDummyResourceWhileRacing);
+            s_racingWrapper.Reset();
+        });
+
+        auto resource = Make<DummyResource>();
+
+        auto wrapper = ResourceManager::GetOrCreate<IDummyWrapper>(resource.Get());
+
+        Assert::AreEqual<IDummyWrapper*>(s_racingWrapper.Get(), wrapper.Get());
+    }
+
+    TEST_METHOD_EX(ResourceManager_ManyResources_CanBeAddedAndRemoved)
+    {
+        auto tryCreateDummyResource = ResourceManager::TryCreate<IDummyResource, DummyWrapper, ResourceManager::MakeWrapper>;
+        ResourceManager::RegisterType(tryCreateDummyResource);
+        auto restoreTypeTable = MakeScopeWarden([&] { ResourceManager::UnregisterType(tryCreateDummyResource); });
+
+        std::vector<ComPtr<IDummyResource>> resources;
+        std::vector<ComPtr<IDummyWrapper>> wrappers;
+
+        // Enough resources to populate every shard of the interop table.
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto resource = Make<DummyResource>();
+
+            resources.push_back(resource);
+            wrappers.push_back(ResourceManager::GetOrCreate<IDummyWrapper>(resource.Get()));
+        }
+
+        for (size_t i = 0; i < resources.size(); ++i)
+        {
+            auto actual = ResourceManager::GetOrCreate<IDummyWrapper>(resources[i].Get());
+            Assert::AreEqual(wrappers[i].Get(), actual.Get());
+        }
+
+        for (auto& wrapper : wrappers)
+        {
+            ThrowIfFailed(As<IClosable>(wrapper)->Close());
+        }
+    }
+
     TEST_METHOD_EX(ResourceManager_GetOrCreate_UnknownType_Fails)
     {
         // For this test we do NOT register IDummyResource via ResourceManager::RegisterType.
@@ -394,6 +451,9 @@ TEST_CLASS(ResourceManagerUnitTests)
 };
 
 
+ComPtr<DummyWrapper> ResourceManagerUnitTests::s_racingWrapper;
+
+
 //
 // Verify that ResourceManager copes with COM objects that require QI to
 // IUnknown for equality comparisons.
@@ -478,3 +538,68 @@ TEST_CLASS(ResourceManagerRequiresCOMIdentity)
         Assert::AreEqual(wrapper1.Get(), wrapper2.Get());
     }
 };
+
+
+//
+// Verify that ResourceManager doesn't assume every object with the same
+// vtable supports the same interfaces, unless it knows the class.
+//
+
+namespace
+{
+    // Stands in for an aggregated or tear-off object: every instance shares
+    // one vtable, but each can expose a different extra interface.
+    class ResourceWithTearOff : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IDummyResource>
+    {
+        IID m_tearOffIid;
+        ComPtr<IUnknown> m_tearOff;
+
+    public:
+        ResourceWithTearOff(IID const& tearOffIid, IUnknown* tearOff)
+            : m_tearOffIid(tearOffIid)
+            , m_tearOff(tearOff)
+        {
+        }
+
+        IFACEMETHODIMP QueryInterface(REFIID iid, void** object) override
+        {
+            if (IsEqualGUID(iid, m_tearOffIid))
+                return m_tearOff->QueryInterface(iid, object);
+
+            return __super::QueryInterface(iid, object);
+        }
+    };
+}
+
+TEST_CLASS(ResourceManagerProbeCache)
+{
+    TEST_METHOD_EX(ResourceManager_GetOrCreate_ObjectsThatMayVary_AreProbedFromTheStart)
+    {
+        CanvasDeviceAdapter::SetInstance(std::make_shared<TestDeviceAdapter>());
+
+        // This matches every ResourceWithTearOff, so it would wrap any that
+        // started probing after the entry it should have matched.
+        auto tryCreateDummyResource = ResourceManager::TryCreate<IDummyResource, DummyWrapper, ResourceManager::MakeWrapper>;
+        ResourceManager::RegisterType(tryCreateDummyResource);
+        auto restoreTypeTable = MakeScopeWarden([&] { ResourceManager::UnregisterType(tryCreateDummyResource); });
+
+        // The first object is probed as a swap chain, which can't be wrapped
+        // without a device.
+        auto swapChainObject = Make<ResourceWithTearOff>(__uuidof(IDXGISwapChain1), Make<MockDxgiSwapChain>().Get());
+
+        ExpectHResultException(E_INVALIDARG, [&]
+        {
+            ResourceManager::GetOrCreate(nullptr, swapChainObject.Get(), 0);
+        });
+
+        // The second has the same vtable but is a D2D device, which comes
+        // before swap chains in the type table.
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto deviceObject = Make<ResourceWithTearOff>(__uuidof(ID2D1Device1), d2dDevice.Get());
+
+        auto wrapper = ResourceManager::GetOrCreate(nullptr, deviceObject.Get(), 0);
+
+        Assert::IsNotNull(MaybeAs<ICanvasDevice>(wrapper).Get());
+        Assert::IsNull(MaybeAs<IDummyWrapper>(wrapper).Get());
+    }
+};
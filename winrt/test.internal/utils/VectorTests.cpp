@@ -648,4 +648,41 @@ TEST_CLASS(VectorTests)
         ComPtr<IIterator<MockRuntimeClass*>> iterator;
         ThrowIfFailed(v->First(&iterator));
     }
+
+
+    TEST_METHOD_EX(VectorPooledAllocationTest)
+    {
+        // Releasing a pooled vector should make its memory available to the next one.
+        Vector<int>* firstAddress;
+
+        {
+            auto first = MakePooled<Vector<int>>();
+            CheckMakeResult(first);
+            firstAddress = first.Get();
+        }
+
+        auto second = MakePooled<Vector<int>>();
+        CheckMakeResult(second);
+        Assert::IsTrue(firstAddress == second.Get());
+
+        // Vectors from Make can be pooled too, and still work as usual.
+        auto made = Make<Vector<int>>();
+        ThrowIfFailed(made->Append(1));
+        AssertVectorsEqual<int>(made, { 1 });
+        made.Reset();
+
+        ThrowIfFailed(second->Append(2));
+        AssertVectorsEqual<int>(second, { 2 });
+
+        // Views and iterators come from their own pools.
+        ComPtr<IVectorView<int>> view;
+        ThrowIfFailed(second->GetView(&view));
+
+        ComPtr<IIterator<int>> iterator;
+        ThrowIfFailed(view->First(&iterator));
+
+        int current;
+        ThrowIfFailed(iterator->get_Current(&current));
+        Assert::AreEqual(2, current);
+    }
 };
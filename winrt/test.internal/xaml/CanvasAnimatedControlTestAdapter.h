@@ -18,9 +18,15 @@ class FakeGameThread : public IGameLoopThread
     std::vector<ComPtr<AnimatedControlAsyncAction>> m_pendingActions;
 
 public:
+    // When set, the thread takes over the control's frame wait, as a shared
+    // game loop thread does, leaving it in DeferredFrameWait.
+    bool DeferFrameWaits;
+    std::function<void()> DeferredFrameWait;
+
     FakeGameThread()
         : m_dispatcher(Make<StubDispatcher>())
         , m_dispatcherActive(false)
+        , DeferFrameWaits(false)
     {
     }
 
@@ -81,6 +87,15 @@ public:
         ThrowIfFailed(m_dispatcher->get_HasThreadAccess(&result));
         return !!result;
     }
+
+    virtual bool TryDeferFrameWait(std::function<void()> const& wait) override
+    {
+        if (!DeferFrameWaits)
+            return false;
+
+        DeferredFrameWait = wait;
+        return true;
+    }
 };
 
 class CanvasAnimatedControlTestAdapter : public BaseControlTestAdapter<CanvasAnimatedControlTraits>
@@ -93,11 +108,14 @@ class CanvasAnimatedControlTestAdapter : public BaseControlTestAdapter<CanvasAni
 
 public:
     CALL_COUNTER_WITH_MOCK(CreateCanvasSwapChainMethod, ComPtr<CanvasSwapChain>(ICanvasDevice*, float, float, float, CanvasAlphaMode));
+    CALL_COUNTER_WITH_MOCK(CreateCanvasSwapChainWithOptionsMethod, ComPtr<CanvasSwapChain>(ICanvasDevice*, float, float, float, CanvasAlphaMode, uint32_t, bool, CanvasSwapChainColorSpace));
     ComPtr<StubCanvasDevice> InitialDevice;
+    bool LastUseSharedThread;
 
     CanvasAnimatedControlTestAdapter(StubCanvasDevice* initialDevice = nullptr)
         : m_performanceCounter(1)
         , InitialDevice(initialDevice)
+        , LastUseSharedThread(false)
         , m_swapChainPanel(Make<StubSwapChainPanel>())
     {
         m_swapChainPanel->SetSwapChainMethod.AllowAnyCall(
@@ -119,6 +137,19 @@ public:
         return CreateCanvasSwapChainMethod.WasCalled(device, width, height, dpi, alphaMode);
     }
 
+    virtual ComPtr<CanvasSwapChain> CreateCanvasSwapChainWithOptions(
+        ICanvasDevice* device,
+        float width,
+        float height,
+        float dpi,
+        CanvasAlphaMode alphaMode,
+        uint32_t maximumFrameLatency,
+        bool allowTearing,
+        CanvasSwapChainColorSpace colorSpace) override
+    {
+        return CreateCanvasSwapChainWithOptionsMethod.WasCalled(device, width, height, dpi, alphaMode, maximumFrameLatency, allowTearing, colorSpace);
+    }
+
     virtual ComPtr<CanvasSwapChainPanel> CreateCanvasSwapChainPanel() override
     {
         auto swapChainPanel = Make<CanvasSwapChainPanel>(m_swapChainPanelAdapter);
@@ -150,6 +181,11 @@ public:
             return nullptr;
     }
 
+    std::shared_ptr<FakeGameThread> GetGameThread()
+    {
+        return m_gameThread.lock();
+    }
+
     bool GameThreadHasPendingWork()
     {
         if (auto thread = m_gameThread.lock())
@@ -158,8 +194,11 @@ public:
             return false;
     }
 
-    virtual std::unique_ptr<CanvasGameLoop> CreateAndStartGameLoop(CanvasAnimatedControl* control, ISwapChainPanel*) override
+    virtual std::unique_ptr<CanvasGameLoop> CreateAndStartGameLoop(CanvasAnimatedControl* control, ISwapChainPanel*, bool useSharedThread) override
     {
+        LastUseSharedThread = useSharedThread;
+
+
         // CanvasGameLoop takes ownership of the IGameLoopThread we give it.
         // However, for our tests we also want to allow the adapter to hold on
         // to the thread.  So we store the underlying FakeGameThread in a
@@ -186,6 +225,7 @@ public:
             virtual void StopDispatcher() { m_thread->StopDispatcher(); }
             virtual ComPtr<IAsyncAction> RunAsync(IDispatchedHandler* handler) { return m_thread->RunAsync(handler); }
             virtual bool HasThreadAccess() { return m_thread->HasThreadAccess(); }
+            virtual bool TryDeferFrameWait(std::function<void()> const& wait) { return m_thread->TryDeferFrameWait(wait); }
         };
 
         auto gameThread = std::make_shared<FakeGameThread>();
@@ -219,6 +259,12 @@ public:
         if (m_sleepFn) m_sleepFn(timeInMs);
     }
 
+    std::function<void(int64_t)> m_waitUntilFn;
+    virtual void WaitUntil(int64_t performanceCounter) override
+    {
+        if (m_waitUntilFn) m_waitUntilFn(performanceCounter);
+    }
+
     void SetTime(int64_t time)
     {
         m_performanceCounter = time;
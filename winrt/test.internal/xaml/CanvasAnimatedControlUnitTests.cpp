@@ -313,6 +313,409 @@ TEST_CLASS(CanvasAnimatedControlTests)
         Assert::AreEqual(E_INVALIDARG, f.Control->put_TargetElapsedTime(neg));
     }
 
+    TEST_METHOD_EX(CanvasAnimatedControl_MaximumFrameLatency_DefaultsToZero_AndMustBeInRange)
+    {
+        CanvasAnimatedControlFixture f;
+
+        int32_t value = -1;
+        Assert::AreEqual(S_OK, f.Control->get_MaximumFrameLatency(&value));
+        Assert::AreEqual(0, value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_MaximumFrameLatency(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_MaximumFrameLatency(-1));
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_MaximumFrameLatency(DXGI_MAX_SWAP_CHAIN_BUFFERS + 1));
+
+        Assert::AreEqual(S_OK, f.Control->put_MaximumFrameLatency(DXGI_MAX_SWAP_CHAIN_BUFFERS));
+        Assert::AreEqual(S_OK, f.Control->get_MaximumFrameLatency(&value));
+        Assert::AreEqual(static_cast<int32_t>(DXGI_MAX_SWAP_CHAIN_BUFFERS), value);
+    }
+
+    class FrameLatencyFixture : public CanvasAnimatedControlFixture
+    {
+    public:
+        ComPtr<StubDxgiSwapChain> WaitableSwapChain;
+        Event SignaledEvent;
+
+        FrameLatencyFixture()
+            : SignaledEvent(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET | CREATE_EVENT_INITIAL_SET, EVENT_ALL_ACCESS))
+        {
+            Load();
+            Adapter->DoChanged();
+        }
+
+        void ExpectOneCreateWaitableSwapChain(uint32_t expectedMaximumFrameLatency)
+        {
+            WaitableSwapChain = Make<StubDxgiSwapChain>();
+
+            WaitableSwapChain->Present1Method.AllowAnyCall();
+            WaitableSwapChain->SetMatrixTransformMethod.AllowAnyCall();
+
+            WaitableSwapChain->GetDesc1Method.AllowAnyCall(
+                [=](DXGI_SWAP_CHAIN_DESC1* desc)
+                {
+                    desc->Width = 1;
+                    desc->Height = 1;
+                    desc->Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+                    desc->BufferCount = 2;
+                    desc->AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
+                    return S_OK;
+                });
+
+            WaitableSwapChain->GetBufferMethod.AllowAnyCall(
+                [=](UINT index, const IID& iid, void** out)
+                {
+                    auto surface = Make<MockDxgiSurface>();
+                    return surface.CopyTo(reinterpret_cast<IDXGISurface2**>(out));
+                });
+
+            // The swap chain takes ownership of the handle it is given.
+            WaitableSwapChain->GetFrameLatencyWaitableObjectMethod.SetExpectedCalls(1,
+                [=]
+                {
+                    HANDLE handle;
+                    Assert::IsTrue(!!DuplicateHandle(GetCurrentProcess(), SignaledEvent.Get(), GetCurrentProcess(), &handle, 0, FALSE, DUPLICATE_SAME_ACCESS));
+                    return handle;
+                });
+
+            WaitableSwapChain->SetMaximumFrameLatencyMethod.SetExpectedCalls(1,
+                [=](UINT maximumFrameLatency)
+                {
+                    Assert::AreEqual(expectedMaximumFrameLatency, maximumFrameLatency);
+                    return S_OK;
+                });
+
+            Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(0);
+
+            Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(1,
+                [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t maximumFrameLatency, bool allowTearing, CanvasSwapChainColorSpace colorSpace)
+                {
+                    Assert::AreEqual(expectedMaximumFrameLatency, maximumFrameLatency);
+                    Assert::IsFalse(allowTearing);
+                    Assert::AreEqual(CanvasSwapChainColorSpace::Srgb, colorSpace);
+
+                    StubCanvasDevice* stubDevice = static_cast<StubCanvasDevice*>(device); // Ensured by test construction
+
+                    stubDevice->CreateSwapChainForCompositionWithFlagsMethod.SetExpectedCalls(1,
+                        [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, UINT flags)
+                        {
+                            Assert::AreEqual(static_cast<UINT>(DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT), flags);
+                            return WaitableSwapChain;
+                        });
+
+                    return CanvasSwapChain::CreateNew(device, width, height, dpi, PIXEL_FORMAT(B8G8R8A8UIntNormalized), 2, alphaMode, maximumFrameLatency, allowTearing);
+                });
+        }
+
+        void EnableFrameLatency()
+        {
+            ExpectOneCreateWaitableSwapChain(2);
+
+            Assert::AreEqual(S_OK, Control->put_MaximumFrameLatency(2));
+            Adapter->Tick();
+            Adapter->DoChanged();
+        }
+    };
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenMaximumFrameLatencyIsSet_SwapChainIsRecreatedAsWaitable)
+    {
+        FrameLatencyFixture f;
+        f.EnableFrameLatency();
+
+        // Later ticks, which wait on the latency object, don't recreate the swap chain.
+        f.Adapter->Tick();
+        f.Adapter->Tick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenMaximumFrameLatencyChanges_SwapChainIsNotRecreated)
+    {
+        FrameLatencyFixture f;
+        f.EnableFrameLatency();
+        f.Adapter->Tick();
+
+        f.Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(0);
+
+        f.WaitableSwapChain->SetMaximumFrameLatencyMethod.SetExpectedCalls(1,
+            [](UINT maximumFrameLatency)
+            {
+                Assert::AreEqual(3u, maximumFrameLatency);
+                return S_OK;
+            });
+
+        Assert::AreEqual(S_OK, f.Control->put_MaximumFrameLatency(3));
+        f.Adapter->Tick();
+        f.Adapter->Tick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenMaximumFrameLatencyIsReset_SwapChainIsRecreatedAsNotWaitable)
+    {
+        FrameLatencyFixture f;
+        f.EnableFrameLatency();
+        f.Adapter->Tick();
+
+        f.Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(0);
+        f.ExpectOneCreateSwapChain();
+
+        Assert::AreEqual(S_OK, f.Control->put_MaximumFrameLatency(0));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_IsTearingAllowed_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsTearingAllowed(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsTearingAllowed(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsTearingAllowed(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsTearingAllowed(&value));
+        Assert::IsTrue(!!value);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_ColorSpace_DefaultsToSrgb)
+    {
+        CanvasAnimatedControlFixture f;
+
+        auto value = CanvasSwapChainColorSpace::ScRgb;
+        Assert::AreEqual(S_OK, f.Control->get_ColorSpace(&value));
+        Assert::AreEqual(CanvasSwapChainColorSpace::Srgb, value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_ColorSpace(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_ColorSpace(static_cast<CanvasSwapChainColorSpace>(3)));
+
+        Assert::AreEqual(S_OK, f.Control->put_ColorSpace(CanvasSwapChainColorSpace::Hdr10));
+        Assert::AreEqual(S_OK, f.Control->get_ColorSpace(&value));
+        Assert::AreEqual(CanvasSwapChainColorSpace::Hdr10, value);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenColorSpaceChanges_SwapChainIsRecreated)
+    {
+        CanvasAnimatedControlFixture f;
+        f.Load();
+        f.Adapter->DoChanged();
+
+        f.Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(0);
+        f.Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(1,
+            [](ICanvasDevice* device, float, float, float, CanvasAlphaMode, uint32_t maximumFrameLatency, bool allowTearing, CanvasSwapChainColorSpace colorSpace)
+            {
+                Assert::AreEqual(0u, maximumFrameLatency);
+                Assert::IsFalse(allowTearing);
+                Assert::AreEqual(CanvasSwapChainColorSpace::ScRgb, colorSpace);
+                return CanvasAnimatedControlFixture::CreateTestSwapChain(device);
+            });
+
+        Assert::AreEqual(S_OK, f.Control->put_ColorSpace(CanvasSwapChainColorSpace::ScRgb));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+
+        // Ticking again with the same color space keeps the swap chain.
+        f.Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(0);
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+
+        f.ExpectOneCreateSwapChain();
+
+        Assert::AreEqual(S_OK, f.Control->put_ColorSpace(CanvasSwapChainColorSpace::Srgb));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_IsFramePacingAdaptive_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsFramePacingAdaptive(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsFramePacingAdaptive(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsFramePacingAdaptive(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsFramePacingAdaptive(&value));
+        Assert::IsTrue(!!value);
+
+        TimeSpan jitter{ 1 };
+        Assert::AreEqual(S_OK, f.Control->get_FrameTimeJitter(&jitter));
+        Assert::AreEqual<INT64>(0, jitter.Duration);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_FrameTimeJitter(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_IsFrameStatisticsEnabled_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsFrameStatisticsEnabled(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsFrameStatisticsEnabled(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsFrameStatisticsEnabled(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsFrameStatisticsEnabled(&value));
+        Assert::IsTrue(!!value);
+
+        CanvasAnimatedFrameStatistics statistics{ 1 };
+        Assert::AreEqual(S_OK, f.Control->GetFrameStatistics(&statistics));
+        Assert::AreEqual(0u, statistics.FrameCount);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->GetFrameStatistics(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_IsResolutionDynamic_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsResolutionDynamic(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsResolutionDynamic(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsResolutionDynamic(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsResolutionDynamic(&value));
+        Assert::IsTrue(!!value);
+
+        float scale = 0;
+        Assert::AreEqual(S_OK, f.Control->get_ResolutionScale(&scale));
+        Assert::AreEqual(1.0f, scale);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_ResolutionScale(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_MinimumResolutionScale)
+    {
+        CanvasAnimatedControlFixture f;
+
+        float value = 0;
+        Assert::AreEqual(S_OK, f.Control->get_MinimumResolutionScale(&value));
+        Assert::AreEqual(0.5f, value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_MinimumResolutionScale(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_MinimumResolutionScale(1.0f));
+        Assert::AreEqual(S_OK, f.Control->put_MinimumResolutionScale(0.25f));
+        Assert::AreEqual(S_OK, f.Control->get_MinimumResolutionScale(&value));
+        Assert::AreEqual(0.25f, value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_MinimumResolutionScale(0.0f));
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_MinimumResolutionScale(1.5f));
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_MinimumResolutionScale(NAN));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::MinimumResolutionScaleOutOfRange);
+    }
+
+#if WINVER > _WIN32_WINNT_WINBLUE
+
+    class TearingFixture : public CanvasAnimatedControlFixture
+    {
+    public:
+        ComPtr<StubDxgiSwapChain> TearingSwapChain;
+
+        TearingFixture()
+        {
+            Load();
+            Adapter->DoChanged();
+        }
+
+        void ExpectOneCreateTearingSwapChain(bool isTearingSupported)
+        {
+            TearingSwapChain = Make<StubDxgiSwapChain>();
+
+            TearingSwapChain->GetDesc1Method.AllowAnyCall(
+                [=](DXGI_SWAP_CHAIN_DESC1* desc)
+                {
+                    desc->Width = 1;
+                    desc->Height = 1;
+                    desc->Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+                    desc->BufferCount = 2;
+                    desc->AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
+                    return S_OK;
+                });
+
+            Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(0);
+
+            Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(1,
+                [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t maximumFrameLatency, bool allowTearing, CanvasSwapChainColorSpace colorSpace)
+                {
+                    Assert::AreEqual(0u, maximumFrameLatency);
+                    Assert::IsTrue(allowTearing);
+                    Assert::AreEqual(CanvasSwapChainColorSpace::Srgb, colorSpace);
+
+                    StubCanvasDevice* stubDevice = static_cast<StubCanvasDevice*>(device); // Ensured by test construction
+
+                    stubDevice->IsTearingSupportedMethod.AllowAnyCall([=] { return isTearingSupported; });
+
+                    stubDevice->CreateSwapChainForCompositionWithFlagsMethod.SetExpectedCalls(1,
+                        [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, UINT flags)
+                        {
+                            UINT expectedFlags = isTearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+                            Assert::AreEqual(expectedFlags, flags);
+                            return TearingSwapChain;
+                        });
+
+                    return CanvasSwapChain::CreateNew(device, width, height, dpi, PIXEL_FORMAT(B8G8R8A8UIntNormalized), 2, alphaMode, maximumFrameLatency, allowTearing);
+                });
+        }
+
+        void AllowTearing(bool isTearingSupported)
+        {
+            ExpectOneCreateTearingSwapChain(isTearingSupported);
+
+            Assert::AreEqual(S_OK, Control->put_IsTearingAllowed(TRUE));
+            Adapter->Tick();
+            Adapter->DoChanged();
+        }
+
+        void ExpectPresent(UINT expectedSyncInterval, UINT expectedFlags)
+        {
+            TearingSwapChain->Present1Method.SetExpectedCalls(1,
+                [=](UINT syncInterval, UINT flags, const DXGI_PRESENT_PARAMETERS*)
+                {
+                    Assert::AreEqual(expectedSyncInterval, syncInterval);
+                    Assert::AreEqual(expectedFlags, flags);
+                    return S_OK;
+                });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenTearingIsAllowedAndSupported_PresentsAllowingTearing)
+    {
+        TearingFixture f;
+        f.AllowTearing(true);
+
+        f.ExpectPresent(0, DXGI_PRESENT_ALLOW_TEARING);
+        f.Adapter->Tick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenTearingIsAllowedButNotSupported_PresentsNormally)
+    {
+        TearingFixture f;
+        f.AllowTearing(false);
+
+        // The swap chain isn't recreated just because it doesn't allow tearing.
+        f.ExpectPresent(1, 0);
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenTearingIsDisallowed_SwapChainIsRecreated)
+    {
+        TearingFixture f;
+        f.AllowTearing(true);
+
+        f.Adapter->CreateCanvasSwapChainWithOptionsMethod.SetExpectedCalls(0);
+        f.ExpectOneCreateSwapChain();
+
+        Assert::AreEqual(S_OK, f.Control->put_IsTearingAllowed(FALSE));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+    }
+
+#endif
+
     TEST_METHOD_EX(CanvasAnimatedControl_RecreatedSwapChainHasCorrectAlphaMode)
     {
         CanvasAnimatedControlFixture f;
@@ -416,6 +819,9 @@ TEST_CLASS(CanvasAnimatedControlTests)
 
         VERIFY_THREADING_RESTRICTION(S_OK, f.Control->put_ClearColor(color));
         VERIFY_THREADING_RESTRICTION(S_OK, f.Control->get_ClearColor(&color));
+
+        VERIFY_THREADING_RESTRICTION(RPC_E_WRONG_THREAD, f.Control->put_UseSharedGameLoop(b));
+        VERIFY_THREADING_RESTRICTION(RPC_E_WRONG_THREAD, f.Control->get_UseSharedGameLoop(&b));
     }
 
     class ResizeFixture : public FixtureWithSwapChainAccess
@@ -445,6 +851,17 @@ TEST_CLASS(CanvasAnimatedControlTests)
                     });
         }
 
+        void ExpectOneSetSourceSize(Size size)
+        {
+            m_dxgiSwapChain->SetSourceSizeMethod.SetExpectedCalls(1,
+                [=](UINT width, UINT height)
+                {
+                    Assert::AreEqual(static_cast<UINT>(size.Width), width);
+                    Assert::AreEqual(static_cast<UINT>(size.Height), height);
+                    return S_OK;
+                });
+        }
+
         static const int TickCountForExecute = 5;
 
         void Execute(Size size)
@@ -479,6 +896,43 @@ TEST_CLASS(CanvasAnimatedControlTests)
         }
     }
 
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenSwapChainOverallocationIsAllowed_ResizeOverallocatesAndSetsSourceSize)
+    {
+        ResizeFixture f;
+
+        Assert::AreEqual(S_OK, f.Control->put_IsSwapChainOverallocationAllowed(TRUE));
+
+        f.Device->get_MaximumBitmapSizeInPixelsMethod.AllowAnyCall(
+            [](int32_t* value)
+            {
+                *value = 4096;
+                return S_OK;
+            });
+
+        Size size{ 120, 240 };
+
+        f.ExpectOneResizeBuffers(Size{ 150, 300 });
+
+        f.ExpectOneSetSourceSize(size);
+
+        f.Execute(size);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_IsSwapChainOverallocationAllowed_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsSwapChainOverallocationAllowed(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsSwapChainOverallocationAllowed(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsSwapChainOverallocationAllowed(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsSwapChainOverallocationAllowed(&value));
+        Assert::IsTrue(!!value);
+    }
+
     TEST_METHOD_EX(CanvasAnimatedControl_WhenControlIsResizedToCurrentSize_ThenResizeBuffersIsNotCalled)
     {
         ResizeFixture f;
@@ -569,6 +1023,40 @@ TEST_CLASS(CanvasAnimatedControlTests)
         }
     }
 
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenControlIsResizedToZero_AndFramePacingIsAdaptive_WaitsUntilTheNextUpdateIsDue)
+    {
+        ResizeFixture f;
+        ThrowIfFailed(f.Control->put_IsFramePacingAdaptive(TRUE));
+
+        f.UserControl->Resize(Size{ 0, 0 });
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+
+        MockEventHandler<Animated_UpdateEventHandler> onUpdate(L"OnUpdate");
+        f.AddUpdateHandler(onUpdate.Get());
+        onUpdate.ExpectAtLeastOneCall();
+
+        f.Adapter->m_sleepFn =
+            [&](DWORD)
+            {
+                Assert::Fail(L"Unexpected");
+            };
+
+        int waitCount = 0;
+        f.Adapter->m_waitUntilFn =
+            [&](int64_t performanceCounter)
+            {
+                Assert::IsTrue(performanceCounter > f.Adapter->GetPerformanceCounter());
+                Assert::IsTrue(performanceCounter <= f.Adapter->GetPerformanceCounter() + static_cast<int64_t>(TicksPerFrame));
+                waitCount++;
+            };
+
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.Execute(Size{ 0, 0 });
+
+        Assert::AreEqual(ResizeFixture::TickCountForExecute, waitCount);
+    }
+
     TEST_METHOD_EX(CanvasAnimatedControl_SeesConsistentSizeInUpdateRenderHandlers)
     {
         ResizeFixture f;
@@ -1180,6 +1668,159 @@ TEST_CLASS(CanvasAnimatedControlTests)
         }
     };
 
+    TEST_METHOD_EX(CanvasAnimatedControl_IsUpdatePipelined_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsUpdatePipelined(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsUpdatePipelined(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsUpdatePipelined(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsUpdatePipelined(&value));
+        Assert::IsTrue(!!value);
+    }
+
+    struct UpdateStateFixture : public UpdateRenderFixture
+    {
+        std::vector<ComPtr<IInspectable>> States;
+        std::vector<ComPtr<IInspectable>> DrawnStates;
+        std::vector<ComPtr<IInspectable>> PreviousStates;
+
+        UpdateStateFixture()
+        {
+            ThrowIfFailed(Control->put_IsFixedTimeStep(FALSE));
+
+            OnCreateResources.AllowAnyCall();
+
+            // Each update hands a new state object on to its draw.  Any
+            // inspectable object will do.
+            OnUpdate.AllowAnyCall(
+                [=] (ICanvasAnimatedControl*, ICanvasAnimatedUpdateEventArgs* args)
+                {
+                    ComPtr<IInspectable> previousState;
+                    ThrowIfFailed(args->get_State(&previousState));
+                    PreviousStates.push_back(previousState);
+
+                    auto state = Make<CanvasAnimatedUpdateEventArgs>(CanvasTimingInformation{});
+                    States.push_back(As<IInspectable>(state));
+                    return args->put_State(state.Get());
+                });
+
+            OnDraw.AllowAnyCall(
+                [=] (ICanvasAnimatedControl*, ICanvasAnimatedDrawEventArgs* args)
+                {
+                    ComPtr<IInspectable> state;
+                    ThrowIfFailed(args->get_State(&state));
+                    DrawnStates.push_back(state);
+                    return S_OK;
+                });
+
+            Load();
+            Adapter->DoChanged();
+        }
+
+        void TickFrames(int count)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                Adapter->ProgressTime(TicksPerFrame);
+                Adapter->Tick();
+            }
+        }
+    };
+
+    TEST_METHOD_EX(CanvasAnimatedControl_DrawSeesStateSetByUpdate)
+    {
+        UpdateStateFixture f;
+
+        f.TickFrames(3);
+
+        Assert::AreEqual<size_t>(3, f.States.size());
+        Assert::AreEqual<size_t>(3, f.DrawnStates.size());
+
+        for (size_t i = 0; i < 3; i++)
+        {
+            Assert::IsTrue(IsSameInstance(f.States[i].Get(), f.DrawnStates[i].Get()));
+        }
+
+        // Each update starts out with the previous update's state.
+        Assert::IsNull(f.PreviousStates[0].Get());
+        Assert::IsTrue(IsSameInstance(f.States[0].Get(), f.PreviousStates[1].Get()));
+        Assert::IsTrue(IsSameInstance(f.States[1].Get(), f.PreviousStates[2].Get()));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenUpdateIsPipelined_DrawShowsThePreviousUpdate)
+    {
+        UpdateStateFixture f;
+        ThrowIfFailed(f.Control->put_IsUpdatePipelined(TRUE));
+
+        // The first tick only updates, since there's nothing to draw yet.
+        f.TickFrames(1);
+
+        Assert::AreEqual<size_t>(1, f.States.size());
+        Assert::AreEqual<size_t>(0, f.DrawnStates.size());
+
+        // After that each tick draws the update from the tick before it.
+        f.TickFrames(3);
+
+        Assert::AreEqual<size_t>(4, f.States.size());
+        Assert::AreEqual<size_t>(3, f.DrawnStates.size());
+
+        for (size_t i = 0; i < 3; i++)
+        {
+            Assert::IsTrue(IsSameInstance(f.States[i].Get(), f.DrawnStates[i].Get()));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenUpdateIsPipelined_DrawTimingMatchesTheUpdateBeingDrawn)
+    {
+        UpdateRenderFixture f;
+        ThrowIfFailed(f.Control->put_IsFixedTimeStep(FALSE));
+        ThrowIfFailed(f.Control->put_IsUpdatePipelined(TRUE));
+
+        f.OnCreateResources.AllowAnyCall();
+        f.OnUpdate.AllowAnyCall();
+
+        f.Load();
+        f.Adapter->DoChanged();
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.Adapter->Tick();
+
+        f.OnDraw.SetExpectedCalls(1,
+            [] (ICanvasAnimatedControl*, ICanvasAnimatedDrawEventArgs* args)
+            {
+                CanvasTimingInformation timingInformation;
+                ThrowIfFailed(args->get_Timing(&timingInformation));
+                Assert::AreEqual(1LL, timingInformation.UpdateCount);
+                return S_OK;
+            });
+
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.Adapter->Tick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenPipelinedUpdateFails_ErrorPropagates)
+    {
+        UpdateRenderFixture f;
+        ThrowIfFailed(f.Control->put_IsFixedTimeStep(FALSE));
+        ThrowIfFailed(f.Control->put_IsUpdatePipelined(TRUE));
+
+        f.OnCreateResources.AllowAnyCall();
+        f.OnDraw.AllowAnyCall();
+        f.OnUpdate.SetExpectedCalls(1, [] (ICanvasAnimatedControl*, ICanvasAnimatedUpdateEventArgs*) { return E_FAIL; });
+
+        f.Load();
+        f.Adapter->DoChanged();
+
+        // The update's error is rethrown on the game loop thread, and so
+        // reported to the UI thread like any other.
+        f.Adapter->Tick();
+        ExpectHResultException(E_FAIL, [&] { f.Adapter->DoChanged(); });
+    }
+
     TEST_METHOD_EX(CanvasAnimatedControl_FirstRenderFrameAlwaysIssuesSingleUpdateAndDraw)
     {
         CheckFirstRender(TRUE);
@@ -1906,93 +2547,359 @@ TEST_CLASS(CanvasAnimatedControlTests)
                 return mockDxgiOutput;
             });
 
-        mockDxgiOutput->WaitForVBlankMethod.SetExpectedCalls(1);
+        mockDxgiOutput->WaitForVBlankMethod.SetExpectedCalls(1);
+
+        f.Adapter->Tick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_VariableTimeStep_AlwaysWaitsForVBlank)
+    {
+        CanvasAnimatedControlFixture f;
+        f.Load();
+        f.Adapter->DoChanged();
+        ThrowIfFailed(f.Control->put_IsFixedTimeStep(false));
+
+        auto mockDxgiOutput = Make<MockDxgiOutput>();
+
+        f.Device->GetPrimaryDisplayOutputMethod.SetExpectedCalls(2,
+            [&]
+            {
+                return mockDxgiOutput;
+            });
+
+        mockDxgiOutput->WaitForVBlankMethod.SetExpectedCalls(2);
+
+        f.Adapter->Tick();
+        f.Adapter->Tick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_When_InvalidateCalled_AnyNumberOfTimes_WhileNotPaused_ThenSingleDrawCalled)
+    {
+        UpdateRenderFixture f;        
+        f.GetIntoSteadyState();
+        ThrowIfFailed(f.Control->put_Paused(FALSE));
+
+        // Now, we don't progress time, so we don't expect any more updates.  We
+        // call Invalidate many times, but only get a single Draw as a result.
+        f.OnDraw.SetExpectedCalls(1);
+
+        for (int i = 0; i < 20; ++i)
+            ThrowIfFailed(f.Control->Invalidate());
+
+        for (int i = 0; i < 20; ++i)
+        {
+            f.Adapter->DoChanged();
+            f.Adapter->Tick();
+        }
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_When_InvalidateCalled_AnyNumberOfTimes_WhileNotPaused_AndTimeProgresses_ThenSingleUpdateAndDrawCalled)
+    {
+        UpdateRenderFixture f;        
+        f.GetIntoSteadyState();
+        ThrowIfFailed(f.Control->put_Paused(FALSE));
+
+        // When time progresses and we call Invalidate() we still only see a
+        // single Draw.
+        f.OnUpdate.SetExpectedCalls(1);
+        f.OnDraw.SetExpectedCalls(1);
+
+        for (int i = 0; i < 20; ++i)
+            ThrowIfFailed(f.Control->Invalidate());
+
+        f.Adapter->ProgressTime(TicksPerFrame);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            f.Adapter->DoChanged();
+            f.Adapter->Tick();
+        }
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_When_InvalidateCalled_AnyNumberOfTimes_WhilePaused_ThenOnlySingleDrawIsCalled)
+    {
+        UpdateRenderFixture f;        
+        f.GetIntoSteadyState();
+        ThrowIfFailed(f.Control->put_Paused(TRUE));
+
+        f.OnUpdate.SetExpectedCalls(0);
+        f.OnDraw.SetExpectedCalls(1);
+
+        for (int i = 0; i < 20; ++i)
+            ThrowIfFailed(f.Control->Invalidate());
+
+        for (int i = 0; i < 20; ++i)
+        {
+            f.Adapter->ProgressTime(TicksPerFrame);
+            f.Adapter->DoChanged();
+            f.Adapter->Tick();
+        }
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_IsUpdateOnDemand_DefaultsToFalse)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean value = TRUE;
+        Assert::AreEqual(S_OK, f.Control->get_IsUpdateOnDemand(&value));
+        Assert::IsFalse(!!value);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_IsUpdateOnDemand(nullptr));
+
+        Assert::AreEqual(S_OK, f.Control->put_IsUpdateOnDemand(TRUE));
+        Assert::AreEqual(S_OK, f.Control->get_IsUpdateOnDemand(&value));
+        Assert::IsTrue(!!value);
+    }
+
+    struct OnDemandFixture : public UpdateRenderFixture
+    {
+        OnDemandFixture()
+        {
+            ThrowIfFailed(Control->put_IsUpdateOnDemand(TRUE));
+
+            // The first update happens without being requested.
+            GetIntoSteadyState();
+        }
+
+        void DoChangedAndTick()
+        {
+            Adapter->DoChanged();
+            Adapter->Tick();
+        }
+    };
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenUpdateIsOnDemand_GameLoopStopsUntilAnUpdateIsRequested)
+    {
+        OnDemandFixture f;
+
+        f.Adapter->DoChanged();
+        Assert::IsFalse(f.Adapter->GameThreadHasPendingWork());
+
+        for (int i = 0; i < 5; ++i)
+        {
+            f.Adapter->ProgressTime(TicksPerFrame);
+            f.DoChangedAndTick();
+            Assert::IsFalse(f.Adapter->GameThreadHasPendingWork());
+        }
+
+        Expectations::Instance()->Validate();
+
+        // The time spent idle isn't caught up on, so a requested update runs
+        // straight away and only once.
+        ThrowIfFailed(f.Control->RequestUpdate());
+        ThrowIfFailed(f.Control->RequestUpdate());
+
+        f.OnUpdate.SetExpectedCalls(1);
+        f.OnDraw.SetExpectedCalls(1);
+        f.DoChangedAndTick();
+
+        f.Adapter->DoChanged();
+        Assert::IsFalse(f.Adapter->GameThreadHasPendingWork());
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenUpdateIsOnDemand_AndUpdateHandlerRequestsAnUpdate_GameLoopKeepsRunning)
+    {
+        OnDemandFixture f;
+
+        ThrowIfFailed(f.Control->RequestUpdate());
+
+        f.OnUpdate.SetExpectedCalls(3,
+            [&] (ICanvasAnimatedControl*, ICanvasAnimatedUpdateEventArgs*)
+            {
+                return f.Control->RequestUpdate();
+            });
+        f.OnDraw.SetExpectedCalls(3);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            f.DoChangedAndTick();
+            Assert::IsTrue(f.Adapter->GameThreadHasPendingWork());
+            f.Adapter->ProgressTime(TicksPerFrame);
+        }
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenUpdateIsOnDemand_InvalidateDrawsWithoutAnUpdate)
+    {
+        OnDemandFixture f;
+
+        f.OnUpdate.SetExpectedCalls(0);
+        f.OnDraw.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.Control->Invalidate());
+
+        for (int i = 0; i < 5; ++i)
+        {
+            f.Adapter->ProgressTime(TicksPerFrame);
+            f.DoChangedAndTick();
+        }
+
+        Assert::IsFalse(f.Adapter->GameThreadHasPendingWork());
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenUpdateIsNoLongerOnDemand_GameLoopRestarts)
+    {
+        OnDemandFixture f;
+
+        f.Adapter->DoChanged();
+        Assert::IsFalse(f.Adapter->GameThreadHasPendingWork());
+
+        ThrowIfFailed(f.Control->put_IsUpdateOnDemand(FALSE));
 
-        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+        Assert::IsTrue(f.Adapter->GameThreadHasPendingWork());
     }
 
-    TEST_METHOD_EX(CanvasAnimatedControl_VariableTimeStep_AlwaysWaitsForVBlank)
+    class OcclusionFixture : public FixtureWithSwapChainAccess
     {
-        CanvasAnimatedControlFixture f;
-        f.Load();
-        f.Adapter->DoChanged();
-        ThrowIfFailed(f.Control->put_IsFixedTimeStep(false));
+    public:
+        MockEventHandler<Animated_DrawEventHandler> OnDraw;
 
-        auto mockDxgiOutput = Make<MockDxgiOutput>();
+        OcclusionFixture()
+            : OnDraw(L"OnDraw")
+        {
+            AddDrawHandler(OnDraw.Get());
 
-        f.Device->GetPrimaryDisplayOutputMethod.SetExpectedCalls(2,
-            [&]
-            {
-                return mockDxgiOutput;
-            });
+            Load();
+            Adapter->DoChanged();
+        }
 
-        mockDxgiOutput->WaitForVBlankMethod.SetExpectedCalls(2);
+        void ExpectPresents(std::vector<UINT> expectedFlags, HRESULT hr)
+        {
+            auto index = std::make_shared<size_t>(0);
 
-        f.Adapter->Tick();
-        f.Adapter->Tick();
-    }
+            m_dxgiSwapChain->Present1Method.SetExpectedCalls(static_cast<int>(expectedFlags.size()),
+                [=](UINT, UINT presentFlags, const DXGI_PRESENT_PARAMETERS*)
+                {
+                    Assert::AreEqual(expectedFlags[(*index)++], presentFlags);
+                    return hr;
+                });
+        }
+    };
 
-    TEST_METHOD_EX(CanvasAnimatedControl_When_InvalidateCalled_AnyNumberOfTimes_WhileNotPaused_ThenSingleDrawCalled)
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenPresentReportsOcclusion_DrawingStopsUntilTheSwapChainCanBeSeen)
     {
-        UpdateRenderFixture f;        
-        f.GetIntoSteadyState();
-        ThrowIfFailed(f.Control->put_Paused(FALSE));
+        OcclusionFixture f;
 
-        // Now, we don't progress time, so we don't expect any more updates.  We
-        // call Invalidate many times, but only get a single Draw as a result.
         f.OnDraw.SetExpectedCalls(1);
+        f.ExpectPresents({ 0 }, DXGI_STATUS_OCCLUDED);
+        f.Adapter->Tick();
 
-        for (int i = 0; i < 20; ++i)
-            ThrowIfFailed(f.Control->Invalidate());
+        Expectations::Instance()->Validate();
 
-        for (int i = 0; i < 20; ++i)
+        // Updates carry on, but each tick only makes a test present.
+        for (int i = 0; i < 3; ++i)
         {
-            f.Adapter->DoChanged();
+            f.OnDraw.SetExpectedCalls(0);
+            f.ExpectPresents({ DXGI_PRESENT_TEST }, DXGI_STATUS_OCCLUDED);
+
+            f.Adapter->ProgressTime(TicksPerFrame);
             f.Adapter->Tick();
+
+            Expectations::Instance()->Validate();
         }
+
+        // Once the swap chain can be seen again a frame is drawn straight
+        // away, even without an update.
+        f.OnDraw.SetExpectedCalls(1);
+        f.ExpectPresents({ DXGI_PRESENT_TEST, 0 }, S_OK);
+        f.Adapter->Tick();
     }
 
-    TEST_METHOD_EX(CanvasAnimatedControl_When_InvalidateCalled_AnyNumberOfTimes_WhileNotPaused_AndTimeProgresses_ThenSingleUpdateAndDrawCalled)
+    class DirtyRectsFixture : public FixtureWithSwapChainAccess
     {
-        UpdateRenderFixture f;        
-        f.GetIntoSteadyState();
-        ThrowIfFailed(f.Control->put_Paused(FALSE));
+    public:
+        DirtyRectsFixture()
+        {
+            m_dxgiSwapChain->GetDesc1Method.AllowAnyCall(
+                [=](DXGI_SWAP_CHAIN_DESC1* desc)
+                {
+                    desc->Width = 100;
+                    desc->Height = 100;
+                    desc->Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+                    desc->BufferCount = 2;
+                    desc->AlphaMode = DXGI_ALPHA_MODE_IGNORE;
+                    return S_OK;
+                });
 
-        // When time progresses and we call Invalidate() we still only see a
-        // single Draw.
-        f.OnUpdate.SetExpectedCalls(1);
-        f.OnDraw.SetExpectedCalls(1);
+            ThrowIfFailed(Control->put_Paused(TRUE));
 
-        for (int i = 0; i < 20; ++i)
-            ThrowIfFailed(f.Control->Invalidate());
+            Load();
+            Adapter->DoChanged();
 
-        f.Adapter->ProgressTime(TicksPerFrame);
+            // The first frame is always presented whole.
+            Adapter->Tick();
+        }
 
-        for (int i = 0; i < 20; ++i)
+        void ExpectPresent(std::vector<RECT> expectedDirtyRects)
         {
-            f.Adapter->DoChanged();
-            f.Adapter->Tick();
+            m_dxgiSwapChain->Present1Method.SetExpectedCalls(1,
+                [=](UINT, UINT, const DXGI_PRESENT_PARAMETERS* presentParameters)
+                {
+                    Assert::AreEqual(static_cast<UINT>(expectedDirtyRects.size()), presentParameters->DirtyRectsCount);
+
+                    for (size_t i = 0; i < expectedDirtyRects.size(); i++)
+                    {
+                        Assert::AreEqual(expectedDirtyRects[i], presentParameters->pDirtyRects[i]);
+                    }
+
+                    return S_OK;
+                });
+        }
+
+        void DoChangedAndTick()
+        {
+            Adapter->DoChanged();
+            Adapter->Tick();
         }
+    };
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenInvalidateRectIsCalled_NextFrameIsPresentedWithDirtyRects)
+    {
+        DirtyRectsFixture f;
+
+        ThrowIfFailed(f.Control->InvalidateRect(Rect{ 1, 2, 3, 4 }));
+        ThrowIfFailed(f.Control->InvalidateRect(Rect{ 10, 10, 1, 1 }));
+
+        f.ExpectPresent({ RECT{ 1, 2, 4, 6 }, RECT{ 10, 10, 11, 11 } });
+        f.DoChangedAndTick();
+
+        // The rects only apply to the one frame.
+        ThrowIfFailed(f.Control->InvalidateRect(Rect{ 5, 5, 1, 1 }));
+
+        f.ExpectPresent({ RECT{ 5, 5, 6, 6 } });
+        f.DoChangedAndTick();
     }
 
-    TEST_METHOD_EX(CanvasAnimatedControl_When_InvalidateCalled_AnyNumberOfTimes_WhilePaused_ThenOnlySingleDrawIsCalled)
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenInvalidateIsAlsoCalled_NextFrameIsPresentedWhole)
     {
-        UpdateRenderFixture f;        
-        f.GetIntoSteadyState();
-        ThrowIfFailed(f.Control->put_Paused(TRUE));
+        DirtyRectsFixture f;
 
-        f.OnUpdate.SetExpectedCalls(0);
-        f.OnDraw.SetExpectedCalls(1);
+        ThrowIfFailed(f.Control->InvalidateRect(Rect{ 1, 2, 3, 4 }));
+        ThrowIfFailed(f.Control->Invalidate());
 
-        for (int i = 0; i < 20; ++i)
-            ThrowIfFailed(f.Control->Invalidate());
+        f.ExpectPresent({});
+        f.DoChangedAndTick();
+    }
 
-        for (int i = 0; i < 20; ++i)
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenInvalidateRectIsCalledTooOften_NextFrameIsPresentedWhole)
+    {
+        DirtyRectsFixture f;
+
+        for (size_t i = 0; i <= CanvasAnimatedControl::MaximumDirtyRectCount; i++)
         {
-            f.Adapter->ProgressTime(TicksPerFrame);
-            f.Adapter->DoChanged();
-            f.Adapter->Tick();
+            ThrowIfFailed(f.Control->InvalidateRect(Rect{ 1, 1, 1, 1 }));
         }
+
+        f.ExpectPresent({});
+        f.DoChangedAndTick();
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_InvalidateRect_RejectsNegativeSizes)
+    {
+        CanvasAnimatedControlFixture f;
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->InvalidateRect(Rect{ 0, 0, -1, 1 }));
+        Assert::AreEqual(E_INVALIDARG, f.Control->InvalidateRect(Rect{ 0, 0, 1, -1 }));
     }
 
     TEST_METHOD_EX(CanvasAnimatedControl_When_ControlStartsPaused_AndInvalidateIsCalled_ThenDrawIsCalledBeforeFirstUpdate)
@@ -2218,6 +3125,59 @@ TEST_CLASS(CanvasAnimatedControlChangedAction)
         Assert::AreEqual(S_OK, f.Control->get_UseSharedDevice(&useSharedDevice));
         Assert::IsFalse(!!useSharedDevice);
     }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_UseSharedGameLoop_Default_False)
+    {
+        CanvasAnimatedControlFixture f;
+
+        boolean useSharedGameLoop;
+        Assert::AreEqual(S_OK, f.Control->get_UseSharedGameLoop(&useSharedGameLoop));
+        Assert::IsFalse(!!useSharedGameLoop);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_UseSharedGameLoop_IsPassedToAdapterOnLoad)
+    {
+        CanvasAnimatedControlFixture f;
+
+        ThrowIfFailed(f.Control->put_UseSharedGameLoop(TRUE));
+
+        boolean useSharedGameLoop;
+        ThrowIfFailed(f.Control->get_UseSharedGameLoop(&useSharedGameLoop));
+        Assert::IsTrue(!!useSharedGameLoop);
+
+        f.Load();
+
+        Assert::IsTrue(f.Adapter->LastUseSharedThread);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenGameThreadDefersFrameWait_TickDoesNotWait)
+    {
+        CanvasAnimatedControlFixture f;
+        f.Load();
+        f.Adapter->DoChanged();
+
+        f.Adapter->GetGameThread()->DeferFrameWaits = true;
+
+        // The first tick presents; the second has nothing to do and so would
+        // normally wait for a vblank itself.
+        f.Adapter->Tick();
+        f.Adapter->Tick();
+
+        auto& deferredWait = f.Adapter->GetGameThread()->DeferredFrameWait;
+        Assert::IsTrue(static_cast<bool>(deferredWait));
+
+        auto mockDxgiOutput = Make<MockDxgiOutput>();
+
+        f.Device->GetPrimaryDisplayOutputMethod.SetExpectedCalls(1,
+            [&]
+            {
+                return mockDxgiOutput;
+            });
+
+        mockDxgiOutput->WaitForVBlankMethod.SetExpectedCalls(1);
+
+        deferredWait();
+    }
 };
 
 TEST_CLASS(CanvasAnimatedControlRenderLoop)
@@ -3366,6 +4326,245 @@ TEST_CLASS(CanvasAnimatedControl_AppAccessingWorkerThreadTests)
     }
 };
 
+class StubTimingAdapter : public ICanvasTimingAdapter
+{
+public:
+    int64_t Time = 0;
+
+    virtual int64_t GetPerformanceCounter() override { return Time; }
+    virtual int64_t GetPerformanceFrequency() override { return StepTimer::TicksPerSecond; }
+};
+
+TEST_CLASS(StepTimer_AdaptivePacing)
+{
+    static int64_t const RefreshPeriod144Hz = StepTimer::TicksPerSecond / 144;
+
+    static void AddSyncs(StepTimer& timer, int64_t refreshPeriod, int count)
+    {
+        for (int i = 1; i <= count; i++)
+            timer.AddDisplaySync(1000 + i * refreshPeriod, i);
+    }
+
+    TEST_METHOD_EX(StepTimer_AddDisplaySync_MeasuresTheRefreshPeriod)
+    {
+        auto adapter = std::make_shared<StubTimingAdapter>();
+        StepTimer timer(adapter);
+
+        Assert::AreEqual<int64_t>(0, timer.GetRefreshPeriod());
+
+        timer.AddDisplaySync(1000, 1);
+        Assert::AreEqual<int64_t>(0, timer.GetRefreshPeriod());
+
+        // Two refreshes passed between these syncs.
+        timer.AddDisplaySync(1000 + 2 * RefreshPeriod144Hz, 3);
+        Assert::AreEqual(RefreshPeriod144Hz, timer.GetRefreshPeriod());
+
+        // Repeated syncs are ignored.
+        timer.AddDisplaySync(5000000, 3);
+        Assert::AreEqual(RefreshPeriod144Hz, timer.GetRefreshPeriod());
+    }
+
+    TEST_METHOD_EX(StepTimer_WithAdaptivePacing_NoisyTimeDeltasAreSnappedToTheRefreshPeriod)
+    {
+        auto adapter = std::make_shared<StubTimingAdapter>();
+        StepTimer timer(adapter);
+        timer.SetFixedTimeStep(false);
+        timer.SetAdaptivePacing(true);
+        AddSyncs(timer, RefreshPeriod144Hz, 2);
+
+        int64_t noise[] = { 30, -30, 20, -20 };
+
+        for (auto n : noise)
+        {
+            adapter->Time += RefreshPeriod144Hz + n;
+            timer.Tick(false, 0, [](bool) {});
+
+            Assert::AreEqual(static_cast<uint64_t>(RefreshPeriod144Hz), timer.GetElapsedTicks());
+        }
+
+        Assert::IsTrue(timer.GetFrameTimeJitterTicks() > 0);
+    }
+
+    TEST_METHOD_EX(StepTimer_WithAdaptivePacing_TotalTimeDoesNotDriftFromRealTime)
+    {
+        auto adapter = std::make_shared<StubTimingAdapter>();
+        StepTimer timer(adapter);
+        timer.SetFixedTimeStep(false);
+        timer.SetAdaptivePacing(true);
+        AddSyncs(timer, RefreshPeriod144Hz, 2);
+
+        // Every frame runs slightly long, which on its own would be snapped
+        // away entirely.
+        for (int i = 0; i < 1000; i++)
+        {
+            adapter->Time += RefreshPeriod144Hz + 100;
+            timer.Tick(false, 0, [](bool) {});
+        }
+
+        auto drift = static_cast<int64_t>(timer.GetTotalTicks()) - adapter->Time;
+        Assert::IsTrue(llabs(drift) <= RefreshPeriod144Hz / 2);
+    }
+
+    TEST_METHOD_EX(StepTimer_WithoutAdaptivePacing_TimeDeltasAreNotChanged)
+    {
+        auto adapter = std::make_shared<StubTimingAdapter>();
+        StepTimer timer(adapter);
+        timer.SetFixedTimeStep(false);
+        AddSyncs(timer, RefreshPeriod144Hz, 2);
+
+        adapter->Time += RefreshPeriod144Hz + 30;
+        timer.Tick(false, 0, [](bool) {});
+
+        Assert::AreEqual(static_cast<uint64_t>(RefreshPeriod144Hz + 30), timer.GetElapsedTicks());
+    }
+};
+
+TEST_CLASS(FrameStatisticsTrackerTests)
+{
+    TEST_METHOD_EX(FrameStatisticsTracker_AveragesTheMostRecentFrames)
+    {
+        FrameStatisticsTracker tracker;
+
+        auto empty = tracker.GetStatistics();
+        Assert::AreEqual(0u, empty.FrameCount);
+        Assert::AreEqual<INT64>(0, empty.AverageDrawTime.Duration);
+
+        tracker.AddFrame(FrameTimings{ 10, 20, 30, 1 });
+        tracker.AddFrame(FrameTimings{ 30, 40, 50, 0 });
+
+        auto statistics = tracker.GetStatistics();
+        Assert::AreEqual(2u, statistics.FrameCount);
+        Assert::AreEqual<INT64>(20, statistics.AverageUpdateTime.Duration);
+        Assert::AreEqual<INT64>(30, statistics.AverageDrawTime.Duration);
+        Assert::AreEqual<INT64>(40, statistics.AveragePresentTime.Duration);
+        Assert::AreEqual(1u, statistics.MissedVerticalBlankCount);
+
+        // Once the window is full the oldest frames drop out.
+        for (uint32_t i = 0; i < FrameStatisticsTracker::SampleCount; i++)
+            tracker.AddFrame(FrameTimings{ 100, 100, 100, 0 });
+
+        statistics = tracker.GetStatistics();
+        Assert::AreEqual(static_cast<uint32_t>(FrameStatisticsTracker::SampleCount), statistics.FrameCount);
+        Assert::AreEqual<INT64>(100, statistics.AverageUpdateTime.Duration);
+        Assert::AreEqual(0u, statistics.MissedVerticalBlankCount);
+    }
+
+    TEST_METHOD_EX(FrameStatisticsTracker_GpuTimesAreAveragedSeparately)
+    {
+        FrameStatisticsTracker tracker;
+
+        tracker.AddFrame(FrameTimings{});
+        tracker.AddGpuTime(50);
+        tracker.AddGpuTime(150);
+
+        Assert::AreEqual<INT64>(100, tracker.GetStatistics().AverageGpuTime.Duration);
+
+        tracker.Reset();
+        Assert::AreEqual<INT64>(0, tracker.GetStatistics().AverageGpuTime.Duration);
+    }
+
+    TEST_METHOD_EX(FrameStatisticsTracker_CountMissedVerticalBlanks)
+    {
+        FrameStatisticsTracker tracker;
+
+        DXGI_FRAME_STATISTICS statistics{};
+        statistics.PresentCount = 10;
+        statistics.PresentRefreshCount = 100;
+
+        // The first sample only gives us something to compare with.
+        Assert::AreEqual(0u, tracker.CountMissedVerticalBlanks(statistics));
+
+        // One present per refresh.
+        statistics.PresentCount = 12;
+        statistics.PresentRefreshCount = 102;
+        Assert::AreEqual(0u, tracker.CountMissedVerticalBlanks(statistics));
+
+        // Two presents took five refreshes.
+        statistics.PresentCount = 14;
+        statistics.PresentRefreshCount = 107;
+        Assert::AreEqual(3u, tracker.CountMissedVerticalBlanks(statistics));
+
+        // Nothing new has been displayed.
+        Assert::AreEqual(0u, tracker.CountMissedVerticalBlanks(statistics));
+    }
+};
+
+TEST_CLASS(ResolutionScalerTests)
+{
+    static const uint64_t Budget = 1000;
+
+    static void AddFrames(ResolutionScaler& scaler, uint32_t count, uint64_t drawTime, float minimumScale = 0.5f)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            scaler.AddFrame(drawTime, Budget, minimumScale);
+    }
+
+    TEST_METHOD_EX(ResolutionScaler_StaysAtFullSizeWithinBudget)
+    {
+        ResolutionScaler scaler;
+
+        AddFrames(scaler, 200, Budget * 8 / 10);
+
+        Assert::AreEqual(1.0f, scaler.GetScale());
+    }
+
+    TEST_METHOD_EX(ResolutionScaler_ScalesDownOnceSettled_ToTheTargetLoad)
+    {
+        ResolutionScaler scaler;
+
+        for (uint32_t i = 1; i < ResolutionScaler::SettleFrameCount; i++)
+            Assert::IsFalse(scaler.AddFrame(Budget * 3, Budget, 0.1f));
+
+        Assert::AreEqual(1.0f, scaler.GetScale());
+
+        Assert::IsTrue(scaler.AddFrame(Budget * 3, Budget, 0.1f));
+
+        // Three times over budget needs half the pixels of three quarters of it.
+        Assert::AreEqual(0.5f, scaler.GetScale(), 0.001f);
+    }
+
+    TEST_METHOD_EX(ResolutionScaler_DoesNotGoBelowTheMinimum)
+    {
+        ResolutionScaler scaler;
+
+        AddFrames(scaler, 100, Budget * 100, 0.5f);
+        Assert::AreEqual(0.5f, scaler.GetScale());
+
+        // Raising the minimum applies straight away.
+        Assert::IsTrue(scaler.AddFrame(Budget * 100, Budget, 0.75f));
+        Assert::AreEqual(0.75f, scaler.GetScale());
+    }
+
+    TEST_METHOD_EX(ResolutionScaler_ScalesUpGraduallyOnceThereIsHeadroom)
+    {
+        ResolutionScaler scaler;
+
+        AddFrames(scaler, ResolutionScaler::SettleFrameCount, Budget * 100);
+        Assert::AreEqual(0.5f, scaler.GetScale());
+
+        // Headroom has to last before anything changes.
+        uint32_t frameCount = 1;
+        while (!scaler.AddFrame(1, Budget, 0.5f))
+            frameCount++;
+
+        Assert::IsTrue(frameCount >= ResolutionScaler::HeadroomFrameCount);
+        Assert::AreEqual(0.6f, scaler.GetScale(), 0.001f);
+    }
+
+    TEST_METHOD_EX(ResolutionScaler_PrefersGpuTimeToDrawTime)
+    {
+        ResolutionScaler scaler;
+
+        scaler.AddGpuTime(Budget / 2);
+        AddFrames(scaler, 100, Budget * 100);
+
+        Assert::AreEqual(1.0f, scaler.GetScale());
+
+        scaler.Reset();
+        Assert::AreEqual(1.0f, scaler.GetScale());
+    }
+};
+
 TEST_CLASS(CanvasAnimatedControl_DpiScaling)
 {
     class DpiScalingFixture : public FixtureWithSwapChainAccess
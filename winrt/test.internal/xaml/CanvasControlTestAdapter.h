@@ -20,6 +20,7 @@ public:
     CanvasControlTestAdapter()
         : SurfaceContentsLostEventSource(Make<MockEventSourceUntyped>(L"SurfaceContentsLost"))
         , CompositionRenderingEventSource(Make<MockEventSourceUntyped>(L"CompositionRendering"))
+        , LastDrawingSessionUpdateRectangle{}
     {
         DeviceFactory->GetSharedDeviceWithForceSoftwareRendererMethod.AllowAnyCall(
             [&](boolean, ICanvasDevice** device)
@@ -61,6 +62,10 @@ public:
     // means).
     std::function<ComPtr<MockCanvasDrawingSession>()> OnCanvasImageSourceDrawingSessionFactory_Create;
 
+    // The update rectangle passed to the most recently created drawing
+    // session.
+    Rect LastDrawingSessionUpdateRectangle;
+
     virtual ComPtr<CanvasImageSource> CreateCanvasImageSource(
         ICanvasDevice* device, 
         float width, 
@@ -83,8 +88,10 @@ public:
 
         auto dsFactory = std::make_shared<MockCanvasImageSourceDrawingSessionFactory>();
         dsFactory->CreateMethod.AllowAnyCall(
-            [&](ICanvasDevice*, ISurfaceImageSourceNativeWithD2D*, Color const&, Rect const&, float)
+            [&](ICanvasDevice*, ISurfaceImageSourceNativeWithD2D*, Color const&, Rect const& updateRectangle, float)
             {
+                LastDrawingSessionUpdateRectangle = updateRectangle;
+
                 if (OnCanvasImageSourceDrawingSessionFactory_Create)
                 {
                     // We call the function through a copy - this is so the
@@ -118,6 +125,11 @@ public:
         return Make<StubImageControl>();
     }
 
+    virtual ComPtr<IRectangleGeometry> CreateRectangleGeometry() override
+    {
+        return Make<StubRectangleGeometry>();
+    }
+
     virtual void DisableAccessibilityView(IImage*) override
     {
     }
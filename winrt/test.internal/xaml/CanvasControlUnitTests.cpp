@@ -239,6 +239,44 @@ TEST_CLASS(CanvasControlTests_SizeTests)
         }
     }
 
+    TEST_METHOD_EX(CanvasControl_WhenSurfaceSizeIsBucketed_OnlyReallocatesWhenOutsideTheBucket)
+    {
+        struct TestCase
+        {
+            int ResizeWidth;
+            int ResizeHeight;
+            bool ExpectRecreation;
+            int AllocatedWidth;
+            int AllocatedHeight;
+        } testSteps[]
+        {
+            { 100, 100,  true, 256, 256 }, // Initial sizing
+            { 200, 256, false, 256, 256 }, // Still fits
+            { 600, 100,  true, 768, 256 }, // Too wide
+            { 300, 100, false, 768, 256 }, // Not yet a whole bucket too big
+            { 200, 100,  true, 256, 256 }, // Now it is
+        };
+
+        ResizeFixture f;
+        f.SetIsSurfaceSizeBucketed();
+
+        for (auto const& testStep : testSteps)
+        {
+            if (testStep.ExpectRecreation) 
+                f.ExpectOneCreateCanvasImageSource((float)testStep.AllocatedWidth, (float)testStep.AllocatedHeight);
+
+            // The whole control is redrawn after every resize.
+            f.ExpectOneDrawEvent();
+
+            f.Execute(testStep.ResizeWidth, testStep.ResizeHeight);
+
+            // Only the control's part of the image source is shown.
+            auto arrangedRect = f.Arrange(testStep.ResizeWidth, testStep.ResizeHeight);
+            Assert::AreEqual(Rect{ 0, 0, (float)testStep.AllocatedWidth, (float)testStep.AllocatedHeight }, arrangedRect);
+            Assert::AreEqual(Rect{ 0, 0, (float)testStep.ResizeWidth, (float)testStep.ResizeHeight }, f.GetImageClip());
+        }
+    }
+
     TEST_METHOD_EX(CanvasControl_ZeroSizedControl_DoesNotCreateImageSource_DoesNotCallDrawHandler)
     {
         ResizeFixture f;
@@ -290,10 +328,19 @@ TEST_CLASS(CanvasControlTests_SizeTests)
         bool m_sourceSeen;
 
     public:
+        Rect LastArrangeRect;
+
         MockImageControl()
             : m_expectedSource(None)
             , m_sourceSeen(false)
+            , LastArrangeRect{}
+        {
+        }
+
+        IFACEMETHODIMP Arrange(Rect finalRect) override
         {
+            LastArrangeRect = finalRect;
+            return S_OK;
         }
 
         void ExpectOnePutSource(ExpectedSource s)
@@ -342,6 +389,7 @@ TEST_CLASS(CanvasControlTests_SizeTests)
         float m_expectedImageSourceHeight;
         float m_expectedImageSourceDpi;
         ComPtr<MockImageControl> m_imageControl;
+        ComPtr<StubRectangleGeometry> m_imageClip;
 
     public:
         CanvasControlTestAdapter_VerifyCreateImageSource()
@@ -351,8 +399,12 @@ TEST_CLASS(CanvasControlTests_SizeTests)
             , m_expectedImageSourceHeight(-1)
             , m_expectedImageSourceDpi(-1)
             , m_imageControl(Make<MockImageControl>())
+            , m_imageClip(Make<StubRectangleGeometry>())
         {}
 
+        ComPtr<MockImageControl> GetImageControl() const { return m_imageControl; }
+        ComPtr<StubRectangleGeometry> GetImageClip() const { return m_imageClip; }
+
         void ExpectOneCreateCanvasImageSource(float width, float height, float dpi = DEFAULT_DPI)
         {
             CreateCanvasImageSourceMethod.SetExpectedCalls(1);
@@ -383,6 +435,11 @@ TEST_CLASS(CanvasControlTests_SizeTests)
             return m_imageControl;
         }
 
+        virtual ComPtr<IRectangleGeometry> CreateRectangleGeometry() override
+        {
+            return m_imageClip;
+        }
+
         virtual ComPtr<CanvasImageSource> CreateCanvasImageSource(ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode) override
         {
             Assert::AreEqual(m_expectedImageSourceWidth, width, L"ExpectedImageSourceWidth");
@@ -439,6 +496,26 @@ TEST_CLASS(CanvasControlTests_SizeTests)
             Validate();
         }
 
+        void SetIsSurfaceSizeBucketed()
+        {
+            ThrowIfFailed(m_control->put_IsSurfaceSizeBucketed(TRUE));
+        }
+
+        // Returns the rect that the image control was arranged in.
+        Rect Arrange(int width, int height)
+        {
+            Size finalSize{ static_cast<float>(width), static_cast<float>(height) };
+            Size returnedSize;
+            ThrowIfFailed(As<IFrameworkElementOverrides>(m_control)->ArrangeOverride(finalSize, &returnedSize));
+
+            return m_adapter->GetImageControl()->LastArrangeRect;
+        }
+
+        Rect GetImageClip()
+        {
+            return m_adapter->GetImageClip()->Rect;
+        }
+
     private:
         void Resize(int width, int height)
         {
@@ -902,4 +979,152 @@ TEST_CLASS(CanvasControl_ClearColor)
 
         f.RenderAnyNumberOfFrames();
     }
-};
\ No newline at end of file
+};
+
+TEST_CLASS(CanvasControl_InvalidateRegion)
+{
+    struct Fixture : public CanvasControlFixture
+    {
+        MockEventHandler<Static_DrawEventHandler> OnDraw;
+
+        Fixture()
+            : OnDraw(MockEventHandler<Static_DrawEventHandler>(L"Draw"))
+        {
+            Adapter->CreateCanvasImageSourceMethod.AllowAnyCall();
+            AddDrawHandler(OnDraw.Get());
+            Load();
+
+            // The first frame is always drawn whole.
+            OnDraw.SetExpectedCalls(1);
+            RenderSingleFrame();
+            OnDraw.Validate();
+        }
+
+        void ExpectDraw(Rect expectedUpdateRectangle)
+        {
+            OnDraw.SetExpectedCalls(1);
+            RenderSingleFrame();
+            OnDraw.Validate();
+
+            Assert::AreEqual(expectedUpdateRectangle, Adapter->LastDrawingSessionUpdateRectangle);
+        }
+    };
+
+    TEST_METHOD_EX(CanvasControl_WhenInvalidateRegionIsCalled_OnlyThatRegionIsDrawn)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.Control->InvalidateRegion(Rect{ 10, 20, 30, 40 }));
+        f.ExpectDraw(Rect{ 10, 20, 30, 40 });
+
+        // Nothing is drawn until the control is invalidated again.
+        f.OnDraw.SetExpectedCalls(0);
+        f.RenderSingleFrame();
+    }
+
+    TEST_METHOD_EX(CanvasControl_WhenInvalidateRegionIsCalledMoreThanOnce_TheUnionIsDrawn)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.Control->InvalidateRegion(Rect{ 10, 20, 5, 5 }));
+        ThrowIfFailed(f.Control->InvalidateRegion(Rect{ 30, 10, 10, 5 }));
+        f.ExpectDraw(Rect{ 10, 10, 30, 15 });
+    }
+
+    TEST_METHOD_EX(CanvasControl_InvalidateRegion_IsClippedToTheControl)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.Control->InvalidateRegion(Rect{ -10, 150, 50, 100 }));
+        f.ExpectDraw(Rect{ 0, 150, 40, 50 });
+
+        // Regions entirely outside the control draw nothing.
+        ThrowIfFailed(f.Control->InvalidateRegion(Rect{ 500, 500, 10, 10 }));
+        f.OnDraw.SetExpectedCalls(0);
+        f.RenderSingleFrame();
+    }
+
+    TEST_METHOD_EX(CanvasControl_WhenInvalidateIsAlsoCalled_TheWholeControlIsDrawn)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.Control->InvalidateRegion(Rect{ 10, 20, 5, 5 }));
+        ThrowIfFailed(f.Control->Invalidate());
+        f.ExpectDraw(Rect{ 0, 0, (float)Fixture::InitialWidth, (float)Fixture::InitialHeight });
+    }
+
+    TEST_METHOD_EX(CanvasControl_InvalidateRegion_RejectsNegativeSizes)
+    {
+        CanvasControlFixture f;
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->InvalidateRegion(Rect{ 0, 0, -1, 1 }));
+        Assert::AreEqual(E_INVALIDARG, f.Control->InvalidateRegion(Rect{ 0, 0, 1, -1 }));
+    }
+};
+
+TEST_CLASS(CanvasControl_DrawPlaceholder)
+{
+    struct Fixture : public CanvasControlFixture
+    {
+        MockEventHandler<Static_DrawEventHandler> OnDraw;
+        MockEventHandler<Static_DrawEventHandler> OnDrawPlaceholder;
+        ComPtr<MockAsyncAction> Action;
+
+        Fixture()
+            : OnDraw(MockEventHandler<Static_DrawEventHandler>(L"Draw"))
+            , OnDrawPlaceholder(MockEventHandler<Static_DrawEventHandler>(L"DrawPlaceholder"))
+            , Action(Make<MockAsyncAction>())
+        {
+            Adapter->CreateCanvasImageSourceMethod.AllowAnyCall();
+
+            auto action = Action;
+            auto onCreateResources = Callback<Static_CreateResourcesEventHandler>(
+                [=] (ICanvasControl*, ICanvasCreateResourcesEventArgs* args)
+                {
+                    return args->TrackAsyncAction(action.Get());
+                });
+
+            AddCreateResourcesHandler(onCreateResources.Get());
+            AddDrawHandler(OnDraw.Get());
+
+            EventRegistrationToken token;
+            ThrowIfFailed(Control->add_DrawPlaceholder(OnDrawPlaceholder.Get(), &token));
+
+            Load();
+        }
+
+        float GetCreateResourcesProgress()
+        {
+            float value;
+            ThrowIfFailed(Control->get_CreateResourcesProgress(&value));
+            return value;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasControl_WhileResourcesAreBeingCreated_DrawPlaceholderIsRaisedInsteadOfDraw)
+    {
+        Fixture f;
+
+        f.OnDraw.SetExpectedCalls(0);
+        f.OnDrawPlaceholder.SetExpectedCalls(1);
+        f.RenderSingleFrame();
+        f.OnDrawPlaceholder.Validate();
+
+        Assert::AreEqual(0.0f, f.GetCreateResourcesProgress());
+
+        f.Action->SetResult(S_OK);
+
+        Assert::AreEqual(1.0f, f.GetCreateResourcesProgress());
+
+        f.OnDraw.SetExpectedCalls(1);
+        f.OnDrawPlaceholder.SetExpectedCalls(0);
+        f.RenderSingleFrame();
+    }
+
+    TEST_METHOD_EX(CanvasControl_get_CreateResourcesProgress_NullArg)
+    {
+        CanvasControlFixture f;
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_CreateResourcesProgress(nullptr));
+    }
+};
@@ -66,6 +66,11 @@ public:
         return Image;
     }
 
+    virtual ComPtr<IRectangleGeometry> CreateRectangleGeometry() override
+    {
+        return Make<StubRectangleGeometry>();
+    }
+
     virtual void DisableAccessibilityView(IImage*) override
     {
     }
@@ -391,6 +396,46 @@ TEST_CLASS(CanvasVirtualControlTests)
         Assert::AreEqual(S_OK, f.Control->CreateDrawingSession(anyRegion, &ds));
     }
 
+    TEST_METHOD_EX(CanvasVirtualControl_DrawRegions_FailsWhenCreateResourcesNotComplete)
+    {
+        Fixture f;
+        f.ExpectCreateImageSource();
+        f.AddAsyncCreateResources();
+        f.Load();
+
+        auto handler = Callback<ICanvasRegionDrawHandler>([] (Rect, ICanvasDrawingSession*) { return S_OK; });
+        Rect regions[] = { anyRegion };
+
+        Assert::AreEqual(E_FAIL, f.Control->DrawRegions(1, regions, 0, handler.Get()));
+        ValidateStoredErrorState(E_FAIL, Strings::CreateDrawingSessionCalledBeforeRegionsInvalidated);
+    }
+
+    TEST_METHOD_EX(CanvasVirtualControl_DrawRegions_CallsThroughToImageSourceWithClearColor)
+    {
+        Fixture f;
+
+        ThrowIfFailed(f.Control->put_ClearColor(anyColor));
+        auto imageSource = f.ExpectCreateImageSource();
+
+        auto handler = Callback<ICanvasRegionDrawHandler>([] (Rect, ICanvasDrawingSession*) { return S_OK; });
+        Rect regions[] = { anyRegion, anyRegion };
+
+        imageSource->DrawRegionsMethod.SetExpectedCalls(1,
+            [&] (Color clearColor, uint32_t regionCount, Rect* actualRegions, int32_t maximumParallelism, ICanvasRegionDrawHandler* actualHandler)
+            {
+                Assert::AreEqual(anyColor, clearColor);
+                Assert::AreEqual(2U, regionCount);
+                Assert::IsTrue(regions == actualRegions);
+                Assert::AreEqual(3, maximumParallelism);
+                Assert::IsTrue(IsSameInstance(handler.Get(), actualHandler));
+                return S_OK;
+            });
+
+        f.Load();
+
+        ThrowIfFailed(f.Control->DrawRegions(2, regions, 3, handler.Get()));
+    }
+
     TEST_METHOD_EX(CanvasVirtualControl_Invalidate_IsNoOpIfSurfaceHasntBeenCreated)
     {
         Fixture f;
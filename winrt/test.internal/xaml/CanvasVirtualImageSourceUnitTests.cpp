@@ -643,6 +643,121 @@ public:
         Assert::AreEqual(E_INVALIDARG, f.ImageSource->ResumeDrawingSession(nullptr));
     }
 
+    TEST_METHOD_EX(CanvasVirtualImageSource_DrawRegions_FailsWithBadParams)
+    {
+        SimpleFixture f;
+
+        auto handler = Callback<ICanvasRegionDrawHandler>([] (Rect, ICanvasDrawingSession*) { return S_OK; });
+        Rect regions[] = { anyUpdateRectangle };
+
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->DrawRegions(anyColor, 1, regions, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->DrawRegions(anyColor, 1, nullptr, 0, handler.Get()));
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->DrawRegions(anyColor, 1, regions, -1, handler.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasVirtualImageSource_DrawRegions_RecordsEachRegion_ThenPlaysThemBackInOrder)
+    {
+        SimpleFixture f(anySize, anyDpi);
+
+        Rect regions[] = { Rect{ 1, 2, 3, 4 }, Rect{ 5, 6, 7, 8 } };
+
+        f.Device->CreateCommandListMethod.SetExpectedCalls(2,
+            []
+            {
+                auto commandList = Make<MockD2DCommandList>();
+                commandList->CloseMethod.AllowAnyCall();
+                return commandList;
+            });
+
+        f.Device->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+            [] { return Make<StubD2DDeviceContext>(nullptr); });
+
+        std::vector<Rect> recordedRegions;
+        std::vector<ComPtr<IUnknown>> recordedCommandLists;
+
+        auto handler = Callback<ICanvasRegionDrawHandler>(
+            [&] (Rect region, ICanvasDrawingSession* drawingSession)
+            {
+                ComPtr<ID2D1Image> d2dTarget;
+                GetWrappedResource<ID2D1DeviceContext>(drawingSession)->GetTarget(&d2dTarget);
+
+                float dpiX, dpiY;
+                GetWrappedResource<ID2D1DeviceContext>(drawingSession)->GetDpi(&dpiX, &dpiY);
+                Assert::AreEqual(anyDpi, dpiX);
+
+                recordedRegions.push_back(region);
+                recordedCommandLists.push_back(d2dTarget);
+                return S_OK;
+            });
+
+        std::vector<ComPtr<IUnknown>> playedBackImages;
+
+        f.DrawingSessionFactory->CreateMethod.SetExpectedCalls(2,
+            [&] (ICanvasDevice*, ISurfaceImageSourceNativeWithD2D*, Color const& clearColor, Rect const& updateRectangleInDips, float)
+            {
+                auto n = f.DrawingSessionFactory->CreateMethod.GetCurrentCallCount() - 1;
+
+                // Every region has been recorded before any are played back.
+                Assert::AreEqual<size_t>(2, recordedRegions.size());
+
+                Assert::AreEqual(anyColor, clearColor);
+                Assert::AreEqual(regions[n], updateRectangleInDips);
+
+                auto deviceContext = Make<StubD2DDeviceContext>(nullptr);
+                deviceContext->DrawImageMethod.SetExpectedCalls(1,
+                    [&] (ID2D1Image* image, D2D1_POINT_2F const*, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+                    {
+                        playedBackImages.push_back(image);
+                    });
+
+                return Make<CanvasDrawingSession>(deviceContext.Get());
+            });
+
+        f.Vsis->get_DispatcherMethod.AllowAnyCall(
+            [] (ICoreDispatcher** value)
+            {
+                auto mockDispatcher = Make<MockDispatcher>();
+                mockDispatcher->get_HasThreadAccessMethod.AllowAnyCall([] (boolean* hasThreadAccess) { *hasThreadAccess = true; return S_OK; });
+                return mockDispatcher.CopyTo(value);
+            });
+
+        // With a parallelism of one every region is recorded on this thread, in order.
+        ThrowIfFailed(f.ImageSource->DrawRegions(anyColor, 2, regions, 1, handler.Get()));
+
+        Assert::AreEqual<size_t>(2, recordedRegions.size());
+        Assert::AreEqual<size_t>(2, playedBackImages.size());
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            Assert::AreEqual(regions[i], recordedRegions[i]);
+            Assert::IsTrue(IsSameInstance(recordedCommandLists[i].Get(), playedBackImages[i].Get()));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasVirtualImageSource_DrawRegions_WhenTheHandlerFails_NothingIsPlayedBack)
+    {
+        SimpleFixture f;
+
+        Rect regions[] = { anyUpdateRectangle };
+
+        f.Device->CreateCommandListMethod.AllowAnyCall(
+            []
+            {
+                auto commandList = Make<MockD2DCommandList>();
+                commandList->CloseMethod.AllowAnyCall();
+                return commandList;
+            });
+
+        f.Device->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+            [] { return Make<StubD2DDeviceContext>(nullptr); });
+
+        auto handler = Callback<ICanvasRegionDrawHandler>([] (Rect, ICanvasDrawingSession*) { return E_NOTIMPL; });
+
+        f.DrawingSessionFactory->CreateMethod.SetExpectedCalls(0);
+
+        Assert::AreEqual(E_NOTIMPL, f.ImageSource->DrawRegions(anyColor, 1, regions, 1, handler.Get()));
+    }
+
     TEST_METHOD_EX(CanvasVirtualImageSource_Invalidate_CallsInvalidateForEntireImage)
     {
         SimpleFixture f;
@@ -683,6 +798,11 @@ public:
         ComPtr<IVirtualSurfaceUpdatesCallbackNative> m_callback;
 
     public:
+        CallbackFixture(Size size = anySize, float dpi = anyDpi)
+            : SimpleFixture(size, dpi)
+        {
+        }
+
         void ExpectRegisterForUpdatesNeeded()
         {
             Vsis->RegisterForUpdatesNeededMethod.SetExpectedCalls(1,
@@ -842,6 +962,133 @@ public:
         Assert::AreEqual(RPC_E_WRONG_THREAD, f.ImageSource->RaiseRegionsInvalidatedIfAny());
     }
 
+    TEST_METHOD_EX(VirtualImageTiles_GetTilesCovering_ReturnsOverlappingTilesInRowMajorOrder)
+    {
+        auto tiles = VirtualImageTiles::GetTilesCovering(RECT{ 10, 250, 300, 260 }, SIZE{ 1000, 1000 });
+
+        Assert::AreEqual<size_t>(4, tiles.size());
+        Assert::IsTrue(VirtualImageTiles::Index(0, 0) == tiles[0]);
+        Assert::IsTrue(VirtualImageTiles::Index(1, 0) == tiles[1]);
+        Assert::IsTrue(VirtualImageTiles::Index(0, 1) == tiles[2]);
+        Assert::IsTrue(VirtualImageTiles::Index(1, 1) == tiles[3]);
+    }
+
+    TEST_METHOD_EX(VirtualImageTiles_TilesAreClippedToTheImage)
+    {
+        SIZE imageSize{ 300, 200 };
+
+        Assert::AreEqual<size_t>(2, VirtualImageTiles::GetTilesCovering(RECT{ -50, -50, 5000, 5000 }, imageSize).size());
+        Assert::AreEqual<size_t>(0, VirtualImageTiles::GetTilesCovering(RECT{ 300, 0, 400, 100 }, imageSize).size());
+
+        Assert::AreEqual(RECT{ 256, 0, 300, 200 }, VirtualImageTiles::GetTileRect(VirtualImageTiles::Index(1, 0), imageSize));
+    }
+
+    TEST_METHOD_EX(VirtualImageTiles_TryGetTileIndex_OnlyMatchesWholeTiles)
+    {
+        SIZE imageSize{ 300, 200 };
+        VirtualImageTiles::Index index;
+
+        Assert::IsTrue(VirtualImageTiles::TryGetTileIndex(RECT{ 256, 0, 300, 200 }, imageSize, &index));
+        Assert::IsTrue(VirtualImageTiles::Index(1, 0) == index);
+
+        Assert::IsFalse(VirtualImageTiles::TryGetTileIndex(RECT{ 0, 0, 100, 100 }, imageSize, &index));
+        Assert::IsFalse(VirtualImageTiles::TryGetTileIndex(RECT{ 1, 0, 256, 200 }, imageSize, &index));
+        Assert::IsFalse(VirtualImageTiles::TryGetTileIndex(RECT{ 512, 0, 768, 200 }, imageSize, &index));
+    }
+
+    TEST_METHOD_EX(VirtualImageTiles_GetPrefetchBounds_GrowsOnEverySideWhenNotMoving)
+    {
+        RECT visible{ 100, 100, 200, 200 };
+
+        Assert::AreEqual(RECT{ 50, 50, 250, 250 }, VirtualImageTiles::GetPrefetchBounds(visible, visible, 50, SIZE{ 1000, 1000 }));
+        Assert::AreEqual(RECT{ 0, 0, 220, 220 }, VirtualImageTiles::GetPrefetchBounds(visible, visible, 150, SIZE{ 220, 220 }));
+    }
+
+    TEST_METHOD_EX(VirtualImageTiles_GetPrefetchBounds_GrowsTowardsTheDirectionOfMovement)
+    {
+        RECT visible{ 100, 100, 200, 200 };
+
+        Assert::AreEqual(RECT{ 100, 50, 250, 200 }, VirtualImageTiles::GetPrefetchBounds(visible, RECT{ 90, 110, 190, 210 }, 50, SIZE{ 1000, 1000 }));
+        Assert::AreEqual(RECT{ 50, 100, 200, 250 }, VirtualImageTiles::GetPrefetchBounds(visible, RECT{ 110, 90, 210, 190 }, 50, SIZE{ 1000, 1000 }));
+    }
+
+    TEST_METHOD_EX(CanvasVirtualImageSource_PrefetchMarginAndMaximumCachedTileCount_DefaultToZeroAndCanBeSet)
+    {
+        SimpleFixture f;
+
+        float margin;
+        ThrowIfFailed(f.ImageSource->get_PrefetchMargin(&margin));
+        Assert::AreEqual(0.0f, margin);
+
+        uint32_t count;
+        ThrowIfFailed(f.ImageSource->get_MaximumCachedTileCount(&count));
+        Assert::AreEqual(0u, count);
+
+        ThrowIfFailed(f.ImageSource->put_PrefetchMargin(64));
+        ThrowIfFailed(f.ImageSource->get_PrefetchMargin(&margin));
+        Assert::AreEqual(64.0f, margin);
+
+        ThrowIfFailed(f.ImageSource->put_MaximumCachedTileCount(16));
+        ThrowIfFailed(f.ImageSource->get_MaximumCachedTileCount(&count));
+        Assert::AreEqual(16u, count);
+
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->put_PrefetchMargin(-1));
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->put_PrefetchMargin(NAN));
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->get_PrefetchMargin(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.ImageSource->get_MaximumCachedTileCount(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasVirtualImageSource_WhenTileCacheIsEnabled_RegionsInvalidatedReportsWholeTiles)
+    {
+        CallbackFixture f(Size{ 1000, 600 }, DEFAULT_DPI);
+
+        f.ExpectRegisterForUpdatesNeeded();
+
+        ThrowIfFailed(f.ImageSource->put_MaximumCachedTileCount(4));
+
+        auto onRegionsInvalidated = MockEventHandler<ImageSourceRegionsInvalidatedHandler>(L"onRegionsInvalidated");
+        EventRegistrationToken token;
+        ThrowIfFailed(f.ImageSource->add_RegionsInvalidated(onRegionsInvalidated.Get(), &token));
+
+        f.Vsis->GetUpdateRectCountMethod.SetExpectedCalls(1,
+            [&] (DWORD* count)
+            {
+                *count = 2;
+                return S_OK;
+            });
+
+        f.Vsis->GetUpdateRectsMethod.SetExpectedCalls(1,
+            [&] (RECT* updates, DWORD)
+            {
+                updates[0] = RECT{ 10, 10, 300, 20 };
+                updates[1] = RECT{ 270, 30, 280, 40 };
+                return S_OK;
+            });
+
+        f.Vsis->GetVisibleBoundsMethod.SetExpectedCalls(1,
+            [&] (RECT* bounds)
+            {
+                *bounds = RECT{ 0, 0, 400, 300 };
+                return S_OK;
+            });
+
+        onRegionsInvalidated.SetExpectedCalls(1,
+            [&] (ICanvasVirtualImageSource*, ICanvasRegionsInvalidatedEventArgs* args)
+            {
+                ComArray<Rect> invalidatedRegions;
+                ThrowIfFailed(args->get_InvalidatedRegions(invalidatedRegions.GetAddressOfSize(), invalidatedRegions.GetAddressOfData()));
+
+                // Overlapping update rectangles are only reported once.
+                Assert::AreEqual<size_t>(2, invalidatedRegions.GetSize());
+                Assert::AreEqual(RECT{ 0, 0, 256, 256 }, ToRECT(invalidatedRegions[0], DEFAULT_DPI));
+                Assert::AreEqual(RECT{ 256, 0, 512, 256 }, ToRECT(invalidatedRegions[1], DEFAULT_DPI));
+
+                return S_OK;
+            });
+
+        f.RaiseUpdatesNeeded();
+    }
+
     TEST_METHOD_EX(CanvasVirtualImageSource_CanvasRegionsInvalidatedEventArgs_AccessorsFailWhenPassedNull)
     {
         auto args = Make<CanvasRegionsInvalidatedEventArgs>(std::vector<Rect>(), Rect{});
@@ -119,7 +119,7 @@ struct MockGameLoopClient : public ICanvasGameLoopClient
         GameLoopStopped.WasCalled();
     }
 
-    virtual bool Tick(CanvasSwapChain* target, bool areResourcesCreated) override 
+    virtual bool Tick(CanvasSwapChain* target, bool areResourcesCreated, IGameLoopThread* thread) override 
     {
         return true;
     }
@@ -375,6 +375,7 @@ TEST_CLASS(CanvasGameLoopTests)
             virtual void StartDispatcher() override {}
             virtual void StopDispatcher() override {}
             virtual bool HasThreadAccess() override { return true; }
+            virtual bool TryDeferFrameWait(std::function<void()> const&) override { return false; }
         };
 
         CanvasGameLoop gameLoop(&gameLoopClient, std::make_unique<MockGameLoopThread>());
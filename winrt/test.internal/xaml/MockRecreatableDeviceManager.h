@@ -11,6 +11,7 @@ public:
     CALL_COUNTER_WITH_MOCK(SetChangedCallbackMethod, void(std::function<void(ChangeReason)>));
     CALL_COUNTER_WITH_MOCK(RunWithDeviceMethod, void(Sender*, DeviceCreationOptions, RunWithDeviceFunction));
     CALL_COUNTER_WITH_MOCK(IsReadyToDrawMethod, bool());
+    CALL_COUNTER_WITH_MOCK(GetCreateResourcesProgressMethod, float());
     CALL_COUNTER_WITH_MOCK(AddCreateResourcesMethod, EventRegistrationToken(Sender*, CreateResourcesHandler*));
     CALL_COUNTER_WITH_MOCK(RemoveCreateResourcesMethod, void(EventRegistrationToken));
     CALL_COUNTER_WITH_MOCK(SetDpiChangedMethod, void())
@@ -57,6 +58,11 @@ public:
     {
         return IsReadyToDrawMethod.WasCalled();
     }
+
+    virtual float GetCreateResourcesProgress() override
+    {
+        return GetCreateResourcesProgressMethod.WasCalled();
+    }
     
     virtual void SetDpiChanged() override
     {
@@ -1098,6 +1098,74 @@ public:
         Assert::IsTrue(f.DeviceManager->IsReadyToDraw());
     }
 
+    TEST_METHOD_EX(RecreatableDeviceManager_WhenWorkIsRunOnBackgroundThreads_ResourcesAreCreatedOnceAllOfItAndTheTrackedActionHaveCompleted)
+    {
+        Fixture f;
+
+        Event releaseWork(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        Event workCompleted(CreateEventEx(NULL, NULL, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS));
+        std::atomic<int> changedCount(0);
+
+        // Background work completes on threadpool threads, so this can't use
+        // the fixture's (single threaded) changed callback.
+        f.DeviceManager->SetChangedCallback(
+            [&] (ChangeReason reason)
+            {
+                Assert::AreEqual(ChangeReason::Other, reason);
+
+                if (++changedCount == 2)
+                    SetEvent(workCompleted.Get());
+            });
+
+        auto trackedAction = Make<MockAsyncAction>();
+
+        auto onCreateResources = Callback<CreateResourcesHandler>(
+            [&](IInspectable*, ICanvasCreateResourcesEventArgs* args)
+            {
+                return ExceptionBoundary(
+                    [&]
+                    {
+                        ThrowIfFailed(args->TrackAsyncAction(trackedAction.Get()));
+
+                        for (int i = 0; i < 2; ++i)
+                        {
+                            auto work = Callback<ICanvasCreateResourcesWorkHandler>(
+                                [&]
+                                {
+                                    WaitForSingleObjectEx(releaseWork.Get(), INFINITE, FALSE);
+                                    return S_OK;
+                                });
+
+                            ComPtr<IAsyncAction> action;
+                            ThrowIfFailed(args->RunOnBackgroundThread(work.Get(), &action));
+                            Assert::IsNotNull(action.Get());
+                        }
+                    });
+            });
+
+        f.DeviceManager->AddCreateResources(f.AnySender, onCreateResources.Get());
+
+        f.DeviceFactory->ExpectToActivateOne();
+        f.CallRunWithDeviceExpectFlagsSet(RunWithDeviceFlags::ResourcesNotCreated);
+
+        Assert::IsFalse(f.DeviceManager->IsReadyToDraw());
+        Assert::AreEqual(0.0f, f.DeviceManager->GetCreateResourcesProgress());
+
+        // Let both work items finish.
+        SetEvent(releaseWork.Get());
+        Assert::AreEqual(WAIT_OBJECT_0, WaitForSingleObjectEx(workCompleted.Get(), 10000, FALSE));
+
+        Assert::IsFalse(f.DeviceManager->IsReadyToDraw());
+        Assert::AreEqual(2.0f / 3.0f, f.DeviceManager->GetCreateResourcesProgress());
+        f.CallRunWithDeviceExpectFlagsSet(RunWithDeviceFlags::ResourcesNotCreated);
+
+        trackedAction->SetResult(S_OK);
+
+        Assert::IsTrue(f.DeviceManager->IsReadyToDraw());
+        Assert::AreEqual(1.0f, f.DeviceManager->GetCreateResourcesProgress());
+        f.CallRunWithDeviceExpectExactFlags(RunWithDeviceFlags::None);
+    }
+
     TEST_METHOD_EX(RecreatableDeviceManager_WhenDpiChangesDuringCreateResourcesAsync_ItIsDeferredUntilTheProperTime)
     {
         FixtureWithCreateResourcesAsync f;
@@ -8,6 +8,7 @@ using Microsoft.VisualStudio.TestTools.UnitTesting;
 using System;
 using System.Collections.Generic;
 using System.IO;
+using System.Numerics;
 using System.Threading.Tasks;
 using Windows.Foundation;
 using Windows.UI;
@@ -185,5 +186,37 @@ namespace test.managed
 
             CollectionAssert.AreEqual(expected, histogram);
         }
+
+        [TestMethod]
+        public void CanvasImage_ComputeStatistics()
+        {
+            Color[] colors =
+            {
+                Colors.Red, Colors.Lime,
+                Colors.Blue, Colors.White
+            };
+
+            var device = new CanvasDevice();
+            var bitmap = CanvasBitmap.CreateFromColors(device, colors, 2, 2);
+
+            // Statistics over the entire 2x2 bitmap.
+            var statistics = CanvasImage.ComputeStatistics(bitmap, new Rect(0, 0, 2, 2), device);
+
+            Assert.AreEqual(new Vector4(0, 0, 0, 1), statistics.Minimum);
+            Assert.AreEqual(new Vector4(1, 1, 1, 1), statistics.Maximum);
+            Assert.AreEqual(new Vector4(0.5f, 0.5f, 0.5f, 1), statistics.Mean);
+            Assert.AreEqual(new Vector4(0.25f, 0.25f, 0.25f, 0), statistics.Variance);
+
+            // Statistics of just the top left 1x1 (single red pixel).
+            statistics = CanvasImage.ComputeStatistics(bitmap, new Rect(0, 0, 1, 1), device);
+
+            Assert.AreEqual(new Vector4(1, 0, 0, 1), statistics.Minimum);
+            Assert.AreEqual(new Vector4(1, 0, 0, 1), statistics.Maximum);
+            Assert.AreEqual(new Vector4(1, 0, 0, 1), statistics.Mean);
+            Assert.AreEqual(new Vector4(0, 0, 0, 0), statistics.Variance);
+
+            // Empty source rectangles are not allowed.
+            Assert.ThrowsException<ArgumentException>(() => CanvasImage.ComputeStatistics(bitmap, new Rect(0, 0, 0, 0), device));
+        }
     }
 }